@@ -0,0 +1,60 @@
+# Compiles an embedded Lua script to bytecode, and writes the bytecode to a
+# C++ header as an array named <NAME>_bytecode.
+#
+# Usage:
+# cmake -DINPUT=<script.lua> -DOUTPUT=<header.h> -DNAME=<name>
+#       -DCHUNKNAME=<chunk name> -DCOMPILER=<luajit or luac> -DJIT=<bool>
+#       -P CompileLua.cmake
+#
+# Wrapper scripts are embedded as C++ raw string literals, whose delimiters on
+# the first and last lines aren't Lua. They're removed before compiling, while
+# keeping the line numbers the same.
+
+file(READ "${INPUT}" source)
+
+if(source MATCHES "^R\"luastring\"--\\(")
+	string(REGEX REPLACE "^R\"luastring\"--\\(" "" source "${source}")
+	string(REGEX REPLACE "--\\)luastring\"--\"[\r\n]*$" "" source "${source}")
+endif()
+
+set(stripped "${OUTPUT}.lua")
+set(bytecode "${OUTPUT}.bc")
+file(WRITE "${stripped}" "${source}")
+
+if(JIT)
+	# -g keeps the debug info for error messages and tracebacks, and -F gives
+	# the chunk the same name the source version is loaded with.
+	execute_process(
+		COMMAND "${COMPILER}" -b -g -F "${CHUNKNAME}" "${stripped}" "${bytecode}"
+		RESULT_VARIABLE result
+		ERROR_VARIABLE error)
+else()
+	execute_process(
+		COMMAND "${COMPILER}" -o "${bytecode}" "${stripped}"
+		RESULT_VARIABLE result
+		ERROR_VARIABLE error)
+endif()
+
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "Could not compile ${INPUT}: ${error}")
+endif()
+
+file(READ "${bytecode}" hex HEX)
+string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1, " bytes "${hex}")
+
+# Break the lines every 16 bytes.
+set(group "")
+foreach(i RANGE 15)
+	set(group "${group}0x[0-9a-f][0-9a-f], ")
+endforeach()
+string(REGEX REPLACE "(${group})" "\\1\n\t" bytes "${bytes}")
+string(REPLACE " \n" "\n" bytes "${bytes}")
+
+file(WRITE "${OUTPUT}"
+"// Generated from ${INPUT} by CompileLua.cmake, do not edit.
+
+static const unsigned char ${NAME}_bytecode[] =
+{
+	${bytes}
+};
+")
@@ -33,6 +33,14 @@ AC_DEFUN([ACLOVE_DEP_MPG123], [
 		AC_SUBST([FILE_OFFSET],[-D_FILE_OFFSET_BITS=64]),
 		AC_SUBST([FILE_OFFSET],[]))])
 
+# C++ library, so only the header can be checked
+AC_DEFUN([ACLOVE_DEP_BASISU], [
+	AC_LANG_PUSH([C++])
+	AC_CHECK_HEADER([basisu_transcoder.h], [], [LOVE_MSG_ERROR([the Basis Universal transcoder])])
+	AC_LANG_POP([C++])
+	LIBS="$LIBS -lbasisu_transcoder"
+	AC_DEFINE([LOVE_SUPPORT_BASISU], [], [Enable Basis Universal transcoding])])
+
 AC_DEFUN([ACLOVE_DEP_GME], [
 	AC_SEARCH_LIBS([gme_open_data], [gme], [], [LOVE_MSG_ERROR([gme])])
 	AC_DEFINE([LOVE_SUPPORT_GME], [], [Enable gme])
@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "Runner.h"
+#include "common/version.h"
+
+// C++
+#include <algorithm>
+#include <chrono>
+
+namespace love
+{
+namespace bench
+{
+
+Runner::Runner(int repetitions, const std::string &filter)
+	: repetitions(std::max(repetitions, 1))
+	, filter(filter)
+{
+}
+
+bool Runner::isSelected(const std::string &name) const
+{
+	return filter.empty() || name.find(filter) != std::string::npos;
+}
+
+void Runner::run(const std::string &name, int64 operations, const std::function<void()> &body, const std::function<void()> &after)
+{
+	if (!isSelected(name))
+		return;
+
+	Result result;
+	result.name = name;
+	result.operations = std::max(operations, (int64) 1);
+
+	// The first run fills caches and lets the driver and allocator settle.
+	for (int i = -1; i < repetitions; i++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		body();
+		auto end = std::chrono::steady_clock::now();
+
+		if (after)
+			after();
+
+		if (i >= 0)
+			result.times.push_back(std::chrono::duration<double>(end - start).count());
+	}
+
+	std::sort(result.times.begin(), result.times.end());
+
+	double median = result.times[result.times.size() / 2];
+	fprintf(stderr, "%-40s %12.2f ns/op\n", name.c_str(), median * 1e9 / result.operations);
+
+	results.push_back(result);
+}
+
+void Runner::write(FILE *file) const
+{
+	fprintf(file, "{\n");
+	fprintf(file, "\t\"version\": \"%s\",\n", love::VERSION);
+	fprintf(file, "\t\"repetitions\": %d,\n", repetitions);
+	fprintf(file, "\t\"benchmarks\": [");
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const Result &r = results[i];
+		double median = r.times[r.times.size() / 2];
+
+		fprintf(file, "%s\n\t\t{", i > 0 ? "," : "");
+		fprintf(file, "\"name\": \"%s\", ", r.name.c_str());
+		fprintf(file, "\"operations\": %lld, ", (long long) r.operations);
+		fprintf(file, "\"median_seconds\": %.9g, ", median);
+		fprintf(file, "\"min_seconds\": %.9g, ", r.times.front());
+		fprintf(file, "\"max_seconds\": %.9g, ", r.times.back());
+		fprintf(file, "\"ns_per_op\": %.6g, ", median * 1e9 / r.operations);
+		fprintf(file, "\"ops_per_second\": %.6g}", median > 0.0 ? r.operations / median : 0.0);
+	}
+
+	fprintf(file, "\n\t]\n}\n");
+}
+
+void fillRandom(void *data, size_t size, uint32 seed, uint8 mask)
+{
+	uint8 *bytes = (uint8 *) data;
+	uint32 x = seed != 0 ? seed : 1;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		// xorshift32
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		bytes[i] = (uint8) (x & mask);
+	}
+}
+
+} // bench
+} // love
@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/int.h"
+
+// C++
+#include <functional>
+#include <string>
+#include <vector>
+#include <stdio.h>
+
+struct lua_State;
+
+namespace love
+{
+namespace bench
+{
+
+/**
+ * Runs benchmarks and collects their timings. Every benchmark is run once to
+ * warm up and then a fixed number of times, and the median is reported so a
+ * single slow run doesn't skew the result.
+ **/
+class Runner
+{
+public:
+
+	Runner(int repetitions, const std::string &filter);
+
+	/**
+	 * Whether the benchmark matches the filter given on the command line.
+	 * Can be used to skip expensive setup.
+	 **/
+	bool isSelected(const std::string &name) const;
+
+	/**
+	 * Times 'body', which does 'operations' units of work (draws, bytes,
+	 * messages...) per call. 'after' is called untimed after every call, to
+	 * end a frame or restore state which the body changed.
+	 **/
+	void run(const std::string &name, int64 operations, const std::function<void()> &body, const std::function<void()> &after = nullptr);
+
+	/**
+	 * Writes the results as JSON.
+	 **/
+	void write(FILE *file) const;
+
+private:
+
+	struct Result
+	{
+		std::string name;
+		int64 operations;
+		std::vector<double> times;
+	};
+
+	int repetitions;
+	std::string filter;
+
+	std::vector<Result> results;
+
+}; // Runner
+
+/**
+ * Fills memory with reproducible pseudo-random bytes. Only the bits in 'mask'
+ * are random, so lower masks give more compressible data.
+ **/
+void fillRandom(void *data, size_t size, uint32 seed, uint8 mask = 0xFF);
+
+void runGraphicsBenchmarks(Runner &runner);
+void runFontBenchmarks(Runner &runner);
+void runDataBenchmarks(Runner &runner, lua_State *L);
+void runThreadBenchmarks(Runner &runner);
+void runPhysicsBenchmarks(Runner &runner);
+
+} // bench
+} // love
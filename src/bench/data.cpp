@@ -0,0 +1,200 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Runner.h"
+#include "common/Module.h"
+#include "common/Object.h"
+#include "common/Variant.h"
+#include "common/runtime.h"
+#include "data/DataModule.h"
+#include "data/HashFunction.h"
+#include "filesystem/FileData.h"
+#include "image/Image.h"
+#include "image/ImageData.h"
+
+namespace love
+{
+namespace bench
+{
+
+static void runImageBenchmarks(Runner &runner)
+{
+	using namespace love::image;
+
+	auto imagemodule = Module::getInstance<Image>(Module::M_IMAGE);
+
+	const int size = 512;
+	const int pixels = size * size;
+
+	StrongRef<ImageData> source(imagemodule->newImageData(size, size, PIXELFORMAT_RGBA8), Acquire::NORETAIN);
+	StrongRef<ImageData> dest(imagemodule->newImageData(size, size, PIXELFORMAT_RGBA8), Acquire::NORETAIN);
+
+	// Some noise, but not so much that encoding only hits the worst case.
+	fillRandom(source->getData(), source->getSize(), 0x12345678, 0x3F);
+
+	const int tile = 128;
+
+	runner.run("image.paste", pixels, [&]()
+	{
+		for (int y = 0; y < size; y += tile)
+		{
+			for (int x = 0; x < size; x += tile)
+				dest->paste(source, x, y, size - x - tile, size - y - tile, tile, tile);
+		}
+	});
+
+	const FormatHandler::EncodedFormat formats[] = {FormatHandler::ENCODED_PNG, FormatHandler::ENCODED_TGA};
+	const char *names[] = {"png", "tga"};
+
+	for (int i = 0; i < 2; i++)
+	{
+		std::string name = names[i];
+
+		runner.run("image.encode." + name, pixels, [&]()
+		{
+			source->encode(formats[i], ("bench." + name).c_str(), false)->release();
+		});
+
+		if (!runner.isSelected("image.decode." + name))
+			continue;
+
+		StrongRef<love::filesystem::FileData> encoded(source->encode(formats[i], ("bench." + name).c_str(), false), Acquire::NORETAIN);
+
+		runner.run("image.decode." + name, pixels, [&]()
+		{
+			imagemodule->newImageData(encoded)->release();
+		});
+	}
+}
+
+static void runCompressorBenchmarks(Runner &runner)
+{
+	using namespace love::data;
+
+	const size_t size = 4 * 1024 * 1024;
+	std::vector<char> input(size);
+	fillRandom(input.data(), size, 0x9E3779B9, 0x0F);
+
+	const Compressor::Format formats[] = {Compressor::FORMAT_LZ4, Compressor::FORMAT_ZLIB, Compressor::FORMAT_ZSTD};
+
+	for (Compressor::Format format : formats)
+	{
+		const char *fname = nullptr;
+		Compressor::getConstant(format, fname);
+		std::string name = fname;
+
+		StrongRef<CompressedData> compressed;
+
+		// Formats which weren't compiled in are skipped.
+		try
+		{
+			compressed.set(compress(format, input.data(), size), Acquire::NORETAIN);
+		}
+		catch (love::Exception &)
+		{
+			continue;
+		}
+
+		runner.run("data.compress." + name, size, [&]()
+		{
+			compress(format, input.data(), size)->release();
+		});
+
+		runner.run("data.decompress." + name, size, [&]()
+		{
+			size_t rawsize = 0;
+			delete[] decompress(compressed, rawsize);
+		});
+	}
+}
+
+static void runHashBenchmarks(Runner &runner)
+{
+	using namespace love::data;
+
+	const size_t size = 1024 * 1024;
+	std::vector<char> input(size);
+	fillRandom(input.data(), size, 0xDEADBEEF);
+
+	const HashFunction::Function functions[] =
+	{
+		HashFunction::FUNCTION_MD5,
+		HashFunction::FUNCTION_SHA1,
+		HashFunction::FUNCTION_SHA256,
+		HashFunction::FUNCTION_XXH64,
+		HashFunction::FUNCTION_XXH3_64,
+	};
+
+	for (HashFunction::Function function : functions)
+	{
+		const char *fname = nullptr;
+		HashFunction::getConstant(function, fname);
+
+		HashFunction *hasher = HashFunction::getHashFunction(function);
+		if (hasher == nullptr)
+			continue;
+
+		runner.run(std::string("data.hash.") + fname, size, [&]()
+		{
+			HashFunction::Value value;
+			hasher->hash(function, input.data(), size, value);
+		});
+	}
+}
+
+static void runVariantBenchmarks(Runner &runner, lua_State *L)
+{
+	const char *code =
+		"return {x = 10, y = 20.5, name = 'player', alive = true,"
+		" inventory = {'sword', 'shield', 'potion'}, stats = {hp = 100, mp = 30}}";
+
+	if (luaL_dostring(L, code) != 0)
+	{
+		fprintf(stderr, "Could not create the Variant test table: %s\n", lua_tostring(L, -1));
+		lua_pop(L, 1);
+		return;
+	}
+
+	const int count = 1000;
+
+	runner.run("variant.table.roundtrip", count, [&]()
+	{
+		for (int i = 0; i < count; i++)
+		{
+			Variant v = Variant::fromLua(L, -1);
+			v.toLua(L);
+			lua_pop(L, 1);
+		}
+	});
+
+	lua_pop(L, 1);
+}
+
+void runDataBenchmarks(Runner &runner, lua_State *L)
+{
+	runImageBenchmarks(runner);
+	runCompressorBenchmarks(runner);
+	runHashBenchmarks(runner);
+	runVariantBenchmarks(runner, L);
+}
+
+} // bench
+} // love
@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Runner.h"
+#include "common/Module.h"
+#include "common/Object.h"
+#include "font/Font.h"
+#include "graphics/Graphics.h"
+#include "graphics/SpriteBatch.h"
+#include "graphics/ParticleSystem.h"
+
+namespace love
+{
+namespace bench
+{
+
+static const char *LOREM =
+	"Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+	"tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+	"veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+	"commodo consequat. Duis aute irure dolor in reprehenderit in voluptate "
+	"velit esse cillum dolore eu fugiat nulla pariatur.\n"
+	"Excepteur sint occaecat cupidatat non proident, sunt in culpa qui officia "
+	"deserunt mollit anim id est laborum.";
+
+void runGraphicsBenchmarks(Runner &runner)
+{
+	using namespace love::graphics;
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (gfx == nullptr || !gfx->isCreated())
+	{
+		fprintf(stderr, "Skipping the graphics benchmarks, there's no window.\n");
+		return;
+	}
+
+	// Ending the frame keeps the stream buffers cycling the way they do in a
+	// game, without timing the buffer swap itself.
+	auto present = [gfx]() { gfx->present(nullptr); };
+
+	const int count = 10000;
+
+	runner.run("graphics.stream.rectangles", count, [&]()
+	{
+		for (int i = 0; i < count; i++)
+			gfx->rectangle(Graphics::DRAW_FILL, (float) (i % 100), (float) (i / 100), 4.0f, 4.0f);
+		gfx->flushStreamDraws();
+	}, present);
+
+	Canvas::Settings settings;
+	settings.width = 64;
+	settings.height = 64;
+	StrongRef<Canvas> canvas(gfx->newCanvas(settings), Acquire::NORETAIN);
+
+	if (runner.isSelected("graphics.spritebatch.add_flush"))
+	{
+		StrongRef<SpriteBatch> batch(gfx->newSpriteBatch(canvas, count, vertex::USAGE_DYNAMIC), Acquire::NORETAIN);
+
+		runner.run("graphics.spritebatch.add_flush", count, [&]()
+		{
+			batch->clear();
+			for (int i = 0; i < count; i++)
+				batch->add(Matrix4((float) (i % 100), (float) (i / 100), 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f));
+			batch->flush();
+		}, present);
+	}
+
+	if (runner.isSelected("graphics.particlesystem.update"))
+	{
+		StrongRef<ParticleSystem> particles(gfx->newParticleSystem(canvas, count), Acquire::NORETAIN);
+		particles->setEmissionRate(5000.0f);
+		particles->setParticleLifetime(1.0f, 2.0f);
+		particles->setSpeed(50.0f, 100.0f);
+		particles->start();
+
+		// Run until the emission and expiry rates are balanced.
+		for (int i = 0; i < 120; i++)
+			particles->update(1.0f / 60.0f);
+
+		const int frames = 60;
+		runner.run("graphics.particlesystem.update", frames, [&]()
+		{
+			for (int i = 0; i < frames; i++)
+				particles->update(1.0f / 60.0f);
+		});
+	}
+
+	if (runner.isSelected("graphics.font.layout"))
+	{
+		auto fontmodule = Module::getInstance<love::font::Font>(Module::M_FONT);
+		StrongRef<love::font::Rasterizer> rasterizer(fontmodule->newTrueTypeRasterizer(14, love::font::TrueTypeRasterizer::HINTING_NORMAL), Acquire::NORETAIN);
+		StrongRef<Font> font(gfx->newFont(rasterizer), Acquire::NORETAIN);
+
+		std::vector<Font::ColoredString> text = {{LOREM, Colorf(1.0f, 1.0f, 1.0f, 1.0f)}};
+		Font::ColoredCodepoints codepoints;
+		Font::getCodepointsFromString(text, codepoints);
+
+		std::vector<Font::GlyphVertex> vertices;
+
+		runner.run("graphics.font.layout", (int64) codepoints.cps.size(), [&]()
+		{
+			vertices.clear();
+			font->generateVerticesFormatted(codepoints, Colorf(1.0f, 1.0f, 1.0f, 1.0f), 300.0f, Font::ALIGN_LEFT, vertices);
+		});
+	}
+}
+
+void runFontBenchmarks(Runner &runner)
+{
+	using namespace love::font;
+
+	if (!runner.isSelected("font.rasterize"))
+		return;
+
+	auto fontmodule = Module::getInstance<Font>(Module::M_FONT);
+	StrongRef<Rasterizer> rasterizer(fontmodule->newTrueTypeRasterizer(14, TrueTypeRasterizer::HINTING_NORMAL), Acquire::NORETAIN);
+
+	// Printable ASCII.
+	const uint32 first = 32;
+	const uint32 last = 126;
+
+	runner.run("font.rasterize", last - first + 1, [&]()
+	{
+		for (uint32 glyph = first; glyph <= last; glyph++)
+			rasterizer->getGlyphData(glyph)->release();
+	});
+}
+
+} // bench
+} // love
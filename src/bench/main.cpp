@@ -0,0 +1,155 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Runner.h"
+#include "common/runtime.h"
+#include "modules/love/love.h"
+
+// C
+#include <stdlib.h>
+#include <string.h>
+
+using namespace love;
+using namespace love::bench;
+
+static void printUsage()
+{
+	fprintf(stderr,
+		"Usage: love-bench [options]\n"
+		"  --filter <text>    Only run benchmarks whose names contain the text.\n"
+		"  --repetitions <n>  Timed runs per benchmark (default 5).\n"
+		"  --output <file>    Write the JSON results to a file instead of stdout.\n"
+		"  --no-graphics      Skip the benchmarks which need a window.\n");
+}
+
+static bool require(lua_State *L, const char *name)
+{
+	lua_getglobal(L, "require");
+	lua_pushstring(L, name);
+
+	if (lua_pcall(L, 1, 0, 0) != 0)
+	{
+		fprintf(stderr, "Could not load %s: %s\n", name, lua_tostring(L, -1));
+		lua_pop(L, 1);
+		return false;
+	}
+
+	return true;
+}
+
+static bool createWindow(lua_State *L)
+{
+	// Vsync would make the frame-based benchmarks measure the display rate.
+	const char *code = "love.window.setMode(256, 256, {vsync = 0, resizable = false})";
+
+	if (!require(L, "love.graphics") || !require(L, "love.window"))
+		return false;
+
+	if (luaL_dostring(L, code) != 0)
+	{
+		fprintf(stderr, "Could not create a window: %s\n", lua_tostring(L, -1));
+		lua_pop(L, 1);
+		return false;
+	}
+
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	std::string filter;
+	std::string output;
+	int repetitions = 5;
+	bool graphics = true;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+			filter = argv[++i];
+		else if (strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc)
+			repetitions = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+			output = argv[++i];
+		else if (strcmp(argv[i], "--no-graphics") == 0)
+			graphics = false;
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+
+	lua_State *L = luaL_newstate();
+	luaL_openlibs(L);
+
+	// The modules are loaded through Lua, the same way a game loads them, so
+	// they're set up exactly as they would be at runtime.
+	luax_preload(L, luaopen_love, "love");
+
+	const char *modules[] = {"love", "love.data", "love.image", "love.font", "love.thread", "love.physics"};
+	for (const char *name : modules)
+	{
+		if (!require(L, name))
+		{
+			lua_close(L);
+			return 1;
+		}
+	}
+
+	Runner runner(repetitions, filter);
+
+	try
+	{
+		if (graphics && createWindow(L))
+			runGraphicsBenchmarks(runner);
+
+		runFontBenchmarks(runner);
+		runDataBenchmarks(runner, L);
+		runThreadBenchmarks(runner);
+		runPhysicsBenchmarks(runner);
+	}
+	catch (std::exception &e)
+	{
+		fprintf(stderr, "Error: %s\n", e.what());
+		lua_close(L);
+		return 1;
+	}
+
+	FILE *file = stdout;
+	if (!output.empty())
+	{
+		file = fopen(output.c_str(), "w");
+		if (file == nullptr)
+		{
+			fprintf(stderr, "Could not open %s for writing.\n", output.c_str());
+			lua_close(L);
+			return 1;
+		}
+	}
+
+	runner.write(file);
+
+	if (file != stdout)
+		fclose(file);
+
+	lua_close(L);
+	return 0;
+}
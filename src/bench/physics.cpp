@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Runner.h"
+#include "common/Module.h"
+#include "common/Object.h"
+#include "physics/box2d/Physics.h"
+
+namespace love
+{
+namespace bench
+{
+
+using namespace love::physics::box2d;
+
+/**
+ * A box with a pile of circles falling into it, 64 pixels per meter.
+ **/
+static World *newScene(Physics *physics)
+{
+	World *world = physics->newWorld(0.0f, 9.81f * 64.0f, true);
+
+	Body *ground = physics->newBody(world, 400.0f, 600.0f, Body::BODY_STATIC);
+	const float walls[][4] =
+	{
+		{0.0f, 0.0f, 800.0f, 20.0f},
+		{-400.0f, -300.0f, 20.0f, 600.0f},
+		{400.0f, -300.0f, 20.0f, 600.0f},
+	};
+
+	for (const auto &wall : walls)
+	{
+		Shape *shape = physics->newRectangleShape(wall[0], wall[1], wall[2], wall[3]);
+		physics->newFixture(ground, shape, 1.0f)->release();
+		shape->release();
+	}
+
+	ground->release();
+
+	Shape *circle = physics->newCircleShape(6.0f);
+
+	for (int i = 0; i < 500; i++)
+	{
+		float x = 50.0f + (i % 50) * 14.0f + (i / 50 % 2) * 7.0f;
+		float y = 50.0f + (i / 50) * 14.0f;
+
+		Body *body = physics->newBody(world, x, y, Body::BODY_DYNAMIC);
+		physics->newFixture(body, circle, 1.0f)->release();
+		body->release();
+	}
+
+	circle->release();
+
+	return world;
+}
+
+void runPhysicsBenchmarks(Runner &runner)
+{
+	if (!runner.isSelected("physics.world.step"))
+		return;
+
+	auto physics = Module::getInstance<Physics>(Module::M_PHYSICS);
+
+	World *world = newScene(physics);
+
+	// Every run simulates the same second, starting from a fresh scene.
+	auto reset = [&]()
+	{
+		world->destroy();
+		world->release();
+		world = newScene(physics);
+	};
+
+	const int steps = 60;
+
+	runner.run("physics.world.step", steps, [&]()
+	{
+		for (int i = 0; i < steps; i++)
+			world->update(1.0f / 60.0f);
+	}, reset);
+
+	world->destroy();
+	world->release();
+}
+
+} // bench
+} // love
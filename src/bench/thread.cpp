@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Runner.h"
+#include "common/Object.h"
+#include "common/Variant.h"
+#include "thread/Channel.h"
+#include "thread/threads.h"
+
+namespace love
+{
+namespace bench
+{
+
+namespace
+{
+
+class Producer : public love::thread::Threadable
+{
+public:
+
+	Producer(love::thread::Channel *channel, int count)
+		: channel(channel)
+		, count(count)
+	{
+		setThreadName("Bench producer");
+	}
+
+	void threadFunction() override
+	{
+		for (int i = 0; i < count; i++)
+			channel->push(Variant((double) i));
+	}
+
+private:
+
+	StrongRef<love::thread::Channel> channel;
+	int count;
+
+}; // Producer
+
+} // anonymous namespace
+
+void runThreadBenchmarks(Runner &runner)
+{
+	using namespace love::thread;
+
+	const int messages = 100000;
+	const int producercounts[] = {1, 4};
+
+	for (int producercount : producercounts)
+	{
+		std::string name = "thread.channel.push_pop." + std::to_string(producercount);
+		StrongRef<Channel> channel(new Channel(), Acquire::NORETAIN);
+
+		runner.run(name, messages, [&]()
+		{
+			std::vector<StrongRef<Producer>> producers;
+			for (int i = 0; i < producercount; i++)
+			{
+				producers.emplace_back(new Producer(channel, messages / producercount), Acquire::NORETAIN);
+				producers.back()->start();
+			}
+
+			Variant v;
+			for (int i = 0; i < (messages / producercount) * producercount; i++)
+				channel->demand(&v);
+
+			for (const auto &producer : producers)
+				producer->wait();
+		});
+	}
+}
+
+} // bench
+} // love
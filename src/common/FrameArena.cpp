@@ -0,0 +1,170 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "FrameArena.h"
+#include "memory.h"
+#include "Exception.h"
+
+// C++
+#include <algorithm>
+
+namespace love
+{
+
+static thread_local FrameArena *currentArena = nullptr;
+
+FrameArena::FrameArena(size_t chunksize)
+	: chunkSize(chunksize)
+	, currentChunk(0)
+	, offset(0)
+	, usedSize(0)
+	, liveAllocations(0)
+{
+}
+
+FrameArena::~FrameArena()
+{
+	if (currentArena == this)
+		currentArena = nullptr;
+
+	for (const Chunk &chunk : chunks)
+		alignedFree(chunk.memory);
+}
+
+void *FrameArena::allocate(size_t size, size_t alignment)
+{
+	if (size == 0)
+		size = 1;
+
+	uint8 *mem = nullptr;
+
+	if (currentChunk < chunks.size())
+	{
+		const Chunk &chunk = chunks[currentChunk];
+		size_t start = alignUp((size_t) chunk.memory + offset, alignment) - (size_t) chunk.memory;
+
+		if (start + size <= chunk.size)
+		{
+			mem = chunk.memory + start;
+			offset = start + size;
+		}
+	}
+
+	if (mem == nullptr)
+		mem = allocateInNewChunk(size, alignment);
+
+	usedSize += size;
+	liveAllocations++;
+
+	return mem;
+}
+
+uint8 *FrameArena::allocateInNewChunk(size_t size, size_t alignment)
+{
+	// Chunk memory is page-aligned, so any smaller alignment is already met at
+	// the start of a chunk.
+	size_t chunksize = std::max(chunkSize, alignUp(size + alignment, getPageSize()));
+
+	if (!chunks.empty())
+		currentChunk++;
+
+	// Skip past chunks kept from an earlier frame which are too small.
+	while (currentChunk < chunks.size() && chunks[currentChunk].size < size + alignment)
+		currentChunk++;
+
+	if (currentChunk >= chunks.size())
+	{
+		Chunk chunk;
+		if (!alignedMalloc((void **) &chunk.memory, chunksize, std::max(alignment, getPageSize())))
+			throw love::Exception("Out of memory.");
+
+		chunk.size = chunksize;
+		chunks.push_back(chunk);
+		currentChunk = chunks.size() - 1;
+	}
+
+	const Chunk &chunk = chunks[currentChunk];
+	size_t start = alignUp((size_t) chunk.memory, alignment) - (size_t) chunk.memory;
+	offset = start + size;
+
+	return chunk.memory + start;
+}
+
+void FrameArena::deallocate(void *mem)
+{
+	if (mem != nullptr && liveAllocations > 0)
+		liveAllocations--;
+}
+
+void FrameArena::reset()
+{
+	if (liveAllocations > 0)
+		return;
+
+	// Replace the chunks with a single one which can hold everything this
+	// frame needed, so later frames don't have to hop between chunks.
+	if (chunks.size() > 1)
+	{
+		size_t total = 0;
+		for (const Chunk &chunk : chunks)
+		{
+			total += chunk.size;
+			alignedFree(chunk.memory);
+		}
+
+		chunks.clear();
+
+		Chunk chunk;
+		if (alignedMalloc((void **) &chunk.memory, total, getPageSize()))
+		{
+			chunk.size = total;
+			chunks.push_back(chunk);
+		}
+	}
+
+	currentChunk = 0;
+	offset = 0;
+	usedSize = 0;
+}
+
+size_t FrameArena::getUsedSize() const
+{
+	return usedSize;
+}
+
+size_t FrameArena::getCapacity() const
+{
+	size_t capacity = 0;
+	for (const Chunk &chunk : chunks)
+		capacity += chunk.size;
+	return capacity;
+}
+
+FrameArena *FrameArena::getCurrent()
+{
+	return currentArena;
+}
+
+void FrameArena::setCurrent(FrameArena *arena)
+{
+	currentArena = arena;
+}
+
+} // love
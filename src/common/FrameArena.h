@@ -0,0 +1,157 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "int.h"
+
+// C++
+#include <stddef.h>
+#include <memory>
+#include <vector>
+
+namespace love
+{
+
+/**
+ * A bump allocator for memory which only has to live until the end of the
+ * current frame. Allocations are carved out of large chunks and are all freed
+ * at once by reset(), which the owner calls once per frame.
+ **/
+class FrameArena
+{
+public:
+
+	static const size_t DEFAULT_CHUNK_SIZE = 256 * 1024;
+
+	FrameArena(size_t chunksize = DEFAULT_CHUNK_SIZE);
+	~FrameArena();
+
+	/**
+	 * 'alignment' must be a power of two.
+	 **/
+	void *allocate(size_t size, size_t alignment);
+
+	/**
+	 * The memory isn't reused until the next reset, this only keeps track of
+	 * how many allocations are still live.
+	 **/
+	void deallocate(void *mem);
+
+	/**
+	 * Frees all allocations made since the last reset. If the frame needed
+	 * more than one chunk they're merged into one big enough for the whole
+	 * frame. Nothing is freed while allocations are still live (for example
+	 * a container which outlived its frame), they're picked up by a later
+	 * reset instead.
+	 **/
+	void reset();
+
+	size_t getUsedSize() const;
+	size_t getCapacity() const;
+
+	/**
+	 * The arena used by ArenaAllocator on the calling thread, or null if
+	 * allocations should come from the heap.
+	 **/
+	static FrameArena *getCurrent();
+	static void setCurrent(FrameArena *arena);
+
+private:
+
+	struct Chunk
+	{
+		uint8 *memory;
+		size_t size;
+	};
+
+	uint8 *allocateInNewChunk(size_t size, size_t alignment);
+
+	std::vector<Chunk> chunks;
+	size_t chunkSize;
+
+	size_t currentChunk;
+	size_t offset;
+
+	size_t usedSize;
+	size_t liveAllocations;
+
+}; // FrameArena
+
+/**
+ * A standard allocator which uses the thread's current FrameArena when it's
+ * created, and the heap when there is none. Containers using it must not
+ * outlive the frame they're created in.
+ **/
+template <typename T>
+class ArenaAllocator
+{
+public:
+
+	typedef T value_type;
+
+	ArenaAllocator()
+		: arena(FrameArena::getCurrent())
+	{}
+
+	template <typename U>
+	ArenaAllocator(const ArenaAllocator<U> &other)
+		: arena(other.arena)
+	{}
+
+	T *allocate(size_t n)
+	{
+		if (arena != nullptr)
+			return (T *) arena->allocate(sizeof(T) * n, alignof(T));
+		return std::allocator<T>().allocate(n);
+	}
+
+	void deallocate(T *p, size_t n)
+	{
+		if (arena != nullptr)
+			arena->deallocate(p);
+		else
+			std::allocator<T>().deallocate(p, n);
+	}
+
+	FrameArena *arena;
+
+}; // ArenaAllocator
+
+template <typename T, typename U>
+bool operator == (const ArenaAllocator<T> &a, const ArenaAllocator<U> &b)
+{
+	return a.arena == b.arena;
+}
+
+template <typename T, typename U>
+bool operator != (const ArenaAllocator<T> &a, const ArenaAllocator<U> &b)
+{
+	return a.arena != b.arena;
+}
+
+/**
+ * A vector for temporary data which is only needed during the current frame.
+ **/
+template <typename T>
+using ScratchVector = std::vector<T, ArenaAllocator<T>>;
+
+} // love
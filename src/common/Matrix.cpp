@@ -20,6 +20,7 @@
 
 #include "Matrix.h"
 #include "common/config.h"
+#include "common/int.h"
 
 // STD
 #include <cstring> // memcpy
@@ -29,6 +30,10 @@
 #include <xmmintrin.h>
 #endif
 
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace love
 {
 
@@ -100,6 +105,150 @@ void Matrix4::multiply(const Matrix4 &a, const Matrix4 &b, Matrix4 &t)
 	multiply(a, b, t.e);
 }
 
+//                 | x |
+//                 | y |
+//                 | 0 |
+//                 | 1 |
+// | e0 e4 e8  e12 |
+// | e1 e5 e9  e13 |
+// | e2 e6 e10 e14 |
+// | e3 e7 e11 e15 |
+
+void Matrix4::transformXY(float *dst, size_t dststride, const float *src, size_t srcstride, int size) const
+{
+	const uint8 *s = (const uint8 *) src;
+	uint8 *d = (uint8 *) dst;
+
+	int i = 0;
+
+#if defined(LOVE_SIMD_SSE)
+
+	// Two vertices per iteration, as [x0 y0 x1 y1].
+	const __m128 col1 = _mm_setr_ps(e[0], e[1], e[0], e[1]);
+	const __m128 col2 = _mm_setr_ps(e[4], e[5], e[4], e[5]);
+	const __m128 col4 = _mm_setr_ps(e[12], e[13], e[12], e[13]);
+
+	for (; i + 2 <= size; i += 2)
+	{
+		__m128 v = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *) s);
+		v = _mm_loadh_pi(v, (const __m64 *) (s + srcstride));
+
+		__m128 xx = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0));
+		__m128 yy = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+
+		__m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xx, col1), _mm_mul_ps(yy, col2)), col4);
+
+		_mm_storel_pi((__m64 *) d, r);
+		_mm_storeh_pi((__m64 *) (d + dststride), r);
+
+		s += srcstride * 2;
+		d += dststride * 2;
+	}
+
+#elif defined(LOVE_SIMD_NEON)
+
+	const float32x2_t col1 = vld1_f32(&e[0]);
+	const float32x2_t col2 = vld1_f32(&e[4]);
+	const float32x2_t col4 = vld1_f32(&e[12]);
+
+	for (; i < size; i++)
+	{
+		float32x2_t v = vld1_f32((const float *) s);
+		float32x2_t r = vmla_lane_f32(vmla_lane_f32(col4, col1, v, 0), col2, v, 1);
+		vst1_f32((float *) d, r);
+
+		s += srcstride;
+		d += dststride;
+	}
+
+#endif
+
+	for (; i < size; i++)
+	{
+		const float *sv = (const float *) s;
+		float *dv = (float *) d;
+
+		// Store in temp variables in case src = dst
+		float x = (e[0]*sv[0]) + (e[4]*sv[1]) + (0) + (e[12]);
+		float y = (e[1]*sv[0]) + (e[5]*sv[1]) + (0) + (e[13]);
+
+		dv[0] = x;
+		dv[1] = y;
+
+		s += srcstride;
+		d += dststride;
+	}
+}
+
+void Matrix4::transformXY0(float *dst, size_t dststride, const float *src, size_t srcstride, int size) const
+{
+	const uint8 *s = (const uint8 *) src;
+	uint8 *d = (uint8 *) dst;
+
+	int i = 0;
+
+#if defined(LOVE_SIMD_SSE)
+
+	const __m128 col1 = _mm_loadu_ps(&e[0]);
+	const __m128 col2 = _mm_loadu_ps(&e[4]);
+	const __m128 col4 = _mm_loadu_ps(&e[12]);
+
+	for (; i < size; i++)
+	{
+		const float *sv = (const float *) s;
+		float *dv = (float *) d;
+
+		__m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(sv[0]), col1), _mm_mul_ps(_mm_set1_ps(sv[1]), col2)), col4);
+
+		// Only x, y and z are written, the destination may be tightly packed.
+		_mm_storel_pi((__m64 *) dv, r);
+		_mm_store_ss(dv + 2, _mm_movehl_ps(r, r));
+
+		s += srcstride;
+		d += dststride;
+	}
+
+#elif defined(LOVE_SIMD_NEON)
+
+	const float32x4_t col1 = vld1q_f32(&e[0]);
+	const float32x4_t col2 = vld1q_f32(&e[4]);
+	const float32x4_t col4 = vld1q_f32(&e[12]);
+
+	for (; i < size; i++)
+	{
+		const float *sv = (const float *) s;
+		float *dv = (float *) d;
+
+		float32x4_t r = vmlaq_n_f32(vmlaq_n_f32(col4, col1, sv[0]), col2, sv[1]);
+
+		vst1_f32(dv, vget_low_f32(r));
+		vst1q_lane_f32(dv + 2, r, 2);
+
+		s += srcstride;
+		d += dststride;
+	}
+
+#endif
+
+	for (; i < size; i++)
+	{
+		const float *sv = (const float *) s;
+		float *dv = (float *) d;
+
+		// Store in temp variables in case src = dst
+		float x = (e[0]*sv[0]) + (e[4]*sv[1]) + (0) + (e[12]);
+		float y = (e[1]*sv[0]) + (e[5]*sv[1]) + (0) + (e[13]);
+		float z = (e[2]*sv[0]) + (e[6]*sv[1]) + (0) + (e[14]);
+
+		dv[0] = x;
+		dv[1] = y;
+		dv[2] = z;
+
+		s += srcstride;
+		d += dststride;
+	}
+}
+
 // | e0 e4 e8  e12 |
 // | e1 e5 e9  e13 |
 // | e2 e6 e10 e14 |
@@ -186,7 +186,8 @@ public:
 
 	/**
 	 * Transforms an array of 2-component vertices by this Matrix. The source
-	 * and destination arrays may be the same.
+	 * and destination arrays may be the same. The vertex types must store x
+	 * and y as adjacent floats.
 	 **/
 	template <typename Vdst, typename Vsrc>
 	void transformXY(Vdst *dst, const Vsrc *src, int size) const;
@@ -198,6 +199,14 @@ public:
 	template <typename Vdst, typename Vsrc>
 	void transformXY0(Vdst *dst, const Vsrc *src, int size) const;
 
+	/**
+	 * Versions of the above for arbitrary vertex layouts. The pointers are to
+	 * the x component of the first source and destination vertex, and the
+	 * strides are the distances in bytes between consecutive vertices.
+	 **/
+	void transformXY(float *dst, size_t dststride, const float *src, size_t srcstride, int size) const;
+	void transformXY0(float *dst, size_t dststride, const float *src, size_t srcstride, int size) const;
+
 	/**
 	 * Transforms an array of 3-component vertices by this Matrix. The source
 	 * and destination arrays may be the same.
@@ -315,31 +324,15 @@ private:
 template <typename Vdst, typename Vsrc>
 void Matrix4::transformXY(Vdst *dst, const Vsrc *src, int size) const
 {
-	for (int i = 0; i < size; i++)
-	{
-		// Store in temp variables in case src = dst
-		float x = (e[0]*src[i].x) + (e[4]*src[i].y) + (0) + (e[12]);
-		float y = (e[1]*src[i].x) + (e[5]*src[i].y) + (0) + (e[13]);
-
-		dst[i].x = x;
-		dst[i].y = y;
-	}
+	if (size > 0)
+		transformXY(&dst->x, sizeof(Vdst), &src->x, sizeof(Vsrc), size);
 }
 
 template <typename Vdst, typename Vsrc>
 void Matrix4::transformXY0(Vdst *dst, const Vsrc *src, int size) const
 {
-	for (int i = 0; i < size; i++)
-	{
-		// Store in temp variables in case src = dst
-		float x = (e[0]*src[i].x) + (e[4]*src[i].y) + (0) + (e[12]);
-		float y = (e[1]*src[i].x) + (e[5]*src[i].y) + (0) + (e[13]);
-		float z = (e[2]*src[i].x) + (e[6]*src[i].y) + (0) + (e[14]);
-
-		dst[i].x = x;
-		dst[i].y = y;
-		dst[i].z = z;
-	}
+	if (size > 0)
+		transformXY0(&dst->x, sizeof(Vdst), &src->x, sizeof(Vsrc), size);
 }
 
 //                 | x |
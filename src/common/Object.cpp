@@ -20,6 +20,7 @@
 
 // LOVE
 #include "Object.h"
+#include "memory.h"
 
 namespace love
 {
@@ -28,16 +29,28 @@ love::Type Object::type("Object", nullptr);
 
 Object::Object()
 	: count(1)
+	, threadConfined(false)
+	, proxyOwner(nullptr)
+	, proxySlot(0)
+	, memoryType(nullptr)
+	, memorySize(0)
 {
 }
 
 Object::Object(const Object & /*other*/)
 	: count(1) // Always start with a reference count of 1.
+	, threadConfined(false)
+	, proxyOwner(nullptr)
+	, proxySlot(0)
+	, memoryType(nullptr)
+	, memorySize(0)
 {
 }
 
 Object::~Object()
 {
+	if (memoryType != nullptr)
+		addTypeMemoryStats(*memoryType, -1, -memorySize);
 }
 
 int Object::getReferenceCount() const
@@ -47,11 +60,27 @@ int Object::getReferenceCount() const
 
 void Object::retain()
 {
-	count.fetch_add(1, std::memory_order_relaxed);
+	// Relaxed loads and stores compile to plain memory accesses, without
+	// the cost of an atomic read-modify-write.
+	if (threadConfined)
+		count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	else
+		count.fetch_add(1, std::memory_order_relaxed);
 }
 
 void Object::release()
 {
+	if (threadConfined)
+	{
+		int newcount = count.load(std::memory_order_relaxed) - 1;
+		count.store(newcount, std::memory_order_relaxed);
+
+		if (newcount == 0)
+			delete this;
+
+		return;
+	}
+
 	// http://www.boost.org/doc/libs/1_56_0/doc/html/atomic/usage_examples.html
 	if (count.fetch_sub(1, std::memory_order_release) == 1)
 	{
@@ -60,4 +89,48 @@ void Object::release()
 	}
 }
 
+bool Object::isThreadConfined() const
+{
+	return threadConfined;
+}
+
+void Object::shareWithThreads()
+{
+	threadConfined = false;
+}
+
+int Object::getProxySlot(const void *owner) const
+{
+	return owner == proxyOwner ? proxySlot : 0;
+}
+
+void Object::setProxySlot(const void *owner, int slot)
+{
+	proxyOwner = owner;
+	proxySlot = slot;
+}
+
+int64 Object::getNativeMemorySize() const
+{
+	return memorySize;
+}
+
+void Object::setNativeMemorySize(Type &type, int64 bytes)
+{
+	if (memoryType == nullptr)
+	{
+		memoryType = &type;
+		addTypeMemoryStats(type, 1, bytes);
+	}
+	else
+		addTypeMemoryStats(type, 0, bytes - memorySize);
+
+	memorySize = bytes;
+}
+
+void Object::confineToThread()
+{
+	threadConfined = true;
+}
+
 } // love
@@ -71,11 +71,71 @@ public:
 	 **/
 	void release();
 
+	/**
+	 * Whether retain and release use plain instead of atomic operations,
+	 * because the Object is only used by one thread at a time.
+	 **/
+	bool isThreadConfined() const;
+
+	/**
+	 * Switches the Object to atomic reference counting for good, so any
+	 * thread can retain and release it. Must be called by the thread using
+	 * the Object, before it's handed to another thread. Variants do this for
+	 * the Objects they hold.
+	 **/
+	void shareWithThreads();
+
+	/**
+	 * Gets the slot holding the Object's Lua proxy in the objects table
+	 * identified by owner, or 0 if it has none there. See luax_pushtype.
+	 **/
+	int getProxySlot(const void *owner) const;
+
+	/**
+	 * Remembers the slot holding the Object's Lua proxy. Only for
+	 * thread-confined Objects, since other threads may read it.
+	 **/
+	void setProxySlot(const void *owner, int slot);
+
+	/**
+	 * Gets the native memory owned by the Object, as last reported with
+	 * setNativeMemorySize.
+	 **/
+	int64 getNativeMemorySize() const;
+
+protected:
+
+	/**
+	 * Reports the native memory owned by the Object, for the memory stats of
+	 * the given type. The first call also counts the Object as a live object
+	 * of that type, until it's destroyed. Later calls must use the same type.
+	 **/
+	void setNativeMemorySize(Type &type, int64 bytes);
+
+	/**
+	 * Opts a new Object into plain reference counting. Only for types that
+	 * stay on the thread which uses them, like the ones tracked by the
+	 * Memoizer, whose references are changed a lot by wrapper calls.
+	 **/
+	void confineToThread();
+
 private:
 
 	// The reference count.
 	std::atomic<int> count;
 
+	// Only changed by the thread using the Object, before other threads can
+	// see it.
+	bool threadConfined;
+
+	// The objects table holding the Object's Lua proxy, and where.
+	const void *proxyOwner;
+	int proxySlot;
+
+	// The type the Object's memory is reported under, if it is.
+	Type *memoryType;
+	int64 memorySize;
+
 }; // Object
 
 
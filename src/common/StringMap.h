@@ -47,6 +47,8 @@ public:
 	};
 
 	StringMap(const Entry *entries, unsigned int num)
+		: seed(0)
+		, perfect(false)
 	{
 
 		for (unsigned int i = 0; i < SIZE; ++i)
@@ -54,8 +56,31 @@ public:
 
 		unsigned int n = num / sizeof(Entry);
 
+		// Look for a hash seed which gives every key its own slot, so a lookup
+		// is a single hash and string compare. Linear probing is used if none
+		// of the tried seeds work.
+		for (unsigned int s = 0; s < MAX_SEED_ATTEMPTS && !perfect; ++s)
+		{
+			bool used[MAX] = {};
+			perfect = true;
+
+			for (unsigned int i = 0; i < n && perfect; ++i)
+			{
+				unsigned int str_i = hash(entries[i].key, s) & (MAX - 1);
+				perfect = !used[str_i];
+				used[str_i] = true;
+			}
+
+			if (perfect)
+				seed = s;
+		}
+
+		bool isperfect = perfect;
+
 		for (unsigned int i = 0; i < n; ++i)
 			add(entries[i].key, entries[i].value);
+
+		perfect = isperfect;
 	}
 
 	bool streq(const char *a, const char *b)
@@ -74,20 +99,24 @@ public:
 
 	bool find(const char *key, T &t)
 	{
-		unsigned int str_hash = djb2(key);
+		unsigned int str_hash = hash(key, seed);
 
 		for (unsigned int i = 0; i < MAX; ++i)
 		{
-			unsigned int str_i = (str_hash + i) % MAX;
+			const Record &r = records[(str_hash + i) & (MAX - 1)];
 
-			if (!records[str_i].set)
+			if (!r.set)
 				return false;
 
-			if (streq(records[str_i].key, key))
+			if (r.hash == str_hash && streq(r.key, key))
 			{
-				t = records[str_i].value;
+				t = r.value;
 				return true;
 			}
+
+			// With a perfect seed, a key can only be in its own slot.
+			if (perfect)
+				return false;
 		}
 
 		return false;
@@ -113,12 +142,15 @@ public:
 
 	bool add(const char *key, T value)
 	{
-		unsigned int str_hash = djb2(key);
+		unsigned int str_hash = hash(key, seed);
 		bool inserted = false;
 
+		// Keys added later may not get their own slot.
+		perfect = false;
+
 		for (unsigned int i = 0; i < MAX; ++i)
 		{
-			unsigned int str_i = (str_hash + i) % MAX;
+			unsigned int str_i = (str_hash + i) & (MAX - 1);
 
 			if (!records[str_i].set)
 			{
@@ -126,6 +158,7 @@ public:
 				records[str_i].set = true;
 				records[str_i].key = key;
 				records[str_i].value = value;
+				records[str_i].hash = str_hash;
 				break;
 			}
 		}
@@ -143,17 +176,6 @@ public:
 		return inserted;
 	}
 
-	unsigned int djb2(const char *key)
-	{
-		unsigned int hash = 5381;
-		int c;
-
-		while ((c = *key++))
-			hash = ((hash << 5) + hash) + c;
-
-		return hash;
-	}
-
 	std::vector<std::string> getNames() const
 	{
 		std::vector<std::string> names;
@@ -172,15 +194,38 @@ private:
 	{
 		const char *key;
 		T value;
+		unsigned int hash;
 		bool set;
 		Record() : set(false) {}
 	};
 
-	static const unsigned int MAX = SIZE * 2;
+	// djb2, with the seed mixed into the starting value.
+	static unsigned int hash(const char *key, unsigned int seed)
+	{
+		unsigned int hash = 5381 + seed * 2654435761u;
+		int c;
+
+		while ((c = *key++))
+			hash = ((hash << 5) + hash) + c;
+
+		// Fold the high bits in, since only the low bits pick the slot.
+		return hash ^ (hash >> 15);
+	}
+
+	static constexpr unsigned int nextPowerOfTwo(unsigned int v, unsigned int p = 1)
+	{
+		return p >= v ? p : nextPowerOfTwo(v, p * 2);
+	}
+
+	static const unsigned int MAX = nextPowerOfTwo(SIZE * 2);
+	static const unsigned int MAX_SEED_ATTEMPTS = 256;
 
 	Record records[MAX];
 	const char *reverse[SIZE];
 
+	unsigned int seed;
+	bool perfect;
+
 }; // StringMap
 
 } // love
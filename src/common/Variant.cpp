@@ -18,7 +18,7 @@
  * 3. This notice may not be removed or altered from any source distribution.
  **/
 
-#include <memory>
+#include <algorithm>
 
 #include "Variant.h"
 #include "common/StringMap.h"
@@ -41,6 +41,411 @@ static Proxy *tryextractproxy(lua_State *L, int idx)
 	return nullptr;
 }
 
+namespace
+{
+
+// Encoded tables are a tree of tagged values, in native byte order:
+//
+//   table:  TAG_TABLE, uint32 numbercount, uint32 valuecount,
+//           uint32 paircount, double[numbercount], value[valuecount],
+//           (key, value)[paircount]
+//   others: the tag, then its payload (if any).
+//
+// The array part of a table is numbercount + valuecount long; its leading
+// numbers are stored without tags. String keys are stored in full the first
+// time they're seen (TAG_KEY), and by index after that (TAG_KEYREF).
+enum TableTag : uint8
+{
+	TAG_NIL,
+	TAG_FALSE,
+	TAG_TRUE,
+	TAG_NUMBER,    // double
+	TAG_STRING,    // uint32 length, bytes
+	TAG_KEY,       // uint32 length, bytes
+	TAG_KEYREF,    // uint32 index of an earlier TAG_KEY
+	TAG_LUSERDATA, // void *
+	TAG_OBJECT,    // love::Type *, love::Object *
+	TAG_TABLE,
+};
+
+class TableEncoder
+{
+public:
+
+	TableEncoder(std::vector<char> &out)
+		: hasObjects(false)
+		, out(out)
+		, keyCount(0)
+	{
+		memset(keyCache, 0, sizeof(keyCache));
+	}
+
+	// Returns false if the table contains a value Variants can't hold.
+	bool encodeTable(lua_State *L, int idx)
+	{
+		const void *tablepointer = lua_topointer(L, idx);
+		if (std::find(path.begin(), path.end(), tablepointer) != path.end())
+			throw love::Exception("Cycle detected in table");
+
+		if (!lua_checkstack(L, 3))
+			throw love::Exception("Table is nested too deeply.");
+
+		path.push_back(tablepointer);
+		bool success = encodeTableContents(L, idx);
+		path.pop_back();
+
+		return success;
+	}
+
+	bool hasObjects;
+
+private:
+
+	template <typename T>
+	void put(T value)
+	{
+		const char *bytes = (const char *) &value;
+		out.insert(out.end(), bytes, bytes + sizeof(T));
+	}
+
+	template <typename T>
+	void patch(size_t pos, T value)
+	{
+		memcpy(&out[pos], &value, sizeof(T));
+	}
+
+	void putString(TableTag tag, const char *str, size_t len)
+	{
+		put<uint8>(tag);
+		put<uint32>((uint32) len);
+		out.insert(out.end(), str, str + len);
+	}
+
+	bool encodeTableContents(lua_State *L, int idx)
+	{
+		size_t headerpos = out.size();
+		put<uint8>(TAG_TABLE);
+		put<uint32>(0);
+		put<uint32>(0);
+		put<uint32>(0);
+
+		size_t len = luax_objlen(L, idx);
+		size_t arraylen = 0;
+
+		for (; arraylen < len; arraylen++)
+		{
+			lua_rawgeti(L, idx, (int) arraylen + 1);
+			bool isnumber = lua_type(L, -1) == LUA_TNUMBER;
+			if (isnumber)
+				put<double>(lua_tonumber(L, -1));
+			lua_pop(L, 1);
+
+			if (!isnumber)
+				break;
+		}
+
+		size_t numbercount = arraylen;
+
+		// Anything after a hole goes into the hash part below.
+		for (; arraylen < len; arraylen++)
+		{
+			lua_rawgeti(L, idx, (int) arraylen + 1);
+
+			if (lua_isnil(L, -1))
+			{
+				lua_pop(L, 1);
+				break;
+			}
+
+			bool success = encodeValue(L, lua_gettop(L), false);
+			lua_pop(L, 1);
+
+			if (!success)
+				return false;
+		}
+
+		uint32 paircount = 0;
+
+		lua_pushnil(L);
+		while (lua_next(L, idx))
+		{
+			int keyidx = lua_gettop(L) - 1;
+
+			if (lua_type(L, keyidx) == LUA_TNUMBER)
+			{
+				lua_Number n = lua_tonumber(L, keyidx);
+				if (n >= 1 && n <= (lua_Number) arraylen && n == (lua_Number) (size_t) n)
+				{
+					lua_pop(L, 1);
+					continue;
+				}
+			}
+
+			if (!encodeValue(L, keyidx, true) || !encodeValue(L, keyidx + 1, false))
+			{
+				lua_pop(L, 2);
+				return false;
+			}
+
+			lua_pop(L, 1);
+			paircount++;
+		}
+
+		patch<uint32>(headerpos + 1, (uint32) numbercount);
+		patch<uint32>(headerpos + 5, (uint32) (arraylen - numbercount));
+		patch<uint32>(headerpos + 9, paircount);
+
+		return true;
+	}
+
+	bool encodeValue(lua_State *L, int idx, bool iskey)
+	{
+		switch (lua_type(L, idx))
+		{
+		case LUA_TBOOLEAN:
+			put<uint8>(lua_toboolean(L, idx) ? TAG_TRUE : TAG_FALSE);
+			return true;
+		case LUA_TNUMBER:
+			put<uint8>(TAG_NUMBER);
+			put<double>(lua_tonumber(L, idx));
+			return true;
+		case LUA_TSTRING:
+		{
+			size_t len = 0;
+			const char *str = lua_tolstring(L, idx, &len);
+
+			if (!iskey)
+			{
+				putString(TAG_STRING, str, len);
+				return true;
+			}
+
+			// Equal short strings share one pointer in Lua, and every key is
+			// kept alive by its table while encoding. A collision in this
+			// cache only means the key is written out again.
+			KeyCacheEntry &entry = keyCache[((size_t) str >> 4) % KEY_CACHE_SIZE];
+			if (entry.str == str)
+			{
+				put<uint8>(TAG_KEYREF);
+				put<uint32>(entry.index);
+			}
+			else
+			{
+				putString(TAG_KEY, str, len);
+				entry.str = str;
+				entry.index = keyCount++;
+			}
+			return true;
+		}
+		case LUA_TLIGHTUSERDATA:
+			put<uint8>(TAG_LUSERDATA);
+			put<void *>(lua_touserdata(L, idx));
+			return true;
+		case LUA_TUSERDATA:
+		{
+			Proxy *p = tryextractproxy(L, idx);
+			if (p == nullptr)
+			{
+				luax_typerror(L, idx, "love type");
+				return false;
+			}
+
+			// Tables can be read by other threads.
+			if (p->object != nullptr)
+				p->object->shareWithThreads();
+
+			put<uint8>(TAG_OBJECT);
+			put<love::Type *>(p->type);
+			put<love::Object *>(p->object);
+			hasObjects = true;
+			return true;
+		}
+		case LUA_TTABLE:
+			return encodeTable(L, idx);
+		default:
+			return false;
+		}
+	}
+
+	static const int KEY_CACHE_SIZE = 256;
+
+	struct KeyCacheEntry
+	{
+		const char *str;
+		uint32 index;
+	};
+
+	std::vector<char> &out;
+	std::vector<const void *> path;
+
+	KeyCacheEntry keyCache[KEY_CACHE_SIZE];
+	uint32 keyCount;
+
+}; // TableEncoder
+
+class TableReader
+{
+public:
+
+	TableReader(const char *bytes)
+		: p(bytes)
+	{
+	}
+
+	void pushValue(lua_State *L)
+	{
+		switch (get<uint8>())
+		{
+		case TAG_FALSE:
+			lua_pushboolean(L, 0);
+			break;
+		case TAG_TRUE:
+			lua_pushboolean(L, 1);
+			break;
+		case TAG_NUMBER:
+			lua_pushnumber(L, get<double>());
+			break;
+		case TAG_STRING:
+		{
+			uint32 len = get<uint32>();
+			lua_pushlstring(L, p, len);
+			p += len;
+			break;
+		}
+		case TAG_KEY:
+		{
+			uint32 len = get<uint32>();
+			keys.emplace_back(p, len);
+			lua_pushlstring(L, p, len);
+			p += len;
+			break;
+		}
+		case TAG_KEYREF:
+		{
+			const std::pair<const char *, uint32> &key = keys[get<uint32>()];
+			lua_pushlstring(L, key.first, key.second);
+			break;
+		}
+		case TAG_LUSERDATA:
+			lua_pushlightuserdata(L, get<void *>());
+			break;
+		case TAG_OBJECT:
+		{
+			love::Type *type = get<love::Type *>();
+			luax_pushtype(L, *type, get<love::Object *>());
+			break;
+		}
+		case TAG_TABLE:
+			pushTable(L);
+			break;
+		case TAG_NIL:
+		default:
+			lua_pushnil(L);
+			break;
+		}
+	}
+
+	// Calls fn for every love object, without touching Lua.
+	template <typename F>
+	void visitObjects(F fn)
+	{
+		switch (get<uint8>())
+		{
+		case TAG_NUMBER:
+			p += sizeof(double);
+			break;
+		case TAG_STRING:
+		case TAG_KEY:
+			p += get<uint32>();
+			break;
+		case TAG_KEYREF:
+			p += sizeof(uint32);
+			break;
+		case TAG_LUSERDATA:
+			p += sizeof(void *);
+			break;
+		case TAG_OBJECT:
+			p += sizeof(love::Type *);
+			fn(get<love::Object *>());
+			break;
+		case TAG_TABLE:
+		{
+			uint32 numbercount = get<uint32>();
+			uint32 valuecount = get<uint32>();
+			uint32 paircount = get<uint32>();
+
+			p += numbercount * sizeof(double);
+
+			for (uint32 i = 0; i < valuecount + paircount * 2; i++)
+				visitObjects(fn);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+private:
+
+	template <typename T>
+	T get()
+	{
+		T value;
+		memcpy(&value, p, sizeof(T));
+		p += sizeof(T);
+		return value;
+	}
+
+	void pushTable(lua_State *L)
+	{
+		uint32 numbercount = get<uint32>();
+		uint32 valuecount = get<uint32>();
+		uint32 paircount = get<uint32>();
+
+		luaL_checkstack(L, 3, "Table is nested too deeply.");
+		lua_createtable(L, (int) (numbercount + valuecount), (int) paircount);
+
+		for (uint32 i = 0; i < numbercount; i++)
+		{
+			lua_pushnumber(L, get<double>());
+			lua_rawseti(L, -2, (int) i + 1);
+		}
+
+		for (uint32 i = 0; i < valuecount; i++)
+		{
+			pushValue(L);
+			lua_rawseti(L, -2, (int) (numbercount + i) + 1);
+		}
+
+		for (uint32 i = 0; i < paircount; i++)
+		{
+			pushValue(L);
+			pushValue(L);
+			lua_rawset(L, -3);
+		}
+	}
+
+	const char *p;
+	std::vector<std::pair<const char *, uint32>> keys;
+
+}; // TableReader
+
+} // anonymous namespace
+
+Variant::SharedTable::SharedTable(std::vector<char> &&bytes, bool hasObjects)
+	: bytes(std::move(bytes))
+	, hasObjects(hasObjects)
+{
+	if (hasObjects)
+		TableReader(this->bytes.data()).visitObjects([](Object *o) { if (o) o->retain(); });
+}
+
+Variant::SharedTable::~SharedTable()
+{
+	if (hasObjects)
+		TableReader(bytes.data()).visitObjects([](Object *o) { if (o) o->release(); });
+}
+
 Variant::Variant()
 	: type(NIL)
 {
@@ -85,15 +490,12 @@ Variant::Variant(love::Type *lovetype, love::Object *object)
 	data.objectproxy.type = lovetype;
 	data.objectproxy.object = object;
 
+	// The Variant may be handed to another thread.
 	if (data.objectproxy.object != nullptr)
+	{
+		data.objectproxy.object->shareWithThreads();
 		data.objectproxy.object->retain();
-}
-
-// Variant gets ownership of the vector.
-Variant::Variant(std::vector<std::pair<Variant, Variant>> *table)
-	: type(TABLE)
-{
-	data.table = new SharedTable(table);
+	}
 }
 
 Variant::Variant(const Variant &v)
@@ -147,7 +549,7 @@ Variant &Variant::operator = (const Variant &v)
 	return *this;
 }
 
-Variant Variant::fromLua(lua_State *L, int n, std::set<const void*> *tableSet)
+Variant Variant::fromLua(lua_State *L, int n)
 {
 	size_t len;
 	const char *str;
@@ -180,48 +582,16 @@ Variant Variant::fromLua(lua_State *L, int n, std::set<const void*> *tableSet)
 		return Variant();
 	case LUA_TTABLE:
 		{
-			bool success = true;
-			std::unique_ptr<std::set<const void*>> tableSetPtr;
-			std::vector<std::pair<Variant, Variant>> *table = new std::vector<std::pair<Variant, Variant>>();
-
-			// If we had no tables argument, allocate one now, and store it in our unique_ptr
-			if (tableSet == nullptr)
-				tableSetPtr.reset(tableSet = new std::set<const void*>);
+			std::vector<char> bytes;
+			TableEncoder encoder(bytes);
 
-			// Now make sure this table wasn't already serialised
-			const void *tablePointer = lua_topointer(L, n);
+			if (encoder.encodeTable(L, n))
 			{
-				auto result = tableSet->insert(tablePointer);
-				if (!result.second) // insertion failed
-					throw love::Exception("Cycle detected in table");
+				Variant v;
+				v.type = TABLE;
+				v.data.table = new SharedTable(std::move(bytes), encoder.hasObjects);
+				return v;
 			}
-
-			size_t len = luax_objlen(L, -1);
-			if (len > 0)
-				table->reserve(len);
-
-			lua_pushnil(L);
-
-			while (lua_next(L, n))
-			{
-				table->emplace_back(fromLua(L, -2, tableSet), fromLua(L, -1, tableSet));
-				lua_pop(L, 1);
-
-				const auto &p = table->back();
-				if (p.first.getType() == UNKNOWN || p.second.getType() == UNKNOWN)
-				{
-					success = false;
-					break;
-				}
-			}
-
-			// And remove the table from the set again
-			tableSet->erase(tablePointer);
-
-			if (success)
-				return Variant(table);
-			else
-				delete table;
 		}
 		break;
 	}
@@ -254,22 +624,8 @@ void Variant::toLua(lua_State *L) const
 		luax_pushtype(L, *data.objectproxy.type, data.objectproxy.object);
 		break;
 	case TABLE:
-	{
-		std::vector<std::pair<Variant, Variant>> *table = data.table->table;
-		int tsize = (int) table->size();
-
-		lua_createtable(L, 0, tsize);
-
-		for (int i = 0; i < tsize; ++i)
-		{
-			std::pair<Variant, Variant> &kv = (*table)[i];
-			kv.first.toLua(L);
-			kv.second.toLua(L);
-			lua_settable(L, -3);
-		}
-
+		TableReader(data.table->bytes.data()).pushValue(L);
 		break;
-	}
 	case NIL:
 	default:
 		lua_pushnil(L);
@@ -27,7 +27,6 @@
 
 #include <cstring>
 #include <vector>
-#include <set>
 
 namespace love
 {
@@ -55,7 +54,6 @@ public:
 	Variant(const char *string, size_t len);
 	Variant(void *lightuserdata);
 	Variant(love::Type *type, love::Object *object);
-	Variant(std::vector<std::pair<Variant, Variant>> *table);
 	Variant(const Variant &v);
 	Variant(Variant &&v);
 	~Variant();
@@ -64,7 +62,7 @@ public:
 
 	Type getType() const { return type; }
 
-	static Variant fromLua(lua_State *L, int n, std::set<const void*> *tableSet = nullptr);
+	static Variant fromLua(lua_State *L, int n);
 	void toLua(lua_State *L) const;
 
 private:
@@ -85,18 +83,22 @@ private:
 		size_t len;
 	};
 
+	/**
+	 * A Lua table flattened into one contiguous buffer, so sending it to
+	 * another thread doesn't need an allocation per nested value. Repeated
+	 * string keys are stored once, and leading runs of numbers in arrays are
+	 * stored as packed doubles. See Variant.cpp for the layout.
+	 **/
 	class SharedTable : public love::Object
 	{
 	public:
 
-		SharedTable(std::vector<std::pair<Variant, Variant>> *table)
-			: table(table)
-		{
-		}
-
-		virtual ~SharedTable() { delete table; }
+		// Retains any love objects the encoded table refers to.
+		SharedTable(std::vector<char> &&bytes, bool hasObjects);
+		virtual ~SharedTable();
 
-		std::vector<std::pair<Variant, Variant>> *table;
+		std::vector<char> bytes;
+		bool hasObjects;
 	};
 
 	static const int MAX_SMALL_STRING_LENGTH = 15;
@@ -25,6 +25,9 @@
 #include "SDL.h"
 #include "jni.h"
 
+#include <android/asset_manager.h>
+#include <android/asset_manager_jni.h>
+
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -184,6 +187,65 @@ bool loadGameArchiveToMemory(const char* filename, char **ptr, size_t *size)
 	return true;
 }
 
+static AAssetManager *getAssetManager()
+{
+	static AAssetManager *manager = nullptr;
+
+	if (manager != nullptr)
+		return manager;
+
+	JNIEnv *env = (JNIEnv*) SDL_AndroidGetJNIEnv();
+
+	jobject activity = (jobject) SDL_AndroidGetActivity();
+
+	jclass clazz(env->GetObjectClass(activity));
+	jmethodID method_id = env->GetMethodID(clazz, "getAssets", "()Landroid/content/res/AssetManager;");
+
+	jobject assets = env->CallObjectMethod(activity, method_id);
+
+	// The native manager is only valid for as long as the Java one is, so
+	// it's kept alive for the rest of the process.
+	if (assets != nullptr)
+	{
+		jobject assets_ref = env->NewGlobalRef(assets);
+		manager = AAssetManager_fromJava(env, assets_ref);
+		env->DeleteLocalRef(assets);
+	}
+
+	env->DeleteLocalRef(activity);
+	env->DeleteLocalRef(clazz);
+
+	return manager;
+}
+
+int openAssetFileDescriptor(const char *filename, int64 *offset, int64 *length)
+{
+	AAssetManager *manager = getAssetManager();
+	if (manager == nullptr)
+		return -1;
+
+	// Asset paths are relative to the assets folder.
+	while (*filename == '/')
+		filename++;
+
+	AAsset *asset = AAssetManager_open(manager, filename, AASSET_MODE_UNKNOWN);
+	if (asset == nullptr)
+		return -1;
+
+	off64_t start = 0;
+	off64_t size = 0;
+	int fd = AAsset_openFileDescriptor64(asset, &start, &size);
+
+	AAsset_close(asset);
+
+	if (fd < 0)
+		return -1;
+
+	*offset = (int64) start;
+	*length = (int64) size;
+	return fd;
+}
+
 bool directoryExists(const char *path)
 {
 	struct stat s;
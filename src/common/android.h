@@ -22,6 +22,7 @@
 #define LOVE_ANDROID_H
 
 #include "config.h"
+#include "int.h"
 
 #ifdef LOVE_ANDROID
 
@@ -60,6 +61,13 @@ void freeGameArchiveMemory(void *ptr);
 
 bool loadGameArchiveToMemory(const char *filename, char **ptr, size_t *size);
 
+/**
+ * Opens a file descriptor for the APK containing the given asset, along with
+ * the range of the APK the asset occupies. Only works for assets which are
+ * stored uncompressed. Returns -1 otherwise. The caller closes the descriptor.
+ **/
+int openAssetFileDescriptor(const char *filename, int64 *offset, int64 *length);
+
 bool directoryExists(const char *path);
 
 bool mkdir(const char *path);
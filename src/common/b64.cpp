@@ -19,11 +19,20 @@
  **/
 
 #include "b64.h"
+#include "cpu.h"
+#include "int.h"
 #include "Exception.h"
 
+#include <algorithm>
 #include <limits>
 #include <stdio.h>
 
+#if defined(LOVE_CPU_X86)
+#include <immintrin.h>
+#elif defined(LOVE_SIMD_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace love
 {
 
@@ -33,10 +42,33 @@ static const char cb64[]="ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz01
 // Translation table to decode (created by Bob Trower)
 static const char cd64[]="|$$$}rstuvwxyz{$$$$$$$>?@ABCDEFGHIJKLMNOPQRSTUVW$$$$$$XYZ[\\]^_`abcdefghijklmnopq";
 
+static const uint8 B64_INVALID = 0xFF;
+
+// cd64 expanded to every byte value, with B64_INVALID for characters that
+// aren't part of the alphabet (including padding, which is skipped).
+static const uint8 *getDecodeTable()
+{
+	static const struct Table
+	{
+		uint8 values[256];
+
+		Table()
+		{
+			for (int c = 0; c < 256; c++)
+			{
+				char v = (c < 43 || c > 122) ? '$' : cd64[c - 43];
+				values[c] = v == '$' ? B64_INVALID : (uint8) (v - 62);
+			}
+		}
+	} table;
+
+	return table.values;
+}
+
 /**
  * encode 3 8-bit binary bytes as 4 '6-bit' characters
  **/
-static void b64_encode_block(char in[3], char out[4], int len)
+static void b64_encode_block(const uint8 in[3], char out[4], int len)
 {
 	out[0] = (char) cb64[(int)((in[0] & 0xfc) >> 2)];
 	out[1] = (char) cb64[(int)(((in[0] & 0x03) << 4) | ((in[1] & 0xf0) >> 4))];
@@ -44,133 +76,455 @@ static void b64_encode_block(char in[3], char out[4], int len)
 	out[3] = (char) (len > 2 ? cb64[(int)(in[2] & 0x3f)] : '=');
 }
 
-char *b64_encode(const char *src, size_t srclen, size_t linelen, size_t &dstlen)
+static void b64_decode_block(const uint8 in[4], uint8 out[3])
 {
-	if (linelen == 0)
-		linelen = std::numeric_limits<size_t>::max();
+	out[0] = (uint8)(in[0] << 2 | in[1] >> 4);
+	out[1] = (uint8)(in[1] << 4 | in[2] >> 2);
+	out[2] = (uint8)(((in[2] << 6) & 0xc0) | in[3]);
+}
 
-	size_t blocksout = 0;
-	size_t srcpos = 0;
+// The vector versions work on whole 3 byte groups (or 4 character groups when
+// decoding) and return how many source bytes they handled, leaving the rest
+// to the scalar code. The decoders stop at the first vector which contains
+// anything outside the alphabet, such as line breaks and padding.
 
-	size_t adjustment = (srclen % 3) ? (3 - (srclen % 3)) : 0;
-	size_t paddedlen = ((srclen + adjustment) / 3) * 4;
+#if defined(LOVE_CPU_X86)
 
-	dstlen = paddedlen + paddedlen / linelen;
+// Based on the approach described by Wojciech Muła and Daniel Lemire in
+// "Faster Base64 Encoding and Decoding using AVX2 Instructions".
 
-	if (dstlen == 0)
-		return nullptr;
+LOVE_TARGET("ssse3")
+static size_t b64EncodeSSSE3(const uint8 *src, size_t srclen, char *dst)
+{
+	const __m128i shuf = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+	const __m128i shiftlut = _mm_setr_epi8(
+		'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+		'0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
 
-	char *dst = nullptr;
-	try
+	size_t i = 0;
+
+	// Each iteration uses 12 of the 16 bytes it loads.
+	for (; i + 16 <= srclen; i += 12)
 	{
-		dst = new char[dstlen + 1];
+		__m128i in = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (src + i)), shuf);
+
+		// Split each 3 byte group into four 6 bit indices.
+		__m128i t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+		__m128i t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+		__m128i indices = _mm_or_si128(t0, t1);
+
+		// Map the index ranges to the offset that turns them into characters.
+		__m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+		__m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+		range = _mm_or_si128(range, _mm_and_si128(less, _mm_set1_epi8(13)));
+
+		__m128i out = _mm_add_epi8(_mm_shuffle_epi8(shiftlut, range), indices);
+		_mm_storeu_si128((__m128i *) (dst + i / 3 * 4), out);
 	}
-	catch (std::exception &)
+
+	return i;
+}
+
+LOVE_TARGET("avx2")
+static size_t b64EncodeAVX2(const uint8 *src, size_t srclen, char *dst)
+{
+	const __m256i shuf = _mm256_broadcastsi128_si256(_mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+	const __m256i shiftlut = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+		'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+		'0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0));
+
+	size_t i = 0;
+
+	// Each 128 bit lane gets its own 12 byte group.
+	for (; i + 28 <= srclen; i += 24)
 	{
-		throw love::Exception("Out of memory.");
+		__m128i lo = _mm_loadu_si128((const __m128i *) (src + i));
+		__m128i hi = _mm_loadu_si128((const __m128i *) (src + i + 12));
+		__m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+		in = _mm256_shuffle_epi8(in, shuf);
+
+		__m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+		__m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+		__m256i indices = _mm256_or_si256(t0, t1);
+
+		__m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+		__m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+		range = _mm256_or_si256(range, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+
+		__m256i out = _mm256_add_epi8(_mm256_shuffle_epi8(shiftlut, range), indices);
+		_mm256_storeu_si256((__m256i *) (dst + i / 3 * 4), out);
 	}
 
-	size_t dstpos = 0;
+	return i;
+}
 
-	while (srcpos < srclen)
+LOVE_TARGET("ssse3")
+static size_t b64DecodeSSSE3(const uint8 *src, size_t srclen, uint8 *dst, size_t dstsize)
+{
+	const __m128i lutlo = _mm_setr_epi8(
+		0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+		0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+	const __m128i luthi = _mm_setr_epi8(
+		0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+		0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	const __m128i lutroll = _mm_setr_epi8(
+		0, 16, 19, 4, -65, -65, -71, -71,
+		0, 0, 0, 0, 0, 0, 0, 0);
+	const __m128i mask2f = _mm_set1_epi8(0x2F);
+	const __m128i packshuf = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+	size_t i = 0;
+	size_t o = 0;
+
+	// The store writes 16 bytes, 12 of them decoded.
+	for (; i + 16 <= srclen && o + 16 <= dstsize; i += 16, o += 12)
 	{
-		char in[3]  = {0};
-		char out[4] = {0};
+		__m128i str = _mm_loadu_si128((const __m128i *) (src + i));
 
-		int len = 0;
+		// Classify each character by its nibbles; any overlap is invalid.
+		__m128i hinibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask2f);
+		__m128i lonibbles = _mm_and_si128(str, mask2f);
+		__m128i hi = _mm_shuffle_epi8(luthi, hinibbles);
+		__m128i lo = _mm_shuffle_epi8(lutlo, lonibbles);
 
-		for (int i = 0; i < 3; i++)
-		{
-			if (srcpos >= srclen)
-				break;
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0xFFFF)
+			break;
 
-			in[i] = src[srcpos++];
-			len++;
-		}
+		__m128i eq2f = _mm_cmpeq_epi8(str, mask2f);
+		__m128i roll = _mm_shuffle_epi8(lutroll, _mm_add_epi8(eq2f, hinibbles));
+		str = _mm_add_epi8(str, roll);
 
-		if (len > 0)
-		{
-			b64_encode_block(in, out, len);
+		// Pack the 6 bit values of each group back into 3 bytes.
+		__m128i merged = _mm_maddubs_epi16(str, _mm_set1_epi32(0x01400140));
+		__m128i out = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+		_mm_storeu_si128((__m128i *) (dst + o), _mm_shuffle_epi8(out, packshuf));
+	}
 
-			for (int i = 0; i < 4 && dstpos < dstlen; i++, dstpos++)
-				dst[dstpos] = out[i];
+	return i;
+}
 
-			blocksout++;
-		}
+LOVE_TARGET("avx2")
+static size_t b64DecodeAVX2(const uint8 *src, size_t srclen, uint8 *dst, size_t dstsize)
+{
+	const __m256i lutlo = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+		0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+		0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A));
+	const __m256i luthi = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+		0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+		0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10));
+	const __m256i lutroll = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+		0, 16, 19, 4, -65, -65, -71, -71,
+		0, 0, 0, 0, 0, 0, 0, 0));
+	const __m256i mask2f = _mm256_set1_epi8(0x2F);
+	const __m256i packshuf = _mm256_broadcastsi128_si256(_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+	const __m256i packperm = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+
+	size_t i = 0;
+	size_t o = 0;
+
+	// The store writes 32 bytes, 24 of them decoded.
+	for (; i + 32 <= srclen && o + 32 <= dstsize; i += 32, o += 24)
+	{
+		__m256i str = _mm256_loadu_si256((const __m256i *) (src + i));
 
-		if (blocksout >= linelen / 4 || srcpos >= srclen)
-		{
-			if (blocksout > 0 && dstpos < dstlen)
-				dst[dstpos++] = '\n';
+		__m256i hinibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask2f);
+		__m256i lonibbles = _mm256_and_si256(str, mask2f);
+		__m256i hi = _mm256_shuffle_epi8(luthi, hinibbles);
+		__m256i lo = _mm256_shuffle_epi8(lutlo, lonibbles);
+
+		if (!_mm256_testz_si256(lo, hi))
+			break;
 
-			blocksout = 0;
+		__m256i eq2f = _mm256_cmpeq_epi8(str, mask2f);
+		__m256i roll = _mm256_shuffle_epi8(lutroll, _mm256_add_epi8(eq2f, hinibbles));
+		str = _mm256_add_epi8(str, roll);
+
+		__m256i merged = _mm256_maddubs_epi16(str, _mm256_set1_epi32(0x01400140));
+		__m256i out = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+		out = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(out, packshuf), packperm);
+		_mm256_storeu_si256((__m256i *) (dst + o), out);
+	}
+
+	return i;
+}
+
+static size_t b64EncodeSIMD(const uint8 *src, size_t srclen, char *dst)
+{
+	const CPUFeatures &cpu = getCPUFeatures();
+	if (cpu.avx2)
+		return b64EncodeAVX2(src, srclen, dst);
+	else if (cpu.ssse3)
+		return b64EncodeSSSE3(src, srclen, dst);
+	return 0;
+}
+
+static size_t b64DecodeSIMD(const uint8 *src, size_t srclen, uint8 *dst, size_t dstsize)
+{
+	const CPUFeatures &cpu = getCPUFeatures();
+	if (cpu.avx2)
+		return b64DecodeAVX2(src, srclen, dst, dstsize);
+	else if (cpu.ssse3)
+		return b64DecodeSSSE3(src, srclen, dst, dstsize);
+	return 0;
+}
+
+#elif defined(LOVE_SIMD_NEON) && defined(__aarch64__)
+
+static size_t b64EncodeSIMD(const uint8 *src, size_t srclen, char *dst)
+{
+	const uint8 *alphabet = (const uint8 *) cb64;
+	const uint8x16x4_t lut = {{
+		vld1q_u8(alphabet), vld1q_u8(alphabet + 16), vld1q_u8(alphabet + 32), vld1q_u8(alphabet + 48)
+	}};
+	const uint8x16_t mask = vdupq_n_u8(0x3F);
+
+	size_t i = 0;
+
+	for (; i + 48 <= srclen; i += 48)
+	{
+		// De-interleave the first, second and third bytes of each group.
+		uint8x16x3_t in = vld3q_u8(src + i);
+		uint8x16x4_t out;
+
+		out.val[0] = vshrq_n_u8(in.val[0], 2);
+		out.val[1] = vandq_u8(vorrq_u8(vshrq_n_u8(in.val[1], 4), vshlq_n_u8(in.val[0], 4)), mask);
+		out.val[2] = vandq_u8(vorrq_u8(vshrq_n_u8(in.val[2], 6), vshlq_n_u8(in.val[1], 2)), mask);
+		out.val[3] = vandq_u8(in.val[2], mask);
+
+		for (int j = 0; j < 4; j++)
+			out.val[j] = vqtbl4q_u8(lut, out.val[j]);
+
+		vst4q_u8((uint8 *) dst + i / 3 * 4, out);
+	}
+
+	return i;
+}
+
+static size_t b64DecodeSIMD(const uint8 *src, size_t srclen, uint8 *dst, size_t dstsize)
+{
+	const uint8 *table = getDecodeTable();
+	const uint8x16x4_t lutlo = {{
+		vld1q_u8(table), vld1q_u8(table + 16), vld1q_u8(table + 32), vld1q_u8(table + 48)
+	}};
+	const uint8x16x4_t luthi = {{
+		vld1q_u8(table + 64), vld1q_u8(table + 80), vld1q_u8(table + 96), vld1q_u8(table + 112)
+	}};
+	const uint8x16_t offset = vdupq_n_u8(64);
+
+	size_t i = 0;
+	size_t o = 0;
+
+	for (; i + 64 <= srclen && o + 48 <= dstsize; i += 64, o += 48)
+	{
+		uint8x16x4_t in = vld4q_u8(src + i);
+		uint8x16_t error = vdupq_n_u8(0);
+
+		// Characters above 127 look up 0, but are caught by their high bit.
+		for (int j = 0; j < 4; j++)
+		{
+			uint8x16_t c = in.val[j];
+			uint8x16_t v = vqtbx4q_u8(vqtbl4q_u8(lutlo, c), luthi, vsubq_u8(c, offset));
+			error = vorrq_u8(error, vorrq_u8(v, c));
+			in.val[j] = v;
 		}
+
+		if (vmaxvq_u8(error) & 0x80)
+			break;
+
+		uint8x16x3_t out;
+		out.val[0] = vorrq_u8(vshlq_n_u8(in.val[0], 2), vshrq_n_u8(in.val[1], 4));
+		out.val[1] = vorrq_u8(vshlq_n_u8(in.val[1], 4), vshrq_n_u8(in.val[2], 2));
+		out.val[2] = vorrq_u8(vshlq_n_u8(in.val[2], 6), in.val[3]);
+
+		vst3q_u8(dst + o, out);
 	}
 
-	dst[dstpos] = '\0';
-	return dst;
+	return i;
 }
 
-static void b64_decode_block(char in[4], char out[3])
+#else
+
+static size_t b64EncodeSIMD(const uint8 */*src*/, size_t /*srclen*/, char */*dst*/)
 {
-	out[0] = (char)(in[0] << 2 | in[1] >> 4);
-	out[1] = (char)(in[1] << 4 | in[2] >> 2);
-	out[2] = (char)(((in[2] << 6) & 0xc0) | in[3]);
+	return 0;
 }
 
-char *b64_decode(const char *src, size_t srclen, size_t &size)
+static size_t b64DecodeSIMD(const uint8 */*src*/, size_t /*srclen*/, uint8 */*dst*/, size_t /*dstsize*/)
+{
+	return 0;
+}
+
+#endif
+
+// Encodes whole 3 byte groups, without padding or line breaks.
+static void b64_encode_groups(const uint8 *src, size_t groups, char *dst)
+{
+	size_t srclen = groups * 3;
+	size_t i = b64EncodeSIMD(src, srclen, dst);
+
+	for (; i < srclen; i += 3)
+		b64_encode_block(src + i, dst + i / 3 * 4, 3);
+}
+
+// Lines hold a whole number of 4 character blocks.
+static size_t b64_blocks_per_line(size_t linelen)
+{
+	if (linelen == 0)
+		return std::numeric_limits<size_t>::max();
+
+	return std::max(linelen / 4, (size_t) 1);
+}
+
+size_t b64_encoded_size(size_t srclen, size_t linelen)
+{
+	size_t blocks = (srclen + 2) / 3;
+
+	// Every full line ends with a line break.
+	return blocks * 4 + blocks / b64_blocks_per_line(linelen);
+}
+
+size_t b64_encode(const char *src, size_t srclen, size_t linelen, char *dst)
+{
+	size_t dstlen = b64_encoded_size(srclen, linelen);
+	size_t blocksperline = b64_blocks_per_line(linelen);
+
+	const uint8 *s = (const uint8 *) src;
+	size_t fullblocks = srclen / 3;
+	size_t srcpos = 0;
+	size_t dstpos = 0;
+
+	while (srcpos < srclen)
+	{
+		size_t blocks = std::min(blocksperline, fullblocks - srcpos / 3);
+
+		b64_encode_groups(s + srcpos, blocks, dst + dstpos);
+		srcpos += blocks * 3;
+		dstpos += blocks * 4;
+
+		// A trailing partial group finishes the current line if it has room.
+		if (blocks < blocksperline && srcpos < srclen)
+		{
+			uint8 in[3] = {0};
+			int len = (int) (srclen - srcpos);
+
+			for (int i = 0; i < len; i++)
+				in[i] = s[srcpos + i];
+
+			b64_encode_block(in, dst + dstpos, len);
+			srcpos = srclen;
+			dstpos += 4;
+		}
+
+		if (dstpos < dstlen)
+			dst[dstpos++] = '\n';
+	}
+
+	return dstpos;
+}
+
+char *b64_encode(const char *src, size_t srclen, size_t linelen, size_t &dstlen)
 {
-	size_t paddedsize = (srclen / 4) * 3;
+	dstlen = b64_encoded_size(srclen, linelen);
+
+	if (dstlen == 0)
+		return nullptr;
 
 	char *dst = nullptr;
 	try
 	{
-		dst = new char[paddedsize];
+		dst = new char[dstlen + 1];
 	}
 	catch (std::exception &)
 	{
 		throw love::Exception("Out of memory.");
 	}
 
-	char *d = dst;
+	b64_encode(src, srclen, linelen, dst);
+
+	dst[dstlen] = '\0';
+	return dst;
+}
 
-	char in[4]  = {0};
-	char out[3] = {0};
-	size_t i, len, srcpos = 0;
+size_t b64_decoded_max_size(size_t srclen)
+{
+	// A trailing group of 2 or 3 characters decodes to 1 or 2 bytes.
+	size_t remainder = srclen % 4;
+	return (srclen / 4) * 3 + (remainder > 1 ? remainder - 1 : 0);
+}
+
+size_t b64_decode(const char *src, size_t srclen, char *dst, size_t dstsize)
+{
+	const uint8 *table = getDecodeTable();
+	const uint8 *s = (const uint8 *) src;
+	uint8 *d = (uint8 *) dst;
+
+	uint8 in[4] = {0};
+	uint8 out[3] = {0};
+	size_t len = 0;
+	size_t srcpos = 0;
+	size_t dstpos = 0;
 
-	while (srcpos <= srclen)
+	// Characters outside the alphabet are skipped.
+	while (srcpos < srclen)
 	{
-		for (len = 0, i = 0; i < 4 && srcpos <= srclen; i++)
+		if (len == 0)
 		{
-			char v = 0;
+			size_t consumed = b64DecodeSIMD(s + srcpos, srclen - srcpos, d + dstpos, dstsize - dstpos);
+			srcpos += consumed;
+			dstpos += consumed / 4 * 3;
 
-			while (srcpos <= srclen && v == 0)
-			{
-				v = src[srcpos++];
-				v = (char)((v < 43 || v > 122) ? 0 : cd64[v - 43]);
-				if (v != 0)
-					v = (char)((v == '$') ? 0 : v - 61);
-			}
-
-			if (srcpos <= srclen)
-			{
-				len++;
-				if (v != 0)
-					in[i] = (char)(v - 1);
-			}
-			else
-				in[i] = 0;
+			if (srcpos >= srclen)
+				break;
 		}
 
-		if (len)
+		uint8 v = table[s[srcpos++]];
+		if (v == B64_INVALID)
+			continue;
+
+		in[len++] = v;
+
+		if (len == 4)
 		{
-			b64_decode_block(in, out);
-			for (i = 0; i < len - 1; i++)
-				 *(d++) = out[i];
+			if (dstsize - dstpos < 3)
+				throw love::Exception("Not enough space to decode the base64 data.");
+
+			b64_decode_block(in, d + dstpos);
+			dstpos += 3;
+			len = 0;
 		}
 	}
 
-	size = (size_t)(ptrdiff_t) (d - dst);
+	if (len > 1)
+	{
+		if (dstsize - dstpos < len - 1)
+			throw love::Exception("Not enough space to decode the base64 data.");
+
+		for (size_t i = len; i < 4; i++)
+			in[i] = 0;
+
+		b64_decode_block(in, out);
+		for (size_t i = 0; i < len - 1; i++)
+			d[dstpos++] = out[i];
+	}
+
+	return dstpos;
+}
+
+char *b64_decode(const char *src, size_t srclen, size_t &size)
+{
+	size_t maxsize = b64_decoded_max_size(srclen);
+
+	char *dst = nullptr;
+	try
+	{
+		dst = new char[maxsize];
+	}
+	catch (std::exception &)
+	{
+		throw love::Exception("Out of memory.");
+	}
+
+	size = b64_decode(src, srclen, dst, maxsize);
 	return dst;
 }
 
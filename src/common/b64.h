@@ -40,6 +40,25 @@ namespace love
  */
 char *b64_encode(const char *src, size_t srclen, size_t linelen, size_t &dstlen);
 
+/**
+ * Gets the length of the string b64_encode would produce, not counting the
+ * null terminator.
+ */
+size_t b64_encoded_size(size_t srclen, size_t linelen);
+
+/**
+ * Base64-encode data into an existing buffer. No null terminator is written.
+ *
+ * @param src The data to encode.
+ * @param srclen The size in bytes of the data.
+ * @param linelen The maximum length of each line in the encoded string.
+ *        0 indicates no maximum length.
+ * @param dst The buffer to write to, which must hold at least
+ *        b64_encoded_size(srclen, linelen) bytes.
+ * @return The number of bytes written.
+ */
+size_t b64_encode(const char *src, size_t srclen, size_t linelen, char *dst);
+
 /**
  * Decode base64 encoded data.
  *
@@ -50,6 +69,24 @@ char *b64_encode(const char *src, size_t srclen, size_t linelen, size_t &dstlen)
  */
 char *b64_decode(const char *src, size_t srclen, size_t &dstlen);
 
+/**
+ * Gets the largest number of bytes that decoding a base64 string of the given
+ * length can produce.
+ */
+size_t b64_decoded_max_size(size_t srclen);
+
+/**
+ * Decode base64 encoded data into an existing buffer. Throws an exception if
+ * the decoded data doesn't fit.
+ *
+ * @param src The string containing the base64 data.
+ * @param srclen The length of the string.
+ * @param dst The buffer to write to.
+ * @param dstsize The size of the buffer.
+ * @return The number of bytes written.
+ */
+size_t b64_decode(const char *src, size_t srclen, char *dst, size_t dstsize);
+
 } // love
 
 #endif // LOVE_B64_H
@@ -0,0 +1,311 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "colorconvert.h"
+#include "config.h"
+#include "StringMap.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+
+#if defined(LOVE_SIMD_SSE)
+#include <xmmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace love
+{
+
+static inline float toLinear(float c)
+{
+	if (c <= 0.04045f)
+		return c / 12.92f;
+	else
+		return powf((c + 0.055f) / 1.055f, 2.4f);
+}
+
+static inline float toGamma(float c)
+{
+	if (c <= 0.0031308f)
+		return c * 12.92f;
+	else
+		return 1.055f * powf(c, 1.0f / 2.4f) - 0.055f;
+}
+
+struct GammaTables
+{
+	uint8 toLinear[256];
+	uint8 toGamma[256];
+
+	GammaTables()
+	{
+		for (int i = 0; i < 256; i++)
+		{
+			float c = i / 255.0f;
+			toLinear[i] = (uint8) (std::min(std::max(love::toLinear(c), 0.0f), 1.0f) * 255.0f + 0.5f);
+			toGamma[i] = (uint8) (std::min(std::max(love::toGamma(c), 0.0f), 1.0f) * 255.0f + 0.5f);
+		}
+	}
+};
+
+static const GammaTables &getGammaTables()
+{
+	static GammaTables tables;
+	return tables;
+}
+
+static void premultiply(float *rgba, size_t count)
+{
+	size_t i = 0;
+
+#if defined(LOVE_SIMD_SSE)
+
+	for (; i < count; i++)
+	{
+		float *p = rgba + i * 4;
+		__m128 v = _mm_loadu_ps(p);
+		__m128 r = _mm_mul_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)));
+
+		// [r0 r1 r2 v3]
+		__m128 t = _mm_shuffle_ps(r, v, _MM_SHUFFLE(3, 3, 2, 2));
+		_mm_storeu_ps(p, _mm_shuffle_ps(r, t, _MM_SHUFFLE(2, 0, 1, 0)));
+	}
+
+#elif defined(LOVE_SIMD_NEON)
+
+	for (; i < count; i++)
+	{
+		float *p = rgba + i * 4;
+		float32x4_t v = vld1q_f32(p);
+		float32x4_t r = vmulq_n_f32(v, vgetq_lane_f32(v, 3));
+		vst1q_f32(p, vsetq_lane_f32(vgetq_lane_f32(v, 3), r, 3));
+	}
+
+#endif
+
+	for (; i < count; i++)
+	{
+		float *p = rgba + i * 4;
+		p[0] *= p[3];
+		p[1] *= p[3];
+		p[2] *= p[3];
+	}
+}
+
+static void unpremultiply(float *rgba, size_t count)
+{
+	size_t i = 0;
+
+#if defined(LOVE_SIMD_SSE)
+
+	const __m128 zero = _mm_setzero_ps();
+
+	for (; i < count; i++)
+	{
+		float *p = rgba + i * 4;
+		__m128 v = _mm_loadu_ps(p);
+		__m128 a = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+
+		// Pixels with zero alpha keep their color.
+		__m128 nonzero = _mm_cmpneq_ps(a, zero);
+		__m128 r = _mm_div_ps(v, a);
+		r = _mm_or_ps(_mm_and_ps(nonzero, r), _mm_andnot_ps(nonzero, v));
+
+		__m128 t = _mm_shuffle_ps(r, v, _MM_SHUFFLE(3, 3, 2, 2));
+		_mm_storeu_ps(p, _mm_shuffle_ps(r, t, _MM_SHUFFLE(2, 0, 1, 0)));
+	}
+
+#elif defined(LOVE_SIMD_NEON) && defined(__aarch64__)
+	// 32-bit NEON has no vector division, so it uses the scalar path below.
+
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+
+	for (; i < count; i++)
+	{
+		float *p = rgba + i * 4;
+		float32x4_t v = vld1q_f32(p);
+		float32x4_t a = vdupq_laneq_f32(v, 3);
+
+		uint32x4_t nonzero = vmvnq_u32(vceqq_f32(a, zero));
+		float32x4_t r = vbslq_f32(nonzero, vdivq_f32(v, a), v);
+		vst1q_f32(p, vsetq_lane_f32(vgetq_lane_f32(v, 3), r, 3));
+	}
+
+#endif
+
+	for (; i < count; i++)
+	{
+		float *p = rgba + i * 4;
+		if (p[3] != 0.0f)
+		{
+			p[0] /= p[3];
+			p[1] /= p[3];
+			p[2] /= p[3];
+		}
+	}
+}
+
+void convertColors(ColorConversion conversion, float *rgba, size_t count)
+{
+	switch (conversion)
+	{
+	case COLOR_CONVERSION_GAMMA_TO_LINEAR:
+		for (size_t i = 0; i < count * 4; i += 4)
+		{
+			rgba[i + 0] = toLinear(rgba[i + 0]);
+			rgba[i + 1] = toLinear(rgba[i + 1]);
+			rgba[i + 2] = toLinear(rgba[i + 2]);
+		}
+		break;
+	case COLOR_CONVERSION_LINEAR_TO_GAMMA:
+		for (size_t i = 0; i < count * 4; i += 4)
+		{
+			rgba[i + 0] = toGamma(rgba[i + 0]);
+			rgba[i + 1] = toGamma(rgba[i + 1]);
+			rgba[i + 2] = toGamma(rgba[i + 2]);
+		}
+		break;
+	case COLOR_CONVERSION_PREMULTIPLY:
+		premultiply(rgba, count);
+		break;
+	case COLOR_CONVERSION_UNPREMULTIPLY:
+		unpremultiply(rgba, count);
+		break;
+	default:
+		break;
+	}
+}
+
+void convertColors(ColorConversion conversion, uint8 *rgba, size_t count)
+{
+	const uint8 *table = nullptr;
+
+	switch (conversion)
+	{
+	case COLOR_CONVERSION_GAMMA_TO_LINEAR:
+		table = getGammaTables().toLinear;
+		break;
+	case COLOR_CONVERSION_LINEAR_TO_GAMMA:
+		table = getGammaTables().toGamma;
+		break;
+	case COLOR_CONVERSION_PREMULTIPLY:
+		for (size_t i = 0; i < count * 4; i += 4)
+		{
+			uint32 a = rgba[i + 3];
+			rgba[i + 0] = (uint8) ((rgba[i + 0] * a + 127) / 255);
+			rgba[i + 1] = (uint8) ((rgba[i + 1] * a + 127) / 255);
+			rgba[i + 2] = (uint8) ((rgba[i + 2] * a + 127) / 255);
+		}
+		return;
+	case COLOR_CONVERSION_UNPREMULTIPLY:
+		for (size_t i = 0; i < count * 4; i += 4)
+		{
+			uint32 a = rgba[i + 3];
+			if (a == 0)
+				continue;
+			rgba[i + 0] = (uint8) std::min<uint32>((rgba[i + 0] * 255 + a / 2) / a, 255);
+			rgba[i + 1] = (uint8) std::min<uint32>((rgba[i + 1] * 255 + a / 2) / a, 255);
+			rgba[i + 2] = (uint8) std::min<uint32>((rgba[i + 2] * 255 + a / 2) / a, 255);
+		}
+		return;
+	default:
+		return;
+	}
+
+	for (size_t i = 0; i < count * 4; i += 4)
+	{
+		rgba[i + 0] = table[rgba[i + 0]];
+		rgba[i + 1] = table[rgba[i + 1]];
+		rgba[i + 2] = table[rgba[i + 2]];
+	}
+}
+
+template <typename T>
+static void swizzle(const int order[4], T *rgba, size_t count)
+{
+	for (size_t i = 0; i < count * 4; i += 4)
+	{
+		T src[4] = {rgba[i + 0], rgba[i + 1], rgba[i + 2], rgba[i + 3]};
+		rgba[i + 0] = src[order[0]];
+		rgba[i + 1] = src[order[1]];
+		rgba[i + 2] = src[order[2]];
+		rgba[i + 3] = src[order[3]];
+	}
+}
+
+void swizzleColors(const int order[4], float *rgba, size_t count)
+{
+	swizzle(order, rgba, count);
+}
+
+void swizzleColors(const int order[4], uint8 *rgba, size_t count)
+{
+	swizzle(order, rgba, count);
+}
+
+bool getSwizzle(const char *str, int order[4])
+{
+	static const char channels[] = "rgba";
+
+	for (int i = 0; i < 4; i++)
+	{
+		if (str[i] == '\0')
+			return false;
+
+		const char *c = std::find(channels, channels + 4, str[i]);
+		if (c == channels + 4)
+			return false;
+
+		order[i] = (int) (c - channels);
+	}
+
+	return str[4] == '\0';
+}
+
+static StringMap<ColorConversion, COLOR_CONVERSION_MAX_ENUM>::Entry conversionEntries[] =
+{
+	{ "gammatolinear", COLOR_CONVERSION_GAMMA_TO_LINEAR },
+	{ "lineartogamma", COLOR_CONVERSION_LINEAR_TO_GAMMA },
+	{ "premultiply",   COLOR_CONVERSION_PREMULTIPLY     },
+	{ "unpremultiply", COLOR_CONVERSION_UNPREMULTIPLY   },
+};
+
+static StringMap<ColorConversion, COLOR_CONVERSION_MAX_ENUM> conversions(conversionEntries, sizeof(conversionEntries));
+
+bool getConstant(const char *in, ColorConversion &out)
+{
+	return conversions.find(in, out);
+}
+
+bool getConstant(ColorConversion in, const char *&out)
+{
+	return conversions.find(in, out);
+}
+
+std::vector<std::string> getConstants(ColorConversion)
+{
+	return conversions.getNames();
+}
+
+} // love
@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_COLOR_CONVERT_H
+#define LOVE_COLOR_CONVERT_H
+
+#include "int.h"
+
+// C++
+#include <string>
+#include <vector>
+
+namespace love
+{
+
+enum ColorConversion
+{
+	COLOR_CONVERSION_GAMMA_TO_LINEAR,
+	COLOR_CONVERSION_LINEAR_TO_GAMMA,
+	COLOR_CONVERSION_PREMULTIPLY,
+	COLOR_CONVERSION_UNPREMULTIPLY,
+	COLOR_CONVERSION_MAX_ENUM
+};
+
+/**
+ * Converts count RGBA pixels in place. Gamma conversions leave alpha alone,
+ * and unpremultiplying leaves pixels with zero alpha alone.
+ **/
+void convertColors(ColorConversion conversion, float *rgba, size_t count);
+void convertColors(ColorConversion conversion, uint8 *rgba, size_t count);
+
+/**
+ * Reorders the channels of count RGBA pixels in place. order[i] is the
+ * source channel (0-3) for destination channel i.
+ **/
+void swizzleColors(const int order[4], float *rgba, size_t count);
+void swizzleColors(const int order[4], uint8 *rgba, size_t count);
+
+/**
+ * Parses a channel order string such as "bgra" for swizzleColors.
+ **/
+bool getSwizzle(const char *str, int order[4]);
+
+bool getConstant(const char *in, ColorConversion &out);
+bool getConstant(ColorConversion in, const char *&out);
+std::vector<std::string> getConstants(ColorConversion);
+
+} // love
+
+#endif // LOVE_COLOR_CONVERT_H
@@ -0,0 +1,465 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "cpu.h"
+#include "int.h"
+
+// C++
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#if defined(LOVE_CPU_X86)
+#	if defined(_MSC_VER)
+#		include <intrin.h>
+#	else
+#		include <cpuid.h>
+#	endif
+#elif defined(LOVE_CPU_ARM64)
+#	if defined(__linux__)
+#		include <sys/auxv.h>
+#	endif
+#endif
+
+#if defined(_WIN32)
+#	ifndef NOMINMAX
+#		define NOMINMAX
+#	endif
+#	include <windows.h>
+#elif defined(__APPLE__)
+#	include <sys/sysctl.h>
+#elif defined(__linux__)
+#	include <cctype>
+#	include <cstdio>
+#	include <cstdlib>
+#	include <map>
+#	include <set>
+#	include <string>
+#endif
+
+namespace love
+{
+
+#if defined(LOVE_CPU_X86)
+
+static void cpuid(int leaf, uint32 regs[4])
+{
+#if defined(_MSC_VER)
+	int r[4];
+	__cpuidex(r, leaf, 0);
+	for (int i = 0; i < 4; i++)
+		regs[i] = (uint32) r[i];
+#else
+	__cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+static uint64 xgetbv()
+{
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	uint32 eax, edx;
+	__asm__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+	return ((uint64) edx << 32) | eax;
+#endif
+}
+
+static CPUFeatures detectCPUFeatures()
+{
+	CPUFeatures f;
+	uint32 regs[4];
+
+	cpuid(0, regs);
+	uint32 maxleaf = regs[0];
+
+	if (maxleaf < 1)
+		return f;
+
+	cpuid(1, regs);
+	f.sse2 = (regs[3] & (1u << 26)) != 0;
+	f.ssse3 = (regs[2] & (1u << 9)) != 0;
+	f.sse41 = (regs[2] & (1u << 19)) != 0;
+	f.sse42 = (regs[2] & (1u << 20)) != 0;
+
+	// AVX-encoded instructions also need the OS to save the YMM registers.
+	bool osxsave = (regs[2] & (1u << 27)) != 0;
+	bool avx = (regs[2] & (1u << 28)) != 0 && osxsave && (xgetbv() & 0x6) == 0x6;
+
+	f.avx = avx;
+	f.fma = avx && (regs[2] & (1u << 12)) != 0;
+	f.f16c = avx && (regs[2] & (1u << 29)) != 0;
+
+	if (maxleaf >= 7)
+	{
+		cpuid(7, regs);
+		f.avx2 = avx && (regs[1] & (1u << 5)) != 0;
+		f.sha = f.ssse3 && f.sse41 && (regs[1] & (1u << 29)) != 0;
+	}
+
+	return f;
+}
+
+#elif defined(LOVE_CPU_ARM64)
+
+static CPUFeatures detectCPUFeatures()
+{
+	CPUFeatures f;
+
+	// NEON is a required part of ARMv8-A.
+	f.neon = true;
+
+#if defined(__linux__)
+	// HWCAP_SHA1 and HWCAP_SHA2 from asm/hwcap.h.
+	unsigned long hwcap = getauxval(AT_HWCAP);
+	f.armSHA1 = (hwcap & (1ul << 5)) != 0;
+	f.armSHA2 = (hwcap & (1ul << 6)) != 0;
+#elif defined(__APPLE__)
+	// Every 64 bit Apple CPU has the crypto extensions.
+	f.armSHA1 = f.armSHA2 = true;
+#elif defined(_WIN32)
+	f.armSHA1 = f.armSHA2 = IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE) != 0;
+#endif
+
+	return f;
+}
+
+#else
+
+static CPUFeatures detectCPUFeatures()
+{
+	CPUFeatures f;
+#if defined(__ARM_NEON)
+	// 32 bit ARM builds only use NEON when the whole build targets it.
+	f.neon = true;
+#endif
+	return f;
+}
+
+#endif
+
+const CPUFeatures &getCPUFeatures()
+{
+	static const CPUFeatures features = detectCPUFeatures();
+	return features;
+}
+
+#if defined(_WIN32)
+
+static void detectCPUTopology(CPUTopology &t)
+{
+	DWORD size = 0;
+	GetLogicalProcessorInformationEx(RelationAll, nullptr, &size);
+	if (GetLastError() != ERROR_INSUFFICIENT_BUFFER || size == 0)
+		return;
+
+	std::vector<uint8> buffer(size);
+	auto info = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX *) buffer.data();
+	if (!GetLogicalProcessorInformationEx(RelationAll, info, &size))
+		return;
+
+	std::vector<int> coreclasses;
+	int logical = 0;
+
+	for (DWORD offset = 0; offset < size;)
+	{
+		auto entry = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX *) (buffer.data() + offset);
+		offset += entry->Size;
+
+		if (entry->Relationship == RelationProcessorCore)
+		{
+			// Higher efficiency classes are faster. They're all 0 on CPUs
+			// whose cores are all the same.
+			coreclasses.push_back(entry->Processor.EfficiencyClass);
+			for (WORD g = 0; g < entry->Processor.GroupCount; g++)
+			{
+				for (KAFFINITY mask = entry->Processor.GroupMask[g].Mask; mask != 0; mask &= mask - 1)
+					logical++;
+			}
+		}
+		else if (entry->Relationship == RelationCache)
+		{
+			const CACHE_RELATIONSHIP &cache = entry->Cache;
+			int cachesize = (int) cache.CacheSize;
+
+			if (cache.Level == 1 && cache.Type == CacheData && t.l1DataCacheSize == 0)
+				t.l1DataCacheSize = cachesize;
+			else if (cache.Level == 2 && cache.Type != CacheInstruction && t.l2CacheSize == 0)
+				t.l2CacheSize = cachesize;
+			else if (cache.Level == 3 && cache.Type != CacheInstruction && t.l3CacheSize == 0)
+				t.l3CacheSize = cachesize;
+
+			if (cache.Level == 1 && cache.LineSize > 0)
+				t.cacheLineSize = cache.LineSize;
+		}
+	}
+
+	if (coreclasses.empty())
+		return;
+
+	int fastest = *std::max_element(coreclasses.begin(), coreclasses.end());
+
+	t.logicalCores = std::max(logical, (int) coreclasses.size());
+	t.physicalCores = (int) coreclasses.size();
+	t.performanceCores = (int) std::count(coreclasses.begin(), coreclasses.end(), fastest);
+	t.efficiencyCores = t.physicalCores - t.performanceCores;
+}
+
+#elif defined(__APPLE__)
+
+static int sysctlInt(const char *name, int def)
+{
+	int value = 0;
+	size_t size = sizeof(value);
+	if (sysctlbyname(name, &value, &size, nullptr, 0) != 0 || value <= 0)
+	{
+		// Some cache sizes are 64 bit values.
+		int64 value64 = 0;
+		size = sizeof(value64);
+		if (sysctlbyname(name, &value64, &size, nullptr, 0) != 0 || value64 <= 0)
+			return def;
+		return (int) std::min<int64>(value64, std::numeric_limits<int>::max());
+	}
+	return value;
+}
+
+static void detectCPUTopology(CPUTopology &t)
+{
+	t.logicalCores = sysctlInt("hw.logicalcpu", t.logicalCores);
+	t.physicalCores = sysctlInt("hw.physicalcpu", t.physicalCores);
+
+	// perflevel0 is the fastest cluster. Older systems and Intel Macs don't
+	// have any perflevels.
+	int perflevels = sysctlInt("hw.nperflevels", 1);
+	if (perflevels > 1)
+	{
+		t.performanceCores = sysctlInt("hw.perflevel0.physicalcpu", t.physicalCores);
+		t.efficiencyCores = std::max(t.physicalCores - t.performanceCores, 0);
+
+		t.l1DataCacheSize = sysctlInt("hw.perflevel0.l1dcachesize", 0);
+		t.l2CacheSize = sysctlInt("hw.perflevel0.l2cachesize", 0);
+	}
+	else
+		t.performanceCores = t.physicalCores;
+
+	if (t.l1DataCacheSize == 0)
+		t.l1DataCacheSize = sysctlInt("hw.l1dcachesize", 0);
+	if (t.l2CacheSize == 0)
+		t.l2CacheSize = sysctlInt("hw.l2cachesize", 0);
+
+	t.l3CacheSize = sysctlInt("hw.l3cachesize", 0);
+	t.cacheLineSize = sysctlInt("hw.cachelinesize", t.cacheLineSize);
+}
+
+#elif defined(__linux__)
+
+static bool readSysFile(const std::string &path, std::string &contents)
+{
+	FILE *file = fopen(path.c_str(), "r");
+	if (file == nullptr)
+		return false;
+
+	char buffer[256];
+	size_t length = fread(buffer, 1, sizeof(buffer) - 1, file);
+	fclose(file);
+
+	buffer[length] = '\0';
+	contents = buffer;
+
+	while (!contents.empty() && isspace((unsigned char) contents.back()))
+		contents.pop_back();
+
+	return true;
+}
+
+static long readSysInt(const std::string &path, long def)
+{
+	std::string contents;
+	if (!readSysFile(path, contents) || contents.empty())
+		return def;
+	return strtol(contents.c_str(), nullptr, 10);
+}
+
+// Cache sizes look like "32K" or "8192K".
+static int readSysSize(const std::string &path)
+{
+	std::string contents;
+	if (!readSysFile(path, contents) || contents.empty())
+		return 0;
+
+	char *end = nullptr;
+	long size = strtol(contents.c_str(), &end, 10);
+	if (*end == 'K')
+		size *= 1024;
+	else if (*end == 'M')
+		size *= 1024 * 1024;
+
+	return (int) size;
+}
+
+// CPU lists look like "0-7,16,18-19".
+static std::set<int> readSysCPUList(const std::string &path)
+{
+	std::set<int> cpus;
+	std::string contents;
+	if (!readSysFile(path, contents))
+		return cpus;
+
+	const char *str = contents.c_str();
+	while (*str != '\0')
+	{
+		char *end = nullptr;
+		long first = strtol(str, &end, 10);
+		if (end == str)
+			break;
+
+		long last = first;
+		if (*end == '-')
+		{
+			str = end + 1;
+			last = strtol(str, &end, 10);
+		}
+
+		for (long i = first; i <= last; i++)
+			cpus.insert((int) i);
+
+		str = *end == ',' ? end + 1 : end;
+	}
+
+	return cpus;
+}
+
+static void detectCPUTopology(CPUTopology &t)
+{
+	const std::string cpudir = "/sys/devices/system/cpu/";
+
+	std::set<int> online = readSysCPUList(cpudir + "online");
+	if (online.empty())
+		return;
+
+	// Intel hybrid CPUs list their efficiency cores separately. Elsewhere
+	// (mostly ARM) every core has a relative capacity, and anything below
+	// the maximum is treated as an efficiency core.
+	std::set<int> atomcpus = readSysCPUList("/sys/devices/cpu_atom/cpus");
+
+	struct Core
+	{
+		long capacity;
+		bool atom;
+	};
+
+	std::map<std::pair<long, long>, Core> cores;
+	long maxcapacity = 0;
+
+	for (int cpu : online)
+	{
+		std::string dir = cpudir + "cpu" + std::to_string(cpu) + "/";
+
+		long package = readSysInt(dir + "topology/physical_package_id", 0);
+		long coreid = readSysInt(dir + "topology/core_id", cpu);
+		long capacity = readSysInt(dir + "cpu_capacity", 0);
+
+		Core &core = cores[std::make_pair(package, coreid)];
+		core.capacity = std::max(core.capacity, capacity);
+		core.atom = core.atom || atomcpus.count(cpu) > 0;
+
+		maxcapacity = std::max(maxcapacity, capacity);
+	}
+
+	t.logicalCores = (int) online.size();
+	t.physicalCores = (int) cores.size();
+	t.performanceCores = 0;
+
+	for (const auto &core : cores)
+	{
+		if (core.second.atom || core.second.capacity < maxcapacity)
+			t.efficiencyCores++;
+		else
+			t.performanceCores++;
+	}
+
+	// Caches as seen from the first online CPU, which is a performance core
+	// on every hybrid system we know of.
+	std::string cachedir = cpudir + "cpu" + std::to_string(*online.begin()) + "/cache/";
+	for (int i = 0; ; i++)
+	{
+		std::string dir = cachedir + "index" + std::to_string(i) + "/";
+
+		std::string type;
+		if (!readSysFile(dir + "type", type))
+			break;
+
+		long level = readSysInt(dir + "level", 0);
+		int cachesize = readSysSize(dir + "size");
+
+		if (level == 1 && type == "Data")
+		{
+			t.l1DataCacheSize = cachesize;
+			t.cacheLineSize = (int) readSysInt(dir + "coherency_line_size", t.cacheLineSize);
+		}
+		else if (level == 2 && type != "Instruction")
+			t.l2CacheSize = cachesize;
+		else if (level == 3 && type != "Instruction")
+			t.l3CacheSize = cachesize;
+	}
+}
+
+#else
+
+static void detectCPUTopology(CPUTopology &)
+{
+}
+
+#endif
+
+static CPUTopology getDetectedCPUTopology()
+{
+	CPUTopology t;
+
+	int logical = (int) std::thread::hardware_concurrency();
+	if (logical > 0)
+		t.logicalCores = t.physicalCores = t.performanceCores = logical;
+
+	detectCPUTopology(t);
+
+	t.logicalCores = std::max(t.logicalCores, 1);
+	t.physicalCores = std::min(std::max(t.physicalCores, 1), t.logicalCores);
+	t.performanceCores = std::min(std::max(t.performanceCores, 1), t.physicalCores);
+	t.efficiencyCores = t.physicalCores - t.performanceCores;
+
+	if (t.cacheLineSize <= 0)
+		t.cacheLineSize = 64;
+
+	return t;
+}
+
+const CPUTopology &getCPUTopology()
+{
+	static const CPUTopology topology = getDetectedCPUTopology();
+	return topology;
+}
+
+int getParallelThreadCount()
+{
+	return getCPUTopology().physicalCores;
+}
+
+} // love
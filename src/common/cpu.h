@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_CPU_H
+#define LOVE_CPU_H
+
+#include "config.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#	define LOVE_CPU_X86
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#	define LOVE_CPU_ARM64
+#endif
+
+// Lets a single function use instructions that the rest of the file isn't
+// compiled for. Callers must check getCPUFeatures() first.
+#if defined(LOVE_CPU_X86) && (defined(__GNUC__) || defined(__clang__))
+#	define LOVE_TARGET(features) __attribute__((target(features)))
+#else
+#	define LOVE_TARGET(features)
+#endif
+
+namespace love
+{
+
+struct CPUFeatures
+{
+	bool sse2 = false;
+	bool ssse3 = false;
+	bool sse41 = false;
+	bool sse42 = false;
+	bool avx = false;
+	bool avx2 = false;
+	bool fma = false;
+	bool f16c = false;
+	bool neon = false;
+	bool sha = false; // x86 SHA extensions, along with the SSSE3/SSE4.1 they need.
+	bool armSHA1 = false;
+	bool armSHA2 = false;
+};
+
+/**
+ * Instruction set extensions supported by both the CPU and the OS, detected
+ * once on first use.
+ **/
+const CPUFeatures &getCPUFeatures();
+
+struct CPUTopology
+{
+	int logicalCores = 1;
+	int physicalCores = 1;
+
+	// Physical cores in the fastest cluster, and in every slower one, on
+	// hybrid CPUs. Every core counts as a performance core elsewhere.
+	int performanceCores = 1;
+	int efficiencyCores = 0;
+
+	// Sizes in bytes of the caches seen by a single core, or 0 if unknown.
+	int l1DataCacheSize = 0;
+	int l2CacheSize = 0;
+	int l3CacheSize = 0;
+	int cacheLineSize = 64;
+};
+
+/**
+ * Core counts and cache sizes as reported by the OS, detected once on first
+ * use. Counts fall back to one physical core per logical core when the OS
+ * doesn't say.
+ **/
+const CPUTopology &getCPUTopology();
+
+/**
+ * Threads worth running CPU-bound work on at once, including the calling
+ * thread: one per physical core. SMT siblings mostly share the same execution
+ * units, so extra threads on them tend to just contend for cache.
+ **/
+int getParallelThreadCount();
+
+} // love
+
+#endif // LOVE_CPU_H
@@ -19,6 +19,13 @@
  **/
 
 #include "halffloat.h"
+#include "cpu.h"
+
+#if defined(LOVE_CPU_X86)
+#include <immintrin.h>
+#elif defined(LOVE_SIMD_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 namespace love
 {
@@ -153,4 +160,78 @@ half floatToHalf(float f)
 	return basetable[(conv.i >> 23) & 0x1FF] + ((conv.i & 0x007FFFFF) >> shifttable[(conv.i >> 23) & 0x1FF]);
 }
 
+#if defined(LOVE_CPU_X86)
+
+LOVE_TARGET("avx,f16c")
+static size_t halfToFloatF16C(const half *src, float *dst, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8)
+		_mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *) (src + i))));
+
+	return i;
+}
+
+LOVE_TARGET("avx,f16c")
+static size_t floatToHalfF16C(const float *src, half *dst, size_t count)
+{
+	const __m256 absmask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+	const __m256 overflow = _mm256_set1_ps(65536.0f);
+	const __m128i signbit = _mm_set1_epi16((short) 0x8000);
+	const __m128i infinity = _mm_set1_epi16(0x7C00);
+
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 v = _mm256_loadu_ps(src + i);
+
+		// The tables truncate the mantissa, so round towards zero to match.
+		__m128i h = _mm256_cvtps_ph(v, _MM_FROUND_TO_ZERO);
+
+		// Rounding towards zero turns overflow into the largest finite half,
+		// but the tables give infinity.
+		__m256 big = _mm256_cmp_ps(_mm256_and_ps(v, absmask), overflow, _CMP_GE_OQ);
+		__m128i big16 = _mm_packs_epi32(_mm_castps_si128(_mm256_castps256_ps128(big)), _mm_castps_si128(_mm256_extractf128_ps(big, 1)));
+		__m128i inf = _mm_or_si128(_mm_and_si128(h, signbit), infinity);
+		h = _mm_or_si128(_mm_andnot_si128(big16, h), _mm_and_si128(big16, inf));
+
+		_mm_storeu_si128((__m128i *) (dst + i), h);
+	}
+
+	return i;
+}
+
+#endif // LOVE_CPU_X86
+
+void halfToFloat(const half *src, float *dst, size_t count)
+{
+	size_t i = 0;
+
+#if defined(LOVE_CPU_X86)
+	if (getCPUFeatures().f16c)
+		i = halfToFloatF16C(src, dst, count);
+#elif defined(LOVE_SIMD_NEON) && defined(__aarch64__)
+	for (; i + 4 <= count; i += 4)
+		vst1q_f32(dst + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src + i))));
+#endif
+
+	for (; i < count; i++)
+		dst[i] = halfToFloat(src[i]);
+}
+
+void floatToHalf(const float *src, half *dst, size_t count)
+{
+	size_t i = 0;
+
+#if defined(LOVE_CPU_X86)
+	if (getCPUFeatures().f16c)
+		i = floatToHalfF16C(src, dst, count);
+#endif
+
+	for (; i < count; i++)
+		dst[i] = floatToHalf(src[i]);
+}
+
 } // love
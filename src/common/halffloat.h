@@ -23,6 +23,9 @@
 
 #include "int.h"
 
+// C
+#include <stddef.h>
+
 namespace love
 {
 
@@ -33,6 +36,14 @@ void halfInit();
 float halfToFloat(half h);
 half floatToHalf(float f);
 
+/**
+ * Converts arrays of values, using F16C or NEON instructions when the CPU has
+ * them. Results match the single-value versions for all finite values and
+ * infinities.
+ **/
+void halfToFloat(const half *src, float *dst, size_t count);
+void floatToHalf(const float *src, half *dst, size_t count);
+
 } // love
 
 #endif // LOVE_HALF_FLOAT_H
@@ -20,7 +20,9 @@
 
 #include "config.h"
 #include "memory.h"
+#include "types.h"
 
+#include <atomic>
 #include <stdlib.h>
 
 #ifdef LOVE_WINDOWS
@@ -67,4 +69,38 @@ size_t alignUp(size_t size, size_t alignment)
 	return (size + alignment - 1) & (~(alignment - 1));
 }
 
+// Indexed by type ID.
+static std::atomic<Type *> statsTypes[Type::MAX_TYPES];
+static std::atomic<int64> statsCounts[Type::MAX_TYPES];
+static std::atomic<int64> statsBytes[Type::MAX_TYPES];
+
+void addTypeMemoryStats(Type &type, int64 count, int64 bytes)
+{
+	uint32 id = type.getId();
+
+	statsTypes[id].store(&type, std::memory_order_relaxed);
+	statsCounts[id].fetch_add(count, std::memory_order_relaxed);
+	statsBytes[id].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+std::vector<TypeMemoryStats> getTypeMemoryStats()
+{
+	std::vector<TypeMemoryStats> stats;
+
+	for (uint32 id = 0; id < Type::MAX_TYPES; id++)
+	{
+		Type *type = statsTypes[id].load(std::memory_order_relaxed);
+		if (type == nullptr)
+			continue;
+
+		TypeMemoryStats s;
+		s.type = type;
+		s.count = statsCounts[id].load(std::memory_order_relaxed);
+		s.bytes = statsBytes[id].load(std::memory_order_relaxed);
+		stats.push_back(s);
+	}
+
+	return stats;
+}
+
 } // love
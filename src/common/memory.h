@@ -20,11 +20,16 @@
 
 #pragma once
 
+#include "int.h"
+
 #include <stddef.h>
+#include <vector>
 
 namespace love
 {
 
+class Type;
+
 bool alignedMalloc(void **mem, size_t size, size_t alignment);
 void alignedFree(void *mem);
 
@@ -35,4 +40,22 @@ size_t getPageSize();
  **/
 size_t alignUp(size_t size, size_t alignment);
 
+struct TypeMemoryStats
+{
+	Type *type;
+	int64 count;
+	int64 bytes;
+};
+
+/**
+ * Adjusts the live object count and the native memory total of a type. Objects
+ * report themselves through Object::setNativeMemorySize.
+ **/
+void addTypeMemoryStats(Type &type, int64 count, int64 bytes);
+
+/**
+ * Gets the stats of every type which has had objects reported.
+ **/
+std::vector<TypeMemoryStats> getTypeMemoryStats();
+
 } // love
@@ -0,0 +1,222 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "common/config.h"
+#include "profiling.h"
+#include "thread/threads.h"
+
+#include <algorithm>
+#include <chrono>
+#include <unordered_set>
+
+namespace love
+{
+
+std::atomic<int> profilingFlags(0);
+
+// Each thread's trace stops growing at this many events, so a forgotten trace
+// doesn't use up all memory.
+static const size_t MAX_TRACE_EVENTS = 1 << 20;
+
+static std::atomic<int> nextThreadID(1);
+
+static thread::Mutex *getStacksMutex()
+{
+	// Function-local statics are initialized safely by the first thread which
+	// needs them, which may not be the main thread.
+	static thread::MutexRef mutex;
+	return mutex;
+}
+
+static std::vector<ProfileZoneStack *> &getStacks()
+{
+	static std::vector<ProfileZoneStack *> stacks;
+	return stacks;
+}
+
+// Traces of threads which have exited. Only accessed with the stacks locked.
+static std::vector<ProfileThreadTrace> &getFinishedTraces()
+{
+	static std::vector<ProfileThreadTrace> traces;
+	return traces;
+}
+
+static double getTraceTime()
+{
+	static const auto epoch = std::chrono::steady_clock::now();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+namespace
+{
+
+// Owns the calling thread's zone stack, and unregisters it when the thread
+// exits.
+struct ThreadZoneStack
+{
+	ProfileZoneStack *stack = nullptr;
+
+	~ThreadZoneStack()
+	{
+		if (stack == nullptr)
+			return;
+
+		{
+			thread::Lock lock(getStacksMutex());
+			auto &stacks = getStacks();
+			stacks.erase(std::remove(stacks.begin(), stacks.end(), stack), stacks.end());
+
+			if (!stack->trace.events.empty() || stack->trace.dropped > 0)
+			{
+				stack->trace.threadName = stack->threadName;
+				getFinishedTraces().push_back(std::move(stack->trace));
+			}
+		}
+
+		delete stack->traceMutex;
+		delete stack;
+	}
+};
+
+thread_local ThreadZoneStack threadZoneStack;
+
+} // anonymous namespace
+
+ProfileZoneStack *getProfileZoneStack()
+{
+	ProfileZoneStack *stack = threadZoneStack.stack;
+	if (stack != nullptr)
+		return stack;
+
+	stack = new ProfileZoneStack();
+	stack->depth.store(0);
+	stack->luaSampled.store(false);
+	stack->snapshotTick = 0;
+
+	// Threads started by LOVE set their own name.
+	stack->threadName = "main";
+
+	for (int i = 0; i < ProfileZoneStack::MAX_DEPTH; i++)
+		stack->zones[i].store(nullptr);
+
+	stack->traceMutex = thread::newMutex();
+	stack->trace.threadID = nextThreadID.fetch_add(1);
+	stack->trace.dropped = 0;
+
+	{
+		thread::Lock lock(getStacksMutex());
+		getStacks().push_back(stack);
+	}
+
+	threadZoneStack.stack = stack;
+	return stack;
+}
+
+void setProfileThreadName(const std::string &name)
+{
+	ProfileZoneStack *stack = getProfileZoneStack();
+
+	thread::Lock lock(getStacksMutex());
+	stack->threadName = name;
+}
+
+void pushProfileZone(const char *name)
+{
+	ProfileZoneStack *stack = getProfileZoneStack();
+	int depth = stack->depth.load(std::memory_order_relaxed);
+
+	if (depth < ProfileZoneStack::MAX_DEPTH)
+		stack->zones[depth].store(name, std::memory_order_relaxed);
+
+	// The sampler loads the depth with acquire ordering, so it sees the name.
+	stack->depth.store(depth + 1, std::memory_order_release);
+}
+
+void popProfileZone()
+{
+	ProfileZoneStack *stack = getProfileZoneStack();
+	stack->depth.store(stack->depth.load(std::memory_order_relaxed) - 1, std::memory_order_release);
+}
+
+void forEachProfileZoneStack(const std::function<void(ProfileZoneStack &)> &func)
+{
+	thread::Lock lock(getStacksMutex());
+
+	for (ProfileZoneStack *stack : getStacks())
+		func(*stack);
+}
+
+void addProfileTraceEvent(const char *name, char phase)
+{
+	ProfileZoneStack *stack = getProfileZoneStack();
+	ProfileTraceEvent event = {name, getTraceTime(), phase};
+
+	thread::Lock lock(stack->traceMutex);
+
+	if (stack->trace.events.size() < MAX_TRACE_EVENTS)
+		stack->trace.events.push_back(event);
+	else
+		stack->trace.dropped++;
+}
+
+const char *internProfileName(const std::string &name)
+{
+	static thread::MutexRef mutex;
+	static std::unordered_set<std::string> names;
+
+	thread::Lock lock(mutex);
+
+	// Elements of an unordered_set don't move when it grows.
+	return names.insert(name).first->c_str();
+}
+
+std::vector<ProfileThreadTrace> getProfileTraces()
+{
+	thread::Lock lock(getStacksMutex());
+
+	std::vector<ProfileThreadTrace> traces = getFinishedTraces();
+
+	for (ProfileZoneStack *stack : getStacks())
+	{
+		thread::Lock tracelock(stack->traceMutex);
+
+		traces.push_back(stack->trace);
+		traces.back().threadName = stack->threadName;
+	}
+
+	return traces;
+}
+
+void clearProfileTraces()
+{
+	thread::Lock lock(getStacksMutex());
+
+	getFinishedTraces().clear();
+
+	for (ProfileZoneStack *stack : getStacks())
+	{
+		thread::Lock tracelock(stack->traceMutex);
+
+		stack->trace.events.clear();
+		stack->trace.dropped = 0;
+	}
+}
+
+} // love
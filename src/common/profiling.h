@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+#include "int.h"
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace love
+{
+
+namespace thread
+{
+class Mutex;
+}
+
+enum ProfileFlags
+{
+	PROFILE_SAMPLING = 1 << 0,
+	PROFILE_TRACING = 1 << 1,
+};
+
+/**
+ * A timestamped event in a thread's trace. The phase is 'B' (begin zone), 'E'
+ * (end zone) or 'i' (instant), as in the Chrome trace format.
+ **/
+struct ProfileTraceEvent
+{
+	const char *name;
+	double time;
+	char phase;
+};
+
+struct ProfileThreadTrace
+{
+	int threadID;
+	std::string threadName;
+	std::vector<ProfileTraceEvent> events;
+	int64 dropped;
+};
+
+/**
+ * The named native zones a thread is currently inside. The sampling profiler
+ * in love.profiler reads these from its own thread.
+ **/
+struct ProfileZoneStack
+{
+	static const int MAX_DEPTH = 32;
+
+	// Zones deeper than MAX_DEPTH are counted but not recorded.
+	std::atomic<const char *> zones[MAX_DEPTH];
+	std::atomic<int> depth;
+
+	// Set while the thread's Lua code is being sampled. Its zones are then
+	// added to the Lua samples instead of being sampled separately.
+	std::atomic<bool> luaSampled;
+
+	// These are only accessed while the stacks are locked.
+	std::string threadName;
+	std::vector<const char *> snapshot;
+	uint64 snapshotTick;
+
+	// The thread's trace is only accessed with traceMutex locked.
+	thread::Mutex *traceMutex;
+	ProfileThreadTrace trace;
+};
+
+extern std::atomic<int> profilingFlags;
+
+/**
+ * Gets the zone stack of the calling thread, creating it if needed.
+ **/
+ProfileZoneStack *getProfileZoneStack();
+
+void setProfileThreadName(const std::string &name);
+
+void pushProfileZone(const char *name);
+void popProfileZone();
+
+/**
+ * Calls the function for the zone stack of every thread which has one, while
+ * keeping the stacks locked.
+ **/
+void forEachProfileZoneStack(const std::function<void(ProfileZoneStack &)> &func);
+
+/**
+ * Adds an event to the calling thread's trace. The name must outlive the
+ * trace, see internProfileName.
+ **/
+void addProfileTraceEvent(const char *name, char phase);
+
+/**
+ * Gets a copy of the name which lives as long as the program, for names which
+ * aren't string literals.
+ **/
+const char *internProfileName(const std::string &name);
+
+/**
+ * Gets the traces of every thread, including threads which have exited since
+ * the traces were last cleared.
+ **/
+std::vector<ProfileThreadTrace> getProfileTraces();
+void clearProfileTraces();
+
+/**
+ * Marks the enclosing scope as a named zone of native code for the sampling
+ * profiler and the tracer. The name must be a string literal. This only costs
+ * an atomic load when neither is running.
+ **/
+class ProfileZone
+{
+public:
+
+	ProfileZone(const char *name)
+		: name(name)
+		, flags(profilingFlags.load(std::memory_order_relaxed))
+	{
+		if (flags & PROFILE_SAMPLING)
+			pushProfileZone(name);
+		if (flags & PROFILE_TRACING)
+			addProfileTraceEvent(name, 'B');
+	}
+
+	~ProfileZone()
+	{
+		if (flags & PROFILE_TRACING)
+			addProfileTraceEvent(name, 'E');
+		if (flags & PROFILE_SAMPLING)
+			popProfileZone();
+	}
+
+private:
+
+	const char *name;
+	int flags;
+
+}; // ProfileZone
+
+#define LOVE_PROFILE_ZONE_CONCAT_(a, b) a##b
+#define LOVE_PROFILE_ZONE_CONCAT(a, b) LOVE_PROFILE_ZONE_CONCAT_(a, b)
+#define LOVE_PROFILE_ZONE(name) love::ProfileZone LOVE_PROFILE_ZONE_CONCAT(love_profile_zone_, __LINE__)(name)
+
+} // love
@@ -29,6 +29,7 @@
 
 // C++
 #include <algorithm>
+#include <climits>
 #include <iostream>
 #include <cstdio>
 #include <sstream>
@@ -36,6 +37,64 @@
 namespace love
 {
 
+// The objects registry table keeps the proxies of thread-confined objects at
+// integer keys, whose index is cached in the Object, so pushing an existing
+// proxy doesn't hash the object's pointer. Free slots form a list headed at
+// PROXY_SLOTS_FREE.
+static const int PROXY_SLOTS_FREE = 0;
+static const int PROXY_SLOTS_COUNT = -1;
+
+// Native memory sizes from which new proxies step the Lua GC.
+static const int64 LARGE_NATIVE_MEMORY_SIZE = 256 * 1024;
+
+static int allocproxyslot(lua_State *L, int tidx)
+{
+	lua_rawgeti(L, tidx, PROXY_SLOTS_FREE);
+	int slot = (int) lua_tointeger(L, -1);
+	lua_pop(L, 1);
+
+	if (slot > 0)
+	{
+		// Unlink the slot from the free list.
+		lua_rawgeti(L, tidx, slot);
+		lua_rawseti(L, tidx, PROXY_SLOTS_FREE);
+		return slot;
+	}
+
+	// Can't use the table's length, it has holes where collected proxies
+	// were, whose slots are freed later by __gc.
+	lua_rawgeti(L, tidx, PROXY_SLOTS_COUNT);
+	slot = (int) lua_tointeger(L, -1) + 1;
+	lua_pop(L, 1);
+
+	lua_pushinteger(L, slot);
+	lua_rawseti(L, tidx, PROXY_SLOTS_COUNT);
+
+	return slot;
+}
+
+static void freeproxyslot(lua_State *L, Proxy *p)
+{
+	if (p->slot <= 0)
+		return;
+
+	luax_getregistry(L, REGISTRY_OBJECTS);
+
+	if (lua_istable(L, -1))
+	{
+		int tidx = lua_gettop(L);
+
+		// Link the slot into the free list.
+		lua_rawgeti(L, tidx, PROXY_SLOTS_FREE);
+		lua_rawseti(L, tidx, p->slot);
+		lua_pushinteger(L, p->slot);
+		lua_rawseti(L, tidx, PROXY_SLOTS_FREE);
+	}
+
+	lua_pop(L, 1);
+	p->slot = 0;
+}
+
 /**
  * Called when an object is collected. The object is released
  * once in this function, possibly deleting it.
@@ -43,6 +102,7 @@ namespace love
 static int w__gc(lua_State *L)
 {
 	Proxy *p = (Proxy *) lua_touserdata(L, 1);
+	freeproxyslot(L, p);
 	if (p->object != nullptr)
 	{
 		p->object->release();
@@ -91,6 +151,8 @@ static int w__release(lua_State *L)
 
 	if (object != nullptr)
 	{
+		freeproxyslot(L, p);
+
 		p->object = nullptr;
 		object->release();
 
@@ -333,6 +395,7 @@ int luax_register_module(lua_State *L, const WrappedModule &m)
 	Proxy *p = (Proxy *)lua_newuserdata(L, sizeof(Proxy));
 	p->object = m.module;
 	p->type = m.type;
+	p->slot = 0;
 
 	luaL_newmetatable(L, m.module->getName());
 	lua_pushvalue(L, -1);
@@ -371,6 +434,20 @@ int luax_register_module(lua_State *L, const WrappedModule &m)
 	return 1;
 }
 
+int luax_loadembedded(lua_State *L, const unsigned char *bytecode, size_t bytecodesize, const char *source, size_t sourcesize, const char *name)
+{
+	if (bytecode != nullptr)
+	{
+		if (luaL_loadbuffer(L, (const char *) bytecode, bytecodesize, name) == 0)
+			return 0;
+
+		// Pop the error message.
+		lua_pop(L, 1);
+	}
+
+	return luaL_loadbuffer(L, source, sourcesize, name);
+}
+
 int luax_preload(lua_State *L, lua_CFunction f, const char *name)
 {
 	lua_getglobal(L, "package");
@@ -519,6 +596,7 @@ void luax_rawnewtype(lua_State *L, love::Type &type, love::Object *object)
 
 	u->object = object;
 	u->type = &type;
+	u->slot = 0;
 
 	const char *name = type.getName();
 	luaL_newmetatable(L, name);
@@ -536,6 +614,12 @@ void luax_rawnewtype(lua_State *L, love::Type &type, love::Object *object)
 	}
 
 	lua_setmetatable(L, -2);
+
+	// The Lua GC only sees the small proxy, so large native allocations make
+	// it do extra work in proportion, to collect them in time.
+	int64 memsize = object->getNativeMemorySize();
+	if (memsize >= LARGE_NATIVE_MEMORY_SIZE)
+		lua_gc(L, LUA_GCSTEP, (int) std::min(memsize / 1024, (int64) INT_MAX));
 }
 
 void luax_pushtype(lua_State *L, love::Type &type, love::Object *object)
@@ -556,6 +640,40 @@ void luax_pushtype(lua_State *L, love::Type &type, love::Object *object)
 		return luax_rawnewtype(L, type, object);
 	}
 
+	int tidx = lua_gettop(L);
+	const void *owner = lua_topointer(L, tidx);
+
+	int slot = object->getProxySlot(owner);
+	if (slot > 0)
+	{
+		lua_rawgeti(L, tidx, slot);
+
+		// The slot may have been freed and reused since.
+		Proxy *p = (Proxy *) lua_touserdata(L, -1);
+		if (p != nullptr && p->object == object)
+		{
+			lua_remove(L, tidx);
+			return;
+		}
+
+		lua_pop(L, 1);
+	}
+
+	if (object->isThreadConfined())
+	{
+		luax_rawnewtype(L, type, object);
+
+		slot = allocproxyslot(L, tidx);
+		lua_pushvalue(L, -1);
+		lua_rawseti(L, tidx, slot);
+
+		((Proxy *) lua_touserdata(L, -1))->slot = slot;
+		object->setProxySlot(owner, slot);
+
+		lua_remove(L, tidx);
+		return;
+	}
+
 	// Get the value of loveobjects[object] on the stack.
 	lua_pushlightuserdata(L, object);
 	lua_gettable(L, -2);
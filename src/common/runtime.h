@@ -72,6 +72,10 @@ struct Proxy
 
 	// Pointer to the actual object.
 	Object *object;
+
+	// Index of the proxy in the objects registry table, or 0 if it's keyed by
+	// the object's pointer instead (see luax_pushtype.)
+	int slot;
 };
 
 /**
@@ -272,6 +276,26 @@ int luax_require(lua_State *L, const char *name);
  **/
 int luax_register_module(lua_State *L, const WrappedModule &m);
 
+/**
+ * Loads a Lua script embedded in love, preferring its precompiled bytecode if
+ * there is any, and falling back to the source if the bytecode was made for a
+ * different Lua version. Returns the luaL_loadbuffer status.
+ * @param bytecode The bytecode, or null. See LOVE_EMBEDDED_BYTECODE.
+ * @param source The source code of the script.
+ * @param name The chunk name.
+ **/
+int luax_loadembedded(lua_State *L, const unsigned char *bytecode, size_t bytecodesize, const char *source, size_t sourcesize, const char *name);
+
+// The bytecode arguments of luax_loadembedded for a script, which is only
+// compiled when building with LOVE_PRECOMPILE_LUA. The generated header
+// (luabytecode/<name>.h) has to be included when LOVE_PRECOMPILED_LUA is
+// defined.
+#ifdef LOVE_PRECOMPILED_LUA
+#define LOVE_EMBEDDED_BYTECODE(name) name##_bytecode, sizeof(name##_bytecode)
+#else
+#define LOVE_EMBEDDED_BYTECODE(name) nullptr, 0
+#endif
+
 /**
  * Inserts a module with 'name' into the package.preloaded table.
  * @param f The function to be called when the module is opened.
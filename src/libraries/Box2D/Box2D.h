@@ -65,4 +65,6 @@ For discussion please visit http://box2d.org/forum
 #include <Box2D/Dynamics/Joints/b2WeldJoint.h>
 #include <Box2D/Dynamics/Joints/b2WheelJoint.h>
 
+#include <Box2D/Dynamics/b2WorldState.h>
+
 #endif
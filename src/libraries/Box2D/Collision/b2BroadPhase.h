@@ -107,6 +107,7 @@ public:
 private:
 
 	friend class b2DynamicTree;
+	friend class b2WorldState;
 
 	void BufferMove(int32 proxyId);
 	void UnBufferMove(int32 proxyId);
@@ -125,6 +125,8 @@ public:
 
 private:
 
+	friend class b2WorldState;
+
 	int32 AllocateNode();
 	void FreeNode(int32 node);
 
@@ -149,6 +149,7 @@ b2Contact::b2Contact(b2Fixture* fA, int32 indexA, b2Fixture* fB, int32 indexB)
 	m_nodeB.other = NULL;
 
 	m_toiCount = 0;
+	m_updateIndex = -1;
 
 	m_friction = b2MixFriction(m_fixtureA->m_friction, m_fixtureB->m_friction);
 	m_restitution = b2MixRestitution(m_fixtureA->m_restitution, m_fixtureB->m_restitution);
@@ -160,13 +161,17 @@ b2Contact::b2Contact(b2Fixture* fA, int32 indexA, b2Fixture* fB, int32 indexB)
 // Note: do not assume the fixture AABBs are overlapping or are valid.
 void b2Contact::Update(b2ContactListener* listener)
 {
-	b2Manifold oldManifold = m_manifold;
+	b2Manifold manifold;
+	bool touching = EvaluateUpdate(&manifold);
+	ApplyUpdate(manifold, touching, listener);
+}
 
-	// Re-enable this contact.
-	m_flags |= e_enabledFlag;
+bool b2Contact::EvaluateUpdate(b2Manifold* manifold)
+{
+	// Start from the old manifold so untouched fields keep their values.
+	*manifold = m_manifold;
 
 	bool touching = false;
-	bool wasTouching = (m_flags & e_touchingFlag) == e_touchingFlag;
 
 	bool sensorA = m_fixtureA->IsSensor();
 	bool sensorB = m_fixtureB->IsSensor();
@@ -185,25 +190,25 @@ void b2Contact::Update(b2ContactListener* listener)
 		touching = b2TestOverlap(shapeA, m_indexA, shapeB, m_indexB, xfA, xfB);
 
 		// Sensors don't generate manifolds.
-		m_manifold.pointCount = 0;
+		manifold->pointCount = 0;
 	}
 	else
 	{
-		Evaluate(&m_manifold, xfA, xfB);
-		touching = m_manifold.pointCount > 0;
+		Evaluate(manifold, xfA, xfB);
+		touching = manifold->pointCount > 0;
 
 		// Match old contact ids to new contact ids and copy the
 		// stored impulses to warm start the solver.
-		for (int32 i = 0; i < m_manifold.pointCount; ++i)
+		for (int32 i = 0; i < manifold->pointCount; ++i)
 		{
-			b2ManifoldPoint* mp2 = m_manifold.points + i;
+			b2ManifoldPoint* mp2 = manifold->points + i;
 			mp2->normalImpulse = 0.0f;
 			mp2->tangentImpulse = 0.0f;
 			b2ContactID id2 = mp2->id;
 
-			for (int32 j = 0; j < oldManifold.pointCount; ++j)
+			for (int32 j = 0; j < m_manifold.pointCount; ++j)
 			{
-				b2ManifoldPoint* mp1 = oldManifold.points + j;
+				const b2ManifoldPoint* mp1 = m_manifold.points + j;
 
 				if (mp1->id.key == id2.key)
 				{
@@ -213,12 +218,29 @@ void b2Contact::Update(b2ContactListener* listener)
 				}
 			}
 		}
+	}
 
-		if (touching != wasTouching)
-		{
-			bodyA->SetAwake(true);
-			bodyB->SetAwake(true);
-		}
+	return touching;
+}
+
+void b2Contact::ApplyUpdate(const b2Manifold& manifold, bool touching, b2ContactListener* listener)
+{
+	b2Manifold oldManifold = m_manifold;
+	m_manifold = manifold;
+
+	// Re-enable this contact.
+	m_flags |= e_enabledFlag;
+
+	bool wasTouching = (m_flags & e_touchingFlag) == e_touchingFlag;
+
+	bool sensorA = m_fixtureA->IsSensor();
+	bool sensorB = m_fixtureB->IsSensor();
+	bool sensor = sensorA || sensorB;
+
+	if (sensor == false && touching != wasTouching)
+	{
+		m_fixtureA->GetBody()->SetAwake(true);
+		m_fixtureB->GetBody()->SetAwake(true);
 	}
 
 	if (touching)
@@ -146,10 +146,12 @@ public:
 
 protected:
 	friend class b2ContactManager;
+	friend class b2ContactUpdateTask;
 	friend class b2World;
 	friend class b2ContactSolver;
 	friend class b2Body;
 	friend class b2Fixture;
+	friend class b2WorldState;
 
 	// Flags stored in m_flags
 	enum
@@ -189,6 +191,13 @@ protected:
 
 	void Update(b2ContactListener* listener);
 
+	// Update is split in two so the manifolds of many contacts can be
+	// computed in parallel. EvaluateUpdate only reads the contact and its
+	// bodies, and returns whether the new manifold is touching. ApplyUpdate
+	// stores the result, wakes the bodies and calls the listener.
+	bool EvaluateUpdate(b2Manifold* manifold);
+	void ApplyUpdate(const b2Manifold& manifold, bool touching, b2ContactListener* listener);
+
 	static b2ContactRegister s_registers[b2Shape::e_typeCount][b2Shape::e_typeCount];
 	static bool s_initialized;
 
@@ -213,6 +222,10 @@ protected:
 	int32 m_toiCount;
 	float32 m_toi;
 
+	// Index of this contact's precomputed update during a parallel
+	// b2ContactManager::Collide, or -1.
+	int32 m_updateIndex;
+
 	float32 m_friction;
 	float32 m_restitution;
 
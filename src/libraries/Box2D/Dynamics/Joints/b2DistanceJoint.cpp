@@ -258,3 +258,14 @@ void b2DistanceJoint::Dump()
 	b2Log("  jd.dampingRatio = %.15lef;\n", m_dampingRatio);
 	b2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
+
+int32 b2DistanceJoint::GetSolverState(float32* state) const
+{
+	state[0] = m_impulse;
+	return 1;
+}
+
+void b2DistanceJoint::SetSolverState(const float32* state)
+{
+	m_impulse = state[0];
+}
@@ -249,3 +249,18 @@ void b2FrictionJoint::Dump()
 	b2Log("  jd.maxTorque = %.15lef;\n", m_maxTorque);
 	b2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
+
+int32 b2FrictionJoint::GetSolverState(float32* state) const
+{
+	state[0] = m_linearImpulse.x;
+	state[1] = m_linearImpulse.y;
+	state[2] = m_angularImpulse;
+	return 3;
+}
+
+void b2FrictionJoint::SetSolverState(const float32* state)
+{
+	m_linearImpulse.x = state[0];
+	m_linearImpulse.y = state[1];
+	m_angularImpulse = state[2];
+}
@@ -417,3 +417,14 @@ void b2GearJoint::Dump()
 	b2Log("  jd.ratio = %.15lef;\n", m_ratio);
 	b2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
+
+int32 b2GearJoint::GetSolverState(float32* state) const
+{
+	state[0] = m_impulse;
+	return 1;
+}
+
+void b2GearJoint::SetSolverState(const float32* state)
+{
+	m_impulse = state[0];
+}
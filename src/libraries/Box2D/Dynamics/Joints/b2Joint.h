@@ -26,6 +26,9 @@ class b2Joint;
 struct b2SolverData;
 class b2BlockAllocator;
 
+/// The most floats used by a joint's solver state.
+#define b2_maxJointSolverState	5
+
 enum b2JointType
 {
 	e_unknownJoint,
@@ -149,11 +152,19 @@ public:
 	/// Shift the origin for any points stored in world coordinates.
 	virtual void ShiftOrigin(const b2Vec2& newOrigin) { B2_NOT_USED(newOrigin);  }
 
+	/// Get the solver state kept between steps for warm starting, as at most
+	/// b2_maxJointSolverState floats. Returns the number of floats written.
+	virtual int32 GetSolverState(float32* state) const { B2_NOT_USED(state); return 0; }
+
+	/// Restore solver state written by GetSolverState.
+	virtual void SetSolverState(const float32* state) { B2_NOT_USED(state); }
+
 protected:
 	friend class b2World;
 	friend class b2Body;
 	friend class b2Island;
 	friend class b2GearJoint;
+	friend class b2WorldState;
 
 	static b2Joint* Create(const b2JointDef* def, b2BlockAllocator* allocator);
 	static void Destroy(b2Joint* joint, b2BlockAllocator* allocator);
@@ -302,3 +302,18 @@ void b2MotorJoint::Dump()
 	b2Log("  jd.correctionFactor = %.15lef;\n", m_correctionFactor);
 	b2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
+
+int32 b2MotorJoint::GetSolverState(float32* state) const
+{
+	state[0] = m_linearImpulse.x;
+	state[1] = m_linearImpulse.y;
+	state[2] = m_angularImpulse;
+	return 3;
+}
+
+void b2MotorJoint::SetSolverState(const float32* state)
+{
+	m_linearImpulse.x = state[0];
+	m_linearImpulse.y = state[1];
+	m_angularImpulse = state[2];
+}
@@ -147,6 +147,12 @@ public:
 	/// Dump to b2Log
 	void Dump();
 
+	/// Implement b2Joint::GetSolverState
+	int32 GetSolverState(float32* state) const;
+
+	/// Implement b2Joint::SetSolverState
+	void SetSolverState(const float32* state);
+
 protected:
 	friend class b2Joint;
 	friend class b2GearJoint;
@@ -346,3 +346,14 @@ void b2PulleyJoint::ShiftOrigin(const b2Vec2& newOrigin)
 	m_groundAnchorA -= newOrigin;
 	m_groundAnchorB -= newOrigin;
 }
+
+int32 b2PulleyJoint::GetSolverState(float32* state) const
+{
+	state[0] = m_impulse;
+	return 1;
+}
+
+void b2PulleyJoint::SetSolverState(const float32* state)
+{
+	m_impulse = state[0];
+}
@@ -112,6 +112,12 @@ public:
 	/// Implement b2Joint::ShiftOrigin
 	void ShiftOrigin(const b2Vec2& newOrigin);
 
+	/// Implement b2Joint::GetSolverState
+	int32 GetSolverState(float32* state) const;
+
+	/// Implement b2Joint::SetSolverState
+	void SetSolverState(const float32* state);
+
 protected:
 
 	friend class b2Joint;
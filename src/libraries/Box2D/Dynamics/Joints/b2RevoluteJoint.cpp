@@ -500,3 +500,22 @@ void b2RevoluteJoint::Dump()
 	b2Log("  jd.maxMotorTorque = %.15lef;\n", m_maxMotorTorque);
 	b2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
+
+int32 b2RevoluteJoint::GetSolverState(float32* state) const
+{
+	state[0] = m_impulse.x;
+	state[1] = m_impulse.y;
+	state[2] = m_impulse.z;
+	state[3] = m_motorImpulse;
+	state[4] = (float32) m_limitState;
+	return 5;
+}
+
+void b2RevoluteJoint::SetSolverState(const float32* state)
+{
+	m_impulse.x = state[0];
+	m_impulse.y = state[1];
+	m_impulse.z = state[2];
+	m_motorImpulse = state[3];
+	m_limitState = (b2LimitState) (int32) state[4];
+}
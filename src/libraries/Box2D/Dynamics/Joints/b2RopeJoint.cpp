@@ -239,3 +239,16 @@ void b2RopeJoint::Dump()
 	b2Log("  jd.maxLength = %.15lef;\n", m_maxLength);
 	b2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
+
+int32 b2RopeJoint::GetSolverState(float32* state) const
+{
+	state[0] = m_impulse;
+	state[1] = (float32) m_state;
+	return 2;
+}
+
+void b2RopeJoint::SetSolverState(const float32* state)
+{
+	m_impulse = state[0];
+	m_state = (b2LimitState) (int32) state[1];
+}
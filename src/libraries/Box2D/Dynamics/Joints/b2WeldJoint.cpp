@@ -342,3 +342,18 @@ void b2WeldJoint::Dump()
 	b2Log("  jd.dampingRatio = %.15lef;\n", m_dampingRatio);
 	b2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
+
+int32 b2WeldJoint::GetSolverState(float32* state) const
+{
+	state[0] = m_impulse.x;
+	state[1] = m_impulse.y;
+	state[2] = m_impulse.z;
+	return 3;
+}
+
+void b2WeldJoint::SetSolverState(const float32* state)
+{
+	m_impulse.x = state[0];
+	m_impulse.y = state[1];
+	m_impulse.z = state[2];
+}
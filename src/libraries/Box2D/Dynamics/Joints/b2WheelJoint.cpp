@@ -417,3 +417,18 @@ void b2WheelJoint::Dump()
 	b2Log("  jd.dampingRatio = %.15lef;\n", m_dampingRatio);
 	b2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
+
+int32 b2WheelJoint::GetSolverState(float32* state) const
+{
+	state[0] = m_impulse;
+	state[1] = m_motorImpulse;
+	state[2] = m_springImpulse;
+	return 3;
+}
+
+void b2WheelJoint::SetSolverState(const float32* state)
+{
+	m_impulse = state[0];
+	m_motorImpulse = state[1];
+	m_springImpulse = state[2];
+}
@@ -390,6 +390,7 @@ private:
 	friend class b2ContactManager;
 	friend class b2ContactSolver;
 	friend class b2Contact;
+	friend class b2WorldState;
 	
 	friend class b2DistanceJoint;
 	friend class b2FrictionJoint;
@@ -25,6 +25,42 @@
 b2ContactFilter b2_defaultFilter;
 b2ContactListener b2_defaultListener;
 
+// Contacts are updated in parallel in batches of at least this many.
+static const int32 b2_minContactUpdateBatch = 32;
+
+struct b2ContactUpdate
+{
+	b2Contact* contact;
+	b2Manifold manifold;
+	bool touching;
+};
+
+class b2ContactUpdateTask : public b2Task
+{
+public:
+	b2ContactUpdateTask(b2ContactUpdate* updates, int32 count, int32 batchCount)
+		: m_updates(updates), m_count(count), m_batchCount(batchCount) {}
+
+	void Execute(int32 index)
+	{
+		int32 size = m_count / m_batchCount;
+		int32 remainder = m_count % m_batchCount;
+		int32 begin = index * size + b2Min(index, remainder);
+		int32 end = begin + size + (index < remainder ? 1 : 0);
+
+		for (int32 i = begin; i < end; ++i)
+		{
+			b2ContactUpdate* update = m_updates + i;
+			update->touching = update->contact->EvaluateUpdate(&update->manifold);
+		}
+	}
+
+private:
+	b2ContactUpdate* m_updates;
+	int32 m_count;
+	int32 m_batchCount;
+};
+
 b2ContactManager::b2ContactManager()
 {
 	m_contactList = NULL;
@@ -32,6 +68,14 @@ b2ContactManager::b2ContactManager()
 	m_contactFilter = &b2_defaultFilter;
 	m_contactListener = &b2_defaultListener;
 	m_allocator = NULL;
+	m_taskExecutor = NULL;
+	m_updateBuffer = NULL;
+	m_updateCapacity = 0;
+}
+
+b2ContactManager::~b2ContactManager()
+{
+	b2Free(m_updateBuffer);
 }
 
 void b2ContactManager::Destroy(b2Contact* c)
@@ -102,8 +146,82 @@ void b2ContactManager::Destroy(b2Contact* c)
 // This is the top level collision call for the time step. Here
 // all the narrow phase collision is processed for the world
 // contact list.
+void b2ContactManager::PrepareUpdates()
+{
+	if (m_taskExecutor == NULL)
+	{
+		return;
+	}
+
+	int32 threadCount = m_taskExecutor->GetThreadCount();
+	if (threadCount < 2 || m_contactCount < 2 * b2_minContactUpdateBatch)
+	{
+		return;
+	}
+
+	if (m_updateCapacity < m_contactCount)
+	{
+		b2Free(m_updateBuffer);
+		m_updateCapacity = b2Max(m_contactCount, 2 * m_updateCapacity);
+		m_updateBuffer = (b2ContactUpdate*)b2Alloc(m_updateCapacity * sizeof(b2ContactUpdate));
+	}
+
+	// Collect the contacts Collide is going to update. Contacts flagged for
+	// filtering may be destroyed by the user's filter, so they're left to
+	// Collide. The checks here only read state, and bodies can only be woken
+	// up during Collide, so every contact picked here gets updated there.
+	int32 count = 0;
+	for (b2Contact* c = m_contactList; c; c = c->GetNext())
+	{
+		if (c->m_flags & b2Contact::e_filterFlag)
+		{
+			continue;
+		}
+
+		b2Fixture* fixtureA = c->GetFixtureA();
+		b2Fixture* fixtureB = c->GetFixtureB();
+		b2Body* bodyA = fixtureA->GetBody();
+		b2Body* bodyB = fixtureB->GetBody();
+
+		bool activeA = bodyA->IsAwake() && bodyA->m_type != b2_staticBody;
+		bool activeB = bodyB->IsAwake() && bodyB->m_type != b2_staticBody;
+		if (activeA == false && activeB == false)
+		{
+			continue;
+		}
+
+		int32 proxyIdA = fixtureA->m_proxies[c->GetChildIndexA()].proxyId;
+		int32 proxyIdB = fixtureB->m_proxies[c->GetChildIndexB()].proxyId;
+		if (m_broadPhase.TestOverlap(proxyIdA, proxyIdB) == false)
+		{
+			continue;
+		}
+
+		c->m_updateIndex = count;
+		m_updateBuffer[count++].contact = c;
+	}
+
+	int32 batchCount = b2Min(4 * threadCount, count / b2_minContactUpdateBatch);
+	if (batchCount < 2)
+	{
+		for (int32 i = 0; i < count; ++i)
+		{
+			m_updateBuffer[i].contact->m_updateIndex = -1;
+		}
+		return;
+	}
+
+	b2ContactUpdateTask task(m_updateBuffer, count, batchCount);
+	m_taskExecutor->ParallelFor(batchCount, &task);
+}
+
 void b2ContactManager::Collide()
 {
+	// Evaluate manifolds ahead of time when a task executor is set. The
+	// results are applied below in list order, so the listener sees the
+	// same sequence of events as a serial update.
+	PrepareUpdates();
+
 	// Update awake contacts.
 	b2Contact* c = m_contactList;
 	while (c)
@@ -164,7 +282,16 @@ void b2ContactManager::Collide()
 		}
 
 		// The contact persists.
-		c->Update(m_contactListener);
+		if (c->m_updateIndex >= 0)
+		{
+			const b2ContactUpdate* update = m_updateBuffer + c->m_updateIndex;
+			c->m_updateIndex = -1;
+			c->ApplyUpdate(update->manifold, update->touching, m_contactListener);
+		}
+		else
+		{
+			c->Update(m_contactListener);
+		}
 		c = c->GetNext();
 	}
 }
@@ -162,6 +162,10 @@ b2Island::b2Island(
 	m_allocator = allocator;
 	m_listener = listener;
 
+	m_sharedStatics = false;
+	m_impulses = NULL;
+	m_sleeping = false;
+
 	m_bodies = (b2Body**)m_allocator->Allocate(bodyCapacity * sizeof(b2Body*));
 	m_contacts = (b2Contact**)m_allocator->Allocate(contactCapacity	 * sizeof(b2Contact*));
 	m_joints = (b2Joint**)m_allocator->Allocate(jointCapacity * sizeof(b2Joint*));
@@ -186,10 +190,13 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 
 	float32 h = step.dt;
 
+	m_sleeping = false;
+
 	// Integrate velocities and apply damping. Initialize the body state.
 	for (int32 i = 0; i < m_bodyCount; ++i)
 	{
 		b2Body* b = m_bodies[i];
+		int32 index = b->m_islandIndex;
 
 		b2Vec2 c = b->m_sweep.c;
 		float32 a = b->m_sweep.a;
@@ -197,8 +204,11 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 		float32 w = b->m_angularVelocity;
 
 		// Store positions for continuous collision.
-		b->m_sweep.c0 = b->m_sweep.c;
-		b->m_sweep.a0 = b->m_sweep.a;
+		if (m_sharedStatics == false || b->m_type != b2_staticBody)
+		{
+			b->m_sweep.c0 = b->m_sweep.c;
+			b->m_sweep.a0 = b->m_sweep.a;
+		}
 
 		if (b->m_type == b2_dynamicBody)
 		{
@@ -217,10 +227,10 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 			w *= 1.0f / (1.0f + h * b->m_angularDamping);
 		}
 
-		m_positions[i].c = c;
-		m_positions[i].a = a;
-		m_velocities[i].v = v;
-		m_velocities[i].w = w;
+		m_positions[index].c = c;
+		m_positions[index].a = a;
+		m_velocities[index].v = v;
+		m_velocities[index].w = w;
 	}
 
 	timer.Reset();
@@ -274,10 +284,11 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	// Integrate positions
 	for (int32 i = 0; i < m_bodyCount; ++i)
 	{
-		b2Vec2 c = m_positions[i].c;
-		float32 a = m_positions[i].a;
-		b2Vec2 v = m_velocities[i].v;
-		float32 w = m_velocities[i].w;
+		int32 index = m_bodies[i]->m_islandIndex;
+		b2Vec2 c = m_positions[index].c;
+		float32 a = m_positions[index].a;
+		b2Vec2 v = m_velocities[index].v;
+		float32 w = m_velocities[index].w;
 
 		// Check for large velocities
 		b2Vec2 translation = h * v;
@@ -298,10 +309,10 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 		c += h * v;
 		a += h * w;
 
-		m_positions[i].c = c;
-		m_positions[i].a = a;
-		m_velocities[i].v = v;
-		m_velocities[i].w = w;
+		m_positions[index].c = c;
+		m_positions[index].a = a;
+		m_velocities[index].v = v;
+		m_velocities[index].w = w;
 	}
 
 	// Solve position constraints
@@ -330,10 +341,16 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	for (int32 i = 0; i < m_bodyCount; ++i)
 	{
 		b2Body* body = m_bodies[i];
-		body->m_sweep.c = m_positions[i].c;
-		body->m_sweep.a = m_positions[i].a;
-		body->m_linearVelocity = m_velocities[i].v;
-		body->m_angularVelocity = m_velocities[i].w;
+		if (m_sharedStatics && body->m_type == b2_staticBody)
+		{
+			continue;
+		}
+
+		int32 index = body->m_islandIndex;
+		body->m_sweep.c = m_positions[index].c;
+		body->m_sweep.a = m_positions[index].a;
+		body->m_linearVelocity = m_velocities[index].v;
+		body->m_angularVelocity = m_velocities[index].w;
 		body->SynchronizeTransform();
 	}
 
@@ -372,9 +389,16 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 
 		if (minSleepTime >= b2_timeToSleep && positionSolved)
 		{
+			m_sleeping = true;
+
 			for (int32 i = 0; i < m_bodyCount; ++i)
 			{
 				b2Body* b = m_bodies[i];
+				if (m_sharedStatics && b->GetType() == b2_staticBody)
+				{
+					continue;
+				}
+
 				b->SetAwake(false);
 			}
 		}
@@ -515,7 +539,7 @@ void b2Island::SolveTOI(const b2TimeStep& subStep, int32 toiIndexA, int32 toiInd
 
 void b2Island::Report(const b2ContactVelocityConstraint* constraints)
 {
-	if (m_listener == NULL)
+	if (m_listener == NULL && m_impulses == NULL)
 	{
 		return;
 	}
@@ -534,6 +558,13 @@ void b2Island::Report(const b2ContactVelocityConstraint* constraints)
 			impulse.tangentImpulses[j] = vc->points[j].tangentImpulse;
 		}
 
-		m_listener->PostSolve(c, &impulse);
+		if (m_impulses != NULL)
+		{
+			m_impulses[i] = impulse;
+		}
+		else
+		{
+			m_listener->PostSolve(c, &impulse);
+		}
 	}
 }
@@ -28,6 +28,7 @@ class b2Joint;
 class b2StackAllocator;
 class b2ContactListener;
 struct b2ContactVelocityConstraint;
+struct b2ContactImpulse;
 struct b2Profile;
 
 /// This is an internal class.
@@ -57,6 +58,16 @@ public:
 		++m_bodyCount;
 	}
 
+	// Adds a body whose island index was already assigned. Islands solved
+	// in parallel share static bodies, which keep one index for all of them.
+	void AddIndexed(b2Body* body)
+	{
+		b2Assert(m_bodyCount < m_bodyCapacity);
+		b2Assert(0 <= body->m_islandIndex && body->m_islandIndex < m_bodyCapacity);
+		m_bodies[m_bodyCount] = body;
+		++m_bodyCount;
+	}
+
 	void Add(b2Contact* contact)
 	{
 		b2Assert(m_contactCount < m_contactCapacity);
@@ -74,6 +85,17 @@ public:
 	b2StackAllocator* m_allocator;
 	b2ContactListener* m_listener;
 
+	// When set, static bodies may be in other islands being solved at the
+	// same time, so Solve doesn't write to them.
+	bool m_sharedStatics;
+
+	// When set, Report stores the contact impulses here instead of calling
+	// the listener, so they can be reported later.
+	b2ContactImpulse* m_impulses;
+
+	// Whether the last call to Solve put the island to sleep.
+	bool m_sleeping;
+
 	b2Body** m_bodies;
 	b2Contact** m_contacts;
 	b2Joint** m_joints;
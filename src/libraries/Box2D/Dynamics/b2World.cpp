@@ -39,6 +39,10 @@ b2World::b2World(const b2Vec2& gravity)
 	m_destructionListener = NULL;
 	g_debugDraw = NULL;
 
+	m_taskExecutor = NULL;
+	m_taskAllocators = NULL;
+	m_taskAllocatorCount = 0;
+
 	m_bodyList = NULL;
 	m_jointList = NULL;
 
@@ -82,6 +86,13 @@ b2World::~b2World()
 
 		b = bNext;
 	}
+
+	for (int32 i = 0; i < m_taskAllocatorCount; ++i)
+	{
+		m_taskAllocators[i]->~b2StackAllocator();
+		b2Free(m_taskAllocators[i]);
+	}
+	b2Free(m_taskAllocators);
 }
 
 void b2World::SetDestructionListener(b2DestructionListener* listener)
@@ -89,6 +100,12 @@ void b2World::SetDestructionListener(b2DestructionListener* listener)
 	m_destructionListener = listener;
 }
 
+void b2World::SetTaskExecutor(b2TaskExecutor* executor)
+{
+	m_taskExecutor = executor;
+	m_contactManager.m_taskExecutor = executor;
+}
+
 void b2World::SetContactFilter(b2ContactFilter* filter)
 {
 	m_contactManager.m_contactFilter = filter;
@@ -389,6 +406,23 @@ void b2World::Solve(const b2TimeStep& step)
 	m_profile.solveVelocity = 0.0f;
 	m_profile.solvePosition = 0.0f;
 
+	if (m_taskExecutor != NULL && m_taskExecutor->GetThreadCount() > 1)
+	{
+		// Gear joints use bodies from outside their island, which can't be
+		// shared safely between islands solved at the same time.
+		bool gearJoint = false;
+		for (b2Joint* j = m_jointList; j; j = j->m_next)
+		{
+			gearJoint = gearJoint || j->GetType() == e_gearJoint;
+		}
+
+		if (gearJoint == false)
+		{
+			SolveParallel(step);
+			return;
+		}
+	}
+
 	// Size the island for the worst case.
 	b2Island island(m_bodyCount,
 					m_contactManager.m_contactCount,
@@ -547,30 +581,422 @@ void b2World::Solve(const b2TimeStep& step)
 
 	m_stackAllocator.Free(stack);
 
+	FinishSolve();
+}
+
+// A range of the bodies, contacts and joints gathered for parallel solving.
+struct b2IslandRange
+{
+	int32 bodyStart;
+	int32 bodyCount;
+	int32 dynamicCount;
+	int32 contactStart;
+	int32 contactCount;
+	int32 jointStart;
+	int32 jointCount;
+	bool sleeping;
+	b2Profile profile;
+};
+
+class b2IslandSolveTask : public b2Task
+{
+public:
+	const b2TimeStep* m_step;
+	b2Vec2 m_gravity;
+	bool m_allowSleep;
+	int32 m_staticCount;
+	b2Body** m_bodies;
+	b2Contact** m_contacts;
+	b2Joint** m_joints;
+	b2ContactImpulse* m_impulses;
+	b2IslandRange* m_islands;
+	int32* m_batchStarts;
+	b2StackAllocator** m_allocators;
+
+	void Execute(int32 index)
 	{
-		b2Timer timer;
-		// Synchronize fixtures, check for out of range bodies.
-		for (b2Body* b = m_bodyList; b; b = b->GetNext())
+		int32 begin = m_batchStarts[index];
+		int32 end = m_batchStarts[index + 1];
+
+		// Size one island for the largest island of the batch.
+		int32 dynamicCapacity = 0;
+		int32 contactCapacity = 0;
+		int32 jointCapacity = 0;
+		for (int32 i = begin; i < end; ++i)
 		{
-			// If a body was not in an island then it did not move.
-			if ((b->m_flags & b2Body::e_islandFlag) == 0)
+			dynamicCapacity = b2Max(dynamicCapacity, m_islands[i].dynamicCount);
+			contactCapacity = b2Max(contactCapacity, m_islands[i].contactCount);
+			jointCapacity = b2Max(jointCapacity, m_islands[i].jointCount);
+		}
+
+		b2Island island(m_staticCount + dynamicCapacity, contactCapacity, jointCapacity, m_allocators[index], NULL);
+		island.m_sharedStatics = true;
+
+		for (int32 i = begin; i < end; ++i)
+		{
+			b2IslandRange* range = m_islands + i;
+
+			island.Clear();
+			island.m_impulses = m_impulses + range->contactStart;
+
+			for (int32 j = 0; j < range->bodyCount; ++j)
 			{
-				continue;
+				island.AddIndexed(m_bodies[range->bodyStart + j]);
 			}
 
+			for (int32 j = 0; j < range->contactCount; ++j)
+			{
+				island.Add(m_contacts[range->contactStart + j]);
+			}
+
+			for (int32 j = 0; j < range->jointCount; ++j)
+			{
+				island.Add(m_joints[range->jointStart + j]);
+			}
+
+			island.Solve(&range->profile, *m_step, m_gravity, m_allowSleep);
+			range->sleeping = island.m_sleeping;
+		}
+	}
+};
+
+// Islands are gathered the same way as in Solve, then solved in batches on
+// the task executor. Static bodies can be in several islands, so islands
+// don't write to them. Their updates and the PostSolve reports are applied
+// afterwards in island order, which gives the same result as Solve.
+void b2World::SolveParallel(const b2TimeStep& step)
+{
+	int32 contactCount = m_contactManager.m_contactCount;
+
+	// A static body is added once to each island touching it, through
+	// one of its contacts or joints.
+	int32 bodyCapacity = m_bodyCount + contactCount + m_jointCount;
+
+	b2Body** bodies = (b2Body**)m_stackAllocator.Allocate(bodyCapacity * sizeof(b2Body*));
+	b2Contact** contacts = (b2Contact**)m_stackAllocator.Allocate(contactCount * sizeof(b2Contact*));
+	b2Joint** joints = (b2Joint**)m_stackAllocator.Allocate(m_jointCount * sizeof(b2Joint*));
+	b2ContactImpulse* impulses = (b2ContactImpulse*)m_stackAllocator.Allocate(contactCount * sizeof(b2ContactImpulse));
+	b2IslandRange* islands = (b2IslandRange*)m_stackAllocator.Allocate(m_bodyCount * sizeof(b2IslandRange));
+	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(m_bodyCount * sizeof(b2Body*));
+
+	int32 bodyTotal = 0;
+	int32 contactTotal = 0;
+	int32 jointTotal = 0;
+	int32 islandCount = 0;
+	int32 staticCount = 0;
+
+	// Clear all the island flags.
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		b->m_flags &= ~b2Body::e_islandFlag;
+		if (b->GetType() == b2_staticBody)
+		{
+			b->m_islandIndex = -1;
+		}
+	}
+	for (b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
+	{
+		c->m_flags &= ~b2Contact::e_islandFlag;
+	}
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		j->m_islandFlag = false;
+	}
+
+	// Gather all awake islands.
+	for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
+	{
+		if (seed->m_flags & b2Body::e_islandFlag)
+		{
+			continue;
+		}
+
+		if (seed->IsAwake() == false || seed->IsActive() == false)
+		{
+			continue;
+		}
+
+		// The seed can be dynamic or kinematic.
+		if (seed->GetType() == b2_staticBody)
+		{
+			continue;
+		}
+
+		b2IslandRange* range = islands + islandCount++;
+		range->bodyStart = bodyTotal;
+		range->dynamicCount = 0;
+		range->contactStart = contactTotal;
+		range->jointStart = jointTotal;
+		range->sleeping = false;
+
+		int32 stackCount = 0;
+		stack[stackCount++] = seed;
+		seed->m_flags |= b2Body::e_islandFlag;
+
+		// Perform a depth first search (DFS) on the constraint graph.
+		while (stackCount > 0)
+		{
+			// Grab the next body off the stack and add it to the island.
+			b2Body* b = stack[--stackCount];
+			b2Assert(b->IsActive() == true);
+			b2Assert(bodyTotal < bodyCapacity);
+			bodies[bodyTotal++] = b;
+
+			// Make sure the body is awake.
+			b->SetAwake(true);
+
+			// To keep islands as small as possible, we don't
+			// propagate islands across static bodies.
 			if (b->GetType() == b2_staticBody)
 			{
+				if (b->m_islandIndex < 0)
+				{
+					b->m_islandIndex = staticCount++;
+				}
 				continue;
 			}
 
-			// Update fixtures (for broad-phase).
-			b->SynchronizeFixtures();
+			++range->dynamicCount;
+
+			// Search all contacts connected to this body.
+			for (b2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
+			{
+				b2Contact* contact = ce->contact;
+
+				// Has this contact already been added to an island?
+				if (contact->m_flags & b2Contact::e_islandFlag)
+				{
+					continue;
+				}
+
+				// Is this contact solid and touching?
+				if (contact->IsEnabled() == false ||
+					contact->IsTouching() == false)
+				{
+					continue;
+				}
+
+				// Skip sensors.
+				bool sensorA = contact->m_fixtureA->m_isSensor;
+				bool sensorB = contact->m_fixtureB->m_isSensor;
+				if (sensorA || sensorB)
+				{
+					continue;
+				}
+
+				contacts[contactTotal++] = contact;
+				contact->m_flags |= b2Contact::e_islandFlag;
+
+				b2Body* other = ce->other;
+
+				// Was the other body already added to this island?
+				if (other->m_flags & b2Body::e_islandFlag)
+				{
+					continue;
+				}
+
+				b2Assert(stackCount < m_bodyCount);
+				stack[stackCount++] = other;
+				other->m_flags |= b2Body::e_islandFlag;
+			}
+
+			// Search all joints connect to this body.
+			for (b2JointEdge* je = b->m_jointList; je; je = je->next)
+			{
+				if (je->joint->m_islandFlag == true)
+				{
+					continue;
+				}
+
+				b2Body* other = je->other;
+
+				// Don't simulate joints connected to inactive bodies.
+				if (other->IsActive() == false)
+				{
+					continue;
+				}
+
+				joints[jointTotal++] = je->joint;
+				je->joint->m_islandFlag = true;
+
+				if (other->m_flags & b2Body::e_islandFlag)
+				{
+					continue;
+				}
+
+				b2Assert(stackCount < m_bodyCount);
+				stack[stackCount++] = other;
+				other->m_flags |= b2Body::e_islandFlag;
+			}
 		}
 
-		// Look for new contacts.
-		m_contactManager.FindNewContacts();
-		m_profile.broadphase = timer.GetMilliseconds();
+		range->bodyCount = bodyTotal - range->bodyStart;
+		range->contactCount = contactTotal - range->contactStart;
+		range->jointCount = jointTotal - range->jointStart;
+
+		// Allow static bodies to participate in other islands.
+		for (int32 i = range->bodyStart; i < bodyTotal; ++i)
+		{
+			if (bodies[i]->GetType() == b2_staticBody)
+			{
+				bodies[i]->m_flags &= ~b2Body::e_islandFlag;
+			}
+		}
+	}
+
+	// Static bodies keep the index they were given for the whole step, and
+	// the other bodies of each island are indexed after all of them.
+	for (int32 i = 0; i < islandCount; ++i)
+	{
+		int32 index = staticCount;
+		for (int32 j = 0; j < islands[i].bodyCount; ++j)
+		{
+			b2Body* b = bodies[islands[i].bodyStart + j];
+			if (b->GetType() != b2_staticBody)
+			{
+				b->m_islandIndex = index++;
+			}
+		}
 	}
+
+	// Split the islands into batches of about the same amount of work.
+	int32 batchCount = b2Min(4 * m_taskExecutor->GetThreadCount(), islandCount);
+	int32* batchStarts = (int32*)m_stackAllocator.Allocate((batchCount + 1) * sizeof(int32));
+
+	int32 workTotal = bodyTotal + contactTotal + jointTotal;
+	int32 work = 0;
+	int32 batch = 0;
+	batchStarts[0] = 0;
+	for (int32 i = 0; i < islandCount && batch + 1 < batchCount; ++i)
+	{
+		work += islands[i].bodyCount + islands[i].contactCount + islands[i].jointCount;
+		if (float32(work) >= float32(workTotal) * (batch + 1) / batchCount)
+		{
+			batchStarts[++batch] = i + 1;
+		}
+	}
+	batchCount = batch + 1;
+	batchStarts[batchCount] = islandCount;
+
+	if (m_taskAllocatorCount < batchCount)
+	{
+		b2StackAllocator** allocators = (b2StackAllocator**)b2Alloc(batchCount * sizeof(b2StackAllocator*));
+		for (int32 i = 0; i < batchCount; ++i)
+		{
+			if (i < m_taskAllocatorCount)
+			{
+				allocators[i] = m_taskAllocators[i];
+			}
+			else
+			{
+				void* mem = b2Alloc(sizeof(b2StackAllocator));
+				allocators[i] = new (mem) b2StackAllocator;
+			}
+		}
+
+		b2Free(m_taskAllocators);
+		m_taskAllocators = allocators;
+		m_taskAllocatorCount = batchCount;
+	}
+
+	b2IslandSolveTask task;
+	task.m_step = &step;
+	task.m_gravity = m_gravity;
+	task.m_allowSleep = m_allowSleep;
+	task.m_staticCount = staticCount;
+	task.m_bodies = bodies;
+	task.m_contacts = contacts;
+	task.m_joints = joints;
+	task.m_impulses = impulses;
+	task.m_islands = islands;
+	task.m_batchStarts = batchStarts;
+	task.m_allocators = m_taskAllocators;
+
+	if (batchCount > 1)
+	{
+		m_taskExecutor->ParallelFor(batchCount, &task);
+	}
+	else if (islandCount > 0)
+	{
+		task.Execute(0);
+	}
+
+	// Apply the deferred work in island order.
+	b2ContactListener* listener = m_contactManager.m_contactListener;
+	for (int32 i = 0; i < islandCount; ++i)
+	{
+		const b2IslandRange* range = islands + i;
+
+		m_profile.solveInit += range->profile.solveInit;
+		m_profile.solveVelocity += range->profile.solveVelocity;
+		m_profile.solvePosition += range->profile.solvePosition;
+
+		for (int32 j = 0; j < range->bodyCount; ++j)
+		{
+			b2Body* b = bodies[range->bodyStart + j];
+			if (b->GetType() != b2_staticBody)
+			{
+				continue;
+			}
+
+			// Repeat what searching and solving this island alone would
+			// have done to the static body.
+			b->SetAwake(true);
+			b->m_sweep.c0 = b->m_sweep.c;
+			b->m_sweep.a0 = b->m_sweep.a;
+			b->SynchronizeTransform();
+
+			if (range->sleeping)
+			{
+				b->SetAwake(false);
+			}
+		}
+
+		if (listener != NULL)
+		{
+			for (int32 j = 0; j < range->contactCount; ++j)
+			{
+				int32 index = range->contactStart + j;
+				listener->PostSolve(contacts[index], impulses + index);
+			}
+		}
+	}
+
+	m_stackAllocator.Free(batchStarts);
+	m_stackAllocator.Free(stack);
+	m_stackAllocator.Free(islands);
+	m_stackAllocator.Free(impulses);
+	m_stackAllocator.Free(joints);
+	m_stackAllocator.Free(contacts);
+	m_stackAllocator.Free(bodies);
+
+	FinishSolve();
+}
+
+void b2World::FinishSolve()
+{
+	b2Timer timer;
+	// Synchronize fixtures, check for out of range bodies.
+	for (b2Body* b = m_bodyList; b; b = b->GetNext())
+	{
+		// If a body was not in an island then it did not move.
+		if ((b->m_flags & b2Body::e_islandFlag) == 0)
+		{
+			continue;
+		}
+
+		if (b->GetType() == b2_staticBody)
+		{
+			continue;
+		}
+
+		// Update fixtures (for broad-phase).
+		b->SynchronizeFixtures();
+	}
+
+	// Look for new contacts.
+	m_contactManager.FindNewContacts();
+	m_profile.broadphase = timer.GetMilliseconds();
 }
 
 // Find TOI contacts and solve them.
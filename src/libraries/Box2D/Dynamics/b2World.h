@@ -61,6 +61,14 @@ public:
 	/// remain in scope.
 	void SetContactListener(b2ContactListener* listener);
 
+	/// Register a task executor to run narrow-phase collision and island
+	/// solving on several threads. The executor is owned by you and must
+	/// remain in scope. The simulation is identical to a single-threaded
+	/// step, but PostSolve is called for all islands after they have all
+	/// been solved. Pass NULL to step on the calling thread only.
+	void SetTaskExecutor(b2TaskExecutor* executor);
+	b2TaskExecutor* GetTaskExecutor() const { return m_taskExecutor; }
+
 	/// Register a routine for debug drawing. The debug draw functions are called
 	/// inside with b2World::DrawDebugData method. The debug draw object is owned
 	/// by you and must remain in scope.
@@ -223,8 +231,11 @@ private:
 	friend class b2Fixture;
 	friend class b2ContactManager;
 	friend class b2Controller;
+	friend class b2WorldState;
 
 	void Solve(const b2TimeStep& step);
+	void SolveParallel(const b2TimeStep& step);
+	void FinishSolve();
 	void SolveTOI(const b2TimeStep& step);
 
 	void DrawJoint(b2Joint* joint);
@@ -249,6 +260,12 @@ private:
 	b2DestructionListener* m_destructionListener;
 	b2Draw* g_debugDraw;
 
+	b2TaskExecutor* m_taskExecutor;
+
+	// One stack allocator per batch of islands solved in parallel.
+	b2StackAllocator** m_taskAllocators;
+	int32 m_taskAllocatorCount;
+
 	// This is used to compute the time step ratio to
 	// support a variable time step.
 	float32 m_inv_dt0;
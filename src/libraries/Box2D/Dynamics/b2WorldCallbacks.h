@@ -152,4 +152,32 @@ public:
 									const b2Vec2& normal, float32 fraction) = 0;
 };
 
+/// A unit of work split into independent items, run by a b2TaskExecutor.
+class b2Task
+{
+public:
+	virtual ~b2Task() {}
+
+	/// Called once for each item. Items may run concurrently and in any
+	/// order, so they must not touch each other's data.
+	virtual void Execute(int32 index) = 0;
+};
+
+/// Implement this class to let b2World::Step run independent parts of the
+/// step (narrow-phase collision and island solving) on several threads.
+/// The results are identical to a single-threaded step.
+class b2TaskExecutor
+{
+public:
+	virtual ~b2TaskExecutor() {}
+
+	/// The number of threads that can run items at once, including the
+	/// calling thread. This is used to decide how finely to split work.
+	virtual int32 GetThreadCount() const = 0;
+
+	/// Call task->Execute(i) for every i in [0, count), possibly in
+	/// parallel, and return once all of them have finished.
+	virtual void ParallelFor(int32 count, b2Task* task) = 0;
+};
+
 #endif
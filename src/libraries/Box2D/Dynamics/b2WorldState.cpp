@@ -0,0 +1,497 @@
+/*
+* Copyright (c) 2006-2018 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Box2D/Dynamics/b2WorldState.h>
+#include <Box2D/Dynamics/b2World.h>
+#include <Box2D/Dynamics/b2Body.h>
+#include <Box2D/Dynamics/b2Fixture.h>
+#include <Box2D/Dynamics/Contacts/b2Contact.h>
+#include <Box2D/Dynamics/Joints/b2Joint.h>
+#include <string.h>
+
+namespace
+{
+
+const uint32 b2_worldStateMagic = 0x53573262; // "b2WS"
+
+struct b2WorldStateHeader
+{
+	uint32 magic;
+	int32 size;
+	uint32 topology[2];
+
+	int32 bodyCount;
+	int32 proxyCount;
+	int32 jointCount;
+	int32 contactCount;
+
+	int32 worldFlags;
+	float32 inv_dt0;
+
+	int32 treeRoot;
+	int32 treeNodeCount;
+	int32 treeNodeCapacity;
+	int32 treeFreeList;
+	uint32 treePath;
+	int32 treeInsertionCount;
+
+	int32 broadPhaseProxyCount;
+	int32 moveCount;
+};
+
+struct b2BodyStateRecord
+{
+	b2Transform xf;
+	b2Sweep sweep;
+	b2Vec2 linearVelocity;
+	float32 angularVelocity;
+	b2Vec2 force;
+	float32 torque;
+	float32 sleepTime;
+	uint16 flags;
+};
+
+struct b2ContactStateRecord
+{
+	int32 proxyIdA;
+	int32 proxyIdB;
+	uint32 flags;
+	b2Manifold manifold;
+	int32 toiCount;
+	float32 toi;
+	float32 friction;
+	float32 restitution;
+	float32 tangentSpeed;
+};
+
+struct b2JointStateRecord
+{
+	float32 state[b2_maxJointSolverState];
+};
+
+// FNV-1a over the identity of every body, fixture and joint, in list order.
+struct b2TopologyHash
+{
+	b2TopologyHash() : hash(0xcbf29ce484222325ULL) {}
+
+	template <typename T>
+	void Add(const T& value)
+	{
+		const unsigned char* bytes = (const unsigned char*)&value;
+		for (size_t i = 0; i < sizeof(T); ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 0x100000001b3ULL;
+		}
+	}
+
+	unsigned long long hash;
+};
+
+// Writes records into a buffer which may not be aligned.
+struct b2StateWriter
+{
+	explicit b2StateWriter(void* buffer) : p((char*)buffer) {}
+
+	template <typename T>
+	void Write(const T& value)
+	{
+		memcpy(p, &value, sizeof(T));
+		p += sizeof(T);
+	}
+
+	void Write(const void* data, int32 size)
+	{
+		memcpy(p, data, size);
+		p += size;
+	}
+
+	char* p;
+};
+
+struct b2StateReader
+{
+	explicit b2StateReader(const void* buffer) : p((const char*)buffer) {}
+
+	template <typename T>
+	void Read(T& value)
+	{
+		memcpy(&value, p, sizeof(T));
+		p += sizeof(T);
+	}
+
+	void Read(void* data, int32 size)
+	{
+		memcpy(data, p, size);
+		p += size;
+	}
+
+	const char* p;
+};
+
+} // anonymous namespace
+
+void b2WorldState::ComputeTopology(const b2World* world, uint32 topology[2], int32* proxyCount)
+{
+	b2TopologyHash hash;
+	*proxyCount = 0;
+
+	hash.Add(world->m_bodyCount);
+	for (const b2Body* b = world->m_bodyList; b; b = b->m_next)
+	{
+		hash.Add(b);
+		hash.Add(b->m_type);
+		hash.Add(uint16(b->m_flags & b2Body::e_activeFlag));
+		hash.Add(b->m_fixtureCount);
+
+		for (const b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			hash.Add(f);
+			hash.Add(f->m_proxyCount);
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				hash.Add(f->m_proxies[i].proxyId);
+			}
+
+			*proxyCount += f->m_proxyCount;
+		}
+	}
+
+	hash.Add(world->m_jointCount);
+	for (const b2Joint* j = world->m_jointList; j; j = j->m_next)
+	{
+		hash.Add(j);
+		hash.Add(j->m_type);
+		hash.Add(j->m_bodyA);
+		hash.Add(j->m_bodyB);
+	}
+
+	topology[0] = uint32(hash.hash);
+	topology[1] = uint32(hash.hash >> 32);
+}
+
+int32 b2WorldState::GetSize(const b2World* world)
+{
+	const b2ContactManager& contactManager = world->m_contactManager;
+	const b2BroadPhase& broadPhase = contactManager.m_broadPhase;
+
+	int32 proxyCount = 0;
+	for (const b2Body* b = world->m_bodyList; b; b = b->m_next)
+	{
+		for (const b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			proxyCount += f->m_proxyCount;
+		}
+	}
+
+	int32 size = sizeof(b2WorldStateHeader);
+	size += world->m_bodyCount * sizeof(b2BodyStateRecord);
+	size += proxyCount * sizeof(b2AABB);
+	size += broadPhase.m_tree.m_nodeCapacity * sizeof(b2TreeNode);
+	size += broadPhase.m_moveCount * sizeof(int32);
+	size += world->m_jointCount * sizeof(b2JointStateRecord);
+	size += contactManager.m_contactCount * sizeof(b2ContactStateRecord);
+	return size;
+}
+
+void b2WorldState::Save(const b2World* world, void* buffer)
+{
+	b2Assert(world->IsLocked() == false);
+
+	const b2ContactManager& contactManager = world->m_contactManager;
+	const b2BroadPhase& broadPhase = contactManager.m_broadPhase;
+	const b2DynamicTree& tree = broadPhase.m_tree;
+
+	b2WorldStateHeader header;
+	header.magic = b2_worldStateMagic;
+	header.size = GetSize(world);
+	ComputeTopology(world, header.topology, &header.proxyCount);
+	header.bodyCount = world->m_bodyCount;
+	header.jointCount = world->m_jointCount;
+	header.contactCount = contactManager.m_contactCount;
+	header.worldFlags = world->m_flags & ~b2World::e_locked;
+	header.inv_dt0 = world->m_inv_dt0;
+	header.treeRoot = tree.m_root;
+	header.treeNodeCount = tree.m_nodeCount;
+	header.treeNodeCapacity = tree.m_nodeCapacity;
+	header.treeFreeList = tree.m_freeList;
+	header.treePath = tree.m_path;
+	header.treeInsertionCount = tree.m_insertionCount;
+	header.broadPhaseProxyCount = broadPhase.m_proxyCount;
+	header.moveCount = broadPhase.m_moveCount;
+
+	b2StateWriter writer(buffer);
+	writer.Write(header);
+
+	for (const b2Body* b = world->m_bodyList; b; b = b->m_next)
+	{
+		b2BodyStateRecord record;
+		record.xf = b->m_xf;
+		record.sweep = b->m_sweep;
+		record.linearVelocity = b->m_linearVelocity;
+		record.angularVelocity = b->m_angularVelocity;
+		record.force = b->m_force;
+		record.torque = b->m_torque;
+		record.sleepTime = b->m_sleepTime;
+		record.flags = b->m_flags & ~b2Body::e_islandFlag;
+		writer.Write(record);
+	}
+
+	for (const b2Body* b = world->m_bodyList; b; b = b->m_next)
+	{
+		for (const b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				writer.Write(f->m_proxies[i].aabb);
+			}
+		}
+	}
+
+	writer.Write(tree.m_nodes, tree.m_nodeCapacity * sizeof(b2TreeNode));
+	writer.Write(broadPhase.m_moveBuffer, broadPhase.m_moveCount * sizeof(int32));
+
+	for (const b2Joint* j = world->m_jointList; j; j = j->m_next)
+	{
+		b2JointStateRecord record;
+		memset(&record, 0, sizeof(record));
+		j->GetSolverState(record.state);
+		writer.Write(record);
+	}
+
+	for (const b2Contact* c = contactManager.m_contactList; c; c = c->m_next)
+	{
+		b2ContactStateRecord record;
+		record.proxyIdA = c->m_fixtureA->m_proxies[c->m_indexA].proxyId;
+		record.proxyIdB = c->m_fixtureB->m_proxies[c->m_indexB].proxyId;
+		record.flags = c->m_flags & ~b2Contact::e_islandFlag;
+		record.manifold = c->m_manifold;
+		record.toiCount = c->m_toiCount;
+		record.toi = c->m_toi;
+		record.friction = c->m_friction;
+		record.restitution = c->m_restitution;
+		record.tangentSpeed = c->m_tangentSpeed;
+		writer.Write(record);
+	}
+}
+
+bool b2WorldState::Restore(b2World* world, const void* buffer, int32 size)
+{
+	b2Assert(world->IsLocked() == false);
+
+	if (size < int32(sizeof(b2WorldStateHeader)))
+	{
+		return false;
+	}
+
+	b2StateReader reader(buffer);
+
+	b2WorldStateHeader header;
+	reader.Read(header);
+
+	if (header.magic != b2_worldStateMagic || header.size > size)
+	{
+		return false;
+	}
+
+	uint32 topology[2];
+	int32 proxyCount;
+	ComputeTopology(world, topology, &proxyCount);
+
+	if (topology[0] != header.topology[0] || topology[1] != header.topology[1] ||
+		world->m_bodyCount != header.bodyCount || world->m_jointCount != header.jointCount ||
+		proxyCount != header.proxyCount)
+	{
+		return false;
+	}
+
+	int32 expectedSize = sizeof(b2WorldStateHeader);
+	expectedSize += header.bodyCount * sizeof(b2BodyStateRecord);
+	expectedSize += header.proxyCount * sizeof(b2AABB);
+	expectedSize += header.treeNodeCapacity * sizeof(b2TreeNode);
+	expectedSize += header.moveCount * sizeof(int32);
+	expectedSize += header.jointCount * sizeof(b2JointStateRecord);
+	expectedSize += header.contactCount * sizeof(b2ContactStateRecord);
+
+	if (header.size != expectedSize || header.treeNodeCapacity <= 0 ||
+		header.moveCount < 0 || header.contactCount < 0)
+	{
+		return false;
+	}
+
+	// The contacts have to refer to leaves of the saved tree.
+	const char* nodes = reader.p + header.bodyCount * sizeof(b2BodyStateRecord) + header.proxyCount * sizeof(b2AABB);
+	const char* contactRecords = (const char*)buffer + header.size - header.contactCount * sizeof(b2ContactStateRecord);
+	for (int32 i = 0; i < header.contactCount; ++i)
+	{
+		b2ContactStateRecord record;
+		memcpy(&record, contactRecords + i * sizeof(b2ContactStateRecord), sizeof(record));
+
+		int32 proxyIds[2] = {record.proxyIdA, record.proxyIdB};
+		for (int32 j = 0; j < 2; ++j)
+		{
+			if (proxyIds[j] < 0 || proxyIds[j] >= header.treeNodeCapacity)
+			{
+				return false;
+			}
+
+			b2TreeNode node;
+			memcpy(&node, nodes + proxyIds[j] * sizeof(b2TreeNode), sizeof(node));
+			if (node.userData == NULL || node.IsLeaf() == false || node.height != 0)
+			{
+				return false;
+			}
+		}
+	}
+
+	b2ContactManager& contactManager = world->m_contactManager;
+	b2BroadPhase& broadPhase = contactManager.m_broadPhase;
+	b2DynamicTree& tree = broadPhase.m_tree;
+
+	// Remove every contact without reporting that it ended. The contacts are
+	// recreated in their saved order below, since that order affects the
+	// solver.
+	b2Contact* c = contactManager.m_contactList;
+	while (c)
+	{
+		b2Contact* next = c->m_next;
+		c->m_flags &= ~b2Contact::e_touchingFlag;
+		contactManager.Destroy(c);
+		c = next;
+	}
+
+	for (b2Body* b = world->m_bodyList; b; b = b->m_next)
+	{
+		b2BodyStateRecord record;
+		reader.Read(record);
+		b->m_xf = record.xf;
+		b->m_sweep = record.sweep;
+		b->m_linearVelocity = record.linearVelocity;
+		b->m_angularVelocity = record.angularVelocity;
+		b->m_force = record.force;
+		b->m_torque = record.torque;
+		b->m_sleepTime = record.sleepTime;
+		b->m_flags = record.flags;
+	}
+
+	for (b2Body* b = world->m_bodyList; b; b = b->m_next)
+	{
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				reader.Read(f->m_proxies[i].aabb);
+			}
+		}
+	}
+
+	// The proxies keep their ids, so the tree's nodes can be copied back.
+	if (tree.m_nodeCapacity < header.treeNodeCapacity)
+	{
+		b2TreeNode* nodes = (b2TreeNode*)b2Alloc(header.treeNodeCapacity * sizeof(b2TreeNode));
+		b2Free(tree.m_nodes);
+		tree.m_nodes = nodes;
+	}
+
+	tree.m_nodeCapacity = header.treeNodeCapacity;
+	reader.Read(tree.m_nodes, header.treeNodeCapacity * sizeof(b2TreeNode));
+	tree.m_root = header.treeRoot;
+	tree.m_nodeCount = header.treeNodeCount;
+	tree.m_freeList = header.treeFreeList;
+	tree.m_path = header.treePath;
+	tree.m_insertionCount = header.treeInsertionCount;
+
+	if (broadPhase.m_moveCapacity < header.moveCount)
+	{
+		int32* moveBuffer = (int32*)b2Alloc(header.moveCount * sizeof(int32));
+		b2Free(broadPhase.m_moveBuffer);
+		broadPhase.m_moveBuffer = moveBuffer;
+		broadPhase.m_moveCapacity = header.moveCount;
+	}
+
+	reader.Read(broadPhase.m_moveBuffer, header.moveCount * sizeof(int32));
+	broadPhase.m_moveCount = header.moveCount;
+	broadPhase.m_proxyCount = header.broadPhaseProxyCount;
+
+	for (b2Joint* j = world->m_jointList; j; j = j->m_next)
+	{
+		b2JointStateRecord record;
+		reader.Read(record);
+		j->SetSolverState(record.state);
+	}
+
+	// Contacts are pushed onto the front of the lists, so they're created
+	// from last to first.
+	for (int32 i = header.contactCount - 1; i >= 0; --i)
+	{
+		b2ContactStateRecord record;
+		memcpy(&record, contactRecords + i * sizeof(b2ContactStateRecord), sizeof(record));
+
+		b2FixtureProxy* proxyA = (b2FixtureProxy*)tree.GetUserData(record.proxyIdA);
+		b2FixtureProxy* proxyB = (b2FixtureProxy*)tree.GetUserData(record.proxyIdB);
+
+		c = b2Contact::Create(proxyA->fixture, proxyA->childIndex, proxyB->fixture, proxyB->childIndex, contactManager.m_allocator);
+		b2Assert(c != NULL);
+
+		b2Body* bodyA = c->m_fixtureA->m_body;
+		b2Body* bodyB = c->m_fixtureB->m_body;
+
+		c->m_prev = NULL;
+		c->m_next = contactManager.m_contactList;
+		if (contactManager.m_contactList != NULL)
+		{
+			contactManager.m_contactList->m_prev = c;
+		}
+		contactManager.m_contactList = c;
+
+		c->m_nodeA.contact = c;
+		c->m_nodeA.other = bodyB;
+		c->m_nodeA.prev = NULL;
+		c->m_nodeA.next = bodyA->m_contactList;
+		if (bodyA->m_contactList != NULL)
+		{
+			bodyA->m_contactList->prev = &c->m_nodeA;
+		}
+		bodyA->m_contactList = &c->m_nodeA;
+
+		c->m_nodeB.contact = c;
+		c->m_nodeB.other = bodyA;
+		c->m_nodeB.prev = NULL;
+		c->m_nodeB.next = bodyB->m_contactList;
+		if (bodyB->m_contactList != NULL)
+		{
+			bodyB->m_contactList->prev = &c->m_nodeB;
+		}
+		bodyB->m_contactList = &c->m_nodeB;
+
+		c->m_flags = record.flags;
+		c->m_manifold = record.manifold;
+		c->m_toiCount = record.toiCount;
+		c->m_toi = record.toi;
+		c->m_friction = record.friction;
+		c->m_restitution = record.restitution;
+		c->m_tangentSpeed = record.tangentSpeed;
+
+		++contactManager.m_contactCount;
+	}
+
+	world->m_flags = (world->m_flags & b2World::e_locked) | (header.worldFlags & ~b2World::e_locked);
+	world->m_inv_dt0 = header.inv_dt0;
+
+	return true;
+}
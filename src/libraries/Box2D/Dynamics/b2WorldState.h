@@ -0,0 +1,58 @@
+/*
+* Copyright (c) 2006-2018 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef B2_WORLD_STATE_H
+#define B2_WORLD_STATE_H
+
+#include <Box2D/Common/b2Settings.h>
+
+class b2World;
+
+/// Saves and restores the simulation state of a world, for rollback. This
+/// covers body motion and sleep, contacts with their warm starting impulses,
+/// joint impulses and the broad-phase, so stepping after a restore gives the
+/// same results as stepping after the save.
+/// The state holds pointers, so it can only be restored into the same world
+/// in the same process, and only while it has the same bodies, fixtures and
+/// joints, with the same active flags. Settings like gravity, friction or
+/// joint motors are not part of the state.
+class b2WorldState
+{
+public:
+
+	/// Get the number of bytes Save needs for the world's current state.
+	static int32 GetSize(const b2World* world);
+
+	/// Save the world's state into buffer, which needs GetSize bytes.
+	/// @warning this should be called outside of a time step.
+	static void Save(const b2World* world, void* buffer);
+
+	/// Restore a state written by Save. No contact listener callbacks are
+	/// called. Returns false, without changing the world, if the state is
+	/// invalid or was saved with different bodies, fixtures or joints.
+	/// @warning this should be called outside of a time step.
+	static bool Restore(b2World* world, const void* buffer, int32 size);
+
+private:
+
+	// Hashes the identity of every body, fixture and joint, and counts the
+	// broad-phase proxies of the fixtures.
+	static void ComputeTopology(const b2World* world, uint32 topology[2], int32* proxyCount);
+};
+
+#endif
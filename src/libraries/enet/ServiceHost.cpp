@@ -0,0 +1,263 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "ServiceHost.h"
+
+// LOVE
+#include "data/ByteData.h"
+
+// C++
+#include <cstring>
+#include <new>
+
+namespace love
+{
+namespace enet
+{
+
+ServiceHost::ServiceHost(ENetHost *host, love::thread::Channel *events, int intervalMS)
+	: host(host)
+	, events(events)
+	, intervalMS(intervalMS)
+	, stopping(false)
+{
+	threadName = "enet";
+}
+
+ServiceHost::~ServiceHost()
+{
+	stop();
+	enet_host_destroy(host);
+}
+
+void ServiceHost::send(int peer, enet_uint8 channel, ENetPacket *packet)
+{
+	Command command = {};
+	command.type = COMMAND_SEND;
+	command.peer = peer;
+	command.channel = channel;
+	command.packet = packet;
+	pushCommand(command);
+}
+
+void ServiceHost::connect(const ENetAddress &address, size_t channelCount, enet_uint32 data)
+{
+	Command command = {};
+	command.type = COMMAND_CONNECT;
+	command.address = address;
+	command.channel = (enet_uint8) channelCount;
+	command.data = data;
+	pushCommand(command);
+}
+
+void ServiceHost::disconnect(int peer, enet_uint32 data, DisconnectMode mode)
+{
+	Command command = {};
+	command.type = COMMAND_DISCONNECT;
+	command.peer = peer;
+	command.data = data;
+	command.mode = mode;
+	pushCommand(command);
+}
+
+void ServiceHost::stop()
+{
+	stopping = true;
+	wait();
+
+	love::thread::Lock lock(mutex);
+
+	for (const Command &command : commands)
+	{
+		if (command.packet != nullptr)
+			enet_packet_destroy(command.packet);
+	}
+
+	commands.clear();
+}
+
+size_t ServiceHost::getPeerCount() const
+{
+	return host->peerCount;
+}
+
+ENetAddress ServiceHost::getSocketAddress() const
+{
+	ENetAddress address = {};
+	enet_socket_get_address(host->socket, &address);
+	return address;
+}
+
+ENetPacket *ServiceHost::createPacket(love::Data *data, enet_uint32 flags)
+{
+	ENetPacket *packet = enet_packet_create(data->getData(), data->getSize(), flags | ENET_PACKET_FLAG_NO_ALLOCATE);
+	if (packet == nullptr)
+		return nullptr;
+
+	// The service thread releases the Data once the packet has been sent.
+	data->shareWithThreads();
+	data->retain();
+
+	packet->userData = data;
+	packet->freeCallback = releasePacketData;
+
+	return packet;
+}
+
+void ServiceHost::releasePacketData(ENetPacket *packet)
+{
+	love::Data *data = (love::Data *) packet->userData;
+	if (data != nullptr)
+		data->release();
+	packet->userData = nullptr;
+}
+
+void *ServiceHost::allocate(size_t size)
+{
+	// Matches the delete[] in ByteData's destructor.
+	return new (std::nothrow) char[size];
+}
+
+void ServiceHost::deallocate(void *memory)
+{
+	delete[] (char *) memory;
+}
+
+void ServiceHost::pushCommand(const Command &command)
+{
+	love::thread::Lock lock(mutex);
+
+	if (stopping)
+	{
+		if (command.packet != nullptr)
+			enet_packet_destroy(command.packet);
+		return;
+	}
+
+	commands.push_back(command);
+}
+
+void ServiceHost::runCommand(const Command &command)
+{
+	ENetPeer *peer = nullptr;
+	if (command.peer > 0 && (size_t) command.peer <= host->peerCount)
+		peer = &host->peers[command.peer - 1];
+
+	switch (command.type)
+	{
+	case COMMAND_SEND:
+		if (command.peer == 0)
+			enet_host_broadcast(host, command.channel, command.packet);
+		else if (peer == nullptr || enet_peer_send(peer, command.channel, command.packet) < 0)
+			enet_packet_destroy(command.packet);
+		break;
+	case COMMAND_CONNECT:
+		// The peer's index is reported by its connect event.
+		enet_host_connect(host, &command.address, command.channel, command.data);
+		break;
+	case COMMAND_DISCONNECT:
+		if (peer == nullptr)
+			break;
+		if (command.mode == DISCONNECT_NOW)
+			enet_peer_disconnect_now(peer, command.data);
+		else if (command.mode == DISCONNECT_LATER)
+			enet_peer_disconnect_later(peer, command.data);
+		else
+			enet_peer_disconnect(peer, command.data);
+		break;
+	}
+}
+
+void ServiceHost::pushEvent(const ENetEvent &event)
+{
+	std::vector<Variant> values;
+	values.reserve(4);
+
+	const char *name = "none";
+	if (event.type == ENET_EVENT_TYPE_CONNECT)
+		name = "connect";
+	else if (event.type == ENET_EVENT_TYPE_DISCONNECT)
+		name = "disconnect";
+	else if (event.type == ENET_EVENT_TYPE_RECEIVE)
+		name = "receive";
+
+	values.emplace_back(name, strlen(name));
+	values.emplace_back(event.peer != nullptr ? (double) (event.peer - host->peers + 1) : 0.0);
+
+	if (event.type == ENET_EVENT_TYPE_RECEIVE)
+	{
+		// Take the packet's memory instead of copying it. It was allocated
+		// with allocate(), so ByteData can free it.
+		ENetPacket *packet = event.packet;
+		StrongRef<data::ByteData> bytes(new data::ByteData(packet->data, packet->dataLength, true), Acquire::NORETAIN);
+
+		packet->data = nullptr;
+		enet_packet_destroy(packet);
+
+		values.emplace_back(&data::ByteData::type, bytes.get());
+	}
+	else
+		values.emplace_back((double) event.data);
+
+	values.emplace_back((double) event.channelID);
+
+	events->pushMany(values);
+}
+
+void ServiceHost::threadFunction()
+{
+	while (!stopping)
+	{
+		{
+			love::thread::Lock lock(mutex);
+			std::swap(commands, runningCommands);
+		}
+
+		for (const Command &command : runningCommands)
+			runCommand(command);
+
+		runningCommands.clear();
+
+		// Sends everything queued above in one flush, then waits for incoming
+		// packets until the tick is over.
+		ENetEvent event;
+		int result = enet_host_service(host, &event, (enet_uint32) intervalMS);
+
+		while (result > 0)
+		{
+			pushEvent(event);
+			result = enet_host_check_events(host, &event);
+		}
+
+		if (result < 0)
+		{
+			std::vector<Variant> values;
+			values.emplace_back("error", strlen("error"));
+			values.emplace_back(0.0);
+			values.emplace_back(0.0);
+			values.emplace_back(0.0);
+			events->pushMany(values);
+			break;
+		}
+	}
+}
+
+} // enet
+} // love
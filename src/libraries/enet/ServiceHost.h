@@ -0,0 +1,141 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_LUAENET_SERVICE_HOST_H
+#define LOVE_LUAENET_SERVICE_HOST_H
+
+// LOVE
+#include "common/Object.h"
+#include "common/Data.h"
+#include "thread/threads.h"
+#include "thread/Channel.h"
+
+// ENet
+extern "C" {
+#include <enet/enet.h>
+}
+
+// C++
+#include <atomic>
+#include <vector>
+
+namespace love
+{
+namespace enet
+{
+
+/**
+ * An ENet host serviced on its own thread, so networking doesn't wait for the
+ * frame loop. Events are pushed to a Channel as four values at a time: the
+ * event type ("connect", "disconnect" or "receive"), the peer index (starting
+ * at 1), the data (a ByteData for received packets, otherwise the event's
+ * number) and the ENet channel. If servicing fails, an "error" event is
+ * pushed and the thread stops.
+ *
+ * Commands from other threads are queued and applied at the start of the next
+ * tick, so all the packets sent in a tick go out in a single flush.
+ **/
+class ServiceHost : public love::thread::Threadable
+{
+public:
+
+	enum DisconnectMode
+	{
+		DISCONNECT_NORMAL,
+		DISCONNECT_NOW,
+		DISCONNECT_LATER,
+	};
+
+	// Takes ownership of the host.
+	ServiceHost(ENetHost *host, love::thread::Channel *events, int intervalMS);
+	virtual ~ServiceHost();
+
+	// Peer indices start at 1, and 0 broadcasts to all connected peers. Takes
+	// ownership of the packet.
+	void send(int peer, enet_uint8 channel, ENetPacket *packet);
+
+	void connect(const ENetAddress &address, size_t channelCount, enet_uint32 data);
+	void disconnect(int peer, enet_uint32 data, DisconnectMode mode);
+
+	// Stops servicing the host. Queued commands are dropped.
+	void stop();
+
+	size_t getPeerCount() const;
+	ENetAddress getSocketAddress() const;
+
+	/**
+	 * Creates a packet which points at the Data's memory instead of copying
+	 * it. The Data is retained until ENet is done with the packet, and must
+	 * not be modified until then.
+	 **/
+	static ENetPacket *createPacket(love::Data *data, enet_uint32 flags);
+
+	/**
+	 * Allocator callbacks for enet_initialize_with_callbacks, which let the
+	 * data of received packets be handed to a ByteData without a copy.
+	 **/
+	static void *allocate(size_t size);
+	static void deallocate(void *memory);
+
+	// Implements Threadable.
+	void threadFunction() override;
+
+private:
+
+	enum CommandType
+	{
+		COMMAND_SEND,
+		COMMAND_CONNECT,
+		COMMAND_DISCONNECT,
+	};
+
+	struct Command
+	{
+		CommandType type;
+		int peer;
+		enet_uint8 channel;
+		ENetPacket *packet;
+		ENetAddress address;
+		enet_uint32 data;
+		DisconnectMode mode;
+	};
+
+	void pushCommand(const Command &command);
+	void runCommand(const Command &command);
+	void pushEvent(const ENetEvent &event);
+
+	static void releasePacketData(ENetPacket *packet);
+
+	ENetHost *host;
+	StrongRef<love::thread::Channel> events;
+	int intervalMS;
+
+	love::thread::MutexRef mutex;
+	std::vector<Command> commands;
+	std::vector<Command> runningCommands;
+
+	std::atomic<bool> stopping;
+
+}; // ServiceHost
+
+} // enet
+} // love
+
+#endif // LOVE_LUAENET_SERVICE_HOST_H
@@ -32,12 +32,23 @@ extern "C" {
 #include <enet/enet.h>
 }
 
+// LOVE
+#include "common/runtime.h"
+#include "common/Data.h"
+#include "thread/Channel.h"
+#include "ServiceHost.h"
+
+using love::enet::ServiceHost;
+
 #define check_host(l, idx)\
 	*(ENetHost**)luaL_checkudata(l, idx, "enet_host")
 
 #define check_peer(l, idx)\
 	*(ENetPeer**)luaL_checkudata(l, idx, "enet_peer")
 
+#define check_service_host(l, idx)\
+	*(ServiceHost**)luaL_checkudata(l, idx, "enet_service_host")
+
 /**
  * Parse address string, eg:
  *	*:5959
@@ -164,15 +175,22 @@ static void push_event(lua_State *l, ENetEvent *event) {
 }
 
 /**
- * Read a packet off the stack as a string
+ * Read a packet off the stack as a string or a Data
  * idx is position of string
+ * A Data isn't copied, so it must not be modified until the packet is sent.
  */
 static ENetPacket *read_packet(lua_State *l, int idx, enet_uint8 *channel_id) {
-	size_t size;
+	size_t size = 0;
 	int argc = lua_gettop(l);
-	const void *data = luaL_checklstring(l, idx, &size);
+	const void *data = NULL;
+	love::Data *data_object = NULL;
 	ENetPacket *packet;
 
+	if (love::luax_istype(l, idx, love::Data::type))
+		data_object = love::luax_totype<love::Data>(l, idx);
+	else
+		data = luaL_checklstring(l, idx, &size);
+
 	enet_uint32 flags = ENET_PACKET_FLAG_RELIABLE;
 	*channel_id = 0;
 
@@ -193,7 +211,11 @@ static ENetPacket *read_packet(lua_State *l, int idx, enet_uint8 *channel_id) {
 		*channel_id = (int) luaL_checknumber(l, idx+1);
 	}
 
-	packet = enet_packet_create(data, size, flags);
+	if (data_object != NULL)
+		packet = ServiceHost::createPacket(data_object, flags);
+	else
+		packet = enet_packet_create(data, size, flags);
+
 	if (packet == NULL) {
 		luaL_error(l, "Failed to create packet");
 	}
@@ -210,35 +232,42 @@ static ENetPacket *read_packet(lua_State *l, int idx, enet_uint8 *channel_id) {
  *	[in_bandwidth = 0]
  *	[out_bandwidth = 0]
  */
-static int host_create(lua_State *l) {
-	ENetHost *host;
+static ENetHost *create_host(lua_State *l, int idx) {
 	size_t peer_count = 64, channel_count = 1;
 	enet_uint32 in_bandwidth = 0, out_bandwidth = 0;
 
 	int have_address = 1;
 	ENetAddress address;
 
-	if (lua_gettop(l) == 0 || lua_isnil(l, 1)) {
+	if (lua_gettop(l) < idx || lua_isnil(l, idx)) {
 		have_address = 0;
 	} else {
-		parse_address(l, luaL_checkstring(l, 1), &address);
+		parse_address(l, luaL_checkstring(l, idx), &address);
 	}
 
-	switch (lua_gettop(l)) {
+	switch (lua_gettop(l) - idx + 1) {
+		default:
 		case 5:
-			if (!lua_isnil(l, 5)) out_bandwidth = (int) luaL_checknumber(l, 5);
+			if (!lua_isnil(l, idx+4)) out_bandwidth = (int) luaL_checknumber(l, idx+4);
 		case 4:
-			if (!lua_isnil(l, 4)) in_bandwidth = (int) luaL_checknumber(l, 4);
+			if (!lua_isnil(l, idx+3)) in_bandwidth = (int) luaL_checknumber(l, idx+3);
 		case 3:
-			if (!lua_isnil(l, 3)) channel_count = (int) luaL_checknumber(l, 3);
+			if (!lua_isnil(l, idx+2)) channel_count = (int) luaL_checknumber(l, idx+2);
 		case 2:
-			if (!lua_isnil(l, 2)) peer_count = (int) luaL_checknumber(l, 2);
+			if (!lua_isnil(l, idx+1)) peer_count = (int) luaL_checknumber(l, idx+1);
+		case 1:
+		case 0:
+			break;
 	}
 
 	// printf("host create, peers=%d, channels=%d, in=%d, out=%d\n",
 	//		peer_count, channel_count, in_bandwidth, out_bandwidth);
-	host = enet_host_create(have_address ? &address : NULL, peer_count,
+	return enet_host_create(have_address ? &address : NULL, peer_count,
 			channel_count, in_bandwidth, out_bandwidth);
+}
+
+static int host_create(lua_State *l) {
+	ENetHost *host = create_host(l, 1);
 
 	if (host == NULL) {
 		lua_pushnil (l);
@@ -722,8 +751,164 @@ static int peer_send(lua_State *l) {
 	return 1;
 }
 
+/**
+ * Create a host serviced on its own thread, which pushes its events to a
+ * love Channel (see ServiceHost.h)
+ * Args:
+ *	channel
+ *	address (nil for client)
+ *	[peer_count = 64]
+ *	[channel_count = 1]
+ *	[in_bandwidth = 0]
+ *	[out_bandwidth = 0]
+ *	[interval = 1], maximum time in ms between ticks
+ */
+static int service_host_create(lua_State *l) {
+	love::thread::Channel *channel = love::luax_checktype<love::thread::Channel>(l, 1);
+	int interval = (int) luaL_optnumber(l, 7, 1);
+	if (interval < 0) {
+		return luaL_argerror(l, 7, "Interval can't be negative");
+	}
+
+	ENetHost *host = create_host(l, 2);
+
+	if (host == NULL) {
+		lua_pushnil (l);
+		lua_pushstring(l, "enet: failed to create host (already listening?)");
+		return 2;
+	}
+
+	ServiceHost *service_host = new ServiceHost(host, channel, interval);
+	if (!service_host->start()) {
+		service_host->release();
+		return luaL_error(l, "enet: failed to start the service thread");
+	}
+
+	*(ServiceHost**)lua_newuserdata(l, sizeof(void*)) = service_host;
+	luaL_getmetatable(l, "enet_service_host");
+	lua_setmetatable(l, -2);
+
+	return 1;
+}
+
+static ServiceHost *check_running_service_host(lua_State *l, int idx) {
+	ServiceHost *host = check_service_host(l, idx);
+	if (!host) {
+		luaL_error(l, "Tried to index a destroyed host!");
+	}
+	return host;
+}
+
+static int check_peer_index(lua_State *l, ServiceHost *host, int idx) {
+	int peer_index = (int) luaL_checknumber(l, idx);
+	if (peer_index < 1 || (size_t) peer_index > host->getPeerCount()) {
+		luaL_argerror(l, idx, "Invalid peer index");
+	}
+	return peer_index;
+}
+
+/**
+ * Queue a string or Data to be sent to a peer on the next tick
+ * Args:
+ *	peer index
+ *	packet data
+ *	channel id
+ *	flags ["reliable", nil]
+ */
+static int service_host_send(lua_State *l) {
+	ServiceHost *host = check_running_service_host(l, 1);
+	int peer_index = check_peer_index(l, host, 2);
+
+	enet_uint8 channel_id;
+	ENetPacket *packet = read_packet(l, 3, &channel_id);
+
+	host->send(peer_index, channel_id, packet);
+	return 0;
+}
+
+static int service_host_broadcast(lua_State *l) {
+	ServiceHost *host = check_running_service_host(l, 1);
+
+	enet_uint8 channel_id;
+	ENetPacket *packet = read_packet(l, 2, &channel_id);
+
+	host->send(0, channel_id, packet);
+	return 0;
+}
+
+/**
+ * Queue a connection to a remote host. The peer's index comes with its
+ * "connect" event.
+ * Args:
+ *	address
+ *	[channel_count = 1]
+ *	[data = 0]
+ */
+static int service_host_connect(lua_State *l) {
+	ServiceHost *host = check_running_service_host(l, 1);
+	ENetAddress address;
+	parse_address(l, luaL_checkstring(l, 2), &address);
+
+	size_t channel_count = (size_t) luaL_optnumber(l, 3, 1);
+	enet_uint32 data = (enet_uint32) luaL_optnumber(l, 4, 0);
+
+	host->connect(address, channel_count, data);
+	return 0;
+}
+
+static int service_host_disconnect_with(lua_State *l, ServiceHost::DisconnectMode mode) {
+	ServiceHost *host = check_running_service_host(l, 1);
+	int peer_index = check_peer_index(l, host, 2);
+	enet_uint32 data = (enet_uint32) luaL_optnumber(l, 3, 0);
+
+	host->disconnect(peer_index, data, mode);
+	return 0;
+}
+
+static int service_host_disconnect(lua_State *l) {
+	return service_host_disconnect_with(l, ServiceHost::DISCONNECT_NORMAL);
+}
+
+static int service_host_disconnect_now(lua_State *l) {
+	return service_host_disconnect_with(l, ServiceHost::DISCONNECT_NOW);
+}
+
+static int service_host_disconnect_later(lua_State *l) {
+	return service_host_disconnect_with(l, ServiceHost::DISCONNECT_LATER);
+}
+
+static int service_host_get_socket_address(lua_State *l) {
+	ServiceHost *host = check_running_service_host(l, 1);
+	ENetAddress address = host->getSocketAddress();
+
+	lua_pushfstring(l, "%d.%d.%d.%d:%d",
+			((address.host) & 0xFF),
+			((address.host >> 8) & 0xFF),
+			((address.host >> 16) & 0xFF),
+			(address.host >> 24& 0xFF),
+			address.port);
+	return 1;
+}
+
+static int service_host_peer_count(lua_State *l) {
+	ServiceHost *host = check_running_service_host(l, 1);
+	lua_pushinteger (l, host->getPeerCount());
+	return 1;
+}
+
+static int service_host_gc(lua_State *l) {
+	ServiceHost** host = (ServiceHost**)luaL_checkudata(l, 1, "enet_service_host");
+	// Stops the thread and destroys the ENet host.
+	if (*host) {
+		(*host)->release();
+	}
+	*host = NULL;
+	return 0;
+}
+
 static const struct luaL_Reg enet_funcs [] = {
 	{"host_create", host_create},
+	{"service_host_create", service_host_create},
 	{"linked_version", linked_version},
 	{NULL, NULL}
 };
@@ -773,12 +958,28 @@ static const struct luaL_Reg enet_peer_funcs [] = {
 	{NULL, NULL}
 };
 
+static const struct luaL_Reg enet_service_host_funcs [] = {
+	{"send", service_host_send},
+	{"broadcast", service_host_broadcast},
+	{"connect", service_host_connect},
+	{"disconnect", service_host_disconnect},
+	{"disconnect_now", service_host_disconnect_now},
+	{"disconnect_later", service_host_disconnect_later},
+	{"get_socket_address", service_host_get_socket_address},
+	{"peer_count", service_host_peer_count},
+	{"destroy", service_host_gc},
+	{NULL, NULL}
+};
+
 extern "C" {
 	void luax_register(lua_State *L, const char *name, const luaL_Reg *l);
 }
 
 int luaopen_enet(lua_State *l) {
-	enet_initialize();
+	// Received packets are handed to ByteData without a copy, so ENet has to
+	// allocate the same way ByteData frees.
+	ENetCallbacks callbacks = {ServiceHost::allocate, ServiceHost::deallocate, NULL};
+	enet_initialize_with_callbacks(ENET_VERSION, &callbacks);
 	atexit(enet_deinitialize);
 
 	// create metatables
@@ -789,6 +990,13 @@ int luaopen_enet(lua_State *l) {
 	lua_pushcfunction(l, host_gc);
 	lua_setfield(l, -2, "__gc");
 
+	luaL_newmetatable(l, "enet_service_host");
+	lua_newtable(l);
+	luax_register(l, NULL, enet_service_host_funcs);
+	lua_setfield(l, -2, "__index");
+	lua_pushcfunction(l, service_host_gc);
+	lua_setfield(l, -2, "__gc");
+
 	luaL_newmetatable(l, "enet_peer");
 	lua_newtable(l);
 	luax_register(l, NULL, enet_peer_funcs);
@@ -1128,6 +1128,7 @@ pfn_glObjectPtrLabelKHR fp_glObjectPtrLabelKHR;
 pfn_glGetObjectPtrLabelKHR fp_glGetObjectPtrLabelKHR;
 pfn_glGetPointervKHR fp_glGetPointervKHR;
 pfn_glGetGraphicsResetStatusKHR fp_glGetGraphicsResetStatusKHR;
+pfn_glMaxShaderCompilerThreadsKHR fp_glMaxShaderCompilerThreadsKHR;
 pfn_glReadnPixelsKHR fp_glReadnPixelsKHR;
 pfn_glGetnUniformfvKHR fp_glGetnUniformfvKHR;
 pfn_glGetnUniformivKHR fp_glGetnUniformivKHR;
@@ -3759,6 +3760,11 @@ static void load_GL_KHR_debug(LOADER load) {
 }
 
 GLboolean GLAD_KHR_no_error = GL_FALSE;
+GLboolean GLAD_KHR_parallel_shader_compile = GL_FALSE;
+static void load_GL_KHR_parallel_shader_compile(LOADER load) {
+	if(!GLAD_KHR_parallel_shader_compile) return;
+	fp_glMaxShaderCompilerThreadsKHR = (pfn_glMaxShaderCompilerThreadsKHR)load("glMaxShaderCompilerThreadsKHR");
+}
 GLboolean GLAD_KHR_robust_buffer_access_behavior = GL_FALSE;
 GLboolean GLAD_KHR_robustness = GL_FALSE;
 static void load_GL_KHR_robustness(LOADER load) {
@@ -6748,6 +6754,7 @@ static void find_extensions(void) {
 	GLAD_KHR_context_flush_control = has_ext("GL_KHR_context_flush_control");
 	GLAD_KHR_debug = has_ext("GL_KHR_debug");
 	GLAD_KHR_no_error = has_ext("GL_KHR_no_error");
+	GLAD_KHR_parallel_shader_compile = has_ext("GL_KHR_parallel_shader_compile");
 	GLAD_KHR_robust_buffer_access_behavior = has_ext("GL_KHR_robust_buffer_access_behavior");
 	GLAD_KHR_robustness = has_ext("GL_KHR_robustness");
 	GLAD_KHR_texture_compression_astc_hdr = has_ext("GL_KHR_texture_compression_astc_hdr");
@@ -7299,6 +7306,7 @@ bool gladLoadGLLoader(LOADER load) {
 	find_extensions();
 	load_GL_KHR_blend_equation_advanced(load);
 	load_GL_KHR_debug(load);
+	load_GL_KHR_parallel_shader_compile(load);
 	load_GL_KHR_robustness(load);
 	load_GL_ARB_base_instance(load);
 	load_GL_ARB_bindless_texture(load);
@@ -4229,6 +4229,13 @@ extern pfn_glGetPointervKHR fp_glGetPointervKHR;
 extern GLboolean GLAD_KHR_no_error;
 #define GL_CONTEXT_FLAG_NO_ERROR_BIT_KHR       0x00000008
 
+ /* GL_KHR_parallel_shader_compile */
+extern GLboolean GLAD_KHR_parallel_shader_compile;
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR     0x91B0
+#define GL_COMPLETION_STATUS_KHR               0x91B1
+typedef void (APIENTRYP pfn_glMaxShaderCompilerThreadsKHR) (GLuint);
+extern pfn_glMaxShaderCompilerThreadsKHR fp_glMaxShaderCompilerThreadsKHR;
+
  /* GL_KHR_robust_buffer_access_behavior */
 extern GLboolean GLAD_KHR_robust_buffer_access_behavior;
 
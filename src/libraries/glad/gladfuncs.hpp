@@ -1131,6 +1131,9 @@ inline void glObjectPtrLabelKHR(const void* ptr, GLsizei length, const GLchar* l
 inline void glGetObjectPtrLabelKHR(const void* ptr, GLsizei bufSize, GLsizei* length, GLchar* label) { fp_glGetObjectPtrLabelKHR(ptr, bufSize, length, label); }
 inline void glGetPointervKHR(GLenum pname, void** params) { fp_glGetPointervKHR(pname, params); }
 
+/* GL_KHR_parallel_shader_compile */
+inline void glMaxShaderCompilerThreadsKHR(GLuint count) { fp_glMaxShaderCompilerThreadsKHR(count); }
+
 /* GL_KHR_robustness */
 inline GLenum glGetGraphicsResetStatusKHR() { return fp_glGetGraphicsResetStatusKHR(); }
 inline void glReadnPixelsKHR(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLsizei bufSize, void* data) { fp_glReadnPixelsKHR(x, y, width, height, format, type, bufSize, data); }
@@ -0,0 +1,575 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "Poller.h"
+#include "luasocket.h"
+#include "common/Exception.h"
+
+// C++
+#include <algorithm>
+
+// C
+#include <cmath>
+#include <cerrno>
+#include <cstring>
+
+#ifndef LOVE_POLLER_WSAPOLL
+#	include <unistd.h>
+#endif
+
+namespace love
+{
+namespace luasocket
+{
+
+static int toMilliseconds(double timeout)
+{
+	if (timeout < 0.0)
+		return -1;
+
+	// Round up, so short timeouts don't turn into busy waits.
+	return (int) std::min(std::ceil(timeout * 1000.0), 2147483647.0);
+}
+
+Poller::Poller(bool edgeTriggered)
+	: edgeTriggered(edgeTriggered)
+{
+#if defined(LOVE_POLLER_WSAPOLL)
+	// WSAPoll has no edge-triggered mode.
+	this->edgeTriggered = false;
+#elif defined(LOVE_POLLER_EPOLL)
+	fd = epoll_create1(EPOLL_CLOEXEC);
+#else
+	fd = kqueue();
+#endif
+
+#ifndef LOVE_POLLER_WSAPOLL
+	if (fd < 0)
+		throw love::Exception("Could not create socket poller: %s", strerror(errno));
+
+	events.resize(64);
+#endif
+}
+
+Poller::~Poller()
+{
+#ifndef LOVE_POLLER_WSAPOLL
+	close(fd);
+#endif
+}
+
+void Poller::add(Socket socket, int events)
+{
+#if defined(LOVE_POLLER_WSAPOLL)
+	auto it = socketIndices.find(socket);
+	if (it != socketIndices.end())
+		return modify(socket, events);
+
+	WSAPOLLFD pollfd = {};
+	pollfd.fd = socket;
+	socketIndices[socket] = sockets.size();
+	sockets.push_back(pollfd);
+	modify(socket, events);
+#elif defined(LOVE_POLLER_EPOLL)
+	epoll_event event = {};
+	event.events = ((events & EVENT_READ) ? EPOLLIN : 0) | ((events & EVENT_WRITE) ? EPOLLOUT : 0) | (edgeTriggered ? EPOLLET : 0);
+	event.data.fd = socket;
+
+	// A closed socket leaves epoll on its own, so its descriptor may come back
+	// while still in our map.
+	if (epoll_ctl(fd, EPOLL_CTL_ADD, socket, &event) < 0)
+	{
+		if (errno != EEXIST || epoll_ctl(fd, EPOLL_CTL_MOD, socket, &event) < 0)
+			throw love::Exception("Could not add socket to poller: %s", strerror(errno));
+	}
+
+	sockets[socket] = events;
+#else
+	// kqueue also forgets closed sockets, so start over.
+	sockets.erase(socket);
+	modify(socket, events);
+#endif
+}
+
+void Poller::modify(Socket socket, int events)
+{
+#if defined(LOVE_POLLER_WSAPOLL)
+	auto it = socketIndices.find(socket);
+	if (it == socketIndices.end())
+		throw love::Exception("Socket is not in the poller.");
+
+	sockets[it->second].events = ((events & EVENT_READ) ? POLLRDNORM : 0) | ((events & EVENT_WRITE) ? POLLWRNORM : 0);
+#elif defined(LOVE_POLLER_EPOLL)
+	if (sockets.find(socket) == sockets.end())
+		throw love::Exception("Socket is not in the poller.");
+
+	epoll_event event = {};
+	event.events = ((events & EVENT_READ) ? EPOLLIN : 0) | ((events & EVENT_WRITE) ? EPOLLOUT : 0) | (edgeTriggered ? EPOLLET : 0);
+	event.data.fd = socket;
+
+	if (epoll_ctl(fd, EPOLL_CTL_MOD, socket, &event) < 0)
+		throw love::Exception("Could not modify socket in poller: %s", strerror(errno));
+
+	sockets[socket] = events;
+#else
+	int oldEvents = 0;
+	auto it = sockets.find(socket);
+	if (it != sockets.end())
+		oldEvents = it->second;
+
+	struct kevent changes[2];
+	int count = 0;
+	unsigned short flags = EV_ADD | EV_ENABLE | (edgeTriggered ? EV_CLEAR : 0);
+
+	if (events & EVENT_READ)
+		EV_SET(&changes[count++], socket, EVFILT_READ, flags, 0, 0, 0);
+	else if (oldEvents & EVENT_READ)
+		EV_SET(&changes[count++], socket, EVFILT_READ, EV_DELETE, 0, 0, 0);
+
+	if (events & EVENT_WRITE)
+		EV_SET(&changes[count++], socket, EVFILT_WRITE, flags, 0, 0, 0);
+	else if (oldEvents & EVENT_WRITE)
+		EV_SET(&changes[count++], socket, EVFILT_WRITE, EV_DELETE, 0, 0, 0);
+
+	if (count > 0 && kevent(fd, changes, count, nullptr, 0, nullptr) < 0)
+		throw love::Exception("Could not modify socket in poller: %s", strerror(errno));
+
+	sockets[socket] = events;
+#endif
+}
+
+void Poller::remove(Socket socket)
+{
+#if defined(LOVE_POLLER_WSAPOLL)
+	auto it = socketIndices.find(socket);
+	if (it == socketIndices.end())
+		return;
+
+	// Swap with the last socket, so removal doesn't shift the others.
+	size_t index = it->second;
+	socketIndices.erase(it);
+
+	if (index != sockets.size() - 1)
+	{
+		sockets[index] = sockets.back();
+		socketIndices[sockets[index].fd] = index;
+	}
+
+	sockets.pop_back();
+#else
+	auto it = sockets.find(socket);
+	if (it == sockets.end())
+		return;
+
+	// Errors are ignored, since the socket may have been closed already.
+#ifdef LOVE_POLLER_EPOLL
+	epoll_event event = {};
+	epoll_ctl(fd, EPOLL_CTL_DEL, socket, &event);
+#else
+	struct kevent changes[2];
+	int count = 0;
+
+	if (it->second & EVENT_READ)
+		EV_SET(&changes[count++], socket, EVFILT_READ, EV_DELETE, 0, 0, 0);
+	if (it->second & EVENT_WRITE)
+		EV_SET(&changes[count++], socket, EVFILT_WRITE, EV_DELETE, 0, 0, 0);
+
+	if (count > 0)
+		kevent(fd, changes, count, nullptr, 0, nullptr);
+#endif
+
+	sockets.erase(it);
+#endif
+}
+
+int Poller::wait(double timeout, std::vector<Result> &results)
+{
+	results.clear();
+	int ms = toMilliseconds(timeout);
+
+#if defined(LOVE_POLLER_WSAPOLL)
+	if (sockets.empty())
+	{
+		if (ms != 0)
+			Sleep(ms < 0 ? INFINITE : (DWORD) ms);
+		return 0;
+	}
+
+	int count = WSAPoll(sockets.data(), (ULONG) sockets.size(), ms);
+	if (count == SOCKET_ERROR)
+		throw love::Exception("Could not poll sockets (error %d).", WSAGetLastError());
+
+	for (size_t i = 0; i < sockets.size() && (int) results.size() < count; i++)
+	{
+		SHORT revents = sockets[i].revents;
+		if (revents == 0)
+			continue;
+
+		Result result = {sockets[i].fd, 0};
+		if (revents & (POLLRDNORM | POLLHUP | POLLERR | POLLNVAL))
+			result.events |= EVENT_READ;
+		if (revents & POLLWRNORM)
+			result.events |= EVENT_WRITE;
+
+		results.push_back(result);
+	}
+#else
+#ifdef LOVE_POLLER_EPOLL
+	int count = epoll_wait(fd, events.data(), (int) events.size(), ms);
+#else
+	struct timespec time;
+	time.tv_sec = ms / 1000;
+	time.tv_nsec = (ms % 1000) * 1000000L;
+
+	int count = kevent(fd, nullptr, 0, events.data(), (int) events.size(), ms < 0 ? nullptr : &time);
+#endif
+
+	if (count < 0)
+	{
+		// A signal interrupted the wait, which isn't an error.
+		if (errno == EINTR)
+			return 0;
+
+		throw love::Exception("Could not poll sockets: %s", strerror(errno));
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+#ifdef LOVE_POLLER_EPOLL
+		const epoll_event &event = events[i];
+		Result result = {event.data.fd, 0};
+
+		if (event.events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+			result.events |= EVENT_READ;
+		if (event.events & EPOLLOUT)
+			result.events |= EVENT_WRITE;
+#else
+		const struct kevent &event = events[i];
+		Result result = {(Socket) event.ident, 0};
+
+		// Each filter is its own event, so a socket which is readable and
+		// writable comes back twice.
+		if (event.filter == EVFILT_READ || (event.flags & EV_ERROR))
+			result.events |= EVENT_READ;
+		else if (event.filter == EVFILT_WRITE)
+			result.events |= EVENT_WRITE;
+#endif
+
+		results.push_back(result);
+	}
+
+	if (count == (int) events.size())
+		events.resize(events.size() * 2);
+#endif
+
+	return (int) results.size();
+}
+
+bool Poller::isEdgeTriggered() const
+{
+	return edgeTriggered;
+}
+
+int Poller::getSocketCount() const
+{
+	return (int) sockets.size();
+}
+
+/**
+ * Lua bindings. The poller's userdata refers to a table which maps each
+ * socket's descriptor to the socket object, so wait can return the objects.
+ **/
+
+#define POLLER_METATABLE "love.socket.poller"
+
+struct LuaPoller
+{
+	Poller *poller;
+	int objects;
+};
+
+static LuaPoller *checkpoller(lua_State *L, int idx)
+{
+	LuaPoller *p = (LuaPoller *) luaL_checkudata(L, idx, POLLER_METATABLE);
+	if (p->poller == nullptr)
+		luaL_error(L, "Cannot use a closed poller.");
+	return p;
+}
+
+// Accepts LuaSocket objects (anything with a getfd method) and descriptors.
+static Poller::Socket checksocket(lua_State *L, int idx)
+{
+	lua_Number fd = -1;
+
+	if (lua_type(L, idx) == LUA_TNUMBER)
+		fd = lua_tonumber(L, idx);
+	else
+	{
+		lua_getfield(L, idx, "getfd");
+		if (!lua_isfunction(L, -1))
+			luaL_argerror(L, idx, "expected a socket or descriptor");
+
+		lua_pushvalue(L, idx);
+		lua_call(L, 1, 1);
+		fd = lua_tonumber(L, -1);
+		lua_pop(L, 1);
+	}
+
+	if (fd < 0)
+		luaL_argerror(L, idx, "socket is closed");
+
+	return (Poller::Socket) fd;
+}
+
+static int checkevents(lua_State *L, int idx)
+{
+	const char *str = luaL_optstring(L, idx, "r");
+	int events = 0;
+
+	for (const char *c = str; *c != '\0'; c++)
+	{
+		if (*c == 'r')
+			events |= Poller::EVENT_READ;
+		else if (*c == 'w')
+			events |= Poller::EVENT_WRITE;
+		else
+			luaL_argerror(L, idx, "events must be 'r', 'w' or 'rw'");
+	}
+
+	return events;
+}
+
+static void setobject(lua_State *L, LuaPoller *p, Poller::Socket socket, int idx)
+{
+	if (idx < 0)
+		idx = lua_gettop(L) + idx + 1;
+
+	lua_rawgeti(L, LUA_REGISTRYINDEX, p->objects);
+	lua_pushnumber(L, (lua_Number) socket);
+	lua_pushvalue(L, idx);
+	lua_rawset(L, -3);
+	lua_pop(L, 1);
+}
+
+static int w_poller_new(lua_State *L)
+{
+	bool edge = lua_isnoneornil(L, 1) ? true : luax_toboolean(L, 1);
+
+	LuaPoller *p = (LuaPoller *) lua_newuserdata(L, sizeof(LuaPoller));
+	p->poller = nullptr;
+	p->objects = LUA_NOREF;
+
+	luaL_getmetatable(L, POLLER_METATABLE);
+	lua_setmetatable(L, -2);
+
+	luax_catchexcept(L, [&]() { p->poller = new Poller(edge); });
+
+	lua_newtable(L);
+	p->objects = luaL_ref(L, LUA_REGISTRYINDEX);
+
+	return 1;
+}
+
+static int w_poller_add(lua_State *L)
+{
+	LuaPoller *p = checkpoller(L, 1);
+	Poller::Socket socket = checksocket(L, 2);
+	int events = checkevents(L, 3);
+
+	luax_catchexcept(L, [&]() { p->poller->add(socket, events); });
+	setobject(L, p, socket, 2);
+
+	lua_pushboolean(L, 1);
+	return 1;
+}
+
+static int w_poller_modify(lua_State *L)
+{
+	LuaPoller *p = checkpoller(L, 1);
+	Poller::Socket socket = checksocket(L, 2);
+	int events = checkevents(L, 3);
+
+	luax_catchexcept(L, [&]() { p->poller->modify(socket, events); });
+
+	lua_pushboolean(L, 1);
+	return 1;
+}
+
+static int w_poller_remove(lua_State *L)
+{
+	LuaPoller *p = checkpoller(L, 1);
+	Poller::Socket socket = checksocket(L, 2);
+
+	p->poller->remove(socket);
+
+	lua_pushnil(L);
+	setobject(L, p, socket, -1);
+	lua_pop(L, 1);
+
+	lua_pushboolean(L, 1);
+	return 1;
+}
+
+// Fills the array at idx with the first count values, and clears the rest.
+static void setarraysize(lua_State *L, int idx, int count)
+{
+	for (int i = count + 1; ; i++)
+	{
+		lua_rawgeti(L, idx, i);
+		bool empty = lua_isnil(L, -1);
+		lua_pop(L, 1);
+
+		if (empty)
+			break;
+
+		lua_pushnil(L);
+		lua_rawseti(L, idx, i);
+	}
+}
+
+/**
+ * poller:wait([timeout], [readable], [writable]) returns arrays of the
+ * readable and writable sockets, reusing the given tables if there are any.
+ * A nil or negative timeout waits forever.
+ **/
+static int w_poller_wait(lua_State *L)
+{
+	LuaPoller *p = checkpoller(L, 1);
+	double timeout = luaL_optnumber(L, 2, -1.0);
+
+	static thread_local std::vector<Poller::Result> results;
+	luax_catchexcept(L, [&]() { p->poller->wait(timeout, results); });
+
+	lua_settop(L, 4);
+	for (int i = 3; i <= 4; i++)
+	{
+		if (!lua_istable(L, i))
+		{
+			lua_newtable(L);
+			lua_replace(L, i);
+		}
+	}
+
+	lua_rawgeti(L, LUA_REGISTRYINDEX, p->objects);
+	int readable = 0;
+	int writable = 0;
+
+	for (const Poller::Result &result : results)
+	{
+		lua_pushnumber(L, (lua_Number) result.socket);
+		lua_rawget(L, 5);
+
+		// A descriptor added directly is returned as a number.
+		if (lua_isnil(L, -1))
+		{
+			lua_pop(L, 1);
+			lua_pushnumber(L, (lua_Number) result.socket);
+		}
+
+		if (result.events & Poller::EVENT_READ)
+		{
+			lua_pushvalue(L, -1);
+			lua_rawseti(L, 3, ++readable);
+		}
+
+		if (result.events & Poller::EVENT_WRITE)
+		{
+			lua_pushvalue(L, -1);
+			lua_rawseti(L, 4, ++writable);
+		}
+
+		lua_pop(L, 1);
+	}
+
+	lua_pop(L, 1);
+
+	setarraysize(L, 3, readable);
+	setarraysize(L, 4, writable);
+
+	return 2;
+}
+
+static int w_poller_count(lua_State *L)
+{
+	LuaPoller *p = checkpoller(L, 1);
+	lua_pushinteger(L, p->poller->getSocketCount());
+	return 1;
+}
+
+static int w_poller_close(lua_State *L)
+{
+	LuaPoller *p = (LuaPoller *) luaL_checkudata(L, 1, POLLER_METATABLE);
+
+	delete p->poller;
+	p->poller = nullptr;
+
+	luaL_unref(L, LUA_REGISTRYINDEX, p->objects);
+	p->objects = LUA_NOREF;
+
+	return 0;
+}
+
+static const luaL_Reg pollerFunctions[] =
+{
+	{ "add", w_poller_add },
+	{ "modify", w_poller_modify },
+	{ "remove", w_poller_remove },
+	{ "wait", w_poller_wait },
+	{ "count", w_poller_count },
+	{ "close", w_poller_close },
+	{ nullptr, nullptr }
+};
+
+static const luaL_Reg moduleFunctions[] =
+{
+	{ "new", w_poller_new },
+	{ nullptr, nullptr }
+};
+
+int __open_luasocket_poller(lua_State *L)
+{
+	luaL_newmetatable(L, POLLER_METATABLE);
+
+	lua_newtable(L);
+	luax_setfuncs(L, pollerFunctions);
+	lua_setfield(L, -2, "__index");
+
+	lua_pushcfunction(L, w_poller_close);
+	lua_setfield(L, -2, "__gc");
+
+	lua_pop(L, 1);
+
+	lua_newtable(L);
+	luax_setfuncs(L, moduleFunctions);
+
+#if defined(LOVE_POLLER_EPOLL)
+	lua_pushstring(L, "epoll");
+#elif defined(LOVE_POLLER_KQUEUE)
+	lua_pushstring(L, "kqueue");
+#else
+	lua_pushstring(L, "wsapoll");
+#endif
+	lua_setfield(L, -2, "backend");
+
+	return 1;
+}
+
+} // luasocket
+} // love
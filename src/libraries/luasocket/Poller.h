@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_LUASOCKET_POLLER_H
+#define LOVE_LUASOCKET_POLLER_H
+
+// LOVE
+#include "common/config.h"
+#include "common/runtime.h"
+
+// C++
+#include <vector>
+#include <unordered_map>
+
+#if defined(LOVE_WINDOWS)
+#	define LOVE_POLLER_WSAPOLL
+#	include <winsock2.h>
+#elif defined(__linux__)
+#	define LOVE_POLLER_EPOLL
+#	include <sys/epoll.h>
+#else
+#	define LOVE_POLLER_KQUEUE
+#	include <sys/types.h>
+#	include <sys/event.h>
+#endif
+
+namespace love
+{
+namespace luasocket
+{
+
+/**
+ * Waits for readiness on many sockets at once, without select()'s linear scan
+ * and FD_SETSIZE limit. Uses epoll on Linux and kqueue on macOS, iOS and the
+ * BSDs. Windows has no readiness API which scales the same way (IOCP reports
+ * completions instead), so it falls back to WSAPoll, which has no socket limit
+ * but is level-triggered and linear in the number of sockets.
+ *
+ * In edge-triggered mode a socket is only reported when it becomes ready, so
+ * it has to be read or written until it would block before it's reported
+ * again.
+ **/
+class Poller
+{
+public:
+
+#ifdef LOVE_POLLER_WSAPOLL
+	typedef SOCKET Socket;
+#else
+	typedef int Socket;
+#endif
+
+	enum Event
+	{
+		EVENT_READ = 1 << 0,
+		EVENT_WRITE = 1 << 1,
+	};
+
+	struct Result
+	{
+		Socket socket;
+		int events;
+	};
+
+	Poller(bool edgeTriggered);
+	~Poller();
+
+	// Events is a combination of Event flags.
+	void add(Socket socket, int events);
+	void modify(Socket socket, int events);
+	void remove(Socket socket);
+
+	/**
+	 * Waits up to timeout seconds (forever if negative) for any socket to be
+	 * ready, and replaces the contents of results with the ready sockets.
+	 * Errors and hangups are reported as readable, so the next receive sees
+	 * them. Returns the number of results.
+	 **/
+	int wait(double timeout, std::vector<Result> &results);
+
+	bool isEdgeTriggered() const;
+	int getSocketCount() const;
+
+private:
+
+	bool edgeTriggered;
+
+#ifdef LOVE_POLLER_WSAPOLL
+	std::vector<WSAPOLLFD> sockets;
+	std::unordered_map<Socket, size_t> socketIndices;
+#else
+	int fd;
+	// Registered sockets and their events.
+	std::unordered_map<Socket, int> sockets;
+	// Grows when a wait fills it, so later waits can return more at once.
+#ifdef LOVE_POLLER_EPOLL
+	std::vector<epoll_event> events;
+#else
+	std::vector<struct kevent> events;
+#endif
+#endif
+
+}; // Poller
+
+} // luasocket
+} // love
+
+#endif // LOVE_LUASOCKET_POLLER_H
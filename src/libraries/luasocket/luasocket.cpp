@@ -57,6 +57,7 @@ int __open(lua_State * L)
 	PRELOAD("socket.url", __open_luasocket_url)
 	PRELOAD("socket.headers", __open_luasocket_headers)
 	PRELOAD("mbox", __open_luasocket_mbox)
+	PRELOAD("socket.poller", __open_luasocket_poller)
 
 	// No need to register garbage collector function.
 
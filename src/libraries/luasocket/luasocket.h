@@ -45,6 +45,9 @@ int __open_luasocket_url(lua_State * L);
 int __open_luasocket_headers(lua_State * L);
 int __open_luasocket_mbox(lua_State * L);
 
+// Native module, see Poller.h.
+int __open_luasocket_poller(lua_State * L);
+
 } // luasocket
 } // love
 
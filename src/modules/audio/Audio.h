@@ -71,6 +71,31 @@ public:
 	static bool getConstant(DistanceModel in, const char  *&out);
 	static std::vector<std::string> getConstants(DistanceModel);
 
+	// Budget for cached static audio, in bytes.
+	static const size_t DEFAULT_STATIC_CACHE_BUDGET = 32 * 1024 * 1024;
+
+	struct Stats
+	{
+		// Streaming underruns across all Sources.
+		int underruns = 0;
+
+		// Buffers decoded by the update thread, and the total time taken.
+		int decodedBuffers = 0;
+		double decodeTime = 0.0;
+
+		// Total and longest time the update thread waited for and held the
+		// lock shared with the main thread.
+		double lockWaitTime = 0.0;
+		double maxLockWaitTime = 0.0;
+		double lockHoldTime = 0.0;
+		double maxLockHoldTime = 0.0;
+
+		// Number of updates, and the total and longest time between two.
+		int updates = 0;
+		double updateInterval = 0.0;
+		double maxUpdateInterval = 0.0;
+	};
+
 	virtual ~Audio() {}
 
 	// Implements Module.
@@ -80,6 +105,28 @@ public:
 	virtual Source *newSource(love::sound::SoundData *soundData) = 0;
 	virtual Source *newSource(int sampleRate, int bitDepth, int channels, int buffers) = 0;
 
+	/**
+	 * Creates a static Source and caches its decoded audio under the key
+	 * (usually a file path), so newCachedSource can reuse it.
+	 **/
+	virtual Source *newSource(love::sound::SoundData *soundData, const std::string &cachekey) = 0;
+
+	/**
+	 * Creates a static Source from cached audio.
+	 * @return The new Source, or null if nothing is cached under the key.
+	 **/
+	virtual Source *newCachedSource(const std::string &cachekey) = 0;
+
+	/**
+	 * Sets how much memory (in bytes) cached static audio may use before the
+	 * least recently used audio no Source is playing from gets evicted. A
+	 * budget of 0 disables the cache.
+	 **/
+	virtual void setStaticCacheBudget(size_t bytes) = 0;
+	virtual size_t getStaticCacheBudget() const = 0;
+	virtual size_t getStaticCacheSize() const = 0;
+	virtual void clearStaticCache() = 0;
+
 	/**
 	 * Gets the current number of simultaneous playing sources.
 	 * @return The current number of simultaneous playing sources.
@@ -121,6 +168,13 @@ public:
 	 **/
 	virtual void stop() = 0;
 
+	/**
+	 * Sets the position, velocity and volume of many Sources at once. This is
+	 * cheaper than setting them on each Source, since the backend only has to
+	 * synchronize once.
+	 **/
+	virtual void updateSources(const std::vector<Source::SpatialUpdate> &updates) = 0;
+
 	/**
 	 * Pauses playback on the specified source.
 	 * @param source The source on which to pause the playback.
@@ -257,6 +311,36 @@ public:
 	 */
 	virtual bool isEFXsupported() const = 0;
 
+	/**
+	 * Sets the volume of a mixer bus. All its Sources are updated at once.
+	 **/
+	virtual void setBusVolume(const std::string &bus, float volume) = 0;
+	virtual float getBusVolume(const std::string &bus) const = 0;
+
+	/**
+	 * Sets the scene effects (see setEffect) every Source on a mixer bus is
+	 * sent to. The effects process the mix of the bus once, rather than each
+	 * Source separately.
+	 * @return False if an effect doesn't exist.
+	 **/
+	virtual bool setBusEffects(const std::string &bus, const std::vector<std::string> &effects) = 0;
+	virtual std::vector<std::string> getBusEffects(const std::string &bus) const = 0;
+
+	/**
+	 * Sets how much audio (in seconds) streaming Sources try to keep queued
+	 * ahead of playback. Streams are refilled when they get close to this
+	 * amount, rather than at a fixed interval.
+	 **/
+	virtual void setStreamingLatency(double seconds) = 0;
+	virtual double getStreamingLatency() const = 0;
+
+	/**
+	 * Gets counters for diagnosing stutter, accumulated since the last call to
+	 * resetStats.
+	 **/
+	virtual Stats getStats() const = 0;
+	virtual void resetStats() = 0;
+
 	/**
 	 * Sets whether audio from other apps mixes with love.audio or is muted,
 	 * on supported platforms.
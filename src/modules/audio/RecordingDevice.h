@@ -23,6 +23,7 @@
 
 #include "common/Object.h"
 #include "sound/SoundData.h"
+#include "thread/Channel.h"
 
 #include <string>
 
@@ -41,6 +42,7 @@ public:
 	static const int DEFAULT_SAMPLE_RATE = 8000;
 	static const int DEFAULT_BIT_DEPTH = 16;
 	static const int DEFAULT_CHANNELS = 1;
+	static const int DEFAULT_FRAMES = 8;
 
 	RecordingDevice();
 	virtual ~RecordingDevice();
@@ -101,6 +103,36 @@ public:
 	 **/
 	virtual bool isRecording() const = 0;
 
+	/**
+	 * Makes recording fill a ring of fixed-size frames from a capture thread,
+	 * instead of waiting for getData. Takes effect at the next start().
+	 * @param frameSamples Samples per frame, or 0 to turn frame mode off.
+	 * @param frames Number of frames the ring holds. Frames captured while
+	 *        it's full are dropped.
+	 * @param channel Optional Channel that receives the number of frames
+	 *        captured so far whenever new frames are available.
+	 **/
+	virtual void setFrameMode(int frameSamples, int frames, love::thread::Channel *channel) = 0;
+	virtual int getFrameSamples() const = 0;
+
+	/**
+	 * Copies the oldest captured frame into a SoundData without allocating.
+	 * Only one thread may read frames at a time.
+	 * @return False if no frame is available.
+	 **/
+	virtual bool readFrame(love::sound::SoundData *dst) = 0;
+
+	/**
+	 * @return Number of frames waiting to be read.
+	 **/
+	virtual int getAvailableFrames() const = 0;
+
+	/**
+	 * @return Number of frames dropped because the ring was full, since the
+	 *         last start().
+	 **/
+	virtual int getDroppedFrames() const = 0;
+
 }; //RecordingDevice
 
 } //audio
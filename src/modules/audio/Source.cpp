@@ -19,6 +19,7 @@
  **/
 
 #include "Source.h"
+#include "common/Exception.h"
 
 namespace love
 {
@@ -29,6 +30,7 @@ love::Type Source::type("Source", &Object::type);
 
 Source::Source(Type sourceType)
 	: sourceType(sourceType)
+	, priority(0)
 {
 }
 
@@ -41,6 +43,50 @@ Source::Type Source::getType() const
 	return sourceType;
 }
 
+void Source::setPriority(int priority)
+{
+	this->priority = priority;
+}
+
+int Source::getPriority() const
+{
+	return priority;
+}
+
+bool Source::isVirtual() const
+{
+	return false;
+}
+
+Source::Stats Source::getStats() const
+{
+	return Stats();
+}
+
+void Source::setBus(const std::string &name)
+{
+	bus = name;
+}
+
+const std::string &Source::getBus() const
+{
+	return bus;
+}
+
+void Source::queueDecoder(love::sound::Decoder */*decoder*/, float /*crossfade*/)
+{
+	throw love::Exception("Only streaming Sources can queue Decoders.");
+}
+
+int Source::getQueuedDecoderCount() const
+{
+	return 0;
+}
+
+void Source::clearQueuedDecoders()
+{
+}
+
 bool Source::getConstant(const char *in, Type &out)
 {
 	return types.find(in, out);
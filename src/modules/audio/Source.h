@@ -24,6 +24,7 @@
 // LOVE
 #include "common/Object.h"
 #include "common/StringMap.h"
+#include "sound/Decoder.h"
 #include "Filter.h"
 
 #include <vector>
@@ -124,6 +125,60 @@ public:
 
 	virtual Type getType() const;
 
+	// New spatial state for one Source, see Audio::updateSources.
+	struct SpatialUpdate
+	{
+		Source *source;
+		float position[3];
+		float velocity[3];
+		float volume;
+	};
+
+	struct Stats
+	{
+		// Times playback ran out of queued audio while streaming.
+		int underruns = 0;
+
+		// Seconds of audio queued ahead of the playback position.
+		double queuedTime = 0.0;
+
+		// Buffers decoded for streaming, and the total time spent decoding.
+		int decodedBuffers = 0;
+		double decodeTime = 0.0;
+	};
+
+	virtual Stats getStats() const;
+
+	/**
+	 * Sources with a higher priority get mixed first when there are more
+	 * playing Sources than the backend can mix at once.
+	 **/
+	void setPriority(int priority);
+	int getPriority() const;
+
+	/**
+	 * Whether the Source is playing without being mixed, because all voices
+	 * are taken by more important Sources. Its position keeps advancing.
+	 **/
+	virtual bool isVirtual() const;
+
+	/**
+	 * Routes the Source through a mixer bus, which scales its volume and adds
+	 * the bus's effects. An empty name removes it from its bus.
+	 **/
+	virtual void setBus(const std::string &name);
+	const std::string &getBus() const;
+
+	/**
+	 * Queues a Decoder to play after the current one on a streaming Source,
+	 * without a gap. It's decoded ahead in the background, and can fade in
+	 * over the last 'crossfade' seconds of the previous Decoder. Queued
+	 * Decoders must have the same format as the Source.
+	 **/
+	virtual void queueDecoder(love::sound::Decoder *decoder, float crossfade);
+	virtual int getQueuedDecoderCount() const;
+	virtual void clearQueuedDecoders();
+
 	static bool getConstant(const char *in, Type &out);
 	static bool getConstant(Type in, const char  *&out);
 	static std::vector<std::string> getConstants(Type);
@@ -134,6 +189,8 @@ public:
 protected:
 
 	Type sourceType;
+	int priority;
+	std::string bus;
 
 private:
 
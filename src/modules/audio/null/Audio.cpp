@@ -29,6 +29,7 @@ namespace null
 
 Audio::Audio()
 	: distanceModel(DISTANCE_NONE)
+	, streamingLatency(0.1)
 {
 }
 
@@ -51,6 +52,16 @@ love::audio::Source *Audio::newSource(love::sound::SoundData *)
 	return new Source();
 }
 
+love::audio::Source *Audio::newSource(love::sound::SoundData *, const std::string &)
+{
+	return new Source();
+}
+
+love::audio::Source *Audio::newCachedSource(const std::string &)
+{
+	return nullptr;
+}
+
 love::audio::Source *Audio::newSource(int, int, int, int)
 {
 	return new Source();
@@ -88,6 +99,10 @@ void Audio::stop()
 {
 }
 
+void Audio::updateSources(const std::vector<love::audio::Source::SpatialUpdate> &)
+{
+}
+
 void Audio::pause(love::audio::Source *)
 {
 }
@@ -203,6 +218,62 @@ bool Audio::isEFXsupported() const
 	return false;
 }
 
+Audio::Stats Audio::getStats() const
+{
+	return Stats();
+}
+
+void Audio::resetStats()
+{
+}
+
+void Audio::setBusVolume(const std::string &, float)
+{
+}
+
+float Audio::getBusVolume(const std::string &) const
+{
+	return 1.0f;
+}
+
+bool Audio::setBusEffects(const std::string &, const std::vector<std::string> &)
+{
+	return false;
+}
+
+std::vector<std::string> Audio::getBusEffects(const std::string &) const
+{
+	return std::vector<std::string>();
+}
+
+void Audio::setStaticCacheBudget(size_t)
+{
+}
+
+size_t Audio::getStaticCacheBudget() const
+{
+	return 0;
+}
+
+size_t Audio::getStaticCacheSize() const
+{
+	return 0;
+}
+
+void Audio::clearStaticCache()
+{
+}
+
+void Audio::setStreamingLatency(double seconds)
+{
+	streamingLatency = seconds;
+}
+
+double Audio::getStreamingLatency() const
+{
+	return streamingLatency;
+}
+
 } // null
 } // audio
 } // love
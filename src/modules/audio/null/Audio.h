@@ -47,6 +47,8 @@ public:
 	// Implements Audio.
 	love::audio::Source *newSource(love::sound::Decoder *decoder);
 	love::audio::Source *newSource(love::sound::SoundData *soundData);
+	love::audio::Source *newSource(love::sound::SoundData *soundData, const std::string &cachekey);
+	love::audio::Source *newCachedSource(const std::string &cachekey);
 	love::audio::Source *newSource(int sampleRate, int bitDepth, int channels, int buffers);
 	int getActiveSourceCount() const;
 	int getMaxSources() const;
@@ -55,6 +57,7 @@ public:
 	void stop(love::audio::Source *source);
 	void stop(const std::vector<love::audio::Source*> &sources);
 	void stop();
+	void updateSources(const std::vector<love::audio::Source::SpatialUpdate> &updates);
 	void pause(love::audio::Source *source);
 	void pause(const std::vector<love::audio::Source*> &sources);
 	std::vector<love::audio::Source*> pause();
@@ -86,9 +89,26 @@ public:
 	int getMaxSourceEffects() const;
 	bool isEFXsupported() const;
 
+	void setStreamingLatency(double seconds);
+	double getStreamingLatency() const;
+
+	Stats getStats() const;
+	void resetStats();
+
+	void setBusVolume(const std::string &bus, float volume);
+	float getBusVolume(const std::string &bus) const;
+	bool setBusEffects(const std::string &bus, const std::vector<std::string> &effects);
+	std::vector<std::string> getBusEffects(const std::string &bus) const;
+
+	void setStaticCacheBudget(size_t bytes);
+	size_t getStaticCacheBudget() const;
+	size_t getStaticCacheSize() const;
+	void clearStaticCache();
+
 private:
 	float volume;
 	DistanceModel distanceModel;
+	double streamingLatency;
 	std::vector<love::audio::RecordingDevice*> capture;
 
 }; // Audio
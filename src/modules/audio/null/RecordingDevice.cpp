@@ -87,6 +87,30 @@ bool RecordingDevice::isRecording() const
 	return false;
 }
 
+void RecordingDevice::setFrameMode(int, int, love::thread::Channel *)
+{
+}
+
+int RecordingDevice::getFrameSamples() const
+{
+	return 0;
+}
+
+bool RecordingDevice::readFrame(love::sound::SoundData *)
+{
+	return false;
+}
+
+int RecordingDevice::getAvailableFrames() const
+{
+	return 0;
+}
+
+int RecordingDevice::getDroppedFrames() const
+{
+	return 0;
+}
+
 } //null
 } //audio
 } //love
@@ -46,6 +46,11 @@ public:
 	virtual int getBitDepth() const;
 	virtual int getChannelCount() const;
 	virtual bool isRecording() const;
+	virtual void setFrameMode(int frameSamples, int frames, love::thread::Channel *channel);
+	virtual int getFrameSamples() const;
+	virtual bool readFrame(love::sound::SoundData *dst);
+	virtual int getAvailableFrames() const;
+	virtual int getDroppedFrames() const;
 
 private:
 	static const char *name;
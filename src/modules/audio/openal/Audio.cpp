@@ -19,7 +19,6 @@
  **/
 
 #include "Audio.h"
-#include "common/delay.h"
 #include "RecordingDevice.h"
 #include "sound/Decoder.h"
 
@@ -38,6 +37,9 @@ Audio::PoolThread::PoolThread(Pool *pool)
 	, finish(false)
 {
 	threadName = "AudioPool";
+
+	// Starving the pool causes audible gaps in streaming Sources.
+	threadPriority = PRIORITY_HIGH;
 }
 
 Audio::PoolThread::~PoolThread()
@@ -57,19 +59,25 @@ void Audio::PoolThread::threadFunction()
 			}
 		}
 
-		pool->update();
-		sleep(5);
+		pool->waitForUpdate(pool->update());
 	}
 }
 
 void Audio::PoolThread::setFinish()
 {
-	thread::Lock lock(mutex);
-	finish = true;
+	{
+		thread::Lock lock(mutex);
+		finish = true;
+	}
+
+	pool->wake();
 }
 
 ALenum Audio::getFormat(int bitDepth, int channels)
 {
+	if (bitDepth == 32)
+		return getFloatFormat(channels);
+
 	if (bitDepth != 8 && bitDepth != 16)
 		return AL_NONE;
 
@@ -89,10 +97,36 @@ ALenum Audio::getFormat(int bitDepth, int channels)
 	return AL_NONE;
 }
 
+ALenum Audio::getFloatFormat(int channels)
+{
+#ifdef AL_EXT_FLOAT32
+	if (!alIsExtensionPresent("AL_EXT_FLOAT32"))
+		return AL_NONE;
+
+	if (channels == 1)
+		return AL_FORMAT_MONO_FLOAT32;
+	else if (channels == 2)
+		return AL_FORMAT_STEREO_FLOAT32;
+#ifdef AL_EXT_MCFORMATS
+	else if (alIsExtensionPresent("AL_EXT_MCFORMATS"))
+	{
+		if (channels == 6)
+			return AL_FORMAT_51CHN32;
+		else if (channels == 8)
+			return AL_FORMAT_71CHN32;
+	}
+#endif
+#else
+	LOVE_UNUSED(channels);
+#endif
+	return AL_NONE;
+}
+
 Audio::Audio()
 	: device(nullptr)
 	, context(nullptr)
 	, pool(nullptr)
+	, staticCache(DEFAULT_STATIC_CACHE_BUDGET)
 	, poolThread(nullptr)
 	, distanceModel(DISTANCE_INVERSE_CLAMPED)
 {
@@ -190,6 +224,9 @@ Audio::~Audio()
 	delete poolThread;
 	delete pool;
 
+	// The buffers have to go before the context does.
+	staticCache.clear();
+
 	for (auto c : capture)
 		delete c;
 
@@ -229,6 +266,29 @@ love::audio::Source *Audio::newSource(love::sound::SoundData *soundData)
 	return new Source(pool, soundData);
 }
 
+love::audio::Source *Audio::newSource(love::sound::SoundData *soundData, const std::string &cachekey)
+{
+	Source *source = new Source(pool, soundData);
+
+	StaticBufferCache::Entry entry;
+	entry.buffer.set(source->getStaticBuffer());
+	entry.sampleRate = soundData->getSampleRate();
+	entry.bitDepth = soundData->getBitDepth();
+	entry.channels = soundData->getChannelCount();
+	staticCache.insert(cachekey, entry);
+
+	return source;
+}
+
+love::audio::Source *Audio::newCachedSource(const std::string &cachekey)
+{
+	StaticBufferCache::Entry entry;
+	if (!staticCache.find(cachekey, entry))
+		return nullptr;
+
+	return new Source(pool, entry.buffer.get(), entry.sampleRate, entry.bitDepth, entry.channels);
+}
+
 love::audio::Source *Audio::newSource(int sampleRate, int bitDepth, int channels, int buffers)
 {
 	return new Source(pool, sampleRate, bitDepth, channels, buffers);
@@ -269,6 +329,11 @@ void Audio::stop()
 	return Source::stop(pool);
 }
 
+void Audio::updateSources(const std::vector<love::audio::Source::SpatialUpdate> &updates)
+{
+	Source::update(updates);
+}
+
 void Audio::pause(love::audio::Source *source)
 {
 	source->pause();
@@ -565,6 +630,74 @@ int Audio::getMaxSourceEffects() const
 	return MAX_SOURCE_EFFECTS;
 }
 
+Audio::Stats Audio::getStats() const
+{
+	return pool->getStats();
+}
+
+void Audio::resetStats()
+{
+	pool->resetStats();
+}
+
+void Audio::setBusVolume(const std::string &bus, float volume)
+{
+	pool->setBusVolume(bus, volume);
+}
+
+float Audio::getBusVolume(const std::string &bus) const
+{
+	return pool->getBusVolume(bus);
+}
+
+bool Audio::setBusEffects(const std::string &bus, const std::vector<std::string> &effects)
+{
+	for (const std::string &effect : effects)
+	{
+		ALuint id;
+		if (!getEffectID(effect.c_str(), id))
+			return false;
+	}
+
+	pool->setBusEffects(bus, effects);
+	return true;
+}
+
+std::vector<std::string> Audio::getBusEffects(const std::string &bus) const
+{
+	return pool->getBusEffects(bus);
+}
+
+void Audio::setStaticCacheBudget(size_t bytes)
+{
+	staticCache.setBudget(bytes);
+}
+
+size_t Audio::getStaticCacheBudget() const
+{
+	return staticCache.getBudget();
+}
+
+size_t Audio::getStaticCacheSize() const
+{
+	return staticCache.getSize();
+}
+
+void Audio::clearStaticCache()
+{
+	staticCache.clear();
+}
+
+void Audio::setStreamingLatency(double seconds)
+{
+	pool->setStreamingLatency(seconds);
+}
+
+double Audio::getStreamingLatency() const
+{
+	return pool->getStreamingLatency();
+}
+
 bool Audio::isEFXsupported() const
 {
 #ifdef ALC_EXT_EFX
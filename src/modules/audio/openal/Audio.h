@@ -38,6 +38,7 @@
 #include "Source.h"
 #include "Effect.h"
 #include "Pool.h"
+#include "StaticBufferCache.h"
 #include "thread/threads.h"
 
 // OpenAL
@@ -73,7 +74,8 @@ public:
 	 * Gets the OpenAL format identifier based on number of
 	 * channels and bits.
 	 * @param channels.
-	 * @param bitDepth Either 8-bit samples, or 16-bit samples.
+	 * @param bitDepth 8-bit or 16-bit integer samples, or 32-bit float
+	 *        samples if AL_EXT_FLOAT32 is supported.
 	 * @return One of AL_FORMAT_*, or AL_NONE if unsupported format.
 	 **/
 	static ALenum getFormat(int bitDepth, int channels);
@@ -84,6 +86,8 @@ public:
 	// Implements Audio.
 	love::audio::Source *newSource(love::sound::Decoder *decoder);
 	love::audio::Source *newSource(love::sound::SoundData *soundData);
+	love::audio::Source *newSource(love::sound::SoundData *soundData, const std::string &cachekey);
+	love::audio::Source *newCachedSource(const std::string &cachekey);
 	love::audio::Source *newSource(int sampleRate, int bitDepth, int channels, int buffers);
 	int getActiveSourceCount() const;
 	int getMaxSources() const;
@@ -92,6 +96,7 @@ public:
 	void stop(love::audio::Source *source);
 	void stop(const std::vector<love::audio::Source*> &sources);
 	void stop();
+	void updateSources(const std::vector<love::audio::Source::SpatialUpdate> &updates);
 	void pause(love::audio::Source *source);
 	void pause(const std::vector<love::audio::Source*> &sources);
 	std::vector<love::audio::Source*> pause();
@@ -123,10 +128,30 @@ public:
 	int getMaxSourceEffects() const;
 	bool isEFXsupported() const;
 
+	void setStreamingLatency(double seconds);
+	double getStreamingLatency() const;
+
+	Stats getStats() const;
+	void resetStats();
+
+	void setBusVolume(const std::string &bus, float volume);
+	float getBusVolume(const std::string &bus) const;
+	bool setBusEffects(const std::string &bus, const std::vector<std::string> &effects);
+	std::vector<std::string> getBusEffects(const std::string &bus) const;
+
+	void setStaticCacheBudget(size_t bytes);
+	size_t getStaticCacheBudget() const;
+	size_t getStaticCacheSize() const;
+	void clearStaticCache();
+
 	bool getEffectID(const char *name, ALuint &id);
 
 private:
+
+	static ALenum getFloatFormat(int channels);
+
 	void initializeEFX();
+
 	// The OpenAL device.
 	ALCdevice *device;
 
@@ -150,6 +175,9 @@ private:
 	// The Pool.
 	Pool *pool;
 
+	// Decoded static audio shared by Sources loaded from the same file.
+	StaticBufferCache staticCache;
+
 	class PoolThread: public thread::Threadable
 	{
 	protected:
@@ -21,6 +21,12 @@
 #include "Pool.h"
 
 #include "Source.h"
+#include "timer/Timer.h"
+#include "common/profiling.h"
+
+// C++
+#include <algorithm>
+#include <cfloat>
 
 namespace love
 {
@@ -29,9 +35,16 @@ namespace audio
 namespace openal
 {
 
+constexpr double Pool::MIN_UPDATE_DELAY;
+constexpr double Pool::MAX_UPDATE_DELAY;
+
 Pool::Pool()
 	: sources()
 	, totalSources(0)
+	, lastVirtualUpdate(0.0)
+	, lastUpdateTime(0.0)
+	, streamingLatency(0.1)
+	, wakeRequested(false)
 {
 	// Clear errors.
 	alGetError();
@@ -99,20 +112,116 @@ bool Pool::isPlaying(Source *s)
 	return p;
 }
 
-void Pool::update()
+double Pool::update()
 {
-	thread::Lock lock(mutex);
+	LOVE_PROFILE_ZONE("Pool:update");
 
-	std::vector<Source *> torelease;
+	std::vector<Source *> decoding;
+
+	double start = timer::Timer::getTime();
 
-	for (const auto &i : playing)
 	{
-		if (!i.first->update())
-			torelease.push_back(i.first);
+		thread::Lock lock(mutex);
+		double locked = timer::Timer::getTime();
+
+		if (lastUpdateTime > 0.0)
+		{
+			double interval = start - lastUpdateTime;
+			stats.updates++;
+			stats.updateInterval += interval;
+			stats.maxUpdateInterval = std::max(stats.maxUpdateInterval, interval);
+		}
+
+		lastUpdateTime = start;
+
+		updateVirtualSources();
+
+		std::vector<Source *> torelease;
+
+		for (const auto &i : playing)
+		{
+			int underruns = i.first->getUnderrunCountAtomic();
+
+			if (!i.first->update())
+				torelease.push_back(i.first);
+			else if (i.first->prepareDecodeAtomic())
+			{
+				i.first->retain();
+				decoding.push_back(i.first);
+			}
+
+			stats.underruns += i.first->getUnderrunCountAtomic() - underruns;
+		}
+
+		for (Source *s : torelease)
+			releaseSource(s);
+
+		recordLockAtomic(locked - start, timer::Timer::getTime() - locked);
 	}
 
-	for (Source *s : torelease)
-		releaseSource(s);
+	// Decoding can take a while, so other threads can use the Pool meanwhile.
+	int decoded = 0;
+	double decodestart = timer::Timer::getTime();
+
+	for (Source *s : decoding)
+		decoded += s->decodeAhead();
+
+	double decodetime = timer::Timer::getTime() - decodestart;
+	double delay = MAX_UPDATE_DELAY;
+
+	start = timer::Timer::getTime();
+
+	{
+		thread::Lock lock(mutex);
+		double locked = timer::Timer::getTime();
+
+		stats.decodedBuffers += decoded;
+		stats.decodeTime += decodetime;
+
+		for (Source *s : decoding)
+			s->queueDecodedAtomic();
+
+		for (const auto &i : playing)
+			delay = std::min(delay, i.first->getUpdateDelay(streamingLatency));
+
+		recordLockAtomic(locked - start, timer::Timer::getTime() - locked);
+	}
+
+	for (Source *s : decoding)
+		s->release();
+
+	return std::max(delay, MIN_UPDATE_DELAY);
+}
+
+void Pool::waitForUpdate(double seconds)
+{
+	thread::Lock lock(mutex);
+
+	if (!wakeRequested)
+		cond->wait(mutex, std::max((int) (seconds * 1000), 1));
+
+	wakeRequested = false;
+}
+
+void Pool::wake()
+{
+	thread::Lock lock(mutex);
+	wakeRequested = true;
+	cond->signal();
+}
+
+void Pool::setStreamingLatency(double seconds)
+{
+	thread::Lock lock(mutex);
+	streamingLatency = std::max(seconds, 0.0);
+	wakeRequested = true;
+	cond->signal();
+}
+
+double Pool::getStreamingLatency() const
+{
+	thread::Lock lock(mutex);
+	return streamingLatency;
 }
 
 int Pool::getActiveSourceCount() const
@@ -125,6 +234,207 @@ int Pool::getMaxSources() const
 	return totalSources;
 }
 
+love::audio::Audio::Stats Pool::getStats() const
+{
+	thread::Lock lock(mutex);
+	return stats;
+}
+
+void Pool::resetStats()
+{
+	thread::Lock lock(mutex);
+	stats = love::audio::Audio::Stats();
+}
+
+void Pool::recordLockAtomic(double waited, double held)
+{
+	stats.lockWaitTime += waited;
+	stats.maxLockWaitTime = std::max(stats.maxLockWaitTime, waited);
+	stats.lockHoldTime += held;
+	stats.maxLockHoldTime = std::max(stats.maxLockHoldTime, held);
+}
+
+void Pool::setBusVolume(const std::string &bus, float volume)
+{
+	thread::Lock lock(mutex);
+
+	Bus &b = buses[bus];
+	b.volume = volume;
+
+	for (Source *s : b.sources)
+		s->applyBusAtomic(b.volume, b.effects);
+}
+
+float Pool::getBusVolume(const std::string &bus) const
+{
+	thread::Lock lock(mutex);
+
+	auto it = buses.find(bus);
+	return it != buses.end() ? it->second.volume : 1.0f;
+}
+
+void Pool::setBusEffects(const std::string &bus, const std::vector<std::string> &effects)
+{
+	thread::Lock lock(mutex);
+
+	Bus &b = buses[bus];
+	b.effects = effects;
+
+	for (Source *s : b.sources)
+		s->applyBusAtomic(b.volume, b.effects);
+}
+
+std::vector<std::string> Pool::getBusEffects(const std::string &bus) const
+{
+	thread::Lock lock(mutex);
+
+	auto it = buses.find(bus);
+	return it != buses.end() ? it->second.effects : std::vector<std::string>();
+}
+
+void Pool::moveSourceToBus(Source *source, const std::string &from, const std::string &to)
+{
+	if (!from.empty())
+	{
+		auto it = buses.find(from);
+		if (it != buses.end())
+		{
+			auto &sources = it->second.sources;
+			sources.erase(std::remove(sources.begin(), sources.end(), source), sources.end());
+		}
+	}
+
+	if (to.empty())
+	{
+		source->applyBusAtomic(1.0f, std::vector<std::string>());
+		return;
+	}
+
+	Bus &b = buses[to];
+	b.sources.push_back(source);
+	source->applyBusAtomic(b.volume, b.effects);
+}
+
+bool Pool::addVirtualSource(Source *source, double position, bool paused)
+{
+	if (!source->canBeVirtual())
+		return false;
+
+	source->makeVirtualAtomic(position, paused);
+
+	if (std::find(virtualSources.begin(), virtualSources.end(), source) == virtualSources.end())
+	{
+		source->retain();
+		virtualSources.push_back(source);
+	}
+
+	return true;
+}
+
+void Pool::removeVirtualSource(Source *source)
+{
+	auto it = std::find(virtualSources.begin(), virtualSources.end(), source);
+	if (it == virtualSources.end())
+		return;
+
+	virtualSources.erase(it);
+	source->release();
+}
+
+float Pool::getVirtualScore(Source *source, const float *listener) const
+{
+	// Paused Sources aren't heard, so they give up their voice first.
+	if (!source->isPlaying())
+		return -FLT_MAX;
+
+	// Audibility is in [0, 1], so priority always wins.
+	return (float) source->getPriority() + source->getAudibility(listener);
+}
+
+void Pool::updateVirtualSources()
+{
+	double now = love::timer::Timer::getTime();
+	double dt = lastVirtualUpdate > 0.0 ? now - lastVirtualUpdate : 0.0;
+	lastVirtualUpdate = now;
+
+	if (virtualSources.empty())
+		return;
+
+	std::vector<Source *> finished;
+	for (Source *s : virtualSources)
+	{
+		if (!s->advanceVirtualAtomic(dt))
+			finished.push_back(s);
+	}
+
+	for (Source *s : finished)
+		removeVirtualSource(s);
+
+	float listener[3] = {0.0f, 0.0f, 0.0f};
+	alGetListenerfv(AL_POSITION, listener);
+
+	std::vector<std::pair<float, Source *>> candidates;
+	for (Source *s : virtualSources)
+	{
+		if (!s->isVirtualPaused())
+			candidates.emplace_back(getVirtualScore(s, listener), s);
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [](const std::pair<float, Source *> &a, const std::pair<float, Source *> &b)
+	{
+		return a.first > b.first;
+	});
+
+	// Keeps two similar Sources from trading places every update.
+	const float hysteresis = 0.05f;
+
+	for (const auto &candidate : candidates)
+	{
+		Source *promoted = candidate.second;
+
+		if (available.empty())
+		{
+			Source *weakest = nullptr;
+			float weakestscore = FLT_MAX;
+
+			for (const auto &i : playing)
+			{
+				if (!i.first->canBeVirtual())
+					continue;
+
+				float score = getVirtualScore(i.first, listener);
+				if (score < weakestscore)
+				{
+					weakest = i.first;
+					weakestscore = score;
+				}
+			}
+
+			if (weakest == nullptr || weakestscore + hysteresis >= candidate.first)
+				break;
+
+			double position = weakest->getPlaybackTimeAtomic();
+			bool paused = !weakest->isPlaying();
+
+			// Keep the Source alive between losing its voice and going virtual.
+			weakest->retain();
+			releaseSource(weakest);
+			addVirtualSource(weakest, position, paused);
+			weakest->release();
+		}
+
+		ALuint out = 0;
+		char wasPlaying = 0;
+		if (!assignSource(promoted, out, wasPlaying))
+			break;
+
+		removeVirtualSource(promoted);
+
+		if (!promoted->promoteAtomic(out))
+			releaseSource(promoted);
+	}
+}
+
 bool Pool::assignSource(Source *source, ALuint &out, char &wasPlaying)
 {
 	out = 0;
@@ -142,6 +452,10 @@ bool Pool::assignSource(Source *source, ALuint &out, char &wasPlaying)
 
 	playing.insert(std::make_pair(source, out));
 	source->retain();
+
+	// The update thread may be sleeping for longer than this Source can wait.
+	wakeRequested = true;
+	cond->signal();
 	return true;
 }
 
@@ -181,9 +495,11 @@ thread::Lock Pool::lock()
 std::vector<love::audio::Source*> Pool::getPlayingSources()
 {
 	std::vector<love::audio::Source*> sources;
-	sources.reserve(playing.size());
+	sources.reserve(playing.size() + virtualSources.size());
 	for (auto &i : playing)
 		sources.push_back(i.first);
+	for (Source *s : virtualSources)
+		sources.push_back(s);
 	return sources;
 }
 
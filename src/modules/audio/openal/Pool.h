@@ -25,6 +25,7 @@
 #include <queue>
 #include <map>
 #include <vector>
+#include <string>
 #include <cmath>
 
 // LOVE
@@ -32,6 +33,7 @@
 #include "common/Exception.h"
 #include "thread/threads.h"
 #include "audio/Source.h"
+#include "audio/Audio.h"
 
 // OpenAL
 #ifdef LOVE_APPLE_USE_FRAMEWORKS
@@ -78,11 +80,41 @@ public:
 	 **/
 	bool isPlaying(Source *s);
 
-	void update();
+	/**
+	 * Updates all playing Sources.
+	 * @return How long (in seconds) until the next update is needed.
+	 **/
+	double update();
+
+	/**
+	 * Blocks until the given number of seconds has passed or wake is called.
+	 **/
+	void waitForUpdate(double seconds);
+
+	/**
+	 * Makes waitForUpdate return early, e.g. when playback changes.
+	 **/
+	void wake();
+
+	/**
+	 * Sets how much streamed audio (in seconds) the Pool tries to keep queued
+	 * in every streaming Source. Lower values mean the Pool sleeps longer
+	 * between updates, but leave less room for a late update.
+	 **/
+	void setStreamingLatency(double seconds);
+	double getStreamingLatency() const;
 
 	int getActiveSourceCount() const;
 	int getMaxSources() const;
 
+	love::audio::Audio::Stats getStats() const;
+	void resetStats();
+
+	void setBusVolume(const std::string &bus, float volume);
+	float getBusVolume(const std::string &bus) const;
+	void setBusEffects(const std::string &bus, const std::vector<std::string> &effects);
+	std::vector<std::string> getBusEffects(const std::string &bus) const;
+
 private:
 
 	friend class Source;
@@ -98,6 +130,34 @@ private:
 	bool assignSource(Source *source, ALuint &out, char &wasPlaying);
 	bool findSource(Source *source, ALuint &out);
 
+	bool addVirtualSource(Source *source, double position, bool paused);
+	void removeVirtualSource(Source *source);
+
+	/**
+	 * Advances virtual Sources, then gives free OpenAL sources to the most
+	 * important ones, taking them from less important playing Sources when
+	 * none are free.
+	 **/
+	void updateVirtualSources();
+
+	float getVirtualScore(Source *source, const float *listener) const;
+
+	/**
+	 * Moves a Source between mixer buses (an empty name means none) and
+	 * applies the new bus's settings to it.
+	 **/
+	void moveSourceToBus(Source *source, const std::string &from, const std::string &to);
+
+	// Records how long update waited for and then held the lock.
+	void recordLockAtomic(double waited, double held);
+
+	struct Bus
+	{
+		float volume = 1.0f;
+		std::vector<std::string> effects;
+		std::vector<Source *> sources;
+	};
+
 	// Maximum possible number of OpenAL sources the pool attempts to generate.
 	static const int MAX_SOURCES = 64;
 
@@ -113,10 +173,34 @@ private:
 	// A map of playing sources.
 	std::map<Source *, ALuint> playing;
 
+	// Playing Sources without an OpenAL source.
+	std::vector<Source *> virtualSources;
+
+	// When virtual Sources were last advanced.
+	double lastVirtualUpdate;
+
+	std::map<std::string, Bus> buses;
+
+	love::audio::Audio::Stats stats;
+
+	// When update last started.
+	double lastUpdateTime;
+
+	// Bounds for the time between updates.
+	static constexpr double MIN_UPDATE_DELAY = 0.001;
+	static constexpr double MAX_UPDATE_DELAY = 0.1;
+
+	double streamingLatency;
+
+	// Set by wake, cleared by waitForUpdate.
+	bool wakeRequested;
+
 	// Only one thread can access this object at the same time. This mutex will
 	// make sure of that.
 	love::thread::MutexRef mutex;
 
+	love::thread::ConditionalRef cond;
+
 }; // Pool
 
 } // openal
@@ -22,6 +22,9 @@
 #include "Audio.h"
 #include "sound/Sound.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace love
 {
 namespace audio
@@ -42,8 +45,51 @@ public:
 
 };
 
+RecordingDevice::CaptureThread::CaptureThread(RecordingDevice *device)
+	: device(device)
+	, finish(false)
+{
+	threadName = "AudioCapture";
+	threadPriority = PRIORITY_HIGH;
+}
+
+RecordingDevice::CaptureThread::~CaptureThread()
+{
+}
+
+void RecordingDevice::CaptureThread::setFinish()
+{
+	thread::Lock lock(mutex);
+	finish = true;
+	cond->signal();
+}
+
+void RecordingDevice::CaptureThread::threadFunction()
+{
+	// Poll twice per frame, so a frame waits at most half its length.
+	double frameseconds = (double) device->frameSamples / device->sampleRate;
+	int timeout = std::max((int) (frameseconds * 500), 1);
+
+	while (true)
+	{
+		device->captureFrames();
+
+		thread::Lock lock(mutex);
+		if (finish)
+			return;
+
+		cond->wait(mutex, timeout);
+
+		if (finish)
+			return;
+	}
+}
+
 RecordingDevice::RecordingDevice(const char *name) 
 	: name(name)
+	, writeIndex(0)
+	, readIndex(0)
+	, droppedFrames(0)
 {
 }
 
@@ -67,6 +113,12 @@ bool RecordingDevice::start(int samples, int sampleRate, int bitDepth, int chann
 	if (isRecording())
 		stop();
 
+	// The device has to hold a few frames while the capture thread sleeps.
+	if (frameSamples > 0)
+		samples = std::max(samples, frameSamples * 4);
+
+	thread::Lock l(deviceMutex);
+
 	device = alcCaptureOpenDevice(name.c_str(), sampleRate, format, samples);
 	if (device == nullptr)
 		return false;
@@ -78,6 +130,18 @@ bool RecordingDevice::start(int samples, int sampleRate, int bitDepth, int chann
 	this->bitDepth = bitDepth;
 	this->channels = channels;
 
+	if (frameSamples > 0)
+	{
+		ring.resize((size_t) getFrameBytes() * frameCount);
+		discard.resize(getFrameBytes());
+		writeIndex = 0;
+		readIndex = 0;
+		droppedFrames = 0;
+
+		captureThread = new CaptureThread(this);
+		captureThread->start();
+	}
+
 	return true;
 }
 
@@ -86,6 +150,16 @@ void RecordingDevice::stop()
 	if (!isRecording())
 		return;
 
+	if (captureThread != nullptr)
+	{
+		captureThread->setFinish();
+		captureThread->wait();
+		delete captureThread;
+		captureThread = nullptr;
+	}
+
+	thread::Lock l(deviceMutex);
+
 	alcCaptureStop(device);
 	alcCaptureCloseDevice(device);
 	device = nullptr;
@@ -96,6 +170,9 @@ love::sound::SoundData *RecordingDevice::getData()
 	if (!isRecording())
 		return nullptr;
 
+	if (captureThread != nullptr)
+		throw love::Exception("Can't get data from a RecordingDevice in frame mode, use readFrame instead.");
+
 	int samples = getSampleCount();
 	if (samples == 0)
 		return nullptr;
@@ -112,6 +189,8 @@ int RecordingDevice::getSampleCount() const
 	if (!isRecording())
 		return 0;
 
+	thread::Lock l(deviceMutex);
+
 	ALCint samples;
 	alcGetIntegerv(device, ALC_CAPTURE_SAMPLES, sizeof(ALCint), &samples);
 	return (int)samples;
@@ -147,6 +226,103 @@ bool RecordingDevice::isRecording() const
 	return device != nullptr;
 }
 
+void RecordingDevice::setFrameMode(int frameSamples, int frames, love::thread::Channel *channel)
+{
+	if (isRecording())
+		throw love::Exception("Can't change the frame mode of a RecordingDevice while it's recording.");
+
+	if (frameSamples < 0)
+		throw love::Exception("Invalid number of samples per frame.");
+
+	if (frames <= 0)
+		throw love::Exception("Invalid number of frames.");
+
+	this->frameSamples = frameSamples;
+	frameCount = frames;
+	frameChannel.set(channel);
+}
+
+int RecordingDevice::getFrameSamples() const
+{
+	return frameSamples;
+}
+
+int RecordingDevice::getFrameBytes() const
+{
+	return frameSamples * channels * (bitDepth / 8);
+}
+
+void RecordingDevice::captureFrames()
+{
+	uint64 captured = 0;
+
+	{
+		thread::Lock l(deviceMutex);
+
+		if (device == nullptr)
+			return;
+
+		ALCint available = 0;
+		alcGetIntegerv(device, ALC_CAPTURE_SAMPLES, 1, &available);
+
+		size_t framebytes = getFrameBytes();
+
+		for (; available >= frameSamples; available -= frameSamples)
+		{
+			uint64 w = writeIndex.load(std::memory_order_relaxed);
+			uint64 r = readIndex.load(std::memory_order_acquire);
+
+			if (w - r < (uint64) frameCount)
+			{
+				alcCaptureSamples(device, &ring[(w % frameCount) * framebytes], frameSamples);
+				writeIndex.store(w + 1, std::memory_order_release);
+				captured = w + 1;
+			}
+			else
+			{
+				// The reader is behind. Newer frames are dropped rather than
+				// overwriting the ones being read.
+				alcCaptureSamples(device, &discard[0], frameSamples);
+				droppedFrames++;
+			}
+		}
+	}
+
+	if (captured > 0 && frameChannel.get() != nullptr)
+		frameChannel->push(Variant((double) captured));
+}
+
+bool RecordingDevice::readFrame(love::sound::SoundData *dst)
+{
+	if (dst->getChannelCount() != channels || dst->getBitDepth() != bitDepth)
+		throw love::Exception("SoundData format doesn't match the RecordingDevice's.");
+
+	size_t framebytes = getFrameBytes();
+	if (dst->getSize() < framebytes)
+		throw love::Exception("SoundData must hold at least %d samples.", frameSamples);
+
+	uint64 r = readIndex.load(std::memory_order_relaxed);
+	uint64 w = writeIndex.load(std::memory_order_acquire);
+
+	if (r == w || ring.empty())
+		return false;
+
+	memcpy(dst->getData(), &ring[(r % frameCount) * framebytes], framebytes);
+	readIndex.store(r + 1, std::memory_order_release);
+
+	return true;
+}
+
+int RecordingDevice::getAvailableFrames() const
+{
+	return (int) (writeIndex.load() - readIndex.load());
+}
+
+int RecordingDevice::getDroppedFrames() const
+{
+	return droppedFrames.load();
+}
+
 } //openal
 } //audio
 } //love
@@ -38,6 +38,11 @@
 
 #include "audio/RecordingDevice.h"
 #include "sound/SoundData.h"
+#include "thread/threads.h"
+#include "common/int.h"
+
+#include <atomic>
+#include <vector>
 
 namespace love
 {
@@ -62,9 +67,35 @@ public:
 	virtual int getBitDepth() const;
 	virtual int getChannelCount() const;
 	virtual bool isRecording() const;
+	virtual void setFrameMode(int frameSamples, int frames, love::thread::Channel *channel);
+	virtual int getFrameSamples() const;
+	virtual bool readFrame(love::sound::SoundData *dst);
+	virtual int getAvailableFrames() const;
+	virtual int getDroppedFrames() const;
 
 private:
 
+	class CaptureThread : public thread::Threadable
+	{
+	public:
+		CaptureThread(RecordingDevice *device);
+		virtual ~CaptureThread();
+		void setFinish();
+		void threadFunction();
+
+	private:
+		RecordingDevice *device;
+		bool finish;
+		love::thread::MutexRef mutex;
+		love::thread::ConditionalRef cond;
+	};
+
+	// Moves whole frames from the device into the ring. Runs on the capture
+	// thread.
+	void captureFrames();
+
+	int getFrameBytes() const;
+
 	int samples = DEFAULT_SAMPLES;
 	int sampleRate = DEFAULT_SAMPLE_RATE;
 	int bitDepth = DEFAULT_BIT_DEPTH;
@@ -73,6 +104,23 @@ private:
 	std::string name;
 	ALCdevice *device = nullptr;
 
+	// Guards the device, which the capture thread reads from.
+	love::thread::MutexRef deviceMutex;
+
+	int frameSamples = 0;
+	int frameCount = DEFAULT_FRAMES;
+	StrongRef<love::thread::Channel> frameChannel;
+
+	// Single-producer single-consumer ring of frames. The capture thread only
+	// advances writeIndex and the reader only advances readIndex.
+	std::vector<char> ring;
+	std::vector<char> discard;
+	std::atomic<uint64> writeIndex;
+	std::atomic<uint64> readIndex;
+	std::atomic<int> droppedFrames;
+
+	CaptureThread *captureThread = nullptr;
+
 }; //RecordingDevice
 
 } //openal
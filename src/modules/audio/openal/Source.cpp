@@ -23,10 +23,12 @@
 #include "Pool.h"
 #include "Audio.h"
 #include "common/math.h"
+#include "timer/Timer.h"
 
 // STD
 #include <iostream>
 #include <algorithm>
+#include <limits>
 
 #define audiomodule() (Module::getInstance<Audio>(Module::M_AUDIO))
 
@@ -141,6 +143,24 @@ Source::Source(Pool *pool, love::sound::SoundData *soundData)
 		slotlist.push(i);
 }
 
+Source::Source(Pool *pool, StaticDataBuffer *buffer, int sampleRate, int bitDepth, int channels)
+	: love::audio::Source(Source::TYPE_STATIC)
+	, pool(pool)
+	, staticBuffer(buffer)
+	, sampleRate(sampleRate)
+	, channels(channels)
+	, bitDepth(bitDepth)
+{
+	float z[3] = {0, 0, 0};
+
+	setFloatv(position, z);
+	setFloatv(velocity, z);
+	setFloatv(direction, z);
+
+	for (unsigned int i = 0; i < (unsigned int)audiomodule()->getMaxSourceEffects(); i++)
+		slotlist.push(i);
+}
+
 Source::Source(Pool *pool, love::sound::Decoder *decoder)
 	: love::audio::Source(Source::TYPE_STREAM)
 	, pool(pool)
@@ -239,11 +259,24 @@ Source::Source(const Source &s)
 	, decoder(nullptr)
 	, toLoop(0)
 	, buffers(s.buffers)
+	, busVolume(s.busVolume)
+	, busEffects(s.busEffects)
 {
 	if (sourceType == TYPE_STREAM)
 	{
 		if (s.decoder.get())
+		{
+			Lock dl(s.decodeMutex);
 			decoder.set(s.decoder->clone(), Acquire::NORETAIN);
+
+			for (const QueuedDecoder &q : s.queuedDecoders)
+			{
+				QueuedDecoder copy;
+				copy.decoder.set(q.decoder->clone(), Acquire::NORETAIN);
+				copy.crossfadeBytes = q.crossfadeBytes;
+				queuedDecoders.push_back(copy);
+			}
+		}
 	}
 	if (sourceType != TYPE_STATIC)
 	{
@@ -274,6 +307,13 @@ Source::Source(const Source &s)
 	setFloatv(velocity, s.velocity);
 	setFloatv(direction, s.direction);
 
+	if (!s.bus.empty())
+	{
+		Lock l = pool->lock();
+		pool->moveSourceToBus(this, "", s.bus);
+		bus = s.bus;
+	}
+
 	for (unsigned int i = 0; i < (unsigned int)audiomodule()->getMaxSourceEffects(); i++)
 	{
 		// filter out already taken slots
@@ -293,6 +333,12 @@ Source::Source(const Source &s)
 
 Source::~Source()
 {
+	if (!bus.empty())
+	{
+		Lock l = pool->lock();
+		pool->moveSourceToBus(this, bus, "");
+	}
+
 	stop();
 
 	if (sourceType != TYPE_STATIC)
@@ -329,9 +375,20 @@ bool Source::play()
 	Lock l = pool->lock();
 	ALuint out;
 
+	if (virtualVoice)
+	{
+		virtualPaused = false;
+		return true;
+	}
+
 	char wasPlaying;
 	if (!pool->assignSource(this, out, wasPlaying))
-		return valid = false;
+	{
+		// Every OpenAL source is taken. Play virtually until the Pool finds
+		// one for this Source.
+		valid = false;
+		return pool->addVirtualSource(this, 0.0, false);
+	}
 
 	if (!wasPlaying)
 		return valid = playAtomic(out);
@@ -342,22 +399,35 @@ bool Source::play()
 
 void Source::stop()
 {
-	if (!valid)
+	if (!valid && !virtualVoice)
 		return;
 
 	Lock l = pool->lock();
-	pool->releaseSource(this);
+
+	if (virtualVoice)
+	{
+		virtualVoice = false;
+		virtualPaused = false;
+		pool->removeVirtualSource(this);
+	}
+	else
+		pool->releaseSource(this);
 }
 
 void Source::pause()
 {
 	Lock l = pool->lock();
-	if (pool->isPlaying(this))
+	if (virtualVoice)
+		virtualPaused = true;
+	else if (pool->isPlaying(this))
 		pauseAtomic();
 }
 
 bool Source::isPlaying() const
 {
+	if (virtualVoice)
+		return !virtualPaused;
+
 	if (!valid)
 		return false;
 
@@ -371,8 +441,15 @@ bool Source::isFinished() const
 	if (!valid)
 		return false;
 
-	if (sourceType == TYPE_STREAM && (isLooping() || !decoder->isFinished()))
-		return false;
+	if (sourceType == TYPE_STREAM)
+	{
+		if (isLooping())
+			return false;
+
+		Lock dl(decodeMutex);
+		if (!decoder->isFinished() || !queuedDecoders.empty() || !pendingData.empty())
+			return false;
+	}
 
 	ALenum state;
 	alGetSourcei(source, AL_SOURCE_STATE, &state);
@@ -399,7 +476,7 @@ bool Source::update()
 				ALint processed;
 				ALuint buffers[MAX_BUFFERS];
 				float curOffsetSamples, curOffsetSecs, newOffsetSamples, newOffsetSecs;
-				int freq = decoder->getSampleRate();
+				int freq = sampleRate;
 
 				alGetSourcef(source, AL_SAMPLE_OFFSET, &curOffsetSamples);
 				curOffsetSecs = curOffsetSamples / freq;
@@ -416,18 +493,18 @@ bool Source::update()
 				for (unsigned int i = 0; i < (unsigned int)processed; i++)
 					unusedBuffers.push(buffers[i]);
 
-				while (!unusedBuffers.empty())
+				// OpenAL stops a Source that plays all of its queued buffers.
+				ALint state;
+				alGetSourcei(source, AL_SOURCE_STATE, &state);
+				if (state == AL_STOPPED && !starved)
 				{
-					auto b = unusedBuffers.top();
-					if (streamAtomic(b, decoder.get()) > 0)
-					{
-						alSourceQueueBuffers(source, 1, &b);
-						unusedBuffers.pop();
-					}
-					else
-						break;
+					starved = true;
+					underruns++;
 				}
 
+				// The Pool refills the buffers with prepareDecodeAtomic,
+				// decodeAhead and queueDecodedAtomic, so decoding doesn't
+				// happen while the Pool is locked.
 				return true;
 			}
 			return false;
@@ -455,12 +532,261 @@ bool Source::update()
 	return false;
 }
 
+double Source::getUpdateDelay(double latency)
+{
+	if (!valid || pitch <= 0.0f)
+		return latency;
+
+	ALint queued = 0, processed = 0;
+	ALfloat offset = 0.0f;
+
+	switch (sourceType)
+	{
+	case TYPE_STATIC:
+	{
+		// Only the end needs to be noticed, so the Source can be released.
+		if (isLooping())
+			return std::numeric_limits<double>::max();
+
+		ALsizei samples = (staticBuffer->getSize() / channels) / (bitDepth / 8);
+		alGetSourcef(source, AL_SAMPLE_OFFSET, &offset);
+		return (samples - offset) / (sampleRate * pitch);
+	}
+	case TYPE_STREAM:
+	{
+		int bytespersample = decoder->getChannelCount() * (decoder->getBitDepth() / 8);
+		double buffersamples = (double) decoder->getSize() / bytespersample;
+		double rate = decoder->getSampleRate() * pitch;
+
+		alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+		alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
+		alGetSourcef(source, AL_SAMPLE_OFFSET, &offset);
+
+		// The last buffer before a loop or the end can be shorter than the
+		// decoder's buffer, so this is an estimate.
+		double remaining = ((queued - processed) * buffersamples - offset) / rate;
+
+		// Nothing left to decode: wait for playback to end.
+		if (!unusedBuffers.empty())
+			return remaining;
+
+		// No buffer can be refilled until the first one's done playing.
+		double firstdone = (buffersamples - offset) / rate;
+		return std::max(firstdone, remaining - latency);
+	}
+	case TYPE_QUEUE:
+	case TYPE_MAX_ENUM:
+		break;
+	}
+
+	// Queueable Sources are fed by the user, who expects free buffers to show
+	// up promptly.
+	return latency;
+}
+
+bool Source::isVirtual() const
+{
+	return virtualVoice;
+}
+
+StaticDataBuffer *Source::getStaticBuffer() const
+{
+	return staticBuffer.get();
+}
+
+void Source::setBus(const std::string &name)
+{
+	Lock l = pool->lock();
+
+	if (name == bus)
+		return;
+
+	pool->moveSourceToBus(this, bus, name);
+	bus = name;
+}
+
+void Source::queueDecoder(love::sound::Decoder *decoder, float crossfade)
+{
+	if (sourceType != TYPE_STREAM)
+		throw love::Exception("Only streaming Sources can queue Decoders.");
+
+	if (decoder->getSampleRate() != sampleRate || decoder->getBitDepth() != bitDepth || decoder->getChannelCount() != channels)
+		throw QueueFormatMismatchException();
+
+	QueuedDecoder next;
+	next.decoder.set(decoder);
+
+	int framesize = channels * (bitDepth / 8);
+	next.crossfadeBytes = (int) (std::max(crossfade, 0.0f) * sampleRate) * framesize;
+
+	Lock dl(decodeMutex);
+	queuedDecoders.push_back(std::move(next));
+}
+
+int Source::getQueuedDecoderCount() const
+{
+	Lock dl(decodeMutex);
+	return (int) queuedDecoders.size();
+}
+
+void Source::clearQueuedDecoders()
+{
+	Lock dl(decodeMutex);
+	queuedDecoders.clear();
+}
+
+void Source::applyBusAtomic(float volume, const std::vector<std::string> &effects)
+{
+	busVolume = volume;
+
+	if (valid)
+		alSourcef(source, AL_GAIN, this->volume * busVolume);
+
+	for (const std::string &effect : busEffects)
+	{
+		if (std::find(effects.begin(), effects.end(), effect) == effects.end())
+			unsetEffect(effect.c_str());
+	}
+
+	for (const std::string &effect : effects)
+	{
+		if (std::find(busEffects.begin(), busEffects.end(), effect) == busEffects.end())
+			setEffect(effect.c_str());
+	}
+
+	busEffects = effects;
+}
+
+bool Source::canBeVirtual() const
+{
+	// Queueable Sources are fed by the user, so there's no position to keep.
+	return sourceType != TYPE_QUEUE;
+}
+
+bool Source::isVirtualPaused() const
+{
+	return virtualPaused;
+}
+
+float Source::getAudibility(const float *listener) const
+{
+	float gain = volume * busVolume;
+
+	// Approximates OpenAL's inverse clamped distance model, which only
+	// applies to mono Sources.
+	if (channels == 1 && rolloffFactor > 0.0f)
+	{
+		float d[3];
+		for (int i = 0; i < 3; i++)
+			d[i] = relative ? position[i] : position[i] - listener[i];
+
+		float distance = sqrtf(d[0]*d[0] + d[1]*d[1] + d[2]*d[2]);
+		distance = std::min(std::max(distance, referenceDistance), maxDistance);
+
+		float denom = referenceDistance + rolloffFactor * (distance - referenceDistance);
+		if (denom > 0.0f)
+			gain *= referenceDistance / denom;
+	}
+
+	return std::min(std::max(gain, minVolume), maxVolume);
+}
+
+double Source::getPlaybackTimeAtomic()
+{
+	float offset = 0.0f;
+	if (valid)
+		alGetSourcef(source, AL_SEC_OFFSET, &offset);
+	return offset + offsetSeconds;
+}
+
+void Source::makeVirtualAtomic(double position, bool paused)
+{
+	virtualVoice = true;
+	virtualPaused = paused;
+	virtualPosition = position;
+	virtualDuration = 0.0;
+
+	if (sourceType == TYPE_STATIC)
+	{
+		ALsizei samples = (staticBuffer->getSize() / channels) / (bitDepth / 8);
+		virtualDuration = (double) samples / sampleRate;
+	}
+	else if (sourceType == TYPE_STREAM)
+	{
+		Lock dl(decodeMutex);
+		virtualDuration = decoder->getDuration();
+	}
+}
+
+bool Source::advanceVirtualAtomic(double dt)
+{
+	if (virtualPaused)
+		return true;
+
+	virtualPosition += dt * pitch;
+
+	// Streams with an unknown duration just keep going.
+	while (sourceType == TYPE_STREAM && virtualDuration > 0.0 && virtualPosition >= virtualDuration)
+	{
+		Lock dl(decodeMutex);
+		if (queuedDecoders.empty())
+			break;
+
+		decoder = queuedDecoders.front().decoder;
+		queuedDecoders.pop_front();
+		decoder->rewind();
+		pendingData.clear();
+
+		virtualPosition -= virtualDuration;
+		virtualDuration = decoder->getDuration();
+	}
+
+	if (virtualDuration > 0.0 && virtualPosition >= virtualDuration)
+	{
+		if (!isLooping())
+		{
+			virtualVoice = false;
+			return false;
+		}
+
+		virtualPosition = fmod(virtualPosition, virtualDuration);
+	}
+
+	return true;
+}
+
+bool Source::promoteAtomic(ALuint source)
+{
+	virtualVoice = false;
+
+	if (sourceType == TYPE_STREAM)
+	{
+		Lock dl(decodeMutex);
+		decoder->seek((float) virtualPosition);
+		decodeGeneration++;
+		pendingData.clear();
+	}
+
+	offsetSeconds = (float) virtualPosition;
+	offsetSamples = (float) (virtualPosition * sampleRate);
+
+	valid = playAtomic(source);
+
+	if (valid && virtualPaused)
+		pauseAtomic();
+
+	return valid;
+}
+
 void Source::setPitch(float pitch)
 {
 	if (valid)
 		alSourcef(source, AL_PITCH, pitch);
 
 	this->pitch = pitch;
+
+	// Playing faster can make a stream run out earlier than planned.
+	pool->wake();
 }
 
 float Source::getPitch() const
@@ -479,21 +805,14 @@ float Source::getPitch() const
 void Source::setVolume(float volume)
 {
 	if (valid)
-		alSourcef(source, AL_GAIN, volume);
+		alSourcef(source, AL_GAIN, volume * busVolume);
 
 	this->volume = volume;
 }
 
 float Source::getVolume() const
 {
-	if (valid)
-	{
-		ALfloat f;
-		alGetSourcef(source, AL_GAIN, &f);
-		return f;
-	}
-
-	// In case the Source isn't playing.
+	// AL_GAIN also includes the mixer bus's volume.
 	return volume;
 }
 
@@ -516,6 +835,12 @@ void Source::seek(float offset, Source::Unit unit)
 		break;
 	}
 
+	if (virtualVoice)
+	{
+		virtualPosition = offsetSeconds;
+		return;
+	}
+
 	bool wasPlaying = isPlaying();
 	switch (sourceType)
 	{
@@ -532,7 +857,12 @@ void Source::seek(float offset, Source::Unit unit)
 			if (valid)
 				stop();
 
-			decoder->seek(offsetSeconds);
+			{
+				Lock dl(decodeMutex);
+				decoder->seek(offsetSeconds);
+				decodeGeneration++;
+				pendingData.clear();
+			}
 
 			if (wasPlaying)
 				play();
@@ -586,6 +916,13 @@ float Source::tell(Source::Unit unit)
 
 	float offset = 0.0f;
 
+	if (virtualVoice)
+	{
+		if (unit == UNIT_SAMPLES)
+			return (float) (virtualPosition * sampleRate);
+		return (float) virtualPosition;
+	}
+
 	switch (unit)
 	{
 	case Source::UNIT_SAMPLES:
@@ -622,6 +959,8 @@ double Source::getDuration(Unit unit)
 	}
 	case TYPE_STREAM:
 	{
+		// Some decoders seek to find the duration.
+		Lock dl(decodeMutex);
 		double seconds = decoder->getDuration();
 
 		if (unit == UNIT_SECONDS)
@@ -838,10 +1177,12 @@ void Source::prepareAtomic()
 		alSourcei(source, AL_BUFFER, staticBuffer->getBuffer());
 		break;
 	case TYPE_STREAM:
+	{
+		Lock dl(decodeMutex);
 		while (!unusedBuffers.empty())
 		{
 			auto b = unusedBuffers.top();
-			if (streamAtomic(b, decoder.get()) == 0)
+			if (streamAtomic(b) == 0)
 				break;
 
 			alSourceQueueBuffers(source, 1, &b);
@@ -851,6 +1192,7 @@ void Source::prepareAtomic()
 				break;
 		}
 		break;
+	}
 	case TYPE_QUEUE:
 	{
 		while (!streamBuffers.empty())
@@ -876,7 +1218,14 @@ void Source::teardownAtomic()
 		ALint queued;
 		ALuint buffer;
 
-		decoder->seek(0);
+		{
+			// Anything decoded ahead is from the old position.
+			Lock dl(decodeMutex);
+			decoder->seek(0);
+			decodeGeneration++;
+			pendingData.clear();
+		}
+
 		// drain buffers
 		//since we only unqueue 1 buffer, it's OK to use singular variable pointer instead of array
 		alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
@@ -914,6 +1263,7 @@ void Source::teardownAtomic()
 bool Source::playAtomic(ALuint source)
 {
 	this->source = source;
+	starved = false;
 	prepareAtomic();
 
 	// Clear errors.
@@ -1032,6 +1382,47 @@ bool Source::play(const std::vector<love::audio::Source*> &sources)
 	return success;
 }
 
+void Source::update(const std::vector<love::audio::Source::SpatialUpdate> &updates)
+{
+	if (updates.size() == 0)
+		return;
+
+	// Don't apply anything if one of the Sources can't be positioned.
+	for (const auto &u : updates)
+	{
+		if (((Source *) u.source)->channels > 1)
+			throw SpatialSupportException();
+	}
+
+	Pool *pool = ((Source *) updates[0].source)->pool;
+	Lock l = pool->lock();
+
+	// Lets the implementation apply all changes together rather than one by
+	// one. Some implementations ignore this.
+	ALCcontext *context = alcGetCurrentContext();
+	if (context)
+		alcSuspendContext(context);
+
+	for (const auto &u : updates)
+	{
+		Source *source = (Source *) u.source;
+
+		source->setFloatv(source->position, u.position);
+		source->setFloatv(source->velocity, u.velocity);
+		source->volume = u.volume;
+
+		if (source->valid)
+		{
+			alSourcefv(source->source, AL_POSITION, source->position);
+			alSourcefv(source->source, AL_VELOCITY, source->velocity);
+			alSourcef(source->source, AL_GAIN, source->volume * source->busVolume);
+		}
+	}
+
+	if (context)
+		alcProcessContext(context);
+}
+
 void Source::stop(const std::vector<love::audio::Source*> &sources)
 {
 	if (sources.size() == 0)
@@ -1054,6 +1445,13 @@ void Source::stop(const std::vector<love::audio::Source*> &sources)
 	for (auto &_source : sources)
 	{
 		Source *source = (Source*) _source;
+		if (source->virtualVoice)
+		{
+			source->virtualVoice = false;
+			source->virtualPaused = false;
+			pool->removeVirtualSource(source);
+			continue;
+		}
 		if (source->valid)
 			source->teardownAtomic();
 		pool->releaseSource(source, false);
@@ -1074,6 +1472,8 @@ void Source::pause(const std::vector<love::audio::Source*> &sources)
 		Source *source = (Source*) _source;
 		if (source->valid)
 			sourceIds.push_back(source->source);
+		else if (source->virtualVoice)
+			source->virtualPaused = true;
 	}
 
 	alSourcePausev((ALsizei) sourceIds.size(), &sourceIds[0]);
@@ -1106,7 +1506,7 @@ void Source::reset()
 	alSourcefv(source, AL_VELOCITY, velocity);
 	alSourcefv(source, AL_DIRECTION, direction);
 	alSourcef(source, AL_PITCH, pitch);
-	alSourcef(source, AL_GAIN, volume);
+	alSourcef(source, AL_GAIN, volume * busVolume);
 	alSourcef(source, AL_MIN_GAIN, minVolume);
 	alSourcef(source, AL_MAX_GAIN, maxVolume);
 	alSourcef(source, AL_REFERENCE_DISTANCE, referenceDistance);
@@ -1138,23 +1538,33 @@ void Source::setFloatv(float *dst, const float *src) const
 	dst[2] = src[2];
 }
 
-int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
+int Source::streamAtomic(ALuint buffer)
 {
 	// Get more sound data.
-	int decoded = std::max(d->decode(), 0);
+	decodeChunk(streamChunk);
+	int decoded = bufferDataAtomic(buffer, streamChunk.data.data(), (int) streamChunk.data.size());
 
+	advanceLoopAtomic(streamChunk.rewound);
+	return decoded;
+}
+
+int Source::bufferDataAtomic(ALuint buffer, const void *data, int size)
+{
 	// OpenAL implementations are allowed to ignore 0-size alBufferData calls.
-	if (decoded > 0)
-	{
-		int fmt = Audio::getFormat(d->getBitDepth(), d->getChannelCount());
+	if (size <= 0)
+		return 0;
 
-		if (fmt != AL_NONE)
-			alBufferData(buffer, fmt, d->getBuffer(), decoded, d->getSampleRate());
-		else
-			decoded = 0;
-	}
+	int fmt = Audio::getFormat(bitDepth, channels);
+	if (fmt == AL_NONE)
+		return 0;
 
-	if (decoder->isFinished() && isLooping())
+	alBufferData(buffer, fmt, data, size, sampleRate);
+	return size;
+}
+
+void Source::advanceLoopAtomic(bool rewound)
+{
+	if (rewound)
 	{
 		int queued, processed;
 		alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
@@ -1163,7 +1573,6 @@ int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
 			toLoop = queued-processed;
 		else
 			toLoop = buffers-processed;
-		d->rewind();
 	}
 
 	if (toLoop > 0)
@@ -1174,8 +1583,284 @@ int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
 			offsetSeconds = 0;
 		}
 	}
+}
 
-	return decoded;
+bool Source::prepareDecodeAtomic()
+{
+	if (!valid || sourceType != TYPE_STREAM)
+		return false;
+
+	Lock dl(decodeMutex);
+
+	// The next Decoder gets its first buffer decoded well before it's needed.
+	bool preroll = !queuedDecoders.empty() && !queuedDecoders.front().prerolled;
+
+	if (unusedBuffers.empty() && !preroll)
+		return false;
+
+	if (decoder->isFinished() && !isLooping() && queuedDecoders.empty() && pendingData.empty())
+		return false;
+
+	decodeRequest = (int) unusedBuffers.size();
+	requestGeneration = decodeGeneration;
+	return true;
+}
+
+int Source::decodeAhead()
+{
+	Lock dl(decodeMutex);
+
+	// The Source was stopped or seeked since the request.
+	if (requestGeneration != decodeGeneration)
+		return 0;
+
+	int count = decodedCount;
+
+	for (int i = 0; i < decodeRequest; i++)
+	{
+		if ((int) decodedChunks.size() <= decodedCount)
+			decodedChunks.emplace_back();
+
+		DecodedChunk &chunk = decodedChunks[decodedCount++];
+
+		double start = love::timer::Timer::getTime();
+		decodeChunk(chunk);
+		decodeTime += love::timer::Timer::getTime() - start;
+		decodedBuffers++;
+
+		if (chunk.data.empty())
+			break;
+	}
+
+	if (!queuedDecoders.empty() && !queuedDecoders.front().prerolled)
+	{
+		double start = love::timer::Timer::getTime();
+		prerollQueuedDecoder();
+		decodeTime += love::timer::Timer::getTime() - start;
+		decodedBuffers++;
+	}
+
+	return decodedCount - count;
+}
+
+// Equal-power crossfade from the end of one Decoder into the start of the
+// next, written over the start of the next.
+template <typename T>
+static void crossfadeSamples(const T *from, T *to, int frames, int channels, float zero, float lo, float hi)
+{
+	for (int i = 0; i < frames; i++)
+	{
+		float t = (i + 0.5f) / frames;
+		float fromgain = cosf(t * (float) LOVE_M_PI_2);
+		float togain = sinf(t * (float) LOVE_M_PI_2);
+
+		for (int c = 0; c < channels; c++)
+		{
+			int s = i * channels + c;
+			float v = (from[s] - zero) * fromgain + (to[s] - zero) * togain;
+			to[s] = (T) (std::min(std::max(v, lo), hi) + zero);
+		}
+	}
+}
+
+void Source::prerollQueuedDecoder()
+{
+	QueuedDecoder &next = queuedDecoders.front();
+	love::sound::Decoder *d = next.decoder.get();
+
+	int decoded = std::max(d->decode(), 0);
+	const char *buffer = (const char *) d->getBuffer();
+	next.preroll.assign(buffer, buffer + decoded);
+	next.prerolled = true;
+}
+
+void Source::decodeChunk(DecodedChunk &chunk)
+{
+	chunk.rewound = false;
+	chunk.data.clear();
+
+	while (true)
+	{
+		// Data held back last time goes first.
+		chunk.data.swap(pendingData);
+		pendingData.clear();
+
+		// The end of the current Decoder is held back from each chunk, so it's
+		// still around to crossfade when the Decoder runs out.
+		int holdback = queuedDecoders.empty() ? 0 : queuedDecoders.front().crossfadeBytes;
+
+		bool finished = false;
+		while (!finished && (int) chunk.data.size() <= holdback)
+		{
+			int decoded = std::max(decoder->decode(), 0);
+			const char *buffer = (const char *) decoder->getBuffer();
+			chunk.data.insert(chunk.data.end(), buffer, buffer + decoded);
+			finished = decoded == 0 || decoder->isFinished();
+		}
+
+		if (!finished)
+		{
+			if (holdback > 0)
+			{
+				pendingData.assign(chunk.data.end() - holdback, chunk.data.end());
+				chunk.data.resize(chunk.data.size() - holdback);
+			}
+			return;
+		}
+
+		if (queuedDecoders.empty())
+		{
+			if (isLooping())
+			{
+				decoder->rewind();
+				chunk.rewound = true;
+			}
+			return;
+		}
+
+		// Hand off to the next Decoder, right after the last sample of this
+		// one. Playback position restarts once this chunk has played.
+		if (!queuedDecoders.front().prerolled)
+			prerollQueuedDecoder();
+
+		QueuedDecoder next = std::move(queuedDecoders.front());
+		queuedDecoders.pop_front();
+
+		decoder = next.decoder;
+		pendingData.swap(next.preroll);
+		chunk.rewound = true;
+
+		int overlap = std::min(holdback, (int) chunk.data.size());
+		if (overlap > 0)
+		{
+			while ((int) pendingData.size() < overlap && !decoder->isFinished())
+			{
+				int decoded = std::max(decoder->decode(), 0);
+				if (decoded == 0)
+					break;
+
+				const char *buffer = (const char *) decoder->getBuffer();
+				pendingData.insert(pendingData.end(), buffer, buffer + decoded);
+			}
+
+			// A next Decoder that's shorter than the crossfade just ends it early.
+			overlap = std::min(overlap, (int) pendingData.size());
+
+			int framesize = channels * (bitDepth / 8);
+			int frames = overlap / framesize;
+			const char *from = chunk.data.data() + chunk.data.size() - overlap;
+
+			if (bitDepth == 8)
+				crossfadeSamples((const uint8 *) from, (uint8 *) pendingData.data(), frames, channels, 128.0f, -128.0f, 127.0f);
+			else if (bitDepth == 16)
+				crossfadeSamples((const int16 *) from, (int16 *) pendingData.data(), frames, channels, 0.0f, -32768.0f, 32767.0f);
+			else
+				crossfadeSamples((const float *) from, (float *) pendingData.data(), frames, channels, 0.0f, -1.0f, 1.0f);
+
+			chunk.data.resize(chunk.data.size() - overlap);
+		}
+
+		// All of the previous Decoder's remaining data was crossfaded, so this
+		// chunk starts with the next one instead.
+		if (!chunk.data.empty())
+			return;
+	}
+}
+
+void Source::queueDecodedAtomic()
+{
+	Lock dl(decodeMutex);
+
+	int count = decodedCount;
+	decodedCount = 0;
+
+	if (!valid || requestGeneration != decodeGeneration)
+		return;
+
+	for (int i = 0; i < count && !unusedBuffers.empty(); i++)
+	{
+		const DecodedChunk &chunk = decodedChunks[i];
+
+		auto b = unusedBuffers.top();
+		int size = bufferDataAtomic(b, chunk.data.data(), (int) chunk.data.size());
+		advanceLoopAtomic(chunk.rewound);
+
+		if (size == 0)
+			break;
+
+		alSourceQueueBuffers(source, 1, &b);
+		unusedBuffers.pop();
+	}
+
+	if (starved)
+	{
+		ALint queued = 0;
+		alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+
+		if (queued > 0)
+		{
+			starved = false;
+			alSourcePlay(source);
+		}
+	}
+}
+
+Source::Stats Source::getStats() const
+{
+	Stats s;
+
+	{
+		Lock l = pool->lock();
+
+		s.underruns = underruns;
+
+		if (valid && !virtualVoice)
+		{
+			ALint queued = 0, processed = 0;
+			ALfloat offset = 0.0f;
+
+			alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+			alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
+			alGetSourcef(source, AL_SAMPLE_OFFSET, &offset);
+
+			if (sourceType == TYPE_STATIC)
+			{
+				ALsizei samples = (staticBuffer->getSize() / channels) / (bitDepth / 8);
+				s.queuedTime = (samples - offset) / sampleRate;
+			}
+			else if (sourceType == TYPE_STREAM)
+			{
+				// The decoder can be swapped for a queued one while decoding ahead.
+				int buffersize = 0;
+				{
+					Lock dl(decodeMutex);
+					buffersize = decoder->getSize();
+				}
+
+				int bytespersample = channels * (bitDepth / 8);
+				double buffersamples = (double) buffersize / bytespersample;
+				s.queuedTime = ((queued - processed) * buffersamples - offset) / sampleRate;
+			}
+			else if (sourceType == TYPE_QUEUE)
+			{
+				int bytespersample = channels * (bitDepth / 8);
+				s.queuedTime = ((double) bufferedBytes / bytespersample - offset) / sampleRate;
+			}
+
+			s.queuedTime = std::max(s.queuedTime, 0.0);
+		}
+	}
+
+	Lock dl(decodeMutex);
+	s.decodedBuffers = decodedBuffers;
+	s.decodeTime = decodeTime;
+
+	return s;
+}
+
+int Source::getUnderrunCountAtomic() const
+{
+	return underruns;
 }
 
 void Source::setMinVolume(float volume)
@@ -28,12 +28,14 @@
 #include "audio/Filter.h"
 #include "sound/SoundData.h"
 #include "sound/Decoder.h"
+#include "thread/threads.h"
 #include "Audio.h"
 #include "Filter.h"
 
 // STL
 #include <vector>
 #include <stack>
+#include <deque>
 
 // C
 #include <float.h>
@@ -99,6 +101,7 @@ class Source : public love::audio::Source
 public:
 
 	Source(Pool *pool, love::sound::SoundData *soundData);
+	Source(Pool *pool, StaticDataBuffer *buffer, int sampleRate, int bitDepth, int channels);
 	Source(Pool *pool, love::sound::Decoder *decoder);
 	Source(Pool *pool, int sampleRate, int bitDepth, int channels, int buffers);
 	Source(const Source &s);
@@ -111,6 +114,58 @@ public:
 	virtual bool isPlaying() const;
 	virtual bool isFinished() const;
 	virtual bool update();
+
+	/**
+	 * Estimates how long (in seconds) the Pool can wait before this Source
+	 * needs another update, given how much audio should stay queued. Must be
+	 * called with the Pool locked.
+	 **/
+	double getUpdateDelay(double latency);
+
+	/**
+	 * Streaming Sources are refilled in three steps, so the decoding doesn't
+	 * block other threads that need the Pool:
+	 * prepareDecodeAtomic (Pool locked) records how much to decode and returns
+	 * whether there's anything to do, decodeAhead (Pool unlocked) decodes into
+	 * staging memory, and queueDecodedAtomic (Pool locked) hands the data to
+	 * OpenAL. Data decoded before a seek or stop is dropped.
+	 **/
+	bool prepareDecodeAtomic();
+	int decodeAhead();
+	void queueDecodedAtomic();
+
+	Stats getStats() const;
+	int getUnderrunCountAtomic() const;
+
+	virtual bool isVirtual() const;
+
+	StaticDataBuffer *getStaticBuffer() const;
+
+	virtual void setBus(const std::string &name);
+
+	virtual void queueDecoder(love::sound::Decoder *decoder, float crossfade);
+	virtual int getQueuedDecoderCount() const;
+	virtual void clearQueuedDecoders();
+
+	/**
+	 * Applies a mixer bus's volume and effects. Called by the Pool with its
+	 * lock held.
+	 **/
+	void applyBusAtomic(float volume, const std::vector<std::string> &effects);
+
+	/**
+	 * Virtual voice handling, used by the Pool with its lock held. A virtual
+	 * Source has no OpenAL source, but its position keeps advancing so it can
+	 * resume at the right spot once it gets one.
+	 **/
+	bool canBeVirtual() const;
+	bool isVirtualPaused() const;
+	float getAudibility(const float *listener) const;
+	double getPlaybackTimeAtomic();
+	void makeVirtualAtomic(double position, bool paused);
+	bool advanceVirtualAtomic(double dt);
+	bool promoteAtomic(ALuint source);
+
 	virtual void setPitch(float pitch);
 	virtual float getPitch() const;
 	virtual void setVolume(float volume);
@@ -168,6 +223,7 @@ public:
 	static bool play(const std::vector<love::audio::Source*> &sources);
 	static void stop(const std::vector<love::audio::Source*> &sources);
 	static void pause(const std::vector<love::audio::Source*> &sources);
+	static void update(const std::vector<love::audio::Source::SpatialUpdate> &updates);
 
 	static std::vector<love::audio::Source*> pause(Pool *pool);
 	static void stop(Pool *pool);
@@ -178,7 +234,9 @@ private:
 
 	void setFloatv(float *dst, const float *src) const;
 
-	int streamAtomic(ALuint buffer, love::sound::Decoder *d);
+	int streamAtomic(ALuint buffer);
+	int bufferDataAtomic(ALuint buffer, const void *data, int size);
+	void advanceLoopAtomic(bool rewound);
 
 	Pool *pool = nullptr;
 	ALuint source = 0;
@@ -222,10 +280,68 @@ private:
 
 	StrongRef<love::sound::Decoder> decoder;
 
+	// Guards the decoder, which decodeAhead uses without the Pool's lock.
+	love::thread::MutexRef decodeMutex;
+
+	struct DecodedChunk
+	{
+		std::vector<char> data;
+		bool rewound = false;
+	};
+
+	struct QueuedDecoder
+	{
+		StrongRef<love::sound::Decoder> decoder;
+		int crossfadeBytes = 0;
+		std::vector<char> preroll;
+		bool prerolled = false;
+	};
+
+	/**
+	 * Decodes the next part of the stream, handing off to the next queued
+	 * Decoder when the current one ends. Must be called with decodeMutex
+	 * locked.
+	 **/
+	void decodeChunk(DecodedChunk &chunk);
+	void prerollQueuedDecoder();
+
+	// Decoders to play after the current one, and decoded data held back
+	// from the current one so it can be crossfaded with the next. Guarded by
+	// decodeMutex.
+	std::deque<QueuedDecoder> queuedDecoders;
+	std::vector<char> pendingData;
+
+	// Staging memory for decodeAhead, reused between updates.
+	std::vector<DecodedChunk> decodedChunks;
+	DecodedChunk streamChunk;
+	int decodedCount = 0;
+	int decodeRequest = 0;
+
+	// Set when a stream ran dry and stopped, so it's restarted once refilled.
+	bool starved = false;
+	int underruns = 0;
+
+	// Guarded by decodeMutex.
+	int decodedBuffers = 0;
+	double decodeTime = 0.0;
+
+	// Bumped whenever the decoder's position jumps.
+	uint32 decodeGeneration = 0;
+	uint32 requestGeneration = 0;
+
+	bool virtualVoice = false;
+	bool virtualPaused = false;
+	double virtualPosition = 0.0;
+	double virtualDuration = 0.0;
+
 	unsigned int toLoop = 0;
 	ALsizei bufferedBytes = 0;
 	int buffers = 0;
 
+	// The mixer bus's volume, and the effects it added to this Source.
+	float busVolume = 1.0f;
+	std::vector<std::string> busEffects;
+
 	Filter *directfilter = nullptr;
 
 	struct EffectMapStorage
@@ -0,0 +1,132 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "StaticBufferCache.h"
+#include "Source.h"
+
+namespace love
+{
+namespace audio
+{
+namespace openal
+{
+
+StaticBufferCache::StaticBufferCache(size_t budget)
+	: size(0)
+	, budget(budget)
+	, useCounter(0)
+{
+}
+
+StaticBufferCache::~StaticBufferCache()
+{
+}
+
+bool StaticBufferCache::find(const std::string &key, Entry &out)
+{
+	thread::Lock lock(mutex);
+
+	auto it = entries.find(key);
+	if (it == entries.end())
+		return false;
+
+	it->second.lastUse = ++useCounter;
+	out = it->second;
+	return true;
+}
+
+void StaticBufferCache::insert(const std::string &key, const Entry &entry)
+{
+	thread::Lock lock(mutex);
+
+	// Nothing would stay cached with a budget of 0.
+	if (budget == 0 || entry.buffer.get() == nullptr)
+		return;
+
+	auto it = entries.find(key);
+	if (it != entries.end())
+	{
+		size -= it->second.buffer->getSize();
+		entries.erase(it);
+	}
+
+	Entry &e = entries[key];
+	e = entry;
+	e.lastUse = ++useCounter;
+	size += e.buffer->getSize();
+
+	evict();
+}
+
+void StaticBufferCache::setBudget(size_t bytes)
+{
+	thread::Lock lock(mutex);
+	budget = bytes;
+	evict();
+}
+
+size_t StaticBufferCache::getBudget() const
+{
+	thread::Lock lock(mutex);
+	return budget;
+}
+
+size_t StaticBufferCache::getSize() const
+{
+	thread::Lock lock(mutex);
+	return size;
+}
+
+void StaticBufferCache::clear()
+{
+	thread::Lock lock(mutex);
+	entries.clear();
+	size = 0;
+}
+
+void StaticBufferCache::evict()
+{
+	while (size > budget && !entries.empty())
+	{
+		// Prefer buffers no Source uses, since dropping them frees memory.
+		auto victim = entries.end();
+		bool victimunused = false;
+
+		for (auto it = entries.begin(); it != entries.end(); ++it)
+		{
+			bool unused = it->second.buffer->getReferenceCount() == 1;
+
+			if (victim == entries.end()
+				|| (unused && !victimunused)
+				|| (unused == victimunused && it->second.lastUse < victim->second.lastUse))
+			{
+				victim = it;
+				victimunused = unused;
+			}
+		}
+
+		size -= victim->second.buffer->getSize();
+		entries.erase(victim);
+	}
+}
+
+} // openal
+} // audio
+} // love
@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_AUDIO_OPENAL_STATIC_BUFFER_CACHE_H
+#define LOVE_AUDIO_OPENAL_STATIC_BUFFER_CACHE_H
+
+// LOVE
+#include "common/config.h"
+#include "common/int.h"
+#include "common/Object.h"
+#include "thread/threads.h"
+
+// C++
+#include <string>
+#include <unordered_map>
+
+namespace love
+{
+namespace audio
+{
+namespace openal
+{
+
+class StaticDataBuffer;
+
+/**
+ * Shares decoded static audio between Sources loaded from the same file, so
+ * it's decoded and uploaded to OpenAL once. Entries not used by any Source
+ * are evicted (least recently used first) when the cache goes over budget.
+ **/
+class StaticBufferCache
+{
+public:
+
+	struct Entry
+	{
+		StrongRef<StaticDataBuffer> buffer;
+		int sampleRate = 0;
+		int bitDepth = 0;
+		int channels = 0;
+		uint64 lastUse = 0;
+	};
+
+	StaticBufferCache(size_t budget);
+	~StaticBufferCache();
+
+	bool find(const std::string &key, Entry &out);
+	void insert(const std::string &key, const Entry &entry);
+
+	void setBudget(size_t bytes);
+	size_t getBudget() const;
+
+	/**
+	 * Gets the total size of all cached buffers, in bytes.
+	 **/
+	size_t getSize() const;
+
+	void clear();
+
+private:
+
+	void evict();
+
+	std::unordered_map<std::string, Entry> entries;
+
+	size_t size;
+	size_t budget;
+	uint64 useCounter;
+
+	love::thread::MutexRef mutex;
+
+}; // StaticBufferCache
+
+} // openal
+} // audio
+} // love
+
+#endif // LOVE_AUDIO_OPENAL_STATIC_BUFFER_CACHE_H
@@ -54,16 +54,40 @@ int w_newSource(lua_State *L)
 			return luax_enumerror(L, "source type", Source::getConstants(stype), stypestr);
 	}
 
+	Source *t = nullptr;
+
+	// Static Sources loaded from a file share decoded audio through a cache,
+	// keyed by the file's path.
+	std::string cachekey;
+	if (stype == Source::TYPE_STATIC)
+	{
+		if (lua_type(L, 1) == LUA_TSTRING)
+			cachekey = luax_checkstring(L, 1);
+		else if (luax_istype(L, 1, love::filesystem::File::type))
+			cachekey = luax_totype<love::filesystem::File>(L, 1)->getFilename();
+
+		if (!cachekey.empty())
+		{
+			luax_catchexcept(L, [&]() { t = instance()->newCachedSource(cachekey); });
+			if (t != nullptr)
+			{
+				luax_pushtype(L, t);
+				t->release();
+				return 1;
+			}
+		}
+	}
+
 	if (lua_isstring(L, 1) || luax_istype(L, 1, love::filesystem::File::type) || luax_istype(L, 1, love::filesystem::FileData::type))
 		luax_convobj(L, 1, "sound", "newDecoder");
 
 	if (stype == Source::TYPE_STATIC && luax_istype(L, 1, love::sound::Decoder::type))
 		luax_convobj(L, 1, "sound", "newSoundData");
 
-	Source *t = nullptr;
-
 	luax_catchexcept(L, [&]() {
-		if (luax_istype(L, 1, love::sound::SoundData::type))
+		if (luax_istype(L, 1, love::sound::SoundData::type) && !cachekey.empty())
+			t = instance()->newSource(luax_totype<love::sound::SoundData>(L, 1), cachekey);
+		else if (luax_istype(L, 1, love::sound::SoundData::type))
 			t = instance()->newSource(luax_totype<love::sound::SoundData>(L, 1));
 		else if (luax_istype(L, 1, love::sound::Decoder::type))
 			t = instance()->newSource(luax_totype<love::sound::Decoder>(L, 1));
@@ -162,6 +186,42 @@ int w_stop(lua_State *L)
 	return 0;
 }
 
+int w_updateSources(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	luaL_checktype(L, 2, LUA_TTABLE);
+
+	// Each Source takes 7 values: x, y, z, vx, vy, vz, volume.
+	const int stride = 7;
+
+	std::vector<Source *> sources = readSourceList(L, 1);
+	std::vector<Source::SpatialUpdate> updates(sources.size());
+
+	if ((int) luax_objlen(L, 2) < (int) sources.size() * stride)
+		return luaL_error(L, "Expected %d values for %d Sources.", (int) sources.size() * stride, (int) sources.size());
+
+	for (int i = 0; i < (int) sources.size(); i++)
+	{
+		Source::SpatialUpdate &u = updates[i];
+		u.source = sources[i];
+
+		for (int j = 0; j < stride; j++)
+			lua_rawgeti(L, 2, i * stride + j + 1);
+
+		for (int j = 0; j < 3; j++)
+		{
+			u.position[j] = (float) luaL_checknumber(L, -7 + j);
+			u.velocity[j] = (float) luaL_checknumber(L, -4 + j);
+		}
+
+		u.volume = (float) luaL_checknumber(L, -1);
+		lua_pop(L, stride);
+	}
+
+	luax_catchexcept(L, [&]() { instance()->updateSources(updates); });
+	return 0;
+}
+
 int w_pause(lua_State *L)
 {
 	if (lua_isnone(L, 1))
@@ -521,6 +581,151 @@ int w_isEffectsSupported(lua_State *L)
 	return 1;
 }
 
+int w_setStaticCacheBudget(lua_State *L)
+{
+	lua_Number bytes = luaL_checknumber(L, 1);
+	if (bytes < 0)
+		return luaL_error(L, "Cache budget must not be negative.");
+
+	instance()->setStaticCacheBudget((size_t) bytes);
+	return 0;
+}
+
+int w_getStaticCacheBudget(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getStaticCacheBudget());
+	return 1;
+}
+
+int w_getStaticCacheSize(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getStaticCacheSize());
+	return 1;
+}
+
+int w_clearStaticCache(lua_State *)
+{
+	instance()->clearStaticCache();
+	return 0;
+}
+
+int w_setBusVolume(lua_State *L)
+{
+	std::string bus = luax_checkstring(L, 1);
+	float volume = (float) luaL_checknumber(L, 2);
+	instance()->setBusVolume(bus, volume);
+	return 0;
+}
+
+int w_getBusVolume(lua_State *L)
+{
+	std::string bus = luax_checkstring(L, 1);
+	lua_pushnumber(L, instance()->getBusVolume(bus));
+	return 1;
+}
+
+int w_setBusEffects(lua_State *L)
+{
+	std::string bus = luax_checkstring(L, 1);
+	std::vector<std::string> effects;
+
+	if (!lua_isnoneornil(L, 2))
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+		for (int i = 1; i <= (int) luax_objlen(L, 2); i++)
+		{
+			lua_rawgeti(L, 2, i);
+			effects.push_back(luax_checkstring(L, -1));
+			lua_pop(L, 1);
+		}
+	}
+
+	luax_pushboolean(L, instance()->setBusEffects(bus, effects));
+	return 1;
+}
+
+int w_getBusEffects(lua_State *L)
+{
+	std::string bus = luax_checkstring(L, 1);
+	std::vector<std::string> effects = instance()->getBusEffects(bus);
+
+	lua_createtable(L, (int) effects.size(), 0);
+	for (int i = 0; i < (int) effects.size(); i++)
+	{
+		luax_pushstring(L, effects[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
+int w_getStats(lua_State *L)
+{
+	Audio::Stats stats = instance()->getStats();
+
+	if (lua_istable(L, 1))
+		lua_pushvalue(L, 1);
+	else
+		lua_createtable(L, 0, 10);
+
+	auto average = [](double total, int count) { return count > 0 ? total / count : 0.0; };
+
+	lua_pushinteger(L, stats.underruns);
+	lua_setfield(L, -2, "underruns");
+
+	lua_pushinteger(L, stats.decodedBuffers);
+	lua_setfield(L, -2, "decodedbuffers");
+
+	lua_pushnumber(L, average(stats.decodeTime, stats.decodedBuffers) * 1000.0);
+	lua_setfield(L, -2, "decodems");
+
+	// The update thread takes the lock twice per update.
+	lua_pushnumber(L, average(stats.lockWaitTime, stats.updates * 2) * 1000.0);
+	lua_setfield(L, -2, "lockwaitms");
+
+	lua_pushnumber(L, stats.maxLockWaitTime * 1000.0);
+	lua_setfield(L, -2, "maxlockwaitms");
+
+	lua_pushnumber(L, average(stats.lockHoldTime, stats.updates * 2) * 1000.0);
+	lua_setfield(L, -2, "lockholdms");
+
+	lua_pushnumber(L, stats.maxLockHoldTime * 1000.0);
+	lua_setfield(L, -2, "maxlockholdms");
+
+	lua_pushinteger(L, stats.updates);
+	lua_setfield(L, -2, "updates");
+
+	lua_pushnumber(L, average(stats.updateInterval, stats.updates) * 1000.0);
+	lua_setfield(L, -2, "updateintervalms");
+
+	lua_pushnumber(L, stats.maxUpdateInterval * 1000.0);
+	lua_setfield(L, -2, "maxupdateintervalms");
+
+	return 1;
+}
+
+int w_resetStats(lua_State *)
+{
+	instance()->resetStats();
+	return 0;
+}
+
+int w_setStreamingLatency(lua_State *L)
+{
+	double seconds = luaL_checknumber(L, 1);
+	if (seconds < 0.0)
+		return luaL_error(L, "Streaming latency must not be negative.");
+
+	instance()->setStreamingLatency(seconds);
+	return 0;
+}
+
+int w_getStreamingLatency(lua_State *L)
+{
+	lua_pushnumber(L, instance()->getStreamingLatency());
+	return 1;
+}
+
 int w_setMixWithSystem(lua_State *L)
 {
 	luax_pushboolean(L, instance()->setMixWithSystem(luax_checkboolean(L, 1)));
@@ -542,6 +747,7 @@ static const luaL_Reg functions[] =
 	{ "play", w_play },
 	{ "stop", w_stop },
 	{ "pause", w_pause },
+	{ "updateSources", w_updateSources },
 	{ "setVolume", w_setVolume },
 	{ "getVolume", w_getVolume },
 	{ "setPosition", w_setPosition },
@@ -564,6 +770,18 @@ static const luaL_Reg functions[] =
 	{ "getMaxSourceEffects", w_getMaxSourceEffects },
 	{ "isEffectsSupported", w_isEffectsSupported },
 	{ "setMixWithSystem", w_setMixWithSystem },
+	{ "setBusVolume", w_setBusVolume },
+	{ "getBusVolume", w_getBusVolume },
+	{ "setBusEffects", w_setBusEffects },
+	{ "getBusEffects", w_getBusEffects },
+	{ "getStats", w_getStats },
+	{ "resetStats", w_resetStats },
+	{ "setStreamingLatency", w_setStreamingLatency },
+	{ "setStaticCacheBudget", w_setStaticCacheBudget },
+	{ "getStaticCacheBudget", w_getStaticCacheBudget },
+	{ "getStaticCacheSize", w_getStaticCacheSize },
+	{ "clearStaticCache", w_clearStaticCache },
+	{ "getStreamingLatency", w_getStreamingLatency },
 
 	// Deprecated
 	{ "getSourceCount", w_getSourceCount },
@@ -22,6 +22,8 @@
 #include "wrap_Audio.h"
 
 #include "sound/SoundData.h"
+#include "thread/wrap_Channel.h"
+
 namespace love
 {
 namespace audio
@@ -136,6 +138,50 @@ int w_RecordingDevice_isRecording(lua_State *L)
 	return 1;
 }
 
+int w_RecordingDevice_setFrameMode(lua_State *L)
+{
+	RecordingDevice *d = luax_checkrecordingdevice(L, 1);
+	int samples = lua_isnoneornil(L, 2) ? 0 : (int) luaL_checkinteger(L, 2);
+	int frames = (int) luaL_optinteger(L, 3, RecordingDevice::DEFAULT_FRAMES);
+	love::thread::Channel *channel = lua_isnoneornil(L, 4) ? nullptr : love::thread::luax_checkchannel(L, 4);
+
+	luax_catchexcept(L, [&]() { d->setFrameMode(samples, frames, channel); });
+	return 0;
+}
+
+int w_RecordingDevice_getFrameSamples(lua_State *L)
+{
+	RecordingDevice *d = luax_checkrecordingdevice(L, 1);
+	lua_pushinteger(L, d->getFrameSamples());
+	return 1;
+}
+
+int w_RecordingDevice_readFrame(lua_State *L)
+{
+	RecordingDevice *d = luax_checkrecordingdevice(L, 1);
+	love::sound::SoundData *s = luax_checktype<love::sound::SoundData>(L, 2);
+
+	bool success = false;
+	luax_catchexcept(L, [&]() { success = d->readFrame(s); });
+
+	luax_pushboolean(L, success);
+	return 1;
+}
+
+int w_RecordingDevice_getAvailableFrames(lua_State *L)
+{
+	RecordingDevice *d = luax_checkrecordingdevice(L, 1);
+	lua_pushinteger(L, d->getAvailableFrames());
+	return 1;
+}
+
+int w_RecordingDevice_getDroppedFrames(lua_State *L)
+{
+	RecordingDevice *d = luax_checkrecordingdevice(L, 1);
+	lua_pushinteger(L, d->getDroppedFrames());
+	return 1;
+}
+
 static const luaL_Reg w_RecordingDevice_functions[] =
 {
 	{ "start", w_RecordingDevice_start },
@@ -147,6 +193,11 @@ static const luaL_Reg w_RecordingDevice_functions[] =
 	{ "getChannelCount", w_RecordingDevice_getChannelCount },
 	{ "getName", w_RecordingDevice_getName },
 	{ "isRecording", w_RecordingDevice_isRecording },
+	{ "setFrameMode", w_RecordingDevice_setFrameMode },
+	{ "getFrameSamples", w_RecordingDevice_getFrameSamples },
+	{ "readFrame", w_RecordingDevice_readFrame },
+	{ "getAvailableFrames", w_RecordingDevice_getAvailableFrames },
+	{ "getDroppedFrames", w_RecordingDevice_getDroppedFrames },
 	{ 0, 0 }
 };
 
@@ -21,6 +21,8 @@
 #include <limits>
 
 #include "sound/SoundData.h"
+#include "sound/Decoder.h"
+#include "filesystem/FileData.h"
 #include "wrap_Source.h"
 
 #include <cmath>
@@ -591,6 +593,103 @@ int w_Source_getChannels(lua_State *L)
 	return w_Source_getChannelCount(L);
 }
 
+int w_Source_setPriority(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	t->setPriority((int) luaL_checkinteger(L, 2));
+	return 0;
+}
+
+int w_Source_getPriority(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	lua_pushinteger(L, t->getPriority());
+	return 1;
+}
+
+int w_Source_isVirtual(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	luax_pushboolean(L, t->isVirtual());
+	return 1;
+}
+
+int w_Source_setBus(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	const char *name = lua_isnoneornil(L, 2) ? "" : luaL_checkstring(L, 2);
+	luax_catchexcept(L, [&]() { t->setBus(name); });
+	return 0;
+}
+
+int w_Source_getBus(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	const std::string &bus = t->getBus();
+	if (bus.empty())
+		lua_pushnil(L);
+	else
+		luax_pushstring(L, bus);
+	return 1;
+}
+
+int w_Source_getStats(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	Source::Stats stats = t->getStats();
+
+	if (lua_istable(L, 2))
+		lua_pushvalue(L, 2);
+	else
+		lua_createtable(L, 0, 4);
+
+	lua_pushinteger(L, stats.underruns);
+	lua_setfield(L, -2, "underruns");
+
+	lua_pushnumber(L, stats.queuedTime * 1000.0);
+	lua_setfield(L, -2, "queuedms");
+
+	lua_pushinteger(L, stats.decodedBuffers);
+	lua_setfield(L, -2, "decodedbuffers");
+
+	double decodetime = stats.decodedBuffers > 0 ? stats.decodeTime / stats.decodedBuffers : 0.0;
+	lua_pushnumber(L, decodetime * 1000.0);
+	lua_setfield(L, -2, "decodems");
+
+	return 1;
+}
+
+int w_Source_queueDecoder(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+
+	if (lua_isstring(L, 2) || luax_istype(L, 2, love::filesystem::File::type) || luax_istype(L, 2, love::filesystem::FileData::type))
+		luax_convobj(L, 2, "sound", "newDecoder");
+
+	love::sound::Decoder *decoder = luax_checktype<love::sound::Decoder>(L, 2);
+	float crossfade = (float) luaL_optnumber(L, 3, 0.0);
+
+	if (crossfade < 0.0f)
+		return luaL_error(L, "Crossfade duration must not be negative.");
+
+	luax_catchexcept(L, [&]() { t->queueDecoder(decoder, crossfade); });
+	return 0;
+}
+
+int w_Source_getQueuedDecoderCount(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	lua_pushinteger(L, t->getQueuedDecoderCount());
+	return 1;
+}
+
+int w_Source_clearQueuedDecoders(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	t->clearQueuedDecoders();
+	return 0;
+}
+
 static const luaL_Reg w_Source_functions[] =
 {
 	{ "clone", w_Source_clone },
@@ -641,6 +740,15 @@ static const luaL_Reg w_Source_functions[] =
 	{ "queue", w_Source_queue },
 
 	{ "getType", w_Source_getType },
+	{ "setPriority", w_Source_setPriority },
+	{ "getPriority", w_Source_getPriority },
+	{ "isVirtual", w_Source_isVirtual },
+	{ "setBus", w_Source_setBus },
+	{ "getBus", w_Source_getBus },
+	{ "getStats", w_Source_getStats },
+	{ "queueDecoder", w_Source_queueDecoder },
+	{ "getQueuedDecoderCount", w_Source_getQueuedDecoderCount },
+	{ "clearQueuedDecoders", w_Source_clearQueuedDecoders },
 
 	// Deprecated
 	{ "getChannels", w_Source_getChannels },
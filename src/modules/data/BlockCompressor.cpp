@@ -0,0 +1,291 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "BlockCompressor.h"
+#include "common/Exception.h"
+#include "thread/WorkerPool.h"
+
+// C++
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+
+// C
+#include <cstring>
+
+namespace love
+{
+namespace data
+{
+
+static const char BLOCK_MAGIC[4] = {'L', 'O', 'V', 'B'};
+static const uint8 BLOCK_VERSION = 1;
+static const size_t BLOCK_HEADER_SIZE = 24;
+
+static inline void writeUint32LE(char *dst, uint32 v)
+{
+	for (int i = 0; i < 4; i++)
+		dst[i] = (char) (v >> (i * 8));
+}
+
+static inline void writeUint64LE(char *dst, uint64 v)
+{
+	for (int i = 0; i < 8; i++)
+		dst[i] = (char) (v >> (i * 8));
+}
+
+static inline uint32 readUint32LE(const char *src)
+{
+	uint32 v = 0;
+	for (int i = 0; i < 4; i++)
+		v |= (uint32) (uint8) src[i] << (i * 8);
+	return v;
+}
+
+static inline uint64 readUint64LE(const char *src)
+{
+	uint64 v = 0;
+	for (int i = 0; i < 8; i++)
+		v |= (uint64) (uint8) src[i] << (i * 8);
+	return v;
+}
+
+// Finds the compressed bytes and uncompressed size of a block in a container
+// already validated by getInfo.
+static void getBlock(const char *data, const BlockCompressor::Info &info, size_t block, const char *&src, size_t &srcsize, size_t &rawsize)
+{
+	const char *index = data + BLOCK_HEADER_SIZE;
+	const char *blocks = index + info.blockCount * sizeof(uint64);
+
+	uint64 start = block > 0 ? readUint64LE(index + (block - 1) * sizeof(uint64)) : 0;
+	uint64 end = readUint64LE(index + block * sizeof(uint64));
+
+	src = blocks + start;
+	srcsize = (size_t) (end - start);
+
+	uint64 offset = (uint64) block * info.blockSize;
+	rawsize = (size_t) std::min<uint64>(info.blockSize, info.rawSize - offset);
+}
+
+static void decompressBlockTo(const char *data, const BlockCompressor::Info &info, Compressor *compressor, size_t block, char *dst)
+{
+	const char *src = nullptr;
+	size_t srcsize = 0;
+	size_t rawsize = 0;
+	getBlock(data, info, block, src, srcsize, rawsize);
+
+	size_t decompressedsize = rawsize;
+	std::unique_ptr<char[]> raw(compressor->decompress(info.format, src, srcsize, decompressedsize));
+
+	if (decompressedsize != rawsize)
+		throw love::Exception("Could not decompress block-compressed data (block %d has the wrong size).", (int) block + 1);
+
+	memcpy(dst, raw.get(), rawsize);
+}
+
+static Compressor *getBlockCompressor(Compressor::Format format)
+{
+	Compressor *compressor = Compressor::getCompressor(format);
+	if (compressor == nullptr)
+		throw love::Exception("Invalid compression format.");
+	return compressor;
+}
+
+char *BlockCompressor::compress(Compressor::Format format, const char *data, size_t dataSize, int level, size_t blockSize, size_t &compressedSize)
+{
+	Compressor *compressor = getBlockCompressor(format);
+
+	if (blockSize == 0 || blockSize > MAX_BLOCK_SIZE)
+		throw love::Exception("Block size must be between 1 and %d bytes.", (int) MAX_BLOCK_SIZE);
+
+	size_t blockcount = (dataSize + blockSize - 1) / blockSize;
+
+	if (blockcount > (size_t) std::numeric_limits<int>::max())
+		throw love::Exception("Too many blocks; use a larger block size.");
+
+	std::vector<std::unique_ptr<char[]>> blocks(blockcount);
+	std::vector<size_t> blocksizes(blockcount);
+
+	love::thread::WorkerPool::getShared().parallelFor((int) blockcount, [&](int i)
+	{
+		size_t offset = (size_t) i * blockSize;
+		size_t size = std::min(blockSize, dataSize - offset);
+		blocks[i].reset(compressor->compress(format, data + offset, size, level, blocksizes[i]));
+	});
+
+	size_t totalsize = BLOCK_HEADER_SIZE + blockcount * sizeof(uint64);
+	for (size_t size : blocksizes)
+		totalsize += size;
+
+	char *out = nullptr;
+
+	try
+	{
+		out = new char[totalsize];
+	}
+	catch (std::bad_alloc &)
+	{
+		throw love::Exception("Out of memory.");
+	}
+
+	memcpy(out, BLOCK_MAGIC, 4);
+	out[4] = (char) BLOCK_VERSION;
+	out[5] = (char) format;
+	out[6] = out[7] = 0;
+	writeUint32LE(out + 8, (uint32) blockSize);
+	writeUint32LE(out + 12, (uint32) blockcount);
+	writeUint64LE(out + 16, (uint64) dataSize);
+
+	char *index = out + BLOCK_HEADER_SIZE;
+	char *dst = index + blockcount * sizeof(uint64);
+	uint64 end = 0;
+
+	for (size_t i = 0; i < blockcount; i++)
+	{
+		memcpy(dst, blocks[i].get(), blocksizes[i]);
+		dst += blocksizes[i];
+
+		end += blocksizes[i];
+		writeUint64LE(index + i * sizeof(uint64), end);
+	}
+
+	compressedSize = totalsize;
+	return out;
+}
+
+char *BlockCompressor::decompress(const char *data, size_t dataSize, size_t &decompressedSize)
+{
+	Info info = getInfo(data, dataSize);
+	Compressor *compressor = getBlockCompressor(info.format);
+
+	if (info.rawSize > (uint64) std::numeric_limits<size_t>::max())
+		throw love::Exception("Block-compressed data is too large to decompress.");
+
+	char *out = nullptr;
+
+	try
+	{
+		out = new char[std::max<size_t>((size_t) info.rawSize, 1)];
+	}
+	catch (std::bad_alloc &)
+	{
+		throw love::Exception("Out of memory.");
+	}
+
+	try
+	{
+		love::thread::WorkerPool::getShared().parallelFor((int) info.blockCount, [&](int i)
+		{
+			decompressBlockTo(data, info, compressor, (size_t) i, out + (size_t) i * info.blockSize);
+		});
+	}
+	catch (love::Exception &)
+	{
+		delete[] out;
+		throw;
+	}
+
+	decompressedSize = (size_t) info.rawSize;
+	return out;
+}
+
+char *BlockCompressor::decompressBlock(const char *data, size_t dataSize, size_t block, size_t &decompressedSize)
+{
+	Info info = getInfo(data, dataSize);
+	Compressor *compressor = getBlockCompressor(info.format);
+
+	if (block >= info.blockCount)
+		throw love::Exception("Invalid block index: %d (the data has %d blocks).", (int) block + 1, (int) info.blockCount);
+
+	const char *src = nullptr;
+	size_t srcsize = 0;
+	size_t rawsize = 0;
+	getBlock(data, info, block, src, srcsize, rawsize);
+
+	char *out = nullptr;
+
+	try
+	{
+		out = new char[rawsize];
+	}
+	catch (std::bad_alloc &)
+	{
+		throw love::Exception("Out of memory.");
+	}
+
+	try
+	{
+		decompressBlockTo(data, info, compressor, block, out);
+	}
+	catch (love::Exception &)
+	{
+		delete[] out;
+		throw;
+	}
+
+	decompressedSize = rawsize;
+	return out;
+}
+
+BlockCompressor::Info BlockCompressor::getInfo(const char *data, size_t dataSize)
+{
+	if (dataSize < BLOCK_HEADER_SIZE || memcmp(data, BLOCK_MAGIC, 4) != 0)
+		throw love::Exception("Invalid block-compressed data.");
+
+	if ((uint8) data[4] != BLOCK_VERSION)
+		throw love::Exception("Unsupported block-compressed data version.");
+
+	if ((uint8) data[5] >= (uint8) Compressor::FORMAT_MAX_ENUM)
+		throw love::Exception("Invalid block-compressed data format.");
+
+	Info info;
+	info.format = (Compressor::Format) (uint8) data[5];
+	info.blockSize = readUint32LE(data + 8);
+	info.blockCount = readUint32LE(data + 12);
+	info.rawSize = readUint64LE(data + 16);
+
+	if (info.blockSize == 0 || info.blockSize > MAX_BLOCK_SIZE)
+		throw love::Exception("Invalid block-compressed data (bad block size).");
+
+	if ((info.rawSize + info.blockSize - 1) / info.blockSize != info.blockCount)
+		throw love::Exception("Invalid block-compressed data (bad block count).");
+
+	size_t indexsize = info.blockCount * sizeof(uint64);
+	if (dataSize - BLOCK_HEADER_SIZE < indexsize)
+		throw love::Exception("Invalid block-compressed data (truncated block index).");
+
+	uint64 available = dataSize - BLOCK_HEADER_SIZE - indexsize;
+	uint64 previous = 0;
+
+	for (size_t i = 0; i < info.blockCount; i++)
+	{
+		uint64 end = readUint64LE(data + BLOCK_HEADER_SIZE + i * sizeof(uint64));
+		if (end < previous || end > available)
+			throw love::Exception("Invalid block-compressed data (truncated or corrupt blocks).");
+		previous = end;
+	}
+
+	return info;
+}
+
+} // data
+} // love
@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/int.h"
+#include "Compressor.h"
+
+// C
+#include <stddef.h>
+
+namespace love
+{
+namespace data
+{
+
+/**
+ * Compresses large inputs as independent blocks, spread across the shared
+ * worker pool, into a container with an index of the blocks. Decompression is
+ * parallel as well, and any single block can be decompressed on its own for
+ * random access.
+ *
+ * Each block uses the regular one-shot Compressor for the format. The
+ * container starts with a 24 byte little-endian header: the magic "LOVB", a
+ * version byte, the format, two reserved bytes, the block size (uint32), the
+ * block count (uint32) and the total uncompressed size (uint64). It's
+ * followed by the end offset of every block's data (uint64 each, relative to
+ * the start of the block data), then the blocks themselves.
+ **/
+class BlockCompressor
+{
+public:
+
+	static const size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+	static const size_t MAX_BLOCK_SIZE = 512 * 1024 * 1024;
+
+	struct Info
+	{
+		Compressor::Format format;
+		size_t blockSize;
+		size_t blockCount;
+		uint64 rawSize;
+	};
+
+	/**
+	 * Compresses input data, and returns the container (allocated with new[]).
+	 *
+	 * @param[in] format The format to compress each block with.
+	 * @param[in] data The input (uncompressed) data.
+	 * @param[in] dataSize The size in bytes of the input data.
+	 * @param[in] level The amount of compression to apply, or -1 for default.
+	 * @param[in] blockSize The uncompressed size in bytes of each block.
+	 * @param[out] compressedSize The size in bytes of the container.
+	 **/
+	static char *compress(Compressor::Format format, const char *data, size_t dataSize, int level, size_t blockSize, size_t &compressedSize);
+
+	/**
+	 * Decompresses every block of a container, and returns the result
+	 * (allocated with new[]).
+	 **/
+	static char *decompress(const char *data, size_t dataSize, size_t &decompressedSize);
+
+	/**
+	 * Decompresses a single block of a container, and returns the result
+	 * (allocated with new[]).
+	 **/
+	static char *decompressBlock(const char *data, size_t dataSize, size_t block, size_t &decompressedSize);
+
+	/**
+	 * Parses a container's header. Throws an exception if it's invalid.
+	 **/
+	static Info getInfo(const char *data, size_t dataSize);
+
+}; // BlockCompressor
+
+} // data
+} // love
@@ -36,6 +36,7 @@ ByteData::ByteData(size_t size)
 {
 	create();
 	memset(data, 0, size);
+	setNativeMemorySize(type, size);
 }
 
 ByteData::ByteData(const void *d, size_t size)
@@ -43,6 +44,7 @@ ByteData::ByteData(const void *d, size_t size)
 {
 	create();
 	memcpy(data, d, size);
+	setNativeMemorySize(type, size);
 }
 
 ByteData::ByteData(void *d, size_t size, bool own)
@@ -55,6 +57,8 @@ ByteData::ByteData(void *d, size_t size, bool own)
 		create();
 		memcpy(data, d, size);
 	}
+
+	setNativeMemorySize(type, size);
 }
 
 ByteData::ByteData(const ByteData &d)
@@ -62,6 +66,7 @@ ByteData::ByteData(const ByteData &d)
 {
 	create();
 	memcpy(data, d.data, size);
+	setNativeMemorySize(type, size);
 }
 
 ByteData::~ByteData()
@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "ByteDataBuilder.h"
+#include "common/Exception.h"
+
+// C++
+#include <algorithm>
+#include <limits>
+#include <string.h>
+
+namespace love
+{
+namespace data
+{
+
+love::Type ByteDataBuilder::type("ByteDataBuilder", &Object::type);
+
+ByteDataBuilder::ByteDataBuilder(size_t capacity)
+	: data(nullptr)
+	, size(0)
+	, capacity(0)
+{
+	reserve(capacity);
+	setNativeMemorySize(type, this->capacity);
+}
+
+ByteDataBuilder::~ByteDataBuilder()
+{
+	delete[] data;
+}
+
+void ByteDataBuilder::reserve(size_t newcapacity)
+{
+	if (newcapacity <= capacity)
+		return;
+
+	char *newdata = nullptr;
+
+	try
+	{
+		newdata = new char[newcapacity];
+	}
+	catch (std::exception &)
+	{
+		throw love::Exception("Out of memory.");
+	}
+
+	if (data != nullptr)
+		memcpy(newdata, data, size);
+
+	delete[] data;
+	data = newdata;
+	capacity = newcapacity;
+
+	setNativeMemorySize(type, capacity);
+}
+
+size_t ByteDataBuilder::getCapacity() const
+{
+	return capacity;
+}
+
+char *ByteDataBuilder::getRange(size_t offset, size_t length)
+{
+	if (offset > std::numeric_limits<size_t>::max() - length)
+		throw love::Exception("ByteDataBuilder size is too large.");
+
+	size_t end = offset + length;
+
+	if (end > capacity)
+	{
+		// Doubling keeps appends amortized constant time.
+		size_t grown = capacity > std::numeric_limits<size_t>::max() / 2 ? end : capacity * 2;
+		reserve(std::max(std::max(end, grown), (size_t) 64));
+	}
+
+	if (offset > size)
+		memset(data + size, 0, offset - size);
+
+	size = std::max(size, end);
+
+	return data + offset;
+}
+
+void ByteDataBuilder::append(const void *bytes, size_t length)
+{
+	write(size, bytes, length);
+}
+
+void ByteDataBuilder::write(size_t offset, const void *bytes, size_t length)
+{
+	char *dst = getRange(offset, length);
+	if (length > 0)
+		memmove(dst, bytes, length);
+}
+
+void ByteDataBuilder::setSize(size_t newsize)
+{
+	if (newsize > size)
+		memset(getRange(size, newsize - size), 0, newsize - size);
+	else
+		size = newsize;
+}
+
+size_t ByteDataBuilder::getSize() const
+{
+	return size;
+}
+
+const char *ByteDataBuilder::getData() const
+{
+	return data;
+}
+
+void ByteDataBuilder::clear()
+{
+	size = 0;
+}
+
+ByteData *ByteDataBuilder::finish()
+{
+	// ByteData frees with delete[] as well, so the buffer can be given away.
+	// Any extra capacity goes with it.
+	if (data == nullptr)
+		reserve(1);
+
+	ByteData *result = new ByteData(data, size, true);
+
+	data = nullptr;
+	size = 0;
+	capacity = 0;
+
+	setNativeMemorySize(type, 0);
+
+	return result;
+}
+
+} // data
+} // love
@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "ByteData.h"
+
+#include <stddef.h>
+
+namespace love
+{
+namespace data
+{
+
+/**
+ * Accumulates bytes in a buffer which grows as needed, for building up
+ * serialized data in pieces. The result is handed off as a ByteData without
+ * copying it.
+ **/
+class ByteDataBuilder : public Object
+{
+public:
+
+	static love::Type type;
+
+	ByteDataBuilder(size_t capacity);
+	virtual ~ByteDataBuilder();
+
+	/**
+	 * Gets a pointer to size bytes at the given offset, for writing in place.
+	 * The buffer grows if they go past the current end, and any bytes between
+	 * the old end and offset are zeroed.
+	 **/
+	char *getRange(size_t offset, size_t size);
+
+	void append(const void *data, size_t size);
+	void write(size_t offset, const void *data, size_t size);
+
+	/**
+	 * Shrinks or zero-extends the contents.
+	 **/
+	void setSize(size_t size);
+	size_t getSize() const;
+
+	void reserve(size_t capacity);
+	size_t getCapacity() const;
+
+	const char *getData() const;
+
+	void clear();
+
+	/**
+	 * Hands the contents off to a new ByteData, and leaves the builder empty.
+	 **/
+	ByteData *finish();
+
+private:
+
+	char *data;
+	size_t size;
+	size_t capacity;
+
+}; // ByteDataBuilder
+
+} // data
+} // love
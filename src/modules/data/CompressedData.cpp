@@ -49,6 +49,8 @@ CompressedData::CompressedData(Compressor::Format format, char *cdata, size_t co
 
 		memcpy(data, cdata, dataSize);
 	}
+
+	setNativeMemorySize(type, dataSize);
 }
 
 CompressedData::CompressedData(const CompressedData &c)
@@ -67,6 +69,7 @@ CompressedData::CompressedData(const CompressedData &c)
 	}
 
 	memcpy(data, c.data, dataSize);
+	setNativeMemorySize(type, dataSize);
 }
 
 CompressedData::~CompressedData()
@@ -0,0 +1,364 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "CompressionContext.h"
+#include "common/config.h"
+#include "common/Exception.h"
+
+#ifdef LOVE_SUPPORT_ZSTD
+#include <zstd.h>
+#include <zdict.h>
+#endif
+
+// C++
+#include <algorithm>
+#include <new>
+
+// C
+#include <cstring>
+
+namespace love
+{
+namespace data
+{
+
+love::Type CompressionContext::type("CompressionContext", &Object::type);
+
+CompressionContext::CompressionContext(Compressor::Format format, int level, Data *dictionary)
+	: format(format)
+	, level(level)
+	, dictionary(dictionary)
+	, zstdCCtx(nullptr)
+	, zstdDCtx(nullptr)
+	, zstdCDict(nullptr)
+	, zstdDDict(nullptr)
+{
+	if (format == Compressor::FORMAT_ZSTD && !isZstdSupported())
+		throw love::Exception("zstd compression is not supported in this build.");
+
+	if (format != Compressor::FORMAT_ZSTD && Compressor::getCompressor(format) == nullptr)
+		throw love::Exception("Invalid compression format.");
+
+	if (format != Compressor::FORMAT_ZSTD && dictionary != nullptr)
+		throw love::Exception("Compression dictionaries are only supported by the zstd format.");
+
+#ifdef LOVE_SUPPORT_ZSTD
+	if (format == Compressor::FORMAT_ZSTD)
+	{
+		if (this->level < 0)
+			this->level = ZSTD_CLEVEL_DEFAULT;
+		else
+			this->level = std::min(this->level, ZSTD_maxCLevel());
+	}
+#endif
+}
+
+CompressionContext::~CompressionContext()
+{
+#ifdef LOVE_SUPPORT_ZSTD
+	ZSTD_freeCCtx(zstdCCtx);
+	ZSTD_freeDCtx(zstdDCtx);
+	ZSTD_freeCDict(zstdCDict);
+	ZSTD_freeDDict(zstdDDict);
+#endif
+}
+
+char *CompressionContext::compress(const char *data, size_t dataSize, size_t &compressedSize)
+{
+	if (format != Compressor::FORMAT_ZSTD)
+		return Compressor::getCompressor(format)->compress(format, data, dataSize, level, compressedSize);
+
+#ifdef LOVE_SUPPORT_ZSTD
+	if (zstdCCtx == nullptr)
+	{
+		zstdCCtx = ZSTD_createCCtx();
+		if (zstdCCtx == nullptr)
+			throw love::Exception("Out of memory.");
+	}
+
+	if (dictionary.get() != nullptr && zstdCDict == nullptr)
+	{
+		zstdCDict = ZSTD_createCDict(dictionary->getData(), dictionary->getSize(), level);
+		if (zstdCDict == nullptr)
+			throw love::Exception("Could not load zstd dictionary.");
+	}
+
+	size_t maxsize = ZSTD_compressBound(dataSize);
+	char *compressedbytes = nullptr;
+
+	try
+	{
+		compressedbytes = new char[maxsize];
+	}
+	catch (std::bad_alloc &)
+	{
+		throw love::Exception("Out of memory.");
+	}
+
+	size_t result = 0;
+	if (zstdCDict != nullptr)
+		result = ZSTD_compress_usingCDict(zstdCCtx, compressedbytes, maxsize, data, dataSize, zstdCDict);
+	else
+		result = ZSTD_compressCCtx(zstdCCtx, compressedbytes, maxsize, data, dataSize, level);
+
+	if (ZSTD_isError(result))
+	{
+		delete[] compressedbytes;
+		throw love::Exception("Could not zstd-compress data (%s).", ZSTD_getErrorName(result));
+	}
+
+	// Shrink the buffer if it's much larger than the compressed data, like
+	// the zlib compressor does.
+	if ((double) maxsize / (double) std::max<size_t>(result, 1) >= 1.3)
+	{
+		char *cbytes = new (std::nothrow) char[std::max<size_t>(result, 1)];
+		if (cbytes)
+		{
+			memcpy(cbytes, compressedbytes, result);
+			delete[] compressedbytes;
+			compressedbytes = cbytes;
+		}
+	}
+
+	compressedSize = result;
+	return compressedbytes;
+#else
+	throw love::Exception("zstd compression is not supported in this build.");
+#endif
+}
+
+char *CompressionContext::decompress(const char *data, size_t dataSize, size_t &decompressedSize)
+{
+	if (format != Compressor::FORMAT_ZSTD)
+		return Compressor::getCompressor(format)->decompress(format, data, dataSize, decompressedSize);
+
+#ifdef LOVE_SUPPORT_ZSTD
+	if (zstdDCtx == nullptr)
+	{
+		zstdDCtx = ZSTD_createDCtx();
+		if (zstdDCtx == nullptr)
+			throw love::Exception("Out of memory.");
+	}
+
+	if (dictionary.get() != nullptr && zstdDDict == nullptr)
+	{
+		zstdDDict = ZSTD_createDDict(dictionary->getData(), dictionary->getSize());
+		if (zstdDDict == nullptr)
+			throw love::Exception("Could not load zstd dictionary.");
+	}
+
+	size_t rawsize = decompressedSize;
+
+	if (rawsize == 0)
+	{
+		unsigned long long framesize = ZSTD_getFrameContentSize(data, dataSize);
+
+		if (framesize == ZSTD_CONTENTSIZE_ERROR)
+			throw love::Exception("Could not decompress zstd-compressed data (invalid data).");
+		else if (framesize != ZSTD_CONTENTSIZE_UNKNOWN)
+			rawsize = (size_t) framesize;
+	}
+
+	if (rawsize > 0)
+	{
+		char *rawbytes = nullptr;
+
+		try
+		{
+			rawbytes = new char[rawsize];
+		}
+		catch (std::bad_alloc &)
+		{
+			throw love::Exception("Out of memory.");
+		}
+
+		size_t result = 0;
+		if (zstdDDict != nullptr)
+			result = ZSTD_decompress_usingDDict(zstdDCtx, rawbytes, rawsize, data, dataSize, zstdDDict);
+		else
+			result = ZSTD_decompressDCtx(zstdDCtx, rawbytes, rawsize, data, dataSize);
+
+		if (ZSTD_isError(result))
+		{
+			delete[] rawbytes;
+			throw love::Exception("Could not decompress zstd-compressed data (%s).", ZSTD_getErrorName(result));
+		}
+
+		decompressedSize = result;
+		return rawbytes;
+	}
+
+	// The frame doesn't store its decompressed size (e.g. it came from a
+	// CompressionStream), so decode it in pieces.
+	ZSTD_DCtx_reset(zstdDCtx, ZSTD_reset_session_and_parameters);
+	if (zstdDDict != nullptr)
+		ZSTD_DCtx_refDDict(zstdDCtx, zstdDDict);
+
+	std::vector<char> output;
+	ZSTD_inBuffer in = {data, dataSize, 0};
+	size_t result = 0;
+
+	while (true)
+	{
+		size_t offset = output.size();
+		size_t chunksize = std::max(ZSTD_DStreamOutSize(), dataSize * 2);
+		output.resize(offset + chunksize);
+
+		ZSTD_outBuffer out = {&output[offset], chunksize, 0};
+		result = ZSTD_decompressStream(zstdDCtx, &out, &in);
+
+		output.resize(offset + out.pos);
+
+		if (ZSTD_isError(result))
+			throw love::Exception("Could not decompress zstd-compressed data (%s).", ZSTD_getErrorName(result));
+
+		if (in.pos == in.size && out.pos < out.size)
+			break;
+	}
+
+	if (result != 0)
+		throw love::Exception("Could not decompress zstd-compressed data (the data is incomplete).");
+
+	char *rawbytes = nullptr;
+
+	try
+	{
+		rawbytes = new char[std::max<size_t>(output.size(), 1)];
+	}
+	catch (std::bad_alloc &)
+	{
+		throw love::Exception("Out of memory.");
+	}
+
+	if (!output.empty())
+		memcpy(rawbytes, output.data(), output.size());
+
+	decompressedSize = output.size();
+	return rawbytes;
+#else
+	throw love::Exception("zstd compression is not supported in this build.");
+#endif
+}
+
+size_t CompressionContext::decompressInto(const char *data, size_t dataSize, char *dst, size_t dstSize)
+{
+	if (format != Compressor::FORMAT_ZSTD)
+		return Compressor::getCompressor(format)->decompressInto(format, data, dataSize, dst, dstSize);
+
+#ifdef LOVE_SUPPORT_ZSTD
+	if (zstdDCtx == nullptr)
+	{
+		zstdDCtx = ZSTD_createDCtx();
+		if (zstdDCtx == nullptr)
+			throw love::Exception("Out of memory.");
+	}
+
+	if (dictionary.get() != nullptr && zstdDDict == nullptr)
+	{
+		zstdDDict = ZSTD_createDDict(dictionary->getData(), dictionary->getSize());
+		if (zstdDDict == nullptr)
+			throw love::Exception("Could not load zstd dictionary.");
+	}
+
+	size_t framesize = Compressor::getDecompressedSize(format, data, dataSize);
+	if (framesize > dstSize)
+		throw love::Exception("The decompressed data (%d bytes) doesn't fit in the destination (%d bytes).", (int) framesize, (int) dstSize);
+
+	size_t result = 0;
+	if (zstdDDict != nullptr)
+		result = ZSTD_decompress_usingDDict(zstdDCtx, dst, dstSize, data, dataSize, zstdDDict);
+	else
+		result = ZSTD_decompressDCtx(zstdDCtx, dst, dstSize, data, dataSize);
+
+	if (ZSTD_isError(result))
+		throw love::Exception("Could not decompress zstd-compressed data (%s).", ZSTD_getErrorName(result));
+
+	return result;
+#else
+	throw love::Exception("zstd compression is not supported in this build.");
+#endif
+}
+
+Compressor::Format CompressionContext::getFormat() const
+{
+	return format;
+}
+
+int CompressionContext::getLevel() const
+{
+	return level;
+}
+
+Data *CompressionContext::getDictionary() const
+{
+	return dictionary.get();
+}
+
+char *CompressionContext::trainDictionary(const char *samples, const std::vector<size_t> &sampleSizes, size_t maxSize, size_t &dictSize)
+{
+#ifdef LOVE_SUPPORT_ZSTD
+	if (maxSize == 0)
+		throw love::Exception("Dictionary size must be greater than 0.");
+
+	if (sampleSizes.empty())
+		throw love::Exception("Training a dictionary requires at least one sample.");
+
+	char *dict = nullptr;
+
+	try
+	{
+		dict = new char[maxSize];
+	}
+	catch (std::bad_alloc &)
+	{
+		throw love::Exception("Out of memory.");
+	}
+
+	size_t result = ZDICT_trainFromBuffer(dict, maxSize, samples, sampleSizes.data(), (unsigned) sampleSizes.size());
+
+	if (ZDICT_isError(result))
+	{
+		delete[] dict;
+		throw love::Exception("Could not train compression dictionary (%s).", ZDICT_getErrorName(result));
+	}
+
+	dictSize = result;
+	return dict;
+#else
+	LOVE_UNUSED(samples);
+	LOVE_UNUSED(sampleSizes);
+	LOVE_UNUSED(maxSize);
+	LOVE_UNUSED(dictSize);
+	throw love::Exception("zstd compression is not supported in this build.");
+#endif
+}
+
+bool CompressionContext::isZstdSupported()
+{
+#ifdef LOVE_SUPPORT_ZSTD
+	return true;
+#else
+	return false;
+#endif
+}
+
+} // data
+} // love
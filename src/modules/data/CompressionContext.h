@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/Data.h"
+#include "Compressor.h"
+
+// C++
+#include <vector>
+
+// zstd
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+namespace love
+{
+namespace data
+{
+
+/**
+ * Compresses and decompresses with state that's kept between calls, so many
+ * small inputs (e.g. network packets) don't each pay for setting up the
+ * compressor. With zstd, a context can also use a dictionary trained on
+ * typical inputs, which greatly improves the ratio for small data.
+ *
+ * Other formats are supported for convenience, but gain nothing from reuse.
+ * A context must only be used by one thread at a time.
+ **/
+class CompressionContext : public Object
+{
+public:
+
+	static love::Type type;
+
+	/**
+	 * @param format The compression format to use.
+	 * @param level The amount of compression to apply, or -1 for the default.
+	 *        Unlike other formats, zstd accepts levels up to 22.
+	 * @param dictionary A dictionary to compress and decompress with, or null.
+	 *        Only supported by zstd.
+	 **/
+	CompressionContext(Compressor::Format format, int level, Data *dictionary);
+	virtual ~CompressionContext();
+
+	/**
+	 * Compresses input data, and returns the compressed result (allocated
+	 * with new[]).
+	 **/
+	char *compress(const char *data, size_t dataSize, size_t &compressedSize);
+
+	/**
+	 * Decompresses compressed data, and returns the result (allocated with
+	 * new[]). See Compressor::decompress.
+	 **/
+	char *decompress(const char *data, size_t dataSize, size_t &decompressedSize);
+
+	/**
+	 * Decompresses into an existing buffer. zstd reuses the context's state,
+	 * so this doesn't allocate. See Compressor::decompressInto.
+	 **/
+	size_t decompressInto(const char *data, size_t dataSize, char *dst, size_t dstSize);
+
+	Compressor::Format getFormat() const;
+	int getLevel() const;
+	Data *getDictionary() const;
+
+	/**
+	 * Builds a zstd dictionary from samples which are representative of the
+	 * data that will be compressed with it.
+	 *
+	 * @param samples All samples, stored back to back.
+	 * @param sampleSizes The size in bytes of each sample.
+	 * @param maxSize The maximum size in bytes of the dictionary.
+	 * @param[out] dictSize The size in bytes of the dictionary.
+	 *
+	 * @return The dictionary (allocated with new[]).
+	 **/
+	static char *trainDictionary(const char *samples, const std::vector<size_t> &sampleSizes, size_t maxSize, size_t &dictSize);
+
+	/**
+	 * Whether love was built with zstd support.
+	 **/
+	static bool isZstdSupported();
+
+private:
+
+	Compressor::Format format;
+	int level;
+	StrongRef<Data> dictionary;
+
+	// zstd compression and decompression contexts and digested dictionaries,
+	// created when first needed.
+	ZSTD_CCtx_s *zstdCCtx;
+	ZSTD_DCtx_s *zstdDCtx;
+	ZSTD_CDict_s *zstdCDict;
+	ZSTD_DDict_s *zstdDDict;
+
+}; // CompressionContext
+
+} // data
+} // love
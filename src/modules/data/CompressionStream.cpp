@@ -0,0 +1,800 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "CompressionStream.h"
+#include "common/config.h"
+#include "common/Exception.h"
+#include "common/int.h"
+
+#include "libraries/lz4/lz4.h"
+#include "libraries/lz4/lz4hc.h"
+#include "libraries/xxHash/xxhash.h"
+
+#include <zlib.h>
+
+#ifdef LOVE_SUPPORT_ZSTD
+#include <zstd.h>
+#endif
+
+// C++
+#include <algorithm>
+#include <limits>
+
+// C
+#include <cstring>
+
+namespace love
+{
+namespace data
+{
+
+// Output is produced in pieces of this size.
+static const size_t STREAM_CHUNK_SIZE = 64 * 1024;
+
+static inline void appendUint32LE(std::vector<char> &out, uint32 v)
+{
+	char bytes[4] = {(char) v, (char) (v >> 8), (char) (v >> 16), (char) (v >> 24)};
+	out.insert(out.end(), bytes, bytes + 4);
+}
+
+static inline uint32 readUint32LE(const char *src)
+{
+	const uint8 *b = (const uint8 *) src;
+	return (uint32) b[0] | ((uint32) b[1] << 8) | ((uint32) b[2] << 16) | ((uint32) b[3] << 24);
+}
+
+class ZlibStream final : public CompressionStream
+{
+public:
+
+	ZlibStream(Compressor::Format format, Mode mode, int level)
+		: CompressionStream(format, mode)
+	{
+		memset(&stream, 0, sizeof(z_stream));
+
+		// Same window bits as the one-shot zlib compressor.
+		int windowbits = 15;
+		if (format == Compressor::FORMAT_GZIP)
+			windowbits += 16;
+		else if (format == Compressor::FORMAT_DEFLATE)
+			windowbits = -windowbits;
+
+		if (level < 0)
+			level = Z_DEFAULT_COMPRESSION;
+		else if (level > 9)
+			level = 9;
+
+		int status = Z_OK;
+		if (mode == MODE_COMPRESS)
+			status = deflateInit2(&stream, level, Z_DEFLATED, windowbits, 8, Z_DEFAULT_STRATEGY);
+		else
+			status = inflateInit2(&stream, windowbits);
+
+		if (status != Z_OK)
+			throw love::Exception("Could not initialize zlib stream.");
+	}
+
+	virtual ~ZlibStream()
+	{
+		if (mode == MODE_COMPRESS)
+			deflateEnd(&stream);
+		else
+			inflateEnd(&stream);
+	}
+
+	void process(const char *data, size_t size, std::vector<char> &output) override
+	{
+		if (mode == MODE_COMPRESS && finished)
+			throw love::Exception("Cannot compress more data after the stream is finished.");
+
+		// zlib sizes are 32 bits, so huge inputs are fed in pieces.
+		while (size > 0)
+		{
+			uInt chunk = (uInt) std::min<size_t>(size, std::numeric_limits<uInt>::max());
+			size_t consumed = 0;
+
+			if (mode == MODE_COMPRESS)
+				consumed = deflateChunk(data, chunk, Z_NO_FLUSH, output);
+			else
+				consumed = inflateChunk(data, chunk, output);
+
+			data += consumed;
+			size -= consumed;
+		}
+	}
+
+	void finish(std::vector<char> &output) override
+	{
+		if (mode == MODE_COMPRESS)
+		{
+			if (!finished)
+				deflateChunk(nullptr, 0, Z_FINISH, output);
+			finished = true;
+		}
+		else if (!finished)
+			throw love::Exception("Could not decompress data (the compressed stream is incomplete).");
+	}
+
+private:
+
+	size_t deflateChunk(const char *data, uInt size, int flush, std::vector<char> &output)
+	{
+		stream.next_in = (Bytef *) data;
+		stream.avail_in = size;
+
+		while (true)
+		{
+			size_t offset = output.size();
+			output.resize(offset + STREAM_CHUNK_SIZE);
+
+			stream.next_out = (Bytef *) &output[offset];
+			stream.avail_out = (uInt) STREAM_CHUNK_SIZE;
+
+			int status = deflate(&stream, flush);
+
+			output.resize(offset + STREAM_CHUNK_SIZE - stream.avail_out);
+
+			if (status == Z_STREAM_ERROR)
+				throw love::Exception("Could not compress data (zlib stream error).");
+
+			if (flush == Z_FINISH ? status == Z_STREAM_END : (stream.avail_in == 0 && stream.avail_out > 0))
+				break;
+		}
+
+		return size;
+	}
+
+	size_t inflateChunk(const char *data, uInt size, std::vector<char> &output)
+	{
+		// More data after the end of a stream starts a concatenated one, e.g.
+		// another gzip member.
+		if (finished)
+		{
+			inflateReset(&stream);
+			finished = false;
+		}
+
+		stream.next_in = (Bytef *) data;
+		stream.avail_in = size;
+
+		while (true)
+		{
+			size_t offset = output.size();
+			output.resize(offset + STREAM_CHUNK_SIZE);
+
+			stream.next_out = (Bytef *) &output[offset];
+			stream.avail_out = (uInt) STREAM_CHUNK_SIZE;
+
+			int status = inflate(&stream, Z_NO_FLUSH);
+
+			output.resize(offset + STREAM_CHUNK_SIZE - stream.avail_out);
+
+			if (status == Z_STREAM_END)
+			{
+				finished = true;
+				break;
+			}
+			else if (status == Z_NEED_DICT || status == Z_DATA_ERROR || status == Z_MEM_ERROR || status == Z_STREAM_ERROR)
+			{
+				const char *err = stream.msg != nullptr ? stream.msg : "invalid data";
+				throw love::Exception("Could not decompress data (%s).", err);
+			}
+
+			// All input consumed and inflate didn't fill the output, so it
+			// needs more input to continue.
+			if (stream.avail_in == 0 && stream.avail_out > 0)
+				break;
+		}
+
+		return size - stream.avail_in;
+	}
+
+	z_stream stream;
+
+}; // ZlibStream
+
+// See https://github.com/lz4/lz4/blob/dev/doc/lz4_Frame_format.md
+
+static const uint32 LZ4F_MAGIC = 0x184D2204;
+static const uint32 LZ4F_SKIPPABLE_MAGIC = 0x184D2A50;
+static const uint32 LZ4F_SKIPPABLE_MASK = 0xFFFFFFF0;
+static const uint32 LZ4F_UNCOMPRESSED_BIT = 0x80000000;
+
+static const uint8 LZ4F_FLG_VERSION       = 0x40;
+static const uint8 LZ4F_FLG_VERSION_MASK  = 0xC0;
+static const uint8 LZ4F_FLG_BLOCK_INDEP   = 0x20;
+static const uint8 LZ4F_FLG_BLOCK_CHKSUM  = 0x10;
+static const uint8 LZ4F_FLG_CONTENT_SIZE  = 0x08;
+static const uint8 LZ4F_FLG_CONTENT_CHKSUM = 0x04;
+static const uint8 LZ4F_FLG_DICTID        = 0x01;
+
+// Linked blocks can reference up to this much previously decoded data.
+static const size_t LZ4F_HISTORY_SIZE = 64 * 1024;
+
+// Block maximum size code 5: 256 KB.
+static const uint8 LZ4F_BLOCK_SIZE_CODE = 5;
+
+static size_t getLZ4FrameBlockSize(int code)
+{
+	return (size_t) 1 << (8 + 2 * code);
+}
+
+class LZ4FrameStream final : public CompressionStream
+{
+public:
+
+	LZ4FrameStream(Mode mode, int level)
+		: CompressionStream(Compressor::FORMAT_LZ4, mode)
+		, checksum(XXH32_createState())
+		, highCompression(level >= 9)
+		, headerWritten(false)
+		, state(STATE_HEADER)
+		, flags(0)
+		, blockMaxSize(0)
+		, blockSize(0)
+		, blockUncompressed(false)
+		, skipSize(0)
+	{
+		if (checksum == nullptr)
+			throw love::Exception("Out of memory.");
+
+		XXH32_reset(checksum, 0);
+
+		if (mode == MODE_COMPRESS)
+			block.reserve(getLZ4FrameBlockSize(LZ4F_BLOCK_SIZE_CODE));
+	}
+
+	virtual ~LZ4FrameStream()
+	{
+		XXH32_freeState(checksum);
+	}
+
+	void process(const char *data, size_t size, std::vector<char> &output) override
+	{
+		if (mode == MODE_COMPRESS)
+			compress(data, size, output);
+		else
+		{
+			pending.insert(pending.end(), data, data + size);
+			decompress(output);
+		}
+	}
+
+	void finish(std::vector<char> &output) override
+	{
+		if (mode == MODE_COMPRESS)
+		{
+			if (finished)
+				return;
+
+			if (!headerWritten)
+				writeHeader(output);
+
+			if (!block.empty())
+				writeBlock(output);
+
+			appendUint32LE(output, 0); // EndMark
+			appendUint32LE(output, XXH32_digest(checksum));
+
+			finished = true;
+		}
+		else if (!finished || state != STATE_HEADER || !pending.empty())
+			throw love::Exception("Could not decompress data (the compressed stream is incomplete).");
+	}
+
+private:
+
+	enum State
+	{
+		STATE_HEADER,
+		STATE_BLOCK_SIZE,
+		STATE_BLOCK_DATA,
+		STATE_CONTENT_CHECKSUM,
+		STATE_SKIP,
+	};
+
+	void compress(const char *data, size_t size, std::vector<char> &output)
+	{
+		if (finished)
+			throw love::Exception("Cannot compress more data after the stream is finished.");
+
+		if (!headerWritten)
+			writeHeader(output);
+
+		XXH32_update(checksum, data, size);
+
+		size_t maxsize = getLZ4FrameBlockSize(LZ4F_BLOCK_SIZE_CODE);
+
+		while (size > 0)
+		{
+			size_t count = std::min(size, maxsize - block.size());
+			block.insert(block.end(), data, data + count);
+
+			data += count;
+			size -= count;
+
+			if (block.size() == maxsize)
+				writeBlock(output);
+		}
+	}
+
+	void writeHeader(std::vector<char> &output)
+	{
+		uint8 descriptor[2] = {
+			LZ4F_FLG_VERSION | LZ4F_FLG_BLOCK_INDEP | LZ4F_FLG_CONTENT_CHKSUM,
+			(uint8) (LZ4F_BLOCK_SIZE_CODE << 4),
+		};
+
+		appendUint32LE(output, LZ4F_MAGIC);
+		output.push_back((char) descriptor[0]);
+		output.push_back((char) descriptor[1]);
+		output.push_back((char) ((XXH32(descriptor, 2, 0) >> 8) & 0xFF));
+
+		headerWritten = true;
+	}
+
+	void writeBlock(std::vector<char> &output)
+	{
+		int srcsize = (int) block.size();
+		int maxdstsize = LZ4_compressBound(srcsize);
+
+		size_t offset = output.size();
+		output.resize(offset + 4 + maxdstsize);
+
+		char *dst = &output[offset + 4];
+		int csize = 0;
+
+		// Use LZ4-HC for compression level 9 and higher, like Compressor.
+		if (highCompression)
+			csize = LZ4_compress_HC(block.data(), dst, srcsize, maxdstsize, LZ4HC_CLEVEL_DEFAULT);
+		else
+			csize = LZ4_compress_default(block.data(), dst, srcsize, maxdstsize);
+
+		uint32 header = 0;
+
+		// Incompressible blocks are stored as-is.
+		if (csize <= 0 || csize >= srcsize)
+		{
+			memcpy(dst, block.data(), srcsize);
+			csize = srcsize;
+			header = (uint32) srcsize | LZ4F_UNCOMPRESSED_BIT;
+		}
+		else
+			header = (uint32) csize;
+
+		output.resize(offset + 4 + csize);
+
+		uint8 *h = (uint8 *) &output[offset];
+		h[0] = (uint8) header;
+		h[1] = (uint8) (header >> 8);
+		h[2] = (uint8) (header >> 16);
+		h[3] = (uint8) (header >> 24);
+
+		block.clear();
+	}
+
+	// Parses as much of the pending input as possible.
+	void decompress(std::vector<char> &output)
+	{
+		size_t pos = 0;
+
+		while (true)
+		{
+			const char *src = pending.data() + pos;
+			size_t available = pending.size() - pos;
+
+			size_t used = 0;
+
+			if (state == STATE_HEADER)
+				used = parseHeader(src, available);
+			else if (state == STATE_BLOCK_SIZE)
+				used = parseBlockSize(src, available);
+			else if (state == STATE_BLOCK_DATA)
+				used = parseBlockData(src, available, output);
+			else if (state == STATE_CONTENT_CHECKSUM)
+				used = parseContentChecksum(src, available);
+			else if (state == STATE_SKIP)
+			{
+				used = (size_t) std::min<uint64>(skipSize, available);
+				skipSize -= used;
+				if (skipSize == 0)
+					endFrame();
+			}
+
+			// Zero means more input is needed before the state can advance.
+			if (used == 0)
+				break;
+
+			pos += used;
+		}
+
+		pending.erase(pending.begin(), pending.begin() + pos);
+	}
+
+	size_t parseHeader(const char *src, size_t available)
+	{
+		if (available < 4)
+			return 0;
+
+		uint32 magic = readUint32LE(src);
+
+		if ((magic & LZ4F_SKIPPABLE_MASK) == LZ4F_SKIPPABLE_MAGIC)
+		{
+			if (available < 8)
+				return 0;
+
+			finished = false;
+			skipSize = readUint32LE(src + 4);
+			state = STATE_SKIP;
+
+			if (skipSize == 0)
+				endFrame();
+
+			return 8;
+		}
+
+		if (magic != LZ4F_MAGIC)
+			throw love::Exception("Could not decompress data (not an LZ4 frame).");
+
+		if (available < 7)
+			return 0;
+
+		uint8 flg = (uint8) src[4];
+		uint8 bd = (uint8) src[5];
+
+		if ((flg & LZ4F_FLG_VERSION_MASK) != LZ4F_FLG_VERSION)
+			throw love::Exception("Could not decompress data (unsupported LZ4 frame version).");
+
+		if (flg & LZ4F_FLG_DICTID)
+			throw love::Exception("Could not decompress data (LZ4 frames with dictionaries are not supported).");
+
+		int sizecode = (bd >> 4) & 0x07;
+		if (sizecode < 4)
+			throw love::Exception("Could not decompress data (invalid LZ4 block size).");
+
+		size_t descsize = 2 + ((flg & LZ4F_FLG_CONTENT_SIZE) ? 8 : 0);
+		size_t headersize = 4 + descsize + 1;
+
+		if (available < headersize)
+			return 0;
+
+		uint8 hc = (uint8) ((XXH32(src + 4, descsize, 0) >> 8) & 0xFF);
+		if (hc != (uint8) src[4 + descsize])
+			throw love::Exception("Could not decompress data (corrupt LZ4 frame header).");
+
+		finished = false;
+		flags = flg;
+		blockMaxSize = getLZ4FrameBlockSize(sizecode);
+		history.clear();
+		XXH32_reset(checksum, 0);
+		state = STATE_BLOCK_SIZE;
+
+		return headersize;
+	}
+
+	size_t parseBlockSize(const char *src, size_t available)
+	{
+		if (available < 4)
+			return 0;
+
+		uint32 header = readUint32LE(src);
+
+		if (header == 0)
+		{
+			if (flags & LZ4F_FLG_CONTENT_CHKSUM)
+				state = STATE_CONTENT_CHECKSUM;
+			else
+				endFrame();
+			return 4;
+		}
+
+		blockSize = header & ~LZ4F_UNCOMPRESSED_BIT;
+		blockUncompressed = (header & LZ4F_UNCOMPRESSED_BIT) != 0;
+
+		if (blockSize > blockMaxSize)
+			throw love::Exception("Could not decompress data (invalid LZ4 block size).");
+
+		state = STATE_BLOCK_DATA;
+		return 4;
+	}
+
+	size_t parseBlockData(const char *src, size_t available, std::vector<char> &output)
+	{
+		size_t checksumsize = (flags & LZ4F_FLG_BLOCK_CHKSUM) ? 4 : 0;
+
+		if (available < blockSize + checksumsize)
+			return 0;
+
+		if (checksumsize > 0 && XXH32(src, blockSize, 0) != readUint32LE(src + blockSize))
+			throw love::Exception("Could not decompress data (LZ4 block checksum mismatch).");
+
+		size_t offset = output.size();
+		size_t decodedsize = blockSize;
+
+		if (blockUncompressed)
+			output.insert(output.end(), src, src + blockSize);
+		else
+		{
+			output.resize(offset + blockMaxSize);
+
+			int result = 0;
+			if (flags & LZ4F_FLG_BLOCK_INDEP)
+				result = LZ4_decompress_safe(src, &output[offset], (int) blockSize, (int) blockMaxSize);
+			else
+				result = LZ4_decompress_safe_usingDict(src, &output[offset], (int) blockSize, (int) blockMaxSize, history.data(), (int) history.size());
+
+			if (result < 0)
+				throw love::Exception("Could not decompress LZ4-compressed data.");
+
+			decodedsize = (size_t) result;
+			output.resize(offset + decodedsize);
+		}
+
+		const char *decoded = &output[0] + offset;
+
+		XXH32_update(checksum, decoded, decodedsize);
+
+		// Linked blocks need the previous 64 KB of output as a dictionary.
+		if (!(flags & LZ4F_FLG_BLOCK_INDEP))
+		{
+			if (decodedsize >= LZ4F_HISTORY_SIZE)
+				history.assign(decoded + decodedsize - LZ4F_HISTORY_SIZE, decoded + decodedsize);
+			else
+			{
+				history.insert(history.end(), decoded, decoded + decodedsize);
+				if (history.size() > LZ4F_HISTORY_SIZE)
+					history.erase(history.begin(), history.end() - LZ4F_HISTORY_SIZE);
+			}
+		}
+
+		state = STATE_BLOCK_SIZE;
+		return blockSize + checksumsize;
+	}
+
+	size_t parseContentChecksum(const char *src, size_t available)
+	{
+		if (available < 4)
+			return 0;
+
+		if (XXH32_digest(checksum) != readUint32LE(src))
+			throw love::Exception("Could not decompress data (LZ4 content checksum mismatch).");
+
+		endFrame();
+		return 4;
+	}
+
+	void endFrame()
+	{
+		state = STATE_HEADER;
+		finished = true;
+	}
+
+	XXH32_state_t *checksum;
+
+	// Compression.
+	bool highCompression;
+	bool headerWritten;
+	std::vector<char> block;
+
+	// Decompression.
+	State state;
+	std::vector<char> pending;
+	std::vector<char> history;
+	uint8 flags;
+	size_t blockMaxSize;
+	size_t blockSize;
+	bool blockUncompressed;
+	uint64 skipSize;
+
+}; // LZ4FrameStream
+
+#ifdef LOVE_SUPPORT_ZSTD
+
+class ZstdStream final : public CompressionStream
+{
+public:
+
+	ZstdStream(Mode mode, int level)
+		: CompressionStream(Compressor::FORMAT_ZSTD, mode)
+		, cstream(nullptr)
+		, dstream(nullptr)
+	{
+		if (mode == MODE_COMPRESS)
+		{
+			cstream = ZSTD_createCCtx();
+			if (cstream == nullptr)
+				throw love::Exception("Out of memory.");
+
+			if (level < 0)
+				level = ZSTD_CLEVEL_DEFAULT;
+
+			ZSTD_CCtx_setParameter(cstream, ZSTD_c_compressionLevel, std::min(level, ZSTD_maxCLevel()));
+		}
+		else
+		{
+			dstream = ZSTD_createDCtx();
+			if (dstream == nullptr)
+				throw love::Exception("Out of memory.");
+		}
+	}
+
+	virtual ~ZstdStream()
+	{
+		ZSTD_freeCCtx(cstream);
+		ZSTD_freeDCtx(dstream);
+	}
+
+	void process(const char *data, size_t size, std::vector<char> &output) override
+	{
+		ZSTD_inBuffer in = {data, size, 0};
+
+		if (mode == MODE_COMPRESS)
+		{
+			if (finished)
+				throw love::Exception("Cannot compress more data after the stream is finished.");
+
+			while (in.pos < in.size)
+				run(&in, ZSTD_e_continue, output);
+
+			return;
+		}
+
+		if (size == 0)
+			return;
+
+		// Frames can be concatenated, and the context moves on to the next
+		// one by itself.
+		bool framedone = false;
+
+		while (true)
+		{
+			size_t offset = output.size();
+			output.resize(offset + ZSTD_DStreamOutSize());
+
+			ZSTD_outBuffer out = {&output[offset], ZSTD_DStreamOutSize(), 0};
+			size_t result = ZSTD_decompressStream(dstream, &out, &in);
+
+			output.resize(offset + out.pos);
+
+			if (ZSTD_isError(result))
+				throw love::Exception("Could not decompress data (%s).", ZSTD_getErrorName(result));
+
+			framedone = result == 0;
+
+			// A full output buffer may be hiding more data which is ready.
+			if (in.pos == in.size && out.pos < out.size)
+				break;
+		}
+
+		finished = framedone;
+	}
+
+	void finish(std::vector<char> &output) override
+	{
+		if (mode == MODE_COMPRESS)
+		{
+			if (finished)
+				return;
+
+			ZSTD_inBuffer in = {nullptr, 0, 0};
+			while (run(&in, ZSTD_e_end, output) != 0)
+			{
+			}
+
+			finished = true;
+		}
+		else if (!finished)
+			throw love::Exception("Could not decompress data (the compressed stream is incomplete).");
+	}
+
+private:
+
+	size_t run(ZSTD_inBuffer *in, ZSTD_EndDirective directive, std::vector<char> &output)
+	{
+		size_t offset = output.size();
+		output.resize(offset + ZSTD_CStreamOutSize());
+
+		ZSTD_outBuffer out = {&output[offset], ZSTD_CStreamOutSize(), 0};
+		size_t remaining = ZSTD_compressStream2(cstream, &out, in, directive);
+
+		output.resize(offset + out.pos);
+
+		if (ZSTD_isError(remaining))
+			throw love::Exception("Could not compress data (%s).", ZSTD_getErrorName(remaining));
+
+		return remaining;
+	}
+
+	ZSTD_CCtx *cstream;
+	ZSTD_DCtx *dstream;
+
+}; // ZstdStream
+
+#endif // LOVE_SUPPORT_ZSTD
+
+love::Type CompressionStream::type("CompressionStream", &Object::type);
+
+CompressionStream::CompressionStream(Compressor::Format format, Mode mode)
+	: format(format)
+	, mode(mode)
+	, finished(false)
+{
+}
+
+CompressionStream *CompressionStream::create(Compressor::Format format, Mode mode, int level)
+{
+	switch (format)
+	{
+	case Compressor::FORMAT_LZ4:
+		return new LZ4FrameStream(mode, level);
+	case Compressor::FORMAT_ZLIB:
+	case Compressor::FORMAT_GZIP:
+	case Compressor::FORMAT_DEFLATE:
+		return new ZlibStream(format, mode, level);
+#ifdef LOVE_SUPPORT_ZSTD
+	case Compressor::FORMAT_ZSTD:
+		return new ZstdStream(mode, level);
+#endif
+	default:
+		throw love::Exception("Invalid compression format.");
+	}
+}
+
+bool CompressionStream::isFinished() const
+{
+	return finished;
+}
+
+Compressor::Format CompressionStream::getFormat() const
+{
+	return format;
+}
+
+CompressionStream::Mode CompressionStream::getMode() const
+{
+	return mode;
+}
+
+bool CompressionStream::getConstant(const char *in, Mode &out)
+{
+	return modes.find(in, out);
+}
+
+bool CompressionStream::getConstant(Mode in, const char *&out)
+{
+	return modes.find(in, out);
+}
+
+std::vector<std::string> CompressionStream::getConstants(Mode)
+{
+	return modes.getNames();
+}
+
+StringMap<CompressionStream::Mode, CompressionStream::MODE_MAX_ENUM>::Entry CompressionStream::modeEntries[] =
+{
+	{ "compress",   MODE_COMPRESS   },
+	{ "decompress", MODE_DECOMPRESS },
+};
+
+StringMap<CompressionStream::Mode, CompressionStream::MODE_MAX_ENUM> CompressionStream::modes(CompressionStream::modeEntries, sizeof(CompressionStream::modeEntries));
+
+} // data
+} // love
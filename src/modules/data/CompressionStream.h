@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/StringMap.h"
+#include "Compressor.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace data
+{
+
+/**
+ * Compresses or decompresses data incrementally, a chunk at a time, so large
+ * files never need to be held in memory all at once.
+ *
+ * The lz4 format uses the standard LZ4 frame format here, which differs from
+ * the block format with a size header used by love.data.compress.
+ *
+ * A stream may be passed between threads, but must only be used by one
+ * thread at a time.
+ **/
+class CompressionStream : public Object
+{
+public:
+
+	static love::Type type;
+
+	enum Mode
+	{
+		MODE_COMPRESS,
+		MODE_DECOMPRESS,
+		MODE_MAX_ENUM
+	};
+
+	/**
+	 * Creates a stream for the given format.
+	 *
+	 * @param format The compression format to produce or consume.
+	 * @param mode Whether the stream compresses or decompresses.
+	 * @param level The amount of compression to apply (between 0 and 9), or
+	 *        -1 for the default. Only used when compressing.
+	 **/
+	static CompressionStream *create(Compressor::Format format, Mode mode, int level = -1);
+
+	virtual ~CompressionStream() {}
+
+	/**
+	 * Compresses or decompresses the next chunk of input, and appends any
+	 * resulting output. Output can lag behind input while the stream buffers
+	 * data internally.
+	 * Decompression streams decode concatenated streams one after another.
+	 **/
+	virtual void process(const char *data, size_t size, std::vector<char> &output) = 0;
+
+	/**
+	 * Ends the stream and appends any remaining output. Compression streams
+	 * can't process more data afterward. Decompression streams throw an
+	 * exception if the compressed data was incomplete.
+	 **/
+	virtual void finish(std::vector<char> &output) = 0;
+
+	/**
+	 * Whether the stream is complete: after finish() when compressing, or at
+	 * the end of the compressed data when decompressing.
+	 **/
+	bool isFinished() const;
+
+	Compressor::Format getFormat() const;
+	Mode getMode() const;
+
+	static bool getConstant(const char *in, Mode &out);
+	static bool getConstant(Mode in, const char *&out);
+	static std::vector<std::string> getConstants(Mode);
+
+protected:
+
+	CompressionStream(Compressor::Format format, Mode mode);
+
+	Compressor::Format format;
+	Mode mode;
+	bool finished;
+
+private:
+
+	static StringMap<Mode, MODE_MAX_ENUM>::Entry modeEntries[];
+	static StringMap<Mode, MODE_MAX_ENUM> modes;
+
+}; // CompressionStream
+
+} // data
+} // love
@@ -20,6 +20,7 @@
 
 // LOVE
 #include "Compressor.h"
+#include "CompressionContext.h"
 #include "common/config.h"
 #include "common/int.h"
 
@@ -28,11 +29,30 @@
 
 #include <zlib.h>
 
+#include <algorithm>
+#include <string.h>
+
+#ifdef LOVE_SUPPORT_ZSTD
+#include <zstd.h>
+#endif
+
 namespace love
 {
 namespace data
 {
 
+// The size of the uncompressed data, stored in a little-endian header before
+// LZ4-compressed data.
+static uint32 getLZ4RawSize(const char *data)
+{
+	uint32 rawsize = 0;
+	memcpy(&rawsize, data, sizeof(uint32));
+#ifdef LOVE_BIG_ENDIAN
+	rawsize = swapuint32(rawsize);
+#endif
+	return rawsize;
+}
+
 class LZ4Compressor : public Compressor
 {
 public:
@@ -112,12 +132,7 @@ public:
 			throw love::Exception("Invalid LZ4-compressed data size.");
 
 		// Extract the original uncompressed size (stored in our custom header.)
-#ifdef LOVE_BIG_ENDIAN
-		// Convert from stored little-endian to big-endian.
-		uint32 rawsize = swapuint32(*(uint32 *) data);
-#else
-		uint32 rawsize = *(uint32 *) data;
-#endif
+		uint32 rawsize = getLZ4RawSize(data);
 
 		try
 		{
@@ -158,6 +173,27 @@ public:
 		return rawbytes;
 	}
 
+	size_t decompressInto(Format format, const char *data, size_t dataSize, char *dst, size_t dstSize) override
+	{
+		if (format != FORMAT_LZ4)
+			throw love::Exception("Invalid format (expecting LZ4)");
+
+		const size_t headersize = sizeof(uint32);
+
+		if (dataSize < headersize)
+			throw love::Exception("Invalid LZ4-compressed data size.");
+
+		uint32 rawsize = getLZ4RawSize(data);
+		if (rawsize > dstSize)
+			throw love::Exception("The decompressed data (%d bytes) doesn't fit in the destination (%d bytes).", (int) rawsize, (int) dstSize);
+
+		int result = LZ4_decompress_safe(data + headersize, dst, (int) (dataSize - headersize), (int) rawsize);
+		if (result < 0)
+			throw love::Exception("Could not decompress LZ4-compressed data.");
+
+		return (size_t) result;
+	}
+
 	bool isSupported(Format format) const override
 	{
 		return format == FORMAT_LZ4;
@@ -313,8 +349,13 @@ public:
 
 		char *rawbytes = nullptr;
 
-		// We might know the output size before decompression. If not, we guess.
-		size_t rawsize = decompressedSize > 0 ? decompressedSize : dataSize * 2;
+		// We might know the output size before decompression, or gzip's
+		// trailer might. If not, we guess.
+		size_t rawsize = decompressedSize;
+		if (rawsize == 0)
+			rawsize = getDecompressedSize(FORMAT_GZIP, data, dataSize);
+		if (rawsize == 0)
+			rawsize = std::max<size_t>(dataSize * 2, 64);
 
 		// Repeatedly try to decompress with an increasingly large output buffer.
 		while (true)
@@ -351,6 +392,22 @@ public:
 		return rawbytes;
 	}
 
+	size_t decompressInto(Format format, const char *data, size_t dataSize, char *dst, size_t dstSize) override
+	{
+		if (!isSupported(format))
+			throw love::Exception("Invalid format (expecting zlib or gzip)");
+
+		uLongf destLen = (uLongf) dstSize;
+		int status = zlibDecompress(format, (Bytef *) dst, &destLen, (const Bytef *) data, (uLong) dataSize);
+
+		if (status == Z_BUF_ERROR)
+			throw love::Exception("The decompressed data doesn't fit in the destination (%d bytes).", (int) dstSize);
+		else if (status != Z_OK)
+			throw love::Exception("Could not decompress zlib/gzip-compressed data.");
+
+		return (size_t) destLen;
+	}
+
 	bool isSupported(Format format) const override
 	{
 		return format == FORMAT_ZLIB || format == FORMAT_GZIP || format == FORMAT_DEFLATE;
@@ -358,12 +415,62 @@ public:
 
 }; // zlibCompressor
 
+#ifdef LOVE_SUPPORT_ZSTD
+
+class ZstdCompressor : public Compressor
+{
+public:
+
+	// zstd allocates a context for every one-shot call anyway, so this uses a
+	// temporary CompressionContext rather than duplicating its code.
+
+	char *compress(Format format, const char *data, size_t dataSize, int level, size_t &compressedSize) override
+	{
+		if (format != FORMAT_ZSTD)
+			throw love::Exception("Invalid format (expecting zstd)");
+
+		StrongRef<CompressionContext> context(new CompressionContext(format, level, nullptr), Acquire::NORETAIN);
+		return context->compress(data, dataSize, compressedSize);
+	}
+
+	char *decompress(Format format, const char *data, size_t dataSize, size_t &decompressedSize) override
+	{
+		if (format != FORMAT_ZSTD)
+			throw love::Exception("Invalid format (expecting zstd)");
+
+		StrongRef<CompressionContext> context(new CompressionContext(format, -1, nullptr), Acquire::NORETAIN);
+		return context->decompress(data, dataSize, decompressedSize);
+	}
+
+	size_t decompressInto(Format format, const char *data, size_t dataSize, char *dst, size_t dstSize) override
+	{
+		if (format != FORMAT_ZSTD)
+			throw love::Exception("Invalid format (expecting zstd)");
+
+		StrongRef<CompressionContext> context(new CompressionContext(format, -1, nullptr), Acquire::NORETAIN);
+		return context->decompressInto(data, dataSize, dst, dstSize);
+	}
+
+	bool isSupported(Format format) const override
+	{
+		return format == FORMAT_ZSTD;
+	}
+
+}; // ZstdCompressor
+
+#endif // LOVE_SUPPORT_ZSTD
+
 Compressor *Compressor::getCompressor(Format format)
 {
 	static LZ4Compressor lz4compressor;
 	static zlibCompressor zlibcompressor;
 
+#ifdef LOVE_SUPPORT_ZSTD
+	static ZstdCompressor zstdcompressor;
+	Compressor *compressors[] = {&lz4compressor, &zlibcompressor, &zstdcompressor};
+#else
 	Compressor *compressors[] = {&lz4compressor, &zlibcompressor};
+#endif
 
 	for (Compressor *c : compressors)
 	{
@@ -374,6 +481,40 @@ Compressor *Compressor::getCompressor(Format format)
 	return nullptr;
 }
 
+size_t Compressor::getDecompressedSize(Format format, const char *data, size_t dataSize)
+{
+	const uint8 *bytes = (const uint8 *) data;
+
+	switch (format)
+	{
+	case FORMAT_LZ4:
+		return dataSize >= sizeof(uint32) ? getLZ4RawSize(data) : 0;
+	case FORMAT_ZLIB:
+	case FORMAT_GZIP:
+		// zlib decompression auto-detects gzip data. A gzip stream ends with
+		// the uncompressed size, little-endian.
+		if (dataSize >= 18 && bytes[0] == 0x1F && bytes[1] == 0x8B)
+		{
+			const uint8 *isize = bytes + dataSize - 4;
+			return (size_t) isize[0] | ((size_t) isize[1] << 8) | ((size_t) isize[2] << 16) | ((size_t) isize[3] << 24);
+		}
+		return 0;
+	case FORMAT_ZSTD:
+#ifdef LOVE_SUPPORT_ZSTD
+	{
+		unsigned long long framesize = ZSTD_getFrameContentSize(data, dataSize);
+		if (framesize == ZSTD_CONTENTSIZE_ERROR || framesize == ZSTD_CONTENTSIZE_UNKNOWN)
+			return 0;
+		return (size_t) framesize;
+	}
+#else
+		return 0;
+#endif
+	default:
+		return 0;
+	}
+}
+
 bool Compressor::getConstant(const char *in, Format &out)
 {
 	return formatNames.find(in, out);
@@ -395,6 +536,7 @@ StringMap<Compressor::Format, Compressor::FORMAT_MAX_ENUM>::Entry Compressor::fo
 	{ "zlib",    FORMAT_ZLIB    },
 	{ "gzip",    FORMAT_GZIP    },
 	{ "deflate", FORMAT_DEFLATE },
+	{ "zstd",    FORMAT_ZSTD    },
 };
 
 StringMap<Compressor::Format, Compressor::FORMAT_MAX_ENUM> Compressor::formatNames(Compressor::formatEntries, sizeof(Compressor::formatEntries));
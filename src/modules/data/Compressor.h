@@ -41,6 +41,7 @@ public:
 		FORMAT_ZLIB,
 		FORMAT_GZIP,
 		FORMAT_DEFLATE,
+		FORMAT_ZSTD,
 		FORMAT_MAX_ENUM
 	};
 
@@ -81,6 +82,21 @@ public:
 	 **/
 	virtual char *decompress(Format format, const char *data, size_t dataSize, size_t &decompressedSize) = 0;
 
+	/**
+	 * Decompresses compressed data into an existing buffer instead of
+	 * allocating one. Throws an exception if the result doesn't fit.
+	 *
+	 * @return The size in bytes of the decompressed data written to dst.
+	 **/
+	virtual size_t decompressInto(Format format, const char *data, size_t dataSize, char *dst, size_t dstSize) = 0;
+
+	/**
+	 * Gets the decompressed size recorded by the compressed data itself, or
+	 * 0 if the format doesn't record it. zlib and deflate never do, and gzip
+	 * only stores it modulo 4 GB, so its size is just a hint.
+	 **/
+	static size_t getDecompressedSize(Format format, const char *data, size_t dataSize);
+
 	/**
 	 * Gets whether a specific format is supported by this backend.
 	 **/
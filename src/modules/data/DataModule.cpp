@@ -21,6 +21,8 @@
 // LOVE
 #include "DataModule.h"
 #include "common/b64.h"
+#include "common/config.h"
+#include "common/cpu.h"
 #include "common/int.h"
 #include "common/StringMap.h"
 
@@ -29,12 +31,231 @@
 #include <list>
 #include <iostream>
 
+#if defined(LOVE_CPU_X86)
+#include <immintrin.h>
+#elif defined(LOVE_SIMD_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace
 {
 
+using love::uint8;
+
 static const char hexchars[] = "0123456789abcdef";
 
-char *bytesToHex(const love::uint8 *src, size_t srclen, size_t &dstlen)
+// The vector versions return how many source bytes they converted (pairs of
+// characters when decoding), leaving the rest to the scalar loops.
+
+#if defined(LOVE_CPU_X86)
+
+LOVE_TARGET("ssse3")
+size_t bytesToHexSSSE3(const uint8 *src, size_t srclen, char *dst)
+{
+	const __m128i lut = _mm_loadu_si128((const __m128i *) hexchars);
+	const __m128i mask = _mm_set1_epi8(0x0F);
+	size_t i = 0;
+
+	for (; i + 16 <= srclen; i += 16)
+	{
+		__m128i in = _mm_loadu_si128((const __m128i *) (src + i));
+		__m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(in, 4), mask));
+		__m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(in, mask));
+
+		_mm_storeu_si128((__m128i *) (dst + i * 2), _mm_unpacklo_epi8(hi, lo));
+		_mm_storeu_si128((__m128i *) (dst + i * 2 + 16), _mm_unpackhi_epi8(hi, lo));
+	}
+
+	return i;
+}
+
+LOVE_TARGET("avx2")
+size_t bytesToHexAVX2(const uint8 *src, size_t srclen, char *dst)
+{
+	const __m256i lut = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) hexchars));
+	const __m256i mask = _mm256_set1_epi8(0x0F);
+	size_t i = 0;
+
+	for (; i + 32 <= srclen; i += 32)
+	{
+		__m256i in = _mm256_loadu_si256((const __m256i *) (src + i));
+		__m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(in, 4), mask));
+		__m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(in, mask));
+
+		// The unpacks work within each 128 bit lane.
+		__m256i a = _mm256_unpacklo_epi8(hi, lo);
+		__m256i b = _mm256_unpackhi_epi8(hi, lo);
+
+		_mm256_storeu_si256((__m256i *) (dst + i * 2), _mm256_permute2x128_si256(a, b, 0x20));
+		_mm256_storeu_si256((__m256i *) (dst + i * 2 + 32), _mm256_permute2x128_si256(a, b, 0x31));
+	}
+
+	return i;
+}
+
+// Matches nibble() below: anything that isn't a hex digit becomes 0.
+LOVE_TARGET("ssse3")
+inline __m128i hexValuesSSSE3(__m128i c)
+{
+	__m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+	__m128i isdigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+
+	__m128i alpha = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+	__m128i isalpha = _mm_cmpeq_epi8(_mm_min_epu8(alpha, _mm_set1_epi8(5)), alpha);
+
+	return _mm_or_si128(_mm_and_si128(isdigit, digit), _mm_and_si128(isalpha, _mm_add_epi8(alpha, _mm_set1_epi8(10))));
+}
+
+LOVE_TARGET("ssse3")
+size_t hexToBytesSSSE3(const char *src, size_t srclen, uint8 *dst)
+{
+	// Multiplies the first nibble of each pair by 16 and adds the second.
+	const __m128i weights = _mm_set1_epi16(0x0110);
+	size_t i = 0;
+
+	for (; i * 2 + 32 <= srclen; i += 16)
+	{
+		__m128i a = hexValuesSSSE3(_mm_loadu_si128((const __m128i *) (src + i * 2)));
+		__m128i b = hexValuesSSSE3(_mm_loadu_si128((const __m128i *) (src + i * 2 + 16)));
+
+		a = _mm_maddubs_epi16(a, weights);
+		b = _mm_maddubs_epi16(b, weights);
+
+		_mm_storeu_si128((__m128i *) (dst + i), _mm_packus_epi16(a, b));
+	}
+
+	return i;
+}
+
+LOVE_TARGET("avx2")
+inline __m256i hexValuesAVX2(__m256i c)
+{
+	__m256i digit = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+	__m256i isdigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+
+	__m256i alpha = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+	__m256i isalpha = _mm256_cmpeq_epi8(_mm256_min_epu8(alpha, _mm256_set1_epi8(5)), alpha);
+
+	return _mm256_or_si256(_mm256_and_si256(isdigit, digit), _mm256_and_si256(isalpha, _mm256_add_epi8(alpha, _mm256_set1_epi8(10))));
+}
+
+LOVE_TARGET("avx2")
+size_t hexToBytesAVX2(const char *src, size_t srclen, uint8 *dst)
+{
+	const __m256i weights = _mm256_set1_epi16(0x0110);
+	size_t i = 0;
+
+	for (; i * 2 + 64 <= srclen; i += 32)
+	{
+		__m256i a = hexValuesAVX2(_mm256_loadu_si256((const __m256i *) (src + i * 2)));
+		__m256i b = hexValuesAVX2(_mm256_loadu_si256((const __m256i *) (src + i * 2 + 32)));
+
+		a = _mm256_maddubs_epi16(a, weights);
+		b = _mm256_maddubs_epi16(b, weights);
+
+		// The pack interleaves the lanes of a and b; put them back in order.
+		__m256i out = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+		_mm256_storeu_si256((__m256i *) (dst + i), out);
+	}
+
+	return i;
+}
+
+size_t bytesToHexSIMD(const uint8 *src, size_t srclen, char *dst)
+{
+	const love::CPUFeatures &cpu = love::getCPUFeatures();
+	if (cpu.avx2)
+		return bytesToHexAVX2(src, srclen, dst);
+	else if (cpu.ssse3)
+		return bytesToHexSSSE3(src, srclen, dst);
+	return 0;
+}
+
+size_t hexToBytesSIMD(const char *src, size_t srclen, uint8 *dst)
+{
+	const love::CPUFeatures &cpu = love::getCPUFeatures();
+	if (cpu.avx2)
+		return hexToBytesAVX2(src, srclen, dst);
+	else if (cpu.ssse3)
+		return hexToBytesSSSE3(src, srclen, dst);
+	return 0;
+}
+
+#elif defined(LOVE_SIMD_NEON) && defined(__aarch64__)
+
+size_t bytesToHexSIMD(const uint8 *src, size_t srclen, char *dst)
+{
+	const uint8x16_t lut = vld1q_u8((const uint8 *) hexchars);
+	const uint8x16_t mask = vdupq_n_u8(0x0F);
+	size_t i = 0;
+
+	for (; i + 16 <= srclen; i += 16)
+	{
+		uint8x16_t in = vld1q_u8(src + i);
+
+		uint8x16x2_t out;
+		out.val[0] = vqtbl1q_u8(lut, vshrq_n_u8(in, 4));
+		out.val[1] = vqtbl1q_u8(lut, vandq_u8(in, mask));
+
+		vst2q_u8((uint8 *) dst + i * 2, out);
+	}
+
+	return i;
+}
+
+inline uint8x16_t hexValuesNEON(uint8x16_t c)
+{
+	uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+	uint8x16_t isdigit = vcleq_u8(digit, vdupq_n_u8(9));
+
+	uint8x16_t alpha = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+	uint8x16_t isalpha = vcleq_u8(alpha, vdupq_n_u8(5));
+
+	return vorrq_u8(vandq_u8(isdigit, digit), vandq_u8(isalpha, vaddq_u8(alpha, vdupq_n_u8(10))));
+}
+
+size_t hexToBytesSIMD(const char *src, size_t srclen, uint8 *dst)
+{
+	size_t i = 0;
+
+	for (; i * 2 + 32 <= srclen; i += 16)
+	{
+		// De-interleave the high and low nibble characters.
+		uint8x16x2_t in = vld2q_u8((const uint8 *) src + i * 2);
+		uint8x16_t hi = hexValuesNEON(in.val[0]);
+		uint8x16_t lo = hexValuesNEON(in.val[1]);
+
+		vst1q_u8(dst + i, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+	}
+
+	return i;
+}
+
+#else
+
+size_t bytesToHexSIMD(const uint8 */*src*/, size_t /*srclen*/, char */*dst*/)
+{
+	return 0;
+}
+
+size_t hexToBytesSIMD(const char */*src*/, size_t /*srclen*/, uint8 */*dst*/)
+{
+	return 0;
+}
+
+#endif
+
+void bytesToHex(const uint8 *src, size_t srclen, char *dst)
+{
+	for (size_t i = bytesToHexSIMD(src, srclen, dst); i < srclen; i++)
+	{
+		uint8 b = src[i];
+		dst[i * 2 + 0] = hexchars[b >> 4];
+		dst[i * 2 + 1] = hexchars[b & 0xF];
+	}
+}
+
+char *bytesToHex(const uint8 *src, size_t srclen, size_t &dstlen)
 {
 	dstlen = srclen * 2;
 
@@ -51,62 +272,70 @@ char *bytesToHex(const love::uint8 *src, size_t srclen, size_t &dstlen)
 		throw love::Exception("Out of memory.");
 	}
 
-	for (size_t i = 0; i < srclen; i++)
-	{
-		love::uint8 b = src[i];
-		dst[i * 2 + 0] = hexchars[b >> 4];
-		dst[i * 2 + 1] = hexchars[b & 0xF];
-	}
+	bytesToHex(src, srclen, dst);
 
 	dst[dstlen] = '\0';
 	return dst;
 }
 
-love::uint8 nibble(char c)
+uint8 nibble(char c)
 {
 	if (c >= '0' && c <= '9')
-		return (love::uint8) (c - '0');
+		return (uint8) (c - '0');
 
 	if (c >= 'A' && c <= 'F')
-		return (love::uint8) (c - 'A' + 0x0a);
+		return (uint8) (c - 'A' + 0x0a);
 
 	if (c >= 'a' && c <= 'f')
-		return (love::uint8) (c - 'a' + 0x0a);
+		return (uint8) (c - 'a' + 0x0a);
 
 	return 0;
 }
 
-love::uint8 *hexToBytes(const char *src, size_t srclen, size_t &dstlen)
+void skipHexPrefix(const char *&src, size_t &srclen)
 {
 	if (srclen >= 2 && src[0] == '0' && (src[1] == 'x' || src[1] == 'X'))
 	{
 		src += 2;
 		srclen -= 2;
 	}
+}
+
+// Expects any 0x prefix to already be skipped, and room for (srclen + 1) / 2
+// bytes in dst.
+void hexToBytes(const char *src, size_t srclen, uint8 *dst)
+{
+	size_t dstlen = (srclen + 1) / 2;
+
+	for (size_t i = hexToBytesSIMD(src, srclen, dst); i < dstlen; i++)
+	{
+		dst[i] = nibble(src[i * 2]) << 4;
+
+		if (i * 2 + 1 < srclen)
+			dst[i] |= nibble(src[i * 2 + 1]);
+	}
+}
+
+uint8 *hexToBytes(const char *src, size_t srclen, size_t &dstlen)
+{
+	skipHexPrefix(src, srclen);
 
 	dstlen = (srclen + 1) / 2;
 
 	if (dstlen == 0)
 		return nullptr;
 
-	love::uint8 *dst = nullptr;
+	uint8 *dst = nullptr;
 	try
 	{
-		dst = new love::uint8[dstlen];
+		dst = new uint8[dstlen];
 	}
 	catch (std::exception &)
 	{
 		throw love::Exception("Out of memory.");
 	}
 
-	for (size_t i = 0; i < dstlen; i++)
-	{
-		dst[i] = nibble(src[i * 2]) << 4;
-
-		if (i * 2 + 1 < srclen)
-			dst[i] |= nibble(src[i * 2 + 1]);
-	}
-
+	hexToBytes(src, srclen, dst);
 	return dst;
 }
 
@@ -163,6 +392,25 @@ char *decompress(Compressor::Format format, const char *cbytes, size_t compresse
 	return compressor->decompress(format, cbytes, compressedsize, rawsize);
 }
 
+size_t decompressInto(CompressedData *data, char *dst, size_t dstsize)
+{
+	size_t rawsize = data->getDecompressedSize();
+	if (rawsize > dstsize)
+		throw love::Exception("The decompressed data (%d bytes) doesn't fit in the destination (%d bytes).", (int) rawsize, (int) dstsize);
+
+	return decompressInto(data->getFormat(), (const char *) data->getData(), data->getSize(), dst, dstsize);
+}
+
+size_t decompressInto(Compressor::Format format, const char *cbytes, size_t compressedsize, char *dst, size_t dstsize)
+{
+	Compressor *compressor = Compressor::getCompressor(format);
+
+	if (compressor == nullptr)
+		throw love::Exception("Invalid compression format.");
+
+	return compressor->decompressInto(format, cbytes, compressedsize, dst, dstsize);
+}
+
 char *encode(EncodeFormat format, const char *src, size_t srclen, size_t &dstlen, size_t linelen)
 {
 	switch (format)
@@ -187,6 +435,56 @@ char *decode(EncodeFormat format, const char *src, size_t srclen, size_t &dstlen
 	}
 }
 
+size_t getEncodedSize(EncodeFormat format, size_t srclen, size_t linelen)
+{
+	switch (format)
+	{
+	case ENCODE_BASE64:
+	default:
+		return b64_encoded_size(srclen, linelen);
+	case ENCODE_HEX:
+		return srclen * 2;
+	}
+}
+
+size_t encodeInto(EncodeFormat format, const char *src, size_t srclen, char *dst, size_t dstsize, size_t linelen)
+{
+	size_t dstlen = getEncodedSize(format, srclen, linelen);
+	if (dstlen > dstsize)
+		throw love::Exception("Not enough space to encode the data (needs %d bytes, has %d.)", (int) dstlen, (int) dstsize);
+
+	switch (format)
+	{
+	case ENCODE_BASE64:
+	default:
+		return b64_encode(src, srclen, linelen, dst);
+	case ENCODE_HEX:
+		bytesToHex((const uint8 *) src, srclen, dst);
+		return dstlen;
+	}
+}
+
+size_t decodeInto(EncodeFormat format, const char *src, size_t srclen, char *dst, size_t dstsize)
+{
+	switch (format)
+	{
+	case ENCODE_BASE64:
+	default:
+		return b64_decode(src, srclen, dst, dstsize);
+	case ENCODE_HEX:
+	{
+		skipHexPrefix(src, srclen);
+
+		size_t dstlen = (srclen + 1) / 2;
+		if (dstlen > dstsize)
+			throw love::Exception("Not enough space to decode the data (needs %d bytes, has %d.)", (int) dstlen, (int) dstsize);
+
+		hexToBytes(src, srclen, (uint8 *) dst);
+		return dstlen;
+	}
+	}
+}
+
 std::string hash(HashFunction::Function function, Data *input)
 {
 	return hash(function, (const char*) input->getData(), input->getSize());
@@ -245,6 +543,58 @@ ByteData *DataModule::newByteData(void *d, size_t size, bool own)
 	return new ByteData(d, size, own);
 }
 
+ByteDataBuilder *DataModule::newByteDataBuilder(size_t capacity)
+{
+	return new ByteDataBuilder(capacity);
+}
+
+CompressionStream *DataModule::newCompressionStream(Compressor::Format format, CompressionStream::Mode mode, int level)
+{
+	return CompressionStream::create(format, mode, level);
+}
+
+CompressionContext *DataModule::newCompressionContext(Compressor::Format format, int level, Data *dictionary)
+{
+	return new CompressionContext(format, level, dictionary);
+}
+
+Hasher *DataModule::newHasher(HashFunction::Function function)
+{
+	return new Hasher(function);
+}
+
+size_t getDataValueSize(DataValueType type)
+{
+	switch (type)
+	{
+	case DATAVALUE_INT8:
+	case DATAVALUE_UINT8:
+		return 1;
+	case DATAVALUE_INT16:
+	case DATAVALUE_UINT16:
+		return 2;
+	case DATAVALUE_INT32:
+	case DATAVALUE_UINT32:
+	case DATAVALUE_FLOAT:
+		return 4;
+	case DATAVALUE_DOUBLE:
+		return 8;
+	case DATAVALUE_MAX_ENUM:
+		break;
+	}
+
+	return 0;
+}
+
+bool needsByteSwap(Endianness endianness)
+{
+#ifdef LOVE_BIG_ENDIAN
+	return endianness == ENDIAN_LITTLE;
+#else
+	return endianness == ENDIAN_BIG;
+#endif
+}
+
 static StringMap<EncodeFormat, ENCODE_MAX_ENUM>::Entry encoderEntries[] =
 {
 	{ "base64", ENCODE_BASE64 },
@@ -261,6 +611,29 @@ static StringMap<ContainerType, CONTAINER_MAX_ENUM>::Entry containerEntries[] =
 
 static StringMap<ContainerType, CONTAINER_MAX_ENUM> containers(containerEntries, sizeof(containerEntries));
 
+static StringMap<DataValueType, DATAVALUE_MAX_ENUM>::Entry dataValueTypeEntries[] =
+{
+	{ "int8",   DATAVALUE_INT8   },
+	{ "uint8",  DATAVALUE_UINT8  },
+	{ "int16",  DATAVALUE_INT16  },
+	{ "uint16", DATAVALUE_UINT16 },
+	{ "int32",  DATAVALUE_INT32  },
+	{ "uint32", DATAVALUE_UINT32 },
+	{ "float",  DATAVALUE_FLOAT  },
+	{ "double", DATAVALUE_DOUBLE },
+};
+
+static StringMap<DataValueType, DATAVALUE_MAX_ENUM> dataValueTypes(dataValueTypeEntries, sizeof(dataValueTypeEntries));
+
+static StringMap<Endianness, ENDIAN_MAX_ENUM>::Entry endiannessEntries[] =
+{
+	{ "native", ENDIAN_NATIVE },
+	{ "little", ENDIAN_LITTLE },
+	{ "big",    ENDIAN_BIG    },
+};
+
+static StringMap<Endianness, ENDIAN_MAX_ENUM> endiannesses(endiannessEntries, sizeof(endiannessEntries));
+
 bool getConstant(const char *in, EncodeFormat &out)
 {
 	return encoders.find(in, out);
@@ -291,5 +664,35 @@ std::vector<std::string> getConstants(ContainerType)
 	return containers.getNames();
 }
 
+bool getConstant(const char *in, DataValueType &out)
+{
+	return dataValueTypes.find(in, out);
+}
+
+bool getConstant(DataValueType in, const char *&out)
+{
+	return dataValueTypes.find(in, out);
+}
+
+std::vector<std::string> getConstants(DataValueType)
+{
+	return dataValueTypes.getNames();
+}
+
+bool getConstant(const char *in, Endianness &out)
+{
+	return endiannesses.find(in, out);
+}
+
+bool getConstant(Endianness in, const char *&out)
+{
+	return endiannesses.find(in, out);
+}
+
+std::vector<std::string> getConstants(Endianness)
+{
+	return endiannesses.getNames();
+}
+
 } // data
 } // love
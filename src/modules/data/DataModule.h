@@ -22,9 +22,13 @@
 
 #include "CompressedData.h"
 #include "Compressor.h"
+#include "CompressionStream.h"
+#include "CompressionContext.h"
+#include "Hasher.h"
 #include "HashFunction.h"
 #include "DataView.h"
 #include "ByteData.h"
+#include "ByteDataBuilder.h"
 
 // LOVE
 #include "common/Module.h"
@@ -49,6 +53,28 @@ enum ContainerType
 	CONTAINER_MAX_ENUM
 };
 
+// Types for reading and writing numbers stored in any Data.
+enum DataValueType
+{
+	DATAVALUE_INT8,
+	DATAVALUE_UINT8,
+	DATAVALUE_INT16,
+	DATAVALUE_UINT16,
+	DATAVALUE_INT32,
+	DATAVALUE_UINT32,
+	DATAVALUE_FLOAT,
+	DATAVALUE_DOUBLE,
+	DATAVALUE_MAX_ENUM
+};
+
+enum Endianness
+{
+	ENDIAN_NATIVE,
+	ENDIAN_LITTLE,
+	ENDIAN_BIG,
+	ENDIAN_MAX_ENUM
+};
+
 /**
  * Compresses a block of memory using the given compression format.
  *
@@ -84,9 +110,35 @@ char *decompress(CompressedData *data, size_t &decompressedsize);
  **/
 char *decompress(Compressor::Format format, const char *cbytes, size_t compressedsize, size_t &rawsize);
 
+/**
+ * Decompresses into an existing buffer without allocating one. Throws an
+ * exception if the result doesn't fit in dstsize bytes.
+ *
+ * @return The number of bytes written to dst.
+ **/
+size_t decompressInto(CompressedData *data, char *dst, size_t dstsize);
+size_t decompressInto(Compressor::Format format, const char *cbytes, size_t compressedsize, char *dst, size_t dstsize);
+
 char *encode(EncodeFormat format, const char *src, size_t srclen, size_t &dstlen, size_t linelen = 0);
 char *decode(EncodeFormat format, const char *src, size_t srclen, size_t &dstlen);
 
+/**
+ * Gets the size in bytes of the encoded form of srclen bytes.
+ **/
+size_t getEncodedSize(EncodeFormat format, size_t srclen, size_t linelen = 0);
+
+/**
+ * Encodes or decodes into an existing buffer, so large payloads can be
+ * processed a chunk at a time without intermediate allocations. Base64 chunks
+ * concatenate cleanly when each chunk's size is a multiple of 3 bytes when
+ * encoding, or 4 characters when decoding. Throws an exception if the output
+ * doesn't fit in dstsize bytes.
+ *
+ * @return The number of bytes written to dst.
+ **/
+size_t encodeInto(EncodeFormat format, const char *src, size_t srclen, char *dst, size_t dstsize, size_t linelen = 0);
+size_t decodeInto(EncodeFormat format, const char *src, size_t srclen, char *dst, size_t dstsize);
+
 /**
  * Hash the input, producing an set of bytes as output.
  *
@@ -100,6 +152,17 @@ std::string hash(HashFunction::Function function, const char *input, uint64_t si
 void hash(HashFunction::Function function, Data *input, HashFunction::Value &output);
 void hash(HashFunction::Function function, const char *input, uint64_t size, HashFunction::Value &output);
 
+/**
+ * Gets the size in bytes of a single value of the given type.
+ **/
+size_t getDataValueSize(DataValueType type);
+
+/**
+ * Whether values with the given endianness need their bytes swapped on this
+ * system.
+ **/
+bool needsByteSwap(Endianness endianness);
+
 
 bool getConstant(const char *in, EncodeFormat &out);
 bool getConstant(EncodeFormat in, const char *&out);
@@ -109,6 +172,14 @@ bool getConstant(const char *in, ContainerType &out);
 bool getConstant(ContainerType in, const char *&out);
 std::vector<std::string> getConstants(ContainerType);
 
+bool getConstant(const char *in, DataValueType &out);
+bool getConstant(DataValueType in, const char *&out);
+std::vector<std::string> getConstants(DataValueType);
+
+bool getConstant(const char *in, Endianness &out);
+bool getConstant(Endianness in, const char *&out);
+std::vector<std::string> getConstants(Endianness);
+
 
 class DataModule : public Module
 {
@@ -124,6 +195,10 @@ public:
 	ByteData *newByteData(size_t size);
 	ByteData *newByteData(const void *d, size_t size);
 	ByteData *newByteData(void *d, size_t size, bool own);
+	ByteDataBuilder *newByteDataBuilder(size_t capacity);
+	CompressionStream *newCompressionStream(Compressor::Format format, CompressionStream::Mode mode, int level = -1);
+	CompressionContext *newCompressionContext(Compressor::Format format, int level, Data *dictionary);
+	Hasher *newHasher(HashFunction::Function function);
 
 	static DataModule instance;
 
@@ -19,10 +19,32 @@
  **/
 
 #include "HashFunction.h"
+#include "common/Exception.h"
+#include "common/cpu.h"
 
-// FIXME: Probably trivial by having tole and tobe functions, which can be ifdeffed to being identity functions
-#ifdef LOVE_BIG_ENDIAN
-#	error Hashing not yet implemented for big endian
+#define XXH_STATIC_LINKING_ONLY
+#include "libraries/xxHash/xxhash.h"
+
+// C++
+#include <algorithm>
+
+// C
+#include <cstring>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+#if defined(LOVE_CPU_X86)
+#	define LOVE_HASH_SHA_X86
+#	include <immintrin.h>
+#endif
+
+// Only when the compiler targets the crypto extensions (or is MSVC, which
+// always exposes them); GCC and Clang disagree on the per-function spelling.
+#if defined(LOVE_CPU_ARM64) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2) || defined(_MSC_VER))
+#	define LOVE_HASH_SHA_ARM
+#	include <arm_neon.h>
 #endif
 
 namespace love
@@ -45,11 +67,173 @@ inline uint32 rightrot(uint32 x, uint8 amount)
 	return (x >> amount) | (x << (32 - amount));
 }
 
+inline uint64 leftrot(uint64 x, uint8 amount)
+{
+	return (x << amount) | (x >> (64 - amount));
+}
+
 inline uint64 rightrot(uint64 x, uint8 amount)
 {
 	return (x >> amount) | (x << (64 - amount));
 }
 
+// Byte-wise loads, so the implementations below work regardless of the
+// alignment of the input and the endianness of the host.
+inline uint32 load32le(const uint8 *p)
+{
+	return (uint32) p[0] | ((uint32) p[1] << 8) | ((uint32) p[2] << 16) | ((uint32) p[3] << 24);
+}
+
+inline uint32 load32be(const uint8 *p)
+{
+	return ((uint32) p[0] << 24) | ((uint32) p[1] << 16) | ((uint32) p[2] << 8) | (uint32) p[3];
+}
+
+inline uint64 load64le(const uint8 *p)
+{
+	return (uint64) load32le(p) | ((uint64) load32le(p + 4) << 32);
+}
+
+inline uint64 load64be(const uint8 *p)
+{
+	return ((uint64) load32be(p) << 32) | (uint64) load32be(p + 4);
+}
+
+/**
+ * Shared buffering and padding for the Merkle-Damgård hashes below (MD5 and
+ * the SHA family), which only differ in their block function, word size and
+ * byte order. Full blocks are processed straight from the input.
+ **/
+template <typename Core>
+class BlockContext : public HashFunction::Context
+{
+public:
+
+	typedef typename Core::Word Word;
+
+	BlockContext(HashFunction::Function function)
+		: function(function)
+	{
+		reset();
+	}
+
+	void update(const char *input, uint64 length) override
+	{
+		const uint8 *in = (const uint8 *) input;
+		totalLength += length;
+
+		if (bufferSize > 0)
+		{
+			size_t n = (size_t) std::min<uint64>(length, Core::BLOCK_SIZE - bufferSize);
+			memcpy(buffer + bufferSize, in, n);
+
+			bufferSize += n;
+			in += n;
+			length -= n;
+
+			if (bufferSize < Core::BLOCK_SIZE)
+				return;
+
+			Core::process(state, buffer, 1);
+			bufferSize = 0;
+		}
+
+		size_t blocks = (size_t) (length / Core::BLOCK_SIZE);
+		if (blocks > 0)
+		{
+			Core::process(state, in, blocks);
+			in += blocks * Core::BLOCK_SIZE;
+			length -= blocks * Core::BLOCK_SIZE;
+		}
+
+		memcpy(buffer, in, (size_t) length);
+		bufferSize = (size_t) length;
+	}
+
+	void digest(HashFunction::Value &output) const override
+	{
+		Word final[8];
+		memcpy(final, state, sizeof(state));
+
+		// The padding is a single 1 bit, zeroes, then the message length in
+		// bits, in one or two blocks depending on how much space is left.
+		uint8 padded[Core::BLOCK_SIZE * 2];
+		size_t paddedsize = Core::BLOCK_SIZE;
+		if (bufferSize + 1 + Core::LENGTH_SIZE > Core::BLOCK_SIZE)
+			paddedsize += Core::BLOCK_SIZE;
+
+		memcpy(padded, buffer, bufferSize);
+		padded[bufferSize] = 0x80;
+		memset(padded + bufferSize + 1, 0, paddedsize - bufferSize - 1);
+
+		uint64 bits = totalLength * 8;
+		for (int i = 0; i < 8; i++)
+		{
+			if (Core::bigEndian)
+				padded[paddedsize - 1 - i] = (uint8) (bits >> (i * 8));
+			else
+				padded[paddedsize - 8 + i] = (uint8) (bits >> (i * 8));
+		}
+
+		Core::process(final, padded, paddedsize / Core::BLOCK_SIZE);
+
+		output.size = Core::getDigestSize(function);
+
+		for (size_t i = 0; i < output.size; i++)
+		{
+			size_t byte = i % sizeof(Word);
+			size_t shift = Core::bigEndian ? (sizeof(Word) - 1 - byte) * 8 : byte * 8;
+			output.data[i] = (char) ((final[i / sizeof(Word)] >> shift) & 0xFF);
+		}
+	}
+
+	void reset() override
+	{
+		Core::init(function, state);
+		bufferSize = 0;
+		totalLength = 0;
+	}
+
+private:
+
+	HashFunction::Function function;
+	Word state[8];
+	uint8 buffer[Core::BLOCK_SIZE];
+	size_t bufferSize;
+	uint64 totalLength;
+
+}; // BlockContext
+
+template <typename Core>
+class BlockHashFunction : public HashFunction
+{
+public:
+
+	bool isSupported(Function function) const override
+	{
+		return Core::isSupported(function);
+	}
+
+	void hash(Function function, const char *input, uint64 length, Value &output) const override
+	{
+		if (!isSupported(function))
+			throw love::Exception("Hash function not supported by %s implementation", Core::name);
+
+		BlockContext<Core> context(function);
+		context.update(input, length);
+		context.digest(output);
+	}
+
+	Context *newContext(Function function) const override
+	{
+		if (!isSupported(function))
+			throw love::Exception("Hash function not supported by %s implementation", Core::name);
+
+		return new BlockContext<Core>(function);
+	}
+
+}; // BlockHashFunction
+
 /**
  * The following implementation is based on the pseudocode provided by multiple
  * authors on wikipedia: https://en.wikipedia.org/wiki/MD5
@@ -57,106 +241,102 @@ inline uint64 rightrot(uint64 x, uint8 amount)
  * information is present. I believe this note, and the zlib license of this
  * project satisfy the conditions of the license.
  **/
-class MD5 : public HashFunction
+struct MD5Core
 {
-private:
+	typedef uint32 Word;
+
+	static const size_t BLOCK_SIZE = 64;
+	static const size_t LENGTH_SIZE = 8;
+	static const bool bigEndian = false;
+	static const char *name;
+
 	static const uint8 shifts[64];
 	static const uint32 constants[64];
 
-public:
-	bool isSupported(Function function) const override
+	static bool isSupported(HashFunction::Function function)
 	{
-		return function == FUNCTION_MD5;
+		return function == HashFunction::FUNCTION_MD5;
 	}
 
-	void hash(Function function, const char *input, uint64 length, Value &output) const override
+	static size_t getDigestSize(HashFunction::Function)
 	{
-		if (function != FUNCTION_MD5)
-			throw love::Exception("Hash function not supported by MD5 implementation");
-
-		uint32 a0 = 0x67452301;
-		uint32 b0 = 0xefcdab89;
-		uint32 c0 = 0x98badcfe;
-		uint32 d0 = 0x10325476;
-
-		// Do the required padding
-		uint64 paddedLength = length;
-		if (length % 64 < 56)
-			paddedLength += 56-length%64;
-		if (length % 64 > 56)
-			paddedLength += 120-length%64;
-		uint8 *padded = new uint8[paddedLength+8];
-		memcpy(padded, input, length);
-		memset(padded+length, 0, paddedLength-length);
-		padded[length] = 0x80;
-		*((uint64*) &padded[paddedLength]) = length*8;
-		paddedLength += 8;
-
-		for (uint64 i = 0; i < paddedLength; i += 64)
-		{
-			uint32 *chunk = (uint32*) &padded[i];
+		return 16;
+	}
 
-			uint32 A = a0;
-			uint32 B = b0;
-			uint32 C = c0;
-			uint32 D = d0;
-			uint32 F;
-			uint32 g;
+	static void init(HashFunction::Function, Word *state)
+	{
+		state[0] = 0x67452301;
+		state[1] = 0xefcdab89;
+		state[2] = 0x98badcfe;
+		state[3] = 0x10325476;
+	}
 
-			for (int j = 0; j < 64; j++)
-			{
-				if (j < 16)
-				{
-					F = (B & C) | (~B & D);
-					g = j;
-				}
-				else if (j < 32)
-				{
-					F = (D & B) | (~D & C);
-					g = (5*j + 1) % 16;
-				}
-				else if (j < 48)
-				{
-					F = B ^ C ^ D;
-					g = (3*j + 5) % 16;
-				}
-				else
-				{
-					F = C ^ (B | ~D);
-					g = (7*j) % 16;
-				}
+	static void process(Word *state, const uint8 *blocks, size_t count)
+	{
+		for (; count > 0; count--, blocks += BLOCK_SIZE)
+			processBlock(state, blocks);
+	}
 
-				uint32 temp = D;
-				D = C;
-				C = B;
-				B += leftrot(A + F + constants[j] + chunk[g], shifts[j]);
-				A = temp;
+	static void processBlock(Word *state, const uint8 *block)
+	{
+		uint32 chunk[16];
+		for (int j = 0; j < 16; j++)
+			chunk[j] = load32le(block + j * 4);
+
+		uint32 A = state[0];
+		uint32 B = state[1];
+		uint32 C = state[2];
+		uint32 D = state[3];
+		uint32 F;
+		uint32 g;
+
+		for (int j = 0; j < 64; j++)
+		{
+			if (j < 16)
+			{
+				F = (B & C) | (~B & D);
+				g = j;
+			}
+			else if (j < 32)
+			{
+				F = (D & B) | (~D & C);
+				g = (5*j + 1) % 16;
+			}
+			else if (j < 48)
+			{
+				F = B ^ C ^ D;
+				g = (3*j + 5) % 16;
+			}
+			else
+			{
+				F = C ^ (B | ~D);
+				g = (7*j) % 16;
 			}
 
-			a0 += A;
-			b0 += B;
-			c0 += C;
-			d0 += D;
+			uint32 temp = D;
+			D = C;
+			C = B;
+			B += leftrot(A + F + constants[j] + chunk[g], shifts[j]);
+			A = temp;
 		}
 
-		delete[] padded;
-
-		memcpy(&output.data[ 0], &a0, 4);
-		memcpy(&output.data[ 4], &b0, 4);
-		memcpy(&output.data[ 8], &c0, 4);
-		memcpy(&output.data[12], &d0, 4);
-		output.size = 16;
+		state[0] += A;
+		state[1] += B;
+		state[2] += C;
+		state[3] += D;
 	}
-} md5;
+};
+
+const char *MD5Core::name = "MD5";
 
-const uint8 MD5::shifts[64] = {
+const uint8 MD5Core::shifts[64] = {
 	7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
 	5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
 	4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
 	6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21,
 };
 
-const uint32 MD5::constants[64] = {
+const uint32 MD5Core::constants[64] = {
 	0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
 	0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
 	0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
@@ -180,234 +360,222 @@ const uint32 MD5::constants[64] = {
  * in RFC3174. I believe this means no copyright other than that of the LÖVE
  * Development Team applies.
  **/
-class SHA1 : public HashFunction
+struct SHA1Core
 {
-public:
-	bool isSupported(Function function) const override
+	typedef uint32 Word;
+
+	static const size_t BLOCK_SIZE = 64;
+	static const size_t LENGTH_SIZE = 8;
+	static const bool bigEndian = true;
+	static const char *name;
+
+	static bool isSupported(HashFunction::Function function)
 	{
-		return function == FUNCTION_SHA1;
+		return function == HashFunction::FUNCTION_SHA1;
 	}
 
-	void hash(Function function, const char *input, uint64 length, Value &output) const override
+	static size_t getDigestSize(HashFunction::Function)
 	{
-		if (function != FUNCTION_SHA1)
-			throw love::Exception("Hash function not supported by SHA1 implementation");
-
-		uint32 intermediate[5] = {
-			0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0
-		};
-
-		// Same padding as for md5, but then big-endian
-		uint64 paddedLength = length;
-		if (length % 64 < 56)
-			paddedLength += 56-length%64;
-		if (length % 64 > 56)
-			paddedLength += 120-length%64;
-		uint8 *padded = new uint8[paddedLength+8];
-		memcpy(padded, input, length);
-		memset(padded+length, 0, paddedLength-length);
-		padded[length] = 0x80;
-
-		// Now we need the length in bits
-		length *= 8;
-		for (int i = 0; i < 8; ++i, ++paddedLength)
-			padded[paddedLength] = (length >> (56-i*8)) & 0xFF;
-
-		// Allocate our extended words
-		uint32 words[80];
+		return 20;
+	}
 
-		for (uint64 i = 0; i < paddedLength; i += 64)
-		{
-			uint32 *chunk = (uint32*) &padded[i];
-			for (int j = 0; j < 16; j++)
-			{
-				char *c = (char*) &words[j];
-				c[0] = (chunk[j] >> 24) & 0xFF;
-				c[1] = (chunk[j] >> 16) & 0xFF;
-				c[2] = (chunk[j] >>  8) & 0xFF;
-				c[3] = (chunk[j] >>  0) & 0xFF;
-			}
-			for (int j = 16; j < 80; j++)
-				words[j] = leftrot(words[j-3] ^ words[j-8] ^ words[j-14] ^ words[j-16], 1);
+	static void init(HashFunction::Function, Word *state)
+	{
+		state[0] = 0x67452301;
+		state[1] = 0xEFCDAB89;
+		state[2] = 0x98BADCFE;
+		state[3] = 0x10325476;
+		state[4] = 0xC3D2E1F0;
+	}
 
-			uint32 A = intermediate[0];
-			uint32 B = intermediate[1];
-			uint32 C = intermediate[2];
-			uint32 D = intermediate[3];
-			uint32 E = intermediate[4];
+	static void process(Word *state, const uint8 *blocks, size_t count)
+	{
+#ifdef LOVE_HASH_SHA_X86
+		if (getCPUFeatures().sha)
+			return processX86(state, blocks, count);
+#endif
+#ifdef LOVE_HASH_SHA_ARM
+		if (getCPUFeatures().armSHA1)
+			return processARM(state, blocks, count);
+#endif
+		for (; count > 0; count--, blocks += BLOCK_SIZE)
+			processBlock(state, blocks);
+	}
 
-			for (int j = 0; j < 80; j++)
-			{
-				uint32 temp = leftrot(A, 5) + E + words[j];
-
-				if (j < 20)
-					temp += 0x5A827999 + ((B & C) | (~B & D));
-				else if (j < 40)
-					temp += 0x6ED9EBA1 + (B ^ C ^ D);
-				else if (j < 60)
-					temp += 0x8F1BBCDC + ((B & C) | (B & D) | (C & D));
-				else
-					temp += 0xCA62C1D6 + (B ^ C ^ D);
-
-				E = D;
-				D = C;
-				C = leftrot(B, 30);
-				B = A;
-				A = temp;
-			}
+#ifdef LOVE_HASH_SHA_X86
+	LOVE_TARGET("sha,sse4.1") static void processX86(Word *state, const uint8 *blocks, size_t count);
+#endif
+#ifdef LOVE_HASH_SHA_ARM
+	static void processARM(Word *state, const uint8 *blocks, size_t count);
+#endif
 
-			intermediate[0] += A;
-			intermediate[1] += B;
-			intermediate[2] += C;
-			intermediate[3] += D;
-			intermediate[4] += E;
-		}
+	static void processBlock(Word *state, const uint8 *block)
+	{
+		// Our extended words
+		uint32 words[80];
 
-		delete[] padded;
+		for (int j = 0; j < 16; j++)
+			words[j] = load32be(block + j * 4);
+		for (int j = 16; j < 80; j++)
+			words[j] = leftrot(words[j-3] ^ words[j-8] ^ words[j-14] ^ words[j-16], 1);
 
-		for (int i = 0; i < 20; i += 4)
+		uint32 A = state[0];
+		uint32 B = state[1];
+		uint32 C = state[2];
+		uint32 D = state[3];
+		uint32 E = state[4];
+
+		for (int j = 0; j < 80; j++)
 		{
-			output.data[i+0] = (intermediate[i/4] >> 24) & 0xFF;
-			output.data[i+1] = (intermediate[i/4] >> 16) & 0xFF;
-			output.data[i+2] = (intermediate[i/4] >>  8) & 0xFF;
-			output.data[i+3] = (intermediate[i/4] >>  0) & 0xFF;
+			uint32 temp = leftrot(A, 5) + E + words[j];
+
+			if (j < 20)
+				temp += 0x5A827999 + ((B & C) | (~B & D));
+			else if (j < 40)
+				temp += 0x6ED9EBA1 + (B ^ C ^ D);
+			else if (j < 60)
+				temp += 0x8F1BBCDC + ((B & C) | (B & D) | (C & D));
+			else
+				temp += 0xCA62C1D6 + (B ^ C ^ D);
+
+			E = D;
+			D = C;
+			C = leftrot(B, 30);
+			B = A;
+			A = temp;
 		}
 
-		output.size = 20;
+		state[0] += A;
+		state[1] += B;
+		state[2] += C;
+		state[3] += D;
+		state[4] += E;
 	}
-} sha1;
+};
+
+const char *SHA1Core::name = "SHA1";
 
 /**
  * This implementation was based on the description in RFC-6234.
  **/
 // SHA-2: SHA-224 and SHA-256
-class SHA256 : public HashFunction
+struct SHA256Core
 {
-private:
+	typedef uint32 Word;
+
+	static const size_t BLOCK_SIZE = 64;
+	static const size_t LENGTH_SIZE = 8;
+	static const bool bigEndian = true;
+	static const char *name;
+
 	static const uint32 initial224[8];
 	static const uint32 initial256[8];
 	static const uint32 constants[64];
 
-public:
-	bool isSupported(Function function) const override
+	static bool isSupported(HashFunction::Function function)
 	{
-		return function == FUNCTION_SHA224 || function == FUNCTION_SHA256;
+		return function == HashFunction::FUNCTION_SHA224 || function == HashFunction::FUNCTION_SHA256;
 	}
 
-	void hash(Function function, const char *input, uint64 length, Value &output) const override
+	static size_t getDigestSize(HashFunction::Function function)
 	{
-		if (!isSupported(function))
-			throw love::Exception("Hash function not supported by SHA-224/SHA-256 implementation");
-
-		// Same padding as for sha1
-		uint64 paddedLength = length;
-		if (length % 64 < 56)
-			paddedLength += 56-length%64;
-		if (length % 64 > 56)
-			paddedLength += 120-length%64;
-		uint8 *padded = new uint8[paddedLength+8];
-		memcpy(padded, input, length);
-		memset(padded+length, 0, paddedLength-length);
-		padded[length] = 0x80;
-
-		// Now we need the length in bits
-		length *= 8;
-		for (int i = 0; i < 8; ++i, ++paddedLength)
-			padded[paddedLength] = (length >> (56-i*8)) & 0xFF;
-
-		uint32 intermediate[8];
-		if (function == FUNCTION_SHA224)
-			memcpy(intermediate, initial224, sizeof(intermediate));
-		else
-			memcpy(intermediate, initial256, sizeof(intermediate));
+		return function == HashFunction::FUNCTION_SHA224 ? 28 : 32;
+	}
 
-		// Allocate our extended words
-		uint32 words[64];
+	static void init(HashFunction::Function function, Word *state)
+	{
+		if (function == HashFunction::FUNCTION_SHA224)
+			memcpy(state, initial224, sizeof(initial224));
+		else
+			memcpy(state, initial256, sizeof(initial256));
+	}
 
-		for (uint64 i = 0; i < paddedLength; i += 64)
-		{
-			uint32 *chunk = (uint32*) &padded[i];
-			for (int j = 0; j < 16; j++)
-			{
-				char *c = (char*) &words[j];
-				c[0] = (chunk[j] >> 24) & 0xFF;
-				c[1] = (chunk[j] >> 16) & 0xFF;
-				c[2] = (chunk[j] >>  8) & 0xFF;
-				c[3] = (chunk[j] >>  0) & 0xFF;
-			}
-			for (int j = 16; j < 64; j++)
-			{
-				words[j] = rightrot(words[j-2], 17) ^ rightrot(words[j-2], 19) ^ (words[j-2] >> 10);
-				words[j] += rightrot(words[j-15], 7) ^ rightrot(words[j-15], 18) ^ (words[j-15] >> 3);
-				words[j] += words[j-7] + words[j-16];
-			}
+	static void process(Word *state, const uint8 *blocks, size_t count)
+	{
+#ifdef LOVE_HASH_SHA_X86
+		if (getCPUFeatures().sha)
+			return processX86(state, blocks, count);
+#endif
+#ifdef LOVE_HASH_SHA_ARM
+		if (getCPUFeatures().armSHA2)
+			return processARM(state, blocks, count);
+#endif
+		for (; count > 0; count--, blocks += BLOCK_SIZE)
+			processBlock(state, blocks);
+	}
 
-			uint32 A = intermediate[0];
-			uint32 B = intermediate[1];
-			uint32 C = intermediate[2];
-			uint32 D = intermediate[3];
-			uint32 E = intermediate[4];
-			uint32 F = intermediate[5];
-			uint32 G = intermediate[6];
-			uint32 H = intermediate[7];
+#ifdef LOVE_HASH_SHA_X86
+	LOVE_TARGET("sha,sse4.1") static void processX86(Word *state, const uint8 *blocks, size_t count);
+#endif
+#ifdef LOVE_HASH_SHA_ARM
+	static void processARM(Word *state, const uint8 *blocks, size_t count);
+#endif
 
-			for (int j = 0; j < 64; j++)
-			{
-				uint32 temp1 = H + constants[j] + words[j];
-				temp1 += rightrot(E, 6) ^ rightrot(E, 11) ^ rightrot(E, 25);
-				temp1 += (E & F) ^ (~E & G);
-				uint32 temp2 = rightrot(A, 2) ^ rightrot(A, 13) ^ rightrot(A, 22);
-				temp2 += (A & B) ^ (A & C) ^ (B & C);
-
-				H = G;
-				G = F;
-				F = E;
-				E = D + temp1;
-				D = C;
-				C = B;
-				B = A;
-				A = temp1 + temp2;
-			}
+	static void processBlock(Word *state, const uint8 *block)
+	{
+		// Our extended words
+		uint32 words[64];
 
-			intermediate[0] += A;
-			intermediate[1] += B;
-			intermediate[2] += C;
-			intermediate[3] += D;
-			intermediate[4] += E;
-			intermediate[5] += F;
-			intermediate[6] += G;
-			intermediate[7] += H;
+		for (int j = 0; j < 16; j++)
+			words[j] = load32be(block + j * 4);
+		for (int j = 16; j < 64; j++)
+		{
+			words[j] = rightrot(words[j-2], 17) ^ rightrot(words[j-2], 19) ^ (words[j-2] >> 10);
+			words[j] += rightrot(words[j-15], 7) ^ rightrot(words[j-15], 18) ^ (words[j-15] >> 3);
+			words[j] += words[j-7] + words[j-16];
 		}
 
-		delete[] padded;
+		uint32 A = state[0];
+		uint32 B = state[1];
+		uint32 C = state[2];
+		uint32 D = state[3];
+		uint32 E = state[4];
+		uint32 F = state[5];
+		uint32 G = state[6];
+		uint32 H = state[7];
 
-		int hashlength = 32;
-		if (function == FUNCTION_SHA224)
-			hashlength = 28;
-
-		for (int i = 0; i < hashlength; i += 4)
+		for (int j = 0; j < 64; j++)
 		{
-			output.data[i+0] = (intermediate[i/4] >> 24) & 0xFF;
-			output.data[i+1] = (intermediate[i/4] >> 16) & 0xFF;
-			output.data[i+2] = (intermediate[i/4] >>  8) & 0xFF;
-			output.data[i+3] = (intermediate[i/4] >>  0) & 0xFF;
+			uint32 temp1 = H + constants[j] + words[j];
+			temp1 += rightrot(E, 6) ^ rightrot(E, 11) ^ rightrot(E, 25);
+			temp1 += (E & F) ^ (~E & G);
+			uint32 temp2 = rightrot(A, 2) ^ rightrot(A, 13) ^ rightrot(A, 22);
+			temp2 += (A & B) ^ (A & C) ^ (B & C);
+
+			H = G;
+			G = F;
+			F = E;
+			E = D + temp1;
+			D = C;
+			C = B;
+			B = A;
+			A = temp1 + temp2;
 		}
 
-		output.size = hashlength;
+		state[0] += A;
+		state[1] += B;
+		state[2] += C;
+		state[3] += D;
+		state[4] += E;
+		state[5] += F;
+		state[6] += G;
+		state[7] += H;
 	}
-} sha256;
+};
 
-const uint32 SHA256::initial224[8] = {
+const char *SHA256Core::name = "SHA-224/SHA-256";
+
+const uint32 SHA256Core::initial224[8] = {
 	0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939,
 	0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4,
 };
 
-const uint32 SHA256::initial256[8] = {
+const uint32 SHA256Core::initial256[8] = {
 	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
 	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
 };
 
-const uint32 SHA256::constants[64] = {
+const uint32 SHA256Core::constants[64] = {
 	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
 	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
 	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
@@ -429,142 +597,108 @@ const uint32 SHA256::constants[64] = {
 /**
  * This implementation was based on the description in RFC-6234.
  **/
-// SHA-2: SHA-224 and SHA-256
-class SHA512 : public HashFunction
+// SHA-2: SHA-384 and SHA-512
+struct SHA512Core
 {
-private:
+	typedef uint64 Word;
+
+	static const size_t BLOCK_SIZE = 128;
+	static const size_t LENGTH_SIZE = 16;
+	static const bool bigEndian = true;
+	static const char *name;
+
 	static const uint64 initial384[8];
 	static const uint64 initial512[8];
 	static const uint64 constants[80];
 
-public:
-	bool isSupported(Function function) const override
+	static bool isSupported(HashFunction::Function function)
 	{
-		return function == FUNCTION_SHA384 || function == FUNCTION_SHA512;
+		return function == HashFunction::FUNCTION_SHA384 || function == HashFunction::FUNCTION_SHA512;
 	}
 
-	void hash(Function function, const char *input, uint64 length, Value &output) const override
+	static size_t getDigestSize(HashFunction::Function function)
 	{
-		if (!isSupported(function))
-			throw love::Exception("Hash function not supported by SHA-384/SHA-512 implementation");
+		return function == HashFunction::FUNCTION_SHA384 ? 48 : 64;
+	}
 
-		uint64 intermediates[8];
-		if (function == FUNCTION_SHA384)
-			memcpy(intermediates, initial384, sizeof(intermediates));
+	static void init(HashFunction::Function function, Word *state)
+	{
+		if (function == HashFunction::FUNCTION_SHA384)
+			memcpy(state, initial384, sizeof(initial384));
 		else
-			memcpy(intermediates, initial512, sizeof(intermediates));
-
-		uint64 paddedLength = length;
-		if (length % 128 < 112)
-			paddedLength += 112-length%128;
-		if (length % 128 > 112)
-			paddedLength += 240-length%128;
-		uint8 *padded = new uint8[paddedLength+16];
-		paddedLength += 8;
-		memcpy(padded, input, length);
-		memset(padded+length, 0, paddedLength-length);
-		padded[length] = 0x80;
-
-		// Now we need the length in bits, note we only write a 64-bit int, so
-		// we have filled the first 8 bytes with zeroes
-		length *= 8;
-		for (int i = 0; i < 8; ++i, ++paddedLength)
-			padded[paddedLength] = (length >> (56-i*8)) & 0xFF;
-
-		// Allocate our extended words
-		uint64 words[80];
-
-		for (uint64 i = 0; i < paddedLength; i += 128)
-		{
-			uint64 *chunk = (uint64*) &padded[i];
-			for (int j = 0; j < 16; ++j)
-			{
-				char *c = (char*) &words[j];
-				c[0] = (chunk[j] >> 56) & 0xFF;
-				c[1] = (chunk[j] >> 48) & 0xFF;
-				c[2] = (chunk[j] >> 40) & 0xFF;
-				c[3] = (chunk[j] >> 32) & 0xFF;
-				c[4] = (chunk[j] >> 24) & 0xFF;
-				c[5] = (chunk[j] >> 16) & 0xFF;
-				c[6] = (chunk[j] >>  8) & 0xFF;
-				c[7] = (chunk[j] >>  0) & 0xFF;
-			}
-			for (int j = 16; j < 80; ++j)
-			{
-				words[j] = words[j-7] + words[j-16];
-				words[j] += rightrot(words[j-2], 19) ^ rightrot(words[j-2], 61) ^ (words[j-2] >> 6);
-				words[j] += rightrot(words[j-15], 1) ^ rightrot(words[j-15], 8) ^ (words[j-15] >> 7);
-			}
+			memcpy(state, initial512, sizeof(initial512));
+	}
 
-			uint64 A = intermediates[0];
-			uint64 B = intermediates[1];
-			uint64 C = intermediates[2];
-			uint64 D = intermediates[3];
-			uint64 E = intermediates[4];
-			uint64 F = intermediates[5];
-			uint64 G = intermediates[6];
-			uint64 H = intermediates[7];
+	static void process(Word *state, const uint8 *blocks, size_t count)
+	{
+		for (; count > 0; count--, blocks += BLOCK_SIZE)
+			processBlock(state, blocks);
+	}
 
-			for (int j = 0; j < 80; ++j)
-			{
-				uint64 temp1 = H + constants[j] + words[j];
-				temp1 += rightrot(E, 14) ^ rightrot(E, 18) ^ rightrot(E, 41);
-				temp1 += (E & F) ^ (~E & G);
-				uint64 temp2 = rightrot(A, 28) ^ rightrot(A, 34) ^ rightrot(A, 39);
-				temp2 += (A & B) ^ (A & C) ^ (B & C);
-				H = G;
-				G = F;
-				F = E;
-				E = D + temp1;
-				D = C;
-				C = B;
-				B = A;
-				A = temp1 + temp2;
-			}
+	static void processBlock(Word *state, const uint8 *block)
+	{
+		// Our extended words
+		uint64 words[80];
 
-			intermediates[0] += A;
-			intermediates[1] += B;
-			intermediates[2] += C;
-			intermediates[3] += D;
-			intermediates[4] += E;
-			intermediates[5] += F;
-			intermediates[6] += G;
-			intermediates[7] += H;
+		for (int j = 0; j < 16; ++j)
+			words[j] = load64be(block + j * 8);
+		for (int j = 16; j < 80; ++j)
+		{
+			words[j] = words[j-7] + words[j-16];
+			words[j] += rightrot(words[j-2], 19) ^ rightrot(words[j-2], 61) ^ (words[j-2] >> 6);
+			words[j] += rightrot(words[j-15], 1) ^ rightrot(words[j-15], 8) ^ (words[j-15] >> 7);
 		}
 
-		delete[] padded;
-
-		int hashlength = 64;
-		if (function == FUNCTION_SHA384)
-			hashlength = 48;
+		uint64 A = state[0];
+		uint64 B = state[1];
+		uint64 C = state[2];
+		uint64 D = state[3];
+		uint64 E = state[4];
+		uint64 F = state[5];
+		uint64 G = state[6];
+		uint64 H = state[7];
 
-		for (int i = 0; i < hashlength; i += 8)
+		for (int j = 0; j < 80; ++j)
 		{
-			output.data[i+0] = (intermediates[i/8] >> 56) & 0xFF;
-			output.data[i+1] = (intermediates[i/8] >> 48) & 0xFF;
-			output.data[i+2] = (intermediates[i/8] >> 40) & 0xFF;
-			output.data[i+3] = (intermediates[i/8] >> 32) & 0xFF;
-			output.data[i+4] = (intermediates[i/8] >> 24) & 0xFF;
-			output.data[i+5] = (intermediates[i/8] >> 16) & 0xFF;
-			output.data[i+6] = (intermediates[i/8] >>  8) & 0xFF;
-			output.data[i+7] = (intermediates[i/8] >>  0) & 0xFF;
+			uint64 temp1 = H + constants[j] + words[j];
+			temp1 += rightrot(E, 14) ^ rightrot(E, 18) ^ rightrot(E, 41);
+			temp1 += (E & F) ^ (~E & G);
+			uint64 temp2 = rightrot(A, 28) ^ rightrot(A, 34) ^ rightrot(A, 39);
+			temp2 += (A & B) ^ (A & C) ^ (B & C);
+			H = G;
+			G = F;
+			F = E;
+			E = D + temp1;
+			D = C;
+			C = B;
+			B = A;
+			A = temp1 + temp2;
 		}
 
-		output.size = hashlength;
+		state[0] += A;
+		state[1] += B;
+		state[2] += C;
+		state[3] += D;
+		state[4] += E;
+		state[5] += F;
+		state[6] += G;
+		state[7] += H;
 	}
-} sha512;
+};
+
+const char *SHA512Core::name = "SHA-384/SHA-512";
 
-const uint64 SHA512::initial384[8] = {
+const uint64 SHA512Core::initial384[8] = {
 	0xcbbb9d5dc1059ed8, 0x629a292a367cd507, 0x9159015a3070dd17, 0x152fecd8f70e5939,
 	0x67332667ffc00b31, 0x8eb44a8768581511, 0xdb0c2e0d64f98fa7, 0x47b5481dbefa4fa4,
 };
 
-const uint64 SHA512::initial512[8] = {
+const uint64 SHA512Core::initial512[8] = {
 	0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
 	0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179,
 };
 
-const uint64 SHA512::constants[80] = {
+const uint64 SHA512Core::constants[80] = {
 	0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc,
 	0x3956c25bf348b538, 0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118,
 	0xd807aa98a3030242, 0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
@@ -587,6 +721,801 @@ const uint64 SHA512::constants[80] = {
 	0x4cc5d4becb3e42b6, 0x597f299cfc657e2a, 0x5fcb6fab3ad6faec, 0x6c44198c4a475817,
 };
 
+#ifdef LOVE_HASH_SHA_X86
+
+// The SHA extensions work on the state in a shuffled order (ABEF/CDGH for
+// SHA-256, and ABCD reversed with E in the top lane for SHA-1), so the state
+// is converted once per call rather than per block.
+
+void SHA1Core::processX86(Word *state, const uint8 *blocks, size_t count)
+{
+	const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+	__m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) state), 0x1B);
+	__m128i e0 = _mm_set_epi32((int) state[4], 0, 0, 0);
+
+	for (; count > 0; count--, blocks += BLOCK_SIZE)
+	{
+		__m128i abcdsave = abcd;
+		__m128i e0save = e0;
+
+		__m128i msg[4];
+		for (int i = 0; i < 4; i++)
+			msg[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (blocks + i * 16)), mask);
+
+		__m128i e1 = e0;
+
+		// 20 groups of 4 rounds. Each group's E comes from the ABCD value
+		// before the previous group.
+		for (int i = 0; i < 20; i++)
+		{
+			__m128i e = i == 0 ? _mm_add_epi32(e0, msg[0]) : _mm_sha1nexte_epu32(e1, msg[i & 3]);
+			e1 = abcd;
+
+			switch (i / 5)
+			{
+			case 0:
+				abcd = _mm_sha1rnds4_epu32(abcd, e, 0);
+				break;
+			case 1:
+				abcd = _mm_sha1rnds4_epu32(abcd, e, 1);
+				break;
+			case 2:
+				abcd = _mm_sha1rnds4_epu32(abcd, e, 2);
+				break;
+			default:
+				abcd = _mm_sha1rnds4_epu32(abcd, e, 3);
+				break;
+			}
+
+			// Message schedule for the group 4 ahead.
+			if (i < 16)
+			{
+				__m128i w = _mm_sha1msg1_epu32(msg[i & 3], msg[(i + 1) & 3]);
+				w = _mm_xor_si128(w, msg[(i + 2) & 3]);
+				msg[i & 3] = _mm_sha1msg2_epu32(w, msg[(i + 3) & 3]);
+			}
+		}
+
+		e0 = _mm_sha1nexte_epu32(e1, e0save);
+		abcd = _mm_add_epi32(abcd, abcdsave);
+	}
+
+	_mm_storeu_si128((__m128i *) state, _mm_shuffle_epi32(abcd, 0x1B));
+	state[4] = (uint32) _mm_extract_epi32(e0, 3);
+}
+
+void SHA256Core::processX86(Word *state, const uint8 *blocks, size_t count)
+{
+	const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+	__m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) &state[0]), 0xB1);
+	__m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) &state[4]), 0x1B);
+	__m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+	state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+	for (; count > 0; count--, blocks += BLOCK_SIZE)
+	{
+		__m128i abefsave = state0;
+		__m128i cdghsave = state1;
+
+		__m128i msg[4];
+		for (int i = 0; i < 4; i++)
+			msg[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (blocks + i * 16)), mask);
+
+		// 16 groups of 4 rounds.
+		for (int i = 0; i < 16; i++)
+		{
+			__m128i k = _mm_add_epi32(msg[i & 3], _mm_loadu_si128((const __m128i *) &constants[i * 4]));
+			state1 = _mm_sha256rnds2_epu32(state1, state0, k);
+			state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(k, 0x0E));
+
+			// Message schedule for the group 4 ahead.
+			if (i < 12)
+			{
+				__m128i w = _mm_sha256msg1_epu32(msg[i & 3], msg[(i + 1) & 3]);
+				w = _mm_add_epi32(w, _mm_alignr_epi8(msg[(i + 3) & 3], msg[(i + 2) & 3], 4));
+				msg[i & 3] = _mm_sha256msg2_epu32(w, msg[(i + 3) & 3]);
+			}
+		}
+
+		state0 = _mm_add_epi32(state0, abefsave);
+		state1 = _mm_add_epi32(state1, cdghsave);
+	}
+
+	tmp = _mm_shuffle_epi32(state0, 0x1B);
+	state1 = _mm_shuffle_epi32(state1, 0xB1);
+	_mm_storeu_si128((__m128i *) &state[0], _mm_blend_epi16(tmp, state1, 0xF0));
+	_mm_storeu_si128((__m128i *) &state[4], _mm_alignr_epi8(state1, tmp, 8));
+}
+
+#endif // LOVE_HASH_SHA_X86
+
+#ifdef LOVE_HASH_SHA_ARM
+
+void SHA1Core::processARM(Word *state, const uint8 *blocks, size_t count)
+{
+	static const uint32 k[4] = {0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xCA62C1D6};
+
+	uint32x4_t abcd = vld1q_u32(state);
+	uint32 e0 = state[4];
+
+	for (; count > 0; count--, blocks += BLOCK_SIZE)
+	{
+		uint32x4_t abcdsave = abcd;
+		uint32 e0save = e0;
+
+		uint32x4_t msg[4];
+		for (int i = 0; i < 4; i++)
+			msg[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + i * 16)));
+
+		// 20 groups of 4 rounds.
+		for (int i = 0; i < 20; i++)
+		{
+			uint32x4_t w = vaddq_u32(msg[i & 3], vdupq_n_u32(k[i / 5]));
+			uint32 e1 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+
+			if (i < 5)
+				abcd = vsha1cq_u32(abcd, e0, w);
+			else if (i >= 10 && i < 15)
+				abcd = vsha1mq_u32(abcd, e0, w);
+			else
+				abcd = vsha1pq_u32(abcd, e0, w);
+
+			e0 = e1;
+
+			if (i < 16)
+				msg[i & 3] = vsha1su1q_u32(vsha1su0q_u32(msg[i & 3], msg[(i + 1) & 3], msg[(i + 2) & 3]), msg[(i + 3) & 3]);
+		}
+
+		abcd = vaddq_u32(abcd, abcdsave);
+		e0 += e0save;
+	}
+
+	vst1q_u32(state, abcd);
+	state[4] = e0;
+}
+
+void SHA256Core::processARM(Word *state, const uint8 *blocks, size_t count)
+{
+	uint32x4_t state0 = vld1q_u32(&state[0]);
+	uint32x4_t state1 = vld1q_u32(&state[4]);
+
+	for (; count > 0; count--, blocks += BLOCK_SIZE)
+	{
+		uint32x4_t abcdsave = state0;
+		uint32x4_t efghsave = state1;
+
+		uint32x4_t msg[4];
+		for (int i = 0; i < 4; i++)
+			msg[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + i * 16)));
+
+		// 16 groups of 4 rounds.
+		for (int i = 0; i < 16; i++)
+		{
+			uint32x4_t w = vaddq_u32(msg[i & 3], vld1q_u32(&constants[i * 4]));
+			uint32x4_t prev = state0;
+			state0 = vsha256hq_u32(state0, state1, w);
+			state1 = vsha256h2q_u32(state1, prev, w);
+
+			if (i < 12)
+				msg[i & 3] = vsha256su1q_u32(vsha256su0q_u32(msg[i & 3], msg[(i + 1) & 3]), msg[(i + 2) & 3], msg[(i + 3) & 3]);
+		}
+
+		state0 = vaddq_u32(state0, abcdsave);
+		state1 = vaddq_u32(state1, efghsave);
+	}
+
+	vst1q_u32(&state[0], state0);
+	vst1q_u32(&state[4], state1);
+}
+
+#endif // LOVE_HASH_SHA_ARM
+
+BlockHashFunction<MD5Core> md5;
+BlockHashFunction<SHA1Core> sha1;
+BlockHashFunction<SHA256Core> sha256;
+BlockHashFunction<SHA512Core> sha512;
+
+/**
+ * XXH32 and XXH64 come from the bundled xxHash library. XXH3 (64 and 128 bit,
+ * default secret and seed 0) is implemented below following the xxHash
+ * specification, since the bundled version predates it. Digests use xxHash's
+ * canonical (big-endian) representation, which matches xxhsum's output.
+ **/
+namespace xxh3
+{
+
+static const uint32 PRIME32_1 = 0x9E3779B1U;
+static const uint32 PRIME32_2 = 0x85EBCA77U;
+static const uint32 PRIME32_3 = 0xC2B2AE3DU;
+
+static const uint64 PRIME64_1 = 0x9E3779B185EBCA87ULL;
+static const uint64 PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64 PRIME64_3 = 0x165667B19E3779F9ULL;
+static const uint64 PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64 PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+static const uint64 PRIME_MX1 = 0x165667919E3779F9ULL;
+static const uint64 PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+static const size_t SECRET_SIZE = 192;
+static const size_t SECRET_SIZE_MIN = 136;
+static const size_t STRIPE_LEN = 64;
+static const size_t SECRET_CONSUME_RATE = 8;
+static const size_t STRIPES_PER_BLOCK = (SECRET_SIZE - STRIPE_LEN) / SECRET_CONSUME_RATE;
+static const size_t BLOCK_LEN = STRIPE_LEN * STRIPES_PER_BLOCK;
+static const size_t SECRET_LASTACC_START = 7;
+static const size_t SECRET_MERGEACCS_START = 11;
+static const size_t MIDSIZE_MAX = 240;
+static const size_t MIDSIZE_STARTOFFSET = 3;
+static const size_t MIDSIZE_LASTOFFSET = 17;
+
+static const uint8 secret[SECRET_SIZE] =
+{
+	0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+	0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+	0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+	0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+	0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+	0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+	0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+	0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+	0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+	0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+	0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+	0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+struct Hash128
+{
+	uint64 low;
+	uint64 high;
+};
+
+inline Hash128 mul128(uint64 a, uint64 b)
+{
+	Hash128 r;
+#if defined(__SIZEOF_INT128__)
+	unsigned __int128 product = (unsigned __int128) a * b;
+	r.low = (uint64) product;
+	r.high = (uint64) (product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	r.low = _umul128(a, b, &r.high);
+#else
+	uint64 lolo = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+	uint64 hilo = (a >> 32) * (b & 0xFFFFFFFF);
+	uint64 lohi = (a & 0xFFFFFFFF) * (b >> 32);
+	uint64 hihi = (a >> 32) * (b >> 32);
+	uint64 cross = (lolo >> 32) + (hilo & 0xFFFFFFFF) + lohi;
+	r.high = (hilo >> 32) + (cross >> 32) + hihi;
+	r.low = (cross << 32) | (lolo & 0xFFFFFFFF);
+#endif
+	return r;
+}
+
+inline uint64 mul128fold64(uint64 a, uint64 b)
+{
+	Hash128 r = mul128(a, b);
+	return r.low ^ r.high;
+}
+
+inline uint32 swap32(uint32 x)
+{
+	return ((x << 24) & 0xFF000000) | ((x << 8) & 0x00FF0000) | ((x >> 8) & 0x0000FF00) | ((x >> 24) & 0x000000FF);
+}
+
+inline uint64 swap64(uint64 x)
+{
+	return ((uint64) swap32((uint32) x) << 32) | (uint64) swap32((uint32) (x >> 32));
+}
+
+inline uint64 xxh64Avalanche(uint64 h)
+{
+	h ^= h >> 33;
+	h *= PRIME64_2;
+	h ^= h >> 29;
+	h *= PRIME64_3;
+	h ^= h >> 32;
+	return h;
+}
+
+inline uint64 avalanche(uint64 h)
+{
+	h ^= h >> 37;
+	h *= PRIME_MX1;
+	h ^= h >> 32;
+	return h;
+}
+
+inline uint64 rrmxmx(uint64 h, uint64 len)
+{
+	h ^= leftrot(h, 49) ^ leftrot(h, 24);
+	h *= PRIME_MX2;
+	h ^= (h >> 35) + len;
+	h *= PRIME_MX2;
+	h ^= h >> 28;
+	return h;
+}
+
+inline uint64 mix16B(const uint8 *in, const uint8 *s)
+{
+	return mul128fold64(load64le(in) ^ load64le(s), load64le(in + 8) ^ load64le(s + 8));
+}
+
+inline void mix32B(Hash128 &acc, const uint8 *in1, const uint8 *in2, const uint8 *s)
+{
+	acc.low += mix16B(in1, s);
+	acc.low ^= load64le(in2) + load64le(in2 + 8);
+	acc.high += mix16B(in2, s + 16);
+	acc.high ^= load64le(in1) + load64le(in1 + 8);
+}
+
+static uint64 hash64Short(const uint8 *in, size_t len)
+{
+	if (len == 0)
+		return xxh64Avalanche(load64le(secret + 56) ^ load64le(secret + 64));
+
+	if (len <= 3)
+	{
+		uint32 combined = ((uint32) in[0] << 16) | ((uint32) in[len >> 1] << 24) | (uint32) in[len - 1] | ((uint32) len << 8);
+		uint64 bitflip = load32le(secret) ^ load32le(secret + 4);
+		return xxh64Avalanche((uint64) combined ^ bitflip);
+	}
+
+	if (len <= 8)
+	{
+		uint64 bitflip = load64le(secret + 8) ^ load64le(secret + 16);
+		uint64 input64 = load32le(in + len - 4) + ((uint64) load32le(in) << 32);
+		return rrmxmx(input64 ^ bitflip, len);
+	}
+
+	if (len <= 16)
+	{
+		uint64 lo = load64le(in) ^ (load64le(secret + 24) ^ load64le(secret + 32));
+		uint64 hi = load64le(in + len - 8) ^ (load64le(secret + 40) ^ load64le(secret + 48));
+		return avalanche(len + swap64(lo) + hi + mul128fold64(lo, hi));
+	}
+
+	uint64 acc = len * PRIME64_1;
+
+	if (len <= 128)
+	{
+		if (len > 32)
+		{
+			if (len > 64)
+			{
+				if (len > 96)
+				{
+					acc += mix16B(in + 48, secret + 96);
+					acc += mix16B(in + len - 64, secret + 112);
+				}
+				acc += mix16B(in + 32, secret + 64);
+				acc += mix16B(in + len - 48, secret + 80);
+			}
+			acc += mix16B(in + 16, secret + 32);
+			acc += mix16B(in + len - 32, secret + 48);
+		}
+		acc += mix16B(in, secret);
+		acc += mix16B(in + len - 16, secret + 16);
+		return avalanche(acc);
+	}
+
+	size_t rounds = len / 16;
+	for (size_t i = 0; i < 8; i++)
+		acc += mix16B(in + 16 * i, secret + 16 * i);
+
+	uint64 accend = mix16B(in + len - 16, secret + SECRET_SIZE_MIN - MIDSIZE_LASTOFFSET);
+	acc = avalanche(acc);
+
+	for (size_t i = 8; i < rounds; i++)
+		accend += mix16B(in + 16 * i, secret + 16 * (i - 8) + MIDSIZE_STARTOFFSET);
+
+	return avalanche(acc + accend);
+}
+
+static Hash128 hash128Short(const uint8 *in, size_t len)
+{
+	Hash128 h;
+
+	if (len == 0)
+	{
+		h.low = xxh64Avalanche(load64le(secret + 64) ^ load64le(secret + 72));
+		h.high = xxh64Avalanche(load64le(secret + 80) ^ load64le(secret + 88));
+		return h;
+	}
+
+	if (len <= 3)
+	{
+		uint32 combinedl = ((uint32) in[0] << 16) | ((uint32) in[len >> 1] << 24) | (uint32) in[len - 1] | ((uint32) len << 8);
+		uint32 combinedh = leftrot(swap32(combinedl), 13);
+		uint64 bitflipl = load32le(secret) ^ load32le(secret + 4);
+		uint64 bitfliph = load32le(secret + 8) ^ load32le(secret + 12);
+		h.low = xxh64Avalanche((uint64) combinedl ^ bitflipl);
+		h.high = xxh64Avalanche((uint64) combinedh ^ bitfliph);
+		return h;
+	}
+
+	if (len <= 8)
+	{
+		uint64 input64 = load32le(in) + ((uint64) load32le(in + len - 4) << 32);
+		uint64 bitflip = load64le(secret + 16) ^ load64le(secret + 24);
+
+		Hash128 m = mul128(input64 ^ bitflip, PRIME64_1 + (len << 2));
+		m.high += m.low << 1;
+		m.low ^= m.high >> 3;
+		m.low ^= m.low >> 35;
+		m.low *= PRIME_MX2;
+		m.low ^= m.low >> 28;
+		m.high = avalanche(m.high);
+		return m;
+	}
+
+	if (len <= 16)
+	{
+		uint64 bitflipl = load64le(secret + 32) ^ load64le(secret + 40);
+		uint64 bitfliph = load64le(secret + 48) ^ load64le(secret + 56);
+		uint64 lo = load64le(in);
+		uint64 hi = load64le(in + len - 8);
+
+		Hash128 m = mul128(lo ^ hi ^ bitflipl, PRIME64_1);
+		m.low += (uint64) (len - 1) << 54;
+		hi ^= bitfliph;
+		m.high += hi + (uint64) (uint32) hi * (PRIME32_2 - 1);
+		m.low ^= swap64(m.high);
+
+		h = mul128(m.low, PRIME64_2);
+		h.high += m.high * PRIME64_2;
+		h.low = avalanche(h.low);
+		h.high = avalanche(h.high);
+		return h;
+	}
+
+	Hash128 acc;
+	acc.low = len * PRIME64_1;
+	acc.high = 0;
+
+	if (len <= 128)
+	{
+		if (len > 32)
+		{
+			if (len > 64)
+			{
+				if (len > 96)
+					mix32B(acc, in + 48, in + len - 64, secret + 96);
+				mix32B(acc, in + 32, in + len - 48, secret + 64);
+			}
+			mix32B(acc, in + 16, in + len - 32, secret + 32);
+		}
+		mix32B(acc, in, in + len - 16, secret);
+	}
+	else
+	{
+		size_t rounds = len / 32;
+		for (size_t i = 0; i < 4; i++)
+			mix32B(acc, in + 32 * i, in + 32 * i + 16, secret + 32 * i);
+
+		acc.low = avalanche(acc.low);
+		acc.high = avalanche(acc.high);
+
+		for (size_t i = 4; i < rounds; i++)
+			mix32B(acc, in + 32 * i, in + 32 * i + 16, secret + MIDSIZE_STARTOFFSET + 32 * (i - 4));
+
+		mix32B(acc, in + len - 16, in + len - 32, secret + SECRET_SIZE_MIN - MIDSIZE_LASTOFFSET - 16);
+	}
+
+	h.low = avalanche(acc.low + acc.high);
+	h.high = 0 - avalanche(acc.low * PRIME64_1 + acc.high * PRIME64_4 + len * PRIME64_2);
+	return h;
+}
+
+inline void initAcc(uint64 *acc)
+{
+	acc[0] = PRIME32_3;
+	acc[1] = PRIME64_1;
+	acc[2] = PRIME64_2;
+	acc[3] = PRIME64_3;
+	acc[4] = PRIME64_4;
+	acc[5] = PRIME32_2;
+	acc[6] = PRIME64_5;
+	acc[7] = PRIME32_1;
+}
+
+inline void accumulate512(uint64 *acc, const uint8 *in, const uint8 *s)
+{
+	for (int i = 0; i < 8; i++)
+	{
+		uint64 value = load64le(in + 8 * i);
+		uint64 key = value ^ load64le(s + 8 * i);
+		acc[i ^ 1] += value;
+		acc[i] += (key & 0xFFFFFFFF) * (key >> 32);
+	}
+}
+
+inline void scrambleAcc(uint64 *acc)
+{
+	const uint8 *s = secret + SECRET_SIZE - STRIPE_LEN;
+	for (int i = 0; i < 8; i++)
+	{
+		uint64 a = acc[i];
+		a ^= a >> 47;
+		a ^= load64le(s + 8 * i);
+		a *= PRIME32_1;
+		acc[i] = a;
+	}
+}
+
+inline void accumulateLast(uint64 *acc, const uint8 *laststripe)
+{
+	accumulate512(acc, laststripe, secret + SECRET_SIZE - STRIPE_LEN - SECRET_LASTACC_START);
+}
+
+// Processes every stripe of an input longer than MIDSIZE_MAX.
+static void accumulateLong(uint64 *acc, const uint8 *in, size_t len)
+{
+	initAcc(acc);
+
+	size_t blocks = (len - 1) / BLOCK_LEN;
+	for (size_t n = 0; n < blocks; n++)
+	{
+		const uint8 *block = in + n * BLOCK_LEN;
+		for (size_t i = 0; i < STRIPES_PER_BLOCK; i++)
+			accumulate512(acc, block + i * STRIPE_LEN, secret + i * SECRET_CONSUME_RATE);
+		scrambleAcc(acc);
+	}
+
+	size_t stripes = ((len - 1) - BLOCK_LEN * blocks) / STRIPE_LEN;
+	const uint8 *block = in + blocks * BLOCK_LEN;
+	for (size_t i = 0; i < stripes; i++)
+		accumulate512(acc, block + i * STRIPE_LEN, secret + i * SECRET_CONSUME_RATE);
+
+	accumulateLast(acc, in + len - STRIPE_LEN);
+}
+
+static uint64 mergeAccs(const uint64 *acc, const uint8 *s, uint64 start)
+{
+	uint64 result = start;
+	for (int i = 0; i < 4; i++)
+		result += mul128fold64(acc[2 * i] ^ load64le(s + 16 * i), acc[2 * i + 1] ^ load64le(s + 16 * i + 8));
+	return avalanche(result);
+}
+
+static void digestLong(HashFunction::Function function, const uint64 *acc, uint64 len, Hash128 &h)
+{
+	h.low = mergeAccs(acc, secret + SECRET_MERGEACCS_START, len * PRIME64_1);
+
+	if (function == HashFunction::FUNCTION_XXH3_128)
+		h.high = mergeAccs(acc, secret + SECRET_SIZE - STRIPE_LEN - SECRET_MERGEACCS_START, ~(len * PRIME64_2));
+}
+
+} // xxh3
+
+static void writeCanonical(uint64 value, int bytes, char *dst)
+{
+	for (int i = 0; i < bytes; i++)
+		dst[i] = (char) ((value >> ((bytes - 1 - i) * 8)) & 0xFF);
+}
+
+static void writeXXHash(HashFunction::Function function, const xxh3::Hash128 &h, HashFunction::Value &output)
+{
+	switch (function)
+	{
+	case HashFunction::FUNCTION_XXH32:
+		writeCanonical(h.low, 4, output.data);
+		output.size = 4;
+		break;
+	case HashFunction::FUNCTION_XXH3_128:
+		writeCanonical(h.high, 8, output.data);
+		writeCanonical(h.low, 8, output.data + 8);
+		output.size = 16;
+		break;
+	default:
+		writeCanonical(h.low, 8, output.data);
+		output.size = 8;
+		break;
+	}
+}
+
+class XXHashContext : public HashFunction::Context
+{
+public:
+
+	XXHashContext(HashFunction::Function function)
+		: function(function)
+	{
+		reset();
+	}
+
+	void update(const char *input, uint64 length) override
+	{
+		if (function == HashFunction::FUNCTION_XXH32)
+			XXH32_update(&state32, input, (size_t) length);
+		else if (function == HashFunction::FUNCTION_XXH64)
+			XXH64_update(&state64, input, (size_t) length);
+		else
+			updateXXH3((const uint8 *) input, length);
+	}
+
+	void digest(HashFunction::Value &output) const override
+	{
+		xxh3::Hash128 h = {0, 0};
+
+		if (function == HashFunction::FUNCTION_XXH32)
+			h.low = XXH32_digest(&state32);
+		else if (function == HashFunction::FUNCTION_XXH64)
+			h.low = XXH64_digest(&state64);
+		else if (totalLength <= xxh3::MIDSIZE_MAX)
+		{
+			if (function == HashFunction::FUNCTION_XXH3_128)
+				h = xxh3::hash128Short(buffer, bufferSize);
+			else
+				h.low = xxh3::hash64Short(buffer, bufferSize);
+		}
+		else
+		{
+			// The last stripe always covers the final 64 bytes of input, which
+			// may partly come from the previously consumed stripe.
+			uint8 laststripe[xxh3::STRIPE_LEN];
+			size_t catchup = xxh3::STRIPE_LEN - bufferSize;
+			memcpy(laststripe, lastStripe + bufferSize, catchup);
+			memcpy(laststripe + catchup, buffer, bufferSize);
+
+			uint64 finalacc[8];
+			memcpy(finalacc, acc, sizeof(acc));
+			xxh3::accumulateLast(finalacc, laststripe);
+			xxh3::digestLong(function, finalacc, totalLength, h);
+		}
+
+		writeXXHash(function, h, output);
+	}
+
+	void reset() override
+	{
+		XXH32_reset(&state32, 0);
+		XXH64_reset(&state64, 0);
+		xxh3::initAcc(acc);
+		bufferSize = 0;
+		stripesInBlock = 0;
+		totalLength = 0;
+	}
+
+private:
+
+	void updateXXH3(const uint8 *in, uint64 length)
+	{
+		// Short inputs use entirely different code paths, so everything is
+		// kept until the input is known to be long.
+		if (totalLength + length <= xxh3::MIDSIZE_MAX)
+		{
+			memcpy(buffer + bufferSize, in, (size_t) length);
+			bufferSize += (size_t) length;
+			totalLength += length;
+			return;
+		}
+
+		if (totalLength <= xxh3::MIDSIZE_MAX)
+		{
+			uint8 pending[xxh3::MIDSIZE_MAX];
+			size_t pendingsize = bufferSize;
+			memcpy(pending, buffer, pendingsize);
+
+			bufferSize = 0;
+			consumeXXH3(pending, pendingsize);
+		}
+
+		totalLength += length;
+		consumeXXH3(in, length);
+	}
+
+	// A stripe is only consumed once more input follows it, since the final
+	// stripe is processed differently.
+	void consumeXXH3(const uint8 *in, uint64 length)
+	{
+		while (length > 0)
+		{
+			if (bufferSize == xxh3::STRIPE_LEN)
+			{
+				consumeStripe(buffer);
+				memcpy(lastStripe, buffer, xxh3::STRIPE_LEN);
+				bufferSize = 0;
+			}
+
+			if (bufferSize == 0 && length > xxh3::STRIPE_LEN)
+			{
+				do
+				{
+					consumeStripe(in);
+					in += xxh3::STRIPE_LEN;
+					length -= xxh3::STRIPE_LEN;
+				} while (length > xxh3::STRIPE_LEN);
+
+				memcpy(lastStripe, in - xxh3::STRIPE_LEN, xxh3::STRIPE_LEN);
+			}
+
+			size_t n = (size_t) std::min<uint64>(length, xxh3::STRIPE_LEN - bufferSize);
+			memcpy(buffer + bufferSize, in, n);
+			bufferSize += n;
+			in += n;
+			length -= n;
+		}
+	}
+
+	void consumeStripe(const uint8 *stripe)
+	{
+		xxh3::accumulate512(acc, stripe, xxh3::secret + stripesInBlock * xxh3::SECRET_CONSUME_RATE);
+
+		if (++stripesInBlock == xxh3::STRIPES_PER_BLOCK)
+		{
+			xxh3::scrambleAcc(acc);
+			stripesInBlock = 0;
+		}
+	}
+
+	HashFunction::Function function;
+
+	XXH32_state_t state32;
+	XXH64_state_t state64;
+
+	// XXH3 state. The buffer holds all input while it's short, and the
+	// unconsumed part of the current stripe afterwards.
+	uint64 acc[8];
+	uint8 buffer[xxh3::MIDSIZE_MAX];
+	uint8 lastStripe[xxh3::STRIPE_LEN];
+	size_t bufferSize;
+	size_t stripesInBlock;
+	uint64 totalLength;
+
+}; // XXHashContext
+
+class XXHash : public HashFunction
+{
+public:
+
+	bool isSupported(Function function) const override
+	{
+		return function == FUNCTION_XXH32 || function == FUNCTION_XXH64
+			|| function == FUNCTION_XXH3_64 || function == FUNCTION_XXH3_128;
+	}
+
+	void hash(Function function, const char *input, uint64 length, Value &output) const override
+	{
+		if (!isSupported(function))
+			throw love::Exception("Hash function not supported by xxHash implementation");
+
+		const uint8 *in = (const uint8 *) input;
+		xxh3::Hash128 h = {0, 0};
+
+		if (function == FUNCTION_XXH32)
+			h.low = XXH32(input, (size_t) length, 0);
+		else if (function == FUNCTION_XXH64)
+			h.low = XXH64(input, (size_t) length, 0);
+		else if (length <= xxh3::MIDSIZE_MAX)
+		{
+			if (function == FUNCTION_XXH3_128)
+				h = xxh3::hash128Short(in, (size_t) length);
+			else
+				h.low = xxh3::hash64Short(in, (size_t) length);
+		}
+		else
+		{
+			uint64 acc[8];
+			xxh3::accumulateLong(acc, in, (size_t) length);
+			xxh3::digestLong(function, acc, length, h);
+		}
+
+		writeXXHash(function, h, output);
+	}
+
+	Context *newContext(Function function) const override
+	{
+		if (!isSupported(function))
+			throw love::Exception("Hash function not supported by xxHash implementation");
+
+		return new XXHashContext(function);
+	}
+
+} xxhash;
+
 } // impl
 }
 
@@ -604,6 +1533,11 @@ HashFunction *HashFunction::getHashFunction(Function function)
 	case FUNCTION_SHA384:
 	case FUNCTION_SHA512:
 		return &impl::sha512;
+	case FUNCTION_XXH32:
+	case FUNCTION_XXH64:
+	case FUNCTION_XXH3_64:
+	case FUNCTION_XXH3_128:
+		return &impl::xxhash;
 	case FUNCTION_MAX_ENUM:
 		return nullptr;
 	// No default for compiler warnings
@@ -632,6 +1566,10 @@ StringMap<HashFunction::Function, HashFunction::FUNCTION_MAX_ENUM>::Entry HashFu
 	{"sha256", FUNCTION_SHA256},
 	{"sha384", FUNCTION_SHA384},
 	{"sha512", FUNCTION_SHA512},
+	{"xxh32", FUNCTION_XXH32},
+	{"xxh64", FUNCTION_XXH64},
+	{"xxh3", FUNCTION_XXH3_64},
+	{"xxh128", FUNCTION_XXH3_128},
 };
 
 StringMap<HashFunction::Function, HashFunction::FUNCTION_MAX_ENUM> HashFunction::functionNames(HashFunction::functionEntries, sizeof(HashFunction::functionEntries));
@@ -42,6 +42,10 @@ public:
 		FUNCTION_SHA256,
 		FUNCTION_SHA384,
 		FUNCTION_SHA512,
+		FUNCTION_XXH32,
+		FUNCTION_XXH64,
+		FUNCTION_XXH3_64,
+		FUNCTION_XXH3_128,
 		FUNCTION_MAX_ENUM
 	};
 
@@ -51,6 +55,23 @@ public:
 		size_t size;
 	};
 
+	/**
+	 * Hashes input which is passed to it in pieces. The digest of everything
+	 * passed in so far can be retrieved at any point, without affecting later
+	 * updates.
+	 **/
+	class Context
+	{
+	public:
+
+		virtual ~Context() {}
+
+		virtual void update(const char *input, uint64 length) = 0;
+		virtual void digest(Value &output) const = 0;
+		virtual void reset() = 0;
+
+	}; // Context
+
 	/**
 	 * Get a HashFunction instance for the given function.
 	 *
@@ -72,6 +93,12 @@ public:
 	 **/
 	virtual void hash(Function function, const char *input, uint64 length, Value &output) const = 0;
 
+	/**
+	 * Creates a Context for incrementally hashing input with the given
+	 * function. The caller owns the returned Context.
+	 **/
+	virtual Context *newContext(Function function) const = 0;
+
 	/**
 	 * @param[in] function The requested hash function.
 	 * @return Whether this HashFunction instance implements the given function.
@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Hasher.h"
+#include "common/Exception.h"
+
+namespace love
+{
+namespace data
+{
+
+love::Type Hasher::type("Hasher", &Object::type);
+
+Hasher::Hasher(HashFunction::Function function)
+	: function(function)
+	, context(nullptr)
+{
+	HashFunction *hashfunction = HashFunction::getHashFunction(function);
+	if (hashfunction == nullptr)
+		throw love::Exception("Invalid hash function.");
+
+	context = hashfunction->newContext(function);
+}
+
+Hasher::~Hasher()
+{
+	delete context;
+}
+
+void Hasher::update(const char *input, uint64 length)
+{
+	context->update(input, length);
+}
+
+void Hasher::digest(HashFunction::Value &output) const
+{
+	context->digest(output);
+}
+
+void Hasher::reset()
+{
+	context->reset();
+}
+
+HashFunction::Function Hasher::getFunction() const
+{
+	return function;
+}
+
+} // data
+} // love
@@ -0,0 +1,194 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_ByteDataBuilder.h"
+#include "wrap_DataModule.h"
+#include "common/Data.h"
+
+// Lua 5.3
+#include "libraries/lua53/lstrlib.h"
+
+namespace love
+{
+namespace data
+{
+
+ByteDataBuilder *luax_checkbytedatabuilder(lua_State *L, int idx)
+{
+	return luax_checktype<ByteDataBuilder>(L, idx);
+}
+
+static size_t checkOffset(lua_State *L, int idx)
+{
+	lua_Integer offset = luaL_checkinteger(L, idx);
+	if (offset < 0)
+		luaL_argerror(L, idx, "offset must not be negative");
+	return (size_t) offset;
+}
+
+// Packs the values after fmtidx into the builder at offset, and returns the
+// number of bytes written.
+static size_t packAt(lua_State *L, ByteDataBuilder *t, size_t offset, int fmtidx)
+{
+	const char *fmt = luaL_checkstring(L, fmtidx);
+
+	luaL_Buffer_53 b;
+	lua53_str_pack(L, fmt, fmtidx + 1, &b);
+
+	size_t size = b.nelems;
+	luax_catchexcept(L,
+		[&]() { t->write(offset, b.ptr, size); },
+		[&](bool) { lua53_cleanupbuffer(&b); }
+	);
+
+	return size;
+}
+
+int w_ByteDataBuilder_pack(lua_State *L)
+{
+	ByteDataBuilder *t = luax_checkbytedatabuilder(L, 1);
+	size_t offset = t->getSize();
+	packAt(L, t, offset, 2);
+	lua_pushinteger(L, (lua_Integer) offset);
+	return 1;
+}
+
+int w_ByteDataBuilder_packAt(lua_State *L)
+{
+	ByteDataBuilder *t = luax_checkbytedatabuilder(L, 1);
+	size_t offset = checkOffset(L, 2);
+	size_t size = packAt(L, t, offset, 3);
+	lua_pushinteger(L, (lua_Integer) (offset + size));
+	return 1;
+}
+
+int w_ByteDataBuilder_append(lua_State *L)
+{
+	ByteDataBuilder *t = luax_checkbytedatabuilder(L, 1);
+
+	const char *bytes = nullptr;
+	size_t size = 0;
+
+	if (luax_istype(L, 2, Data::type))
+	{
+		Data *data = luax_checktype<Data>(L, 2);
+		bytes = (const char *) data->getData();
+		size = data->getSize();
+	}
+	else
+		bytes = luaL_checklstring(L, 2, &size);
+
+	size_t offset = t->getSize();
+	luax_catchexcept(L, [&]() { t->append(bytes, size); });
+
+	lua_pushinteger(L, (lua_Integer) offset);
+	return 1;
+}
+
+int w_ByteDataBuilder_setSize(lua_State *L)
+{
+	ByteDataBuilder *t = luax_checkbytedatabuilder(L, 1);
+	size_t size = checkOffset(L, 2);
+	luax_catchexcept(L, [&]() { t->setSize(size); });
+	return 0;
+}
+
+int w_ByteDataBuilder_getSize(lua_State *L)
+{
+	ByteDataBuilder *t = luax_checkbytedatabuilder(L, 1);
+	lua_pushinteger(L, (lua_Integer) t->getSize());
+	return 1;
+}
+
+int w_ByteDataBuilder_reserve(lua_State *L)
+{
+	ByteDataBuilder *t = luax_checkbytedatabuilder(L, 1);
+	size_t capacity = checkOffset(L, 2);
+	luax_catchexcept(L, [&]() { t->reserve(capacity); });
+	return 0;
+}
+
+int w_ByteDataBuilder_getCapacity(lua_State *L)
+{
+	ByteDataBuilder *t = luax_checkbytedatabuilder(L, 1);
+	lua_pushinteger(L, (lua_Integer) t->getCapacity());
+	return 1;
+}
+
+int w_ByteDataBuilder_getString(lua_State *L)
+{
+	ByteDataBuilder *t = luax_checkbytedatabuilder(L, 1);
+	lua_pushlstring(L, t->getData(), t->getSize());
+	return 1;
+}
+
+int w_ByteDataBuilder_clear(lua_State *L)
+{
+	ByteDataBuilder *t = luax_checkbytedatabuilder(L, 1);
+	t->clear();
+	return 0;
+}
+
+int w_ByteDataBuilder_finish(lua_State *L)
+{
+	ByteDataBuilder *t = luax_checkbytedatabuilder(L, 1);
+
+	ContainerType ctype = CONTAINER_DATA;
+	if (!lua_isnoneornil(L, 2))
+		ctype = luax_checkcontainertype(L, 2);
+
+	if (ctype == CONTAINER_STRING)
+	{
+		lua_pushlstring(L, t->getData(), t->getSize());
+		t->clear();
+		return 1;
+	}
+
+	ByteData *data = nullptr;
+	luax_catchexcept(L, [&]() { data = t->finish(); });
+
+	luax_pushtype(L, data);
+	data->release();
+	return 1;
+}
+
+static const luaL_Reg w_ByteDataBuilder_functions[] =
+{
+	{ "pack", w_ByteDataBuilder_pack },
+	{ "packAt", w_ByteDataBuilder_packAt },
+	{ "append", w_ByteDataBuilder_append },
+	{ "setSize", w_ByteDataBuilder_setSize },
+	{ "getSize", w_ByteDataBuilder_getSize },
+	{ "reserve", w_ByteDataBuilder_reserve },
+	{ "getCapacity", w_ByteDataBuilder_getCapacity },
+	{ "getString", w_ByteDataBuilder_getString },
+	{ "clear", w_ByteDataBuilder_clear },
+	{ "finish", w_ByteDataBuilder_finish },
+	{ 0, 0 },
+};
+
+extern "C" int luaopen_bytedatabuilder(lua_State *L)
+{
+	return luax_register_type(L, &ByteDataBuilder::type, w_ByteDataBuilder_functions, nullptr);
+}
+
+} // data
+} // love
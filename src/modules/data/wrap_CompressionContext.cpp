@@ -0,0 +1,205 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_CompressionContext.h"
+#include "wrap_CompressedData.h"
+#include "wrap_DataModule.h"
+#include "DataModule.h"
+
+namespace love
+{
+namespace data
+{
+
+CompressionContext *luax_checkcompressioncontext(lua_State *L, int idx)
+{
+	return luax_checktype<CompressionContext>(L, idx);
+}
+
+int w_CompressionContext_compress(lua_State *L)
+{
+	CompressionContext *t = luax_checkcompressioncontext(L, 1);
+	ContainerType ctype = luax_checkcontainertype(L, 2);
+
+	size_t rawsize = 0;
+	const char *rawbytes = nullptr;
+
+	if (lua_isstring(L, 3))
+		rawbytes = luaL_checklstring(L, 3, &rawsize);
+	else
+	{
+		Data *rawdata = luax_checktype<Data>(L, 3);
+		rawsize = rawdata->getSize();
+		rawbytes = (const char *) rawdata->getData();
+	}
+
+	char *cbytes = nullptr;
+	size_t csize = 0;
+	luax_catchexcept(L, [&](){ cbytes = t->compress(rawbytes, rawsize, csize); });
+
+	if (ctype == CONTAINER_DATA)
+	{
+		CompressedData *cdata = nullptr;
+		luax_catchexcept(L,
+			[&]() { cdata = new CompressedData(t->getFormat(), cbytes, csize, rawsize, true); },
+			[&](bool failed) { if (failed) delete[] cbytes; }
+		);
+		luax_pushtype(L, cdata);
+		cdata->release();
+	}
+	else
+	{
+		lua_pushlstring(L, cbytes, csize);
+		delete[] cbytes;
+	}
+
+	return 1;
+}
+
+int w_CompressionContext_decompress(lua_State *L)
+{
+	CompressionContext *t = luax_checkcompressioncontext(L, 1);
+	ContainerType ctype = luax_checkcontainertype(L, 2);
+
+	size_t compressedsize = 0;
+	const char *cbytes = nullptr;
+	size_t rawsize = 0;
+
+	if (luax_istype(L, 3, CompressedData::type))
+	{
+		CompressedData *data = luax_checkcompresseddata(L, 3);
+		if (data->getFormat() != t->getFormat())
+			return luaL_error(L, "CompressedData format must match the CompressionContext's format.");
+
+		cbytes = (const char *) data->getData();
+		compressedsize = data->getSize();
+		rawsize = data->getDecompressedSize();
+	}
+	else if (luax_istype(L, 3, Data::type))
+	{
+		Data *data = luax_checktype<Data>(L, 3);
+		cbytes = (const char *) data->getData();
+		compressedsize = data->getSize();
+	}
+	else
+		cbytes = luaL_checklstring(L, 3, &compressedsize);
+
+	char *rawbytes = nullptr;
+	luax_catchexcept(L, [&](){ rawbytes = t->decompress(cbytes, compressedsize, rawsize); });
+
+	if (ctype == CONTAINER_DATA)
+	{
+		ByteData *data = nullptr;
+		luax_catchexcept(L,
+			[&]() { data = DataModule::instance.newByteData(rawbytes, rawsize, true); },
+			[&](bool failed) { if (failed) delete[] rawbytes; }
+		);
+		luax_pushtype(L, Data::type, data);
+		data->release();
+	}
+	else
+	{
+		lua_pushlstring(L, rawbytes, rawsize);
+		delete[] rawbytes;
+	}
+
+	return 1;
+}
+
+int w_CompressionContext_decompressInto(lua_State *L)
+{
+	CompressionContext *t = luax_checkcompressioncontext(L, 1);
+
+	size_t dstsize = 0;
+	char *dst = luax_checkdatadestination(L, 2, dstsize);
+
+	size_t compressedsize = 0;
+	const char *cbytes = nullptr;
+
+	if (luax_istype(L, 4, CompressedData::type))
+	{
+		CompressedData *data = luax_checkcompresseddata(L, 4);
+		if (data->getFormat() != t->getFormat())
+			return luaL_error(L, "CompressedData format must match the CompressionContext's format.");
+
+		cbytes = (const char *) data->getData();
+		compressedsize = data->getSize();
+	}
+	else if (luax_istype(L, 4, Data::type))
+	{
+		Data *data = luax_checktype<Data>(L, 4);
+		cbytes = (const char *) data->getData();
+		compressedsize = data->getSize();
+	}
+	else
+		cbytes = luaL_checklstring(L, 4, &compressedsize);
+
+	size_t written = 0;
+	luax_catchexcept(L, [&](){ written = t->decompressInto(cbytes, compressedsize, dst, dstsize); });
+
+	lua_pushnumber(L, (lua_Number) written);
+	return 1;
+}
+
+int w_CompressionContext_getFormat(lua_State *L)
+{
+	CompressionContext *t = luax_checkcompressioncontext(L, 1);
+
+	const char *str = nullptr;
+	if (!Compressor::getConstant(t->getFormat(), str))
+		return luaL_error(L, "Unknown compressed data format.");
+
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_CompressionContext_getLevel(lua_State *L)
+{
+	CompressionContext *t = luax_checkcompressioncontext(L, 1);
+	lua_pushinteger(L, t->getLevel());
+	return 1;
+}
+
+int w_CompressionContext_getDictionary(lua_State *L)
+{
+	CompressionContext *t = luax_checkcompressioncontext(L, 1);
+	luax_pushtype(L, t->getDictionary());
+	return 1;
+}
+
+static const luaL_Reg w_CompressionContext_functions[] =
+{
+	{ "compress", w_CompressionContext_compress },
+	{ "decompress", w_CompressionContext_decompress },
+	{ "decompressInto", w_CompressionContext_decompressInto },
+	{ "getFormat", w_CompressionContext_getFormat },
+	{ "getLevel", w_CompressionContext_getLevel },
+	{ "getDictionary", w_CompressionContext_getDictionary },
+	{ 0, 0 },
+};
+
+extern "C" int luaopen_compressioncontext(lua_State *L)
+{
+	return luax_register_type(L, &CompressionContext::type, w_CompressionContext_functions, nullptr);
+}
+
+} // data
+} // love
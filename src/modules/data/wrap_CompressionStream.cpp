@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_CompressionStream.h"
+#include "wrap_DataModule.h"
+#include "DataModule.h"
+
+namespace love
+{
+namespace data
+{
+
+CompressionStream *luax_checkcompressionstream(lua_State *L, int idx)
+{
+	return luax_checktype<CompressionStream>(L, idx);
+}
+
+// Pushes stream output in the given container. Data containers get nil when
+// there's no output, since ByteData can't be empty.
+static int pushOutput(lua_State *L, ContainerType ctype, const std::vector<char> &output)
+{
+	if (ctype == CONTAINER_DATA)
+	{
+		if (output.empty())
+		{
+			lua_pushnil(L);
+			return 1;
+		}
+
+		ByteData *data = nullptr;
+		luax_catchexcept(L, [&]() { data = DataModule::instance.newByteData(output.data(), output.size()); });
+		luax_pushtype(L, data);
+		data->release();
+	}
+	else
+		lua_pushlstring(L, output.data(), output.size());
+
+	return 1;
+}
+
+int w_CompressionStream_process(lua_State *L)
+{
+	CompressionStream *t = luax_checkcompressionstream(L, 1);
+	ContainerType ctype = luax_checkcontainertype(L, 2);
+
+	size_t size = 0;
+	const char *bytes = nullptr;
+
+	if (luax_istype(L, 3, Data::type))
+	{
+		Data *data = luax_checktype<Data>(L, 3);
+		bytes = (const char *) data->getData();
+		size = data->getSize();
+	}
+	else
+		bytes = luaL_checklstring(L, 3, &size);
+
+	std::vector<char> output;
+	luax_catchexcept(L, [&](){ t->process(bytes, size, output); });
+
+	return pushOutput(L, ctype, output);
+}
+
+int w_CompressionStream_finish(lua_State *L)
+{
+	CompressionStream *t = luax_checkcompressionstream(L, 1);
+	ContainerType ctype = luax_checkcontainertype(L, 2);
+
+	std::vector<char> output;
+	luax_catchexcept(L, [&](){ t->finish(output); });
+
+	return pushOutput(L, ctype, output);
+}
+
+int w_CompressionStream_isFinished(lua_State *L)
+{
+	CompressionStream *t = luax_checkcompressionstream(L, 1);
+	luax_pushboolean(L, t->isFinished());
+	return 1;
+}
+
+int w_CompressionStream_getFormat(lua_State *L)
+{
+	CompressionStream *t = luax_checkcompressionstream(L, 1);
+
+	const char *str = nullptr;
+	if (!Compressor::getConstant(t->getFormat(), str))
+		return luaL_error(L, "Unknown compressed data format.");
+
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_CompressionStream_getMode(lua_State *L)
+{
+	CompressionStream *t = luax_checkcompressionstream(L, 1);
+
+	const char *str = nullptr;
+	if (!CompressionStream::getConstant(t->getMode(), str))
+		return luaL_error(L, "Unknown compression stream mode.");
+
+	lua_pushstring(L, str);
+	return 1;
+}
+
+static const luaL_Reg w_CompressionStream_functions[] =
+{
+	{ "process", w_CompressionStream_process },
+	{ "finish", w_CompressionStream_finish },
+	{ "isFinished", w_CompressionStream_isFinished },
+	{ "getFormat", w_CompressionStream_getFormat },
+	{ "getMode", w_CompressionStream_getMode },
+	{ 0, 0 },
+};
+
+extern "C" int luaopen_compressionstream(lua_State *L)
+{
+	return luax_register_type(L, &CompressionStream::type, w_CompressionStream_functions, nullptr);
+}
+
+} // data
+} // love
@@ -19,6 +19,14 @@
  **/
 
 #include "wrap_Data.h"
+#include "DataModule.h"
+
+// C++
+#include <algorithm>
+#include <atomic>
+
+// C
+#include <cstring>
 
 namespace love
 {
@@ -30,6 +38,356 @@ Data *luax_checkdata(lua_State *L, int idx)
 	return luax_checktype<Data>(L, idx);
 }
 
+template <typename T>
+static inline T loadValue(const char *src, bool swap)
+{
+	char bytes[sizeof(T)];
+	memcpy(bytes, src, sizeof(T));
+	if (swap)
+		std::reverse(bytes, bytes + sizeof(T));
+
+	T value;
+	memcpy(&value, bytes, sizeof(T));
+	return value;
+}
+
+template <typename T>
+static inline void storeValue(char *dst, T value, bool swap)
+{
+	char bytes[sizeof(T)];
+	memcpy(bytes, &value, sizeof(T));
+	if (swap)
+		std::reverse(bytes, bytes + sizeof(T));
+
+	memcpy(dst, bytes, sizeof(T));
+}
+
+static lua_Number loadNumber(DataValueType type, const char *src, bool swap)
+{
+	switch (type)
+	{
+	case DATAVALUE_INT8:
+		return (lua_Number) loadValue<int8>(src, swap);
+	case DATAVALUE_UINT8:
+		return (lua_Number) loadValue<uint8>(src, swap);
+	case DATAVALUE_INT16:
+		return (lua_Number) loadValue<int16>(src, swap);
+	case DATAVALUE_UINT16:
+		return (lua_Number) loadValue<uint16>(src, swap);
+	case DATAVALUE_INT32:
+		return (lua_Number) loadValue<int32>(src, swap);
+	case DATAVALUE_UINT32:
+		return (lua_Number) loadValue<uint32>(src, swap);
+	case DATAVALUE_FLOAT:
+		return (lua_Number) loadValue<float>(src, swap);
+	case DATAVALUE_DOUBLE:
+	default:
+		return (lua_Number) loadValue<double>(src, swap);
+	}
+}
+
+// Integer types wrap around, like a C cast from a 64 bit integer would.
+static void storeNumber(DataValueType type, char *dst, lua_Number n, bool swap)
+{
+	switch (type)
+	{
+	case DATAVALUE_INT8:
+	case DATAVALUE_UINT8:
+		storeValue<uint8>(dst, (uint8) (int64) n, swap);
+		break;
+	case DATAVALUE_INT16:
+	case DATAVALUE_UINT16:
+		storeValue<uint16>(dst, (uint16) (int64) n, swap);
+		break;
+	case DATAVALUE_INT32:
+	case DATAVALUE_UINT32:
+		storeValue<uint32>(dst, (uint32) (int64) n, swap);
+		break;
+	case DATAVALUE_FLOAT:
+		storeValue<float>(dst, (float) n, swap);
+		break;
+	case DATAVALUE_DOUBLE:
+	default:
+		storeValue<double>(dst, (double) n, swap);
+		break;
+	}
+}
+
+static DataValueType luax_checkdatavaluetype(lua_State *L, int idx)
+{
+	const char *str = luaL_checkstring(L, idx);
+	DataValueType type = DATAVALUE_MAX_ENUM;
+	if (!getConstant(str, type))
+		luax_enumerror(L, "data value type", getConstants(type), str);
+	return type;
+}
+
+static bool luax_optbyteswap(lua_State *L, int idx)
+{
+	if (lua_isnoneornil(L, idx))
+		return false;
+
+	const char *str = luaL_checkstring(L, idx);
+	Endianness endianness = ENDIAN_MAX_ENUM;
+	if (!getConstant(str, endianness))
+		luax_enumerror(L, "endianness", getConstants(endianness), str);
+	return needsByteSwap(endianness);
+}
+
+// Returns a pointer to count values starting at the given byte offset, or
+// raises an error if they don't fit inside the Data.
+static char *checkValueRange(lua_State *L, Data *t, lua_Integer offset, lua_Integer count, size_t valuesize)
+{
+	size_t size = t->getSize();
+
+	if (offset < 0 || count < 0 || (size_t) offset > size || (size_t) count > (size - (size_t) offset) / valuesize)
+		luaL_error(L, "The given byte offset and count (%d, %d) don't fit within the Data's size (%d).", (int) offset, (int) count, (int) size);
+
+	return (char *) t->getData() + offset;
+}
+
+int w_Data_getValue(lua_State *L)
+{
+	Data *t = luax_checkdata(L, 1);
+	DataValueType type = luax_checkdatavaluetype(L, 2);
+	lua_Integer offset = luaL_checkinteger(L, 3);
+	bool swap = luax_optbyteswap(L, 4);
+
+	const char *src = checkValueRange(L, t, offset, 1, getDataValueSize(type));
+
+	lua_pushnumber(L, loadNumber(type, src, swap));
+	return 1;
+}
+
+int w_Data_setValue(lua_State *L)
+{
+	Data *t = luax_checkdata(L, 1);
+	DataValueType type = luax_checkdatavaluetype(L, 2);
+	lua_Integer offset = luaL_checkinteger(L, 3);
+	lua_Number value = luaL_checknumber(L, 4);
+	bool swap = luax_optbyteswap(L, 5);
+
+	char *dst = checkValueRange(L, t, offset, 1, getDataValueSize(type));
+
+	storeNumber(type, dst, value, swap);
+	return 0;
+}
+
+int w_Data_getValues(lua_State *L)
+{
+	Data *t = luax_checkdata(L, 1);
+	DataValueType type = luax_checkdatavaluetype(L, 2);
+	lua_Integer offset = luaL_checkinteger(L, 3);
+	lua_Integer count = luaL_checkinteger(L, 4);
+	bool swap = luax_optbyteswap(L, 5);
+
+	size_t valuesize = getDataValueSize(type);
+	const char *src = checkValueRange(L, t, offset, count, valuesize);
+
+	// An existing table can be reused to avoid creating garbage.
+	if (lua_istable(L, 6))
+		lua_pushvalue(L, 6);
+	else
+	{
+		luaL_argcheck(L, lua_isnoneornil(L, 6), 6, "expected table");
+		lua_createtable(L, (int) count, 0);
+	}
+
+	for (lua_Integer i = 0; i < count; i++)
+	{
+		lua_pushnumber(L, loadNumber(type, src + i * valuesize, swap));
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	return 1;
+}
+
+int w_Data_setValues(lua_State *L)
+{
+	Data *t = luax_checkdata(L, 1);
+	DataValueType type = luax_checkdatavaluetype(L, 2);
+	lua_Integer offset = luaL_checkinteger(L, 3);
+	luaL_checktype(L, 4, LUA_TTABLE);
+	bool swap = luax_optbyteswap(L, 5);
+
+	lua_Integer count = (lua_Integer) luax_objlen(L, 4);
+	size_t valuesize = getDataValueSize(type);
+	char *dst = checkValueRange(L, t, offset, count, valuesize);
+
+	for (lua_Integer i = 0; i < count; i++)
+	{
+		lua_rawgeti(L, 4, (int) i + 1);
+		storeNumber(type, dst + i * valuesize, luaL_checknumber(L, -1), swap);
+		lua_pop(L, 1);
+	}
+
+	return 0;
+}
+
+enum AtomicOp
+{
+	ATOMIC_LOAD,
+	ATOMIC_STORE,
+	ATOMIC_EXCHANGE,
+	ATOMIC_ADD,
+	ATOMIC_COMPARE_EXCHANGE,
+};
+
+// Data memory is treated as std::atomic<T> in place, which relies on the
+// atomic types having the same size and representation as the plain ones.
+template <typename T>
+static lua_Number atomicOp(AtomicOp op, char *ptr, lua_Number a, lua_Number b, bool &success)
+{
+	static_assert(sizeof(std::atomic<T>) == sizeof(T), "std::atomic must not add padding.");
+
+	std::atomic<T> *value = (std::atomic<T> *) ptr;
+	T operand = (T) (int64) a;
+	success = true;
+
+	switch (op)
+	{
+	case ATOMIC_LOAD:
+	default:
+		return (lua_Number) value->load();
+	case ATOMIC_STORE:
+		value->store(operand);
+		return a;
+	case ATOMIC_EXCHANGE:
+		return (lua_Number) value->exchange(operand);
+	case ATOMIC_ADD:
+		return (lua_Number) value->fetch_add(operand);
+	case ATOMIC_COMPARE_EXCHANGE:
+		// On failure, operand holds the current value.
+		success = value->compare_exchange_strong(operand, (T) (int64) b);
+		return (lua_Number) operand;
+	}
+}
+
+static int w_Data_atomic(lua_State *L, AtomicOp op, int nargs)
+{
+	Data *t = luax_checkdata(L, 1);
+	DataValueType type = luax_checkdatavaluetype(L, 2);
+	lua_Integer offset = luaL_checkinteger(L, 3);
+
+	lua_Number a = nargs > 0 ? luaL_checknumber(L, 4) : 0;
+	lua_Number b = nargs > 1 ? luaL_checknumber(L, 5) : 0;
+
+	size_t valuesize = getDataValueSize(type);
+	char *ptr = checkValueRange(L, t, offset, 1, valuesize);
+
+	if (((uintptr_t) ptr % valuesize) != 0)
+		return luaL_error(L, "Atomic operations require the value's address to be aligned to its size (%d bytes.)", (int) valuesize);
+
+	lua_Number result = 0;
+	bool success = true;
+
+	switch (type)
+	{
+	case DATAVALUE_INT8:
+		result = atomicOp<int8>(op, ptr, a, b, success);
+		break;
+	case DATAVALUE_UINT8:
+		result = atomicOp<uint8>(op, ptr, a, b, success);
+		break;
+	case DATAVALUE_INT16:
+		result = atomicOp<int16>(op, ptr, a, b, success);
+		break;
+	case DATAVALUE_UINT16:
+		result = atomicOp<uint16>(op, ptr, a, b, success);
+		break;
+	case DATAVALUE_INT32:
+		result = atomicOp<int32>(op, ptr, a, b, success);
+		break;
+	case DATAVALUE_UINT32:
+		result = atomicOp<uint32>(op, ptr, a, b, success);
+		break;
+	default:
+		return luaL_error(L, "Atomic operations only support integer value types.");
+	}
+
+	if (op == ATOMIC_STORE)
+		return 0;
+
+	if (op == ATOMIC_COMPARE_EXCHANGE)
+	{
+		lua_pushboolean(L, success);
+		lua_pushnumber(L, result);
+		return 2;
+	}
+
+	lua_pushnumber(L, result);
+	return 1;
+}
+
+int w_Data_atomicLoad(lua_State *L)
+{
+	return w_Data_atomic(L, ATOMIC_LOAD, 0);
+}
+
+int w_Data_atomicStore(lua_State *L)
+{
+	return w_Data_atomic(L, ATOMIC_STORE, 1);
+}
+
+int w_Data_atomicExchange(lua_State *L)
+{
+	return w_Data_atomic(L, ATOMIC_EXCHANGE, 1);
+}
+
+int w_Data_atomicAdd(lua_State *L)
+{
+	return w_Data_atomic(L, ATOMIC_ADD, 1);
+}
+
+int w_Data_atomicCompareExchange(lua_State *L)
+{
+	return w_Data_atomic(L, ATOMIC_COMPARE_EXCHANGE, 2);
+}
+
+int w_Data_copyFrom(lua_State *L)
+{
+	Data *t = luax_checkdata(L, 1);
+	Data *src = luax_checkdata(L, 2);
+
+	lua_Integer srcoffset = luaL_optinteger(L, 3, 0);
+	lua_Integer dstoffset = luaL_optinteger(L, 4, 0);
+
+	if (srcoffset < 0 || (size_t) srcoffset > src->getSize())
+		return luaL_error(L, "Invalid source byte offset: %d", (int) srcoffset);
+
+	if (dstoffset < 0 || (size_t) dstoffset > t->getSize())
+		return luaL_error(L, "Invalid destination byte offset: %d", (int) dstoffset);
+
+	size_t maxsize = std::min(src->getSize() - (size_t) srcoffset, t->getSize() - (size_t) dstoffset);
+	lua_Integer size = luaL_optinteger(L, 5, (lua_Integer) maxsize);
+
+	if (size < 0 || (size_t) size > maxsize)
+		return luaL_error(L, "The given size (%d) doesn't fit within both Data objects.", (int) size);
+
+	// The source and destination may be the same Data, or overlapping views.
+	memmove((char *) t->getData() + dstoffset, (const char *) src->getData() + srcoffset, (size_t) size);
+	return 0;
+}
+
+int w_Data_fill(lua_State *L)
+{
+	Data *t = luax_checkdata(L, 1);
+	int value = (int) luaL_checkinteger(L, 2);
+
+	lua_Integer offset = luaL_optinteger(L, 3, 0);
+	if (offset < 0 || (size_t) offset > t->getSize())
+		return luaL_error(L, "Invalid byte offset: %d", (int) offset);
+
+	size_t maxsize = t->getSize() - (size_t) offset;
+	lua_Integer size = luaL_optinteger(L, 4, (lua_Integer) maxsize);
+
+	if (size < 0 || (size_t) size > maxsize)
+		return luaL_error(L, "The given size (%d) doesn't fit within the Data's size.", (int) size);
+
+	memset((char *) t->getData() + offset, value & 0xFF, (size_t) size);
+	return 0;
+}
+
 int w_Data_getString(lua_State *L)
 {
 	Data *t = luax_checkdata(L, 1);
@@ -56,6 +414,17 @@ const luaL_Reg w_Data_functions[] =
 	{ "getString", w_Data_getString },
 	{ "getPointer", w_Data_getPointer },
 	{ "getSize", w_Data_getSize },
+	{ "getValue", w_Data_getValue },
+	{ "setValue", w_Data_setValue },
+	{ "getValues", w_Data_getValues },
+	{ "setValues", w_Data_setValues },
+	{ "copyFrom", w_Data_copyFrom },
+	{ "fill", w_Data_fill },
+	{ "atomicLoad", w_Data_atomicLoad },
+	{ "atomicStore", w_Data_atomicStore },
+	{ "atomicExchange", w_Data_atomicExchange },
+	{ "atomicAdd", w_Data_atomicAdd },
+	{ "atomicCompareExchange", w_Data_atomicCompareExchange },
 	{ 0, 0 }
 };
 
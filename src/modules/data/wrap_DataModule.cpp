@@ -22,9 +22,14 @@
 #include "wrap_DataModule.h"
 #include "wrap_Data.h"
 #include "wrap_ByteData.h"
+#include "wrap_ByteDataBuilder.h"
 #include "wrap_DataView.h"
 #include "wrap_CompressedData.h"
+#include "wrap_CompressionContext.h"
+#include "wrap_CompressionStream.h"
+#include "wrap_Hasher.h"
 #include "DataModule.h"
+#include "BlockCompressor.h"
 #include "common/b64.h"
 
 // Lua 5.3
@@ -35,6 +40,7 @@
 #include <iostream>
 #include <algorithm>
 #include <limits>
+#include <vector>
 
 namespace love
 {
@@ -110,6 +116,20 @@ int w_newByteData(lua_State *L)
 	return 1;
 }
 
+int w_newByteDataBuilder(lua_State *L)
+{
+	lua_Integer capacity = luaL_optinteger(L, 1, 0);
+	if (capacity < 0)
+		return luaL_argerror(L, 1, "capacity must not be negative");
+
+	ByteDataBuilder *b = nullptr;
+	luax_catchexcept(L, [&]() { b = DataModule::instance.newByteDataBuilder((size_t) capacity); });
+
+	luax_pushtype(L, b);
+	b->release();
+	return 1;
+}
+
 int w_compress(lua_State *L)
 {
 	ContainerType ctype = luax_checkcontainertype(L, 1);
@@ -145,6 +165,30 @@ int w_compress(lua_State *L)
 	return 1;
 }
 
+char *luax_checkdatadestination(lua_State *L, int idx, size_t &dstsize)
+{
+	Data *dst = luax_checkdata(L, idx);
+	lua_Integer offset = luaL_checkinteger(L, idx + 1);
+
+	if (offset < 0 || (size_t) offset > dst->getSize())
+		luaL_error(L, "Invalid destination byte offset: %d", (int) offset);
+
+	dstsize = dst->getSize() - (size_t) offset;
+	return (char *) dst->getData() + offset;
+}
+
+static const char *checkSource(lua_State *L, int idx, size_t &srclen)
+{
+	if (luax_istype(L, idx, Data::type))
+	{
+		Data *data = luax_totype<Data>(L, idx);
+		srclen = data->getSize();
+		return (const char *) data->getData();
+	}
+
+	return luaL_checklstring(L, idx, &srclen);
+}
+
 int w_decompress(lua_State *L)
 {
 	ContainerType ctype = luax_checkcontainertype(L, 1);
@@ -197,6 +241,303 @@ int w_decompress(lua_State *L)
 	return 1;
 }
 
+int w_decompressInto(lua_State *L)
+{
+	size_t dstsize = 0;
+	char *dst = luax_checkdatadestination(L, 1, dstsize);
+
+	size_t written = 0;
+
+	if (luax_istype(L, 3, CompressedData::type))
+	{
+		CompressedData *data = luax_checkcompresseddata(L, 3);
+		luax_catchexcept(L, [&](){ written = decompressInto(data, dst, dstsize); });
+	}
+	else
+	{
+		Compressor::Format format = Compressor::FORMAT_LZ4;
+		const char *fstr = luaL_checkstring(L, 3);
+
+		if (!Compressor::getConstant(fstr, format))
+			return luax_enumerror(L, "compressed data format", Compressor::getConstants(format), fstr);
+
+		size_t compressedsize = 0;
+		const char *cbytes = checkSource(L, 4, compressedsize);
+
+		luax_catchexcept(L, [&](){ written = decompressInto(format, cbytes, compressedsize, dst, dstsize); });
+	}
+
+	lua_pushnumber(L, (lua_Number) written);
+	return 1;
+}
+
+int w_getDecompressedSize(lua_State *L)
+{
+	size_t rawsize = 0;
+
+	if (luax_istype(L, 1, CompressedData::type))
+	{
+		CompressedData *data = luax_checkcompresseddata(L, 1);
+		rawsize = data->getDecompressedSize();
+		if (rawsize == 0)
+			rawsize = Compressor::getDecompressedSize(data->getFormat(), (const char *) data->getData(), data->getSize());
+	}
+	else
+	{
+		Compressor::Format format = Compressor::FORMAT_LZ4;
+		const char *fstr = luaL_checkstring(L, 1);
+
+		if (!Compressor::getConstant(fstr, format))
+			return luax_enumerror(L, "compressed data format", Compressor::getConstants(format), fstr);
+
+		size_t compressedsize = 0;
+		const char *cbytes = checkSource(L, 2, compressedsize);
+		rawsize = Compressor::getDecompressedSize(format, cbytes, compressedsize);
+	}
+
+	// Unknown for formats which don't record it.
+	if (rawsize > 0)
+		lua_pushnumber(L, (lua_Number) rawsize);
+	else
+		lua_pushnil(L);
+
+	return 1;
+}
+
+int w_newCompressionStream(lua_State *L)
+{
+	const char *fstr = luaL_checkstring(L, 1);
+	Compressor::Format format = Compressor::FORMAT_LZ4;
+
+	if (!Compressor::getConstant(fstr, format))
+		return luax_enumerror(L, "compressed data format", Compressor::getConstants(format), fstr);
+
+	const char *mstr = luaL_checkstring(L, 2);
+	CompressionStream::Mode mode = CompressionStream::MODE_COMPRESS;
+
+	if (!CompressionStream::getConstant(mstr, mode))
+		return luax_enumerror(L, "compression stream mode", CompressionStream::getConstants(mode), mstr);
+
+	int level = (int) luaL_optinteger(L, 3, -1);
+
+	CompressionStream *s = nullptr;
+	luax_catchexcept(L, [&](){ s = DataModule::instance.newCompressionStream(format, mode, level); });
+
+	luax_pushtype(L, s);
+	s->release();
+	return 1;
+}
+
+int w_newCompressionContext(lua_State *L)
+{
+	const char *fstr = luaL_checkstring(L, 1);
+	Compressor::Format format = Compressor::FORMAT_LZ4;
+
+	if (!Compressor::getConstant(fstr, format))
+		return luax_enumerror(L, "compressed data format", Compressor::getConstants(format), fstr);
+
+	int level = (int) luaL_optinteger(L, 2, -1);
+
+	StrongRef<Data> dictionary;
+	if (luax_istype(L, 3, Data::type))
+		dictionary.set(luax_checkdata(L, 3));
+	else if (!lua_isnoneornil(L, 3))
+	{
+		size_t size = 0;
+		const char *str = luaL_checklstring(L, 3, &size);
+		luax_catchexcept(L, [&]() { dictionary.set(DataModule::instance.newByteData(str, size), Acquire::NORETAIN); });
+	}
+
+	CompressionContext *c = nullptr;
+	luax_catchexcept(L, [&](){ c = DataModule::instance.newCompressionContext(format, level, dictionary.get()); });
+
+	luax_pushtype(L, c);
+	c->release();
+	return 1;
+}
+
+int w_trainDictionary(lua_State *L)
+{
+	ContainerType ctype = luax_checkcontainertype(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+
+	// zstd's default dictionary size.
+	lua_Integer maxsize = luaL_optinteger(L, 3, 112640);
+	if (maxsize <= 0)
+		return luaL_error(L, "Dictionary size must be greater than 0.");
+
+	int count = (int) luax_objlen(L, 2);
+
+	// The samples are only referenced from the table until they're copied
+	// into one contiguous block, which is what the trainer expects.
+	std::vector<std::pair<const char *, size_t>> samples;
+	size_t totalsize = 0;
+
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, 2, i);
+
+		size_t size = 0;
+		const char *bytes = nullptr;
+
+		if (luax_istype(L, -1, Data::type))
+		{
+			Data *data = luax_checkdata(L, -1);
+			bytes = (const char *) data->getData();
+			size = data->getSize();
+		}
+		else if (lua_type(L, -1) == LUA_TSTRING)
+			bytes = lua_tolstring(L, -1, &size);
+		else
+			return luaL_error(L, "Expected string or Data at index %d.", i);
+
+		lua_pop(L, 1);
+
+		samples.emplace_back(bytes, size);
+		totalsize += size;
+	}
+
+	char *dict = nullptr;
+	size_t dictsize = 0;
+
+	luax_catchexcept(L, [&]()
+	{
+		std::vector<char> buffer;
+		std::vector<size_t> sizes;
+
+		buffer.reserve(totalsize);
+		sizes.reserve(samples.size());
+
+		for (const auto &sample : samples)
+		{
+			buffer.insert(buffer.end(), sample.first, sample.first + sample.second);
+			sizes.push_back(sample.second);
+		}
+
+		dict = CompressionContext::trainDictionary(buffer.data(), sizes, (size_t) maxsize, dictsize);
+	});
+
+	if (ctype == CONTAINER_DATA)
+	{
+		ByteData *data = nullptr;
+		luax_catchexcept(L,
+			[&]() { data = DataModule::instance.newByteData(dict, dictsize, true); },
+			[&](bool failed) { if (failed) delete[] dict; }
+		);
+		luax_pushtype(L, Data::type, data);
+		data->release();
+	}
+	else
+	{
+		lua_pushlstring(L, dict, dictsize);
+		delete[] dict;
+	}
+
+	return 1;
+}
+
+static int pushBlockBuffer(lua_State *L, ContainerType ctype, char *bytes, size_t size)
+{
+	if (ctype == CONTAINER_DATA)
+	{
+		ByteData *data = nullptr;
+		luax_catchexcept(L,
+			[&]() { data = DataModule::instance.newByteData(bytes, size, true); },
+			[&](bool failed) { if (failed) delete[] bytes; }
+		);
+		luax_pushtype(L, Data::type, data);
+		data->release();
+	}
+	else
+	{
+		lua_pushlstring(L, bytes, size);
+		delete[] bytes;
+	}
+
+	return 1;
+}
+
+static const char *checkBlockBytes(lua_State *L, int idx, size_t &size)
+{
+	if (luax_istype(L, idx, Data::type))
+	{
+		Data *data = luax_checkdata(L, idx);
+		size = data->getSize();
+		return (const char *) data->getData();
+	}
+
+	return luaL_checklstring(L, idx, &size);
+}
+
+int w_compressBlocks(lua_State *L)
+{
+	ContainerType ctype = luax_checkcontainertype(L, 1);
+
+	const char *fstr = luaL_checkstring(L, 2);
+	Compressor::Format format = Compressor::FORMAT_LZ4;
+
+	if (!Compressor::getConstant(fstr, format))
+		return luax_enumerror(L, "compressed data format", Compressor::getConstants(format), fstr);
+
+	size_t rawsize = 0;
+	const char *rawbytes = checkBlockBytes(L, 3, rawsize);
+
+	int level = (int) luaL_optinteger(L, 4, -1);
+
+	lua_Integer blocksize = luaL_optinteger(L, 5, (lua_Integer) BlockCompressor::DEFAULT_BLOCK_SIZE);
+	if (blocksize <= 0)
+		return luaL_error(L, "Block size must be greater than 0.");
+
+	char *cbytes = nullptr;
+	size_t csize = 0;
+	luax_catchexcept(L, [&](){ cbytes = BlockCompressor::compress(format, rawbytes, rawsize, level, (size_t) blocksize, csize); });
+
+	return pushBlockBuffer(L, ctype, cbytes, csize);
+}
+
+int w_decompressBlocks(lua_State *L)
+{
+	ContainerType ctype = luax_checkcontainertype(L, 1);
+
+	size_t csize = 0;
+	const char *cbytes = checkBlockBytes(L, 2, csize);
+
+	char *rawbytes = nullptr;
+	size_t rawsize = 0;
+
+	if (lua_isnoneornil(L, 3))
+		luax_catchexcept(L, [&](){ rawbytes = BlockCompressor::decompress(cbytes, csize, rawsize); });
+	else
+	{
+		lua_Integer block = luaL_checkinteger(L, 3) - 1;
+		if (block < 0)
+			return luaL_error(L, "Invalid block index: %d", (int) block + 1);
+
+		luax_catchexcept(L, [&](){ rawbytes = BlockCompressor::decompressBlock(cbytes, csize, (size_t) block, rawsize); });
+	}
+
+	return pushBlockBuffer(L, ctype, rawbytes, rawsize);
+}
+
+int w_getBlockInfo(lua_State *L)
+{
+	size_t csize = 0;
+	const char *cbytes = checkBlockBytes(L, 1, csize);
+
+	BlockCompressor::Info info;
+	luax_catchexcept(L, [&](){ info = BlockCompressor::getInfo(cbytes, csize); });
+
+	const char *fstr = nullptr;
+	if (!Compressor::getConstant(info.format, fstr))
+		return luaL_error(L, "Unknown compressed data format.");
+
+	lua_pushstring(L, fstr);
+	lua_pushnumber(L, (lua_Number) info.blockSize);
+	lua_pushnumber(L, (lua_Number) info.blockCount);
+	lua_pushnumber(L, (lua_Number) info.rawSize);
+	return 4;
+}
+
 int w_encode(lua_State *L)
 {
 	ContainerType ctype = luax_checkcontainertype(L, 1);
@@ -297,6 +638,73 @@ int w_decode(lua_State *L)
 	return 1;
 }
 
+// Shared by encodeInto and decodeInto: the destination Data and offset.
+int w_encodeInto(lua_State *L)
+{
+	const char *formatstr = luaL_checkstring(L, 1);
+	EncodeFormat format;
+	if (!getConstant(formatstr, format))
+		return luax_enumerror(L, "encode format", getConstants(format), formatstr);
+
+	size_t dstsize = 0;
+	char *dst = luax_checkdatadestination(L, 2, dstsize);
+
+	size_t srclen = 0;
+	const char *src = checkSource(L, 4, srclen);
+
+	size_t linelen = (size_t) luaL_optinteger(L, 5, 0);
+
+	size_t written = 0;
+	luax_catchexcept(L, [&](){ written = encodeInto(format, src, srclen, dst, dstsize, linelen); });
+
+	lua_pushnumber(L, (lua_Number) written);
+	return 1;
+}
+
+int w_decodeInto(lua_State *L)
+{
+	const char *formatstr = luaL_checkstring(L, 1);
+	EncodeFormat format;
+	if (!getConstant(formatstr, format))
+		return luax_enumerror(L, "decode format", getConstants(format), formatstr);
+
+	size_t dstsize = 0;
+	char *dst = luax_checkdatadestination(L, 2, dstsize);
+
+	size_t srclen = 0;
+	const char *src = checkSource(L, 4, srclen);
+
+	size_t written = 0;
+	luax_catchexcept(L, [&](){ written = decodeInto(format, src, srclen, dst, dstsize); });
+
+	lua_pushnumber(L, (lua_Number) written);
+	return 1;
+}
+
+int w_getEncodedSize(lua_State *L)
+{
+	const char *formatstr = luaL_checkstring(L, 1);
+	EncodeFormat format;
+	if (!getConstant(formatstr, format))
+		return luax_enumerror(L, "encode format", getConstants(format), formatstr);
+
+	size_t srclen = 0;
+	if (lua_isnumber(L, 2))
+	{
+		lua_Integer size = luaL_checkinteger(L, 2);
+		if (size < 0)
+			return luaL_error(L, "Invalid size: %d", (int) size);
+		srclen = (size_t) size;
+	}
+	else
+		checkSource(L, 2, srclen);
+
+	size_t linelen = (size_t) luaL_optinteger(L, 3, 0);
+
+	lua_pushnumber(L, (lua_Number) getEncodedSize(format, srclen, linelen));
+	return 1;
+}
+
 int w_hash(lua_State *L)
 {
 	const char *fstr = luaL_checkstring(L, 1);
@@ -321,6 +729,21 @@ int w_hash(lua_State *L)
 	return 1;
 }
 
+int w_newHasher(lua_State *L)
+{
+	const char *fstr = luaL_checkstring(L, 1);
+	HashFunction::Function function;
+	if (!HashFunction::getConstant(fstr, function))
+		return luax_enumerror(L, "hash function", HashFunction::getConstants(function), fstr);
+
+	Hasher *h = nullptr;
+	luax_catchexcept(L, [&](){ h = DataModule::instance.newHasher(function); });
+
+	luax_pushtype(L, h);
+	h->release();
+	return 1;
+}
+
 int w_pack(lua_State *L)
 {
 	ContainerType ctype = luax_checkcontainertype(L, 1);
@@ -368,11 +791,24 @@ static const luaL_Reg functions[] =
 {
 	{ "newDataView", w_newDataView },
 	{ "newByteData", w_newByteData },
+	{ "newByteDataBuilder", w_newByteDataBuilder },
 	{ "compress", w_compress },
 	{ "decompress", w_decompress },
+	{ "decompressInto", w_decompressInto },
+	{ "getDecompressedSize", w_getDecompressedSize },
+	{ "newCompressionStream", w_newCompressionStream },
+	{ "newCompressionContext", w_newCompressionContext },
+	{ "trainDictionary", w_trainDictionary },
+	{ "compressBlocks", w_compressBlocks },
+	{ "decompressBlocks", w_decompressBlocks },
+	{ "getBlockInfo", w_getBlockInfo },
 	{ "encode", w_encode },
 	{ "decode", w_decode },
+	{ "encodeInto", w_encodeInto },
+	{ "decodeInto", w_decodeInto },
+	{ "getEncodedSize", w_getEncodedSize },
 	{ "hash", w_hash },
+	{ "newHasher", w_newHasher },
 
 	{ "pack", w_pack },
 	{ "unpack", w_unpack },
@@ -385,8 +821,12 @@ static const lua_CFunction types[] =
 {
 	luaopen_data,
 	luaopen_bytedata,
+	luaopen_bytedatabuilder,
 	luaopen_dataview,
 	luaopen_compresseddata,
+	luaopen_compressioncontext,
+	luaopen_compressionstream,
+	luaopen_hasher,
 	nullptr
 };
 
@@ -31,6 +31,13 @@ namespace data
 {
 
 ContainerType luax_checkcontainertype(lua_State *L, int idx);
+
+/**
+ * Gets a pointer to a Data argument at the given byte offset (the next
+ * argument), and the number of bytes after it.
+ **/
+char *luax_checkdatadestination(lua_State *L, int idx, size_t &dstsize);
+
 int w_compress(lua_State *L);
 int w_decompress(lua_State *L);
 extern "C" LOVE_EXPORT int luaopen_love_data(lua_State *L);
@@ -20,6 +20,11 @@
 
 #include "Event.h"
 
+// C++
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
+
 using love::thread::Mutex;
 using love::thread::Lock;
 
@@ -28,86 +33,277 @@ namespace love
 namespace event
 {
 
-Message::Message(const std::string &name, const std::vector<Variant> &vargs)
-	: name(name)
-	, args(vargs)
+// Event names are interned, so messages only have to store an index.
+class EventNames
+{
+public:
+
+	EventNames()
+	{
+		names.push_back("");
+		ids[""] = 0;
+	}
+
+	int getID(const char *name)
+	{
+		Lock lock(mutex);
+
+		auto it = ids.find(name);
+		if (it != ids.end())
+			return it->second;
+
+		int id = (int) names.size();
+		names.push_back(name);
+		ids[name] = id;
+		return id;
+	}
+
+	const std::string &getName(int id)
+	{
+		// Elements of a deque stay in place when more are added, so the
+		// reference is still valid after the lock is released.
+		Lock lock(mutex);
+		return names[id];
+	}
+
+private:
+
+	love::thread::MutexRef mutex;
+	std::deque<std::string> names;
+	std::unordered_map<std::string, int> ids;
+
+}; // EventNames
+
+static EventNames &getEventNames()
+{
+	static EventNames names;
+	return names;
+}
+
+Message::Message()
+	: nameID(0)
+	, argCount(0)
+{
+}
+
+Message::Message(const char *name)
+	: nameID(getEventNames().getID(name))
+	, argCount(0)
+{
+}
+
+void Message::setName(const char *name)
+{
+	nameID = getEventNames().getID(name);
+}
+
+const std::string &Message::getName() const
+{
+	return getEventNames().getName(nameID);
+}
+
+bool Message::hasName() const
 {
+	return nameID != 0;
 }
 
-Message::~Message()
+void Message::addArg(const Variant &arg)
 {
+	if (argCount >= MAX_ARGS)
+		throw love::Exception("Events can have at most %d arguments.", MAX_ARGS);
+
+	args[argCount++] = arg;
 }
 
-int Message::toLua(lua_State *L)
+int Message::getArgCount() const
 {
-	luax_pushstring(L, name);
+	return argCount;
+}
 
-	for (const Variant &v : args)
-		v.toLua(L);
+void Message::clear()
+{
+	for (int i = 0; i < argCount; i++)
+		args[i] = Variant();
 
-	return (int) args.size() + 1;
+	nameID = 0;
+	argCount = 0;
 }
 
-Message *Message::fromLua(lua_State *L, int n)
+int Message::toLua(lua_State *L) const
 {
-	std::string name = luax_checkstring(L, n);
-	std::vector<Variant> vargs;
+	luax_pushstring(L, getName());
+
+	for (int i = 0; i < argCount; i++)
+		args[i].toLua(L);
+
+	return argCount + 1;
+}
+
+void Message::fromLua(lua_State *L, int n, Message &msg)
+{
+	msg.clear();
+	msg.setName(luaL_checkstring(L, n));
 
 	int count = lua_gettop(L) - n;
 	n++;
 
-	Variant varg;
-
 	for (int i = 0; i < count; i++)
 	{
 		if (lua_isnoneornil(L, n+i))
 			break;
 
-		luax_catchexcept(L, [&]() {
-			vargs.push_back(Variant::fromLua(L, n+i));
-		});
+		if (i >= MAX_ARGS)
+		{
+			msg.clear();
+			luaL_error(L, "Events can have at most %d arguments.", MAX_ARGS);
+		}
+
+		Variant arg;
+		luax_catchexcept(L, [&]() { arg = Variant::fromLua(L, n+i); });
 
-		if (vargs.back().getType() == Variant::UNKNOWN)
+		if (arg.getType() == Variant::UNKNOWN)
 		{
-			vargs.clear();
+			msg.clear();
 			luaL_error(L, "Argument %d can't be stored safely\nExpected boolean, number, string or userdata.", n+i);
-			return nullptr;
 		}
+
+		msg.addArg(arg);
 	}
+}
 
-	return new Message(name, vargs);
+Event::Event()
+	: coalescing(false)
+	, rawSampleHead(0)
+	, rawSampleCount(0)
+	, droppedRawSamples(0)
+	, queueHead(0)
+	, queueCount(0)
+{
+	queue.resize(64);
 }
 
 Event::~Event()
 {
 }
 
-void Event::push(Message *msg)
+void Event::push(const Message &msg)
 {
 	Lock lock(mutex);
-	msg->retain();
-	queue.push(msg);
+
+	if (queueCount == queue.size())
+	{
+		// Unwrap the ring into a bigger buffer.
+		std::vector<Message> newqueue(queue.size() * 2);
+		for (size_t i = 0; i < queueCount; i++)
+			newqueue[i] = queue[(queueHead + i) % queue.size()];
+
+		queue.swap(newqueue);
+		queueHead = 0;
+	}
+
+	queue[(queueHead + queueCount) % queue.size()] = msg;
+	queueCount++;
 }
 
-bool Event::poll(Message *&msg)
+bool Event::poll(Message &msg)
 {
 	Lock lock(mutex);
-	if (queue.empty())
+
+	if (queueCount == 0)
 		return false;
-	msg = queue.front();
-	queue.pop();
+
+	Message &front = queue[queueHead];
+	msg = front;
+	front.clear();
+
+	queueHead = (queueHead + 1) % queue.size();
+	queueCount--;
 	return true;
 }
 
 void Event::clear()
 {
 	Lock lock(mutex);
-	while (!queue.empty())
+
+	for (size_t i = 0; i < queueCount; i++)
+		queue[(queueHead + i) % queue.size()].clear();
+
+	queueHead = 0;
+	queueCount = 0;
+}
+
+void Event::setCoalescing(bool enable)
+{
+	coalescing = enable;
+}
+
+bool Event::getCoalescing() const
+{
+	return coalescing;
+}
+
+void Event::setRawSampleCapacity(int capacity)
+{
+	Lock lock(mutex);
+
+	rawSamples.clear();
+	rawSamples.resize(std::max(capacity, 0));
+	rawSamples.shrink_to_fit();
+
+	rawSampleHead = 0;
+	rawSampleCount = 0;
+	droppedRawSamples = 0;
+}
+
+int Event::getRawSampleCapacity() const
+{
+	return (int) rawSamples.size();
+}
+
+void Event::addRawSample(const Message &msg, double time)
+{
+	Lock lock(mutex);
+
+	if (rawSamples.empty())
+		return;
+
+	if (rawSampleCount == rawSamples.size())
 	{
-		// std::queue::pop will remove the first (front) element.
-		queue.front()->release();
-		queue.pop();
+		// Overwrite the oldest sample.
+		rawSampleHead = (rawSampleHead + 1) % rawSamples.size();
+		rawSampleCount--;
+		droppedRawSamples++;
 	}
+
+	RawSample &sample = rawSamples[(rawSampleHead + rawSampleCount) % rawSamples.size()];
+	sample.message = msg;
+	sample.time = time;
+	rawSampleCount++;
+}
+
+bool Event::pollRawSample(Message &msg, double &time)
+{
+	Lock lock(mutex);
+
+	if (rawSampleCount == 0)
+		return false;
+
+	RawSample &sample = rawSamples[rawSampleHead];
+	msg = sample.message;
+	time = sample.time;
+	sample.message.clear();
+
+	rawSampleHead = (rawSampleHead + 1) % rawSamples.size();
+	rawSampleCount--;
+	return true;
+}
+
+int64 Event::getDroppedRawSampleCount()
+{
+	Lock lock(mutex);
+	int64 dropped = droppedRawSamples;
+	droppedRawSamples = 0;
+	return dropped;
 }
 
 } // event
@@ -31,7 +31,7 @@
 #include "thread/threads.h"
 
 // C++
-#include <queue>
+#include <string>
 #include <vector>
 
 namespace love
@@ -39,41 +39,113 @@ namespace love
 namespace event
 {
 
-class Message : public Object
+/**
+ * An event and its arguments. The arguments are stored inside the message and
+ * the name is interned, so creating and queueing a message doesn't allocate
+ * (except for strings too long to be stored in a Variant directly.)
+ **/
+class Message
 {
 public:
 
-	Message(const std::string &name, const std::vector<Variant> &vargs = {});
-	~Message();
+	static const int MAX_ARGS = 8;
+
+	Message();
+	Message(const char *name);
+
+	void setName(const char *name);
+	const std::string &getName() const;
+	bool hasName() const;
+
+	/**
+	 * Throws an exception if the message already has MAX_ARGS arguments.
+	 **/
+	void addArg(const Variant &arg);
+
+	int getArgCount() const;
+
+	/**
+	 * Removes the name and arguments, releasing any objects they refer to.
+	 **/
+	void clear();
 
-	int toLua(lua_State *L);
-	static Message *fromLua(lua_State *L, int n);
+	int toLua(lua_State *L) const;
+	static void fromLua(lua_State *L, int n, Message &msg);
 
 private:
 
-	std::string name;
-	std::vector<Variant> args;
+	// 0 is the empty name.
+	int nameID;
+
+	int argCount;
+	Variant args[MAX_ARGS];
 
 }; // Message
 
 class Event : public Module
 {
 public:
+
+	Event();
 	virtual ~Event();
 
 	// Implements Module.
 	virtual ModuleType getModuleType() const { return M_EVENT; }
 
-	void push(Message *msg);
-	bool poll(Message *&msg);
+	void push(const Message &msg);
+	bool poll(Message &msg);
 	virtual void clear();
 
 	virtual void pump() = 0;
-	virtual Message *wait() = 0;
+	virtual bool wait(Message &msg) = 0;
+
+	/**
+	 * When enabled, pump() merges high-rate motion events: consecutive mouse
+	 * and touch motion from the same device become one event with the latest
+	 * position and the summed deltas, and only the latest value of each
+	 * joystick and gamepad axis is kept.
+	 **/
+	void setCoalescing(bool enable);
+	bool getCoalescing() const;
+
+	/**
+	 * Keeps up to 'capacity' timestamped copies of the motion and axis events
+	 * before they're coalesced, for code which needs every sample. The oldest
+	 * samples are dropped when the buffer is full. 0 disables sampling.
+	 **/
+	void setRawSampleCapacity(int capacity);
+	int getRawSampleCapacity() const;
+
+	void addRawSample(const Message &msg, double time);
+	bool pollRawSample(Message &msg, double &time);
+
+	/**
+	 * Gets the number of samples dropped since the last call.
+	 **/
+	int64 getDroppedRawSampleCount();
 
 protected:
+
+	struct RawSample
+	{
+		Message message;
+		double time;
+	};
+
 	love::thread::MutexRef mutex;
-	std::queue<Message *> queue;
+
+	bool coalescing;
+
+	std::vector<RawSample> rawSamples;
+	size_t rawSampleHead;
+	size_t rawSampleCount;
+	int64 droppedRawSamples;
+
+	// A ring buffer of pending messages. The slots are reused, so it only
+	// grows when more messages are pending than ever before.
+	std::vector<Message> queue;
+	size_t queueHead;
+	size_t queueCount;
 
 }; // Event
 
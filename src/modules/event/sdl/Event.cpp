@@ -19,6 +19,7 @@
  **/
 
 #include "Event.h"
+#include "common/profiling.h"
 
 #include "filesystem/DroppedFile.h"
 #include "filesystem/Filesystem.h"
@@ -116,31 +117,60 @@ Event::~Event()
 
 void Event::pump()
 {
+	LOVE_PROFILE_ZONE("Event:pump");
+
 	exceptionIfInRenderPass("love.event.pump");
 
 	SDL_Event e;
+	Message msg;
+
+	bool sampling = getRawSampleCapacity() > 0;
 
 	while (SDL_PollEvent(&e))
 	{
-		Message *msg = convert(e);
-		if (msg)
+		// SDL timestamps are in milliseconds.
+		double time = e.common.timestamp / 1000.0;
+
+		bool coalescable = isCoalescable(e);
+
+		if (!coalescable)
+			flushCoalescedEvents(msg);
+		else if (coalescing)
+		{
+			if (sampling && convert(e, msg))
+				addRawSample(msg, time);
+
+			coalesce(e);
+			continue;
+		}
+
+		if (convert(e, msg))
 		{
+			if (coalescable && sampling)
+				addRawSample(msg, time);
+
 			push(msg);
-			msg->release();
 		}
 	}
+
+	flushCoalescedEvents(msg);
+
+	// Joystick states are updated along with the events.
+	auto joymodule = Module::getInstance<joystick::JoystickModule>(Module::M_JOYSTICK);
+	if (joymodule)
+		joymodule->setLastPumpTime(SDL_GetTicks() / 1000.0);
 }
 
-Message *Event::wait()
+bool Event::wait(Message &msg)
 {
 	exceptionIfInRenderPass("love.event.wait");
 
 	SDL_Event e;
 
 	if (SDL_WaitEvent(&e) != 1)
-		return nullptr;
+		return false;
 
-	return convert(e);
+	return convert(e, msg);
 }
 
 void Event::clear()
@@ -154,6 +184,8 @@ void Event::clear()
 		// Do nothing with 'e' ...
 	}
 
+	coalescedEvents.clear();
+
 	love::event::Event::clear();
 }
 
@@ -168,12 +200,87 @@ void Event::exceptionIfInRenderPass(const char *name)
 		throw love::Exception("%s cannot be called while a Canvas is active in love.graphics.", name);
 }
 
-Message *Event::convert(const SDL_Event &e)
+bool Event::isCoalescable(const SDL_Event &e)
+{
+	switch (e.type)
+	{
+	case SDL_MOUSEMOTION:
+	case SDL_FINGERMOTION:
+	case SDL_JOYAXISMOTION:
+	case SDL_CONTROLLERAXISMOTION:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void Event::coalesce(const SDL_Event &e)
+{
+	for (SDL_Event &held : coalescedEvents)
+	{
+		if (held.type != e.type)
+			continue;
+
+		switch (e.type)
+		{
+		case SDL_MOUSEMOTION:
+			if (held.motion.which == e.motion.which)
+			{
+				int xrel = held.motion.xrel + e.motion.xrel;
+				int yrel = held.motion.yrel + e.motion.yrel;
+				held.motion = e.motion;
+				held.motion.xrel = xrel;
+				held.motion.yrel = yrel;
+				return;
+			}
+			break;
+		case SDL_FINGERMOTION:
+			if (held.tfinger.touchId == e.tfinger.touchId && held.tfinger.fingerId == e.tfinger.fingerId)
+			{
+				float dx = held.tfinger.dx + e.tfinger.dx;
+				float dy = held.tfinger.dy + e.tfinger.dy;
+				held.tfinger = e.tfinger;
+				held.tfinger.dx = dx;
+				held.tfinger.dy = dy;
+				return;
+			}
+			break;
+		case SDL_JOYAXISMOTION:
+			if (held.jaxis.which == e.jaxis.which && held.jaxis.axis == e.jaxis.axis)
+			{
+				held.jaxis = e.jaxis;
+				return;
+			}
+			break;
+		case SDL_CONTROLLERAXISMOTION:
+			if (held.caxis.which == e.caxis.which && held.caxis.axis == e.caxis.axis)
+			{
+				held.caxis = e.caxis;
+				return;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	coalescedEvents.push_back(e);
+}
+
+void Event::flushCoalescedEvents(Message &msg)
 {
-	Message *msg = nullptr;
+	for (const SDL_Event &e : coalescedEvents)
+	{
+		if (convert(e, msg))
+			push(msg);
+	}
+
+	coalescedEvents.clear();
+}
 
-	std::vector<Variant> vargs;
-	vargs.reserve(4);
+bool Event::convert(const SDL_Event &e, Message &msg)
+{
+	msg.clear();
 
 	love::filesystem::Filesystem *filesystem = nullptr;
 
@@ -214,10 +321,10 @@ Message *Event::convert(const SDL_Event &e)
 		if (!love::keyboard::Keyboard::getConstant(scancode, txt2))
 			txt2 = "unknown";
 
-		vargs.emplace_back(txt, strlen(txt));
-		vargs.emplace_back(txt2, strlen(txt2));
-		vargs.emplace_back(e.key.repeat != 0);
-		msg = new Message("keypressed", vargs);
+		msg.addArg(Variant(txt, strlen(txt)));
+		msg.addArg(Variant(txt2, strlen(txt2)));
+		msg.addArg(Variant(e.key.repeat != 0));
+		msg.setName("keypressed");
 		break;
 	case SDL_KEYUP:
 		keyit = keys.find(e.key.keysym.sym);
@@ -231,21 +338,21 @@ Message *Event::convert(const SDL_Event &e)
 		if (!love::keyboard::Keyboard::getConstant(scancode, txt2))
 			txt2 = "unknown";
 
-		vargs.emplace_back(txt, strlen(txt));
-		vargs.emplace_back(txt2, strlen(txt2));
-		msg = new Message("keyreleased", vargs);
+		msg.addArg(Variant(txt, strlen(txt)));
+		msg.addArg(Variant(txt2, strlen(txt2)));
+		msg.setName("keyreleased");
 		break;
 	case SDL_TEXTINPUT:
 		txt = e.text.text;
-		vargs.emplace_back(txt, strlen(txt));
-		msg = new Message("textinput", vargs);
+		msg.addArg(Variant(txt, strlen(txt)));
+		msg.setName("textinput");
 		break;
 	case SDL_TEXTEDITING:
 		txt = e.edit.text;
-		vargs.emplace_back(txt, strlen(txt));
-		vargs.emplace_back((double) e.edit.start);
-		vargs.emplace_back((double) e.edit.length);
-		msg = new Message("textedited", vargs);
+		msg.addArg(Variant(txt, strlen(txt)));
+		msg.addArg(Variant((double) e.edit.start));
+		msg.addArg(Variant((double) e.edit.length));
+		msg.setName("textedited");
 		break;
 	case SDL_MOUSEMOTION:
 		{
@@ -255,12 +362,12 @@ Message *Event::convert(const SDL_Event &e)
 			double yrel = (double) e.motion.yrel;
 			windowToDPICoords(&x, &y);
 			windowToDPICoords(&xrel, &yrel);
-			vargs.emplace_back(x);
-			vargs.emplace_back(y);
-			vargs.emplace_back(xrel);
-			vargs.emplace_back(yrel);
-			vargs.emplace_back(e.motion.which == SDL_TOUCH_MOUSEID);
-			msg = new Message("mousemoved", vargs);
+			msg.addArg(Variant(x));
+			msg.addArg(Variant(y));
+			msg.addArg(Variant(xrel));
+			msg.addArg(Variant(yrel));
+			msg.addArg(Variant(e.motion.which == SDL_TOUCH_MOUSEID));
+			msg.setName("mousemoved");
 		}
 		break;
 	case SDL_MOUSEBUTTONDOWN:
@@ -281,20 +388,20 @@ Message *Event::convert(const SDL_Event &e)
 			double px = (double) e.button.x;
 			double py = (double) e.button.y;
 			windowToDPICoords(&px, &py);
-			vargs.emplace_back(px);
-			vargs.emplace_back(py);
-			vargs.emplace_back((double) button);
-			vargs.emplace_back(e.button.which == SDL_TOUCH_MOUSEID);
-			vargs.emplace_back((double) e.button.clicks);
+			msg.addArg(Variant(px));
+			msg.addArg(Variant(py));
+			msg.addArg(Variant((double) button));
+			msg.addArg(Variant(e.button.which == SDL_TOUCH_MOUSEID));
+			msg.addArg(Variant((double) e.button.clicks));
 
 			bool down = e.type == SDL_MOUSEBUTTONDOWN;
-			msg = new Message(down ? "mousepressed" : "mousereleased", vargs);
+			msg.setName(down ? "mousepressed" : "mousereleased");
 		}
 		break;
 	case SDL_MOUSEWHEEL:
-		vargs.emplace_back((double) e.wheel.x);
-		vargs.emplace_back((double) e.wheel.y);
-		msg = new Message("wheelmoved", vargs);
+		msg.addArg(Variant((double) e.wheel.x));
+		msg.addArg(Variant((double) e.wheel.y));
+		msg.setName("wheelmoved");
 		break;
 	case SDL_FINGERDOWN:
 	case SDL_FINGERUP:
@@ -338,12 +445,12 @@ Message *Event::convert(const SDL_Event &e)
 		// bits as can fit in a pointer (for now.)
 		// We use lightuserdata instead of a lua_Number (double) because doubles
 		// can't represent all possible id values on 64-bit systems.
-		vargs.emplace_back((void *) (intptr_t) touchinfo.id);
-		vargs.emplace_back(touchinfo.x);
-		vargs.emplace_back(touchinfo.y);
-		vargs.emplace_back(touchinfo.dx);
-		vargs.emplace_back(touchinfo.dy);
-		vargs.emplace_back(touchinfo.pressure);
+		msg.addArg(Variant((void *) (intptr_t) touchinfo.id));
+		msg.addArg(Variant(touchinfo.x));
+		msg.addArg(Variant(touchinfo.y));
+		msg.addArg(Variant(touchinfo.dx));
+		msg.addArg(Variant(touchinfo.dy));
+		msg.addArg(Variant(touchinfo.pressure));
 
 		if (e.type == SDL_FINGERDOWN)
 			txt = "touchpressed";
@@ -351,7 +458,7 @@ Message *Event::convert(const SDL_Event &e)
 			txt = "touchreleased";
 		else
 			txt = "touchmoved";
-		msg = new Message(txt, vargs);
+		msg.setName(txt);
 #endif
 		break;
 	case SDL_JOYBUTTONDOWN:
@@ -364,10 +471,10 @@ Message *Event::convert(const SDL_Event &e)
 	case SDL_CONTROLLERBUTTONDOWN:
 	case SDL_CONTROLLERBUTTONUP:
 	case SDL_CONTROLLERAXISMOTION:
-		msg = convertJoystickEvent(e);
+		convertJoystickEvent(e, msg);
 		break;
 	case SDL_WINDOWEVENT:
-		msg = convertWindowEvent(e);
+		convertWindowEvent(e, msg);
 		break;
 	case SDL_DROPFILE:
 		filesystem = Module::getInstance<filesystem::Filesystem>(Module::M_FILESYSTEM);
@@ -378,14 +485,14 @@ Message *Event::convert(const SDL_Event &e)
 
 			if (filesystem->isRealDirectory(e.drop.file))
 			{
-				vargs.emplace_back(e.drop.file, strlen(e.drop.file));
-				msg = new Message("directorydropped", vargs);
+				msg.addArg(Variant(e.drop.file, strlen(e.drop.file)));
+				msg.setName("directorydropped");
 			}
 			else
 			{
 				auto *file = new love::filesystem::DroppedFile(e.drop.file);
-				vargs.emplace_back(&love::filesystem::DroppedFile::type, file);
-				msg = new Message("filedropped", vargs);
+				msg.addArg(Variant(&love::filesystem::DroppedFile::type, file));
+				msg.setName("filedropped");
 				file->release();
 			}
 		}
@@ -393,28 +500,24 @@ Message *Event::convert(const SDL_Event &e)
 		break;
 	case SDL_QUIT:
 	case SDL_APP_TERMINATING:
-		msg = new Message("quit");
+		msg.setName("quit");
 		break;
 	case SDL_APP_LOWMEMORY:
-		msg = new Message("lowmemory");
+		msg.setName("lowmemory");
 		break;
 	default:
 		break;
 	}
 
-	return msg;
+	return msg.hasName();
 }
 
-Message *Event::convertJoystickEvent(const SDL_Event &e) const
+bool Event::convertJoystickEvent(const SDL_Event &e, Message &msg) const
 {
 	auto joymodule = Module::getInstance<joystick::JoystickModule>(Module::M_JOYSTICK);
 	if (!joymodule)
-		return nullptr;
-
-	Message *msg = nullptr;
+		return false;
 
-	std::vector<Variant> vargs;
-	vargs.reserve(4);
 
 	love::Type *joysticktype = &love::joystick::Joystick::type;
 	love::joystick::Joystick *stick = nullptr;
@@ -431,11 +534,9 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 		if (!stick)
 			break;
 
-		vargs.emplace_back(joysticktype, stick);
-		vargs.emplace_back((double)(e.jbutton.button+1));
-		msg = new Message((e.type == SDL_JOYBUTTONDOWN) ?
-						  "joystickpressed" : "joystickreleased",
-						  vargs);
+		msg.addArg(Variant(joysticktype, stick));
+		msg.addArg(Variant((double)(e.jbutton.button+1)));
+		msg.setName(e.type == SDL_JOYBUTTONDOWN ? "joystickpressed" : "joystickreleased");
 		break;
 	case SDL_JOYAXISMOTION:
 		{
@@ -443,11 +544,11 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 			if (!stick)
 				break;
 
-			vargs.emplace_back(joysticktype, stick);
-			vargs.emplace_back((double)(e.jaxis.axis+1));
+			msg.addArg(Variant(joysticktype, stick));
+			msg.addArg(Variant((double)(e.jaxis.axis+1)));
 			float value = joystick::Joystick::clampval(e.jaxis.value / 32768.0f);
-			vargs.emplace_back((double) value);
-			msg = new Message("joystickaxis", vargs);
+			msg.addArg(Variant((double) value));
+			msg.setName("joystickaxis");
 		}
 		break;
 	case SDL_JOYHATMOTION:
@@ -458,10 +559,10 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 		if (!stick)
 			break;
 
-		vargs.emplace_back(joysticktype, stick);
-		vargs.emplace_back((double)(e.jhat.hat+1));
-		vargs.emplace_back(txt, strlen(txt));
-		msg = new Message("joystickhat", vargs);
+		msg.addArg(Variant(joysticktype, stick));
+		msg.addArg(Variant((double)(e.jhat.hat+1)));
+		msg.addArg(Variant(txt, strlen(txt)));
+		msg.setName("joystickhat");
 		break;
 	case SDL_CONTROLLERBUTTONDOWN:
 	case SDL_CONTROLLERBUTTONUP:
@@ -475,10 +576,9 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 		if (!stick)
 			break;
 
-		vargs.emplace_back(joysticktype, stick);
-		vargs.emplace_back(txt, strlen(txt));
-		msg = new Message(e.type == SDL_CONTROLLERBUTTONDOWN ?
-						  "gamepadpressed" : "gamepadreleased", vargs);
+		msg.addArg(Variant(joysticktype, stick));
+		msg.addArg(Variant(txt, strlen(txt)));
+		msg.setName(e.type == SDL_CONTROLLERBUTTONDOWN ? "gamepadpressed" : "gamepadreleased");
 		break;
 	case SDL_CONTROLLERAXISMOTION:
 		if (joystick::sdl::Joystick::getConstant((SDL_GameControllerAxis) e.caxis.axis, padaxis))
@@ -490,11 +590,11 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 			if (!stick)
 				break;
 
-			vargs.emplace_back(joysticktype, stick);
-			vargs.emplace_back(txt, strlen(txt));
+			msg.addArg(Variant(joysticktype, stick));
+			msg.addArg(Variant(txt, strlen(txt)));
 			float value = joystick::Joystick::clampval(e.caxis.value / 32768.0f);
-			vargs.emplace_back((double) value);
-			msg = new Message("gamepadaxis", vargs);
+			msg.addArg(Variant((double) value));
+			msg.setName("gamepadaxis");
 		}
 		break;
 	case SDL_JOYDEVICEADDED:
@@ -502,8 +602,8 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 		stick = joymodule->addJoystick(e.jdevice.which);
 		if (stick)
 		{
-			vargs.emplace_back(joysticktype, stick);
-			msg = new Message("joystickadded", vargs);
+			msg.addArg(Variant(joysticktype, stick));
+			msg.setName("joystickadded");
 		}
 		break;
 	case SDL_JOYDEVICEREMOVED:
@@ -512,46 +612,42 @@ Message *Event::convertJoystickEvent(const SDL_Event &e) const
 		if (stick)
 		{
 			joymodule->removeJoystick(stick);
-			vargs.emplace_back(joysticktype, stick);
-			msg = new Message("joystickremoved", vargs);
+			msg.addArg(Variant(joysticktype, stick));
+			msg.setName("joystickremoved");
 		}
 		break;
 	default:
 		break;
 	}
 
-	return msg;
+	return msg.hasName();
 }
 
-Message *Event::convertWindowEvent(const SDL_Event &e)
+bool Event::convertWindowEvent(const SDL_Event &e, Message &msg)
 {
-	Message *msg = nullptr;
-
-	std::vector<Variant> vargs;
-	vargs.reserve(4);
 
 	window::Window *win = nullptr;
 	graphics::Graphics *gfx = nullptr;
 
 	if (e.type != SDL_WINDOWEVENT)
-		return nullptr;
+		return false;
 
 	switch (e.window.event)
 	{
 	case SDL_WINDOWEVENT_FOCUS_GAINED:
 	case SDL_WINDOWEVENT_FOCUS_LOST:
-		vargs.emplace_back(e.window.event == SDL_WINDOWEVENT_FOCUS_GAINED);
-		msg = new Message("focus", vargs);
+		msg.addArg(Variant(e.window.event == SDL_WINDOWEVENT_FOCUS_GAINED));
+		msg.setName("focus");
 		break;
 	case SDL_WINDOWEVENT_ENTER:
 	case SDL_WINDOWEVENT_LEAVE:
-		vargs.emplace_back(e.window.event == SDL_WINDOWEVENT_ENTER);
-		msg = new Message("mousefocus", vargs);
+		msg.addArg(Variant(e.window.event == SDL_WINDOWEVENT_ENTER));
+		msg.setName("mousefocus");
 		break;
 	case SDL_WINDOWEVENT_SHOWN:
 	case SDL_WINDOWEVENT_HIDDEN:
-		vargs.emplace_back(e.window.event == SDL_WINDOWEVENT_SHOWN);
-		msg = new Message("visible", vargs);
+		msg.addArg(Variant(e.window.event == SDL_WINDOWEVENT_SHOWN));
+		msg.setName("visible");
 		break;
 	case SDL_WINDOWEVENT_RESIZED:
 		{
@@ -576,9 +672,9 @@ Message *Event::convertWindowEvent(const SDL_Event &e)
 				windowToDPICoords(&width, &height);
 			}
 
-			vargs.emplace_back(width);
-			vargs.emplace_back(height);
-			msg = new Message("resize", vargs);
+			msg.addArg(Variant(width));
+			msg.addArg(Variant(height));
+			msg.setName("resize");
 		}
 		break;
 	case SDL_WINDOWEVENT_SIZE_CHANGED:
@@ -611,7 +707,7 @@ Message *Event::convertWindowEvent(const SDL_Event &e)
 		break;
 	}
 
-	return msg;
+	return msg.hasName();
 }
 
 std::map<SDL_Keycode, love::keyboard::Keyboard::Key> Event::createKeyMap()
@@ -60,7 +60,7 @@ public:
 	 * the screen and game state only needs updating when the user interacts with
 	 * the window.
 	 **/
-	Message *wait();
+	bool wait(Message &msg);
 
 	/**
 	 * Clears the event queue.
@@ -71,9 +71,17 @@ private:
 
 	void exceptionIfInRenderPass(const char *name);
 
-	Message *convert(const SDL_Event &e);
-	Message *convertJoystickEvent(const SDL_Event &e) const;
-	Message *convertWindowEvent(const SDL_Event &e);
+	static bool isCoalescable(const SDL_Event &e);
+	void coalesce(const SDL_Event &e);
+	void flushCoalescedEvents(Message &msg);
+
+	bool convert(const SDL_Event &e, Message &msg);
+	bool convertJoystickEvent(const SDL_Event &e, Message &msg) const;
+	bool convertWindowEvent(const SDL_Event &e, Message &msg);
+
+	// Motion and axis events held back by coalescing until the end of pump(),
+	// or until an event of another kind arrives.
+	std::vector<SDL_Event> coalescedEvents;
 
 	static std::map<SDL_Keycode, love::keyboard::Keyboard::Key> createKeyMap();
 	static std::map<SDL_Keycode, love::keyboard::Keyboard::Key> keys;
@@ -30,6 +30,10 @@ static const char event_lua[] =
 #include "wrap_Event.lua"
 ;
 
+#ifdef LOVE_PRECOMPILED_LUA
+#include "luabytecode/event_lua.h"
+#endif
+
 namespace love
 {
 namespace event
@@ -39,14 +43,10 @@ namespace event
 
 static int w_poll_i(lua_State *L)
 {
-	Message *m = nullptr;
+	Message m;
 
 	if (instance()->poll(m))
-	{
-		int args = m->toLua(L);
-		m->release();
-		return args;
-	}
+		return m.toLua(L);
 
 	// No pending events.
 	return 0;
@@ -60,29 +60,24 @@ int w_pump(lua_State *L)
 
 int w_wait(lua_State *L)
 {
-	Message *m = nullptr;
-	luax_catchexcept(L, [&]() { m = instance()->wait(); });
-	if (m)
-	{
-		int args = m->toLua(L);
-		m->release();
-		return args;
-	}
+	Message m;
+	bool received = false;
+	luax_catchexcept(L, [&]() { received = instance()->wait(m); });
+
+	if (received)
+		return m.toLua(L);
 
 	return 0;
 }
 
 int w_push(lua_State *L)
 {
-	StrongRef<Message> m;
-	luax_catchexcept(L, [&]() { m.set(Message::fromLua(L, 1), Acquire::NORETAIN); });
-
-	luax_pushboolean(L, m.get() != nullptr);
+	Message m;
+	Message::fromLua(L, 1, m);
 
-	if (m.get() == nullptr)
-		return 1;
+	luax_catchexcept(L, [&]() { instance()->push(m); });
 
-	instance()->push(m);
+	luax_pushboolean(L, true);
 	return 1;
 }
 
@@ -95,9 +90,8 @@ int w_clear(lua_State *L)
 int w_quit(lua_State *L)
 {
 	luax_catchexcept(L, [&]() {
-		std::vector<Variant> args = {Variant::fromLua(L, 1)};
-
-		StrongRef<Message> m(new Message("quit", args), Acquire::NORETAIN);
+		Message m("quit");
+		m.addArg(Variant::fromLua(L, 1));
 		instance()->push(m);
 	});
 
@@ -105,6 +99,70 @@ int w_quit(lua_State *L)
 	return 1;
 }
 
+int w_setCoalescing(lua_State *L)
+{
+	instance()->setCoalescing(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_getCoalescing(lua_State *L)
+{
+	luax_pushboolean(L, instance()->getCoalescing());
+	return 1;
+}
+
+int w_setRawSampling(lua_State *L)
+{
+	int capacity = (int) luaL_checkinteger(L, 1);
+	if (capacity < 0)
+		return luaL_error(L, "Raw sample capacity can't be negative.");
+
+	luax_catchexcept(L, [&]() { instance()->setRawSampleCapacity(capacity); });
+	return 0;
+}
+
+int w_getRawSampling(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getRawSampleCapacity());
+	return 1;
+}
+
+int w_getRawSamples(lua_State *L)
+{
+	lua_newtable(L);
+
+	Message m;
+	double time = 0.0;
+	int count = 0;
+
+	while (instance()->pollRawSample(m, time))
+	{
+		// { name, time, args... }
+		int top = lua_gettop(L);
+		int nargs = m.toLua(L);
+
+		lua_createtable(L, nargs + 1, 0);
+
+		lua_pushvalue(L, top + 1);
+		lua_rawseti(L, -2, 1);
+
+		lua_pushnumber(L, time);
+		lua_rawseti(L, -2, 2);
+
+		for (int i = 2; i <= nargs; i++)
+		{
+			lua_pushvalue(L, top + i);
+			lua_rawseti(L, -2, i + 1);
+		}
+
+		lua_rawseti(L, top, ++count);
+		lua_settop(L, top);
+	}
+
+	lua_pushnumber(L, (lua_Number) instance()->getDroppedRawSampleCount());
+	return 2;
+}
+
 // List of functions to wrap.
 static const luaL_Reg functions[] =
 {
@@ -114,6 +172,11 @@ static const luaL_Reg functions[] =
 	{ "push", w_push },
 	{ "clear", w_clear },
 	{ "quit", w_quit },
+	{ "setCoalescing", w_setCoalescing },
+	{ "getCoalescing", w_getCoalescing },
+	{ "setRawSampling", w_setRawSampling },
+	{ "getRawSampling", w_getRawSampling },
+	{ "getRawSamples", w_getRawSamples },
 	{ 0, 0 }
 };
 
@@ -136,7 +199,7 @@ extern "C" int luaopen_love_event(lua_State *L)
 
 	int ret = luax_register_module(L, w);
 
-	if (luaL_loadbuffer(L, (const char *)event_lua, sizeof(event_lua), "wrap_Event.lua") == 0)
+	if (luax_loadembedded(L, LOVE_EMBEDDED_BYTECODE(event_lua), event_lua, sizeof(event_lua), "wrap_Event.lua") == 0)
 		lua_call(L, 0, 0);
 	else
 		lua_error(L);
@@ -0,0 +1,238 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "AssetCache.h"
+#include "Filesystem.h"
+#include "common/Module.h"
+#include "data/DataModule.h"
+#include "thread/threads.h"
+
+// C++
+#include <atomic>
+
+// C
+#include <cstring>
+
+namespace love
+{
+namespace filesystem
+{
+
+// Changing the entry layout must bump this, so stale entries aren't loaded.
+// Processing code should put its own version in the key parameters instead.
+static const uint32 CACHE_VERSION = 1;
+static const char CACHE_MAGIC[4] = {'L', 'V', 'A', 'C'};
+static const char *CACHE_DIRECTORY = "assetcache";
+
+// Keeps payloads 16-byte aligned in mapped files.
+struct EntryHeader
+{
+	char magic[4];
+	uint32 version;
+	uint64 size;
+};
+
+static std::atomic<bool> enabledCategories[AssetCache::CATEGORY_MAX_ENUM] =
+{
+	{false}, // imagedata
+	{false}, // mipmaps
+	{true},  // shaders
+};
+
+// Entries with the same key (e.g. the same image decoded on two threads) would
+// otherwise share writeAtomic's temporary file.
+static thread::Mutex *getWriteMutex()
+{
+	static thread::MutexRef mutex;
+	return mutex;
+}
+
+static std::string hashToHex(const void *data, size_t size)
+{
+	data::HashFunction::Value hashvalue;
+	data::hash(data::HashFunction::FUNCTION_XXH3_128, (const char *) data, size, hashvalue);
+
+	static const char hexchars[] = "0123456789abcdef";
+
+	std::string hex;
+	for (size_t i = 0; i < hashvalue.size; i++)
+	{
+		uint8 b = (uint8) hashvalue.data[i];
+		hex += hexchars[b >> 4];
+		hex += hexchars[b & 0xF];
+	}
+
+	return hex;
+}
+
+void AssetCache::setEnabled(Category category, bool enable)
+{
+	enabledCategories[category] = enable;
+}
+
+bool AssetCache::isEnabled(Category category)
+{
+	return enabledCategories[category];
+}
+
+std::string AssetCache::getKey(const void *content, size_t size, const std::string &params)
+{
+	return getKey(hashToHex(content, size) + "\n" + params);
+}
+
+std::string AssetCache::getKey(const std::string &params)
+{
+	std::string key = params + "\n" + std::to_string(CACHE_VERSION);
+	return hashToHex(key.c_str(), key.size());
+}
+
+std::string AssetCache::getDirectory(Category category)
+{
+	const char *name = "unknown";
+	getConstant(category, name);
+	return std::string(CACHE_DIRECTORY) + "/" + name;
+}
+
+std::string AssetCache::getFilename(Category category, const std::string &key)
+{
+	return getDirectory(category) + "/" + key + ".bin";
+}
+
+bool AssetCache::load(Category category, const std::string &key, Entry &entry)
+{
+	auto fs = Module::getInstance<Filesystem>(Module::M_FILESYSTEM);
+	if (fs == nullptr || key.empty() || !isEnabled(category))
+		return false;
+
+	std::string filename = getFilename(category, key);
+
+	Filesystem::Info info = {};
+	if (!fs->getInfo(filename.c_str(), info) || info.type != Filesystem::FILETYPE_FILE)
+		return false;
+
+	StrongRef<FileData> file;
+
+	try
+	{
+		file.set(fs->mapFile(filename.c_str()), Acquire::NORETAIN);
+	}
+	catch (love::Exception &)
+	{
+		return false;
+	}
+
+	if (file->getSize() < sizeof(EntryHeader))
+		return false;
+
+	EntryHeader header;
+	memcpy(&header, file->getData(), sizeof(EntryHeader));
+
+	if (memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION
+		|| header.size != file->getSize() - sizeof(EntryHeader))
+		return false;
+
+	entry.file = file;
+	entry.payload = (const uint8 *) file->getData() + sizeof(EntryHeader);
+	entry.size = (size_t) header.size;
+
+	return true;
+}
+
+bool AssetCache::save(Category category, const std::string &key, const void *payload, size_t size)
+{
+	auto fs = Module::getInstance<Filesystem>(Module::M_FILESYSTEM);
+	if (fs == nullptr || key.empty() || !isEnabled(category))
+		return false;
+
+	std::vector<uint8> contents(sizeof(EntryHeader) + size);
+
+	EntryHeader header;
+	memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	header.version = CACHE_VERSION;
+	header.size = size;
+
+	memcpy(contents.data(), &header, sizeof(EntryHeader));
+	memcpy(contents.data() + sizeof(EntryHeader), payload, size);
+
+	thread::Lock lock(getWriteMutex());
+
+	try
+	{
+		fs->createDirectory(getDirectory(category).c_str());
+		fs->writeAtomic(getFilename(category, key).c_str(), contents.data(), (int64) contents.size());
+	}
+	catch (love::Exception &)
+	{
+		// Not being able to write to the save directory isn't an error here.
+		return false;
+	}
+
+	return true;
+}
+
+void AssetCache::remove(Category category, const std::string &key)
+{
+	auto fs = Module::getInstance<Filesystem>(Module::M_FILESYSTEM);
+	if (fs != nullptr && !key.empty())
+		fs->remove(getFilename(category, key).c_str());
+}
+
+void AssetCache::clear(Category category)
+{
+	auto fs = Module::getInstance<Filesystem>(Module::M_FILESYSTEM);
+	if (fs == nullptr)
+		return;
+
+	std::string dir = getDirectory(category);
+
+	std::vector<std::string> items;
+	fs->getDirectoryItems(dir.c_str(), items);
+
+	for (const std::string &item : items)
+		fs->remove((dir + "/" + item).c_str());
+}
+
+bool AssetCache::getConstant(const char *in, Category &out)
+{
+	return categories.find(in, out);
+}
+
+bool AssetCache::getConstant(Category in, const char *&out)
+{
+	return categories.find(in, out);
+}
+
+std::vector<std::string> AssetCache::getConstants(Category)
+{
+	return categories.getNames();
+}
+
+StringMap<AssetCache::Category, AssetCache::CATEGORY_MAX_ENUM>::Entry AssetCache::categoryEntries[] =
+{
+	{ "imagedata", CATEGORY_IMAGEDATA },
+	{ "mipmaps",   CATEGORY_MIPMAPS   },
+	{ "shaders",   CATEGORY_SHADERS   },
+};
+
+StringMap<AssetCache::Category, AssetCache::CATEGORY_MAX_ENUM> AssetCache::categories(AssetCache::categoryEntries, sizeof(AssetCache::categoryEntries));
+
+} // filesystem
+} // love
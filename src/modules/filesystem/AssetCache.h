@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "FileData.h"
+#include "common/int.h"
+#include "common/StringMap.h"
+
+// C++
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace filesystem
+{
+
+/**
+ * A content-addressed cache of processed assets in the save directory, so
+ * expensive CPU processing (image decoding, mipmap filtering, shader linking)
+ * only happens the first time some content is seen.
+ *
+ * Entries are keyed by an XXH3 hash of the source content plus a string of
+ * the processing parameters, which should include everything else the result
+ * depends on. Loaded entries are memory-mapped where possible. Entries are
+ * written atomically, and any entry which fails validation is a miss.
+ *
+ * Each category is enabled separately. Shader binaries are cached by default;
+ * decoded images and mipmaps take disk space proportional to their pixels, so
+ * they're opt-in.
+ **/
+class AssetCache
+{
+public:
+
+	enum Category
+	{
+		CATEGORY_IMAGEDATA,
+		CATEGORY_MIPMAPS,
+		CATEGORY_SHADERS,
+		CATEGORY_MAX_ENUM
+	};
+
+	struct Entry
+	{
+		// Keeps the payload's memory alive.
+		StrongRef<FileData> file;
+		const uint8 *payload = nullptr;
+		size_t size = 0;
+	};
+
+	static void setEnabled(Category category, bool enable);
+	static bool isEnabled(Category category);
+
+	/**
+	 * Gets the key for size bytes of content processed with the given
+	 * parameters.
+	 **/
+	static std::string getKey(const void *content, size_t size, const std::string &params);
+
+	/**
+	 * Gets the key for a result which depends on several pieces of content,
+	 * given as keys or hashes of their own.
+	 **/
+	static std::string getKey(const std::string &params);
+
+	/**
+	 * Loads an entry. Returns false on a miss, or when the category is
+	 * disabled or there's no save directory.
+	 **/
+	static bool load(Category category, const std::string &key, Entry &entry);
+
+	/**
+	 * Writes an entry, replacing any old one. Failures are ignored, since the
+	 * cache is only an optimization. Returns whether the entry was written.
+	 **/
+	static bool save(Category category, const std::string &key, const void *payload, size_t size);
+
+	// Removes an entry, e.g. after its contents turned out to be unusable.
+	static void remove(Category category, const std::string &key);
+
+	// Removes every entry of the category.
+	static void clear(Category category);
+
+	static bool getConstant(const char *in, Category &out);
+	static bool getConstant(Category in, const char *&out);
+	static std::vector<std::string> getConstants(Category);
+
+private:
+
+	static std::string getDirectory(Category category);
+	static std::string getFilename(Category category, const std::string &key);
+
+	static StringMap<Category, CATEGORY_MAX_ENUM>::Entry categoryEntries[];
+	static StringMap<Category, CATEGORY_MAX_ENUM> categories;
+
+}; // AssetCache
+
+} // filesystem
+} // love
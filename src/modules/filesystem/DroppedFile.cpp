@@ -209,6 +209,7 @@ bool DroppedFile::setBuffer(BufferMode bufmode, int64 size)
 		vbufmode = _IOLBF;
 		break;
 	case File::BUFFER_FULL:
+	case File::BUFFER_READAHEAD:
 		vbufmode = _IOFBF;
 		break;
 	}
@@ -138,6 +138,7 @@ StringMap<File::BufferMode, File::BUFFER_MAX_ENUM>::Entry File::bufferModeEntrie
 	{ "none", BUFFER_NONE },
 	{ "line", BUFFER_LINE },
 	{ "full", BUFFER_FULL },
+	{ "readahead", BUFFER_READAHEAD },
 };
 
 StringMap<File::BufferMode, File::BUFFER_MAX_ENUM> File::bufferModes(File::bufferModeEntries, sizeof(File::bufferModeEntries));
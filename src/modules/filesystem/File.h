@@ -63,6 +63,7 @@ public:
 		BUFFER_NONE,
 		BUFFER_LINE,
 		BUFFER_FULL,
+		BUFFER_READAHEAD,
 		BUFFER_MAX_ENUM
 	};
 
@@ -172,6 +173,9 @@ public:
 	 * buffer's capacity is reached.
 	 * In the BUFFER_LINE mode, the file will also write to disk if a newline is
 	 * written.
+	 * BUFFER_READAHEAD only applies to files opened for reading. Data after
+	 * the read position is fetched in the background, and the size is the
+	 * initial amount fetched at a time.
 	 *
 	 * @param bufmode The buffer mode.
 	 * @param size The size in bytes of the buffer.
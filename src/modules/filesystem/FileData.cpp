@@ -24,6 +24,16 @@
 #include <iostream>
 #include <limits>
 
+#ifdef LOVE_WINDOWS
+#include <windows.h>
+#include "common/utf8.h"
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace love
 {
 namespace filesystem
@@ -34,7 +44,8 @@ love::Type FileData::type("FileData", &Data::type);
 FileData::FileData(uint64 size, const std::string &filename)
 	: data(nullptr)
 	, size((size_t) size)
-	, filename(filename)
+	, mapped(false)
+	, mapOffset(0)
 {
 	try
 	{
@@ -45,6 +56,27 @@ FileData::FileData(uint64 size, const std::string &filename)
 		throw love::Exception("Out of memory.");
 	}
 
+	setFilename(filename);
+	setNativeMemorySize(type, size);
+}
+
+FileData::FileData(const std::string &filename)
+	: data(nullptr)
+	, size(0)
+	, mapped(false)
+	, mapOffset(0)
+{
+	setFilename(filename);
+
+	// Memory-mapped files are backed by the file, so they're counted without
+	// their size.
+	setNativeMemorySize(type, 0);
+}
+
+void FileData::setFilename(const std::string &filename)
+{
+	this->filename = filename;
+
 	size_t dotpos = filename.rfind('.');
 
 	if (dotpos != std::string::npos)
@@ -59,6 +91,8 @@ FileData::FileData(uint64 size, const std::string &filename)
 FileData::FileData(const FileData &c)
 	: data(nullptr)
 	, size(c.size)
+	, mapped(false)
+	, mapOffset(0)
 	, filename(c.filename)
 	, extension(c.extension)
 	, name(c.name)
@@ -72,11 +106,108 @@ FileData::FileData(const FileData &c)
 		throw love::Exception("Out of memory.");
 	}
 	memcpy(data, c.data, size);
+	setNativeMemorySize(type, size);
 }
 
 FileData::~FileData()
 {
-	delete [] data;
+	if (!mapped)
+		delete [] data;
+	else
+	{
+#ifdef LOVE_WINDOWS
+		UnmapViewOfFile(data);
+#else
+		munmap(data - mapOffset, (size_t) size + mapOffset);
+#endif
+	}
+}
+
+FileData *FileData::createMapped(const std::string &path, const std::string &filename)
+{
+#ifdef LOVE_WINDOWS
+	void *view = nullptr;
+	uint64 viewsize = 0;
+
+	std::wstring wpath = to_widestr(path);
+
+	HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return nullptr;
+
+	LARGE_INTEGER filesize;
+	if (GetFileSizeEx(file, &filesize) && filesize.QuadPart > 0)
+	{
+		// Copy-on-write pages, so writes through getData don't reach the file.
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+		if (mapping != nullptr)
+		{
+			view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+			viewsize = (uint64) filesize.QuadPart;
+
+			// The view keeps the mapping and file alive.
+			CloseHandle(mapping);
+		}
+	}
+
+	CloseHandle(file);
+
+	if (view == nullptr)
+		return nullptr;
+
+	FileData *filedata = new FileData(filename);
+	filedata->data = (char *) view;
+	filedata->size = viewsize;
+	filedata->mapped = true;
+	return filedata;
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return nullptr;
+
+	FileData *filedata = nullptr;
+
+	struct stat buf;
+	if (fstat(fd, &buf) == 0 && S_ISREG(buf.st_mode) && buf.st_size > 0)
+		filedata = createMapped(fd, 0, (int64) buf.st_size, filename);
+
+	// The mapping stays valid after the descriptor is closed.
+	close(fd);
+
+	return filedata;
+#endif
+}
+
+#ifndef LOVE_WINDOWS
+
+FileData *FileData::createMapped(int fd, int64 offset, int64 size, const std::string &filename)
+{
+	if (fd < 0 || offset < 0 || size <= 0)
+		return nullptr;
+
+	// mmap offsets have to be page aligned.
+	int64 pagesize = (int64) sysconf(_SC_PAGESIZE);
+	int64 start = pagesize > 0 ? offset - (offset % pagesize) : offset;
+	size_t delta = (size_t) (offset - start);
+
+	// Copy-on-write pages, so writes through getData don't reach the file.
+	void *view = mmap(nullptr, (size_t) size + delta, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, (off_t) start);
+	if (view == MAP_FAILED)
+		return nullptr;
+
+	FileData *filedata = new FileData(filename);
+	filedata->data = (char *) view + delta;
+	filedata->size = (uint64) size;
+	filedata->mapped = true;
+	filedata->mapOffset = delta;
+	return filedata;
+}
+
+#endif // LOVE_WINDOWS
+
+bool FileData::isMapped() const
+{
+	return mapped;
 }
 
 FileData *FileData::clone() const
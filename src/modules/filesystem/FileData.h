@@ -53,14 +53,45 @@ public:
 	const std::string &getExtension() const;
 	const std::string &getName() const;
 
+	/**
+	 * Creates a FileData whose contents are the file at path on disk, mapped
+	 * into memory instead of copied. Pages are loaded as they're accessed and
+	 * writes stay private to the FileData. Returns null if the file can't be
+	 * mapped.
+	 * @param path The full path of the file on disk.
+	 * @param filename The filename used for file type identification.
+	 **/
+	static FileData *createMapped(const std::string &path, const std::string &filename);
+
+#ifndef LOVE_WINDOWS
+	/**
+	 * Like the above, but maps a range of an already open file. The range
+	 * doesn't need to be page aligned, and fd can be closed afterwards.
+	 **/
+	static FileData *createMapped(int fd, int64 offset, int64 size, const std::string &filename);
+#endif
+
+	bool isMapped() const;
+
 private:
 
+	FileData(const std::string &filename);
+
+	void setFilename(const std::string &filename);
+
 	// The actual data.
 	char *data;
 
 	// Size of the data.
 	uint64 size;
 
+	// Whether data is a file mapping rather than heap memory.
+	bool mapped;
+
+	// Distance from the start of the mapping to data, when the mapped range
+	// didn't start on a page boundary.
+	size_t mapOffset;
+
 	// The filename used for error purposes.
 	std::string filename;
 
@@ -0,0 +1,251 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "FileRequest.h"
+#include "Filesystem.h"
+
+namespace love
+{
+namespace filesystem
+{
+
+love::Type FileRequest::type("FileRequest", &Object::type);
+
+FileRequest::FileRequest(Operation operation, const std::string &filename, love::Data *data, int priority)
+	: operation(operation)
+	, filename(filename)
+	, input(data)
+	, priority(priority)
+	, sequence(0)
+	, state(STATE_PENDING)
+{
+}
+
+FileRequest::~FileRequest()
+{
+}
+
+FileRequest::Operation FileRequest::getOperation() const
+{
+	return operation;
+}
+
+const std::string &FileRequest::getFilename() const
+{
+	return filename;
+}
+
+int FileRequest::getPriority() const
+{
+	return priority;
+}
+
+bool FileRequest::isComplete() const
+{
+	thread::Lock lock(mutex);
+	return state == STATE_DONE || state == STATE_CANCELLED;
+}
+
+bool FileRequest::isCancelled() const
+{
+	thread::Lock lock(mutex);
+	return state == STATE_CANCELLED;
+}
+
+void FileRequest::wait()
+{
+	thread::Lock lock(mutex);
+	while (state == STATE_PENDING || state == STATE_RUNNING)
+		cond->wait(mutex);
+}
+
+bool FileRequest::cancel()
+{
+	thread::Lock lock(mutex);
+
+	if (state != STATE_PENDING)
+		return false;
+
+	state = STATE_CANCELLED;
+	input.set(nullptr);
+	cond->broadcast();
+	return true;
+}
+
+FileData *FileRequest::getData() const
+{
+	thread::Lock lock(mutex);
+
+	if (state == STATE_CANCELLED)
+		throw love::Exception("Could not access file '%s': the request was cancelled.", filename.c_str());
+
+	if (state != STATE_DONE)
+		return nullptr;
+
+	if (!error.empty())
+		throw love::Exception("%s", error.c_str());
+
+	return result.get();
+}
+
+bool FileRequest::begin()
+{
+	thread::Lock lock(mutex);
+
+	if (state != STATE_PENDING)
+		return false;
+
+	state = STATE_RUNNING;
+	return true;
+}
+
+void FileRequest::run(Filesystem *filesystem)
+{
+	StrongRef<FileData> data;
+	std::string err;
+
+	try
+	{
+		const char *name = filename.c_str();
+
+		if (operation == OPERATION_READ)
+			data.set(filesystem->read(name), Acquire::NORETAIN);
+		else if (operation == OPERATION_WRITE)
+			filesystem->write(name, input->getData(), input->getSize());
+		else if (operation == OPERATION_APPEND)
+			filesystem->append(name, input->getData(), input->getSize());
+		else if (operation == OPERATION_SAVE)
+			filesystem->writeAtomic(name, input->getData(), input->getSize());
+	}
+	catch (std::exception &e)
+	{
+		err = e.what();
+	}
+
+	thread::Lock lock(mutex);
+	result = data;
+	error = err;
+	input.set(nullptr);
+	state = STATE_DONE;
+	cond->broadcast();
+}
+
+StringMap<FileRequest::Operation, FileRequest::OPERATION_MAX_ENUM>::Entry FileRequest::operationEntries[] =
+{
+	{ "read",   OPERATION_READ   },
+	{ "write",  OPERATION_WRITE  },
+	{ "append", OPERATION_APPEND },
+	{ "save",   OPERATION_SAVE   },
+};
+
+StringMap<FileRequest::Operation, FileRequest::OPERATION_MAX_ENUM> FileRequest::operations(FileRequest::operationEntries, sizeof(FileRequest::operationEntries));
+
+bool FileRequest::getConstant(const char *in, Operation &out)
+{
+	return operations.find(in, out);
+}
+
+bool FileRequest::getConstant(Operation in, const char *&out)
+{
+	return operations.find(in, out);
+}
+
+std::vector<std::string> FileRequest::getConstants(Operation)
+{
+	return operations.getNames();
+}
+
+FileIOThread::FileIOThread(Filesystem *filesystem)
+	: filesystem(filesystem)
+	, nextSequence(0)
+	, stopping(false)
+{
+	threadName = "FileIO";
+}
+
+FileIOThread::~FileIOThread()
+{
+	stop();
+}
+
+void FileIOThread::submit(FileRequest *request)
+{
+	thread::Lock lock(mutex);
+
+	if (stopping)
+		throw love::Exception("The file I/O thread has stopped.");
+
+	request->sequence = nextSequence++;
+	pending.push_back(request);
+	cond->broadcast();
+}
+
+void FileIOThread::stop()
+{
+	std::vector<StrongRef<FileRequest>> cancelled;
+
+	{
+		thread::Lock lock(mutex);
+		stopping = true;
+		cancelled.swap(pending);
+		cond->broadcast();
+	}
+
+	for (const auto &request : cancelled)
+		request->cancel();
+
+	wait();
+}
+
+void FileIOThread::threadFunction()
+{
+	while (true)
+	{
+		StrongRef<FileRequest> request;
+
+		{
+			thread::Lock lock(mutex);
+
+			while (!stopping && pending.empty())
+				cond->wait(mutex);
+
+			if (stopping)
+				return;
+
+			// Highest priority first, then in submission order.
+			auto best = pending.begin();
+			for (auto it = pending.begin() + 1; it != pending.end(); ++it)
+			{
+				FileRequest *r = it->get();
+				if (r->priority > (*best)->priority || (r->priority == (*best)->priority && r->sequence < (*best)->sequence))
+					best = it;
+			}
+
+			request = *best;
+			pending.erase(best);
+		}
+
+		if (request->begin())
+			request->run(filesystem);
+	}
+}
+
+} // filesystem
+} // love
@@ -0,0 +1,167 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_FILESYSTEM_FILE_REQUEST_H
+#define LOVE_FILESYSTEM_FILE_REQUEST_H
+
+// LOVE
+#include "common/Object.h"
+#include "common/Data.h"
+#include "common/StringMap.h"
+#include "thread/threads.h"
+#include "FileData.h"
+
+// C++
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace filesystem
+{
+
+class Filesystem;
+
+/**
+ * A read, write, append or save run on the Filesystem's I/O thread. Completion is
+ * polled, like the other asynchronous objects.
+ **/
+class FileRequest : public Object
+{
+public:
+
+	static love::Type type;
+
+	enum Operation
+	{
+		OPERATION_READ,
+		OPERATION_WRITE,
+		OPERATION_APPEND,
+		OPERATION_SAVE,
+		OPERATION_MAX_ENUM
+	};
+
+	/**
+	 * @param data The data to write or append. Unused for reads.
+	 * @param priority Pending requests with a higher priority run first.
+	 **/
+	FileRequest(Operation operation, const std::string &filename, love::Data *data, int priority);
+	virtual ~FileRequest();
+
+	Operation getOperation() const;
+	const std::string &getFilename() const;
+	int getPriority() const;
+
+	// True once the request has finished, failed or been cancelled.
+	bool isComplete() const;
+	bool isCancelled() const;
+
+	// Blocks until the request is complete.
+	void wait();
+
+	/**
+	 * Cancels the request if the I/O thread hasn't started it yet. Returns
+	 * whether it was cancelled.
+	 **/
+	bool cancel();
+
+	/**
+	 * Returns the data read by a read request, or null until it's complete
+	 * and for other operations. Throws if the request failed or was
+	 * cancelled.
+	 **/
+	FileData *getData() const;
+
+	static bool getConstant(const char *in, Operation &out);
+	static bool getConstant(Operation in, const char *&out);
+	static std::vector<std::string> getConstants(Operation);
+
+private:
+
+	friend class FileIOThread;
+
+	enum State
+	{
+		STATE_PENDING,
+		STATE_RUNNING,
+		STATE_DONE,
+		STATE_CANCELLED,
+	};
+
+	// Called by the I/O thread. Returns false if the request was cancelled.
+	bool begin();
+	void run(Filesystem *filesystem);
+
+	Operation operation;
+	std::string filename;
+	StrongRef<love::Data> input;
+	int priority;
+
+	// Orders requests with the same priority.
+	uint64 sequence;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef cond;
+
+	State state;
+	StrongRef<FileData> result;
+	std::string error;
+
+	static StringMap<Operation, OPERATION_MAX_ENUM>::Entry operationEntries[];
+	static StringMap<Operation, OPERATION_MAX_ENUM> operations;
+
+}; // FileRequest
+
+/**
+ * Runs FileRequests one at a time, highest priority first, so blocking file
+ * access stays off the threads which submit them.
+ **/
+class FileIOThread : public love::thread::Threadable
+{
+public:
+
+	FileIOThread(Filesystem *filesystem);
+	virtual ~FileIOThread();
+
+	void submit(FileRequest *request);
+
+	// Cancels pending requests and waits for the running one to finish.
+	void stop();
+
+	// Implements Threadable.
+	void threadFunction() override;
+
+private:
+
+	Filesystem *filesystem;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef cond;
+
+	std::vector<StrongRef<FileRequest>> pending;
+	uint64 nextSequence;
+	bool stopping;
+
+}; // FileIOThread
+
+} // filesystem
+} // love
+
+#endif // LOVE_FILESYSTEM_FILE_REQUEST_H
@@ -37,6 +37,16 @@
 #include <unistd.h>
 #endif
 
+#ifndef LOVE_WINDOWS
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdio.h>
+#endif
+
+// C++
+#include <algorithm>
+
 namespace love
 {
 namespace filesystem
@@ -45,11 +55,142 @@ namespace filesystem
 love::Type Filesystem::type("filesystem", &Module::type);
 
 Filesystem::Filesystem()
+	: ioThread(nullptr)
 {
 }
 
 Filesystem::~Filesystem()
 {
+	stopFileIO();
+}
+
+FileRequest *Filesystem::newFileRequest(FileRequest::Operation operation, const char *filename, love::Data *data, int priority)
+{
+	if (operation != FileRequest::OPERATION_READ && data == nullptr)
+		throw love::Exception("Data must be given for a write, append or save request.");
+
+	StrongRef<FileRequest> request(new FileRequest(operation, filename, data, priority), Acquire::NORETAIN);
+
+	{
+		thread::Lock lock(ioMutex);
+
+		if (ioThread == nullptr)
+		{
+			ioThread = new FileIOThread(this);
+			if (!ioThread->start())
+			{
+				ioThread->release();
+				ioThread = nullptr;
+				throw love::Exception("Could not start the file I/O thread.");
+			}
+		}
+
+		ioThread->submit(request);
+	}
+
+	request->retain();
+	return request;
+}
+
+void Filesystem::stopFileIO()
+{
+	FileIOThread *iothread = nullptr;
+
+	{
+		thread::Lock lock(ioMutex);
+		iothread = ioThread;
+		ioThread = nullptr;
+	}
+
+	if (iothread != nullptr)
+	{
+		iothread->stop();
+		iothread->release();
+	}
+}
+
+void Filesystem::replaceFile(const std::string &path, const void *data, int64 size)
+{
+	if (size < 0)
+		throw love::Exception("Invalid write size.");
+
+	std::string temppath = path + ".tmp";
+
+	const char *src = (const char *) data;
+	int64 remaining = size;
+	bool success = true;
+
+#ifdef LOVE_WINDOWS
+	std::wstring wpath = to_widestr(path);
+	std::wstring wtemppath = to_widestr(temppath);
+
+	HANDLE file = CreateFileW(wtemppath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		throw love::Exception("Could not open file %s.", temppath.c_str());
+
+	while (success && remaining > 0)
+	{
+		DWORD written = 0;
+		DWORD count = (DWORD) std::min(remaining, (int64) 0x40000000);
+		success = WriteFile(file, src, count, &written, nullptr) && written > 0;
+		src += written;
+		remaining -= written;
+	}
+
+	success = success && FlushFileBuffers(file);
+	success = CloseHandle(file) && success;
+
+	// MoveFileEx replaces the file in one step when both are on one volume.
+	if (!success || !MoveFileExW(wtemppath.c_str(), wpath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+	{
+		DeleteFileW(wtemppath.c_str());
+		throw love::Exception("Data could not be written.");
+	}
+#else
+	int fd = open(temppath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		throw love::Exception("Could not open file %s.", temppath.c_str());
+
+	while (success && remaining > 0)
+	{
+		ssize_t written = ::write(fd, src, (size_t) std::min(remaining, (int64) 0x40000000));
+		if (written < 0 && errno == EINTR)
+			continue;
+
+		success = written > 0;
+		if (success)
+		{
+			src += written;
+			remaining -= written;
+		}
+	}
+
+#if defined(LOVE_MACOSX) || defined(LOVE_IOS)
+	// fsync only reaches the drive's cache on Apple platforms.
+	success = success && (fcntl(fd, F_FULLFSYNC) == 0 || fsync(fd) == 0);
+#else
+	success = success && fsync(fd) == 0;
+#endif
+
+	success = close(fd) == 0 && success;
+
+	if (!success || rename(temppath.c_str(), path.c_str()) != 0)
+	{
+		unlink(temppath.c_str());
+		throw love::Exception("Data could not be written.");
+	}
+
+	// The rename itself is only durable once the directory is flushed.
+	size_t slash = path.rfind('/');
+	std::string dir = slash == std::string::npos ? "." : path.substr(0, std::max(slash, (size_t) 1));
+
+	int dirfd = open(dir.c_str(), O_RDONLY);
+	if (dirfd >= 0)
+	{
+		fsync(dirfd);
+		close(dirfd);
+	}
+#endif
 }
 
 void Filesystem::setAndroidSaveExternal(bool useExternal)
@@ -120,6 +261,92 @@ std::string Filesystem::getExecutablePath() const
 #endif
 }
 
+static bool matchGlobComponents(const char *p, const char *s)
+{
+	while (*p != '\0')
+	{
+		if (*p == '*')
+		{
+			bool anydepth = p[1] == '*';
+			p += anydepth ? 2 : 1;
+
+			// "**/" also matches no directories at all.
+			if (anydepth && *p == '/' && matchGlobComponents(p + 1, s))
+				return true;
+
+			// Try every length of match for the wildcard.
+			while (true)
+			{
+				if (matchGlobComponents(p, s))
+					return true;
+				if (*s == '\0' || (!anydepth && *s == '/'))
+					return false;
+				s++;
+			}
+		}
+
+		if (*s == '\0')
+			return false;
+
+		if (*p == '?')
+		{
+			if (*s == '/')
+				return false;
+		}
+		else if (*p == '[')
+		{
+			const char *c = p + 1;
+			bool negate = *c == '!' || *c == '^';
+			if (negate)
+				c++;
+
+			// A ']' right after the '[' is part of the set.
+			bool matched = false;
+			do
+			{
+				if (c[1] == '-' && c[2] != ']' && c[2] != '\0')
+				{
+					matched = matched || (*s >= c[0] && *s <= c[2]);
+					c += 3;
+				}
+				else
+				{
+					matched = matched || *c == *s;
+					c++;
+				}
+			} while (*c != ']' && *c != '\0');
+
+			if (*c == ']')
+			{
+				if (matched == negate || *s == '/')
+					return false;
+				p = c;
+			}
+			else if (*s != '[') // Unclosed, so it's a literal '['.
+				return false;
+		}
+		else if (*p != *s)
+			return false;
+
+		p++;
+		s++;
+	}
+
+	return *s == '\0';
+}
+
+bool Filesystem::matchGlob(const std::string &pattern, const std::string &path)
+{
+	if (pattern.find('/') == std::string::npos)
+	{
+		size_t slash = path.rfind('/');
+		if (slash != std::string::npos)
+			return matchGlobComponents(pattern.c_str(), path.c_str() + slash + 1);
+	}
+
+	return matchGlobComponents(pattern.c_str(), path.c_str());
+}
+
 bool Filesystem::getConstant(const char *in, FileType &out)
 {
 	return fileTypes.find(in, out);
@@ -28,6 +28,7 @@
 #include "common/StringMap.h"
 #include "FileData.h"
 #include "File.h"
+#include "FileRequest.h"
 
 // C++
 #include <string>
@@ -79,6 +80,12 @@ public:
 		FileType type;
 	};
 
+	struct DirectoryEntry
+	{
+		std::string path;
+		Info info;
+	};
+
 	static love::Type type;
 
 	Filesystem();
@@ -211,6 +218,22 @@ public:
 	 **/
 	virtual FileData *read(const char *filename, int64 size = File::ALL) const = 0;
 
+	/**
+	 * Reads a whole file. Files in a directory on disk are memory-mapped
+	 * instead of copied, as are files stored uncompressed in a game archive
+	 * mapped out of the APK on Android. Other files are read normally.
+	 * @param filename The name of the file to read from.
+	 **/
+	virtual FileData *mapFile(const char *filename) const = 0;
+
+	/**
+	 * Enables caching of getInfo and getDirectoryItems results. Each directory
+	 * is listed once and its entries are answered from memory afterwards,
+	 * until the search path or the save directory changes.
+	 **/
+	virtual void setPathCacheEnabled(bool enable) = 0;
+	virtual bool isPathCacheEnabled() const = 0;
+
 	/**
 	 * Write data to a file.
 	 * @param filename The name of the file to write to.
@@ -227,12 +250,44 @@ public:
 	 **/
 	virtual void append(const char *filename, const void *data, int64 size) const = 0;
 
+	/**
+	 * Writes data to a temporary file in the save directory, flushes it to
+	 * disk and then renames it over the file, so the file either has its old
+	 * or its new contents even if the program or system crashes.
+	 * @param filename The name of the file to replace.
+	 * @param data The data to write.
+	 * @param size The size in bytes of the data to write.
+	 **/
+	virtual void writeAtomic(const char *filename, const void *data, int64 size) const = 0;
+
 	/**
 	 * This "native" method returns a table of all
 	 * files in a given directory.
 	 **/
 	virtual void getDirectoryItems(const char *dir, std::vector<std::string> &items) = 0;
 
+	/**
+	 * Recursively lists everything under a directory across all mounts, along
+	 * with each entry's metadata, in depth-first order. Symlinked directories
+	 * aren't descended into.
+	 * @param dir The directory to scan. Returned paths start with it.
+	 * @param pattern A glob (see matchGlob) which paths relative to dir must
+	 *        match to be returned, or empty to return everything. Directories
+	 *        are scanned regardless.
+	 * @param filter Only return entries of this type, or FILETYPE_MAX_ENUM.
+	 * @param maxDepth How many levels of subdirectories to scan. Negative for
+	 *        no limit.
+	 **/
+	virtual void scanDirectory(const char *dir, const std::string &pattern, FileType filter, int maxDepth, std::vector<DirectoryEntry> &entries) = 0;
+
+	/**
+	 * Matches a '/' separated path against a glob. '*' and '?' match within a
+	 * path component, '**' matches across components, and [a-z] or [!a-z]
+	 * match character sets. Patterns without a '/' are matched against the
+	 * last component only.
+	 **/
+	static bool matchGlob(const std::string &pattern, const std::string &path);
+
 	/**
 	 * Enable or disable symbolic link support in love.filesystem.
 	 **/
@@ -263,12 +318,37 @@ public:
 	 **/
 	virtual std::string getExecutablePath() const;
 
+	/**
+	 * Queues a read, write, append or save to run on the file I/O thread,
+	 * which is started the first time it's needed.
+	 * @param data The data to write. Unused for reads.
+	 * @param priority Pending requests with a higher priority run first.
+	 **/
+	FileRequest *newFileRequest(FileRequest::Operation operation, const char *filename, love::Data *data, int priority);
+
 	static bool getConstant(const char *in, FileType &out);
 	static bool getConstant(FileType in, const char *&out);
 	static std::vector<std::string> getConstants(FileType);
 
+protected:
+
+	/**
+	 * Cancels pending file requests and waits for the running one. Subclasses
+	 * must call this before shutting down whatever read and write use.
+	 **/
+	void stopFileIO();
+
+	/**
+	 * Replaces the file at the full (OS-dependent) path with the data, via a
+	 * temporary file next to it which is flushed to disk before the rename.
+	 **/
+	static void replaceFile(const std::string &path, const void *data, int64 size);
+
 private:
 
+	love::thread::MutexRef ioMutex;
+	FileIOThread *ioThread;
+
 	// Should we save external or internal for Android
 	bool useExternal;
 
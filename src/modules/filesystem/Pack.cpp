@@ -0,0 +1,415 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Pack.h"
+#include "common/Exception.h"
+
+#include "libraries/lz4/lz4.h"
+#include "libraries/lz4/lz4hc.h"
+#include "libraries/xxHash/xxhash.h"
+
+#ifdef LOVE_SUPPORT_ZSTD
+#include <zstd.h>
+#endif
+
+// C++
+#include <algorithm>
+#include <limits>
+#include <cstring>
+
+namespace love
+{
+namespace filesystem
+{
+namespace pack
+{
+
+static void storeU32(uint8 *dst, uint32 v)
+{
+	for (int i = 0; i < 4; i++)
+		dst[i] = (uint8) (v >> (i * 8));
+}
+
+static void storeU64(uint8 *dst, uint64 v)
+{
+	for (int i = 0; i < 8; i++)
+		dst[i] = (uint8) (v >> (i * 8));
+}
+
+static uint32 loadU32(const uint8 *src)
+{
+	uint32 v = 0;
+	for (int i = 0; i < 4; i++)
+		v |= (uint32) src[i] << (i * 8);
+	return v;
+}
+
+static uint64 loadU64(const uint8 *src)
+{
+	uint64 v = 0;
+	for (int i = 0; i < 8; i++)
+		v |= (uint64) src[i] << (i * 8);
+	return v;
+}
+
+uint64 hashPath(const char *path, size_t length)
+{
+	return (uint64) XXH64(path, length, 0);
+}
+
+void encodeHeader(const Header &header, uint8 *dst)
+{
+	memset(dst, 0, HEADER_SIZE);
+	storeU32(dst + 0, MAGIC);
+	storeU32(dst + 4, header.version);
+	storeU32(dst + 8, header.entryCount);
+	storeU32(dst + 12, header.blockSize);
+	storeU64(dst + 16, header.indexOffset);
+	storeU64(dst + 24, header.namesOffset);
+	storeU64(dst + 32, header.namesSize);
+}
+
+bool decodeHeader(const uint8 *src, Header &header)
+{
+	if (loadU32(src) != MAGIC)
+		return false;
+
+	header.version = loadU32(src + 4);
+	header.entryCount = loadU32(src + 8);
+	header.blockSize = loadU32(src + 12);
+	header.indexOffset = loadU64(src + 16);
+	header.namesOffset = loadU64(src + 24);
+	header.namesSize = loadU64(src + 32);
+	return true;
+}
+
+void encodeEntry(const Entry &entry, uint8 *dst)
+{
+	storeU64(dst + 0, entry.hash);
+	storeU64(dst + 8, entry.offset);
+	storeU64(dst + 16, entry.size);
+	storeU64(dst + 24, entry.storedSize);
+	storeU32(dst + 32, entry.nameOffset);
+	storeU32(dst + 36, entry.nameLength);
+	storeU32(dst + 40, entry.compression);
+	storeU32(dst + 44, entry.blockCount);
+}
+
+void decodeEntry(const uint8 *src, Entry &entry)
+{
+	entry.hash = loadU64(src + 0);
+	entry.offset = loadU64(src + 8);
+	entry.size = loadU64(src + 16);
+	entry.storedSize = loadU64(src + 24);
+	entry.nameOffset = loadU32(src + 32);
+	entry.nameLength = loadU32(src + 36);
+	entry.compression = loadU32(src + 40);
+	entry.blockCount = loadU32(src + 44);
+}
+
+bool isSupported(Compression compression)
+{
+	switch (compression)
+	{
+	case COMPRESSION_NONE:
+	case COMPRESSION_LZ4:
+		return true;
+	case COMPRESSION_ZSTD:
+#ifdef LOVE_SUPPORT_ZSTD
+		return true;
+#else
+		return false;
+#endif
+	default:
+		return false;
+	}
+}
+
+bool decompressBlock(Compression compression, const void *src, size_t srcsize, void *dst, size_t dstsize)
+{
+	if (srcsize == dstsize)
+	{
+		memcpy(dst, src, dstsize);
+		return true;
+	}
+
+	if (compression == COMPRESSION_LZ4)
+	{
+		int result = LZ4_decompress_safe((const char *) src, (char *) dst, (int) srcsize, (int) dstsize);
+		return result == (int) dstsize;
+	}
+#ifdef LOVE_SUPPORT_ZSTD
+	else if (compression == COMPRESSION_ZSTD)
+	{
+		size_t result = ZSTD_decompress(dst, dstsize, src, srcsize);
+		return !ZSTD_isError(result) && result == dstsize;
+	}
+#endif
+
+	return false;
+}
+
+// Returns the compressed size, or srcsize if the block should be stored as-is.
+static size_t compressBlock(Compression compression, const char *src, size_t srcsize, std::vector<char> &dst)
+{
+	size_t csize = 0;
+
+	if (compression == COMPRESSION_LZ4)
+	{
+		int bound = LZ4_compressBound((int) srcsize);
+		dst.resize(bound);
+		csize = (size_t) std::max(LZ4_compress_HC(src, dst.data(), (int) srcsize, bound, LZ4HC_CLEVEL_DEFAULT), 0);
+	}
+#ifdef LOVE_SUPPORT_ZSTD
+	else if (compression == COMPRESSION_ZSTD)
+	{
+		size_t bound = ZSTD_compressBound(srcsize);
+		dst.resize(bound);
+		csize = ZSTD_compress(dst.data(), bound, src, srcsize, ZSTD_CLEVEL_DEFAULT);
+		if (ZSTD_isError(csize))
+			csize = 0;
+	}
+#endif
+
+	if (csize == 0 || csize >= srcsize)
+	{
+		dst.assign(src, src + srcsize);
+		return srcsize;
+	}
+
+	dst.resize(csize);
+	return csize;
+}
+
+static std::string normalizePath(const std::string &path)
+{
+	std::string result;
+	size_t start = 0;
+
+	while (start <= path.size())
+	{
+		size_t end = path.find('/', start);
+		if (end == std::string::npos)
+			end = path.size();
+
+		std::string segment = path.substr(start, end - start);
+
+		if (segment == "." || segment == ".." || segment.find('\\') != std::string::npos)
+			throw love::Exception("Invalid path in pack: %s", path.c_str());
+
+		if (!segment.empty())
+		{
+			if (!result.empty())
+				result += '/';
+			result += segment;
+		}
+
+		start = end + 1;
+	}
+
+	if (result.empty())
+		throw love::Exception("Invalid path in pack: %s", path.c_str());
+
+	return result;
+}
+
+static void writeBytes(File *file, const void *data, uint64 size)
+{
+	if (size > 0 && !file->write(data, (int64) size))
+		throw love::Exception("Could not write pack file.");
+}
+
+static uint64 padTo(File *file, uint64 pos, uint64 alignment)
+{
+	static const uint8 zeros[4096] = {};
+
+	uint64 padded = (pos + alignment - 1) / alignment * alignment;
+	while (pos < padded)
+	{
+		uint64 count = std::min(padded - pos, (uint64) sizeof(zeros));
+		writeBytes(file, zeros, count);
+		pos += count;
+	}
+
+	return padded;
+}
+
+void write(File *file, const std::vector<Input> &inputs, Compression compression, uint32 blockSize)
+{
+	if (!isSupported(compression))
+		throw love::Exception("The compression format isn't supported by this build.");
+
+	if (blockSize == 0 || blockSize > (uint32) std::numeric_limits<int>::max())
+		throw love::Exception("Invalid pack block size.");
+
+	// Entry data is laid out in path order, so files in the same directory
+	// stay close together.
+	std::vector<std::pair<std::string, love::Data *>> files;
+	for (const Input &input : inputs)
+		files.emplace_back(normalizePath(input.path), input.data.get());
+
+	std::sort(files.begin(), files.end(), [](const std::pair<std::string, love::Data *> &a, const std::pair<std::string, love::Data *> &b)
+	{
+		return a.first < b.first;
+	});
+
+	for (size_t i = 1; i < files.size(); i++)
+	{
+		if (files[i].first == files[i - 1].first)
+			throw love::Exception("Duplicate path in pack: %s", files[i].first.c_str());
+	}
+
+	if (files.size() > std::numeric_limits<uint32>::max())
+		throw love::Exception("Too many files for a pack.");
+
+	std::vector<Entry> entries;
+	std::string names;
+
+	uint8 headerbytes[HEADER_SIZE] = {};
+	writeBytes(file, headerbytes, HEADER_SIZE);
+	uint64 pos = padTo(file, HEADER_SIZE, ALIGNMENT);
+
+	std::vector<char> block;
+
+	for (const auto &f : files)
+	{
+		const std::string &path = f.first;
+		const char *src = (const char *) f.second->getData();
+		uint64 size = f.second->getSize();
+
+		if (names.size() + path.size() > std::numeric_limits<uint32>::max())
+			throw love::Exception("Too many files for a pack.");
+
+		Entry entry = {};
+		entry.hash = hashPath(path.c_str(), path.size());
+		entry.offset = pos;
+		entry.size = size;
+		entry.nameOffset = (uint32) names.size();
+		entry.nameLength = (uint32) path.size();
+		entry.compression = COMPRESSION_NONE;
+
+		names += path;
+
+		std::vector<std::vector<char>> blocks;
+		uint64 storedblocks = 0;
+
+		if (compression != COMPRESSION_NONE && size > 0)
+		{
+			uint64 count = (size + blockSize - 1) / blockSize;
+			for (uint64 i = 0; i < count; i++)
+			{
+				size_t rawsize = (size_t) std::min((uint64) blockSize, size - i * blockSize);
+				storedblocks += compressBlock(compression, src + i * blockSize, rawsize, block);
+				blocks.push_back(block);
+			}
+		}
+
+		uint64 tablesize = (blocks.size() + 1) * sizeof(uint64);
+
+		// Entries which don't get smaller are stored as-is, and can be read
+		// without going through blocks at all.
+		if (!blocks.empty() && storedblocks + tablesize < size)
+		{
+			entry.compression = compression;
+			entry.blockCount = (uint32) blocks.size();
+
+			std::vector<uint8> table(tablesize);
+			uint64 offset = tablesize;
+			for (size_t i = 0; i < blocks.size(); i++)
+			{
+				storeU64(&table[i * sizeof(uint64)], offset);
+				offset += blocks[i].size();
+			}
+			storeU64(&table[blocks.size() * sizeof(uint64)], offset);
+
+			writeBytes(file, table.data(), tablesize);
+			for (const auto &b : blocks)
+				writeBytes(file, b.data(), b.size());
+
+			entry.storedSize = offset;
+		}
+		else
+		{
+			writeBytes(file, src, size);
+			entry.storedSize = size;
+		}
+
+		pos = padTo(file, pos + entry.storedSize, ALIGNMENT);
+		entries.push_back(entry);
+	}
+
+	std::sort(entries.begin(), entries.end(), [&](const Entry &a, const Entry &b)
+	{
+		if (a.hash != b.hash)
+			return a.hash < b.hash;
+		return names.compare(a.nameOffset, a.nameLength, names, b.nameOffset, b.nameLength) < 0;
+	});
+
+	Header header = {};
+	header.version = VERSION;
+	header.entryCount = (uint32) entries.size();
+	header.blockSize = blockSize;
+	header.indexOffset = pos;
+	header.namesOffset = pos + entries.size() * ENTRY_SIZE;
+	header.namesSize = names.size();
+
+	std::vector<uint8> index(entries.size() * ENTRY_SIZE);
+	for (size_t i = 0; i < entries.size(); i++)
+		encodeEntry(entries[i], &index[i * ENTRY_SIZE]);
+
+	writeBytes(file, index.data(), index.size());
+	writeBytes(file, names.data(), names.size());
+
+	encodeHeader(header, headerbytes);
+
+	if (!file->seek(0))
+		throw love::Exception("Could not write pack file.");
+
+	writeBytes(file, headerbytes, HEADER_SIZE);
+}
+
+static StringMap<Compression, COMPRESSION_MAX_ENUM>::Entry compressionEntries[] =
+{
+	{ "none", COMPRESSION_NONE },
+	{ "lz4",  COMPRESSION_LZ4  },
+	{ "zstd", COMPRESSION_ZSTD },
+};
+
+static StringMap<Compression, COMPRESSION_MAX_ENUM> compressions(compressionEntries, sizeof(compressionEntries));
+
+bool getConstant(const char *in, Compression &out)
+{
+	return compressions.find(in, out);
+}
+
+bool getConstant(Compression in, const char *&out)
+{
+	return compressions.find(in, out);
+}
+
+std::vector<std::string> getConstants(Compression)
+{
+	return compressions.getNames();
+}
+
+} // pack
+} // filesystem
+} // love
@@ -0,0 +1,132 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_FILESYSTEM_PACK_H
+#define LOVE_FILESYSTEM_PACK_H
+
+// LOVE
+#include "common/Data.h"
+#include "common/int.h"
+#include "common/StringMap.h"
+#include "File.h"
+
+// C++
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace filesystem
+{
+
+/**
+ * Indexed asset packs, mounted like zip archives but without a central
+ * directory to parse or whole entries to inflate for random access.
+ *
+ * Packs are little-endian:
+ *   Header (HEADER_SIZE bytes)
+ *   Entry data, each entry starting on an ALIGNMENT boundary
+ *   Index: ENTRY_SIZE records sorted by path hash, then by path
+ *   Names: the paths of all entries, not null-terminated
+ *
+ * A compressed entry starts with blockCount + 1 uint64 offsets, relative to
+ * the entry, which bound each block. Every block decompresses to the pack's
+ * block size except the last. A block whose stored size equals its
+ * decompressed size is stored as-is.
+ **/
+namespace pack
+{
+
+enum Compression
+{
+	COMPRESSION_NONE,
+	COMPRESSION_LZ4,
+	COMPRESSION_ZSTD,
+	COMPRESSION_MAX_ENUM
+};
+
+static const uint32 MAGIC = 0x4B41504C; // "LPAK"
+static const uint32 VERSION = 1;
+static const uint64 ALIGNMENT = 4096;
+static const size_t HEADER_SIZE = 64;
+static const size_t ENTRY_SIZE = 48;
+static const uint32 DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+struct Header
+{
+	uint32 version;
+	uint32 entryCount;
+	uint32 blockSize;
+	uint64 indexOffset;
+	uint64 namesOffset;
+	uint64 namesSize;
+};
+
+struct Entry
+{
+	uint64 hash;
+	uint64 offset;
+	uint64 size;
+	uint64 storedSize;
+	uint32 nameOffset;
+	uint32 nameLength;
+	uint32 compression;
+	uint32 blockCount;
+};
+
+struct Input
+{
+	std::string path;
+	StrongRef<love::Data> data;
+};
+
+uint64 hashPath(const char *path, size_t length);
+
+void encodeHeader(const Header &header, uint8 *dst);
+
+// Returns false if the data doesn't start with the pack magic number.
+bool decodeHeader(const uint8 *src, Header &header);
+
+void encodeEntry(const Entry &entry, uint8 *dst);
+void decodeEntry(const uint8 *src, Entry &entry);
+
+/**
+ * Decompresses a block into exactly dstsize bytes. Returns false if the data
+ * is invalid or the compression isn't supported.
+ **/
+bool decompressBlock(Compression compression, const void *src, size_t srcsize, void *dst, size_t dstsize);
+
+/**
+ * Writes a pack of the inputs to a File open for writing. Paths use '/' as
+ * the separator and must be unique.
+ **/
+void write(File *file, const std::vector<Input> &inputs, Compression compression, uint32 blockSize = DEFAULT_BLOCK_SIZE);
+
+bool isSupported(Compression compression);
+
+bool getConstant(const char *in, Compression &out);
+bool getConstant(Compression in, const char *&out);
+std::vector<std::string> getConstants(Compression);
+
+} // pack
+} // filesystem
+} // love
+
+#endif // LOVE_FILESYSTEM_PACK_H
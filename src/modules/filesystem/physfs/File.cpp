@@ -22,6 +22,7 @@
 
 // STD
 #include <cstring>
+#include <algorithm>
 
 // LOVE
 #include "Filesystem.h"
@@ -37,12 +38,209 @@ extern bool hack_setupWriteDirectory();
 namespace physfs
 {
 
+static void invalidatePathCache()
+{
+	auto fs = Module::getInstance<Filesystem>(Module::M_FILESYSTEM);
+	if (fs != nullptr)
+		fs->invalidatePathCache();
+}
+
+const int64 Readahead::DEFAULT_WINDOW_SIZE;
+const int64 Readahead::MAX_WINDOW_SIZE;
+
+Readahead::Readahead(PHYSFS_File *handle, uint64 pos, int64 windowsize)
+	: handle(handle)
+	, length((uint64) std::max(PHYSFS_fileLength(handle), (PHYSFS_sint64) 0))
+	, pos(pos)
+	, lastReadEnd(pos)
+	, minWindowSize(std::min(std::max(windowsize, (int64) 4096), MAX_WINDOW_SIZE))
+	, windowSize(minWindowSize)
+	, requested(nullptr)
+	, stopping(false)
+{
+	threadName = "Readahead";
+
+	for (Window &w : windows)
+	{
+		w.offset = 0;
+		w.size = 0;
+		w.pending = false;
+	}
+}
+
+Readahead::~Readahead()
+{
+	stop();
+	PHYSFS_close(handle);
+}
+
+void Readahead::stop()
+{
+	{
+		thread::Lock lock(mutex);
+		stopping = true;
+		cond->broadcast();
+	}
+
+	wait();
+}
+
+void Readahead::prefetch(uint64 offset)
+{
+	if (offset >= length)
+		return;
+
+	thread::Lock lock(mutex);
+
+	// Only one window is read at a time, since the thread has one handle.
+	if (stopping || windows[0].pending || windows[1].pending)
+		return;
+
+	Window *w = nullptr;
+	for (Window &win : windows)
+	{
+		if (offset >= win.offset && offset < win.offset + win.size)
+			return;
+		if (pos < win.offset || pos >= win.offset + win.size)
+			w = &win;
+	}
+
+	if (w == nullptr)
+		return;
+
+	w->offset = offset;
+	w->size = (int64) std::min((uint64) windowSize, length - offset);
+	w->pending = true;
+
+	requested = w;
+	cond->broadcast();
+}
+
+int64 Readahead::read(PHYSFS_File *file, void *dst, int64 size)
+{
+	bool sequential = pos == lastReadEnd;
+	if (!sequential)
+		windowSize = minWindowSize;
+
+	uint8 *out = (uint8 *) dst;
+	int64 total = 0;
+
+	while (size > 0 && pos < length)
+	{
+		Window *w = nullptr;
+
+		{
+			thread::Lock lock(mutex);
+
+			for (Window &win : windows)
+			{
+				if (pos < win.offset || pos >= win.offset + win.size)
+					continue;
+
+				// The reader caught up with the thread, so read further ahead.
+				if (win.pending)
+					windowSize = std::min(windowSize * 2, MAX_WINDOW_SIZE);
+
+				while (win.pending && !stopping)
+					cond->wait(mutex);
+
+				if (!win.pending)
+					w = &win;
+				break;
+			}
+		}
+
+		if (w == nullptr || pos - w->offset >= w->data.size())
+		{
+			int64 count = -1;
+			if (PHYSFS_seek(file, pos))
+				count = PHYSFS_readBytes(file, out, (PHYSFS_uint64) size);
+
+			if (count > 0)
+			{
+				pos += count;
+				total += count;
+			}
+			else if (total == 0)
+				total = count;
+
+			if (sequential)
+				prefetch(pos);
+
+			break;
+		}
+
+		int64 count = std::min(size, (int64) (w->offset + w->data.size() - pos));
+		memcpy(out, w->data.data() + (pos - w->offset), (size_t) count);
+
+		out += count;
+		size -= count;
+		pos += count;
+		total += count;
+
+		// Start on the next window while this one is consumed.
+		prefetch(w->offset + w->size);
+	}
+
+	lastReadEnd = pos;
+	return total;
+}
+
+void Readahead::seek(uint64 pos)
+{
+	this->pos = pos;
+}
+
+uint64 Readahead::tell() const
+{
+	return pos;
+}
+
+uint64 Readahead::getLength() const
+{
+	return length;
+}
+
+void Readahead::threadFunction()
+{
+	while (true)
+	{
+		Window *w = nullptr;
+
+		{
+			thread::Lock lock(mutex);
+
+			while (!stopping && requested == nullptr)
+				cond->wait(mutex);
+
+			if (stopping)
+				return;
+
+			w = requested;
+			requested = nullptr;
+		}
+
+		w->data.resize((size_t) w->size);
+
+		int64 count = -1;
+		if (PHYSFS_seek(handle, w->offset))
+			count = PHYSFS_readBytes(handle, w->data.data(), (PHYSFS_uint64) w->size);
+
+		w->data.resize((size_t) std::max(count, (int64) 0));
+
+		thread::Lock lock(mutex);
+		w->pending = false;
+		cond->broadcast();
+	}
+}
+
 File::File(const std::string &filename)
 	: filename(filename)
 	, file(nullptr)
 	, mode(MODE_CLOSED)
 	, bufferMode(BUFFER_NONE)
 	, bufferSize(0)
+	, readahead(nullptr)
 {
 }
 
@@ -102,6 +300,10 @@ bool File::open(Mode mode)
 
 	this->mode = mode;
 
+	// Opening for writing can create or truncate the file.
+	if (mode == MODE_APPEND || mode == MODE_WRITE)
+		invalidatePathCache();
+
 	if (file != nullptr && !setBuffer(bufferMode, bufferSize))
 	{
 		// Revert to buffer defaults if we don't successfully set the buffer.
@@ -114,12 +316,24 @@ bool File::open(Mode mode)
 
 bool File::close()
 {
+	if (readahead != nullptr)
+	{
+		readahead->release();
+		readahead = nullptr;
+	}
+
 	if (file == nullptr || !PHYSFS_close(file))
 		return false;
 
+	bool written = mode == MODE_APPEND || mode == MODE_WRITE;
+
 	mode = MODE_CLOSED;
 	file = nullptr;
 
+	// Cached sizes are only refreshed once the file is closed.
+	if (written)
+		invalidatePathCache();
+
 	return true;
 }
 
@@ -155,6 +369,9 @@ int64 File::read(void *dst, int64 size)
 	if (size < 0)
 		throw love::Exception("Invalid read size.");
 
+	if (readahead != nullptr)
+		return readahead->read(file, dst, size);
+
 	return PHYSFS_readBytes(file, dst, (PHYSFS_uint64) size);
 }
 
@@ -210,6 +427,9 @@ inline bool test_eof(File *, PHYSFS_File *file)
 
 bool File::isEOF()
 {
+	if (readahead != nullptr)
+		return readahead->tell() >= readahead->getLength();
+
 	return file == nullptr || test_eof(this, file);
 }
 
@@ -218,11 +438,23 @@ int64 File::tell()
 	if (file == nullptr)
 		return -1;
 
+	if (readahead != nullptr)
+		return (int64) readahead->tell();
+
 	return (int64) PHYSFS_tell(file);
 }
 
 bool File::seek(uint64 pos)
 {
+	if (readahead != nullptr)
+	{
+		if (pos > readahead->getLength())
+			return false;
+
+		readahead->seek(pos);
+		return true;
+	}
+
 	return file != nullptr && PHYSFS_seek(file, (PHYSFS_uint64) pos) != 0;
 }
 
@@ -240,6 +472,17 @@ bool File::setBuffer(BufferMode bufmode, int64 size)
 		return true;
 	}
 
+	if (bufmode == BUFFER_READAHEAD && mode != MODE_READ)
+		return false;
+
+	// The handle's position lags behind while reading ahead.
+	if (readahead != nullptr)
+	{
+		PHYSFS_seek(file, readahead->tell());
+		readahead->release();
+		readahead = nullptr;
+	}
+
 	int ret = 1;
 
 	switch (bufmode)
@@ -253,11 +496,31 @@ bool File::setBuffer(BufferMode bufmode, int64 size)
 	case BUFFER_FULL:
 		ret = PHYSFS_setBuffer(file, size);
 		break;
+	case BUFFER_READAHEAD:
+		ret = PHYSFS_setBuffer(file, 0);
+		break;
 	}
 
 	if (ret == 0)
 		return false;
 
+	if (bufmode == BUFFER_READAHEAD)
+	{
+		PHYSFS_File *handle = PHYSFS_openRead(filename.c_str());
+		if (handle == nullptr)
+			return false;
+
+		int64 windowsize = size > 0 ? size : Readahead::DEFAULT_WINDOW_SIZE;
+		readahead = new Readahead(handle, (uint64) PHYSFS_tell(file), windowsize);
+
+		if (!readahead->start())
+		{
+			readahead->release();
+			readahead = nullptr;
+			return false;
+		}
+	}
+
 	bufferMode = bufmode;
 	bufferSize = size;
 
@@ -24,12 +24,14 @@
 // LOVE
 #include "common/config.h"
 #include "filesystem/File.h"
+#include "thread/threads.h"
 
 // PhysFS
 #include "libraries/physfs/physfs.h"
 
 // STD
 #include <string>
+#include <vector>
 
 namespace love
 {
@@ -38,6 +40,73 @@ namespace filesystem
 namespace physfs
 {
 
+/**
+ * Serves sequential reads from two windows of a file, one of which is read
+ * ahead on a background thread (with its own PhysFS handle) while the other
+ * is consumed. The window size grows while the reader keeps catching up with
+ * the thread, and resets when it seeks.
+ **/
+class Readahead : public love::thread::Threadable
+{
+public:
+
+	static const int64 DEFAULT_WINDOW_SIZE = 64 * 1024;
+	static const int64 MAX_WINDOW_SIZE = 4 * 1024 * 1024;
+
+	/**
+	 * @param handle A PhysFS handle to the file, used only by the thread.
+	 * Readahead takes ownership of it.
+	 * @param pos The initial read position.
+	 **/
+	Readahead(PHYSFS_File *handle, uint64 pos, int64 windowsize);
+	virtual ~Readahead();
+
+	// Reads at the current position, falling back to the given handle when
+	// the data isn't in a window.
+	int64 read(PHYSFS_File *file, void *dst, int64 size);
+
+	void seek(uint64 pos);
+	uint64 tell() const;
+	uint64 getLength() const;
+
+	void stop();
+
+	// Implements Threadable.
+	void threadFunction() override;
+
+private:
+
+	struct Window
+	{
+		uint64 offset;
+		int64 size;
+		std::vector<uint8> data;
+		bool pending;
+	};
+
+	// Starts reading the window which doesn't hold the read position, if the
+	// thread is idle.
+	void prefetch(uint64 offset);
+
+	PHYSFS_File *handle;
+	uint64 length;
+
+	uint64 pos;
+	uint64 lastReadEnd;
+
+	int64 minWindowSize;
+	int64 windowSize;
+
+	// A window is only touched by the thread while it's pending.
+	Window windows[2];
+	Window *requested;
+	bool stopping;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef cond;
+
+}; // Readahead
+
 class File : public love::filesystem::File
 {
 public:
@@ -82,6 +151,8 @@ private:
 	BufferMode bufferMode;
 	int64 bufferSize;
 
+	Readahead *readahead;
+
 }; // File
 
 } // physfs
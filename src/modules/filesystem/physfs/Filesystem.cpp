@@ -27,6 +27,7 @@
 
 #include "Filesystem.h"
 #include "File.h"
+#include "PackArchiver.h"
 
 // PhysFS
 #include "libraries/physfs/physfs.h"
@@ -89,18 +90,56 @@ namespace
 		return out.str();
 	}
 
+	// Cache keys have no leading or trailing slashes.
+	std::string trimSlashes(const std::string &input)
+	{
+		size_t start = input.find_first_not_of('/');
+		if (start == std::string::npos)
+			return std::string();
+
+		size_t end = input.find_last_not_of('/');
+		return input.substr(start, end - start + 1);
+	}
+
+#ifdef LOVE_ANDROID
+	// Zip fields are little endian.
+	love::uint32 readLE(const love::uint8 *p, int bytes)
+	{
+		love::uint32 value = 0;
+		for (int i = bytes - 1; i >= 0; i--)
+			value = (value << 8) | p[i];
+		return value;
+	}
+#endif
+
 }
 
 namespace love
 {
 namespace filesystem
 {
+
+extern bool hack_setupWriteDirectory();
+
 namespace physfs
 {
 
+// Invalidates the path cache when it goes out of scope, after whatever change
+// the enclosing function made.
+struct PathCacheInvalidator
+{
+	Filesystem *filesystem;
+	~PathCacheInvalidator() { filesystem->invalidatePathCache(); }
+};
+
 Filesystem::Filesystem()
 	: fused(false)
 	, fusedSet(false)
+	, pathCacheEnabled(false)
+#ifdef LOVE_ANDROID
+	, gameArchiveFD(-1)
+	, gameArchiveOffset(0)
+#endif
 {
 	requirePath = {"?.lua", "?/init.lua"};
 	cRequirePath = {"??"};
@@ -108,8 +147,15 @@ Filesystem::Filesystem()
 
 Filesystem::~Filesystem()
 {
+	stopFileIO();
+
 	if (PHYSFS_isInit())
 		PHYSFS_deinit();
+
+#ifdef LOVE_ANDROID
+	if (gameArchiveFD >= 0)
+		close(gameArchiveFD);
+#endif
 }
 
 const char *Filesystem::getName() const
@@ -122,6 +168,9 @@ void Filesystem::init(const char *arg0)
 	if (!PHYSFS_init(arg0))
 		throw love::Exception("Failed to initialize filesystem: %s", PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
 
+	if (!registerPackArchiver())
+		throw love::Exception("Failed to initialize filesystem: %s", PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
+
 	// Enable symlinks by default.
 	setSymlinksEnabled(true);
 }
@@ -143,6 +192,8 @@ bool Filesystem::isFused() const
 
 bool Filesystem::setIdentity(const char *ident, bool appendToPath) 
 {
+	PathCacheInvalidator invalidator = {this};
+
 	if (!PHYSFS_isInit())
 		return false;
 
@@ -211,6 +262,8 @@ const char *Filesystem::getIdentity() const
 
 bool Filesystem::setSource(const char *source)
 {
+	PathCacheInvalidator invalidator = {this};
+
 	if (!PHYSFS_isInit())
 		return false;
 
@@ -226,8 +279,10 @@ bool Filesystem::setSource(const char *source)
 
 	new_search_path = love::android::getSelectedGameFile();
 
-	// try mounting first, if that fails, load to memory and mount
-	if (!PHYSFS_mount(new_search_path.c_str(), nullptr, 1))
+	// try mounting first, then mapping it out of the APK, and if those fail,
+	// load to memory and mount
+	if (!PHYSFS_mount(new_search_path.c_str(), nullptr, 1)
+		&& !mountGameArchiveAsset(new_search_path))
 	{
 		// PHYSFS cannot yet mount a zip file inside an .apk
 		SDL_Log("Mounting %s did not work. Loading to memory.",
@@ -269,6 +324,8 @@ const char *Filesystem::getSource() const
 
 bool Filesystem::setupWriteDirectory()
 {
+	PathCacheInvalidator invalidator = {this};
+
 	if (!PHYSFS_isInit())
 		return false;
 
@@ -325,6 +382,8 @@ bool Filesystem::setupWriteDirectory()
 
 bool Filesystem::mount(const char *archive, const char *mountpoint, bool appendToPath)
 {
+	PathCacheInvalidator invalidator = {this};
+
 	if (!PHYSFS_isInit() || !archive)
 		return false;
 
@@ -350,14 +409,39 @@ bool Filesystem::mount(const char *archive, const char *mountpoint, bool appendT
 
 		const char *realDir = PHYSFS_getRealDir(archive);
 		if (!realDir)
+		{
+#ifdef LOVE_ANDROID
+			// Archives stored uncompressed in the APK's assets are mapped.
+			int64 offset = 0;
+			int64 length = 0;
+			int fd = love::android::openAssetFileDescriptor(archive, &offset, &length);
+			if (fd < 0)
+				return false;
+
+			StrongRef<FileData> data(FileData::createMapped(fd, offset, length, archive), Acquire::NORETAIN);
+			close(fd);
+
+			return data.get() != nullptr && mount(data.get(), archive, mountpoint, appendToPath);
+#else
 			return false;
+#endif
+		}
 
 		realPath = realDir;
 
 		// Always disallow mounting of files inside the game source, since it
 		// won't work anyway if the game source is a zipped .love file.
 		if (realPath.find(game_source) == 0)
+		{
+#ifdef LOVE_ANDROID
+			// Unless the game source was mapped out of the APK and the file
+			// is stored uncompressed in it.
+			StrongRef<FileData> data(mapStoredGameFile(archive), Acquire::NORETAIN);
+			return data.get() != nullptr && mount(data.get(), archive, mountpoint, appendToPath);
+#else
 			return false;
+#endif
+		}
 
 		realPath += LOVE_PATH_SEPARATOR;
 		realPath += archive;
@@ -371,6 +455,8 @@ bool Filesystem::mount(const char *archive, const char *mountpoint, bool appendT
 
 bool Filesystem::mount(Data *data, const char *archivename, const char *mountpoint, bool appendToPath)
 {
+	PathCacheInvalidator invalidator = {this};
+
 	if (!PHYSFS_isInit())
 		return false;
 
@@ -385,6 +471,8 @@ bool Filesystem::mount(Data *data, const char *archivename, const char *mountpoi
 
 bool Filesystem::unmount(const char *archive)
 {
+	PathCacheInvalidator invalidator = {this};
+
 	if (!PHYSFS_isInit() || !archive)
 		return false;
 
@@ -565,6 +653,29 @@ bool Filesystem::getInfo(const char *filepath, Info &info) const
 	if (!PHYSFS_isInit())
 		return false;
 
+	std::string path = trimSlashes(filepath);
+
+	if (!pathCacheEnabled || path.empty())
+		return statPath(filepath, info);
+
+	size_t slash = path.rfind('/');
+	std::string parent = slash != std::string::npos ? path.substr(0, slash) : std::string();
+	std::string name = path.substr(slash != std::string::npos ? slash + 1 : 0);
+
+	thread::Lock lock(cacheMutex);
+
+	const CachedDirectory &dir = getCachedDirectory(parent);
+
+	auto it = dir.entries.find(name);
+	if (it == dir.entries.end())
+		return false;
+
+	info = it->second;
+	return true;
+}
+
+bool Filesystem::statPath(const char *filepath, Info &info)
+{
 	PHYSFS_Stat stat = {};
 	if (!PHYSFS_stat(filepath, &stat))
 		return false;
@@ -586,6 +697,8 @@ bool Filesystem::getInfo(const char *filepath, Info &info) const
 
 bool Filesystem::createDirectory(const char *dir)
 {
+	PathCacheInvalidator invalidator = {this};
+
 	if (!PHYSFS_isInit())
 		return false;
 
@@ -600,6 +713,8 @@ bool Filesystem::createDirectory(const char *dir)
 
 bool Filesystem::remove(const char *file)
 {
+	PathCacheInvalidator invalidator = {this};
+
 	if (!PHYSFS_isInit())
 		return false;
 
@@ -622,6 +737,55 @@ FileData *Filesystem::read(const char *filename, int64 size) const
 	return file.read(size);
 }
 
+FileData *Filesystem::mapFile(const char *filename) const
+{
+	if (!PHYSFS_isInit())
+		throw love::Exception("PhysFS is not initialized.");
+
+	const char *dir = PHYSFS_getRealDir(filename);
+
+#ifdef LOVE_ANDROID
+	if (dir != nullptr && gameArchive.get() != nullptr && game_source == dir)
+	{
+		FileData *data = mapStoredGameFile(filename);
+		if (data != nullptr)
+			return data;
+	}
+#endif
+
+	// Files inside other archives can't be mapped.
+	if (dir != nullptr && isRealDirectory(dir))
+	{
+		std::string path = filename;
+		const char *mountpoint = PHYSFS_getMountPoint(dir);
+
+		// Paths in the search path are relative to where the dir is mounted.
+		if (mountpoint != nullptr)
+		{
+			std::string mount = mountpoint;
+			while (!mount.empty() && mount[0] == '/')
+				mount = mount.substr(1);
+
+			while (!path.empty() && path[0] == '/')
+				path = path.substr(1);
+
+			if (path.compare(0, mount.size(), mount) == 0)
+				path = path.substr(mount.size());
+
+			while (!path.empty() && path[0] == '/')
+				path = path.substr(1);
+		}
+
+		std::string fullpath = std::string(dir) + LOVE_PATH_SEPARATOR + path;
+
+		FileData *data = FileData::createMapped(fullpath, filename);
+		if (data != nullptr)
+			return data;
+	}
+
+	return read(filename);
+}
+
 void Filesystem::write(const char *filename, const void *data, int64 size) const
 {
 	File file(filename);
@@ -644,11 +808,55 @@ void Filesystem::append(const char *filename, const void *data, int64 size) cons
 		throw love::Exception("Data could not be written.");
 }
 
+void Filesystem::writeAtomic(const char *filename, const void *data, int64 size) const
+{
+	if (!PHYSFS_isInit())
+		throw love::Exception("PhysFS is not initialized.");
+
+	if (PHYSFS_getWriteDir() == nullptr && !hack_setupWriteDirectory())
+		throw love::Exception("Could not set write directory.");
+
+	// The path skips PhysFS, so it has to be checked the same way.
+	std::string path = trimSlashes(filename);
+	if (path.empty() || path.find_first_of("\\:") != std::string::npos)
+		throw love::Exception("Invalid filename: %s", filename);
+
+	size_t start = 0;
+	while (start < path.size())
+	{
+		size_t end = std::min(path.find('/', start), path.size());
+		std::string segment = path.substr(start, end - start);
+
+		if (segment.empty() || segment == "." || segment == "..")
+			throw love::Exception("Invalid filename: %s", filename);
+
+		start = end + 1;
+	}
+
+	size_t slash = path.rfind('/');
+	if (slash != std::string::npos && !PHYSFS_mkdir(path.substr(0, slash).c_str()))
+		throw love::Exception("Could not create directory for %s.", filename);
+
+	std::string fullpath = std::string(PHYSFS_getWriteDir()) + LOVE_PATH_SEPARATOR + path;
+
+	replaceFile(fullpath, data, size);
+
+	invalidatePathCache();
+}
+
 void Filesystem::getDirectoryItems(const char *dir, std::vector<std::string> &items)
 {
 	if (!PHYSFS_isInit())
 		return;
 
+	if (pathCacheEnabled)
+	{
+		thread::Lock lock(cacheMutex);
+		const CachedDirectory &cached = getCachedDirectory(trimSlashes(dir));
+		items.insert(items.end(), cached.items.begin(), cached.items.end());
+		return;
+	}
+
 	char **rc = PHYSFS_enumerateFiles(dir);
 
 	if (rc == nullptr)
@@ -660,8 +868,89 @@ void Filesystem::getDirectoryItems(const char *dir, std::vector<std::string> &it
 	PHYSFS_freeList(rc);
 }
 
+void Filesystem::scanDirectory(const char *dir, const std::string &pattern, FileType filter, int maxDepth, std::vector<DirectoryEntry> &entries)
+{
+	if (!PHYSFS_isInit())
+		return;
+
+	scanDirectory(trimSlashes(dir), std::string(), 0, pattern, filter, maxDepth, entries);
+}
+
+void Filesystem::scanDirectory(const std::string &root, const std::string &relative, int depth, const std::string &pattern, FileType filter, int maxDepth, std::vector<DirectoryEntry> &entries) const
+{
+	std::string dir = root;
+	if (!relative.empty())
+		dir = root.empty() ? relative : root + "/" + relative;
+
+	std::vector<DirectoryEntry> children;
+	getDirectoryEntries(dir, children);
+
+	for (DirectoryEntry &child : children)
+	{
+		std::string childrelative = relative.empty() ? child.path : relative + "/" + child.path;
+
+		bool matches = (filter == FILETYPE_MAX_ENUM || child.info.type == filter)
+			&& (pattern.empty() || matchGlob(pattern, childrelative));
+
+		if (matches)
+		{
+			DirectoryEntry entry;
+			entry.path = root.empty() ? childrelative : root + "/" + childrelative;
+			entry.info = child.info;
+			entries.push_back(entry);
+		}
+
+		if (child.info.type == FILETYPE_DIRECTORY && (maxDepth < 0 || depth < maxDepth))
+			scanDirectory(root, childrelative, depth + 1, pattern, filter, maxDepth, entries);
+	}
+}
+
+void Filesystem::getDirectoryEntries(const std::string &dir, std::vector<DirectoryEntry> &entries) const
+{
+	if (pathCacheEnabled)
+	{
+		thread::Lock lock(cacheMutex);
+		const CachedDirectory &cached = getCachedDirectory(dir);
+
+		for (const std::string &item : cached.items)
+		{
+			auto it = cached.entries.find(item);
+			if (it == cached.entries.end())
+				continue;
+
+			DirectoryEntry entry;
+			entry.path = item;
+			entry.info = it->second;
+			entries.push_back(entry);
+		}
+
+		return;
+	}
+
+	char **rc = PHYSFS_enumerateFiles(dir.c_str());
+
+	if (rc == nullptr)
+		return;
+
+	for (char **i = rc; *i != 0; i++)
+	{
+		std::string child = dir.empty() ? std::string(*i) : dir + "/" + *i;
+
+		DirectoryEntry entry;
+		entry.path = *i;
+		entry.info = {};
+
+		if (statPath(child.c_str(), entry.info))
+			entries.push_back(entry);
+	}
+
+	PHYSFS_freeList(rc);
+}
+
 void Filesystem::setSymlinksEnabled(bool enable)
 {
+	PathCacheInvalidator invalidator = {this};
+
 	if (!PHYSFS_isInit())
 		return;
 
@@ -692,6 +981,172 @@ void Filesystem::allowMountingForPath(const std::string &path)
 		allowedMountPaths.push_back(path);
 }
 
+void Filesystem::setPathCacheEnabled(bool enable)
+{
+	thread::Lock lock(cacheMutex);
+	pathCacheEnabled = enable;
+	pathCache.clear();
+}
+
+bool Filesystem::isPathCacheEnabled() const
+{
+	return pathCacheEnabled;
+}
+
+void Filesystem::invalidatePathCache() const
+{
+	thread::Lock lock(cacheMutex);
+	pathCache.clear();
+}
+
+const Filesystem::CachedDirectory &Filesystem::getCachedDirectory(const std::string &dir) const
+{
+	auto it = pathCache.find(dir);
+	if (it != pathCache.end())
+		return it->second;
+
+	// Existence comes from the parent's cached listing, so missing paths never
+	// have to search the whole search path.
+	bool exists = dir.empty();
+	if (!exists)
+	{
+		size_t slash = dir.rfind('/');
+		std::string parent = slash != std::string::npos ? dir.substr(0, slash) : std::string();
+		std::string name = dir.substr(slash != std::string::npos ? slash + 1 : 0);
+
+		const CachedDirectory &parentdir = getCachedDirectory(parent);
+		auto entry = parentdir.entries.find(name);
+		exists = entry != parentdir.entries.end() && entry->second.type != FILETYPE_FILE;
+	}
+
+	CachedDirectory &cached = pathCache[dir];
+	cached.exists = exists;
+
+	if (!exists)
+		return cached;
+
+	char **rc = PHYSFS_enumerateFiles(dir.c_str());
+	if (rc == nullptr)
+		return cached;
+
+	for (char **i = rc; *i != 0; i++)
+	{
+		cached.items.push_back(*i);
+
+		std::string child = dir.empty() ? std::string(*i) : dir + "/" + *i;
+
+		Info info = {};
+		if (statPath(child.c_str(), info))
+			cached.entries[*i] = info;
+	}
+
+	PHYSFS_freeList(rc);
+
+	return cached;
+}
+
+#ifdef LOVE_ANDROID
+
+bool Filesystem::mountGameArchiveAsset(const std::string &path)
+{
+	int64 offset = 0;
+	int64 length = 0;
+	int fd = love::android::openAssetFileDescriptor(path.c_str(), &offset, &length);
+	if (fd < 0)
+		return false;
+
+	StrongRef<FileData> archive(FileData::createMapped(fd, offset, length, path), Acquire::NORETAIN);
+
+	if (archive.get() == nullptr || !PHYSFS_mountMemory(archive->getData(), archive->getSize(), nullptr, path.c_str(), nullptr, 1))
+	{
+		close(fd);
+		return false;
+	}
+
+	SDL_Log("Mapped %s from the APK.", path.c_str());
+
+	gameArchive = archive;
+	gameArchiveFD = fd;
+	gameArchiveOffset = offset;
+	storedGameFiles.clear();
+
+	// Index the files stored without compression, using the central
+	// directory at the end of the archive. Zip64 archives aren't indexed,
+	// their files are just read through PhysFS.
+	const uint8 *zip = (const uint8 *) archive->getData();
+	size_t size = archive->getSize();
+
+	// The end of central directory record is 22 bytes, followed by a comment
+	// of up to 64k.
+	if (size < 22)
+		return true;
+
+	size_t eocd = size - 22;
+	size_t mineocd = size > 22 + 0xFFFF ? size - 22 - 0xFFFF : 0;
+	while (readLE(zip + eocd, 4) != 0x06054b50)
+	{
+		if (eocd == mineocd)
+			return true;
+		eocd--;
+	}
+
+	size_t count = readLE(zip + eocd + 10, 2);
+	size_t pos = readLE(zip + eocd + 16, 4);
+
+	for (size_t i = 0; i < count && pos + 46 <= size; i++)
+	{
+		const uint8 *entry = zip + pos;
+		if (readLE(entry, 4) != 0x02014b50)
+			break;
+
+		uint32 flags = readLE(entry + 8, 2);
+		uint32 method = readLE(entry + 10, 2);
+		uint32 compressedsize = readLE(entry + 20, 4);
+		uint32 filesize = readLE(entry + 24, 4);
+		size_t namelength = readLE(entry + 28, 2);
+		size_t headeroffset = readLE(entry + 42, 4);
+
+		pos += 46 + namelength + readLE(entry + 30, 2) + readLE(entry + 32, 2);
+		if (pos > size)
+			break;
+
+		std::string name((const char *) entry + 46, namelength);
+
+		// Stored, unencrypted and non-empty files only.
+		if (method != 0 || (flags & 1) != 0 || filesize == 0 || filesize != compressedsize
+			|| filesize == 0xFFFFFFFF || headeroffset == 0xFFFFFFFF || name.empty() || name.back() == '/')
+			continue;
+
+		// The file's contents follow its local header, whose variable length
+		// fields can differ from the central directory's.
+		if (headeroffset + 30 > size || readLE(zip + headeroffset, 4) != 0x04034b50)
+			continue;
+
+		size_t dataoffset = headeroffset + 30 + readLE(zip + headeroffset + 26, 2) + readLE(zip + headeroffset + 28, 2);
+		if (dataoffset + filesize > size)
+			continue;
+
+		StoredFile file = {(int64) dataoffset, (int64) filesize};
+		storedGameFiles[name] = file;
+	}
+
+	return true;
+}
+
+FileData *Filesystem::mapStoredGameFile(const char *filename) const
+{
+	if (gameArchive.get() == nullptr)
+		return nullptr;
+
+	auto it = storedGameFiles.find(trimSlashes(filename));
+	if (it == storedGameFiles.end())
+		return nullptr;
+
+	return FileData::createMapped(gameArchiveFD, gameArchiveOffset + it->second.offset, it->second.size, filename);
+}
+
+#endif // LOVE_ANDROID
+
 } // physfs
 } // filesystem
 } // love
@@ -25,9 +25,11 @@
 #include <cstdlib>
 #include <cstring>
 #include <map>
+#include <unordered_map>
 
 // LOVE
 #include "filesystem/Filesystem.h"
+#include "thread/threads.h"
 
 namespace love
 {
@@ -83,10 +85,13 @@ public:
 	bool remove(const char *file) override;
 
 	FileData *read(const char *filename, int64 size = File::ALL) const override;
+	FileData *mapFile(const char *filename) const override;
 	void write(const char *filename, const void *data, int64 size) const override;
 	void append(const char *filename, const void *data, int64 size) const override;
+	void writeAtomic(const char *filename, const void *data, int64 size) const override;
 
 	void getDirectoryItems(const char *dir, std::vector<std::string> &items) override;
+	void scanDirectory(const char *dir, const std::string &pattern, FileType filter, int maxDepth, std::vector<DirectoryEntry> &entries) override;
 
 	void setSymlinksEnabled(bool enable) override;
 	bool areSymlinksEnabled() const override;
@@ -96,8 +101,49 @@ public:
 
 	void allowMountingForPath(const std::string &path) override;
 
+	void setPathCacheEnabled(bool enable) override;
+	bool isPathCacheEnabled() const override;
+
+	// Drops cached path information. Called whenever the search path or the
+	// contents of the save directory may have changed.
+	void invalidatePathCache() const;
+
 private:
 
+	struct CachedDirectory
+	{
+		bool exists;
+		std::vector<std::string> items;
+		std::unordered_map<std::string, Info> entries;
+	};
+
+	static bool statPath(const char *path, Info &info);
+
+	// Lists the directory if it isn't cached yet. cacheMutex must be locked.
+	const CachedDirectory &getCachedDirectory(const std::string &dir) const;
+
+	// Lists a directory's children and their metadata, through the path cache
+	// when it's enabled.
+	void getDirectoryEntries(const std::string &dir, std::vector<DirectoryEntry> &entries) const;
+
+	void scanDirectory(const std::string &root, const std::string &relative, int depth, const std::string &pattern, FileType filter, int maxDepth, std::vector<DirectoryEntry> &entries) const;
+
+#ifdef LOVE_ANDROID
+	struct StoredFile
+	{
+		int64 offset;
+		int64 size;
+	};
+
+	// Mounts the game archive straight out of the APK when it's stored
+	// uncompressed there.
+	bool mountGameArchiveAsset(const std::string &path);
+
+	// Maps a file stored uncompressed in the game archive mounted by the
+	// above. Returns null for any other file.
+	FileData *mapStoredGameFile(const char *filename) const;
+#endif
+
 	// Contains the current working directory (UTF8).
 	std::string cwd;
 
@@ -129,6 +175,21 @@ private:
 
 	std::map<std::string, StrongRef<Data>> mountedData;
 
+#ifdef LOVE_ANDROID
+	// The APK the game archive is mapped from, where the archive starts in
+	// it, and the archive's uncompressed files keyed by path.
+	StrongRef<FileData> gameArchive;
+	int gameArchiveFD;
+	int64 gameArchiveOffset;
+	std::unordered_map<std::string, StoredFile> storedGameFiles;
+#endif
+
+	// Cached directory listings, keyed by path without leading or trailing
+	// slashes.
+	bool pathCacheEnabled;
+	love::thread::MutexRef cacheMutex;
+	mutable std::unordered_map<std::string, CachedDirectory> pathCache;
+
 }; // Filesystem
 
 } // physfs
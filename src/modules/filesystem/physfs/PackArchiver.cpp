@@ -0,0 +1,516 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "PackArchiver.h"
+#include "filesystem/Pack.h"
+
+#include "libraries/physfs/physfs.h"
+
+// C++
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+
+using namespace love::filesystem::pack;
+
+namespace
+{
+
+struct PackArchive
+{
+	PHYSFS_Io *io;
+	Header header;
+	std::vector<Entry> entries;
+	std::string names;
+
+	// Directory path (without slashes at either end, "" for the root) to the
+	// names of its direct children.
+	std::unordered_map<std::string, std::set<std::string>> directories;
+};
+
+struct PackFile
+{
+	PHYSFS_Io *io;
+	Entry entry;
+	uint32 blockSize;
+	uint64 pos;
+
+	std::vector<uint64> blocks;
+	std::vector<uint8> stored;
+	std::vector<uint8> decoded;
+	int64 decodedBlock;
+};
+
+bool readAt(PHYSFS_Io *io, uint64 offset, void *dst, uint64 size)
+{
+	if (!io->seek(io, offset))
+		return false;
+
+	if (io->read(io, dst, size) != (PHYSFS_sint64) size)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+		return false;
+	}
+
+	return true;
+}
+
+const Entry *findEntry(const PackArchive *archive, const char *path)
+{
+	size_t length = strlen(path);
+	uint64 hash = hashPath(path, length);
+
+	auto it = std::lower_bound(archive->entries.begin(), archive->entries.end(), hash, [](const Entry &e, uint64 h)
+	{
+		return e.hash < h;
+	});
+
+	for (; it != archive->entries.end() && it->hash == hash; ++it)
+	{
+		if (it->nameLength == length && archive->names.compare(it->nameOffset, length, path) == 0)
+			return &(*it);
+	}
+
+	return nullptr;
+}
+
+// Makes sure the block at the given index is in the file's decoded buffer.
+bool decodeBlock(PackFile *file, uint64 block)
+{
+	if (file->decodedBlock == (int64) block)
+		return true;
+
+	uint64 start = file->blocks[block];
+	uint64 storedsize = file->blocks[block + 1] - start;
+	uint64 size = std::min((uint64) file->blockSize, file->entry.size - block * file->blockSize);
+
+	file->stored.resize(storedsize);
+	file->decoded.resize(size);
+
+	if (!readAt(file->io, file->entry.offset + start, file->stored.data(), storedsize))
+		return false;
+
+	Compression compression = (Compression) file->entry.compression;
+	if (!decompressBlock(compression, file->stored.data(), storedsize, file->decoded.data(), size))
+	{
+		file->decodedBlock = -1;
+		PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+		return false;
+	}
+
+	file->decodedBlock = (int64) block;
+	return true;
+}
+
+PHYSFS_sint64 fileRead(PHYSFS_Io *io, void *buf, PHYSFS_uint64 buflen)
+{
+	PackFile *file = (PackFile *) io->opaque;
+
+	uint64 len = std::min((uint64) buflen, file->entry.size - std::min(file->pos, file->entry.size));
+	if (len == 0)
+		return 0;
+
+	if (file->entry.compression == COMPRESSION_NONE)
+	{
+		if (!readAt(file->io, file->entry.offset + file->pos, buf, len))
+			return -1;
+
+		file->pos += len;
+		return (PHYSFS_sint64) len;
+	}
+
+	uint8 *dst = (uint8 *) buf;
+	uint64 remaining = len;
+
+	while (remaining > 0)
+	{
+		uint64 block = file->pos / file->blockSize;
+		uint64 offset = file->pos % file->blockSize;
+
+		if (!decodeBlock(file, block))
+			return len == remaining ? -1 : (PHYSFS_sint64) (len - remaining);
+
+		uint64 count = std::min(remaining, (uint64) file->decoded.size() - offset);
+		memcpy(dst, file->decoded.data() + offset, count);
+
+		dst += count;
+		remaining -= count;
+		file->pos += count;
+	}
+
+	return (PHYSFS_sint64) len;
+}
+
+PHYSFS_sint64 fileWrite(PHYSFS_Io * /*io*/, const void * /*buf*/, PHYSFS_uint64 /*len*/)
+{
+	PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+	return -1;
+}
+
+int fileSeek(PHYSFS_Io *io, PHYSFS_uint64 offset)
+{
+	PackFile *file = (PackFile *) io->opaque;
+
+	if (offset > file->entry.size)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_PAST_EOF);
+		return 0;
+	}
+
+	file->pos = offset;
+	return 1;
+}
+
+PHYSFS_sint64 fileTell(PHYSFS_Io *io)
+{
+	return (PHYSFS_sint64) ((PackFile *) io->opaque)->pos;
+}
+
+PHYSFS_sint64 fileLength(PHYSFS_Io *io)
+{
+	return (PHYSFS_sint64) ((PackFile *) io->opaque)->entry.size;
+}
+
+int fileFlush(PHYSFS_Io * /*io*/)
+{
+	return 1;
+}
+
+PHYSFS_Io *fileDuplicate(PHYSFS_Io *io);
+
+void fileDestroy(PHYSFS_Io *io)
+{
+	PackFile *file = (PackFile *) io->opaque;
+	file->io->destroy(file->io);
+	delete file;
+	delete io;
+}
+
+const PHYSFS_Io fileIo =
+{
+	0,
+	nullptr,
+	fileRead,
+	fileWrite,
+	fileSeek,
+	fileTell,
+	fileLength,
+	fileDuplicate,
+	fileFlush,
+	fileDestroy,
+};
+
+PHYSFS_Io *newFileIo(PHYSFS_Io *archiveio, const Entry &entry, uint32 blockSize, const std::vector<uint64> &blocks)
+{
+	PHYSFS_Io *io = archiveio->duplicate(archiveio);
+	if (io == nullptr)
+		return nullptr;
+
+	PackFile *file = new PackFile();
+	file->io = io;
+	file->entry = entry;
+	file->blockSize = blockSize;
+	file->pos = 0;
+	file->blocks = blocks;
+	file->decodedBlock = -1;
+
+	PHYSFS_Io *result = new PHYSFS_Io(fileIo);
+	result->opaque = file;
+	return result;
+}
+
+PHYSFS_Io *fileDuplicate(PHYSFS_Io *io)
+{
+	PackFile *file = (PackFile *) io->opaque;
+	return newFileIo(file->io, file->entry, file->blockSize, file->blocks);
+}
+
+bool validateEntry(const Header &header, const Entry &entry)
+{
+	if ((uint64) entry.nameOffset + entry.nameLength > header.namesSize || entry.nameLength == 0)
+		return false;
+
+	if (entry.offset > header.indexOffset || entry.storedSize > header.indexOffset - entry.offset)
+		return false;
+
+	if (entry.compression == COMPRESSION_NONE)
+		return entry.storedSize == entry.size && entry.blockCount == 0;
+
+	if (entry.compression >= COMPRESSION_MAX_ENUM)
+		return false;
+
+	uint64 blockcount = (entry.size + header.blockSize - 1) / header.blockSize;
+	return entry.size > 0 && entry.blockCount == blockcount;
+}
+
+void *openArchive(PHYSFS_Io *io, const char * /*name*/, int forWrite, int *claimed)
+{
+	uint8 headerbytes[HEADER_SIZE];
+	Header header;
+
+	if (!readAt(io, 0, headerbytes, HEADER_SIZE) || !decodeHeader(headerbytes, header))
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_UNSUPPORTED);
+		return nullptr;
+	}
+
+	*claimed = 1;
+
+	if (forWrite)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+		return nullptr;
+	}
+
+	if (header.version != VERSION)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_UNSUPPORTED);
+		return nullptr;
+	}
+
+	PHYSFS_sint64 length = io->length(io);
+	uint64 indexsize = (uint64) header.entryCount * ENTRY_SIZE;
+
+	if (length < 0 || header.blockSize == 0
+		|| header.indexOffset > (uint64) length || indexsize > (uint64) length - header.indexOffset
+		|| header.namesOffset > (uint64) length || header.namesSize > (uint64) length - header.namesOffset)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+		return nullptr;
+	}
+
+	PackArchive *archive = new PackArchive();
+	archive->header = header;
+	archive->entries.resize(header.entryCount);
+	archive->names.resize(header.namesSize);
+
+	std::vector<uint8> index(indexsize);
+
+	if (!readAt(io, header.indexOffset, index.data(), indexsize)
+		|| !readAt(io, header.namesOffset, &archive->names[0], header.namesSize))
+	{
+		delete archive;
+		return nullptr;
+	}
+
+	archive->directories[""];
+
+	for (size_t i = 0; i < archive->entries.size(); i++)
+	{
+		Entry &entry = archive->entries[i];
+		decodeEntry(&index[i * ENTRY_SIZE], entry);
+
+		if (!validateEntry(header, entry) || (i > 0 && entry.hash < archive->entries[i - 1].hash))
+		{
+			delete archive;
+			PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+			return nullptr;
+		}
+
+		if (!isSupported((Compression) entry.compression))
+		{
+			delete archive;
+			PHYSFS_setErrorCode(PHYSFS_ERR_UNSUPPORTED);
+			return nullptr;
+		}
+
+		std::string path = archive->names.substr(entry.nameOffset, entry.nameLength);
+
+		// Register the file and every directory above it with its parent.
+		size_t end = path.size();
+		while (true)
+		{
+			size_t slash = path.rfind('/', end - 1);
+			std::string parent = slash == std::string::npos ? std::string() : path.substr(0, slash);
+			std::string child = path.substr(slash == std::string::npos ? 0 : slash + 1, end - (slash == std::string::npos ? 0 : slash + 1));
+
+			auto &children = archive->directories[parent];
+			bool existed = !children.insert(child).second;
+
+			if (existed || slash == std::string::npos)
+				break;
+
+			end = slash;
+		}
+	}
+
+	archive->io = io;
+	return archive;
+}
+
+PHYSFS_EnumerateCallbackResult enumerate(void *opaque, const char *dirname, PHYSFS_EnumerateCallback cb, const char *origdir, void *callbackdata)
+{
+	PackArchive *archive = (PackArchive *) opaque;
+
+	auto it = archive->directories.find(dirname);
+	if (it == archive->directories.end())
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_NOT_FOUND);
+		return PHYSFS_ENUM_ERROR;
+	}
+
+	for (const std::string &child : it->second)
+	{
+		PHYSFS_EnumerateCallbackResult result = cb(callbackdata, origdir, child.c_str());
+
+		if (result == PHYSFS_ENUM_ERROR)
+			PHYSFS_setErrorCode(PHYSFS_ERR_APP_CALLBACK);
+
+		if (result != PHYSFS_ENUM_OK)
+			return result;
+	}
+
+	return PHYSFS_ENUM_OK;
+}
+
+PHYSFS_Io *openRead(void *opaque, const char *filename)
+{
+	PackArchive *archive = (PackArchive *) opaque;
+
+	const Entry *entry = findEntry(archive, filename);
+	if (entry == nullptr)
+	{
+		bool isdir = archive->directories.count(filename) > 0;
+		PHYSFS_setErrorCode(isdir ? PHYSFS_ERR_NOT_A_FILE : PHYSFS_ERR_NOT_FOUND);
+		return nullptr;
+	}
+
+	std::vector<uint64> blocks;
+
+	if (entry->compression != COMPRESSION_NONE)
+	{
+		std::vector<uint8> table((entry->blockCount + 1) * sizeof(uint64));
+		if (!readAt(archive->io, entry->offset, table.data(), table.size()))
+			return nullptr;
+
+		blocks.resize(entry->blockCount + 1);
+		for (size_t i = 0; i < blocks.size(); i++)
+		{
+			blocks[i] = 0;
+			for (int j = 0; j < 8; j++)
+				blocks[i] |= (uint64) table[i * sizeof(uint64) + j] << (j * 8);
+		}
+
+		bool valid = blocks.front() == table.size() && blocks.back() == entry->storedSize;
+		for (size_t i = 0; valid && i < entry->blockCount; i++)
+		{
+			uint64 size = std::min((uint64) archive->header.blockSize, entry->size - i * archive->header.blockSize);
+			valid = blocks[i] <= blocks[i + 1] && blocks[i + 1] - blocks[i] <= size;
+		}
+
+		if (!valid)
+		{
+			PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+			return nullptr;
+		}
+	}
+
+	return newFileIo(archive->io, *entry, archive->header.blockSize, blocks);
+}
+
+PHYSFS_Io *openWrite(void * /*opaque*/, const char * /*filename*/)
+{
+	PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+	return nullptr;
+}
+
+int removePath(void * /*opaque*/, const char * /*filename*/)
+{
+	PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+	return 0;
+}
+
+int stat(void *opaque, const char *filename, PHYSFS_Stat *stat)
+{
+	PackArchive *archive = (PackArchive *) opaque;
+
+	stat->modtime = -1;
+	stat->createtime = -1;
+	stat->accesstime = -1;
+	stat->readonly = 1;
+
+	const Entry *entry = findEntry(archive, filename);
+	if (entry != nullptr)
+	{
+		stat->filesize = (PHYSFS_sint64) entry->size;
+		stat->filetype = PHYSFS_FILETYPE_REGULAR;
+		return 1;
+	}
+
+	if (archive->directories.count(filename) > 0)
+	{
+		stat->filesize = 0;
+		stat->filetype = PHYSFS_FILETYPE_DIRECTORY;
+		return 1;
+	}
+
+	PHYSFS_setErrorCode(PHYSFS_ERR_NOT_FOUND);
+	return 0;
+}
+
+void closeArchive(void *opaque)
+{
+	PackArchive *archive = (PackArchive *) opaque;
+	archive->io->destroy(archive->io);
+	delete archive;
+}
+
+const PHYSFS_Archiver packArchiver =
+{
+	0,
+	{
+		"LPAK",
+		"LOVE indexed asset pack",
+		"LOVE Development Team",
+		"https://love2d.org/",
+		0,
+	},
+	openArchive,
+	enumerate,
+	openRead,
+	openWrite,
+	openWrite,
+	removePath,
+	removePath,
+	stat,
+	closeArchive,
+};
+
+} // anonymous namespace
+
+bool registerPackArchiver()
+{
+	return PHYSFS_registerArchiver(&packArchiver) != 0;
+}
+
+} // physfs
+} // filesystem
+} // love
@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_FileRequest.h"
+
+namespace love
+{
+namespace filesystem
+{
+
+FileRequest *luax_checkfilerequest(lua_State *L, int idx)
+{
+	return luax_checktype<FileRequest>(L, idx);
+}
+
+int w_FileRequest_isComplete(lua_State *L)
+{
+	FileRequest *r = luax_checkfilerequest(L, 1);
+	luax_pushboolean(L, r->isComplete());
+	return 1;
+}
+
+int w_FileRequest_isCancelled(lua_State *L)
+{
+	FileRequest *r = luax_checkfilerequest(L, 1);
+	luax_pushboolean(L, r->isCancelled());
+	return 1;
+}
+
+int w_FileRequest_wait(lua_State *L)
+{
+	FileRequest *r = luax_checkfilerequest(L, 1);
+	FileData *data = nullptr;
+	luax_catchexcept(L, [&](){ r->wait(); data = r->getData(); });
+
+	if (data != nullptr)
+		luax_pushtype(L, data);
+	else
+		lua_pushnil(L);
+
+	return 1;
+}
+
+int w_FileRequest_cancel(lua_State *L)
+{
+	FileRequest *r = luax_checkfilerequest(L, 1);
+	luax_pushboolean(L, r->cancel());
+	return 1;
+}
+
+int w_FileRequest_getData(lua_State *L)
+{
+	FileRequest *r = luax_checkfilerequest(L, 1);
+	FileData *data = nullptr;
+	luax_catchexcept(L, [&](){ data = r->getData(); });
+
+	if (data != nullptr)
+		luax_pushtype(L, data);
+	else
+		lua_pushnil(L);
+
+	return 1;
+}
+
+int w_FileRequest_getFilename(lua_State *L)
+{
+	FileRequest *r = luax_checkfilerequest(L, 1);
+	luax_pushstring(L, r->getFilename());
+	return 1;
+}
+
+int w_FileRequest_getOperation(lua_State *L)
+{
+	FileRequest *r = luax_checkfilerequest(L, 1);
+	const char *str = nullptr;
+	if (!FileRequest::getConstant(r->getOperation(), str))
+		return luaL_error(L, "Unknown file request operation.");
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_FileRequest_getPriority(lua_State *L)
+{
+	FileRequest *r = luax_checkfilerequest(L, 1);
+	lua_pushinteger(L, r->getPriority());
+	return 1;
+}
+
+static const luaL_Reg w_FileRequest_functions[] =
+{
+	{ "isComplete", w_FileRequest_isComplete },
+	{ "isCancelled", w_FileRequest_isCancelled },
+	{ "wait", w_FileRequest_wait },
+	{ "cancel", w_FileRequest_cancel },
+	{ "getData", w_FileRequest_getData },
+	{ "getFilename", w_FileRequest_getFilename },
+	{ "getOperation", w_FileRequest_getOperation },
+	{ "getPriority", w_FileRequest_getPriority },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_filerequest(lua_State *L)
+{
+	return luax_register_type(L, &FileRequest::type, w_FileRequest_functions, nullptr);
+}
+
+} // filesystem
+} // love
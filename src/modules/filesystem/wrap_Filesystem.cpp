@@ -24,6 +24,9 @@
 #include "wrap_File.h"
 #include "wrap_DroppedFile.h"
 #include "wrap_FileData.h"
+#include "wrap_FileRequest.h"
+#include "Pack.h"
+#include "AssetCache.h"
 #include "data/wrap_Data.h"
 #include "data/wrap_DataModule.h"
 
@@ -223,6 +226,17 @@ FileData *luax_getfiledata(lua_State *L, int idx)
 	FileData *data = nullptr;
 	File *file = nullptr;
 
+#ifdef LOVE_ANDROID
+	// Files stored uncompressed in a game archive mapped out of the APK are
+	// mapped as well, instead of copied.
+	if (lua_type(L, idx) == LUA_TSTRING && instance() != nullptr)
+	{
+		const char *filename = lua_tostring(L, idx);
+		luax_catchexcept(L, [&]() { data = instance()->mapFile(filename); });
+		return data;
+	}
+#endif
+
 	if (lua_isstring(L, idx) || luax_istype(L, idx, File::type))
 	{
 		file = luax_getfile(L, idx);
@@ -336,6 +350,73 @@ int w_newFileData(lua_State *L)
 	return 1;
 }
 
+int w_mapFile(lua_State *L)
+{
+	const char *filename = luaL_checkstring(L, 1);
+
+	FileData *data = nullptr;
+	try
+	{
+		data = instance()->mapFile(filename);
+	}
+	catch (love::Exception &e)
+	{
+		return luax_ioError(L, "%s", e.what());
+	}
+
+	luax_pushtype(L, data);
+	data->release();
+	return 1;
+}
+
+int w_setPathCacheEnabled(lua_State *L)
+{
+	instance()->setPathCacheEnabled(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isPathCacheEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isPathCacheEnabled());
+	return 1;
+}
+
+static AssetCache::Category luax_checkassetcachecategory(lua_State *L, int idx)
+{
+	const char *str = luaL_checkstring(L, idx);
+	AssetCache::Category category = AssetCache::CATEGORY_MAX_ENUM;
+	if (!AssetCache::getConstant(str, category))
+		luax_enumerror(L, "asset cache category", AssetCache::getConstants(category), str);
+	return category;
+}
+
+int w_setAssetCacheEnabled(lua_State *L)
+{
+	AssetCache::Category category = luax_checkassetcachecategory(L, 1);
+	AssetCache::setEnabled(category, luax_checkboolean(L, 2));
+	return 0;
+}
+
+int w_isAssetCacheEnabled(lua_State *L)
+{
+	AssetCache::Category category = luax_checkassetcachecategory(L, 1);
+	luax_pushboolean(L, AssetCache::isEnabled(category));
+	return 1;
+}
+
+int w_clearAssetCache(lua_State *L)
+{
+	if (lua_isnoneornil(L, 1))
+	{
+		for (int i = 0; i < (int) AssetCache::CATEGORY_MAX_ENUM; i++)
+			AssetCache::clear((AssetCache::Category) i);
+	}
+	else
+		AssetCache::clear(luax_checkassetcachecategory(L, 1));
+
+	return 0;
+}
+
 int w_getWorkingDirectory(lua_State *L)
 {
 	lua_pushstring(L, instance()->getWorkingDirectory());
@@ -545,6 +626,62 @@ static int w_write_or_append(lua_State *L, File::Mode mode)
 	return 1;
 }
 
+int w_readAsync(lua_State *L)
+{
+	const char *filename = luaL_checkstring(L, 1);
+	int priority = (int) luaL_optinteger(L, 2, 0);
+
+	FileRequest *request = nullptr;
+	luax_catchexcept(L, [&](){ request = instance()->newFileRequest(FileRequest::OPERATION_READ, filename, nullptr, priority); });
+
+	luax_pushtype(L, request);
+	request->release();
+	return 1;
+}
+
+static int w_writeAsync_or_appendAsync(lua_State *L, FileRequest::Operation operation)
+{
+	const char *filename = luaL_checkstring(L, 1);
+	int priority = (int) luaL_optinteger(L, 3, 0);
+
+	StrongRef<love::Data> data;
+
+	// Data is written as-is, so it shouldn't be modified until the request is
+	// complete. Strings have to be copied.
+	if (luax_istype(L, 2, love::Data::type))
+		data.set(luax_totype<love::Data>(L, 2));
+	else if (lua_isstring(L, 2))
+	{
+		size_t len = 0;
+		const char *str = lua_tolstring(L, 2, &len);
+		luax_catchexcept(L, [&](){ data.set(instance()->newFileData(str, len, filename), Acquire::NORETAIN); });
+	}
+	else
+		return luaL_argerror(L, 2, "string or Data expected");
+
+	FileRequest *request = nullptr;
+	luax_catchexcept(L, [&](){ request = instance()->newFileRequest(operation, filename, data, priority); });
+
+	luax_pushtype(L, request);
+	request->release();
+	return 1;
+}
+
+int w_writeAsync(lua_State *L)
+{
+	return w_writeAsync_or_appendAsync(L, FileRequest::OPERATION_WRITE);
+}
+
+int w_appendAsync(lua_State *L)
+{
+	return w_writeAsync_or_appendAsync(L, FileRequest::OPERATION_APPEND);
+}
+
+int w_saveAsync(lua_State *L)
+{
+	return w_writeAsync_or_appendAsync(L, FileRequest::OPERATION_SAVE);
+}
+
 int w_write(lua_State *L)
 {
 	return w_write_or_append(L, File::MODE_WRITE);
@@ -555,6 +692,69 @@ int w_append(lua_State *L)
 	return w_write_or_append(L, File::MODE_APPEND);
 }
 
+int w_writePack(lua_State *L)
+{
+	const char *filename = luaL_checkstring(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+
+	pack::Compression compression = pack::COMPRESSION_LZ4;
+	if (!lua_isnoneornil(L, 3))
+	{
+		const char *str = luaL_checkstring(L, 3);
+		if (!pack::getConstant(str, compression))
+			return luax_enumerror(L, "pack compression", pack::getConstants(compression), str);
+	}
+
+	lua_Integer blocksize = luaL_optinteger(L, 4, pack::DEFAULT_BLOCK_SIZE);
+	if (blocksize <= 0 || blocksize > 0x7FFFFFFF)
+		return luaL_argerror(L, 4, "block size must be positive");
+
+	std::vector<pack::Input> inputs;
+
+	lua_pushnil(L);
+	while (lua_next(L, 2))
+	{
+		if (lua_type(L, -2) != LUA_TSTRING)
+			return luaL_error(L, "Pack file paths must be strings.");
+
+		pack::Input input;
+		input.path = lua_tostring(L, -2);
+
+		if (luax_istype(L, -1, love::Data::type))
+			input.data.set(luax_totype<love::Data>(L, -1));
+		else if (lua_type(L, -1) == LUA_TSTRING)
+		{
+			size_t len = 0;
+			const char *str = lua_tolstring(L, -1, &len);
+			luax_catchexcept(L, [&](){ input.data.set(instance()->newFileData(str, len, input.path.c_str()), Acquire::NORETAIN); });
+		}
+		else
+			return luaL_error(L, "Pack file contents must be strings or Data.");
+
+		inputs.push_back(input);
+		lua_pop(L, 1);
+	}
+
+	StrongRef<File> file(instance()->newFile(filename), Acquire::NORETAIN);
+
+	try
+	{
+		if (!file->open(File::MODE_WRITE))
+			throw love::Exception("Could not open file %s.", filename);
+
+		pack::write(file, inputs, compression, (uint32) blocksize);
+		file->close();
+	}
+	catch (love::Exception &e)
+	{
+		file->close();
+		return luax_ioError(L, "%s", e.what());
+	}
+
+	luax_pushboolean(L, true);
+	return 1;
+}
+
 int w_getDirectoryItems(lua_State *L)
 {
 	const char *dir = luaL_checkstring(L, 1);
@@ -574,6 +774,79 @@ int w_getDirectoryItems(lua_State *L)
 	return 1;
 }
 
+int w_scanDirectory(lua_State *L)
+{
+	const char *dir = luaL_checkstring(L, 1);
+
+	std::string pattern;
+	Filesystem::FileType filter = Filesystem::FILETYPE_MAX_ENUM;
+	int maxdepth = -1;
+
+	if (lua_type(L, 2) == LUA_TSTRING)
+		pattern = lua_tostring(L, 2);
+	else if (!lua_isnoneornil(L, 2))
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+
+		lua_getfield(L, 2, "pattern");
+		if (!lua_isnoneornil(L, -1))
+			pattern = luaL_checkstring(L, -1);
+		lua_pop(L, 1);
+
+		lua_getfield(L, 2, "type");
+		if (!lua_isnoneornil(L, -1))
+		{
+			const char *typestr = luaL_checkstring(L, -1);
+			if (!Filesystem::getConstant(typestr, filter))
+				return luax_enumerror(L, "file type", Filesystem::getConstants(filter), typestr);
+		}
+		lua_pop(L, 1);
+
+		maxdepth = luax_intflag(L, 2, "maxdepth", -1);
+	}
+
+	std::vector<Filesystem::DirectoryEntry> entries;
+	luax_catchexcept(L, [&]() { instance()->scanDirectory(dir, pattern, filter, maxdepth, entries); });
+
+	lua_createtable(L, (int) entries.size(), 0);
+
+	for (int i = 0; i < (int) entries.size(); i++)
+	{
+		Filesystem::Info &info = entries[i].info;
+
+		const char *typestr = nullptr;
+		if (!Filesystem::getConstant(info.type, typestr))
+			typestr = "other";
+
+		lua_createtable(L, 0, 4);
+
+		luax_pushstring(L, entries[i].path);
+		lua_setfield(L, -2, "path");
+
+		lua_pushstring(L, typestr);
+		lua_setfield(L, -2, "type");
+
+		// Lua numbers (doubles) can't fit the full range of 64 bit ints.
+		info.size = std::min<int64>(info.size, 0x20000000000000LL);
+		if (info.size >= 0)
+		{
+			lua_pushnumber(L, (lua_Number) info.size);
+			lua_setfield(L, -2, "size");
+		}
+
+		info.modtime = std::min<int64>(info.modtime, 0x20000000000000LL);
+		if (info.modtime >= 0)
+		{
+			lua_pushnumber(L, (lua_Number) info.modtime);
+			lua_setfield(L, -2, "modtime");
+		}
+
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
 int w_lines(lua_State *L)
 {
 	if (lua_isstring(L, 1))
@@ -944,13 +1217,25 @@ static const luaL_Reg functions[] =
 	{ "read", w_read },
 	{ "write", w_write },
 	{ "append", w_append },
+	{ "readAsync", w_readAsync },
+	{ "writeAsync", w_writeAsync },
+	{ "appendAsync", w_appendAsync },
+	{ "saveAsync", w_saveAsync },
+	{ "writePack", w_writePack },
 	{ "getDirectoryItems", w_getDirectoryItems },
+	{ "scanDirectory", w_scanDirectory },
 	{ "lines", w_lines },
 	{ "load", w_load },
 	{ "getInfo", w_getInfo },
 	{ "setSymlinksEnabled", w_setSymlinksEnabled },
 	{ "areSymlinksEnabled", w_areSymlinksEnabled },
 	{ "newFileData", w_newFileData },
+	{ "mapFile", w_mapFile },
+	{ "setPathCacheEnabled", w_setPathCacheEnabled },
+	{ "isPathCacheEnabled", w_isPathCacheEnabled },
+	{ "setAssetCacheEnabled", w_setAssetCacheEnabled },
+	{ "isAssetCacheEnabled", w_isAssetCacheEnabled },
+	{ "clearAssetCache", w_clearAssetCache },
 	{ "getRequirePath", w_getRequirePath },
 	{ "setRequirePath", w_setRequirePath },
 	{ "getCRequirePath", w_getCRequirePath },
@@ -972,6 +1257,7 @@ static const lua_CFunction types[] =
 	luaopen_file,
 	luaopen_droppedfile,
 	luaopen_filedata,
+	luaopen_filerequest,
 	0
 };
 
@@ -22,6 +22,7 @@
 #include "BMFontRasterizer.h"
 #include "filesystem/Filesystem.h"
 #include "image/Image.h"
+#include "thread/WorkerPool.h"
 
 // C++
 #include <sstream>
@@ -131,9 +132,11 @@ std::string BMFontLine::getAttributeString(const char *name) const
 } // anonymous namespace
 
 
-BMFontRasterizer::BMFontRasterizer(love::filesystem::FileData *fontdef, const std::vector<image::ImageData *> &imagelist, float dpiscale)
+BMFontRasterizer::BMFontRasterizer(love::filesystem::FileData *fontdef, const std::vector<image::ImageData *> &imagelist, float dpiscale, bool backgrounddecode)
 	: fontSize(0)
 	, unicode(false)
+	, pageWidth(0)
+	, pageHeight(0)
 	, lineHeight(0)
 {
 	this->dpiScale = dpiscale;
@@ -150,12 +153,47 @@ BMFontRasterizer::BMFontRasterizer(love::filesystem::FileData *fontdef, const st
 		if (imagelist[i]->getFormat() != PIXELFORMAT_RGBA8)
 			throw love::Exception("Only 32-bit RGBA images are supported in BMFonts.");
 
-		images[i] = imagelist[i];
+		pages[i] = std::make_shared<Page>();
+		pages[i]->imageData.set(imagelist[i]);
 	}
 
 	std::string configtext((const char *) fontdef->getData(), fontdef->getSize());
 
 	parseConfig(configtext);
+
+	if (!backgrounddecode)
+		return;
+
+	for (const auto &pagepair : pages)
+	{
+		std::shared_ptr<Page> page = pagepair.second;
+
+		if (page->imageData.get() != nullptr)
+			continue;
+
+		page->decoding = true;
+
+		love::thread::WorkerPool::getShared().submit([page]()
+		{
+			StrongRef<image::ImageData> imagedata;
+			std::string err;
+
+			try
+			{
+				imagedata.set(loadPageImageData(page->filename), Acquire::NORETAIN);
+			}
+			catch (std::exception &e)
+			{
+				err = e.what();
+			}
+
+			love::thread::Lock lock(page->mutex);
+			page->imageData = imagedata;
+			page->error = err;
+			page->decoding = false;
+			page->cond->broadcast();
+		});
+	}
 }
 
 BMFontRasterizer::~BMFontRasterizer()
@@ -182,6 +220,8 @@ void BMFontRasterizer::parseConfig(const std::string &configtext)
 		{
 			lineHeight = cline.getAttributeInt("lineHeight");
 			metrics.ascent = cline.getAttributeInt("base");
+			pageWidth = cline.getAttributeInt("scaleW");
+			pageHeight = cline.getAttributeInt("scaleH");
 		}
 		else if (tag == "page")
 		{
@@ -192,33 +232,25 @@ void BMFontRasterizer::parseConfig(const std::string &configtext)
 			if (!fontFolder.empty())
 				filename = fontFolder + "/" + filename;
 
-			// Load the page file from disk into an ImageData, if necessary.
-			if (images[pageindex].get() == nullptr)
+			std::shared_ptr<Page> &page = pages[pageindex];
+			if (page.get() == nullptr)
+				page = std::make_shared<Page>();
+
+			// The page file is only loaded once it's needed, unless its size
+			// is needed to validate the characters.
+			if (page->imageData.get() == nullptr)
 			{
 				using namespace love::filesystem;
-				using namespace love::image;
-
-				auto filesystem  = Module::getInstance<Filesystem>(Module::M_FILESYSTEM);
-				auto imagemodule = Module::getInstance<image::Image>(Module::M_IMAGE);
 
+				auto filesystem = Module::getInstance<Filesystem>(Module::M_FILESYSTEM);
 				if (!filesystem)
 					throw love::Exception("Filesystem module not loaded!");
-				if (!imagemodule)
-					throw love::Exception("Image module not loaded!");
-
-				// read() returns a retained ref already.
-				StrongRef<FileData> data(filesystem->read(filename.c_str()), Acquire::NORETAIN);
-
-				ImageData *imagedata = imagemodule->newImageData(data.get());
 
-				if (imagedata->getFormat() != PIXELFORMAT_RGBA8)
-				{
-					imagedata->release();
-					throw love::Exception("Only 32-bit RGBA images are supported in BMFonts.");
-				}
+				Filesystem::Info info = {};
+				if (!filesystem->getInfo(filename.c_str(), info))
+					throw love::Exception("Could not open BMFont page file %s. Does not exist.", filename.c_str());
 
-				// Same with newImageData.
-				images[pageindex].set(imagedata, Acquire::NORETAIN);
+				page->filename = filename;
 			}
 		}
 		else if (tag == "char")
@@ -260,25 +292,24 @@ void BMFontRasterizer::parseConfig(const std::string &configtext)
 	for (const auto &cpair : characters)
 	{
 		const BMFontCharacter &c = cpair.second;
-		int width = c.metrics.width;
-		int height = c.metrics.height;
 
 		if (!unicode && cpair.first > 127)
 			throw love::Exception("Invalid BMFont character id (only unicode and ASCII are supported)");
 
-		if (c.page < 0 || images[c.page].get() == nullptr)
+		auto pageit = pages.find(c.page);
+		if (c.page < 0 || pageit == pages.end())
 			throw love::Exception("Invalid BMFont character page id: %d", c.page);
 
-		const image::ImageData *id = images[c.page].get();
+		// Pages which aren't loaded yet are expected to have the size given
+		// by the font definition. Without it, the page has to be loaded now.
+		const image::ImageData *id = pageit->second->imageData.get();
+		if (id == nullptr && (pageWidth <= 0 || pageHeight <= 0))
+			id = getPageImageData(c.page);
 
-		if (!id->inside(c.x, c.y))
-			throw love::Exception("Invalid coordinates for BMFont character %u.", cpair.first);
-
-		if (width > 0 && !id->inside(c.x + width - 1, c.y))
-			throw love::Exception("Invalid width %d for BMFont character %u.", width, cpair.first);
-
-		if (height > 0 && !id->inside(c.x, c.y + height - 1))
-			throw love::Exception("Invalid height %d for BMFont character %u.", height, cpair.first);
+		if (id != nullptr)
+			checkCharacter(cpair.first, c, id->getWidth(), id->getHeight());
+		else
+			checkCharacter(cpair.first, c, pageWidth, pageHeight);
 
 		if (guessheight)
 			lineHeight = std::max(lineHeight, c.metrics.height);
@@ -287,6 +318,75 @@ void BMFontRasterizer::parseConfig(const std::string &configtext)
 	metrics.height = lineHeight;
 }
 
+void BMFontRasterizer::checkCharacter(uint32 id, const BMFontCharacter &c, int pagewidth, int pageheight) const
+{
+	if (c.x < 0 || c.y < 0 || c.x >= pagewidth || c.y >= pageheight)
+		throw love::Exception("Invalid coordinates for BMFont character %u.", id);
+
+	if (c.metrics.width > 0 && c.x + c.metrics.width > pagewidth)
+		throw love::Exception("Invalid width %d for BMFont character %u.", c.metrics.width, id);
+
+	if (c.metrics.height > 0 && c.y + c.metrics.height > pageheight)
+		throw love::Exception("Invalid height %d for BMFont character %u.", c.metrics.height, id);
+}
+
+image::ImageData *BMFontRasterizer::getPageImageData(int pageindex) const
+{
+	auto it = pages.find(pageindex);
+	if (it == pages.end())
+		return nullptr;
+
+	Page &page = *it->second;
+
+	love::thread::Lock lock(page.mutex);
+
+	while (page.decoding)
+		page.cond->wait(page.mutex);
+
+	if (page.imageData.get() == nullptr && page.error.empty())
+	{
+		try
+		{
+			page.imageData.set(loadPageImageData(page.filename), Acquire::NORETAIN);
+		}
+		catch (std::exception &e)
+		{
+			page.error = e.what();
+		}
+	}
+
+	if (!page.error.empty())
+		throw love::Exception("%s", page.error.c_str());
+
+	return page.imageData.get();
+}
+
+image::ImageData *BMFontRasterizer::loadPageImageData(const std::string &filename)
+{
+	using namespace love::filesystem;
+
+	auto filesystem  = Module::getInstance<Filesystem>(Module::M_FILESYSTEM);
+	auto imagemodule = Module::getInstance<image::Image>(Module::M_IMAGE);
+
+	if (!filesystem)
+		throw love::Exception("Filesystem module not loaded!");
+	if (!imagemodule)
+		throw love::Exception("Image module not loaded!");
+
+	// read() returns a retained ref already.
+	StrongRef<FileData> data(filesystem->read(filename.c_str()), Acquire::NORETAIN);
+
+	image::ImageData *imagedata = imagemodule->newImageData(data.get());
+
+	if (imagedata->getFormat() != PIXELFORMAT_RGBA8)
+	{
+		imagedata->release();
+		throw love::Exception("Only 32-bit RGBA images are supported in BMFonts.");
+	}
+
+	return imagedata;
+}
+
 int BMFontRasterizer::getLineHeight() const
 {
 	return lineHeight;
@@ -301,12 +401,14 @@ GlyphData *BMFontRasterizer::getGlyphData(uint32 glyph) const
 		return new GlyphData(glyph, GlyphMetrics(), PIXELFORMAT_RGBA8);
 
 	const BMFontCharacter &c = it->second;
-	const auto &imagepair = images.find(c.page);
+	image::ImageData *imagedata = getPageImageData(c.page);
 
-	if (imagepair == images.end())
+	if (imagedata == nullptr)
 		return new GlyphData(glyph, GlyphMetrics(), PIXELFORMAT_RGBA8);
 
-	image::ImageData *imagedata = imagepair->second.get();
+	// The page's actual size may not match the one in the font definition.
+	checkCharacter(glyph, c, imagedata->getWidth(), imagedata->getHeight());
+
 	GlyphData *g = new GlyphData(glyph, c.metrics, PIXELFORMAT_RGBA8);
 
 	size_t pixelsize = imagedata->getPixelSize();
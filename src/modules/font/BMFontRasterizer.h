@@ -25,8 +25,11 @@
 #include "common/config.h"
 #include "Rasterizer.h"
 #include "image/ImageData.h"
+#include "thread/threads.h"
 
 // C++
+#include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -36,13 +39,19 @@ namespace font
 {
 
 /**
- * Rasterizer for BMFont bitmap fonts.
+ * Rasterizer for BMFont bitmap fonts. Page images which aren't given are
+ * loaded from the files the font definition refers to, the first time one of
+ * their glyphs is rasterized.
  **/
 class BMFontRasterizer : public Rasterizer
 {
 public:
 
-	BMFontRasterizer(love::filesystem::FileData *fontdef, const std::vector<image::ImageData *> &imagelist, float dpiscale);
+	/**
+	 * If backgrounddecode is true, the page image files start decoding on
+	 * worker threads right away, rather than when they're first needed.
+	 **/
+	BMFontRasterizer(love::filesystem::FileData *fontdef, const std::vector<image::ImageData *> &imagelist, float dpiscale, bool backgrounddecode = false);
 	virtual ~BMFontRasterizer();
 
 	// Implements Rasterizer.
@@ -65,12 +74,30 @@ private:
 		GlyphMetrics metrics;
 	};
 
+	// Shared with the worker thread decoding the page in the background.
+	struct Page
+	{
+		love::thread::MutexRef mutex;
+		love::thread::ConditionalRef cond;
+		std::string filename;
+		StrongRef<image::ImageData> imageData;
+		bool decoding = false;
+		std::string error;
+	};
+
 	void parseConfig(const std::string &config);
+	void checkCharacter(uint32 id, const BMFontCharacter &c, int pagewidth, int pageheight) const;
+
+	// Loads the page's image if it isn't yet, or waits for its background
+	// decode to finish.
+	image::ImageData *getPageImageData(int pageindex) const;
+
+	static image::ImageData *loadPageImageData(const std::string &filename);
 
 	std::string fontFolder;
 
 	// Image pages, indexed by their page id.
-	std::unordered_map<int, StrongRef<image::ImageData>> images;
+	std::unordered_map<int, std::shared_ptr<Page>> pages;
 
 	// Glyph characters, indexed by their glyph id.
 	std::unordered_map<uint32, BMFontCharacter> characters;
@@ -81,6 +108,10 @@ private:
 	int fontSize;
 	bool unicode;
 
+	// Size of the page images, if the font definition has it.
+	int pageWidth;
+	int pageHeight;
+
 	int lineHeight;
 
 }; // BMFontRasterizer
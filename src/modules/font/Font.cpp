@@ -54,9 +54,15 @@ Rasterizer *Font::newTrueTypeRasterizer(int size, float dpiscale, TrueTypeRaster
 	return newTrueTypeRasterizer(data.get(), size, dpiscale, hinting);
 }
 
-Rasterizer *Font::newBMFontRasterizer(love::filesystem::FileData *fontdef, const std::vector<image::ImageData *> &images, float dpiscale)
+Rasterizer *Font::newDistanceFieldRasterizer(int size, int spread, float dpiscale)
 {
-	return new BMFontRasterizer(fontdef, images, dpiscale);
+	StrongRef<DefaultFontData> data(new DefaultFontData, Acquire::NORETAIN);
+	return newDistanceFieldRasterizer(data.get(), size, spread, dpiscale);
+}
+
+Rasterizer *Font::newBMFontRasterizer(love::filesystem::FileData *fontdef, const std::vector<image::ImageData *> &images, float dpiscale, bool backgrounddecode)
+{
+	return new BMFontRasterizer(fontdef, images, dpiscale, backgrounddecode);
 }
 
 Rasterizer *Font::newImageRasterizer(love::image::ImageData *data, const std::string &text, int extraspacing, float dpiscale)
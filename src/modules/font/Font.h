@@ -52,7 +52,15 @@ public:
 	virtual Rasterizer *newTrueTypeRasterizer(love::Data *data, int size, TrueTypeRasterizer::Hinting hinting) = 0;
 	virtual Rasterizer *newTrueTypeRasterizer(love::Data *data, int size, float dpiscale, TrueTypeRasterizer::Hinting hinting) = 0;
 
-	virtual Rasterizer *newBMFontRasterizer(love::filesystem::FileData *fontdef, const std::vector<image::ImageData *> &images, float dpiscale);
+	/**
+	 * Creates a TrueType Rasterizer whose glyphs are signed distance fields,
+	 * which can be drawn crisply at sizes other than the one they were
+	 * rasterized at.
+	 **/
+	virtual Rasterizer *newDistanceFieldRasterizer(int size, int spread, float dpiscale);
+	virtual Rasterizer *newDistanceFieldRasterizer(love::Data *data, int size, int spread, float dpiscale) = 0;
+
+	virtual Rasterizer *newBMFontRasterizer(love::filesystem::FileData *fontdef, const std::vector<image::ImageData *> &images, float dpiscale, bool backgrounddecode = false);
 
 	virtual Rasterizer *newImageRasterizer(love::image::ImageData *data, const std::string &glyphs, int extraspacing, float dpiscale);
 	virtual Rasterizer *newImageRasterizer(love::image::ImageData *data, uint32 *glyphs, int length, int extraspacing, float dpiscale);
@@ -46,6 +46,8 @@ GlyphData::GlyphData(uint32 glyph, GlyphMetrics glyphMetrics, PixelFormat f)
 
 	if (metrics.width > 0 && metrics.height > 0)
 		data = new uint8[metrics.width * metrics.height * getPixelSize()];
+
+	setNativeMemorySize(type, getSize());
 }
 
 GlyphData::GlyphData(const GlyphData &c)
@@ -59,6 +61,8 @@ GlyphData::GlyphData(const GlyphData &c)
 		data = new uint8[metrics.width * metrics.height * getPixelSize()];
 		memcpy(data, c.data, c.getSize());
 	}
+
+	setNativeMemorySize(type, getSize());
 }
 
 GlyphData::~GlyphData()
@@ -102,6 +102,16 @@ float Rasterizer::getKerning(uint32 /*leftglyph*/, uint32 /*rightglyph*/) const
 	return 0.0f;
 }
 
+Rasterizer *Rasterizer::clone() const
+{
+	return nullptr;
+}
+
+int Rasterizer::getDistanceFieldSpread() const
+{
+	return 0;
+}
+
 float Rasterizer::getDPIScale() const
 {
 	return dpiScale;
@@ -120,6 +120,20 @@ public:
 
 	virtual DataType getDataType() const = 0;
 
+	/**
+	 * Creates a new Rasterizer with the same font and settings, which can
+	 * rasterize glyphs on another thread while this one is in use. Returns
+	 * null if this kind of Rasterizer doesn't support that. The new Rasterizer
+	 * must be released on the thread which created it.
+	 **/
+	virtual Rasterizer *clone() const;
+
+	/**
+	 * Gets the distance in pixels covered by the signed distance field in
+	 * glyphs of a distance field Rasterizer, or 0 for regular coverage glyphs.
+	 **/
+	virtual int getDistanceFieldSpread() const;
+
 	float getDPIScale() const;
 
 protected:
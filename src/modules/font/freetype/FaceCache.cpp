@@ -0,0 +1,168 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "FaceCache.h"
+#include "common/Exception.h"
+#include "libraries/xxHash/xxhash.h"
+
+// C
+#include <string.h>
+
+// C++
+#include <algorithm>
+
+namespace love
+{
+namespace font
+{
+namespace freetype
+{
+
+FaceCache::Face::Face()
+	: face(nullptr)
+	, hash(0)
+	, references(0)
+{
+}
+
+FaceCache::Face::~Face()
+{
+	clearOutlines();
+}
+
+FT_Error FaceCache::Face::getGlyph(FT_UInt index, int pixelsize, FT_Int32 loadflags, FT_Glyph *glyph)
+{
+	OutlineKey key = {index, (FT_UInt) pixelsize, loadflags};
+	auto it = outlines.find(key);
+
+	if (it == outlines.end())
+	{
+		FT_Error err = FT_Load_Glyph(face, index, loadflags);
+		if (err != FT_Err_Ok)
+			return err;
+
+		FT_Glyph loaded = nullptr;
+		err = FT_Get_Glyph(face->glyph, &loaded);
+		if (err != FT_Err_Ok)
+			return err;
+
+		if (outlines.size() >= MAX_CACHED_OUTLINES)
+			clearOutlines();
+
+		it = outlines.emplace(key, loaded).first;
+	}
+
+	return FT_Glyph_Copy(it->second, glyph);
+}
+
+size_t FaceCache::Face::OutlineKeyHash::operator()(const OutlineKey &key) const
+{
+	return (size_t) XXH32(&key, sizeof(OutlineKey), 0);
+}
+
+void FaceCache::Face::clearOutlines()
+{
+	for (const auto &outline : outlines)
+		FT_Done_Glyph(outline.second);
+
+	outlines.clear();
+}
+
+FaceCache::FaceCache(FT_Library library)
+	: library(library)
+{
+}
+
+FaceCache::~FaceCache()
+{
+	// Faces still in use by rasterizers are leaked rather than invalidated.
+}
+
+FaceCache::Face *FaceCache::acquire(love::Data *data)
+{
+	uint64 hash = XXH64(data->getData(), data->getSize(), 0);
+
+	thread::Lock lock(mutex);
+
+	std::vector<Face *> &candidates = faces[hash];
+
+	for (Face *face : candidates)
+	{
+		love::Data *facedata = face->data.get();
+
+		if (facedata == data || (facedata->getSize() == data->getSize()
+			&& memcmp(facedata->getData(), data->getData(), data->getSize()) == 0))
+		{
+			face->references++;
+			return face;
+		}
+	}
+
+	FT_Face ftface = nullptr;
+	FT_Error err = FT_New_Memory_Face(library,
+	                                  (const FT_Byte *)data->getData(), /* first byte in memory */
+	                                  data->getSize(),                  /* size in bytes        */
+	                                  0,                                /* face_index           */
+	                                  &ftface);
+
+	if (err != FT_Err_Ok)
+	{
+		if (candidates.empty())
+			faces.erase(hash);
+
+		throw love::Exception("TrueType Font loading error: FT_New_Face failed: 0x%x (problem with font file?)", err);
+	}
+
+	Face *face = new Face();
+	face->face = ftface;
+	face->data.set(data);
+	face->hash = hash;
+	face->references = 1;
+
+	candidates.push_back(face);
+	return face;
+}
+
+void FaceCache::release(Face *face)
+{
+	thread::Lock lock(mutex);
+
+	if (--face->references > 0)
+		return;
+
+	auto it = faces.find(face->hash);
+	if (it != faces.end())
+	{
+		std::vector<Face *> &candidates = it->second;
+		candidates.erase(std::remove(candidates.begin(), candidates.end(), face), candidates.end());
+
+		if (candidates.empty())
+			faces.erase(it);
+	}
+
+	face->clearOutlines();
+	FT_Done_Face(face->face);
+	delete face;
+}
+
+} // freetype
+} // font
+} // love
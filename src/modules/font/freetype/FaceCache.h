@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_FONT_FREETYPE_FACE_CACHE_H
+#define LOVE_FONT_FREETYPE_FACE_CACHE_H
+
+// LOVE
+#include "common/config.h"
+#include "common/int.h"
+#include "common/Data.h"
+#include "common/Object.h"
+#include "thread/threads.h"
+
+// FreeType2
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_GLYPH_H
+#include FT_SIZES_H
+
+// C++
+#include <unordered_map>
+#include <vector>
+
+namespace love
+{
+namespace font
+{
+namespace freetype
+{
+
+/**
+ * Shares FT_Faces between TrueTypeRasterizers created from the same font
+ * file data, so it's parsed once no matter how many sizes are used. Each
+ * rasterizer uses its own FT_Size on the shared face. Loaded glyph outlines
+ * are cached per face, for every rasterizer with the same size and hinting.
+ **/
+class FaceCache
+{
+public:
+
+	class Face
+	{
+	public:
+
+		Face();
+		~Face();
+
+		/**
+		 * Gets a copy of a glyph loaded with FT_Load_Glyph at the given pixel
+		 * size, which must be the one of the active FT_Size. The mutex must be
+		 * locked.
+		 **/
+		FT_Error getGlyph(FT_UInt index, int pixelsize, FT_Int32 loadflags, FT_Glyph *glyph);
+
+		FT_Face face;
+
+		// Must be locked while the face (or any of its sizes) is used, since
+		// rasterizers sharing it may be used from different threads.
+		love::thread::MutexRef mutex;
+
+	private:
+
+		friend class FaceCache;
+
+		struct OutlineKey
+		{
+			FT_UInt index;
+			FT_UInt pixelSize;
+			FT_Int32 loadFlags;
+
+			bool operator == (const OutlineKey &other) const
+			{
+				return index == other.index && pixelSize == other.pixelSize && loadFlags == other.loadFlags;
+			}
+		};
+
+		struct OutlineKeyHash
+		{
+			size_t operator()(const OutlineKey &key) const;
+		};
+
+		void clearOutlines();
+
+		StrongRef<love::Data> data;
+		uint64 hash;
+		int references;
+
+		std::unordered_map<OutlineKey, FT_Glyph, OutlineKeyHash> outlines;
+
+	}; // Face
+
+	FaceCache(FT_Library library);
+	~FaceCache();
+
+	/**
+	 * Gets the face for the font file data, opening it if no rasterizer uses
+	 * one with the same contents yet. Must be paired with release.
+	 **/
+	Face *acquire(love::Data *data);
+	void release(Face *face);
+
+private:
+
+	// Outlines past this count evict all of the face's cached ones.
+	static const size_t MAX_CACHED_OUTLINES = 4096;
+
+	FT_Library library;
+
+	std::unordered_map<uint64, std::vector<Face *>> faces;
+
+	// Also serializes the creation and destruction of faces, which isn't
+	// thread-safe within one FT_Library.
+	love::thread::MutexRef mutex;
+
+}; // FaceCache
+
+} // freetype
+} // font
+} // love
+
+#endif // LOVE_FONT_FREETYPE_FACE_CACHE_H
@@ -36,13 +36,17 @@ namespace freetype
 {
 
 Font::Font()
+	: faceCache(nullptr)
 {
 	if (FT_Init_FreeType(&library))
 		throw love::Exception("TrueTypeFont Loading error: FT_Init_FreeType failed");
+
+	faceCache = new FaceCache(library);
 }
 
 Font::~Font()
 {
+	delete faceCache;
 	FT_Done_FreeType(library);
 }
 
@@ -68,7 +72,15 @@ Rasterizer *Font::newTrueTypeRasterizer(love::Data *data, int size, TrueTypeRast
 
 Rasterizer *Font::newTrueTypeRasterizer(love::Data *data, int size, float dpiscale, TrueTypeRasterizer::Hinting hinting)
 {
-	return new TrueTypeRasterizer(library, data, size, dpiscale, hinting);
+	return new TrueTypeRasterizer(faceCache, data, size, dpiscale, hinting);
+}
+
+Rasterizer *Font::newDistanceFieldRasterizer(love::Data *data, int size, int spread, float dpiscale)
+{
+	if (spread <= 0)
+		throw love::Exception("Invalid distance field spread: %d", spread);
+
+	return new TrueTypeRasterizer(faceCache, data, size, dpiscale, TrueTypeRasterizer::HINTING_NORMAL, spread);
 }
 
 const char *Font::getName() const
@@ -23,6 +23,7 @@
 
 // LOVE
 #include "font/Font.h"
+#include "FaceCache.h"
 
 // FreeType2
 #include <ft2build.h>
@@ -47,6 +48,7 @@ public:
 	Rasterizer *newRasterizer(love::filesystem::FileData *data) override;
 	Rasterizer *newTrueTypeRasterizer(love::Data *data, int size, TrueTypeRasterizer::Hinting hinting) override;
 	Rasterizer *newTrueTypeRasterizer(love::Data *data, int size, float dpiscale, TrueTypeRasterizer::Hinting hinting) override;
+	Rasterizer *newDistanceFieldRasterizer(love::Data *data, int size, int spread, float dpiscale) override;
 
 	// Implement Module
 	const char *getName() const override;
@@ -56,6 +58,9 @@ private:
 	// FreeType library
 	FT_Library library;
 
+	// Shared by all TrueTypeRasterizers.
+	FaceCache *faceCache;
+
 }; // Font
 
 } // freetype
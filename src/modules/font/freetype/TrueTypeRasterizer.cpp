@@ -25,6 +25,10 @@
 // C
 #include <math.h>
 
+// C++
+#include <algorithm>
+#include <vector>
+
 namespace love
 {
 namespace font
@@ -32,33 +36,112 @@ namespace font
 namespace freetype
 {
 
-TrueTypeRasterizer::TrueTypeRasterizer(FT_Library library, love::Data *data, int size, float dpiscale, Hinting hinting)
-	: data(data)
+// Squared distance transform of a 1D function, from "Distance Transforms of
+// Sampled Functions" (Felzenszwalb and Huttenlocher). z must have room for
+// n + 1 values.
+static void distanceTransform1D(const float *f, float *d, int *v, float *z, int n)
+{
+	const float inf = 1e20f;
+
+	int k = 0;
+	v[0] = 0;
+	z[0] = -inf;
+	z[1] = inf;
+
+	for (int q = 1; q < n; q++)
+	{
+		float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+		while (s <= z[k])
+		{
+			k--;
+			s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+		}
+
+		k++;
+		v[k] = q;
+		z[k] = s;
+		z[k + 1] = inf;
+	}
+
+	k = 0;
+	for (int q = 0; q < n; q++)
+	{
+		while (z[k + 1] < q)
+			k++;
+		d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+	}
+}
+
+// In-place squared Euclidean distance transform of a w * h grid, where 0
+// marks the pixels distances are measured to.
+static void distanceTransform(std::vector<float> &grid, int w, int h)
+{
+	int n = std::max(w, h);
+	std::vector<float> f(n), d(n), z(n + 1);
+	std::vector<int> v(n);
+
+	for (int x = 0; x < w; x++)
+	{
+		for (int y = 0; y < h; y++)
+			f[y] = grid[y * w + x];
+
+		distanceTransform1D(f.data(), d.data(), v.data(), z.data(), h);
+
+		for (int y = 0; y < h; y++)
+			grid[y * w + x] = d[y];
+	}
+
+	for (int y = 0; y < h; y++)
+	{
+		distanceTransform1D(&grid[y * w], d.data(), v.data(), z.data(), w);
+		std::copy(d.begin(), d.begin() + w, grid.begin() + y * w);
+	}
+}
+
+TrueTypeRasterizer::TrueTypeRasterizer(FaceCache *faceCache, love::Data *data, int size, float dpiscale, Hinting hinting, int spread)
+	: faceCache(faceCache)
+	, face(nullptr)
+	, ftSize(nullptr)
+	, size(size)
+	, pixelSize(0)
+	, data(data)
 	, hinting(hinting)
+	, spread(spread)
 {
 	this->dpiScale = dpiscale;
 	size = floorf(size * dpiscale + 0.5f);
+	pixelSize = size;
 
 	if (size <= 0)
 		throw love::Exception("Invalid TrueType font size: %d", size);
 
+	if (spread < 0)
+		throw love::Exception("Invalid distance field spread: %d", spread);
+
+	face = faceCache->acquire(data);
+
 	FT_Error err = FT_Err_Ok;
-	err = FT_New_Memory_Face(library,
-	                         (const FT_Byte *)data->getData(), /* first byte in memory */
-	                         data->getSize(),                  /* size in bytes        */
-	                         0,                                /* face_index           */
-	                         &face);
 
-	if (err != FT_Err_Ok)
-		throw love::Exception("TrueType Font loading error: FT_New_Face failed: 0x%x (problem with font file?)", err);
+	{
+		thread::Lock lock(face->mutex);
 
-	err = FT_Set_Pixel_Sizes(face, size, size);
+		err = FT_New_Size(face->face, &ftSize);
+
+		if (err == FT_Err_Ok)
+		{
+			FT_Activate_Size(ftSize);
+			err = FT_Set_Pixel_Sizes(face->face, size, size);
+		}
+	}
 
 	if (err != FT_Err_Ok)
+	{
+		releaseFace();
 		throw love::Exception("TrueType Font loading error: FT_Set_Pixel_Sizes failed: 0x%x (invalid size?)", err);
+	}
 
 	// Set global metrics
-	FT_Size_Metrics s = face->size->metrics;
+	FT_Size_Metrics s = ftSize->metrics;
 	metrics.advance = (int) (s.max_advance >> 6);
 	metrics.ascent  = (int) (s.ascender >> 6);
 	metrics.descent = (int) (s.descender >> 6);
@@ -67,7 +150,20 @@ TrueTypeRasterizer::TrueTypeRasterizer(FT_Library library, love::Data *data, int
 
 TrueTypeRasterizer::~TrueTypeRasterizer()
 {
-	FT_Done_Face(face);
+	releaseFace();
+}
+
+void TrueTypeRasterizer::releaseFace()
+{
+	if (ftSize != nullptr)
+	{
+		thread::Lock lock(face->mutex);
+		FT_Done_Size(ftSize);
+		ftSize = nullptr;
+	}
+
+	faceCache->release(face);
+	face = nullptr;
 }
 
 int TrueTypeRasterizer::getLineHeight() const
@@ -83,16 +179,16 @@ GlyphData *TrueTypeRasterizer::getGlyphData(uint32 glyph) const
 	FT_Error err = FT_Err_Ok;
 	FT_UInt loadoption = hintingToLoadOption(hinting);
 
-	// Initialize
-	err = FT_Load_Glyph(face, FT_Get_Char_Index(face, glyph), FT_LOAD_DEFAULT | loadoption);
-
-	if (err != FT_Err_Ok)
-		throw love::Exception("TrueType Font glyph error: FT_Load_Glyph failed (0x%x)", err);
+	{
+		thread::Lock lock(face->mutex);
+		FT_Activate_Size(ftSize);
 
-	err = FT_Get_Glyph(face->glyph, &ftglyph);
+		FT_UInt index = FT_Get_Char_Index(face->face, glyph);
+		err = face->getGlyph(index, pixelSize, FT_LOAD_DEFAULT | loadoption, &ftglyph);
 
-	if (err != FT_Err_Ok)
-		throw love::Exception("TrueType Font glyph error: FT_Get_Glyph failed (0x%x)", err);
+		if (err != FT_Err_Ok)
+			throw love::Exception("TrueType Font glyph error: FT_Load_Glyph failed (0x%x)", err);
+	}
 
 	FT_Render_Mode rendermode = FT_RENDER_MODE_NORMAL;
 	if (hinting == HINTING_MONO)
@@ -157,25 +253,104 @@ GlyphData *TrueTypeRasterizer::getGlyphData(uint32 glyph) const
 	// Having copied the data over, we can destroy the glyph.
 	FT_Done_Glyph(ftglyph);
 
+	if (spread > 0 && glyphData->getWidth() > 0 && glyphData->getHeight() > 0)
+	{
+		GlyphData *sdf = nullptr;
+		try
+		{
+			sdf = toDistanceField(glyphData);
+		}
+		catch (love::Exception &)
+		{
+			glyphData->release();
+			throw;
+		}
+
+		glyphData->release();
+		glyphData = sdf;
+	}
+
 	return glyphData;
 }
 
+GlyphData *TrueTypeRasterizer::toDistanceField(const GlyphData *gd) const
+{
+	int srcw = gd->getWidth();
+	int srch = gd->getHeight();
+
+	// The field extends past the outline by the spread on every side.
+	GlyphMetrics metrics = {};
+	metrics.width = srcw + spread * 2;
+	metrics.height = srch + spread * 2;
+	metrics.bearingX = gd->getBearingX() - spread;
+	metrics.bearingY = gd->getBearingY() + spread;
+	metrics.advance = gd->getAdvance();
+
+	int w = metrics.width;
+	int h = metrics.height;
+
+	// Squared distances from each pixel to the nearest one inside the glyph,
+	// and to the nearest one outside of it.
+	std::vector<float> outside(w * h, 1e20f);
+	std::vector<float> inside(w * h, 0.0f);
+
+	const uint8 *src = (const uint8 *) gd->getData();
+
+	for (int y = 0; y < srch; y++)
+	{
+		for (int x = 0; x < srcw; x++)
+		{
+			// Alpha is stored in the second component of LA8 glyphs.
+			if (src[2 * (y * srcw + x) + 1] >= 128)
+			{
+				int i = (y + spread) * w + (x + spread);
+				outside[i] = 0.0f;
+				inside[i] = 1e20f;
+			}
+		}
+	}
+
+	distanceTransform(outside, w, h);
+	distanceTransform(inside, w, h);
+
+	GlyphData *sdf = new GlyphData(gd->getGlyph(), metrics, PIXELFORMAT_LA8);
+	uint8 *dest = (uint8 *) sdf->getData();
+
+	for (int i = 0; i < w * h; i++)
+	{
+		// Pixel centers are half a pixel away from the outline between them.
+		float dist = outside[i] > 0.0f ? sqrtf(outside[i]) - 0.5f : 0.5f - sqrtf(inside[i]);
+
+		// 0.5 is on the outline, and values increase towards the inside.
+		float v = std::min(std::max(0.5f - dist / (spread * 2.0f), 0.0f), 1.0f);
+
+		dest[2 * i + 0] = 255;
+		dest[2 * i + 1] = (uint8) (v * 255.0f + 0.5f);
+	}
+
+	return sdf;
+}
+
 int TrueTypeRasterizer::getGlyphCount() const
 {
-	return (int) face->num_glyphs;
+	return (int) face->face->num_glyphs;
 }
 
 bool TrueTypeRasterizer::hasGlyph(uint32 glyph) const
 {
-	return FT_Get_Char_Index(face, glyph) != 0;
+	thread::Lock lock(face->mutex);
+	return FT_Get_Char_Index(face->face, glyph) != 0;
 }
 
 float TrueTypeRasterizer::getKerning(uint32 leftglyph, uint32 rightglyph) const
 {
+	thread::Lock lock(face->mutex);
+	FT_Activate_Size(ftSize);
+
 	FT_Vector kerning = {};
-	FT_Get_Kerning(face,
-	               FT_Get_Char_Index(face, leftglyph),
-	               FT_Get_Char_Index(face, rightglyph),
+	FT_Get_Kerning(face->face,
+	               FT_Get_Char_Index(face->face, leftglyph),
+	               FT_Get_Char_Index(face->face, rightglyph),
 	               FT_KERNING_DEFAULT,
 	               &kerning);
 	return float(kerning.x >> 6);
@@ -186,6 +361,17 @@ Rasterizer::DataType TrueTypeRasterizer::getDataType() const
 	return DATA_TRUETYPE;
 }
 
+Rasterizer *TrueTypeRasterizer::clone() const
+{
+	// The clone shares the face, which is locked whenever it's used.
+	return new TrueTypeRasterizer(faceCache, data.get(), size, dpiScale, hinting, spread);
+}
+
+int TrueTypeRasterizer::getDistanceFieldSpread() const
+{
+	return spread;
+}
+
 bool TrueTypeRasterizer::accepts(FT_Library library, love::Data *data)
 {
 	const FT_Byte *fbase = (const FT_Byte *) data->getData();
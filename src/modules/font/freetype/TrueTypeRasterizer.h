@@ -24,6 +24,7 @@
 // LOVE
 #include "filesystem/FileData.h"
 #include "font/TrueTypeRasterizer.h"
+#include "FaceCache.h"
 
 // FreeType2
 #include <ft2build.h>
@@ -44,7 +45,11 @@ class TrueTypeRasterizer : public love::font::TrueTypeRasterizer
 {
 public:
 
-	TrueTypeRasterizer(FT_Library library, love::Data *data, int size, float dpiscale, Hinting hinting);
+	/**
+	 * A spread greater than 0 makes the glyphs signed distance fields, with
+	 * that many pixels of distance on either side of the outline.
+	 **/
+	TrueTypeRasterizer(FaceCache *faceCache, love::Data *data, int size, float dpiscale, Hinting hinting, int spread = 0);
 	virtual ~TrueTypeRasterizer();
 
 	// Implement Rasterizer
@@ -54,6 +59,8 @@ public:
 	bool hasGlyph(uint32 glyph) const override;
 	float getKerning(uint32 leftglyph, uint32 rightglyph) const override;
 	DataType getDataType() const override;
+	Rasterizer *clone() const override;
+	int getDistanceFieldSpread() const override;
 
 	static bool accepts(FT_Library library, love::Data *data);
 
@@ -61,14 +68,30 @@ private:
 
 	static FT_UInt hintingToLoadOption(Hinting hinting);
 
-	// TrueType face
-	FT_Face face;
+	void releaseFace();
+
+	GlyphData *toDistanceField(const GlyphData *gd) const;
+
+	FaceCache *faceCache;
+
+	// TrueType face, shared with other rasterizers using the same font data.
+	FaceCache::Face *face;
+
+	// This rasterizer's size on the face. It has to be activated while the
+	// face's mutex is locked before it's used.
+	FT_Size ftSize;
+
+	// The requested size, before the DPI scale is applied.
+	int size;
+	int pixelSize;
 
 	// Font data
 	StrongRef<love::Data> data;
 
 	Hinting hinting;
 
+	int spread;
+
 }; // TrueTypeRasterizer
 
 } // freetype
@@ -28,6 +28,8 @@
 
 #include "filesystem/wrap_Filesystem.h"
 
+#include <algorithm>
+
 namespace love
 {
 namespace font
@@ -132,6 +134,47 @@ static void convimagedata(lua_State *L, int idx)
 		luax_convobj(L, idx, "image", "newImageData");
 }
 
+int w_newDistanceFieldRasterizer(lua_State *L)
+{
+	Rasterizer *t = nullptr;
+	love::Data *d = nullptr;
+	int startidx = 1;
+
+	// A number (or nothing) as the first argument uses the default font.
+	if (lua_type(L, 1) != LUA_TNUMBER && !lua_isnoneornil(L, 1))
+	{
+		if (luax_istype(L, 1, love::Data::type))
+		{
+			d = data::luax_checkdata(L, 1);
+			d->retain();
+		}
+		else
+			d = filesystem::luax_getfiledata(L, 1);
+
+		startidx = 2;
+	}
+
+	// Distance fields are meant to be scaled, so this is a rasterization size
+	// rather than a display size.
+	int size = (int) luaL_optinteger(L, startidx, 32);
+	int spread = (int) luaL_optinteger(L, startidx + 1, std::max(size / 8, 2));
+	float dpiscale = (float) luaL_optnumber(L, startidx + 2, 1.0);
+
+	if (d == nullptr)
+		luax_catchexcept(L, [&](){ t = instance()->newDistanceFieldRasterizer(size, spread, dpiscale); });
+	else
+	{
+		luax_catchexcept(L,
+			[&]() { t = instance()->newDistanceFieldRasterizer(d, size, spread, dpiscale); },
+			[&](bool) { d->release(); }
+		);
+	}
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
 int w_newBMFontRasterizer(lua_State *L)
 {
 	Rasterizer *t = nullptr;
@@ -139,8 +182,13 @@ int w_newBMFontRasterizer(lua_State *L)
 	filesystem::FileData *d = filesystem::luax_getfiledata(L, 1);
 	std::vector<image::ImageData *> images;
 	float dpiscale = (float) luaL_optnumber(L, 3, 1.0);
+	bool backgrounddecode = luax_optboolean(L, 4, false);
 
-	if (lua_istable(L, 2))
+	if (lua_isnoneornil(L, 2))
+	{
+		// The pages are loaded from the files the font definition refers to.
+	}
+	else if (lua_istable(L, 2))
 	{
 		for (int i = 1; i <= (int) luax_objlen(L, 2); i++)
 		{
@@ -163,7 +211,7 @@ int w_newBMFontRasterizer(lua_State *L)
 	}
 
 	luax_catchexcept(L,
-		[&]() { t = instance()->newBMFontRasterizer(d, images, dpiscale); },
+		[&]() { t = instance()->newBMFontRasterizer(d, images, dpiscale, backgrounddecode); },
 		[&](bool) { d->release(); for (auto id : images) id->release(); }
 	);
 
@@ -217,6 +265,7 @@ static const luaL_Reg functions[] =
 {
 	{ "newRasterizer",  w_newRasterizer },
 	{ "newTrueTypeRasterizer", w_newTrueTypeRasterizer },
+	{ "newDistanceFieldRasterizer", w_newDistanceFieldRasterizer },
 	{ "newBMFontRasterizer", w_newBMFontRasterizer },
 	{ "newImageRasterizer", w_newImageRasterizer },
 	{ "newGlyphData",  w_newGlyphData },
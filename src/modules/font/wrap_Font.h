@@ -32,6 +32,7 @@ namespace font
 
 int w_newRasterizer(lua_State *L);
 int w_newTrueTypeRasterizer(lua_State *L);
+int w_newDistanceFieldRasterizer(lua_State *L);
 int w_newBMFontRasterizer(lua_State *L);
 int w_newImageRasterizer(lua_State *L);
 int w_newGlyphData(lua_State *L);
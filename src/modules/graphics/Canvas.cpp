@@ -31,6 +31,8 @@ int Canvas::canvasCount = 0;
 
 Canvas::Canvas(const Settings &settings)
 	: Texture(settings.type)
+	, activeMipmapCount(1)
+	, mipmapsDirty(false)
 {
 	this->settings = settings;
 
@@ -71,6 +73,8 @@ Canvas::Canvas(const Settings &settings)
 		filter.mipmap = defaultMipmapFilter;
 	}
 
+	activeMipmapCount = mipmapCount;
+
 	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
 	const Graphics::Capabilities &caps = gfx->getCapabilities();
 
@@ -117,6 +121,35 @@ int Canvas::getRequestedMSAA() const
 	return settings.msaa;
 }
 
+void Canvas::setMipmapsDirty(bool dirty)
+{
+	mipmapsDirty = dirty && getMipmapMode() == MIPMAPS_AUTO;
+}
+
+bool Canvas::isMipmapsDirty() const
+{
+	return mipmapsDirty;
+}
+
+bool Canvas::resolveMipmaps(bool force)
+{
+	if (!mipmapsDirty)
+		return false;
+
+	// The mip chain isn't touched when sampling only reads the base level.
+	if (!force && filter.mipmap == FILTER_NONE)
+		return false;
+
+	generateMipmaps();
+	mipmapsDirty = false;
+	return true;
+}
+
+int Canvas::getActiveMipmapCount() const
+{
+	return activeMipmapCount;
+}
+
 love::image::ImageData *Canvas::newImageData(love::image::Image *module, int slice, int mipmap, const Rect &r)
 {
 	if (!isReadable())
@@ -164,20 +197,20 @@ love::image::ImageData *Canvas::newImageData(love::image::Image *module, int sli
 	return module->newImageData(r.w, r.h, dataformat);
 }
 
-void Canvas::draw(Graphics *gfx, Quad *q, const Matrix4 &t)
+void Canvas::drawQuad(Graphics *gfx, const Vector2 *positions, const Vector2 *texcoords, int layer, const Matrix4 &t)
 {
 	if (gfx->isCanvasActive(this))
 		throw love::Exception("Cannot render a Canvas to itself!");
 
-	Texture::draw(gfx, q, t);
+	Texture::drawQuad(gfx, positions, texcoords, layer, t);
 }
 
-void Canvas::drawLayer(Graphics *gfx, int layer, Quad *quad, const Matrix4 &m)
+void Canvas::drawQuadLayer(Graphics *gfx, int layer, const Vector2 *positions, const Vector2 *texcoords, const Matrix4 &m)
 {
 	if (gfx->isCanvasActive(this, layer))
 		throw love::Exception("Cannot render a Canvas to itself!");
 
-	Texture::drawLayer(gfx, layer, quad, m);
+	Texture::drawQuadLayer(gfx, layer, positions, texcoords, m);
 }
 
 bool Canvas::getConstant(const char *in, MipmapMode &out)
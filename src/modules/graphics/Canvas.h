@@ -23,6 +23,7 @@
 #include "image/Image.h"
 #include "image/ImageData.h"
 #include "Texture.h"
+#include "GraphicsReadback.h"
 #include "common/Optional.h"
 #include "common/StringMap.h"
 
@@ -81,14 +82,39 @@ public:
 	int getRequestedMSAA() const;
 
 	virtual love::image::ImageData *newImageData(love::image::Image *module, int slice, int mipmap, const Rect &rect);
+
+	/**
+	 * Like newImageData, but doesn't wait for the GPU to finish rendering to
+	 * the Canvas. The returned readback delivers the ImageData later.
+	 **/
+	virtual GraphicsReadback *newReadback(love::image::Image *module, int slice, int mipmap, const Rect &rect) = 0;
 	virtual void generateMipmaps() = 0;
 
+	/**
+	 * Auto mipmaps aren't regenerated as soon as the base level is rendered
+	 * to. They're flagged as stale instead, and rebuilt by resolveMipmaps the
+	 * next time the Canvas is sampled or one of its mip levels is read.
+	 **/
+	void setMipmapsDirty(bool dirty);
+	bool isMipmapsDirty() const;
+
+	/**
+	 * Regenerates stale mipmaps. Unless force is true, sampling which only
+	 * uses the base level (no mipmap filter) leaves them stale. Returns
+	 * whether the mipmaps were regenerated.
+	 **/
+	bool resolveMipmaps(bool force);
+
+	/**
+	 * Limits sampling and mipmap generation to the first count mip levels, so
+	 * unused small levels don't have to be regenerated.
+	 **/
+	virtual void setActiveMipmapCount(int count) = 0;
+	int getActiveMipmapCount() const;
+
 	virtual int getMSAA() const = 0;
 	virtual ptrdiff_t getRenderTargetHandle() const = 0;
 
-	void draw(Graphics *gfx, Quad *q, const Matrix4 &t) override;
-	void drawLayer(Graphics *gfx, int layer, Quad *q, const Matrix4 &t) override;
-
 	static int canvasCount;
 
 	static bool getConstant(const char *in, MipmapMode &out);
@@ -102,8 +128,14 @@ public:
 
 protected:
 
+	void drawQuad(Graphics *gfx, const Vector2 *positions, const Vector2 *texcoords, int layer, const Matrix4 &t) override;
+	void drawQuadLayer(Graphics *gfx, int layer, const Vector2 *positions, const Vector2 *texcoords, const Matrix4 &t) override;
+
 	Settings settings;
 
+	int activeMipmapCount;
+	bool mipmapsDirty;
+
 private:
 
 	static StringMap<MipmapMode, MIPMAPS_MAX_ENUM>::Entry mipmapEntries[];
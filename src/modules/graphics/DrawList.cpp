@@ -0,0 +1,255 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "DrawList.h"
+#include "Graphics.h"
+
+// C++
+#include <algorithm>
+#include <cstring>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type DrawList::type("DrawList", &Drawable::type);
+
+DrawList::DrawList()
+	: color(1.0f, 1.0f, 1.0f, 1.0f)
+	, count(0)
+{
+}
+
+DrawList::~DrawList()
+{
+}
+
+DrawList::Command &DrawList::addCommand(CommandType type, Texture *texture, int vertexcount)
+{
+	// Consecutive sprites which use the same texture become a single command,
+	// so they end up in the same stream draw request when the list is drawn.
+	if (type == COMMAND_QUADS && !commands.empty())
+	{
+		Command &last = commands.back();
+		if (last.type == COMMAND_QUADS && last.texture.get() == texture)
+		{
+			last.vertexCount += vertexcount;
+			count++;
+			return last;
+		}
+	}
+
+	Command cmd;
+	cmd.type = type;
+	cmd.texture.set(texture);
+	cmd.vertexStart = (int) positions.size();
+	cmd.vertexCount = vertexcount;
+
+	commands.push_back(cmd);
+	count++;
+
+	return commands.back();
+}
+
+void DrawList::add(Texture *texture, Quad *quad, const Matrix4 &m)
+{
+	if (!texture->isReadable())
+		throw love::Exception("Textures with non-readable formats cannot be drawn.");
+
+	if (texture->getTextureType() != TEXTURE_2D)
+		throw love::Exception("Only 2D textures can be added to a DrawList.");
+
+	if (quad == nullptr)
+		quad = texture->getQuad();
+
+	thread::Lock lock(mutex);
+
+	addCommand(COMMAND_QUADS, texture, 4);
+
+	size_t start = positions.size();
+	positions.resize(start + 4);
+	attributes.resize(start + 4);
+
+	m.transformXY(&positions[start], quad->getVertexPositions(), 4);
+
+	const Vector2 *texcoords = quad->getVertexTexCoords();
+	Color c = toColor(color);
+
+	for (int i = 0; i < 4; i++)
+	{
+		vertex::STf_RGBAub &v = attributes[start + i];
+		v.s = texcoords[i].x;
+		v.t = texcoords[i].y;
+		v.color = c;
+	}
+}
+
+void DrawList::polygon(const Vector2 *coords, size_t count, const Matrix4 &m)
+{
+	if (count < 3)
+		throw love::Exception("Need at least three vertices to draw a polygon.");
+
+	if (count > LOVE_UINT16_MAX)
+		throw love::Exception("Too many vertices in polygon (maximum is %d).", LOVE_UINT16_MAX);
+
+	thread::Lock lock(mutex);
+
+	addCommand(COMMAND_POLYGON, nullptr, (int) count);
+
+	size_t start = positions.size();
+	positions.resize(start + count);
+	attributes.resize(start + count);
+
+	m.transformXY(&positions[start], coords, (int) count);
+
+	Color c = toColor(color);
+
+	for (size_t i = start; i < start + count; i++)
+	{
+		attributes[i].s = 0.0f;
+		attributes[i].t = 0.0f;
+		attributes[i].color = c;
+	}
+}
+
+void DrawList::rectangle(float x, float y, float w, float h, const Matrix4 &m)
+{
+	Vector2 coords[] = {
+		Vector2(x, y),
+		Vector2(x, y+h),
+		Vector2(x+w, y+h),
+		Vector2(x+w, y),
+	};
+
+	polygon(coords, 4, m);
+}
+
+void DrawList::addMesh(Mesh *mesh, const Matrix4 &m)
+{
+	thread::Lock lock(mutex);
+
+	Command &cmd = addCommand(COMMAND_MESH, nullptr, 0);
+	cmd.mesh.set(mesh);
+	cmd.transform = m;
+}
+
+void DrawList::setColor(const Colorf &color)
+{
+	thread::Lock lock(mutex);
+	this->color = color;
+}
+
+Colorf DrawList::getColor() const
+{
+	thread::Lock lock(mutex);
+	return color;
+}
+
+void DrawList::clear()
+{
+	thread::Lock lock(mutex);
+
+	commands.clear();
+	positions.clear();
+	attributes.clear();
+	count = 0;
+}
+
+int DrawList::getCount() const
+{
+	thread::Lock lock(mutex);
+	return count;
+}
+
+int DrawList::getVertexCount() const
+{
+	thread::Lock lock(mutex);
+	return (int) positions.size();
+}
+
+void DrawList::draw(Graphics *gfx, const Matrix4 &m)
+{
+	using namespace vertex;
+
+	thread::Lock lock(mutex);
+
+	const Matrix4 &tm = gfx->getTransform();
+	bool is2D = tm.isAffine2DTransform();
+
+	Matrix4 t(tm, m);
+
+	Colorf gcolor = gfx->getColor();
+	bool tinted = gcolor != Colorf(1.0f, 1.0f, 1.0f, 1.0f);
+
+	// Each request has to stay within the range of uint16 indices.
+	const int maxquadvertices = (LOVE_UINT16_MAX / 4) * 4;
+
+	for (const Command &c : commands)
+	{
+		if (c.type == COMMAND_MESH)
+		{
+			c.mesh->draw(gfx, Matrix4(m, c.transform));
+			continue;
+		}
+
+		int maxvertices = c.type == COMMAND_QUADS ? maxquadvertices : c.vertexCount;
+		int end = c.vertexStart + c.vertexCount;
+
+		for (int start = c.vertexStart; start < end; start += maxvertices)
+		{
+			Graphics::StreamDrawCommand cmd;
+			cmd.formats[0] = getSinglePositionFormat(is2D);
+			cmd.formats[1] = CommonFormat::STf_RGBAub;
+			cmd.indexMode = c.type == COMMAND_QUADS ? TriangleIndexMode::QUADS : TriangleIndexMode::FAN;
+			cmd.vertexCount = std::min(end - start, maxvertices);
+			cmd.texture = c.texture.get();
+
+			Graphics::StreamVertexData data = gfx->requestStreamDraw(cmd);
+
+			if (is2D)
+				t.transformXY((Vector2 *) data.stream[0], &positions[start], cmd.vertexCount);
+			else
+				t.transformXY0((Vector3 *) data.stream[0], &positions[start], cmd.vertexCount);
+
+			STf_RGBAub *vertexdata = (STf_RGBAub *) data.stream[1];
+
+			if (!tinted)
+				memcpy(vertexdata, &attributes[start], sizeof(STf_RGBAub) * cmd.vertexCount);
+			else
+			{
+				for (int i = 0; i < cmd.vertexCount; i++)
+				{
+					const STf_RGBAub &src = attributes[start + i];
+					Colorf vc = toColorf(src.color);
+					vc *= gcolor;
+
+					vertexdata[i].s = src.s;
+					vertexdata[i].t = src.t;
+					vertexdata[i].color = toColor(vc);
+				}
+			}
+		}
+	}
+}
+
+} // graphics
+} // love
@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_GRAPHICS_DRAW_LIST_H
+#define LOVE_GRAPHICS_DRAW_LIST_H
+
+// LOVE
+#include "common/config.h"
+#include "common/Color.h"
+#include "common/Matrix.h"
+#include "common/Vector.h"
+#include "thread/threads.h"
+#include "Drawable.h"
+#include "Texture.h"
+#include "Quad.h"
+#include "Mesh.h"
+#include "vertex.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+class Graphics;
+
+/**
+ * A DrawList records sprite, shape and mesh draws into CPU memory, so it can
+ * be filled from any thread. Drawing it (which must happen on the main thread)
+ * submits the recorded geometry straight into the stream draw buffers, with
+ * consecutive draws that share a texture merged into a single request.
+ **/
+class DrawList : public Drawable
+{
+public:
+
+	static love::Type type;
+
+	DrawList();
+	virtual ~DrawList();
+
+	void add(Texture *texture, Quad *quad, const Matrix4 &m);
+	void polygon(const Vector2 *coords, size_t count, const Matrix4 &m);
+	void rectangle(float x, float y, float w, float h, const Matrix4 &m);
+	void addMesh(Mesh *mesh, const Matrix4 &m);
+
+	void setColor(const Colorf &color);
+	Colorf getColor() const;
+
+	void clear();
+
+	int getCount() const;
+	int getVertexCount() const;
+
+	// Implements Drawable.
+	void draw(Graphics *gfx, const Matrix4 &m) override;
+
+private:
+
+	enum CommandType
+	{
+		COMMAND_QUADS,
+		COMMAND_POLYGON,
+		COMMAND_MESH,
+	};
+
+	struct Command
+	{
+		CommandType type;
+		StrongRef<Texture> texture;
+		StrongRef<Mesh> mesh;
+		Matrix4 transform;
+		int vertexStart;
+		int vertexCount;
+	};
+
+	Command &addCommand(CommandType type, Texture *texture, int vertexcount);
+
+	std::vector<Command> commands;
+
+	// Positions are stored already transformed by the local transform given
+	// when the draw was recorded.
+	std::vector<Vector2> positions;
+	std::vector<vertex::STf_RGBAub> attributes;
+
+	Colorf color;
+	int count;
+
+	thread::MutexRef mutex;
+
+}; // DrawList
+
+} // graphics
+} // love
+
+#endif // LOVE_GRAPHICS_DRAW_LIST_H
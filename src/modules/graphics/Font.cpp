@@ -22,16 +22,27 @@
 #include "font/GlyphData.h"
 
 #include "libraries/utf8/utf8.h"
+#include "libraries/xxHash/xxhash.h"
 
 #include "common/math.h"
 #include "common/Matrix.h"
+#include "common/profiling.h"
+#include "thread/WorkerPool.h"
 #include "Graphics.h"
 
 #include <math.h>
-#include <sstream>
+#include <string.h>
 #include <algorithm> // for max
 #include <limits>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LOVE_FONT_UTF8_SSE2
+#include <emmintrin.h>
+#elif defined(LOVE_SIMD_NEON) && defined(__aarch64__)
+#define LOVE_FONT_UTF8_NEON
+#include <arm_neon.h>
+#endif
+
 namespace love
 {
 namespace graphics
@@ -42,9 +53,160 @@ static inline uint16 normToUint16(double n)
 	return (uint16) (n * LOVE_UINT16_MAX);
 }
 
+// Uses the first Rasterizer (the font or one of its fallbacks) with the glyph.
+static love::font::GlyphData *getGlyphData(const std::vector<StrongRef<love::font::Rasterizer>> &rasterizers, uint32 glyph)
+{
+	for (const StrongRef<love::font::Rasterizer> &r : rasterizers)
+	{
+		if (r->hasGlyph(glyph))
+			return r->getGlyphData(glyph);
+	}
+
+	return rasterizers[0]->getGlyphData(glyph);
+}
+
+// Copies the ASCII bytes at the start of src to dst as codepoints, 16 bytes at
+// a time. Returns the number of bytes copied, which is a multiple of 16.
+static size_t decodeASCIIRun(const uint8 *src, size_t len, uint32 *dst)
+{
+	size_t i = 0;
+
+#if defined(LOVE_FONT_UTF8_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+
+	for (; i + 16 <= len; i += 16)
+	{
+		__m128i bytes = _mm_loadu_si128((const __m128i *) (src + i));
+		if (_mm_movemask_epi8(bytes) != 0)
+			break;
+
+		__m128i lo = _mm_unpacklo_epi8(bytes, zero);
+		__m128i hi = _mm_unpackhi_epi8(bytes, zero);
+
+		_mm_storeu_si128((__m128i *) (dst + i +  0), _mm_unpacklo_epi16(lo, zero));
+		_mm_storeu_si128((__m128i *) (dst + i +  4), _mm_unpackhi_epi16(lo, zero));
+		_mm_storeu_si128((__m128i *) (dst + i +  8), _mm_unpacklo_epi16(hi, zero));
+		_mm_storeu_si128((__m128i *) (dst + i + 12), _mm_unpackhi_epi16(hi, zero));
+	}
+#elif defined(LOVE_FONT_UTF8_NEON)
+	for (; i + 16 <= len; i += 16)
+	{
+		uint8x16_t bytes = vld1q_u8(src + i);
+		if (vmaxvq_u8(bytes) >= 0x80)
+			break;
+
+		uint16x8_t lo = vmovl_u8(vget_low_u8(bytes));
+		uint16x8_t hi = vmovl_high_u8(bytes);
+
+		vst1q_u32(dst + i +  0, vmovl_u16(vget_low_u16(lo)));
+		vst1q_u32(dst + i +  4, vmovl_high_u16(lo));
+		vst1q_u32(dst + i +  8, vmovl_u16(vget_low_u16(hi)));
+		vst1q_u32(dst + i + 12, vmovl_high_u16(hi));
+	}
+#else
+	for (; i + 16 <= len; i += 16)
+	{
+		uint64 words[2];
+		memcpy(words, src + i, sizeof(words));
+		if (((words[0] | words[1]) & 0x8080808080808080ULL) != 0)
+			break;
+
+		for (size_t j = 0; j < 16; j++)
+			dst[i + j] = src[i + j];
+	}
+#endif
+
+	return i;
+}
+
+// Decodes and validates UTF-8 text. dst must have room for len codepoints.
+// Returns the number of codepoints written.
+static size_t decodeUTF8(const uint8 *src, size_t len, uint32 *dst)
+{
+	size_t i = 0;
+	size_t count = 0;
+
+	while (i < len)
+	{
+		size_t ascii = decodeASCIIRun(src + i, len - i, dst + count);
+		i += ascii;
+		count += ascii;
+
+		// Finish the rest of the block one character at a time.
+		size_t blockend = std::min(len, i + 16);
+
+		while (i < blockend)
+		{
+			uint32 c = src[i++];
+
+			if (c < 0x80)
+			{
+				dst[count++] = c;
+				continue;
+			}
+
+			int extra = 0;
+			uint32 mincodepoint = 0;
+
+			if ((c & 0xE0) == 0xC0)
+			{
+				extra = 1;
+				c &= 0x1F;
+				mincodepoint = 0x80;
+			}
+			else if ((c & 0xF0) == 0xE0)
+			{
+				extra = 2;
+				c &= 0x0F;
+				mincodepoint = 0x800;
+			}
+			else if ((c & 0xF8) == 0xF0)
+			{
+				extra = 3;
+				c &= 0x07;
+				mincodepoint = 0x10000;
+			}
+			else
+				throw love::Exception("UTF-8 decoding error: Invalid UTF-8");
+
+			if (len - i < (size_t) extra)
+				throw love::Exception("UTF-8 decoding error: Not enough space");
+
+			for (int j = 0; j < extra; j++)
+			{
+				uint32 b = src[i++];
+				if ((b & 0xC0) != 0x80)
+					throw love::Exception("UTF-8 decoding error: Invalid UTF-8");
+
+				c = (c << 6) | (b & 0x3F);
+			}
+
+			// Overlong encodings, surrogates and out-of-range values.
+			if (c < mincodepoint || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF))
+				throw love::Exception("UTF-8 decoding error: Invalid UTF-8");
+
+			dst[count++] = c;
+		}
+	}
+
+	return count;
+}
+
 love::Type Font::type("Font", &Object::type);
 int Font::fontCount = 0;
 
+Font::GlyphBatch::GlyphBatch(Font *font)
+	: font(font)
+{
+	if (font->glyphBatchDepth++ == 0)
+		font->glyphUseCounter++;
+}
+
+Font::GlyphBatch::~GlyphBatch()
+{
+	font->glyphBatchDepth--;
+}
+
 const vertex::CommonFormat Font::vertexFormat = vertex::CommonFormat::XYf_STus_RGBAub;
 
 Font::Font(love::font::Rasterizer *r, const Texture::Filter &f)
@@ -57,6 +219,11 @@ Font::Font(love::font::Rasterizer *r, const Texture::Filter &f)
 	, dpiScale(r->getDPIScale())
 	, useSpacesAsTab(false)
 	, textureCacheID(0)
+	, glyphEvictionID(0)
+	, glyphUseCounter(0)
+	, glyphBatchDepth(0)
+	, usedGlyphPlaceholders(false)
+	, layoutCacheTextureID(0)
 {
 	filter.mipmap = Texture::FILTER_NONE;
 
@@ -89,6 +256,7 @@ Font::Font(love::font::Rasterizer *r, const Texture::Filter &f)
 
 Font::~Font()
 {
+	cancelGlyphPrefetch();
 	--fontCount;
 }
 
@@ -123,7 +291,7 @@ bool Font::loadVolatile()
 {
 	textureCacheID++;
 	glyphs.clear();
-	images.clear();
+	texturePages.clear();
 	createTexture();
 	return true;
 }
@@ -141,11 +309,30 @@ void Font::createTexture()
 	// If we have an existing texture already, we'll try replacing it with a
 	// larger-sized one rather than creating a second one. Having a single
 	// texture reduces texture switches and draw calls when rendering.
-	if ((nextsize.width > size.width || nextsize.height > size.height) && !images.empty())
+	if ((nextsize.width > size.width || nextsize.height > size.height) && !texturePages.empty())
 	{
 		recreatetexture = true;
 		size = nextsize;
-		images.pop_back();
+		texturePages.pop_back();
+	}
+	else if ((int) texturePages.size() >= MAX_TEXTURE_PAGES)
+	{
+		// Evict the least recently used page instead of adding another one,
+		// unless all of them are in use by the text currently being generated.
+		int lruindex = -1;
+
+		for (int i = 0; i < (int) texturePages.size(); i++)
+		{
+			const TexturePage &page = texturePages[i];
+			if (page.lastUsed == glyphUseCounter)
+				continue;
+
+			if (lruindex < 0 || page.lastUsed < texturePages[lruindex].lastUsed)
+				lruindex = i;
+		}
+
+		if (lruindex >= 0)
+			return evictTexturePage(lruindex);
 	}
 
 	Image::Settings settings;
@@ -159,13 +346,17 @@ void Font::createTexture()
 	Rect rect = {0, 0, size.width, size.height};
 	image->replacePixels(emptydata.data(), emptydata.size(), 0, 0, rect, false);
 
-	images.emplace_back(image, Acquire::NORETAIN);
+	TexturePage page;
+	page.image.set(image, Acquire::NORETAIN);
+	page.nextShelfY = TEXTURE_PADDING;
+	page.lastUsed = glyphUseCounter;
+	page.evictionID = 0;
+
+	texturePages.push_back(page);
 
 	textureWidth  = size.width;
 	textureHeight = size.height;
 
-	rowHeight = textureX = textureY = TEXTURE_PADDING;
-
 	// Re-add the old glyphs if we re-created the existing texture object.
 	if (recreatetexture)
 	{
@@ -183,10 +374,81 @@ void Font::createTexture()
 	}
 }
 
+void Font::evictTexturePage(int index)
+{
+	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
+	gfx->flushStreamDraws();
+
+	TexturePage &page = texturePages[index];
+
+	for (auto it = glyphs.begin(); it != glyphs.end(); )
+	{
+		if (it->second.page == index)
+			it = glyphs.erase(it);
+		else
+			++it;
+	}
+
+	// Clear the used part of the page, so the transparent padding around new
+	// glyphs doesn't pick up pieces of old ones.
+	size_t bpp = getPixelFormatSize(pixelFormat);
+	std::vector<uint8> emptydata(textureWidth * page.nextShelfY * bpp, 0);
+
+	Rect rect = {0, 0, textureWidth, page.nextShelfY};
+	page.image->replacePixels(emptydata.data(), emptydata.size(), 0, 0, rect, false);
+
+	page.shelves.clear();
+	page.nextShelfY = TEXTURE_PADDING;
+	page.lastUsed = glyphUseCounter;
+	page.evictionID = ++glyphEvictionID;
+
+	// Cached layouts can reference the evicted glyphs.
+	clearLayoutCache();
+}
+
+bool Font::packGlyph(TexturePage &page, int w, int h, int &x, int &y) const
+{
+	int paddedw = w + TEXTURE_PADDING;
+	int paddedh = h + TEXTURE_PADDING;
+
+	TextureShelf *best = nullptr;
+
+	// Use the shelf with the least wasted height which still has room.
+	for (TextureShelf &shelf : page.shelves)
+	{
+		if (shelf.height < paddedh || shelf.x + paddedw > textureWidth)
+			continue;
+
+		if (best == nullptr || shelf.height < best->height)
+			best = &shelf;
+	}
+
+	bool hasroom = page.nextShelfY + paddedh <= textureHeight;
+
+	// Start a new shelf if there's no fitting one, or if the best one would
+	// waste a lot of space.
+	if (hasroom && (best == nullptr || best->height > paddedh + paddedh / 2))
+	{
+		page.shelves.push_back({TEXTURE_PADDING, page.nextShelfY, paddedh});
+		page.nextShelfY += paddedh;
+		best = &page.shelves.back();
+	}
+
+	if (best == nullptr)
+		return false;
+
+	x = best->x;
+	y = best->y;
+	best->x += paddedw;
+
+	return true;
+}
+
 void Font::unloadVolatile()
 {
+	clearLayoutCache();
 	glyphs.clear();
-	images.clear();
+	texturePages.clear();
 }
 
 love::font::GlyphData *Font::getRasterizerGlyphData(uint32 glyph)
@@ -207,54 +469,75 @@ love::font::GlyphData *Font::getRasterizerGlyphData(uint32 glyph)
 		return new love::font::GlyphData(glyph, gm, fmt);
 	}
 
-	for (const StrongRef<love::font::Rasterizer> &r : rasterizers)
-	{
-		if (r->hasGlyph(glyph))
-			return r->getGlyphData(glyph);
-	}
-
-	return rasterizers[0]->getGlyphData(glyph);
+	return getGlyphData(rasterizers, glyph);
 }
 
 const Font::Glyph &Font::addGlyph(uint32 glyph)
 {
 	StrongRef<love::font::GlyphData> gd(getRasterizerGlyphData(glyph), Acquire::NORETAIN);
+	return addGlyph(glyph, gd);
+}
+
+const Font::Glyph &Font::addGlyph(uint32 glyph, love::font::GlyphData *gd)
+{
+	LOVE_PROFILE_ZONE("Font:addGlyph");
 
 	int w = gd->getWidth();
 	int h = gd->getHeight();
 
-	if (w + TEXTURE_PADDING * 2 < textureWidth && h + TEXTURE_PADDING * 2 < textureHeight)
+	int page = -1;
+	int textureX = 0, textureY = 0;
+
+	// Don't waste space for empty glyphs.
+	if (w > 0 && h > 0)
 	{
-		if (textureX + w + TEXTURE_PADDING > textureWidth)
+		if (w + TEXTURE_PADDING * 2 > textureWidth || h + TEXTURE_PADDING * 2 > textureHeight)
 		{
-			// Out of space - new row!
-			textureX = TEXTURE_PADDING;
-			textureY += rowHeight;
-			rowHeight = TEXTURE_PADDING;
+			TextureSize nextsize = getNextTextureSize();
+			if (nextsize.width <= textureWidth && nextsize.height <= textureHeight)
+				throw love::Exception("Glyph %u is too large to fit in the font's texture.", glyph);
+
+			// Grow the texture until the glyph fits.
+			createTexture();
+			return addGlyph(glyph, gd);
 		}
 
-		if (textureY + h + TEXTURE_PADDING > textureHeight)
+		// Newer pages are the most likely to have room.
+		for (int i = (int) texturePages.size() - 1; i >= 0; i--)
 		{
-			// Totally out of space - new texture!
+			if (packGlyph(texturePages[i], w, h, textureX, textureY))
+			{
+				page = i;
+				break;
+			}
+		}
+
+		if (page < 0)
+		{
+			// Totally out of space - bigger texture, new texture, or evicted
+			// texture page!
 			createTexture();
 
-			// Makes sure the above code for checking if the glyph can fit at
-			// the current position in the texture is run again for this glyph.
-			return addGlyph(glyph);
+			// Makes sure the above code for finding space for the glyph is run
+			// again.
+			return addGlyph(glyph, gd);
 		}
 	}
 
 	Glyph g;
 
 	g.texture = 0;
+	g.page = page;
 	g.spacing = floorf(gd->getAdvance() / dpiScale + 0.5f);
 
 	memset(g.vertices, 0, sizeof(GlyphVertex) * 4);
 
-	// Don't waste space for empty glyphs.
-	if (w > 0 && h > 0)
+	if (page >= 0)
 	{
-		Image *image = images.back();
+		TexturePage &texpage = texturePages[page];
+		texpage.lastUsed = glyphUseCounter;
+
+		Image *image = texpage.image;
 		g.texture = image;
 
 		Rect rect = {textureX, textureY, gd->getWidth(), gd->getHeight()};
@@ -288,25 +571,186 @@ const Font::Glyph &Font::addGlyph(uint32 glyph)
 			g.vertices[i].x += gd->getBearingX() / dpiScale;
 			g.vertices[i].y -= gd->getBearingY() / dpiScale;
 		}
-
-		textureX += w + TEXTURE_PADDING;
-		rowHeight = std::max(rowHeight, h + TEXTURE_PADDING);
 	}
 
 	glyphs[glyph] = g;
 	return glyphs[glyph];
 }
 
-const Font::Glyph &Font::findGlyph(uint32 glyph)
+const Font::Glyph &Font::findGlyph(uint32 glyph, bool placeholder)
 {
 	const auto it = glyphs.find(glyph);
 
 	if (it != glyphs.end())
+	{
+		if (it->second.page >= 0)
+			texturePages[it->second.page].lastUsed = glyphUseCounter;
+
 		return it->second;
+	}
+
+	// Prefetched glyphs which aren't ready yet are drawn as blank spaces.
+	if (placeholder && pendingGlyphs.count(glyph) != 0)
+	{
+		usedGlyphPlaceholders = true;
+		return findGlyph(32);
+	}
 
 	return addGlyph(glyph);
 }
 
+void Font::prefetchGlyphs(const Codepoints &codepoints)
+{
+	if (glyphPrefetch.get() == nullptr)
+	{
+		std::vector<StrongRef<love::font::Rasterizer>> clones;
+
+		for (const StrongRef<love::font::Rasterizer> &r : rasterizers)
+		{
+			love::font::Rasterizer *clone = r->clone();
+			if (clone == nullptr)
+			{
+				clones.clear();
+				break;
+			}
+
+			clones.emplace_back(clone, Acquire::NORETAIN);
+		}
+
+		if (clones.empty())
+		{
+			for (uint32 g : codepoints)
+				findGlyph(g);
+			return;
+		}
+
+		glyphPrefetch.reset(new GlyphPrefetch());
+		glyphPrefetch->rasterizers = clones;
+	}
+
+	GlyphPrefetch *state = glyphPrefetch.get();
+
+	thread::Lock lock(state->mutex);
+
+	for (uint32 g : codepoints)
+	{
+		// Tabs made from spaces don't go through the Rasterizers.
+		if (g == 9 && useSpacesAsTab)
+			continue;
+
+		if (glyphs.count(g) != 0 || pendingGlyphs.count(g) != 0)
+			continue;
+
+		pendingGlyphs.insert(g);
+		state->queued.push_back(g);
+	}
+
+	if (state->running || state->queued.empty())
+		return;
+
+	state->running = true;
+
+	// The Font's destructor waits for the task, and the clones are only
+	// released on the main thread along with the state.
+	thread::WorkerPool::getShared().submit([state]()
+	{
+		while (true)
+		{
+			uint32 glyph = 0;
+
+			{
+				thread::Lock lock(state->mutex);
+
+				if (state->cancelled || state->queued.empty())
+				{
+					state->running = false;
+					state->cond->broadcast();
+					return;
+				}
+
+				glyph = state->queued.back();
+				state->queued.pop_back();
+			}
+
+			// Failed glyphs are dropped here, and rasterized again (and the
+			// error reported) when they're drawn.
+			StrongRef<love::font::GlyphData> gd;
+			try
+			{
+				gd.set(getGlyphData(state->rasterizers, glyph), Acquire::NORETAIN);
+			}
+			catch (love::Exception &)
+			{
+			}
+
+			thread::Lock lock(state->mutex);
+			state->finished.emplace_back(glyph, gd);
+		}
+	});
+}
+
+bool Font::isPrefetchingGlyphs() const
+{
+	return !pendingGlyphs.empty();
+}
+
+void Font::addPrefetchedGlyphs()
+{
+	if (pendingGlyphs.empty())
+		return;
+
+	std::vector<std::pair<uint32, StrongRef<love::font::GlyphData>>> finished;
+
+	{
+		thread::Lock lock(glyphPrefetch->mutex);
+		finished.swap(glyphPrefetch->finished);
+	}
+
+	if (finished.empty())
+		return;
+
+	for (const auto &result : finished)
+	{
+		pendingGlyphs.erase(result.first);
+
+		if (result.second.get() != nullptr && glyphs.find(result.first) == glyphs.end())
+			addGlyph(result.first, result.second.get());
+	}
+
+	// Vertices generated with placeholders (for example by Text objects) need
+	// to be generated again.
+	if (usedGlyphPlaceholders)
+	{
+		textureCacheID++;
+		usedGlyphPlaceholders = !pendingGlyphs.empty();
+	}
+}
+
+void Font::cancelGlyphPrefetch()
+{
+	if (glyphPrefetch.get() == nullptr)
+		return;
+
+	{
+		GlyphPrefetch &state = *glyphPrefetch;
+
+		thread::Lock lock(state.mutex);
+		state.cancelled = true;
+
+		while (state.running)
+			state.cond->wait(state.mutex);
+	}
+
+	glyphPrefetch.reset();
+	pendingGlyphs.clear();
+
+	if (usedGlyphPlaceholders)
+	{
+		textureCacheID++;
+		usedGlyphPlaceholders = false;
+	}
+}
+
 float Font::getKerning(uint32 leftglyph, uint32 rightglyph)
 {
 	uint64 packedglyphs = ((uint64) leftglyph << 32) | (uint64) rightglyph;
@@ -332,23 +776,26 @@ float Font::getKerning(uint32 leftglyph, uint32 rightglyph)
 
 void Font::getCodepointsFromString(const std::string &text, Codepoints &codepoints)
 {
-	codepoints.reserve(text.size());
+	if (text.empty())
+		return;
+
+	// There's never more than one codepoint per byte.
+	size_t start = codepoints.size();
+	codepoints.resize(start + text.size());
+
+	size_t count = 0;
 
 	try
 	{
-		utf8::iterator<std::string::const_iterator> i(text.begin(), text.begin(), text.end());
-		utf8::iterator<std::string::const_iterator> end(text.end(), text.begin(), text.end());
-
-		while (i != end)
-		{
-			uint32 g = *i++;
-			codepoints.push_back(g);
-		}
+		count = decodeUTF8((const uint8 *) text.data(), text.size(), codepoints.data() + start);
 	}
-	catch (utf8::exception &e)
+	catch (love::Exception &)
 	{
-		throw love::Exception("UTF-8 decoding error: %s", e.what());
+		codepoints.resize(start);
+		throw;
 	}
+
+	codepoints.resize(start + count);
 }
 
 void Font::getCodepointsFromString(const std::vector<ColoredString> &strs, ColoredCodepoints &codepoints)
@@ -387,6 +834,8 @@ float Font::getHeight() const
 
 std::vector<Font::DrawCommand> Font::generateVertices(const ColoredCodepoints &codepoints, const Colorf &constantcolor, std::vector<GlyphVertex> &vertices, float extra_spacing, Vector2 offset, TextInfo *info)
 {
+	GlyphBatch batch(this);
+
 	// Spacing counter and newline handling.
 	float dx = offset.x;
 	float dy = offset.y;
@@ -407,6 +856,8 @@ std::vector<Font::DrawCommand> Font::generateVertices(const ColoredCodepoints &c
 
 	uint32 prevglyph = 0;
 
+	addPrefetchedGlyphs();
+
 	Colorf linearconstantcolor = gammaCorrectColor(constantcolor);
 
 	Color curcolor = toColor(constantcolor);
@@ -451,7 +902,7 @@ std::vector<Font::DrawCommand> Font::generateVertices(const ColoredCodepoints &c
 
 		uint32 cacheid = textureCacheID;
 
-		const Glyph &glyph = findGlyph(g);
+		const Glyph &glyph = findGlyph(g, true);
 
 		// If findGlyph invalidates the texture cache, re-start the loop.
 		if (cacheid != textureCacheID)
@@ -533,6 +984,9 @@ std::vector<Font::DrawCommand> Font::generateVerticesFormatted(const ColoredCode
 {
 	wrap = std::max(wrap, 0.0f);
 
+	// Lines shouldn't evict each other's glyphs.
+	GlyphBatch batch(this);
+
 	uint32 cacheid = textureCacheID;
 
 	std::vector<DrawCommand> drawcommands;
@@ -626,14 +1080,27 @@ void Font::printv(graphics::Graphics *gfx, const Matrix4 &t, const std::vector<D
 
 	Matrix4 m(gfx->getTransform(), t);
 
+	bool instanced = gfx->canDrawInstancedGlyphs(isDistanceField());
+
 	for (const DrawCommand &cmd : drawcommands)
 	{
+		// Large runs of glyphs upload one compact instance per glyph instead of
+		// four vertices. Small ones are cheaper to batch with other draws.
+		if (instanced && cmd.vertexcount / 4 >= MIN_INSTANCED_GLYPHS)
+		{
+			gfx->drawInstancedGlyphs(cmd.texture, isDistanceField(), t, &vertices[cmd.startvertex], cmd.vertexcount / 4);
+			continue;
+		}
+
 		Graphics::StreamDrawCommand streamcmd;
 		streamcmd.formats[0] = vertexFormat;
 		streamcmd.indexMode = vertex::TriangleIndexMode::QUADS;
 		streamcmd.vertexCount = cmd.vertexcount;
 		streamcmd.texture = cmd.texture;
 
+		if (isDistanceField())
+			streamcmd.standardShaderType = Shader::STANDARD_DISTANCE_FIELD;
+
 		Graphics::StreamVertexData data = gfx->requestStreamDraw(streamcmd);
 		GlyphVertex *vertexdata = (GlyphVertex *) data.stream[0];
 
@@ -642,68 +1109,185 @@ void Font::printv(graphics::Graphics *gfx, const Matrix4 &t, const std::vector<D
 	}
 }
 
-void Font::print(graphics::Graphics *gfx, const std::vector<ColoredString> &text, const Matrix4 &m, const Colorf &constantcolor)
+const Font::Layout &Font::getLayout(const std::vector<ColoredString> &text, bool formatted, float wrap, AlignMode align, const Colorf &constantcolor)
 {
-	ColoredCodepoints codepoints;
-	getCodepointsFromString(text, codepoints);
+	// Layouts drawn with placeholders are invalidated once the prefetched
+	// glyphs arrive, even if nothing new gets generated.
+	addPrefetchedGlyphs();
+
+	if (layoutCacheTextureID != textureCacheID)
+	{
+		clearLayoutCache();
+		layoutCacheTextureID = textureCacheID;
+	}
+
+	int alignint = (int) align;
+
+	uint64 hash = XXH64(&wrap, sizeof(float), formatted ? 1 : 0);
+	hash = XXH64(&alignint, sizeof(int), hash);
+	hash = XXH64(&constantcolor, sizeof(Colorf), hash);
+
+	for (const ColoredString &cstr : text)
+	{
+		hash = XXH64(cstr.str.data(), cstr.str.size(), hash);
+		hash = XXH64(&cstr.color, sizeof(Colorf), hash);
+	}
+
+	auto it = layoutCacheIndex.find(hash);
+	if (it != layoutCacheIndex.end())
+	{
+		const Layout &l = *it->second;
+
+		bool match = l.formatted == formatted && l.wrap == wrap && l.align == align
+			&& l.constantColor == constantcolor && l.text.size() == text.size();
+
+		for (size_t i = 0; match && i < text.size(); i++)
+			match = l.text[i].str == text[i].str && l.text[i].color == text[i].color;
+
+		if (match)
+		{
+			markTexturesUsed(l.drawCommands);
+			layoutCache.splice(layoutCache.begin(), layoutCache, it->second);
+			return layoutCache.front();
+		}
+
+		// Hash collision: the new layout replaces the old one.
+		layoutCache.erase(it->second);
+		layoutCacheIndex.erase(it);
+	}
+
+	Layout layout;
+	layout.hash = hash;
+	layout.text = text;
+	layout.formatted = formatted;
+	layout.wrap = wrap;
+	layout.align = align;
+	layout.constantColor = constantcolor;
+
+	const ColoredCodepoints &codepoints = getCachedCodepoints(text.data(), text.size());
+
+	if (formatted)
+		layout.drawCommands = generateVerticesFormatted(codepoints, constantcolor, wrap, align, layout.vertices);
+	else
+		layout.drawCommands = generateVertices(codepoints, constantcolor, layout.vertices);
+
+	// Adding glyphs can re-create the texture, which invalidates every
+	// layout generated before it.
+	if (layoutCacheTextureID != textureCacheID)
+	{
+		clearLayoutCache();
+		layoutCacheTextureID = textureCacheID;
+	}
+
+	layoutCache.push_front(std::move(layout));
+	layoutCacheIndex[hash] = layoutCache.begin();
 
-	std::vector<GlyphVertex> vertices;
-	std::vector<DrawCommand> drawcommands = generateVertices(codepoints, constantcolor, vertices);
+	if (layoutCache.size() > MAX_LAYOUT_CACHE_SIZE)
+	{
+		layoutCacheIndex.erase(layoutCache.back().hash);
+		layoutCache.pop_back();
+	}
 
-	printv(gfx, m, drawcommands, vertices);
+	return layoutCache.front();
 }
 
-void Font::printf(graphics::Graphics *gfx, const std::vector<ColoredString> &text, float wrap, AlignMode align, const Matrix4 &m, const Colorf &constantcolor)
+void Font::clearLayoutCache()
+{
+	layoutCache.clear();
+	layoutCacheIndex.clear();
+}
+
+const Font::ColoredCodepoints &Font::getCachedCodepoints(const ColoredString *text, size_t count)
 {
-	ColoredCodepoints codepoints;
-	getCodepointsFromString(text, codepoints);
+	uint64 hash = 0;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		hash = XXH64(text[i].str.data(), text[i].str.size(), hash);
+		hash = XXH64(&text[i].color, sizeof(Colorf), hash);
+	}
+
+	auto it = codepointCacheIndex.find(hash);
+	if (it != codepointCacheIndex.end())
+	{
+		const CachedCodepoints &c = *it->second;
 
-	std::vector<GlyphVertex> vertices;
-	std::vector<DrawCommand> drawcommands = generateVerticesFormatted(codepoints, constantcolor, wrap, align, vertices);
+		bool match = c.text.size() == count;
+		for (size_t i = 0; match && i < count; i++)
+			match = c.text[i].str == text[i].str && c.text[i].color == text[i].color;
 
-	printv(gfx, m, drawcommands, vertices);
+		if (match)
+		{
+			codepointCache.splice(codepointCache.begin(), codepointCache, it->second);
+			return codepointCache.front().codepoints;
+		}
+
+		// Hash collision: the new entry replaces the old one.
+		codepointCache.erase(it->second);
+		codepointCacheIndex.erase(it);
+	}
+
+	CachedCodepoints c;
+	c.hash = hash;
+	c.text.assign(text, text + count);
+	getCodepointsFromString(c.text, c.codepoints);
+
+	codepointCache.push_front(std::move(c));
+	codepointCacheIndex[hash] = codepointCache.begin();
+
+	if (codepointCache.size() > MAX_CODEPOINT_CACHE_SIZE)
+	{
+		codepointCacheIndex.erase(codepointCache.back().hash);
+		codepointCache.pop_back();
+	}
+
+	return codepointCache.front().codepoints;
+}
+
+void Font::print(graphics::Graphics *gfx, const std::vector<ColoredString> &text, const Matrix4 &m, const Colorf &constantcolor)
+{
+	const Layout &layout = getLayout(text, false, 0.0f, ALIGN_LEFT, constantcolor);
+	printv(gfx, m, layout.drawCommands, layout.vertices);
+}
+
+void Font::printf(graphics::Graphics *gfx, const std::vector<ColoredString> &text, float wrap, AlignMode align, const Matrix4 &m, const Colorf &constantcolor)
+{
+	const Layout &layout = getLayout(text, true, wrap, align, constantcolor);
+	printv(gfx, m, layout.drawCommands, layout.vertices);
 }
 
 int Font::getWidth(const std::string &str)
 {
 	if (str.size() == 0) return 0;
 
-	std::istringstream iss(str);
-	std::string line;
+	ColoredString cstr = {str, Colorf(1.0f, 1.0f, 1.0f, 1.0f)};
+	const Codepoints &codepoints = getCachedCodepoints(&cstr, 1).cps;
+
 	int max_width = 0;
+	int width = 0;
+	uint32 prevglyph = 0;
 
-	while (getline(iss, line, '\n'))
+	for (uint32 c : codepoints)
 	{
-		int width = 0;
-		uint32 prevglyph = 0;
-		try
+		if (c == '\n')
 		{
-			utf8::iterator<std::string::const_iterator> i(line.begin(), line.begin(), line.end());
-			utf8::iterator<std::string::const_iterator> end(line.end(), line.begin(), line.end());
-
-			while (i != end)
-			{
-				uint32 c = *i++;
-
-				// Ignore carriage returns
-				if (c == '\r')
-					continue;
+			max_width = std::max(max_width, width);
+			width = 0;
+			prevglyph = 0;
+			continue;
+		}
 
-				const Glyph &g = findGlyph(c);
-				width += g.spacing + getKerning(prevglyph, c);
+		// Ignore carriage returns
+		if (c == '\r')
+			continue;
 
-				prevglyph = c;
-			}
-		}
-		catch (utf8::exception &e)
-		{
-			throw love::Exception("UTF-8 decoding error: %s", e.what());
-		}
+		const Glyph &g = findGlyph(c);
+		width += g.spacing + getKerning(prevglyph, c);
 
-		max_width = std::max(max_width, width);
+		prevglyph = c;
 	}
 
-	return max_width;
+	return std::max(max_width, width);
 }
 
 int Font::getWidth(char character)
@@ -872,8 +1456,7 @@ void Font::getWrap(const ColoredCodepoints &codepoints, float wraplimit, std::ve
 
 void Font::getWrap(const std::vector<ColoredString> &text, float wraplimit, std::vector<std::string> &lines, std::vector<int> *linewidths)
 {
-	ColoredCodepoints cps;
-	getCodepointsFromString(text, cps);
+	const ColoredCodepoints &cps = getCachedCodepoints(text.data(), text.size());
 
 	std::vector<ColoredCodepoints> codepointlines;
 	getWrap(cps, wraplimit, codepointlines, linewidths);
@@ -899,6 +1482,7 @@ void Font::getWrap(const std::vector<ColoredString> &text, float wraplimit, std:
 void Font::setLineHeight(float height)
 {
 	lineHeight = height;
+	clearLayoutCache();
 }
 
 float Font::getLineHeight() const
@@ -908,8 +1492,8 @@ float Font::getLineHeight() const
 
 void Font::setFilter(const Texture::Filter &f)
 {
-	for (const auto &image : images)
-		image->setFilter(f);
+	for (const TexturePage &page : texturePages)
+		page.image->setFilter(f);
 
 	filter = f;
 }
@@ -983,8 +1567,14 @@ void Font::setFallbacks(const std::vector<Font *> &fallbacks)
 	{
 		if (f->rasterizers[0]->getDataType() != this->rasterizers[0]->getDataType())
 			throw love::Exception("Font fallbacks must be of the same font type.");
+
+		if (f->isDistanceField() != isDistanceField())
+			throw love::Exception("Font fallbacks must all be distance field fonts, or all be regular fonts.");
 	}
 
+	// A pending prefetch could pick glyphs from the old fallbacks.
+	cancelGlyphPrefetch();
+
 	rasterizers.resize(1);
 
 	// NOTE: this won't invalidate already-rasterized glyphs.
@@ -997,11 +1587,50 @@ float Font::getDPIScale() const
 	return dpiScale;
 }
 
+bool Font::isDistanceField() const
+{
+	return rasterizers[0]->getDistanceFieldSpread() > 0;
+}
+
 uint32 Font::getTextureCacheID() const
 {
 	return textureCacheID;
 }
 
+uint32 Font::getGlyphEvictionID() const
+{
+	return glyphEvictionID;
+}
+
+bool Font::hasEvictedGlyphs(const std::vector<DrawCommand> &commands, uint32 evictionid) const
+{
+	if (evictionid == glyphEvictionID)
+		return false;
+
+	for (const DrawCommand &cmd : commands)
+	{
+		for (const TexturePage &page : texturePages)
+		{
+			if (page.image.get() == cmd.texture && page.evictionID > evictionid)
+				return true;
+		}
+	}
+
+	return false;
+}
+
+void Font::markTexturesUsed(const std::vector<DrawCommand> &commands)
+{
+	for (const DrawCommand &cmd : commands)
+	{
+		for (TexturePage &page : texturePages)
+		{
+			if (page.image.get() == cmd.texture)
+				page.lastUsed = glyphUseCounter;
+		}
+	}
+}
+
 bool Font::getConstant(const char *in, AlignMode &out)
 {
 	return alignModes.find(in, out);
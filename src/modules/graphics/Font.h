@@ -21,9 +21,12 @@
 #pragma once
 
 // STD
+#include <list>
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
 #include <vector>
+#include <memory>
 #include <stddef.h>
 
 // LOVE
@@ -33,6 +36,7 @@
 #include "common/Vector.h"
 
 #include "font/Rasterizer.h"
+#include "thread/threads.h"
 #include "Image.h"
 #include "vertex.h"
 #include "Volatile.h"
@@ -96,6 +100,23 @@ public:
 		int vertexcount;
 	};
 
+	/**
+	 * Glyphs used while a GlyphBatch exists won't be evicted from the glyph
+	 * texture pages until the batch is destroyed, so vertices generated during
+	 * it stay valid together.
+	 **/
+	class GlyphBatch
+	{
+	public:
+
+		GlyphBatch(Font *font);
+		~GlyphBatch();
+
+	private:
+
+		Font *font;
+	};
+
 	Font(love::font::Rasterizer *r, const Texture::Filter &filter);
 
 	virtual ~Font();
@@ -169,12 +190,46 @@ public:
 	bool hasGlyph(uint32 glyph) const;
 	bool hasGlyphs(const std::string &text) const;
 
+	/**
+	 * Rasterizes glyphs on a worker thread, so they can be added to the glyph
+	 * texture later without a hitch. Finished glyphs are uploaded together the
+	 * next time text is drawn with this Font, and until then draws use a blank
+	 * placeholder for them. Glyphs of Fonts whose Rasterizers can't be cloned
+	 * (image fonts and BMFonts) are added immediately instead.
+	 **/
+	void prefetchGlyphs(const Codepoints &glyphs);
+	bool isPrefetchingGlyphs() const;
+
 	void setFallbacks(const std::vector<Font *> &fallbacks);
 
 	float getDPIScale() const;
 
+	/**
+	 * Whether the glyphs are signed distance fields, which are drawn with the
+	 * standard distance field shader.
+	 **/
+	bool isDistanceField() const;
+
 	uint32 getTextureCacheID() const;
 
+	/**
+	 * ID which is incremented when the glyphs of a texture page are evicted.
+	 * Unlike the texture cache ID, glyphs on other pages remain valid.
+	 **/
+	uint32 getGlyphEvictionID() const;
+
+	/**
+	 * Whether any texture used by the draw commands had its glyphs evicted
+	 * after the given glyph eviction ID.
+	 **/
+	bool hasEvictedGlyphs(const std::vector<DrawCommand> &commands, uint32 evictionid) const;
+
+	/**
+	 * Marks the texture pages used by previously generated draw commands as
+	 * recently used, so their glyphs are less likely to be evicted.
+	 **/
+	void markTexturesUsed(const std::vector<DrawCommand> &commands);
+
 	// Implements Volatile.
 	bool loadVolatile() override;
 	void unloadVolatile() override;
@@ -190,6 +245,7 @@ private:
 	struct Glyph
 	{
 		Texture *texture;
+		int page;
 		int spacing;
 		GlyphVertex vertices[4];
 	};
@@ -200,12 +256,82 @@ private:
 		int height;
 	};
 
+	// A row of glyphs in a texture page with a fixed height.
+	struct TextureShelf
+	{
+		int x;
+		int y;
+		int height;
+	};
+
+	struct TexturePage
+	{
+		StrongRef<love::graphics::Image> image;
+		std::vector<TextureShelf> shelves;
+		int nextShelfY;
+
+		// Value of glyphUseCounter when a glyph in the page was last used.
+		uint32 lastUsed;
+
+		// Value of glyphEvictionID when the page's glyphs were last evicted.
+		uint32 evictionID;
+	};
+
+	// Vertices generated by print or printf, kept for when the same text is
+	// drawn again.
+	struct Layout
+	{
+		uint64 hash;
+
+		std::vector<ColoredString> text;
+		bool formatted;
+		float wrap;
+		AlignMode align;
+		Colorf constantColor;
+
+		std::vector<DrawCommand> drawCommands;
+		std::vector<GlyphVertex> vertices;
+	};
+
+	// Decoded text used by getWidth, getWrap and layout generation, kept for
+	// strings which are measured or drawn repeatedly.
+	struct CachedCodepoints
+	{
+		uint64 hash;
+		std::vector<ColoredString> text;
+		ColoredCodepoints codepoints;
+	};
+
+	// Shared with the worker thread which rasterizes prefetched glyphs.
+	struct GlyphPrefetch
+	{
+		love::thread::MutexRef mutex;
+		love::thread::ConditionalRef cond;
+
+		// Clones of the Font's Rasterizers, only used by the worker.
+		std::vector<StrongRef<love::font::Rasterizer>> rasterizers;
+
+		Codepoints queued;
+		std::vector<std::pair<uint32, StrongRef<love::font::GlyphData>>> finished;
+
+		bool running = false;
+		bool cancelled = false;
+	};
+
 	void createTexture();
+	void evictTexturePage(int index);
+	bool packGlyph(TexturePage &page, int w, int h, int &x, int &y) const;
 
 	TextureSize getNextTextureSize() const;
 	love::font::GlyphData *getRasterizerGlyphData(uint32 glyph);
 	const Glyph &addGlyph(uint32 glyph);
-	const Glyph &findGlyph(uint32 glyph);
+	const Glyph &addGlyph(uint32 glyph, love::font::GlyphData *gd);
+	const Glyph &findGlyph(uint32 glyph, bool placeholder = false);
+	void addPrefetchedGlyphs();
+	void cancelGlyphPrefetch();
+	const Layout &getLayout(const std::vector<ColoredString> &text, bool formatted, float wrap, AlignMode align, const Colorf &constantcolor);
+	void clearLayoutCache();
+	const ColoredCodepoints &getCachedCodepoints(const ColoredString *text, size_t count);
 	float getKerning(uint32 leftglyph, uint32 rightglyph);
 	void printv(Graphics *gfx, const Matrix4 &t, const std::vector<DrawCommand> &drawcommands, const std::vector<GlyphVertex> &vertices);
 
@@ -217,7 +343,7 @@ private:
 	int textureWidth;
 	int textureHeight;
 
-	std::vector<StrongRef<love::graphics::Image>> images;
+	std::vector<TexturePage> texturePages;
 
 	// maps glyphs to glyph texture information
 	std::unordered_map<uint32, Glyph> glyphs;
@@ -231,14 +357,33 @@ private:
 
 	float dpiScale;
 
-	int textureX, textureY;
-	int rowHeight;
-
 	bool useSpacesAsTab;
 
 	// ID which is incremented when the texture cache is invalidated.
 	uint32 textureCacheID;
 
+	uint32 glyphEvictionID;
+
+	// Incremented for every text generation outside of a GlyphBatch. Pages
+	// used since the last increment are never evicted.
+	uint32 glyphUseCounter;
+	int glyphBatchDepth;
+
+	std::unique_ptr<GlyphPrefetch> glyphPrefetch;
+
+	// Glyphs queued for prefetching which haven't been added yet.
+	std::unordered_set<uint32> pendingGlyphs;
+	bool usedGlyphPlaceholders;
+
+	// Most recently used first. Only valid for layoutCacheTextureID.
+	std::list<Layout> layoutCache;
+	std::unordered_map<uint64, std::list<Layout>::iterator> layoutCacheIndex;
+	uint32 layoutCacheTextureID;
+
+	// Most recently used first.
+	std::list<CachedCodepoints> codepointCache;
+	std::unordered_map<uint64, std::list<CachedCodepoints>::iterator> codepointCacheIndex;
+
 	// 1 pixel of transparent padding between glyphs (so quads won't pick up
 	// other glyphs), plus one pixel of transparent padding that the quads will
 	// use, for edge antialiasing.
@@ -247,6 +392,17 @@ private:
 	// This will be used if the Rasterizer doesn't have a tab character itself.
 	static const int SPACES_PER_TAB = 4;
 
+	static const size_t MAX_LAYOUT_CACHE_SIZE = 128;
+	static const size_t MAX_CODEPOINT_CACHE_SIZE = 256;
+
+	// Number of max-sized texture pages after which the least recently used
+	// page is evicted instead of creating a new one.
+	static const int MAX_TEXTURE_PAGES = 4;
+
+	// Glyphs sharing a texture in a print call after which they're drawn with
+	// instancing, when it's available.
+	static const int MIN_INSTANCED_GLYPHS = 64;
+
 	static StringMap<AlignMode, ALIGN_MAX_ENUM>::Entry alignModeEntries[];
 	static StringMap<AlignMode, ALIGN_MAX_ENUM> alignModes;
 	
@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/int.h"
+#include "Resource.h"
+
+// C
+#include <stddef.h>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * Keeps the state of a ParticleSystem's particles in GPU buffers and advances
+ * it on the GPU. Particles live in fixed slots; the ParticleSystem decides
+ * which slots new particles are written to.
+ **/
+class GPUParticleSimulator
+{
+public:
+
+	// Values which change as a particle is simulated. Interleaved in the
+	// buffer returned by getStateBuffer.
+	struct State
+	{
+		float position[2];
+		float velocity[2];
+		float life;
+		float rotation;
+	};
+
+	// Values which are fixed when a particle is spawned. Interleaved in the
+	// buffer returned by getSpawnBuffer.
+	struct Spawn
+	{
+		float lifetime;
+		float spinStart;
+		float spinEnd;
+		float linearDamping;
+
+		float origin[2];
+		float linearAcceleration[2];
+
+		float radialAcceleration;
+		float tangentialAcceleration;
+		float sizeOffset;
+		float sizeIntervalSize;
+	};
+
+	virtual ~GPUParticleSimulator() {}
+
+	/**
+	 * Writes newly spawned particles into count slots starting at first. If
+	 * spawns is null, only the simulated state of the slots is replaced.
+	 **/
+	virtual void setParticles(uint32 first, uint32 count, const State *states, const Spawn *spawns) = 0;
+
+	/**
+	 * Advances every slot by dt seconds. Slots whose life has run out are
+	 * left alone.
+	 **/
+	virtual void simulate(float dt) = 0;
+
+	virtual Resource *getStateBuffer() = 0;
+	virtual Resource *getSpawnBuffer() = 0;
+
+	virtual uint32 getSize() const = 0;
+
+}; // GPUParticleSimulator
+
+} // graphics
+} // love
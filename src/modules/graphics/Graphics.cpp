@@ -27,14 +27,19 @@
 #include "font/Font.h"
 #include "window/Window.h"
 #include "SpriteBatch.h"
+#include "DrawList.h"
+#include "TextureAtlas.h"
+#include "TileLayer.h"
 #include "ParticleSystem.h"
 #include "Font.h"
 #include "Video.h"
 #include "Text.h"
 #include "common/deprecation.h"
+#include "common/profiling.h"
 
 // C++
 #include <algorithm>
+#include <cstring>
 #include <stdlib.h>
 
 namespace love
@@ -115,11 +120,33 @@ Graphics::Graphics()
 	, active(true)
 	, writingToStencil(false)
 	, streamBufferState()
+	, streamBufferAutoSizing(true)
+	, deferringDraws(false)
+	, submittingDeferredDraws(false)
+	, deferredStateChanged(false)
+	, deferredLayer(0)
+	, deferringStencil(false)
+	, deferredStencilWrite()
+	, deferredStencilClear()
 	, projectionMatrix()
 	, canvasSwitchCount(0)
 	, drawCalls(0)
 	, drawCallsBatched(0)
+	, pendingStreamFlushReason(STREAM_FLUSH_STATE)
 	, quadIndexBuffer(nullptr)
+	, lineCornerBuffer(nullptr)
+	, lineBatchState()
+	, gpuLinesEnabled(false)
+	, glyphCornerBuffer(nullptr)
+	, glyphInstanceBuffer(nullptr)
+	, imageUploadBudget(16 * 1024 * 1024)
+	, backgroundUploads(false)
+	, textureStreamingBudget(256 * 1024 * 1024)
+	, textureMemoryBudget(0)
+	, pendingUploadTotal(0)
+	, pendingUploadDone(0)
+	, canvasPoolLifetime(DEFAULT_CANVAS_POOL_LIFETIME)
+	, textureBinning(false)
 	, capabilities()
 	, cachedShaderStages()
 {
@@ -129,8 +156,18 @@ Graphics::Graphics()
 	pixelScaleStack.reserve(16);
 	pixelScaleStack.push_back(1);
 
-	states.reserve(10);
-	states.push_back(DisplayState());
+	savedStates.reserve(10);
+
+	for (int i = 0; i < STREAM_FLUSH_MAX_ENUM; i++)
+		streamFlushCounts[i] = 0;
+
+	// Initial sizes that should be good enough for most cases.
+	streamBufferUsage[0].minSize = 1024 * 1024 * 1;
+	streamBufferUsage[1].minSize = 256  * 1024 * 1;
+	streamBufferUsage[2].minSize = sizeof(uint16) * LOVE_UINT16_MAX;
+
+	// Graphics is created and used on the main thread.
+	FrameArena::setCurrent(&frameArena);
 
 	if (!Shader::initialize())
 		throw love::Exception("Shader support failed to initialize!");
@@ -139,6 +176,8 @@ Graphics::Graphics()
 Graphics::~Graphics()
 {
 	delete quadIndexBuffer;
+	delete lineCornerBuffer;
+	delete glyphCornerBuffer;
 
 	// Clean up standard shaders before the active shader. If we do it after,
 	// the active shader may try to activate a standard shader when deactivating
@@ -153,13 +192,16 @@ Graphics::~Graphics()
 		}
 	}
 
-	states.clear();
+	savedStates.clear();
+	displayState = DisplayState();
 
 	defaultFont.set(nullptr);
 
 	delete streamBufferState.vb[0];
 	delete streamBufferState.vb[1];
 	delete streamBufferState.indexBuffer;
+	delete lineBatchState.buffer;
+	delete glyphInstanceBuffer;
 
 	for (int i = 0; i < (int) ShaderStage::STAGE_MAX_ENUM; i++)
 		cachedShaderStages[i].clear();
@@ -179,11 +221,46 @@ void Graphics::createQuadIndexBuffer()
 	vertex::fillIndices(vertex::TriangleIndexMode::QUADS, 0, LOVE_UINT16_MAX, (uint16 *) map.get());
 }
 
+void Graphics::createLineCornerBuffer()
+{
+	if (lineCornerBuffer != nullptr)
+		return;
+
+	// Each corner is (end, side, alpha). The end is 0 at the start of the
+	// segment and 1 at its end, and |side| is 1 at the edge of the line and 2
+	// at the outer edge of the smooth line fringe. The first quad is the line
+	// itself and the other two are its fringe, in the quad index order.
+	static const float corners[] =
+	{
+		0.0f, -1.0f, 1.0f,  0.0f,  1.0f, 1.0f,  1.0f, -1.0f, 1.0f,  1.0f,  1.0f, 1.0f,
+		0.0f, -2.0f, 0.0f,  0.0f, -1.0f, 1.0f,  1.0f, -2.0f, 0.0f,  1.0f, -1.0f, 1.0f,
+		0.0f,  1.0f, 1.0f,  0.0f,  2.0f, 0.0f,  1.0f,  1.0f, 1.0f,  1.0f,  2.0f, 0.0f,
+	};
+
+	lineCornerBuffer = newBuffer(sizeof(corners), corners, BUFFER_VERTEX, vertex::USAGE_STATIC, 0);
+}
+
+void Graphics::createGlyphCornerBuffer()
+{
+	if (glyphCornerBuffer != nullptr)
+		return;
+
+	// Unit square corners, ordered for a triangle strip like Font's glyphs.
+	static const float corners[] = {0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f, 1.0f};
+
+	glyphCornerBuffer = newBuffer(sizeof(corners), corners, BUFFER_VERTEX, vertex::USAGE_STATIC, 0);
+}
+
 Quad *Graphics::newQuad(Quad::Viewport v, double sw, double sh)
 {
 	return new Quad(v, sw, sh);
 }
 
+QuadAtlas *Graphics::newQuadAtlas(double sw, double sh)
+{
+	return new QuadAtlas(sw, sh);
+}
+
 Font *Graphics::newFont(love::font::Rasterizer *data, const Texture::Filter &filter)
 {
 	return new Font(data, filter);
@@ -204,9 +281,9 @@ Video *Graphics::newVideo(love::video::VideoStream *stream, float dpiscale)
 	return new Video(this, stream, dpiscale);
 }
 
-love::graphics::SpriteBatch *Graphics::newSpriteBatch(Texture *texture, int size, vertex::Usage usage)
+love::graphics::SpriteBatch *Graphics::newSpriteBatch(Texture *texture, int size, vertex::Usage usage, bool instanced)
 {
-	return new SpriteBatch(this, texture, size, usage);
+	return new SpriteBatch(this, texture, size, usage, instanced);
 }
 
 love::graphics::ParticleSystem *Graphics::newParticleSystem(Texture *texture, int size)
@@ -214,7 +291,27 @@ love::graphics::ParticleSystem *Graphics::newParticleSystem(Texture *texture, in
 	return new ParticleSystem(texture, size);
 }
 
-ShaderStage *Graphics::newShaderStage(ShaderStage::StageType stage, const std::string &optsource)
+DrawList *Graphics::newDrawList()
+{
+	return new DrawList();
+}
+
+TextureAtlas *Graphics::newTextureAtlas(int size, PixelFormat format, bool linear)
+{
+	return new TextureAtlas(this, size, format, linear);
+}
+
+TextureArrayBin *Graphics::newTextureArrayBin(int width, int height, int layers, PixelFormat format, bool linear)
+{
+	return new TextureArrayBin(this, width, height, layers, format, linear);
+}
+
+TileLayer *Graphics::newTileLayer(Texture *texture, int width, int height, float tilewidth, float tileheight, int chunksize)
+{
+	return new TileLayer(this, texture, width, height, tilewidth, tileheight, chunksize);
+}
+
+ShaderStage *Graphics::newShaderStage(ShaderStage::StageType stage, const std::string &optsource, bool deferValidation)
 {
 	if (stage == ShaderStage::STAGE_MAX_ENUM)
 		throw love::Exception("Invalid shader stage.");
@@ -241,9 +338,11 @@ ShaderStage *Graphics::newShaderStage(ShaderStage::StageType stage, const std::s
 
 	if (s == nullptr)
 	{
-		s = newShaderStageInternal(stage, cachekey, source, getRenderer() == RENDERER_OPENGLES);
-		if (!cachekey.empty())
-			cachedShaderStages[stage][cachekey] = s;
+		s = newShaderStageInternal(stage, cachekey, source, getRenderer() == RENDERER_OPENGLES, deferValidation);
+
+		// Stages which haven't been validated yet are cached once they are.
+		if (!deferValidation)
+			cacheShaderStage(s);
 	}
 
 	return s;
@@ -257,7 +356,223 @@ Shader *Graphics::newShader(const std::string &vertex, const std::string &pixel)
 	StrongRef<ShaderStage> vertexstage(newShaderStage(ShaderStage::STAGE_VERTEX, vertex), Acquire::NORETAIN);
 	StrongRef<ShaderStage> pixelstage(newShaderStage(ShaderStage::STAGE_PIXEL, pixel), Acquire::NORETAIN);
 
-	return newShaderInternal(vertexstage.get(), pixelstage.get());
+	return newShaderInternal(vertexstage.get(), pixelstage.get(), false);
+}
+
+Shader *Graphics::newShaderAsync(const std::string &vertex, const std::string &pixel)
+{
+	if (vertex.empty() && pixel.empty())
+		throw love::Exception("Error creating shader: no source code!");
+
+	StrongRef<ShaderStage> vertexstage(newShaderStage(ShaderStage::STAGE_VERTEX, vertex, true), Acquire::NORETAIN);
+	StrongRef<ShaderStage> pixelstage(newShaderStage(ShaderStage::STAGE_PIXEL, pixel, true), Acquire::NORETAIN);
+
+	return newShaderInternal(vertexstage.get(), pixelstage.get(), true);
+}
+
+ShaderVariants *Graphics::newShaderVariants(const std::string &vertex, const std::string &pixel, const std::vector<std::string> &keys)
+{
+	return new ShaderVariants(vertex, pixel, keys);
+}
+
+Shader *Graphics::newComputeShader(const std::string &source)
+{
+	if (!capabilities.features[FEATURE_COMPUTE])
+		throw love::Exception("Compute shaders are not supported on this system.");
+
+	if (source.empty())
+		throw love::Exception("Error creating compute shader: no source code!");
+
+	StrongRef<ShaderStage> stage(newShaderStage(ShaderStage::STAGE_COMPUTE, source), Acquire::NORETAIN);
+
+	return newComputeShaderInternal(stage.get());
+}
+
+ImageLoader *Graphics::newImageLoader(love::Data *data, const Image::Settings &settings)
+{
+	ImageLoader *loader = new ImageLoader(data, settings);
+	imageLoaders.emplace_back(loader);
+	return loader;
+}
+
+void Graphics::setImageUploadBudget(size_t bytes)
+{
+	imageUploadBudget = bytes;
+}
+
+size_t Graphics::getImageUploadBudget() const
+{
+	return imageUploadBudget;
+}
+
+void Graphics::setBackgroundUploads(bool enable)
+{
+	backgroundUploads = enable;
+}
+
+bool Graphics::getBackgroundUploads() const
+{
+	return backgroundUploads;
+}
+
+void Graphics::setTextureStreamingBudget(size_t bytes)
+{
+	textureStreamingBudget = bytes;
+}
+
+size_t Graphics::getTextureStreamingBudget() const
+{
+	return textureStreamingBudget;
+}
+
+void Graphics::setTextureMemoryBudget(size_t bytes)
+{
+	textureMemoryBudget = bytes;
+}
+
+size_t Graphics::getTextureMemoryBudget() const
+{
+	return textureMemoryBudget;
+}
+
+void Graphics::addPendingImageUpload(Image *image)
+{
+	for (const auto &pending : pendingImageUploads)
+	{
+		if (pending.get() == image)
+			return;
+	}
+
+	pendingImageUploads.emplace_back(image);
+	pendingUploadTotal += image->getPendingUploadSize();
+}
+
+float Graphics::getRestoreProgress() const
+{
+	if (pendingImageUploads.empty() || pendingUploadTotal == 0)
+		return 1.0f;
+
+	return std::min((float) ((double) pendingUploadDone / (double) pendingUploadTotal), 1.0f);
+}
+
+void Graphics::updateImageLoaders()
+{
+	size_t budget = imageUploadBudget;
+
+	// Images being restored after the context was lost come first, since
+	// they're likely to be drawn soon.
+	for (size_t i = 0; i < pendingImageUploads.size(); )
+	{
+		Image *image = pendingImageUploads[i];
+		size_t uploaded = image->uploadPendingData(budget);
+
+		budget -= std::min(budget, uploaded);
+		pendingUploadDone += uploaded;
+
+		if (!image->isUploadPending())
+			pendingImageUploads.erase(pendingImageUploads.begin() + i);
+		else
+			i++;
+	}
+
+	if (pendingImageUploads.empty())
+		pendingUploadTotal = pendingUploadDone = 0;
+
+	// Loaders are updated in the order they were created, so earlier loads
+	// finish first.
+	for (size_t i = 0; i < imageLoaders.size(); )
+	{
+		ImageLoader *loader = imageLoaders[i];
+		budget -= std::min(budget, loader->update(budget));
+
+		if (loader->isComplete())
+			imageLoaders.erase(imageLoaders.begin() + i);
+		else
+			i++;
+	}
+
+	// Whatever is left goes to streaming Images.
+	updateStreamingImages(budget);
+}
+
+void Graphics::updateStreamingImages(size_t uploadbudget)
+{
+	const std::vector<Image *> &images = Image::getStreamingImages();
+
+	if (images.empty() || uploadbudget == 0)
+		return;
+
+	size_t resident = 0;
+	std::vector<Image *> streaming;
+
+	for (Image *image : images)
+	{
+		resident += image->getResidentMemorySize();
+
+		if (image->getResidentMipmap() != image->getRequestedMipmap())
+			streaming.push_back(image);
+	}
+
+	// Every Image gets its less detailed levels before any gets its most
+	// detailed ones.
+	std::stable_sort(streaming.begin(), streaming.end(), [](Image *a, Image *b)
+	{
+		return a->getPixelWidth(a->getResidentMipmap()) < b->getPixelWidth(b->getResidentMipmap());
+	});
+
+	for (Image *image : streaming)
+	{
+		if (uploadbudget == 0)
+			break;
+
+		size_t nextsize = image->getNextStreamingSize();
+
+		if (nextsize > 0 && resident + nextsize > textureStreamingBudget)
+			continue;
+
+		resident += nextsize;
+		uploadbudget -= std::min(uploadbudget, image->streamMipmaps(uploadbudget));
+	}
+}
+
+void Graphics::updateTextureResidency()
+{
+	const std::vector<Image *> &images = Image::getImages();
+
+	// Their data is uploaded by updateImageLoaders, before anything new.
+	for (Image *image : images)
+	{
+		if (image->isUsedSinceEviction())
+			image->restore(true);
+	}
+
+	if (textureMemoryBudget == 0 || Texture::totalGraphicsMemory <= (int64) textureMemoryBudget)
+		return;
+
+	uint32 frame = Texture::getUsageFrame();
+	std::vector<Image *> evictable;
+
+	for (Image *image : images)
+	{
+		if (image->getLastUsedFrame() + EVICTION_MIN_UNUSED_FRAMES <= frame && image->isEvictable())
+			evictable.push_back(image);
+	}
+
+	std::sort(evictable.begin(), evictable.end(), [](Image *a, Image *b)
+	{
+		if (a->getResidencyPriority() != b->getResidencyPriority())
+			return a->getResidencyPriority() < b->getResidencyPriority();
+
+		return a->getLastUsedFrame() < b->getLastUsedFrame();
+	});
+
+	for (Image *image : evictable)
+	{
+		if (Texture::totalGraphicsMemory <= (int64) textureMemoryBudget)
+			break;
+
+		image->evict();
+	}
 }
 
 Mesh *Graphics::newMesh(const std::vector<Vertex> &vertices, PrimitiveType drawmode, vertex::Usage usage)
@@ -280,14 +595,40 @@ love::graphics::Mesh *Graphics::newMesh(const std::vector<Mesh::AttribFormat> &v
 	return new Mesh(this, vertexformat, data, datasize, drawmode, usage);
 }
 
+SkinnedMesh *Graphics::newSkinnedMesh(const std::vector<Mesh::AttribFormat> &vertexformat, int vertexcount, PrimitiveType drawmode, vertex::Usage usage)
+{
+	return new SkinnedMesh(this, vertexformat, vertexcount, drawmode, usage);
+}
+
+SkinnedMesh *Graphics::newSkinnedMesh(const std::vector<Mesh::AttribFormat> &vertexformat, const void *data, size_t datasize, PrimitiveType drawmode, vertex::Usage usage)
+{
+	return new SkinnedMesh(this, vertexformat, data, datasize, drawmode, usage);
+}
+
 love::graphics::Text *Graphics::newText(graphics::Font *font, const std::vector<Font::ColoredString> &text)
 {
 	return new Text(font, text);
 }
 
-void Graphics::cleanupCachedShaderStage(ShaderStage::StageType type, const std::string &hashkey)
+void Graphics::cacheShaderStage(ShaderStage *stage)
+{
+	const std::string &cachekey = stage->getCacheKey();
+	if (cachekey.empty() || !stage->isValidated())
+		return;
+
+	auto &cache = cachedShaderStages[stage->getStageType()];
+	if (cache.find(cachekey) == cache.end())
+		cache[cachekey] = stage;
+}
+
+void Graphics::cleanupCachedShaderStage(ShaderStage *stage)
 {
-	cachedShaderStages[type].erase(hashkey);
+	auto &cache = cachedShaderStages[stage->getStageType()];
+
+	// Another stage with the same source may be the cached one.
+	auto it = cache.find(stage->getCacheKey());
+	if (it != cache.end() && it->second == stage)
+		cache.erase(it);
 }
 
 bool Graphics::validateShader(bool gles, const std::string &vertex, const std::string &pixel, std::string &err)
@@ -334,7 +675,7 @@ int Graphics::getPixelHeight() const
 
 double Graphics::getCurrentDPIScale() const
 {
-	const auto &rt = states.back().renderTargets.getFirstTarget();
+	const auto &rt = displayState.renderTargets.getFirstTarget();
 	if (rt.canvas.get())
 		return rt.canvas->getDPIScale();
 
@@ -406,27 +747,33 @@ void Graphics::restoreState(const DisplayState &s)
 	setDefaultMipmapFilter(s.defaultMipmapFilter, s.defaultMipmapSharpness);
 }
 
-void Graphics::restoreStateChecked(const DisplayState &s)
+void Graphics::restoreStateChecked(const DisplayState &s, uint32 fields)
 {
-	const DisplayState &cur = states.back();
+	const DisplayState &cur = displayState;
+
+	auto restoring = [fields](StateField field) { return (fields & (1u << field)) != 0; };
 
-	if (s.color != cur.color)
+	if (restoring(STATE_COLOR) && s.color != cur.color)
 		setColor(s.color);
 
-	setBackgroundColor(s.backgroundColor);
+	if (restoring(STATE_BACKGROUND_COLOR))
+		setBackgroundColor(s.backgroundColor);
 
-	if (s.blendMode != cur.blendMode || s.blendAlphaMode != cur.blendAlphaMode)
+	if (restoring(STATE_BLEND) && (s.blendMode != cur.blendMode || s.blendAlphaMode != cur.blendAlphaMode))
 		setBlendMode(s.blendMode, s.blendAlphaMode);
 
 	// These are just simple assignments.
-	setLineWidth(s.lineWidth);
-	setLineStyle(s.lineStyle);
-	setLineJoin(s.lineJoin);
-
-	if (s.pointSize != cur.pointSize)
+	if (restoring(STATE_LINE_WIDTH))
+		setLineWidth(s.lineWidth);
+	if (restoring(STATE_LINE_STYLE))
+		setLineStyle(s.lineStyle);
+	if (restoring(STATE_LINE_JOIN))
+		setLineJoin(s.lineJoin);
+
+	if (restoring(STATE_POINT_SIZE) && s.pointSize != cur.pointSize)
 		setPointSize(s.pointSize);
 
-	if (s.scissor != cur.scissor || (s.scissor && !(s.scissorRect == cur.scissorRect)))
+	if (restoring(STATE_SCISSOR) && (s.scissor != cur.scissor || (s.scissor && !(s.scissorRect == cur.scissorRect))))
 	{
 		if (s.scissor)
 			setScissor(s.scissorRect);
@@ -434,95 +781,184 @@ void Graphics::restoreStateChecked(const DisplayState &s)
 			setScissor();
 	}
 
-	if (s.stencilCompare != cur.stencilCompare || s.stencilTestValue != cur.stencilTestValue)
+	if (restoring(STATE_STENCIL) && (s.stencilCompare != cur.stencilCompare || s.stencilTestValue != cur.stencilTestValue))
 		setStencilTest(s.stencilCompare, s.stencilTestValue);
 
-	if (s.depthTest != cur.depthTest || s.depthWrite != cur.depthWrite)
+	if (restoring(STATE_DEPTH) && (s.depthTest != cur.depthTest || s.depthWrite != cur.depthWrite))
 		setDepthMode(s.depthTest, s.depthWrite);
 
-	setMeshCullMode(s.meshCullMode);
+	if (restoring(STATE_MESH_CULL_MODE))
+		setMeshCullMode(s.meshCullMode);
 
-	if (s.winding != cur.winding)
+	if (restoring(STATE_WINDING) && s.winding != cur.winding)
 		setFrontFaceWinding(s.winding);
 
-	setFont(s.font.get());
-	setShader(s.shader.get());
+	if (restoring(STATE_FONT))
+		setFont(s.font.get());
 
-	const auto &sRTs = s.renderTargets;
-	const auto &curRTs = cur.renderTargets;
+	if (restoring(STATE_SHADER) && s.shader.get() != cur.shader.get())
+		setShader(s.shader.get());
 
-	bool canvaseschanged = sRTs.colors.size() != curRTs.colors.size();
-	if (!canvaseschanged)
+	if (restoring(STATE_RENDER_TARGETS))
 	{
-		for (size_t i = 0; i < sRTs.colors.size() && i < curRTs.colors.size(); i++)
+		const auto &sRTs = s.renderTargets;
+		const auto &curRTs = cur.renderTargets;
+
+		bool canvaseschanged = sRTs.colors.size() != curRTs.colors.size();
+		if (!canvaseschanged)
 		{
-			if (sRTs.colors[i] != curRTs.colors[i])
+			for (size_t i = 0; i < sRTs.colors.size() && i < curRTs.colors.size(); i++)
 			{
-				canvaseschanged = true;
-				break;
+				if (sRTs.colors[i] != curRTs.colors[i])
+				{
+					canvaseschanged = true;
+					break;
+				}
 			}
-		}
 
-		if (!canvaseschanged && sRTs.depthStencil != curRTs.depthStencil)
-			canvaseschanged = true;
+			if (!canvaseschanged && sRTs.depthStencil != curRTs.depthStencil)
+				canvaseschanged = true;
 
-		if (sRTs.temporaryRTFlags != curRTs.temporaryRTFlags)
-			canvaseschanged = true;
-	}
+			if (sRTs.temporaryRTFlags != curRTs.temporaryRTFlags)
+				canvaseschanged = true;
+		}
 
-	if (canvaseschanged)
-		setCanvas(s.renderTargets);
+		if (canvaseschanged)
+			setCanvas(s.renderTargets);
+	}
 
-	if (s.colorMask != cur.colorMask)
+	if (restoring(STATE_COLOR_MASK) && s.colorMask != cur.colorMask)
 		setColorMask(s.colorMask);
 
-	if (s.wireframe != cur.wireframe)
+	if (restoring(STATE_WIREFRAME) && s.wireframe != cur.wireframe)
 		setWireframe(s.wireframe);
 
-	setDefaultFilter(s.defaultFilter);
-	setDefaultMipmapFilter(s.defaultMipmapFilter, s.defaultMipmapSharpness);
+	if (restoring(STATE_DEFAULT_FILTER))
+		setDefaultFilter(s.defaultFilter);
+
+	if (restoring(STATE_DEFAULT_MIPMAP_FILTER))
+		setDefaultMipmapFilter(s.defaultMipmapFilter, s.defaultMipmapSharpness);
+}
+
+void Graphics::saveStateFieldSlow(StateField field)
+{
+	SavedState &saved = savedStates.back();
+	DisplayState &s = saved.state;
+	const DisplayState &cur = displayState;
+
+	saved.fields |= 1u << field;
+
+	switch (field)
+	{
+	case STATE_COLOR:
+		s.color = cur.color;
+		break;
+	case STATE_BACKGROUND_COLOR:
+		s.backgroundColor = cur.backgroundColor;
+		break;
+	case STATE_BLEND:
+		s.blendMode = cur.blendMode;
+		s.blendAlphaMode = cur.blendAlphaMode;
+		break;
+	case STATE_LINE_WIDTH:
+		s.lineWidth = cur.lineWidth;
+		break;
+	case STATE_LINE_STYLE:
+		s.lineStyle = cur.lineStyle;
+		break;
+	case STATE_LINE_JOIN:
+		s.lineJoin = cur.lineJoin;
+		break;
+	case STATE_POINT_SIZE:
+		s.pointSize = cur.pointSize;
+		break;
+	case STATE_SCISSOR:
+		s.scissor = cur.scissor;
+		s.scissorRect = cur.scissorRect;
+		break;
+	case STATE_STENCIL:
+		s.stencilCompare = cur.stencilCompare;
+		s.stencilTestValue = cur.stencilTestValue;
+		break;
+	case STATE_DEPTH:
+		s.depthTest = cur.depthTest;
+		s.depthWrite = cur.depthWrite;
+		break;
+	case STATE_MESH_CULL_MODE:
+		s.meshCullMode = cur.meshCullMode;
+		break;
+	case STATE_WINDING:
+		s.winding = cur.winding;
+		break;
+	case STATE_FONT:
+		s.font = cur.font;
+		break;
+	case STATE_SHADER:
+		s.shader = cur.shader;
+		break;
+	case STATE_RENDER_TARGETS:
+		s.renderTargets = cur.renderTargets;
+		break;
+	case STATE_COLOR_MASK:
+		s.colorMask = cur.colorMask;
+		break;
+	case STATE_WIREFRAME:
+		s.wireframe = cur.wireframe;
+		break;
+	case STATE_DEFAULT_FILTER:
+		s.defaultFilter = cur.defaultFilter;
+		break;
+	case STATE_DEFAULT_MIPMAP_FILTER:
+		s.defaultMipmapFilter = cur.defaultMipmapFilter;
+		s.defaultMipmapSharpness = cur.defaultMipmapSharpness;
+		break;
+	case STATE_MAX_ENUM:
+		break;
+	}
 }
 
 Colorf Graphics::getColor() const
 {
-	return states.back().color;
+	return displayState.color;
 }
 
 void Graphics::setBackgroundColor(Colorf c)
 {
-	states.back().backgroundColor = c;
+	saveStateField(STATE_BACKGROUND_COLOR);
+	displayState.backgroundColor = c;
 }
 
 Colorf Graphics::getBackgroundColor() const
 {
-	return states.back().backgroundColor;
+	return displayState.backgroundColor;
 }
 
 void Graphics::checkSetDefaultFont()
 {
 	// We don't create or set the default Font if an existing font is in use.
-	if (states.back().font.get() != nullptr)
+	if (displayState.font.get() != nullptr)
 		return;
 
 	// Create a new default font if we don't have one yet.
 	if (!defaultFont.get())
 		defaultFont.set(newDefaultFont(12, font::TrueTypeRasterizer::HINTING_NORMAL), Acquire::NORETAIN);
 
-	states.back().font.set(defaultFont.get());
+	saveStateField(STATE_FONT);
+	displayState.font.set(defaultFont.get());
 }
 
 void Graphics::setFont(love::graphics::Font *font)
 {
 	// We don't need to set a default font here if null is passed in, since we
 	// only care about the default font in getFont and print.
-	DisplayState &state = states.back();
-	state.font.set(font);
+	saveStateField(STATE_FONT);
+	displayState.font.set(font);
 }
 
 love::graphics::Font *Graphics::getFont()
 {
 	checkSetDefaultFont();
-	return states.back().font.get();
+	return displayState.font.get();
 }
 
 void Graphics::setShader(love::graphics::Shader *shader)
@@ -530,19 +966,30 @@ void Graphics::setShader(love::graphics::Shader *shader)
 	if (shader == nullptr)
 		return setShader();
 
-	shader->attach();
-	states.back().shader.set(shader);
+	if (shader->isCompute())
+		throw love::Exception("Compute shaders can't be used for drawing. Use love.graphics.dispatchThreadgroups instead.");
+
+	shader->finishLoading();
+
+	if (!deferDrawStateChange())
+		shader->attach();
+
+	saveStateField(STATE_SHADER);
+	displayState.shader.set(shader);
 }
 
 void Graphics::setShader()
 {
-	Shader::attachDefault(Shader::STANDARD_DEFAULT);
-	states.back().shader.set(nullptr);
+	if (!deferDrawStateChange())
+		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+
+	saveStateField(STATE_SHADER);
+	displayState.shader.set(nullptr);
 }
 
 love::graphics::Shader *Graphics::getShader() const
 {
-	return states.back().shader.get();
+	return displayState.shader.get();
 }
 
 void Graphics::setCanvas(RenderTarget rt, uint32 temporaryRTFlags)
@@ -567,13 +1014,14 @@ void Graphics::setCanvas(const RenderTargetsStrongRef &rts)
 
 	targets.depthStencil = RenderTarget(rts.depthStencil.canvas, rts.depthStencil.slice, rts.depthStencil.mipmap);
 	targets.temporaryRTFlags = rts.temporaryRTFlags;
+	targets.actions = rts.actions;
 
 	return setCanvas(targets);
 }
 
 void Graphics::setCanvas(const RenderTargets &rts)
 {
-	DisplayState &state = states.back();
+	DisplayState &state = displayState;
 	int ncanvases = (int) rts.colors.size();
 
 	RenderTarget firsttarget = rts.getFirstTarget();
@@ -603,6 +1051,9 @@ void Graphics::setCanvas(const RenderTargets &rts)
 		if (rts.temporaryRTFlags != prevRTs.temporaryRTFlags)
 			modified = true;
 
+		if (!(rts.actions == prevRTs.actions))
+			modified = true;
+
 		if (!modified)
 			return;
 	}
@@ -721,15 +1172,65 @@ void Graphics::setCanvas(const RenderTargets &rts)
 
 	refs.depthStencil = RenderTargetStrongRef(rts.depthStencil.canvas, rts.depthStencil.slice);
 	refs.temporaryRTFlags = rts.temporaryRTFlags;
+	refs.actions = rts.actions;
+
+	// The load actions only apply when the pass begins. Restoring these render
+	// targets later (e.g. via pop) shouldn't clear them again.
+	refs.actions.colorLoad = LOAD_ACTION_LOAD;
+	refs.actions.depthLoad = LOAD_ACTION_LOAD;
+	refs.actions.stencilLoad = LOAD_ACTION_LOAD;
 
+	saveStateField(STATE_RENDER_TARGETS);
 	std::swap(state.renderTargets, refs);
 
+	applyLoadActions(rts);
+
 	canvasSwitchCount++;
 }
 
+void Graphics::applyLoadActions(const RenderTargets &rts)
+{
+	const RenderPassActions &actions = rts.actions;
+	int ncolors = (int) rts.colors.size();
+
+	bool hasdepth = (rts.temporaryRTFlags & TEMPORARY_RT_DEPTH) != 0;
+	bool hasstencil = (rts.temporaryRTFlags & TEMPORARY_RT_STENCIL) != 0;
+
+	if (rts.depthStencil.canvas != nullptr)
+	{
+		PixelFormat dsformat = rts.depthStencil.canvas->getPixelFormat();
+		hasdepth = isPixelFormatDepth(dsformat);
+		hasstencil = isPixelFormatStencil(dsformat);
+	}
+
+	std::vector<OptionalColorf> clearcolors;
+	std::vector<bool> discardcolors;
+
+	if (actions.colorLoad == LOAD_ACTION_CLEAR)
+		clearcolors.assign(ncolors, OptionalColorf(actions.clearColor));
+	else if (actions.colorLoad == LOAD_ACTION_DONT_CARE)
+		discardcolors.assign(ncolors, true);
+
+	OptionalDouble cleardepth;
+	if (hasdepth && actions.depthLoad == LOAD_ACTION_CLEAR)
+		cleardepth = OptionalDouble(actions.clearDepth);
+
+	OptionalInt clearstencil;
+	if (hasstencil && actions.stencilLoad == LOAD_ACTION_CLEAR)
+		clearstencil = OptionalInt(actions.clearStencil);
+
+	bool discarddepth = hasdepth && actions.depthLoad == LOAD_ACTION_DONT_CARE;
+	bool discardstencil = hasstencil && actions.stencilLoad == LOAD_ACTION_DONT_CARE;
+
+	if (!discardcolors.empty() || discarddepth || discardstencil)
+		discard(discardcolors, discarddepth, discardstencil);
+
+	clear(clearcolors, clearstencil, cleardepth);
+}
+
 void Graphics::setCanvas()
 {
-	DisplayState &state = states.back();
+	DisplayState &state = displayState;
 
 	if (state.renderTargets.colors.empty() && state.renderTargets.depthStencil.canvas == nullptr)
 		return;
@@ -737,13 +1238,14 @@ void Graphics::setCanvas()
 	flushStreamDraws();
 	setCanvasInternal(RenderTargets(), width, height, pixelWidth, pixelHeight, isGammaCorrect());
 
+	saveStateField(STATE_RENDER_TARGETS);
 	state.renderTargets = RenderTargetsStrongRef();
 	canvasSwitchCount++;
 }
 
 Graphics::RenderTargets Graphics::getCanvas() const
 {
-	const auto &curRTs = states.back().renderTargets;
+	const auto &curRTs = displayState.renderTargets;
 
 	RenderTargets rts;
 	rts.colors.reserve(curRTs.colors.size());
@@ -753,19 +1255,20 @@ Graphics::RenderTargets Graphics::getCanvas() const
 
 	rts.depthStencil = RenderTarget(curRTs.depthStencil.canvas, curRTs.depthStencil.slice, curRTs.depthStencil.mipmap);
 	rts.temporaryRTFlags = curRTs.temporaryRTFlags;
+	rts.actions = curRTs.actions;
 
 	return rts;
 }
 
 bool Graphics::isCanvasActive() const
 {
-	const auto &rts = states.back().renderTargets;
+	const auto &rts = displayState.renderTargets;
 	return !rts.colors.empty() || rts.depthStencil.canvas != nullptr;
 }
 
 bool Graphics::isCanvasActive(love::graphics::Canvas *canvas) const
 {
-	const auto &rts = states.back().renderTargets;
+	const auto &rts = displayState.renderTargets;
 
 	for (const auto &rt : rts.colors)
 	{
@@ -779,9 +1282,62 @@ bool Graphics::isCanvasActive(love::graphics::Canvas *canvas) const
 	return false;
 }
 
+void Graphics::copyTexture(Texture *src, Texture *dst, const Rect &srcrect, int srcslice, int srcmipmap, int dstx, int dsty, int dstslice, int dstmipmap)
+{
+	PixelFormat format = src->getPixelFormat();
+
+	if (format != dst->getPixelFormat())
+		throw love::Exception("Textures must have the same pixel format to be copied.");
+
+	if (isPixelFormatCompressed(format) || isPixelFormatDepthStencil(format))
+		throw love::Exception("Textures with compressed or depth/stencil formats cannot be copied.");
+
+	if (!src->isReadable() || !dst->isReadable())
+		throw love::Exception("Only readable textures can be copied.");
+
+	if (!src->isValidSlice(srcslice) || !dst->isValidSlice(dstslice))
+		throw love::Exception("Invalid texture slice.");
+
+	if (srcmipmap < 0 || srcmipmap >= src->getMipmapCount() || dstmipmap < 0 || dstmipmap >= dst->getMipmapCount())
+		throw love::Exception("Invalid texture mipmap index.");
+
+	if (srcrect.w <= 0 || srcrect.h <= 0)
+		throw love::Exception("Copied region dimensions must be greater than 0.");
+
+	if (srcrect.x < 0 || srcrect.y < 0 || srcrect.x + srcrect.w > src->getPixelWidth(srcmipmap)
+		|| srcrect.y + srcrect.h > src->getPixelHeight(srcmipmap))
+		throw love::Exception("Copied region is outside of the source texture.");
+
+	if (dstx < 0 || dsty < 0 || dstx + srcrect.w > dst->getPixelWidth(dstmipmap)
+		|| dsty + srcrect.h > dst->getPixelHeight(dstmipmap))
+		throw love::Exception("Copied region is outside of the destination texture.");
+
+	if (src == dst && srcslice == dstslice && srcmipmap == dstmipmap
+		&& srcrect.x < dstx + srcrect.w && dstx < srcrect.x + srcrect.w
+		&& srcrect.y < dsty + srcrect.h && dsty < srcrect.y + srcrect.h)
+		throw love::Exception("Copied regions within the same texture must not overlap.");
+
+	Canvas *srccanvas = dynamic_cast<Canvas *>(src);
+	Canvas *dstcanvas = dynamic_cast<Canvas *>(dst);
+	if ((srccanvas != nullptr && isCanvasActive(srccanvas)) || (dstcanvas != nullptr && isCanvasActive(dstcanvas)))
+		throw love::Exception("Active Canvases cannot be copied to or from.");
+
+	flushStreamDraws();
+
+	Image *srcimage = dynamic_cast<Image *>(src);
+	if (srcimage != nullptr)
+		srcimage->prepareGPUAccess(false);
+
+	Image *dstimage = dynamic_cast<Image *>(dst);
+	if (dstimage != nullptr)
+		dstimage->prepareGPUAccess(true);
+
+	copyTextureInternal(src, dst, srcrect, srcslice, srcmipmap, dstx, dsty, dstslice, dstmipmap);
+}
+
 bool Graphics::isCanvasActive(Canvas *canvas, int slice) const
 {
-	const auto &rts = states.back().renderTargets;
+	const auto &rts = displayState.renderTargets;
 
 	for (const auto &rt : rts.colors)
 	{
@@ -827,90 +1383,229 @@ Canvas *Graphics::getTemporaryCanvas(PixelFormat format, int w, int h, int sampl
 	return canvas;
 }
 
-void Graphics::intersectScissor(const Rect &rect)
+static bool isSameCanvasSettings(const Canvas::Settings &a, const Canvas::Settings &b)
 {
-	Rect currect = states.back().scissorRect;
+	return a.width == b.width && a.height == b.height && a.layers == b.layers
+		&& a.mipmaps == b.mipmaps && a.format == b.format && a.type == b.type
+		&& a.dpiScale == b.dpiScale && a.msaa == b.msaa
+		&& a.readable.hasValue == b.readable.hasValue
+		&& (!a.readable.hasValue || a.readable.value == b.readable.value);
+}
 
-	if (!states.back().scissor)
+Canvas *Graphics::getPooledCanvas(const Canvas::Settings &settings)
+{
+	for (PooledCanvas &pooled : canvasPool)
 	{
-		currect.x = 0;
-		currect.y = 0;
-		currect.w = std::numeric_limits<int>::max();
-		currect.h = std::numeric_limits<int>::max();
+		if (!pooled.usedThisFrame && isSameCanvasSettings(pooled.settings, settings))
+		{
+			pooled.usedThisFrame = true;
+			pooled.framesSinceUse = 0;
+			return pooled.canvas;
+		}
 	}
 
-	int x1 = std::max(currect.x, rect.x);
-	int y1 = std::max(currect.y, rect.y);
-
-	int x2 = std::min(currect.x + currect.w, rect.x + rect.w);
-	int y2 = std::min(currect.y + currect.h, rect.y + rect.h);
+	Canvas *canvas = newCanvas(settings);
+	canvasPool.emplace_back(canvas, settings);
 
-	Rect newrect = {x1, y1, std::max(0, x2 - x1), std::max(0, y2 - y1)};
-	setScissor(newrect);
+	return canvas;
 }
 
-bool Graphics::getScissor(Rect &rect) const
+void Graphics::setCanvasPoolLifetime(int frames)
 {
-	const DisplayState &state = states.back();
-	rect = state.scissorRect;
-	return state.scissor;
+	canvasPoolLifetime = std::max(frames, 0);
 }
 
-void Graphics::setStencilTest()
+int Graphics::getCanvasPoolLifetime() const
 {
-	setStencilTest(COMPARE_ALWAYS, 0);
+	return canvasPoolLifetime;
 }
 
-void Graphics::getStencilTest(CompareMode &compare, int &value) const
+void Graphics::clearCanvasPool()
 {
-	const DisplayState &state = states.back();
-	compare = state.stencilCompare;
-	value = state.stencilTestValue;
+	for (PooledCanvas &pooled : canvasPool)
+		pooled.canvas->release();
+
+	canvasPool.clear();
 }
 
-void Graphics::setDepthMode()
+void Graphics::setTextureBinning(bool enable)
 {
-	setDepthMode(COMPARE_ALWAYS, false);
+	textureBinning = enable;
 }
 
-void Graphics::getDepthMode(CompareMode &compare, bool &write) const
+bool Graphics::isTextureBinningEnabled() const
 {
-	const DisplayState &state = states.back();
-	compare = state.depthTest;
-	write = state.depthWrite;
+	return textureBinning;
 }
 
-void Graphics::setMeshCullMode(CullMode cull)
+bool Graphics::addToTextureBin(Image *image)
+{
+	if (image->getArrayTexture() != nullptr)
+		return true;
+
+	if (image->getTextureType() != TEXTURE_2D || image->getMipmapsType() != Image::MIPMAPS_NONE
+		|| image->getAtlasTexture() != nullptr || image->getImageData(0, 0) == nullptr
+		|| isPixelFormatCompressed(image->getPixelFormat()))
+	{
+		return false;
+	}
+
+	for (const StrongRef<TextureArrayBin> &bin : textureBins)
+	{
+		if (bin->isCompatible(image, false) && bin->add(image))
+			return true;
+	}
+
+	if (!capabilities.textureTypes[TEXTURE_2D_ARRAY])
+		return false;
+
+	int w = image->getPixelWidth();
+	int h = image->getPixelHeight();
+	PixelFormat format = image->getPixelFormat();
+
+	// Large Images would need a lot of memory for a useful number of layers.
+	int64 layersize = (int64) getPixelFormatSize(format) * w * h;
+	int64 layers = std::min(MAX_TEXTURE_BIN_MEMORY / layersize, (int64) MAX_TEXTURE_BIN_LAYERS);
+	layers = std::min(layers, (int64) capabilities.limits[LIMIT_TEXTURE_LAYERS]);
+
+	if (layers < 2)
+		return false;
+
+	StrongRef<TextureArrayBin> bin(newTextureArrayBin(w, h, (int) layers, format, image->isFormatLinear()), Acquire::NORETAIN);
+	textureBins.push_back(bin);
+
+	return bin->add(image);
+}
+
+void Graphics::clearTextureBins()
+{
+	for (const StrongRef<TextureArrayBin> &bin : textureBins)
+		bin->clear();
+
+	textureBins.clear();
+}
+
+void Graphics::updateTextureBins()
+{
+	for (int i = (int) textureBins.size() - 1; i >= 0; i--)
+	{
+		textureBins[i]->removeUnreferenced();
+
+		if (textureBins[i]->getImageCount() == 0)
+		{
+			textureBins[i] = textureBins.back();
+			textureBins.pop_back();
+		}
+	}
+}
+
+void Graphics::updateCanvasPool()
+{
+	for (int i = (int) canvasPool.size() - 1; i >= 0; i--)
+	{
+		PooledCanvas &pooled = canvasPool[i];
+
+		if (pooled.usedThisFrame)
+		{
+			pooled.usedThisFrame = false;
+			continue;
+		}
+
+		if (++pooled.framesSinceUse > canvasPoolLifetime)
+		{
+			pooled.canvas->release();
+			canvasPool[i] = canvasPool.back();
+			canvasPool.pop_back();
+		}
+	}
+}
+
+void Graphics::intersectScissor(const Rect &rect)
+{
+	Rect currect = displayState.scissorRect;
+
+	if (!displayState.scissor)
+	{
+		currect.x = 0;
+		currect.y = 0;
+		currect.w = std::numeric_limits<int>::max();
+		currect.h = std::numeric_limits<int>::max();
+	}
+
+	int x1 = std::max(currect.x, rect.x);
+	int y1 = std::max(currect.y, rect.y);
+
+	int x2 = std::min(currect.x + currect.w, rect.x + rect.w);
+	int y2 = std::min(currect.y + currect.h, rect.y + rect.h);
+
+	Rect newrect = {x1, y1, std::max(0, x2 - x1), std::max(0, y2 - y1)};
+	setScissor(newrect);
+}
+
+bool Graphics::getScissor(Rect &rect) const
+{
+	const DisplayState &state = displayState;
+	rect = state.scissorRect;
+	return state.scissor;
+}
+
+void Graphics::setStencilTest()
+{
+	setStencilTest(COMPARE_ALWAYS, 0);
+}
+
+void Graphics::getStencilTest(CompareMode &compare, int &value) const
+{
+	const DisplayState &state = displayState;
+	compare = state.stencilCompare;
+	value = state.stencilTestValue;
+}
+
+void Graphics::setDepthMode()
+{
+	setDepthMode(COMPARE_ALWAYS, false);
+}
+
+void Graphics::getDepthMode(CompareMode &compare, bool &write) const
+{
+	const DisplayState &state = displayState;
+	compare = state.depthTest;
+	write = state.depthWrite;
+}
+
+void Graphics::setMeshCullMode(CullMode cull)
 {
 	// Handled inside the draw() graphics API implementations.
-	states.back().meshCullMode = cull;
+	saveStateField(STATE_MESH_CULL_MODE);
+	displayState.meshCullMode = cull;
 }
 
 CullMode Graphics::getMeshCullMode() const
 {
-	return states.back().meshCullMode;
+	return displayState.meshCullMode;
 }
 
 vertex::Winding Graphics::getFrontFaceWinding() const
 {
-	return states.back().winding;
+	return displayState.winding;
 }
 
 Graphics::ColorMask Graphics::getColorMask() const
 {
-	return states.back().colorMask;
+	return displayState.colorMask;
 }
 
 Graphics::BlendMode Graphics::getBlendMode(BlendAlpha &alphamode) const
 {
-	alphamode = states.back().blendAlphaMode;
-	return states.back().blendMode;
+	alphamode = displayState.blendAlphaMode;
+	return displayState.blendMode;
 }
 
 void Graphics::setDefaultFilter(const Texture::Filter &f)
 {
 	Texture::defaultFilter = f;
-	states.back().defaultFilter = f;
+	saveStateField(STATE_DEFAULT_FILTER);
+	displayState.defaultFilter = f;
 }
 
 const Texture::Filter &Graphics::getDefaultFilter() const
@@ -923,8 +1618,9 @@ void Graphics::setDefaultMipmapFilter(Texture::FilterMode filter, float sharpnes
 	Texture::defaultMipmapFilter = filter;
 	Texture::defaultMipmapSharpness = sharpness;
 
-	states.back().defaultMipmapFilter = filter;
-	states.back().defaultMipmapSharpness = sharpness;
+	saveStateField(STATE_DEFAULT_MIPMAP_FILTER);
+	displayState.defaultMipmapFilter = filter;
+	displayState.defaultMipmapSharpness = sharpness;
 }
 
 void Graphics::getDefaultMipmapFilter(Texture::FilterMode *filter, float *sharpness) const
@@ -935,42 +1631,55 @@ void Graphics::getDefaultMipmapFilter(Texture::FilterMode *filter, float *sharpn
 
 void Graphics::setLineWidth(float width)
 {
-	states.back().lineWidth = width;
+	saveStateField(STATE_LINE_WIDTH);
+	displayState.lineWidth = width;
 }
 
 void Graphics::setLineStyle(Graphics::LineStyle style)
 {
-	states.back().lineStyle = style;
+	saveStateField(STATE_LINE_STYLE);
+	displayState.lineStyle = style;
 }
 
 void Graphics::setLineJoin(Graphics::LineJoin join)
 {
-	states.back().lineJoin = join;
+	saveStateField(STATE_LINE_JOIN);
+	displayState.lineJoin = join;
 }
 
 float Graphics::getLineWidth() const
 {
-	return states.back().lineWidth;
+	return displayState.lineWidth;
 }
 
 Graphics::LineStyle Graphics::getLineStyle() const
 {
-	return states.back().lineStyle;
+	return displayState.lineStyle;
 }
 
 Graphics::LineJoin Graphics::getLineJoin() const
 {
-	return states.back().lineJoin;
+	return displayState.lineJoin;
+}
+
+void Graphics::setGPULinesEnabled(bool enable)
+{
+	gpuLinesEnabled = enable;
+}
+
+bool Graphics::isGPULinesEnabled() const
+{
+	return gpuLinesEnabled;
 }
 
 float Graphics::getPointSize() const
 {
-	return states.back().pointSize;
+	return displayState.pointSize;
 }
 
 bool Graphics::isWireframe() const
 {
-	return states.back().wireframe;
+	return displayState.wireframe;
 }
 
 void Graphics::captureScreenshot(const ScreenshotInfo &info)
@@ -982,20 +1691,41 @@ Graphics::StreamVertexData Graphics::requestStreamDraw(const StreamDrawCommand &
 {
 	using namespace vertex;
 
+	if (isRecordingDeferredDraws())
+	{
+		// The point size and video textures aren't part of the recorded state,
+		// so those draws happen immediately.
+		if (cmd.primitiveMode != PRIMITIVE_POINTS && cmd.standardShaderType != Shader::STANDARD_VIDEO)
+			return recordDeferredDraw(cmd);
+
+		submitDeferredDraws();
+	}
+
+	// Lines drawn by the GPU line path must be drawn before anything after them.
+	if (lineBatchState.segmentCount > 0)
+		flushLineBatch();
+
 	StreamBufferState &state = streamBufferState;
 
 	bool shouldflush = false;
 	bool shouldresize = false;
 
-	if (cmd.primitiveMode != state.primitiveMode
+	StreamFlushReason flushreason = STREAM_FLUSH_BUFFER_FULL;
+
+	if (cmd.texture != state.texture)
+		flushreason = STREAM_FLUSH_TEXTURE;
+	else if (cmd.standardShaderType != state.standardShaderType)
+		flushreason = STREAM_FLUSH_SHADER;
+	else if (cmd.primitiveMode != state.primitiveMode
 		|| cmd.formats[0] != state.formats[0] || cmd.formats[1] != state.formats[1]
-		|| ((cmd.indexMode != TriangleIndexMode::NONE) != (state.indexCount > 0))
-		|| cmd.texture != state.texture
-		|| cmd.standardShaderType != state.standardShaderType)
+		|| ((cmd.indexMode != TriangleIndexMode::NONE) != (state.indexCount > 0)))
 	{
-		shouldflush = true;
+		flushreason = STREAM_FLUSH_VERTEX_FORMAT;
 	}
 
+	if (flushreason != STREAM_FLUSH_BUFFER_FULL)
+		shouldflush = true;
+
 	int totalvertices = state.vertexCount + cmd.vertexCount;
 
 	// We only support uint16 index buffers for now.
@@ -1044,7 +1774,9 @@ Graphics::StreamVertexData Graphics::requestStreamDraw(const StreamDrawCommand &
 
 	if (shouldflush || shouldresize)
 	{
+		pendingStreamFlushReason = flushreason;
 		flushStreamDraws();
+		pendingStreamFlushReason = STREAM_FLUSH_STATE;
 
 		state.primitiveMode = cmd.primitiveMode;
 		state.formats[0] = cmd.formats[0];
@@ -1061,19 +1793,16 @@ Graphics::StreamVertexData Graphics::requestStreamDraw(const StreamDrawCommand &
 
 	if (shouldresize)
 	{
-		for (int i = 0; i < 2; i++)
+		for (int i = 0; i < 3; i++)
 		{
-			if (state.vb[i]->getSize() < buffersizes[i])
+			if (getStreamBuffer(i)->getSize() < buffersizes[i])
 			{
-				delete state.vb[i];
-				state.vb[i] = newStreamBuffer(BUFFER_VERTEX, buffersizes[i]);
-			}
-		}
+				resizeStreamBuffer(i, buffersizes[i]);
 
-		if (state.indexBuffer->getSize() < buffersizes[2])
-		{
-			delete state.indexBuffer;
-			state.indexBuffer = newStreamBuffer(BUFFER_INDEX, buffersizes[2]);
+				StreamBuffer::FrameStats stats = getStreamBuffer(i)->getFrameStats();
+				stats.wraps++;
+				getStreamBuffer(i)->setFrameStats(stats);
+			}
 		}
 	}
 
@@ -1114,13 +1843,24 @@ Graphics::StreamVertexData Graphics::requestStreamDraw(const StreamDrawCommand &
 
 void Graphics::flushStreamDraws()
 {
+	LOVE_PROFILE_ZONE("Graphics:flushStreamDraws");
+
 	using namespace vertex;
 
+	// Anything which needs the stream batcher flushed also needs recorded
+	// draws to be submitted before it.
+	if (isRecordingDeferredDraws())
+		submitDeferredDraws();
+
+	flushLineBatch();
+
 	auto &sbstate = streamBufferState;
 
 	if (sbstate.vertexCount == 0 && sbstate.indexCount == 0)
 		return;
 
+	streamFlushCounts[pendingStreamFlushReason]++;
+
 	Attributes attributes;
 	Buffers buffers;
 
@@ -1191,6 +1931,281 @@ void Graphics::flushStreamDraws()
 	streamBufferState.indexCount = 0;
 }
 
+void Graphics::beginDeferredDraws(bool batchStencil)
+{
+	if (deferringDraws)
+		throw love::Exception("Draws are already being deferred.");
+
+	if (batchStencil && writingToStencil)
+		throw love::Exception("Stencil batching can't begin while drawing to the stencil buffer.");
+
+	flushStreamDraws();
+
+	deferringDraws = true;
+	deferredStateChanged = false;
+	deferringStencil = batchStencil;
+	deferredStencilWrite = StencilWriteState();
+	deferredStencilClear = OptionalInt();
+}
+
+void Graphics::endDeferredDraws()
+{
+	if (!deferringDraws)
+		throw love::Exception("endDeferredDraws called without a matching beginDeferredDraws.");
+
+	submitDeferredDraws();
+	deferringDraws = false;
+	deferringStencil = false;
+}
+
+bool Graphics::isDeferringDraws() const
+{
+	return deferringDraws;
+}
+
+void Graphics::setDeferredLayer(int layer)
+{
+	deferredLayer = layer;
+}
+
+int Graphics::getDeferredLayer() const
+{
+	return deferredLayer;
+}
+
+bool Graphics::isRecordingDeferredDraws() const
+{
+	return deferringDraws && !submittingDeferredDraws;
+}
+
+bool Graphics::deferDrawStateChange()
+{
+	if (!isRecordingDeferredDraws())
+		return false;
+
+	deferredStateChanged = true;
+	return true;
+}
+
+bool Graphics::deferStencilStateChange()
+{
+	if (!deferringStencil)
+		return false;
+
+	return deferDrawStateChange();
+}
+
+bool Graphics::deferStencilClear(int value)
+{
+	if (!deferringStencil || !isRecordingDeferredDraws())
+		return false;
+
+	// Only one clear is done per submission.
+	if (deferredStencilClear.hasValue && deferredStencilClear.value != value)
+		submitDeferredDraws();
+
+	deferredStencilClear.set(value);
+	deferredStateChanged = true;
+	return true;
+}
+
+void Graphics::applyDeferredStencilState(const DeferredDraw &draw)
+{
+	if (draw.stencilWrite)
+		drawToStencilBuffer(draw.stencilAction, draw.stencilValue);
+	else
+	{
+		if (writingToStencil)
+			stopDrawToStencilBuffer();
+
+		setStencilTest(draw.stencilCompare, draw.stencilValue);
+	}
+}
+
+Graphics::StreamVertexData Graphics::recordDeferredDraw(const StreamDrawCommand &cmd)
+{
+	const DisplayState &state = displayState;
+
+	if (state.shader.get() != nullptr && cmd.texture != nullptr)
+		state.shader->checkMainTexture(cmd.texture);
+
+	DeferredDraw draw;
+	draw.layer = deferredLayer;
+	draw.shader.set(state.shader.get());
+	draw.blendMode = state.blendMode;
+	draw.blendAlphaMode = state.blendAlphaMode;
+	draw.command = cmd;
+	draw.texture.set(cmd.texture);
+
+	draw.stencilWrite = deferringStencil && deferredStencilWrite.active;
+	draw.stencilAction = deferredStencilWrite.action;
+	draw.stencilCompare = deferringStencil ? state.stencilCompare : COMPARE_ALWAYS;
+	draw.stencilValue = draw.stencilWrite ? deferredStencilWrite.value : state.stencilTestValue;
+
+	StreamVertexData d;
+
+	for (int i = 0; i < 2; i++)
+	{
+		draw.vertexOffsets[i] = 0;
+		d.stream[i] = nullptr;
+
+		if (cmd.formats[i] == vertex::CommonFormat::NONE)
+			continue;
+
+		std::vector<uint8> &vertices = deferredVertices[i];
+
+		draw.vertexOffsets[i] = vertices.size();
+		vertices.resize(vertices.size() + vertex::getFormatStride(cmd.formats[i]) * cmd.vertexCount);
+
+		d.stream[i] = &vertices[draw.vertexOffsets[i]];
+	}
+
+	deferredDraws.push_back(draw);
+	return d;
+}
+
+void Graphics::submitDeferredDraws()
+{
+	if (!isRecordingDeferredDraws() || (deferredDraws.empty() && !deferredStateChanged))
+		return;
+
+	submittingDeferredDraws = true;
+
+	// Immediate draws made while recording ran with the state from before any
+	// deferred changes, which are about to be applied.
+	flushStreamDraws();
+
+	DisplayState &state = displayState;
+
+	// The state which was current when the draws were recorded hasn't been
+	// applied, so the first draw always sets it.
+	StrongRef<Shader> usershader = state.shader;
+	BlendMode userblend = state.blendMode;
+	BlendAlpha useralpha = state.blendAlphaMode;
+
+	StencilWriteState userstencilwrite = deferredStencilWrite;
+	CompareMode userstencilcompare = state.stencilCompare;
+	int userstencilvalue = state.stencilTestValue;
+
+	deferredDrawOrder.resize(deferredDraws.size());
+	for (int i = 0; i < (int) deferredDraws.size(); i++)
+		deferredDrawOrder[i] = i;
+
+	// Only the layer has to keep its order, the rest is for batching.
+	std::stable_sort(deferredDrawOrder.begin(), deferredDrawOrder.end(), [this](int a, int b)
+	{
+		const DeferredDraw &da = deferredDraws[a];
+		const DeferredDraw &db = deferredDraws[b];
+
+		if (da.layer != db.layer)
+			return da.layer < db.layer;
+
+		// Stencil masks come before the draws which are clipped by them.
+		if (da.stencilWrite != db.stencilWrite)
+			return da.stencilWrite;
+		if (da.stencilWrite && da.stencilAction != db.stencilAction)
+			return da.stencilAction < db.stencilAction;
+		if (!da.stencilWrite && da.stencilCompare != db.stencilCompare)
+			return da.stencilCompare < db.stencilCompare;
+		if (da.stencilValue != db.stencilValue)
+			return da.stencilValue < db.stencilValue;
+
+		if (da.shader.get() != db.shader.get())
+			return da.shader.get() < db.shader.get();
+		if (da.command.standardShaderType != db.command.standardShaderType)
+			return da.command.standardShaderType < db.command.standardShaderType;
+		if (da.texture.get() != db.texture.get())
+			return da.texture.get() < db.texture.get();
+		if (da.blendMode != db.blendMode)
+			return da.blendMode < db.blendMode;
+		return da.blendAlphaMode < db.blendAlphaMode;
+	});
+
+	try
+	{
+		if (deferredStencilClear.hasValue)
+		{
+			OptionalInt stencilclear = deferredStencilClear;
+			deferredStencilClear = OptionalInt();
+			clear(OptionalColorf(), stencilclear, OptionalDouble());
+		}
+
+		bool first = true;
+		const DeferredDraw *prev = nullptr;
+
+		for (int index : deferredDrawOrder)
+		{
+			const DeferredDraw &draw = deferredDraws[index];
+
+			if (deferringStencil && (prev == nullptr || draw.stencilWrite != prev->stencilWrite
+				|| draw.stencilAction != prev->stencilAction || draw.stencilCompare != prev->stencilCompare
+				|| draw.stencilValue != prev->stencilValue))
+			{
+				applyDeferredStencilState(draw);
+			}
+
+			prev = &draw;
+
+			if (first || draw.shader.get() != state.shader.get())
+			{
+				if (draw.shader.get() != nullptr)
+					setShader(draw.shader.get());
+				else
+					setShader();
+			}
+
+			if (first || draw.blendMode != state.blendMode || draw.blendAlphaMode != state.blendAlphaMode)
+				setBlendMode(draw.blendMode, draw.blendAlphaMode);
+
+			first = false;
+
+			StreamVertexData data = requestStreamDraw(draw.command);
+
+			for (int i = 0; i < 2; i++)
+			{
+				if (draw.command.formats[i] == vertex::CommonFormat::NONE)
+					continue;
+
+				size_t size = vertex::getFormatStride(draw.command.formats[i]) * draw.command.vertexCount;
+				memcpy(data.stream[i], &deferredVertices[i][draw.vertexOffsets[i]], size);
+			}
+		}
+
+		if (usershader.get() != nullptr)
+			setShader(usershader.get());
+		else
+			setShader();
+
+		setBlendMode(userblend, useralpha);
+
+		if (deferringStencil)
+		{
+			if (writingToStencil)
+				stopDrawToStencilBuffer();
+
+			setStencilTest(userstencilcompare, userstencilvalue);
+
+			if (userstencilwrite.active)
+				drawToStencilBuffer(userstencilwrite.action, userstencilwrite.value);
+		}
+	}
+	catch (love::Exception &)
+	{
+		submittingDeferredDraws = false;
+		deferredDraws.clear();
+		deferredVertices[0].clear();
+		deferredVertices[1].clear();
+		throw;
+	}
+
+	submittingDeferredDraws = false;
+	deferredStateChanged = false;
+
+	deferredDraws.clear();
+	deferredVertices[0].clear();
+	deferredVertices[1].clear();
+}
+
 void Graphics::flushStreamDrawsGlobal()
 {
 	Graphics *instance = getInstance<Graphics>(M_GRAPHICS);
@@ -1212,6 +2227,11 @@ void Graphics::draw(Texture *texture, Quad *quad, const Matrix4 &m)
 	texture->draw(this, quad, m);
 }
 
+void Graphics::draw(Texture *texture, QuadAtlas *atlas, int frame, const Matrix4 &m)
+{
+	texture->draw(this, atlas, frame, m);
+}
+
 void Graphics::drawLayer(Texture *texture, int layer, const Matrix4 &m)
 {
 	texture->drawLayer(this, layer, m);
@@ -1222,124 +2242,499 @@ void Graphics::drawLayer(Texture *texture, int layer, Quad *quad, const Matrix4
 	texture->drawLayer(this, layer, quad, m);
 }
 
+void Graphics::drawLayer(Texture *texture, int layer, QuadAtlas *atlas, int frame, const Matrix4 &m)
+{
+	texture->drawLayer(this, layer, atlas, frame, m);
+}
+
 void Graphics::drawInstanced(Mesh *mesh, const Matrix4 &m, int instancecount)
 {
 	mesh->drawInstanced(this, m, instancecount);
 }
 
+void Graphics::drawIndirect(Mesh *mesh, const Matrix4 &m, const void *records, int drawcount)
+{
+	mesh->drawIndirect(this, m, records, drawcount);
+}
+
 void Graphics::print(const std::vector<Font::ColoredString> &str, const Matrix4 &m)
 {
 	checkSetDefaultFont();
 
-	if (states.back().font.get() != nullptr)
-		print(str, states.back().font.get(), m);
+	if (displayState.font.get() != nullptr)
+		print(str, displayState.font.get(), m);
 }
 
 void Graphics::print(const std::vector<Font::ColoredString> &str, Font *font, const Matrix4 &m)
 {
-	font->print(this, str, m, states.back().color);
+	font->print(this, str, m, displayState.color);
 }
 
 void Graphics::printf(const std::vector<Font::ColoredString> &str, float wrap, Font::AlignMode align, const Matrix4 &m)
 {
 	checkSetDefaultFont();
 
-	if (states.back().font.get() != nullptr)
-		printf(str, states.back().font.get(), wrap, align, m);
+	if (displayState.font.get() != nullptr)
+		printf(str, displayState.font.get(), wrap, align, m);
 }
 
 void Graphics::printf(const std::vector<Font::ColoredString> &str, Font *font, float wrap, Font::AlignMode align, const Matrix4 &m)
 {
-	font->printf(this, str, wrap, align, m, states.back().color);
+	font->printf(this, str, wrap, align, m, displayState.color);
 }
 
-/**
- * Primitives (points, shapes, lines).
- **/
+/**
+ * Primitives (points, shapes, lines).
+ **/
+
+void Graphics::points(const Vector2 *positions, const Colorf *colors, size_t numpoints)
+{
+	const Matrix4 &t = getTransform();
+	bool is2D = t.isAffine2DTransform();
+
+	StreamDrawCommand cmd;
+	cmd.primitiveMode = PRIMITIVE_POINTS;
+	cmd.formats[0] = vertex::getSinglePositionFormat(is2D);
+	cmd.formats[1] = vertex::CommonFormat::RGBAub;
+	cmd.vertexCount = (int) numpoints;
+
+	StreamVertexData data = requestStreamDraw(cmd);
+
+	if (is2D)
+		t.transformXY((Vector2 *) data.stream[0], positions, cmd.vertexCount);
+	else
+		t.transformXY0((Vector3 *) data.stream[0], positions, cmd.vertexCount);
+
+	Color *colordata = (Color *) data.stream[1];
+
+	if (colors)
+	{
+		Colorf nc = getColor();
+		gammaCorrectColor(nc);
+
+		if (isGammaCorrect())
+		{
+			for (int i = 0; i < cmd.vertexCount; i++)
+			{
+				Colorf ci = colors[i];
+				gammaCorrectColor(ci);
+				ci *= nc;
+				unGammaCorrectColor(ci);
+				colordata[i] = toColor(ci);
+			}
+		}
+		else
+		{
+			for (int i = 0; i < cmd.vertexCount; i++)
+				colordata[i] = toColor(nc * colors[i]);
+		}
+	}
+	else
+	{
+		Color c = toColor(getColor());
+
+		for (int i = 0; i < cmd.vertexCount; i++)
+			colordata[i] = c;
+	}
+}
+
+void Graphics::points(const vertex::XYf_RGBAub_Sf *points, size_t numpoints)
+{
+	const Matrix4 &t = getTransform();
+	bool is2D = t.isAffine2DTransform();
+
+	StreamDrawCommand cmd;
+	cmd.primitiveMode = PRIMITIVE_POINTS;
+	cmd.formats[0] = vertex::getSinglePositionFormat(is2D);
+	cmd.formats[1] = vertex::CommonFormat::RGBAub_Sf;
+	cmd.vertexCount = (int) numpoints;
+
+	StreamVertexData data = requestStreamDraw(cmd);
+
+	const size_t srcstride = sizeof(vertex::XYf_RGBAub_Sf);
+
+	if (is2D)
+		t.transformXY((float *) data.stream[0], sizeof(float) * 2, &points[0].x, srcstride, cmd.vertexCount);
+	else
+		t.transformXY0((float *) data.stream[0], sizeof(float) * 3, &points[0].x, srcstride, cmd.vertexCount);
+
+	vertex::RGBAub_Sf *attribdata = (vertex::RGBAub_Sf *) data.stream[1];
+
+	Colorf nc = getColor();
+
+	if (nc.r == 1.0f && nc.g == 1.0f && nc.b == 1.0f && nc.a == 1.0f)
+	{
+		for (int i = 0; i < cmd.vertexCount; i++)
+		{
+			attribdata[i].color = points[i].color;
+			attribdata[i].size = points[i].size;
+		}
+	}
+	else if (isGammaCorrect())
+	{
+		gammaCorrectColor(nc);
+
+		for (int i = 0; i < cmd.vertexCount; i++)
+		{
+			Colorf ci = toColorf(points[i].color);
+			gammaCorrectColor(ci);
+			ci *= nc;
+			unGammaCorrectColor(ci);
+			attribdata[i].color = toColor(ci);
+			attribdata[i].size = points[i].size;
+		}
+	}
+	else
+	{
+		for (int i = 0; i < cmd.vertexCount; i++)
+		{
+			attribdata[i].color = toColor(nc * toColorf(points[i].color));
+			attribdata[i].size = points[i].size;
+		}
+	}
+}
+
+int Graphics::calculateEllipsePoints(float rx, float ry) const
+{
+	int points = (int) sqrtf(((rx + ry) / 2.0f) * 20.0f * (float) pixelScaleStack.back());
+	return std::max(points, 8);
+}
+
+const Vector2 *Graphics::getUnitArcPoints(float angle1, float angleshift, int count)
+{
+	UnitArcKey key = {angle1, angleshift, count};
+
+	auto it = unitArcCache.find(key);
+	if (it != unitArcCache.end())
+		return it->second.data();
+
+	// Lots of distinct shapes are better off not being cached at all than
+	// growing the cache forever.
+	if (unitArcCache.size() >= MAX_UNIT_ARC_CACHE_SIZE)
+		unitArcCache.clear();
+
+	std::vector<Vector2> &points = unitArcCache[key];
+	points.resize(count);
+
+	for (int i = 0; i < count; i++)
+	{
+		float phi = angle1 + angleshift * (float) i;
+		points[i] = Vector2(cosf(phi), sinf(phi));
+	}
+
+	return points.data();
+}
+
+void Graphics::polyline(const Vector2 *vertices, size_t count)
+{
+	float halfwidth = getLineWidth() * 0.5f;
+	LineJoin linejoin = getLineJoin();
+	LineStyle linestyle = getLineStyle();
+
+	float pixelsize = 1.0f / std::max((float) pixelScaleStack.back(), 0.000001f);
+
+	if (canDrawGPULines())
+	{
+		polylineGPU(vertices, count);
+	}
+	else if (linejoin == LINE_JOIN_NONE)
+	{
+		NoneJoinPolyline line;
+		line.render(vertices, count, halfwidth, pixelsize, linestyle == LINE_SMOOTH);
+		line.draw(this);
+	}
+	else if (linejoin == LINE_JOIN_BEVEL)
+	{
+		BevelJoinPolyline line;
+		line.render(vertices, count, halfwidth, pixelsize, linestyle == LINE_SMOOTH);
+		line.draw(this);
+	}
+	else if (linejoin == LINE_JOIN_MITER)
+	{
+		MiterJoinPolyline line;
+		line.render(vertices, count, halfwidth, pixelsize, linestyle == LINE_SMOOTH);
+		line.draw(this);
+	}
+}
+
+bool Graphics::canDrawGPULines() const
+{
+	if (!gpuLinesEnabled || !capabilities.features[FEATURE_INSTANCING])
+		return false;
+
+	if (Shader::standardShaders[Shader::STANDARD_LINE] == nullptr || !Shader::isDefaultActive())
+		return false;
+
+	// Bevel joins need extra geometry between segments, and recorded draws
+	// only support the stream batcher.
+	if (getLineJoin() == LINE_JOIN_BEVEL || isRecordingDeferredDraws())
+		return false;
+
+	return getTransform().isAffine2DTransform();
+}
+
+void Graphics::bezier(const love::math::BezierCurve * const *curves, size_t count, double tolerance)
+{
+	curvePoints.clear();
+	curveChainStarts.clear();
+
+	love::math::BezierCurve::renderAdaptive(curves, count, tolerance, curvePoints, curveChainStarts);
+
+	for (size_t i = 0; i < curveChainStarts.size(); i++)
+	{
+		size_t start = curveChainStarts[i];
+		size_t end = i + 1 < curveChainStarts.size() ? curveChainStarts[i + 1] : curvePoints.size();
+
+		if (end - start >= 2)
+			polyline(&curvePoints[start], end - start);
+	}
+}
+
+void Graphics::polylineGPU(const Vector2 *vertices, size_t count)
+{
+	if (count < 2)
+		return;
+
+	LineBatchState &state = lineBatchState;
+
+	bool smooth = getLineStyle() == LINE_SMOOTH;
+	bool miter = getLineJoin() == LINE_JOIN_MITER;
+
+	if (streamBufferState.vertexCount > 0 || (state.segmentCount > 0 && state.smooth != smooth))
+		flushStreamDraws();
+
+	if (state.buffer == nullptr)
+		state.buffer = newStreamBuffer(BUFFER_VERTEX, 1024 * 1024 * 1);
+
+	createLineCornerBuffer();
+
+	if (state.segmentCount > 0)
+		drawCallsBatched++;
+
+	state.smooth = smooth;
+
+	// Points are transformed here so lines drawn with different transforms
+	// can share a draw call. The CPU path extrudes lines before transforming
+	// them, so the widths are scaled to match (exactly, for uniform scales).
+	const float *e = getTransform().getElements();
+	float scale = sqrtf(fabsf(e[0] * e[5] - e[4] * e[1]));
+
+	float pixelsize = 1.0f / std::max((float) pixelScaleStack.back(), 0.000001f);
+	float halfwidth = getLineWidth() * 0.5f;
+	if (smooth)
+		halfwidth -= pixelsize * 0.3f;
+
+	LineSegment segment;
+	segment.halfWidth = halfwidth * scale;
+	segment.fringeWidth = smooth ? pixelsize * scale : 0.0f;
+	segment.color = toColor(getColor());
+
+	auto transformed = [&](size_t i) -> Vector2
+	{
+		const Vector2 &v = vertices[i];
+		return Vector2(e[0] * v.x + e[4] * v.y + e[12], e[1] * v.x + e[5] * v.y + e[13]);
+	};
+
+	bool looping = miter && count > 2 && vertices[0] == vertices[count - 1];
+
+	const size_t stride = sizeof(LineSegment);
+	size_t segmentcount = count - 1;
+
+	Vector2 start = transformed(0);
+	Vector2 end = transformed(1);
+	Vector2 prev = looping ? transformed(count - 2) : start;
+
+	for (size_t i = 0; i < segmentcount; i++)
+	{
+		Vector2 following = end;
+		if (i + 2 < count)
+			following = transformed(i + 2);
+		else if (looping)
+			following = transformed(1);
+
+		if (state.map.data == nullptr || (state.segmentCount + 1) * stride > state.map.size)
+		{
+			flushLineBatch();
+			state.map = state.buffer->map(std::min((segmentcount - i) * stride, state.buffer->getUsableSize()));
+			state.smooth = smooth;
+		}
+
+		segment.prev = miter ? prev : start;
+		segment.start = start;
+		segment.end = end;
+		segment.next = miter ? following : end;
+
+		memcpy(state.map.data + state.segmentCount * stride, &segment, stride);
+		state.segmentCount++;
+
+		prev = start;
+		start = end;
+		end = following;
+	}
+}
+
+void Graphics::flushLineBatch()
+{
+	using namespace vertex;
+
+	LineBatchState &state = lineBatchState;
+
+	int segmentcount = state.segmentCount;
+	if (segmentcount == 0)
+		return;
+
+	// Attaching the line shader flushes stream draws, which would flush this
+	// batch again.
+	state.segmentCount = 0;
+
+	if (Shader::isDefaultActive())
+		Shader::attachDefault(Shader::STANDARD_LINE);
+
+	Shader *shader = Shader::current;
+
+	const size_t stride = sizeof(LineSegment);
+	size_t usedsize = stride * segmentcount;
+
+	Attributes attributes;
+	Buffers buffers;
+
+	attributes.set(ATTRIB_POS, DATA_FLOAT, 3, 0, sizeof(float) * 3, 0);
+	buffers.set(0, lineCornerBuffer, 0);
+
+	int segmenta = shader->getVertexAttributeIndex("LineSegmentA");
+	int segmentb = shader->getVertexAttributeIndex("LineSegmentB");
+	int params = shader->getVertexAttributeIndex("LineParams");
+
+	if (segmenta >= 0)
+		attributes.set(segmenta, DATA_FLOAT, 4, (uint16) offsetof(LineSegment, prev), (uint16) stride, 1, STEP_PER_INSTANCE);
+	if (segmentb >= 0)
+		attributes.set(segmentb, DATA_FLOAT, 4, (uint16) offsetof(LineSegment, end), (uint16) stride, 1, STEP_PER_INSTANCE);
+	if (params >= 0)
+		attributes.set(params, DATA_FLOAT, 2, (uint16) offsetof(LineSegment, halfWidth), (uint16) stride, 1, STEP_PER_INSTANCE);
+
+	attributes.set(ATTRIB_COLOR, DATA_UNORM8, 4, (uint16) offsetof(LineSegment, color), (uint16) stride, 1, STEP_PER_INSTANCE);
+
+	buffers.set(1, state.buffer, state.buffer->unmap(usedsize));
+	state.map = StreamBuffer::MapInfo();
+
+	Colorf nc = getColor();
+	setColor(Colorf(1.0f, 1.0f, 1.0f, 1.0f));
+
+	pushIdentityTransform();
+
+	// One quad per segment for rough lines, plus two for the smooth fringe.
+	DrawIndexedCommand cmd(&attributes, &buffers, quadIndexBuffer);
+	cmd.primitiveType = PRIMITIVE_TRIANGLES;
+	cmd.indexCount = state.smooth ? 18 : 6;
+	cmd.instanceCount = segmentcount;
+	cmd.indexType = INDEX_UINT16;
+	draw(cmd);
+
+	state.buffer->markUsed(usedsize);
+
+	popTransform();
+	setColor(nc);
+}
+
+bool Graphics::canDrawInstancedGlyphs(bool distancefield) const
+{
+	if (!capabilities.features[FEATURE_INSTANCING])
+		return false;
+
+	Shader::StandardShader type = distancefield ? Shader::STANDARD_INSTANCED_GLYPH_DISTANCE_FIELD : Shader::STANDARD_INSTANCED_GLYPH;
+	if (Shader::standardShaders[type] == nullptr)
+		return false;
+
+	// Custom shaders expect the regular glyph vertices, and recorded draws
+	// only support the stream batcher.
+	return Shader::isDefaultActive() && !isRecordingDeferredDraws();
+}
+
+void Graphics::drawInstancedGlyphs(Texture *texture, bool distancefield, const Matrix4 &m, const vertex::XYf_STus_RGBAub *quads, int glyphcount)
+{
+	using namespace vertex;
+
+	if (glyphcount <= 0)
+		return;
+
+	flushStreamDraws();
+
+	if (glyphInstanceBuffer == nullptr)
+		glyphInstanceBuffer = newStreamBuffer(BUFFER_VERTEX, 256 * 1024);
+
+	createGlyphCornerBuffer();
+
+	Shader::attachDefault(distancefield ? Shader::STANDARD_INSTANCED_GLYPH_DISTANCE_FIELD : Shader::STANDARD_INSTANCED_GLYPH);
+
+	Shader *shader = Shader::current;
+	shader->checkMainTexture(texture);
+
+	const size_t stride = sizeof(GlyphInstance);
+
+	Attributes attributes;
+	Buffers buffers;
+
+	attributes.set(ATTRIB_POS, DATA_FLOAT, 2, 0, sizeof(float) * 2, 0);
+	buffers.set(0, glyphCornerBuffer, 0);
 
-void Graphics::points(const Vector2 *positions, const Colorf *colors, size_t numpoints)
-{
-	const Matrix4 &t = getTransform();
-	bool is2D = t.isAffine2DTransform();
+	int rectindex = shader->getVertexAttributeIndex("GlyphRect");
+	int texrectindex = shader->getVertexAttributeIndex("GlyphTexRect");
 
-	StreamDrawCommand cmd;
-	cmd.primitiveMode = PRIMITIVE_POINTS;
-	cmd.formats[0] = vertex::getSinglePositionFormat(is2D);
-	cmd.formats[1] = vertex::CommonFormat::RGBAub;
-	cmd.vertexCount = (int) numpoints;
+	if (rectindex >= 0)
+		attributes.set(rectindex, DATA_FLOAT, 4, (uint16) offsetof(GlyphInstance, rect), (uint16) stride, 1, STEP_PER_INSTANCE);
+	if (texrectindex >= 0)
+		attributes.set(texrectindex, DATA_UNORM16, 4, (uint16) offsetof(GlyphInstance, texRect), (uint16) stride, 1, STEP_PER_INSTANCE);
 
-	StreamVertexData data = requestStreamDraw(cmd);
+	attributes.set(ATTRIB_COLOR, DATA_UNORM8, 4, (uint16) offsetof(GlyphInstance, color), (uint16) stride, 1, STEP_PER_INSTANCE);
 
-	if (is2D)
-		t.transformXY((Vector2 *) data.stream[0], positions, cmd.vertexCount);
-	else
-		t.transformXY0((Vector3 *) data.stream[0], positions, cmd.vertexCount);
+	// The glyph colors already include the global color.
+	Colorf nc = getColor();
+	setColor(Colorf(1.0f, 1.0f, 1.0f, 1.0f));
 
-	Color *colordata = (Color *) data.stream[1];
+	TempTransform transform(this, m);
 
-	if (colors)
-	{
-		Colorf nc = getColor();
-		gammaCorrectColor(nc);
+	int maxinstances = (int) (glyphInstanceBuffer->getUsableSize() / stride);
 
-		if (isGammaCorrect())
-		{
-			for (int i = 0; i < cmd.vertexCount; i++)
-			{
-				Colorf ci = colors[i];
-				gammaCorrectColor(ci);
-				ci *= nc;
-				unGammaCorrectColor(ci);
-				colordata[i] = toColor(ci);
-			}
-		}
-		else
-		{
-			for (int i = 0; i < cmd.vertexCount; i++)
-				colordata[i] = toColor(nc * colors[i]);
-		}
-	}
-	else
+	for (int start = 0; start < glyphcount; start += maxinstances)
 	{
-		Color c = toColor(getColor());
+		int count = std::min(glyphcount - start, maxinstances);
+		size_t usedsize = stride * count;
 
-		for (int i = 0; i < cmd.vertexCount; i++)
-			colordata[i] = c;
-	}
-}
+		StreamBuffer::MapInfo map = glyphInstanceBuffer->map(usedsize);
+		GlyphInstance *instances = (GlyphInstance *) map.data;
 
-int Graphics::calculateEllipsePoints(float rx, float ry) const
-{
-	int points = (int) sqrtf(((rx + ry) / 2.0f) * 20.0f * (float) pixelScaleStack.back());
-	return std::max(points, 8);
-}
+		for (int i = 0; i < count; i++)
+		{
+			// The first and last vertices of a glyph are its opposite corners.
+			const XYf_STus_RGBAub &a = quads[(start + i) * 4 + 0];
+			const XYf_STus_RGBAub &b = quads[(start + i) * 4 + 3];
+
+			GlyphInstance &instance = instances[i];
+			instance.rect[0] = a.x;
+			instance.rect[1] = a.y;
+			instance.rect[2] = b.x;
+			instance.rect[3] = b.y;
+			instance.texRect[0] = a.s;
+			instance.texRect[1] = a.t;
+			instance.texRect[2] = b.s;
+			instance.texRect[3] = b.t;
+			instance.color = a.color;
+		}
 
-void Graphics::polyline(const Vector2 *vertices, size_t count)
-{
-	float halfwidth = getLineWidth() * 0.5f;
-	LineJoin linejoin = getLineJoin();
-	LineStyle linestyle = getLineStyle();
+		buffers.set(1, glyphInstanceBuffer, glyphInstanceBuffer->unmap(usedsize));
 
-	float pixelsize = 1.0f / std::max((float) pixelScaleStack.back(), 0.000001f);
+		DrawCommand cmd(&attributes, &buffers);
+		cmd.primitiveType = PRIMITIVE_TRIANGLE_STRIP;
+		cmd.vertexStart = 0;
+		cmd.vertexCount = 4;
+		cmd.instanceCount = count;
+		cmd.texture = texture;
+		draw(cmd);
 
-	if (linejoin == LINE_JOIN_NONE)
-	{
-		NoneJoinPolyline line;
-		line.render(vertices, count, halfwidth, pixelsize, linestyle == LINE_SMOOTH);
-		line.draw(this);
-	}
-	else if (linejoin == LINE_JOIN_BEVEL)
-	{
-		BevelJoinPolyline line;
-		line.render(vertices, count, halfwidth, pixelsize, linestyle == LINE_SMOOTH);
-		line.draw(this);
-	}
-	else if (linejoin == LINE_JOIN_MITER)
-	{
-		MiterJoinPolyline line;
-		line.render(vertices, count, halfwidth, pixelsize, linestyle == LINE_SMOOTH);
-		line.draw(this);
+		glyphInstanceBuffer->markUsed(usedsize);
 	}
+
+	setColor(nc);
 }
 
 void Graphics::rectangle(DrawMode mode, float x, float y, float w, float h)
@@ -1370,36 +2765,34 @@ void Graphics::rectangle(DrawMode mode, float x, float y, float w, float h, floa
 
 	int num_coords = (points + 2) * 4;
 	Vector2 *coords = getScratchBuffer<Vector2>(num_coords + 1);
-	float phi = .0f;
 
-	for (int i = 0; i <= points + 2; ++i, phi += angle_shift)
+	// Each corner starts a quarter turn (points + 1 angle shifts) after the
+	// previous one, and shares its first point with the previous corner's
+	// last, so corner k's point i is unit[i - k].
+	const Vector2 *unit = getUnitArcPoints(0.0f, angle_shift, (points + 1) * 4 + 2);
+
+	for (int i = 0; i <= points + 2; ++i)
 	{
-		coords[i].x = x + rx * (1 - cosf(phi));
-		coords[i].y = y + ry * (1 - sinf(phi));
+		coords[i].x = x + rx * (1 - unit[i].x);
+		coords[i].y = y + ry * (1 - unit[i].y);
 	}
 
-	phi = half_pi;
-
-	for (int i = points + 2; i <= 2 * (points + 2); ++i, phi += angle_shift)
+	for (int i = points + 2; i <= 2 * (points + 2); ++i)
 	{
-		coords[i].x = x + w - rx * (1 + cosf(phi));
-		coords[i].y = y +     ry * (1 - sinf(phi));
+		coords[i].x = x + w - rx * (1 + unit[i - 1].x);
+		coords[i].y = y +     ry * (1 - unit[i - 1].y);
 	}
 
-	phi = 2 * half_pi;
-
-	for (int i = 2 * (points + 2); i <= 3 * (points + 2); ++i, phi += angle_shift)
+	for (int i = 2 * (points + 2); i <= 3 * (points + 2); ++i)
 	{
-		coords[i].x = x + w - rx * (1 + cosf(phi));
-		coords[i].y = y + h - ry * (1 + sinf(phi));
+		coords[i].x = x + w - rx * (1 + unit[i - 2].x);
+		coords[i].y = y + h - ry * (1 + unit[i - 2].y);
 	}
 
-	phi = 3 * half_pi;
-
-	for (int i = 3 * (points + 2); i <= 4 * (points + 2); ++i, phi += angle_shift)
+	for (int i = 3 * (points + 2); i <= 4 * (points + 2); ++i)
 	{
-		coords[i].x = x +     rx * (1 - cosf(phi));
-		coords[i].y = y + h - ry * (1 + sinf(phi));
+		coords[i].x = x +     rx * (1 - unit[i - 3].x);
+		coords[i].y = y + h - ry * (1 + unit[i - 3].y);
 	}
 
 	coords[num_coords] = coords[0];
@@ -1427,32 +2820,64 @@ void Graphics::ellipse(DrawMode mode, float x, float y, float a, float b, int po
 	float two_pi = (float) (LOVE_M_PI * 2);
 	if (points <= 0) points = 1;
 	float angle_shift = (two_pi / points);
-	float phi = .0f;
 
-	// 1 extra point at the end for a closed loop, and 1 extra point at the
-	// start in filled mode for the vertex in the center of the ellipse.
-	int extrapoints = 1 + (mode == DRAW_FILL ? 1 : 0);
-
-	Vector2 *polygoncoords = getScratchBuffer<Vector2>(points + extrapoints);
-	Vector2 *coords = polygoncoords;
+	const Vector2 *unit = getUnitArcPoints(0.0f, angle_shift, points);
 
 	if (mode == DRAW_FILL)
 	{
-		coords[0].x = x;
-		coords[0].y = y;
-		coords++;
+		// The unit circle goes straight into the stream buffer, with the
+		// ellipse's position and radii folded into the transform.
+		const Matrix4 &t = getTransform();
+		bool is2D = t.isAffine2DTransform();
+
+		Matrix4 m(t, Matrix4(a, 0.0f, 0.0f, b, x, y));
+		Vector2 center(x, y);
+
+		// 1 extra point at the start for the vertex in the center of the
+		// ellipse, and 1 at the end for a closed loop.
+		StreamDrawCommand cmd;
+		cmd.formats[0] = vertex::getSinglePositionFormat(is2D);
+		cmd.formats[1] = vertex::CommonFormat::RGBAub;
+		cmd.indexMode = vertex::TriangleIndexMode::FAN;
+		cmd.vertexCount = points + 2;
+
+		StreamVertexData data = requestStreamDraw(cmd);
+
+		if (is2D)
+		{
+			Vector2 *positions = (Vector2 *) data.stream[0];
+			t.transformXY(positions, &center, 1);
+			m.transformXY(positions + 1, unit, points);
+			positions[points + 1] = positions[1];
+		}
+		else
+		{
+			Vector3 *positions = (Vector3 *) data.stream[0];
+			t.transformXY0(positions, &center, 1);
+			m.transformXY0(positions + 1, unit, points);
+			positions[points + 1] = positions[1];
+		}
+
+		Color c = toColor(getColor());
+		Color *colordata = (Color *) data.stream[1];
+		for (int i = 0; i < cmd.vertexCount; i++)
+			colordata[i] = c;
+
+		return;
 	}
 
-	for (int i = 0; i < points; ++i, phi += angle_shift)
+	// 1 extra point at the end for a closed loop.
+	Vector2 *coords = getScratchBuffer<Vector2>(points + 1);
+
+	for (int i = 0; i < points; ++i)
 	{
-		coords[i].x = x + a * cosf(phi);
-		coords[i].y = y + b * sinf(phi);
+		coords[i].x = x + a * unit[i].x;
+		coords[i].y = y + b * unit[i].y;
 	}
 
 	coords[points] = coords[0];
 
-	// Last argument to polygon(): don't skip the last vertex in fill mode.
-	polygon(mode, polygoncoords, points + extrapoints, false);
+	polygon(mode, coords, points + 1);
 }
 
 void Graphics::ellipse(DrawMode mode, float x, float y, float a, float b)
@@ -1489,17 +2914,17 @@ void Graphics::arc(DrawMode drawmode, ArcMode arcmode, float x, float y, float r
 	if (drawmode == DRAW_FILL && arcmode == ARC_OPEN)
 		arcmode = ARC_CLOSED;
 
-	float phi = angle1;
-
 	Vector2 *coords = nullptr;
 	int num_coords = 0;
 
 	const auto createPoints = [&](Vector2 *coordinates)
 	{
-		for (int i = 0; i <= points; ++i, phi += angle_shift)
+		const Vector2 *unit = getUnitArcPoints(angle1, angle_shift, points + 1);
+
+		for (int i = 0; i <= points; ++i)
 		{
-			coordinates[i].x = x + radius * cosf(phi);
-			coordinates[i].y = y + radius * sinf(phi);
+			coordinates[i].x = x + radius * unit[i].x;
+			coordinates[i].y = y + radius * unit[i].y;
 		}
 	};
 
@@ -1558,11 +2983,54 @@ void Graphics::polygon(DrawMode mode, const Vector2 *coords, size_t count, bool
 		const Matrix4 &t = getTransform();
 		bool is2D = t.isAffine2DTransform();
 
+		int vertexcount = (int)count - (skipLastFilledVertex ? 1 : 0);
+
+		// A fan only covers convex polygons correctly.
+		if (vertexcount > 3 && !math::isConvex(coords, vertexcount))
+		{
+			polygonIndices.clear();
+			math::triangulate(coords, vertexcount, std::vector<size_t>(), polygonIndices);
+
+			if (polygonIndices.empty())
+				return;
+
+			StreamDrawCommand cmd;
+			cmd.formats[0] = vertex::getSinglePositionFormat(is2D);
+			cmd.formats[1] = vertex::CommonFormat::RGBAub;
+			cmd.vertexCount = (int) polygonIndices.size();
+
+			StreamVertexData data = requestStreamDraw(cmd);
+
+			if (is2D)
+			{
+				Vector2 *positions = (Vector2 *) data.stream[0];
+				for (int i = 0; i < cmd.vertexCount; i++)
+					positions[i] = coords[polygonIndices[i]];
+
+				t.transformXY(positions, positions, cmd.vertexCount);
+			}
+			else
+			{
+				Vector3 *positions = (Vector3 *) data.stream[0];
+				for (int i = 0; i < cmd.vertexCount; i++)
+					positions[i] = Vector3(coords[polygonIndices[i]].x, coords[polygonIndices[i]].y, 0.0f);
+
+				t.transformXY0(positions, positions, cmd.vertexCount);
+			}
+
+			Color c = toColor(getColor());
+			Color *colordata = (Color *) data.stream[1];
+			for (int i = 0; i < cmd.vertexCount; i++)
+				colordata[i] = c;
+
+			return;
+		}
+
 		StreamDrawCommand cmd;
 		cmd.formats[0] = vertex::getSinglePositionFormat(is2D);
 		cmd.formats[1] = vertex::CommonFormat::RGBAub;
 		cmd.indexMode = vertex::TriangleIndexMode::FAN;
-		cmd.vertexCount = (int)count - (skipLastFilledVertex ? 1 : 0);
+		cmd.vertexCount = vertexcount;
 
 		StreamVertexData data = requestStreamDraw(cmd);
 
@@ -1599,10 +3067,149 @@ Graphics::Stats Graphics::getStats() const
 	stats.images = Image::imageCount;
 	stats.fonts = Font::fontCount;
 	stats.textureMemory = Texture::totalGraphicsMemory;
+
+	stats.evictedImages = 0;
+	for (const Image *image : Image::getImages())
+	{
+		if (!image->isResident())
+			stats.evictedImages++;
+	}
+
+	stats.pooledCanvases = (int) canvasPool.size();
+	stats.canvasPoolMemory = 0;
+	for (const PooledCanvas &pooled : canvasPool)
+		stats.canvasPoolMemory += pooled.canvas->getGraphicsMemorySize();
 	
 	return stats;
 }
 
+Graphics::StreamStats Graphics::getStreamStats() const
+{
+	StreamStats stats;
+
+	for (int i = 0; i < STREAM_FLUSH_MAX_ENUM; i++)
+		stats.flushes[i] = streamFlushCounts[i];
+
+	const StreamBuffer *buffers[] = {streamBufferState.vb[0], streamBufferState.vb[1], streamBufferState.indexBuffer};
+
+	for (int i = 0; i < 3; i++)
+	{
+		if (buffers[i] != nullptr)
+			stats.buffers[i] = buffers[i]->getFrameStats();
+
+		const StreamBufferUsage &usage = streamBufferUsage[i];
+
+		stats.bufferSizes[i] = buffers[i] != nullptr ? buffers[i]->getSize() : 0;
+		stats.highWaterMarks[i] = std::max(usage.windowPeak, usage.previousWindowPeak);
+		stats.resizes[i] = usage.resizes;
+	}
+
+	return stats;
+}
+
+StreamBuffer *&Graphics::getStreamBuffer(int index)
+{
+	if (index < 2)
+		return streamBufferState.vb[index];
+	else
+		return streamBufferState.indexBuffer;
+}
+
+void Graphics::resizeStreamBuffer(int index, size_t size)
+{
+	StreamBuffer *&buffer = getStreamBuffer(index);
+
+	StreamBuffer::FrameStats stats = buffer->getFrameStats();
+	delete buffer;
+	buffer = nullptr;
+
+	buffer = newStreamBuffer(index < 2 ? BUFFER_VERTEX : BUFFER_INDEX, size);
+	buffer->setFrameStats(stats);
+
+	streamBufferUsage[index].resizes++;
+}
+
+void Graphics::setStreamBufferSizes(const size_t sizes[3])
+{
+	for (int i = 0; i < 3; i++)
+	{
+		if (sizes[i] == 0)
+			throw love::Exception("Stream buffer sizes must be greater than 0.");
+	}
+
+	flushStreamDraws();
+
+	for (int i = 0; i < 3; i++)
+	{
+		streamBufferUsage[i].minSize = sizes[i];
+
+		StreamBuffer *buffer = getStreamBuffer(i);
+		if (buffer != nullptr && buffer->getSize() != sizes[i])
+			resizeStreamBuffer(i, sizes[i]);
+	}
+}
+
+void Graphics::getStreamBufferSizes(size_t sizes[3]) const
+{
+	for (int i = 0; i < 3; i++)
+		sizes[i] = streamBufferUsage[i].minSize;
+}
+
+void Graphics::setStreamBufferAutoSizing(bool enable)
+{
+	streamBufferAutoSizing = enable;
+}
+
+bool Graphics::isStreamBufferAutoSizing() const
+{
+	return streamBufferAutoSizing;
+}
+
+void Graphics::updateStreamBufferSizes()
+{
+	for (int i = 0; i < 3; i++)
+	{
+		StreamBuffer *buffer = getStreamBuffer(i);
+		if (buffer == nullptr)
+			continue;
+
+		StreamBufferUsage &usage = streamBufferUsage[i];
+
+		size_t used = buffer->getFrameStats().uploadedBytes;
+		usage.windowPeak = std::max(usage.windowPeak, used);
+
+		bool windowdone = ++usage.windowFrames >= STREAM_BUFFER_SIZING_WINDOW;
+
+		if (streamBufferAutoSizing)
+		{
+			size_t size = buffer->getSize();
+			size_t newsize = size;
+
+			// Grow before the next frame has to flush and reallocate partway
+			// through.
+			if (used > size - size / 4)
+				newsize = (size_t) nextP2((int) (used * 2));
+			else if (windowdone)
+			{
+				// Shrink once the peak usage of a whole window was low.
+				size_t peak = std::max(usage.windowPeak, usage.previousWindowPeak);
+				if (peak < size / 4)
+					newsize = std::max(usage.minSize, (size_t) nextP2((int) (peak * 2)));
+			}
+
+			if (newsize != size)
+				resizeStreamBuffer(i, newsize);
+		}
+
+		if (windowdone)
+		{
+			usage.previousWindowPeak = usage.windowPeak;
+			usage.windowPeak = 0;
+			usage.windowFrames = 0;
+		}
+	}
+}
+
 size_t Graphics::getStackDepth() const
 {
 	return stackTypeStack.size();
@@ -1618,7 +3225,7 @@ void Graphics::push(StackType type)
 	pixelScaleStack.push_back(pixelScaleStack.back());
 
 	if (type == STACK_ALL)
-		states.push_back(states.back());
+		savedStates.emplace_back();
 
 	stackTypeStack.push_back(type);
 }
@@ -1633,12 +3240,13 @@ void Graphics::pop()
 
 	if (stackTypeStack.back() == STACK_ALL)
 	{
-		DisplayState &newstate = states[states.size() - 2];
+		const SavedState &saved = savedStates.back();
 
-		restoreStateChecked(newstate);
+		// The setters called here don't save anything new, since all of the
+		// fields they modify are already in the top saved state.
+		restoreStateChecked(saved.state, saved.fields);
 
-		// The last two states in the stack should be equal now.
-		states.pop_back();
+		savedStates.pop_back();
 	}
 
 	stackTypeStack.pop_back();
@@ -1838,6 +3446,16 @@ std::vector<std::string> Graphics::getConstants(LineJoin)
 	return lineJoins.getNames();
 }
 
+bool Graphics::getConstant(const char *in, StreamFlushReason &out)
+{
+	return streamFlushReasons.find(in, out);
+}
+
+bool Graphics::getConstant(StreamFlushReason in, const char *&out)
+{
+	return streamFlushReasons.find(in, out);
+}
+
 bool Graphics::getConstant(const char *in, Feature &out)
 {
 	return features.find(in, out);
@@ -1873,6 +3491,66 @@ std::vector<std::string> Graphics::getConstants(StackType)
 	return stackTypes.getNames();
 }
 
+bool Graphics::getConstant(const char *in, LoadAction &out)
+{
+	return loadActions.find(in, out);
+}
+
+bool Graphics::getConstant(LoadAction in, const char *&out)
+{
+	return loadActions.find(in, out);
+}
+
+std::vector<std::string> Graphics::getConstants(LoadAction)
+{
+	return loadActions.getNames();
+}
+
+bool Graphics::getConstant(const char *in, StoreAction &out)
+{
+	return storeActions.find(in, out);
+}
+
+bool Graphics::getConstant(StoreAction in, const char *&out)
+{
+	return storeActions.find(in, out);
+}
+
+std::vector<std::string> Graphics::getConstants(StoreAction)
+{
+	return storeActions.getNames();
+}
+
+bool Graphics::getConstant(const char *in, LatencyMode &out)
+{
+	return latencyModes.find(in, out);
+}
+
+bool Graphics::getConstant(LatencyMode in, const char *&out)
+{
+	return latencyModes.find(in, out);
+}
+
+std::vector<std::string> Graphics::getConstants(LatencyMode)
+{
+	return latencyModes.getNames();
+}
+
+bool Graphics::getConstant(const char *in, MemoryBarrierType &out)
+{
+	return memoryBarrierTypes.find(in, out);
+}
+
+bool Graphics::getConstant(MemoryBarrierType in, const char *&out)
+{
+	return memoryBarrierTypes.find(in, out);
+}
+
+std::vector<std::string> Graphics::getConstants(MemoryBarrierType)
+{
+	return memoryBarrierTypes.getNames();
+}
+
 StringMap<Graphics::DrawMode, Graphics::DRAW_MAX_ENUM>::Entry Graphics::drawModeEntries[] =
 {
 	{ "line", DRAW_LINE },
@@ -1930,6 +3608,17 @@ StringMap<Graphics::LineJoin, Graphics::LINE_JOIN_MAX_ENUM>::Entry Graphics::lin
 
 StringMap<Graphics::LineJoin, Graphics::LINE_JOIN_MAX_ENUM> Graphics::lineJoins(Graphics::lineJoinEntries, sizeof(Graphics::lineJoinEntries));
 
+StringMap<Graphics::StreamFlushReason, Graphics::STREAM_FLUSH_MAX_ENUM>::Entry Graphics::streamFlushReasonEntries[] =
+{
+	{ "texture",      STREAM_FLUSH_TEXTURE       },
+	{ "shader",       STREAM_FLUSH_SHADER        },
+	{ "vertexformat", STREAM_FLUSH_VERTEX_FORMAT },
+	{ "bufferfull",   STREAM_FLUSH_BUFFER_FULL   },
+	{ "state",        STREAM_FLUSH_STATE         },
+};
+
+StringMap<Graphics::StreamFlushReason, Graphics::STREAM_FLUSH_MAX_ENUM> Graphics::streamFlushReasons(Graphics::streamFlushReasonEntries, sizeof(Graphics::streamFlushReasonEntries));
+
 StringMap<Graphics::Feature, Graphics::FEATURE_MAX_ENUM>::Entry Graphics::featureEntries[] =
 {
 	{ "multicanvasformats", FEATURE_MULTI_CANVAS_FORMATS },
@@ -1940,6 +3629,12 @@ StringMap<Graphics::Feature, Graphics::FEATURE_MAX_ENUM>::Entry Graphics::featur
 	{ "shaderderivatives",  FEATURE_SHADER_DERIVATIVES   },
 	{ "glsl3",              FEATURE_GLSL3                },
 	{ "instancing",         FEATURE_INSTANCING           },
+	{ "gputiming",          FEATURE_GPU_TIMING           },
+	{ "gpuparticles",       FEATURE_GPU_PARTICLES        },
+	{ "drawindirect",       FEATURE_DRAW_INDIRECT        },
+	{ "framelatencylimit",  FEATURE_FRAME_LATENCY_LIMIT  },
+	{ "compute",            FEATURE_COMPUTE              },
+	{ "occlusionquery",     FEATURE_OCCLUSION_QUERY      },
 };
 
 StringMap<Graphics::Feature, Graphics::FEATURE_MAX_ENUM> Graphics::features(Graphics::featureEntries, sizeof(Graphics::featureEntries));
@@ -1954,6 +3649,7 @@ StringMap<Graphics::SystemLimit, Graphics::LIMIT_MAX_ENUM>::Entry Graphics::syst
 	{ "multicanvas",       LIMIT_MULTI_CANVAS        },
 	{ "canvasmsaa",        LIMIT_CANVAS_MSAA         },
 	{ "anisotropy",        LIMIT_ANISOTROPY          },
+	{ "threadgroups",      LIMIT_THREADGROUPS        },
 };
 
 StringMap<Graphics::SystemLimit, Graphics::LIMIT_MAX_ENUM> Graphics::systemLimits(Graphics::systemLimitEntries, sizeof(Graphics::systemLimitEntries));
@@ -1966,5 +3662,47 @@ StringMap<Graphics::StackType, Graphics::STACK_MAX_ENUM>::Entry Graphics::stackT
 
 StringMap<Graphics::StackType, Graphics::STACK_MAX_ENUM> Graphics::stackTypes(Graphics::stackTypeEntries, sizeof(Graphics::stackTypeEntries));
 
+StringMap<Graphics::LoadAction, Graphics::LOAD_ACTION_MAX_ENUM>::Entry Graphics::loadActionEntries[] =
+{
+	{ "load",     LOAD_ACTION_LOAD      },
+	{ "clear",    LOAD_ACTION_CLEAR     },
+	{ "dontcare", LOAD_ACTION_DONT_CARE },
+};
+
+StringMap<Graphics::LoadAction, Graphics::LOAD_ACTION_MAX_ENUM> Graphics::loadActions(Graphics::loadActionEntries, sizeof(Graphics::loadActionEntries));
+
+StringMap<Graphics::StoreAction, Graphics::STORE_ACTION_MAX_ENUM>::Entry Graphics::storeActionEntries[] =
+{
+	{ "store",   STORE_ACTION_STORE   },
+	{ "discard", STORE_ACTION_DISCARD },
+};
+
+StringMap<Graphics::StoreAction, Graphics::STORE_ACTION_MAX_ENUM> Graphics::storeActions(Graphics::storeActionEntries, sizeof(Graphics::storeActionEntries));
+
+StringMap<Graphics::LatencyMode, Graphics::LATENCY_MODE_MAX_ENUM>::Entry Graphics::latencyModeEntries[] =
+{
+	{ "normal",          LATENCY_MODE_NORMAL           },
+	{ "low",             LATENCY_MODE_LOW              },
+	{ "variablerefresh", LATENCY_MODE_VARIABLE_REFRESH },
+};
+
+StringMap<Graphics::LatencyMode, Graphics::LATENCY_MODE_MAX_ENUM> Graphics::latencyModes(Graphics::latencyModeEntries, sizeof(Graphics::latencyModeEntries));
+
+StringMap<Graphics::MemoryBarrierType, Graphics::MEMORY_BARRIER_MAX_ENUM>::Entry Graphics::memoryBarrierTypeEntries[] =
+{
+	{ "storagebuffer", MEMORY_BARRIER_STORAGE_BUFFER },
+	{ "image",         MEMORY_BARRIER_IMAGE          },
+	{ "texture",       MEMORY_BARRIER_TEXTURE        },
+	{ "vertexbuffer",  MEMORY_BARRIER_VERTEX_BUFFER  },
+	{ "indexbuffer",   MEMORY_BARRIER_INDEX_BUFFER   },
+	{ "indirect",      MEMORY_BARRIER_INDIRECT       },
+	{ "uniformbuffer", MEMORY_BARRIER_UNIFORM_BUFFER },
+	{ "framebuffer",   MEMORY_BARRIER_FRAMEBUFFER    },
+	{ "bufferupdate",  MEMORY_BARRIER_BUFFER_UPDATE  },
+	{ "all",           MEMORY_BARRIER_ALL            },
+};
+
+StringMap<Graphics::MemoryBarrierType, Graphics::MEMORY_BARRIER_MAX_ENUM> Graphics::memoryBarrierTypes(Graphics::memoryBarrierTypeEntries, sizeof(Graphics::memoryBarrierTypeEntries));
+
 } // graphics
 } // love
@@ -29,6 +29,7 @@
 #include "common/Optional.h"
 #include "common/int.h"
 #include "common/Color.h"
+#include "common/FrameArena.h"
 #include "StreamBuffer.h"
 #include "vertex.h"
 #include "Texture.h"
@@ -37,16 +38,26 @@
 #include "ShaderStage.h"
 #include "Shader.h"
 #include "Quad.h"
+#include "QuadAtlas.h"
+#include "ShaderVariants.h"
 #include "Mesh.h"
+#include "SkinnedMesh.h"
 #include "Image.h"
+#include "ImageLoader.h"
+#include "TextureArrayBin.h"
+#include "VideoRecorder.h"
+#include "OcclusionQuery.h"
 #include "Deprecations.h"
 #include "depthstencil.h"
+#include "math/BezierCurve.h"
 #include "math/Transform.h"
 #include "font/Rasterizer.h"
 #include "font/Font.h"
 #include "video/VideoStream.h"
 #include "data/HashFunction.h"
 
+#include "libraries/xxHash/xxhash.h"
+
 // C++
 #include <string>
 #include <vector>
@@ -58,10 +69,14 @@ namespace graphics
 {
 
 class SpriteBatch;
+class DrawList;
+class TextureAtlas;
+class TileLayer;
 class ParticleSystem;
 class Text;
 class Video;
 class Buffer;
+class GPUParticleSimulator;
 
 typedef Optional<Colorf> OptionalColorf;
 
@@ -164,6 +179,12 @@ public:
 		FEATURE_SHADER_DERIVATIVES,
 		FEATURE_GLSL3,
 		FEATURE_INSTANCING,
+		FEATURE_GPU_TIMING,
+		FEATURE_GPU_PARTICLES,
+		FEATURE_DRAW_INDIRECT,
+		FEATURE_FRAME_LATENCY_LIMIT,
+		FEATURE_COMPUTE,
+		FEATURE_OCCLUSION_QUERY,
 		FEATURE_MAX_ENUM
 	};
 
@@ -184,6 +205,7 @@ public:
 		LIMIT_MULTI_CANVAS,
 		LIMIT_CANVAS_MSAA,
 		LIMIT_ANISOTROPY,
+		LIMIT_THREADGROUPS,
 		LIMIT_MAX_ENUM
 	};
 
@@ -200,6 +222,59 @@ public:
 		TEMPORARY_RT_STENCIL = (1 << 1),
 	};
 
+	// What happens to the contents of a render target when a pass begins.
+	enum LoadAction
+	{
+		LOAD_ACTION_LOAD,
+		LOAD_ACTION_CLEAR,
+		LOAD_ACTION_DONT_CARE,
+		LOAD_ACTION_MAX_ENUM
+	};
+
+	// What happens to the contents of a render target when a pass ends.
+	enum StoreAction
+	{
+		STORE_ACTION_STORE,
+		STORE_ACTION_DISCARD,
+		STORE_ACTION_MAX_ENUM
+	};
+
+	// How present trades throughput for input-to-display latency.
+	enum LatencyMode
+	{
+		// Frames are queued up to the frames in flight limit.
+		LATENCY_MODE_NORMAL,
+
+		// Each frame finishes on the GPU before the next one starts, and with
+		// vsync the next frame starts as late as it can while still making
+		// the following refresh.
+		LATENCY_MODE_LOW,
+
+		// At most one frame in flight, and frames start no faster than just
+		// under the display's refresh rate, which keeps variable refresh
+		// displays within their range without vsync queueing frames.
+		LATENCY_MODE_VARIABLE_REFRESH,
+
+		LATENCY_MODE_MAX_ENUM
+	};
+
+	// What memoryBarrier makes shader storage writes visible to. Passed to it
+	// as a bitmask of (1 << type).
+	enum MemoryBarrierType
+	{
+		MEMORY_BARRIER_STORAGE_BUFFER,
+		MEMORY_BARRIER_IMAGE,
+		MEMORY_BARRIER_TEXTURE,
+		MEMORY_BARRIER_VERTEX_BUFFER,
+		MEMORY_BARRIER_INDEX_BUFFER,
+		MEMORY_BARRIER_INDIRECT,
+		MEMORY_BARRIER_UNIFORM_BUFFER,
+		MEMORY_BARRIER_FRAMEBUFFER,
+		MEMORY_BARRIER_BUFFER_UPDATE,
+		MEMORY_BARRIER_ALL,
+		MEMORY_BARRIER_MAX_ENUM
+	};
+
 	struct Capabilities
 	{
 		double limits[LIMIT_MAX_ENUM];
@@ -225,6 +300,83 @@ public:
 		int images;
 		int fonts;
 		int64 textureMemory;
+		int evictedImages;
+		int pooledCanvases;
+		int64 canvasPoolMemory;
+	};
+
+	// Why flushStreamDraws submitted a batch.
+	enum StreamFlushReason
+	{
+		STREAM_FLUSH_TEXTURE,
+		STREAM_FLUSH_SHADER,
+		STREAM_FLUSH_VERTEX_FORMAT,
+		STREAM_FLUSH_BUFFER_FULL,
+		STREAM_FLUSH_STATE, // Any flush not caused by requestStreamDraw.
+		STREAM_FLUSH_MAX_ENUM
+	};
+
+	struct StreamStats
+	{
+		int flushes[STREAM_FLUSH_MAX_ENUM];
+
+		// Position data, other vertex attributes, and indices.
+		StreamBuffer::FrameStats buffers[3];
+
+		// Current buffer sizes, and the most data uploaded to each buffer in a
+		// single frame recently.
+		size_t bufferSizes[3];
+		size_t highWaterMarks[3];
+
+		// Number of times each buffer has been reallocated.
+		int resizes[3];
+	};
+
+	struct GPUPassTiming
+	{
+		// The first render target of the pass, or null for the main screen.
+		StrongRef<Canvas> canvas;
+
+		// Time the GPU spent executing the pass, in milliseconds.
+		double time;
+	};
+
+	struct GPUTimings
+	{
+		// Number of frames between the measured frame and the current one.
+		int latency = 0;
+
+		// Sum of the pass times, in milliseconds.
+		double frameTime = 0.0;
+
+		std::vector<GPUPassTiming> passes;
+	};
+
+	// CPU-side timings of the most recent frame, in milliseconds.
+	struct FrameTimings
+	{
+		// Time between the end of the previous present and the start of this one.
+		double cpuTime = 0.0;
+
+		// Time spent blocked in the window's buffer swap.
+		double swapTime = 0.0;
+
+		// Time stream buffer maps spent waiting for the GPU to release data.
+		double fenceWaitTime = 0.0;
+
+		// Time present spent waiting to stay within the frame latency limit.
+		double frameLimitWaitTime = 0.0;
+
+		// Estimated time from the start of a frame on the CPU until the GPU
+		// finished it, for the most recently completed frame.
+		double displayLatency = 0.0;
+
+		// Number of presented frames the GPU had not finished yet.
+		int framesInFlight = 0;
+
+		// Time present slept so the next frame would start later, in the
+		// low latency and variable refresh modes.
+		double frameStartDelay = 0.0;
 	};
 
 	struct ColorMask
@@ -266,6 +418,10 @@ public:
 		// TODO: This should be moved out to a state transition API?
 		CullMode cullMode = CULL_NONE;
 
+		// Whether the attributes and buffers belong to a persistent object,
+		// so backends can cache their vertex setup.
+		bool cacheVertexArray = false;
+
 		DrawCommand(const vertex::Attributes *attribs, const vertex::Buffers *buffers)
 			: attributes(attribs)
 			, buffers(buffers)
@@ -291,6 +447,8 @@ public:
 		// TODO: This should be moved out to a state transition API?
 		CullMode cullMode = CULL_NONE;
 
+		bool cacheVertexArray = false;
+
 		DrawIndexedCommand(const vertex::Attributes *attribs, const vertex::Buffers *buffers, Resource *indexbuffer)
 			: attributes(attribs)
 			, buffers(buffers)
@@ -298,6 +456,58 @@ public:
 		{}
 	};
 
+	// The layout of the records in an indirect draw buffer, as used by OpenGL.
+	struct DrawIndirectArgs
+	{
+		uint32 vertexCount;
+		uint32 instanceCount;
+		uint32 firstVertex;
+		uint32 baseInstance;
+	};
+
+	struct DrawIndexedIndirectArgs
+	{
+		uint32 indexCount;
+		uint32 instanceCount;
+		uint32 firstIndex;
+		int32 baseVertex;
+		uint32 baseInstance;
+	};
+
+	/**
+	 * Submits drawCount draws whose parameters are read from an indirect
+	 * buffer of DrawIndirectArgs, or DrawIndexedIndirectArgs if an index
+	 * buffer is used.
+	 **/
+	struct DrawIndirectCommand
+	{
+		PrimitiveType primitiveType = PRIMITIVE_TRIANGLES;
+
+		const vertex::Attributes *attributes;
+		const vertex::Buffers *buffers;
+
+		// Null for non-indexed draws.
+		Resource *indexBuffer = nullptr;
+		IndexDataType indexType = INDEX_UINT16;
+
+		Resource *indirectBuffer;
+		size_t indirectBufferOffset = 0;
+		int drawCount = 0;
+
+		Texture *texture = nullptr;
+
+		// TODO: This should be moved out to a state transition API?
+		CullMode cullMode = CULL_NONE;
+
+		bool cacheVertexArray = false;
+
+		DrawIndirectCommand(const vertex::Attributes *attribs, const vertex::Buffers *buffers, Resource *indirectbuffer)
+			: attributes(attribs)
+			, buffers(buffers)
+			, indirectBuffer(indirectbuffer)
+		{}
+	};
+
 	struct StreamDrawCommand
 	{
 		PrimitiveType primitiveMode = PRIMITIVE_TRIANGLES;
@@ -352,6 +562,10 @@ public:
 	{
 		ScreenshotCallback callback = nullptr;
 		void *data = nullptr;
+
+		// Whether the callback can be called from a thread other than the
+		// main one. The userdata pointer is null when it is.
+		bool threadSafe = false;
 	};
 
 	struct RenderTargetStrongRef;
@@ -407,12 +621,45 @@ public:
 		}
 	};
 
+	/**
+	 * Load and store actions for the color, depth and stencil buffers of a
+	 * Canvas pass. Tile-based GPUs can skip reading previous contents back
+	 * into tile memory, and skip writing contents which aren't used later.
+	 **/
+	struct RenderPassActions
+	{
+		LoadAction colorLoad = LOAD_ACTION_LOAD;
+		LoadAction depthLoad = LOAD_ACTION_LOAD;
+		LoadAction stencilLoad = LOAD_ACTION_LOAD;
+
+		StoreAction colorStore = STORE_ACTION_STORE;
+		StoreAction depthStore = STORE_ACTION_STORE;
+		StoreAction stencilStore = STORE_ACTION_STORE;
+
+		Colorf clearColor = Colorf(0.0f, 0.0f, 0.0f, 0.0f);
+		double clearDepth = 1.0;
+		int clearStencil = 0;
+
+		bool operator == (const RenderPassActions &other) const
+		{
+			return colorLoad == other.colorLoad && depthLoad == other.depthLoad
+				&& stencilLoad == other.stencilLoad && colorStore == other.colorStore
+				&& depthStore == other.depthStore && stencilStore == other.stencilStore
+				&& clearColor == other.clearColor && clearDepth == other.clearDepth
+				&& clearStencil == other.clearStencil;
+		}
+	};
+
 	struct RenderTargets
 	{
 		std::vector<RenderTarget> colors;
 		RenderTarget depthStencil;
 		uint32 temporaryRTFlags;
 
+		// Not part of the comparison below, since it's used for framebuffer
+		// object lookups.
+		RenderPassActions actions;
+
 		RenderTargets()
 			: depthStencil(nullptr)
 			, temporaryRTFlags(0)
@@ -447,6 +694,7 @@ public:
 		std::vector<RenderTargetStrongRef> colors;
 		RenderTargetStrongRef depthStencil;
 		uint32 temporaryRTFlags;
+		RenderPassActions actions;
 
 		RenderTargetsStrongRef()
 			: depthStencil(nullptr)
@@ -474,25 +722,135 @@ public:
 	virtual Image *newImage(TextureType textype, PixelFormat format, int width, int height, int slices, const Image::Settings &settings) = 0;
 
 	Quad *newQuad(Quad::Viewport v, double sw, double sh);
+	QuadAtlas *newQuadAtlas(double sw, double sh);
 	Font *newFont(love::font::Rasterizer *data, const Texture::Filter &filter = Texture::defaultFilter);
 	Font *newDefaultFont(int size, font::TrueTypeRasterizer::Hinting hinting, const Texture::Filter &filter = Texture::defaultFilter);
 	Video *newVideo(love::video::VideoStream *stream, float dpiscale);
 
-	SpriteBatch *newSpriteBatch(Texture *texture, int size, vertex::Usage usage);
+	SpriteBatch *newSpriteBatch(Texture *texture, int size, vertex::Usage usage, bool instanced = false);
 	ParticleSystem *newParticleSystem(Texture *texture, int size);
+	DrawList *newDrawList();
+	TextureAtlas *newTextureAtlas(int size, PixelFormat format, bool linear);
+	TextureArrayBin *newTextureArrayBin(int width, int height, int layers, PixelFormat format, bool linear);
+	TileLayer *newTileLayer(Texture *texture, int width, int height, float tilewidth, float tileheight, int chunksize);
 
 	virtual Canvas *newCanvas(const Canvas::Settings &settings) = 0;
 
-	ShaderStage *newShaderStage(ShaderStage::StageType stage, const std::string &source);
+	ShaderStage *newShaderStage(ShaderStage::StageType stage, const std::string &source, bool deferValidation = false);
 	Shader *newShader(const std::string &vertex, const std::string &pixel);
 
+	/**
+	 * Creates a Shader whose validation, compilation and linking may still be
+	 * in progress when this returns. See Shader::isReady.
+	 **/
+	Shader *newShaderAsync(const std::string &vertex, const std::string &pixel);
+
+	ShaderVariants *newShaderVariants(const std::string &vertex, const std::string &pixel, const std::vector<std::string> &keys);
+
+	// Requires FEATURE_COMPUTE. See dispatchThreadgroups.
+	Shader *newComputeShader(const std::string &source);
+
+	/**
+	 * Starts loading an Image in the background. The loader is updated once
+	 * per frame until it's complete. See ImageLoader.
+	 **/
+	ImageLoader *newImageLoader(love::Data *data, const Image::Settings &settings);
+
+	/**
+	 * Sets the maximum amount of pixel data (in bytes) uploaded each frame for
+	 * Images which are loaded in the background.
+	 **/
+	void setImageUploadBudget(size_t bytes);
+	size_t getImageUploadBudget() const;
+
+	/**
+	 * Uploads the data of Images loaded in the background on a separate
+	 * thread with its own graphics context, where the backend supports it.
+	 * Those uploads aren't limited by the image upload budget.
+	 **/
+	void setBackgroundUploads(bool enable);
+	bool getBackgroundUploads() const;
+
+	// Whether background uploads are enabled and the backend can do them.
+	virtual bool isBackgroundUploadActive() const { return false; }
+
+	/**
+	 * Sets the amount of GPU memory (in bytes) the mipmap levels of streaming
+	 * Images may use in total. Levels which don't fit aren't streamed in until
+	 * others are released.
+	 **/
+	void setTextureStreamingBudget(size_t bytes);
+	size_t getTextureStreamingBudget() const;
+
+	/**
+	 * Sets the amount of GPU memory (in bytes) all textures may use, or 0 for
+	 * no limit. While it's exceeded, Images which weren't drawn recently are
+	 * evicted at the end of the frame (see Image::setResidencyPriority), and
+	 * restored in the background once they're drawn again.
+	 **/
+	void setTextureMemoryBudget(size_t bytes);
+	size_t getTextureMemoryBudget() const;
+
+	/**
+	 * Uploads the pending data of an Image in the background, within the image
+	 * upload budget. Used for Images reloaded after the graphics context was
+	 * lost which weren't drawn recently.
+	 **/
+	void addPendingImageUpload(Image *image);
+
+	/**
+	 * Gets a Canvas matching the given settings from the render target pool,
+	 * creating one if none is free. A pooled Canvas is handed out at most once
+	 * per frame, and is released after it hasn't been requested for the pool's
+	 * lifetime (in frames). The pool keeps its own reference to the Canvas.
+	 **/
+	Canvas *getPooledCanvas(const Canvas::Settings &settings);
+
+	void setCanvasPoolLifetime(int frames);
+	int getCanvasPoolLifetime() const;
+
+	// Releases all Canvases held by the render target pool.
+	void clearCanvasPool();
+
+	/**
+	 * When enabled, new Images are automatically stored in texture array bins
+	 * shared with other Images of the same size and format, so draws of
+	 * different Images can be batched. Images are removed from their bin once
+	 * nothing else references them.
+	 **/
+	void setTextureBinning(bool enable);
+	bool isTextureBinningEnabled() const;
+
+	/**
+	 * Adds the Image to a compatible automatic texture array bin, creating a
+	 * new bin if needed. Returns false if the Image can't be binned.
+	 **/
+	bool addToTextureBin(Image *image);
+
+	// Releases all automatic texture array bins.
+	void clearTextureBins();
+
+	/**
+	 * Gets how much of the data of Images reloaded after the graphics context
+	 * was lost has been uploaded so far, between 0 and 1.
+	 **/
+	float getRestoreProgress() const;
+
 	virtual Buffer *newBuffer(size_t size, const void *data, BufferType type, vertex::Usage usage, uint32 mapflags) = 0;
+	virtual GPUParticleSimulator *newGPUParticleSimulator(uint32 size) = 0;
+	virtual VideoRecorder *newVideoRecorder(const std::string &target, int width, int height, const VideoRecorder::Settings &settings) = 0;
+
+	// Requires FEATURE_OCCLUSION_QUERY.
+	virtual OcclusionQuery *newOcclusionQuery(bool conservative) = 0;
 
 	Mesh *newMesh(const std::vector<Vertex> &vertices, PrimitiveType drawmode, vertex::Usage usage);
 	Mesh *newMesh(int vertexcount, PrimitiveType drawmode, vertex::Usage usage);
 	Mesh *newMesh(const std::vector<Mesh::AttribFormat> &vertexformat, int vertexcount, PrimitiveType drawmode, vertex::Usage usage);
 	Mesh *newMesh(const std::vector<Mesh::AttribFormat> &vertexformat, const void *data, size_t datasize, PrimitiveType drawmode, vertex::Usage usage);
 
+	SkinnedMesh *newSkinnedMesh(const std::vector<Mesh::AttribFormat> &vertexformat, int vertexcount, PrimitiveType drawmode, vertex::Usage usage);
+	SkinnedMesh *newSkinnedMesh(const std::vector<Mesh::AttribFormat> &vertexformat, const void *data, size_t datasize, PrimitiveType drawmode, vertex::Usage usage);
+
 	Text *newText(Font *font, const std::vector<Font::ColoredString> &text = {});
 
 	bool validateShader(bool gles, const std::string &vertex, const std::string &pixel, std::string &err);
@@ -507,6 +865,12 @@ public:
 
 	virtual void discard(const std::vector<bool> &colorbuffers, bool depthstencil) = 0;
 
+	/**
+	 * Hints that the contents of the given buffers of the active render
+	 * targets aren't needed. Depth and stencil can be discarded separately.
+	 **/
+	virtual void discard(const std::vector<bool> &colorbuffers, bool depth, bool stencil) = 0;
+
 	/**
 	 * Flips buffers. (Rendered geometry is presented on screen).
 	 **/
@@ -694,6 +1058,16 @@ public:
 	void setLineJoin(LineJoin style);
 	LineJoin getLineJoin() const;
 
+	/**
+	 * Sets whether lines (and the outlines of other shapes) are expanded into
+	 * triangles on the GPU using instancing, rather than tessellated on the
+	 * CPU. Only the line's points are uploaded. Lines which can't be drawn
+	 * that way (bevel joins, custom shaders, 3D transforms, deferred draws, or
+	 * no instancing support) still use the CPU path.
+	 **/
+	void setGPULinesEnabled(bool enable);
+	bool isGPULinesEnabled() const;
+
 	/**
 	 * Sets the size of points.
 	 **/
@@ -721,9 +1095,12 @@ public:
 
 	void draw(Drawable *drawable, const Matrix4 &m);
 	void draw(Texture *texture, Quad *quad, const Matrix4 &m);
+	void draw(Texture *texture, QuadAtlas *atlas, int frame, const Matrix4 &m);
 	void drawLayer(Texture *texture, int layer, const Matrix4 &m);
 	void drawLayer(Texture *texture, int layer, Quad *quad, const Matrix4 &m);
+	void drawLayer(Texture *texture, int layer, QuadAtlas *atlas, int frame, const Matrix4 &m);
 	void drawInstanced(Mesh *mesh, const Matrix4 &m, int instancecount);
+	void drawIndirect(Mesh *mesh, const Matrix4 &m, const void *records, int drawcount);
 
 	/**
 	 * Draws text at the specified coordinates
@@ -742,6 +1119,24 @@ public:
 	 **/
 	void points(const Vector2 *positions, const Colorf *colors, size_t numpoints);
 
+	/**
+	 * Draws a series of points from packed records, each with its own color
+	 * (multiplied by the global color) and size (multiplied by the point size).
+	 **/
+	void points(const vertex::XYf_RGBAub_Sf *points, size_t numpoints);
+
+	/**
+	 * Whether glyph quads generated by a Font can currently be drawn with
+	 * drawInstancedGlyphs, rather than through the stream batcher.
+	 **/
+	bool canDrawInstancedGlyphs(bool distancefield) const;
+
+	/**
+	 * Draws glyph quads generated by a Font (4 vertices each) as one compact
+	 * instance per glyph, which the vertex shader expands back into a quad.
+	 **/
+	void drawInstancedGlyphs(Texture *texture, bool distancefield, const Matrix4 &m, const vertex::XYf_STus_RGBAub *quads, int glyphcount);
+
 	/**
 	 * Draws a series of lines connecting the given vertices.
 	 * @param coords Vertex positions (v1, ..., vn). If v1 == vn the line will be drawn closed.
@@ -749,6 +1144,13 @@ public:
 	 **/
 	void polyline(const Vector2 *vertices, size_t count);
 
+	/**
+	 * Draws Bezier curves as lines, flattened adaptively to within tolerance
+	 * (in local coordinates). Curves which start where the previous one
+	 * ended are joined into a single line.
+	 **/
+	void bezier(const love::math::BezierCurve * const *curves, size_t count, double tolerance);
+
 	/**
 	 * Draws a rectangle.
 	 * @param x Position along x-axis for top-left corner.
@@ -848,6 +1250,77 @@ public:
 	 **/
 	Stats getStats() const;
 
+	/**
+	 * Returns per-frame counters for the stream draw batcher: why batches were
+	 * flushed, and how much data went through each stream buffer.
+	 **/
+	StreamStats getStreamStats() const;
+
+	/**
+	 * Sets the minimum sizes of the stream buffers, in bytes. Existing buffers
+	 * are reallocated.
+	 **/
+	void setStreamBufferSizes(const size_t sizes[3]);
+	void getStreamBufferSizes(size_t sizes[3]) const;
+
+	/**
+	 * Automatic sizing grows the stream buffers at the end of a frame which
+	 * almost filled them, and shrinks them back towards their minimum sizes
+	 * when the peak usage stays low for a while.
+	 **/
+	void setStreamBufferAutoSizing(bool enable);
+	bool isStreamBufferAutoSizing() const;
+
+	/**
+	 * GPU timing measures how long the GPU spends on the main screen and each
+	 * Canvas pass. Results are read back asynchronously, so they describe a
+	 * frame from a few frames ago. Measuring starts at the next frame.
+	 **/
+	virtual void setGPUTimingEnabled(bool enable) = 0;
+	virtual bool isGPUTimingEnabled() const = 0;
+
+	/**
+	 * Gets the timings of the most recent frame whose results are available.
+	 * Returns false if there are none yet.
+	 **/
+	virtual bool getGPUTimings(GPUTimings &timings) const = 0;
+
+	virtual FrameTimings getFrameTimings() const = 0;
+
+	/**
+	 * Limits how many presented frames may be waiting on the GPU before present
+	 * blocks. 0 disables the limit.
+	 **/
+	virtual void setMaxFramesInFlight(int frames) = 0;
+	virtual int getMaxFramesInFlight() const = 0;
+
+	/**
+	 * The low latency and variable refresh modes override the frames in
+	 * flight limit while they're active.
+	 **/
+	virtual void setLatencyMode(LatencyMode mode) = 0;
+	virtual LatencyMode getLatencyMode() const = 0;
+
+	/**
+	 * Runs a compute shader over the given number of threadgroups, each the
+	 * size of the shader's local threadgroup size. The active shader is
+	 * unaffected.
+	 **/
+	virtual void dispatchThreadgroups(Shader *shader, int x, int y, int z) = 0;
+
+	/**
+	 * Makes shader writes to storage buffers and images visible to the later
+	 * uses given as a bitmask of (1 << MemoryBarrierType).
+	 **/
+	virtual void memoryBarrier(uint32 flags) = 0;
+
+	/**
+	 * Copies a rectangle of pixels from one texture to another without going
+	 * through the CPU. Both textures must have the same (uncompressed, color)
+	 * pixel format.
+	 **/
+	void copyTexture(Texture *src, Texture *dst, const Rect &srcrect, int srcslice, int srcmipmap, int dstx, int dsty, int dstslice, int dstmipmap);
+
 	size_t getStackDepth() const;
 	void push(StackType type = STACK_TRANSFORM);
 	void pop();
@@ -869,17 +1342,42 @@ public:
 
 	virtual void draw(const DrawCommand &cmd) = 0;
 	virtual void draw(const DrawIndexedCommand &cmd) = 0;
-	virtual void drawQuads(int start, int count, const vertex::Attributes &attributes, const vertex::Buffers &buffers, Texture *texture) = 0;
+	virtual void draw(const DrawIndirectCommand &cmd) = 0;
+	virtual void drawQuads(int start, int count, const vertex::Attributes &attributes, const vertex::Buffers &buffers, Texture *texture, bool cacheVertexArray = false) = 0;
 
 	void flushStreamDraws();
 	StreamVertexData requestStreamDraw(const StreamDrawCommand &command);
 
+	/**
+	 * Starts recording stream draws (sprites, shapes, text and DrawLists)
+	 * instead of submitting them. They're submitted sorted by the layer set
+	 * with setDeferredLayer, and then by shader, texture and blend mode, so
+	 * draws which share state are batched together. Only the layer order is preserved: draws within a
+	 * layer may be reordered. State changes other than the shader and blend
+	 * mode, and draws which don't go through the stream batcher, submit
+	 * everything recorded so far first.
+	 *
+	 * With batchStencil, stencil writes, stencil tests and stencil-only
+	 * clears are recorded too. Within a layer, every stencil mask is drawn
+	 * before the draws which test against the stencil buffer, grouped by
+	 * action, compare mode and reference value, and the stencil is cleared
+	 * once before all of them. Each mask in a layer should use its own
+	 * reference value, so masks don't clip each other's content.
+	 **/
+	void beginDeferredDraws(bool batchStencil = false);
+	void endDeferredDraws();
+	bool isDeferringDraws() const;
+
+	void setDeferredLayer(int layer);
+	int getDeferredLayer() const;
+
 	static void flushStreamDrawsGlobal();
 
 	virtual Shader::Language getShaderLanguageTarget() const = 0;
 	const DefaultShaderCode &getCurrentDefaultShaderCode() const;
 
-	void cleanupCachedShaderStage(ShaderStage::StageType type, const std::string &cachekey);
+	void cacheShaderStage(ShaderStage *stage);
+	void cleanupCachedShaderStage(ShaderStage *stage);
 
 	template <typename T>
 	T *getScratchBuffer(size_t count)
@@ -916,6 +1414,9 @@ public:
 	static bool getConstant(LineJoin in, const char *&out);
 	static std::vector<std::string> getConstants(LineJoin);
 
+	static bool getConstant(const char *in, StreamFlushReason &out);
+	static bool getConstant(StreamFlushReason in, const char *&out);
+
 	static bool getConstant(const char *in, Feature &out);
 	static bool getConstant(Feature in, const char *&out);
 
@@ -926,6 +1427,22 @@ public:
 	static bool getConstant(StackType in, const char *&out);
 	static std::vector<std::string> getConstants(StackType);
 
+	static bool getConstant(const char *in, LoadAction &out);
+	static bool getConstant(LoadAction in, const char *&out);
+	static std::vector<std::string> getConstants(LoadAction);
+
+	static bool getConstant(const char *in, StoreAction &out);
+	static bool getConstant(StoreAction in, const char *&out);
+	static std::vector<std::string> getConstants(StoreAction);
+
+	static bool getConstant(const char *in, LatencyMode &out);
+	static bool getConstant(LatencyMode in, const char *&out);
+	static std::vector<std::string> getConstants(LatencyMode);
+
+	static bool getConstant(const char *in, MemoryBarrierType &out);
+	static bool getConstant(MemoryBarrierType in, const char *&out);
+	static std::vector<std::string> getConstants(MemoryBarrierType);
+
 	// Default shader code (a shader is always required internally.)
 	static DefaultShaderCode defaultShaderCode[Shader::STANDARD_MAX_ENUM][Shader::LANGUAGE_MAX_ENUM][2];
 
@@ -972,6 +1489,37 @@ protected:
 		float defaultMipmapSharpness = 0.0f;
 	};
 
+	enum StateField
+	{
+		STATE_COLOR,
+		STATE_BACKGROUND_COLOR,
+		STATE_BLEND,
+		STATE_LINE_WIDTH,
+		STATE_LINE_STYLE,
+		STATE_LINE_JOIN,
+		STATE_POINT_SIZE,
+		STATE_SCISSOR,
+		STATE_STENCIL,
+		STATE_DEPTH,
+		STATE_MESH_CULL_MODE,
+		STATE_WINDING,
+		STATE_FONT,
+		STATE_SHADER,
+		STATE_RENDER_TARGETS,
+		STATE_COLOR_MASK,
+		STATE_WIREFRAME,
+		STATE_DEFAULT_FILTER,
+		STATE_DEFAULT_MIPMAP_FILTER,
+		STATE_MAX_ENUM
+	};
+
+	struct SavedState
+	{
+		// Bitmask of the StateFields which have been copied into state.
+		uint32 fields = 0;
+		DisplayState state;
+	};
+
 	struct StreamBufferState
 	{
 		StreamBuffer *vb[2];
@@ -995,6 +1543,61 @@ protected:
 		}
 	};
 
+	struct DeferredDraw
+	{
+		int layer;
+		StrongRef<Shader> shader;
+		BlendMode blendMode;
+		BlendAlpha blendAlphaMode;
+		StreamDrawCommand command;
+		StrongRef<Texture> texture;
+		size_t vertexOffsets[2];
+
+		// Only used when stencil state is deferred.
+		bool stencilWrite;
+		StencilAction stencilAction;
+		CompareMode stencilCompare;
+		int stencilValue;
+	};
+
+	struct StencilWriteState
+	{
+		bool active = false;
+		StencilAction action = STENCIL_REPLACE;
+		int value = 0;
+	};
+
+	// Per-instance data for a line segment drawn by the GPU line path. The
+	// neighbouring points are used for miter joins and are equal to the
+	// segment's own end points when there's no join.
+	struct LineSegment
+	{
+		Vector2 prev;
+		Vector2 start;
+		Vector2 end;
+		Vector2 next;
+		float halfWidth;
+		float fringeWidth;
+		Color color;
+	};
+
+	// Per-instance data for a glyph drawn by drawInstancedGlyphs. Glyph quads
+	// are axis-aligned, so their opposite corners are enough to rebuild them.
+	struct GlyphInstance
+	{
+		float rect[4];
+		uint16 texRect[4];
+		Color color;
+	};
+
+	struct LineBatchState
+	{
+		StreamBuffer *buffer = nullptr;
+		StreamBuffer::MapInfo map = StreamBuffer::MapInfo();
+		int segmentCount = 0;
+		bool smooth = false;
+	};
+
 	struct TemporaryCanvas
 	{
 		Canvas *canvas;
@@ -1006,21 +1609,109 @@ protected:
 		{}
 	};
 
-	virtual ShaderStage *newShaderStageInternal(ShaderStage::StageType stage, const std::string &cachekey, const std::string &source, bool gles) = 0;
-	virtual Shader *newShaderInternal(ShaderStage *vertex, ShaderStage *pixel) = 0;
+	struct PooledCanvas
+	{
+		Canvas *canvas;
+		Canvas::Settings settings;
+		int framesSinceUse;
+		bool usedThisFrame;
+
+		PooledCanvas(Canvas *c, const Canvas::Settings &s)
+			: canvas(c)
+			, settings(s)
+			, framesSinceUse(0)
+			, usedThisFrame(true)
+		{}
+	};
+
+	virtual ShaderStage *newShaderStageInternal(ShaderStage::StageType stage, const std::string &cachekey, const std::string &source, bool gles, bool deferValidation) = 0;
+	virtual Shader *newShaderInternal(ShaderStage *vertex, ShaderStage *pixel, bool async) = 0;
+	virtual Shader *newComputeShaderInternal(ShaderStage *compute) = 0;
+	virtual void copyTextureInternal(Texture *src, Texture *dst, const Rect &srcrect, int srcslice, int srcmipmap, int dstx, int dsty, int dstslice, int dstmipmap) = 0;
 	virtual StreamBuffer *newStreamBuffer(BufferType type, size_t size) = 0;
 
 	virtual void setCanvasInternal(const RenderTargets &rts, int w, int h, int pixelw, int pixelh, bool hasSRGBcanvas) = 0;
 
 	virtual void initCapabilities() = 0;
+
+	bool isRecordingDeferredDraws() const;
+
+	// Advances background Image loads within the upload budget. Called once
+	// per frame.
+	void updateImageLoaders();
+
+	// Streams in mipmap levels of streaming Images, least detailed levels
+	// first, within the given upload budget.
+	void updateStreamingImages(size_t uploadbudget);
+
+	// Restores evicted Images which were drawn, and evicts others while the
+	// texture memory budget is exceeded.
+	void updateTextureResidency();
+
+	/**
+	 * Returns true if a shader or blend mode change should only be stored in
+	 * the current DisplayState, because it'll be applied when the recorded
+	 * deferred draws are submitted.
+	 **/
+	bool deferDrawStateChange();
+
+	/**
+	 * Like deferDrawStateChange, for stencil state. Only true when recording
+	 * deferred draws with stencil batching.
+	 **/
+	bool deferStencilStateChange();
+
+	/**
+	 * Records a stencil-only clear to be done when the deferred draws are
+	 * submitted. Returns false if the clear should happen immediately.
+	 **/
+	bool deferStencilClear(int value);
+
+	void applyDeferredStencilState(const DeferredDraw &draw);
+
+	StreamVertexData recordDeferredDraw(const StreamDrawCommand &command);
+	void submitDeferredDraws();
+
+	bool canDrawGPULines() const;
+	void polylineGPU(const Vector2 *vertices, size_t count);
+	void flushLineBatch();
+	void createLineCornerBuffer();
+	void createGlyphCornerBuffer();
+
 	virtual void getAPIStats(int &shaderswitches) const = 0;
 
 	void createQuadIndexBuffer();
 
 	Canvas *getTemporaryCanvas(PixelFormat format, int w, int h, int samples);
 
+	// Clears or discards the active render targets at the start of a pass.
+	void applyLoadActions(const RenderTargets &rts);
+
+	// Called once per frame.
+	void updateCanvasPool();
+
+	// Called once per frame.
+	void updateTextureBins();
+
+	// Called once per frame, after the stream buffers have moved to the next
+	// frame but before their frame stats are reset.
+	void updateStreamBufferSizes();
+
+	// Must only be called when no stream draws are pending.
+	void resizeStreamBuffer(int index, size_t size);
+	StreamBuffer *&getStreamBuffer(int index);
+
 	void restoreState(const DisplayState &s);
-	void restoreStateChecked(const DisplayState &s);
+	void restoreStateChecked(const DisplayState &s, uint32 fields);
+
+	// Must be called by state setters before they modify the given field.
+	void saveStateField(StateField field)
+	{
+		if (!savedStates.empty() && (savedStates.back().fields & (1u << field)) == 0)
+			saveStateFieldSlow(field);
+	}
+
+	void saveStateFieldSlow(StateField field);
 
 	void pushTransform();
 	void pushIdentityTransform();
@@ -1042,36 +1733,150 @@ protected:
 
 	StreamBufferState streamBufferState;
 
+	// Backs ScratchVectors created on the main thread. Reset after present().
+	FrameArena frameArena;
+
+	struct StreamBufferUsage
+	{
+		size_t minSize = 0;
+
+		// Peak per-frame usage in the current and previous sizing windows.
+		size_t windowPeak = 0;
+		size_t previousWindowPeak = 0;
+		int windowFrames = 0;
+
+		int resizes = 0;
+	};
+
+	StreamBufferUsage streamBufferUsage[3];
+	bool streamBufferAutoSizing;
+
+	// Draws recorded while deferring, and their vertex data.
+	std::vector<DeferredDraw> deferredDraws;
+	std::vector<uint8> deferredVertices[2];
+	std::vector<int> deferredDrawOrder;
+
+	bool deferringDraws;
+	bool submittingDeferredDraws;
+	bool deferredStateChanged;
+	int deferredLayer;
+
+	// Stencil writes and clears recorded with the deferred draws, which
+	// haven't been applied yet.
+	bool deferringStencil;
+	StencilWriteState deferredStencilWrite;
+	OptionalInt deferredStencilClear;
+
 	std::vector<Matrix4> transformStack;
 	Matrix4 projectionMatrix;
 
 	std::vector<double> pixelScaleStack;
 
-	std::vector<DisplayState> states;
+	DisplayState displayState;
+
+	// One entry per push(STACK_ALL). Only the fields which are modified while
+	// the entry is on top of the stack are copied, and pop restores just those.
+	std::vector<SavedState> savedStates;
 	std::vector<StackType> stackTypeStack;
 
 	std::vector<TemporaryCanvas> temporaryCanvases;
 
+	// Triangle indices of the last concave polygon drawn in fill mode.
+	std::vector<uint32> polygonIndices;
+
+	// Flattened points of the last curves drawn with bezier().
+	std::vector<Vector2> curvePoints;
+	std::vector<size_t> curveChainStarts;
+
+	// Canvases handed out to user code by getPooledCanvas.
+	std::vector<PooledCanvas> canvasPool;
+	int canvasPoolLifetime;
+
+	bool textureBinning;
+	std::vector<StrongRef<TextureArrayBin>> textureBins;
+
+	// Background Image loads which aren't complete yet.
+	std::vector<StrongRef<ImageLoader>> imageLoaders;
+	size_t imageUploadBudget;
+	bool backgroundUploads;
+	size_t textureStreamingBudget;
+	size_t textureMemoryBudget;
+
+	// Images whose data is uploaded in the background after the context was
+	// lost, in the order they were reloaded.
+	std::vector<StrongRef<Image>> pendingImageUploads;
+	size_t pendingUploadTotal;
+	size_t pendingUploadDone;
+
 	int canvasSwitchCount;
 	int drawCalls;
 	int drawCallsBatched;
 
+	int streamFlushCounts[STREAM_FLUSH_MAX_ENUM];
+	StreamFlushReason pendingStreamFlushReason;
+
 	Buffer *quadIndexBuffer;
 
+	// Corners of the quads the GPU line path expands each segment into.
+	Buffer *lineCornerBuffer;
+	LineBatchState lineBatchState;
+	bool gpuLinesEnabled;
+
+	// Unit square corners and per-frame instance data for instanced glyphs.
+	Buffer *glyphCornerBuffer;
+	StreamBuffer *glyphInstanceBuffer;
+
 	Capabilities capabilities;
 
 	Deprecations deprecations;
 
 	static const size_t MAX_USER_STACK_DEPTH = 128;
 	static const int MAX_TEMPORARY_CANVAS_UNUSED_FRAMES = 16;
+	static const int DEFAULT_CANVAS_POOL_LIFETIME = 16;
+
+	// Images drawn within this many frames aren't evicted.
+	static const uint32 EVICTION_MIN_UNUSED_FRAMES = 2;
+	static const int STREAM_BUFFER_SIZING_WINDOW = 300;
+	static const int MAX_TEXTURE_BIN_LAYERS = 64;
+	static const int64 MAX_TEXTURE_BIN_MEMORY = 32 * 1024 * 1024;
+	static const size_t MAX_UNIT_ARC_CACHE_SIZE = 256;
 
 private:
 
+	struct UnitArcKey
+	{
+		float angle1;
+		float angleShift;
+		int count;
+
+		bool operator == (const UnitArcKey &other) const
+		{
+			return angle1 == other.angle1 && angleShift == other.angleShift && count == other.count;
+		}
+	};
+
+	struct UnitArcKeyHasher
+	{
+		size_t operator() (const UnitArcKey &key) const
+		{
+			return XXH32(&key, sizeof(UnitArcKey), 0);
+		}
+	};
+
 	void checkSetDefaultFont();
 	int calculateEllipsePoints(float rx, float ry) const;
 
+	/**
+	 * Gets count (cos, sin) pairs of the angles angle1 + i * angleshift. These
+	 * are computed once and reused by every ellipse, arc and rounded rectangle
+	 * drawn with the same segment count and angles.
+	 **/
+	const Vector2 *getUnitArcPoints(float angle1, float angleshift, int count);
+
 	std::vector<uint8> scratchBuffer;
 
+	std::unordered_map<UnitArcKey, std::vector<Vector2>, UnitArcKeyHasher> unitArcCache;
+
 	std::unordered_map<std::string, ShaderStage *> cachedShaderStages[ShaderStage::STAGE_MAX_ENUM];
 
 	static StringMap<DrawMode, DRAW_MAX_ENUM>::Entry drawModeEntries[];
@@ -1092,6 +1897,9 @@ private:
 	static StringMap<LineJoin, LINE_JOIN_MAX_ENUM>::Entry lineJoinEntries[];
 	static StringMap<LineJoin, LINE_JOIN_MAX_ENUM> lineJoins;
 
+	static StringMap<StreamFlushReason, STREAM_FLUSH_MAX_ENUM>::Entry streamFlushReasonEntries[];
+	static StringMap<StreamFlushReason, STREAM_FLUSH_MAX_ENUM> streamFlushReasons;
+
 	static StringMap<Feature, FEATURE_MAX_ENUM>::Entry featureEntries[];
 	static StringMap<Feature, FEATURE_MAX_ENUM> features;
 
@@ -1101,6 +1909,18 @@ private:
 	static StringMap<StackType, STACK_MAX_ENUM>::Entry stackTypeEntries[];
 	static StringMap<StackType, STACK_MAX_ENUM> stackTypes;
 
+	static StringMap<LoadAction, LOAD_ACTION_MAX_ENUM>::Entry loadActionEntries[];
+	static StringMap<LoadAction, LOAD_ACTION_MAX_ENUM> loadActions;
+
+	static StringMap<StoreAction, STORE_ACTION_MAX_ENUM>::Entry storeActionEntries[];
+	static StringMap<StoreAction, STORE_ACTION_MAX_ENUM> storeActions;
+
+	static StringMap<LatencyMode, LATENCY_MODE_MAX_ENUM>::Entry latencyModeEntries[];
+	static StringMap<LatencyMode, LATENCY_MODE_MAX_ENUM> latencyModes;
+
+	static StringMap<MemoryBarrierType, MEMORY_BARRIER_MAX_ENUM>::Entry memoryBarrierTypeEntries[];
+	static StringMap<MemoryBarrierType, MEMORY_BARRIER_MAX_ENUM> memoryBarrierTypes;
+
 }; // Graphics
 
 } // graphics
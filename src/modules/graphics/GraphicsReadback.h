@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "image/ImageData.h"
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * A pending copy of GPU pixel data into an ImageData. The copy is issued
+ * without stalling the pipeline; the ImageData becomes available once the GPU
+ * has finished with it.
+ **/
+class GraphicsReadback : public Object
+{
+public:
+
+	static love::Type type;
+
+	virtual ~GraphicsReadback();
+
+	/**
+	 * Checks whether the GPU has finished and copies the pixels into the
+	 * ImageData if so. Never blocks. Returns isComplete().
+	 **/
+	virtual bool update() = 0;
+
+	/**
+	 * Blocks until the GPU has finished and the pixels have been copied.
+	 **/
+	virtual void wait() = 0;
+
+	bool isComplete() const;
+
+	// Returns null until the readback is complete.
+	love::image::ImageData *getImageData() const;
+
+protected:
+
+	GraphicsReadback(love::image::ImageData *data);
+
+	StrongRef<love::image::ImageData> imageData;
+	bool complete;
+
+}; // GraphicsReadback
+
+} // graphics
+} // love
@@ -23,6 +23,8 @@
 
 // C++
 #include <algorithm>
+#include <limits>
+#include <string.h>
 
 namespace love
 {
@@ -33,6 +35,12 @@ love::Type Image::type("Image", &Texture::type);
 
 int Image::imageCount = 0;
 
+std::vector<Image *> Image::streamingImages;
+std::vector<Image *> Image::images;
+
+// Streaming Images keep levels up to this size resident from the start.
+static const int STREAMING_RESIDENT_SIZE = 64;
+
 Image::Image(const Slices &data, const Settings &settings, bool validatedata)
 	: Texture(data.getTextureType())
 	, settings(settings)
@@ -40,10 +48,34 @@ Image::Image(const Slices &data, const Settings &settings, bool validatedata)
 	, mipmapsType(settings.mipmaps ? MIPMAPS_GENERATED : MIPMAPS_NONE)
 	, sRGB(isGammaCorrect() && !settings.linear)
 	, usingDefaultTexture(false)
+	, uploadPending(settings.deferUpload && validatedata)
+	, uploadSlice(0)
+	, uploadMipmap(0)
+	, uploadRow(0)
+	, backgroundUpload(false)
+	, streaming(settings.streaming && validatedata && data.getTextureType() == TEXTURE_2D)
+	, residentMipmap(0)
+	, requestedMipmap(0)
+	, streamingMipmap(-1)
+	, streamRow(0)
+	, residencyPriority(0)
+	, evicted(false)
+	, evictedFrame(0)
+	, pixelsModified(false)
+	, dynamicMipmapsDirty(false)
+	, dataReleased(false)
 {
 	if (validatedata && data.validate() == MIPMAPS_DATA)
 		mipmapsType = MIPMAPS_DATA;
 
+	if (mipmapsType != MIPMAPS_DATA)
+		streaming = false;
+
+	if (streaming)
+		streamingImages.push_back(this);
+
+	images.push_back(this);
+
 	++imageCount;
 }
 
@@ -75,6 +107,12 @@ Image::Image(const Slices &slices, const Settings &settings)
 
 Image::~Image()
 {
+	disableStreaming();
+
+	auto it = std::find(images.begin(), images.end(), this);
+	if (it != images.end())
+		images.erase(it);
+
 	--imageCount;
 }
 
@@ -88,6 +126,9 @@ void Image::init(PixelFormat fmt, int w, int h, const Settings &settings)
 
 	format = fmt;
 
+	if (settings.dynamic && (isCompressed() || streaming))
+		throw love::Exception("Dynamic Images cannot be compressed or use mipmap streaming.");
+
 	if (isCompressed() && mipmapsType == MIPMAPS_GENERATED)
 		mipmapsType = MIPMAPS_NONE;
 
@@ -96,6 +137,17 @@ void Image::init(PixelFormat fmt, int w, int h, const Settings &settings)
 	if (mipmapCount > 1)
 		filter.mipmap = defaultMipmapFilter;
 
+	// Streaming Images start out with only their smallest levels resident.
+	if (streaming)
+	{
+		residentMipmap = mipmapCount - 1;
+
+		while (residentMipmap > 0 && std::max(getPixelWidth(residentMipmap - 1), getPixelHeight(residentMipmap - 1)) <= STREAMING_RESIDENT_SIZE)
+			residentMipmap--;
+
+		uploadMipmap = residentMipmap;
+	}
+
 	initQuad();
 }
 
@@ -113,6 +165,8 @@ void Image::uploadImageData(love::image::ImageDataBase *d, int level, int slice,
 
 void Image::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps)
 {
+	restore(false);
+
 	// No effect if the texture hasn't been created yet.
 	if (getHandle() == 0 || usingDefaultTexture)
 		return;
@@ -143,29 +197,77 @@ void Image::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap,
 
 	love::image::ImageDataBase *oldd = data.get(slice, mipmap);
 
-	if (oldd == nullptr)
+	if (oldd == nullptr && !dataReleased)
 		throw love::Exception("Image does not store ImageData!");
 
-	Rect currect = {0, 0, oldd->getWidth(), oldd->getHeight()};
+	Rect currect = {0, 0, mipw, miph};
 
 	// We can only replace the internal Data (used when reloading due to setMode)
 	// if the dimensions match. We also don't currently support partial updates
 	// of compressed textures.
-	if (rect == currect)
+	if (rect == currect && !dataReleased)
 		data.set(slice, mipmap, d);
-	else if (isPixelFormatCompressed(d->getFormat()))
+	else if (!(rect == currect) && isPixelFormatCompressed(d->getFormat()))
 		throw love::Exception("Compressed textures only support replacing the entire Image.");
+	else
+		pixelsModified = true;
 
 	Graphics::flushStreamDrawsGlobal();
 
+	love::image::ImageData *id = dynamic_cast<love::image::ImageData *>(d);
+
+	if (settings.dynamic && id != nullptr)
+	{
+		DynamicSource *source = getDynamicSource(slice, mipmap);
+
+		if (source == nullptr)
+		{
+			dynamicSources.emplace_back();
+			source = &dynamicSources.back();
+			source->slice = slice;
+			source->mipmap = mipmap;
+		}
+
+		if (source->data.get() != id || source->x != x || source->y != y)
+		{
+			// Changes recorded for the old ImageData are still read from it.
+			if (!source->dirty.empty())
+				flushPendingUpdates();
+
+			source->data.set(id);
+			source->x = x;
+			source->y = y;
+		}
+
+		markDirty(slice, mipmap, {0, 0, id->getWidth(), id->getHeight()});
+
+		if (reloadmipmaps && mipmap == 0 && getMipmapCount() > 1)
+		{
+			dynamicMipmapsDirty = true;
+
+			if (mipmapsType == MIPMAPS_DATA)
+				pixelsModified = true;
+		}
+
+		return;
+	}
+
 	uploadImageData(d, mipmap, slice, x, y);
 
 	if (reloadmipmaps && mipmap == 0 && getMipmapCount() > 1)
+	{
 		generateMipmaps();
+
+		if (mipmapsType == MIPMAPS_DATA)
+			pixelsModified = true;
+	}
 }
 
 void Image::replacePixels(const void *data, size_t size, int slice, int mipmap, const Rect &rect, bool reloadmipmaps)
 {
+	restore(false);
+	pixelsModified = true;
+
 	Graphics::flushStreamDrawsGlobal();
 
 	uploadByteData(format, data, size, mipmap, slice, rect);
@@ -174,6 +276,653 @@ void Image::replacePixels(const void *data, size_t size, int slice, int mipmap,
 		generateMipmaps();
 }
 
+void Image::replacePixelsStreamed(const void *data, size_t size, int slice, int mipmap, const Rect &rect)
+{
+	restore(false);
+	pixelsModified = true;
+
+	Graphics::flushStreamDrawsGlobal();
+
+	StreamedRect r = {mipmap, slice, rect, 0, size};
+	uploadStreamedByteData(format, data, size, &r, 1);
+}
+
+// Merges r into the dirty rectangles it overlaps or adjoins (when the merged
+// rectangle isn't larger than the two), so each pixel is uploaded once.
+static void addDirtyRect(std::vector<Rect> &rects, Rect r)
+{
+	const size_t MAX_DIRTY_RECTS = 16;
+
+	for (size_t i = 0; i < rects.size(); i++)
+	{
+		const Rect &o = rects[i];
+
+		int x1 = std::min(o.x, r.x);
+		int y1 = std::min(o.y, r.y);
+		int x2 = std::max(o.x + o.w, r.x + r.w);
+		int y2 = std::max(o.y + o.h, r.y + r.h);
+
+		int64 unionarea = (int64) (x2 - x1) * (y2 - y1);
+
+		if (unionarea <= (int64) o.w * o.h + (int64) r.w * r.h)
+		{
+			r = {x1, y1, x2 - x1, y2 - y1};
+			rects.erase(rects.begin() + i);
+
+			// The bigger rectangle can now merge with earlier ones.
+			i = (size_t) -1;
+		}
+	}
+
+	// Too many separate rectangles cost more in upload calls than the pixels
+	// between them.
+	if (rects.size() >= MAX_DIRTY_RECTS)
+	{
+		for (const Rect &o : rects)
+		{
+			int x2 = std::max(o.x + o.w, r.x + r.w);
+			int y2 = std::max(o.y + o.h, r.y + r.h);
+			r.x = std::min(o.x, r.x);
+			r.y = std::min(o.y, r.y);
+			r.w = x2 - r.x;
+			r.h = y2 - r.y;
+		}
+
+		rects.clear();
+	}
+
+	rects.push_back(r);
+}
+
+void Image::markDirty(int slice, int mipmap, const Rect &rect)
+{
+	if (!settings.dynamic)
+		throw love::Exception("Only dynamic Images can have dirty rectangles.");
+
+	DynamicSource *source = getDynamicSource(slice, mipmap);
+
+	if (source == nullptr)
+		throw love::Exception("No ImageData to update slice %d, mipmap %d of the Image from.", slice + 1, mipmap + 1);
+
+	// Clip to both the ImageData and the mipmap level.
+	int x1 = std::max(rect.x, std::max(0, -source->x));
+	int y1 = std::max(rect.y, std::max(0, -source->y));
+	int x2 = std::min(rect.x + rect.w, std::min(source->data->getWidth(), getPixelWidth(mipmap) - source->x));
+	int y2 = std::min(rect.y + rect.h, std::min(source->data->getHeight(), getPixelHeight(mipmap) - source->y));
+
+	if (x2 <= x1 || y2 <= y1)
+		return;
+
+	Graphics::flushStreamDrawsGlobal();
+
+	addDirtyRect(source->dirty, {x1, y1, x2 - x1, y2 - y1});
+	hasPendingUpdates = true;
+}
+
+bool Image::isDynamic() const
+{
+	return settings.dynamic;
+}
+
+Image::DynamicSource *Image::getDynamicSource(int slice, int mipmap)
+{
+	for (DynamicSource &source : dynamicSources)
+	{
+		if (source.slice == slice && source.mipmap == mipmap)
+			return &source;
+	}
+
+	// Defaults to the Image's own data.
+	auto id = dynamic_cast<love::image::ImageData *>(data.get(slice, mipmap));
+	if (id == nullptr)
+		return nullptr;
+
+	dynamicSources.emplace_back();
+
+	DynamicSource &source = dynamicSources.back();
+	source.slice = slice;
+	source.mipmap = mipmap;
+	source.data.set(id);
+	source.x = 0;
+	source.y = 0;
+
+	return &source;
+}
+
+void Image::flushPendingUpdates()
+{
+	hasPendingUpdates = false;
+
+	// Nothing can be uploaded to the default texture.
+	if (getHandle() == 0 || usingDefaultTexture)
+	{
+		for (DynamicSource &source : dynamicSources)
+			source.dirty.clear();
+
+		dynamicMipmapsDirty = false;
+		return;
+	}
+
+	size_t pixelsize = getPixelFormatSize(format);
+
+	std::vector<StreamedRect> rects;
+	size_t totalsize = 0;
+
+	for (const DynamicSource &source : dynamicSources)
+	{
+		for (const Rect &r : source.dirty)
+		{
+			Rect dstrect = {source.x + r.x, source.y + r.y, r.w, r.h};
+			StreamedRect s = {source.mipmap, source.slice, dstrect, totalsize, pixelsize * r.w * r.h};
+
+			rects.push_back(s);
+			totalsize += s.size;
+		}
+	}
+
+	if (dynamicScratch.size() < totalsize)
+		dynamicScratch.resize(totalsize);
+
+	// Only the dirty rows of each rectangle are copied out of the ImageData.
+	size_t index = 0;
+
+	for (DynamicSource &source : dynamicSources)
+	{
+		if (source.dirty.empty())
+			continue;
+
+		love::thread::Lock lock(source.data->getMutex());
+
+		const uint8 *src = (const uint8 *) source.data->getData();
+		size_t srcpitch = pixelsize * source.data->getWidth();
+
+		for (const Rect &r : source.dirty)
+		{
+			uint8 *dst = dynamicScratch.data() + rects[index++].offset;
+			size_t rowsize = pixelsize * r.w;
+
+			for (int y = 0; y < r.h; y++)
+				memcpy(dst + rowsize * y, src + srcpitch * (r.y + y) + pixelsize * r.x, rowsize);
+		}
+
+		source.dirty.clear();
+	}
+
+	if (!rects.empty())
+		uploadStreamedByteData(format, dynamicScratch.data(), totalsize, rects.data(), (int) rects.size());
+
+	if (dynamicMipmapsDirty)
+	{
+		dynamicMipmapsDirty = false;
+		generateMipmaps();
+	}
+}
+
+void Image::uploadStagedByteData(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r)
+{
+	uploadByteData(pixelformat, data, size, level, slice, r);
+}
+
+void Image::uploadStreamedByteData(PixelFormat pixelformat, const void *data, size_t /*size*/, const StreamedRect *rects, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		const StreamedRect &r = rects[i];
+		uploadByteData(pixelformat, (const uint8 *) data + r.offset, r.size, r.level, r.slice, r.rect);
+	}
+}
+
+size_t Image::uploadPendingData(size_t maxsize)
+{
+	if (!uploadPending || maxsize == 0)
+		return 0;
+
+	// Nothing can be uploaded to the default texture.
+	if (getHandle() == 0 || usingDefaultTexture)
+	{
+		uploadPending = false;
+		releaseUploadStaging();
+		return 0;
+	}
+
+	// A background upload takes the rest of the data at once, and doesn't
+	// count against the budget until it's complete.
+	if (backgroundUpload || beginBackgroundUpload())
+	{
+		backgroundUpload = true;
+
+		if (!pollBackgroundUpload(false))
+			return 0;
+
+		return finishBackgroundUpload();
+	}
+
+	Graphics::flushStreamDrawsGlobal();
+
+	int mipcount = mipmapsType == MIPMAPS_DATA ? data.getMipmapCount() : 1;
+	size_t uploaded = 0;
+
+	while (uploaded < maxsize && uploadMipmap < mipcount)
+	{
+		if (uploadSlice >= data.getSliceCount(uploadMipmap))
+		{
+			uploadMipmap++;
+			uploadSlice = 0;
+			continue;
+		}
+
+		love::image::ImageDataBase *d = data.get(uploadSlice, uploadMipmap);
+
+		if (d == nullptr)
+		{
+			uploadSlice++;
+			continue;
+		}
+
+		bool finished = false;
+		uploaded += uploadDataRows(d, uploadSlice, uploadMipmap, uploadRow, maxsize - uploaded, finished);
+
+		if (finished)
+			uploadSlice++;
+	}
+
+	if (uploadMipmap >= mipcount)
+	{
+		uploadPending = false;
+		releaseUploadStaging();
+		releaseUploadedData();
+
+		if (mipmapsType == MIPMAPS_GENERATED)
+			generateMipmaps();
+	}
+
+	return uploaded;
+}
+
+size_t Image::uploadDataRows(love::image::ImageDataBase *d, int slice, int mipmap, int &row, size_t maxsize, bool &finished)
+{
+	love::image::ImageData *id = dynamic_cast<love::image::ImageData *>(d);
+
+	love::thread::EmptyLock lock;
+	if (id != nullptr)
+		lock.setLock(id->getMutex());
+
+	int w = d->getWidth();
+	int h = d->getHeight();
+
+	// Compressed data is always uploaded one whole level at a time.
+	if (isPixelFormatCompressed(d->getFormat()))
+	{
+		Rect rect = {0, 0, w, h};
+		uploadStagedByteData(d->getFormat(), d->getData(), d->getSize(), mipmap, slice, rect);
+
+		row = 0;
+		finished = true;
+		return d->getSize();
+	}
+
+	size_t rowsize = d->getSize() / h;
+	int rows = (int) std::min(maxsize / rowsize, (size_t) (h - row));
+	rows = std::max(rows, 1);
+
+	Rect rect = {0, row, w, rows};
+	const uint8 *src = (const uint8 *) d->getData() + rowsize * row;
+	uploadStagedByteData(d->getFormat(), src, rowsize * rows, mipmap, slice, rect);
+
+	row += rows;
+	finished = row >= h;
+
+	if (finished)
+		row = 0;
+
+	return rowsize * rows;
+}
+
+bool Image::isUploadPending() const
+{
+	return uploadPending;
+}
+
+size_t Image::getPendingUploadSize() const
+{
+	if (!uploadPending)
+		return 0;
+
+	int mipcount = mipmapsType == MIPMAPS_DATA ? data.getMipmapCount() : 1;
+	size_t size = 0;
+
+	for (int mip = uploadMipmap; mip < mipcount; mip++)
+		size += getMipmapDataSize(mip);
+
+	return size;
+}
+
+void Image::resetPendingUpload()
+{
+	uploadSlice = 0;
+	uploadMipmap = residentMipmap;
+	uploadRow = 0;
+	backgroundUpload = false;
+}
+
+size_t Image::finishBackgroundUpload()
+{
+	size_t uploaded = getPendingUploadSize();
+
+	uploadPending = false;
+	backgroundUpload = false;
+
+	releaseUploadStaging();
+	releaseUploadedData();
+
+	return uploaded;
+}
+
+void Image::setReloadFunction(const ReloadFunction &fn)
+{
+	reloadFunction = fn;
+}
+
+bool Image::isDataRetained() const
+{
+	return !dataReleased;
+}
+
+void Image::releaseUploadedData()
+{
+	if (settings.retainData || streaming || uploadPending || dataReleased)
+		return;
+
+	if (getHandle() == 0 || usingDefaultTexture)
+		return;
+
+	data.clear();
+	dataReleased = true;
+}
+
+bool Image::reloadData()
+{
+	if (!dataReleased)
+		return true;
+
+	if (!reloadFunction)
+		return false;
+
+	Slices slices(texType);
+
+	try
+	{
+		reloadFunction(slices);
+
+		if (settings.mipmapFilter != love::image::MipmapGenerator::FILTER_MAX_ENUM)
+			slices.generateMipmaps(settings.mipmapFilter, sRGB);
+
+		if (settings.compact != love::image::FormatCompactor::MODE_NONE)
+			slices.compact(settings.compact, settings.compactQuality, getCompactFormats(settings.compact, sRGB));
+	}
+	catch (love::Exception &)
+	{
+		return false;
+	}
+
+	love::image::ImageDataBase *base = slices.get(0, 0);
+
+	if (base == nullptr || base->getFormat() != format
+		|| base->getWidth() != pixelWidth || base->getHeight() != pixelHeight)
+	{
+		return false;
+	}
+
+	if (mipmapsType == MIPMAPS_DATA && slices.getMipmapCount() < getMipmapCount())
+		return false;
+
+	data = slices;
+	dataReleased = false;
+	return true;
+}
+
+void Image::setRequestedMipmap(int mipmap)
+{
+	requestedMipmap = std::min(std::max(mipmap, 0), getMipmapCount() - 1);
+	updateResidency();
+}
+
+int Image::getRequestedMipmap() const
+{
+	return requestedMipmap;
+}
+
+int Image::getResidentMipmap() const
+{
+	return residentMipmap;
+}
+
+bool Image::isStreaming() const
+{
+	return streaming;
+}
+
+void Image::updateResidency()
+{
+	// Levels are only released once the initial upload is done.
+	if (!streaming || uploadPending || getHandle() == 0 || usingDefaultTexture)
+		return;
+
+	if (streamingMipmap < 0 && residentMipmap >= requestedMipmap)
+		return;
+
+	Graphics::flushStreamDrawsGlobal();
+
+	// The level being streamed in isn't needed anymore.
+	if (streamingMipmap >= 0 && streamingMipmap < requestedMipmap)
+	{
+		releaseMipmap(streamingMipmap);
+		streamingMipmap = -1;
+		streamRow = 0;
+		releaseUploadStaging();
+	}
+
+	if (residentMipmap < requestedMipmap)
+	{
+		int oldresident = residentMipmap;
+		residentMipmap = requestedMipmap;
+
+		// Stop sampling from the levels before they're released.
+		setBaseMipmap(residentMipmap);
+
+		for (int mip = oldresident; mip < residentMipmap; mip++)
+			releaseMipmap(mip);
+	}
+
+	setGraphicsMemorySize(getResidentMemorySize());
+}
+
+size_t Image::streamMipmaps(size_t maxsize)
+{
+	if (!streaming || uploadPending || maxsize == 0 || getHandle() == 0 || usingDefaultTexture)
+		return 0;
+
+	updateResidency();
+
+	if (residentMipmap <= requestedMipmap)
+		return 0;
+
+	Graphics::flushStreamDrawsGlobal();
+
+	int mip = residentMipmap - 1;
+
+	if (streamingMipmap != mip)
+	{
+		allocateMipmap(mip);
+		streamingMipmap = mip;
+		streamRow = 0;
+		setGraphicsMemorySize(getResidentMemorySize());
+	}
+
+	bool finished = false;
+	size_t uploaded = uploadDataRows(data.get(0, mip), 0, mip, streamRow, maxsize, finished);
+
+	// The level can only be sampled once all of it has been uploaded.
+	if (finished)
+	{
+		residentMipmap = mip;
+		streamingMipmap = -1;
+		setBaseMipmap(mip);
+
+		if (residentMipmap <= requestedMipmap)
+			releaseUploadStaging();
+	}
+
+	return uploaded;
+}
+
+size_t Image::getNextStreamingSize() const
+{
+	if (!streaming || uploadPending || residentMipmap <= requestedMipmap)
+		return 0;
+
+	if (streamingMipmap == residentMipmap - 1)
+		return 0;
+
+	return getMipmapDataSize(residentMipmap - 1);
+}
+
+size_t Image::getResidentMemorySize() const
+{
+	if (!streaming)
+		return 0;
+
+	size_t size = 0;
+
+	for (int mip = residentMipmap; mip < getMipmapCount(); mip++)
+		size += getMipmapDataSize(mip);
+
+	if (streamingMipmap >= 0)
+		size += getMipmapDataSize(streamingMipmap);
+
+	return size;
+}
+
+size_t Image::getMipmapDataSize(int mipmap) const
+{
+	size_t size = 0;
+
+	for (int slice = 0; slice < data.getSliceCount(mipmap); slice++)
+	{
+		love::image::ImageDataBase *d = data.get(slice, mipmap);
+		if (d != nullptr)
+			size += d->getSize();
+	}
+
+	return size;
+}
+
+void Image::setResidencyPriority(int priority)
+{
+	residencyPriority = priority;
+}
+
+int Image::getResidencyPriority() const
+{
+	return residencyPriority;
+}
+
+bool Image::isResident() const
+{
+	return !evicted;
+}
+
+bool Image::isEvictable() const
+{
+	if (evicted || streaming || uploadPending || pixelsModified || settings.dynamic || getHandle() == 0 || usingDefaultTexture)
+		return false;
+
+	if (dataReleased)
+		return (bool) reloadFunction;
+
+	// Images created without data have nothing to restore from.
+	return data.get(0, 0) != nullptr;
+}
+
+bool Image::evict()
+{
+	if (!isEvictable())
+		return false;
+
+	Graphics::flushStreamDrawsGlobal();
+
+	evictTexture();
+
+	evicted = true;
+	evictedFrame = usageFrame;
+	return true;
+}
+
+void Image::restore(bool async)
+{
+	if (!evicted)
+		return;
+
+	Graphics::flushStreamDrawsGlobal();
+
+	evicted = false;
+	restoreTexture(async);
+}
+
+bool Image::isUsedSinceEviction() const
+{
+	return evicted && getLastUsedFrame() > evictedFrame;
+}
+
+void Image::prepareGPUAccess(bool write)
+{
+	if (streaming)
+		throw love::Exception("Images with mipmap streaming cannot be copied to or from.");
+
+	restore(false);
+
+	if (uploadPending && backgroundUpload)
+	{
+		pollBackgroundUpload(true);
+		finishBackgroundUpload();
+	}
+	else if (uploadPending)
+		uploadPendingData(std::numeric_limits<size_t>::max());
+
+	if (hasPendingUpdates)
+		flushPendingUpdates();
+
+	// The texture no longer matches the Image's data.
+	if (write)
+		pixelsModified = true;
+}
+
+const std::vector<Image *> &Image::getImages()
+{
+	return images;
+}
+
+void Image::disableStreaming()
+{
+	if (streaming)
+	{
+		auto it = std::find(streamingImages.begin(), streamingImages.end(), this);
+		if (it != streamingImages.end())
+			streamingImages.erase(it);
+	}
+
+	streaming = false;
+	residentMipmap = 0;
+	requestedMipmap = 0;
+	streamingMipmap = -1;
+	streamRow = 0;
+}
+
+const std::vector<Image *> &Image::getStreamingImages()
+{
+	return streamingImages;
+}
+
 bool Image::isCompressed() const
 {
 	return isPixelFormatCompressed(format);
@@ -189,6 +938,38 @@ Image::MipmapsType Image::getMipmapsType() const
 	return mipmapsType;
 }
 
+love::image::ImageDataBase *Image::getImageData(int slice, int mipmap) const
+{
+	return data.get(slice, mipmap);
+}
+
+std::vector<PixelFormat> Image::getCompactFormats(love::image::FormatCompactor::Mode mode, bool srgb)
+{
+	std::vector<PixelFormat> formats;
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (gfx == nullptr)
+		return formats;
+
+	for (int i = 0; i < (int) PIXELFORMAT_MAX_ENUM; i++)
+	{
+		PixelFormat format = (PixelFormat) i;
+
+		if (!love::image::FormatCompactor::isCompactFormat(format, mode))
+			continue;
+
+		// sRGB Images need formats with sRGB variants, which among the
+		// compact formats are the compressed RGB and RGBA ones.
+		if (srgb && !isPixelFormatCompressed(format))
+			continue;
+
+		if (gfx->isImageFormatSupported(format))
+			formats.push_back(format);
+	}
+
+	return formats;
+}
+
 Image::Slices::Slices(TextureType textype)
 	: textureType(textype)
 {
@@ -249,6 +1030,55 @@ void Image::Slices::add(love::image::CompressedImageData *cdata, int startslice,
 	}
 }
 
+void Image::Slices::generateMipmaps(love::image::MipmapGenerator::Filter filter, bool srgb, bool parallel)
+{
+	if (textureType == TEXTURE_VOLUME)
+		throw love::Exception("Mipmaps cannot be generated on the CPU for volume images.");
+
+	for (int slice = 0; slice < getSliceCount(); slice++)
+	{
+		if (getMipmapCount(slice) != 1)
+			continue;
+
+		auto id = dynamic_cast<love::image::ImageData *>(get(slice, 0));
+		if (id == nullptr)
+			continue;
+
+		auto mipmaps = love::image::MipmapGenerator::generate(id, filter, srgb, parallel);
+
+		for (int mip = 0; mip < (int) mipmaps.size(); mip++)
+			set(slice, mip + 1, mipmaps[mip]);
+	}
+}
+
+void Image::Slices::compact(love::image::FormatCompactor::Mode mode, float minpsnr, const std::vector<PixelFormat> &formats, bool parallel)
+{
+	std::vector<love::image::ImageData *> images;
+
+	for (const auto &levels : data)
+	{
+		for (const auto &d : levels)
+		{
+			auto id = dynamic_cast<love::image::ImageData *>(d.get());
+			if (id == nullptr)
+				return;
+
+			images.push_back(id);
+		}
+	}
+
+	auto results = love::image::FormatCompactor::compact(images, mode, formats, minpsnr, parallel);
+	if (results.empty())
+		return;
+
+	size_t i = 0;
+	for (auto &levels : data)
+	{
+		for (auto &d : levels)
+			d = results[i++];
+	}
+}
+
 int Image::Slices::getSliceCount(int mip) const
 {
 	if (textureType == TEXTURE_VOLUME)
@@ -378,6 +1208,12 @@ StringMap<Image::SettingType, Image::SETTING_MAX_ENUM>::Entry Image::settingType
 	{ "mipmaps",  SETTING_MIPMAPS   },
 	{ "linear",   SETTING_LINEAR    },
 	{ "dpiscale", SETTING_DPI_SCALE },
+	{ "mipmapfilter", SETTING_MIPMAP_FILTER },
+	{ "streaming",    SETTING_STREAMING     },
+	{ "retaindata",   SETTING_RETAIN_DATA   },
+	{ "compact",        SETTING_COMPACT         },
+	{ "compactquality", SETTING_COMPACT_QUALITY },
+	{ "dynamic",        SETTING_DYNAMIC         },
 };
 
 StringMap<Image::SettingType, Image::SETTING_MAX_ENUM> Image::settingTypes(Image::settingTypeEntries, sizeof(Image::settingTypeEntries));
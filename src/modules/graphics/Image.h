@@ -26,8 +26,14 @@
 #include "common/math.h"
 #include "image/ImageData.h"
 #include "image/CompressedImageData.h"
+#include "image/MipmapGenerator.h"
+#include "image/FormatCompactor.h"
 #include "Texture.h"
 
+// C++
+#include <functional>
+#include <vector>
+
 namespace love
 {
 namespace graphics
@@ -51,6 +57,12 @@ public:
 		SETTING_MIPMAPS,
 		SETTING_LINEAR,
 		SETTING_DPI_SCALE,
+		SETTING_MIPMAP_FILTER,
+		SETTING_STREAMING,
+		SETTING_RETAIN_DATA,
+		SETTING_COMPACT,
+		SETTING_COMPACT_QUALITY,
+		SETTING_DYNAMIC,
 		SETTING_MAX_ENUM
 	};
 
@@ -59,6 +71,36 @@ public:
 		bool mipmaps = false;
 		bool linear = false;
 		float dpiScale = 1.0f;
+
+		// Mipmaps are generated on the CPU with this filter (see
+		// Slices::generateMipmaps) rather than by the GPU, unless it's
+		// FILTER_MAX_ENUM.
+		love::image::MipmapGenerator::Filter mipmapFilter = love::image::MipmapGenerator::FILTER_MAX_ENUM;
+
+		// Only the smallest mipmap levels are uploaded when the Image is
+		// created, the rest are streamed in over time (see streamMipmaps.)
+		// Only used by 2D Images with mipmap data.
+		bool streaming = false;
+
+		// If false, the data is released once it's been uploaded. It has to
+		// be provided again by the reload function (see setReloadFunction)
+		// if the texture is re-created. Streaming Images always retain it.
+		bool retainData = true;
+
+		// RGBA8 data is converted to the smallest supported format allowed by
+		// the mode (see Slices::compact), keeping at least compactQuality dB
+		// of PSNR for the lossy modes.
+		love::image::FormatCompactor::Mode compact = love::image::FormatCompactor::MODE_NONE;
+		float compactQuality = 38.0f;
+
+		// replacePixels and markDirty only record which pixels changed. They
+		// are uploaded straight from the ImageData when the Image is next
+		// drawn, with overlapping changes merged (see markDirty.)
+		bool dynamic = false;
+
+		// Not exposed to Lua. The texture is allocated but its data is only
+		// uploaded by uploadPendingData (see ImageLoader.)
+		bool deferUpload = false;
 	};
 
 	struct Slices
@@ -73,6 +115,20 @@ public:
 
 		void add(love::image::CompressedImageData *cdata, int startslice, int startmip, bool addallslices, bool addallmips);
 
+		/**
+		 * Generates the mipmap levels of each slice which has only base level
+		 * ImageData, replacing GPU mipmap generation. Volume textures aren't
+		 * supported.
+		 **/
+		void generateMipmaps(love::image::MipmapGenerator::Filter filter, bool srgb, bool parallel = true);
+
+		/**
+		 * Replaces the ImageData of every slice and mipmap level with one
+		 * compact format picked out of the given candidates, if one meets
+		 * the quality limit. Otherwise the data is left as-is.
+		 **/
+		void compact(love::image::FormatCompactor::Mode mode, float minpsnr, const std::vector<PixelFormat> &formats, bool parallel = true);
+
 		int getSliceCount(int mip = 0) const;
 		int getMipmapCount(int slice = 0) const;
 
@@ -91,17 +147,136 @@ public:
 
 	}; // Slices
 
+	typedef std::function<void(Slices &slices)> ReloadFunction;
+
 	virtual ~Image();
 
+	/**
+	 * Sets the function which provides the data of an Image that doesn't
+	 * retain it, when the texture has to be re-created (for example after the
+	 * graphics context is lost.) The function should throw if it can't load
+	 * the data.
+	 **/
+	void setReloadFunction(const ReloadFunction &fn);
+	bool isDataRetained() const;
+
 	void replacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps);
 	void replacePixels(const void *data, size_t size, int slice, int mipmap, const Rect &rect, bool reloadmipmaps);
 
+	/**
+	 * Like replacePixels, for data which is replaced every frame. Backends can
+	 * copy it into a ring of staging memory so the CPU never waits for the
+	 * driver or for the GPU to finish reading the last upload. Mipmaps are
+	 * not regenerated.
+	 **/
+	void replacePixelsStreamed(const void *data, size_t size, int slice, int mipmap, const Rect &rect);
+
+	/**
+	 * Marks a rectangle of the ImageData last given to replacePixels (or the
+	 * Image's own ImageData) for the slice and mipmap level as modified, in
+	 * the ImageData's coordinates. Only for dynamic Images; the pixels are
+	 * read and uploaded when the Image is next drawn.
+	 **/
+	void markDirty(int slice, int mipmap, const Rect &rect);
+	bool isDynamic() const;
+
+	/**
+	 * Uploads the next part of the data of an Image created with deferred
+	 * uploads, roughly maxsize bytes (but at least one row of pixels) at a
+	 * time. Returns the number of bytes uploaded.
+	 **/
+	size_t uploadPendingData(size_t maxsize);
+	bool isUploadPending() const;
+
+	// Size in bytes of the data uploadPendingData has yet to upload.
+	size_t getPendingUploadSize() const;
+
+	/**
+	 * Sets the most detailed mipmap level a streaming Image should keep
+	 * resident. More detailed levels are released immediately, less detailed
+	 * ones are streamed in over time.
+	 **/
+	void setRequestedMipmap(int mipmap);
+	int getRequestedMipmap() const;
+
+	// The most detailed mipmap level which can currently be sampled.
+	int getResidentMipmap() const;
+	bool isStreaming() const;
+
+	/**
+	 * Uploads part of the next more detailed mipmap level of a streaming
+	 * Image, if it hasn't reached the requested level yet. Works like
+	 * uploadPendingData. Returns the number of bytes uploaded.
+	 **/
+	size_t streamMipmaps(size_t maxsize);
+
+	// Size of the next level streamMipmaps would allocate, or 0 if it's
+	// already allocated or none is needed.
+	size_t getNextStreamingSize() const;
+
+	// GPU memory used by the allocated mipmap levels of a streaming Image.
+	size_t getResidentMemorySize() const;
+
+	static const std::vector<Image *> &getStreamingImages();
+
+	/**
+	 * Sets the priority used when Images are evicted from GPU memory to stay
+	 * within the texture memory budget (see Graphics::setTextureMemoryBudget.)
+	 * Images with a lower priority are evicted first, and the least recently
+	 * drawn first among equal priorities.
+	 **/
+	void setResidencyPriority(int priority);
+	int getResidencyPriority() const;
+
+	// False while the Image's texture is evicted.
+	bool isResident() const;
+
+	/**
+	 * Whether the texture can be evicted and later re-created from the
+	 * Image's data, which has to be retained or come from the reload function.
+	 * Textures with pixels which were replaced without updating the data can't
+	 * be, nor can streaming or dynamic Images or ones with deferred uploads.
+	 **/
+	bool isEvictable() const;
+
+	/**
+	 * Releases the texture's GPU memory. A transparent placeholder is drawn
+	 * instead until the Image is restored. Returns false if it can't be
+	 * evicted.
+	 **/
+	bool evict();
+
+	/**
+	 * Re-creates the texture of an evicted Image. If async is true, its data
+	 * is uploaded in the background within the image upload budget, like
+	 * Images reloaded after the graphics context was lost.
+	 **/
+	void restore(bool async);
+
+	// Whether an evicted Image has been drawn since it was evicted.
+	bool isUsedSinceEviction() const;
+
+	/**
+	 * Makes sure the texture has all of the Image's pixels before the GPU
+	 * copies from it or (if write is true) to it. See Graphics::copyTexture.
+	 **/
+	void prepareGPUAccess(bool write);
+
+	static const std::vector<Image *> &getImages();
+
 	bool isFormatLinear() const;
 	bool isCompressed() const;
 	MipmapsType getMipmapsType() const;
 
+	// Returns null if this Image doesn't store data for that slice / mipmap.
+	love::image::ImageDataBase *getImageData(int slice, int mipmap) const;
+
 	static int imageCount;
 
+	// Compact formats the current system can use for Images created with the
+	// given compact mode.
+	static std::vector<PixelFormat> getCompactFormats(love::image::FormatCompactor::Mode mode, bool srgb);
+
 	static bool getConstant(const char *in, SettingType &out);
 	static bool getConstant(SettingType in, const char *&out);
 	static const char *getConstant(SettingType in);
@@ -117,6 +292,83 @@ protected:
 
 	virtual void generateMipmaps() = 0;
 
+	// Used for the parts uploaded by uploadPendingData. Backends can stage the
+	// data so the upload doesn't wait for the GPU.
+	virtual void uploadStagedByteData(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r);
+
+	// Called once all pending data has been uploaded.
+	virtual void releaseUploadStaging() {}
+
+	/**
+	 * Backends which can upload on another thread start uploading all of the
+	 * remaining pending data there (and generating mipmaps, if needed.)
+	 * Returns false if the data has to be uploaded by uploadPendingData.
+	 **/
+	virtual bool beginBackgroundUpload() { return false; }
+
+	// Returns true once the upload started by beginBackgroundUpload is
+	// complete. Blocks until it is if wait is true.
+	virtual bool pollBackgroundUpload(bool /*wait*/) { return true; }
+
+	// One rectangle of a streamed upload, found at offset in its data.
+	struct StreamedRect
+	{
+		int level;
+		int slice;
+		Rect rect;
+		size_t offset;
+		size_t size;
+	};
+
+	// Used by replacePixelsStreamed and dynamic Images. All of the rectangles
+	// are uploaded out of the same block of data.
+	virtual void uploadStreamedByteData(PixelFormat pixelformat, const void *data, size_t size, const StreamedRect *rects, int count);
+
+	void flushPendingUpdates() override;
+
+	// Storage for individual mipmap levels, used by streaming Images. The
+	// base mipmap is the most detailed level which is sampled.
+	virtual void allocateMipmap(int /*mipmap*/) {}
+	virtual void releaseMipmap(int /*mipmap*/) {}
+	virtual void setBaseMipmap(int /*mipmap*/) {}
+
+	// Stops streaming altogether, for backends which can't sample from a
+	// subset of the mipmap levels.
+	void disableStreaming();
+
+	/**
+	 * Uploads rows of d starting at row, roughly maxsize bytes (but at least
+	 * one row of pixels) at a time. Compressed data is uploaded a whole level
+	 * at a time. Returns the number of bytes uploaded, advances row and sets
+	 * finished once the last row has been uploaded.
+	 **/
+	size_t uploadDataRows(love::image::ImageDataBase *d, int slice, int mipmap, int &row, size_t maxsize, bool &finished);
+
+	size_t getMipmapDataSize(int mipmap) const;
+
+	// Releases levels which are more detailed than the requested one.
+	void updateResidency();
+
+	// Releases the data once it's been uploaded, if the settings say so.
+	void releaseUploadedData();
+
+	// Gets released data back from the reload function. Returns false if it
+	// isn't available.
+	bool reloadData();
+
+	// Restarts deferred uploads from the beginning, for example when the
+	// texture had to be re-created.
+	void resetPendingUpload();
+
+	// Finishes deferred uploads done by beginBackgroundUpload. Returns the
+	// number of bytes uploaded.
+	size_t finishBackgroundUpload();
+
+	// Replaces the texture with a placeholder, and re-creates it. Called by
+	// evict and restore.
+	virtual void evictTexture() = 0;
+	virtual void restoreTexture(bool async) = 0;
+
 	// The settings used to initialize this Image.
 	Settings settings;
 
@@ -129,12 +381,62 @@ protected:
 	// back to a default texture.
 	bool usingDefaultTexture;
 
+	// Position of the next deferred upload.
+	bool uploadPending;
+	int uploadSlice;
+	int uploadMipmap;
+	int uploadRow;
+	bool backgroundUpload;
+
+	// Streaming mipmap residency. streamingMipmap is the level currently
+	// being uploaded, or -1.
+	bool streaming;
+
+	bool dataReleased;
+	ReloadFunction reloadFunction;
+
+	int residentMipmap;
+	int requestedMipmap;
+	int streamingMipmap;
+	int streamRow;
+
+	int residencyPriority;
+	bool evicted;
+	uint32 evictedFrame;
+
+	// Set once the texture holds pixels which aren't in the Image's data, and
+	// would be lost if it was evicted.
+	bool pixelsModified;
+
+	// The ImageData a dynamic Image's slice and mipmap level is updated from,
+	// placed at x,y. Dirty rectangles are in the ImageData's coordinates.
+	struct DynamicSource
+	{
+		int slice;
+		int mipmap;
+		StrongRef<love::image::ImageData> data;
+		int x;
+		int y;
+		std::vector<Rect> dirty;
+	};
+
+	std::vector<DynamicSource> dynamicSources;
+	bool dynamicMipmapsDirty;
+
+	// Holds the packed dirty rectangles of a flush.
+	std::vector<uint8> dynamicScratch;
+
 private:
 
 	Image(const Slices &data, const Settings &settings, bool validatedata);
 
 	void init(PixelFormat fmt, int w, int h, const Settings &settings);
 
+	DynamicSource *getDynamicSource(int slice, int mipmap);
+
+	static std::vector<Image *> streamingImages;
+	static std::vector<Image *> images;
+
 	static StringMap<SettingType, SETTING_MAX_ENUM>::Entry settingTypeEntries[];
 	static StringMap<SettingType, SETTING_MAX_ENUM> settingTypes;
 
@@ -0,0 +1,254 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "ImageLoader.h"
+#include "Graphics.h"
+#include "image/Image.h"
+#include "thread/WorkerPool.h"
+
+// C++
+#include <limits>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type ImageLoader::type("ImageLoader", &Object::type);
+
+ImageLoader::ImageLoader(love::Data *data, const Image::Settings &settings)
+	: decode(std::make_shared<Decode>())
+	, settings(settings)
+	, compactOnCreate(false)
+	, complete(false)
+{
+	this->settings.deferUpload = true;
+
+	auto idata = dynamic_cast<love::image::ImageData *>(data);
+	auto cdata = dynamic_cast<love::image::CompressedImageData *>(data);
+
+	if (idata != nullptr || cdata != nullptr)
+	{
+		decode->imageData.set(idata);
+		decode->compressedData.set(cdata);
+		decode->done = true;
+		compactOnCreate = idata != nullptr;
+		return;
+	}
+
+	auto imagemodule = Module::getInstance<love::image::Image>(Module::M_IMAGE);
+	if (imagemodule == nullptr)
+		throw love::Exception("Cannot load images without the love.image module.");
+
+	std::shared_ptr<Decode> state = decode;
+	StrongRef<love::Data> encoded(data);
+
+	auto mipmapfilter = settings.mipmapFilter;
+	bool srgb = isGammaCorrect() && !settings.linear;
+
+	// Supported formats are queried here, on the main thread.
+	auto compactmode = settings.compact;
+	float compactquality = settings.compactQuality;
+	std::vector<PixelFormat> compactformats;
+	if (compactmode != love::image::FormatCompactor::MODE_NONE)
+		compactformats = Image::getCompactFormats(compactmode, srgb);
+
+	thread::WorkerPool::getShared().submit([state, encoded, imagemodule, mipmapfilter, srgb, compactmode, compactquality, compactformats]()
+	{
+		StrongRef<love::image::ImageData> decodeddata;
+		StrongRef<love::image::CompressedImageData> decodedcdata;
+		std::vector<StrongRef<love::image::ImageData>> mipmaps;
+		std::vector<StrongRef<love::image::ImageDataBase>> compacted;
+		std::string err;
+
+		try
+		{
+			if (imagemodule->isCompressed(encoded))
+				decodedcdata.set(imagemodule->newCompressedData(encoded), Acquire::NORETAIN);
+			else
+				decodeddata.set(imagemodule->newImageData(encoded), Acquire::NORETAIN);
+
+			// Generated serially: this is already off the main thread, and
+			// using the pool here could hold up its other users.
+			if (decodeddata.get() != nullptr && mipmapfilter != love::image::MipmapGenerator::FILTER_MAX_ENUM)
+				mipmaps = love::image::MipmapGenerator::generate(decodeddata, mipmapfilter, srgb, false);
+
+			if (decodeddata.get() != nullptr && !compactformats.empty())
+			{
+				std::vector<love::image::ImageData *> levels = {decodeddata.get()};
+				for (const auto &mipmap : mipmaps)
+					levels.push_back(mipmap.get());
+
+				compacted = love::image::FormatCompactor::compact(levels, compactmode, compactformats, compactquality, false);
+			}
+		}
+		catch (std::exception &e)
+		{
+			err = e.what();
+		}
+
+		thread::Lock lock(state->mutex);
+		state->imageData = decodeddata;
+		state->compressedData = decodedcdata;
+		state->mipmaps = mipmaps;
+		state->compacted = compacted;
+		state->error = err;
+		state->done = true;
+		state->cond->broadcast();
+	});
+}
+
+ImageLoader::~ImageLoader()
+{
+}
+
+void ImageLoader::createImage()
+{
+	Image::Slices slices(TEXTURE_2D);
+
+	{
+		thread::Lock lock(decode->mutex);
+
+		if (!decode->error.empty())
+		{
+			error = decode->error;
+			complete = true;
+			return;
+		}
+
+		if (!decode->compacted.empty())
+		{
+			for (int mip = 0; mip < (int) decode->compacted.size(); mip++)
+				slices.set(0, mip, decode->compacted[mip]);
+		}
+		else
+		{
+			if (decode->imageData.get() != nullptr)
+				slices.set(0, 0, decode->imageData);
+			else
+				slices.add(decode->compressedData, 0, 0, false, settings.mipmaps);
+
+			for (int mip = 0; mip < (int) decode->mipmaps.size(); mip++)
+				slices.set(0, mip + 1, decode->mipmaps[mip]);
+		}
+
+		decode->imageData.set(nullptr);
+		decode->compressedData.set(nullptr);
+		decode->mipmaps.clear();
+		decode->compacted.clear();
+	}
+
+	// ImageData given directly still needs its mipmaps, and compacting.
+	try
+	{
+		bool srgb = isGammaCorrect() && !settings.linear;
+
+		if (settings.mipmapFilter != love::image::MipmapGenerator::FILTER_MAX_ENUM && slices.getMipmapCount(0) == 1)
+			slices.generateMipmaps(settings.mipmapFilter, srgb);
+
+		if (compactOnCreate && settings.compact != love::image::FormatCompactor::MODE_NONE)
+			slices.compact(settings.compact, settings.compactQuality, Image::getCompactFormats(settings.compact, srgb));
+	}
+	catch (love::Exception &e)
+	{
+		error = e.what();
+		complete = true;
+		return;
+	}
+
+	try
+	{
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		image.set(gfx->newImage(slices, settings), Acquire::NORETAIN);
+	}
+	catch (love::Exception &e)
+	{
+		error = e.what();
+		complete = true;
+	}
+}
+
+size_t ImageLoader::update(size_t maxsize)
+{
+	if (complete)
+		return 0;
+
+	if (image.get() == nullptr)
+	{
+		{
+			thread::Lock lock(decode->mutex);
+			if (!decode->done)
+				return 0;
+		}
+
+		createImage();
+
+		if (complete)
+			return 0;
+	}
+
+	size_t uploaded = 0;
+
+	try
+	{
+		uploaded = image->uploadPendingData(maxsize);
+	}
+	catch (love::Exception &e)
+	{
+		error = e.what();
+		image.set(nullptr);
+		complete = true;
+		return uploaded;
+	}
+
+	complete = !image->isUploadPending();
+	return uploaded;
+}
+
+void ImageLoader::wait()
+{
+	if (complete)
+		return;
+
+	{
+		thread::Lock lock(decode->mutex);
+		while (!decode->done)
+			decode->cond->wait(decode->mutex);
+	}
+
+	while (!complete)
+		update(std::numeric_limits<size_t>::max());
+}
+
+bool ImageLoader::isComplete() const
+{
+	return complete;
+}
+
+Image *ImageLoader::getImage() const
+{
+	if (!error.empty())
+		throw love::Exception("%s", error.c_str());
+
+	return complete ? image.get() : nullptr;
+}
+
+} // graphics
+} // love
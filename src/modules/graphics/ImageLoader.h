@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/Data.h"
+#include "thread/threads.h"
+#include "image/ImageData.h"
+#include "image/CompressedImageData.h"
+#include "Image.h"
+
+// C++
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * Loads an Image without stalling the calling thread. Encoded image files are
+ * decoded on worker threads, and the pixels are then uploaded in pieces spread
+ * across frames, within the per-frame image upload budget of Graphics.
+ **/
+class ImageLoader : public Object
+{
+public:
+
+	static love::Type type;
+
+	/**
+	 * The data can be an encoded image file, or an ImageData or
+	 * CompressedImageData which only needs to be uploaded.
+	 **/
+	ImageLoader(love::Data *data, const Image::Settings &settings);
+	virtual ~ImageLoader();
+
+	/**
+	 * Advances loading without blocking, uploading at most maxsize bytes of
+	 * pixel data. Returns the number of bytes uploaded.
+	 **/
+	size_t update(size_t maxsize);
+
+	/**
+	 * Blocks until the data is decoded, then uploads all remaining data.
+	 **/
+	void wait();
+
+	// True once the Image is ready to be drawn, or if loading failed.
+	bool isComplete() const;
+
+	/**
+	 * Returns null until loading is complete. Throws if loading failed.
+	 **/
+	Image *getImage() const;
+
+private:
+
+	// Shared with the worker thread which decodes the data.
+	struct Decode
+	{
+		love::thread::MutexRef mutex;
+		love::thread::ConditionalRef cond;
+		bool done = false;
+		StrongRef<love::image::ImageData> imageData;
+		StrongRef<love::image::CompressedImageData> compressedData;
+		std::vector<StrongRef<love::image::ImageData>> mipmaps;
+		// The base level followed by its mipmaps, if they were compacted.
+		std::vector<StrongRef<love::image::ImageDataBase>> compacted;
+		std::string error;
+	};
+
+	void createImage();
+
+	std::shared_ptr<Decode> decode;
+
+	Image::Settings settings;
+	StrongRef<Image> image;
+
+	// ImageData given directly is compacted by createImage rather than by a
+	// worker.
+	bool compactOnCreate;
+
+	std::string error;
+	bool complete;
+
+}; // ImageLoader
+
+} // graphics
+} // love
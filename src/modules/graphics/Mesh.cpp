@@ -28,6 +28,8 @@
 // C++
 #include <algorithm>
 #include <limits>
+#include <cmath>
+#include <cstring>
 
 namespace love
 {
@@ -68,6 +70,7 @@ Mesh::Mesh(graphics::Graphics *gfx, const std::vector<AttribFormat> &vertexforma
 	, useIndexBuffer(false)
 	, indexCount(0)
 	, indexDataType(INDEX_UINT16)
+	, indirectBuffer(nullptr)
 	, primitiveType(drawmode)
 	, rangeStart(-1)
 	, rangeCount(-1)
@@ -82,6 +85,7 @@ Mesh::Mesh(graphics::Graphics *gfx, const std::vector<AttribFormat> &vertexforma
 		throw love::Exception("Data size is too small for specified vertex attribute formats.");
 
 	vbo = gfx->newBuffer(datasize, data, BUFFER_VERTEX, usage, Buffer::MAP_EXPLICIT_RANGE_MODIFY | Buffer::MAP_READ);
+	updateNativeMemorySize();
 
 	vertexScratchBuffer = new char[vertexStride];
 }
@@ -95,6 +99,7 @@ Mesh::Mesh(graphics::Graphics *gfx, const std::vector<AttribFormat> &vertexforma
 	, useIndexBuffer(false)
 	, indexCount(0)
 	, indexDataType(vertex::getIndexDataTypeFromMax(vertexcount))
+	, indirectBuffer(nullptr)
 	, primitiveType(drawmode)
 	, rangeStart(-1)
 	, rangeCount(-1)
@@ -113,6 +118,7 @@ Mesh::Mesh(graphics::Graphics *gfx, const std::vector<AttribFormat> &vertexforma
 	memset(vbo->map(), 0, buffersize);
 	vbo->setMappedRangeModified(0, vbo->getSize());
 	vbo->unmap();
+	updateNativeMemorySize();
 
 	vertexScratchBuffer = new char[vertexStride];
 }
@@ -121,6 +127,7 @@ Mesh::~Mesh()
 {
 	delete vbo;
 	delete ibo;
+	delete indirectBuffer;
 	delete vertexScratchBuffer;
 
 	for (const auto &attrib : attachedAttributes)
@@ -176,6 +183,15 @@ size_t Mesh::getAttributeOffset(size_t attribindex) const
 	return offset;
 }
 
+void Mesh::updateNativeMemorySize()
+{
+	size_t size = vbo->getSize();
+	if (ibo != nullptr)
+		size += ibo->getSize();
+
+	setNativeMemorySize(type, (int64) size);
+}
+
 void Mesh::setVertex(size_t vertindex, const void *data, size_t datasize)
 {
 	if (vertindex >= vertexCount)
@@ -227,6 +243,30 @@ void Mesh::setVertexAttribute(size_t vertindex, int attribindex, const void *dat
 	vbo->setMappedRangeModified(offset, size);
 }
 
+void Mesh::setVertexAttributeXY(size_t startvertex, int attribindex, const Vector2 *positions, size_t count)
+{
+	if (attribindex < 0 || attribindex >= (int) vertexFormat.size())
+		throw love::Exception("Invalid vertex attribute index: %d", attribindex + 1);
+
+	const AttribFormat &format = vertexFormat[attribindex];
+	if (format.type != vertex::DATA_FLOAT || format.components < 2)
+		throw love::Exception("Vertex attribute '%s' must have at least two float components.", format.name.c_str());
+
+	if (startvertex + count > vertexCount)
+		throw love::Exception("Too many vertices (expected at most %d, got %d)", (int) (vertexCount - startvertex), (int) count);
+
+	if (count == 0)
+		return;
+
+	size_t offset = startvertex * vertexStride + getAttributeOffset(attribindex);
+	uint8 *bufferdata = (uint8 *) vbo->map() + offset;
+
+	for (size_t i = 0; i < count; i++)
+		memcpy(bufferdata + i * vertexStride, &positions[i], sizeof(float) * 2);
+
+	vbo->setMappedRangeModified(offset, (count - 1) * vertexStride + sizeof(float) * 2);
+}
+
 size_t Mesh::getVertexAttribute(size_t vertindex, int attribindex, void *data, size_t datasize)
 {
 	if (vertindex >= vertexCount)
@@ -380,6 +420,37 @@ void Mesh::flush()
 		ibo->unmap();
 }
 
+void Mesh::copyVertices(Mesh *dst, size_t srcstart, size_t dststart, size_t count)
+{
+	bool sameformat = vertexFormat.size() == dst->vertexFormat.size() && vertexStride == dst->vertexStride;
+
+	for (size_t i = 0; sameformat && i < vertexFormat.size(); i++)
+	{
+		sameformat = vertexFormat[i].type == dst->vertexFormat[i].type
+			&& vertexFormat[i].components == dst->vertexFormat[i].components;
+	}
+
+	if (!sameformat)
+		throw love::Exception("Meshes must have the same vertex format to copy vertices between them.");
+
+	if (count == 0)
+		return;
+
+	if (srcstart >= vertexCount || count > vertexCount - srcstart)
+		throw love::Exception("Invalid source vertex range.");
+
+	if (dststart >= dst->vertexCount || count > dst->vertexCount - dststart)
+		throw love::Exception("Invalid destination vertex range.");
+
+	if (dst == this && srcstart < dststart + count && dststart < srcstart + count)
+		throw love::Exception("Copied vertex ranges within the same Mesh must not overlap.");
+
+	flush();
+	dst->flush();
+
+	vbo->copyTo(srcstart * vertexStride, count * vertexStride, dst->vbo, dststart * vertexStride);
+}
+
 /**
  * Copies index data from a vector to a mapped index buffer.
  **/
@@ -418,6 +489,8 @@ void Mesh::setVertexMap(const std::vector<uint32> &map)
 		ibo = gfx->newBuffer(size, nullptr, BUFFER_INDEX, vbo->getUsage(), Buffer::MAP_READ);
 	}
 
+	updateNativeMemorySize();
+
 	useIndexBuffer = true;
 	indexCount = map.size();
 
@@ -455,6 +528,8 @@ void Mesh::setVertexMap(IndexDataType datatype, const void *data, size_t datasiz
 		ibo = gfx->newBuffer(datasize, nullptr, BUFFER_INDEX, vbo->getUsage(), Buffer::MAP_READ);
 	}
 
+	updateNativeMemorySize();
+
 	indexCount = datasize / vertex::getIndexDataSize(datatype);
 
 	if (!ibo || indexCount == 0)
@@ -517,6 +592,232 @@ size_t Mesh::getVertexMapCount() const
 	return indexCount;
 }
 
+// Size of the simulated post-transform vertex cache used by optimize().
+static const int VERTEX_CACHE_SIZE = 32;
+
+/**
+ * Scores a vertex for optimizeVertexCache. Vertices which are in the cache and
+ * vertices with few remaining triangles score higher. See Tom Forsyth's
+ * "Linear-Speed Vertex Cache Optimisation".
+ **/
+static float getVertexCacheScore(int cachepos, int activetris)
+{
+	if (activetris == 0)
+		return -1.0f;
+
+	float score = 0.0f;
+
+	// The vertices of the most recent triangle get a fixed score, so the
+	// next triangle doesn't depend on which order they were added in.
+	if (cachepos >= 0 && cachepos < 3)
+		score = 0.75f;
+	else if (cachepos >= 3)
+		score = powf(1.0f - (float) (cachepos - 3) / (float) (VERTEX_CACHE_SIZE - 3), 1.5f);
+
+	return score + 2.0f * powf((float) activetris, -0.5f);
+}
+
+static void optimizeVertexCache(std::vector<uint32> &indices, size_t vertexcount)
+{
+	size_t tricount = indices.size() / 3;
+
+	// Triangles using each vertex, in a compact adjacency list.
+	std::vector<uint32> activetris(vertexcount, 0);
+	for (uint32 v : indices)
+		activetris[v]++;
+
+	std::vector<uint32> trioffsets(vertexcount + 1, 0);
+	for (size_t i = 0; i < vertexcount; i++)
+		trioffsets[i + 1] = trioffsets[i] + activetris[i];
+
+	std::vector<uint32> vertextris(indices.size());
+	std::vector<uint32> filled(vertexcount, 0);
+	for (size_t t = 0; t < tricount; t++)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			uint32 v = indices[t * 3 + i];
+			vertextris[trioffsets[v] + filled[v]++] = (uint32) t;
+		}
+	}
+
+	std::vector<int> cachepos(vertexcount, -1);
+	std::vector<float> vertexscores(vertexcount);
+	for (size_t i = 0; i < vertexcount; i++)
+		vertexscores[i] = getVertexCacheScore(-1, activetris[i]);
+
+	std::vector<bool> emitted(tricount, false);
+
+	std::vector<uint32> cache;
+	std::vector<uint32> newcache;
+	cache.reserve(VERTEX_CACHE_SIZE + 3);
+	newcache.reserve(VERTEX_CACHE_SIZE + 3);
+
+	std::vector<uint32> result;
+	result.reserve(indices.size());
+
+	size_t nextunemitted = 0;
+	int64 besttri = -1;
+
+	for (size_t n = 0; n < tricount; n++)
+	{
+		// Nothing in the cache has triangles left, so continue with the next
+		// triangle in the original order.
+		if (besttri < 0)
+		{
+			while (emitted[nextunemitted])
+				nextunemitted++;
+			besttri = (int64) nextunemitted;
+		}
+
+		const uint32 *tri = &indices[besttri * 3];
+		emitted[besttri] = true;
+		result.insert(result.end(), tri, tri + 3);
+
+		// Remove the triangle from its vertices' lists of remaining triangles.
+		for (int i = 0; i < 3; i++)
+		{
+			uint32 v = tri[i];
+			uint32 *begin = &vertextris[trioffsets[v]];
+			uint32 *end = begin + activetris[v];
+
+			uint32 *it = std::find(begin, end, (uint32) besttri);
+			if (it != end)
+			{
+				*it = *(end - 1);
+				activetris[v]--;
+			}
+		}
+
+		// The triangle's vertices move to the front of the LRU cache.
+		newcache.assign(tri, tri + 3);
+		for (uint32 v : cache)
+		{
+			if (v != tri[0] && v != tri[1] && v != tri[2])
+				newcache.push_back(v);
+		}
+
+		std::swap(cache, newcache);
+
+		for (int i = 0; i < (int) cache.size(); i++)
+		{
+			uint32 v = cache[i];
+			cachepos[v] = i < VERTEX_CACHE_SIZE ? i : -1;
+			vertexscores[v] = getVertexCacheScore(cachepos[v], activetris[v]);
+		}
+
+		// Only triangles using vertices whose scores changed (including ones
+		// which were just evicted from the cache) need to be considered.
+		float bestscore = -1.0f;
+		besttri = -1;
+
+		for (uint32 v : cache)
+		{
+			const uint32 *vtris = &vertextris[trioffsets[v]];
+
+			for (uint32 j = 0; j < activetris[v]; j++)
+			{
+				const uint32 *t = &indices[vtris[j] * 3];
+				float score = vertexscores[t[0]] + vertexscores[t[1]] + vertexscores[t[2]];
+
+				if (score > bestscore)
+				{
+					bestscore = score;
+					besttri = vtris[j];
+				}
+			}
+		}
+
+		if ((int) cache.size() > VERTEX_CACHE_SIZE)
+			cache.resize(VERTEX_CACHE_SIZE);
+	}
+
+	indices.swap(result);
+}
+
+void Mesh::optimize()
+{
+	if (primitiveType != PRIMITIVE_TRIANGLES)
+		throw love::Exception("Only Meshes which use the triangles draw mode can be optimized.");
+
+	std::vector<uint32> indices;
+
+	if (!getVertexMap(indices))
+	{
+		indices.resize(vertexCount);
+		for (size_t i = 0; i < vertexCount; i++)
+			indices[i] = (uint32) i;
+	}
+
+	if (indices.size() % 3 != 0)
+		throw love::Exception("The Mesh's vertex map must contain a multiple of 3 indices to be optimized.");
+
+	for (uint32 index : indices)
+	{
+		if (index >= vertexCount)
+			throw love::Exception("Invalid vertex map value: %d", index + 1);
+	}
+
+	optimizeVertexCache(indices, vertexCount);
+
+	// Vertices used by attributes attached from other Meshes are indexed by the
+	// vertex map too, so they'd need to be reordered as well.
+	bool canreorder = true;
+	for (const auto &attrib : attachedAttributes)
+	{
+		if (attrib.second.mesh != this && attrib.second.step == STEP_PER_VERTEX)
+			canreorder = false;
+	}
+
+	size_t usedcount = vertexCount;
+
+	if (canreorder && vertexCount > 0)
+	{
+		// Number the vertices in the order they're first used. Unused vertices
+		// go at the end.
+		const uint32 unused = std::numeric_limits<uint32>::max();
+		std::vector<uint32> remap(vertexCount, unused);
+
+		uint32 next = 0;
+		for (uint32 &index : indices)
+		{
+			if (remap[index] == unused)
+				remap[index] = next++;
+			index = remap[index];
+		}
+
+		usedcount = next;
+
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			if (remap[i] == unused)
+				remap[i] = next++;
+		}
+
+		uint8 *vertices = (uint8 *) mapVertexData();
+		std::vector<uint8> oldvertices(vertices, vertices + vertexCount * vertexStride);
+
+		for (size_t i = 0; i < vertexCount; i++)
+			memcpy(vertices + remap[i] * vertexStride, &oldvertices[i * vertexStride], vertexStride);
+
+		unmapVertexData();
+	}
+
+	// All indices are below the number of used vertices, which may allow a
+	// smaller index type than the full vertex count would.
+	IndexDataType datatype = vertex::getIndexDataTypeFromMax(usedcount);
+
+	if (datatype == INDEX_UINT16)
+	{
+		std::vector<uint16> data(indices.begin(), indices.end());
+		setVertexMap(datatype, data.data(), data.size() * sizeof(uint16));
+	}
+	else
+		setVertexMap(datatype, indices.data(), indices.size() * sizeof(uint32));
+
+	useIndexBuffer = true;
+}
+
 void Mesh::setTexture(Texture *tex)
 {
 	texture.set(tex);
@@ -571,25 +872,14 @@ void Mesh::draw(Graphics *gfx, const love::Matrix4 &m)
 	drawInstanced(gfx, m, 1);
 }
 
-void Mesh::drawInstanced(Graphics *gfx, const Matrix4 &m, int instancecount)
+void Mesh::getDrawAttributes(vertex::Attributes &attributes, vertex::Buffers &buffers)
 {
-	if (vertexCount <= 0 || instancecount <= 0)
-		return;
-
-	if (instancecount > 1 && !gfx->getCapabilities().features[Graphics::FEATURE_INSTANCING])
-		throw love::Exception("Instancing is not supported on this system.");
-
-	gfx->flushStreamDraws();
-
 	if (Shader::isDefaultActive())
-		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+		Shader::attachDefault(getStandardShaderType());
 
 	if (Shader::current && texture.get())
 		Shader::current->checkMainTexture(texture);
 
-	vertex::Attributes attributes;
-	vertex::Buffers buffers;
-
 	int activebuffers = 0;
 
 	for (const auto &attrib : attachedAttributes)
@@ -630,6 +920,21 @@ void Mesh::drawInstanced(Graphics *gfx, const Matrix4 &m, int instancecount)
 	// Not supported on all platforms or GL versions, I believe.
 	if (!attributes.isEnabled(ATTRIB_POS))
 		throw love::Exception("Mesh must have an enabled VertexPosition attribute to be drawn.");
+}
+
+void Mesh::drawInstanced(Graphics *gfx, const Matrix4 &m, int instancecount)
+{
+	if (vertexCount <= 0 || instancecount <= 0)
+		return;
+
+	if (instancecount > 1 && !gfx->getCapabilities().features[Graphics::FEATURE_INSTANCING])
+		throw love::Exception("Instancing is not supported on this system.");
+
+	gfx->flushStreamDraws();
+
+	vertex::Attributes attributes;
+	vertex::Buffers buffers;
+	getDrawAttributes(attributes, buffers);
 
 	Graphics::TempTransform transform(gfx, m);
 
@@ -645,6 +950,7 @@ void Mesh::drawInstanced(Graphics *gfx, const Matrix4 &m, int instancecount)
 		cmd.instanceCount = instancecount;
 		cmd.texture = texture;
 		cmd.cullMode = gfx->getMeshCullMode();
+		cmd.cacheVertexArray = true;
 
 		int start = std::min(std::max(0, rangeStart), (int) indexCount - 1);
 		cmd.indexBufferOffset = start * vertex::getIndexDataSize(indexDataType);
@@ -673,11 +979,87 @@ void Mesh::drawInstanced(Graphics *gfx, const Matrix4 &m, int instancecount)
 		cmd.instanceCount = instancecount;
 		cmd.texture = texture;
 		cmd.cullMode = gfx->getMeshCullMode();
+		cmd.cacheVertexArray = true;
 
 		if (cmd.vertexCount > 0)
 			gfx->draw(cmd);
 	}
 }
 
+size_t Mesh::getIndirectRecordSize() const
+{
+	if (useIndexBuffer && ibo != nullptr && indexCount > 0)
+		return sizeof(Graphics::DrawIndexedIndirectArgs);
+	else
+		return sizeof(Graphics::DrawIndirectArgs);
+}
+
+void Mesh::drawIndirect(Graphics *gfx, const Matrix4 &m, const void *records, int drawcount)
+{
+	if (vertexCount <= 0 || drawcount <= 0)
+		return;
+
+	if (!gfx->getCapabilities().features[Graphics::FEATURE_DRAW_INDIRECT])
+		throw love::Exception("Indirect draws are not supported on this system.");
+
+	bool indexed = useIndexBuffer && ibo != nullptr && indexCount > 0;
+	size_t size = getIndirectRecordSize() * drawcount;
+
+	// The GPU reads the records directly, so make sure they stay in range.
+	for (int i = 0; i < drawcount; i++)
+	{
+		if (indexed)
+		{
+			const auto &args = ((const Graphics::DrawIndexedIndirectArgs *) records)[i];
+			if ((uint64) args.firstIndex + args.indexCount > indexCount)
+				throw love::Exception("Invalid index range in indirect draw %d.", i + 1);
+		}
+		else
+		{
+			const auto &args = ((const Graphics::DrawIndirectArgs *) records)[i];
+			if ((uint64) args.firstVertex + args.vertexCount > vertexCount)
+				throw love::Exception("Invalid vertex range in indirect draw %d.", i + 1);
+		}
+	}
+
+	gfx->flushStreamDraws();
+
+	if (indirectBuffer && size > indirectBuffer->getSize())
+	{
+		delete indirectBuffer;
+		indirectBuffer = nullptr;
+	}
+
+	if (!indirectBuffer)
+		indirectBuffer = gfx->newBuffer(size, nullptr, BUFFER_INDIRECT, vertex::USAGE_STREAM, 0);
+
+	indirectBuffer->fill(0, size, records);
+
+	vertex::Attributes attributes;
+	vertex::Buffers buffers;
+	getDrawAttributes(attributes, buffers);
+
+	Graphics::TempTransform transform(gfx, m);
+
+	Graphics::DrawIndirectCommand cmd(&attributes, &buffers, indirectBuffer);
+
+	cmd.primitiveType = primitiveType;
+	cmd.drawCount = drawcount;
+	cmd.texture = texture;
+	cmd.cullMode = gfx->getMeshCullMode();
+	cmd.cacheVertexArray = true;
+
+	if (indexed)
+	{
+		// Make sure the index buffer isn't mapped (sends data to GPU if needed.)
+		ibo->unmap();
+
+		cmd.indexBuffer = ibo;
+		cmd.indexType = indexDataType;
+	}
+
+	gfx->draw(cmd);
+}
+
 } // graphics
 } // love
@@ -27,6 +27,7 @@
 #include "common/StringMap.h"
 #include "Drawable.h"
 #include "Texture.h"
+#include "Shader.h"
 #include "vertex.h"
 #include "Buffer.h"
 
@@ -81,6 +82,12 @@ public:
 	void setVertexAttribute(size_t vertindex, int attribindex, const void *data, size_t datasize);
 	size_t getVertexAttribute(size_t vertindex, int attribindex, void *data, size_t datasize);
 
+	/**
+	 * Writes 2D positions into the first two components of a float attribute
+	 * for count vertices, leaving the rest of each vertex unchanged.
+	 **/
+	void setVertexAttributeXY(size_t startvertex, int attribindex, const Vector2 *positions, size_t count);
+
 	/**
 	 * Gets the total number of vertices that can be used when drawing the Mesh.
 	 **/
@@ -120,6 +127,18 @@ public:
 	 **/
 	void flush();
 
+	/**
+	 * Copies count vertices to another Mesh with the same vertex format,
+	 * without reading them back from the GPU.
+	 **/
+	void copyVertices(Mesh *dst, size_t srcstart, size_t dststart, size_t count);
+
+	/**
+	 * Gets the Buffer holding the vertex data, e.g. for binding it to a shader
+	 * storage block.
+	 **/
+	Buffer *getVertexBuffer() const { return vbo; }
+
 	/**
 	 * Sets the vertex map to use when drawing the Mesh. The vertex map
 	 * determines the order in which vertices are used by the draw mode.
@@ -141,6 +160,16 @@ public:
 	 **/
 	size_t getVertexMapCount() const;
 
+	/**
+	 * Reorders the triangles of the vertex map for better post-transform
+	 * vertex cache use, then reorders the vertices in the order they're first
+	 * used and updates the vertex map to match. The index data type is chosen
+	 * from the number of vertices in use. Only Meshes with the triangles draw
+	 * mode can be optimized. The vertices aren't reordered if the Mesh uses
+	 * per-vertex attributes attached from other Meshes.
+	 **/
+	void optimize();
+
 	/**
 	 * Sets the texture used when drawing the Mesh.
 	 **/
@@ -172,8 +201,27 @@ public:
 
 	void drawInstanced(Graphics *gfx, const Matrix4 &m, int instancecount);
 
+	/**
+	 * Submits drawcount draws of the Mesh at once. The records are
+	 * Graphics::DrawIndexedIndirectArgs if the Mesh uses a vertex map, and
+	 * Graphics::DrawIndirectArgs otherwise. Their base instance values offset
+	 * into per-instance attributes attached from other Meshes.
+	 **/
+	void drawIndirect(Graphics *gfx, const Matrix4 &m, const void *records, int drawcount);
+
+	// Size in bytes of one record passed to drawIndirect.
+	size_t getIndirectRecordSize() const;
+
 	static std::vector<AttribFormat> getDefaultVertexFormat();
 
+protected:
+
+	// The standard shader used for drawing when no custom Shader is active.
+	virtual Shader::StandardShader getStandardShaderType() const { return Shader::STANDARD_DEFAULT; }
+
+	// Also makes the shader used for drawing active.
+	virtual void getDrawAttributes(vertex::Attributes &attributes, vertex::Buffers &buffers);
+
 private:
 
 	friend class SpriteBatch;
@@ -189,6 +237,7 @@ private:
 	void setupAttachedAttributes();
 	void calculateAttributeSizes();
 	size_t getAttributeOffset(size_t attribindex) const;
+	void updateNativeMemorySize();
 
 	std::vector<AttribFormat> vertexFormat;
 	std::vector<size_t> attributeSizes;
@@ -210,6 +259,9 @@ private:
 	size_t indexCount;
 	IndexDataType indexDataType;
 
+	// Records for indirect draws, created when first needed.
+	Buffer *indirectBuffer;
+
 	PrimitiveType primitiveType;
 
 	int rangeStart;
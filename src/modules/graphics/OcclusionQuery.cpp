@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "OcclusionQuery.h"
+#include "Graphics.h"
+#include "common/Exception.h"
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type OcclusionQuery::type("OcclusionQuery", &Object::type);
+
+OcclusionQuery *OcclusionQuery::current = nullptr;
+
+OcclusionQuery::OcclusionQuery(bool conservative)
+	: conservative(conservative)
+{
+}
+
+OcclusionQuery::~OcclusionQuery()
+{
+	if (current == this)
+		current = nullptr;
+}
+
+void OcclusionQuery::start()
+{
+	if (current == this)
+		throw love::Exception("This OcclusionQuery is already active.");
+	else if (current != nullptr)
+		throw love::Exception("Only one OcclusionQuery can be active at a time.");
+
+	// Batched draws from before the query mustn't be counted.
+	Graphics::flushStreamDrawsGlobal();
+
+	startQuery();
+	current = this;
+}
+
+void OcclusionQuery::stop()
+{
+	if (current != this)
+		throw love::Exception("This OcclusionQuery is not active.");
+
+	Graphics::flushStreamDrawsGlobal();
+
+	stopQuery();
+	current = nullptr;
+}
+
+bool OcclusionQuery::isActive() const
+{
+	return current == this;
+}
+
+bool OcclusionQuery::isConservative() const
+{
+	return conservative;
+}
+
+} // graphics
+} // love
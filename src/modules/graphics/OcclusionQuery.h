@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * Finds out whether any samples of the draws made between start and stop
+ * passed the depth and stencil tests, e.g. to skip expensive lighting or
+ * effects whose proxy geometry ended up fully hidden or off-screen.
+ *
+ * Results are never waited for. Every start/stop round uses its own GPU
+ * query, and getResult returns the most recent round the GPU has finished,
+ * which is usually a frame or two behind.
+ *
+ * Only one query can be active at a time. A query can stay active across
+ * Canvas switches.
+ **/
+class OcclusionQuery : public Object
+{
+public:
+
+	static love::Type type;
+
+	// The currently active query, if any.
+	static OcclusionQuery *current;
+
+	/**
+	 * Conservative queries may report hidden draws as visible, in exchange
+	 * for being cheaper on some GPUs.
+	 **/
+	OcclusionQuery(bool conservative);
+	virtual ~OcclusionQuery();
+
+	void start();
+	void stop();
+	bool isActive() const;
+
+	bool isConservative() const;
+
+	/**
+	 * Gets the result of the most recent round the GPU has finished. age is
+	 * the number of rounds stopped since that one (0 if it's the latest).
+	 * Returns false if no round has finished yet.
+	 **/
+	virtual bool getResult(bool &visible, int &age) = 0;
+
+protected:
+
+	virtual void startQuery() = 0;
+	virtual void stopQuery() = 0;
+
+	bool conservative;
+
+}; // OcclusionQuery
+
+} // graphics
+} // love
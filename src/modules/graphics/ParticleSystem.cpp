@@ -24,12 +24,22 @@
 #include "Graphics.h"
 
 #include "common/math.h"
-#include "modules/math/RandomGenerator.h"
+#include "thread/WorkerPool.h"
 
 // STD
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
+#include <cstddef>
+
+#if defined(LOVE_SIMD_SSE)
+#include <xmmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace love
 {
@@ -39,9 +49,17 @@ namespace graphics
 namespace
 {
 
-love::math::RandomGenerator rng;
+// Only used on the main thread, to seed each ParticleSystem's own generator.
+love::math::RandomGenerator seedRNG;
+
+love::math::RandomGenerator::Seed newSeed()
+{
+	love::math::RandomGenerator::Seed seed;
+	seed.b64 = seedRNG.rand();
+	return seed;
+}
 
-float calculate_variation(float inner, float outer, float var)
+float calculate_variation(love::math::RandomGenerator &rng, float inner, float outer, float var)
 {
 	float low = inner - (outer/2.0f)*var;
 	float high = inner + (outer/2.0f)*var;
@@ -49,15 +67,28 @@ float calculate_variation(float inner, float outer, float var)
 	return low*(1-r)+high*r;
 }
 
+void sendFloats(Shader *shader, const char *name, const float *values, int count)
+{
+	const Shader::UniformInfo *info = shader->getUniformInfo(name);
+
+	// Unused uniforms are optimized out of custom shaders.
+	if (info == nullptr || info->baseType != Shader::UNIFORM_FLOAT)
+		return;
+
+	count = std::min(count, info->count);
+	memcpy(info->floats, values, sizeof(float) * info->components * count);
+	shader->updateUniform(info, count);
+}
+
 } // anonymous namespace
 
 love::Type ParticleSystem::type("ParticleSystem", &Drawable::type);
 
 ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 	: pMem(nullptr)
-	, pFree(nullptr)
-	, pHead(nullptr)
-	, pTail(nullptr)
+	, pCapacity(0)
+	, pBegin(0)
+	, pEnd(0)
 	, texture(texture)
 	, active(true)
 	, insertMode(INSERT_MODE_TOP)
@@ -94,7 +125,14 @@ ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 	, defaultOffset(true)
 	, relativeRotation(false)
 	, vertexAttributes(vertex::CommonFormat::XYf_STf_RGBAub, 0)
+	, compactVertexAttributes(vertex::CommonFormat::XYf_STus_RGBAub, 0)
 	, buffer(nullptr)
+	, gpuSimulated(false)
+	, gpuSimulator(nullptr)
+	, gpuCornerBuffer(nullptr)
+	, gpuTime(0.0)
+	, gpuNextSlot(0)
+	, gpuPendingFirst(0)
 {
 	if (size == 0 || size > MAX_PARTICLES)
 		throw love::Exception("Invalid ParticleSystem size.");
@@ -102,6 +140,8 @@ ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 	if (texture->getTextureType() != TEXTURE_2D)
 		throw love::Exception("Only 2D textures can be used with ParticleSystems.");
 
+	rng.setSeed(newSeed());
+
 	sizes.push_back(1.0f);
 	colors.push_back(Colorf(1.0f, 1.0f, 1.0f, 1.0f));
 
@@ -110,9 +150,9 @@ ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 
 ParticleSystem::ParticleSystem(const ParticleSystem &p)
 	: pMem(nullptr)
-	, pFree(nullptr)
-	, pHead(nullptr)
-	, pTail(nullptr)
+	, pCapacity(0)
+	, pBegin(0)
+	, pEnd(0)
 	, texture(p.texture)
 	, active(p.active)
 	, insertMode(p.insertMode)
@@ -155,8 +195,16 @@ ParticleSystem::ParticleSystem(const ParticleSystem &p)
 	, quads(p.quads)
 	, relativeRotation(p.relativeRotation)
 	, vertexAttributes(p.vertexAttributes)
+	, compactVertexAttributes(p.compactVertexAttributes)
 	, buffer(nullptr)
-{
+	, gpuSimulated(p.gpuSimulated)
+	, gpuSimulator(nullptr)
+	, gpuCornerBuffer(nullptr)
+	, gpuTime(0.0)
+	, gpuNextSlot(0)
+	, gpuPendingFirst(0)
+{
+	rng.setSeed(newSeed());
 	setBufferSize(maxParticles);
 }
 
@@ -185,30 +233,63 @@ void ParticleSystem::createBuffers(size_t size)
 {
 	try
 	{
-		pFree = pMem = new Particle[size];
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+		// GPU-simulated particles only pass through the field arrays while
+		// they're being spawned.
+		pCapacity = gpuSimulated ? 2 : (uint32) size * 2;
+		pMem = new float[(size_t) pCapacity * FIELD_MAX_ENUM];
 		maxParticles = (uint32) size;
 
-		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		for (int i = 0; i < FIELD_MAX_ENUM; i++)
+			pFields[i] = pMem + (size_t) pCapacity * i;
+
+		if (gpuSimulated)
+		{
+			gpuSimulator = gfx->newGPUParticleSimulator((uint32) size);
+			gpuSlotDeath.resize(size);
 
-		size_t bytes = sizeof(Vertex) * size * 4;
-		buffer = gfx->newBuffer(bytes, nullptr, BUFFER_VERTEX, vertex::USAGE_STREAM, 0);
+			// Unit square corners, ordered for a triangle strip like Quad's.
+			const float corners[] = {0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f, 1.0f};
+			gpuCornerBuffer = gfx->newBuffer(sizeof(corners), corners, BUFFER_VERTEX, vertex::USAGE_STATIC, 0);
+		}
+		else
+		{
+			size_t bytes = sizeof(Vertex) * size * 4;
+			buffer = gfx->newBuffer(bytes, nullptr, BUFFER_VERTEX, vertex::USAGE_STREAM, 0);
+		}
 	}
 	catch (std::bad_alloc &)
 	{
 		deleteBuffers();
 		throw love::Exception("Out of memory");
 	}
+	catch (love::Exception &)
+	{
+		deleteBuffers();
+		throw;
+	}
 }
 
 void ParticleSystem::deleteBuffers()
 {
 	delete[] pMem;
 	delete buffer;
+	delete gpuSimulator;
+	delete gpuCornerBuffer;
 
 	pMem = nullptr;
 	buffer = nullptr;
+	gpuSimulator = nullptr;
+	gpuCornerBuffer = nullptr;
+
+	gpuSlotDeath.clear();
+	gpuPendingStates.clear();
+	gpuPendingSpawns.clear();
 	maxParticles = 0;
 	activeParticles = 0;
+	pCapacity = 0;
+	pBegin = pEnd = 0;
 }
 
 void ParticleSystem::setBufferSize(uint32 size)
@@ -227,46 +308,39 @@ uint32 ParticleSystem::getBufferSize() const
 
 void ParticleSystem::addParticle(float t)
 {
-	if (isFull())
-		return;
-
-	// Gets a free particle and updates the allocation pointer.
-	Particle *p = pFree++;
-	initParticle(p, t);
-
-	switch (insertMode)
+	if (gpuSimulator != nullptr)
 	{
-	default:
-	case INSERT_MODE_TOP:
-		insertTop(p);
-		break;
-	case INSERT_MODE_BOTTOM:
-		insertBottom(p);
-		break;
-	case INSERT_MODE_RANDOM:
-		insertRandom(p);
-		break;
+		addGPUParticle(t);
+		return;
 	}
 
+	if (isFull())
+		return;
+
+	initParticle(insertParticle(), t);
 	activeParticles++;
 }
 
-void ParticleSystem::initParticle(Particle *p, float t)
+void ParticleSystem::initParticle(uint32 index, float t)
 {
 	float min,max;
 
 	// Linearly interpolate between the previous and current emitter position.
 	love::Vector2 pos = prevPosition + (position - prevPosition) * t;
 
+	float plife;
+
 	min = particleLifeMin;
 	max = particleLifeMax;
 	if (min == max)
-		p->life = min;
+		plife = min;
 	else
-		p->life = (float) rng.random(min, max);
-	p->lifetime = p->life;
+		plife = (float) rng.random(min, max);
+
+	pFields[FIELD_LIFE][index] = plife;
+	pFields[FIELD_LIFETIME][index] = plife;
 
-	p->position = pos;
+	love::Vector2 ppos = pos;
 
 	min = direction - spread/2.0f;
 	max = direction + spread/2.0f;
@@ -282,15 +356,15 @@ void ParticleSystem::initParticle(Particle *p, float t)
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
 		rand_x = (float) rng.random(-emissionArea.x, emissionArea.x);
 		rand_y = (float) rng.random(-emissionArea.y, emissionArea.y);
-		p->position.x += c * rand_x - s * rand_y;
-		p->position.y += s * rand_x + c * rand_y;
+		ppos.x += c * rand_x - s * rand_y;
+		ppos.y += s * rand_x + c * rand_y;
 		break;
 	case DISTRIBUTION_NORMAL:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
 		rand_x = (float) rng.randomNormal(emissionArea.x);
 		rand_y = (float) rng.randomNormal(emissionArea.y);
-		p->position.x += c * rand_x - s * rand_y;
-		p->position.y += s * rand_x + c * rand_y;
+		ppos.x += c * rand_x - s * rand_y;
+		ppos.y += s * rand_x + c * rand_y;
 		break;
 	case DISTRIBUTION_ELLIPSE:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
@@ -298,16 +372,16 @@ void ParticleSystem::initParticle(Particle *p, float t)
 		rand_y = (float) rng.random(-1, 1);
 		min = emissionArea.x * (rand_x * sqrt(1 - 0.5f*pow(rand_y, 2)));
 		max = emissionArea.y * (rand_y * sqrt(1 - 0.5f*pow(rand_x, 2)));
-		p->position.x += c * min - s * max;
-		p->position.y += s * min + c * max;
+		ppos.x += c * min - s * max;
+		ppos.y += s * min + c * max;
 		break;
 	case DISTRIBUTION_BORDER_ELLIPSE:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
 		rand_x = (float) rng.random(0, LOVE_M_PI * 2);
 		min = cosf(rand_x) * emissionArea.x;
 		max = sinf(rand_x) * emissionArea.y;
-		p->position.x += c * min - s * max;
-		p->position.y += s * min + c * max;
+		ppos.x += c * min - s * max;
+		ppos.y += s * min + c * max;
 		break;
 	case DISTRIBUTION_BORDER_RECTANGLE:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
@@ -316,26 +390,26 @@ void ParticleSystem::initParticle(Particle *p, float t)
 		if (rand_x < -rand_y)
 		{
 			min = rand_x + rand_y + emissionArea.x;
-			p->position.x += c * min - s * -emissionArea.y;
-			p->position.y += s * min + c * -emissionArea.y;
+			ppos.x += c * min - s * -emissionArea.y;
+			ppos.y += s * min + c * -emissionArea.y;
 		}
 		else if (rand_x < 0)
 		{
 			max = rand_x + emissionArea.y;
-			p->position.x += c * -emissionArea.x - s * max;
-			p->position.y += s * -emissionArea.x + c * max;
+			ppos.x += c * -emissionArea.x - s * max;
+			ppos.y += s * -emissionArea.x + c * max;
 		}
 		else if (rand_x < rand_y)
 		{
 			max = rand_x - emissionArea.y;
-			p->position.x += c * emissionArea.x - s * max;
-			p->position.y += s * emissionArea.x + c * max;
+			ppos.x += c * emissionArea.x - s * max;
+			ppos.y += s * emissionArea.x + c * max;
 		}
 		else
 		{
 			min = rand_x - rand_y - emissionArea.x;
-			p->position.x += c * min - s * emissionArea.y;
-			p->position.y += s * min + c * emissionArea.y;
+			ppos.x += c * min - s * emissionArea.y;
+			ppos.y += s * min + c * emissionArea.y;
 		}
 		break;
 	case DISTRIBUTION_NONE:
@@ -345,154 +419,270 @@ void ParticleSystem::initParticle(Particle *p, float t)
 
 	// Determine if the origin of each particle is the center of the area
 	if (directionRelativeToEmissionCenter)
-		dir += atan2(p->position.y - pos.y, p->position.x - pos.x);
+		dir += atan2(ppos.y - pos.y, ppos.x - pos.x);
 
-	p->origin = pos;
+	pFields[FIELD_POSITION_X][index] = ppos.x;
+	pFields[FIELD_POSITION_Y][index] = ppos.y;
+
+	pFields[FIELD_ORIGIN_X][index] = pos.x;
+	pFields[FIELD_ORIGIN_Y][index] = pos.y;
 
 	min = speedMin;
 	max = speedMax;
 	float speed = (float) rng.random(min, max);
 
-	p->velocity = love::Vector2(cosf(dir), sinf(dir)) * speed;
+	love::Vector2 velocity = love::Vector2(cosf(dir), sinf(dir)) * speed;
+
+	pFields[FIELD_VELOCITY_X][index] = velocity.x;
+	pFields[FIELD_VELOCITY_Y][index] = velocity.y;
 
-	p->linearAcceleration.x = (float) rng.random(linearAccelerationMin.x, linearAccelerationMax.x);
-	p->linearAcceleration.y = (float) rng.random(linearAccelerationMin.y, linearAccelerationMax.y);
+	pFields[FIELD_LINEAR_ACCELERATION_X][index] = (float) rng.random(linearAccelerationMin.x, linearAccelerationMax.x);
+	pFields[FIELD_LINEAR_ACCELERATION_Y][index] = (float) rng.random(linearAccelerationMin.y, linearAccelerationMax.y);
 
 	min = radialAccelerationMin;
 	max = radialAccelerationMax;
-	p->radialAcceleration = (float) rng.random(min, max);
+	pFields[FIELD_RADIAL_ACCELERATION][index] = (float) rng.random(min, max);
 
 	min = tangentialAccelerationMin;
 	max = tangentialAccelerationMax;
-	p->tangentialAcceleration = (float) rng.random(min, max);
+	pFields[FIELD_TANGENTIAL_ACCELERATION][index] = (float) rng.random(min, max);
 
 	min = linearDampingMin;
 	max = linearDampingMax;
-	p->linearDamping = (float) rng.random(min, max);
+	pFields[FIELD_LINEAR_DAMPING][index] = (float) rng.random(min, max);
 
-	p->sizeOffset       = (float) rng.random(sizeVariation); // time offset for size change
-	p->sizeIntervalSize = (1.0f - (float) rng.random(sizeVariation)) - p->sizeOffset;
-	p->size = sizes[(size_t)(p->sizeOffset - .5f) * (sizes.size() - 1)];
+	float sizeoffset = (float) rng.random(sizeVariation); // time offset for size change
+	pFields[FIELD_SIZE_OFFSET][index] = sizeoffset;
+	pFields[FIELD_SIZE_INTERVAL_SIZE][index] = (1.0f - (float) rng.random(sizeVariation)) - sizeoffset;
+	pFields[FIELD_SIZE][index] = sizes[(size_t)(sizeoffset - .5f) * (sizes.size() - 1)];
 
 	min = rotationMin;
 	max = rotationMax;
-	p->spinStart = calculate_variation(spinStart, spinEnd, spinVariation);
-	p->spinEnd = calculate_variation(spinEnd, spinStart, spinVariation);
-	p->rotation = (float) rng.random(min, max);
+	pFields[FIELD_SPIN_START][index] = calculate_variation(rng, spinStart, spinEnd, spinVariation);
+	pFields[FIELD_SPIN_END][index] = calculate_variation(rng, spinEnd, spinStart, spinVariation);
 
-	p->angle = p->rotation;
+	float rotation = (float) rng.random(min, max);
+	pFields[FIELD_ROTATION][index] = rotation;
+
+	float angle = rotation;
 	if (relativeRotation)
-		p->angle += atan2f(p->velocity.y, p->velocity.x);
+		angle += atan2f(velocity.y, velocity.x);
+	pFields[FIELD_ANGLE][index] = angle;
 
-	p->color = colors[0];
+	pFields[FIELD_COLOR_R][index] = colors[0].r;
+	pFields[FIELD_COLOR_G][index] = colors[0].g;
+	pFields[FIELD_COLOR_B][index] = colors[0].b;
+	pFields[FIELD_COLOR_A][index] = colors[0].a;
 
-	p->quadIndex = 0;
+	pFields[FIELD_QUAD_INDEX][index] = 0.0f;
 }
 
-void ParticleSystem::insertTop(Particle *p)
+uint32 ParticleSystem::insertParticle()
 {
-	if (pHead == nullptr)
+	uint32 index = 0;
+
+	switch (insertMode)
 	{
-		pHead = p;
-		p->prev = nullptr;
-	}
-	else
+	default:
+	case INSERT_MODE_TOP:
+		if (pEnd == pCapacity)
+			recenterParticles();
+		index = pEnd++;
+		break;
+	case INSERT_MODE_BOTTOM:
+		if (pBegin == 0)
+			recenterParticles();
+		index = --pBegin;
+		break;
+	case INSERT_MODE_RANDOM:
 	{
-		pTail->next = p;
-		p->prev = pTail;
+		if (pEnd == pCapacity)
+			recenterParticles();
+		index = pEnd++;
+
+		// Nonuniform, but 64-bit is so large nobody will notice. Hopefully.
+		uint32 pos = pBegin + (uint32) (rng.rand() % ((uint64) activeParticles + 1));
+
+		// Rather than shifting everything after the random position, the
+		// particle already there is moved to the top.
+		if (pos != index)
+		{
+			moveParticle(index, pos);
+			index = pos;
+		}
+		break;
 	}
-	p->next = nullptr;
-	pTail = p;
+	}
+
+	return index;
 }
 
-void ParticleSystem::insertBottom(Particle *p)
+void ParticleSystem::recenterParticles()
 {
-	if (pTail == nullptr)
-	{
-		pTail = p;
-		p->next = nullptr;
-	}
-	else
+	uint32 newbegin = (pCapacity - activeParticles) / 2;
+
+	if (newbegin == pBegin)
+		return;
+
+	for (int i = 0; i < FIELD_MAX_ENUM; i++)
+		memmove(pFields[i] + newbegin, pFields[i] + pBegin, activeParticles * sizeof(float));
+
+	pBegin = newbegin;
+	pEnd = newbegin + activeParticles;
+}
+
+void ParticleSystem::moveParticle(uint32 dst, uint32 src)
+{
+	for (int i = 0; i < FIELD_MAX_ENUM; i++)
+		pFields[i][dst] = pFields[i][src];
+}
+
+void ParticleSystem::removeDeadParticles(float dt)
+{
+	float *plife = pFields[FIELD_LIFE];
+
+	// Decrease lifespan.
+	for (uint32 i = pBegin; i < pEnd; i++)
+		plife[i] -= dt;
+
+	uint32 i = pBegin;
+	while (i < pEnd && plife[i] > 0)
+		i++;
+
+	// Everything before the first dead particle stays where it is.
+	uint32 dst = i;
+
+	for (; i < pEnd; i++)
 	{
-		pHead->prev = p;
-		p->next = pHead;
+		if (plife[i] <= 0)
+			continue;
+
+		if (dst != i)
+			moveParticle(dst, i);
+		dst++;
 	}
-	p->prev = nullptr;
-	pHead = p;
+
+	pEnd = dst;
+	activeParticles = pEnd - pBegin;
 }
 
-void ParticleSystem::insertRandom(Particle *p)
+void ParticleSystem::addGPUParticle(float t)
 {
-	// Nonuniform, but 64-bit is so large nobody will notice. Hopefully.
-	uint64 pos = rng.rand() % ((int64) activeParticles + 1);
+	uint32 slot = gpuNextSlot;
 
-	// Special case where the particle gets inserted before the head.
-	if (pos == activeParticles)
-	{
-		Particle *pA = pHead;
-		if (pA)
-			pA->prev = p;
-		p->prev = nullptr;
-		p->next = pA;
-		pHead = p;
+	// The ring is full when the oldest particle is still alive.
+	if (gpuSlotDeath[slot] > gpuTime)
 		return;
-	}
 
-	// Inserts the particle after the randomly selected particle.
-	Particle *pA = pMem + pos;
-	Particle *pB = pA->next;
-	pA->next = p;
-	if (pB)
-		pB->prev = p;
-	else
-		pTail = p;
-	p->prev = pA;
-	p->next = pB;
+	// Uploads have to be contiguous, so wrapping around starts a new run.
+	if (!gpuPendingStates.empty() && slot != gpuPendingFirst + (uint32) gpuPendingStates.size())
+		flushGPUParticles();
+
+	if (gpuPendingStates.empty())
+		gpuPendingFirst = slot;
+
+	// The field arrays hold a single staging particle in GPU mode.
+	uint32 index = pBegin;
+	initParticle(index, t);
+
+	GPUParticleSimulator::State state;
+	state.position[0] = pFields[FIELD_POSITION_X][index];
+	state.position[1] = pFields[FIELD_POSITION_Y][index];
+	state.velocity[0] = pFields[FIELD_VELOCITY_X][index];
+	state.velocity[1] = pFields[FIELD_VELOCITY_Y][index];
+	state.life = pFields[FIELD_LIFE][index];
+	state.rotation = pFields[FIELD_ROTATION][index];
+
+	GPUParticleSimulator::Spawn spawn;
+	spawn.lifetime = pFields[FIELD_LIFETIME][index];
+	spawn.spinStart = pFields[FIELD_SPIN_START][index];
+	spawn.spinEnd = pFields[FIELD_SPIN_END][index];
+	spawn.linearDamping = pFields[FIELD_LINEAR_DAMPING][index];
+	spawn.origin[0] = pFields[FIELD_ORIGIN_X][index];
+	spawn.origin[1] = pFields[FIELD_ORIGIN_Y][index];
+	spawn.linearAcceleration[0] = pFields[FIELD_LINEAR_ACCELERATION_X][index];
+	spawn.linearAcceleration[1] = pFields[FIELD_LINEAR_ACCELERATION_Y][index];
+	spawn.radialAcceleration = pFields[FIELD_RADIAL_ACCELERATION][index];
+	spawn.tangentialAcceleration = pFields[FIELD_TANGENTIAL_ACCELERATION][index];
+	spawn.sizeOffset = pFields[FIELD_SIZE_OFFSET][index];
+	spawn.sizeIntervalSize = pFields[FIELD_SIZE_INTERVAL_SIZE][index];
+
+	gpuPendingStates.push_back(state);
+	gpuPendingSpawns.push_back(spawn);
+
+	gpuSlotDeath[slot] = gpuTime + state.life;
+	gpuNextSlot = (slot + 1) % maxParticles;
+}
+
+void ParticleSystem::flushGPUParticles()
+{
+	if (gpuSimulator == nullptr || gpuPendingStates.empty())
+		return;
+
+	uint32 count = (uint32) gpuPendingStates.size();
+	gpuSimulator->setParticles(gpuPendingFirst, count, gpuPendingStates.data(), gpuPendingSpawns.data());
+
+	gpuPendingStates.clear();
+	gpuPendingSpawns.clear();
 }
 
-ParticleSystem::Particle *ParticleSystem::removeParticle(Particle *p)
+void ParticleSystem::killGPUParticles()
 {
-	// The linked list is updated in this function and old pointers may be
-	// invalidated. The returned pointer will inform the caller of the new
-	// pointer to the next particle.
-	Particle *pNext = nullptr;
+	gpuPendingStates.clear();
+	gpuPendingSpawns.clear();
 
-	// Removes the particle from the linked list.
-	if (p->prev)
-		p->prev->next = p->next;
-	else
-		pHead = p->next;
+	gpuTime = 0.0;
+	gpuNextSlot = 0;
+	std::fill(gpuSlotDeath.begin(), gpuSlotDeath.end(), 0.0);
+
+	// A zero life marks a slot as dead.
+	std::vector<GPUParticleSimulator::State> states(maxParticles);
+	gpuSimulator->setParticles(0, maxParticles, states.data(), nullptr);
+}
 
-	if (p->next)
+uint32 ParticleSystem::getGPUParticleCount() const
+{
+	uint32 count = 0;
+	for (double death : gpuSlotDeath)
 	{
-		p->next->prev = p->prev;
-		pNext = p->next;
+		if (death > gpuTime)
+			count++;
 	}
-	else
-		pTail = p->prev;
+	return count;
+}
 
-	// The (in memory) last particle can now be moved into the free slot.
-	// It will skip the moving if it happens to be the removed particle.
-	pFree--;
-	if (p != pFree)
+void ParticleSystem::setGPUSimulated(bool enable)
+{
+	if (enable == gpuSimulated)
+		return;
+
+	if (enable)
 	{
-		*p = *pFree;
-		if (pNext == pFree)
-			pNext = p;
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		if (gfx == nullptr || !gfx->getCapabilities().features[Graphics::FEATURE_GPU_PARTICLES])
+			throw love::Exception("GPU-simulated ParticleSystems are not supported on this system.");
 
-		if (p->prev)
-			p->prev->next = p;
-		else
-			pHead = p;
+		if (quads.size() > (size_t) MAX_GPU_QUADS)
+			throw love::Exception("GPU-simulated ParticleSystems can use at most %d Quads.", MAX_GPU_QUADS);
+	}
 
-		if (p->next)
-			p->next->prev = p;
-		else
-			pTail = p;
+	gpuSimulated = enable;
+
+	try
+	{
+		setBufferSize(maxParticles);
 	}
+	catch (love::Exception &)
+	{
+		gpuSimulated = !enable;
+		setBufferSize(maxParticles);
+		throw;
+	}
+}
 
-	activeParticles--;
-	return pNext;
+bool ParticleSystem::isGPUSimulated() const
+{
+	return gpuSimulated;
 }
 
 void ParticleSystem::setTexture(Texture *tex)
@@ -837,6 +1027,9 @@ bool ParticleSystem::hasRelativeRotation() const
 
 uint32 ParticleSystem::getCount() const
 {
+	if (gpuSimulator != nullptr)
+		return getGPUParticleCount();
+
 	return activeParticles;
 }
 
@@ -862,12 +1055,13 @@ void ParticleSystem::reset()
 	if (pMem == nullptr)
 		return;
 
-	pFree = pMem;
-	pHead = nullptr;
-	pTail = nullptr;
+	pBegin = pEnd = pCapacity / 2;
 	activeParticles = 0;
 	life = lifetime;
 	emitCounter = 0;
+
+	if (gpuSimulator != nullptr)
+		killGPUParticles();
 }
 
 void ParticleSystem::emit(uint32 num)
@@ -898,108 +1092,175 @@ bool ParticleSystem::isStopped() const
 
 bool ParticleSystem::isEmpty() const
 {
-	return activeParticles == 0;
+	return getCount() == 0;
 }
 
 bool ParticleSystem::isFull() const
 {
+	if (gpuSimulator != nullptr)
+		return gpuSlotDeath[gpuNextSlot] > gpuTime;
+
 	return activeParticles == maxParticles;
 }
 
-void ParticleSystem::update(float dt)
-{
-	if (pMem == nullptr || dt == 0.0f)
-		return;
-
-	// Traverse all particles and update.
-	Particle *p = pHead;
-
-	while (p)
+void ParticleSystem::updateMotion(uint32 begin, uint32 end, float dt)
+{
+	float *plife = pFields[FIELD_LIFE];
+	float *plifetime = pFields[FIELD_LIFETIME];
+	float *px = pFields[FIELD_POSITION_X];
+	float *py = pFields[FIELD_POSITION_Y];
+	float *pox = pFields[FIELD_ORIGIN_X];
+	float *poy = pFields[FIELD_ORIGIN_Y];
+	float *pvx = pFields[FIELD_VELOCITY_X];
+	float *pvy = pFields[FIELD_VELOCITY_Y];
+	float *pax = pFields[FIELD_LINEAR_ACCELERATION_X];
+	float *pay = pFields[FIELD_LINEAR_ACCELERATION_Y];
+	float *pradial = pFields[FIELD_RADIAL_ACCELERATION];
+	float *ptangential = pFields[FIELD_TANGENTIAL_ACCELERATION];
+	float *pdamping = pFields[FIELD_LINEAR_DAMPING];
+	float *protation = pFields[FIELD_ROTATION];
+	float *pspinstart = pFields[FIELD_SPIN_START];
+	float *pspinend = pFields[FIELD_SPIN_END];
+
+	uint32 p = begin;
+
+#if defined(LOVE_SIMD_SSE)
+	const __m128 vdt = _mm_set1_ps(dt);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	for (; p + 4 <= end; p += 4)
 	{
-		// Decrease lifespan.
-		p->life -= dt;
-
-		if (p->life <= 0)
-			p = removeParticle(p);
-		else
-		{
-			// Temp variables.
-			love::Vector2 radial, tangential;
-			love::Vector2 ppos = p->position;
-
-			// Get vector from particle center to particle.
-			radial = ppos - p->origin;
-			radial.normalize();
-			tangential = radial;
-
-			// Resize radial acceleration.
-			radial *= p->radialAcceleration;
-
-			// Calculate tangential acceleration.
-			{
-				float a = tangential.x;
-				tangential.x = -tangential.y;
-				tangential.y = a;
-			}
-
-			// Resize tangential.
-			tangential *= p->tangentialAcceleration;
-
-			// Update velocity.
-			p->velocity += (radial + tangential + p->linearAcceleration) * dt;
+		__m128 x = _mm_loadu_ps(px + p);
+		__m128 y = _mm_loadu_ps(py + p);
+		__m128 vx = _mm_loadu_ps(pvx + p);
+		__m128 vy = _mm_loadu_ps(pvy + p);
+
+		// Get the normalized vector from particle center to particle.
+		__m128 rx = _mm_sub_ps(x, _mm_loadu_ps(pox + p));
+		__m128 ry = _mm_sub_ps(y, _mm_loadu_ps(poy + p));
+		__m128 len2 = _mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry));
+		__m128 invlen = _mm_and_ps(_mm_cmpgt_ps(len2, zero), _mm_div_ps(one, _mm_sqrt_ps(len2)));
+		rx = _mm_mul_ps(rx, invlen);
+		ry = _mm_mul_ps(ry, invlen);
+
+		// Radial acceleration is along (rx, ry), tangential along (-ry, rx).
+		__m128 radial = _mm_loadu_ps(pradial + p);
+		__m128 tangential = _mm_loadu_ps(ptangential + p);
+		__m128 ax = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(rx, radial), _mm_mul_ps(ry, tangential)), _mm_loadu_ps(pax + p));
+		__m128 ay = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ry, radial), _mm_mul_ps(rx, tangential)), _mm_loadu_ps(pay + p));
+
+		// Update velocity and apply damping.
+		__m128 damping = _mm_div_ps(one, _mm_add_ps(one, _mm_mul_ps(_mm_loadu_ps(pdamping + p), vdt)));
+		vx = _mm_mul_ps(_mm_add_ps(vx, _mm_mul_ps(ax, vdt)), damping);
+		vy = _mm_mul_ps(_mm_add_ps(vy, _mm_mul_ps(ay, vdt)), damping);
+
+		_mm_storeu_ps(pvx + p, vx);
+		_mm_storeu_ps(pvy + p, vy);
+		_mm_storeu_ps(px + p, _mm_add_ps(x, _mm_mul_ps(vx, vdt)));
+		_mm_storeu_ps(py + p, _mm_add_ps(y, _mm_mul_ps(vy, vdt)));
+
+		// Rotate.
+		__m128 t = _mm_sub_ps(one, _mm_div_ps(_mm_loadu_ps(plife + p), _mm_loadu_ps(plifetime + p)));
+		__m128 spin = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(pspinstart + p), _mm_sub_ps(one, t)), _mm_mul_ps(_mm_loadu_ps(pspinend + p), t));
+		_mm_storeu_ps(protation + p, _mm_add_ps(_mm_loadu_ps(protation + p), _mm_mul_ps(spin, vdt)));
+	}
+#elif defined(LOVE_SIMD_NEON) && defined(__aarch64__)
+	// 32-bit NEON has no vector division or square root, so it uses the
+	// scalar path below.
+	const float32x4_t vdt = vdupq_n_f32(dt);
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+	const float32x4_t one = vdupq_n_f32(1.0f);
+
+	for (; p + 4 <= end; p += 4)
+	{
+		float32x4_t x = vld1q_f32(px + p);
+		float32x4_t y = vld1q_f32(py + p);
+		float32x4_t vx = vld1q_f32(pvx + p);
+		float32x4_t vy = vld1q_f32(pvy + p);
+
+		// Get the normalized vector from particle center to particle.
+		float32x4_t rx = vsubq_f32(x, vld1q_f32(pox + p));
+		float32x4_t ry = vsubq_f32(y, vld1q_f32(poy + p));
+		float32x4_t len2 = vaddq_f32(vmulq_f32(rx, rx), vmulq_f32(ry, ry));
+		uint32x4_t nonzero = vcgtq_f32(len2, zero);
+		float32x4_t invlen = vreinterpretq_f32_u32(vandq_u32(nonzero, vreinterpretq_u32_f32(vdivq_f32(one, vsqrtq_f32(len2)))));
+		rx = vmulq_f32(rx, invlen);
+		ry = vmulq_f32(ry, invlen);
+
+		// Radial acceleration is along (rx, ry), tangential along (-ry, rx).
+		float32x4_t radial = vld1q_f32(pradial + p);
+		float32x4_t tangential = vld1q_f32(ptangential + p);
+		float32x4_t ax = vaddq_f32(vsubq_f32(vmulq_f32(rx, radial), vmulq_f32(ry, tangential)), vld1q_f32(pax + p));
+		float32x4_t ay = vaddq_f32(vaddq_f32(vmulq_f32(ry, radial), vmulq_f32(rx, tangential)), vld1q_f32(pay + p));
+
+		// Update velocity and apply damping.
+		float32x4_t damping = vdivq_f32(one, vaddq_f32(one, vmulq_f32(vld1q_f32(pdamping + p), vdt)));
+		vx = vmulq_f32(vaddq_f32(vx, vmulq_f32(ax, vdt)), damping);
+		vy = vmulq_f32(vaddq_f32(vy, vmulq_f32(ay, vdt)), damping);
+
+		vst1q_f32(pvx + p, vx);
+		vst1q_f32(pvy + p, vy);
+		vst1q_f32(px + p, vaddq_f32(x, vmulq_f32(vx, vdt)));
+		vst1q_f32(py + p, vaddq_f32(y, vmulq_f32(vy, vdt)));
+
+		// Rotate.
+		float32x4_t t = vsubq_f32(one, vdivq_f32(vld1q_f32(plife + p), vld1q_f32(plifetime + p)));
+		float32x4_t spin = vaddq_f32(vmulq_f32(vld1q_f32(pspinstart + p), vsubq_f32(one, t)), vmulq_f32(vld1q_f32(pspinend + p), t));
+		vst1q_f32(protation + p, vaddq_f32(vld1q_f32(protation + p), vmulq_f32(spin, vdt)));
+	}
+#endif
 
-			// Apply damping.
-			p->velocity *= 1.0f / (1.0f + p->linearDamping * dt);
+	// Remaining particles, or all of them without SIMD.
+	for (; p < end; p++)
+	{
+		// Get vector from particle center to particle.
+		love::Vector2 radial(px[p] - pox[p], py[p] - poy[p]);
+		radial.normalize();
 
-			// Modify position.
-			ppos += p->velocity * dt;
+		love::Vector2 tangential(-radial.y, radial.x);
 
-			p->position = ppos;
+		radial *= pradial[p];
+		tangential *= ptangential[p];
 
-			const float t = 1.0f - p->life / p->lifetime;
+		// Update velocity.
+		love::Vector2 velocity(pvx[p], pvy[p]);
+		velocity += (radial + tangential + love::Vector2(pax[p], pay[p])) * dt;
 
-			// Rotate.
-			p->rotation += (p->spinStart * (1.0f - t) + p->spinEnd * t) * dt;
+		// Apply damping.
+		velocity *= 1.0f / (1.0f + pdamping[p] * dt);
 
-			p->angle = p->rotation;
+		pvx[p] = velocity.x;
+		pvy[p] = velocity.y;
 
-			if (relativeRotation)
-				p->angle += atan2f(p->velocity.y, p->velocity.x);
+		// Modify position.
+		px[p] += velocity.x * dt;
+		py[p] += velocity.y * dt;
 
-			// Change size according to given intervals:
-			// i = 0       1       2      3          n-1
-			//     |-------|-------|------|--- ... ---|
-			// t = 0    1/(n-1)        3/(n-1)        1
-			//
-			// `s' is the interpolation variable scaled to the current
-			// interval width, e.g. if n = 5 and t = 0.3, then the current
-			// indices are 1,2 and s = 0.3 - 0.25 = 0.05
-			float s = p->sizeOffset + t * p->sizeIntervalSize; // size variation
-			s *= (float)(sizes.size() - 1); // 0 <= s < sizes.size()
-			size_t i = (size_t)s;
-			size_t k = (i == sizes.size() - 1) ? i : i + 1; // boundary check (prevents failing on t = 1.0f)
-			s -= (float)i; // transpose s to be in interval [0:1]: i <= s < i + 1 ~> 0 <= s < 1
-			p->size = sizes[i] * (1.0f - s) + sizes[k] * s;
+		const float t = 1.0f - plife[p] / plifetime[p];
 
-			// Update color according to given intervals (as above)
-			s = t * (float)(colors.size() - 1);
-			i = (size_t)s;
-			k = (i == colors.size() - 1) ? i : i + 1;
-			s -= (float)i;                            // 0 <= s <= 1
-			p->color = colors[i] * (1.0f - s) + colors[k] * s;
+		// Rotate.
+		protation[p] += (pspinstart[p] * (1.0f - t) + pspinend[p] * t) * dt;
+	}
+}
 
-			// Update the quad index.
-			k = quads.size();
-			if (k > 0)
-			{
-				s = t * (float) k; // [0:numquads-1] (clamped below)
-				i = (s > 0.0f) ? (size_t) s : 0;
-				p->quadIndex = (int) ((i < k) ? i : k - 1);
-			}
+void ParticleSystem::update(float dt)
+{
+	if (pMem == nullptr || dt == 0.0f)
+		return;
 
-			// Next particle.
-			p = p->next;
-		}
+	if (gpuSimulator != nullptr)
+	{
+		// Particles emitted since the last update need to be simulated too.
+		flushGPUParticles();
+		gpuSimulator->simulate(dt);
+		gpuTime += dt;
+	}
+	else
+	{
+		removeDeadParticles(dt);
+		updateMotion(pBegin, pEnd, dt);
+		updateAppearance();
 	}
 
 	// Make some more particles.
@@ -1019,11 +1280,102 @@ void ParticleSystem::update(float dt)
 			stop();
 	}
 
+	flushGPUParticles();
+
 	prevPosition = position;
 }
 
+void ParticleSystem::updateBatch(const std::vector<ParticleSystem *> &systems, float dt)
+{
+	// A system listed twice would otherwise be updated by two threads at once.
+	std::vector<ParticleSystem *> unique = systems;
+	std::sort(unique.begin(), unique.end());
+	unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+
+	std::vector<ParticleSystem *> cpusystems;
+	cpusystems.reserve(unique.size());
+
+	for (ParticleSystem *p : unique)
+	{
+		// GPU simulation issues graphics commands, which only the main
+		// thread may do.
+		if (p->gpuSimulator != nullptr)
+			p->update(dt);
+		else
+			cpusystems.push_back(p);
+	}
+
+	auto &pool = love::thread::WorkerPool::getShared();
+	pool.parallelFor((int) cpusystems.size(), [&](int i) { cpusystems[i]->update(dt); });
+}
+
+void ParticleSystem::updateAppearance()
+{
+	float *plife = pFields[FIELD_LIFE];
+	float *plifetime = pFields[FIELD_LIFETIME];
+	float *pvx = pFields[FIELD_VELOCITY_X];
+	float *pvy = pFields[FIELD_VELOCITY_Y];
+	float *protation = pFields[FIELD_ROTATION];
+	float *pangle = pFields[FIELD_ANGLE];
+	float *psize = pFields[FIELD_SIZE];
+	float *psizeoffset = pFields[FIELD_SIZE_OFFSET];
+	float *psizeinterval = pFields[FIELD_SIZE_INTERVAL_SIZE];
+	float *pquad = pFields[FIELD_QUAD_INDEX];
+
+	for (uint32 p = pBegin; p < pEnd; p++)
+	{
+		const float t = 1.0f - plife[p] / plifetime[p];
+
+		pangle[p] = protation[p];
+
+		if (relativeRotation)
+			pangle[p] += atan2f(pvy[p], pvx[p]);
+
+		// Change size according to given intervals:
+		// i = 0       1       2      3          n-1
+		//     |-------|-------|------|--- ... ---|
+		// t = 0    1/(n-1)        3/(n-1)        1
+		//
+		// `s' is the interpolation variable scaled to the current
+		// interval width, e.g. if n = 5 and t = 0.3, then the current
+		// indices are 1,2 and s = 0.3 - 0.25 = 0.05
+		float s = psizeoffset[p] + t * psizeinterval[p]; // size variation
+		s *= (float)(sizes.size() - 1); // 0 <= s < sizes.size()
+		size_t i = (size_t)s;
+		size_t k = (i == sizes.size() - 1) ? i : i + 1; // boundary check (prevents failing on t = 1.0f)
+		s -= (float)i; // transpose s to be in interval [0:1]: i <= s < i + 1 ~> 0 <= s < 1
+		psize[p] = sizes[i] * (1.0f - s) + sizes[k] * s;
+
+		// Update color according to given intervals (as above)
+		s = t * (float)(colors.size() - 1);
+		i = (size_t)s;
+		k = (i == colors.size() - 1) ? i : i + 1;
+		s -= (float)i;                            // 0 <= s <= 1
+		Colorf c = colors[i] * (1.0f - s) + colors[k] * s;
+		pFields[FIELD_COLOR_R][p] = c.r;
+		pFields[FIELD_COLOR_G][p] = c.g;
+		pFields[FIELD_COLOR_B][p] = c.b;
+		pFields[FIELD_COLOR_A][p] = c.a;
+
+		// Update the quad index.
+		k = quads.size();
+		if (k > 0)
+		{
+			s = t * (float) k; // [0:numquads-1] (clamped below)
+			i = (s > 0.0f) ? (size_t) s : 0;
+			pquad[p] = (float) ((i < k) ? i : k - 1);
+		}
+	}
+}
+
 void ParticleSystem::draw(Graphics *gfx, const Matrix4 &m)
 {
+	if (gpuSimulator != nullptr)
+	{
+		drawGPU(gfx, m);
+		return;
+	}
+
 	uint32 pCount = getCount();
 
 	if (pCount == 0 || texture.get() == nullptr || pMem == nullptr || buffer == nullptr)
@@ -1040,40 +1392,81 @@ void ParticleSystem::draw(Graphics *gfx, const Matrix4 &m)
 	const Vector2 *positions = texture->getQuad()->getVertexPositions();
 	const Vector2 *texcoords = texture->getQuad()->getVertexTexCoords();
 
-	Vertex *pVerts = (Vertex *) buffer->map();
-	Particle *p = pHead;
-
 	bool useQuads = !quads.empty();
+	bool compact = true;
+
+	if (useQuads)
+	{
+		for (const StrongRef<Quad> &q : quads)
+		{
+			const Vector2 *st = q->getVertexTexCoords();
+			for (int v = 0; v < 4; v++)
+				compact = compact && vertex::isUnormTexCoord(st[v].x, st[v].y);
+		}
+	}
+	else
+	{
+		for (int v = 0; v < 4; v++)
+			compact = compact && vertex::isUnormTexCoord(texcoords[v].x, texcoords[v].y);
+	}
+
+	// The buffer is sized for the float format, which is the larger one.
+	uint8 *pVerts = (uint8 *) buffer->map();
+	size_t particlestride = compact ? sizeof(vertex::XYf_STus_RGBAub) * 4 : sizeof(Vertex) * 4;
+
+	const float *px = pFields[FIELD_POSITION_X];
+	const float *py = pFields[FIELD_POSITION_Y];
+	const float *pangle = pFields[FIELD_ANGLE];
+	const float *psize = pFields[FIELD_SIZE];
+	const float *pquad = pFields[FIELD_QUAD_INDEX];
 
 	Matrix3 t;
 
 	// set the vertex data for each particle (transformation, texcoords, color)
-	while (p)
+	for (uint32 p = pBegin; p < pEnd; p++)
 	{
 		if (useQuads)
 		{
-			positions = quads[p->quadIndex]->getVertexPositions();
-			texcoords = quads[p->quadIndex]->getVertexTexCoords();
+			int quadindex = (int) pquad[p];
+			positions = quads[quadindex]->getVertexPositions();
+			texcoords = quads[quadindex]->getVertexTexCoords();
 		}
 
 		// particle vertices are image vertices transformed by particle info
-		t.setTransformation(p->position.x, p->position.y, p->angle, p->size, p->size, offset.x, offset.y, 0.0f, 0.0f);
-		t.transformXY(pVerts, positions, 4);
+		t.setTransformation(px[p], py[p], pangle[p], psize[p], psize[p], offset.x, offset.y, 0.0f, 0.0f);
 
 		// Particle colors are stored as floats (0-1) but vertex colors are
 		// unsigned bytes (0-255).
-		Color c = toColor(p->color);
+		Colorf cf(pFields[FIELD_COLOR_R][p], pFields[FIELD_COLOR_G][p], pFields[FIELD_COLOR_B][p], pFields[FIELD_COLOR_A][p]);
+		Color c = toColor(cf);
 
 		// set the texture coordinate and color data for particle vertices
-		for (int v = 0; v < 4; v++)
+		if (compact)
 		{
-			pVerts[v].s = texcoords[v].x;
-			pVerts[v].t = texcoords[v].y;
-			pVerts[v].color = c;
+			auto verts = (vertex::XYf_STus_RGBAub *) pVerts;
+			t.transformXY(verts, positions, 4);
+
+			for (int v = 0; v < 4; v++)
+			{
+				verts[v].s = vertex::packUnormTexCoord(texcoords[v].x);
+				verts[v].t = vertex::packUnormTexCoord(texcoords[v].y);
+				verts[v].color = c;
+			}
+		}
+		else
+		{
+			auto verts = (Vertex *) pVerts;
+			t.transformXY(verts, positions, 4);
+
+			for (int v = 0; v < 4; v++)
+			{
+				verts[v].s = texcoords[v].x;
+				verts[v].t = texcoords[v].y;
+				verts[v].color = c;
+			}
 		}
 
-		pVerts += 4;
-		p = p->next;
+		pVerts += particlestride;
 	}
 
 	Graphics::TempTransform transform(gfx, m);
@@ -1083,7 +1476,128 @@ void ParticleSystem::draw(Graphics *gfx, const Matrix4 &m)
 	vertex::Buffers vertexbuffers;
 	vertexbuffers.set(0, buffer, 0);
 
-	gfx->drawQuads(0, pCount, vertexAttributes, vertexbuffers, texture);
+	gfx->drawQuads(0, pCount, compact ? compactVertexAttributes : vertexAttributes, vertexbuffers, texture);
+}
+
+void ParticleSystem::drawGPU(Graphics *gfx, const Matrix4 &m)
+{
+	using namespace vertex;
+
+	if (texture.get() == nullptr || isEmpty())
+		return;
+
+	if (quads.size() > (size_t) MAX_GPU_QUADS)
+		throw love::Exception("GPU-simulated ParticleSystems can use at most %d Quads.", MAX_GPU_QUADS);
+
+	flushGPUParticles();
+	gfx->flushStreamDraws();
+
+	if (Shader::isDefaultActive())
+		Shader::attachDefault(Shader::STANDARD_GPU_PARTICLE);
+
+	Shader *shader = Shader::current;
+
+	int posvelindex = -1;
+	int liferotindex = -1;
+	int lifetimeindex = -1;
+	int sizevarindex = -1;
+
+	if (shader)
+	{
+		shader->checkMainTexture(texture);
+
+		posvelindex = shader->getVertexAttributeIndex("ParticlePositionVelocity");
+		liferotindex = shader->getVertexAttributeIndex("ParticleLifeRotation");
+		lifetimeindex = shader->getVertexAttributeIndex("ParticleLifetime");
+		sizevarindex = shader->getVertexAttributeIndex("ParticleSizeVariation");
+	}
+
+	if (posvelindex < 0 || liferotindex < 0)
+		throw love::Exception("GPU-simulated ParticleSystems must be drawn with a vertex shader which uses the ParticlePositionVelocity and ParticleLifeRotation attributes.");
+
+	// Per-particle appearance is computed in the vertex shader from these.
+	float sizedata[8] = {};
+	for (size_t i = 0; i < sizes.size() && i < 8; i++)
+		sizedata[i] = sizes[i];
+
+	float colordata[8 * 4] = {};
+	for (size_t i = 0; i < colors.size() && i < 8; i++)
+	{
+		colordata[i * 4 + 0] = colors[i].r;
+		colordata[i * 4 + 1] = colors[i].g;
+		colordata[i * 4 + 2] = colors[i].b;
+		colordata[i * 4 + 3] = colors[i].a;
+	}
+
+	float quadtexcoords[MAX_GPU_QUADS * 4];
+	float quadsizes[MAX_GPU_QUADS * 2];
+
+	int quadcount = quads.empty() ? 1 : (int) quads.size();
+
+	for (int i = 0; i < quadcount; i++)
+	{
+		Quad *quad = quads.empty() ? texture->getQuad() : quads[i].get();
+
+		const Vector2 *positions = quad->getVertexPositions();
+		const Vector2 *texcoords = quad->getVertexTexCoords();
+
+		quadtexcoords[i * 4 + 0] = texcoords[0].x;
+		quadtexcoords[i * 4 + 1] = texcoords[0].y;
+		quadtexcoords[i * 4 + 2] = texcoords[3].x;
+		quadtexcoords[i * 4 + 3] = texcoords[3].y;
+
+		quadsizes[i * 2 + 0] = positions[3].x;
+		quadsizes[i * 2 + 1] = positions[3].y;
+	}
+
+	float params[4] = {
+		(float) std::min(sizes.size(), (size_t) 8),
+		(float) std::min(colors.size(), (size_t) 8),
+		(float) quadcount,
+		relativeRotation ? 1.0f : 0.0f,
+	};
+
+	float offsetdata[2] = {offset.x, offset.y};
+
+	sendFloats(shader, "love_ParticleSizes", sizedata, 8);
+	sendFloats(shader, "love_ParticleColors", colordata, 8);
+	sendFloats(shader, "love_ParticleQuadTexCoords", quadtexcoords, quadcount);
+	sendFloats(shader, "love_ParticleQuadSizes", quadsizes, quadcount);
+	sendFloats(shader, "love_ParticleParams", params, 1);
+	sendFloats(shader, "love_ParticleOffset", offsetdata, 1);
+
+	typedef GPUParticleSimulator::State State;
+	typedef GPUParticleSimulator::Spawn Spawn;
+
+	Attributes attributes;
+	Buffers buffers;
+
+	buffers.set(0, gpuSimulator->getStateBuffer(), 0);
+	buffers.set(1, gpuSimulator->getSpawnBuffer(), 0);
+	buffers.set(2, gpuCornerBuffer, 0);
+
+	attributes.set(ATTRIB_POS, DATA_FLOAT, 2, 0, sizeof(float) * 2, 2);
+
+	attributes.set(posvelindex, DATA_FLOAT, 4, offsetof(State, position), sizeof(State), 0, STEP_PER_INSTANCE);
+	attributes.set(liferotindex, DATA_FLOAT, 2, offsetof(State, life), sizeof(State), 0, STEP_PER_INSTANCE);
+
+	if (lifetimeindex >= 0)
+		attributes.set(lifetimeindex, DATA_FLOAT, 1, offsetof(Spawn, lifetime), sizeof(Spawn), 1, STEP_PER_INSTANCE);
+
+	if (sizevarindex >= 0)
+		attributes.set(sizevarindex, DATA_FLOAT, 2, offsetof(Spawn, sizeOffset), sizeof(Spawn), 1, STEP_PER_INSTANCE);
+
+	Graphics::TempTransform transform(gfx, m);
+
+	// Every slot is drawn; dead ones are culled by the vertex shader.
+	Graphics::DrawCommand cmd(&attributes, &buffers);
+	cmd.primitiveType = PRIMITIVE_TRIANGLE_STRIP;
+	cmd.vertexStart = 0;
+	cmd.vertexCount = 4;
+	cmd.instanceCount = (int) maxParticles;
+	cmd.texture = texture;
+
+	gfx->draw(cmd);
 }
 
 bool ParticleSystem::getConstant(const char *in, AreaSpreadDistribution &out)
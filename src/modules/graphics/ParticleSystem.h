@@ -30,6 +30,8 @@
 #include "Quad.h"
 #include "Texture.h"
 #include "Buffer.h"
+#include "GPUParticleSimulator.h"
+#include "math/RandomGenerator.h"
 
 // STL
 #include <vector>
@@ -83,6 +85,12 @@ public:
 	 **/
 	static const uint32 MAX_PARTICLES = LOVE_INT32_MAX / 4;
 
+	/**
+	 * Maximum number of Quads a GPU-simulated ParticleSystem can use; they're
+	 * sent to the vertex shader as uniform arrays.
+	 **/
+	static const int MAX_GPU_QUADS = 32;
+
 	/**
 	 * Creates a particle system with the specified buffer size and texture.
 	 **/
@@ -451,6 +459,15 @@ public:
 	void setRelativeRotation(bool enable);
 	bool hasRelativeRotation() const;
 
+	/**
+	 * Sets whether particle motion is simulated on the GPU. Emission still
+	 * happens on the CPU, but particles are only uploaded once, when spawned.
+	 * GPU-simulated particles are always drawn in emission order, so the
+	 * insert mode is ignored.
+	 **/
+	void setGPUSimulated(bool enable);
+	bool isGPUSimulated() const;
+
 	/**
 	 * Returns the amount of particles that are currently active in the system.
 	 **/
@@ -510,6 +527,13 @@ public:
 	 **/
 	void update(float dt);
 
+	/**
+	 * Updates many particle systems, spreading them across worker threads.
+	 * Returns once every system has been updated. Systems listed more than
+	 * once are only updated once.
+	 **/
+	static void updateBatch(const std::vector<ParticleSystem *> &systems, float dt);
+
 	// Implements Drawable.
 	void draw(Graphics *gfx, const Matrix4 &m) override;
 
@@ -523,39 +547,38 @@ public:
 
 private:
 
-	// Represents a single particle.
-	struct Particle
+	// Particle data is stored as parallel arrays (one per field), so update
+	// can process several particles at a time. The arrays are kept in draw
+	// order within [pBegin, pEnd) of a buffer twice the maximum particle
+	// count, which lets particles be inserted at either end cheaply.
+	enum ParticleField
 	{
-		Particle *prev;
-		Particle *next;
-
-		float lifetime;
-		float life;
-
-		love::Vector2 position;
-
-		// Particles gravitate towards this point.
-		love::Vector2 origin;
-
-		love::Vector2 velocity;
-		love::Vector2 linearAcceleration;
-		float radialAcceleration;
-		float tangentialAcceleration;
-
-		float linearDamping;
-
-		float size;
-		float sizeOffset;
-		float sizeIntervalSize;
-
-		float rotation; // Amount of rotation applied to the final angle.
-		float angle;
-		float spinStart;
-		float spinEnd;
-
-		Colorf color;
-
-		int quadIndex;
+		FIELD_LIFETIME,
+		FIELD_LIFE,
+		FIELD_POSITION_X,
+		FIELD_POSITION_Y,
+		FIELD_ORIGIN_X, // Particles gravitate towards this point.
+		FIELD_ORIGIN_Y,
+		FIELD_VELOCITY_X,
+		FIELD_VELOCITY_Y,
+		FIELD_LINEAR_ACCELERATION_X,
+		FIELD_LINEAR_ACCELERATION_Y,
+		FIELD_RADIAL_ACCELERATION,
+		FIELD_TANGENTIAL_ACCELERATION,
+		FIELD_LINEAR_DAMPING,
+		FIELD_SIZE,
+		FIELD_SIZE_OFFSET,
+		FIELD_SIZE_INTERVAL_SIZE,
+		FIELD_ROTATION, // Amount of rotation applied to the final angle.
+		FIELD_ANGLE,
+		FIELD_SPIN_START,
+		FIELD_SPIN_END,
+		FIELD_COLOR_R,
+		FIELD_COLOR_G,
+		FIELD_COLOR_B,
+		FIELD_COLOR_A,
+		FIELD_QUAD_INDEX,
+		FIELD_MAX_ENUM
 	};
 
 	void resetOffset();
@@ -564,25 +587,45 @@ private:
 	void deleteBuffers();
 
 	void addParticle(float t);
-	Particle *removeParticle(Particle *p);
 
 	// Called by addParticle.
-	void initParticle(Particle *p, float t);
-	void insertTop(Particle *p);
-	void insertBottom(Particle *p);
-	void insertRandom(Particle *p);
+	void initParticle(uint32 index, float t);
+
+	// Gets the index of a new particle according to the insert mode.
+	uint32 insertParticle();
+
+	// Moves the particles back to the middle of the buffer.
+	void recenterParticles();
+	void moveParticle(uint32 dst, uint32 src);
+
+	// Decreases the life of each particle and removes dead ones, keeping the
+	// rest in order.
+	void removeDeadParticles(float dt);
 
-	// Pointer to the beginning of the allocated memory.
-	Particle *pMem;
+	// Updates velocity, position and rotation. Uses SIMD where available.
+	void updateMotion(uint32 begin, uint32 end, float dt);
 
-	// Pointer to a free particle.
-	Particle *pFree;
+	// Updates angle, size, color and quad index from each particle's age.
+	void updateAppearance();
 
-	// Pointer to the start of the linked list.
-	Particle *pHead;
+	// GPU simulation: new particles are staged and uploaded in contiguous
+	// runs of the slot ring.
+	void addGPUParticle(float t);
+	void flushGPUParticles();
+	void killGPUParticles();
+	uint32 getGPUParticleCount() const;
+	void drawGPU(Graphics *gfx, const Matrix4 &m);
 
-	// Pointer to the end of the linked list.
-	Particle *pTail;
+	// The allocated memory, and the start of each field's array within it.
+	float *pMem;
+	float *pFields[FIELD_MAX_ENUM];
+
+	// Size of each field's array.
+	uint32 pCapacity;
+
+	// The range of active particles in each array.
+	uint32 pBegin;
+	uint32 pEnd;
 
 	// The texture to be drawn.
 	StrongRef<Texture> texture;
@@ -673,9 +716,32 @@ private:
 
 	bool relativeRotation;
 
+	// Compact 16-bit texture coordinates are used when all of them are in
+	// [0, 1], which they are unless a Quad repeats the texture.
 	const vertex::Attributes vertexAttributes;
+	const vertex::Attributes compactVertexAttributes;
 	Buffer *buffer;
 
+	// Each system has its own generator so systems can be updated in
+	// parallel.
+	love::math::RandomGenerator rng;
+
+	bool gpuSimulated;
+	GPUParticleSimulator *gpuSimulator;
+	Buffer *gpuCornerBuffer;
+
+	// Time until which each GPU particle slot is alive, relative to gpuTime.
+	std::vector<double> gpuSlotDeath;
+	double gpuTime;
+
+	// The ring slot the next particle goes in; it replaces the oldest one.
+	uint32 gpuNextSlot;
+
+	// Particles spawned since the last upload, starting at gpuPendingFirst.
+	uint32 gpuPendingFirst;
+	std::vector<GPUParticleSimulator::State> gpuPendingStates;
+	std::vector<GPUParticleSimulator::Spawn> gpuPendingSpawns;
+
 	static StringMap<AreaSpreadDistribution, DISTRIBUTION_MAX_ENUM>::Entry distributionsEntries[];
 	static StringMap<AreaSpreadDistribution, DISTRIBUTION_MAX_ENUM> distributions;
 
@@ -87,7 +87,8 @@ void Polyline::render(const Vector2 *coords, size_t count, size_t size_hint, flo
 	}
 
 	// Use a single linear array for both the regular and overdraw vertices.
-	vertices = new Vector2[vertex_count + extra_vertices + overdraw_vertex_count];
+	vertexStorage.resize(vertex_count + extra_vertices + overdraw_vertex_count);
+	vertices = vertexStorage.data();
 
 	for (size_t i = 0; i < vertex_count; ++i)
 		vertices[i] = anchors[i] + normals[i];
@@ -361,8 +362,6 @@ void NoneJoinPolyline::render_overdraw(const std::vector<Vector2> &/*normals*/,
 
 Polyline::~Polyline()
 {
-	if (vertices)
-		delete[] vertices;
 }
 
 void Polyline::draw(love::graphics::Graphics *gfx)
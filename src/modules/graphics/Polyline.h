@@ -23,6 +23,7 @@
 // LOVE
 #include "common/config.h"
 #include "common/Vector.h"
+#include "common/FrameArena.h"
 #include "graphics/vertex.h"
 
 // C++
@@ -90,6 +91,10 @@ protected:
 	                        Vector2 &s, float &len_s, Vector2 &ns,
 	                        const Vector2 &q, const Vector2 &r, float hw) = 0;
 
+	// Polylines only live for a single draw, so their vertices come from the
+	// frame arena.
+	ScratchVector<Vector2> vertexStorage;
+
 	Vector2 *vertices;
 	Vector2 *overdraw;
 	size_t vertex_count;
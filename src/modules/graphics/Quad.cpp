@@ -35,6 +35,9 @@ Quad::Quad(const Quad::Viewport &v, double sw, double sh)
 	: sw(sw)
 	, sh(sh)
 {
+	// Quads are shared by Lua, SpriteBatches and ParticleSystems on the main
+	// thread, and never retained by worker threads.
+	confineToThread();
 	arrayLayer = 0;
 	refresh(v, sw, sh);
 }
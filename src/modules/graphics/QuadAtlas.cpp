@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "QuadAtlas.h"
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type QuadAtlas::type("QuadAtlas", &Object::type);
+
+QuadAtlas::QuadAtlas(double sw, double sh)
+	: sw(sw)
+	, sh(sh)
+{
+	// Used by the same main thread code as Quads.
+	confineToThread();
+}
+
+QuadAtlas::~QuadAtlas()
+{
+}
+
+int QuadAtlas::add(const Quad::Viewport &v, int layer)
+{
+	int index = (int) viewports.size();
+
+	viewports.push_back(v);
+	layers.push_back(layer);
+	vertexPositions.resize(vertexPositions.size() + 4);
+	vertexTexCoords.resize(vertexTexCoords.size() + 4);
+
+	refresh(index);
+	return index;
+}
+
+int QuadAtlas::addGrid(double x, double y, double w, double h, int columns, int rows, double spacingx, double spacingy)
+{
+	if (columns <= 0 || rows <= 0)
+		throw love::Exception("Invalid grid size: %d x %d", columns, rows);
+
+	int first = (int) viewports.size();
+	size_t count = viewports.size() + (size_t) columns * rows;
+
+	viewports.reserve(count);
+	layers.reserve(count);
+	vertexPositions.reserve(count * 4);
+	vertexTexCoords.reserve(count * 4);
+
+	for (int row = 0; row < rows; row++)
+	{
+		for (int column = 0; column < columns; column++)
+		{
+			Quad::Viewport v = {x + column * (w + spacingx), y + row * (h + spacingy), w, h};
+			add(v, 0);
+		}
+	}
+
+	return first;
+}
+
+void QuadAtlas::set(int index, const Quad::Viewport &v, int layer)
+{
+	checkIndex(index);
+
+	viewports[index] = v;
+	layers[index] = layer;
+
+	refresh(index);
+}
+
+Quad::Viewport QuadAtlas::getViewport(int index) const
+{
+	checkIndex(index);
+	return viewports[index];
+}
+
+int QuadAtlas::getLayer(int index) const
+{
+	checkIndex(index);
+	return layers[index];
+}
+
+void QuadAtlas::clear()
+{
+	viewports.clear();
+	layers.clear();
+	vertexPositions.clear();
+	vertexTexCoords.clear();
+}
+
+double QuadAtlas::getTextureWidth() const
+{
+	return sw;
+}
+
+double QuadAtlas::getTextureHeight() const
+{
+	return sh;
+}
+
+void QuadAtlas::refresh(int index)
+{
+	const Quad::Viewport &v = viewports[index];
+	Vector2 *positions = &vertexPositions[index * 4];
+	Vector2 *texcoords = &vertexTexCoords[index * 4];
+
+	positions[0] = Vector2(0.0f, 0.0f);
+	positions[1] = Vector2(0.0f, (float) v.h);
+	positions[2] = Vector2((float) v.w, 0.0f);
+	positions[3] = Vector2((float) v.w, (float) v.h);
+
+	texcoords[0] = Vector2((float) (v.x / sw), (float) (v.y / sh));
+	texcoords[1] = Vector2((float) (v.x / sw), (float) ((v.y + v.h) / sh));
+	texcoords[2] = Vector2((float) ((v.x + v.w) / sw), (float) (v.y / sh));
+	texcoords[3] = Vector2((float) ((v.x + v.w) / sw), (float) ((v.y + v.h) / sh));
+}
+
+} // graphics
+} // love
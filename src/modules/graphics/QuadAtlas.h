@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/Exception.h"
+#include "common/Vector.h"
+#include "Quad.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * Many Quad viewports of one texture, stored contiguously and addressed by
+ * index. A sprite sheet needs a single object rather than one Quad per frame.
+ **/
+class QuadAtlas : public Object
+{
+public:
+
+	static love::Type type;
+
+	QuadAtlas(double sw, double sh);
+	virtual ~QuadAtlas();
+
+	// Returns the index of the new frame.
+	int add(const Quad::Viewport &v, int layer = 0);
+
+	/**
+	 * Adds columns * rows frames of the given size, row by row, starting at
+	 * x, y. Returns the index of the first one.
+	 **/
+	int addGrid(double x, double y, double w, double h, int columns, int rows, double spacingx = 0.0, double spacingy = 0.0);
+
+	void set(int index, const Quad::Viewport &v, int layer);
+
+	Quad::Viewport getViewport(int index) const;
+	int getLayer(int index) const;
+
+	int getCount() const { return (int) viewports.size(); }
+
+	void clear();
+
+	double getTextureWidth() const;
+	double getTextureHeight() const;
+
+	const Vector2 *getVertexPositions(int index) const { return &vertexPositions[index * 4]; }
+	const Vector2 *getVertexTexCoords(int index) const { return &vertexTexCoords[index * 4]; }
+
+	void checkIndex(int index) const
+	{
+		if (index < 0 || index >= (int) viewports.size())
+			throw love::Exception("Invalid frame index: %d (QuadAtlas has %d frames)", index + 1, (int) viewports.size());
+	}
+
+private:
+
+	void refresh(int index);
+
+	std::vector<Quad::Viewport> viewports;
+	std::vector<int> layers;
+
+	// Four vertices per frame, in the same order as Quad's.
+	std::vector<Vector2> vertexPositions;
+	std::vector<Vector2> vertexTexCoords;
+
+	double sw;
+	double sh;
+
+}; // QuadAtlas
+
+} // graphics
+} // love
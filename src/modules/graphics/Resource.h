@@ -34,6 +34,13 @@ public:
 	virtual ~Resource() {}
 	virtual ptrdiff_t getHandle() const = 0;
 
+	/**
+	 * Byte offset which must be added to any offsets into the resource when
+	 * it's used by a draw. Buffers which cycle through several regions of GPU
+	 * memory point draws at the region holding their current contents.
+	 **/
+	virtual size_t getDrawOffset() const { return 0; }
+
 }; // Resource
 
 } // graphics
@@ -22,6 +22,7 @@
 #include "Shader.h"
 #include "Graphics.h"
 #include "math/MathModule.h"
+#include "thread/WorkerPool.h"
 
 // glslang
 #include "libraries/glslang/glslang/Public/ShaderLang.h"
@@ -39,19 +40,59 @@ love::Type Shader::type("Shader", &Object::type);
 Shader *Shader::current = nullptr;
 Shader *Shader::standardShaders[Shader::STANDARD_MAX_ENUM] = {nullptr};
 
-Shader::Shader(ShaderStage *vertex, ShaderStage *pixel)
+Shader::Shader(ShaderStage *vertex, ShaderStage *pixel, bool async)
 	: stages()
+	, loading(async)
 {
-	std::string err;
-	if (!validate(vertex, pixel, err))
-		throw love::Exception("%s", err.c_str());
-
 	stages[ShaderStage::STAGE_VERTEX] = vertex;
 	stages[ShaderStage::STAGE_PIXEL] = pixel;
+
+	if (!async)
+	{
+		std::string err;
+		if (!validate(vertex, pixel, err))
+			throw love::Exception("%s", err.c_str());
+		return;
+	}
+
+	auto state = std::make_shared<AsyncValidation>();
+	asyncValidation = state;
+
+	// The stages are kept alive by this Shader, and the destructor waits for
+	// the task, so it's safe to refer to them directly.
+	thread::WorkerPool::getShared().submit([state, vertex, pixel]()
+	{
+		std::string err;
+
+		bool valid = (vertex == nullptr || vertex->validate(err))
+			&& (pixel == nullptr || pixel->validate(err))
+			&& validate(vertex, pixel, err);
+
+		if (!valid && err.empty())
+			err = "Cannot compile shader.";
+
+		thread::Lock lock(state->mutex);
+		state->error = err;
+		state->done = true;
+		state->cond->broadcast();
+	});
+}
+
+Shader::Shader(ShaderStage *compute)
+	: stages()
+	, loading(false)
+{
+	stages[ShaderStage::STAGE_COMPUTE] = compute;
+
+	std::string err;
+	if (!validate(compute, err))
+		throw love::Exception("%s", err.c_str());
 }
 
 Shader::~Shader()
 {
+	waitForValidation();
+
 	for (int i = 0; i < STANDARD_MAX_ENUM; i++)
 	{
 		if (this == standardShaders[i])
@@ -62,6 +103,11 @@ Shader::~Shader()
 		attachDefault(STANDARD_DEFAULT);
 }
 
+bool Shader::isCompute() const
+{
+	return stages[ShaderStage::STAGE_COMPUTE].get() != nullptr;
+}
+
 void Shader::attachDefault(StandardShader defaultType)
 {
 	Shader *defaultshader = standardShaders[defaultType];
@@ -87,6 +133,82 @@ bool Shader::isDefaultActive()
 	return false;
 }
 
+void Shader::waitForValidation()
+{
+	if (asyncValidation.get() == nullptr)
+		return;
+
+	AsyncValidation &state = *asyncValidation;
+
+	thread::Lock lock(state.mutex);
+	while (!state.done)
+		state.cond->wait(state.mutex);
+}
+
+bool Shader::isReady()
+{
+	if (!loading)
+		return true;
+
+	if (!asyncError.empty())
+		return true;
+
+	if (asyncValidation.get() != nullptr)
+	{
+		thread::Lock lock(asyncValidation->mutex);
+		if (!asyncValidation->done)
+			return false;
+		if (!asyncValidation->error.empty())
+			return true;
+	}
+
+	return isProgramReady();
+}
+
+void Shader::finishLoading()
+{
+	if (!asyncError.empty())
+		throw love::Exception("%s", asyncError.c_str());
+
+	if (!loading)
+		return;
+
+	if (asyncValidation.get() != nullptr)
+	{
+		waitForValidation();
+
+		std::string err = asyncValidation->error;
+		asyncValidation.reset();
+
+		if (!err.empty())
+		{
+			asyncError = err;
+			throw love::Exception("%s", err.c_str());
+		}
+
+		// Only now are the stages known to be valid, so other shaders can
+		// share them.
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		for (const auto &stage : stages)
+		{
+			if (gfx != nullptr && stage.get() != nullptr)
+				gfx->cacheShaderStage(stage.get());
+		}
+	}
+
+	try
+	{
+		finishProgram();
+	}
+	catch (love::Exception &e)
+	{
+		asyncError = e.what();
+		throw;
+	}
+
+	loading = false;
+}
+
 TextureType Shader::getMainTextureType() const
 {
 	const UniformInfo *info = getUniformInfo(BUILTIN_TEXTURE_MAIN);
@@ -128,6 +250,11 @@ void Shader::checkMainTexture(Texture *tex) const
 
 bool Shader::validate(ShaderStage *vertex, ShaderStage *pixel, std::string &err)
 {
+	// Linking modifies the stages' glslang data, and cached stages are shared
+	// between shaders which may be validated on different threads.
+	static thread::MutexRef linkMutex;
+	thread::Lock lock(linkMutex);
+
 	glslang::TProgram program;
 
 	if (vertex != nullptr)
@@ -145,6 +272,25 @@ bool Shader::validate(ShaderStage *vertex, ShaderStage *pixel, std::string &err)
 	return true;
 }
 
+bool Shader::validate(ShaderStage *compute, std::string &err)
+{
+	// Compute stages are only ever linked with themselves, so they don't need
+	// to share the lock above.
+	static thread::MutexRef linkMutex;
+	thread::Lock lock(linkMutex);
+
+	glslang::TProgram program;
+	program.addShader(compute->getGLSLangShader());
+
+	if (!program.link(EShMsgDefault))
+	{
+		err = "Cannot compile compute shader:\n\n" + std::string(program.getInfoLog()) + "\n" + std::string(program.getInfoDebugLog());
+		return false;
+	}
+
+	return true;
+}
+
 bool Shader::initialize()
 {
 	return glslang::InitializeProcess();
@@ -26,10 +26,12 @@
 #include "Texture.h"
 #include "ShaderStage.h"
 #include "Resource.h"
+#include "thread/threads.h"
 
 // STL
 #include <string>
 #include <map>
+#include <memory>
 #include <vector>
 #include <stddef.h>
 
@@ -44,6 +46,7 @@ namespace graphics
 {
 
 class Graphics;
+class Mesh;
 
 // A GLSL shader
 class Shader : public Object, public Resource
@@ -86,6 +89,7 @@ public:
 		UNIFORM_UINT,
 		UNIFORM_BOOL,
 		UNIFORM_SAMPLER,
+		UNIFORM_STORAGE_IMAGE,
 		UNIFORM_UNKNOWN,
 		UNIFORM_MAX_ENUM
 	};
@@ -95,6 +99,13 @@ public:
 		STANDARD_DEFAULT,
 		STANDARD_VIDEO,
 		STANDARD_ARRAY,
+		STANDARD_INSTANCED_SPRITE,
+		STANDARD_GPU_PARTICLE,
+		STANDARD_LINE,
+		STANDARD_DISTANCE_FIELD,
+		STANDARD_INSTANCED_GLYPH,
+		STANDARD_INSTANCED_GLYPH_DISTANCE_FIELD,
+		STANDARD_SKINNED,
 		STANDARD_MAX_ENUM
 	};
 
@@ -139,9 +150,32 @@ public:
 	// Pointer to the default Shader.
 	static Shader *standardShaders[STANDARD_MAX_ENUM];
 
-	Shader(ShaderStage *vertex, ShaderStage *pixel);
+	/**
+	 * If async is true, validation of the stages happens on a worker thread
+	 * and the backend may compile and link without waiting on the driver.
+	 * finishLoading must be called before the Shader is used.
+	 **/
+	Shader(ShaderStage *vertex, ShaderStage *pixel, bool async = false);
+
+	// Creates a compute shader, which can only be dispatched, not drawn with.
+	Shader(ShaderStage *compute);
+
 	virtual ~Shader();
 
+	bool isCompute() const;
+
+	/**
+	 * Gets whether the Shader can be used without blocking. Also true if
+	 * loading failed, in which case finishLoading will throw.
+	 **/
+	bool isReady();
+
+	/**
+	 * Waits for any pending validation, compilation and linking to complete.
+	 * Throws if any of them failed. Does nothing if loading already finished.
+	 **/
+	void finishLoading();
+
 	/**
 	 * Binds this Shader's program to be used when rendering.
 	 **/
@@ -169,14 +203,45 @@ public:
 
 	virtual void updateUniform(const UniformInfo *info, int count) = 0;
 
+	/**
+	 * Also used for storage images, which are bound for image load/store
+	 * rather than sampled.
+	 **/
 	virtual void sendTextures(const UniformInfo *info, Texture **textures, int count) = 0;
 
+	/**
+	 * Binds a Mesh's vertex buffer to a shader storage block, so the same
+	 * data can be written by a compute shader and then drawn.
+	 **/
+	virtual void sendBuffer(const std::string &name, Mesh *mesh) = 0;
+
+	// Whether the Shader has an active shader storage block with this name.
+	virtual bool hasStorageBlock(const std::string &name) const = 0;
+
+	/**
+	 * Gets the local size of the compute shader's threadgroups, as declared
+	 * with layout(local_size_x = ...) in.
+	 **/
+	virtual void getLocalThreadgroupSize(int size[3]) const = 0;
+
 	/**
 	 * Gets whether a uniform with the specified name exists and is actively
 	 * used in the shader.
 	 **/
 	virtual bool hasUniform(const std::string &name) const = 0;
 
+	/**
+	 * Gets the size in bytes of an active uniform block, or 0 if the Shader
+	 * doesn't have one with the given name.
+	 **/
+	virtual size_t getUniformBlockSize(const std::string &name) const = 0;
+
+	/**
+	 * Copies size bytes from data into a uniform block, starting offset bytes
+	 * into the block. Only the modified range is uploaded before the next draw.
+	 **/
+	virtual void sendUniformBlock(const std::string &name, const void *data, size_t offset, size_t size) = 0;
+
 	/**
 	 * Sets the textures used when rendering a video. For internal use only.
 	 **/
@@ -187,6 +252,7 @@ public:
 	void checkMainTexture(Texture *texture) const;
 
 	static bool validate(ShaderStage *vertex, ShaderStage *pixel, std::string &err);
+	static bool validate(ShaderStage *compute, std::string &err);
 
 	static bool initialize();
 	static void deinitialize();
@@ -199,10 +265,30 @@ public:
 
 protected:
 
+	// Whether the backend's compile or link is still running.
+	virtual bool isProgramReady() { return true; }
+
+	// Waits for and checks the backend's compile and link.
+	virtual void finishProgram() {}
+
 	StrongRef<ShaderStage> stages[ShaderStage::STAGE_MAX_ENUM];
 
 private:
 
+	struct AsyncValidation
+	{
+		love::thread::MutexRef mutex;
+		love::thread::ConditionalRef cond;
+		bool done = false;
+		std::string error;
+	};
+
+	void waitForValidation();
+
+	std::shared_ptr<AsyncValidation> asyncValidation;
+	std::string asyncError;
+	bool loading;
+
 	static StringMap<Language, LANGUAGE_MAX_ENUM>::Entry languageEntries[];
 	static StringMap<Language, LANGUAGE_MAX_ENUM> languages;
 	
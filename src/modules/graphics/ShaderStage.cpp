@@ -127,28 +127,45 @@ namespace love
 namespace graphics
 {
 
-ShaderStage::ShaderStage(Graphics *gfx, StageType stage, const std::string &glsl, bool gles, const std::string &cachekey)
+ShaderStage::ShaderStage(Graphics *gfx, StageType stage, const std::string &glsl, bool gles, const std::string &cachekey, bool deferValidation)
 	: stageType(stage)
 	, source(glsl)
 	, cacheKey(cachekey)
 	, glslangShader(nullptr)
+	, gles(gles)
+	, supportsGLSL3(gfx->getCapabilities().features[Graphics::FEATURE_GLSL3])
+	, validated(false)
 {
-	EShLanguage glslangStage = EShLangCount;
-	if (stage == STAGE_VERTEX)
-		glslangStage = EShLangVertex;
-	else if (stage == STAGE_PIXEL)
-		glslangStage = EShLangFragment;
-	else
+	if (stage != STAGE_VERTEX && stage != STAGE_PIXEL && stage != STAGE_COMPUTE)
 		throw love::Exception("Cannot compile shader stage: unknown stage type.");
 
+	if (deferValidation)
+		return;
+
+	std::string err;
+	if (!validate(err))
+		throw love::Exception("%s", err.c_str());
+}
+
+bool ShaderStage::validate(std::string &err)
+{
+	if (validated)
+		return true;
+
+	EShLanguage glslangStage = EShLangVertex;
+	if (stageType == STAGE_PIXEL)
+		glslangStage = EShLangFragment;
+	else if (stageType == STAGE_COMPUTE)
+		glslangStage = EShLangCompute;
+
+	delete glslangShader;
 	glslangShader = new glslang::TShader(glslangStage);
 
-	bool supportsGLSL3 = gfx->getCapabilities().features[Graphics::FEATURE_GLSL3];
 	int defaultversion = gles ? 100 : 120;
 	EProfile defaultprofile = ENoProfile;
 
-	const char *csrc = glsl.c_str();
-	int srclen = (int) glsl.length();
+	const char *csrc = source.c_str();
+	int srclen = (int) source.length();
 	glslangShader->setStringsWithLengths(&csrc, &srclen, 1);
 
 	bool forcedefault = false;
@@ -160,15 +177,19 @@ ShaderStage::ShaderStage(Graphics *gfx, StageType stage, const std::string &glsl
 	if (!glslangShader->parse(&defaultTBuiltInResource, defaultversion, defaultprofile, forcedefault, forwardcompat, EShMsgSuppressWarnings))
 	{
 		const char *stagename = "unknown";
-		getConstant(stage, stagename);
+		getConstant(stageType, stagename);
 
-		std::string err = "Error validating " + std::string(stagename) + " shader:\n\n"
+		err = "Error validating " + std::string(stagename) + " shader:\n\n"
 			+ std::string(glslangShader->getInfoLog()) + "\n"
 			+ std::string(glslangShader->getInfoDebugLog());
 
 		delete glslangShader;
-		throw love::Exception("%s", err.c_str());
+		glslangShader = nullptr;
+		return false;
 	}
+
+	validated = true;
+	return true;
 }
 
 ShaderStage::~ShaderStage()
@@ -177,7 +198,7 @@ ShaderStage::~ShaderStage()
 	{
 		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
 		if (gfx != nullptr)
-			gfx->cleanupCachedShaderStage(stageType, cacheKey);
+			gfx->cleanupCachedShaderStage(this);
 	}
 
 	delete glslangShader;
@@ -195,8 +216,9 @@ bool ShaderStage::getConstant(StageType in, const char *&out)
 
 StringMap<ShaderStage::StageType, ShaderStage::STAGE_MAX_ENUM>::Entry ShaderStage::stageNameEntries[] =
 {
-	{ "vertex", STAGE_VERTEX },
-	{ "pixel",  STAGE_PIXEL  },
+	{ "vertex",  STAGE_VERTEX  },
+	{ "pixel",   STAGE_PIXEL   },
+	{ "compute", STAGE_COMPUTE },
 };
 
 StringMap<ShaderStage::StageType, ShaderStage::STAGE_MAX_ENUM> ShaderStage::stageNames(ShaderStage::stageNameEntries, sizeof(ShaderStage::stageNameEntries));
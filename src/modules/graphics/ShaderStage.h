@@ -48,15 +48,25 @@ public:
 	{
 		STAGE_VERTEX,
 		STAGE_PIXEL,
+		STAGE_COMPUTE,
 		STAGE_MAX_ENUM
 	};
 
-	ShaderStage(Graphics *gfx, StageType stage, const std::string &glsl, bool gles, const std::string &cachekey);
+	ShaderStage(Graphics *gfx, StageType stage, const std::string &glsl, bool gles, const std::string &cachekey, bool deferValidation = false);
 	virtual ~ShaderStage();
 
+	/**
+	 * Parses the source with glslang, if that was deferred when the stage was
+	 * created. Only touches this stage, so it may run on another thread as
+	 * long as nothing else uses the stage meanwhile.
+	 **/
+	bool validate(std::string &err);
+	bool isValidated() const { return validated; }
+
 	StageType getStageType() const { return stageType; }
 	const std::string &getSource() const { return source; }
 	const std::string &getWarnings() const { return warnings; }
+	const std::string &getCacheKey() const { return cacheKey; }
 	glslang::TShader *getGLSLangShader() const { return glslangShader; }
 
 	static bool getConstant(const char *in, StageType &out);
@@ -73,6 +83,10 @@ private:
 	std::string cacheKey;
 	glslang::TShader *glslangShader;
 
+	bool gles;
+	bool supportsGLSL3;
+	bool validated;
+
 	static StringMap<StageType, STAGE_MAX_ENUM>::Entry stageNameEntries[];
 	static StringMap<StageType, STAGE_MAX_ENUM> stageNames;
 
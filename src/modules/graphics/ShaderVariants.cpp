@@ -0,0 +1,155 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "ShaderVariants.h"
+#include "Graphics.h"
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type ShaderVariants::type("ShaderVariants", &Object::type);
+
+ShaderVariants::ShaderVariants(const std::string &vertex, const std::string &pixel, const std::vector<std::string> &keys)
+	: vertexSource(vertex)
+	, pixelSource(pixel)
+	, keys(keys)
+{
+	if (vertex.empty() && pixel.empty())
+		throw love::Exception("Error creating shader variants: no source code!");
+
+	if (keys.size() > (size_t) MAX_KEYS)
+		throw love::Exception("Too many shader variant keys (%d given, the maximum is %d).", (int) keys.size(), MAX_KEYS);
+
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		if (keys[i].empty() || keys[i].find_first_of(" \t\r\n") != std::string::npos)
+			throw love::Exception("Invalid shader variant key: '%s'", keys[i].c_str());
+
+		for (size_t j = 0; j < i; j++)
+		{
+			if (keys[i] == keys[j])
+				throw love::Exception("Duplicate shader variant key: '%s'", keys[i].c_str());
+		}
+	}
+
+	// Shaders are only used on the main thread.
+	confineToThread();
+}
+
+ShaderVariants::~ShaderVariants()
+{
+}
+
+ShaderVariants::Mask ShaderVariants::getMask(const std::vector<std::string> &names) const
+{
+	Mask mask = 0;
+
+	for (const std::string &name : names)
+	{
+		bool found = false;
+
+		for (size_t i = 0; i < keys.size(); i++)
+		{
+			if (keys[i] == name)
+			{
+				mask |= Mask(1) << i;
+				found = true;
+				break;
+			}
+		}
+
+		if (!found)
+			throw love::Exception("Unknown shader variant key: '%s'", name.c_str());
+	}
+
+	return mask;
+}
+
+Shader *ShaderVariants::getShader(Mask mask)
+{
+	auto it = variants.find(mask);
+	if (it != variants.end())
+		return it->second.get();
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (gfx == nullptr)
+		throw love::Exception("love.graphics must be loaded to compile shader variants.");
+
+	std::string vertex = getVariantSource(vertexSource, mask);
+	std::string pixel = getVariantSource(pixelSource, mask);
+
+	StrongRef<Shader> shader(gfx->newShader(vertex, pixel), Acquire::NORETAIN);
+	variants[mask] = shader;
+
+	return shader.get();
+}
+
+void ShaderVariants::precompile(Mask mask)
+{
+	if (variants.find(mask) != variants.end())
+		return;
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (gfx == nullptr)
+		throw love::Exception("love.graphics must be loaded to compile shader variants.");
+
+	std::string vertex = getVariantSource(vertexSource, mask);
+	std::string pixel = getVariantSource(pixelSource, mask);
+
+	StrongRef<Shader> shader(gfx->newShaderAsync(vertex, pixel), Acquire::NORETAIN);
+	variants[mask] = shader;
+}
+
+bool ShaderVariants::isCached(Mask mask) const
+{
+	return variants.find(mask) != variants.end();
+}
+
+void ShaderVariants::clear()
+{
+	variants.clear();
+}
+
+std::string ShaderVariants::getVariantSource(const std::string &source, Mask mask) const
+{
+	if (source.empty() || mask == 0)
+		return source;
+
+	std::string defines;
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		if (mask & (Mask(1) << i))
+			defines += "#define " + keys[i] + " 1\n";
+	}
+
+	// The defines have to come after the #version line. The user's code has
+	// its own #line directive, so error line numbers aren't affected.
+	size_t pos = source.find('\n');
+	if (pos == std::string::npos)
+		return source + "\n" + defines;
+
+	return source.substr(0, pos + 1) + defines + source.substr(pos + 1);
+}
+
+} // graphics
+} // love
@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/int.h"
+#include "Shader.h"
+
+// C++
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * One shader's source with a set of #define keys. Each combination of keys is
+ * a variant, compiled the first time it's requested and cached by its key
+ * bitmask, so switching between variants doesn't rebuild source strings or
+ * recompile anything. Variants also go through the shader stage and program
+ * binary caches like any other Shader.
+ **/
+class ShaderVariants : public Object
+{
+public:
+
+	typedef uint64 Mask;
+
+	static const int MAX_KEYS = 64;
+
+	static love::Type type;
+
+	// The sources must be complete GLSL, as given to Graphics::newShader.
+	ShaderVariants(const std::string &vertex, const std::string &pixel, const std::vector<std::string> &keys);
+	virtual ~ShaderVariants();
+
+	/**
+	 * Gets the bitmask for the given keys. Throws if one of them wasn't given
+	 * when the ShaderVariants was created.
+	 **/
+	Mask getMask(const std::vector<std::string> &keys) const;
+
+	/**
+	 * Gets the Shader for a variant, compiling it if necessary. A variant
+	 * which is still being precompiled may not be ready yet.
+	 **/
+	Shader *getShader(Mask mask);
+
+	/**
+	 * Starts compiling a variant in the background, if it isn't cached yet.
+	 **/
+	void precompile(Mask mask);
+
+	bool isCached(Mask mask) const;
+	int getCachedCount() const { return (int) variants.size(); }
+
+	const std::vector<std::string> &getKeys() const { return keys; }
+
+	// Releases all cached variants.
+	void clear();
+
+private:
+
+	std::string getVariantSource(const std::string &source, Mask mask) const;
+
+	std::string vertexSource;
+	std::string pixelSource;
+
+	std::vector<std::string> keys;
+
+	std::unordered_map<Mask, StrongRef<Shader>> variants;
+
+}; // ShaderVariants
+
+} // graphics
+} // love
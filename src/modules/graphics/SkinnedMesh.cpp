@@ -0,0 +1,145 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "SkinnedMesh.h"
+
+// C++
+#include <algorithm>
+#include <cstring>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type SkinnedMesh::type("SkinnedMesh", &Mesh::type);
+
+SkinnedMesh::SkinnedMesh(Graphics *gfx, const std::vector<AttribFormat> &vertexformat, const void *data, size_t datasize, PrimitiveType drawmode, vertex::Usage usage)
+	: Mesh(gfx, vertexformat, data, datasize, drawmode, usage)
+	, boneCount(0)
+{
+	init();
+}
+
+SkinnedMesh::SkinnedMesh(Graphics *gfx, const std::vector<AttribFormat> &vertexformat, int vertexcount, PrimitiveType drawmode, vertex::Usage usage)
+	: Mesh(gfx, vertexformat, vertexcount, drawmode, usage)
+	, boneCount(0)
+{
+	init();
+}
+
+SkinnedMesh::~SkinnedMesh()
+{
+}
+
+void SkinnedMesh::init()
+{
+	int indicesindex = getAttributeIndex("VertexBoneIndices");
+	int weightsindex = getAttributeIndex("VertexBoneWeights");
+
+	if (indicesindex < 0 || weightsindex < 0)
+		throw love::Exception("SkinnedMesh vertex formats must have VertexBoneIndices and VertexBoneWeights attributes.");
+
+	int components = 0;
+	vertex::DataType indicestype = getAttributeInfo(indicesindex, components);
+
+	// The shader scales the normalized indices back up.
+	if (indicestype != vertex::DATA_UNORM8 || components != 4)
+		throw love::Exception("The VertexBoneIndices attribute of a SkinnedMesh must have 4 byte components.");
+
+	getAttributeInfo(weightsindex, components);
+	if (components != 4)
+		throw love::Exception("The VertexBoneWeights attribute of a SkinnedMesh must have 4 components.");
+
+	// Every bone starts out as the identity transform.
+	memset(boneData, 0, sizeof(boneData));
+	for (int i = 0; i < MAX_BONES; i++)
+	{
+		boneData[i * 8 + 0] = 1.0f;
+		boneData[i * 8 + 5] = 1.0f;
+	}
+}
+
+void SkinnedMesh::setBoneTransforms(int start, const float *transforms, int count)
+{
+	if (start < 0 || count < 0 || start + count > MAX_BONES)
+		throw love::Exception("Invalid bone range (SkinnedMeshes can have at most %d bones.)", MAX_BONES);
+
+	for (int i = 0; i < count; i++)
+	{
+		const float *t = &transforms[i * 6];
+		float *row = &boneData[(start + i) * 8];
+
+		row[0] = t[0];
+		row[1] = t[1];
+		row[2] = t[2];
+		row[4] = t[3];
+		row[5] = t[4];
+		row[6] = t[5];
+	}
+
+	boneCount = std::max(boneCount, start + count);
+}
+
+void SkinnedMesh::getBoneTransform(int bone, float *transform) const
+{
+	if (bone < 0 || bone >= MAX_BONES)
+		throw love::Exception("Invalid bone index: %d", bone + 1);
+
+	const float *row = &boneData[bone * 8];
+
+	transform[0] = row[0];
+	transform[1] = row[1];
+	transform[2] = row[2];
+	transform[3] = row[4];
+	transform[4] = row[5];
+	transform[5] = row[6];
+}
+
+Shader::StandardShader SkinnedMesh::getStandardShaderType() const
+{
+	return Shader::STANDARD_SKINNED;
+}
+
+void SkinnedMesh::getDrawAttributes(vertex::Attributes &attributes, vertex::Buffers &buffers)
+{
+	Mesh::getDrawAttributes(attributes, buffers);
+
+	Shader *shader = Shader::current;
+
+	if (shader == nullptr || shader->getVertexAttributeIndex("VertexBoneIndices") < 0
+		|| shader->getVertexAttributeIndex("VertexBoneWeights") < 0)
+	{
+		throw love::Exception("SkinnedMeshes must be drawn with a vertex shader which uses the VertexBoneIndices and VertexBoneWeights attributes.");
+	}
+
+	const Shader::UniformInfo *info = shader->getUniformInfo("love_BoneTransforms");
+
+	// The whole skeleton is one uniform upload, regardless of vertex count.
+	if (info != nullptr && info->baseType == Shader::UNIFORM_FLOAT && info->components == 4)
+	{
+		int count = std::min(std::max(boneCount, 1) * 2, info->count);
+		memcpy(info->floats, boneData, sizeof(float) * 4 * count);
+		shader->updateUniform(info, count);
+	}
+}
+
+} // graphics
+} // love
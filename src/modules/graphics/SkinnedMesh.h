@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "Mesh.h"
+#include "Shader.h"
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * A Mesh whose vertices are deformed by up to four bones each, on the GPU.
+ * The vertex format must have a VertexBoneIndices attribute with 4 "byte"
+ * components, and a VertexBoneWeights attribute with 4 components. Bones are
+ * 2D affine transforms, sent to the vertex shader in the love_BoneTransforms
+ * vec4 array when the SkinnedMesh is drawn (two rows per bone). Custom vertex
+ * shaders need to declare those attributes and the array to be used.
+ **/
+class SkinnedMesh : public Mesh
+{
+public:
+
+	static love::Type type;
+
+	// Limited by the number of vertex shader uniforms guaranteed by GLSL ES.
+	static const int MAX_BONES = 48;
+
+	SkinnedMesh(Graphics *gfx, const std::vector<AttribFormat> &vertexformat, const void *data, size_t datasize, PrimitiveType drawmode, vertex::Usage usage);
+	SkinnedMesh(Graphics *gfx, const std::vector<AttribFormat> &vertexformat, int vertexcount, PrimitiveType drawmode, vertex::Usage usage);
+
+	virtual ~SkinnedMesh();
+
+	/**
+	 * Sets the transforms of count bones, starting at the given bone. Each
+	 * transform is 6 floats {a, b, tx, c, d, ty}, which map a vertex position
+	 * to (a*x + b*y + tx, c*x + d*y + ty).
+	 **/
+	void setBoneTransforms(int start, const float *transforms, int count);
+	void getBoneTransform(int bone, float *transform) const;
+
+	/**
+	 * Gets the number of bones sent to the shader: one past the highest bone
+	 * which has been set.
+	 **/
+	int getBoneCount() const { return boneCount; }
+
+protected:
+
+	Shader::StandardShader getStandardShaderType() const override;
+	void getDrawAttributes(vertex::Attributes &attributes, vertex::Buffers &buffers) override;
+
+private:
+
+	void init();
+
+	// Two rows of {a, b, tx, 0} and {c, d, ty, 0} per bone, in the layout of
+	// love_BoneTransforms.
+	float boneData[MAX_BONES * 8];
+	int boneCount;
+
+}; // SkinnedMesh
+
+} // graphics
+} // love
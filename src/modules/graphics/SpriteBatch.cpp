@@ -24,6 +24,7 @@
 // LOVE
 #include "Texture.h"
 #include "Quad.h"
+#include "QuadAtlas.h"
 #include "Graphics.h"
 #include "Buffer.h"
 
@@ -40,13 +41,15 @@ namespace graphics
 
 love::Type SpriteBatch::type("SpriteBatch", &Drawable::type);
 
-SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, vertex::Usage usage)
+SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, vertex::Usage usage, bool instanced)
 	: texture(texture)
 	, size(size)
 	, next(0)
 	, color(255, 255, 255, 255)
 	, color_active(false)
+	, instanced(instanced)
 	, array_buf(nullptr)
+	, corner_buf(nullptr)
 	, range_start(-1)
 	, range_count(-1)
 {
@@ -58,18 +61,49 @@ SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, vertex::Usag
 
 	if (texture->getTextureType() == TEXTURE_2D_ARRAY)
 		vertex_format = vertex::CommonFormat::XYf_STPf_RGBAub;
-	else
+	else if (instanced)
 		vertex_format = vertex::CommonFormat::XYf_STf_RGBAub;
+	else
+		vertex_format = vertex::CommonFormat::XYf_STus_RGBAub;
 
 	vertex_stride = vertex::getFormatStride(vertex_format);
+	sprite_stride = vertex_stride * 4;
+
+	if (instanced)
+	{
+		if (!gfx->getCapabilities().features[Graphics::FEATURE_INSTANCING])
+			throw love::Exception("Instancing is not supported on this system.");
+
+		if (texture->getTextureType() != TEXTURE_2D)
+			throw love::Exception("Instanced SpriteBatches can only be used with 2D textures.");
+
+		if (Shader::standardShaders[Shader::STANDARD_INSTANCED_SPRITE] == nullptr)
+			throw love::Exception("Instanced SpriteBatches are not supported on this system.");
+
+		sprite_stride = sizeof(InstanceData);
 
-	size_t vertex_size = vertex_stride * 4 * size;
-	array_buf = gfx->newBuffer(vertex_size, nullptr, BUFFER_VERTEX, usage, Buffer::MAP_EXPLICIT_RANGE_MODIFY);
+		// Unit square corners, ordered for a triangle strip like Quad's.
+		const float corners[] = {0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f, 1.0f};
+		corner_buf = gfx->newBuffer(sizeof(corners), corners, BUFFER_VERTEX, vertex::USAGE_STATIC, 0);
+	}
+
+	size_t vertex_size = sprite_stride * size;
+
+	try
+	{
+		array_buf = gfx->newBuffer(vertex_size, nullptr, BUFFER_VERTEX, usage, Buffer::MAP_EXPLICIT_RANGE_MODIFY);
+	}
+	catch (love::Exception &)
+	{
+		delete corner_buf;
+		throw;
+	}
 }
 
 SpriteBatch::~SpriteBatch()
 {
 	delete array_buf;
+	delete corner_buf;
 }
 
 int SpriteBatch::add(const Matrix4 &m, int index /*= -1*/)
@@ -78,11 +112,22 @@ int SpriteBatch::add(const Matrix4 &m, int index /*= -1*/)
 }
 
 int SpriteBatch::add(Quad *quad, const Matrix4 &m, int index /*= -1*/)
+{
+	return addQuad(quad->getVertexPositions(), quad->getVertexTexCoords(), quad->getLayer(), m, index);
+}
+
+int SpriteBatch::add(QuadAtlas *atlas, int frame, const Matrix4 &m, int index /*= -1*/)
+{
+	atlas->checkIndex(frame);
+	return addQuad(atlas->getVertexPositions(frame), atlas->getVertexTexCoords(frame), atlas->getLayer(frame), m, index);
+}
+
+int SpriteBatch::addQuad(const Vector2 *quadpositions, const Vector2 *quadtexcoords, int layer, const Matrix4 &m, int index)
 {
 	using namespace vertex;
 
 	if (vertex_format == CommonFormat::XYf_STPf_RGBAub)
-		return addLayer(quad->getLayer(), quad, m, index);
+		return addQuadLayer(layer, quadpositions, quadtexcoords, m, index);
 
 	if (index < -1 || index >= size)
 		throw love::Exception("Invalid sprite index: %d", index + 1);
@@ -90,23 +135,81 @@ int SpriteBatch::add(Quad *quad, const Matrix4 &m, int index /*= -1*/)
 	if (index == -1 && next >= size)
 		setBufferSize(size * 2);
 
-	const Vector2 *quadpositions = quad->getVertexPositions();
-	const Vector2 *quadtexcoords = quad->getVertexTexCoords();
-
 	// Always keep the VBO mapped when adding data (it'll be unmapped on draw.)
-	size_t offset = (index == -1 ? next : index) * vertex_stride * 4;
-	auto verts = (XYf_STf_RGBAub *) ((uint8 *) array_buf->map() + offset);
+	size_t offset = (index == -1 ? next : index) * sprite_stride;
 
-	m.transformXY(verts, quadpositions, 4);
+	if (instanced)
+	{
+		auto instance = (InstanceData *) ((uint8 *) array_buf->map() + offset);
+		const float *e = m.getElements();
 
-	for (int i = 0; i < 4; i++)
+		float w = quadpositions[3].x;
+		float h = quadpositions[3].y;
+
+		instance->transform[0] = e[0] * w;
+		instance->transform[1] = e[1] * w;
+		instance->transform[2] = e[4] * h;
+		instance->transform[3] = e[5] * h;
+
+		instance->position[0] = e[12];
+		instance->position[1] = e[13];
+
+		instance->texRect[0] = quadtexcoords[0].x;
+		instance->texRect[1] = quadtexcoords[0].y;
+		instance->texRect[2] = quadtexcoords[3].x;
+		instance->texRect[3] = quadtexcoords[3].y;
+
+		instance->color = color;
+
+		array_buf->setMappedRangeModified(offset, sprite_stride);
+
+		if (index == -1)
+			return next++;
+
+		return index;
+	}
+
+	if (vertex_format == CommonFormat::XYf_STus_RGBAub)
 	{
-		verts[i].s = quadtexcoords[i].x;
-		verts[i].t = quadtexcoords[i].y;
-		verts[i].color = color;
+		for (int i = 0; i < 4; i++)
+		{
+			if (!isUnormTexCoord(quadtexcoords[i].x, quadtexcoords[i].y))
+			{
+				useFloatTexCoords();
+				offset = (index == -1 ? next : index) * sprite_stride;
+				break;
+			}
+		}
+	}
+
+	if (vertex_format == CommonFormat::XYf_STus_RGBAub)
+	{
+		auto verts = (XYf_STus_RGBAub *) ((uint8 *) array_buf->map() + offset);
+
+		m.transformXY(verts, quadpositions, 4);
+
+		for (int i = 0; i < 4; i++)
+		{
+			verts[i].s = packUnormTexCoord(quadtexcoords[i].x);
+			verts[i].t = packUnormTexCoord(quadtexcoords[i].y);
+			verts[i].color = color;
+		}
+	}
+	else
+	{
+		auto verts = (XYf_STf_RGBAub *) ((uint8 *) array_buf->map() + offset);
+
+		m.transformXY(verts, quadpositions, 4);
+
+		for (int i = 0; i < 4; i++)
+		{
+			verts[i].s = quadtexcoords[i].x;
+			verts[i].t = quadtexcoords[i].y;
+			verts[i].color = color;
+		}
 	}
 
-	array_buf->setMappedRangeModified(offset, vertex_stride * 4);
+	array_buf->setMappedRangeModified(offset, sprite_stride);
 
 	// Increment counter.
 	if (index == -1)
@@ -121,6 +224,17 @@ int SpriteBatch::addLayer(int layer, const Matrix4 &m, int index)
 }
 
 int SpriteBatch::addLayer(int layer, Quad *quad, const Matrix4 &m, int index)
+{
+	return addQuadLayer(layer, quad->getVertexPositions(), quad->getVertexTexCoords(), m, index);
+}
+
+int SpriteBatch::addLayer(int layer, QuadAtlas *atlas, int frame, const Matrix4 &m, int index)
+{
+	atlas->checkIndex(frame);
+	return addQuadLayer(layer, atlas->getVertexPositions(frame), atlas->getVertexTexCoords(frame), m, index);
+}
+
+int SpriteBatch::addQuadLayer(int layer, const Vector2 *quadpositions, const Vector2 *quadtexcoords, const Matrix4 &m, int index)
 {
 	using namespace vertex;
 
@@ -136,11 +250,8 @@ int SpriteBatch::addLayer(int layer, Quad *quad, const Matrix4 &m, int index)
 	if (index == -1 && next >= size)
 		setBufferSize(size * 2);
 
-	const Vector2 *quadpositions = quad->getVertexPositions();
-	const Vector2 *quadtexcoords = quad->getVertexTexCoords();
-
 	// Always keep the VBO mapped when adding data (it'll be unmapped on draw.)
-	size_t offset = (index == -1 ? next : index) * vertex_stride * 4;
+	size_t offset = (index == -1 ? next : index) * sprite_stride;
 	auto verts = (XYf_STPf_RGBAub *) ((uint8 *) array_buf->map() + offset);
 
 	m.transformXY(verts, quadpositions, 4);
@@ -153,7 +264,7 @@ int SpriteBatch::addLayer(int layer, Quad *quad, const Matrix4 &m, int index)
 		verts[i].color = color;
 	}
 
-	array_buf->setMappedRangeModified(offset, vertex_stride * 4);
+	array_buf->setMappedRangeModified(offset, sprite_stride);
 
 	// Increment counter.
 	if (index == -1)
@@ -162,6 +273,41 @@ int SpriteBatch::addLayer(int layer, Quad *quad, const Matrix4 &m, int index)
 	return index;
 }
 
+void SpriteBatch::setSprites(int start, const SpriteRecord *records, int count, const std::vector<Quad *> &quads, QuadAtlas *atlas)
+{
+	if (start < 0 || start > next)
+		throw love::Exception("Invalid sprite index: %d", start + 1);
+
+	if (count <= 0)
+		return;
+
+	int end = start + count;
+
+	if (end > size)
+		setBufferSize(std::max(end, size * 2));
+
+	Quad *defaultquad = texture->getQuad();
+
+	for (int i = 0; i < count; i++)
+	{
+		const SpriteRecord &r = records[i];
+
+		int quadindex = (int) r.quad;
+		int quadcount = atlas != nullptr ? atlas->getCount() : (int) quads.size();
+		if (quadindex < 0 || quadindex > quadcount)
+			throw love::Exception("Invalid quad index %d for sprite %d.", quadindex, start + i + 1);
+
+		Matrix4 m(r.x, r.y, r.angle, r.sx, r.sy, r.ox, r.oy, 0.0f, 0.0f);
+
+		if (atlas != nullptr && quadindex > 0)
+			add(atlas, quadindex - 1, m, start + i);
+		else
+			add(quadindex > 0 ? quads[quadindex - 1] : defaultquad, m, start + i);
+	}
+
+	next = std::max(next, end);
+}
+
 void SpriteBatch::clear()
 {
 	// Reset the position of the next index.
@@ -216,6 +362,40 @@ int SpriteBatch::getCount() const
 	return next;
 }
 
+void SpriteBatch::useFloatTexCoords()
+{
+	using namespace vertex;
+
+	size_t new_sprite_stride = sizeof(XYf_STf_RGBAub) * 4;
+	love::graphics::Buffer *new_array_buf = nullptr;
+
+	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
+	new_array_buf = gfx->newBuffer(new_sprite_stride * size, nullptr, array_buf->getType(), array_buf->getUsage(), array_buf->getMapFlags());
+
+	// The buffer keeps a copy of its data in client memory.
+	const XYf_STus_RGBAub *src = (const XYf_STus_RGBAub *) array_buf->map();
+	XYf_STf_RGBAub *dst = (XYf_STf_RGBAub *) new_array_buf->map();
+
+	for (int i = 0; i < next * 4; i++)
+	{
+		dst[i].x = src[i].x;
+		dst[i].y = src[i].y;
+		dst[i].s = (float) src[i].s / (float) LOVE_UINT16_MAX;
+		dst[i].t = (float) src[i].t / (float) LOVE_UINT16_MAX;
+		dst[i].color = src[i].color;
+	}
+
+	new_array_buf->setMappedRangeModified(0, new_sprite_stride * next);
+
+	// We don't need to unmap the old Buffer since we're deleting it.
+	delete array_buf;
+	array_buf = new_array_buf;
+
+	vertex_format = CommonFormat::XYf_STf_RGBAub;
+	vertex_stride = getFormatStride(vertex_format);
+	sprite_stride = new_sprite_stride;
+}
+
 void SpriteBatch::setBufferSize(int newsize)
 {
 	if (newsize <= 0)
@@ -224,7 +404,7 @@ void SpriteBatch::setBufferSize(int newsize)
 	if (newsize == size)
 		return;
 
-	size_t vertex_size = vertex_stride * 4 * newsize;
+	size_t vertex_size = sprite_stride * newsize;
 	love::graphics::Buffer *new_array_buf = nullptr;
 
 	int new_next = std::min(next, newsize);
@@ -235,7 +415,7 @@ void SpriteBatch::setBufferSize(int newsize)
 		new_array_buf = gfx->newBuffer(vertex_size, nullptr, array_buf->getType(), array_buf->getUsage(), array_buf->getMapFlags());
 
 		// Copy as much of the old data into the new GLBuffer as can fit.
-		size_t copy_size = vertex_stride * 4 * new_next;
+		size_t copy_size = sprite_stride * new_next;
 		array_buf->copyTo(0, copy_size, new_array_buf, 0);
 	}
 	catch (love::Exception &)
@@ -258,13 +438,20 @@ int SpriteBatch::getBufferSize() const
 	return size;
 }
 
+bool SpriteBatch::isInstanced() const
+{
+	return instanced;
+}
+
 void SpriteBatch::attachAttribute(const std::string &name, Mesh *mesh)
 {
 	AttachedAttribute oldattrib = {};
 	AttachedAttribute newattrib = {};
 
-	if (mesh->getVertexCount() < (size_t) next * 4)
-		throw love::Exception("Mesh has too few vertices to be attached to this SpriteBatch (at least %d vertices are required)", next*4);
+	int vertsneeded = next * getVerticesPerSprite();
+
+	if (mesh->getVertexCount() < (size_t) vertsneeded)
+		throw love::Exception("Mesh has too few vertices to be attached to this SpriteBatch (at least %d vertices are required)", vertsneeded);
 
 	auto it = attached_attributes.find(name);
 	if (it != attached_attributes.end())
@@ -311,6 +498,27 @@ void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 	if (next == 0)
 		return;
 
+	int start = std::min(std::max(0, range_start), next - 1);
+
+	int count = next;
+	if (range_count > 0)
+		count = std::min(count, range_count);
+
+	count = std::min(count, next - start);
+
+	if (instanced)
+	{
+		if (count > 0)
+			drawInstanced(gfx, m, start, count);
+		return;
+	}
+
+	if (canDrawMerged(count))
+	{
+		drawMerged(gfx, m, start, count);
+		return;
+	}
+
 	gfx->flushStreamDraws();
 
 	if (texture.get())
@@ -384,16 +592,191 @@ void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 
 	Graphics::TempTransform transform(gfx, m);
 
-	int start = std::min(std::max(0, range_start), next - 1);
+	if (count > 0)
+		gfx->drawQuads(start, count, attributes, buffers, texture, true);
+}
 
-	int count = next;
-	if (range_count > 0)
-		count = std::min(count, range_count);
+bool SpriteBatch::canDrawMerged(int count) const
+{
+	// Attached attributes and array layers need the batch's own buffers.
+	return count > 0 && count <= MAX_MERGED_SPRITES && attached_attributes.empty()
+		&& (vertex_format == vertex::CommonFormat::XYf_STf_RGBAub
+		|| vertex_format == vertex::CommonFormat::XYf_STus_RGBAub);
+}
 
-	count = std::min(count, next - start);
+// Copies a merged draw's texture coordinates and colors. Stream draws bake
+// the global color into each vertex.
+template <typename SrcVertex, typename DstVertex>
+static void copyMergedVertices(const SrcVertex *src, DstVertex *dst, int count, bool coloractive, Colorf nc)
+{
+	if (!coloractive)
+	{
+		Color c = toColor(nc);
+		for (int i = 0; i < count; i++)
+		{
+			dst[i].s = src[i].s;
+			dst[i].t = src[i].t;
+			dst[i].color = c;
+		}
+	}
+	else if (isGammaCorrect())
+	{
+		gammaCorrectColor(nc);
 
-	if (count > 0)
-		gfx->drawQuads(start, count, attributes, buffers, texture);
+		for (int i = 0; i < count; i++)
+		{
+			Colorf ci = toColorf(src[i].color);
+			gammaCorrectColor(ci);
+			ci *= nc;
+			unGammaCorrectColor(ci);
+
+			dst[i].s = src[i].s;
+			dst[i].t = src[i].t;
+			dst[i].color = toColor(ci);
+		}
+	}
+	else
+	{
+		for (int i = 0; i < count; i++)
+		{
+			dst[i].s = src[i].s;
+			dst[i].t = src[i].t;
+			dst[i].color = toColor(nc * toColorf(src[i].color));
+		}
+	}
+}
+
+void SpriteBatch::drawMerged(Graphics *gfx, const Matrix4 &m, int start, int count)
+{
+	using namespace vertex;
+
+	const Matrix4 &tm = gfx->getTransform();
+	bool is2D = tm.isAffine2DTransform();
+
+	bool compact = vertex_format == CommonFormat::XYf_STus_RGBAub;
+
+	// Same formats as Texture::draw, so single sprites merge with these too.
+	Graphics::StreamDrawCommand cmd;
+	cmd.formats[0] = getSinglePositionFormat(is2D);
+	cmd.formats[1] = compact ? CommonFormat::STus_RGBAub : CommonFormat::STf_RGBAub;
+	cmd.indexMode = TriangleIndexMode::QUADS;
+	cmd.vertexCount = count * 4;
+	cmd.texture = texture;
+
+	Graphics::StreamVertexData data = gfx->requestStreamDraw(cmd);
+
+	// The buffer keeps a copy of its data in client memory.
+	const char *src = (const char *) array_buf->map() + start * sprite_stride;
+
+	Matrix4 t(tm, m);
+
+	if (is2D)
+		t.transformXY((float *) data.stream[0], sizeof(float) * 2, (const float *) src, vertex_stride, cmd.vertexCount);
+	else
+		t.transformXY0((float *) data.stream[0], sizeof(float) * 3, (const float *) src, vertex_stride, cmd.vertexCount);
+
+	if (compact)
+		copyMergedVertices((const XYf_STus_RGBAub *) src, (STus_RGBAub *) data.stream[1], cmd.vertexCount, color_active, gfx->getColor());
+	else
+		copyMergedVertices((const XYf_STf_RGBAub *) src, (STf_RGBAub *) data.stream[1], cmd.vertexCount, color_active, gfx->getColor());
+}
+
+void SpriteBatch::drawInstanced(Graphics *gfx, const Matrix4 &m, int start, int count)
+{
+	using namespace vertex;
+
+	gfx->flushStreamDraws();
+
+	if (Shader::isDefaultActive())
+		Shader::attachDefault(Shader::STANDARD_INSTANCED_SPRITE);
+
+	if (Shader::current)
+		Shader::current->checkMainTexture(texture);
+
+	int transformindex = -1;
+	int positionindex = -1;
+	int texrectindex = -1;
+
+	if (Shader::current)
+	{
+		transformindex = Shader::current->getVertexAttributeIndex("InstanceTransform");
+		positionindex = Shader::current->getVertexAttributeIndex("InstancePosition");
+		texrectindex = Shader::current->getVertexAttributeIndex("InstanceTexRect");
+	}
+
+	if (transformindex < 0 || positionindex < 0)
+		throw love::Exception("Instanced SpriteBatches must be drawn with a vertex shader which uses the InstanceTransform and InstancePosition attributes.");
+
+	array_buf->unmap();
+
+	Attributes attributes;
+	Buffers buffers;
+
+	// Sprites before the draw range are skipped by offsetting the instance
+	// data, since there's no base instance parameter to draw with.
+	size_t instanceoffset = start * sprite_stride;
+	uint16 stride = (uint16) sprite_stride;
+
+	buffers.set(0, array_buf, instanceoffset);
+	buffers.set(1, corner_buf, 0);
+
+	attributes.set(ATTRIB_POS, DATA_FLOAT, 2, 0, sizeof(float) * 2, 1);
+
+	attributes.set(transformindex, DATA_FLOAT, 4, offsetof(InstanceData, transform), stride, 0, STEP_PER_INSTANCE);
+	attributes.set(positionindex, DATA_FLOAT, 2, offsetof(InstanceData, position), stride, 0, STEP_PER_INSTANCE);
+
+	if (texrectindex >= 0)
+		attributes.set(texrectindex, DATA_FLOAT, 4, offsetof(InstanceData, texRect), stride, 0, STEP_PER_INSTANCE);
+
+	if (color_active)
+		attributes.set(ATTRIB_COLOR, DATA_UNORM8, 4, offsetof(InstanceData, color), stride, 0, STEP_PER_INSTANCE);
+
+	int activebuffers = 2;
+
+	for (const auto &it : attached_attributes)
+	{
+		Mesh *mesh = it.second.mesh.get();
+
+		// Attached attributes hold one vertex per sprite here.
+		if (mesh->getVertexCount() < (size_t) next)
+			throw love::Exception("Mesh with attribute '%s' attached to this SpriteBatch has too few vertices", it.first.c_str());
+
+		int attributeindex = -1;
+
+		VertexAttribID builtinattrib;
+		if (vertex::getConstant(it.first.c_str(), builtinattrib))
+			attributeindex = (int) builtinattrib;
+		else if (Shader::current)
+			attributeindex = Shader::current->getVertexAttributeIndex(it.first);
+
+		if (attributeindex >= 0)
+		{
+			mesh->vbo->unmap();
+
+			const auto &formats = mesh->getVertexFormat();
+			const auto &format = formats[it.second.index];
+
+			uint16 offset = (uint16) mesh->getAttributeOffset(it.second.index);
+			uint16 meshstride = (uint16) mesh->getVertexStride();
+
+			attributes.set(attributeindex, format.type, format.components, offset, meshstride, activebuffers, STEP_PER_INSTANCE);
+
+			buffers.set(activebuffers, mesh->vbo, start * meshstride);
+			activebuffers++;
+		}
+	}
+
+	Graphics::TempTransform transform(gfx, m);
+
+	Graphics::DrawCommand cmd(&attributes, &buffers);
+	cmd.primitiveType = PRIMITIVE_TRIANGLE_STRIP;
+	cmd.vertexStart = 0;
+	cmd.vertexCount = 4;
+	cmd.instanceCount = count;
+	cmd.texture = texture;
+	cmd.cacheVertexArray = true;
+
+	gfx->draw(cmd);
 }
 
 } // graphics
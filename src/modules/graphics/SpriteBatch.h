@@ -25,6 +25,7 @@
 
 // C++
 #include <unordered_map>
+#include <vector>
 
 // LOVE
 #include "common/math.h"
@@ -43,6 +44,7 @@ namespace graphics
 class Graphics;
 class Texture;
 class Quad;
+class QuadAtlas;
 class Buffer;
 
 class SpriteBatch : public Drawable
@@ -51,13 +53,34 @@ public:
 
 	static love::Type type;
 
-	SpriteBatch(Graphics *gfx, Texture *texture, int size, vertex::Usage usage);
+	// Layout of each sprite in the packed data given to setSprites.
+	struct SpriteRecord
+	{
+		float x, y;
+		float angle;
+		float sx, sy;
+		float ox, oy;
+		// 1-based index into the Quad list, or 0 to use the whole texture.
+		float quad;
+	};
+
+	SpriteBatch(Graphics *gfx, Texture *texture, int size, vertex::Usage usage, bool instanced = false);
 	virtual ~SpriteBatch();
 
 	int add(const Matrix4 &m, int index = -1);
 	int add(Quad *quad, const Matrix4 &m, int index = -1);
+	int add(QuadAtlas *atlas, int frame, const Matrix4 &m, int index = -1);
 	int addLayer(int layer, const Matrix4 &m, int index = -1);
 	int addLayer(int layer, Quad *quad, const Matrix4 &m, int index = -1);
+	int addLayer(int layer, QuadAtlas *atlas, int frame, const Matrix4 &m, int index = -1);
+
+	/**
+	 * Sets count sprites starting at index start from packed records, growing
+	 * the batch if the range goes past its current end. The quad field of
+	 * each record indexes the quads list, or the frames of the atlas if one
+	 * is given.
+	 **/
+	void setSprites(int start, const SpriteRecord *records, int count, const std::vector<Quad *> &quads, QuadAtlas *atlas = nullptr);
 
 	void clear();
 
@@ -96,6 +119,13 @@ public:
 	 **/
 	int getBufferSize() const;
 
+	/**
+	 * Whether this SpriteBatch stores one compact record per sprite and
+	 * expands it into a quad in the vertex shader, instead of storing four
+	 * transformed vertices.
+	 **/
+	bool isInstanced() const;
+
 	/**
 	 * Attaches a specific vertex attribute from a Mesh to this SpriteBatch.
 	 * The vertex attribute will be used when drawing the SpriteBatch.
@@ -111,12 +141,43 @@ public:
 
 private:
 
+	int addQuad(const Vector2 *positions, const Vector2 *texcoords, int layer, const Matrix4 &m, int index);
+	int addQuadLayer(int layer, const Vector2 *positions, const Vector2 *texcoords, const Matrix4 &m, int index);
+
 	struct AttachedAttribute
 	{
 		StrongRef<Mesh> mesh;
 		int index;
 	};
 
+	// Per-sprite data used by instanced SpriteBatches. The 2x2 part of the
+	// sprite's transform is premultiplied by the quad's size, so the vertex
+	// shader only needs to apply it to a unit square.
+	struct InstanceData
+	{
+		float transform[4];
+		float position[2];
+		float texRect[4];
+		Color color;
+	};
+
+	void drawInstanced(Graphics *gfx, const Matrix4 &m, int start, int count);
+
+	// Small batches are copied into the stream buffer with their transform
+	// applied, so consecutive batches and sprites with the same texture and
+	// shader share a draw call.
+	static const int MAX_MERGED_SPRITES = 256;
+
+	bool canDrawMerged(int count) const;
+	void drawMerged(Graphics *gfx, const Matrix4 &m, int start, int count);
+
+	// Sprites use compact 16-bit texture coordinates until one is added with
+	// coordinates outside [0, 1], which converts the batch to floats.
+	void useFloatTexCoords();
+
+	// Number of vertices each sprite's data covers in attached Meshes.
+	int getVerticesPerSprite() const { return instanced ? 1 : 4; }
+
 	/**
 	 * Sets the total number of sprites this SpriteBatch can hold.
 	 * Leaves existing sprite data intact when possible.
@@ -138,9 +199,17 @@ private:
 
 	vertex::CommonFormat vertex_format;
 	size_t vertex_stride;
+
+	// Size in bytes of the data for a single sprite in array_buf.
+	size_t sprite_stride;
+
+	bool instanced;
 	
 	love::graphics::Buffer *array_buf;
 
+	// The unit square expanded by instanced SpriteBatches.
+	love::graphics::Buffer *corner_buf;
+
 	std::unordered_map<std::string, AttachedAttribute> attached_attributes;
 	
 	int range_start;
@@ -50,8 +50,29 @@ public:
 		{}
 	};
 
+	struct FrameStats
+	{
+		size_t uploadedBytes = 0;
+		int maps = 0;
+
+		// map() calls that had to wait on the GPU, or wrap around and orphan
+		// the buffer.
+		int mapStalls = 0;
+
+		// Time map() spent waiting on fences, in seconds.
+		double mapStallTime = 0.0;
+
+		// Times the buffer ran out of space within the frame, and had to be
+		// orphaned or reallocated.
+		int wraps = 0;
+	};
+
 	virtual ~StreamBuffer() {}
 
+	const FrameStats &getFrameStats() const { return frameStats; }
+	void setFrameStats(const FrameStats &stats) { frameStats = stats; }
+	void resetFrameStats() { frameStats = FrameStats(); }
+
 	size_t getSize() const { return bufferSize; }
 	BufferType getMode() const { return mode; }
 
@@ -69,6 +90,8 @@ protected:
 	size_t bufferSize;
 	BufferType mode;
 
+	FrameStats frameStats;
+
 }; // StreamBuffer
 
 } // graphics
@@ -36,6 +36,7 @@ Text::Text(Font *font, const std::vector<Font::ColoredString> &text)
 	, vbo(nullptr)
 	, vert_offset(0)
 	, texture_cache_id((uint32) -1)
+	, glyph_eviction_id(0)
 {
 	set(text);
 }
@@ -86,6 +87,9 @@ void Text::regenerateVertices()
 	// text's vertices, since glyph texcoords might have changed.
 	if (font->getTextureCacheID() != texture_cache_id)
 	{
+		// Keep the entries from evicting each other's glyphs.
+		Font::GlyphBatch batch(font);
+
 		std::vector<TextData> textdata = text_data;
 
 		clear();
@@ -97,73 +101,209 @@ void Text::regenerateVertices()
 	}
 }
 
-void Text::addTextData(const TextData &t)
+void Text::regenerateEvictedVertices()
 {
-	std::vector<Font::GlyphVertex> vertices;
-	std::vector<Font::DrawCommand> new_commands;
+	// Re-generated entries use glyphs which can't be evicted while the batch
+	// exists, so each entry needs to be re-generated at most once.
+	Font::GlyphBatch batch(font);
+
+	bool regenerated = true;
+
+	while (regenerated)
+	{
+		regenerated = false;
+
+		for (int i = 0; i < (int) text_data.size(); i++)
+		{
+			const TextData &t = text_data[i];
+			if (!font->hasEvictedGlyphs(t.commands, t.evictionID))
+				continue;
+
+			uint32 cacheid = texture_cache_id;
+			replaceTextData(i, t);
+
+			// Everything was re-generated if the texture cache was invalidated.
+			if (cacheid != texture_cache_id)
+				return;
+
+			regenerated = true;
+		}
+	}
 
-	Font::TextInfo text_info;
+	glyph_eviction_id = font->getGlyphEvictionID();
+}
 
+void Text::generateVertices(TextData &t, std::vector<Font::GlyphVertex> &vertices)
+{
 	Colorf constantcolor = Colorf(1.0f, 1.0f, 1.0f, 1.0f);
 
 	// We only have formatted text if the align mode is valid.
 	if (t.align == Font::ALIGN_MAX_ENUM)
-		new_commands = font->generateVertices(t.codepoints, constantcolor, vertices, 0.0f, Vector2(0.0f, 0.0f), &text_info);
+		t.commands = font->generateVertices(t.codepoints, constantcolor, vertices, 0.0f, Vector2(0.0f, 0.0f), &t.text_info);
 	else
-		new_commands = font->generateVerticesFormatted(t.codepoints, constantcolor, t.wrap, t.align, vertices, &text_info);
-
-	if (vertices.empty())
-		return;
+		t.commands = font->generateVerticesFormatted(t.codepoints, constantcolor, t.wrap, t.align, vertices, &t.text_info);
 
-	if (t.use_matrix)
+	if (t.use_matrix && !vertices.empty())
 		t.matrix.transformXY(&vertices[0], &vertices[0], (int) vertices.size());
 
-	size_t voffset = vert_offset;
-
-	if (!t.append_vertices)
-	{
-		voffset = 0;
-		draw_commands.clear();
-		text_data.clear();
-	}
-
-	uploadVertices(vertices, voffset);
+	t.vertexCount = vertices.size();
+	t.evictionID = font->getGlyphEvictionID();
+}
 
-	if (!new_commands.empty())
+void Text::appendDrawCommands(const TextData &t)
+{
+	for (Font::DrawCommand cmd : t.commands)
 	{
-		// The start vertex should be adjusted to account for the vertex offset.
-		for (Font::DrawCommand &cmd : new_commands)
-			cmd.startvertex += (int) voffset;
-
-		auto firstcmd = new_commands.begin();
+		// The start vertex should be adjusted to account for the entry's
+		// location in the vertex buffer.
+		cmd.startvertex += (int) t.vertexStart;
 
-		// If the first draw command in the new list has the same texture as the
-		// last one in the existing list we're building and its vertices are
-		// in-order, we can combine them (saving a draw call.)
+		// If the draw command has the same texture as the last one in the list
+		// we're building and its vertices are in-order, we can combine them
+		// (saving a draw call.)
 		if (!draw_commands.empty())
 		{
-			auto prevcmd = draw_commands.back();
-			if (prevcmd.texture == firstcmd->texture && (prevcmd.startvertex + prevcmd.vertexcount) == firstcmd->startvertex)
+			Font::DrawCommand &prevcmd = draw_commands.back();
+			if (prevcmd.texture == cmd.texture && (prevcmd.startvertex + prevcmd.vertexcount) == cmd.startvertex)
 			{
-				draw_commands.back().vertexcount += firstcmd->vertexcount;
-				++firstcmd;
+				prevcmd.vertexcount += cmd.vertexcount;
+				continue;
 			}
 		}
 
-		// Append the new draw commands to the list we're building.
-		draw_commands.insert(draw_commands.end(), firstcmd, new_commands.end());
+		draw_commands.push_back(cmd);
 	}
+}
+
+void Text::rebuildDrawCommands()
+{
+	draw_commands.clear();
+
+	for (const TextData &t : text_data)
+		appendDrawCommands(t);
+}
+
+void Text::addTextData(const TextData &t)
+{
+	std::vector<Font::GlyphVertex> vertices;
+
+	TextData data = t;
+	generateVertices(data, vertices);
+
+	if (!data.append_vertices)
+	{
+		vert_offset = 0;
+		draw_commands.clear();
+		text_data.clear();
+	}
+
+	data.vertexStart = vert_offset;
+	data.vertexCapacity = data.vertexCount;
 
-	vert_offset = voffset + vertices.size();
+	uploadVertices(vertices, data.vertexStart);
 
-	text_data.push_back(t);
-	text_data.back().text_info = text_info;
+	vert_offset += data.vertexCount;
+
+	text_data.push_back(data);
+	appendDrawCommands(text_data.back());
 
 	// Font::generateVertices can invalidate the font's texture cache.
 	if (font->getTextureCacheID() != texture_cache_id)
 		regenerateVertices();
 }
 
+void Text::replaceTextData(int index, const TextData &t)
+{
+	std::vector<Font::GlyphVertex> vertices;
+
+	TextData data = t;
+	generateVertices(data, vertices);
+
+	TextData &olddata = text_data[index];
+
+	// Reuse the entry's previous range in the vertex buffer if the new
+	// vertices fit in it (or it's at the end of the used part of the buffer),
+	// otherwise move the entry to the end of the buffer.
+	if (data.vertexCount <= olddata.vertexCapacity)
+	{
+		data.vertexStart = olddata.vertexStart;
+		data.vertexCapacity = olddata.vertexCapacity;
+	}
+	else if (olddata.vertexStart + olddata.vertexCapacity == vert_offset)
+	{
+		data.vertexStart = olddata.vertexStart;
+		data.vertexCapacity = data.vertexCount;
+		vert_offset = data.vertexStart + data.vertexCount;
+	}
+	else
+	{
+		data.vertexStart = vert_offset;
+		data.vertexCapacity = data.vertexCount;
+		vert_offset += data.vertexCount;
+	}
+
+	text_data[index] = data;
+
+	// Font::generateVertices can invalidate the font's texture cache, in which
+	// case every entry (including this one) has to be regenerated anyway.
+	if (font->getTextureCacheID() != texture_cache_id)
+		return regenerateVertices();
+
+	uploadVertices(vertices, data.vertexStart);
+
+	rebuildDrawCommands();
+	compactVertices();
+}
+
+void Text::compactVertices()
+{
+	size_t usedverts = 0;
+	for (const TextData &t : text_data)
+		usedverts += t.vertexCount;
+
+	// Only compact once a significant portion of the buffer is unused space
+	// left behind by replaced or removed entries.
+	size_t unusedverts = vert_offset - usedverts;
+	if (vbo == nullptr || unusedverts < 1024 || unusedverts < usedverts)
+		return;
+
+	if (usedverts == 0)
+	{
+		for (TextData &t : text_data)
+			t.vertexStart = t.vertexCapacity = 0;
+
+		vert_offset = 0;
+		return;
+	}
+
+	const size_t stride = sizeof(Font::GlyphVertex);
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	Buffer *new_vbo = gfx->newBuffer(size_t(usedverts * stride * 1.5), nullptr, BUFFER_VERTEX, vertex::USAGE_DYNAMIC, 0);
+
+	// The vertices of every entry are still valid, so they can be copied
+	// directly rather than re-generated.
+	size_t voffset = 0;
+	for (TextData &t : text_data)
+	{
+		if (t.vertexCount > 0)
+			vbo->copyTo(t.vertexStart * stride, t.vertexCount * stride, new_vbo, voffset * stride);
+
+		t.vertexStart = voffset;
+		t.vertexCapacity = t.vertexCount;
+		voffset += t.vertexCount;
+	}
+
+	delete vbo;
+	vbo = new_vbo;
+
+	vertexBuffers.set(0, vbo, 0);
+
+	vert_offset = voffset;
+
+	rebuildDrawCommands();
+}
+
 void Text::set(const std::vector<Font::ColoredString> &text)
 {
 	return set(text, -1.0f, Font::ALIGN_MAX_ENUM);
@@ -195,11 +335,48 @@ int Text::addf(const std::vector<Font::ColoredString> &text, float wrap, Font::A
 	return (int) text_data.size() - 1;
 }
 
+void Text::replace(int index, const std::vector<Font::ColoredString> &text, const Matrix4 &m)
+{
+	replacef(index, text, -1.0f, Font::ALIGN_MAX_ENUM, m);
+}
+
+void Text::replacef(int index, const std::vector<Font::ColoredString> &text, float wrap, Font::AlignMode align, const Matrix4 &m)
+{
+	if (index < 0 || index >= (int) text_data.size())
+		throw love::Exception("Invalid text index: %d", index + 1);
+
+	Font::ColoredCodepoints codepoints;
+	Font::getCodepointsFromString(text, codepoints);
+
+	replaceTextData(index, {codepoints, wrap, align, {}, true, true, m});
+}
+
+void Text::remove(int index)
+{
+	if (index < 0 || index >= (int) text_data.size())
+		throw love::Exception("Invalid text index: %d", index + 1);
+
+	// The entry's vertices are left in the buffer until it gets compacted.
+	text_data.erase(text_data.begin() + index);
+
+	if (text_data.empty())
+		return clear();
+
+	rebuildDrawCommands();
+	compactVertices();
+}
+
+int Text::getCount() const
+{
+	return (int) text_data.size();
+}
+
 void Text::clear()
 {
 	text_data.clear();
 	draw_commands.clear();
 	texture_cache_id = font->getTextureCacheID();
+	glyph_eviction_id = font->getGlyphEvictionID();
 	vert_offset = 0;
 }
 
@@ -248,14 +425,19 @@ void Text::draw(Graphics *gfx, const Matrix4 &m)
 	gfx->flushStreamDraws();
 
 	if (Shader::isDefaultActive())
-		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+		Shader::attachDefault(font->isDistanceField() ? Shader::STANDARD_DISTANCE_FIELD : Shader::STANDARD_DEFAULT);
 
 	if (Shader::current)
 		Shader::current->checkMainTextureType(TEXTURE_2D, false);
 
-	// Re-generate the text if the Font's texture cache was invalidated.
+	// Re-generate the text if the Font's texture cache was invalidated, or
+	// only the affected entries if some of its glyphs were evicted.
 	if (font->getTextureCacheID() != texture_cache_id)
 		regenerateVertices();
+	else if (font->getGlyphEvictionID() != glyph_eviction_id)
+		regenerateEvictedVertices();
+
+	font->markTexturesUsed(draw_commands);
 
 	int totalverts = 0;
 	for (const Font::DrawCommand &cmd : draw_commands)
@@ -266,7 +448,7 @@ void Text::draw(Graphics *gfx, const Matrix4 &m)
 	Graphics::TempTransform transform(gfx, m);
 
 	for (const Font::DrawCommand &cmd : draw_commands)
-		gfx->drawQuads(cmd.startvertex / 4, cmd.vertexcount / 4, vertexAttributes, vertexBuffers, cmd.texture);
+		gfx->drawQuads(cmd.startvertex / 4, cmd.vertexcount / 4, vertexAttributes, vertexBuffers, cmd.texture, true);
 }
 
 } // graphics
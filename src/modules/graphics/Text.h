@@ -48,6 +48,24 @@ public:
 	int add(const std::vector<Font::ColoredString> &text, const Matrix4 &m);
 	int addf(const std::vector<Font::ColoredString> &text, float wrap, Font::AlignMode align, const Matrix4 &m);
 
+	/**
+	 * Replaces the text at the given index (as returned by add/addf.) Only the
+	 * vertices of that entry are re-generated and re-uploaded.
+	 **/
+	void replace(int index, const std::vector<Font::ColoredString> &text, const Matrix4 &m);
+	void replacef(int index, const std::vector<Font::ColoredString> &text, float wrap, Font::AlignMode align, const Matrix4 &m);
+
+	/**
+	 * Removes the text at the given index. The indices of any subsequent text
+	 * entries are shifted down by one.
+	 **/
+	void remove(int index);
+
+	/**
+	 * Gets the number of separately added text entries.
+	 **/
+	int getCount() const;
+
 	void clear();
 
 	void setFont(Font *f);
@@ -77,11 +95,29 @@ private:
 		bool use_matrix;
 		bool append_vertices;
 		Matrix4 matrix;
+
+		// Draw commands with start vertices relative to vertexStart.
+		std::vector<Font::DrawCommand> commands;
+
+		// Range of this entry in the vertex buffer. The capacity can be bigger
+		// than the vertex count if the entry was replaced with shorter text.
+		size_t vertexStart;
+		size_t vertexCount;
+		size_t vertexCapacity;
+
+		// The font's glyph eviction ID when the vertices were generated.
+		uint32 evictionID;
 	};
 
 	void uploadVertices(const std::vector<Font::GlyphVertex> &vertices, size_t vertoffset);
 	void regenerateVertices();
+	void regenerateEvictedVertices();
+	void generateVertices(TextData &t, std::vector<Font::GlyphVertex> &vertices);
+	void appendDrawCommands(const TextData &t);
+	void rebuildDrawCommands();
+	void compactVertices();
 	void addTextData(const TextData &s);
+	void replaceTextData(int index, const TextData &t);
 
 	StrongRef<Font> font;
 
@@ -98,6 +134,10 @@ private:
 	
 	// Used so we know when the font's texture cache is invalidated.
 	uint32 texture_cache_id;
+
+	// Used so we know when glyphs might have been evicted from the font's
+	// texture pages.
+	uint32 glyph_eviction_id;
 	
 }; // Text
 
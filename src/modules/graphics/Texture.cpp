@@ -39,6 +39,7 @@ Texture::Filter Texture::defaultFilter;
 Texture::FilterMode Texture::defaultMipmapFilter = Texture::FILTER_LINEAR;
 float Texture::defaultMipmapSharpness = 0.0f;
 int64 Texture::totalGraphicsMemory = 0;
+uint32 Texture::usageFrame = 0;
 
 Texture::Texture(TextureType texType)
 	: texType(texType)
@@ -55,6 +56,13 @@ Texture::Texture(TextureType texType)
 	, wrap()
 	, mipmapSharpness(defaultMipmapSharpness)
 	, graphicsMemorySize(0)
+	, atlasTexture(nullptr)
+	, atlasOffset(0.0f, 0.0f)
+	, atlasScale(1.0f, 1.0f)
+	, arrayTexture(nullptr)
+	, arrayLayer(0)
+	, lastUsedFrame(usageFrame)
+	, hasPendingUpdates(false)
 {
 }
 
@@ -63,6 +71,29 @@ Texture::~Texture()
 	setGraphicsMemorySize(0);
 }
 
+void Texture::markUsed()
+{
+	lastUsedFrame = usageFrame;
+
+	if (hasPendingUpdates)
+		flushPendingUpdates();
+}
+
+uint32 Texture::getLastUsedFrame() const
+{
+	return lastUsedFrame;
+}
+
+void Texture::advanceUsageFrame()
+{
+	usageFrame++;
+}
+
+uint32 Texture::getUsageFrame()
+{
+	return usageFrame;
+}
+
 void Texture::initQuad()
 {
 	Quad::Viewport v = {0, 0, (double) width, (double) height};
@@ -76,6 +107,13 @@ void Texture::setGraphicsMemorySize(int64 bytes)
 	bytes = std::max(bytes, (int64) 0);
 	graphicsMemorySize = bytes;
 	totalGraphicsMemory += bytes;
+
+	setNativeMemorySize(type, bytes);
+}
+
+int64 Texture::getGraphicsMemorySize() const
+{
+	return graphicsMemorySize;
 }
 
 TextureType Texture::getTextureType() const
@@ -115,7 +153,18 @@ void Texture::draw(Graphics *gfx, const Matrix4 &m)
 	draw(gfx, quad, m);
 }
 
-void Texture::draw(Graphics *gfx, Quad *q, const Matrix4 &localTransform)
+void Texture::draw(Graphics *gfx, Quad *q, const Matrix4 &m)
+{
+	drawQuad(gfx, q->getVertexPositions(), q->getVertexTexCoords(), q->getLayer(), m);
+}
+
+void Texture::draw(Graphics *gfx, QuadAtlas *atlas, int frame, const Matrix4 &m)
+{
+	atlas->checkIndex(frame);
+	drawQuad(gfx, atlas->getVertexPositions(frame), atlas->getVertexTexCoords(frame), atlas->getLayer(frame), m);
+}
+
+void Texture::drawQuad(Graphics *gfx, const Vector2 *positions, const Vector2 *texcoords, int layer, const Matrix4 &localTransform)
 {
 	using namespace vertex;
 
@@ -124,39 +173,80 @@ void Texture::draw(Graphics *gfx, Quad *q, const Matrix4 &localTransform)
 
 	if (texType == TEXTURE_2D_ARRAY)
 	{
-		drawLayer(gfx, q->getLayer(), q, localTransform);
+		drawQuadLayer(gfx, layer, positions, texcoords, localTransform);
+		return;
+	}
+
+	// Layers of a shared array texture use its filter and wrap modes, so
+	// textures which don't match are drawn directly.
+	if (arrayTexture != nullptr && filter.min == arrayTexture->filter.min
+		&& filter.mag == arrayTexture->filter.mag && wrap.s == arrayTexture->wrap.s
+		&& wrap.t == arrayTexture->wrap.t)
+	{
+		arrayTexture->drawQuadLayer(gfx, arrayLayer, positions, texcoords, localTransform);
 		return;
 	}
 
 	const Matrix4 &tm = gfx->getTransform();
 	bool is2D = tm.isAffine2DTransform();
 
+	// Atlas regions can't reproduce repeating wrap modes, so those textures
+	// are always drawn directly.
+	bool atlased = atlasTexture != nullptr && wrap.s == WRAP_CLAMP && wrap.t == WRAP_CLAMP;
+
+	Vector2 st[4];
+	bool compact = true;
+
+	for (int i = 0; i < 4; i++)
+	{
+		st[i] = texcoords[i];
+		if (atlased)
+		{
+			st[i].x = atlasOffset.x + texcoords[i].x * atlasScale.x;
+			st[i].y = atlasOffset.y + texcoords[i].y * atlasScale.y;
+		}
+
+		compact = compact && isUnormTexCoord(st[i].x, st[i].y);
+	}
+
+	// Repeating texture coordinates need the full float format.
 	Graphics::StreamDrawCommand cmd;
 	cmd.formats[0] = vertex::getSinglePositionFormat(is2D);
-	cmd.formats[1] = CommonFormat::STf_RGBAub;
+	cmd.formats[1] = compact ? CommonFormat::STus_RGBAub : CommonFormat::STf_RGBAub;
 	cmd.indexMode = TriangleIndexMode::QUADS;
 	cmd.vertexCount = 4;
-	cmd.texture = this;
+	cmd.texture = atlased ? atlasTexture : this;
 
 	Graphics::StreamVertexData data = gfx->requestStreamDraw(cmd);
 
 	Matrix4 t(tm, localTransform);
 
 	if (is2D)
-		t.transformXY((Vector2 *) data.stream[0], q->getVertexPositions(), 4);
+		t.transformXY((Vector2 *) data.stream[0], positions, 4);
 	else
-		t.transformXY0((Vector3 *) data.stream[0], q->getVertexPositions(), 4);
-
-	const Vector2 *texcoords = q->getVertexTexCoords();
-	vertex::STf_RGBAub *vertexdata = (vertex::STf_RGBAub *) data.stream[1];
+		t.transformXY0((Vector3 *) data.stream[0], positions, 4);
 
 	Color c = toColor(gfx->getColor());
 
-	for (int i = 0; i < 4; i++)
+	if (compact)
 	{
-		vertexdata[i].s = texcoords[i].x;
-		vertexdata[i].t = texcoords[i].y;
-		vertexdata[i].color = c;
+		vertex::STus_RGBAub *vertexdata = (vertex::STus_RGBAub *) data.stream[1];
+		for (int i = 0; i < 4; i++)
+		{
+			vertexdata[i].s = packUnormTexCoord(st[i].x);
+			vertexdata[i].t = packUnormTexCoord(st[i].y);
+			vertexdata[i].color = c;
+		}
+	}
+	else
+	{
+		vertex::STf_RGBAub *vertexdata = (vertex::STf_RGBAub *) data.stream[1];
+		for (int i = 0; i < 4; i++)
+		{
+			vertexdata[i].s = st[i].x;
+			vertexdata[i].t = st[i].y;
+			vertexdata[i].color = c;
+		}
 	}
 }
 
@@ -166,6 +256,17 @@ void Texture::drawLayer(Graphics *gfx, int layer, const Matrix4 &m)
 }
 
 void Texture::drawLayer(Graphics *gfx, int layer, Quad *q, const Matrix4 &m)
+{
+	drawQuadLayer(gfx, layer, q->getVertexPositions(), q->getVertexTexCoords(), m);
+}
+
+void Texture::drawLayer(Graphics *gfx, int layer, QuadAtlas *atlas, int frame, const Matrix4 &m)
+{
+	atlas->checkIndex(frame);
+	drawQuadLayer(gfx, layer, atlas->getVertexPositions(frame), atlas->getVertexTexCoords(frame), m);
+}
+
+void Texture::drawQuadLayer(Graphics *gfx, int layer, const Vector2 *positions, const Vector2 *texcoords, const Matrix4 &m)
 {
 	using namespace vertex;
 
@@ -196,11 +297,10 @@ void Texture::drawLayer(Graphics *gfx, int layer, Quad *q, const Matrix4 &m)
 	Graphics::StreamVertexData data = gfx->requestStreamDraw(cmd);
 
 	if (is2D)
-		t.transformXY((Vector2 *) data.stream[0], q->getVertexPositions(), 4);
+		t.transformXY((Vector2 *) data.stream[0], positions, 4);
 	else
-		t.transformXY0((Vector3 *) data.stream[0], q->getVertexPositions(), 4);
+		t.transformXY0((Vector3 *) data.stream[0], positions, 4);
 
-	const Vector2 *texcoords = q->getVertexTexCoords();
 	vertex::STPf_RGBAub *vertexdata = (vertex::STPf_RGBAub *) data.stream[1];
 
 	for (int i = 0; i < 4; i++)
@@ -298,6 +398,52 @@ Quad *Texture::getQuad() const
 	return quad;
 }
 
+void Texture::setAtlasRegion(Texture *atlas, const Rect &region)
+{
+	if (atlas == nullptr && atlasTexture == nullptr)
+		return;
+
+	// Draws already in the batch were generated with the old region.
+	Graphics::flushStreamDrawsGlobal();
+
+	atlasTexture = atlas;
+
+	if (atlas != nullptr)
+	{
+		float aw = (float) atlas->getPixelWidth();
+		float ah = (float) atlas->getPixelHeight();
+
+		atlasOffset = Vector2((float) region.x / aw, (float) region.y / ah);
+		atlasScale = Vector2((float) region.w / aw, (float) region.h / ah);
+	}
+	else
+	{
+		atlasOffset = Vector2(0.0f, 0.0f);
+		atlasScale = Vector2(1.0f, 1.0f);
+	}
+}
+
+Texture *Texture::getAtlasTexture() const
+{
+	return atlasTexture;
+}
+
+void Texture::setArrayLayer(Texture *array, int layer)
+{
+	arrayTexture = array;
+	arrayLayer = array != nullptr ? layer : 0;
+}
+
+Texture *Texture::getArrayTexture() const
+{
+	return arrayTexture;
+}
+
+int Texture::getArrayLayer() const
+{
+	return arrayLayer;
+}
+
 bool Texture::validateFilter(const Filter &f, bool mipmapsAllowed)
 {
 	if (!mipmapsAllowed && f.mipmap != FILTER_NONE)
@@ -30,6 +30,7 @@
 #include "common/int.h"
 #include "Drawable.h"
 #include "Quad.h"
+#include "QuadAtlas.h"
 #include "vertex.h"
 #include "depthstencil.h"
 #include "Resource.h"
@@ -110,10 +111,12 @@ public:
 	/**
 	 * Draws the texture using the specified transformation with a Quad applied.
 	 **/
-	virtual void draw(Graphics *gfx, Quad *quad, const Matrix4 &m);
+	void draw(Graphics *gfx, Quad *quad, const Matrix4 &m);
+	void draw(Graphics *gfx, QuadAtlas *atlas, int frame, const Matrix4 &m);
 
 	void drawLayer(Graphics *gfx, int layer, const Matrix4 &m);
-	virtual void drawLayer(Graphics *gfx, int layer, Quad *quad, const Matrix4 &m);
+	void drawLayer(Graphics *gfx, int layer, Quad *quad, const Matrix4 &m);
+	void drawLayer(Graphics *gfx, int layer, QuadAtlas *atlas, int frame, const Matrix4 &m);
 
 	TextureType getTextureType() const;
 	PixelFormat getPixelFormat() const;
@@ -133,6 +136,8 @@ public:
 
 	float getDPIScale() const;
 
+	int64 getGraphicsMemorySize() const;
+
 	virtual void setFilter(const Filter &f);
 	virtual const Filter &getFilter() const;
 
@@ -148,6 +153,35 @@ public:
 
 	Quad *getQuad() const;
 
+	/**
+	 * Redirects draws of this texture to a region (in pixels) of another
+	 * texture. Used by TextureAtlas. A null atlas makes draws use this texture
+	 * directly again.
+	 **/
+	void setAtlasRegion(Texture *atlas, const Rect &region);
+	Texture *getAtlasTexture() const;
+
+	/**
+	 * Redirects draws of this texture to a layer of an array texture with the
+	 * same dimensions. Used by TextureArrayBin. A null array makes draws use
+	 * this texture directly again.
+	 **/
+	void setArrayLayer(Texture *array, int layer);
+	Texture *getArrayTexture() const;
+	int getArrayLayer() const;
+
+	/**
+	 * Records that the texture is used for drawing in the current frame.
+	 * Recently used textures are reloaded first after the graphics context is
+	 * lost. Pending updates (see flushPendingUpdates) are applied first.
+	 **/
+	void markUsed();
+	uint32 getLastUsedFrame() const;
+
+	// Called once per frame.
+	static void advanceUsageFrame();
+	static uint32 getUsageFrame();
+
 	static bool validateFilter(const Filter &f, bool mipmapsAllowed);
 
 	static int getTotalMipmapCount(int w, int h);
@@ -167,9 +201,18 @@ public:
 
 protected:
 
+	// The four vertices of a Quad or QuadAtlas frame. The layer is only used
+	// by array textures.
+	virtual void drawQuad(Graphics *gfx, const Vector2 *positions, const Vector2 *texcoords, int layer, const Matrix4 &m);
+	virtual void drawQuadLayer(Graphics *gfx, int layer, const Vector2 *positions, const Vector2 *texcoords, const Matrix4 &m);
+
 	void initQuad();
 	void setGraphicsMemorySize(int64 size);
 
+	// Applies updates which were deferred until the texture is next used.
+	// Only called while hasPendingUpdates is set.
+	virtual void flushPendingUpdates() {}
+
 	bool validateDimensions(bool throwException) const;
 
 	TextureType texType;
@@ -198,6 +241,22 @@ protected:
 
 	int64 graphicsMemorySize;
 
+	// Owned by the TextureAtlas this texture was added to, which clears it
+	// before releasing the atlas texture.
+	Texture *atlasTexture;
+	Vector2 atlasOffset;
+	Vector2 atlasScale;
+
+	// Owned by the TextureArrayBin this texture was added to.
+	Texture *arrayTexture;
+	int arrayLayer;
+
+	uint32 lastUsedFrame;
+
+	bool hasPendingUpdates;
+
+	static uint32 usageFrame;
+
 private:
 
 	static StringMap<TextureType, TEXTURE_MAX_ENUM>::Entry texTypeEntries[];
@@ -0,0 +1,201 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "TextureArrayBin.h"
+#include "Graphics.h"
+#include "image/Image.h"
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type TextureArrayBin::type("TextureArrayBin", &Object::type);
+
+TextureArrayBin::TextureArrayBin(Graphics *gfx, int width, int height, int layers, PixelFormat format, bool linear)
+	: imageCount(0)
+{
+	auto imagemodule = Module::getInstance<love::image::Image>(Module::M_IMAGE);
+	if (imagemodule == nullptr)
+		throw love::Exception("Image module has not been loaded.");
+
+	const Graphics::Capabilities &caps = gfx->getCapabilities();
+
+	if (!caps.textureTypes[TEXTURE_2D_ARRAY])
+		throw love::Exception("Array textures are not supported on this system.");
+
+	int maxsize = (int) caps.limits[Graphics::LIMIT_TEXTURE_SIZE];
+	if (width <= 0 || height <= 0 || width > maxsize || height > maxsize)
+		throw love::Exception("Invalid texture array bin dimensions %dx%d (maximum is %d).", width, height, maxsize);
+
+	int maxlayers = (int) caps.limits[Graphics::LIMIT_TEXTURE_LAYERS];
+	if (layers <= 0 || layers > maxlayers)
+		throw love::Exception("Invalid texture array bin layer count %d (maximum is %d).", layers, maxlayers);
+
+	if (isPixelFormatCompressed(format))
+		throw love::Exception("Texture array bins cannot use compressed pixel formats.");
+
+	// All free layers share the same empty ImageData.
+	emptyData.set(imagemodule->newImageData(width, height, format), Acquire::NORETAIN);
+
+	Image::Slices slices(TEXTURE_2D_ARRAY);
+	for (int i = 0; i < layers; i++)
+		slices.set(i, 0, emptyData);
+
+	Image::Settings settings;
+	settings.linear = linear;
+
+	texture.set(gfx->newImage(slices, settings), Acquire::NORETAIN);
+
+	images.resize(layers);
+}
+
+TextureArrayBin::~TextureArrayBin()
+{
+	for (const StrongRef<Image> &img : images)
+	{
+		if (img.get() != nullptr)
+			img->setArrayLayer(nullptr, 0);
+	}
+}
+
+bool TextureArrayBin::isCompatible(Image *image, bool throwException) const
+{
+	const char *err = nullptr;
+
+	if (image == texture.get())
+		err = "A texture array bin cannot contain its own texture.";
+	else if (image->getArrayTexture() != nullptr && image->getArrayTexture() != texture.get())
+		err = "The Image has already been added to a different texture array bin.";
+	else if (image->getAtlasTexture() != nullptr)
+		err = "Images in a texture atlas cannot be added to a texture array bin.";
+	else if (image->getTextureType() != TEXTURE_2D)
+		err = "Only 2D Images can be added to a texture array bin.";
+	else if (image->getPixelFormat() != texture->getPixelFormat())
+		err = "The Image's pixel format must match the texture array bin's pixel format.";
+	else if (image->getPixelWidth() != texture->getPixelWidth() || image->getPixelHeight() != texture->getPixelHeight())
+		err = "The Image's pixel dimensions must match the texture array bin's dimensions.";
+	else if (image->getMipmapsType() != Image::MIPMAPS_NONE)
+		err = "Images with mipmaps cannot be added to a texture array bin.";
+	else if (image->isFormatLinear() != texture->isFormatLinear())
+		err = "The Image's linear setting must match the texture array bin's linear setting.";
+	else if (image->getImageData(0, 0) == nullptr)
+		err = "The Image does not store its ImageData.";
+
+	if (err != nullptr && throwException)
+		throw love::Exception("%s", err);
+
+	return err == nullptr;
+}
+
+bool TextureArrayBin::add(Image *image)
+{
+	isCompatible(image, true);
+
+	if (contains(image))
+		return true;
+
+	for (int i = 0; i < (int) images.size(); i++)
+	{
+		if (images[i].get() != nullptr)
+			continue;
+
+		texture->replacePixels(image->getImageData(0, 0), i, 0, 0, 0, false);
+
+		images[i].set(image);
+		imageCount++;
+
+		image->setArrayLayer(texture, i);
+		return true;
+	}
+
+	return false;
+}
+
+void TextureArrayBin::remove(Image *image)
+{
+	for (int i = 0; i < (int) images.size(); i++)
+	{
+		if (images[i].get() == image)
+		{
+			removeLayer(i);
+			return;
+		}
+	}
+}
+
+bool TextureArrayBin::contains(Image *image) const
+{
+	return image->getArrayTexture() == texture.get();
+}
+
+void TextureArrayBin::clear()
+{
+	for (int i = 0; i < (int) images.size(); i++)
+	{
+		if (images[i].get() != nullptr)
+			removeLayer(i);
+	}
+}
+
+int TextureArrayBin::removeUnreferenced()
+{
+	int count = 0;
+
+	for (int i = 0; i < (int) images.size(); i++)
+	{
+		if (images[i].get() != nullptr && images[i]->getReferenceCount() == 1)
+		{
+			removeLayer(i);
+			count++;
+		}
+	}
+
+	return count;
+}
+
+void TextureArrayBin::removeLayer(int layer)
+{
+	images[layer]->setArrayLayer(nullptr, 0);
+	images[layer].set(nullptr);
+	imageCount--;
+
+	// Drop the layer's reference to the Image's data.
+	texture->replacePixels(emptyData, layer, 0, 0, 0, false);
+}
+
+Image *TextureArrayBin::getTexture() const
+{
+	return texture.get();
+}
+
+int TextureArrayBin::getImageCount() const
+{
+	return imageCount;
+}
+
+int TextureArrayBin::getLayerCount() const
+{
+	return (int) images.size();
+}
+
+} // graphics
+} // love
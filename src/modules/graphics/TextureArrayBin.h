@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/Object.h"
+#include "common/pixelformat.h"
+#include "image/ImageData.h"
+#include "Image.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+class Graphics;
+
+/**
+ * Stores Images of the same size and pixel format as layers of one shared
+ * array texture. Draws of an Image in a bin are remapped to its layer of the
+ * array texture, so consecutive draws of different binned Images don't break
+ * the stream draw batch.
+ *
+ * The layers of the array texture reference the ImageData of their Images,
+ * so the bin doesn't need its own CPU-side copy to survive a context reload.
+ **/
+class TextureArrayBin : public Object
+{
+public:
+
+	static love::Type type;
+
+	TextureArrayBin(Graphics *gfx, int width, int height, int layers, PixelFormat format, bool linear);
+	virtual ~TextureArrayBin();
+
+	/**
+	 * Stores the Image in a free layer of the bin. Returns false if all layers
+	 * are in use.
+	 **/
+	bool add(Image *image);
+	void remove(Image *image);
+	bool contains(Image *image) const;
+
+	void clear();
+
+	/**
+	 * Removes Images which are only referenced by the bin. Returns the number
+	 * of removed Images.
+	 **/
+	int removeUnreferenced();
+
+	Image *getTexture() const;
+	int getImageCount() const;
+	int getLayerCount() const;
+
+	/**
+	 * Whether the Image can be stored in this bin at all (ignoring the free
+	 * layers). Throws with the reason if throwException is true.
+	 **/
+	bool isCompatible(Image *image, bool throwException) const;
+
+private:
+
+	void removeLayer(int layer);
+
+	StrongRef<Image> texture;
+
+	// Contents of unused layers.
+	StrongRef<love::image::ImageData> emptyData;
+
+	// One entry per layer, null for free layers.
+	std::vector<StrongRef<Image>> images;
+	int imageCount;
+
+}; // TextureArrayBin
+
+} // graphics
+} // love
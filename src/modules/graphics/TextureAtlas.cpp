@@ -0,0 +1,249 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "TextureAtlas.h"
+#include "Graphics.h"
+#include "image/Image.h"
+
+// C++
+#include <algorithm>
+#include <cstring>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type TextureAtlas::type("TextureAtlas", &Object::type);
+
+TextureAtlas::TextureAtlas(Graphics *gfx, int size, PixelFormat format, bool linear)
+	: size(size)
+{
+	auto imagemodule = Module::getInstance<love::image::Image>(Module::M_IMAGE);
+	if (imagemodule == nullptr)
+		throw love::Exception("Image module has not been loaded.");
+
+	int maxsize = (int) gfx->getCapabilities().limits[Graphics::LIMIT_TEXTURE_SIZE];
+	if (size <= 0 || size > maxsize)
+		throw love::Exception("Invalid texture atlas size %d (maximum is %d).", size, maxsize);
+
+	if (isPixelFormatCompressed(format))
+		throw love::Exception("Texture atlases cannot use compressed pixel formats.");
+
+	textureData.set(imagemodule->newImageData(size, size, format), Acquire::NORETAIN);
+
+	Image::Slices slices(TEXTURE_2D);
+	slices.set(0, 0, textureData);
+
+	Image::Settings settings;
+	settings.linear = linear;
+
+	texture.set(gfx->newImage(slices, settings), Acquire::NORETAIN);
+}
+
+TextureAtlas::~TextureAtlas()
+{
+	clear();
+}
+
+bool TextureAtlas::isCompatible(Image *image, bool throwException) const
+{
+	const char *err = nullptr;
+
+	if (image == texture.get())
+		err = "A texture atlas cannot contain its own texture.";
+	else if (image->getAtlasTexture() != nullptr && image->getAtlasTexture() != texture.get())
+		err = "The Image has already been added to a different texture atlas.";
+	else if (image->getArrayTexture() != nullptr)
+		err = "Images in a texture array bin cannot be added to a texture atlas.";
+	else if (image->getTextureType() != TEXTURE_2D)
+		err = "Only 2D Images can be added to a texture atlas.";
+	else if (image->getPixelFormat() != texture->getPixelFormat())
+		err = "The Image's pixel format must match the texture atlas' pixel format.";
+	else if (image->getMipmapsType() != Image::MIPMAPS_NONE)
+		err = "Images with mipmaps cannot be added to a texture atlas.";
+	else if (image->isFormatLinear() != texture->isFormatLinear())
+		err = "The Image's linear setting must match the texture atlas' linear setting.";
+	else if (image->getImageData(0, 0) == nullptr)
+		err = "The Image does not store its ImageData.";
+	else if (image->getPixelWidth() + PADDING * 2 > size || image->getPixelHeight() + PADDING * 2 > size)
+		err = "The Image is too large for the texture atlas.";
+
+	if (err != nullptr && throwException)
+		throw love::Exception("%s", err);
+
+	return err == nullptr;
+}
+
+bool TextureAtlas::add(Image *image)
+{
+	isCompatible(image, true);
+
+	if (contains(image))
+		return true;
+
+	int w = image->getPixelWidth();
+	int h = image->getPixelHeight();
+
+	Rect rect;
+	if (!pack(w + PADDING * 2, h + PADDING * 2, rect))
+		return false;
+
+	upload(image, rect);
+
+	images.push_back(image);
+
+	Rect region = {rect.x + PADDING, rect.y + PADDING, w, h};
+	image->setAtlasRegion(texture, region);
+
+	return true;
+}
+
+void TextureAtlas::remove(Image *image)
+{
+	for (auto it = images.begin(); it != images.end(); ++it)
+	{
+		if (it->get() == image)
+		{
+			image->setAtlasRegion(nullptr, Rect());
+			images.erase(it);
+			return;
+		}
+	}
+}
+
+bool TextureAtlas::contains(Image *image) const
+{
+	for (const StrongRef<Image> &img : images)
+	{
+		if (img.get() == image)
+			return true;
+	}
+
+	return false;
+}
+
+void TextureAtlas::clear()
+{
+	for (const StrongRef<Image> &img : images)
+		img->setAtlasRegion(nullptr, Rect());
+
+	images.clear();
+	shelves.clear();
+}
+
+Image *TextureAtlas::getTexture() const
+{
+	return texture.get();
+}
+
+int TextureAtlas::getImageCount() const
+{
+	return (int) images.size();
+}
+
+int TextureAtlas::getSize() const
+{
+	return size;
+}
+
+bool TextureAtlas::pack(int w, int h, Rect &rect)
+{
+	// Simple shelf packer: use the shortest existing shelf the rectangle fits
+	// on, otherwise start a new shelf below the last one.
+	Shelf *best = nullptr;
+
+	for (Shelf &shelf : shelves)
+	{
+		if (h <= shelf.height && shelf.x + w <= size && (best == nullptr || shelf.height < best->height))
+			best = &shelf;
+	}
+
+	if (best != nullptr)
+	{
+		rect = {best->x, best->y, w, h};
+		best->x += w;
+		return true;
+	}
+
+	int y = shelves.empty() ? 0 : shelves.back().y + shelves.back().height;
+
+	if (y + h > size || w > size)
+		return false;
+
+	Shelf shelf = {y, h, w};
+	shelves.push_back(shelf);
+
+	rect = {0, y, w, h};
+	return true;
+}
+
+void TextureAtlas::upload(Image *image, const Rect &rect)
+{
+	love::image::ImageDataBase *src = image->getImageData(0, 0);
+
+	size_t pixelsize = getPixelFormatSize(texture->getPixelFormat());
+	int srcw = src->getWidth();
+	int srch = src->getHeight();
+
+	std::vector<uint8> pixels(rect.w * rect.h * pixelsize);
+
+	{
+		// Uncompressed Images are always backed by an ImageData, which needs
+		// to be locked while its pixels are read.
+		auto srcdata = dynamic_cast<love::image::ImageData *>(src);
+		love::thread::EmptyLock lock;
+		if (srcdata != nullptr)
+			lock.setLock(srcdata->getMutex());
+
+		const uint8 *srcpixels = (const uint8 *) src->getData();
+
+		// Copy the Image into the middle of the rectangle and extrude its edge
+		// pixels into the padding.
+		for (int y = 0; y < rect.h; y++)
+		{
+			int sy = std::min(std::max(y - PADDING, 0), srch - 1);
+			uint8 *row = &pixels[y * rect.w * pixelsize];
+
+			for (int x = 0; x < rect.w; x++)
+			{
+				int sx = std::min(std::max(x - PADDING, 0), srcw - 1);
+				memcpy(row + x * pixelsize, srcpixels + (sy * srcw + sx) * pixelsize, pixelsize);
+			}
+		}
+	}
+
+	{
+		// Keep the CPU-side copy in sync so the atlas can be reloaded.
+		love::thread::Lock lock(textureData->getMutex());
+
+		uint8 *dst = (uint8 *) textureData->getData();
+		size_t rowsize = rect.w * pixelsize;
+
+		for (int y = 0; y < rect.h; y++)
+			memcpy(dst + ((rect.y + y) * size + rect.x) * pixelsize, &pixels[y * rowsize], rowsize);
+	}
+
+	texture->replacePixels(pixels.data(), pixels.size(), 0, 0, rect, false);
+}
+
+} // graphics
+} // love
@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/Object.h"
+#include "common/math.h"
+#include "common/pixelformat.h"
+#include "image/ImageData.h"
+#include "Image.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+class Graphics;
+
+/**
+ * Packs small Images into one shared texture. Draws of an Image that has been
+ * added to an atlas are remapped to the atlas texture, so consecutive draws of
+ * different atlased Images don't break the stream draw batch.
+ *
+ * The atlas keeps a CPU-side copy of its contents so they survive a context
+ * reload. Removing an Image doesn't free its space in the atlas until clear()
+ * is called.
+ **/
+class TextureAtlas : public Object
+{
+public:
+
+	static love::Type type;
+
+	TextureAtlas(Graphics *gfx, int size, PixelFormat format, bool linear);
+	virtual ~TextureAtlas();
+
+	/**
+	 * Packs the Image into the atlas. Returns false if the Image doesn't fit
+	 * in the remaining space.
+	 **/
+	bool add(Image *image);
+	void remove(Image *image);
+	bool contains(Image *image) const;
+
+	void clear();
+
+	Image *getTexture() const;
+	int getImageCount() const;
+	int getSize() const;
+
+	/**
+	 * Whether the Image can be placed into this atlas at all (ignoring the
+	 * remaining space). Throws with the reason if throwException is true.
+	 **/
+	bool isCompatible(Image *image, bool throwException) const;
+
+private:
+
+	struct Shelf
+	{
+		int y;
+		int height;
+		int x;
+	};
+
+	bool pack(int w, int h, Rect &rect);
+	void upload(Image *image, const Rect &rect);
+
+	StrongRef<Image> texture;
+	StrongRef<love::image::ImageData> textureData;
+
+	std::vector<StrongRef<Image>> images;
+	std::vector<Shelf> shelves;
+
+	int size;
+
+	// Images are extruded by this many pixels on each side, so linear
+	// filtering at their edges doesn't sample neighbouring atlas entries.
+	static const int PADDING = 1;
+
+}; // TextureAtlas
+
+} // graphics
+} // love
@@ -0,0 +1,351 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "TileLayer.h"
+#include "Graphics.h"
+#include "Buffer.h"
+#include "Shader.h"
+
+// C++
+#include <algorithm>
+#include <limits>
+#include <cstring>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type TileLayer::type("TileLayer", &Drawable::type);
+
+TileLayer::TileLayer(Graphics *gfx, Texture *texture, int width, int height, float tilewidth, float tileheight, int chunksize)
+	: texture(texture)
+	, width(width)
+	, height(height)
+	, tileWidth(tilewidth)
+	, tileHeight(tileheight)
+	, chunkSize(chunksize)
+	, chunksX(0)
+	, chunksY(0)
+	, drawnChunkCount(0)
+{
+	if (width <= 0 || height <= 0)
+		throw love::Exception("Invalid tile layer dimensions: %dx%d", width, height);
+
+	if (tilewidth <= 0.0f || tileheight <= 0.0f)
+		throw love::Exception("Tile dimensions must be greater than 0.");
+
+	// Each chunk must be drawable with 16 bit indices.
+	if (chunksize <= 0 || chunksize * chunksize * 4 > LOVE_UINT16_MAX)
+		throw love::Exception("Invalid tile layer chunk size: %d", chunksize);
+
+	if (texture->getTextureType() != TEXTURE_2D)
+		throw love::Exception("Tile layers can only be used with 2D textures.");
+
+	chunksX = (width + chunksize - 1) / chunksize;
+	chunksY = (height + chunksize - 1) / chunksize;
+
+	chunks.resize(chunksX * chunksY);
+}
+
+TileLayer::~TileLayer()
+{
+	for (Chunk &chunk : chunks)
+		delete chunk.buffer;
+}
+
+void TileLayer::checkTilePosition(int x, int y) const
+{
+	if (x < 0 || y < 0 || x >= width || y >= height)
+		throw love::Exception("Invalid tile position: (%d, %d)", x + 1, y + 1);
+}
+
+TileLayer::Chunk &TileLayer::getChunk(int x, int y, int &slot)
+{
+	Chunk &chunk = chunks[(y / chunkSize) * chunksX + (x / chunkSize)];
+	slot = (y % chunkSize) * chunkSize + (x % chunkSize);
+	return chunk;
+}
+
+void TileLayer::setTile(int x, int y, Quad *quad, const Colorf &color)
+{
+	checkTilePosition(x, y);
+
+	int slot = 0;
+	Chunk &chunk = getChunk(x, y, slot);
+
+	// Chunk storage is only allocated once a tile is placed in the chunk.
+	if (chunk.quads.empty())
+	{
+		chunk.quads.resize(chunkSize * chunkSize);
+		chunk.colors.resize(chunkSize * chunkSize);
+	}
+
+	if (chunk.quads[slot].get() == nullptr)
+		chunk.tileCount++;
+
+	chunk.quads[slot].set(quad);
+	chunk.colors[slot] = toColor(color);
+	chunk.usedSlots = std::max(chunk.usedSlots, slot + 1);
+	chunk.dirty = true;
+}
+
+void TileLayer::clearTile(int x, int y)
+{
+	checkTilePosition(x, y);
+
+	int slot = 0;
+	Chunk &chunk = getChunk(x, y, slot);
+
+	if (chunk.quads.empty() || chunk.quads[slot].get() == nullptr)
+		return;
+
+	chunk.quads[slot].set(nullptr);
+	chunk.tileCount--;
+	chunk.dirty = true;
+
+	while (chunk.usedSlots > 0 && chunk.quads[chunk.usedSlots - 1].get() == nullptr)
+		chunk.usedSlots--;
+}
+
+Quad *TileLayer::getTile(int x, int y) const
+{
+	checkTilePosition(x, y);
+
+	const Chunk &chunk = chunks[(y / chunkSize) * chunksX + (x / chunkSize)];
+	int slot = (y % chunkSize) * chunkSize + (x % chunkSize);
+
+	if (chunk.quads.empty())
+		return nullptr;
+
+	return chunk.quads[slot].get();
+}
+
+void TileLayer::clear()
+{
+	for (Chunk &chunk : chunks)
+	{
+		chunk.quads.clear();
+		chunk.colors.clear();
+		chunk.tileCount = 0;
+		chunk.usedSlots = 0;
+		chunk.dirty = false;
+	}
+}
+
+void TileLayer::setTexture(Texture *newtexture)
+{
+	if (newtexture->getTextureType() != TEXTURE_2D)
+		throw love::Exception("Tile layers can only be used with 2D textures.");
+
+	texture.set(newtexture);
+}
+
+Texture *TileLayer::getTexture() const
+{
+	return texture.get();
+}
+
+int TileLayer::getWidth() const
+{
+	return width;
+}
+
+int TileLayer::getHeight() const
+{
+	return height;
+}
+
+float TileLayer::getTileWidth() const
+{
+	return tileWidth;
+}
+
+float TileLayer::getTileHeight() const
+{
+	return tileHeight;
+}
+
+int TileLayer::getChunkSize() const
+{
+	return chunkSize;
+}
+
+int TileLayer::getDrawnChunkCount() const
+{
+	return drawnChunkCount;
+}
+
+void TileLayer::updateChunk(Graphics *gfx, Chunk &chunk)
+{
+	int index = (int) (&chunk - &chunks[0]);
+	int chunkx = (index % chunksX) * chunkSize;
+	int chunky = (index / chunksX) * chunkSize;
+
+	vertexScratch.resize(chunk.usedSlots * 4);
+
+	Vector2 bmin(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+	Vector2 bmax(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max());
+
+	for (int slot = 0; slot < chunk.usedSlots; slot++)
+	{
+		vertex::XYf_STf_RGBAub *verts = &vertexScratch[slot * 4];
+		Quad *quad = chunk.quads[slot].get();
+
+		// Empty slots become degenerate quads, which the GPU discards.
+		if (quad == nullptr)
+		{
+			memset(verts, 0, sizeof(vertex::XYf_STf_RGBAub) * 4);
+			continue;
+		}
+
+		float tx = (chunkx + slot % chunkSize) * tileWidth;
+		float ty = (chunky + slot / chunkSize) * tileHeight;
+
+		const Vector2 *positions = quad->getVertexPositions();
+		const Vector2 *texcoords = quad->getVertexTexCoords();
+
+		for (int i = 0; i < 4; i++)
+		{
+			verts[i].x = tx + positions[i].x;
+			verts[i].y = ty + positions[i].y;
+			verts[i].s = texcoords[i].x;
+			verts[i].t = texcoords[i].y;
+			verts[i].color = chunk.colors[slot];
+
+			bmin.x = std::min(bmin.x, verts[i].x);
+			bmin.y = std::min(bmin.y, verts[i].y);
+			bmax.x = std::max(bmax.x, verts[i].x);
+			bmax.y = std::max(bmax.y, verts[i].y);
+		}
+	}
+
+	chunk.boundsMin = bmin;
+	chunk.boundsMax = bmax;
+
+	size_t size = vertexScratch.size() * sizeof(vertex::XYf_STf_RGBAub);
+
+	if (chunk.buffer == nullptr && size > 0)
+	{
+		size_t fullsize = chunkSize * chunkSize * 4 * sizeof(vertex::XYf_STf_RGBAub);
+		chunk.buffer = gfx->newBuffer(fullsize, nullptr, BUFFER_VERTEX, vertex::USAGE_DYNAMIC, 0);
+	}
+
+	if (size > 0)
+		chunk.buffer->fill(0, size, vertexScratch.data());
+
+	chunk.dirty = false;
+}
+
+bool TileLayer::isChunkVisible(const Chunk &chunk, const Matrix4 &t, const Vector2 &viewmin, const Vector2 &viewmax) const
+{
+	Vector2 corners[4] = {
+		Vector2(chunk.boundsMin.x, chunk.boundsMin.y),
+		Vector2(chunk.boundsMax.x, chunk.boundsMin.y),
+		Vector2(chunk.boundsMax.x, chunk.boundsMax.y),
+		Vector2(chunk.boundsMin.x, chunk.boundsMax.y),
+	};
+
+	Vector2 transformed[4];
+	t.transformXY(transformed, corners, 4);
+
+	Vector2 tmin = transformed[0];
+	Vector2 tmax = transformed[0];
+
+	for (int i = 1; i < 4; i++)
+	{
+		tmin.x = std::min(tmin.x, transformed[i].x);
+		tmin.y = std::min(tmin.y, transformed[i].y);
+		tmax.x = std::max(tmax.x, transformed[i].x);
+		tmax.y = std::max(tmax.y, transformed[i].y);
+	}
+
+	return tmax.x >= viewmin.x && tmin.x <= viewmax.x && tmax.y >= viewmin.y && tmin.y <= viewmax.y;
+}
+
+void TileLayer::draw(Graphics *gfx, const Matrix4 &m)
+{
+	using namespace vertex;
+
+	drawnChunkCount = 0;
+
+	gfx->flushStreamDraws();
+
+	if (Shader::isDefaultActive())
+		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+
+	if (Shader::current)
+		Shader::current->checkMainTexture(texture);
+
+	Matrix4 t(gfx->getTransform(), m);
+
+	// Chunks are culled against the area of the active render target (in
+	// units), limited to the scissor rectangle.
+	Graphics::RenderTargets rts = gfx->getCanvas();
+	Canvas *target = rts.getFirstTarget().canvas;
+
+	Vector2 viewmin(0.0f, 0.0f);
+	Vector2 viewmax((float) gfx->getWidth(), (float) gfx->getHeight());
+
+	if (target != nullptr)
+	{
+		int mip = rts.getFirstTarget().mipmap;
+		viewmax = Vector2((float) target->getWidth(mip), (float) target->getHeight(mip));
+	}
+
+	Rect scissor;
+	if (gfx->getScissor(scissor))
+	{
+		viewmin.x = std::max(viewmin.x, (float) scissor.x);
+		viewmin.y = std::max(viewmin.y, (float) scissor.y);
+		viewmax.x = std::min(viewmax.x, (float) (scissor.x + scissor.w));
+		viewmax.y = std::min(viewmax.y, (float) (scissor.y + scissor.h));
+	}
+
+	// Culling only works with 2D transforms, everything is drawn otherwise.
+	bool cull = t.isAffine2DTransform();
+
+	Attributes attributes;
+	attributes.setCommonFormat(CommonFormat::XYf_STf_RGBAub, 0);
+
+	Graphics::TempTransform transform(gfx, m);
+
+	for (Chunk &chunk : chunks)
+	{
+		if (chunk.dirty)
+			updateChunk(gfx, chunk);
+
+		if (chunk.tileCount == 0 || chunk.buffer == nullptr)
+			continue;
+
+		if (cull && !isChunkVisible(chunk, t, viewmin, viewmax))
+			continue;
+
+		Buffers buffers;
+		buffers.set(0, chunk.buffer, 0);
+
+		gfx->drawQuads(0, chunk.usedSlots, attributes, buffers, texture, true);
+		drawnChunkCount++;
+	}
+}
+
+} // graphics
+} // love
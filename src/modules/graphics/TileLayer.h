@@ -0,0 +1,132 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/math.h"
+#include "common/Vector.h"
+#include "common/Matrix.h"
+#include "common/Color.h"
+#include "Drawable.h"
+#include "Texture.h"
+#include "Quad.h"
+#include "vertex.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+class Graphics;
+class Buffer;
+
+/**
+ * A grid of tiles drawn with one texture. Tiles are stored in fixed-size
+ * square chunks, each with its own vertex buffer. Only chunks which are
+ * visible in the current render target and scissor rectangle are drawn, and
+ * changing a tile only re-uploads the chunk it's in.
+ **/
+class TileLayer : public Drawable
+{
+public:
+
+	static love::Type type;
+
+	TileLayer(Graphics *gfx, Texture *texture, int width, int height, float tilewidth, float tileheight, int chunksize);
+	virtual ~TileLayer();
+
+	/**
+	 * Sets the tile at the given (0-based) grid position to the texture region
+	 * of the Quad. The Quad is drawn at its own size, at the tile's position.
+	 **/
+	void setTile(int x, int y, Quad *quad, const Colorf &color);
+	void clearTile(int x, int y);
+	Quad *getTile(int x, int y) const;
+
+	// Removes all tiles.
+	void clear();
+
+	void setTexture(Texture *texture);
+	Texture *getTexture() const;
+
+	int getWidth() const;
+	int getHeight() const;
+	float getTileWidth() const;
+	float getTileHeight() const;
+	int getChunkSize() const;
+
+	// The number of chunks submitted by the most recent draw.
+	int getDrawnChunkCount() const;
+
+	// Implements Drawable.
+	void draw(Graphics *gfx, const Matrix4 &m) override;
+
+private:
+
+	struct Chunk
+	{
+		Buffer *buffer = nullptr;
+		std::vector<StrongRef<Quad>> quads;
+		std::vector<Color> colors;
+
+		int tileCount = 0;
+
+		// One past the highest slot with a tile in it, so trailing empty
+		// slots aren't drawn.
+		int usedSlots = 0;
+
+		bool dirty = false;
+
+		// Bounds of the chunk's tiles in local coordinates.
+		Vector2 boundsMin;
+		Vector2 boundsMax;
+	};
+
+	void checkTilePosition(int x, int y) const;
+	Chunk &getChunk(int x, int y, int &slot);
+	void updateChunk(Graphics *gfx, Chunk &chunk);
+	bool isChunkVisible(const Chunk &chunk, const Matrix4 &t, const Vector2 &viewmin, const Vector2 &viewmax) const;
+
+	StrongRef<Texture> texture;
+
+	int width;
+	int height;
+	float tileWidth;
+	float tileHeight;
+	int chunkSize;
+
+	int chunksX;
+	int chunksY;
+	std::vector<Chunk> chunks;
+
+	int drawnChunkCount;
+
+	// Local vertex data of the chunk being uploaded.
+	std::vector<vertex::XYf_STf_RGBAub> vertexScratch;
+
+}; // TileLayer
+
+} // graphics
+} // love
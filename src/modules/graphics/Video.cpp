@@ -163,7 +163,7 @@ void Video::update()
 			size_t size = bpp * widths[i] * heights[i];
 
 			Rect rect = {0, 0, widths[i], heights[i]};
-			images[i]->replacePixels(data[i], size, 0, 0, rect, false);
+			images[i]->replacePixelsStreamed(data[i], size, 0, 0, rect);
 		}
 	}
 }
@@ -0,0 +1,491 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "VideoRecorder.h"
+#include "Canvas.h"
+#include "Graphics.h"
+#include "common/Exception.h"
+#include "common/Module.h"
+#include "filesystem/Filesystem.h"
+
+// C++
+#include <algorithm>
+
+// C
+#include <string.h>
+
+#if !defined(LOVE_WINDOWS)
+#include <signal.h>
+#endif
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type VideoRecorder::type("VideoRecorder", &Object::type);
+
+// Pipes to other processes aren't available in sandboxed environments.
+#if defined(LOVE_IOS) || defined(LOVE_ANDROID) || defined(LOVE_WINDOWS_UWP)
+#define LOVE_VIDEORECORDER_NO_PIPE
+#endif
+
+VideoRecorder::Writer::Writer(VideoRecorder *recorder)
+	: recorder(recorder)
+	, allocatedFrames(0)
+	, stopping(false)
+{
+	threadName = "VideoRecorderWriter";
+}
+
+VideoRecorder::Writer::~Writer()
+{
+	stop();
+
+	for (uint8 *pixels : freeFrames)
+		delete[] pixels;
+
+	for (uint8 *pixels : queuedFrames)
+		delete[] pixels;
+}
+
+uint8 *VideoRecorder::Writer::acquire()
+{
+	love::thread::Lock l(mutex);
+
+	while (freeFrames.empty())
+	{
+		// Buffers are only allocated when the writer can't keep up, up to
+		// the size of the queue.
+		if (allocatedFrames < recorder->settings.queue)
+		{
+			uint8 *pixels = new (std::nothrow) uint8[recorder->getFrameSize()];
+			if (pixels == nullptr)
+				throw love::Exception("Out of memory.");
+			allocatedFrames++;
+			return pixels;
+		}
+
+		cond->wait(mutex);
+	}
+
+	uint8 *pixels = freeFrames.back();
+	freeFrames.pop_back();
+	return pixels;
+}
+
+void VideoRecorder::Writer::submit(uint8 *pixels)
+{
+	love::thread::Lock l(mutex);
+	queuedFrames.push_back(pixels);
+	cond->broadcast();
+}
+
+void VideoRecorder::Writer::stop()
+{
+	{
+		love::thread::Lock l(mutex);
+		if (stopping)
+			return;
+		stopping = true;
+		cond->broadcast();
+	}
+
+	owner->wait();
+}
+
+std::string VideoRecorder::Writer::getError()
+{
+	love::thread::Lock l(mutex);
+	return error;
+}
+
+void VideoRecorder::Writer::threadFunction()
+{
+	while (true)
+	{
+		uint8 *pixels = nullptr;
+
+		{
+			love::thread::Lock l(mutex);
+
+			while (!stopping && queuedFrames.empty())
+				cond->wait(mutex);
+
+			if (queuedFrames.empty())
+				return;
+
+			pixels = queuedFrames.front();
+			queuedFrames.pop_front();
+		}
+
+		// After an error the remaining frames are dropped, so addFrame never
+		// blocks on a writer which can't make progress.
+		bool failed = false;
+		{
+			love::thread::Lock l(mutex);
+			failed = !error.empty();
+		}
+
+		if (!failed)
+		{
+			try
+			{
+				writeFrame(pixels);
+			}
+			catch (std::exception &e)
+			{
+				love::thread::Lock l(mutex);
+				error = e.what();
+			}
+		}
+
+		love::thread::Lock l(mutex);
+		freeFrames.push_back(pixels);
+		cond->broadcast();
+	}
+}
+
+void VideoRecorder::Writer::writeFrame(const uint8 *pixels)
+{
+	switch (recorder->settings.format)
+	{
+	case FORMAT_Y4M:
+		writeY4M(pixels);
+		break;
+	case FORMAT_RAW:
+	default:
+		write(pixels, recorder->getFrameSize());
+		break;
+	}
+}
+
+void VideoRecorder::Writer::writeY4M(const uint8 *pixels)
+{
+	int w = recorder->width;
+	int h = recorder->height;
+	int cw = (w + 1) / 2;
+	int ch = (h + 1) / 2;
+
+	planes.resize(w * h + cw * ch * 2);
+
+	uint8 *yplane = planes.data();
+	uint8 *uplane = yplane + w * h;
+	uint8 *vplane = uplane + cw * ch;
+
+	// BT.601 with limited range, which is what Y4M readers assume.
+	for (int y = 0; y < h; y++)
+	{
+		const uint8 *row = pixels + y * w * 4;
+		for (int x = 0; x < w; x++)
+		{
+			int r = row[x * 4 + 0];
+			int g = row[x * 4 + 1];
+			int b = row[x * 4 + 2];
+			yplane[y * w + x] = (uint8) (((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+		}
+	}
+
+	// Chroma is averaged over each 2x2 block, clamping at odd edges.
+	for (int cy = 0; cy < ch; cy++)
+	{
+		int y0 = cy * 2;
+		int y1 = std::min(y0 + 1, h - 1);
+
+		for (int cx = 0; cx < cw; cx++)
+		{
+			int x0 = cx * 2;
+			int x1 = std::min(x0 + 1, w - 1);
+
+			const uint8 *p[4] = {
+				pixels + (y0 * w + x0) * 4,
+				pixels + (y0 * w + x1) * 4,
+				pixels + (y1 * w + x0) * 4,
+				pixels + (y1 * w + x1) * 4,
+			};
+
+			int r = (p[0][0] + p[1][0] + p[2][0] + p[3][0] + 2) / 4;
+			int g = (p[0][1] + p[1][1] + p[2][1] + p[3][1] + 2) / 4;
+			int b = (p[0][2] + p[1][2] + p[2][2] + p[3][2] + 2) / 4;
+
+			uplane[cy * cw + cx] = (uint8) (((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+			vplane[cy * cw + cx] = (uint8) (((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+		}
+	}
+
+	write("FRAME\n", 6);
+	write(planes.data(), planes.size());
+}
+
+void VideoRecorder::Writer::write(const void *data, size_t size)
+{
+	if (recorder->pipe != nullptr)
+	{
+		if (fwrite(data, 1, size, recorder->pipe) != size)
+			throw love::Exception("Could not write to the encoder process.");
+	}
+	else if (!recorder->file->write(data, (int64) size))
+		throw love::Exception("Could not write to the video file.");
+}
+
+StringMap<VideoRecorder::Format, VideoRecorder::FORMAT_MAX_ENUM>::Entry VideoRecorder::formatEntries[] =
+{
+	{ "y4m", FORMAT_Y4M },
+	{ "raw", FORMAT_RAW },
+};
+
+StringMap<VideoRecorder::Format, VideoRecorder::FORMAT_MAX_ENUM> VideoRecorder::formats(VideoRecorder::formatEntries, sizeof(VideoRecorder::formatEntries));
+
+VideoRecorder::VideoRecorder(const std::string &target, int width, int height, const Settings &settings)
+	: width(width)
+	, height(height)
+	, settings(settings)
+	, pipe(nullptr)
+	, writer(nullptr)
+	, frameCount(0)
+	, finished(false)
+{
+	if (width <= 0 || height <= 0)
+		throw love::Exception("Invalid video dimensions.");
+
+	if (settings.fps <= 0)
+		throw love::Exception("Video frame rate must be positive.");
+
+	if (settings.buffers < 1 || settings.queue < 1)
+		throw love::Exception("The buffer and queue counts must be at least 1.");
+
+	if (settings.pipe)
+	{
+#ifdef LOVE_VIDEORECORDER_NO_PIPE
+		throw love::Exception("Piping frames to another process is not supported on this system.");
+#else
+#ifdef LOVE_WINDOWS
+		pipe = _popen(target.c_str(), "wb");
+#else
+		// A crashed encoder would otherwise kill us with SIGPIPE, rather
+		// than failing the write.
+		signal(SIGPIPE, SIG_IGN);
+		pipe = popen(target.c_str(), "w");
+#endif
+		if (pipe == nullptr)
+			throw love::Exception("Could not start the encoder process: %s", target.c_str());
+#endif
+	}
+	else
+	{
+		auto fs = Module::getInstance<love::filesystem::Filesystem>(Module::M_FILESYSTEM);
+		if (fs == nullptr)
+			throw love::Exception("love.filesystem must be loaded to record video to a file.");
+
+		file.set(fs->newFile(target.c_str()), Acquire::NORETAIN);
+		file->open(love::filesystem::File::MODE_WRITE);
+	}
+
+	if (settings.format == FORMAT_Y4M)
+	{
+		char header[128];
+		int len = snprintf(header, sizeof(header), "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, settings.fps);
+
+		bool success = false;
+		if (pipe != nullptr)
+			success = fwrite(header, 1, len, pipe) == (size_t) len;
+		else
+			success = file->write(header, len);
+
+		if (!success)
+		{
+			closeOutput();
+			throw love::Exception("Could not write the video header.");
+		}
+	}
+
+	writer = new Writer(this);
+	writer->start();
+}
+
+VideoRecorder::~VideoRecorder()
+{
+	// Frames still on the GPU are lost at this point; the backend has to
+	// flush them in its own destructor if it wants them.
+	if (writer != nullptr)
+	{
+		writer->stop();
+		delete writer;
+	}
+
+	closeOutput();
+}
+
+int VideoRecorder::closeOutput()
+{
+	int status = 0;
+
+	if (pipe != nullptr)
+	{
+#ifdef LOVE_WINDOWS
+		status = _pclose(pipe);
+#elif !defined(LOVE_VIDEORECORDER_NO_PIPE)
+		status = pclose(pipe);
+#endif
+		pipe = nullptr;
+	}
+
+	if (file.get() != nullptr)
+	{
+		file->close();
+		file.set(nullptr);
+	}
+
+	return status;
+}
+
+void VideoRecorder::addFrame(Canvas *canvas)
+{
+	if (finished)
+		throw love::Exception("Cannot add frames to a VideoRecorder which has been finished.");
+
+	if (canvas->getTextureType() != TEXTURE_2D)
+		throw love::Exception("Only 2D Canvases can be recorded.");
+
+	if (canvas->getPixelWidth() != width || canvas->getPixelHeight() != height)
+		throw love::Exception("The Canvas must be %dx%d pixels to be recorded.", width, height);
+
+	PixelFormat format = canvas->getPixelFormat();
+	if (format != PIXELFORMAT_RGBA8 && format != PIXELFORMAT_sRGBA8)
+		throw love::Exception("Only Canvases with the rgba8 or srgba8 formats can be recorded.");
+
+	if (!canvas->isReadable())
+		throw love::Exception("Cannot record non-readable Canvases.");
+
+	if (canvas->getMSAA() > 1)
+		throw love::Exception("Cannot record multisampled Canvases directly.");
+
+	Graphics *gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (gfx != nullptr && gfx->isCanvasActive(canvas))
+		throw love::Exception("Cannot record a Canvas while it's active.");
+
+	// Fail early rather than letting frames pile up behind a broken writer.
+	{
+		std::string error = writer->getError();
+		if (!error.empty())
+			throw love::Exception("%s", error.c_str());
+	}
+
+	readFrame(canvas);
+	frameCount++;
+}
+
+void VideoRecorder::finish()
+{
+	if (finished)
+		return;
+
+	finished = true;
+
+	flushFrames();
+	writer->stop();
+
+	std::string error = writer->getError();
+
+	delete writer;
+	writer = nullptr;
+
+	int status = closeOutput();
+
+	if (!error.empty())
+		throw love::Exception("%s", error.c_str());
+
+	if (status != 0)
+		throw love::Exception("The encoder process exited with status %d.", status);
+}
+
+bool VideoRecorder::isFinished() const
+{
+	return finished;
+}
+
+uint8 *VideoRecorder::acquireFrame()
+{
+	return writer->acquire();
+}
+
+void VideoRecorder::submitFrame(uint8 *pixels)
+{
+	writer->submit(pixels);
+}
+
+size_t VideoRecorder::getFrameSize() const
+{
+	return (size_t) width * (size_t) height * 4;
+}
+
+int VideoRecorder::getWidth() const
+{
+	return width;
+}
+
+int VideoRecorder::getHeight() const
+{
+	return height;
+}
+
+int VideoRecorder::getFPS() const
+{
+	return settings.fps;
+}
+
+VideoRecorder::Format VideoRecorder::getFormat() const
+{
+	return settings.format;
+}
+
+int64 VideoRecorder::getFrameCount() const
+{
+	return frameCount;
+}
+
+double VideoRecorder::getTimestep() const
+{
+	return 1.0 / (double) settings.fps;
+}
+
+double VideoRecorder::getTime() const
+{
+	return (double) frameCount / (double) settings.fps;
+}
+
+bool VideoRecorder::getConstant(const char *in, Format &out)
+{
+	return formats.find(in, out);
+}
+
+bool VideoRecorder::getConstant(Format in, const char *&out)
+{
+	return formats.find(in, out);
+}
+
+std::vector<std::string> VideoRecorder::getConstants(Format)
+{
+	return formats.getNames();
+}
+
+} // graphics
+} // love
@@ -0,0 +1,205 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/StringMap.h"
+#include "common/int.h"
+#include "filesystem/File.h"
+#include "thread/threads.h"
+
+// C++
+#include <string>
+#include <vector>
+#include <deque>
+
+// C
+#include <stdio.h>
+
+namespace love
+{
+namespace graphics
+{
+
+class Canvas;
+
+/**
+ * Records the contents of a Canvas as a stream of video frames. Each frame is
+ * read back without stalling the GPU and handed to a writer thread, which
+ * converts it and writes it either to a file in the save directory or to the
+ * standard input of an external encoder process.
+ *
+ * Frames are timestamped by their index rather than by when they were added,
+ * so a recording always plays back at the given frame rate however long each
+ * frame took to render.
+ **/
+class VideoRecorder : public Object
+{
+public:
+
+	static love::Type type;
+
+	enum Format
+	{
+		FORMAT_Y4M, // YUV4MPEG2 with 4:2:0 chroma.
+		FORMAT_RAW, // Tightly packed RGBA8 frames with no header.
+		FORMAT_MAX_ENUM
+	};
+
+	struct Settings
+	{
+		Format format = FORMAT_Y4M;
+		int fps = 60;
+
+		// Whether the target is a shell command to pipe the frames into,
+		// rather than a filename.
+		bool pipe = false;
+
+		// The number of frames which can be in flight on the GPU.
+		int buffers = 3;
+
+		// The number of frames which can wait for the writer thread before
+		// addFrame blocks.
+		int queue = 8;
+	};
+
+	virtual ~VideoRecorder();
+
+	/**
+	 * Queues a read of the whole Canvas as the next frame. Blocks only if the
+	 * GPU or the writer thread have fallen too far behind.
+	 **/
+	void addFrame(Canvas *canvas);
+
+	/**
+	 * Writes any frames which are still in flight and closes the output.
+	 * Throws if anything went wrong while writing.
+	 **/
+	void finish();
+
+	bool isFinished() const;
+
+	int getWidth() const;
+	int getHeight() const;
+	int getFPS() const;
+	Format getFormat() const;
+
+	int64 getFrameCount() const;
+
+	// The fixed amount of time each frame covers.
+	double getTimestep() const;
+
+	// The timestamp of the next frame to be added.
+	double getTime() const;
+
+	static bool getConstant(const char *in, Format &out);
+	static bool getConstant(Format in, const char *&out);
+	static std::vector<std::string> getConstants(Format);
+
+protected:
+
+	VideoRecorder(const std::string &target, int width, int height, const Settings &settings);
+
+	/**
+	 * Starts reading the Canvas into the next free slot of the backend's
+	 * buffer ring. Completed reads are given to the writer via
+	 * acquireFrame/submitFrame.
+	 **/
+	virtual void readFrame(Canvas *canvas) = 0;
+
+	// Blocks until every frame passed to readFrame has been submitted.
+	virtual void flushFrames() = 0;
+
+	/**
+	 * Gets a buffer of getFrameSize() bytes to copy a completed frame into,
+	 * waiting for the writer thread if every buffer is in use.
+	 **/
+	uint8 *acquireFrame();
+	void submitFrame(uint8 *pixels);
+
+	size_t getFrameSize() const;
+
+	int width;
+	int height;
+	Settings settings;
+
+private:
+
+	class Writer : public love::thread::Threadable
+	{
+	public:
+
+		Writer(VideoRecorder *recorder);
+		virtual ~Writer();
+
+		// Implements Threadable.
+		void threadFunction() override;
+
+		uint8 *acquire();
+		void submit(uint8 *pixels);
+
+		// Writes any queued frames before returning.
+		void stop();
+
+		std::string getError();
+
+	private:
+
+		void writeFrame(const uint8 *pixels);
+		void writeY4M(const uint8 *pixels);
+		void write(const void *data, size_t size);
+
+		VideoRecorder *recorder;
+
+		std::vector<uint8 *> freeFrames;
+		int allocatedFrames;
+		std::deque<uint8 *> queuedFrames;
+
+		// Scratch space for the converted frame.
+		std::vector<uint8> planes;
+
+		love::thread::MutexRef mutex;
+		love::thread::ConditionalRef cond;
+
+		bool stopping;
+		std::string error;
+
+	}; // Writer
+
+	// Returns the exit status of the encoder process, if there was one.
+	int closeOutput();
+
+	StrongRef<love::filesystem::File> file;
+	FILE *pipe;
+
+	Writer *writer;
+
+	int64 frameCount;
+	bool finished;
+
+	static StringMap<Format, FORMAT_MAX_ENUM>::Entry formatEntries[];
+	static StringMap<Format, FORMAT_MAX_ENUM> formats;
+
+}; // VideoRecorder
+
+} // graphics
+} // love
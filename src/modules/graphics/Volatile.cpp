@@ -20,6 +20,9 @@
 
 #include "Volatile.h"
 
+// C++
+#include <algorithm>
+
 namespace love
 {
 namespace graphics
@@ -27,6 +30,7 @@ namespace graphics
 
 // Static members.
 std::list<Volatile *> Volatile::all;
+std::vector<Volatile *> *Volatile::loading = nullptr;
 
 Volatile::Volatile()
 {
@@ -38,18 +42,57 @@ Volatile::~Volatile()
 {
 	// Remove the pointer to this object.
 	all.remove(this);
+
+	if (loading != nullptr)
+		std::replace(loading->begin(), loading->end(), this, (Volatile *) nullptr);
 }
 
-bool Volatile::loadAll()
+bool Volatile::loadAll(const ProgressCallback &progress)
 {
+	std::vector<Volatile *> sorted(all.begin(), all.end());
+
+	// The sort is stable, since objects can depend on ones created before
+	// them.
+	std::stable_sort(sorted.begin(), sorted.end(), [](Volatile *a, Volatile *b)
+	{
+		return a->getVolatilePriority() > b->getVolatilePriority();
+	});
+
 	bool success = true;
+	loading = &sorted;
 
-	for (Volatile *v : all)
-		success = success && v->loadVolatile();
+	try
+	{
+		for (size_t i = 0; i < sorted.size(); i++)
+		{
+			if (sorted[i] != nullptr && !sorted[i]->loadVolatile())
+				success = false;
 
+			if (progress)
+				progress(i + 1, sorted.size());
+		}
+
+		for (size_t i = 0; i < sorted.size(); i++)
+		{
+			if (sorted[i] != nullptr)
+				sorted[i]->finishVolatileLoad();
+		}
+	}
+	catch (...)
+	{
+		loading = nullptr;
+		throw;
+	}
+
+	loading = nullptr;
 	return success;
 }
 
+bool Volatile::isLoadingAll()
+{
+	return loading != nullptr;
+}
+
 void Volatile::unloadAll()
 {
 	for (Volatile *v : all)
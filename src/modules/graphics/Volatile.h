@@ -21,8 +21,14 @@
 #ifndef LOVE_GRAPHICS_VOLATILE_H
 #define LOVE_GRAPHICS_VOLATILE_H
 
+// LOVE
+#include "common/int.h"
+
 // STL
 #include <list>
+#include <vector>
+#include <functional>
+#include <cstddef>
 
 namespace love
 {
@@ -43,8 +49,14 @@ private:
 	// A list of all Volatile object currently alive.
 	static std::list<Volatile *> all;
 
+	// The objects loadAll is reloading, in order. Entries of objects which are
+	// destroyed in the meantime are set to null.
+	static std::vector<Volatile *> *loading;
+
 public:
 
+	typedef std::function<void(size_t loaded, size_t total)> ProgressCallback;
+
 	/**
 	 * Constructor. Automatically adds \c this into the list
 	 * of volatile objects.
@@ -71,14 +83,32 @@ public:
 	 **/
 	virtual void unloadVolatile() = 0;
 
+	/**
+	 * Objects with higher priorities are reloaded first by loadAll. Objects
+	 * with the same priority are reloaded in the order they were created.
+	 **/
+	virtual uint32 getVolatilePriority() const { return LOVE_UINT32_MAX; }
+
+	/**
+	 * Called by loadAll once every object has been reloaded, for work started
+	 * in loadVolatile which can run in the background in the meantime (such
+	 * as shader linking done by the driver's own threads.)
+	 **/
+	virtual void finishVolatileLoad() {}
+
 	// Static:
 
 	/**
-	 * Calls \c loadVolatile() on each element in the list of volatiles.
+	 * Calls \c loadVolatile() on each element in the list of volatiles, in
+	 * priority order, and then \c finishVolatileLoad().
 	 *
+	 * @param progress Optionally called after each element is loaded.
 	 * @return True if all elements succeeded, false if one or more failed.
 	 **/
-	static bool loadAll();
+	static bool loadAll(const ProgressCallback &progress = nullptr);
+
+	// Whether loadAll is in progress.
+	static bool isLoadingAll();
 
 	/**
 	 * Calls \c unloadVolatile() on each element in the list of volatiles.
@@ -41,9 +41,17 @@ Buffer::Buffer(size_t size, const void *data, BufferType type, vertex::Usage usa
 	, memory_map(nullptr)
 	, modified_offset(0)
 	, modified_size(0)
+	, persistent(isPersistentMapSupported(usage))
+	, persistent_map(nullptr)
+	, region_size(0)
+	, region_index(0)
+	, region_in_use(false)
 {
 	target = OpenGL::getGLBufferType(type);
 
+	// Keep every region aligned well enough to be used as any kind of buffer.
+	region_size = (size + 255) & ~(size_t) 255;
+
 	try
 	{
 		memory_map = new char[size];
@@ -112,6 +120,30 @@ void Buffer::unmapStream()
 		glBufferSubData(target, 0, (GLsizeiptr) getSize(), memory_map);
 }
 
+void Buffer::unmapPersistent(size_t offset, size_t size)
+{
+	if (region_in_use)
+	{
+		// Draws which are still in flight may read from the current region,
+		// so move on to the next one once the GPU is done with it.
+		region_syncs[region_index].fence();
+		region_index = (region_index + 1) % PERSISTENT_REGIONS;
+		region_syncs[region_index].cpuWait();
+		region_in_use = false;
+
+		// The new region holds data from a few frames ago.
+		offset = 0;
+		size = getSize();
+	}
+
+	size_t regionoffset = region_index * region_size;
+
+	memcpy(persistent_map + regionoffset + offset, memory_map + offset, size);
+
+	gl.bindBuffer(type, vbo);
+	glFlushMappedBufferRange(target, (GLintptr) (regionoffset + offset), (GLsizeiptr) size);
+}
+
 void Buffer::unmap()
 {
 	if (!is_mapped)
@@ -128,7 +160,9 @@ void Buffer::unmap()
 		modified_size = getSize();
 	}
 
-	if (modified_size > 0)
+	if (modified_size > 0 && persistent)
+		unmapPersistent(modified_offset, modified_size);
+	else if (modified_size > 0)
 	{
 		switch (getUsage())
 		{
@@ -178,6 +212,8 @@ void Buffer::fill(size_t offset, size_t size, const void *data)
 
 	if (is_mapped)
 		setMappedRangeModified(offset, size);
+	else if (persistent)
+		unmapPersistent(offset, size);
 	else
 	{
 		gl.bindBuffer(type, vbo);
@@ -190,9 +226,44 @@ ptrdiff_t Buffer::getHandle() const
 	return vbo;
 }
 
+size_t Buffer::getDrawOffset() const
+{
+	if (!persistent)
+		return 0;
+
+	region_in_use = true;
+	return region_index * region_size;
+}
+
+bool Buffer::isPersistentMapSupported(vertex::Usage usage)
+{
+	if (usage == vertex::USAGE_STATIC)
+		return false;
+
+	// Same requirements as the persistently mapped stream buffers.
+	if (!gl.isCoreProfile() || gl.bugs.clientWaitSyncStalls)
+		return false;
+
+	return GLAD_VERSION_4_4 || GLAD_ARB_buffer_storage;
+}
+
 void Buffer::copyTo(size_t offset, size_t size, love::graphics::Buffer *other, size_t otheroffset)
 {
-	other->fill(otheroffset, size, memory_map + offset);
+	Buffer *dst = (Buffer *) other;
+
+	// Copying between the buffer objects directly also picks up data written
+	// by the GPU, e.g. by compute shaders. The CPU-side copies are kept in sync
+	// for later maps and for restoring.
+	if (gl.isCopyBufferSupported() && !persistent && !dst->persistent && !is_mapped && !dst->is_mapped)
+	{
+		memmove(dst->memory_map + otheroffset, memory_map + offset, size);
+
+		glBindBuffer(GL_COPY_READ_BUFFER, vbo);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, dst->vbo);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (GLintptr) offset, (GLintptr) otheroffset, (GLsizeiptr) size);
+	}
+	else
+		other->fill(otheroffset, size, memory_map + offset);
 }
 
 bool Buffer::loadVolatile()
@@ -216,8 +287,33 @@ bool Buffer::load(bool restore)
 	// Copy the old buffer only if 'restore' was requested.
 	const GLvoid *src = restore ? memory_map : nullptr;
 
-	// Note that if 'src' is '0', no data will be copied.
-	glBufferData(target, (GLsizeiptr) getSize(), src, OpenGL::getGLBufferUsage(getUsage()));
+	if (persistent)
+	{
+		size_t fullsize = region_size * PERSISTENT_REGIONS;
+
+		GLbitfield storageflags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT;
+		GLbitfield mapflags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_FLUSH_EXPLICIT_BIT;
+
+		glBufferStorage(target, (GLsizeiptr) fullsize, nullptr, storageflags);
+		persistent_map = (char *) glMapBufferRange(target, 0, (GLsizeiptr) fullsize, mapflags);
+
+		region_index = 0;
+		region_in_use = false;
+
+		if (persistent_map == nullptr)
+			return false;
+
+		if (src != nullptr)
+		{
+			memcpy(persistent_map, src, getSize());
+			glFlushMappedBufferRange(target, 0, (GLsizeiptr) getSize());
+		}
+	}
+	else
+	{
+		// Note that if 'src' is '0', no data will be copied.
+		glBufferData(target, (GLsizeiptr) getSize(), src, OpenGL::getGLBufferUsage(getUsage()));
+	}
 
 	return (glGetError() == GL_NO_ERROR);
 }
@@ -225,6 +321,17 @@ bool Buffer::load(bool restore)
 void Buffer::unload()
 {
 	is_mapped = false;
+
+	if (persistent_map != nullptr)
+	{
+		gl.bindBuffer(type, vbo);
+		glUnmapBuffer(target);
+		persistent_map = nullptr;
+	}
+
+	for (FenceSync &sync : region_syncs)
+		sync.cleanup();
+
 	gl.deleteBuffer(vbo);
 	vbo = 0;
 }
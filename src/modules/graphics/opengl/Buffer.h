@@ -27,6 +27,7 @@
 
 // OpenGL
 #include "OpenGL.h"
+#include "FenceSync.h"
 
 namespace love
 {
@@ -47,6 +48,7 @@ public:
 	void setMappedRangeModified(size_t offset, size_t size) override;
 	void fill(size_t offset, size_t size, const void *data) override;
 	ptrdiff_t getHandle() const override;
+	size_t getDrawOffset() const override;
 
 	void copyTo(size_t offset, size_t size, love::graphics::Buffer *other, size_t otheroffset) override;
 
@@ -61,6 +63,12 @@ private:
 
 	void unmapStatic(size_t offset, size_t size);
 	void unmapStream();
+	void unmapPersistent(size_t offset, size_t size);
+
+	static bool isPersistentMapSupported(vertex::Usage usage);
+
+	// Number of regions a persistently mapped buffer cycles through.
+	static const int PERSISTENT_REGIONS = 3;
 
 	GLenum target;
 
@@ -73,6 +81,15 @@ private:
 	size_t modified_offset;
 	size_t modified_size;
 
+	// Dynamic and stream buffers are kept persistently mapped when possible,
+	// and writes go to a region of the buffer the GPU isn't using.
+	bool persistent;
+	char *persistent_map;
+	size_t region_size;
+	int region_index;
+	mutable bool region_in_use;
+	FenceSync region_syncs[PERSISTENT_REGIONS];
+
 }; // Buffer
 
 } // opengl
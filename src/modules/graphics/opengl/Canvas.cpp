@@ -19,6 +19,7 @@
  **/
 
 #include "Canvas.h"
+#include "GraphicsReadback.h"
 #include "graphics/Graphics.h"
 #include "Graphics.h"
 
@@ -220,6 +221,9 @@ bool Canvas::loadVolatile()
 		setMipmapSharpness(mipmapSharpness);
 		setDepthSampleMode(depthCompareMode);
 
+		if (activeMipmapCount < mipmapCount)
+			glTexParameteri(gltype, GL_TEXTURE_MAX_LEVEL, activeMipmapCount - 1);
+
 		while (glGetError() != GL_NO_ERROR)
 			/* Clear the error buffer. */;
 
@@ -293,6 +297,9 @@ void Canvas::unloadVolatile()
 	renderbuffer = 0;
 	texture = 0;
 
+	// The contents are gone, so there's nothing left to regenerate from.
+	mipmapsDirty = false;
+
 	setGraphicsMemorySize(0);
 }
 
@@ -414,6 +421,9 @@ love::image::ImageData *Canvas::newImageData(love::image::Image *module, int sli
 {
 	love::image::ImageData *data = love::graphics::Canvas::newImageData(module, slice, mipmap, r);
 
+	if (mipmap > 0)
+		resolveMipmaps(true);
+
 	bool isSRGB = false;
 	OpenGL::TextureFormat fmt = gl.convertPixelFormat(data->getFormat(), false, isSRGB);
 
@@ -437,6 +447,17 @@ love::image::ImageData *Canvas::newImageData(love::image::Image *module, int sli
 	return data;
 }
 
+love::graphics::GraphicsReadback *Canvas::newReadback(love::image::Image *module, int slice, int mipmap, const Rect &r)
+{
+	// Validates the parameters and allocates the destination ImageData.
+	StrongRef<love::image::ImageData> data(love::graphics::Canvas::newImageData(module, slice, mipmap, r), Acquire::NORETAIN);
+
+	if (mipmap > 0)
+		resolveMipmaps(true);
+
+	return new GraphicsReadback(this, data, slice, mipmap, r);
+}
+
 void Canvas::generateMipmaps()
 {
 	if (getMipmapCount() == 1 || getMipmapMode() == MIPMAPS_NONE)
@@ -449,7 +470,40 @@ void Canvas::generateMipmaps()
 	if (gl.bugs.generateMipmapsRequiresTexture2DEnable)
 		glEnable(gltextype);
 
+	// Only the levels up to GL_TEXTURE_MAX_LEVEL are generated.
 	glGenerateMipmap(gltextype);
+
+	mipmapsDirty = false;
+}
+
+void Canvas::setActiveMipmapCount(int count)
+{
+	if (count < 1 || count > getMipmapCount())
+		throw love::Exception("Invalid active mipmap count: %d (must be between 1 and %d)", count, getMipmapCount());
+
+	if (count == activeMipmapCount)
+		return;
+
+	if (!(GLAD_ES_VERSION_3_0 || GLAD_VERSION_1_0))
+		throw love::Exception("Limiting the active mipmap levels of a Canvas is not supported on this system.");
+
+	Graphics::flushStreamDrawsGlobal();
+
+	// Levels past the old limit weren't kept up to date.
+	if (count > activeMipmapCount && getMipmapMode() == MIPMAPS_AUTO)
+	{
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		if (gfx != nullptr)
+			gfx->invalidateMipmaps(this);
+	}
+
+	activeMipmapCount = count;
+
+	if (texture != 0)
+	{
+		gl.bindTextureToUnit(this, 0, false);
+		glTexParameteri(OpenGL::getGLTextureType(texType), GL_TEXTURE_MAX_LEVEL, activeMipmapCount - 1);
+	}
 }
 
 PixelFormat Canvas::getSizedFormat(PixelFormat format)
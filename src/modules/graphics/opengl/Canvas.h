@@ -54,7 +54,9 @@ public:
 	ptrdiff_t getHandle() const override;
 
 	love::image::ImageData *newImageData(love::image::Image *module, int slice, int mipmap, const Rect &rect) override;
+	love::graphics::GraphicsReadback *newReadback(love::image::Image *module, int slice, int mipmap, const Rect &rect) override;
 	void generateMipmaps() override;
+	void setActiveMipmapCount(int count) override;
 
 	int getMSAA() const override
 	{
@@ -52,6 +52,7 @@ bool FenceSync::cpuWait()
 
 	GLbitfield flags = 0;
 	GLuint64 duration = 0;
+	bool waited = false;
 
 	while (true)
 	{
@@ -65,11 +66,21 @@ bool FenceSync::cpuWait()
 
 		flags = GL_SYNC_FLUSH_COMMANDS_BIT;
 		duration = 1000000000; // 1 second in nanoseconds.
+		waited = true;
 	}
 
 	cleanup();
 
-	return true;
+	return waited;
+}
+
+bool FenceSync::isSignaled() const
+{
+	if (sync == 0)
+		return true;
+
+	GLenum status = glClientWaitSync(sync, 0, 0);
+	return status != GL_TIMEOUT_EXPIRED;
 }
 
 void FenceSync::cleanup()
@@ -42,7 +42,12 @@ public:
 	~FenceSync();
 
 	bool fence();
+
+	// Returns true if the CPU had to block until the GPU reached the fence.
 	bool cpuWait();
+
+	// Non-blocking check for whether the GPU has reached the fence.
+	bool isSignaled() const;
 	void cleanup();
 
 private:
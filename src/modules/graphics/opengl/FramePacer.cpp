@@ -0,0 +1,239 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "FramePacer.h"
+#include "timer/Timer.h"
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+FramePacer::FramePacer()
+	: oldestFrame(0)
+	, pendingFrames(0)
+	, maxFramesInFlight(0)
+	, latencyMode(Graphics::LATENCY_MODE_NORMAL)
+	, refreshRate(0.0)
+	, vsync(false)
+	, frameWorkEstimate(0.0)
+	, frameStartTime(0.0)
+	, swapStartTime(0.0)
+{
+}
+
+FramePacer::~FramePacer()
+{
+}
+
+bool FramePacer::isLatencyLimitSupported()
+{
+	return GLAD_VERSION_3_2 || GLAD_ES_VERSION_3_0 || GLAD_ARB_sync;
+}
+
+void FramePacer::setMaxFramesInFlight(int frames)
+{
+	if (frames < 0 || frames > MAX_FRAMES_IN_FLIGHT)
+		throw love::Exception("Invalid maximum frames in flight: %d (must be between 0 and %d)", frames, MAX_FRAMES_IN_FLIGHT);
+
+	if (frames > 0 && !isLatencyLimitSupported())
+		throw love::Exception("Frame latency limits are not supported on this system.");
+
+	maxFramesInFlight = frames;
+}
+
+int FramePacer::getMaxFramesInFlight() const
+{
+	return maxFramesInFlight;
+}
+
+void FramePacer::setLatencyMode(Graphics::LatencyMode mode)
+{
+	if (mode != Graphics::LATENCY_MODE_NORMAL && !isLatencyLimitSupported())
+		throw love::Exception("Low latency modes are not supported on this system.");
+
+	latencyMode = mode;
+	frameWorkEstimate = 0.0;
+}
+
+Graphics::LatencyMode FramePacer::getLatencyMode() const
+{
+	return latencyMode;
+}
+
+void FramePacer::setDisplayInfo(double refreshRate, bool vsync)
+{
+	this->refreshRate = refreshRate;
+	this->vsync = vsync;
+}
+
+void FramePacer::beginPresent()
+{
+	double now = love::timer::Timer::getTime();
+
+	if (frameStartTime > 0.0)
+		timings.cpuTime = (now - frameStartTime) * 1000.0;
+}
+
+void FramePacer::beginSwap()
+{
+	swapStartTime = love::timer::Timer::getTime();
+}
+
+void FramePacer::endSwap()
+{
+	timings.swapTime = (love::timer::Timer::getTime() - swapStartTime) * 1000.0;
+}
+
+void FramePacer::retireOldestFrame(bool wait)
+{
+	Frame &frame = frames[oldestFrame];
+
+	if (wait)
+		frame.sync.cpuWait();
+	else
+		frame.sync.cleanup();
+
+	// The GPU finished the frame at some point before now, so this is an
+	// upper bound on how long it took to get from the CPU to the display.
+	timings.displayLatency = (love::timer::Timer::getTime() - frame.startTime) * 1000.0;
+
+	oldestFrame = (oldestFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+	pendingFrames--;
+}
+
+double FramePacer::delayFrameStart(double gpuTailTime)
+{
+	if (refreshRate <= 0.0)
+		return 0.0;
+
+	double now = love::timer::Timer::getTime();
+	double target = now;
+
+	if (latencyMode == Graphics::LATENCY_MODE_LOW)
+	{
+		// Without vsync a frame is shown as soon as it's done, so there's
+		// nothing to gain from starting it later.
+		if (!vsync)
+			return 0.0;
+
+		// Rises immediately on a slow frame and decays slowly, so a single
+		// fast frame doesn't cause the next one to miss the refresh.
+		double work = timings.cpuTime / 1000.0 + gpuTailTime;
+		if (work > frameWorkEstimate)
+			frameWorkEstimate = work;
+		else
+			frameWorkEstimate += (work - frameWorkEstimate) * 0.1;
+
+		// Present just returned after vsync throttled it, so the next refresh
+		// is about a period away. Leave the frame enough time to make it,
+		// plus some slack for scheduling jitter.
+		const double margin = 0.0015;
+		target = now + 1.0 / refreshRate - frameWorkEstimate - margin;
+	}
+	else if (latencyMode == Graphics::LATENCY_MODE_VARIABLE_REFRESH)
+	{
+		// Staying a little below the maximum refresh rate keeps the display
+		// in its variable range, instead of vsync holding frames back.
+		double minInterval = 1.0 / (refreshRate * 0.97);
+		target = frameStartTime + minInterval;
+	}
+
+	if (target <= now)
+		return 0.0;
+
+	love::timer::Timer::sleepPrecise(target - now);
+	return love::timer::Timer::getTime() - now;
+}
+
+void FramePacer::endFrame(double fenceWaitTime)
+{
+	timings.fenceWaitTime = fenceWaitTime * 1000.0;
+	timings.frameLimitWaitTime = 0.0;
+	timings.frameStartDelay = 0.0;
+
+	if (frameStartTime <= 0.0)
+		frameStartTime = love::timer::Timer::getTime();
+
+	if (isLatencyLimitSupported())
+	{
+		// The ring is full: the oldest frame has to finish before it can be
+		// reused, regardless of the limit.
+		if (pendingFrames == MAX_FRAMES_IN_FLIGHT)
+			retireOldestFrame(true);
+
+		Frame &frame = frames[(oldestFrame + pendingFrames) % MAX_FRAMES_IN_FLIGHT];
+		frame.sync.fence();
+		frame.startTime = frameStartTime;
+		pendingFrames++;
+
+		while (pendingFrames > 0 && frames[oldestFrame].sync.isSignaled())
+			retireOldestFrame(false);
+
+		// The low latency mode waits for the frame it just presented, so the
+		// frame being built is the only one the GPU ever has queued.
+		int limit = maxFramesInFlight > 0 ? maxFramesInFlight : MAX_FRAMES_IN_FLIGHT;
+		if (latencyMode == Graphics::LATENCY_MODE_LOW)
+			limit = 0;
+		else if (latencyMode == Graphics::LATENCY_MODE_VARIABLE_REFRESH)
+			limit = 1;
+
+		double waittime = 0.0;
+
+		if (pendingFrames > limit)
+		{
+			double waitstart = love::timer::Timer::getTime();
+
+			while (pendingFrames > limit)
+				retireOldestFrame(true);
+
+			waittime = love::timer::Timer::getTime() - waitstart;
+			timings.frameLimitWaitTime = waittime * 1000.0;
+		}
+
+		if (latencyMode != Graphics::LATENCY_MODE_NORMAL)
+			timings.frameStartDelay = delayFrameStart(waittime) * 1000.0;
+	}
+
+	timings.framesInFlight = pendingFrames;
+
+	frameStartTime = love::timer::Timer::getTime();
+}
+
+const Graphics::FrameTimings &FramePacer::getTimings() const
+{
+	return timings;
+}
+
+void FramePacer::unload()
+{
+	for (Frame &frame : frames)
+		frame.sync.cleanup();
+
+	oldestFrame = 0;
+	pendingFrames = 0;
+	frameStartTime = 0.0;
+}
+
+} // opengl
+} // graphics
+} // love
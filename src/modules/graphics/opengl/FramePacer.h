@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "OpenGL.h"
+#include "FenceSync.h"
+#include "graphics/Graphics.h"
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+/**
+ * Measures where the time between presents goes, and optionally limits how
+ * many frames the CPU may queue ahead of the GPU. A fence is placed after each
+ * buffer swap; when too many are still pending, present blocks on the oldest.
+ **/
+class FramePacer
+{
+public:
+
+	// Upper bound for the frame latency limit.
+	static const int MAX_FRAMES_IN_FLIGHT = 8;
+
+	FramePacer();
+	~FramePacer();
+
+	static bool isLatencyLimitSupported();
+
+	// 0 means no limit.
+	void setMaxFramesInFlight(int frames);
+	int getMaxFramesInFlight() const;
+
+	void setLatencyMode(Graphics::LatencyMode mode);
+	Graphics::LatencyMode getLatencyMode() const;
+
+	// The refresh rate is 0 when it isn't known.
+	void setDisplayInfo(double refreshRate, bool vsync);
+
+	// Called at the start of present, before any work it does.
+	void beginPresent();
+
+	void beginSwap();
+	void endSwap();
+
+	/**
+	 * Called after the buffer swap. Fences the frame, collects any frames the
+	 * GPU has finished, and waits if the latency limit is exceeded.
+	 * fenceWaitTime is the time the frame's stream buffers spent mapping, in
+	 * seconds.
+	 **/
+	void endFrame(double fenceWaitTime);
+
+	const Graphics::FrameTimings &getTimings() const;
+
+	// Must be called while the OpenGL context is still active.
+	void unload();
+
+private:
+
+	struct Frame
+	{
+		FenceSync sync;
+		double startTime;
+	};
+
+	void retireOldestFrame(bool wait);
+
+	// Sleeps so the next frame starts as late as the latency mode allows.
+	double delayFrameStart(double gpuTailTime);
+
+	Frame frames[MAX_FRAMES_IN_FLIGHT];
+	int oldestFrame;
+	int pendingFrames;
+
+	int maxFramesInFlight;
+
+	Graphics::LatencyMode latencyMode;
+	double refreshRate;
+	bool vsync;
+
+	// Pessimistic estimate of the CPU and GPU time a frame needs, in seconds.
+	double frameWorkEstimate;
+
+	double frameStartTime;
+	double swapStartTime;
+
+	Graphics::FrameTimings timings;
+
+}; // FramePacer
+
+} // opengl
+} // graphics
+} // love
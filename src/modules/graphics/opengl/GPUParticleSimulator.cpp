@@ -0,0 +1,355 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "GPUParticleSimulator.h"
+#include "Shader.h"
+#include "common/Exception.h"
+#include "graphics/vertex.h"
+
+// C++
+#include <string>
+#include <vector>
+
+// C
+#include <stddef.h>
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+static const char *simulateVertexCode = R"(
+in vec4 StatePositionVelocity;
+in vec2 StateLifeRotation;
+in vec4 SpawnLifetimeSpin;
+in vec4 SpawnOriginAcceleration;
+in vec4 SpawnRadialTangential;
+
+uniform float love_DeltaTime;
+
+out vec4 OutPositionVelocity;
+out vec2 OutLifeRotation;
+
+void main() {
+	float dt = love_DeltaTime;
+
+	vec2 pos = StatePositionVelocity.xy;
+	vec2 vel = StatePositionVelocity.zw;
+	float life = StateLifeRotation.x;
+	float rotation = StateLifeRotation.y;
+
+	if (life > 0.0) {
+		life -= dt;
+
+		// Same integration as ParticleSystem::updateMotion.
+		vec2 radial = pos - SpawnOriginAcceleration.xy;
+		float len = length(radial);
+		radial = len > 0.0 ? radial / len : vec2(0.0);
+		vec2 tangential = vec2(-radial.y, radial.x);
+
+		vel += (radial * SpawnRadialTangential.x + tangential * SpawnRadialTangential.y + SpawnOriginAcceleration.zw) * dt;
+		vel *= 1.0 / (1.0 + SpawnLifetimeSpin.w * dt);
+		pos += vel * dt;
+
+		float t = 1.0 - life / SpawnLifetimeSpin.x;
+		rotation += mix(SpawnLifetimeSpin.y, SpawnLifetimeSpin.z, t) * dt;
+	}
+
+	OutPositionVelocity = vec4(pos, vel);
+	OutLifeRotation = vec2(life, rotation);
+}
+)";
+
+// GLSL ES requires a fragment shader, even though nothing is rasterized.
+static const char *simulatePixelCode = R"(
+precision mediump float;
+out vec4 OutColor;
+void main() {
+	OutColor = vec4(0.0);
+}
+)";
+
+// Attribute locations start after LOVE's built-in attributes, so the
+// constant color attribute is never turned into an array.
+enum SimulateAttribute
+{
+	SIMULATE_ATTRIB_POSITION_VELOCITY = ATTRIB_MAX_ENUM,
+	SIMULATE_ATTRIB_LIFE_ROTATION,
+	SIMULATE_ATTRIB_LIFETIME_SPIN,
+	SIMULATE_ATTRIB_ORIGIN_ACCELERATION,
+	SIMULATE_ATTRIB_RADIAL_TANGENTIAL,
+};
+
+GLuint GPUParticleSimulator::program = 0;
+GLint GPUParticleSimulator::deltaTimeLocation = -1;
+int GPUParticleSimulator::programRefs = 0;
+
+static GLuint compileStage(GLenum type, const char *code)
+{
+	std::string source = gl.isCoreProfile() ? "#version 330 core\n" : "#version 300 es\n";
+	source += code;
+
+	const char *src = source.c_str();
+
+	GLuint shader = glCreateShader(type);
+	glShaderSource(shader, 1, &src, nullptr);
+	glCompileShader(shader);
+
+	GLint status = GL_FALSE;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+
+	if (status == GL_FALSE)
+	{
+		GLint loglen = 0;
+		glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &loglen);
+
+		std::vector<char> log(loglen + 1);
+		glGetShaderInfoLog(shader, loglen, nullptr, log.data());
+		glDeleteShader(shader);
+
+		throw love::Exception("Cannot compile particle simulation shader:\n%s", log.data());
+	}
+
+	return shader;
+}
+
+void GPUParticleSimulator::createProgram()
+{
+	GLuint vertex = compileStage(GL_VERTEX_SHADER, simulateVertexCode);
+	GLuint pixel = 0;
+
+	try
+	{
+		pixel = compileStage(GL_FRAGMENT_SHADER, simulatePixelCode);
+	}
+	catch (love::Exception &)
+	{
+		glDeleteShader(vertex);
+		throw;
+	}
+
+	program = glCreateProgram();
+	glAttachShader(program, vertex);
+	glAttachShader(program, pixel);
+
+	glBindAttribLocation(program, SIMULATE_ATTRIB_POSITION_VELOCITY, "StatePositionVelocity");
+	glBindAttribLocation(program, SIMULATE_ATTRIB_LIFE_ROTATION, "StateLifeRotation");
+	glBindAttribLocation(program, SIMULATE_ATTRIB_LIFETIME_SPIN, "SpawnLifetimeSpin");
+	glBindAttribLocation(program, SIMULATE_ATTRIB_ORIGIN_ACCELERATION, "SpawnOriginAcceleration");
+	glBindAttribLocation(program, SIMULATE_ATTRIB_RADIAL_TANGENTIAL, "SpawnRadialTangential");
+
+	// The captured varyings are laid out exactly like the State struct.
+	const char *varyings[] = {"OutPositionVelocity", "OutLifeRotation"};
+	glTransformFeedbackVaryings(program, 2, varyings, GL_INTERLEAVED_ATTRIBS);
+
+	glLinkProgram(program);
+
+	glDetachShader(program, vertex);
+	glDetachShader(program, pixel);
+	glDeleteShader(vertex);
+	glDeleteShader(pixel);
+
+	GLint status = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+
+	if (status == GL_FALSE)
+	{
+		GLint loglen = 0;
+		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &loglen);
+
+		std::vector<char> log(loglen + 1);
+		glGetProgramInfoLog(program, loglen, nullptr, log.data());
+
+		glDeleteProgram(program);
+		program = 0;
+
+		throw love::Exception("Cannot link particle simulation shader:\n%s", log.data());
+	}
+
+	deltaTimeLocation = glGetUniformLocation(program, "love_DeltaTime");
+}
+
+void GPUParticleSimulator::deleteProgram()
+{
+	if (program != 0)
+	{
+		glDeleteProgram(program);
+		program = 0;
+	}
+
+	deltaTimeLocation = -1;
+}
+
+GPUParticleSimulator::GPUParticleSimulator(uint32 size)
+	: size(size)
+	, current(0)
+{
+	if (!isSupported())
+		throw love::Exception("GPU-simulated ParticleSystems are not supported on this system.");
+
+	if (!loadVolatile())
+		throw love::Exception("Could not create GPU particle buffers (out of VRAM?)");
+}
+
+GPUParticleSimulator::~GPUParticleSimulator()
+{
+	unloadVolatile();
+}
+
+bool GPUParticleSimulator::isSupported()
+{
+	return (gl.isCoreProfile() || GLAD_ES_VERSION_3_0) && gl.isInstancingSupported();
+}
+
+bool GPUParticleSimulator::loadVolatile()
+{
+	if (spawnBuffer.vbo != 0)
+		return true;
+
+	if (programRefs == 0)
+		createProgram();
+
+	programRefs++;
+
+	while (glGetError() != GL_NO_ERROR)
+		/* Clear the error buffer. */;
+
+	// Every slot starts out dead.
+	std::vector<State> states(size);
+
+	for (int i = 0; i < 2; i++)
+	{
+		glGenBuffers(1, &stateBuffers[i].vbo);
+		gl.bindBuffer(BUFFER_VERTEX, stateBuffers[i].vbo);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(State) * size, states.data(), GL_DYNAMIC_COPY);
+	}
+
+	glGenBuffers(1, &spawnBuffer.vbo);
+	gl.bindBuffer(BUFFER_VERTEX, spawnBuffer.vbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(Spawn) * size, nullptr, GL_DYNAMIC_DRAW);
+
+	current = 0;
+
+	return glGetError() == GL_NO_ERROR;
+}
+
+void GPUParticleSimulator::unloadVolatile()
+{
+	if (spawnBuffer.vbo == 0)
+		return;
+
+	for (int i = 0; i < 2; i++)
+	{
+		gl.deleteBuffer(stateBuffers[i].vbo);
+		stateBuffers[i].vbo = 0;
+	}
+
+	gl.deleteBuffer(spawnBuffer.vbo);
+	spawnBuffer.vbo = 0;
+
+	if (--programRefs == 0)
+		deleteProgram();
+}
+
+void GPUParticleSimulator::setParticles(uint32 first, uint32 count, const State *states, const Spawn *spawns)
+{
+	if (first + count > size)
+		throw love::Exception("Invalid GPU particle range.");
+
+	if (count == 0)
+		return;
+
+	gl.bindBuffer(BUFFER_VERTEX, stateBuffers[current].vbo);
+	glBufferSubData(GL_ARRAY_BUFFER, sizeof(State) * first, sizeof(State) * count, states);
+
+	if (spawns != nullptr)
+	{
+		gl.bindBuffer(BUFFER_VERTEX, spawnBuffer.vbo);
+		glBufferSubData(GL_ARRAY_BUFFER, sizeof(Spawn) * first, sizeof(Spawn) * count, spawns);
+	}
+}
+
+void GPUParticleSimulator::simulate(float dt)
+{
+	using namespace vertex;
+
+	if (program == 0 || spawnBuffer.vbo == 0)
+		return;
+
+	gl.useProgram(program);
+	glUniform1f(deltaTimeLocation, dt);
+
+	Attributes attributes;
+	Buffers buffers;
+
+	buffers.set(0, &stateBuffers[current], 0);
+	buffers.set(1, &spawnBuffer, 0);
+
+	attributes.set(SIMULATE_ATTRIB_POSITION_VELOCITY, DATA_FLOAT, 4, offsetof(State, position), sizeof(State), 0);
+	attributes.set(SIMULATE_ATTRIB_LIFE_ROTATION, DATA_FLOAT, 2, offsetof(State, life), sizeof(State), 0);
+	attributes.set(SIMULATE_ATTRIB_LIFETIME_SPIN, DATA_FLOAT, 4, offsetof(Spawn, lifetime), sizeof(Spawn), 1);
+	attributes.set(SIMULATE_ATTRIB_ORIGIN_ACCELERATION, DATA_FLOAT, 4, offsetof(Spawn, origin), sizeof(Spawn), 1);
+	attributes.set(SIMULATE_ATTRIB_RADIAL_TANGENTIAL, DATA_FLOAT, 4, offsetof(Spawn, radialAcceleration), sizeof(Spawn), 1);
+
+	gl.setVertexAttributes(attributes, buffers);
+
+	int target = 1 - current;
+
+	glEnable(GL_RASTERIZER_DISCARD);
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, stateBuffers[target].vbo);
+
+	glBeginTransformFeedback(GL_POINTS);
+	glDrawArrays(GL_POINTS, 0, (GLsizei) size);
+	glEndTransformFeedback();
+
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+	glDisable(GL_RASTERIZER_DISCARD);
+
+	current = target;
+
+	// Go back to whichever LOVE shader was active.
+	GLuint activeprogram = 0;
+	if (love::graphics::Shader::current != nullptr)
+		activeprogram = (GLuint) love::graphics::Shader::current->getHandle();
+
+	gl.useProgram(activeprogram);
+}
+
+Resource *GPUParticleSimulator::getStateBuffer()
+{
+	return &stateBuffers[current];
+}
+
+Resource *GPUParticleSimulator::getSpawnBuffer()
+{
+	return &spawnBuffer;
+}
+
+uint32 GPUParticleSimulator::getSize() const
+{
+	return size;
+}
+
+} // opengl
+} // graphics
+} // love
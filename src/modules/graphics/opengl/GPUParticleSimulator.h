@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "graphics/GPUParticleSimulator.h"
+#include "graphics/Volatile.h"
+#include "OpenGL.h"
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+/**
+ * Advances particles with transform feedback. Two state buffers are
+ * ping-ponged: each simulate() call reads from one and captures into the
+ * other, with rasterization disabled.
+ **/
+class GPUParticleSimulator final : public love::graphics::GPUParticleSimulator, public Volatile
+{
+public:
+
+	GPUParticleSimulator(uint32 size);
+	virtual ~GPUParticleSimulator();
+
+	// Implements love::graphics::GPUParticleSimulator.
+	void setParticles(uint32 first, uint32 count, const State *states, const Spawn *spawns) override;
+	void simulate(float dt) override;
+	Resource *getStateBuffer() override;
+	Resource *getSpawnBuffer() override;
+	uint32 getSize() const override;
+
+	// Implements Volatile.
+	bool loadVolatile() override;
+	void unloadVolatile() override;
+
+	static bool isSupported();
+
+private:
+
+	class BufferHandle final : public Resource
+	{
+	public:
+		GLuint vbo = 0;
+		ptrdiff_t getHandle() const override { return vbo; }
+	};
+
+	static void createProgram();
+	static void deleteProgram();
+
+	// The simulation program is shared by every simulator.
+	static GLuint program;
+	static GLint deltaTimeLocation;
+	static int programRefs;
+
+	uint32 size;
+
+	BufferHandle stateBuffers[2];
+	BufferHandle spawnBuffer;
+
+	// Index of the state buffer holding the latest results.
+	int current;
+
+}; // GPUParticleSimulator
+
+} // opengl
+} // graphics
+} // love
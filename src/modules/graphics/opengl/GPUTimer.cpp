@@ -0,0 +1,212 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "GPUTimer.h"
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+GPUTimer::GPUTimer()
+	: enabled(false)
+	, recording(false)
+	, passActive(false)
+	, frameIndex(0)
+	, hasResults(false)
+{
+	currentFrame.frameIndex = 0;
+}
+
+GPUTimer::~GPUTimer()
+{
+}
+
+void GPUTimer::setEnabled(bool enable)
+{
+	// Recording starts at the next frame boundary (see endFrame), so a frame's
+	// queries always cover all of its passes.
+	enabled = enable;
+
+	if (!enable)
+		hasResults = false;
+}
+
+bool GPUTimer::isEnabled() const
+{
+	return enabled;
+}
+
+GLuint GPUTimer::getQuery()
+{
+	GLuint query = 0;
+
+	if (!freeQueries.empty())
+	{
+		query = freeQueries.back();
+		freeQueries.pop_back();
+	}
+	else
+		glGenQueries(1, &query);
+
+	return query;
+}
+
+void GPUTimer::releaseFrame(Frame &frame)
+{
+	for (const Pass &pass : frame.passes)
+		freeQueries.push_back(pass.query);
+
+	frame.passes.clear();
+}
+
+void GPUTimer::beginPass(love::graphics::Canvas *canvas)
+{
+	if (!recording || passActive)
+		return;
+
+	Pass pass;
+	pass.query = getQuery();
+	pass.canvas.set(canvas);
+
+	glBeginQuery(GL_TIME_ELAPSED, pass.query);
+
+	currentFrame.passes.push_back(pass);
+	passActive = true;
+}
+
+void GPUTimer::endPass()
+{
+	if (!passActive)
+		return;
+
+	glEndQuery(GL_TIME_ELAPSED);
+	passActive = false;
+}
+
+bool GPUTimer::collect(Frame &frame)
+{
+	// Queries complete in order, so the frame is done once its last pass is.
+	if (!frame.passes.empty())
+	{
+		GLuint available = 0;
+		glGetQueryObjectuiv(frame.passes.back().query, GL_QUERY_RESULT_AVAILABLE, &available);
+
+		if (!available)
+			return false;
+	}
+
+	// Results are meaningless if the GPU was interrupted (e.g. a power state
+	// change) while the queries were active.
+	if (GLAD_EXT_disjoint_timer_query && !(GLAD_VERSION_3_3 || GLAD_ARB_timer_query))
+	{
+		GLint disjoint = 0;
+		glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+
+		if (disjoint)
+		{
+			releaseFrame(frame);
+			return true;
+		}
+	}
+
+	results.passes.clear();
+	results.frameTime = 0.0;
+	results.latency = frameIndex - frame.frameIndex;
+
+	for (const Pass &pass : frame.passes)
+	{
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v(pass.query, GL_QUERY_RESULT, &elapsed);
+
+		Graphics::GPUPassTiming timing;
+		timing.canvas = pass.canvas;
+		timing.time = (double) elapsed / 1000000.0;
+
+		results.frameTime += timing.time;
+		results.passes.push_back(timing);
+	}
+
+	hasResults = true;
+
+	releaseFrame(frame);
+	return true;
+}
+
+void GPUTimer::endFrame()
+{
+	endPass();
+
+	frameIndex++;
+
+	if (recording)
+	{
+		pendingFrames.push_back(currentFrame);
+		currentFrame.passes.clear();
+	}
+
+	while (!pendingFrames.empty())
+	{
+		if (!collect(pendingFrames.front()))
+		{
+			if ((int) pendingFrames.size() <= MAX_PENDING_FRAMES)
+				break;
+
+			releaseFrame(pendingFrames.front());
+		}
+
+		pendingFrames.pop_front();
+	}
+
+	recording = enabled;
+	currentFrame.frameIndex = frameIndex;
+}
+
+bool GPUTimer::getTimings(Graphics::GPUTimings &timings) const
+{
+	if (!hasResults)
+		return false;
+
+	timings = results;
+	return true;
+}
+
+void GPUTimer::unload()
+{
+	endPass();
+
+	for (Frame &frame : pendingFrames)
+		releaseFrame(frame);
+
+	releaseFrame(currentFrame);
+	pendingFrames.clear();
+
+	if (!freeQueries.empty())
+		glDeleteQueries((GLsizei) freeQueries.size(), &freeQueries[0]);
+
+	freeQueries.clear();
+	recording = false;
+}
+
+} // opengl
+} // graphics
+} // love
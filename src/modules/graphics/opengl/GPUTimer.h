@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "OpenGL.h"
+#include "graphics/Graphics.h"
+
+// C++
+#include <vector>
+#include <deque>
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+/**
+ * Measures GPU time per render pass with GL_TIME_ELAPSED queries. Passes never
+ * overlap, so one query can be active per pass without nesting. Results are
+ * polled a few frames later so reading them never stalls the pipeline.
+ **/
+class GPUTimer
+{
+public:
+
+	GPUTimer();
+	~GPUTimer();
+
+	void setEnabled(bool enable);
+	bool isEnabled() const;
+
+	void beginPass(love::graphics::Canvas *canvas);
+	void endPass();
+
+	/**
+	 * Finishes recording the current frame and collects the results of any
+	 * earlier frames the GPU has completed.
+	 **/
+	void endFrame();
+
+	bool getTimings(Graphics::GPUTimings &timings) const;
+
+	// Must be called while the OpenGL context is still active.
+	void unload();
+
+private:
+
+	struct Pass
+	{
+		GLuint query;
+		StrongRef<love::graphics::Canvas> canvas;
+	};
+
+	struct Frame
+	{
+		std::vector<Pass> passes;
+		int frameIndex;
+	};
+
+	GLuint getQuery();
+	void releaseFrame(Frame &frame);
+	bool collect(Frame &frame);
+
+	// Frames older than this are dropped without waiting for their results.
+	static const int MAX_PENDING_FRAMES = 5;
+
+	bool enabled;
+	bool recording;
+	bool passActive;
+
+	Frame currentFrame;
+	std::deque<Frame> pendingFrames;
+	std::vector<GLuint> freeQueries;
+
+	int frameIndex;
+
+	Graphics::GPUTimings results;
+	bool hasResults;
+
+}; // GPUTimer
+
+} // opengl
+} // graphics
+} // love
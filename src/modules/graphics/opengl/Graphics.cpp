@@ -21,6 +21,7 @@
 // LOVE
 #include "common/config.h"
 #include "common/math.h"
+#include "common/profiling.h"
 #include "common/Vector.h"
 
 #include "Graphics.h"
@@ -29,6 +30,9 @@
 #include "math/MathModule.h"
 #include "window/Window.h"
 #include "Buffer.h"
+#include "GPUParticleSimulator.h"
+#include "VideoRecorder.h"
+#include "OcclusionQuery.h"
 #include "ShaderStage.h"
 
 #include "libraries/xxHash/xxhash.h"
@@ -57,6 +61,14 @@ namespace opengl
 Graphics::Graphics()
 	: windowHasStencil(false)
 	, mainVAO(0)
+	, headlessFBO(0)
+	, copyFBOs()
+	, headlessRenderbuffers()
+	, builtinUniformBuffer(nullptr)
+	, builtinUniformData()
+	, builtinUniformsDirty(true)
+	, loaderThread(nullptr)
+	, loaderThreadFailed(false)
 {
 	gl = OpenGL();
 
@@ -83,6 +95,12 @@ Graphics::Graphics()
 
 Graphics::~Graphics()
 {
+	// Pooled Canvases and binned Images need the OpenGL backend while they're
+	// destroyed.
+	clearCanvasPool();
+	clearTextureBins();
+
+	delete builtinUniformBuffer;
 }
 
 const char *Graphics::getName() const
@@ -110,14 +128,19 @@ love::graphics::Canvas *Graphics::newCanvas(const Canvas::Settings &settings)
 	return new Canvas(settings);
 }
 
-love::graphics::ShaderStage *Graphics::newShaderStageInternal(ShaderStage::StageType stage, const std::string &cachekey, const std::string &source, bool gles)
+love::graphics::ShaderStage *Graphics::newShaderStageInternal(ShaderStage::StageType stage, const std::string &cachekey, const std::string &source, bool gles, bool deferValidation)
+{
+	return new ShaderStage(this, stage, source, gles, cachekey, deferValidation);
+}
+
+love::graphics::Shader *Graphics::newShaderInternal(love::graphics::ShaderStage *vertex, love::graphics::ShaderStage *pixel, bool async)
 {
-	return new ShaderStage(this, stage, source, gles, cachekey);
+	return new Shader(vertex, pixel, async);
 }
 
-love::graphics::Shader *Graphics::newShaderInternal(love::graphics::ShaderStage *vertex, love::graphics::ShaderStage *pixel)
+love::graphics::Shader *Graphics::newComputeShaderInternal(love::graphics::ShaderStage *compute)
 {
-	return new Shader(vertex, pixel);
+	return new Shader(compute);
 }
 
 love::graphics::Buffer *Graphics::newBuffer(size_t size, const void *data, BufferType type, vertex::Usage usage, uint32 mapflags)
@@ -125,6 +148,24 @@ love::graphics::Buffer *Graphics::newBuffer(size_t size, const void *data, Buffe
 	return new Buffer(size, data, type, usage, mapflags);
 }
 
+love::graphics::GPUParticleSimulator *Graphics::newGPUParticleSimulator(uint32 size)
+{
+	return new GPUParticleSimulator(size);
+}
+
+love::graphics::VideoRecorder *Graphics::newVideoRecorder(const std::string &target, int width, int height, const VideoRecorder::Settings &settings)
+{
+	return new VideoRecorder(target, width, height, settings);
+}
+
+love::graphics::OcclusionQuery *Graphics::newOcclusionQuery(bool conservative)
+{
+	if (!capabilities.features[FEATURE_OCCLUSION_QUERY])
+		throw love::Exception("Occlusion queries are not supported on this system.");
+
+	return new OcclusionQuery(conservative);
+}
+
 void Graphics::setViewportSize(int width, int height, int pixelwidth, int pixelheight)
 {
 	this->width = width;
@@ -139,12 +180,15 @@ void Graphics::setViewportSize(int width, int height, int pixelwidth, int pixelh
 
 		// Re-apply the scissor if it was active, since the rectangle passed to
 		// glScissor is affected by the viewport dimensions.
-		if (states.back().scissor)
-			setScissor(states.back().scissorRect);
+		if (displayState.scissor)
+			setScissor(displayState.scissorRect);
 
 		// Set up the projection matrix
 		projectionMatrix = Matrix4::ortho(0.0, (float) width, (float) height, 0.0, -10.0f, 10.0f);
 	}
+
+	// The window may have moved to a display with a different refresh rate.
+	updateFramePacerDisplayInfo();
 }
 
 bool Graphics::setMode(int width, int height, int pixelwidth, int pixelheight, bool windowhasstencil)
@@ -168,6 +212,29 @@ bool Graphics::setMode(int width, int height, int pixelwidth, int pixelheight, b
 	created = true;
 	initCapabilities();
 
+	auto window = Module::getInstance<love::window::Window>(M_WINDOW);
+	if (window != nullptr && window->isHeadless())
+		createHeadlessFramebuffer(pixelwidth, pixelheight);
+
+	updateFramePacerDisplayInfo();
+
+	// Compressed formats which are transcoded at load time should target the
+	// best format this system supports.
+	auto imagemodule = Module::getInstance<love::image::Image>(M_IMAGE);
+	if (imagemodule != nullptr)
+	{
+		std::vector<PixelFormat> formats;
+
+		for (int i = 0; i < (int) PIXELFORMAT_MAX_ENUM; i++)
+		{
+			PixelFormat format = (PixelFormat) i;
+			if (isPixelFormatCompressed(format) && isImageFormatSupported(format))
+				formats.push_back(format);
+		}
+
+		imagemodule->setSupportedCompressedFormats(formats);
+	}
+
 	setViewportSize(width, height, pixelwidth, pixelheight);
 
 	// Enable blending
@@ -209,13 +276,18 @@ bool Graphics::setMode(int width, int height, int pixelwidth, int pixelheight, b
 
 	if (streamBufferState.vb[0] == nullptr)
 	{
-		// Initial sizes that should be good enough for most cases. It will
-		// resize to fit if needed, later.
-		streamBufferState.vb[0] = CreateStreamBuffer(BUFFER_VERTEX, 1024 * 1024 * 1);
-		streamBufferState.vb[1] = CreateStreamBuffer(BUFFER_VERTEX, 256  * 1024 * 1);
-		streamBufferState.indexBuffer = CreateStreamBuffer(BUFFER_INDEX, sizeof(uint16) * LOVE_UINT16_MAX);
+		// These will resize to fit if needed, later.
+		streamBufferState.vb[0] = CreateStreamBuffer(BUFFER_VERTEX, streamBufferUsage[0].minSize);
+		streamBufferState.vb[1] = CreateStreamBuffer(BUFFER_VERTEX, streamBufferUsage[1].minSize);
+		streamBufferState.indexBuffer = CreateStreamBuffer(BUFFER_INDEX, streamBufferUsage[2].minSize);
 	}
 
+	if (builtinUniformBuffer == nullptr && gl.isUniformBufferSupported())
+		builtinUniformBuffer = CreateStreamBuffer(BUFFER_UNIFORM, 256 * 1024);
+
+	// The new context doesn't have the block bound.
+	builtinUniformsDirty = true;
+
 	// Reload all volatile objects.
 	if (!Volatile::loadAll())
 		::printf("Could not reload all volatile objects.\n");
@@ -223,7 +295,7 @@ bool Graphics::setMode(int width, int height, int pixelwidth, int pixelheight, b
 	createQuadIndexBuffer();
 
 	// Restore the graphics state.
-	restoreState(states.back());
+	restoreState(displayState);
 
 	int gammacorrect = isGammaCorrect() ? 1 : 0;
 	Shader::Language target = getShaderLanguageTarget();
@@ -234,6 +306,18 @@ bool Graphics::setMode(int width, int height, int pixelwidth, int pixelheight, b
 		if (i == Shader::STANDARD_ARRAY && !capabilities.textureTypes[TEXTURE_2D_ARRAY])
 			continue;
 
+		if (i == Shader::STANDARD_INSTANCED_SPRITE && !capabilities.features[FEATURE_INSTANCING])
+			continue;
+
+		if (i == Shader::STANDARD_GPU_PARTICLE && !capabilities.features[FEATURE_GPU_PARTICLES])
+			continue;
+
+		if (i == Shader::STANDARD_LINE && !capabilities.features[FEATURE_INSTANCING])
+			continue;
+
+		if ((i == Shader::STANDARD_INSTANCED_GLYPH || i == Shader::STANDARD_INSTANCED_GLYPH_DISTANCE_FIELD) && !capabilities.features[FEATURE_INSTANCING])
+			continue;
+
 		// Apparently some intel GMA drivers on windows fail to compile shaders
 		// which use array textures despite claiming support for the extension.
 		try
@@ -272,6 +356,17 @@ void Graphics::unSetMode()
 	// mode change.
 	Volatile::unloadAll();
 
+	// Images wait for their background uploads when they're unloaded, so the
+	// loader thread is idle by now.
+	if (loaderThread != nullptr)
+	{
+		loaderThread->stop();
+		delete loaderThread;
+		loaderThread = nullptr;
+	}
+
+	loaderThreadFailed = false;
+
 	for (const auto &pair : framebufferObjects)
 		gl.deleteFramebuffer(pair.second);
 
@@ -281,17 +376,91 @@ void Graphics::unSetMode()
 	framebufferObjects.clear();
 	temporaryCanvases.clear();
 
+	if (copyFBOs[0] != 0)
+	{
+		gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, gl.getDefaultFBO());
+		glDeleteFramebuffers(2, copyFBOs);
+		copyFBOs[0] = copyFBOs[1] = 0;
+	}
+
+	gl.clearVertexArrayCache();
+
 	if (mainVAO != 0)
 	{
 		glDeleteVertexArrays(1, &mainVAO);
 		mainVAO = 0;
 	}
 
+	gpuTimer.unload();
+	framePacer.unload();
+	screenshotCapture.unload();
+
+	destroyHeadlessFramebuffer();
+
 	gl.deInitContext();
 
 	created = false;
 }
 
+void Graphics::createHeadlessFramebuffer(int pixelwidth, int pixelheight)
+{
+	destroyHeadlessFramebuffer();
+
+	PixelFormat colorformat = isGammaCorrect() ? PIXELFORMAT_sRGBA8 : PIXELFORMAT_RGBA8;
+	PixelFormat depthstencilformat = PIXELFORMAT_DEPTH24_STENCIL8;
+
+	if (!isCanvasFormatSupported(depthstencilformat))
+		depthstencilformat = PIXELFORMAT_STENCIL8;
+
+	glGenFramebuffers(1, &headlessFBO);
+	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, headlessFBO);
+
+	glGenRenderbuffers(2, headlessRenderbuffers);
+
+	PixelFormat formats[] = {colorformat, depthstencilformat};
+
+	for (int i = 0; i < 2; i++)
+	{
+		bool unusedSRGB = false;
+		OpenGL::TextureFormat fmt = OpenGL::convertPixelFormat(formats[i], true, unusedSRGB);
+
+		glBindRenderbuffer(GL_RENDERBUFFER, headlessRenderbuffers[i]);
+		glRenderbufferStorage(GL_RENDERBUFFER, fmt.internalformat, pixelwidth, pixelheight);
+
+		for (GLenum attachment : fmt.framebufferAttachments)
+		{
+			if (attachment != GL_NONE)
+				glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, headlessRenderbuffers[i]);
+		}
+	}
+
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	if (status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		destroyHeadlessFramebuffer();
+		throw love::Exception("Could not create the headless framebuffer: %s", OpenGL::framebufferStatusString(status));
+	}
+
+	gl.setDefaultFBO(headlessFBO);
+}
+
+void Graphics::destroyHeadlessFramebuffer()
+{
+	if (headlessFBO == 0)
+		return;
+
+	gl.setDefaultFBO(0);
+	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, 0);
+
+	gl.deleteFramebuffer(headlessFBO);
+	glDeleteRenderbuffers(2, headlessRenderbuffers);
+
+	headlessFBO = 0;
+	headlessRenderbuffers[0] = headlessRenderbuffers[1] = 0;
+}
+
 void Graphics::setActive(bool enable)
 {
 	flushStreamDraws();
@@ -306,8 +475,9 @@ void Graphics::setActive(bool enable)
 
 void Graphics::draw(const DrawCommand &cmd)
 {
+	resolveSampledMipmaps(cmd.texture, Shader::current);
 	gl.prepareDraw();
-	gl.setVertexAttributes(*cmd.attributes, *cmd.buffers);
+	gl.setVertexAttributes(*cmd.attributes, *cmd.buffers, cmd.cacheVertexArray);
 	gl.bindTextureToUnit(cmd.texture, 0, false);
 	gl.setCullMode(cmd.cullMode);
 
@@ -323,12 +493,13 @@ void Graphics::draw(const DrawCommand &cmd)
 
 void Graphics::draw(const DrawIndexedCommand &cmd)
 {
+	resolveSampledMipmaps(cmd.texture, Shader::current);
 	gl.prepareDraw();
-	gl.setVertexAttributes(*cmd.attributes, *cmd.buffers);
+	gl.setVertexAttributes(*cmd.attributes, *cmd.buffers, cmd.cacheVertexArray);
 	gl.bindTextureToUnit(cmd.texture, 0, false);
 	gl.setCullMode(cmd.cullMode);
 
-	const void *gloffset = BUFFER_OFFSET(cmd.indexBufferOffset);
+	const void *gloffset = BUFFER_OFFSET(cmd.indexBuffer->getDrawOffset() + cmd.indexBufferOffset);
 	GLenum glprimitivetype = OpenGL::getGLPrimitiveType(cmd.primitiveType);
 	GLenum gldatatype = OpenGL::getGLIndexDataType(cmd.indexType);
 
@@ -342,6 +513,50 @@ void Graphics::draw(const DrawIndexedCommand &cmd)
 	++drawCalls;
 }
 
+void Graphics::draw(const DrawIndirectCommand &cmd)
+{
+	resolveSampledMipmaps(cmd.texture, Shader::current);
+	gl.prepareDraw();
+	gl.setVertexAttributes(*cmd.attributes, *cmd.buffers, cmd.cacheVertexArray);
+	gl.bindTextureToUnit(cmd.texture, 0, false);
+	gl.setCullMode(cmd.cullMode);
+
+	GLenum glprimitivetype = OpenGL::getGLPrimitiveType(cmd.primitiveType);
+	size_t offset = cmd.indirectBuffer->getDrawOffset() + cmd.indirectBufferOffset;
+
+	gl.bindBuffer(BUFFER_INDIRECT, cmd.indirectBuffer->getHandle());
+
+	if (cmd.indexBuffer != nullptr)
+	{
+		GLenum gldatatype = OpenGL::getGLIndexDataType(cmd.indexType);
+		GLsizei stride = (GLsizei) sizeof(DrawIndexedIndirectArgs);
+
+		gl.bindBuffer(BUFFER_INDEX, cmd.indexBuffer->getHandle());
+
+		if (gl.isMultiDrawIndirectSupported())
+			glMultiDrawElementsIndirect(glprimitivetype, gldatatype, BUFFER_OFFSET(offset), cmd.drawCount, stride);
+		else
+		{
+			for (int i = 0; i < cmd.drawCount; i++)
+				glDrawElementsIndirect(glprimitivetype, gldatatype, BUFFER_OFFSET(offset + i * stride));
+		}
+	}
+	else
+	{
+		GLsizei stride = (GLsizei) sizeof(DrawIndirectArgs);
+
+		if (gl.isMultiDrawIndirectSupported())
+			glMultiDrawArraysIndirect(glprimitivetype, BUFFER_OFFSET(offset), cmd.drawCount, stride);
+		else
+		{
+			for (int i = 0; i < cmd.drawCount; i++)
+				glDrawArraysIndirect(glprimitivetype, BUFFER_OFFSET(offset + i * stride));
+		}
+	}
+
+	++drawCalls;
+}
+
 static inline void advanceVertexOffsets(const vertex::Attributes &attributes, vertex::Buffers &buffers, int vertexcount)
 {
 	// TODO: Figure out a better way to avoid touching the same buffer multiple
@@ -364,20 +579,20 @@ static inline void advanceVertexOffsets(const vertex::Attributes &attributes, ve
 	}
 }
 
-void Graphics::drawQuads(int start, int count, const vertex::Attributes &attributes, const vertex::Buffers &buffers, love::graphics::Texture *texture)
+void Graphics::drawQuads(int start, int count, const vertex::Attributes &attributes, const vertex::Buffers &buffers, love::graphics::Texture *texture, bool cacheVertexArray)
 {
 	const int MAX_VERTICES_PER_DRAW = LOVE_UINT16_MAX;
 	const int MAX_QUADS_PER_DRAW    = MAX_VERTICES_PER_DRAW / 4;
 
+	resolveSampledMipmaps(texture, Shader::current);
 	gl.prepareDraw();
 	gl.bindTextureToUnit(texture, 0, false);
 	gl.setCullMode(CULL_NONE);
 
-	gl.bindBuffer(BUFFER_INDEX, quadIndexBuffer->getHandle());
-
 	if (gl.isBaseVertexSupported())
 	{
-		gl.setVertexAttributes(attributes, buffers);
+		gl.setVertexAttributes(attributes, buffers, cacheVertexArray);
+		gl.bindBuffer(BUFFER_INDEX, quadIndexBuffer->getHandle());
 
 		int basevertex = start * 4;
 
@@ -393,6 +608,8 @@ void Graphics::drawQuads(int start, int count, const vertex::Attributes &attribu
 	}
 	else
 	{
+		// The offsets change with each batch, so there's no point caching
+		// a VAO for them.
 		vertex::Buffers bufferscopy = buffers;
 		if (start > 0)
 			advanceVertexOffsets(attributes, bufferscopy, start * 4);
@@ -400,6 +617,7 @@ void Graphics::drawQuads(int start, int count, const vertex::Attributes &attribu
 		for (int quadindex = 0; quadindex < count; quadindex += MAX_QUADS_PER_DRAW)
 		{
 			gl.setVertexAttributes(attributes, bufferscopy);
+			gl.bindBuffer(BUFFER_INDEX, quadIndexBuffer->getHandle());
 
 			int quadcount = std::min(MAX_QUADS_PER_DRAW, count - quadindex);
 
@@ -473,12 +691,13 @@ void Graphics::setDebug(bool enable)
 
 void Graphics::setCanvasInternal(const RenderTargets &rts, int w, int h, int pixelw, int pixelh, bool hasSRGBcanvas)
 {
-	const DisplayState &state = states.back();
+	const DisplayState &state = displayState;
 
 	OpenGL::TempDebugGroup debuggroup("setCanvas");
 
 	flushStreamDraws();
 	endPass();
+	gpuTimer.endPass();
 
 	bool iswindow = rts.getFirstTarget().canvas == nullptr;
 	vertex::Winding vertexwinding = state.winding;
@@ -493,6 +712,14 @@ void Graphics::setCanvasInternal(const RenderTargets &rts, int w, int h, int pix
 	}
 	else
 	{
+		// Rendering to a smaller mip level would be overwritten by stale auto
+		// mipmaps, so they need to be brought up to date first.
+		for (const auto &rt : rts.colors)
+		{
+			if (rt.mipmap > 0)
+				rt.canvas->resolveMipmaps(true);
+		}
+
 		bindCachedFBO(rts);
 
 		projectionMatrix = Matrix4::ortho(0.0, (float) w, 0.0, (float) h, -10.0f, 10.0f);
@@ -517,20 +744,33 @@ void Graphics::setCanvasInternal(const RenderTargets &rts, int w, int h, int pix
 		if (hasSRGBcanvas != gl.isStateEnabled(OpenGL::ENABLE_FRAMEBUFFER_SRGB))
 			gl.setEnableState(OpenGL::ENABLE_FRAMEBUFFER_SRGB, hasSRGBcanvas);
 	}
+
+	gpuTimer.beginPass(rts.getFirstTarget().canvas);
 }
 
 void Graphics::endPass()
 {
-	auto &rts = states.back().renderTargets;
+	auto &rts = displayState.renderTargets;
 	love::graphics::Canvas *depthstencil = rts.depthStencil.canvas.get();
+	const RenderPassActions &actions = rts.actions;
+
+	bool storecolors = actions.colorStore == STORE_ACTION_STORE;
+	bool storedepth = actions.depthStore == STORE_ACTION_STORE;
+	bool storestencil = actions.stencilStore == STORE_ACTION_STORE;
 
 	// Discard the depth/stencil buffer if we're using an internal cached one.
 	if (depthstencil == nullptr && (rts.temporaryRTFlags & (TEMPORARY_RT_DEPTH | TEMPORARY_RT_STENCIL)) != 0)
-		discard({}, true);
+		discard(OpenGL::FRAMEBUFFER_ALL, {}, true, true);
+	else if (depthstencil != nullptr && (!storedepth || !storestencil))
+		discard(OpenGL::FRAMEBUFFER_ALL, {}, !storedepth, !storestencil);
+
+	// Discarded color buffers don't need to be resolved or written out.
+	if (!storecolors && rts.colors.size() > 0)
+		discard(OpenGL::FRAMEBUFFER_ALL, std::vector<bool>(rts.colors.size(), true), false, false);
 
 	// Resolve MSAA buffers. MSAA is only supported for 2D render targets so we
 	// don't have to worry about resolving to slices.
-	if (rts.colors.size() > 0 && rts.colors[0].canvas->getMSAA() > 1)
+	if (storecolors && rts.colors.size() > 0 && rts.colors[0].canvas->getMSAA() > 1)
 	{
 		int mip = rts.colors[0].mipmap;
 		int w = rts.colors[0].canvas->getPixelWidth(mip);
@@ -554,7 +794,8 @@ void Graphics::endPass()
 		}
 	}
 
-	if (depthstencil != nullptr && depthstencil->getMSAA() > 1 && depthstencil->isReadable())
+	if (depthstencil != nullptr && depthstencil->getMSAA() > 1 && depthstencil->isReadable()
+		&& (storedepth || storestencil))
 	{
 		gl.bindFramebuffer(OpenGL::FRAMEBUFFER_DRAW, ((Canvas *) depthstencil)->getFBO());
 
@@ -569,9 +810,9 @@ void Graphics::endPass()
 
 			GLbitfield mask = 0;
 
-			if (isPixelFormatDepth(format))
+			if (isPixelFormatDepth(format) && storedepth)
 				mask |= GL_DEPTH_BUFFER_BIT;
-			if (isPixelFormatStencil(format))
+			if (isPixelFormatStencil(format) && storestencil)
 				mask |= GL_STENCIL_BUFFER_BIT;
 
 			if (mask != 0)
@@ -579,19 +820,61 @@ void Graphics::endPass()
 		}
 	}
 
+	// Auto mipmaps are regenerated lazily, when the Canvas is next sampled.
 	for (const auto &rt : rts.colors)
 	{
-		if (rt.canvas->getMipmapMode() == Canvas::MIPMAPS_AUTO && rt.mipmap == 0)
-			rt.canvas->generateMipmaps();
+		if (storecolors && rt.canvas->getMipmapMode() == Canvas::MIPMAPS_AUTO && rt.mipmap == 0)
+			invalidateMipmaps(rt.canvas.get());
 	}
 
 	int dsmipmap = rts.depthStencil.mipmap;
-	if (depthstencil != nullptr && depthstencil->getMipmapMode() == Canvas::MIPMAPS_AUTO && dsmipmap == 0)
-		depthstencil->generateMipmaps();
+	if (depthstencil != nullptr && depthstencil->getMipmapMode() == Canvas::MIPMAPS_AUTO && dsmipmap == 0
+		&& (storedepth || storestencil))
+		invalidateMipmaps(depthstencil);
+}
+
+void Graphics::invalidateMipmaps(love::graphics::Canvas *canvas)
+{
+	if (canvas->isMipmapsDirty())
+		return;
+
+	canvas->setMipmapsDirty(true);
+
+	if (canvas->isMipmapsDirty())
+		dirtyMipmapCanvases.push_back(canvas);
+}
+
+void Graphics::resolveSampledMipmaps(love::graphics::Texture *texture, love::graphics::Shader *shader)
+{
+	if (dirtyMipmapCanvases.empty())
+		return;
+
+	Shader *glshader = (Shader *) shader;
+
+	for (auto it = dirtyMipmapCanvases.begin(); it != dirtyMipmapCanvases.end(); /**/)
+	{
+		love::graphics::Canvas *canvas = *it;
+
+		bool sampled = canvas == texture
+			|| (glshader != nullptr && glshader->hasTexture((GLuint) canvas->getHandle()));
+
+		// Canvases which were resolved elsewhere (by generateMipmaps or a
+		// mipmap readback) are dropped too.
+		if (sampled)
+			canvas->resolveMipmaps(false);
+
+		if (!canvas->isMipmapsDirty())
+			it = dirtyMipmapCanvases.erase(it);
+		else
+			++it;
+	}
 }
 
 void Graphics::clear(OptionalColorf c, OptionalInt stencil, OptionalDouble depth)
 {
+	if (stencil.hasValue && !c.hasValue && !depth.hasValue && deferStencilClear(stencil.value))
+		return;
+
 	if (c.hasValue || stencil.hasValue || depth.hasValue)
 		flushStreamDraws();
 
@@ -641,7 +924,7 @@ void Graphics::clear(const std::vector<OptionalColorf> &colors, OptionalInt sten
 	if (colors.size() == 0 && !stencil.hasValue && !depth.hasValue)
 		return;
 
-	int ncolorcanvases = (int) states.back().renderTargets.colors.size();
+	int ncolorcanvases = (int) displayState.renderTargets.colors.size();
 	int ncolors = (int) colors.size();
 
 	if (ncolors <= 1 && ncolorcanvases <= 1)
@@ -727,10 +1010,16 @@ void Graphics::clear(const std::vector<OptionalColorf> &colors, OptionalInt sten
 void Graphics::discard(const std::vector<bool> &colorbuffers, bool depthstencil)
 {
 	flushStreamDraws();
-	discard(OpenGL::FRAMEBUFFER_ALL, colorbuffers, depthstencil);
+	discard(OpenGL::FRAMEBUFFER_ALL, colorbuffers, depthstencil, depthstencil);
 }
 
-void Graphics::discard(OpenGL::FramebufferTarget target, const std::vector<bool> &colorbuffers, bool depthstencil)
+void Graphics::discard(const std::vector<bool> &colorbuffers, bool depth, bool stencil)
+{
+	flushStreamDraws();
+	discard(OpenGL::FRAMEBUFFER_ALL, colorbuffers, depth, stencil);
+}
+
+void Graphics::discard(OpenGL::FramebufferTarget target, const std::vector<bool> &colorbuffers, bool depth, bool stencil)
 {
 	if (!(GLAD_VERSION_4_3 || GLAD_ARB_invalidate_subdata || GLAD_ES_VERSION_3_0 || GLAD_EXT_discard_framebuffer))
 		return;
@@ -741,7 +1030,7 @@ void Graphics::discard(OpenGL::FramebufferTarget target, const std::vector<bool>
 	else if (target == OpenGL::FRAMEBUFFER_DRAW)
 		gltarget = GL_DRAW_FRAMEBUFFER;
 
-	std::vector<GLenum> attachments;
+	ScratchVector<GLenum> attachments;
 	attachments.reserve(colorbuffers.size());
 
 	// glDiscardFramebuffer uses different attachment enums for the default FBO.
@@ -750,15 +1039,14 @@ void Graphics::discard(OpenGL::FramebufferTarget target, const std::vector<bool>
 		if (colorbuffers.size() > 0 && colorbuffers[0])
 			attachments.push_back(GL_COLOR);
 
-		if (depthstencil)
-		{
+		if (stencil)
 			attachments.push_back(GL_STENCIL);
+		if (depth)
 			attachments.push_back(GL_DEPTH);
-		}
 	}
 	else
 	{
-		int rendertargetcount = std::max((int) states.back().renderTargets.colors.size(), 1);
+		int rendertargetcount = std::max((int) displayState.renderTargets.colors.size(), 1);
 
 		for (int i = 0; i < (int) colorbuffers.size(); i++)
 		{
@@ -766,13 +1054,15 @@ void Graphics::discard(OpenGL::FramebufferTarget target, const std::vector<bool>
 				attachments.push_back(GL_COLOR_ATTACHMENT0 + i);
 		}
 
-		if (depthstencil)
-		{
+		if (stencil)
 			attachments.push_back(GL_STENCIL_ATTACHMENT);
+		if (depth)
 			attachments.push_back(GL_DEPTH_ATTACHMENT);
-		}
 	}
 
+	if (attachments.empty())
+		return;
+
 	// Hint for the driver that it doesn't need to save these buffers.
 	if (GLAD_VERSION_4_3 || GLAD_ARB_invalidate_subdata || GLAD_ES_VERSION_3_0)
 		glInvalidateFramebuffer(gltarget, (GLint) attachments.size(), &attachments[0]);
@@ -780,6 +1070,73 @@ void Graphics::discard(OpenGL::FramebufferTarget target, const std::vector<bool>
 		glDiscardFramebufferEXT(gltarget, (GLint) attachments.size(), &attachments[0]);
 }
 
+void Graphics::updateBuiltinUniformBuffer()
+{
+	if (builtinUniformBuffer == nullptr)
+		return;
+
+	Shader::BuiltinUniformBlock &data = builtinUniformData;
+
+	const Matrix4 &curxform = getTransform();
+	const Matrix4 &curproj = getProjection();
+
+	bool xformchanged = memcmp(curxform.getElements(), data.viewFromLocal, sizeof(data.viewFromLocal)) != 0;
+	bool projchanged = memcmp(curproj.getElements(), data.clipFromView, sizeof(data.clipFromView)) != 0;
+
+	// See Shader::updateScreenParams.
+	Rect view = gl.getViewport();
+	float screensize[4] = {(float) view.w, (float) view.h, -1.0f, (float) view.h};
+	if (isCanvasActive())
+	{
+		screensize[2] = 1.0f;
+		screensize[3] = 0.0f;
+	}
+
+	bool screenchanged = memcmp(screensize, data.screenSize, sizeof(screensize)) != 0;
+
+	float pointsize = gl.getPointSize();
+
+	if (!builtinUniformsDirty && !xformchanged && !projchanged && !screenchanged && pointsize == data.pointSize)
+		return;
+
+	if (xformchanged || builtinUniformsDirty)
+	{
+		memcpy(data.viewFromLocal, curxform.getElements(), sizeof(data.viewFromLocal));
+
+		Matrix3 normalmatrix = Matrix3(curxform).transposedInverse();
+		const float *e = normalmatrix.getElements();
+		for (int column = 0; column < 3; column++)
+			memcpy(&data.viewNormalFromLocal[column * 4], &e[column * 3], sizeof(float) * 3);
+	}
+
+	if (projchanged || builtinUniformsDirty)
+		memcpy(data.clipFromView, curproj.getElements(), sizeof(data.clipFromView));
+
+	if (xformchanged || projchanged || builtinUniformsDirty)
+	{
+		Matrix4 tp_matrix(curproj, curxform);
+		memcpy(data.clipFromLocal, tp_matrix.getElements(), sizeof(data.clipFromLocal));
+	}
+
+	memcpy(data.screenSize, screensize, sizeof(screensize));
+	data.pointSize = pointsize;
+
+	// Each upload goes to a new part of the buffer, so draws which already
+	// used earlier values don't need to be flushed first.
+	size_t size = sizeof(Shader::BuiltinUniformBlock);
+	size_t alignment = (size_t) gl.getUniformBufferOffsetAlignment();
+	size_t alignedsize = ((size + alignment - 1) / alignment) * alignment;
+
+	StreamBuffer::MapInfo map = builtinUniformBuffer->map(alignedsize);
+	memcpy(map.data, &data, size);
+	size_t offset = builtinUniformBuffer->unmap(size);
+	builtinUniformBuffer->markUsed(alignedsize);
+
+	gl.bindUniformBuffer(Shader::BUILTIN_UNIFORM_BLOCK_BINDING, (GLuint) builtinUniformBuffer->getHandle(), offset, size);
+
+	builtinUniformsDirty = false;
+}
+
 void Graphics::cleanupCanvas(Canvas *canvas)
 {
 	for (auto it = framebufferObjects.begin(); it != framebufferObjects.end(); /**/)
@@ -807,6 +1164,8 @@ void Graphics::cleanupCanvas(Canvas *canvas)
 		else
 			++it;
 	}
+
+	dirtyMipmapCanvases.erase(std::remove(dirtyMipmapCanvases.begin(), dirtyMipmapCanvases.end(), canvas), dirtyMipmapCanvases.end());
 }
 
 void Graphics::bindCachedFBO(const RenderTargets &targets)
@@ -885,17 +1244,23 @@ void Graphics::bindCachedFBO(const RenderTargets &targets)
 
 void Graphics::present(void *screenshotCallbackData)
 {
+	LOVE_PROFILE_ZONE("Graphics:present");
+
 	if (!isActive())
 		return;
 
 	if (isCanvasActive())
 		throw love::Exception("present cannot be called while a Canvas is active.");
 
+	framePacer.beginPresent();
+
 	deprecations.draw(this);
 
 	flushStreamDraws();
 	endPass();
 
+	gpuTimer.endFrame();
+
 	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, gl.getDefaultFBO());
 
 	if (!pendingScreenshotCallbacks.empty())
@@ -903,24 +1268,6 @@ void Graphics::present(void *screenshotCallbackData)
 		int w = getPixelWidth();
 		int h = getPixelHeight();
 
-		size_t row = 4 * w;
-		size_t size = row * h;
-
-		GLubyte *pixels = nullptr;
-		GLubyte *screenshot = nullptr;
-
-		try
-		{
-			pixels = new GLubyte[size];
-			screenshot = new GLubyte[size];
-		}
-		catch (std::exception &)
-		{
-			delete[] pixels;
-			delete[] screenshot;
-			throw love::Exception("Out of memory.");
-		}
-
 #ifdef LOVE_IOS
 		SDL_SysWMinfo info = {};
 		SDL_VERSION(&info.version);
@@ -941,6 +1288,34 @@ void Graphics::present(void *screenshotCallbackData)
 		}
 #endif
 
+		if (ScreenshotCapture::isSupported())
+			screenshotCapture.capture(w, h, pendingScreenshotCallbacks);
+	}
+
+	// Synchronous fallback for when pixel buffers or sync objects are missing.
+	if (!pendingScreenshotCallbacks.empty())
+	{
+		int w = getPixelWidth();
+		int h = getPixelHeight();
+
+		size_t row = 4 * w;
+		size_t size = row * h;
+
+		GLubyte *pixels = nullptr;
+		GLubyte *screenshot = nullptr;
+
+		try
+		{
+			pixels = new GLubyte[size];
+			screenshot = new GLubyte[size];
+		}
+		catch (std::exception &)
+		{
+			delete[] pixels;
+			delete[] screenshot;
+			throw love::Exception("Out of memory.");
+		}
+
 		glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
 
 		// Replace alpha values with full opacity.
@@ -988,6 +1363,8 @@ void Graphics::present(void *screenshotCallbackData)
 		pendingScreenshotCallbacks.clear();
 	}
 
+	screenshotCapture.update(screenshotCallbackData);
+
 #ifdef LOVE_IOS
 	// Hack: SDL's color renderbuffer must be bound when swapBuffers is called.
 	SDL_SysWMinfo info = {};
@@ -1000,9 +1377,27 @@ void Graphics::present(void *screenshotCallbackData)
 		buffer->nextFrame();
 	streamBufferState.indexBuffer->nextFrame();
 
+	if (builtinUniformBuffer != nullptr)
+		builtinUniformBuffer->nextFrame();
+
 	auto window = getInstance<love::window::Window>(M_WINDOW);
 	if (window != nullptr)
+	{
+		framePacer.beginSwap();
 		window->swapBuffers();
+		framePacer.endSwap();
+	}
+
+	double fencewaittime = streamBufferState.indexBuffer->getFrameStats().mapStallTime;
+	for (StreamBuffer *buffer : streamBufferState.vb)
+		fencewaittime += buffer->getFrameStats().mapStallTime;
+
+	framePacer.endFrame(fencewaittime);
+
+	updateStreamBufferSizes();
+
+	// The main screen is the first pass of every frame.
+	gpuTimer.beginPass(nullptr);
 
 	// Reset the per-frame stat counts.
 	drawCalls = 0;
@@ -1010,6 +1405,13 @@ void Graphics::present(void *screenshotCallbackData)
 	canvasSwitchCount = 0;
 	drawCallsBatched = 0;
 
+	for (int i = 0; i < STREAM_FLUSH_MAX_ENUM; i++)
+		streamFlushCounts[i] = 0;
+
+	for (StreamBuffer *buffer : streamBufferState.vb)
+		buffer->resetFrameStats();
+	streamBufferState.indexBuffer->resetFrameStats();
+
 	// This assumes temporary canvases will only be used within a render pass.
 	for (int i = (int) temporaryCanvases.size() - 1; i >= 0; i--)
 	{
@@ -1022,13 +1424,23 @@ void Graphics::present(void *screenshotCallbackData)
 		else
 			temporaryCanvases[i].framesSinceUse++;
 	}
+
+	updateCanvasPool();
+	updateTextureBins();
+
+	updateTextureResidency();
+	updateImageLoaders();
+
+	Texture::advanceUsageFrame();
+
+	frameArena.reset();
 }
 
 void Graphics::setScissor(const Rect &rect)
 {
 	flushStreamDraws();
 
-	DisplayState &state = states.back();
+	DisplayState &state = displayState;
 
 	if (!gl.isStateEnabled(OpenGL::ENABLE_SCISSOR_TEST))
 		gl.setEnableState(OpenGL::ENABLE_SCISSOR_TEST, true);
@@ -1044,16 +1456,18 @@ void Graphics::setScissor(const Rect &rect)
 	// OpenGL's reversed y-coordinate is compensated for in OpenGL::setScissor.
 	gl.setScissor(glrect, isCanvasActive());
 
+	saveStateField(STATE_SCISSOR);
 	state.scissor = true;
 	state.scissorRect = rect;
 }
 
 void Graphics::setScissor()
 {
-	if (states.back().scissor)
+	if (displayState.scissor)
 		flushStreamDraws();
 
-	states.back().scissor = false;
+	saveStateField(STATE_SCISSOR);
+	displayState.scissor = false;
 
 	if (gl.isStateEnabled(OpenGL::ENABLE_SCISSOR_TEST))
 		gl.setEnableState(OpenGL::ENABLE_SCISSOR_TEST, false);
@@ -1061,7 +1475,7 @@ void Graphics::setScissor()
 
 void Graphics::drawToStencilBuffer(StencilAction action, int value)
 {
-	const auto &rts = states.back().renderTargets;
+	const auto &rts = displayState.renderTargets;
 	love::graphics::Canvas *dscanvas = rts.depthStencil.canvas.get();
 
 	if (!isCanvasActive() && !windowHasStencil)
@@ -1069,6 +1483,14 @@ void Graphics::drawToStencilBuffer(StencilAction action, int value)
 	else if (isCanvasActive() && (rts.temporaryRTFlags & TEMPORARY_RT_STENCIL) == 0 && (dscanvas == nullptr || !isPixelFormatStencil(dscanvas->getPixelFormat())))
 		throw love::Exception("Drawing to the stencil buffer with a Canvas active requires either stencil=true or a custom stencil-type Canvas to be used, in setCanvas.");
 
+	if (deferStencilStateChange())
+	{
+		deferredStencilWrite.active = true;
+		deferredStencilWrite.action = action;
+		deferredStencilWrite.value = value;
+		return;
+	}
+
 	flushStreamDraws();
 
 	writingToStencil = true;
@@ -1111,6 +1533,12 @@ void Graphics::drawToStencilBuffer(StencilAction action, int value)
 
 void Graphics::stopDrawToStencilBuffer()
 {
+	if (deferStencilStateChange())
+	{
+		deferredStencilWrite.active = false;
+		return;
+	}
+
 	if (!writingToStencil)
 		return;
 
@@ -1118,7 +1546,7 @@ void Graphics::stopDrawToStencilBuffer()
 
 	writingToStencil = false;
 
-	const DisplayState &state = states.back();
+	const DisplayState &state = displayState;
 
 	// Revert the color write mask.
 	setColorMask(state.colorMask);
@@ -1129,7 +1557,16 @@ void Graphics::stopDrawToStencilBuffer()
 
 void Graphics::setStencilTest(CompareMode compare, int value)
 {
-	DisplayState &state = states.back();
+	DisplayState &state = displayState;
+
+	saveStateField(STATE_STENCIL);
+
+	if (deferStencilStateChange())
+	{
+		state.stencilCompare = compare;
+		state.stencilTestValue = value;
+		return;
+	}
 
 	if (state.stencilCompare != compare || state.stencilTestValue != value)
 		flushStreamDraws();
@@ -1166,11 +1603,12 @@ void Graphics::setStencilTest(CompareMode compare, int value)
 
 void Graphics::setDepthMode(CompareMode compare, bool write)
 {
-	DisplayState &state = states.back();
+	DisplayState &state = displayState;
 
 	if (state.depthTest != compare || state.depthWrite != write)
 		flushStreamDraws();
 
+	saveStateField(STATE_DEPTH);
 	state.depthTest = compare;
 	state.depthWrite = write;
 
@@ -1188,11 +1626,12 @@ void Graphics::setDepthMode(CompareMode compare, bool write)
 
 void Graphics::setFrontFaceWinding(vertex::Winding winding)
 {
-	DisplayState &state = states.back();
+	DisplayState &state = displayState;
 
 	if (state.winding != winding)
 		flushStreamDraws();
 
+	saveStateField(STATE_WINDING);
 	state.winding = winding;
 
 	if (isCanvasActive())
@@ -1210,7 +1649,8 @@ void Graphics::setColor(Colorf c)
 
 	gl.setConstantColor(c);
 
-	states.back().color = c;
+	saveStateField(STATE_COLOR);
+	displayState.color = c;
 }
 
 void Graphics::setColorMask(ColorMask mask)
@@ -1218,12 +1658,14 @@ void Graphics::setColorMask(ColorMask mask)
 	flushStreamDraws();
 
 	glColorMask(mask.r, mask.g, mask.b, mask.a);
-	states.back().colorMask = mask;
+	saveStateField(STATE_COLOR_MASK);
+	displayState.colorMask = mask;
 }
 
 void Graphics::setBlendMode(BlendMode mode, BlendAlpha alphamode)
 {
-	if (mode != states.back().blendMode || alphamode != states.back().blendAlphaMode)
+	bool changed = mode != displayState.blendMode || alphamode != displayState.blendAlphaMode;
+	if (changed && !isRecordingDeferredDraws())
 		flushStreamDraws();
 
 	if (mode == BLEND_LIGHTEN || mode == BLEND_DARKEN)
@@ -1289,6 +1731,15 @@ void Graphics::setBlendMode(BlendMode mode, BlendAlpha alphamode)
 		break;
 	}
 
+	saveStateField(STATE_BLEND);
+
+	if (deferDrawStateChange())
+	{
+		displayState.blendMode = mode;
+		displayState.blendAlphaMode = alphamode;
+		return;
+	}
+
 	// We can only do alpha-multiplication when srcRGB would have been unmodified.
 	if (srcRGB == GL_ONE && alphamode == BLENDALPHA_MULTIPLY && mode != BLEND_NONE)
 		srcRGB = GL_SRC_ALPHA;
@@ -1296,8 +1747,8 @@ void Graphics::setBlendMode(BlendMode mode, BlendAlpha alphamode)
 	glBlendEquation(func);
 	glBlendFuncSeparate(srcRGB, dstRGB, srcA, dstA);
 
-	states.back().blendMode = mode;
-	states.back().blendAlphaMode = alphamode;
+	displayState.blendMode = mode;
+	displayState.blendAlphaMode = alphamode;
 }
 
 void Graphics::setPointSize(float size)
@@ -1306,7 +1757,8 @@ void Graphics::setPointSize(float size)
 		flushStreamDraws();
 
 	gl.setPointSize(size * getCurrentDPIScale());
-	states.back().pointSize = size;
+	saveStateField(STATE_POINT_SIZE);
+	displayState.pointSize = size;
 }
 
 void Graphics::setWireframe(bool enable)
@@ -1318,7 +1770,8 @@ void Graphics::setWireframe(bool enable)
 	flushStreamDraws();
 
 	glPolygonMode(GL_FRONT_AND_BACK, enable ? GL_LINE : GL_FILL);
-	states.back().wireframe = enable;
+	saveStateField(STATE_WIREFRAME);
+	displayState.wireframe = enable;
 }
 
 Graphics::Renderer Graphics::getRenderer() const
@@ -1371,7 +1824,13 @@ void Graphics::initCapabilities()
 	capabilities.features[FEATURE_SHADER_DERIVATIVES] = GLAD_VERSION_2_0 || GLAD_ES_VERSION_3_0 || GLAD_OES_standard_derivatives;
 	capabilities.features[FEATURE_GLSL3] = GLAD_ES_VERSION_3_0 || gl.isCoreProfile();
 	capabilities.features[FEATURE_INSTANCING] = gl.isInstancingSupported();
-	static_assert(FEATURE_MAX_ENUM == 8, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
+	capabilities.features[FEATURE_GPU_TIMING] = gl.isTimerQuerySupported();
+	capabilities.features[FEATURE_GPU_PARTICLES] = GPUParticleSimulator::isSupported();
+	capabilities.features[FEATURE_DRAW_INDIRECT] = gl.isDrawIndirectSupported();
+	capabilities.features[FEATURE_FRAME_LATENCY_LIMIT] = FramePacer::isLatencyLimitSupported();
+	capabilities.features[FEATURE_COMPUTE] = gl.isComputeSupported();
+	capabilities.features[FEATURE_OCCLUSION_QUERY] = gl.isOcclusionQuerySupported();
+	static_assert(FEATURE_MAX_ENUM == 14, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
 
 	capabilities.limits[LIMIT_POINT_SIZE] = gl.getMaxPointSize();
 	capabilities.limits[LIMIT_TEXTURE_SIZE] = gl.getMax2DTextureSize();
@@ -1381,7 +1840,8 @@ void Graphics::initCapabilities()
 	capabilities.limits[LIMIT_MULTI_CANVAS] = gl.getMaxRenderTargets();
 	capabilities.limits[LIMIT_CANVAS_MSAA] = gl.getMaxRenderbufferSamples();
 	capabilities.limits[LIMIT_ANISOTROPY] = gl.getMaxAnisotropy();
-	static_assert(LIMIT_MAX_ENUM == 8, "Graphics::initCapabilities must be updated when adding a new system limit!");
+	capabilities.limits[LIMIT_THREADGROUPS] = gl.getMaxThreadgroups();
+	static_assert(LIMIT_MAX_ENUM == 9, "Graphics::initCapabilities must be updated when adding a new system limit!");
 
 	for (int i = 0; i < TEXTURE_MAX_ENUM; i++)
 		capabilities.textureTypes[i] = gl.isTextureTypeSupported((TextureType) i);
@@ -1414,6 +1874,263 @@ Shader::Language Graphics::getShaderLanguageTarget() const
 		return Shader::LANGUAGE_GLSL1;
 }
 
+void Graphics::setGPUTimingEnabled(bool enable)
+{
+	if (enable && !capabilities.features[FEATURE_GPU_TIMING])
+		throw love::Exception("GPU timing is not supported on this system.");
+
+	gpuTimer.setEnabled(enable);
+}
+
+bool Graphics::isGPUTimingEnabled() const
+{
+	return gpuTimer.isEnabled();
+}
+
+bool Graphics::getGPUTimings(GPUTimings &timings) const
+{
+	return gpuTimer.getTimings(timings);
+}
+
+Graphics::FrameTimings Graphics::getFrameTimings() const
+{
+	return framePacer.getTimings();
+}
+
+void Graphics::setMaxFramesInFlight(int frames)
+{
+	framePacer.setMaxFramesInFlight(frames);
+}
+
+int Graphics::getMaxFramesInFlight() const
+{
+	return framePacer.getMaxFramesInFlight();
+}
+
+void Graphics::setLatencyMode(LatencyMode mode)
+{
+	framePacer.setLatencyMode(mode);
+	updateFramePacerDisplayInfo();
+}
+
+Graphics::LatencyMode Graphics::getLatencyMode() const
+{
+	return framePacer.getLatencyMode();
+}
+
+bool Graphics::isBackgroundUploadActive() const
+{
+	if (loaderThread != nullptr)
+		return backgroundUploads;
+
+	auto window = getInstance<love::window::Window>(M_WINDOW);
+
+	return backgroundUploads && isCreated() && !loaderThreadFailed
+		&& LoaderThread::isSupported() && window != nullptr && !window->isHeadless();
+}
+
+LoaderThread *Graphics::getLoaderThread()
+{
+	if (!backgroundUploads || !isCreated())
+		return nullptr;
+
+	if (loaderThread != nullptr || loaderThreadFailed)
+		return loaderThread;
+
+	// Only try once per context.
+	loaderThreadFailed = true;
+
+	auto window = getInstance<love::window::Window>(M_WINDOW);
+
+	if (window == nullptr || !LoaderThread::isSupported())
+		return nullptr;
+
+	void *context = window->createSharedGLContext();
+
+	if (context == nullptr)
+		return nullptr;
+
+	LoaderThread *thread = new LoaderThread(window, context);
+
+	if (!thread->start())
+	{
+		delete thread;
+		return nullptr;
+	}
+
+	if (!thread->waitForStartup())
+	{
+		thread->stop();
+		delete thread;
+		return nullptr;
+	}
+
+	loaderThread = thread;
+	loaderThreadFailed = false;
+
+	return loaderThread;
+}
+
+void Graphics::dispatchThreadgroups(love::graphics::Shader *shader, int x, int y, int z)
+{
+	if (!capabilities.features[FEATURE_COMPUTE])
+		throw love::Exception("Compute shaders are not supported on this system.");
+
+	if (!shader->isCompute())
+		throw love::Exception("Only compute shaders can be dispatched.");
+
+	if (x <= 0 || y <= 0 || z <= 0)
+		throw love::Exception("Threadgroup counts must be greater than 0.");
+
+	const int maxcount = (int) capabilities.limits[LIMIT_THREADGROUPS];
+	if (x > maxcount || y > maxcount || z > maxcount)
+		throw love::Exception("Threadgroup counts must not exceed %d.", maxcount);
+
+	flushStreamDraws();
+
+	shader->finishLoading();
+
+	resolveSampledMipmaps(nullptr, shader);
+
+	love::graphics::Shader *prevshader = Shader::current;
+
+	Shader *glshader = (Shader *) shader;
+	glshader->attach();
+	glshader->updateBuiltinUniforms();
+
+	// Meshes may have been modified since the shader was last attached.
+	glshader->bindStorageBuffers();
+
+	glDispatchCompute((GLuint) x, (GLuint) y, (GLuint) z);
+
+	if (prevshader != nullptr)
+		prevshader->attach();
+	else
+		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+}
+
+void Graphics::copyTextureInternal(love::graphics::Texture *src, love::graphics::Texture *dst, const Rect &srcrect, int srcslice, int srcmipmap, int dstx, int dsty, int dstslice, int dstmipmap)
+{
+	love::graphics::Canvas *srccanvas = dynamic_cast<love::graphics::Canvas *>(src);
+	if (srccanvas != nullptr && srcmipmap > 0)
+		srccanvas->resolveMipmaps(true);
+
+	GLuint srchandle = (GLuint) src->getHandle();
+	GLuint dsthandle = (GLuint) dst->getHandle();
+
+	if (gl.isCopyImageSupported())
+	{
+		// Cube map faces and array layers are both given as the z coordinate.
+		glCopyImageSubData(srchandle, OpenGL::getGLTextureType(src->getTextureType()), srcmipmap, srcrect.x, srcrect.y, srcslice,
+		                   dsthandle, OpenGL::getGLTextureType(dst->getTextureType()), dstmipmap, dstx, dsty, dstslice,
+		                   srcrect.w, srcrect.h, 1);
+		return;
+	}
+
+	if (!gl.isFramebufferBlitSupported())
+		throw love::Exception("Copying textures is not supported on this system.");
+
+	if (!isCanvasFormatSupported(src->getPixelFormat()))
+	{
+		const char *fstr = "unknown";
+		love::getConstant(src->getPixelFormat(), fstr);
+		throw love::Exception("Textures with the %s format cannot be copied on this system.", fstr);
+	}
+
+	GLuint prevdrawfbo = gl.getFramebuffer(OpenGL::FRAMEBUFFER_DRAW);
+	GLuint prevreadfbo = gl.getFramebuffer(OpenGL::FRAMEBUFFER_READ);
+
+	if (copyFBOs[0] == 0)
+		glGenFramebuffers(2, copyFBOs);
+
+	love::graphics::Texture *textures[] = {src, dst};
+	GLuint handles[] = {srchandle, dsthandle};
+	int slices[] = {srcslice, dstslice};
+	int mipmaps[] = {srcmipmap, dstmipmap};
+
+	for (int i = 0; i < 2; i++)
+	{
+		TextureType textype = textures[i]->getTextureType();
+		int layer = textype == TEXTURE_CUBE ? 0 : slices[i];
+		int face = textype == TEXTURE_CUBE ? slices[i] : 0;
+
+		gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, copyFBOs[i]);
+		gl.framebufferTexture(GL_COLOR_ATTACHMENT0, textype, handles[i], mipmaps[i], layer, face);
+	}
+
+	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_READ, copyFBOs[0]);
+
+	// Blits are affected by the scissor test and sRGB conversions.
+	bool scissor = gl.isStateEnabled(OpenGL::ENABLE_SCISSOR_TEST);
+	bool srgb = gl.isStateEnabled(OpenGL::ENABLE_FRAMEBUFFER_SRGB);
+
+	if (scissor)
+		gl.setEnableState(OpenGL::ENABLE_SCISSOR_TEST, false);
+	if (srgb)
+		gl.setEnableState(OpenGL::ENABLE_FRAMEBUFFER_SRGB, false);
+
+	glBlitFramebuffer(srcrect.x, srcrect.y, srcrect.x + srcrect.w, srcrect.y + srcrect.h,
+	                  dstx, dsty, dstx + srcrect.w, dsty + srcrect.h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+	if (scissor)
+		gl.setEnableState(OpenGL::ENABLE_SCISSOR_TEST, true);
+	if (srgb)
+		gl.setEnableState(OpenGL::ENABLE_FRAMEBUFFER_SRGB, true);
+
+	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_DRAW, prevdrawfbo);
+	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_READ, prevreadfbo);
+}
+
+void Graphics::memoryBarrier(uint32 flags)
+{
+	if (!capabilities.features[FEATURE_COMPUTE])
+		throw love::Exception("Compute shaders are not supported on this system.");
+
+	flushStreamDraws();
+
+	GLbitfield barriers = 0;
+
+	if (flags & (1 << MEMORY_BARRIER_ALL))
+		barriers = GL_ALL_BARRIER_BITS;
+	else
+	{
+		if (flags & (1 << MEMORY_BARRIER_STORAGE_BUFFER))
+			barriers |= GL_SHADER_STORAGE_BARRIER_BIT;
+		if (flags & (1 << MEMORY_BARRIER_IMAGE))
+			barriers |= GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+		if (flags & (1 << MEMORY_BARRIER_TEXTURE))
+			barriers |= GL_TEXTURE_FETCH_BARRIER_BIT;
+		if (flags & (1 << MEMORY_BARRIER_VERTEX_BUFFER))
+			barriers |= GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT;
+		if (flags & (1 << MEMORY_BARRIER_INDEX_BUFFER))
+			barriers |= GL_ELEMENT_ARRAY_BARRIER_BIT;
+		if (flags & (1 << MEMORY_BARRIER_INDIRECT))
+			barriers |= GL_COMMAND_BARRIER_BIT;
+		if (flags & (1 << MEMORY_BARRIER_UNIFORM_BUFFER))
+			barriers |= GL_UNIFORM_BARRIER_BIT;
+		if (flags & (1 << MEMORY_BARRIER_FRAMEBUFFER))
+			barriers |= GL_FRAMEBUFFER_BARRIER_BIT;
+		if (flags & (1 << MEMORY_BARRIER_BUFFER_UPDATE))
+			barriers |= GL_BUFFER_UPDATE_BARRIER_BIT;
+	}
+
+	if (barriers != 0)
+		glMemoryBarrier(barriers);
+}
+
+void Graphics::updateFramePacerDisplayInfo()
+{
+	auto window = Module::getInstance<love::window::Window>(M_WINDOW);
+	if (window == nullptr || !window->isOpen())
+		return;
+
+	int w, h;
+	love::window::WindowSettings settings;
+	window->getWindow(w, h, settings);
+
+	framePacer.setDisplayInfo(settings.refreshrate, settings.vsync != 0);
+}
+
 } // opengl
 } // graphics
 } // love
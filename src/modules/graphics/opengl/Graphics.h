@@ -39,6 +39,10 @@
 #include "Image.h"
 #include "Canvas.h"
 #include "Shader.h"
+#include "GPUTimer.h"
+#include "FramePacer.h"
+#include "ScreenshotCapture.h"
+#include "LoaderThread.h"
 
 #include "libraries/xxHash/xxhash.h"
 
@@ -64,6 +68,9 @@ public:
 	love::graphics::Image *newImage(TextureType textype, PixelFormat format, int width, int height, int slices, const Image::Settings &settings) override;
 	love::graphics::Canvas *newCanvas(const Canvas::Settings &settings) override;
 	love::graphics::Buffer *newBuffer(size_t size, const void *data, BufferType type, vertex::Usage usage, uint32 mapflags) override;
+	love::graphics::GPUParticleSimulator *newGPUParticleSimulator(uint32 size) override;
+	love::graphics::VideoRecorder *newVideoRecorder(const std::string &target, int width, int height, const VideoRecorder::Settings &settings) override;
+	love::graphics::OcclusionQuery *newOcclusionQuery(bool conservative) override;
 
 	void setViewportSize(int width, int height, int pixelwidth, int pixelheight) override;
 	bool setMode(int width, int height, int pixelwidth, int pixelheight, bool windowhasstencil) override;
@@ -73,12 +80,14 @@ public:
 
 	void draw(const DrawCommand &cmd) override;
 	void draw(const DrawIndexedCommand &cmd) override;
-	void drawQuads(int start, int count, const vertex::Attributes &attributes, const vertex::Buffers &buffers, Texture *texture) override;
+	void draw(const DrawIndirectCommand &cmd) override;
+	void drawQuads(int start, int count, const vertex::Attributes &attributes, const vertex::Buffers &buffers, Texture *texture, bool cacheVertexArray = false) override;
 
 	void clear(OptionalColorf color, OptionalInt stencil, OptionalDouble depth) override;
 	void clear(const std::vector<OptionalColorf> &colors, OptionalInt stencil, OptionalDouble depth) override;
 
 	void discard(const std::vector<bool> &colorbuffers, bool depthstencil) override;
+	void discard(const std::vector<bool> &colorbuffers, bool depth, bool stencil) override;
 
 	void present(void *screenshotCallbackData) override;
 
@@ -112,9 +121,42 @@ public:
 
 	Shader::Language getShaderLanguageTarget() const override;
 
+	void setGPUTimingEnabled(bool enable) override;
+	bool isGPUTimingEnabled() const override;
+	bool getGPUTimings(GPUTimings &timings) const override;
+
+	FrameTimings getFrameTimings() const override;
+	void setMaxFramesInFlight(int frames) override;
+	int getMaxFramesInFlight() const override;
+	void setLatencyMode(LatencyMode mode) override;
+	LatencyMode getLatencyMode() const override;
+
+	bool isBackgroundUploadActive() const override;
+
+	void dispatchThreadgroups(love::graphics::Shader *shader, int x, int y, int z) override;
+	void memoryBarrier(uint32 flags) override;
+
 	// Internal use.
 	void cleanupCanvas(Canvas *canvas);
 
+	/**
+	 * Flags a Canvas' auto mipmaps as stale. They're regenerated right before
+	 * the next draw which samples the Canvas with a mipmap filter.
+	 **/
+	void invalidateMipmaps(love::graphics::Canvas *canvas);
+
+	/**
+	 * Uploads the values of the built-in uniform block for the next draw, if
+	 * they've changed since the last one. Used by shaders which have the block.
+	 **/
+	void updateBuiltinUniformBuffer();
+
+	/**
+	 * Gets the thread background uploads are done on, starting it the first
+	 * time. Returns null if background uploads are disabled or unsupported.
+	 **/
+	LoaderThread *getLoaderThread();
+
 private:
 
 	struct CachedFBOHasher
@@ -136,23 +178,55 @@ private:
 		}
 	};
 
-	love::graphics::ShaderStage *newShaderStageInternal(ShaderStage::StageType stage, const std::string &cachekey, const std::string &source, bool gles) override;
-	love::graphics::Shader *newShaderInternal(love::graphics::ShaderStage *vertex, love::graphics::ShaderStage *pixel) override;
+	love::graphics::ShaderStage *newShaderStageInternal(ShaderStage::StageType stage, const std::string &cachekey, const std::string &source, bool gles, bool deferValidation) override;
+	love::graphics::Shader *newShaderInternal(love::graphics::ShaderStage *vertex, love::graphics::ShaderStage *pixel, bool async) override;
+	love::graphics::Shader *newComputeShaderInternal(love::graphics::ShaderStage *compute) override;
+	void copyTextureInternal(love::graphics::Texture *src, love::graphics::Texture *dst, const Rect &srcrect, int srcslice, int srcmipmap, int dstx, int dsty, int dstslice, int dstmipmap) override;
 	love::graphics::StreamBuffer *newStreamBuffer(BufferType type, size_t size) override;
 	void setCanvasInternal(const RenderTargets &rts, int w, int h, int pixelw, int pixelh, bool hasSRGBcanvas) override;
 	void initCapabilities() override;
 	void getAPIStats(int &shaderswitches) const override;
 
 	void endPass();
+	void resolveSampledMipmaps(love::graphics::Texture *texture, love::graphics::Shader *shader);
 	void bindCachedFBO(const RenderTargets &targets);
-	void discard(OpenGL::FramebufferTarget target, const std::vector<bool> &colorbuffers, bool depthstencil);
+	void discard(OpenGL::FramebufferTarget target, const std::vector<bool> &colorbuffers, bool depth, bool stencil);
 
 	void setDebug(bool enable);
 
+	// Stands in for the window's framebuffer when the window is headless.
+	void createHeadlessFramebuffer(int pixelwidth, int pixelheight);
+	void destroyHeadlessFramebuffer();
+
+	// Tells the frame pacer about the window's refresh rate and vsync.
+	void updateFramePacerDisplayInfo();
+
 	std::unordered_map<RenderTargets, GLuint, CachedFBOHasher> framebufferObjects;
+
+	// Canvases whose auto mipmaps were invalidated by rendering to them.
+	std::vector<love::graphics::Canvas *> dirtyMipmapCanvases;
 	bool windowHasStencil;
 	GLuint mainVAO;
 
+	GLuint headlessFBO;
+	GLuint headlessRenderbuffers[2];
+
+	// Read and draw framebuffers for texture copies without glCopyImageSubData.
+	GLuint copyFBOs[2];
+
+	GPUTimer gpuTimer;
+	FramePacer framePacer;
+	ScreenshotCapture screenshotCapture;
+
+	// Created on demand, and stopped when the context is destroyed.
+	LoaderThread *loaderThread;
+	bool loaderThreadFailed;
+
+	// Ring of built-in uniform block contents, shared by all shaders.
+	love::graphics::StreamBuffer *builtinUniformBuffer;
+	Shader::BuiltinUniformBlock builtinUniformData;
+	bool builtinUniformsDirty;
+
 }; // Graphics
 
 } // opengl
@@ -0,0 +1,162 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "GraphicsReadback.h"
+#include "Canvas.h"
+
+// C
+#include <cstring>
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+GraphicsReadback::GraphicsReadback(Canvas *canvas, love::image::ImageData *data, int slice, int mipmap, const Rect &r)
+	: love::graphics::GraphicsReadback(data)
+	, pbo(0)
+{
+	bool supported = isSupported();
+
+	bool isSRGB = false;
+	OpenGL::TextureFormat fmt = gl.convertPixelFormat(data->getFormat(), false, isSRGB);
+
+	TextureType textype = canvas->getTextureType();
+	GLuint texture = (GLuint) canvas->getHandle();
+
+	GLuint current_fbo = gl.getFramebuffer(OpenGL::FRAMEBUFFER_ALL);
+	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, canvas->getFBO());
+
+	if (slice > 0 || mipmap > 0)
+	{
+		int layer = textype == TEXTURE_CUBE ? 0 : slice;
+		int face = textype == TEXTURE_CUBE ? slice : 0;
+		gl.framebufferTexture(GL_COLOR_ATTACHMENT0, textype, texture, mipmap, layer, face);
+	}
+
+	if (supported)
+	{
+		glGenBuffers(1, &pbo);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+		glBufferData(GL_PIXEL_PACK_BUFFER, data->getSize(), nullptr, GL_STREAM_READ);
+
+		glReadPixels(r.x, r.y, r.w, r.h, fmt.externalformat, fmt.type, nullptr);
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		sync.fence();
+	}
+	else
+	{
+		glReadPixels(r.x, r.y, r.w, r.h, fmt.externalformat, fmt.type, data->getData());
+		complete = true;
+	}
+
+	if (slice > 0 || mipmap > 0)
+		gl.framebufferTexture(GL_COLOR_ATTACHMENT0, textype, texture, 0, 0, 0);
+
+	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, current_fbo);
+
+	// Make sure the fence (and the read) are submitted to the GPU, otherwise
+	// polling could never see it complete.
+	if (supported)
+		glFlush();
+}
+
+GraphicsReadback::~GraphicsReadback()
+{
+	if (pbo != 0)
+	{
+		glDeleteBuffers(1, &pbo);
+		pbo = 0;
+	}
+}
+
+bool GraphicsReadback::isSupported()
+{
+	bool pbo = GLAD_VERSION_3_0 || GLAD_ES_VERSION_3_0
+		|| (GLAD_ARB_pixel_buffer_object && (GLAD_ARB_map_buffer_range || GLAD_EXT_map_buffer_range));
+
+	bool sync = GLAD_VERSION_3_2 || GLAD_ES_VERSION_3_0 || GLAD_ARB_sync;
+
+	return pbo && sync;
+}
+
+bool GraphicsReadback::update()
+{
+	if (!complete && sync.isSignaled())
+		finish();
+
+	return complete;
+}
+
+void GraphicsReadback::wait()
+{
+	if (complete)
+		return;
+
+	sync.cpuWait();
+	finish();
+}
+
+void GraphicsReadback::finish()
+{
+	if (complete || pbo == 0)
+		return;
+
+	size_t size = imageData->getSize();
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+
+	const void *src = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+
+	if (src != nullptr)
+	{
+		love::thread::Lock lock(imageData->getMutex());
+		memcpy(imageData->getData(), src, size);
+	}
+
+	glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	glDeleteBuffers(1, &pbo);
+	pbo = 0;
+
+	sync.cleanup();
+	complete = true;
+}
+
+bool GraphicsReadback::loadVolatile()
+{
+	return true;
+}
+
+void GraphicsReadback::unloadVolatile()
+{
+	// The buffer won't survive the context going away, so finish the copy
+	// while it still exists.
+	wait();
+}
+
+} // opengl
+} // graphics
+} // love
@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "graphics/GraphicsReadback.h"
+#include "graphics/Volatile.h"
+#include "common/math.h"
+#include "OpenGL.h"
+#include "FenceSync.h"
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+class Canvas;
+
+/**
+ * Reads pixels into a pixel pack buffer guarded by a FenceSync, and copies
+ * them into the ImageData once the fence has been reached. Falls back to a
+ * synchronous glReadPixels when PBOs or sync objects aren't supported.
+ **/
+class GraphicsReadback final : public love::graphics::GraphicsReadback, public Volatile
+{
+public:
+
+	GraphicsReadback(Canvas *canvas, love::image::ImageData *data, int slice, int mipmap, const Rect &rect);
+	virtual ~GraphicsReadback();
+
+	// Implements love::graphics::GraphicsReadback.
+	bool update() override;
+	void wait() override;
+
+	// Implements Volatile.
+	bool loadVolatile() override;
+	void unloadVolatile() override;
+
+	static bool isSupported();
+
+private:
+
+	void finish();
+
+	GLuint pbo;
+	FenceSync sync;
+
+}; // GraphicsReadback
+
+} // opengl
+} // graphics
+} // love
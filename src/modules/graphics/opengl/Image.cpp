@@ -20,11 +20,12 @@
 
 #include "Image.h"
 
-#include "graphics/Graphics.h"
+#include "Graphics.h"
 #include "common/int.h"
 
 // STD
 #include <algorithm> // for min/max
+#include <cstring>
 
 namespace love
 {
@@ -33,9 +34,22 @@ namespace graphics
 namespace opengl
 {
 
+// Images drawn within this many frames before the context was lost are
+// reloaded with their data right away.
+static const uint32 RESTORE_IMMEDIATE_FRAMES = 2;
+
 Image::Image(TextureType textype, PixelFormat format, int width, int height, int slices, const Settings &settings)
 	: love::graphics::Image(textype, format, width, height, slices, settings)
 	, texture(0)
+	, asyncRestore(false)
+	, stagingBuffer(0)
+	, streamBuffer(0)
+	, streamMap(nullptr)
+	, streamRegionSize(0)
+	, streamRegion(0)
+	, loaderThread(nullptr)
+	, loaderJob(0)
+	, loaderError(GL_NO_ERROR)
 {
 	loadVolatile();
 }
@@ -43,6 +57,15 @@ Image::Image(TextureType textype, PixelFormat format, int width, int height, int
 Image::Image(const Slices &slices, const Settings &settings)
 	: love::graphics::Image(slices, settings)
 	, texture(0)
+	, asyncRestore(false)
+	, stagingBuffer(0)
+	, streamBuffer(0)
+	, streamMap(nullptr)
+	, streamRegionSize(0)
+	, streamRegion(0)
+	, loaderThread(nullptr)
+	, loaderJob(0)
+	, loaderError(GL_NO_ERROR)
 {
 	loadVolatile();
 }
@@ -88,8 +111,67 @@ void Image::loadDefaultTexture()
 		uploadByteData(PIXELFORMAT_RGBA8, px, sizeof(px), 0, slice, rect);
 }
 
+void Image::loadPlaceholderTexture()
+{
+	gl.bindTextureToUnit(this, 0, false);
+
+	Texture::Filter f = filter;
+	f.min = f.mag = FILTER_NEAREST;
+	f.mipmap = FILTER_NONE;
+	gl.setTextureFilter(texType, f);
+
+	if (GLAD_ES_VERSION_3_0 || GLAD_VERSION_1_0)
+		glTexParameteri(OpenGL::getGLTextureType(texType), GL_TEXTURE_MAX_LEVEL, 0);
+
+	bool isSRGB = false;
+	gl.rawTexStorage(texType, 1, PIXELFORMAT_RGBA8, isSRGB, 1, 1, 1);
+
+	GLubyte px[] = {0x00, 0x00, 0x00, 0x00};
+
+	int slices = texType == TEXTURE_CUBE ? 6 : 1;
+	Rect rect = {0, 0, 1, 1};
+	for (int slice = 0; slice < slices; slice++)
+		uploadByteData(PIXELFORMAT_RGBA8, px, sizeof(px), 0, slice, rect);
+
+	setGraphicsMemorySize(0);
+}
+
+void Image::evictTexture()
+{
+	unloadVolatile();
+
+	glGenTextures(1, &texture);
+	loadPlaceholderTexture();
+}
+
+void Image::restoreTexture(bool async)
+{
+	unloadVolatile();
+
+	asyncRestore = async;
+
+	try
+	{
+		loadVolatile();
+	}
+	catch (love::Exception &)
+	{
+		asyncRestore = false;
+		throw;
+	}
+
+	asyncRestore = false;
+}
+
 void Image::loadData()
 {
+	// Deferred uploads have to start over if the texture is re-created.
+	if (uploadPending)
+		resetPendingUpload();
+
+	if (streaming)
+		return loadStreamingData();
+
 	int mipcount = getMipmapCount();
 	int slicecount = 1;
 
@@ -132,7 +214,7 @@ void Image::loadData()
 		{
 			love::image::ImageDataBase *id = data.get(slice, mip);
 
-			if (id != nullptr)
+			if (id != nullptr && !uploadPending)
 				uploadImageData(id, mip, slice, 0, 0);
 		}
 
@@ -143,16 +225,89 @@ void Image::loadData()
 			d = std::max(d / 2, 1);
 	}
 
-	if (mipmapsType == MIPMAPS_GENERATED)
+	if (mipmapsType == MIPMAPS_GENERATED && !uploadPending)
 		generateMipmaps();
 }
 
+void Image::loadStreamingData()
+{
+	// Streaming Images use mutable storage for each level, so levels can be
+	// allocated and released individually. Only the resident levels are
+	// (re-)created, a partially streamed level is lost.
+	streamingMipmap = -1;
+	streamRow = 0;
+
+	OpenGL::TextureFormat fmt = gl.convertPixelFormat(format, false, sRGB);
+
+	if (fmt.swizzled)
+	{
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, fmt.swizzle[0]);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, fmt.swizzle[1]);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, fmt.swizzle[2]);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, fmt.swizzle[3]);
+	}
+
+	for (int mip = residentMipmap; mip < getMipmapCount(); mip++)
+	{
+		allocateMipmap(mip);
+
+		love::image::ImageDataBase *id = data.get(0, mip);
+
+		if (id != nullptr && !uploadPending)
+			uploadImageData(id, mip, 0, 0, 0);
+	}
+
+	setBaseMipmap(residentMipmap);
+}
+
+void Image::allocateMipmap(int mipmap)
+{
+	gl.bindTextureToUnit(this, 0, false);
+
+	OpenGL::TextureFormat fmt = OpenGL::convertPixelFormat(format, false, sRGB);
+
+	int w = getPixelWidth(mipmap);
+	int h = getPixelHeight(mipmap);
+
+	if (isCompressed())
+	{
+		love::image::ImageDataBase *d = data.get(0, mipmap);
+		glCompressedTexImage2D(GL_TEXTURE_2D, mipmap, fmt.internalformat, w, h, 0, d->getSize(), nullptr);
+	}
+	else
+		glTexImage2D(GL_TEXTURE_2D, mipmap, fmt.internalformat, w, h, 0, fmt.externalformat, fmt.type, nullptr);
+}
+
+void Image::releaseMipmap(int mipmap)
+{
+	gl.bindTextureToUnit(this, 0, false);
+
+	OpenGL::TextureFormat fmt = OpenGL::convertPixelFormat(format, false, sRGB);
+
+	// A 0x0 level has no storage. It's outside the sampled range of levels,
+	// so it doesn't make the texture incomplete.
+	if (isCompressed())
+		glCompressedTexImage2D(GL_TEXTURE_2D, mipmap, fmt.internalformat, 0, 0, 0, 0, nullptr);
+	else
+		glTexImage2D(GL_TEXTURE_2D, mipmap, fmt.internalformat, 0, 0, 0, fmt.externalformat, fmt.type, nullptr);
+}
+
+void Image::setBaseMipmap(int mipmap)
+{
+	gl.bindTextureToUnit(this, 0, false);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, mipmap);
+}
+
 void Image::uploadByteData(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r)
 {
 	OpenGL::TempDebugGroup debuggroup("Image data upload");
 
 	gl.bindTextureToUnit(this, 0, false);
+	texSubImage(pixelformat, data, size, level, slice, r);
+}
 
+void Image::texSubImage(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r)
+{
 	OpenGL::TextureFormat fmt = OpenGL::convertPixelFormat(pixelformat, false, sRGB);
 	GLenum gltarget = OpenGL::getGLTextureType(texType);
 
@@ -178,6 +333,260 @@ void Image::uploadByteData(PixelFormat pixelformat, const void *data, size_t siz
 	}
 }
 
+void Image::uploadStagedByteData(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r)
+{
+	bool supported = GLAD_VERSION_3_0 || GLAD_ES_VERSION_3_0
+		|| (GLAD_ARB_pixel_buffer_object && (GLAD_ARB_map_buffer_range || GLAD_EXT_map_buffer_range));
+
+	if (!supported)
+		return uploadByteData(pixelformat, data, size, level, slice, r);
+
+	if (stagingBuffer == 0)
+		glGenBuffers(1, &stagingBuffer);
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer);
+
+	// Orphan the previous contents, so the driver doesn't have to wait for the
+	// last upload from the buffer to finish before we can write to it.
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+
+	void *dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+	if (dst != nullptr)
+	{
+		memcpy(dst, data, size);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+		// The data pointer is an offset into the bound unpack buffer.
+		uploadByteData(pixelformat, nullptr, size, level, slice, r);
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+	else
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		uploadByteData(pixelformat, data, size, level, slice, r);
+	}
+}
+
+void Image::releaseUploadStaging()
+{
+	if (stagingBuffer != 0)
+	{
+		glDeleteBuffers(1, &stagingBuffer);
+		stagingBuffer = 0;
+	}
+}
+
+bool Image::beginBackgroundUpload()
+{
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	LoaderThread *loader = gfx != nullptr ? gfx->getLoaderThread() : nullptr;
+
+	if (loader == nullptr)
+		return false;
+
+	// The loader context sees the texture's storage once the main context
+	// has submitted the commands which created it.
+	glFlush();
+
+	loaderThread = loader;
+	loaderError = GL_NO_ERROR;
+	loaderJob = loader->addJob([this]() { uploadPendingDataInBackground(); });
+
+	return true;
+}
+
+bool Image::pollBackgroundUpload(bool wait)
+{
+	if (loaderThread == nullptr)
+		return true;
+
+	if (wait)
+		loaderThread->waitForJob(loaderJob);
+	else if (!loaderThread->isJobComplete(loaderJob))
+		return false;
+
+	loaderThread = nullptr;
+
+	// Changes made by another context are only guaranteed to be seen once
+	// the texture is bound again.
+	gl.bindTextureToUnit(texType, 0, 0, false);
+	gl.bindTextureToUnit(this, 0, false);
+
+	if (loaderError != GL_NO_ERROR)
+		throw love::Exception("Cannot upload image data (OpenGL error: %s)", OpenGL::errorString(loaderError));
+
+	return true;
+}
+
+void Image::waitForBackgroundUpload()
+{
+	if (loaderThread != nullptr)
+	{
+		loaderThread->waitForJob(loaderJob);
+		loaderThread = nullptr;
+	}
+}
+
+void Image::uploadPendingDataInBackground()
+{
+	// Only raw GL calls from here on, the state tracker belongs to the main
+	// context.
+	GLenum gltextype = OpenGL::getGLTextureType(texType);
+	glBindTexture(gltextype, texture);
+
+	int mipcount = mipmapsType == MIPMAPS_DATA ? data.getMipmapCount() : 1;
+
+	for (int mip = uploadMipmap; mip < mipcount; mip++)
+	{
+		int firstslice = mip == uploadMipmap ? uploadSlice : 0;
+
+		for (int slice = firstslice; slice < data.getSliceCount(mip); slice++)
+		{
+			love::image::ImageDataBase *d = data.get(slice, mip);
+
+			if (d == nullptr)
+				continue;
+
+			love::image::ImageData *id = dynamic_cast<love::image::ImageData *>(d);
+
+			love::thread::EmptyLock lock;
+			if (id != nullptr)
+				lock.setLock(id->getMutex());
+
+			int w = d->getWidth();
+			int h = d->getHeight();
+			int row = (mip == uploadMipmap && slice == uploadSlice) ? uploadRow : 0;
+
+			if (isPixelFormatCompressed(d->getFormat()))
+				row = 0;
+
+			size_t rowsize = d->getSize() / h;
+			Rect rect = {0, row, w, h - row};
+			const uint8 *src = (const uint8 *) d->getData() + rowsize * row;
+
+			texSubImage(d->getFormat(), src, rowsize * (h - row), mip, slice, rect);
+		}
+	}
+
+	if (mipmapsType == MIPMAPS_GENERATED && getMipmapCount() > 1 && !isCompressed()
+		&& (GLAD_ES_VERSION_2_0 || GLAD_VERSION_3_0 || GLAD_ARB_framebuffer_object || GLAD_EXT_framebuffer_object))
+	{
+		if (gl.bugs.generateMipmapsRequiresTexture2DEnable)
+			glEnable(gltextype);
+
+		glGenerateMipmap(gltextype);
+	}
+
+	glBindTexture(gltextype, 0);
+
+	loaderError = glGetError();
+}
+
+void Image::uploadStreamedByteData(PixelFormat pixelformat, const void *data, size_t size, const StreamedRect *rects, int count)
+{
+	// Same requirements as persistently mapped Buffers.
+	bool supported = gl.isCoreProfile() && !gl.bugs.clientWaitSyncStalls
+		&& (GLAD_VERSION_4_4 || GLAD_ARB_buffer_storage);
+
+	if (supported && !isPixelFormatCompressed(pixelformat) && size > streamRegionSize)
+		supported = createStreamBuffer(size);
+
+	if (!supported || isPixelFormatCompressed(pixelformat))
+	{
+		for (int i = 0; i < count; i++)
+		{
+			const StreamedRect &r = rects[i];
+			uploadStagedByteData(pixelformat, (const uint8 *) data + r.offset, r.size, r.level, r.slice, r.rect);
+		}
+		return;
+	}
+
+	// Wait for the GPU to finish reading the region's last upload. With
+	// STREAM_REGIONS regions this is a few frames ago, so it rarely blocks.
+	streamRegion = (streamRegion + 1) % STREAM_REGIONS;
+	streamSyncs[streamRegion].cpuWait();
+
+	size_t offset = streamRegion * streamRegionSize;
+	memcpy(streamMap + offset, data, size);
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, streamBuffer);
+	glFlushMappedBufferRange(GL_PIXEL_UNPACK_BUFFER, (GLintptr) offset, (GLsizeiptr) size);
+
+	// The data pointers are offsets into the bound unpack buffer.
+	for (int i = 0; i < count; i++)
+	{
+		const StreamedRect &r = rects[i];
+		uploadByteData(pixelformat, (const void *) (offset + r.offset), r.size, r.level, r.slice, r.rect);
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	streamSyncs[streamRegion].fence();
+}
+
+void Image::flushPendingUpdates()
+{
+	// This can happen while other textures are being bound for a draw, so the
+	// uploads mustn't change what's bound to the first texture unit.
+	GLuint prevtexture = gl.getBoundTexture(texType, 0);
+
+	love::graphics::Image::flushPendingUpdates();
+
+	gl.bindTextureToUnit(texType, prevtexture, 0, false);
+}
+
+bool Image::createStreamBuffer(size_t size)
+{
+	releaseStreamBuffer();
+
+	// Keep the regions aligned well enough for any pixel format.
+	size_t regionsize = (size + 255) & ~(size_t) 255;
+	size_t fullsize = regionsize * STREAM_REGIONS;
+
+	GLbitfield storageflags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT;
+	GLbitfield mapflags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_FLUSH_EXPLICIT_BIT;
+
+	glGenBuffers(1, &streamBuffer);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, streamBuffer);
+	glBufferStorage(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr) fullsize, nullptr, storageflags);
+	streamMap = (char *) glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr) fullsize, mapflags);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	if (streamMap == nullptr)
+	{
+		releaseStreamBuffer();
+		return false;
+	}
+
+	streamRegionSize = regionsize;
+	streamRegion = 0;
+	return true;
+}
+
+void Image::releaseStreamBuffer()
+{
+	for (FenceSync &sync : streamSyncs)
+		sync.cleanup();
+
+	if (streamBuffer != 0)
+	{
+		if (streamMap != nullptr)
+		{
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, streamBuffer);
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		}
+
+		glDeleteBuffers(1, &streamBuffer);
+	}
+
+	streamBuffer = 0;
+	streamMap = nullptr;
+	streamRegionSize = 0;
+}
+
 bool Image::loadVolatile()
 {
 	if (texture != 0)
@@ -218,9 +627,20 @@ bool Image::loadVolatile()
 		filter.mipmap = FILTER_NONE;
 	}
 
+	// Streaming needs the base level of the texture to be adjustable.
+	if (streaming && (mipmapsType != MIPMAPS_DATA || !(GLAD_ES_VERSION_3_0 || GLAD_VERSION_1_2)))
+		disableStreaming();
+
 	glGenTextures(1, &texture);
 	gl.bindTextureToUnit(this, 0, false);
 
+	// Evicted Images stay evicted when everything is reloaded.
+	if (evicted)
+	{
+		loadPlaceholderTexture();
+		return true;
+	}
+
 	// Use a default texture if the size is too big for the system.
 	if (!validateDimensions(false))
 	{
@@ -232,6 +652,28 @@ bool Image::loadVolatile()
 	setWrap(wrap);
 	setMipmapSharpness(mipmapSharpness);
 
+	// Images which don't retain their data have to get it back first. Without
+	// it, compressed images can't be created at all, and other images are
+	// left uninitialized.
+	if (!reloadData() && isCompressed())
+	{
+		loadDefaultTexture();
+		return true;
+	}
+
+	// When everything is reloaded after the context is lost, only the data of
+	// recently drawn images is uploaded right away. The rest is uploaded in the
+	// background within the image upload budget, as is the data of evicted
+	// images restored asynchronously.
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	bool deferupload = asyncRestore || (Volatile::isLoadingAll() && getLastUsedFrame() + RESTORE_IMMEDIATE_FRAMES < usageFrame);
+
+	if (deferupload && !uploadPending && data.get(0, 0) != nullptr && gfx != nullptr)
+	{
+		uploadPending = true;
+		gfx->addPendingImageUpload(this);
+	}
+
 	GLenum gltextype = OpenGL::getGLTextureType(texType);
 
 	if (mipmapsType == MIPMAPS_NONE && (GLAD_ES_VERSION_3_0 || GLAD_VERSION_1_0))
@@ -257,14 +699,22 @@ bool Image::loadVolatile()
 	int64 memsize = 0;
 
 	for (int slice = 0; slice < data.getSliceCount(0); slice++)
-		memsize += data.get(slice, 0)->getSize();
+	{
+		if (data.get(slice, 0) != nullptr)
+			memsize += data.get(slice, 0)->getSize();
+	}
 
 	if (getMipmapCount() > 1)
 		memsize *= 1.33334;
 
+	if (streaming)
+		memsize = getResidentMemorySize();
+
 	setGraphicsMemorySize(memsize);
 
 	usingDefaultTexture = false;
+
+	releaseUploadedData();
 	return true;
 }
 
@@ -273,12 +723,23 @@ void Image::unloadVolatile()
 	if (texture == 0)
 		return;
 
+	// The loader thread mustn't be using the texture when it's deleted.
+	waitForBackgroundUpload();
+
+	releaseUploadStaging();
+	releaseStreamBuffer();
+
 	gl.deleteTexture(texture);
 	texture = 0;
 
 	setGraphicsMemorySize(0);
 }
 
+uint32 Image::getVolatilePriority() const
+{
+	return getLastUsedFrame();
+}
+
 ptrdiff_t Image::getHandle() const
 {
 	return texture;
@@ -26,6 +26,8 @@
 
 // OpenGL
 #include "OpenGL.h"
+#include "FenceSync.h"
+#include "LoaderThread.h"
 
 namespace love
 {
@@ -46,6 +48,7 @@ public:
 	// Implements Volatile.
 	bool loadVolatile() override;
 	void unloadVolatile() override;
+	uint32 getVolatilePriority() const override;
 
 	ptrdiff_t getHandle() const override;
 
@@ -60,14 +63,61 @@ public:
 private:
 
 	void uploadByteData(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r) override;
+	void uploadStagedByteData(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r) override;
+	void releaseUploadStaging() override;
+	bool beginBackgroundUpload() override;
+	bool pollBackgroundUpload(bool wait) override;
+	void uploadStreamedByteData(PixelFormat pixelformat, const void *data, size_t size, const StreamedRect *rects, int count) override;
+	void flushPendingUpdates() override;
 	void generateMipmaps() override;
 
+	void allocateMipmap(int mipmap) override;
+	void releaseMipmap(int mipmap) override;
+	void setBaseMipmap(int mipmap) override;
+
+	void evictTexture() override;
+	void restoreTexture(bool async) override;
+
 	void loadDefaultTexture();
+	void loadPlaceholderTexture();
 	void loadData();
+	void loadStreamingData();
+
+	bool createStreamBuffer(size_t size);
+	void releaseStreamBuffer();
+
+	// Uploads to the texture bound to the current context's active unit.
+	void texSubImage(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r);
+
+	// Runs on the loader thread.
+	void uploadPendingDataInBackground();
+	void waitForBackgroundUpload();
+
+	// Number of regions the streamed upload buffer cycles through.
+	static const int STREAM_REGIONS = 3;
 
 	// OpenGL texture identifier.
 	GLuint texture;
 
+	// Set while an evicted texture is re-created with deferred uploads.
+	bool asyncRestore;
+
+	// Pixel unpack buffer used for deferred uploads.
+	GLuint stagingBuffer;
+
+	// Persistently mapped pixel unpack buffer used by replacePixelsStreamed.
+	// Each upload goes to the next region once the GPU is done with it.
+	GLuint streamBuffer;
+	char *streamMap;
+	size_t streamRegionSize;
+	int streamRegion;
+	FenceSync streamSyncs[STREAM_REGIONS];
+
+	// Set while the loader thread is uploading the deferred data.
+	LoaderThread *loaderThread;
+	uint64 loaderJob;
+	GLenum loaderError;
+
 }; // Image
 
 } // opengl
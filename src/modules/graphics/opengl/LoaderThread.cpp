@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "LoaderThread.h"
+#include "FenceSync.h"
+#include "window/Window.h"
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+LoaderThread::LoaderThread(love::window::Window *window, void *context)
+	: window(window)
+	, context(context)
+	, nextJobID(0)
+	, completedJobID(0)
+	, started(false)
+	, startupFailed(false)
+	, stopping(false)
+{
+	threadName = "GraphicsLoader";
+}
+
+LoaderThread::~LoaderThread()
+{
+	stop();
+}
+
+bool LoaderThread::waitForStartup()
+{
+	love::thread::Lock l(mutex);
+
+	while (!started)
+		cond->wait(mutex);
+
+	return !startupFailed;
+}
+
+uint64 LoaderThread::addJob(const Job &job)
+{
+	love::thread::Lock l(mutex);
+	jobs.emplace_back(++nextJobID, job);
+	cond->broadcast();
+	return nextJobID;
+}
+
+bool LoaderThread::isJobComplete(uint64 id)
+{
+	love::thread::Lock l(mutex);
+	return completedJobID >= id || startupFailed;
+}
+
+void LoaderThread::waitForJob(uint64 id)
+{
+	love::thread::Lock l(mutex);
+
+	while (completedJobID < id && !startupFailed)
+		cond->wait(mutex);
+}
+
+void LoaderThread::stop()
+{
+	{
+		love::thread::Lock l(mutex);
+		if (stopping)
+			return;
+		stopping = true;
+		cond->broadcast();
+	}
+
+	owner->wait();
+
+	window->deleteSharedGLContext(context);
+	context = nullptr;
+}
+
+void LoaderThread::threadFunction()
+{
+	if (!window->makeSharedGLContextCurrent(context))
+	{
+		love::thread::Lock l(mutex);
+		started = true;
+		startupFailed = true;
+		cond->broadcast();
+		return;
+	}
+
+	// Pixel storage state isn't shared between contexts. This matches what
+	// the main context uses (see Graphics::setMode.)
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	{
+		love::thread::Lock l(mutex);
+		started = true;
+		cond->broadcast();
+	}
+
+	while (true)
+	{
+		std::pair<uint64, Job> job;
+
+		{
+			love::thread::Lock l(mutex);
+
+			while (!stopping && jobs.empty())
+				cond->wait(mutex);
+
+			if (jobs.empty())
+				break;
+
+			job = jobs.front();
+			jobs.pop_front();
+		}
+
+		try
+		{
+			job.second();
+		}
+		catch (std::exception &)
+		{
+			// Jobs report their own errors.
+		}
+
+		// Waiting here keeps the main thread from ever having to.
+		FenceSync sync;
+		sync.fence();
+		sync.cpuWait();
+
+		love::thread::Lock l(mutex);
+		completedJobID = job.first;
+		cond->broadcast();
+	}
+
+	window->makeSharedGLContextCurrent(nullptr);
+}
+
+bool LoaderThread::isSupported()
+{
+	return GLAD_VERSION_3_2 || GLAD_ES_VERSION_3_0 || GLAD_ARB_sync;
+}
+
+} // opengl
+} // graphics
+} // love
@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "OpenGL.h"
+#include "common/int.h"
+#include "thread/threads.h"
+
+// C++
+#include <deque>
+#include <functional>
+
+namespace love
+{
+namespace window
+{
+class Window;
+}
+
+namespace graphics
+{
+namespace opengl
+{
+
+/**
+ * A thread with its own OpenGL context which shares objects with the main
+ * context, used to upload texture data without the main thread waiting on
+ * the driver. Jobs run in the order they're added. A job only counts as
+ * complete once the GPU has reached a fence placed after it, so the main
+ * context sees all of its results.
+ *
+ * Jobs must only use raw GL calls: the OpenGL state tracker (gl) belongs to
+ * the main context.
+ **/
+class LoaderThread : public love::thread::Threadable
+{
+public:
+
+	typedef std::function<void()> Job;
+
+	// Takes ownership of the shared context.
+	LoaderThread(love::window::Window *window, void *context);
+	virtual ~LoaderThread();
+
+	// Implements Threadable.
+	void threadFunction() override;
+
+	/**
+	 * Blocks until the thread has made its context current. Returns false if
+	 * it couldn't, in which case the thread has already exited.
+	 **/
+	bool waitForStartup();
+
+	// Returns an identifier for isJobComplete and waitForJob.
+	uint64 addJob(const Job &job);
+	bool isJobComplete(uint64 id);
+	void waitForJob(uint64 id);
+
+	// Finishes any queued jobs, then deletes the shared context. Must be
+	// called on the main thread while the main context still exists.
+	void stop();
+
+	static bool isSupported();
+
+private:
+
+	love::window::Window *window;
+	void *context;
+
+	std::deque<std::pair<uint64, Job>> jobs;
+	uint64 nextJobID;
+	uint64 completedJobID;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef cond;
+
+	bool started;
+	bool startupFailed;
+	bool stopping;
+
+}; // LoaderThread
+
+} // opengl
+} // graphics
+} // love
@@ -0,0 +1,150 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "OcclusionQuery.h"
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+OcclusionQuery::OcclusionQuery(bool conservative)
+	: love::graphics::OcclusionQuery(conservative)
+	, target(gl.getOcclusionQueryTarget(conservative))
+	, activeQuery(0)
+	, roundIndex(0)
+	, hasResult(false)
+	, resultVisible(false)
+	, resultIndex(0)
+{
+}
+
+OcclusionQuery::~OcclusionQuery()
+{
+	unloadVolatile();
+}
+
+bool OcclusionQuery::loadVolatile()
+{
+	// Queries are created on demand.
+	return true;
+}
+
+void OcclusionQuery::unloadVolatile()
+{
+	if (activeQuery != 0)
+	{
+		glEndQuery(target);
+		freeQueries.push_back(activeQuery);
+		activeQuery = 0;
+	}
+
+	if (current == this)
+		current = nullptr;
+
+	for (const Round &round : pendingRounds)
+		freeQueries.push_back(round.query);
+
+	pendingRounds.clear();
+
+	if (!freeQueries.empty())
+		glDeleteQueries((GLsizei) freeQueries.size(), &freeQueries[0]);
+
+	freeQueries.clear();
+}
+
+GLuint OcclusionQuery::getQuery()
+{
+	GLuint query = 0;
+
+	if (!freeQueries.empty())
+	{
+		query = freeQueries.back();
+		freeQueries.pop_back();
+	}
+	else
+		glGenQueries(1, &query);
+
+	return query;
+}
+
+void OcclusionQuery::startQuery()
+{
+	activeQuery = getQuery();
+	glBeginQuery(target, activeQuery);
+}
+
+void OcclusionQuery::stopQuery()
+{
+	glEndQuery(target);
+
+	Round round;
+	round.query = activeQuery;
+	round.index = roundIndex++;
+	pendingRounds.push_back(round);
+
+	activeQuery = 0;
+
+	// Reusing a query discards its old result, which is fine for rounds
+	// that are too old to be interesting anyway.
+	while ((int) pendingRounds.size() > MAX_PENDING_ROUNDS)
+	{
+		freeQueries.push_back(pendingRounds.front().query);
+		pendingRounds.pop_front();
+	}
+}
+
+bool OcclusionQuery::getResult(bool &visible, int &age)
+{
+	// Queries complete in order, so polling stops at the first pending one.
+	while (!pendingRounds.empty())
+	{
+		const Round &round = pendingRounds.front();
+
+		GLuint available = 0;
+		glGetQueryObjectuiv(round.query, GL_QUERY_RESULT_AVAILABLE, &available);
+
+		if (!available)
+			break;
+
+		GLuint samples = 0;
+		glGetQueryObjectuiv(round.query, GL_QUERY_RESULT, &samples);
+
+		hasResult = true;
+		resultVisible = samples != 0;
+		resultIndex = round.index;
+
+		freeQueries.push_back(round.query);
+		pendingRounds.pop_front();
+	}
+
+	if (!hasResult)
+		return false;
+
+	visible = resultVisible;
+	age = roundIndex - 1 - resultIndex;
+	return true;
+}
+
+} // opengl
+} // graphics
+} // love
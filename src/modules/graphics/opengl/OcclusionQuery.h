@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "graphics/OcclusionQuery.h"
+#include "graphics/Volatile.h"
+#include "OpenGL.h"
+
+// C++
+#include <vector>
+#include <deque>
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+/**
+ * Uses GL_ANY_SAMPLES_PASSED queries (GL_SAMPLES_PASSED on older desktop GL),
+ * pooled the same way as GPUTimer's. Finished rounds are polled in order
+ * with GL_QUERY_RESULT_AVAILABLE, so getResult never stalls.
+ **/
+class OcclusionQuery final : public love::graphics::OcclusionQuery, public Volatile
+{
+public:
+
+	OcclusionQuery(bool conservative);
+	virtual ~OcclusionQuery();
+
+	// Implements Volatile.
+	bool loadVolatile() override;
+	void unloadVolatile() override;
+
+	bool getResult(bool &visible, int &age) override;
+
+protected:
+
+	void startQuery() override;
+	void stopQuery() override;
+
+private:
+
+	struct Round
+	{
+		GLuint query;
+		int index;
+	};
+
+	// Rounds older than this are dropped without waiting for their results.
+	static const int MAX_PENDING_ROUNDS = 8;
+
+	GLuint getQuery();
+
+	GLenum target;
+
+	GLuint activeQuery;
+	std::deque<Round> pendingRounds;
+	std::vector<GLuint> freeQueries;
+
+	int roundIndex;
+
+	bool hasResult;
+	bool resultVisible;
+	int resultIndex;
+
+}; // OcclusionQuery
+
+} // opengl
+} // graphics
+} // love
@@ -27,6 +27,7 @@
 
 #include "graphics/Graphics.h"
 #include "graphics/Buffer.h"
+#include "window/Window.h"
 
 // C++
 #include <algorithm>
@@ -62,6 +63,11 @@ static void *LOVEGetProcAddress(const char *name)
 		return proc;
 #endif
 
+	// Headless windows don't use SDL's OpenGL loader.
+	auto window = Module::getInstance<love::window::Window>(Module::M_WINDOW);
+	if (window != nullptr)
+		return window->getGLProcAddress(name);
+
 	return SDL_GL_GetProcAddress(name);
 }
 
@@ -103,10 +109,14 @@ OpenGL::OpenGL()
 	, maxTextureArrayLayers(0)
 	, maxRenderTargets(1)
 	, maxRenderbufferSamples(0)
+	, maxThreadgroups(0)
 	, maxTextureUnits(1)
+	, uniformBufferOffsetAlignment(1)
 	, maxPointSize(1)
 	, coreProfile(false)
 	, vendor(VENDOR_UNKNOWN)
+	, defaultFBO(0)
+	, vertexArrays()
 	, state()
 {
 	state.constantColor = Colorf(1.0f, 1.0f, 1.0f, 1.0f);
@@ -171,6 +181,12 @@ void OpenGL::setupContext()
 	GLfloat glcolor[4] = {1.0f, 1.0f, 1.0f, 1.0f};
 	glVertexAttrib4fv(ATTRIB_COLOR, glcolor);
 	glVertexAttrib4fv(ATTRIB_CONSTANTCOLOR, glcolor);
+	glVertexAttrib1f(ATTRIB_POINTSIZE, 1.0f);
+
+	// Point sizes always come from the vertex shader (love_PointSize times
+	// the per-vertex size), like they already do in OpenGL ES.
+	if (GLAD_VERSION_2_0)
+		glEnable(GL_PROGRAM_POINT_SIZE);
 
 	GLint maxvertexattribs = 1;
 	glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxvertexattribs);
@@ -182,6 +198,15 @@ void OpenGL::setupContext()
 	else
 		state.instancedAttribArrays = 0;
 
+	state.drawAttribArrays = state.enabledAttribArrays;
+
+	// Whatever VAO is bound now (if any) is used for uncached draws.
+	state.defaultVertexArray = 0;
+	state.defaultIndexBuffer = 0;
+	state.boundVertexArray = nullptr;
+	if (isVertexArrayCacheSupported())
+		glGetIntegerv(GL_VERTEX_ARRAY_BINDING, (GLint *) &state.defaultVertexArray);
+
 	setVertexAttributes(vertex::Attributes(), vertex::Buffers());
 
 	// Get the current viewport.
@@ -214,6 +239,13 @@ void OpenGL::setupContext()
 	else
 		state.enableState[ENABLE_FRAMEBUFFER_SRGB] = false;
 
+	// Let the driver compile and link shaders on its own threads, so async
+	// Shaders can be polled without blocking.
+	if (GLAD_KHR_parallel_shader_compile)
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+	else if (GLAD_ARB_parallel_shader_compile)
+		glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+
 	GLint faceCull = GL_BACK;
 	glGetIntegerv(GL_CULL_FACE_MODE, &faceCull);
 	state.faceCullMode = faceCull;
@@ -221,7 +253,10 @@ void OpenGL::setupContext()
 	for (int i = 0; i < (int) BUFFER_MAX_ENUM; i++)
 	{
 		state.boundBuffers[i] = 0;
-		glBindBuffer(getGLBufferType((BufferType) i), 0);
+		if ((i != BUFFER_UNIFORM || isUniformBufferSupported())
+			&& (i != BUFFER_INDIRECT || isDrawIndirectSupported())
+			&& (i != BUFFER_SHADER_STORAGE || isComputeSupported()))
+			glBindBuffer(getGLBufferType((BufferType) i), 0);
 	}
 
 	// Initialize multiple texture unit support for shaders.
@@ -259,6 +294,8 @@ void OpenGL::deInitContext()
 	if (!contextInitialized)
 		return;
 
+	clearVertexArrayCache();
+
 	for (int i = 0; i < TEXTURE_MAX_ENUM; i++)
 	{
 		if (state.defaultTexture[i] != 0)
@@ -353,6 +390,35 @@ void OpenGL::initOpenGLFunctions()
 			fp_glRenderbufferStorageMultisample = fp_glRenderbufferStorageMultisampleNV;
 	}
 
+	if (GLAD_ES_VERSION_2_0 && !GLAD_ES_VERSION_3_2 && !(GLAD_VERSION_4_3 || GLAD_ARB_copy_image))
+	{
+		if (GLAD_EXT_copy_image)
+			fp_glCopyImageSubData = fp_glCopyImageSubDataEXT;
+		else if (GLAD_OES_copy_image)
+			fp_glCopyImageSubData = fp_glCopyImageSubDataOES;
+	}
+
+	if (GLAD_ES_VERSION_2_0 && !GLAD_ES_VERSION_3_0 && GLAD_OES_vertex_array_object)
+	{
+		fp_glBindVertexArray = fp_glBindVertexArrayOES;
+		fp_glDeleteVertexArrays = fp_glDeleteVertexArraysOES;
+		fp_glGenVertexArrays = fp_glGenVertexArraysOES;
+	}
+
+	if (GLAD_EXT_disjoint_timer_query && !(GLAD_VERSION_3_3 || GLAD_ARB_timer_query))
+	{
+		if (!GLAD_ES_VERSION_3_0)
+		{
+			fp_glGenQueries = fp_glGenQueriesEXT;
+			fp_glDeleteQueries = fp_glDeleteQueriesEXT;
+			fp_glBeginQuery = fp_glBeginQueryEXT;
+			fp_glEndQuery = fp_glEndQueryEXT;
+			fp_glGetQueryObjectuiv = fp_glGetQueryObjectuivEXT;
+		}
+
+		fp_glGetQueryObjectui64v = fp_glGetQueryObjectui64vEXT;
+	}
+
 	if (isInstancingSupported() && !(GLAD_VERSION_3_3 || GLAD_ES_VERSION_3_0))
 	{
 		if (GLAD_ARB_instanced_arrays)
@@ -467,8 +533,25 @@ void OpenGL::initMaxValues()
 	else
 		maxRenderbufferSamples = 0;
 
+	maxThreadgroups = 0;
+	if (isComputeSupported())
+	{
+		maxThreadgroups = std::numeric_limits<int>::max();
+		for (GLuint i = 0; i < 3; i++)
+		{
+			GLint count = 0;
+			glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_COUNT, i, &count);
+			maxThreadgroups = std::min(maxThreadgroups, (int) count);
+		}
+	}
+
 	glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &maxTextureUnits);
 
+	if (isUniformBufferSupported())
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformBufferOffsetAlignment);
+	else
+		uniformBufferOffsetAlignment = 1;
+
 	GLfloat limits[2];
 	if (GLAD_VERSION_3_0)
 		glGetFloatv(GL_POINT_SIZE_RANGE, limits);
@@ -581,6 +664,12 @@ GLenum OpenGL::getGLBufferType(BufferType type)
 		return GL_ARRAY_BUFFER;
 	case BUFFER_INDEX:
 		return GL_ELEMENT_ARRAY_BUFFER;
+	case BUFFER_UNIFORM:
+		return GL_UNIFORM_BUFFER;
+	case BUFFER_INDIRECT:
+		return GL_DRAW_INDIRECT_BUFFER;
+	case BUFFER_SHADER_STORAGE:
+		return GL_SHADER_STORAGE_BUFFER;
 	case BUFFER_MAX_ENUM:
 		return GL_ZERO;
 	}
@@ -666,6 +755,18 @@ void OpenGL::bindBuffer(BufferType type, GLuint buffer)
 	}
 }
 
+void OpenGL::bindUniformBuffer(int binding, GLuint buffer, size_t offset, size_t size)
+{
+	glBindBufferRange(GL_UNIFORM_BUFFER, (GLuint) binding, buffer, (GLintptr) offset, (GLsizeiptr) size);
+	state.boundBuffers[BUFFER_UNIFORM] = buffer;
+}
+
+void OpenGL::bindShaderStorageBuffer(int binding, GLuint buffer)
+{
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, (GLuint) binding, buffer);
+	state.boundBuffers[BUFFER_SHADER_STORAGE] = buffer;
+}
+
 void OpenGL::deleteBuffer(GLuint buffer)
 {
 	glDeleteBuffers(1, &buffer);
@@ -675,10 +776,106 @@ void OpenGL::deleteBuffer(GLuint buffer)
 		if (state.boundBuffers[i] == buffer)
 			state.boundBuffers[i] = 0;
 	}
+
+	if (state.defaultIndexBuffer == buffer)
+		state.defaultIndexBuffer = 0;
+
+	// Buffer names can be reused once they're deleted, so cached VAOs which
+	// reference this buffer must not be matched again.
+	for (auto it = vertexArrays.begin(); it != vertexArrays.end(); )
+	{
+		const VertexArrayKey &key = it->first;
+		CachedVertexArray &va = it->second;
+
+		bool used = false;
+		for (uint32 i = 0; i < key.count; i++)
+			used = used || key.attribs[i].buffer == buffer;
+
+		if (used)
+		{
+			if (state.boundVertexArray == &va)
+				bindVertexArray(nullptr);
+			glDeleteVertexArrays(1, &va.vao);
+			it = vertexArrays.erase(it);
+		}
+		else
+		{
+			// Deleting a buffer only unbinds it from the current VAO. Other
+			// VAOs keep the old buffer, so make sure it's rebound later.
+			if (va.indexBuffer == buffer)
+				va.indexBuffer = 0;
+			++it;
+		}
+	}
 }
 
-void OpenGL::setVertexAttributes(const vertex::Attributes &attributes, const vertex::Buffers &buffers)
+void OpenGL::setVertexAttributes(const vertex::Attributes &attributes, const vertex::Buffers &buffers, bool cached)
 {
+	if (cached && isVertexArrayCacheSupported())
+	{
+		VertexArrayKey key;
+		key.enableBits = attributes.enablebits;
+		key.instanceBits = attributes.instancebits;
+		key.count = 0;
+
+		for (uint32 i = 0; i < vertex::Attributes::MAX; i++)
+		{
+			if (!attributes.isEnabled(i))
+				continue;
+
+			const auto &attrib = attributes.attribs[i];
+			const auto &bufferinfo = buffers.info[attrib.bufferindex];
+
+			VertexArrayKey::Attrib &a = key.attribs[key.count++];
+			a.index = i;
+			a.format = (uint32) attrib.type | ((uint32) attrib.components << 8);
+			a.offsetStride = (uint32) attrib.offsetfromvertex | ((uint32) attrib.stride << 16);
+			a.buffer = (GLuint) bufferinfo.buffer->getHandle();
+			a.bufferOffset = bufferinfo.buffer->getDrawOffset() + bufferinfo.offset;
+		}
+
+		auto it = vertexArrays.find(key);
+		if (it != vertexArrays.end())
+		{
+			bindVertexArray(&it->second);
+			resetConstantAttributes(attributes.enablebits);
+			return;
+		}
+
+		// There shouldn't be this many persistent layouts in practice, but
+		// don't grow without bound if something keeps changing its buffers.
+		if (vertexArrays.size() >= 1024)
+			clearVertexArrayCache();
+
+		CachedVertexArray va = {};
+		glGenVertexArrays(1, &va.vao);
+
+		CachedVertexArray *newva = &vertexArrays.insert(std::make_pair(key, va)).first->second;
+		bindVertexArray(newva);
+
+		for (uint32 i = 0; i < key.count; i++)
+		{
+			const VertexArrayKey::Attrib &a = key.attribs[i];
+			const auto &attrib = attributes.attribs[a.index];
+
+			GLboolean normalized = GL_FALSE;
+			GLenum gltype = getGLVertexDataType(attrib.type, normalized);
+
+			glEnableVertexAttribArray(a.index);
+
+			if (attributes.instancebits & (1u << a.index))
+				glVertexAttribDivisor(a.index, 1);
+
+			bindBuffer(BUFFER_VERTEX, a.buffer);
+			glVertexAttribPointer(a.index, attrib.components, gltype, normalized, attrib.stride, BUFFER_OFFSET(a.bufferOffset + attrib.offsetfromvertex));
+		}
+
+		resetConstantAttributes(attributes.enablebits);
+		return;
+	}
+
+	bindVertexArray(nullptr);
+
 	uint32 enablediff = attributes.enablebits ^ state.enabledAttribArrays;
 	uint32 instancediff = attributes.instancebits ^ state.instancedAttribArrays;
 
@@ -705,7 +902,8 @@ void OpenGL::setVertexAttributes(const vertex::Attributes &attributes, const ver
 			GLboolean normalized = GL_FALSE;
 			GLenum gltype = getGLVertexDataType(attrib.type, normalized);
 
-			const void *offsetpointer = reinterpret_cast<void*>(bufferinfo.offset + attrib.offsetfromvertex);
+			size_t offset = bufferinfo.buffer->getDrawOffset() + bufferinfo.offset + attrib.offsetfromvertex;
+			const void *offsetpointer = reinterpret_cast<void*>(offset);
 
 			bindBuffer(BUFFER_VERTEX, (GLuint) bufferinfo.buffer->getHandle());
 			glVertexAttribPointer(i, attrib.components, gltype, normalized, attrib.stride, offsetpointer);
@@ -715,12 +913,53 @@ void OpenGL::setVertexAttributes(const vertex::Attributes &attributes, const ver
 	state.enabledAttribArrays = attributes.enablebits;
 	state.instancedAttribArrays = attributes.instancebits;
 
+	resetConstantAttributes(attributes.enablebits);
+}
+
+void OpenGL::resetConstantAttributes(uint32 enablebits)
+{
 	// glDisableVertexAttribArray will make the constant value for a vertex
 	// attribute undefined. We rely on the per-vertex color attribute being
 	// white when no per-vertex color is used, so we set it here.
+	// Switching to a VAO which doesn't use an array counts as disabling it.
 	// FIXME: Is there a better place to do this?
-	if ((enablediff & ATTRIBFLAG_COLOR) && !(attributes.enablebits & ATTRIBFLAG_COLOR))
+	uint32 disabled = state.drawAttribArrays & ~enablebits;
+
+	if (disabled & ATTRIBFLAG_COLOR)
 		glVertexAttrib4f(ATTRIB_COLOR, 1.0f, 1.0f, 1.0f, 1.0f);
+
+	// Same for the per-vertex point size scale.
+	if (disabled & ATTRIBFLAG_POINTSIZE)
+		glVertexAttrib1f(ATTRIB_POINTSIZE, 1.0f);
+
+	state.drawAttribArrays = enablebits;
+}
+
+void OpenGL::bindVertexArray(CachedVertexArray *va)
+{
+	if (va == state.boundVertexArray)
+		return;
+
+	// The element array buffer binding is part of each VAO's state.
+	if (state.boundVertexArray != nullptr)
+		state.boundVertexArray->indexBuffer = state.boundBuffers[BUFFER_INDEX];
+	else
+		state.defaultIndexBuffer = state.boundBuffers[BUFFER_INDEX];
+
+	glBindVertexArray(va != nullptr ? va->vao : state.defaultVertexArray);
+
+	state.boundBuffers[BUFFER_INDEX] = va != nullptr ? va->indexBuffer : state.defaultIndexBuffer;
+	state.boundVertexArray = va;
+}
+
+void OpenGL::clearVertexArrayCache()
+{
+	bindVertexArray(nullptr);
+
+	for (auto &pair : vertexArrays)
+		glDeleteVertexArrays(1, &pair.second.vao);
+
+	vertexArrays.clear();
 }
 
 void OpenGL::setCullMode(CullMode mode)
@@ -926,6 +1165,9 @@ void OpenGL::useProgram(GLuint program)
 
 GLuint OpenGL::getDefaultFBO() const
 {
+	if (defaultFBO != 0)
+		return defaultFBO;
+
 #ifdef LOVE_IOS
 	// Hack: iOS uses a custom FBO.
 	SDL_SysWMinfo info = {};
@@ -937,6 +1179,11 @@ GLuint OpenGL::getDefaultFBO() const
 #endif
 }
 
+void OpenGL::setDefaultFBO(GLuint fbo)
+{
+	defaultFBO = fbo;
+}
+
 GLuint OpenGL::getDefaultTexture(TextureType type) const
 {
 	return state.defaultTexture[type];
@@ -968,6 +1215,11 @@ void OpenGL::bindTextureToUnit(TextureType target, GLuint texture, int textureun
 	}
 }
 
+GLuint OpenGL::getBoundTexture(TextureType target, int textureunit) const
+{
+	return state.boundTextures[target][textureunit];
+}
+
 void OpenGL::bindTextureToUnit(Texture *texture, int textureunit, bool restoreprev)
 {
 	TextureType textype = TEXTURE_2D;
@@ -977,6 +1229,7 @@ void OpenGL::bindTextureToUnit(Texture *texture, int textureunit, bool restorepr
 	{
 		textype = texture->getTextureType();
 		handle = (GLuint) texture->getHandle();
+		texture->markUsed();
 	}
 	else
 	{
@@ -1221,6 +1474,75 @@ bool OpenGL::isBaseVertexSupported() const
 	return baseVertexSupported;
 }
 
+bool OpenGL::isTimerQuerySupported() const
+{
+	return GLAD_VERSION_3_3 || GLAD_ARB_timer_query || GLAD_EXT_disjoint_timer_query;
+}
+
+bool OpenGL::isOcclusionQuerySupported() const
+{
+	return GLAD_VERSION_1_5 || GLAD_ES_VERSION_3_0;
+}
+
+GLenum OpenGL::getOcclusionQueryTarget(bool conservative) const
+{
+	if (conservative && (GLAD_VERSION_4_3 || GLAD_ES_VERSION_3_0))
+		return GL_ANY_SAMPLES_PASSED_CONSERVATIVE;
+	else if (GLAD_VERSION_3_3 || GLAD_ARB_occlusion_query2 || GLAD_ES_VERSION_3_0)
+		return GL_ANY_SAMPLES_PASSED;
+	else
+		return GL_SAMPLES_PASSED; // Any non-zero sample count means visible.
+}
+
+bool OpenGL::isUniformBufferSupported() const
+{
+	return GLAD_VERSION_3_1 || GLAD_ARB_uniform_buffer_object || GLAD_ES_VERSION_3_0;
+}
+
+bool OpenGL::isComputeSupported() const
+{
+	// Also covers shader storage buffers and image load/store.
+	return GLAD_VERSION_4_3 || GLAD_ES_VERSION_3_1;
+}
+
+bool OpenGL::isCopyImageSupported() const
+{
+	return GLAD_VERSION_4_3 || GLAD_ARB_copy_image || GLAD_ES_VERSION_3_2 || GLAD_EXT_copy_image || GLAD_OES_copy_image;
+}
+
+bool OpenGL::isCopyBufferSupported() const
+{
+	return GLAD_VERSION_3_1 || GLAD_ARB_copy_buffer || GLAD_ES_VERSION_3_0;
+}
+
+bool OpenGL::isFramebufferBlitSupported() const
+{
+	return GLAD_VERSION_3_0 || GLAD_ARB_framebuffer_object || GLAD_ES_VERSION_3_0
+		|| GLAD_EXT_framebuffer_blit || GLAD_ANGLE_framebuffer_blit || GLAD_NV_framebuffer_blit;
+}
+
+bool OpenGL::isDrawIndirectSupported() const
+{
+	// Indirect draws are only useful with per-instance data if the records'
+	// base instance values are respected.
+	return GLAD_VERSION_4_2 || (GLAD_ARB_draw_indirect && GLAD_ARB_base_instance);
+}
+
+bool OpenGL::isMultiDrawIndirectSupported() const
+{
+	return GLAD_VERSION_4_3 || GLAD_ARB_multi_draw_indirect;
+}
+
+bool OpenGL::isVertexArrayCacheSupported() const
+{
+	return GLAD_VERSION_3_0 || GLAD_ES_VERSION_3_0 || GLAD_ARB_vertex_array_object || GLAD_OES_vertex_array_object;
+}
+
+int OpenGL::getUniformBufferOffsetAlignment() const
+{
+	return uniformBufferOffsetAlignment;
+}
+
 int OpenGL::getMax2DTextureSize() const
 {
 	return std::max(max2DTextureSize, 1);
@@ -1251,6 +1573,11 @@ int OpenGL::getMaxRenderbufferSamples() const
 	return maxRenderbufferSamples;
 }
 
+int OpenGL::getMaxThreadgroups() const
+{
+	return maxThreadgroups;
+}
+
 int OpenGL::getMaxTextureUnits() const
 {
 	return maxTextureUnits;
@@ -33,10 +33,13 @@
 
 // GLAD
 #include "libraries/glad/gladfuncs.hpp"
+#include "libraries/xxHash/xxhash.h"
 
 // C++
 #include <vector>
 #include <stack>
+#include <cstring>
+#include <unordered_map>
 
 // The last argument to AttribPointer takes a buffer offset casted to a pointer.
 #define BUFFER_OFFSET(i) ((char *) NULL + (i))
@@ -211,15 +214,35 @@ public:
 	 **/
 	void bindBuffer(BufferType type, GLuint buffer);
 
+	/**
+	 * glBindBufferRange for uniform buffers, which also changes the generic
+	 * GL_UNIFORM_BUFFER binding point used by bindBuffer.
+	 **/
+	void bindUniformBuffer(int binding, GLuint buffer, size_t offset, size_t size);
+
+	/**
+	 * glBindBufferBase for shader storage buffers, which also changes the
+	 * generic GL_SHADER_STORAGE_BUFFER binding point used by bindBuffer.
+	 **/
+	void bindShaderStorageBuffer(int binding, GLuint buffer);
+
 	/**
 	 * glDeleteBuffers which updates our shadowed state.
 	 **/
 	void deleteBuffer(GLuint buffer);
 
 	/**
-	 * Set all vertex attribute state.
+	 * Set all vertex attribute state. If cached is true and vertex array
+	 * objects are supported, the state is kept in a VAO which is reused by
+	 * later calls with the same layout and buffers. That should only be used
+	 * for buffers whose layout and contents location rarely change.
+	 **/
+	void setVertexAttributes(const vertex::Attributes &attributes, const vertex::Buffers &buffers, bool cached = false);
+
+	/**
+	 * Deletes all cached vertex array objects.
 	 **/
-	void setVertexAttributes(const vertex::Attributes &attributes, const vertex::Buffers &buffers);
+	void clearVertexArrayCache();
 
 	/**
 	 * Wrapper for glCullFace which eliminates redundant state setting.
@@ -289,6 +312,12 @@ public:
 	 **/
 	GLuint getDefaultFBO() const;
 
+	/**
+	 * Replaces the system drawable, e.g. with an offscreen framebuffer when
+	 * there's no window. 0 restores the platform's default.
+	 **/
+	void setDefaultFBO(GLuint fbo);
+
 	/**
 	 * Gets the ID for love's default texture (used for "untextured" primitives.)
 	 **/
@@ -309,6 +338,7 @@ public:
 	 **/
 	void bindTextureToUnit(TextureType target, GLuint texture, int textureunit, bool restoreprev);
 	void bindTextureToUnit(Texture *texture, int textureunit, bool restoreprev);
+	GLuint getBoundTexture(TextureType target, int textureunit) const;
 
 	/**
 	 * Helper for deleting an OpenGL texture.
@@ -342,6 +372,22 @@ public:
 	bool isDepthCompareSampleSupported() const;
 	bool isSamplerLODBiasSupported() const;
 	bool isBaseVertexSupported() const;
+	bool isTimerQuerySupported() const;
+	bool isOcclusionQuerySupported() const;
+	GLenum getOcclusionQueryTarget(bool conservative) const;
+	bool isUniformBufferSupported() const;
+	bool isDrawIndirectSupported() const;
+	bool isComputeSupported() const;
+	bool isCopyImageSupported() const;
+	bool isCopyBufferSupported() const;
+	bool isFramebufferBlitSupported() const;
+	bool isMultiDrawIndirectSupported() const;
+	bool isVertexArrayCacheSupported() const;
+
+	/**
+	 * Returns the required alignment of offsets into uniform buffers.
+	 **/
+	int getUniformBufferOffsetAlignment() const;
 
 	/**
 	 * Returns the maximum supported width or height of a texture.
@@ -361,6 +407,12 @@ public:
 	 **/
 	int getMaxRenderbufferSamples() const;
 
+	/**
+	 * Returns the maximum number of compute threadgroups per dispatch, in each
+	 * dimension.
+	 **/
+	int getMaxThreadgroups() const;
+
 	/**
 	 * Returns the maximum number of accessible texture units.
 	 **/
@@ -413,11 +465,52 @@ public:
 
 private:
 
+	// The attribute layout and bound buffers a cached VAO was created with.
+	struct VertexArrayKey
+	{
+		struct Attrib
+		{
+			uint32 index;
+			uint32 format; // type | components << 8
+			uint32 offsetStride; // offsetfromvertex | stride << 16
+			GLuint buffer;
+			size_t bufferOffset;
+		};
+
+		uint32 enableBits;
+		uint32 instanceBits;
+		uint32 count;
+		Attrib attribs[vertex::Attributes::MAX];
+
+		bool operator == (const VertexArrayKey &other) const
+		{
+			return enableBits == other.enableBits && instanceBits == other.instanceBits
+				&& count == other.count && memcmp(attribs, other.attribs, sizeof(Attrib) * count) == 0;
+		}
+	};
+
+	struct VertexArrayKeyHasher
+	{
+		size_t operator() (const VertexArrayKey &key) const
+		{
+			return XXH32(key.attribs, sizeof(VertexArrayKey::Attrib) * key.count, key.enableBits ^ key.instanceBits);
+		}
+	};
+
+	struct CachedVertexArray
+	{
+		GLuint vao;
+		GLuint indexBuffer; // Element array bindings are part of VAO state.
+	};
+
 	void initVendor();
 	void initOpenGLFunctions();
 	void initMaxValues();
 	void createDefaultTexture();
 
+	void bindVertexArray(CachedVertexArray *va);
+	void resetConstantAttributes(uint32 enablebits);
+
 	bool contextInitialized;
 
 	bool pixelShaderHighpSupported;
@@ -431,13 +524,21 @@ private:
 	int maxTextureArrayLayers;
 	int maxRenderTargets;
 	int maxRenderbufferSamples;
+	int maxThreadgroups;
 	int maxTextureUnits;
+	int uniformBufferOffsetAlignment;
 	float maxPointSize;
 
 	bool coreProfile;
 
 	Vendor vendor;
 
+	GLuint defaultFBO;
+
+	// Cached VAOs are dropped when a buffer they use is deleted, or when there
+	// are too many of them.
+	std::unordered_map<VertexArrayKey, CachedVertexArray, VertexArrayKeyHasher> vertexArrays;
+
 	// Tracked OpenGL state.
 	struct
 	{
@@ -452,9 +553,17 @@ private:
 
 		int curTextureUnit;
 
+		// Attribute arrays of the default VAO.
 		uint32 enabledAttribArrays;
 		uint32 instancedAttribArrays;
 
+		// Attribute arrays used by the last draw, in any VAO.
+		uint32 drawAttribArrays;
+
+		GLuint defaultVertexArray;
+		GLuint defaultIndexBuffer;
+		CachedVertexArray *boundVertexArray; // nullptr for the default VAO.
+
 		Colorf constantColor;
 		Colorf lastConstantColor;
 
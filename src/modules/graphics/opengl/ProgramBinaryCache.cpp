@@ -0,0 +1,169 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "ProgramBinaryCache.h"
+#include "common/int.h"
+#include "filesystem/AssetCache.h"
+
+// C++
+#include <vector>
+
+// C
+#include <cstring>
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+using filesystem::AssetCache;
+
+// Changing how programs are built (attribute bindings etc.) must bump this,
+// so stale entries aren't loaded.
+static const uint32 CACHE_VERSION = 1;
+
+// Cache entries are the binary format followed by the binary.
+struct CacheHeader
+{
+	uint32 format;
+};
+
+static bool hasCoreProgramBinary()
+{
+	return GLAD_VERSION_4_1 || GLAD_ARB_get_program_binary || GLAD_ES_VERSION_3_0;
+}
+
+bool ProgramBinaryCache::isSupported()
+{
+	if (!hasCoreProgramBinary() && !GLAD_OES_get_program_binary)
+		return false;
+
+	// Some drivers expose the API with no formats to use it with.
+	GLint formats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+	return formats > 0;
+}
+
+std::string ProgramBinaryCache::getKey(const std::string *stagehashes, int count)
+{
+	std::string key;
+
+	for (int i = 0; i < count; i++)
+	{
+		if (stagehashes[i].empty())
+			return std::string();
+
+		key += stagehashes[i];
+	}
+
+	// Binaries are only valid for the driver that made them.
+	const GLenum strings[] = {GL_VENDOR, GL_RENDERER, GL_VERSION};
+	for (GLenum name : strings)
+	{
+		const char *str = (const char *) glGetString(name);
+		if (str != nullptr)
+			key += str;
+		key += '\n';
+	}
+
+	key += "program " + std::to_string(CACHE_VERSION);
+
+	return AssetCache::getKey(key);
+}
+
+bool ProgramBinaryCache::load(GLuint program, const std::string &key)
+{
+	AssetCache::Entry entry;
+	if (!AssetCache::load(AssetCache::CATEGORY_SHADERS, key, entry))
+		return false;
+
+	if (entry.size <= sizeof(CacheHeader))
+		return false;
+
+	CacheHeader header;
+	memcpy(&header, entry.payload, sizeof(CacheHeader));
+
+	const uint8 *binary = entry.payload + sizeof(CacheHeader);
+	GLsizei binarysize = (GLsizei) (entry.size - sizeof(CacheHeader));
+
+	if (hasCoreProgramBinary())
+		glProgramBinary(program, (GLenum) header.format, binary, binarysize);
+	else
+		glProgramBinaryOES(program, (GLenum) header.format, binary, binarysize);
+
+	GLint status = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+
+	// Driver updates can invalidate binaries even when the version strings
+	// stay the same. The program gets linked from source and saved again.
+	if (status == GL_FALSE)
+	{
+		AssetCache::remove(AssetCache::CATEGORY_SHADERS, key);
+		return false;
+	}
+
+	return true;
+}
+
+void ProgramBinaryCache::prepare(GLuint program)
+{
+	if (hasCoreProgramBinary())
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+void ProgramBinaryCache::save(GLuint program, const std::string &key)
+{
+	if (key.empty() || !AssetCache::isEnabled(AssetCache::CATEGORY_SHADERS))
+		return;
+
+	GLint binarysize = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binarysize);
+
+	if (binarysize <= 0)
+		return;
+
+	std::vector<uint8> contents(sizeof(CacheHeader) + binarysize);
+
+	GLenum format = 0;
+	GLsizei length = 0;
+	uint8 *binary = contents.data() + sizeof(CacheHeader);
+
+	if (hasCoreProgramBinary())
+		glGetProgramBinary(program, binarysize, &length, &format, binary);
+	else
+		glGetProgramBinaryOES(program, binarysize, &length, &format, binary);
+
+	if (length <= 0)
+		return;
+
+	CacheHeader header;
+	header.format = (uint32) format;
+	memcpy(contents.data(), &header, sizeof(CacheHeader));
+
+	AssetCache::save(AssetCache::CATEGORY_SHADERS, key, contents.data(), sizeof(CacheHeader) + length);
+}
+
+} // opengl
+} // graphics
+} // love
@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "OpenGL.h"
+
+// C++
+#include <string>
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+/**
+ * Stores linked shader programs in the "shaders" category of the AssetCache
+ * with glGetProgramBinary, so later runs (and context reloads) can skip
+ * compiling and linking. Entries are keyed by the shader sources and the GL
+ * driver, and any entry the driver rejects is treated as a miss.
+ **/
+class ProgramBinaryCache
+{
+public:
+
+	static bool isSupported();
+
+	/**
+	 * Gets the cache key for a program made of stages with the given source
+	 * hashes. Returns an empty string if the program can't be cached.
+	 **/
+	static std::string getKey(const std::string *stagehashes, int count);
+
+	/**
+	 * Loads a cached binary into program. Returns true if the program is now
+	 * linked.
+	 **/
+	static bool load(GLuint program, const std::string &key);
+
+	/**
+	 * Should be called before glLinkProgram for programs which will be saved.
+	 **/
+	static void prepare(GLuint program);
+
+	/**
+	 * Writes the binary of a linked program to the cache. Failures are
+	 * ignored.
+	 **/
+	static void save(GLuint program, const std::string &key);
+
+}; // ProgramBinaryCache
+
+} // opengl
+} // graphics
+} // love
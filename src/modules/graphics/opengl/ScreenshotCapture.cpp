@@ -0,0 +1,319 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "ScreenshotCapture.h"
+#include "GraphicsReadback.h"
+#include "image/Image.h"
+#include "common/Module.h"
+
+// C
+#include <string.h>
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+ScreenshotCapture::Worker::Worker()
+	: stopping(false)
+{
+	threadName = "ScreenshotWorker";
+}
+
+ScreenshotCapture::Worker::~Worker()
+{
+	stop();
+}
+
+void ScreenshotCapture::Worker::addJob(const Job &job)
+{
+	love::thread::Lock l(mutex);
+	jobs.push_back(job);
+	cond->broadcast();
+}
+
+void ScreenshotCapture::Worker::getResults(std::vector<Result> &out)
+{
+	love::thread::Lock l(mutex);
+	out.insert(out.end(), results.begin(), results.end());
+	results.clear();
+}
+
+void ScreenshotCapture::Worker::stop()
+{
+	{
+		love::thread::Lock l(mutex);
+		if (stopping)
+			return;
+		stopping = true;
+		cond->broadcast();
+	}
+
+	owner->wait();
+}
+
+void ScreenshotCapture::Worker::threadFunction()
+{
+	while (true)
+	{
+		Job job;
+
+		{
+			love::thread::Lock l(mutex);
+
+			while (!stopping && jobs.empty())
+				cond->wait(mutex);
+
+			if (jobs.empty())
+				return;
+
+			job = jobs.front();
+			jobs.pop_front();
+		}
+
+		process(job);
+	}
+}
+
+void ScreenshotCapture::Worker::process(Job &job)
+{
+	size_t row = 4 * job.width;
+	size_t size = row * job.height;
+
+	Result result;
+
+	try
+	{
+		uint8 *pixels = job.pixels;
+
+		// Replace alpha values with full opacity.
+		for (size_t i = 3; i < size; i += 4)
+			pixels[i] = 255;
+
+		// OpenGL reads pixels from the lower-left, so flip the rows in place.
+		std::vector<uint8> temp(row);
+		for (int y = 0; y < job.height / 2; y++)
+		{
+			uint8 *top = pixels + y * row;
+			uint8 *bottom = pixels + (job.height - 1 - y) * row;
+
+			memcpy(temp.data(), top, row);
+			memcpy(top, bottom, row);
+			memcpy(bottom, temp.data(), row);
+		}
+
+		auto imagemodule = Module::getInstance<love::image::Image>(Module::M_IMAGE);
+
+		// The ImageData takes ownership of the pixels.
+		result.imageData.set(imagemodule->newImageData(job.width, job.height, PIXELFORMAT_RGBA8, pixels, true), Acquire::NORETAIN);
+		job.pixels = nullptr;
+	}
+	catch (std::exception &)
+	{
+		delete[] job.pixels;
+		job.pixels = nullptr;
+	}
+
+	for (const Graphics::ScreenshotInfo &info : job.callbacks)
+	{
+		// Callbacks which touch Lua have to wait for the main thread, even
+		// if they're only being told the capture failed.
+		if (info.threadSafe)
+			info.callback(&info, result.imageData.get(), nullptr);
+		else
+			result.callbacks.push_back(info);
+	}
+
+	if (!result.callbacks.empty())
+	{
+		love::thread::Lock l(mutex);
+		results.push_back(result);
+	}
+}
+
+ScreenshotCapture::ScreenshotCapture()
+	: worker(nullptr)
+{
+}
+
+ScreenshotCapture::~ScreenshotCapture()
+{
+	// Any remaining reads can't be completed without a context at this point.
+	for (Pending &p : pending)
+	{
+		for (const Graphics::ScreenshotInfo &info : p.callbacks)
+			info.callback(&info, nullptr, nullptr);
+		delete p.sync;
+	}
+
+	pending.clear();
+
+	if (worker != nullptr)
+	{
+		worker->stop();
+		runResults(nullptr);
+		delete worker;
+	}
+}
+
+bool ScreenshotCapture::isSupported()
+{
+	return GraphicsReadback::isSupported();
+}
+
+void ScreenshotCapture::capture(int width, int height, std::vector<Graphics::ScreenshotInfo> &callbacks)
+{
+	if (worker == nullptr)
+	{
+		worker = new Worker();
+		worker->start();
+	}
+
+	Pending p;
+	p.width = width;
+	p.height = height;
+	p.frames = 0;
+	p.callbacks = callbacks;
+	p.sync = new FenceSync();
+
+	callbacks.clear();
+
+	if (!freeBuffers.empty())
+	{
+		p.pbo = freeBuffers.back();
+		freeBuffers.pop_back();
+	}
+	else
+		glGenBuffers(1, &p.pbo);
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, p.pbo);
+	glBufferData(GL_PIXEL_PACK_BUFFER, 4 * width * height, nullptr, GL_STREAM_READ);
+
+	glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	p.sync->fence();
+
+	pending.push_back(p);
+}
+
+void ScreenshotCapture::finish(Pending &p)
+{
+	size_t size = 4 * p.width * p.height;
+
+	Job job;
+	job.width = p.width;
+	job.height = p.height;
+	job.callbacks = p.callbacks;
+	job.pixels = new (std::nothrow) uint8[size];
+
+	p.sync->cpuWait();
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, p.pbo);
+
+	const void *src = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+
+	if (src != nullptr && job.pixels != nullptr)
+		memcpy(job.pixels, src, size);
+	else
+	{
+		delete[] job.pixels;
+		job.pixels = nullptr;
+	}
+
+	if (src != nullptr)
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	freeBuffers.push_back(p.pbo);
+
+	delete p.sync;
+	p.sync = nullptr;
+
+	if (job.pixels != nullptr)
+		worker->addJob(job);
+	else
+	{
+		for (const Graphics::ScreenshotInfo &info : job.callbacks)
+			info.callback(&info, nullptr, nullptr);
+	}
+}
+
+void ScreenshotCapture::update(void *screenshotCallbackData)
+{
+	// Reads complete in order, so only the oldest ones need to be checked.
+	while (!pending.empty())
+	{
+		Pending &p = pending.front();
+
+		if (p.frames < MAX_PENDING_FRAMES && !p.sync->isSignaled())
+			break;
+
+		finish(p);
+		pending.pop_front();
+	}
+
+	for (Pending &p : pending)
+		p.frames++;
+
+	runResults(screenshotCallbackData);
+}
+
+void ScreenshotCapture::runResults(void *screenshotCallbackData)
+{
+	if (worker == nullptr)
+		return;
+
+	std::vector<Result> results;
+	worker->getResults(results);
+
+	for (const Result &result : results)
+	{
+		for (const Graphics::ScreenshotInfo &info : result.callbacks)
+		{
+			if (result.imageData.get() != nullptr)
+				info.callback(&info, result.imageData.get(), screenshotCallbackData);
+			else
+				info.callback(&info, nullptr, nullptr);
+		}
+	}
+}
+
+void ScreenshotCapture::unload()
+{
+	for (Pending &p : pending)
+		finish(p);
+
+	pending.clear();
+
+	if (!freeBuffers.empty())
+		glDeleteBuffers((GLsizei) freeBuffers.size(), freeBuffers.data());
+
+	freeBuffers.clear();
+}
+
+} // opengl
+} // graphics
+} // love
@@ -0,0 +1,142 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "OpenGL.h"
+#include "FenceSync.h"
+#include "graphics/Graphics.h"
+#include "image/ImageData.h"
+#include "thread/threads.h"
+
+// C++
+#include <vector>
+#include <deque>
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+/**
+ * Turns love.graphics.captureScreenshot into a pipeline which doesn't stall:
+ * the backbuffer is read into a pixel pack buffer, the buffer is mapped a few
+ * frames later once the GPU has caught up, and the row flip and any encoding
+ * happen on a worker thread.
+ **/
+class ScreenshotCapture
+{
+public:
+
+	ScreenshotCapture();
+	~ScreenshotCapture();
+
+	/**
+	 * Queues a read of the currently bound read framebuffer. Takes ownership
+	 * of the callbacks, and clears the given list.
+	 **/
+	void capture(int width, int height, std::vector<Graphics::ScreenshotInfo> &callbacks);
+
+	/**
+	 * Hands finished reads to the worker thread and calls any callbacks which
+	 * must run on the main thread.
+	 **/
+	void update(void *screenshotCallbackData);
+
+	// Must be called while the OpenGL context is still active.
+	void unload();
+
+	static bool isSupported();
+
+private:
+
+	struct Pending
+	{
+		GLuint pbo;
+		FenceSync *sync;
+		int width;
+		int height;
+		int frames;
+		std::vector<Graphics::ScreenshotInfo> callbacks;
+	};
+
+	struct Job
+	{
+		uint8 *pixels;
+		int width;
+		int height;
+		std::vector<Graphics::ScreenshotInfo> callbacks;
+	};
+
+	struct Result
+	{
+		StrongRef<love::image::ImageData> imageData;
+		std::vector<Graphics::ScreenshotInfo> callbacks;
+	};
+
+	class Worker : public love::thread::Threadable
+	{
+	public:
+
+		Worker();
+		virtual ~Worker();
+
+		// Implements Threadable.
+		void threadFunction() override;
+
+		void addJob(const Job &job);
+		void getResults(std::vector<Result> &results);
+
+		// Finishes any queued jobs before returning.
+		void stop();
+
+	private:
+
+		void process(Job &job);
+
+		std::deque<Job> jobs;
+		std::vector<Result> results;
+
+		love::thread::MutexRef mutex;
+		love::thread::ConditionalRef cond;
+
+		bool stopping;
+
+	}; // Worker
+
+	void finish(Pending &p);
+	void runResults(void *screenshotCallbackData);
+
+	// Reads older than this are waited on rather than polled.
+	static const int MAX_PENDING_FRAMES = 3;
+
+	std::deque<Pending> pending;
+	std::vector<GLuint> freeBuffers;
+
+	Worker *worker;
+
+}; // ScreenshotCapture
+
+} // opengl
+} // graphics
+} // love
@@ -20,9 +20,13 @@
 
 // LOVE
 #include "common/config.h"
+#include "common/profiling.h"
 
 #include "Shader.h"
+#include "ShaderStage.h"
 #include "Graphics.h"
+#include "ProgramBinaryCache.h"
+#include "graphics/Mesh.h"
 
 // C++
 #include <algorithm>
@@ -36,20 +40,48 @@ namespace graphics
 namespace opengl
 {
 
-Shader::Shader(love::graphics::ShaderStage *vertex, love::graphics::ShaderStage *pixel)
-	: love::graphics::Shader(vertex, pixel)
+static void bindImageUnit(int index, GLuint texture, GLenum format, bool layered)
+{
+	glBindImageTexture((GLuint) index, texture, 0, layered ? GL_TRUE : GL_FALSE, 0, GL_READ_WRITE, format);
+}
+
+Shader::Shader(love::graphics::ShaderStage *vertex, love::graphics::ShaderStage *pixel, bool async)
+	: love::graphics::Shader(vertex, pixel, async)
 	, program(0)
+	, programLinked(false)
+	, programPending(false)
+	, asyncLoad(async)
 	, builtinUniforms()
 	, builtinUniformInfo()
 	, builtinAttributes()
+	, localThreadgroupSize()
 	, canvasWasActive(false)
 	, lastViewport()
 	, lastPointSize(0.0f)
+	, builtinBlockIndex(GL_INVALID_INDEX)
 {
 	// load shader source and create program object
 	loadVolatile();
 }
 
+Shader::Shader(love::graphics::ShaderStage *compute)
+	: love::graphics::Shader(compute)
+	, program(0)
+	, programLinked(false)
+	, programPending(false)
+	, asyncLoad(false)
+	, builtinUniforms()
+	, builtinUniformInfo()
+	, builtinAttributes()
+	, localThreadgroupSize()
+	, canvasWasActive(false)
+	, lastViewport()
+	, lastPointSize(0.0f)
+	, builtinBlockIndex(GL_INVALID_INDEX)
+{
+	loadVolatile();
+}
+
 Shader::~Shader()
 {
 	unloadVolatile();
@@ -60,7 +92,7 @@ Shader::~Shader()
 		if (p.second.data != nullptr)
 			free(p.second.data);
 
-		if (p.second.baseType == UNIFORM_SAMPLER)
+		if (p.second.baseType == UNIFORM_SAMPLER || p.second.baseType == UNIFORM_STORAGE_IMAGE)
 		{
 			for (int i = 0; i < p.second.count; i++)
 			{
@@ -96,6 +128,8 @@ void Shader::mapActiveUniforms()
 	std::map<std::string, UniformInfo> olduniforms = uniforms;
 	uniforms.clear();
 
+	int nextimageunit = 0;
+
 	for (int uindex = 0; uindex < numuniforms; uindex++)
 	{
 		GLsizei namelen = 0;
@@ -148,8 +182,12 @@ void Shader::mapActiveUniforms()
 		if (oldu != olduniforms.end())
 		{
 			u.data = oldu->second.data;
+			u.dataSize = oldu->second.dataSize;
 			u.textures = oldu->second.textures;
 
+			if (u.baseType == UNIFORM_STORAGE_IMAGE)
+				nextimageunit = std::max(nextimageunit, u.ints[u.count - 1] + 1);
+
 			updateUniform(&u, u.count, true);
 		}
 		else
@@ -160,21 +198,18 @@ void Shader::mapActiveUniforms()
 			{
 			case UNIFORM_FLOAT:
 				u.dataSize = sizeof(float) * u.components * u.count;
-				u.data = malloc(u.dataSize);
 				break;
 			case UNIFORM_INT:
 			case UNIFORM_BOOL:
 			case UNIFORM_SAMPLER:
+			case UNIFORM_STORAGE_IMAGE:
 				u.dataSize = sizeof(int) * u.components * u.count;
-				u.data = malloc(u.dataSize);
 				break;
 			case UNIFORM_UINT:
 				u.dataSize = sizeof(unsigned int) * u.components * u.count;
-				u.data = malloc(u.dataSize);
 				break;
 			case UNIFORM_MATRIX:
 				u.dataSize = sizeof(float) * (u.matrix.rows * u.matrix.columns) * u.count;
-				u.data = malloc(u.dataSize);
 				break;
 			default:
 				break;
@@ -182,7 +217,10 @@ void Shader::mapActiveUniforms()
 
 			if (u.dataSize > 0)
 			{
-				memset(u.data, 0, u.dataSize);
+				// The second half holds the values last sent to OpenGL, so
+				// sending unchanged values can be skipped.
+				u.data = malloc(u.dataSize * 2);
+				memset(u.data, 0, u.dataSize * 2);
 
 				if (u.baseType == UNIFORM_SAMPLER)
 				{
@@ -196,6 +234,31 @@ void Shader::mapActiveUniforms()
 
 					glUniform1iv(u.location, u.count, u.ints);
 
+					u.textures = new Texture*[u.count];
+					memset(u.textures, 0, sizeof(Texture *) * u.count);
+				}
+				else if (u.baseType == UNIFORM_STORAGE_IMAGE)
+				{
+					if (GLAD_ES_VERSION_2_0)
+					{
+						// OpenGL ES only allows image units to be set with a
+						// layout qualifier in the shader code.
+						GLint binding = 0;
+						glGetUniformiv(program, u.location, &binding);
+
+						for (int i = 0; i < u.count; i++)
+							u.ints[i] = binding + i;
+					}
+					else
+					{
+						for (int i = 0; i < u.count; i++)
+							u.ints[i] = nextimageunit + i;
+
+						glUniform1iv(u.location, u.count, u.ints);
+					}
+
+					nextimageunit = std::max(nextimageunit, u.ints[u.count - 1] + 1);
+
 					u.textures = new Texture*[u.count];
 					memset(u.textures, 0, sizeof(Texture *) * u.count);
 				}
@@ -243,6 +306,9 @@ void Shader::mapActiveUniforms()
 					break;
 				}
 			}
+
+			if (u.dataSize > 0)
+				memcpy(getUploadedData(&u), u.data, u.dataSize);
 		}
 
 		uniforms[u.name] = u;
@@ -250,7 +316,7 @@ void Shader::mapActiveUniforms()
 		if (builtin != BUILTIN_MAX_ENUM)
 			builtinUniformInfo[(int)builtin] = &uniforms[u.name];
 
-		if (u.baseType == UNIFORM_SAMPLER)
+		if (u.baseType == UNIFORM_SAMPLER || u.baseType == UNIFORM_STORAGE_IMAGE)
 		{
 			// Make sure all stored textures have their Volatiles loaded before
 			// the sendTextures call, since it calls getHandle().
@@ -276,7 +342,7 @@ void Shader::mapActiveUniforms()
 		{
 			free(p.second.data);
 
-			if (p.second.baseType != UNIFORM_SAMPLER)
+			if (p.second.baseType != UNIFORM_SAMPLER && p.second.baseType != UNIFORM_STORAGE_IMAGE)
 				continue;
 
 			for (int i = 0; i < p.second.count; i++)
@@ -294,6 +360,8 @@ void Shader::mapActiveUniforms()
 
 bool Shader::loadVolatile()
 {
+	LOVE_PROFILE_ZONE("Shader:link");
+
 	OpenGL::TempDebugGroup debuggroup("Shader load");
 
     // Recreating the shader program will invalidate uniforms that rely on these.
@@ -311,46 +379,78 @@ bool Shader::loadVolatile()
 	textureUnits.clear();
 	textureUnits.push_back(TextureUnit());
 
-	for (const auto &stage : stages)
-	{
-		if (stage.get() != nullptr)
-			stage->loadVolatile();
-	}
-
 	program = glCreateProgram();
 
 	if (program == 0)
 		throw love::Exception("Cannot create shader program object.");
 
-	for (const auto &stage : stages)
-	{
-		if (stage.get() != nullptr)
-			glAttachShader(program, (GLuint) stage->getHandle());
-	}
+	programCacheKey.clear();
 
-	// Bind generic vertex attribute indices to names in the shader.
-	for (int i = 0; i < int(ATTRIB_MAX_ENUM); i++)
+	if (ProgramBinaryCache::isSupported())
 	{
-		const char *name = nullptr;
-		if (vertex::getConstant((VertexAttribID) i, name))
-			glBindAttribLocation(program, i, (const GLchar *) name);
+		std::string stagehashes[ShaderStage::STAGE_MAX_ENUM];
+		for (int i = 0; i < ShaderStage::STAGE_MAX_ENUM; i++)
+		{
+			if (stages[i].get() != nullptr)
+				stagehashes[i] = stages[i]->getCacheKey();
+		}
+
+		programCacheKey = ProgramBinaryCache::getKey(stagehashes, ShaderStage::STAGE_MAX_ENUM);
 	}
 
-	glLinkProgram(program);
+	programLinked = !ProgramBinaryCache::load(program, programCacheKey);
+	if (programLinked)
+		startLink();
 
-	GLint status;
-	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	programPending = true;
 
-	if (status == GL_FALSE)
-	{
-		std::string warnings = getProgramWarnings();
-		glDeleteProgram(program);
-		program = 0;
-		throw love::Exception("Cannot link shader program object:\n%s", warnings.c_str());
-	}
+	// Async shaders finish in finishLoading, once the driver is done with them.
+	// When everything is being reloaded, the driver can link in the background
+	// while other objects load, until finishVolatileLoad.
+	if (!asyncLoad && !Volatile::isLoadingAll())
+		finishProgram();
+
+	return true;
+}
+
+void Shader::finishVolatileLoad()
+{
+	if (!asyncLoad)
+		finishProgram();
+}
+
+bool Shader::isProgramReady()
+{
+	if (!programPending || !programLinked)
+		return true;
+
+	// Without the extension, checking the link status always blocks.
+	if (!(GLAD_KHR_parallel_shader_compile || GLAD_ARB_parallel_shader_compile))
+		return true;
+
+	GLint done = GL_TRUE;
+	glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &done);
+	return done != GL_FALSE;
+}
+
+void Shader::finishProgram()
+{
+	if (!programPending)
+		return;
+
+	programPending = false;
+	asyncLoad = false;
+
+	if (programLinked)
+		checkLink();
 
 	// Get all active uniform variables in this shader from OpenGL.
 	mapActiveUniforms();
+	mapActiveUniformBlocks();
+	mapActiveStorageBlocks();
+
+	if (isCompute())
+		glGetProgramiv(program, GL_COMPUTE_WORK_GROUP_SIZE, localThreadgroupSize);
 
 	for (int i = 0; i < int(ATTRIB_MAX_ENUM); i++)
 	{
@@ -368,8 +468,77 @@ bool Shader::loadVolatile()
 		attach();
 		updateBuiltinUniforms();
 	}
+}
 
-	return true;
+void Shader::startLink()
+{
+	for (const auto &stage : stages)
+	{
+		if (stage.get() == nullptr)
+			continue;
+
+		ShaderStage *glstage = (ShaderStage *) stage.get();
+
+		try
+		{
+			glstage->startCompile();
+		}
+		catch (love::Exception &)
+		{
+			glDeleteProgram(program);
+			program = 0;
+			throw;
+		}
+
+		glAttachShader(program, (GLuint) glstage->getHandle());
+	}
+
+	// Bind generic vertex attribute indices to names in the shader.
+	for (int i = 0; i < int(ATTRIB_MAX_ENUM); i++)
+	{
+		const char *name = nullptr;
+		if (vertex::getConstant((VertexAttribID) i, name))
+			glBindAttribLocation(program, i, (const GLchar *) name);
+	}
+
+	if (!programCacheKey.empty())
+		ProgramBinaryCache::prepare(program);
+
+	glLinkProgram(program);
+}
+
+void Shader::checkLink()
+{
+	for (const auto &stage : stages)
+	{
+		if (stage.get() == nullptr)
+			continue;
+
+		try
+		{
+			((ShaderStage *) stage.get())->checkCompileStatus();
+		}
+		catch (love::Exception &)
+		{
+			glDeleteProgram(program);
+			program = 0;
+			throw;
+		}
+	}
+
+	GLint status;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+
+	if (status == GL_FALSE)
+	{
+		std::string warnings = getProgramWarnings();
+		glDeleteProgram(program);
+		program = 0;
+		throw love::Exception("Cannot link shader program object:\n%s", warnings.c_str());
+	}
+
+	if (!programCacheKey.empty())
+		ProgramBinaryCache::save(program, programCacheKey);
 }
 
 void Shader::unloadVolatile()
@@ -383,10 +552,24 @@ void Shader::unloadVolatile()
 		program = 0;
 	}
 
+	programPending = false;
+
+	// The CPU copies are kept so the blocks can be restored on reload.
+	for (auto &p : uniformBlocks)
+	{
+		if (p.second.buffer != 0)
+			gl.deleteBuffer(p.second.buffer);
+		p.second.buffer = 0;
+	}
+
+	builtinBlockIndex = GL_INVALID_INDEX;
+
 	// active texture list is probably invalid, clear it
 	textureUnits.clear();
 	textureUnits.push_back(TextureUnit());
 
+	imageUnits.clear();
+
 	attributes.clear();
 
 	// And the locations of any built-in uniform variables.
@@ -458,6 +641,23 @@ void Shader::attach()
 			updateUniform(p.first, p.second, true);
 
 		pendingUniformUpdates.clear();
+
+		// Binding points for user blocks are shared with other shaders.
+		for (const auto &p : uniformBlocks)
+		{
+			const UniformBlock &block = p.second;
+			gl.bindUniformBuffer(block.binding, block.buffer, 0, block.data.size());
+		}
+
+		// Image units and storage buffer bindings are shared as well.
+		for (int i = 0; i < (int) imageUnits.size(); i++)
+		{
+			const ImageUnit &unit = imageUnits[i];
+			if (unit.texture != 0)
+				bindImageUnit(i, unit.texture, unit.format, unit.layered);
+		}
+
+		bindStorageBuffers();
 	}
 }
 
@@ -483,6 +683,19 @@ void Shader::updateUniform(const UniformInfo *info, int count)
 
 void Shader::updateUniform(const UniformInfo *info, int count, bool internalupdate)
 {
+	if (info->dataSize > 0)
+	{
+		size_t size = (info->dataSize / info->count) * count;
+		void *uploaded = getUploadedData(info);
+
+		if (!internalupdate && memcmp(uploaded, info->data, size) == 0)
+			return;
+
+		// Pending updates are sent from the same memory when the shader is
+		// next attached, so they count as uploaded here.
+		memcpy(uploaded, info->data, size);
+	}
+
 	if (current != this && !internalupdate)
 	{
 		pendingUniformUpdates.push_back(std::make_pair(info, count));
@@ -513,6 +726,12 @@ void Shader::updateUniform(const UniformInfo *info, int count, bool internalupda
 			break;
 		}
 	}
+	else if (type == UNIFORM_STORAGE_IMAGE)
+	{
+		// Image units are fixed by the shader code in OpenGL ES.
+		if (!GLAD_ES_VERSION_2_0)
+			glUniform1iv(location, count, info->ints);
+	}
 	else if (type == UNIFORM_INT || type == UNIFORM_BOOL || type == UNIFORM_SAMPLER)
 	{
 		switch (info->components)
@@ -582,6 +801,9 @@ void Shader::sendTextures(const UniformInfo *info, Texture **textures, int count
 
 void Shader::sendTextures(const UniformInfo *info, Texture **textures, int count, bool internalUpdate)
 {
+	if (info->baseType == UNIFORM_STORAGE_IMAGE)
+		return sendStorageImages(info, textures, count, internalUpdate);
+
 	if (info->baseType != UNIFORM_SAMPLER)
 		return;
 
@@ -639,7 +861,10 @@ void Shader::sendTextures(const UniformInfo *info, Texture **textures, int count
 
 		GLuint gltex = 0;
 		if (textures[i] != nullptr)
+		{
 			gltex = (GLuint) tex->getHandle();
+			tex->markUsed();
+		}
 		else
 			gltex = gl.getDefaultTexture(info->textureType);
 
@@ -653,10 +878,300 @@ void Shader::sendTextures(const UniformInfo *info, Texture **textures, int count
 	}
 }
 
+void Shader::sendStorageImages(const UniformInfo *info, Texture **textures, int count, bool internalUpdate)
+{
+	bool shaderactive = current == this;
+
+	if (!internalUpdate && shaderactive)
+		flushStreamDraws();
+
+	count = std::min(count, info->count);
+
+	for (int i = 0; i < count; i++)
+	{
+		Texture *tex = textures[i];
+		GLenum format = GL_RGBA8;
+
+		if (tex != nullptr)
+		{
+			PixelFormat pixelformat = tex->getPixelFormat();
+
+			if (tex->getTextureType() != info->textureType)
+			{
+				if (internalUpdate)
+					continue;
+				else
+				{
+					const char *textypestr = "unknown";
+					const char *shadertextypestr = "unknown";
+					Texture::getConstant(tex->getTextureType(), textypestr);
+					Texture::getConstant(info->textureType, shadertextypestr);
+					throw love::Exception("Texture's type (%s) must match the type of %s (%s).", textypestr, info->name.c_str(), shadertextypestr);
+				}
+			}
+			else if (isPixelFormatCompressed(pixelformat) || isPixelFormatDepthStencil(pixelformat) || pixelformat == PIXELFORMAT_sRGBA8)
+			{
+				if (internalUpdate)
+					continue;
+				else
+				{
+					const char *formatstr = "unknown";
+					love::getConstant(pixelformat, formatstr);
+					throw love::Exception("The %s pixel format cannot be used as a storage image in a shader.", formatstr);
+				}
+			}
+
+			bool isSRGB = false;
+			format = OpenGL::convertPixelFormat(pixelformat, false, isSRGB).internalformat;
+
+			tex->retain();
+		}
+
+		if (info->textures[i] != nullptr)
+			info->textures[i]->release();
+
+		info->textures[i] = tex;
+
+		ImageUnit unit;
+		unit.format = format;
+		unit.layered = info->textureType != TEXTURE_2D;
+
+		if (tex != nullptr)
+		{
+			unit.texture = (GLuint) tex->getHandle();
+			tex->markUsed();
+		}
+
+		int imageunit = info->ints[i];
+
+		if ((int) imageUnits.size() <= imageunit)
+			imageUnits.resize(imageunit + 1);
+
+		// Store the texture so it can be re-bound to the image unit later.
+		imageUnits[imageunit] = unit;
+
+		if (shaderactive)
+			bindImageUnit(imageunit, unit.texture, unit.format, unit.layered);
+	}
+}
+
 void Shader::flushStreamDraws() const
 {
-	if (current == this)
-		Graphics::flushStreamDrawsGlobal();
+	// Deferred draws which use this Shader may have been recorded while a
+	// different one was active.
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (gfx != nullptr && (current == this || gfx->isDeferringDraws()))
+		gfx->flushStreamDraws();
+}
+
+void Shader::mapActiveUniformBlocks()
+{
+	builtinBlockIndex = GL_INVALID_INDEX;
+
+	std::map<std::string, UniformBlock> oldblocks;
+	std::swap(oldblocks, uniformBlocks);
+
+	if (!gl.isUniformBufferSupported())
+		return;
+
+	GLint numblocks = 0;
+	glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &numblocks);
+
+	GLint maxbindings = 0;
+	glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &maxbindings);
+
+	GLchar cname[256];
+	const GLint bufsize = (GLint) (sizeof(cname) / sizeof(GLchar));
+
+	GLuint nextbinding = BUILTIN_UNIFORM_BLOCK_BINDING + 1;
+
+	for (int bindex = 0; bindex < numblocks; bindex++)
+	{
+		GLsizei namelen = 0;
+		glGetActiveUniformBlockName(program, (GLuint) bindex, bufsize, &namelen, cname);
+
+		std::string name(cname, (size_t) namelen);
+
+		if (name == "love_BuiltinUniforms")
+		{
+			builtinBlockIndex = (GLuint) bindex;
+			glUniformBlockBinding(program, builtinBlockIndex, BUILTIN_UNIFORM_BLOCK_BINDING);
+			continue;
+		}
+
+		// The linker enforces per-stage block limits, which are normally lower.
+		if ((GLint) nextbinding >= maxbindings)
+			break;
+
+		GLint datasize = 0;
+		glGetActiveUniformBlockiv(program, (GLuint) bindex, GL_UNIFORM_BLOCK_DATA_SIZE, &datasize);
+
+		UniformBlock block = {};
+		block.index = (GLuint) bindex;
+		block.binding = nextbinding++;
+
+		// Make sure previously sent block data is preserved.
+		auto oldblock = oldblocks.find(name);
+		if (oldblock != oldblocks.end() && oldblock->second.data.size() == (size_t) datasize)
+			block.data = oldblock->second.data;
+		else
+			block.data.resize((size_t) datasize, 0);
+
+		glGenBuffers(1, &block.buffer);
+		gl.bindBuffer(BUFFER_UNIFORM, block.buffer);
+		glBufferData(GL_UNIFORM_BUFFER, datasize, block.data.data(), GL_DYNAMIC_DRAW);
+
+		glUniformBlockBinding(program, block.index, block.binding);
+
+		uniformBlocks[name] = block;
+	}
+}
+
+void Shader::flushUniformBlocks()
+{
+	for (auto &p : uniformBlocks)
+	{
+		UniformBlock &block = p.second;
+		if (block.dirtyEnd <= block.dirtyStart)
+			continue;
+
+		gl.bindBuffer(BUFFER_UNIFORM, block.buffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, block.dirtyStart, block.dirtyEnd - block.dirtyStart, &block.data[block.dirtyStart]);
+
+		block.dirtyStart = block.dirtyEnd = 0;
+	}
+}
+
+size_t Shader::getUniformBlockSize(const std::string &name) const
+{
+	const auto it = uniformBlocks.find(name);
+	return it != uniformBlocks.end() ? it->second.data.size() : 0;
+}
+
+void Shader::sendUniformBlock(const std::string &name, const void *data, size_t offset, size_t size)
+{
+	auto it = uniformBlocks.find(name);
+	if (it == uniformBlocks.end())
+		throw love::Exception("Shader uniform block '%s' does not exist.\nA common error is to define but not use the block.", name.c_str());
+
+	UniformBlock &block = it->second;
+
+	if (offset + size > block.data.size())
+		throw love::Exception("Uniform block '%s' is only %d bytes.", name.c_str(), (int) block.data.size());
+
+	if (size == 0)
+		return;
+
+	flushStreamDraws();
+
+	memcpy(&block.data[offset], data, size);
+
+	if (block.dirtyEnd <= block.dirtyStart)
+	{
+		block.dirtyStart = offset;
+		block.dirtyEnd = offset + size;
+	}
+	else
+	{
+		block.dirtyStart = std::min(block.dirtyStart, offset);
+		block.dirtyEnd = std::max(block.dirtyEnd, offset + size);
+	}
+}
+
+void Shader::mapActiveStorageBlocks()
+{
+	std::map<std::string, StorageBlock> oldblocks;
+	std::swap(oldblocks, storageBlocks);
+
+	if (!gl.isComputeSupported())
+		return;
+
+	GLint numblocks = 0;
+	glGetProgramInterfaceiv(program, GL_SHADER_STORAGE_BLOCK, GL_ACTIVE_RESOURCES, &numblocks);
+
+	GLint maxbindings = 0;
+	glGetIntegerv(GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS, &maxbindings);
+
+	GLchar cname[256];
+	const GLint bufsize = (GLint) (sizeof(cname) / sizeof(GLchar));
+
+	for (int bindex = 0; bindex < numblocks; bindex++)
+	{
+		GLsizei namelen = 0;
+		glGetProgramResourceName(program, GL_SHADER_STORAGE_BLOCK, (GLuint) bindex, bufsize, &namelen, cname);
+
+		StorageBlock block;
+		block.index = (GLuint) bindex;
+
+		if (GLAD_ES_VERSION_2_0)
+		{
+			// OpenGL ES can't change storage block bindings after linking, so
+			// the ones from the shader code are used.
+			GLenum prop = GL_BUFFER_BINDING;
+			GLint binding = 0;
+			glGetProgramResourceiv(program, GL_SHADER_STORAGE_BLOCK, (GLuint) bindex, 1, &prop, 1, nullptr, &binding);
+			block.binding = (GLuint) binding;
+		}
+		else
+		{
+			if (bindex >= maxbindings)
+				break;
+
+			block.binding = (GLuint) bindex;
+			glShaderStorageBlockBinding(program, block.index, block.binding);
+		}
+
+		std::string name(cname, (size_t) namelen);
+
+		auto oldblock = oldblocks.find(name);
+		if (oldblock != oldblocks.end())
+			block.mesh = oldblock->second.mesh;
+
+		storageBlocks[name] = block;
+	}
+}
+
+void Shader::bindStorageBuffers()
+{
+	for (const auto &p : storageBlocks)
+	{
+		const StorageBlock &block = p.second;
+		love::graphics::Mesh *mesh = block.mesh.get();
+
+		if (mesh == nullptr)
+			continue;
+
+		mesh->flush();
+		gl.bindShaderStorageBuffer(block.binding, (GLuint) mesh->getVertexBuffer()->getHandle());
+	}
+}
+
+void Shader::sendBuffer(const std::string &name, love::graphics::Mesh *mesh)
+{
+	auto it = storageBlocks.find(name);
+	if (it == storageBlocks.end())
+		throw love::Exception("Shader storage block '%s' does not exist.\nA common error is to define but not use the block.", name.c_str());
+
+	flushStreamDraws();
+
+	it->second.mesh.set(mesh);
+
+	if (current == this && mesh != nullptr)
+	{
+		mesh->flush();
+		gl.bindShaderStorageBuffer(it->second.binding, (GLuint) mesh->getVertexBuffer()->getHandle());
+	}
+}
+
+bool Shader::hasStorageBlock(const std::string &name) const
+{
+	return storageBlocks.find(name) != storageBlocks.end();
+}
+
+void Shader::getLocalThreadgroupSize(int size[3]) const
+{
+	for (int i = 0; i < 3; i++)
+		size[i] = localThreadgroupSize[i];
 }
 
 bool Shader::hasUniform(const std::string &name) const
@@ -752,15 +1267,34 @@ void Shader::updatePointSize(float size)
 	lastPointSize = size;
 }
 
+bool Shader::hasTexture(GLuint gltex) const
+{
+	for (const TextureUnit &unit : textureUnits)
+	{
+		if (unit.active && unit.texture == gltex)
+			return true;
+	}
+
+	return false;
+}
+
 void Shader::updateBuiltinUniforms()
 {
 	if (current != this)
 		return;
 
+	flushUniformBlocks();
+
+	if (builtinBlockIndex != GL_INVALID_INDEX)
+	{
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		gfx->updateBuiltinUniformBuffer();
+		return;
+	}
+
 	updateScreenParams();
 
-	if (GLAD_ES_VERSION_2_0)
-		updatePointSize(gl.getPointSize());
+	updatePointSize(gl.getPointSize());
 
 	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
 
@@ -835,7 +1369,8 @@ bool Shader::isSupported()
 
 int Shader::getUniformTypeComponents(GLenum type) const
 {
-	if (getUniformBaseType(type) == UNIFORM_SAMPLER)
+	UniformType basetype = getUniformBaseType(type);
+	if (basetype == UNIFORM_SAMPLER || basetype == UNIFORM_STORAGE_IMAGE)
 		return 1;
 
 	switch (type)
@@ -964,6 +1499,19 @@ Shader::UniformType Shader::getUniformBaseType(GLenum type) const
 	case GL_SAMPLER_CUBE_MAP_ARRAY:
 	case GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW:
 		return UNIFORM_SAMPLER;
+	case GL_IMAGE_2D:
+	case GL_IMAGE_2D_ARRAY:
+	case GL_IMAGE_3D:
+	case GL_IMAGE_CUBE:
+	case GL_INT_IMAGE_2D:
+	case GL_INT_IMAGE_2D_ARRAY:
+	case GL_INT_IMAGE_3D:
+	case GL_INT_IMAGE_CUBE:
+	case GL_UNSIGNED_INT_IMAGE_2D:
+	case GL_UNSIGNED_INT_IMAGE_2D_ARRAY:
+	case GL_UNSIGNED_INT_IMAGE_3D:
+	case GL_UNSIGNED_INT_IMAGE_CUBE:
+		return UNIFORM_STORAGE_IMAGE;
 	default:
 		return UNIFORM_UNKNOWN;
 	}
@@ -1002,6 +1550,22 @@ TextureType Shader::getUniformTextureType(GLenum type) const
 	case GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW:
 		// Cubemap array textures are not supported.
 		return TEXTURE_MAX_ENUM;
+	case GL_IMAGE_2D:
+	case GL_INT_IMAGE_2D:
+	case GL_UNSIGNED_INT_IMAGE_2D:
+		return TEXTURE_2D;
+	case GL_IMAGE_2D_ARRAY:
+	case GL_INT_IMAGE_2D_ARRAY:
+	case GL_UNSIGNED_INT_IMAGE_2D_ARRAY:
+		return TEXTURE_2D_ARRAY;
+	case GL_IMAGE_3D:
+	case GL_INT_IMAGE_3D:
+	case GL_UNSIGNED_INT_IMAGE_3D:
+		return TEXTURE_VOLUME;
+	case GL_IMAGE_CUBE:
+	case GL_INT_IMAGE_CUBE:
+	case GL_UNSIGNED_INT_IMAGE_CUBE:
+		return TEXTURE_CUBE;
 	default:
 		return TEXTURE_MAX_ENUM;
 	}
@@ -46,13 +46,16 @@ public:
 	/**
 	 * Creates a new Shader using a list of source codes.
 	 * Source must contain either vertex or pixel shader code, or both.
+	 * If async is true, the program isn't checked until finishLoading.
 	 **/
-	Shader(love::graphics::ShaderStage *vertex, love::graphics::ShaderStage *pixel);
+	Shader(love::graphics::ShaderStage *vertex, love::graphics::ShaderStage *pixel, bool async);
+	Shader(love::graphics::ShaderStage *compute);
 	virtual ~Shader();
 
 	// Implements Volatile
 	bool loadVolatile() override;
 	void unloadVolatile() override;
+	void finishVolatileLoad() override;
 
 	// Implements Shader.
 	void attach() override;
@@ -62,7 +65,12 @@ public:
 	const UniformInfo *getUniformInfo(BuiltinUniform builtin) const override;
 	void updateUniform(const UniformInfo *info, int count) override;
 	void sendTextures(const UniformInfo *info, Texture **textures, int count) override;
+	void sendBuffer(const std::string &name, love::graphics::Mesh *mesh) override;
+	bool hasStorageBlock(const std::string &name) const override;
+	void getLocalThreadgroupSize(int size[3]) const override;
 	bool hasUniform(const std::string &name) const override;
+	size_t getUniformBlockSize(const std::string &name) const override;
+	void sendUniformBlock(const std::string &name, const void *data, size_t offset, size_t size) override;
 	ptrdiff_t getHandle() const override;
 	void setVideoTextures(Texture *ytexture, Texture *cbtexture, Texture *crtexture) override;
 
@@ -70,11 +78,54 @@ public:
 	void updatePointSize(float size);
 	void updateBuiltinUniforms();
 
+	/**
+	 * Binds the storage buffers, uploading any changes made to their Meshes
+	 * since they were last bound. Done on attach, and before each dispatch.
+	 **/
+	void bindStorageBuffers();
+
+	/**
+	 * Gets whether the given texture is sent to one of this shader's sampler
+	 * uniforms.
+	 **/
+	bool hasTexture(GLuint gltex) const;
+
 	static std::string getGLSLVersion();
 	static bool isSupported();
 
+	// The layout of the love_BuiltinUniforms block in wrap_Graphics.lua, which
+	// GLSL 3 shaders use instead of individual uniforms. std140 pads each
+	// column of the mat3 to a vec4.
+	struct BuiltinUniformBlock
+	{
+		float viewFromLocal[16];
+		float clipFromView[16];
+		float clipFromLocal[16];
+		float viewNormalFromLocal[12];
+		float screenSize[4];
+		float pointSize;
+		float padding[3];
+	};
+
+	// Every Shader's built-in block uses the same binding point, so it doesn't
+	// need to be re-bound when switching shaders.
+	static const int BUILTIN_UNIFORM_BLOCK_BINDING = 0;
+
 private:
 
+	struct UniformBlock
+	{
+		GLuint index;
+		GLuint binding;
+		GLuint buffer;
+
+		// CPU copy of the block's contents, and the range of it which hasn't
+		// been uploaded yet.
+		std::vector<uint8> data;
+		size_t dirtyStart;
+		size_t dirtyEnd;
+	};
+
 	struct TextureUnit
 	{
 		GLuint texture = 0;
@@ -82,11 +133,50 @@ private:
 		bool active = false;
 	};
 
+	struct ImageUnit
+	{
+		GLuint texture = 0;
+		GLenum format = GL_RGBA8;
+		bool layered = false;
+	};
+
+	struct StorageBlock
+	{
+		GLuint index;
+		GLuint binding;
+		StrongRef<love::graphics::Mesh> mesh;
+	};
+
+	// Implements love::graphics::Shader.
+	bool isProgramReady() override;
+	void finishProgram() override;
+
+	// Starts compiling the stages and linking them into the program object.
+	void startLink();
+
+	// Checks the result of startLink, and saves the program to the binary
+	// cache if programCacheKey isn't empty.
+	void checkLink();
+
 	// Map active uniform names to their locations.
 	void mapActiveUniforms();
 
+	// Assign binding points and buffers to active uniform blocks.
+	void mapActiveUniformBlocks();
+
+	// Assign binding points to active shader storage blocks.
+	void mapActiveStorageBlocks();
+
+	// Upload the modified ranges of user uniform blocks.
+	void flushUniformBlocks();
+
 	void updateUniform(const UniformInfo *info, int count, bool internalupdate);
+
+	// The copy of a uniform's values which were last sent to OpenGL, stored
+	// after the values themselves.
+	static void *getUploadedData(const UniformInfo *info) { return (uint8 *) info->data + info->dataSize; }
 	void sendTextures(const UniformInfo *info, Texture **textures, int count, bool internalupdate);
+	void sendStorageImages(const UniformInfo *info, Texture **textures, int count, bool internalupdate);
 
 	int getUniformTypeComponents(GLenum type) const;
 	MatrixSize getMatrixSize(GLenum type) const;
@@ -102,6 +192,15 @@ private:
 	// volatile
 	GLuint program;
 
+	std::string programCacheKey;
+
+	// Whether the program was linked from source rather than loaded from the
+	// binary cache, and whether finishProgram has yet to run for it.
+	bool programLinked;
+	bool programPending;
+
+	bool asyncLoad;
+
 	// Location values for any built-in uniform variables.
 	GLint builtinUniforms[BUILTIN_MAX_ENUM];
 	UniformInfo *builtinUniformInfo[BUILTIN_MAX_ENUM];
@@ -114,9 +213,21 @@ private:
 	// Uniform location buffer map
 	std::map<std::string, UniformInfo> uniforms;
 
+	std::map<std::string, UniformBlock> uniformBlocks;
+
+	// Index of the love_BuiltinUniforms block, if the program uses it.
+	GLuint builtinBlockIndex;
+
 	// Texture unit pool for setting images
 	std::vector<TextureUnit> textureUnits;
 
+	// Image units for storage images, indexed the same way.
+	std::vector<ImageUnit> imageUnits;
+
+	std::map<std::string, StorageBlock> storageBlocks;
+
+	int localThreadgroupSize[3];
+
 	std::vector<std::pair<const UniformInfo *, int>> pendingUniformUpdates;
 
 	bool canvasWasActive;
@@ -19,6 +19,7 @@
  **/
 
 #include "ShaderStage.h"
+#include "common/profiling.h"
 
 namespace love
 {
@@ -27,11 +28,11 @@ namespace graphics
 namespace opengl
 {
 
-ShaderStage::ShaderStage(love::graphics::Graphics *gfx, StageType stage, const std::string &source, bool gles, const std::string &cachekey)
-	: love::graphics::ShaderStage(gfx, stage, source, gles, cachekey)
+ShaderStage::ShaderStage(love::graphics::Graphics *gfx, StageType stage, const std::string &source, bool gles, const std::string &cachekey, bool deferValidation)
+	: love::graphics::ShaderStage(gfx, stage, source, gles, cachekey, deferValidation)
 	, glShader(0)
+	, compileChecked(false)
 {
-	loadVolatile();
 }
 
 ShaderStage::~ShaderStage()
@@ -40,9 +41,23 @@ ShaderStage::~ShaderStage()
 }
 
 bool ShaderStage::loadVolatile()
+{
+	// Compiled on demand, see compile().
+	return true;
+}
+
+void ShaderStage::compile()
+{
+	startCompile();
+	checkCompileStatus();
+}
+
+void ShaderStage::startCompile()
 {
 	if (glShader != 0)
-		return true;
+		return;
+
+	LOVE_PROFILE_ZONE("ShaderStage:startCompile");
 
 	StageType stage = getStageType();
 	const char *typestr = "unknown";
@@ -53,6 +68,8 @@ bool ShaderStage::loadVolatile()
 		glstage = GL_VERTEX_SHADER;
 	else if (stage == STAGE_PIXEL)
 		glstage = GL_FRAGMENT_SHADER;
+	else if (stage == STAGE_COMPUTE)
+		glstage = GL_COMPUTE_SHADER;
 	else
 		throw love::Exception("%s shader stage is not handled in OpenGL backend code.", typestr);
 
@@ -68,6 +85,19 @@ bool ShaderStage::loadVolatile()
 	glShaderSource(glShader, 1, (const GLchar **)&src, &srclen);
 	glCompileShader(glShader);
 
+	compileChecked = false;
+}
+
+void ShaderStage::checkCompileStatus()
+{
+	if (glShader == 0 || compileChecked)
+		return;
+
+	LOVE_PROFILE_ZONE("ShaderStage:checkCompileStatus");
+
+	const char *typestr = "unknown";
+	getConstant(getStageType(), typestr);
+
 	GLint infologlen;
 	glGetShaderiv(glShader, GL_INFO_LOG_LENGTH, &infologlen);
 
@@ -86,10 +116,11 @@ bool ShaderStage::loadVolatile()
 	if (status == GL_FALSE)
 	{
 		glDeleteShader(glShader);
+		glShader = 0;
 		throw love::Exception("Cannot compile %s shader code:\n%s", typestr, warnings.c_str());
 	}
 
-	return true;
+	compileChecked = true;
 }
 
 void ShaderStage::unloadVolatile()
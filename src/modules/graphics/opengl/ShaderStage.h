@@ -35,11 +35,25 @@ class ShaderStage final : public love::graphics::ShaderStage
 {
 public:
 
-	ShaderStage(love::graphics::Graphics *gfx, StageType stage, const std::string &source, bool gles, const std::string &cachekey);
+	ShaderStage(love::graphics::Graphics *gfx, StageType stage, const std::string &source, bool gles, const std::string &cachekey, bool deferValidation);
 	virtual ~ShaderStage();
 
 	ptrdiff_t getHandle() const override { return glShader; }
 
+	/**
+	 * Creates and compiles the GL shader object, if it doesn't exist yet.
+	 * This is deferred until a program needs it, since programs loaded from
+	 * the binary cache don't.
+	 **/
+	void compile();
+
+	/**
+	 * The two halves of compile(). startCompile doesn't wait for the driver,
+	 * which may finish the work in the background.
+	 **/
+	void startCompile();
+	void checkCompileStatus();
+
 	// Implements Volatile.
 	bool loadVolatile() override;
 	void unloadVolatile() override;
@@ -47,6 +61,7 @@ public:
 private:
 
 	GLuint glShader;
+	bool compileChecked;
 
 }; // ShaderStage
 
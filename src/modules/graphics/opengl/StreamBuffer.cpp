@@ -25,6 +25,7 @@
 #include "graphics/Volatile.h"
 #include "common/Exception.h"
 #include "common/memory.h"
+#include "timer/Timer.h"
 
 #include <vector>
 #include <algorithm>
@@ -69,6 +70,7 @@ public:
 
 	MapInfo map(size_t /*minsize*/) override
 	{
+		frameStats.maps++;
 		return MapInfo(data, bufferSize);
 	}
 
@@ -77,7 +79,10 @@ public:
 		return (size_t) data;
 	}
 
-	void markUsed(size_t /*usedsize*/) override { }
+	void markUsed(size_t usedsize) override
+	{
+		frameStats.uploadedBytes += usedsize;
+	}
 	ptrdiff_t getHandle() const override { return 0; }
 
 private:
@@ -123,8 +128,12 @@ public:
 
 	MapInfo map(size_t minsize) override
 	{
+		frameStats.maps++;
+
 		if (offset + minsize > bufferSize)
 		{
+			frameStats.mapStalls++;
+			frameStats.wraps++;
 			offset = 0;
 			frameOffset = 0;
 			gl.bindBuffer(mode, vbo);
@@ -145,6 +154,7 @@ public:
 	{
 		offset += usedsize;
 		frameOffset += usedsize;
+		frameStats.uploadedBytes += usedsize;
 	}
 
 	void nextFrame() override
@@ -224,6 +234,7 @@ public:
 			syncs[frameIndex * MAX_SYNCS_PER_FRAME + i].fence();
 
 		frameGPUReadOffset += usedsize;
+		frameStats.uploadedBytes += usedsize;
 	}
 
 protected:
@@ -240,6 +251,28 @@ protected:
 		return &syncs[frameIndex * MAX_SYNCS_PER_FRAME + frameGPUReadOffset / syncSize];
 	}
 
+	void waitForRemainingSyncs()
+	{
+		int firstSyncIndex = frameGPUReadOffset / syncSize;
+		int lastSyncIndex = (bufferSize - 1) / syncSize;
+
+		double start = love::timer::Timer::getTime();
+
+		// We're mapping the full range of space left in the buffer, so we
+		// need to wait on all of it...
+		// FIXME: is it even worth it to have multiple sync objects per frame?
+		bool stalled = false;
+		for (int i = firstSyncIndex; i <= lastSyncIndex; i++)
+			stalled |= syncs[frameIndex * MAX_SYNCS_PER_FRAME + i].cpuWait();
+
+		frameStats.maps++;
+		if (stalled)
+		{
+			frameStats.mapStalls++;
+			frameStats.mapStallTime += love::timer::Timer::getTime() - start;
+		}
+	}
+
 }; // StreamBufferSync
 
 class StreamBufferMapSync final : public StreamBufferSync, public Volatile
@@ -271,14 +304,7 @@ public:
 		MapInfo info;
 		info.size = bufferSize - frameGPUReadOffset;
 
-		int firstSyncIndex = frameGPUReadOffset / syncSize;
-		int lastSyncIndex = (bufferSize - 1) / syncSize;
-
-		// We're mapping the full range of space left in the buffer, so we
-		// need to wait on all of it...
-		// FIXME: is it even worth it to have multiple sync objects per frame?
-		for (int i = firstSyncIndex; i <= lastSyncIndex; i++)
-			syncs[frameIndex * MAX_SYNCS_PER_FRAME + i].cpuWait();
+		waitForRemainingSyncs();
 
 		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
 
@@ -362,14 +388,7 @@ public:
 		info.size = bufferSize - frameGPUReadOffset;
 		info.data = data + (frameIndex * bufferSize) + frameGPUReadOffset;
 
-		int firstSyncIndex = frameGPUReadOffset / syncSize;
-		int lastSyncIndex = (bufferSize - 1) / syncSize;
-
-		// We're mapping the full range of space left in the buffer, so we
-		// need to wait on all of it...
-		// FIXME: is it even worth it to have multiple sync objects per frame?
-		for (int i = firstSyncIndex; i <= lastSyncIndex; i++)
-			syncs[frameIndex * MAX_SYNCS_PER_FRAME + i].cpuWait();
+		waitForRemainingSyncs();
 
 		return info;
 	}
@@ -465,14 +484,7 @@ public:
 		info.size = bufferSize - frameGPUReadOffset;
 		info.data = data + (frameIndex * bufferSize) + frameGPUReadOffset;
 
-		int firstSyncIndex = frameGPUReadOffset / syncSize;
-		int lastSyncIndex = (bufferSize - 1) / syncSize;
-
-		// We're mapping the full range of space left in the buffer, so we
-		// need to wait on all of it...
-		// FIXME: is it even worth it to have multiple sync objects per frame?
-		for (int i = firstSyncIndex; i <= lastSyncIndex; i++)
-			syncs[frameIndex * MAX_SYNCS_PER_FRAME + i].cpuWait();
+		waitForRemainingSyncs();
 
 		return info;
 	}
@@ -536,6 +548,11 @@ private:
 
 love::graphics::StreamBuffer *CreateStreamBuffer(BufferType mode, size_t size)
 {
+	// Uniform data has to live in a real buffer object, and the small
+	// sub-allocations it uses are best served by orphaning.
+	if (mode == BUFFER_UNIFORM)
+		return new StreamBufferSubDataOrphan(mode, size);
+
 	if (gl.isCoreProfile())
 	{
 		if (!gl.bugs.clientWaitSyncStalls)
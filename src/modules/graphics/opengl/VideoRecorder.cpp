@@ -0,0 +1,176 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "VideoRecorder.h"
+#include "GraphicsReadback.h"
+#include "Canvas.h"
+#include "common/Exception.h"
+
+// C
+#include <string.h>
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+VideoRecorder::VideoRecorder(const std::string &target, int width, int height, const Settings &settings)
+	: love::graphics::VideoRecorder(target, width, height, settings)
+	, slots(settings.buffers)
+	, next(0)
+	, oldest(0)
+	, pendingCount(0)
+{
+}
+
+VideoRecorder::~VideoRecorder()
+{
+	unloadVolatile();
+}
+
+bool VideoRecorder::isSupported()
+{
+	return GraphicsReadback::isSupported();
+}
+
+void VideoRecorder::readFrame(love::graphics::Canvas *canvas)
+{
+	GLuint current_fbo = gl.getFramebuffer(OpenGL::FRAMEBUFFER_ALL);
+	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, ((Canvas *) canvas)->getFBO());
+
+	if (!isSupported())
+	{
+		uint8 *pixels = acquireFrame();
+		glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+		gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, current_fbo);
+		submitFrame(pixels);
+		return;
+	}
+
+	// Hand off anything the GPU has already finished, so the ring rarely
+	// has to wait when it wraps around.
+	while (pendingCount > 0 && slots[oldest].sync.isSignaled())
+		finishOldest(false);
+
+	if (slots[next].pending)
+		finishOldest(true);
+
+	Slot &slot = slots[next];
+
+	if (slot.pbo == 0)
+	{
+		glGenBuffers(1, &slot.pbo);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+		glBufferData(GL_PIXEL_PACK_BUFFER, getFrameSize(), nullptr, GL_STREAM_READ);
+	}
+	else
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+
+	glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, current_fbo);
+
+	slot.sync.fence();
+	slot.pending = true;
+
+	next = (next + 1) % (int) slots.size();
+	pendingCount++;
+
+	// Make sure the fence is submitted, otherwise polling could never see it
+	// complete.
+	glFlush();
+}
+
+void VideoRecorder::finishOldest(bool wait)
+{
+	Slot &slot = slots[oldest];
+
+	if (wait)
+		slot.sync.cpuWait();
+
+	slot.sync.cleanup();
+	slot.pending = false;
+
+	oldest = (oldest + 1) % (int) slots.size();
+	pendingCount--;
+
+	size_t size = getFrameSize();
+
+	// This can block until the writer thread has room for another frame.
+	uint8 *pixels = acquireFrame();
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+
+	const void *src = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+
+	// A frame which couldn't be mapped is written out black rather than
+	// dropped, so the rest of the recording stays in sync.
+	if (src != nullptr)
+	{
+		memcpy(pixels, src, size);
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	else
+		memset(pixels, 0, size);
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	submitFrame(pixels);
+}
+
+void VideoRecorder::flushFrames()
+{
+	while (pendingCount > 0)
+		finishOldest(true);
+}
+
+bool VideoRecorder::loadVolatile()
+{
+	// Buffers are created again as they're needed.
+	return true;
+}
+
+void VideoRecorder::unloadVolatile()
+{
+	// The buffers won't survive the context going away, so get the frames
+	// out of them while they still exist.
+	if (!isFinished())
+		flushFrames();
+
+	for (Slot &slot : slots)
+	{
+		if (slot.pbo != 0)
+			glDeleteBuffers(1, &slot.pbo);
+
+		slot.pbo = 0;
+		slot.sync.cleanup();
+		slot.pending = false;
+	}
+
+	next = oldest = pendingCount = 0;
+}
+
+} // opengl
+} // graphics
+} // love
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "graphics/VideoRecorder.h"
+#include "graphics/Volatile.h"
+#include "OpenGL.h"
+#include "FenceSync.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+/**
+ * Reads frames into a fixed ring of pixel pack buffers. A buffer is only
+ * mapped once its fence has been reached, or when the ring wraps around to
+ * it again, so the GPU normally has several frames of slack.
+ **/
+class VideoRecorder final : public love::graphics::VideoRecorder, public Volatile
+{
+public:
+
+	VideoRecorder(const std::string &target, int width, int height, const Settings &settings);
+	virtual ~VideoRecorder();
+
+	// Implements Volatile.
+	bool loadVolatile() override;
+	void unloadVolatile() override;
+
+	static bool isSupported();
+
+protected:
+
+	// Implements love::graphics::VideoRecorder.
+	void readFrame(love::graphics::Canvas *canvas) override;
+	void flushFrames() override;
+
+private:
+
+	struct Slot
+	{
+		GLuint pbo = 0;
+		FenceSync sync;
+		bool pending = false;
+	};
+
+	// Copies the oldest pending slot to the writer thread.
+	void finishOldest(bool wait);
+
+	std::vector<Slot> slots;
+
+	// The slot the next frame will be read into, and the oldest pending one.
+	int next;
+	int oldest;
+	int pendingCount;
+
+}; // VideoRecorder
+
+} // opengl
+} // graphics
+} // love
@@ -30,12 +30,15 @@ namespace vertex
 
 static_assert(sizeof(Color) == 4, "sizeof(Color) incorrect!");
 static_assert(sizeof(STf_RGBAub) == sizeof(float)*2 + sizeof(Color), "sizeof(STf_RGBAub) incorrect!");
+static_assert(sizeof(STus_RGBAub) == sizeof(uint16)*2 + sizeof(Color), "sizeof(STus_RGBAub) incorrect!");
 static_assert(sizeof(STPf_RGBAub) == sizeof(float)*3 + sizeof(Color), "sizeof(STPf_RGBAub) incorrect!");
 static_assert(sizeof(XYf_STf) == sizeof(float)*2 + sizeof(float)*2, "sizeof(XYf_STf) incorrect!");
 static_assert(sizeof(XYf_STPf) == sizeof(float)*2 + sizeof(float)*3, "sizeof(XYf_STPf) incorrect!");
 static_assert(sizeof(XYf_STf_RGBAub) == sizeof(float)*2 + sizeof(float)*2 + sizeof(Color), "sizeof(XYf_STf_RGBAub) incorrect!");
 static_assert(sizeof(XYf_STus_RGBAub) == sizeof(float)*2 + sizeof(uint16)*2 + sizeof(Color), "sizeof(XYf_STus_RGBAub) incorrect!");
 static_assert(sizeof(XYf_STPf_RGBAub) == sizeof(float)*2 + sizeof(float)*3 + sizeof(Color), "sizeof(XYf_STPf_RGBAub) incorrect!");
+static_assert(sizeof(RGBAub_Sf) == sizeof(Color) + sizeof(float), "sizeof(RGBAub_Sf) incorrect!");
+static_assert(sizeof(XYf_RGBAub_Sf) == sizeof(float)*2 + sizeof(Color) + sizeof(float), "sizeof(XYf_RGBAub_Sf) incorrect!");
 
 size_t getFormatStride(CommonFormat format)
 {
@@ -51,6 +54,8 @@ size_t getFormatStride(CommonFormat format)
 		return sizeof(uint8) * 4;
 	case CommonFormat::STf_RGBAub:
 		return sizeof(STf_RGBAub);
+	case CommonFormat::STus_RGBAub:
+		return sizeof(STus_RGBAub);
 	case CommonFormat::STPf_RGBAub:
 		return sizeof(STPf_RGBAub);
 	case CommonFormat::XYf_STf:
@@ -63,6 +68,8 @@ size_t getFormatStride(CommonFormat format)
 		return sizeof(XYf_STus_RGBAub);
 	case CommonFormat::XYf_STPf_RGBAub:
 		return sizeof(XYf_STPf_RGBAub);
+	case CommonFormat::RGBAub_Sf:
+		return sizeof(RGBAub_Sf);
 	}
 }
 
@@ -78,6 +85,7 @@ uint32 getFormatFlags(CommonFormat format)
 	case CommonFormat::RGBAub:
 		return ATTRIBFLAG_COLOR;
 	case CommonFormat::STf_RGBAub:
+	case CommonFormat::STus_RGBAub:
 	case CommonFormat::STPf_RGBAub:
 		return ATTRIBFLAG_TEXCOORD | ATTRIBFLAG_COLOR;
 	case CommonFormat::XYf_STf:
@@ -87,6 +95,8 @@ uint32 getFormatFlags(CommonFormat format)
 	case CommonFormat::XYf_STus_RGBAub:
 	case CommonFormat::XYf_STPf_RGBAub:
 		return ATTRIBFLAG_POS | ATTRIBFLAG_TEXCOORD | ATTRIBFLAG_COLOR;
+	case CommonFormat::RGBAub_Sf:
+		return ATTRIBFLAG_COLOR | ATTRIBFLAG_POINTSIZE;
 	}
 }
 
@@ -97,7 +107,9 @@ int getFormatPositionComponents(CommonFormat format)
 	case CommonFormat::NONE:
 	case CommonFormat::RGBAub:
 	case CommonFormat::STf_RGBAub:
+	case CommonFormat::STus_RGBAub:
 	case CommonFormat::STPf_RGBAub:
+	case CommonFormat::RGBAub_Sf:
 		return 0;
 	case CommonFormat::XYf:
 	case CommonFormat::XYf_STf:
@@ -243,6 +255,10 @@ void Attributes::setCommonFormat(CommonFormat format, uint8 bufferindex)
 		set(ATTRIB_TEXCOORD, DATA_FLOAT, 2, 0, stride, bufferindex);
 		set(ATTRIB_COLOR, DATA_UNORM8, 4, uint16(sizeof(float) * 2), stride, bufferindex);
 		break;
+	case CommonFormat::STus_RGBAub:
+		set(ATTRIB_TEXCOORD, DATA_UNORM16, 2, 0, stride, bufferindex);
+		set(ATTRIB_COLOR, DATA_UNORM8, 4, uint16(sizeof(uint16) * 2), stride, bufferindex);
+		break;
 	case CommonFormat::STPf_RGBAub:
 		set(ATTRIB_TEXCOORD, DATA_FLOAT, 3, 0, stride, bufferindex);
 		set(ATTRIB_COLOR, DATA_UNORM8, 4, uint16(sizeof(float) * 3), stride, bufferindex);
@@ -270,6 +286,10 @@ void Attributes::setCommonFormat(CommonFormat format, uint8 bufferindex)
 		set(ATTRIB_TEXCOORD, DATA_FLOAT, 3, uint16(sizeof(float) * 2), stride, bufferindex);
 		set(ATTRIB_COLOR, DATA_UNORM8, 4, uint16(sizeof(float) * 5), stride, bufferindex);
 		break;
+	case CommonFormat::RGBAub_Sf:
+		set(ATTRIB_COLOR, DATA_UNORM8, 4, 0, stride, bufferindex);
+		set(ATTRIB_POINTSIZE, DATA_FLOAT, 1, uint16(sizeof(Color)), stride, bufferindex);
+		break;
 	}
 }
 
@@ -279,6 +299,7 @@ static StringMap<VertexAttribID, ATTRIB_MAX_ENUM>::Entry attribNameEntries[] =
 	{ "VertexTexCoord", ATTRIB_TEXCOORD      },
 	{ "VertexColor",    ATTRIB_COLOR         },
 	{ "ConstantColor",  ATTRIB_CONSTANTCOLOR },
+	{ "VertexPointSize", ATTRIB_POINTSIZE },
 };
 
 static StringMap<VertexAttribID, ATTRIB_MAX_ENUM> attribNames(attribNameEntries, sizeof(attribNameEntries));
@@ -44,6 +44,7 @@ enum VertexAttribID
 	ATTRIB_TEXCOORD,
 	ATTRIB_COLOR,
 	ATTRIB_CONSTANTCOLOR,
+	ATTRIB_POINTSIZE,
 	ATTRIB_MAX_ENUM
 };
 
@@ -52,13 +53,17 @@ enum VertexAttribFlags
 	ATTRIBFLAG_POS = 1 << ATTRIB_POS,
 	ATTRIBFLAG_TEXCOORD = 1 << ATTRIB_TEXCOORD,
 	ATTRIBFLAG_COLOR = 1 << ATTRIB_COLOR,
-	ATTRIBFLAG_CONSTANTCOLOR = 1 << ATTRIB_CONSTANTCOLOR
+	ATTRIBFLAG_CONSTANTCOLOR = 1 << ATTRIB_CONSTANTCOLOR,
+	ATTRIBFLAG_POINTSIZE = 1 << ATTRIB_POINTSIZE
 };
 
 enum BufferType
 {
 	BUFFER_VERTEX = 0,
 	BUFFER_INDEX,
+	BUFFER_UNIFORM,
+	BUFFER_INDIRECT,
+	BUFFER_SHADER_STORAGE,
 	BUFFER_MAX_ENUM
 };
 
@@ -136,12 +141,14 @@ enum class CommonFormat
 	XYZf,
 	RGBAub,
 	STf_RGBAub,
+	STus_RGBAub,
 	STPf_RGBAub,
 	XYf_STf,
 	XYf_STPf,
 	XYf_STf_RGBAub,
 	XYf_STus_RGBAub,
 	XYf_STPf_RGBAub,
+	RGBAub_Sf,
 };
 
 struct STf_RGBAub
@@ -150,6 +157,12 @@ struct STf_RGBAub
 	Color color;
 };
 
+struct STus_RGBAub
+{
+	uint16 s, t;
+	Color  color;
+};
+
 struct STPf_RGBAub
 {
 	float s, t, p;
@@ -189,6 +202,21 @@ struct XYf_STPf_RGBAub
 	Color color;
 };
 
+struct RGBAub_Sf
+{
+	Color color;
+	float size;
+};
+
+// Packed point record used by Graphics::points. Not a stream format itself:
+// positions are transformed into a separate stream.
+struct XYf_RGBAub_Sf
+{
+	float x, y;
+	Color color;
+	float size;
+};
+
 struct Buffers
 {
 	static const unsigned int MAX = 32;
@@ -287,6 +315,21 @@ inline CommonFormat getSinglePositionFormat(bool is2D)
 	return is2D ? CommonFormat::XYf : CommonFormat::XYZf;
 }
 
+/**
+ * Texture coordinates in [0, 1] can use the compact STus formats, which store
+ * them as 16-bit normalized integers. That's within an eighth of a texel even
+ * for 16384 pixel textures, and saves 4 bytes per vertex.
+ **/
+inline bool isUnormTexCoord(float s, float t)
+{
+	return s >= 0.0f && s <= 1.0f && t >= 0.0f && t <= 1.0f;
+}
+
+inline uint16 packUnormTexCoord(float v)
+{
+	return (uint16) (v * (float) LOVE_UINT16_MAX + 0.5f);
+}
+
 size_t getIndexDataSize(IndexDataType type);
 size_t getDataTypeSize(DataType datatype);
 
@@ -115,6 +115,36 @@ int w_Canvas_newImageData(lua_State *L)
 	return 1;
 }
 
+int w_Canvas_newImageDataAsync(lua_State *L)
+{
+	Canvas *canvas = luax_checkcanvas(L, 1);
+	love::image::Image *image = luax_getmodule<love::image::Image>(L, love::image::Image::type);
+
+	int slice = 0;
+	int mipmap = 0;
+	Rect rect = {0, 0, canvas->getPixelWidth(), canvas->getPixelHeight()};
+
+	if (canvas->getTextureType() != TEXTURE_2D)
+		slice = (int) luaL_checkinteger(L, 2) - 1;
+
+	mipmap = (int) luaL_optinteger(L, 3, 1) - 1;
+
+	if (!lua_isnoneornil(L, 4))
+	{
+		rect.x = (int) luaL_checkinteger(L, 4);
+		rect.y = (int) luaL_checkinteger(L, 5);
+		rect.w = (int) luaL_checkinteger(L, 6);
+		rect.h = (int) luaL_checkinteger(L, 7);
+	}
+
+	GraphicsReadback *readback = nullptr;
+	luax_catchexcept(L, [&](){ readback = canvas->newReadback(image, slice, mipmap, rect); });
+
+	luax_pushtype(L, readback);
+	readback->release();
+	return 1;
+}
+
 int w_Canvas_generateMipmaps(lua_State *L)
 {
 	Canvas *c = luax_checkcanvas(L, 1);
@@ -133,13 +163,31 @@ int w_Canvas_getMipmapMode(lua_State *L)
 	return 1;
 }
 
+int w_Canvas_setActiveMipmapCount(lua_State *L)
+{
+	Canvas *c = luax_checkcanvas(L, 1);
+	int count = (int) luaL_checkinteger(L, 2);
+	luax_catchexcept(L, [&]() { c->setActiveMipmapCount(count); });
+	return 0;
+}
+
+int w_Canvas_getActiveMipmapCount(lua_State *L)
+{
+	Canvas *c = luax_checkcanvas(L, 1);
+	lua_pushinteger(L, c->getActiveMipmapCount());
+	return 1;
+}
+
 static const luaL_Reg w_Canvas_functions[] =
 {
 	{ "getMSAA", w_Canvas_getMSAA },
 	{ "renderTo", w_Canvas_renderTo },
 	{ "newImageData", w_Canvas_newImageData },
+	{ "newImageDataAsync", w_Canvas_newImageDataAsync },
 	{ "generateMipmaps", w_Canvas_generateMipmaps },
 	{ "getMipmapMode", w_Canvas_getMipmapMode },
+	{ "setActiveMipmapCount", w_Canvas_setActiveMipmapCount },
+	{ "getActiveMipmapCount", w_Canvas_getActiveMipmapCount },
 	{ 0, 0 }
 };
 
@@ -0,0 +1,219 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_DrawList.h"
+#include "wrap_Texture.h"
+#include "wrap_Quad.h"
+#include "wrap_Mesh.h"
+#include "wrap_SpriteBatch.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+DrawList *luax_checkdrawlist(lua_State *L, int idx)
+{
+	return luax_checktype<DrawList>(L, idx);
+}
+
+int w_DrawList_add(lua_State *L)
+{
+	DrawList *t = luax_checkdrawlist(L, 1);
+	Texture *texture = luax_checktexture(L, 2);
+
+	int startidx = 3;
+	Quad *quad = nullptr;
+
+	if (luax_istype(L, startidx, Quad::type))
+	{
+		quad = luax_totype<Quad>(L, startidx);
+		startidx++;
+	}
+	else if (lua_isnil(L, startidx) && !lua_isnoneornil(L, startidx + 1))
+		return luax_typerror(L, startidx, "Quad");
+
+	luax_checkstandardtransform(L, startidx, [&](const Matrix4 &m)
+	{
+		luax_catchexcept(L, [&](){ t->add(texture, quad, m); });
+	});
+
+	return 0;
+}
+
+int w_DrawList_polygon(lua_State *L)
+{
+	DrawList *t = luax_checkdrawlist(L, 1);
+
+	int args = lua_gettop(L) - 1;
+
+	bool is_table = false;
+	if (args == 1 && lua_istable(L, 2))
+	{
+		args = (int) luax_objlen(L, 2);
+		is_table = true;
+	}
+
+	if (args % 2 != 0)
+		return luaL_error(L, "Number of vertex components must be a multiple of two");
+	else if (args < 6)
+		return luaL_error(L, "Need at least three vertices to draw a polygon");
+
+	int numvertices = args / 2;
+	std::vector<Vector2> coords(numvertices);
+
+	if (is_table)
+	{
+		for (int i = 0; i < numvertices; ++i)
+		{
+			lua_rawgeti(L, 2, (i * 2) + 1);
+			lua_rawgeti(L, 2, (i * 2) + 2);
+			coords[i].x = luax_checkfloat(L, -2);
+			coords[i].y = luax_checkfloat(L, -1);
+			lua_pop(L, 2);
+		}
+	}
+	else
+	{
+		for (int i = 0; i < numvertices; ++i)
+		{
+			coords[i].x = luax_checkfloat(L, (i * 2) + 2);
+			coords[i].y = luax_checkfloat(L, (i * 2) + 3);
+		}
+	}
+
+	luax_catchexcept(L, [&](){ t->polygon(coords.data(), coords.size(), Matrix4()); });
+	return 0;
+}
+
+int w_DrawList_rectangle(lua_State *L)
+{
+	DrawList *t = luax_checkdrawlist(L, 1);
+
+	float x = (float) luaL_checknumber(L, 2);
+	float y = (float) luaL_checknumber(L, 3);
+	float w = (float) luaL_checknumber(L, 4);
+	float h = (float) luaL_checknumber(L, 5);
+
+	luax_catchexcept(L, [&](){ t->rectangle(x, y, w, h, Matrix4()); });
+	return 0;
+}
+
+int w_DrawList_addMesh(lua_State *L)
+{
+	DrawList *t = luax_checkdrawlist(L, 1);
+	Mesh *mesh = luax_checkmesh(L, 2);
+
+	luax_checkstandardtransform(L, 3, [&](const Matrix4 &m)
+	{
+		luax_catchexcept(L, [&](){ t->addMesh(mesh, m); });
+	});
+
+	return 0;
+}
+
+int w_DrawList_setColor(lua_State *L)
+{
+	DrawList *t = luax_checkdrawlist(L, 1);
+	Colorf c;
+
+	if (lua_istable(L, 2))
+	{
+		for (int i = 1; i <= 4; i++)
+			lua_rawgeti(L, 2, i);
+
+		c.r = (float) luaL_checknumber(L, -4);
+		c.g = (float) luaL_checknumber(L, -3);
+		c.b = (float) luaL_checknumber(L, -2);
+		c.a = (float) luaL_optnumber(L, -1, 1.0);
+
+		lua_pop(L, 4);
+	}
+	else
+	{
+		c.r = (float) luaL_checknumber(L, 2);
+		c.g = (float) luaL_checknumber(L, 3);
+		c.b = (float) luaL_checknumber(L, 4);
+		c.a = (float) luaL_optnumber(L, 5, 1.0);
+	}
+
+	t->setColor(c);
+	return 0;
+}
+
+int w_DrawList_getColor(lua_State *L)
+{
+	DrawList *t = luax_checkdrawlist(L, 1);
+	Colorf c = t->getColor();
+
+	lua_pushnumber(L, c.r);
+	lua_pushnumber(L, c.g);
+	lua_pushnumber(L, c.b);
+	lua_pushnumber(L, c.a);
+
+	return 4;
+}
+
+int w_DrawList_clear(lua_State *L)
+{
+	DrawList *t = luax_checkdrawlist(L, 1);
+	t->clear();
+	return 0;
+}
+
+int w_DrawList_getCount(lua_State *L)
+{
+	DrawList *t = luax_checkdrawlist(L, 1);
+	lua_pushinteger(L, t->getCount());
+	return 1;
+}
+
+int w_DrawList_getVertexCount(lua_State *L)
+{
+	DrawList *t = luax_checkdrawlist(L, 1);
+	lua_pushinteger(L, t->getVertexCount());
+	return 1;
+}
+
+static const luaL_Reg w_DrawList_functions[] =
+{
+	{ "add", w_DrawList_add },
+	{ "polygon", w_DrawList_polygon },
+	{ "rectangle", w_DrawList_rectangle },
+	{ "addMesh", w_DrawList_addMesh },
+	{ "setColor", w_DrawList_setColor },
+	{ "getColor", w_DrawList_getColor },
+	{ "clear", w_DrawList_clear },
+	{ "getCount", w_DrawList_getCount },
+	{ "getVertexCount", w_DrawList_getVertexCount },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_drawlist(lua_State *L)
+{
+	return luax_register_type(L, &DrawList::type, w_DrawList_functions, nullptr);
+}
+
+} // graphics
+} // love
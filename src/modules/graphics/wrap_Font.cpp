@@ -214,6 +214,35 @@ int w_Font_hasGlyphs(lua_State *L)
 	return 1;
 }
 
+int w_Font_prefetchGlyphs(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	Font::Codepoints codepoints;
+
+	int count = std::max(lua_gettop(L) - 1, 1);
+
+	luax_catchexcept(L, [&]() {
+		for (int i = 2; i < count + 2; i++)
+		{
+			if (lua_type(L, i) == LUA_TSTRING)
+				Font::getCodepointsFromString(luax_checkstring(L, i), codepoints);
+			else
+				codepoints.push_back((uint32) luaL_checknumber(L, i));
+		}
+
+		t->prefetchGlyphs(codepoints);
+	});
+
+	return 0;
+}
+
+int w_Font_isPrefetchingGlyphs(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	luax_pushboolean(L, t->isPrefetchingGlyphs());
+	return 1;
+}
+
 int w_Font_setFallbacks(lua_State *L)
 {
 	Font *t = luax_checkfont(L, 1);
@@ -246,6 +275,8 @@ static const luaL_Reg w_Font_functions[] =
 	{ "getDescent", w_Font_getDescent },
 	{ "getBaseline", w_Font_getBaseline },
 	{ "hasGlyphs", w_Font_hasGlyphs },
+	{ "prefetchGlyphs", w_Font_prefetchGlyphs },
+	{ "isPrefetchingGlyphs", w_Font_isPrefetchingGlyphs },
 	{ "setFallbacks", w_Font_setFallbacks },
 	{ "getDPIScale", w_Font_getDPIScale },
 	{ 0, 0 }
@@ -29,6 +29,7 @@
 #include "video/VideoStream.h"
 #include "image/wrap_Image.h"
 #include "common/Reference.h"
+#include "math/wrap_BezierCurve.h"
 #include "math/wrap_Transform.h"
 #include "thread/wrap_Channel.h"
 
@@ -45,6 +46,10 @@ static const char graphics_lua[] =
 #include "wrap_Graphics.lua"
 ;
 
+#ifdef LOVE_PRECOMPILED_LUA
+#include "luabytecode/graphics_lua.h"
+#endif
+
 namespace love
 {
 namespace graphics
@@ -258,6 +263,71 @@ static Graphics::RenderTarget checkRenderTarget(lua_State *L, int idx)
 	return target;
 }
 
+template <typename T>
+static void checkPassAction(lua_State *L, int idx, const char *key, const char *enumname, T &action)
+{
+	lua_getfield(L, idx, key);
+	if (!lua_isnoneornil(L, -1))
+	{
+		const char *str = luaL_checkstring(L, -1);
+		if (!Graphics::getConstant(str, action))
+			luax_enumerror(L, enumname, Graphics::getConstants(action), str);
+	}
+	lua_pop(L, 1);
+}
+
+// Reads the 'load' and 'store' fields of the table passed into setCanvas.
+// Each is either a single action for all buffers, or a table with 'color',
+// 'depth' and 'stencil' fields.
+template <typename T>
+static void checkPassActions(lua_State *L, int idx, const char *key, const char *enumname, T &color, T &depth, T &stencil)
+{
+	lua_getfield(L, idx, key);
+
+	if (lua_type(L, -1) == LUA_TSTRING)
+	{
+		const char *str = lua_tostring(L, -1);
+		if (!Graphics::getConstant(str, color))
+			luax_enumerror(L, enumname, Graphics::getConstants(color), str);
+		depth = stencil = color;
+	}
+	else if (lua_istable(L, -1))
+	{
+		int tidx = lua_gettop(L);
+		checkPassAction(L, tidx, "color", enumname, color);
+		checkPassAction(L, tidx, "depth", enumname, depth);
+		checkPassAction(L, tidx, "stencil", enumname, stencil);
+	}
+	else if (!lua_isnoneornil(L, -1))
+		luaL_argerror(L, idx, "expected a string or table for the load and store actions");
+
+	lua_pop(L, 1);
+}
+
+static void checkRenderPassActions(lua_State *L, int idx, Graphics::RenderPassActions &actions)
+{
+	checkPassActions(L, idx, "load", "load action", actions.colorLoad, actions.depthLoad, actions.stencilLoad);
+	checkPassActions(L, idx, "store", "store action", actions.colorStore, actions.depthStore, actions.stencilStore);
+
+	lua_getfield(L, idx, "clearcolor");
+	if (lua_istable(L, -1))
+	{
+		for (int i = 1; i <= 4; i++)
+			lua_rawgeti(L, -i, i);
+
+		actions.clearColor.r = (float) luaL_checknumber(L, -4);
+		actions.clearColor.g = (float) luaL_checknumber(L, -3);
+		actions.clearColor.b = (float) luaL_checknumber(L, -2);
+		actions.clearColor.a = (float) luaL_optnumber(L, -1, 1.0);
+
+		lua_pop(L, 4);
+	}
+	lua_pop(L, 1);
+
+	actions.clearDepth = luax_numberflag(L, idx, "cleardepth", actions.clearDepth);
+	actions.clearStencil = luax_intflag(L, idx, "clearstencil", actions.clearStencil);
+}
+
 int w_setCanvas(lua_State *L)
 {
 	// Disable stencil writes.
@@ -314,6 +384,8 @@ int w_setCanvas(lua_State *L)
 
 		if (targets.depthStencil.canvas == nullptr && (targets.temporaryRTFlags & tempstencilflag) == 0)
 			targets.temporaryRTFlags |= luax_boolflag(L, 1, "stencil", false) ? tempstencilflag : 0;
+
+		checkRenderPassActions(L, 1, targets.actions);
 	}
 	else
 	{
@@ -528,6 +600,7 @@ int w_captureScreenshot(lua_State *L)
 
 		info.data = fileinfo;
 		info.callback = screenshotFileCallback;
+		info.threadSafe = true;
 	}
 	else if (luax_istype(L, 1, love::thread::Channel::type))
 	{
@@ -535,6 +608,7 @@ int w_captureScreenshot(lua_State *L)
 		channel->retain();
 		info.data = channel;
 		info.callback = screenshotChannelCallback;
+		info.threadSafe = true;
 	}
 	else
 		return luax_typerror(L, 1, "function, string, or Channel");
@@ -714,6 +788,52 @@ static Image::Settings w__optImageSettings(lua_State *L, int idx, bool &setdpisc
 			setdpiscale = true;
 		}
 		lua_pop(L, 1);
+
+		lua_getfield(L, idx, Image::getConstant(Image::SETTING_MIPMAP_FILTER));
+		if (!lua_isnoneornil(L, -1))
+		{
+			const char *str = luaL_checkstring(L, -1);
+			if (!image::MipmapGenerator::getConstant(str, s.mipmapFilter))
+				luax_enumerror(L, "mipmap filter", image::MipmapGenerator::getConstants(s.mipmapFilter), str);
+
+			// A mipmap filter implies mipmaps.
+			s.mipmaps = true;
+		}
+		lua_pop(L, 1);
+
+		s.streaming = luax_boolflag(L, idx, Image::getConstant(Image::SETTING_STREAMING), s.streaming);
+		s.retainData = luax_boolflag(L, idx, Image::getConstant(Image::SETTING_RETAIN_DATA), s.retainData);
+		s.dynamic = luax_boolflag(L, idx, Image::getConstant(Image::SETTING_DYNAMIC), s.dynamic);
+
+		lua_getfield(L, idx, Image::getConstant(Image::SETTING_COMPACT));
+		if (!lua_isnoneornil(L, -1))
+		{
+			const char *str = luaL_checkstring(L, -1);
+			if (!image::FormatCompactor::getConstant(str, s.compact))
+				luax_enumerror(L, "compact mode", image::FormatCompactor::getConstants(s.compact), str);
+		}
+		lua_pop(L, 1);
+
+		lua_getfield(L, idx, Image::getConstant(Image::SETTING_COMPACT_QUALITY));
+		if (!lua_isnoneornil(L, -1))
+			s.compactQuality = (float) luaL_checknumber(L, -1);
+		lua_pop(L, 1);
+
+		// Compressed formats can't have their mipmaps generated by the GPU.
+		if (s.compact == image::FormatCompactor::MODE_COMPRESSED && s.mipmaps
+			&& s.mipmapFilter == image::MipmapGenerator::FILTER_MAX_ENUM)
+		{
+			s.mipmapFilter = image::MipmapGenerator::FILTER_BOX;
+		}
+
+		// Streaming needs mipmap data, so mipmaps are generated on the CPU if
+		// nothing else was asked for.
+		if (s.streaming)
+		{
+			s.mipmaps = true;
+			if (s.mipmapFilter == image::MipmapGenerator::FILTER_MAX_ENUM)
+				s.mipmapFilter = image::MipmapGenerator::FILTER_BOX;
+		}
 	}
 
 	return s;
@@ -752,11 +872,54 @@ getImageData(lua_State *L, int idx, bool allowcompressed, float *dpiscale)
 	return std::make_pair(idata, cdata);
 }
 
-static int w__pushNewImage(lua_State *L, Image::Slices &slices, const Image::Settings &settings)
+// Reloads the data of an Image which doesn't retain it from its file.
+static Image::ReloadFunction w__getFileReloadFunction(const std::string &filename, const Image::Settings &settings)
+{
+	return [filename, settings](Image::Slices &slices)
+	{
+		auto fs = Module::getInstance<filesystem::Filesystem>(Module::M_FILESYSTEM);
+		auto imagemodule = Module::getInstance<image::Image>(Module::M_IMAGE);
+
+		if (fs == nullptr || imagemodule == nullptr)
+			throw love::Exception("Cannot reload images without the love.filesystem and love.image modules.");
+
+		StrongRef<filesystem::FileData> fdata(fs->read(filename.c_str()), Acquire::NORETAIN);
+
+		if (imagemodule->isCompressed(fdata))
+		{
+			StrongRef<image::CompressedImageData> cdata(imagemodule->newCompressedData(fdata), Acquire::NORETAIN);
+			slices.add(cdata, 0, 0, false, settings.mipmaps);
+		}
+		else
+		{
+			StrongRef<image::ImageData> idata(imagemodule->newImageData(fdata), Acquire::NORETAIN);
+			slices.set(0, 0, idata);
+		}
+	};
+}
+
+static int w__pushNewImage(lua_State *L, Image::Slices &slices, const Image::Settings &settings, const Image::ReloadFunction &reload = nullptr)
 {
 	StrongRef<Image> i;
 	luax_catchexcept(L,
-		[&]() { i.set(instance()->newImage(slices, settings), Acquire::NORETAIN); },
+		[&]() {
+			if (settings.mipmapFilter != image::MipmapGenerator::FILTER_MAX_ENUM)
+				slices.generateMipmaps(settings.mipmapFilter, isGammaCorrect() && !settings.linear);
+
+			if (settings.compact != image::FormatCompactor::MODE_NONE)
+			{
+				bool srgb = isGammaCorrect() && !settings.linear;
+				slices.compact(settings.compact, settings.compactQuality, Image::getCompactFormats(settings.compact, srgb));
+			}
+
+			i.set(instance()->newImage(slices, settings), Acquire::NORETAIN);
+
+			if (reload)
+				i->setReloadFunction(reload);
+
+			if (instance()->isTextureBinningEnabled())
+				instance()->addToTextureBin(i);
+		},
 		[&](bool) { slices.clear(); }
 	);
 
@@ -1028,7 +1191,13 @@ int w_newImage(lua_State *L)
 			slices.add(data.second, 0, 0, false, settings.mipmaps);
 	}
 
-	return w__pushNewImage(L, slices, settings);
+	// Images loaded from a file which don't retain their data can get it back
+	// from the file.
+	Image::ReloadFunction reload;
+	if (!settings.retainData && lua_type(L, 1) == LUA_TSTRING)
+		reload = w__getFileReloadFunction(lua_tostring(L, 1), settings);
+
+	return w__pushNewImage(L, slices, settings, reload);
 }
 
 int w_newQuad(lua_State *L)
@@ -1078,6 +1247,31 @@ int w_newQuad(lua_State *L)
 	return 1;
 }
 
+int w_newQuadAtlas(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	double sw = 0.0;
+	double sh = 0.0;
+
+	if (luax_istype(L, 1, Texture::type))
+	{
+		Texture *texture = luax_checktexture(L, 1);
+		sw = texture->getWidth();
+		sh = texture->getHeight();
+	}
+	else
+	{
+		sw = luaL_checknumber(L, 1);
+		sh = luaL_checknumber(L, 2);
+	}
+
+	QuadAtlas *atlas = instance()->newQuadAtlas(sw, sh);
+	luax_pushtype(L, atlas);
+	atlas->release();
+	return 1;
+}
+
 int w_newFont(lua_State *L)
 {
 	luax_checkgraphicscreated(L);
@@ -1106,6 +1300,101 @@ int w_newFont(lua_State *L)
 	return 1;
 }
 
+int w_newImageAsync(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	bool dpiscaleset = false;
+	Image::Settings settings = w__optImageSettings(L, 2, dpiscaleset);
+
+	StrongRef<Data> data;
+
+	if (luax_istype(L, 1, image::ImageData::type) || luax_istype(L, 1, image::CompressedImageData::type))
+		data.set(luax_checktype<Data>(L, 1));
+	else
+	{
+		// The file is read here, but decoded on a worker thread.
+		data.set(filesystem::luax_getdata(L, 1), Acquire::NORETAIN);
+
+		if (!dpiscaleset)
+			parseDPIScale(data, &settings.dpiScale);
+	}
+
+	ImageLoader *loader = nullptr;
+	luax_catchexcept(L, [&](){ loader = instance()->newImageLoader(data, settings); });
+
+	luax_pushtype(L, loader);
+	loader->release();
+	return 1;
+}
+
+int w_setImageUploadBudget(lua_State *L)
+{
+	lua_Number bytes = luaL_checknumber(L, 1);
+	if (bytes <= 0)
+		return luaL_error(L, "Image upload budget must be greater than 0.");
+
+	instance()->setImageUploadBudget((size_t) bytes);
+	return 0;
+}
+
+int w_getImageUploadBudget(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getImageUploadBudget());
+	return 1;
+}
+
+int w_setBackgroundUploads(lua_State *L)
+{
+	instance()->setBackgroundUploads(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_getBackgroundUploads(lua_State *L)
+{
+	luax_pushboolean(L, instance()->getBackgroundUploads());
+	luax_pushboolean(L, instance()->isBackgroundUploadActive());
+	return 2;
+}
+
+int w_getRestoreProgress(lua_State *L)
+{
+	lua_pushnumber(L, instance()->getRestoreProgress());
+	return 1;
+}
+
+int w_setTextureStreamingBudget(lua_State *L)
+{
+	lua_Number bytes = luaL_checknumber(L, 1);
+	if (bytes < 0)
+		return luaL_error(L, "Texture streaming budget must not be negative.");
+
+	instance()->setTextureStreamingBudget((size_t) bytes);
+	return 0;
+}
+
+int w_getTextureStreamingBudget(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getTextureStreamingBudget());
+	return 1;
+}
+
+int w_setTextureMemoryBudget(lua_State *L)
+{
+	lua_Number bytes = luaL_checknumber(L, 1);
+	if (bytes < 0)
+		return luaL_error(L, "Texture memory budget must not be negative.");
+
+	instance()->setTextureMemoryBudget((size_t) bytes);
+	return 0;
+}
+
+int w_getTextureMemoryBudget(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getTextureMemoryBudget());
+	return 1;
+}
+
 int w_newImageFont(lua_State *L)
 {
 	luax_checkgraphicscreated(L);
@@ -1136,6 +1425,37 @@ int w_newImageFont(lua_State *L)
 	return 1;
 }
 
+int w_newDistanceFieldFont(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	// Distance fields need linear filtering to be reconstructed.
+	Texture::Filter filter = instance()->getDefaultFilter();
+	filter.min = filter.mag = Texture::FILTER_LINEAR;
+
+	// Convert to Rasterizer, if necessary.
+	if (!luax_istype(L, 1, love::font::Rasterizer::type))
+	{
+		if (lua_isnone(L, 1))
+			lua_pushnil(L);
+
+		std::vector<int> idxs;
+		for (int i = 0; i < lua_gettop(L); i++)
+			idxs.push_back(i + 1);
+
+		luax_convobj(L, &idxs[0], (int) idxs.size(), "font", "newDistanceFieldRasterizer");
+	}
+
+	love::font::Rasterizer *rasterizer = luax_checktype<love::font::Rasterizer>(L, 1);
+
+	graphics::Font *font = nullptr;
+	luax_catchexcept(L, [&]() { font = instance()->newFont(rasterizer, filter); });
+
+	luax_pushtype(L, font);
+	font->release();
+	return 1;
+}
+
 int w_newSpriteBatch(lua_State *L)
 {
 	luax_checkgraphicscreated(L);
@@ -1143,16 +1463,18 @@ int w_newSpriteBatch(lua_State *L)
 	Texture *texture = luax_checktexture(L, 1);
 	int size = (int) luaL_optinteger(L, 2, 1000);
 	vertex::Usage usage = vertex::USAGE_DYNAMIC;
-	if (lua_gettop(L) > 2)
+	if (lua_gettop(L) > 2 && !lua_isnil(L, 3))
 	{
 		const char *usagestr = luaL_checkstring(L, 3);
 		if (!vertex::getConstant(usagestr, usage))
 			return luax_enumerror(L, "usage hint", vertex::getConstants(usage), usagestr);
 	}
 
+	bool instanced = luax_optboolean(L, 4, false);
+
 	SpriteBatch *t = nullptr;
 	luax_catchexcept(L,
-		[&](){ t = instance()->newSpriteBatch(texture, size, usage); }
+		[&](){ t = instance()->newSpriteBatch(texture, size, usage, instanced); }
 	);
 
 	luax_pushtype(L, t);
@@ -1160,6 +1482,99 @@ int w_newSpriteBatch(lua_State *L)
 	return 1;
 }
 
+int w_newDrawList(lua_State *L)
+{
+	// No graphics-created check: DrawLists only hold CPU-side data, so they can
+	// be created and filled from love.thread workers.
+	DrawList *t = nullptr;
+	luax_catchexcept(L, [&](){ t = instance()->newDrawList(); });
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
+int w_newTextureAtlas(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	int size = (int) luaL_optinteger(L, 1, 2048);
+
+	PixelFormat format = PIXELFORMAT_RGBA8;
+	if (!lua_isnoneornil(L, 2))
+	{
+		const char *str = luaL_checkstring(L, 2);
+		if (!getConstant(str, format))
+			return luax_enumerror(L, "pixel format", str);
+	}
+
+	bool linear = luax_optboolean(L, 3, false);
+
+	TextureAtlas *t = nullptr;
+	luax_catchexcept(L, [&](){ t = instance()->newTextureAtlas(size, format, linear); });
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
+int w_newTextureArrayBin(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	int width = (int) luaL_checkinteger(L, 1);
+	int height = (int) luaL_checkinteger(L, 2);
+	int layers = (int) luaL_optinteger(L, 3, 64);
+
+	PixelFormat format = PIXELFORMAT_RGBA8;
+	if (!lua_isnoneornil(L, 4))
+	{
+		const char *str = luaL_checkstring(L, 4);
+		if (!getConstant(str, format))
+			return luax_enumerror(L, "pixel format", str);
+	}
+
+	bool linear = luax_optboolean(L, 5, false);
+
+	TextureArrayBin *t = nullptr;
+	luax_catchexcept(L, [&](){ t = instance()->newTextureArrayBin(width, height, layers, format, linear); });
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
+int w_newTileLayer(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	Texture *texture = luax_checktexture(L, 1);
+	int width = (int) luaL_checkinteger(L, 2);
+	int height = (int) luaL_checkinteger(L, 3);
+	float tilewidth = (float) luaL_checknumber(L, 4);
+	float tileheight = (float) luaL_checknumber(L, 5);
+	int chunksize = (int) luaL_optinteger(L, 6, 32);
+
+	TileLayer *t = nullptr;
+	luax_catchexcept(L, [&](){ t = instance()->newTileLayer(texture, width, height, tilewidth, tileheight, chunksize); });
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
+int w_setTextureBinning(lua_State *L)
+{
+	instance()->setTextureBinning(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isTextureBinningEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isTextureBinningEnabled());
+	return 1;
+}
+
 int w_newParticleSystem(lua_State *L)
 {
 	luax_checkgraphicscreated(L);
@@ -1179,12 +1594,8 @@ int w_newParticleSystem(lua_State *L)
 	return 1;
 }
 
-int w_newCanvas(lua_State *L)
+static void w__checkCanvasSettings(lua_State *L, Canvas::Settings &settings)
 {
-	luax_checkgraphicscreated(L);
-
-	Canvas::Settings settings;
-
 	// check if width and height are given. else default to screen dimensions.
 	settings.width  = (int) luaL_optinteger(L, 1, instance()->getWidth());
 	settings.height = (int) luaL_optinteger(L, 2, instance()->getHeight());
@@ -1213,7 +1624,7 @@ int w_newCanvas(lua_State *L)
 		{
 			const char *str = luaL_checkstring(L, -1);
 			if (!getConstant(str, settings.format))
-				return luax_enumerror(L, "pixel format", str);
+				luax_enumerror(L, "pixel format", str);
 		}
 		lua_pop(L, 1);
 
@@ -1222,7 +1633,7 @@ int w_newCanvas(lua_State *L)
 		{
 			const char *str = luaL_checkstring(L, -1);
 			if (!Texture::getConstant(str, settings.type))
-				return luax_enumerror(L, "texture type", Texture::getConstants(settings.type), str);
+				luax_enumerror(L, "texture type", Texture::getConstants(settings.type), str);
 		}
 		lua_pop(L, 1);
 
@@ -1239,10 +1650,18 @@ int w_newCanvas(lua_State *L)
 		{
 			const char *str = luaL_checkstring(L, -1);
 			if (!Canvas::getConstant(str, settings.mipmaps))
-				return luax_enumerror(L, "Canvas mipmap mode", Canvas::getConstants(settings.mipmaps), str);
+				luax_enumerror(L, "Canvas mipmap mode", Canvas::getConstants(settings.mipmaps), str);
 		}
 		lua_pop(L, 1);
 	}
+}
+
+int w_newCanvas(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	Canvas::Settings settings;
+	w__checkCanvasSettings(L, settings);
 
 	Canvas *canvas = nullptr;
 	luax_catchexcept(L, [&](){ canvas = instance()->newCanvas(settings); });
@@ -1252,59 +1671,153 @@ int w_newCanvas(lua_State *L)
 	return 1;
 }
 
-static int w_getShaderSource(lua_State *L, int startidx, bool gles, std::string &vertexsource, std::string &pixelsource)
+int w_getPooledCanvas(lua_State *L)
 {
-	using namespace love::filesystem;
-
 	luax_checkgraphicscreated(L);
 
-	auto fs = Module::getInstance<Filesystem>(Module::M_FILESYSTEM);
-
-	// read any filepath arguments
-	for (int i = startidx; i < startidx + 2; i++)
-	{
-		if (!lua_isstring(L, i))
-		{
-			if (luax_cangetfiledata(L, i))
-			{
-				FileData *fd = luax_getfiledata(L, i);
+	Canvas::Settings settings;
+	w__checkCanvasSettings(L, settings);
 
-				lua_pushlstring(L, (const char *) fd->getData(), fd->getSize());
-				fd->release();
+	// The pool keeps its own reference to the Canvas.
+	Canvas *canvas = nullptr;
+	luax_catchexcept(L, [&](){ canvas = instance()->getPooledCanvas(settings); });
 
-				lua_replace(L, i);
-			}
+	luax_pushtype(L, canvas);
+	return 1;
+}
 
-			continue;
-		}
+int w_setCanvasPoolLifetime(lua_State *L)
+{
+	int frames = (int) luaL_checkinteger(L, 1);
+	if (frames < 0)
+		return luaL_error(L, "Canvas pool lifetime must not be negative.");
 
-		size_t slen = 0;
-		const char *str = lua_tolstring(L, i, &slen);
+	instance()->setCanvasPoolLifetime(frames);
+	return 0;
+}
+
+int w_getCanvasPoolLifetime(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getCanvasPoolLifetime());
+	return 1;
+}
+
+int w_clearCanvasPool(lua_State *L)
+{
+	luax_catchexcept(L, [&](){ instance()->clearCanvasPool(); });
+	return 0;
+}
+
+int w_newVideoRecorder(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	std::string target = luax_checkstring(L, 1);
+	int width = (int) luaL_checkinteger(L, 2);
+	int height = (int) luaL_checkinteger(L, 3);
+
+	VideoRecorder::Settings settings;
 
-		Filesystem::Info info = {};
-		if (fs != nullptr && fs->getInfo(str, info))
+	if (!lua_isnoneornil(L, 4))
+	{
+		luaL_checktype(L, 4, LUA_TTABLE);
+
+		lua_getfield(L, 4, "format");
+		if (!lua_isnoneornil(L, -1))
 		{
-			FileData *fd = nullptr;
-			luax_catchexcept(L, [&](){ fd = fs->read(str); });
+			const char *str = luaL_checkstring(L, -1);
+			if (!VideoRecorder::getConstant(str, settings.format))
+				return luax_enumerror(L, "video format", VideoRecorder::getConstants(settings.format), str);
+		}
+		lua_pop(L, 1);
+
+		settings.fps = luax_intflag(L, 4, "fps", settings.fps);
+		settings.pipe = luax_boolflag(L, 4, "pipe", settings.pipe);
+		settings.buffers = luax_intflag(L, 4, "buffers", settings.buffers);
+		settings.queue = luax_intflag(L, 4, "queue", settings.queue);
+	}
+
+	VideoRecorder *recorder = nullptr;
+	luax_catchexcept(L, [&](){ recorder = instance()->newVideoRecorder(target, width, height, settings); });
+
+	luax_pushtype(L, recorder);
+	recorder->release();
+	return 1;
+}
+
+int w_newOcclusionQuery(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	bool conservative = luax_optboolean(L, 1, false);
+
+	OcclusionQuery *query = nullptr;
+	luax_catchexcept(L, [&](){ query = instance()->newOcclusionQuery(conservative); });
+
+	luax_pushtype(L, query);
+	query->release();
+	return 1;
+}
+
+// Replaces a filepath or FileData argument with the file's contents.
+static int w_readShaderFileArg(lua_State *L, int idx)
+{
+	using namespace love::filesystem;
+
+	auto fs = Module::getInstance<Filesystem>(Module::M_FILESYSTEM);
+
+	if (!lua_isstring(L, idx))
+	{
+		if (luax_cangetfiledata(L, idx))
+		{
+			FileData *fd = luax_getfiledata(L, idx);
 
 			lua_pushlstring(L, (const char *) fd->getData(), fd->getSize());
 			fd->release();
 
-			lua_replace(L, i);
+			lua_replace(L, idx);
 		}
-		else
+
+		return 0;
+	}
+
+	size_t slen = 0;
+	const char *str = lua_tolstring(L, idx, &slen);
+
+	Filesystem::Info info = {};
+	if (fs != nullptr && fs->getInfo(str, info))
+	{
+		FileData *fd = nullptr;
+		luax_catchexcept(L, [&](){ fd = fs->read(str); });
+
+		lua_pushlstring(L, (const char *) fd->getData(), fd->getSize());
+		fd->release();
+
+		lua_replace(L, idx);
+	}
+	else
+	{
+		// Check if the argument looks like a filepath - we want a nicer
+		// error for misspelled filepath arguments.
+		if (slen > 0 && slen < 64 && !strchr(str, '\n'))
 		{
-			// Check if the argument looks like a filepath - we want a nicer
-			// error for misspelled filepath arguments.
-			if (slen > 0 && slen < 64 && !strchr(str, '\n'))
-			{
-				const char *ext = strchr(str, '.');
-				if (ext != nullptr && !strchr(ext, ';') && !strchr(ext, ' '))
-					return luaL_error(L, "Could not open file %s. Does not exist.", str);
-			}
+			const char *ext = strchr(str, '.');
+			if (ext != nullptr && !strchr(ext, ';') && !strchr(ext, ' '))
+				return luaL_error(L, "Could not open file %s. Does not exist.", str);
 		}
 	}
 
+	return 0;
+}
+
+static int w_getShaderSource(lua_State *L, int startidx, bool gles, std::string &vertexsource, std::string &pixelsource)
+{
+	luax_checkgraphicscreated(L);
+
+	// read any filepath arguments
+	for (int i = startidx; i < startidx + 2; i++)
+		w_readShaderFileArg(L, i);
+
 	bool has_arg1 = lua_isstring(L, startidx + 0) != 0;
 	bool has_arg2 = lua_isstring(L, startidx + 1) != 0;
 
@@ -1356,7 +1869,7 @@ static int w_getShaderSource(lua_State *L, int startidx, bool gles, std::string
 	return 0;
 }
 
-int w_newShader(lua_State *L)
+static int pushNewShader(lua_State *L, bool async)
 {
 	bool gles = instance()->getRenderer() == Graphics::RENDERER_OPENGLES;
 
@@ -1366,7 +1879,11 @@ int w_newShader(lua_State *L)
 	bool should_error = false;
 	try
 	{
-		Shader *shader = instance()->newShader(vertexsource, pixelsource);
+		Shader *shader = nullptr;
+		if (async)
+			shader = instance()->newShaderAsync(vertexsource, pixelsource);
+		else
+			shader = instance()->newShader(vertexsource, pixelsource);
 		luax_pushtype(L, shader);
 		shader->release();
 	}
@@ -1386,6 +1903,138 @@ int w_newShader(lua_State *L)
 	return 1;
 }
 
+int w_newShader(lua_State *L)
+{
+	return pushNewShader(L, false);
+}
+
+int w_newShaderAsync(lua_State *L)
+{
+	return pushNewShader(L, true);
+}
+
+int w_newShaderVariants(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+
+	std::vector<std::string> keys;
+	int nkeys = (int) luax_objlen(L, 1);
+	for (int i = 1; i <= nkeys; i++)
+	{
+		lua_rawgeti(L, 1, i);
+		keys.push_back(luax_checkstring(L, -1));
+		lua_pop(L, 1);
+	}
+
+	bool gles = instance()->getRenderer() == Graphics::RENDERER_OPENGLES;
+
+	std::string vertexsource, pixelsource;
+	w_getShaderSource(L, 2, gles, vertexsource, pixelsource);
+
+	ShaderVariants *variants = nullptr;
+	luax_catchexcept(L, [&](){ variants = instance()->newShaderVariants(vertexsource, pixelsource, keys); });
+
+	luax_pushtype(L, variants);
+	variants->release();
+	return 1;
+}
+
+int w_newComputeShader(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	bool gles = instance()->getRenderer() == Graphics::RENDERER_OPENGLES;
+
+	w_readShaderFileArg(L, 1);
+	luaL_checkstring(L, 1);
+
+	luax_getfunction(L, "graphics", "_computeCodeToGLSL");
+	lua_pushboolean(L, gles);
+	lua_pushvalue(L, 1);
+
+	if (lua_pcall(L, 2, 1, 0) != 0)
+		return luaL_error(L, "%s", lua_tostring(L, -1));
+
+	std::string source = luax_checkstring(L, -1);
+
+	bool should_error = false;
+	try
+	{
+		Shader *shader = instance()->newComputeShader(source);
+		luax_pushtype(L, shader);
+		shader->release();
+	}
+	catch (love::Exception &e)
+	{
+		luax_getfunction(L, "graphics", "_transformGLSLErrorMessages");
+		lua_pushstring(L, e.what());
+
+		// Function pushes the new error string onto the stack.
+		lua_pcall(L, 1, 1, 0);
+		should_error = true;
+	}
+
+	if (should_error)
+		return lua_error(L);
+
+	return 1;
+}
+
+int w_dispatchThreadgroups(lua_State *L)
+{
+	Shader *shader = luax_checkshader(L, 1);
+	int x = (int) luaL_checkinteger(L, 2);
+	int y = (int) luaL_optinteger(L, 3, 1);
+	int z = (int) luaL_optinteger(L, 4, 1);
+
+	luax_catchexcept(L, [&](){ instance()->dispatchThreadgroups(shader, x, y, z); });
+	return 0;
+}
+
+int w_memoryBarrier(lua_State *L)
+{
+	uint32 flags = 0;
+	int nargs = std::max(lua_gettop(L), 1);
+
+	for (int i = 1; i <= nargs; i++)
+	{
+		const char *str = luaL_checkstring(L, i);
+		Graphics::MemoryBarrierType type;
+		if (!Graphics::getConstant(str, type))
+			return luax_enumerror(L, "memory barrier type", Graphics::getConstants(type), str);
+
+		flags |= 1u << (uint32) type;
+	}
+
+	luax_catchexcept(L, [&](){ instance()->memoryBarrier(flags); });
+	return 0;
+}
+
+int w_copyTexture(lua_State *L)
+{
+	Texture *src = luax_checktexture(L, 1);
+	Texture *dst = luax_checktexture(L, 2);
+
+	int srcslice = (int) luaL_optinteger(L, 9, 1) - 1;
+	int srcmipmap = (int) luaL_optinteger(L, 10, 1) - 1;
+	int dstslice = (int) luaL_optinteger(L, 11, 1) - 1;
+	int dstmipmap = (int) luaL_optinteger(L, 12, 1) - 1;
+
+	Rect rect;
+	rect.x = (int) luaL_optinteger(L, 3, 0);
+	rect.y = (int) luaL_optinteger(L, 4, 0);
+
+	int dstx = (int) luaL_optinteger(L, 5, 0);
+	int dsty = (int) luaL_optinteger(L, 6, 0);
+
+	int mip = std::max(std::min(srcmipmap, src->getMipmapCount() - 1), 0);
+	rect.w = (int) luaL_optinteger(L, 7, src->getPixelWidth(mip) - rect.x);
+	rect.h = (int) luaL_optinteger(L, 8, src->getPixelHeight(mip) - rect.y);
+
+	luax_catchexcept(L, [&](){ instance()->copyTexture(src, dst, rect, srcslice, srcmipmap, dstx, dsty, dstslice, dstmipmap); });
+	return 0;
+}
+
 int w_validateShader(lua_State *L)
 {
 	bool gles = luax_checkboolean(L, 1);
@@ -1492,7 +2141,7 @@ static Mesh *newStandardMesh(lua_State *L)
 	return t;
 }
 
-static Mesh *newCustomMesh(lua_State *L)
+static Mesh *newCustomMesh(lua_State *L, bool skinned)
 {
 	Mesh *t = nullptr;
 
@@ -1544,13 +2193,23 @@ static Mesh *newCustomMesh(lua_State *L)
 	if (lua_isnumber(L, 2))
 	{
 		int vertexcount = (int) luaL_checkinteger(L, 2);
-		luax_catchexcept(L, [&](){ t = instance()->newMesh(vertexformat, vertexcount, drawmode, usage); });
+		luax_catchexcept(L, [&]() {
+			if (skinned)
+				t = instance()->newSkinnedMesh(vertexformat, vertexcount, drawmode, usage);
+			else
+				t = instance()->newMesh(vertexformat, vertexcount, drawmode, usage);
+		});
 	}
 	else if (luax_istype(L, 2, Data::type))
 	{
 		// Vertex data comes directly from a Data object.
 		Data *data = luax_checktype<Data>(L, 2);
-		luax_catchexcept(L, [&](){ t = instance()->newMesh(vertexformat, data->getData(), data->getSize(), drawmode, usage); });
+		luax_catchexcept(L, [&]() {
+			if (skinned)
+				t = instance()->newSkinnedMesh(vertexformat, data->getData(), data->getSize(), drawmode, usage);
+			else
+				t = instance()->newMesh(vertexformat, data->getData(), data->getSize(), drawmode, usage);
+		});
 	}
 	else
 	{
@@ -1569,7 +2228,12 @@ static Mesh *newCustomMesh(lua_State *L)
 
 		size_t numvertices = luax_objlen(L, 2);
 
-		luax_catchexcept(L, [&](){ t = instance()->newMesh(vertexformat, numvertices, drawmode, usage); });
+		luax_catchexcept(L, [&]() {
+			if (skinned)
+				t = instance()->newSkinnedMesh(vertexformat, (int) numvertices, drawmode, usage);
+			else
+				t = instance()->newMesh(vertexformat, numvertices, drawmode, usage);
+		});
 
 		// Maximum possible data size for a single vertex attribute.
 		char data[sizeof(float) * 4];
@@ -1625,7 +2289,7 @@ int w_newMesh(lua_State *L)
 
 	int arg2type = lua_type(L, 2);
 	if (arg1type == LUA_TTABLE && (arg2type == LUA_TTABLE || arg2type == LUA_TNUMBER || arg2type == LUA_TUSERDATA))
-		t = newCustomMesh(L);
+		t = newCustomMesh(L, false);
 	else
 		t = newStandardMesh(L);
 
@@ -1634,6 +2298,23 @@ int w_newMesh(lua_State *L)
 	return 1;
 }
 
+int w_newSkinnedMesh(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	luaL_checktype(L, 1, LUA_TTABLE);
+
+	int arg2type = lua_type(L, 2);
+	if (arg2type != LUA_TTABLE && arg2type != LUA_TNUMBER && arg2type != LUA_TUSERDATA)
+		luaL_argerror(L, 2, "table, number, or Data expected");
+
+	Mesh *t = newCustomMesh(L, true);
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
 int w_newText(lua_State *L)
 {
 	luax_checkgraphicscreated(L);
@@ -1966,6 +2647,18 @@ int w_getLineJoin(lua_State *L)
 	return 1;
 }
 
+int w_setGPULinesEnabled(lua_State *L)
+{
+	instance()->setGPULinesEnabled(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isGPULinesEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isGPULinesEnabled());
+	return 1;
+}
+
 int w_setPointSize(lua_State *L)
 {
 	float size = (float)luaL_checknumber(L, 1);
@@ -2111,13 +2804,25 @@ int w_setDefaultShaderCode(lua_State *L)
 			lua_getfield(L, -2, "pixel");
 			lua_getfield(L, -3, "videopixel");
 			lua_getfield(L, -4, "arraypixel");
-
-			std::string vertex = luax_checkstring(L, -4);
-			std::string pixel = luax_checkstring(L, -3);
-			std::string videopixel = luax_checkstring(L, -2);
-			std::string arraypixel = luax_checkstring(L, -1);
-
-			lua_pop(L, 5);
+			lua_getfield(L, -5, "instancedvertex");
+			lua_getfield(L, -6, "gpuparticlevertex");
+			lua_getfield(L, -7, "linevertex");
+			lua_getfield(L, -8, "distancefieldpixel");
+			lua_getfield(L, -9, "instancedglyphvertex");
+			lua_getfield(L, -10, "skinnedvertex");
+
+			std::string vertex = luax_checkstring(L, -10);
+			std::string pixel = luax_checkstring(L, -9);
+			std::string videopixel = luax_checkstring(L, -8);
+			std::string arraypixel = luax_checkstring(L, -7);
+			std::string instancedvertex = luax_checkstring(L, -6);
+			std::string gpuparticlevertex = luax_checkstring(L, -5);
+			std::string linevertex = luax_checkstring(L, -4);
+			std::string distancefieldpixel = luax_checkstring(L, -3);
+			std::string instancedglyphvertex = luax_checkstring(L, -2);
+			std::string skinnedvertex = luax_checkstring(L, -1);
+
+			lua_pop(L, 11);
 
 			Graphics::defaultShaderCode[Shader::STANDARD_DEFAULT][lang][i].source[ShaderStage::STAGE_VERTEX] = vertex;
 			Graphics::defaultShaderCode[Shader::STANDARD_DEFAULT][lang][i].source[ShaderStage::STAGE_PIXEL] = pixel;
@@ -2127,6 +2832,27 @@ int w_setDefaultShaderCode(lua_State *L)
 
 			Graphics::defaultShaderCode[Shader::STANDARD_ARRAY][lang][i].source[ShaderStage::STAGE_VERTEX] = vertex;
 			Graphics::defaultShaderCode[Shader::STANDARD_ARRAY][lang][i].source[ShaderStage::STAGE_PIXEL] = arraypixel;
+
+			Graphics::defaultShaderCode[Shader::STANDARD_INSTANCED_SPRITE][lang][i].source[ShaderStage::STAGE_VERTEX] = instancedvertex;
+			Graphics::defaultShaderCode[Shader::STANDARD_INSTANCED_SPRITE][lang][i].source[ShaderStage::STAGE_PIXEL] = pixel;
+
+			Graphics::defaultShaderCode[Shader::STANDARD_GPU_PARTICLE][lang][i].source[ShaderStage::STAGE_VERTEX] = gpuparticlevertex;
+			Graphics::defaultShaderCode[Shader::STANDARD_GPU_PARTICLE][lang][i].source[ShaderStage::STAGE_PIXEL] = pixel;
+
+			Graphics::defaultShaderCode[Shader::STANDARD_LINE][lang][i].source[ShaderStage::STAGE_VERTEX] = linevertex;
+			Graphics::defaultShaderCode[Shader::STANDARD_LINE][lang][i].source[ShaderStage::STAGE_PIXEL] = pixel;
+
+			Graphics::defaultShaderCode[Shader::STANDARD_DISTANCE_FIELD][lang][i].source[ShaderStage::STAGE_VERTEX] = vertex;
+			Graphics::defaultShaderCode[Shader::STANDARD_DISTANCE_FIELD][lang][i].source[ShaderStage::STAGE_PIXEL] = distancefieldpixel;
+
+			Graphics::defaultShaderCode[Shader::STANDARD_INSTANCED_GLYPH][lang][i].source[ShaderStage::STAGE_VERTEX] = instancedglyphvertex;
+			Graphics::defaultShaderCode[Shader::STANDARD_INSTANCED_GLYPH][lang][i].source[ShaderStage::STAGE_PIXEL] = pixel;
+
+			Graphics::defaultShaderCode[Shader::STANDARD_INSTANCED_GLYPH_DISTANCE_FIELD][lang][i].source[ShaderStage::STAGE_VERTEX] = instancedglyphvertex;
+			Graphics::defaultShaderCode[Shader::STANDARD_INSTANCED_GLYPH_DISTANCE_FIELD][lang][i].source[ShaderStage::STAGE_PIXEL] = distancefieldpixel;
+
+			Graphics::defaultShaderCode[Shader::STANDARD_SKINNED][lang][i].source[ShaderStage::STAGE_VERTEX] = skinnedvertex;
+			Graphics::defaultShaderCode[Shader::STANDARD_SKINNED][lang][i].source[ShaderStage::STAGE_PIXEL] = pixel;
 		}
 	}
 
@@ -2295,7 +3021,7 @@ int w_getStats(lua_State *L)
 	if (lua_istable(L, 1))
 		lua_pushvalue(L, 1);
 	else
-		lua_createtable(L, 0, 7);
+		lua_createtable(L, 0, 11);
 
 	lua_pushinteger(L, stats.drawCalls);
 	lua_setfield(L, -2, "drawcalls");
@@ -2321,6 +3047,247 @@ int w_getStats(lua_State *L)
 	lua_pushinteger(L, stats.textureMemory);
 	lua_setfield(L, -2, "texturememory");
 
+	lua_pushinteger(L, stats.evictedImages);
+	lua_setfield(L, -2, "evictedimages");
+
+	lua_pushinteger(L, stats.pooledCanvases);
+	lua_setfield(L, -2, "pooledcanvases");
+
+	lua_pushinteger(L, stats.canvasPoolMemory);
+	lua_setfield(L, -2, "canvaspoolmemory");
+
+	return 1;
+}
+
+static const char *streamBufferNames[] = {"positions", "attributes", "indices"};
+
+int w_getStreamStats(lua_State *L)
+{
+	Graphics::StreamStats stats = instance()->getStreamStats();
+
+	if (lua_istable(L, 1))
+		lua_pushvalue(L, 1);
+	else
+		lua_createtable(L, 0, 3);
+
+	lua_createtable(L, 0, Graphics::STREAM_FLUSH_MAX_ENUM);
+
+	for (int i = 0; i < Graphics::STREAM_FLUSH_MAX_ENUM; i++)
+	{
+		const char *name = nullptr;
+		if (!Graphics::getConstant((Graphics::StreamFlushReason) i, name))
+			continue;
+
+		lua_pushinteger(L, stats.flushes[i]);
+		lua_setfield(L, -2, name);
+	}
+
+	lua_setfield(L, -2, "flushes");
+
+	for (int i = 0; i < 3; i++)
+	{
+		lua_createtable(L, 0, 8);
+
+		lua_pushnumber(L, (lua_Number) stats.buffers[i].uploadedBytes);
+		lua_setfield(L, -2, "uploadedbytes");
+
+		lua_pushinteger(L, stats.buffers[i].maps);
+		lua_setfield(L, -2, "maps");
+
+		lua_pushinteger(L, stats.buffers[i].mapStalls);
+		lua_setfield(L, -2, "mapstalls");
+
+		lua_pushnumber(L, stats.buffers[i].mapStallTime * 1000.0);
+		lua_setfield(L, -2, "mapstalltime");
+
+		lua_pushinteger(L, stats.buffers[i].wraps);
+		lua_setfield(L, -2, "wraps");
+
+		lua_pushnumber(L, (lua_Number) stats.bufferSizes[i]);
+		lua_setfield(L, -2, "size");
+
+		lua_pushnumber(L, (lua_Number) stats.highWaterMarks[i]);
+		lua_setfield(L, -2, "highwater");
+
+		lua_pushinteger(L, stats.resizes[i]);
+		lua_setfield(L, -2, "resizes");
+
+		lua_setfield(L, -2, streamBufferNames[i]);
+	}
+
+	return 1;
+}
+
+int w_setStreamBufferSizes(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+
+	size_t sizes[3];
+	instance()->getStreamBufferSizes(sizes);
+
+	for (int i = 0; i < 3; i++)
+	{
+		lua_getfield(L, 1, streamBufferNames[i]);
+		if (!lua_isnoneornil(L, -1))
+		{
+			lua_Number size = luaL_checknumber(L, -1);
+			if (size < 1)
+				return luaL_error(L, "Invalid %s stream buffer size: %f", streamBufferNames[i], size);
+			sizes[i] = (size_t) size;
+		}
+		lua_pop(L, 1);
+	}
+
+	luax_catchexcept(L, [&](){ instance()->setStreamBufferSizes(sizes); });
+	return 0;
+}
+
+int w_getStreamBufferSizes(lua_State *L)
+{
+	size_t sizes[3];
+	instance()->getStreamBufferSizes(sizes);
+
+	lua_createtable(L, 0, 3);
+
+	for (int i = 0; i < 3; i++)
+	{
+		lua_pushnumber(L, (lua_Number) sizes[i]);
+		lua_setfield(L, -2, streamBufferNames[i]);
+	}
+
+	return 1;
+}
+
+int w_setStreamBufferAutoSizing(lua_State *L)
+{
+	instance()->setStreamBufferAutoSizing(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isStreamBufferAutoSizing(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isStreamBufferAutoSizing());
+	return 1;
+}
+
+int w_getFrameTimings(lua_State *L)
+{
+	Graphics::FrameTimings timings = instance()->getFrameTimings();
+
+	lua_createtable(L, 0, 7);
+
+	lua_pushnumber(L, timings.cpuTime);
+	lua_setfield(L, -2, "cputime");
+
+	lua_pushnumber(L, timings.swapTime);
+	lua_setfield(L, -2, "swaptime");
+
+	lua_pushnumber(L, timings.fenceWaitTime);
+	lua_setfield(L, -2, "fencewaittime");
+
+	lua_pushnumber(L, timings.frameLimitWaitTime);
+	lua_setfield(L, -2, "framelimitwaittime");
+
+	lua_pushnumber(L, timings.displayLatency);
+	lua_setfield(L, -2, "displaylatency");
+
+	lua_pushinteger(L, timings.framesInFlight);
+	lua_setfield(L, -2, "framesinflight");
+
+	lua_pushnumber(L, timings.frameStartDelay);
+	lua_setfield(L, -2, "framestartdelay");
+
+	return 1;
+}
+
+int w_setMaxFramesInFlight(lua_State *L)
+{
+	int frames = (int) luaL_checkinteger(L, 1);
+	luax_catchexcept(L, [&](){ instance()->setMaxFramesInFlight(frames); });
+	return 0;
+}
+
+int w_getMaxFramesInFlight(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getMaxFramesInFlight());
+	return 1;
+}
+
+int w_setLatencyMode(lua_State *L)
+{
+	const char *str = luaL_checkstring(L, 1);
+	Graphics::LatencyMode mode;
+	if (!Graphics::getConstant(str, mode))
+		return luax_enumerror(L, "latency mode", Graphics::getConstants(mode), str);
+
+	luax_catchexcept(L, [&](){ instance()->setLatencyMode(mode); });
+	return 0;
+}
+
+int w_getLatencyMode(lua_State *L)
+{
+	const char *str = nullptr;
+	if (!Graphics::getConstant(instance()->getLatencyMode(), str))
+		return luaL_error(L, "Unknown latency mode.");
+
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_setGPUTimingEnabled(lua_State *L)
+{
+	bool enable = luax_checkboolean(L, 1);
+	luax_catchexcept(L, [&](){ instance()->setGPUTimingEnabled(enable); });
+	return 0;
+}
+
+int w_isGPUTimingEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isGPUTimingEnabled());
+	return 1;
+}
+
+int w_getGPUTimings(lua_State *L)
+{
+	Graphics::GPUTimings timings;
+
+	if (!instance()->getGPUTimings(timings))
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+
+	lua_createtable(L, 0, 3);
+
+	lua_pushnumber(L, timings.frameTime);
+	lua_setfield(L, -2, "frametime");
+
+	lua_pushinteger(L, timings.latency);
+	lua_setfield(L, -2, "latency");
+
+	lua_createtable(L, (int) timings.passes.size(), 0);
+
+	for (int i = 0; i < (int) timings.passes.size(); i++)
+	{
+		const Graphics::GPUPassTiming &pass = timings.passes[i];
+
+		lua_createtable(L, 0, 2);
+
+		lua_pushnumber(L, pass.time);
+		lua_setfield(L, -2, "time");
+
+		// The main screen has no Canvas.
+		if (pass.canvas.get() != nullptr)
+		{
+			luax_pushtype(L, pass.canvas.get());
+			lua_setfield(L, -2, "canvas");
+		}
+
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	lua_setfield(L, -2, "passes");
+
 	return 1;
 }
 
@@ -2329,6 +3296,8 @@ int w_draw(lua_State *L)
 	Drawable *drawable = nullptr;
 	Texture *texture = nullptr;
 	Quad *quad = nullptr;
+	QuadAtlas *atlas = nullptr;
+	int frame = 0;
 	int startidx = 2;
 
 	if (luax_istype(L, 2, Quad::type))
@@ -2337,6 +3306,13 @@ int w_draw(lua_State *L)
 		quad = luax_totype<Quad>(L, 2);
 		startidx = 3;
 	}
+	else if (luax_istype(L, 2, QuadAtlas::type))
+	{
+		texture = luax_checktexture(L, 1);
+		atlas = luax_totype<QuadAtlas>(L, 2);
+		frame = (int) luaL_checkinteger(L, 3) - 1;
+		startidx = 4;
+	}
 	else if (lua_isnil(L, 2) && !lua_isnoneornil(L, 3))
 	{
 		return luax_typerror(L, 2, "Quad");
@@ -2353,6 +3329,8 @@ int w_draw(lua_State *L)
 		{
 			if (texture && quad)
 				instance()->draw(texture, quad, m);
+			else if (texture && atlas)
+				instance()->draw(texture, atlas, frame, m);
 			else
 				instance()->draw(drawable, m);
 		});
@@ -2365,6 +3343,8 @@ int w_drawLayer(lua_State *L)
 {
 	Texture *texture = luax_checktexture(L, 1);
 	Quad *quad = nullptr;
+	QuadAtlas *atlas = nullptr;
+	int frame = 0;
 	int layer = (int) luaL_checkinteger(L, 2) - 1;
 	int startidx = 3;
 
@@ -2374,6 +3354,12 @@ int w_drawLayer(lua_State *L)
 		quad = luax_totype<Quad>(L, startidx);
 		startidx++;
 	}
+	else if (luax_istype(L, startidx, QuadAtlas::type))
+	{
+		atlas = luax_totype<QuadAtlas>(L, startidx);
+		frame = (int) luaL_checkinteger(L, startidx + 1) - 1;
+		startidx += 2;
+	}
 	else if (lua_isnil(L, startidx) && !lua_isnoneornil(L, startidx + 1))
 	{
 		return luax_typerror(L, startidx, "Quad");
@@ -2385,6 +3371,8 @@ int w_drawLayer(lua_State *L)
 		{
 			if (quad)
 				instance()->drawLayer(texture, layer, quad, m);
+			else if (atlas)
+				instance()->drawLayer(texture, layer, atlas, frame, m);
 			else
 				instance()->drawLayer(texture, layer, m);
 		});
@@ -2406,6 +3394,76 @@ int w_drawInstanced(lua_State *L)
 	return 0;
 }
 
+int w_drawIndirect(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+
+	size_t recordsize = t->getIndirectRecordSize();
+	bool indexed = recordsize == sizeof(Graphics::DrawIndexedIndirectArgs);
+
+	std::vector<uint8> recorddata;
+	const void *records = nullptr;
+	int drawcount = 0;
+
+	if (luax_istype(L, 2, Data::type))
+	{
+		// Raw records, in the layout OpenGL uses.
+		Data *d = luax_checktype<Data>(L, 2);
+
+		if (d->getSize() % recordsize != 0)
+			return luaL_error(L, "Indirect draw data size must be a multiple of %d bytes.", (int) recordsize);
+
+		records = d->getData();
+		drawcount = (int) (d->getSize() / recordsize);
+	}
+	else
+	{
+		// A table of {count, instancecount, first, baseinstance, basevertex}
+		// records. The first vertex or index is 1-based.
+		luaL_checktype(L, 2, LUA_TTABLE);
+
+		drawcount = (int) luax_objlen(L, 2);
+		recorddata.resize(recordsize * drawcount);
+
+		for (int i = 0; i < drawcount; i++)
+		{
+			lua_rawgeti(L, 2, i + 1);
+			luaL_checktype(L, -1, LUA_TTABLE);
+
+			for (int j = 1; j <= 5; j++)
+				lua_rawgeti(L, -j, j);
+
+			uint32 count = (uint32) luaL_checkinteger(L, -5);
+			uint32 instancecount = (uint32) luaL_optinteger(L, -4, 1);
+			uint32 first = (uint32) (luaL_optinteger(L, -3, 1) - 1);
+			uint32 baseinstance = (uint32) luaL_optinteger(L, -2, 0);
+			int32 basevertex = (int32) luaL_optinteger(L, -1, 0);
+
+			if (indexed)
+			{
+				auto &args = ((Graphics::DrawIndexedIndirectArgs *) recorddata.data())[i];
+				args = {count, instancecount, first, basevertex, baseinstance};
+			}
+			else
+			{
+				auto &args = ((Graphics::DrawIndirectArgs *) recorddata.data())[i];
+				args = {count, instancecount, first, baseinstance};
+			}
+
+			lua_pop(L, 6);
+		}
+
+		records = recorddata.data();
+	}
+
+	luax_checkstandardtransform(L, 3, [&](const Matrix4 &m)
+	{
+		luax_catchexcept(L, [&]() { instance()->drawIndirect(t, m, records, drawcount); });
+	});
+
+	return 0;
+}
+
 int w_print(lua_State *L)
 {
 	std::vector<Font::ColoredString> str;
@@ -2488,10 +3546,32 @@ int w_printf(lua_State *L)
 
 int w_points(lua_State *L)
 {
-	// love.graphics.points has 3 variants:
+	// love.graphics.points has 4 variants:
 	// - points(x1, y1, x2, y2, ...)
 	// - points({x1, y1, x2, y2, ...})
 	// - points({{x1, y1 [, r, g, b, a]}, {x2, y2 [, r, g, b, a]}, ...})
+	// - points(data [, count])
+
+	if (luax_istype(L, 1, Data::type))
+	{
+		// Packed {float x, y; uint8 r, g, b, a; float size} records.
+		Data *d = luax_checktype<Data>(L, 1);
+
+		const size_t recordsize = sizeof(vertex::XYf_RGBAub_Sf);
+		lua_Integer maxcount = (lua_Integer) (d->getSize() / recordsize);
+		lua_Integer count = luaL_optinteger(L, 2, maxcount);
+
+		if (count < 0 || count > maxcount)
+			return luaL_error(L, "Invalid point count: %d (the Data holds %d %d-byte points)", (int) count, (int) maxcount, (int) recordsize);
+
+		if (count > 0)
+		{
+			const auto *points = (const vertex::XYf_RGBAub_Sf *) d->getData();
+			luax_catchexcept(L, [&](){ instance()->points(points, (size_t) count); });
+		}
+
+		return 0;
+	}
 
 	int args = lua_gettop(L);
 	bool is_table = false;
@@ -2624,6 +3704,19 @@ int w_line(lua_State *L)
 	return 0;
 }
 
+int w_bezier(lua_State *L)
+{
+	std::vector<love::math::BezierCurve *> curves;
+	love::math::luax_checkbeziercurves(L, 1, curves);
+	double tolerance = luaL_optnumber(L, 2, 0.25);
+
+	luax_catchexcept(L,
+		[&](){ instance()->bezier(curves.data(), curves.size(), tolerance); }
+	);
+
+	return 0;
+}
+
 int w_rectangle(lua_State *L)
 {
 	Graphics::DrawMode mode;
@@ -2796,6 +3889,57 @@ int w_flushBatch(lua_State *)
 	return 0;
 }
 
+int w_updateParticleSystems(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	float dt = (float) luaL_checknumber(L, 2);
+
+	int len = (int) luax_objlen(L, 1);
+	std::vector<ParticleSystem *> systems;
+	systems.reserve(len);
+
+	for (int i = 1; i <= len; i++)
+	{
+		lua_rawgeti(L, 1, i);
+		systems.push_back(luax_checkparticlesystem(L, -1));
+		lua_pop(L, 1);
+	}
+
+	luax_catchexcept(L, [&](){ ParticleSystem::updateBatch(systems, dt); });
+	return 0;
+}
+
+int w_beginDeferredDraws(lua_State *L)
+{
+	bool batchstencil = luax_optboolean(L, 1, false);
+	luax_catchexcept(L, [&](){ instance()->beginDeferredDraws(batchstencil); });
+	return 0;
+}
+
+int w_endDeferredDraws(lua_State *L)
+{
+	luax_catchexcept(L, [&](){ instance()->endDeferredDraws(); });
+	return 0;
+}
+
+int w_isDeferringDraws(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isDeferringDraws());
+	return 1;
+}
+
+int w_setDeferredLayer(lua_State *L)
+{
+	instance()->setDeferredLayer((int) luaL_checkinteger(L, 1));
+	return 0;
+}
+
+int w_getDeferredLayer(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getDeferredLayer());
+	return 1;
+}
+
 int w_getStackDepth(lua_State *L)
 {
 	lua_pushnumber(L, instance()->getStackDepth());
@@ -2899,6 +4043,93 @@ int w_inverseTransformPoint(lua_State *L)
 	return 2;
 }
 
+// C functions in a struct, necessary for the FFI versions of the most used
+// graphics functions. They return false instead of raising errors, in which
+// case the Lua C API versions are called to raise them.
+struct FFI_Graphics
+{
+	void (*setColor)(float r, float g, float b, float a);
+	bool (*rectangle)(bool fill, float x, float y, float w, float h);
+	bool (*draw)(Proxy *p, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+	bool (*drawQuad)(Proxy *p, Proxy *q, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+	bool (*drawFrame)(Proxy *p, Proxy *q, int frame, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+};
+
+static FFI_Graphics ffifuncs =
+{
+	[](float r, float g, float b, float a) // setColor
+	{
+		instance()->setColor(Colorf(r, g, b, a));
+	},
+
+	[](bool fill, float x, float y, float w, float h) -> bool // rectangle
+	{
+		try
+		{
+			instance()->rectangle(fill ? Graphics::DRAW_FILL : Graphics::DRAW_LINE, x, y, w, h);
+		}
+		catch (love::Exception &)
+		{
+			return false;
+		}
+		return true;
+	},
+
+	[](Proxy *p, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky) -> bool // draw
+	{
+		if (p == nullptr || p->object == nullptr || p->type == nullptr || !p->type->isa(Drawable::type))
+			return false;
+
+		try
+		{
+			instance()->draw((Drawable *) p->object, Matrix4(x, y, a, sx, sy, ox, oy, kx, ky));
+		}
+		catch (love::Exception &)
+		{
+			return false;
+		}
+		return true;
+	},
+
+	[](Proxy *p, Proxy *q, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky) -> bool // drawQuad
+	{
+		if (p == nullptr || p->object == nullptr || p->type == nullptr || !p->type->isa(Texture::type))
+			return false;
+
+		// Transforms are also userdata, and are handled by the Lua C API version.
+		if (q == nullptr || q->object == nullptr || q->type == nullptr || !q->type->isa(Quad::type))
+			return false;
+
+		try
+		{
+			instance()->draw((Texture *) p->object, (Quad *) q->object, Matrix4(x, y, a, sx, sy, ox, oy, kx, ky));
+		}
+		catch (love::Exception &)
+		{
+			return false;
+		}
+		return true;
+	},
+
+	[](Proxy *p, Proxy *q, int frame, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky) -> bool // drawFrame
+	{
+		if (p == nullptr || p->object == nullptr || p->type == nullptr || !p->type->isa(Texture::type))
+			return false;
+
+		if (q == nullptr || q->object == nullptr || q->type == nullptr || !q->type->isa(QuadAtlas::type))
+			return false;
+
+		try
+		{
+			instance()->draw((Texture *) p->object, (QuadAtlas *) q->object, frame - 1, Matrix4(x, y, a, sx, sy, ox, oy, kx, ky));
+		}
+		catch (love::Exception &)
+		{
+			return false;
+		}
+		return true;
+	},
+};
 
 // List of functions to wrap.
 static const luaL_Reg functions[] =
@@ -2909,17 +4140,36 @@ static const luaL_Reg functions[] =
 	{ "present", w_present },
 
 	{ "newImage", w_newImage },
+	{ "newImageAsync", w_newImageAsync },
 	{ "newArrayImage", w_newArrayImage },
 	{ "newVolumeImage", w_newVolumeImage },
 	{ "newCubeImage", w_newCubeImage },
 	{ "newQuad", w_newQuad },
+	{ "newQuadAtlas", w_newQuadAtlas },
 	{ "newFont", w_newFont },
 	{ "newImageFont", w_newImageFont },
+	{ "newDistanceFieldFont", w_newDistanceFieldFont },
 	{ "newSpriteBatch", w_newSpriteBatch },
+	{ "newDrawList", w_newDrawList },
+	{ "newTextureAtlas", w_newTextureAtlas },
+	{ "newTextureArrayBin", w_newTextureArrayBin },
+	{ "newTileLayer", w_newTileLayer },
+	{ "setTextureBinning", w_setTextureBinning },
+	{ "isTextureBinningEnabled", w_isTextureBinningEnabled },
 	{ "newParticleSystem", w_newParticleSystem },
 	{ "newCanvas", w_newCanvas },
+	{ "getPooledCanvas", w_getPooledCanvas },
+	{ "newVideoRecorder", w_newVideoRecorder },
+	{ "newOcclusionQuery", w_newOcclusionQuery },
+	{ "setCanvasPoolLifetime", w_setCanvasPoolLifetime },
+	{ "getCanvasPoolLifetime", w_getCanvasPoolLifetime },
+	{ "clearCanvasPool", w_clearCanvasPool },
 	{ "newShader", w_newShader },
+	{ "newShaderAsync", w_newShaderAsync },
+	{ "newShaderVariants", w_newShaderVariants },
+	{ "newComputeShader", w_newComputeShader },
 	{ "newMesh", w_newMesh },
+	{ "newSkinnedMesh", w_newSkinnedMesh },
 	{ "newText", w_newText },
 	{ "_newVideo", w_newVideo },
 
@@ -2951,6 +4201,17 @@ static const luaL_Reg functions[] =
 	{ "getLineWidth", w_getLineWidth },
 	{ "getLineStyle", w_getLineStyle },
 	{ "getLineJoin", w_getLineJoin },
+	{ "setGPULinesEnabled", w_setGPULinesEnabled },
+	{ "setImageUploadBudget", w_setImageUploadBudget },
+	{ "getImageUploadBudget", w_getImageUploadBudget },
+	{ "setBackgroundUploads", w_setBackgroundUploads },
+	{ "getBackgroundUploads", w_getBackgroundUploads },
+	{ "setTextureStreamingBudget", w_setTextureStreamingBudget },
+	{ "getTextureStreamingBudget", w_getTextureStreamingBudget },
+	{ "setTextureMemoryBudget", w_setTextureMemoryBudget },
+	{ "getTextureMemoryBudget", w_getTextureMemoryBudget },
+	{ "getRestoreProgress", w_getRestoreProgress },
+	{ "isGPULinesEnabled", w_isGPULinesEnabled },
 	{ "setPointSize", w_setPointSize },
 	{ "getPointSize", w_getPointSize },
 	{ "setDepthMode", w_setDepthMode },
@@ -2973,12 +4234,29 @@ static const luaL_Reg functions[] =
 	{ "getSystemLimits", w_getSystemLimits },
 	{ "getTextureTypes", w_getTextureTypes },
 	{ "getStats", w_getStats },
+	{ "getStreamStats", w_getStreamStats },
+	{ "setStreamBufferSizes", w_setStreamBufferSizes },
+	{ "getStreamBufferSizes", w_getStreamBufferSizes },
+	{ "setStreamBufferAutoSizing", w_setStreamBufferAutoSizing },
+	{ "isStreamBufferAutoSizing", w_isStreamBufferAutoSizing },
+	{ "setGPUTimingEnabled", w_setGPUTimingEnabled },
+	{ "isGPUTimingEnabled", w_isGPUTimingEnabled },
+	{ "getGPUTimings", w_getGPUTimings },
+	{ "getFrameTimings", w_getFrameTimings },
+	{ "setMaxFramesInFlight", w_setMaxFramesInFlight },
+	{ "getMaxFramesInFlight", w_getMaxFramesInFlight },
+	{ "setLatencyMode", w_setLatencyMode },
+	{ "getLatencyMode", w_getLatencyMode },
 
 	{ "captureScreenshot", w_captureScreenshot },
 
 	{ "draw", w_draw },
 	{ "drawLayer", w_drawLayer },
 	{ "drawInstanced", w_drawInstanced },
+	{ "drawIndirect", w_drawIndirect },
+	{ "dispatchThreadgroups", w_dispatchThreadgroups },
+	{ "memoryBarrier", w_memoryBarrier },
+	{ "copyTexture", w_copyTexture },
 
 	{ "print", w_print },
 	{ "printf", w_printf },
@@ -3004,6 +4282,7 @@ static const luaL_Reg functions[] =
 
 	{ "points", w_points },
 	{ "line", w_line },
+	{ "bezier", w_bezier },
 	{ "rectangle", w_rectangle },
 	{ "circle", w_circle },
 	{ "ellipse", w_ellipse },
@@ -3011,6 +4290,12 @@ static const luaL_Reg functions[] =
 	{ "polygon", w_polygon },
 
 	{ "flushBatch", w_flushBatch },
+	{ "updateParticleSystems", w_updateParticleSystems },
+	{ "beginDeferredDraws", w_beginDeferredDraws },
+	{ "endDeferredDraws", w_endDeferredDraws },
+	{ "isDeferringDraws", w_isDeferringDraws },
+	{ "setDeferredLayer", w_setDeferredLayer },
+	{ "getDeferredLayer", w_getDeferredLayer },
 
 	{ "getStackDepth", w_getStackDepth },
 	{ "push", w_push },
@@ -3041,11 +4326,22 @@ static const lua_CFunction types[] =
 	luaopen_font,
 	luaopen_image,
 	luaopen_quad,
+	luaopen_quadatlas,
 	luaopen_spritebatch,
+	luaopen_drawlist,
+	luaopen_textureatlas,
+	luaopen_texturearraybin,
+	luaopen_tilelayer,
 	luaopen_particlesystem,
 	luaopen_canvas,
+	luaopen_graphicsreadback,
+	luaopen_videorecorder,
+	luaopen_occlusionquery,
+	luaopen_imageloader,
 	luaopen_shader,
+	luaopen_shadervariants,
 	luaopen_mesh,
+	luaopen_skinnedmesh,
 	luaopen_text,
 	luaopen_video,
 	0
@@ -3070,8 +4366,13 @@ extern "C" int luaopen_love_graphics(lua_State *L)
 
 	int n = luax_register_module(L, w);
 
-	if (luaL_loadbuffer(L, (const char *)graphics_lua, sizeof(graphics_lua), "wrap_Graphics.lua") == 0)
-		lua_call(L, 0, 0);
+	// Execute wrap_Graphics.lua, sending the ffi functions struct pointer as
+	// an argument.
+	if (luax_loadembedded(L, LOVE_EMBEDDED_BYTECODE(graphics_lua), graphics_lua, sizeof(graphics_lua), "wrap_Graphics.lua") == 0)
+	{
+		lua_pushlightuserdata(L, &ffifuncs);
+		lua_call(L, 1, 0);
+	}
 	else
 		lua_error(L);
 
@@ -25,11 +25,22 @@
 #include "wrap_Font.h"
 #include "wrap_Image.h"
 #include "wrap_Quad.h"
+#include "wrap_QuadAtlas.h"
 #include "wrap_SpriteBatch.h"
+#include "wrap_DrawList.h"
+#include "wrap_TextureAtlas.h"
+#include "wrap_TextureArrayBin.h"
+#include "wrap_TileLayer.h"
 #include "wrap_ParticleSystem.h"
 #include "wrap_Canvas.h"
+#include "wrap_GraphicsReadback.h"
+#include "wrap_VideoRecorder.h"
+#include "wrap_OcclusionQuery.h"
+#include "wrap_ImageLoader.h"
 #include "wrap_Shader.h"
+#include "wrap_ShaderVariants.h"
 #include "wrap_Mesh.h"
+#include "wrap_SkinnedMesh.h"
 #include "wrap_Text.h"
 #include "wrap_Video.h"
 #include "Graphics.h"
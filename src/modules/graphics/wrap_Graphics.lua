@@ -22,6 +22,8 @@ misrepresented as being the original software.
 3. This notice may not be removed or altered from any source distribution.
 --]]
 
+local ffifuncspointer = ...
+
 local table_concat = table.concat
 local ipairs = ipairs
 
@@ -69,6 +71,18 @@ GLSL.SYNTAX = [[
 
 -- Uniforms shared by the vertex and pixel shader stages.
 GLSL.UNIFORMS = [[
+#if __VERSION__ >= 300
+// One block shared by every shader, so switching shaders doesn't need the
+// values to be sent again. The layout must match opengl::Shader::BuiltinUniformBlock.
+layout(std140) uniform love_BuiltinUniforms {
+	highp mat4 ViewSpaceFromLocal;
+	highp mat4 ClipSpaceFromView;
+	highp mat4 ClipSpaceFromLocal;
+	highp mat3 ViewNormalFromLocal;
+	highp vec4 love_ScreenSize;
+	highp float love_PointSize;
+};
+#else
 // According to the GLSL ES 1.0 spec, uniform precision must match between stages,
 // but we can't guarantee that highp is always supported in fragment shaders...
 // We *really* don't want to use mediump for these in vertex shaders though.
@@ -77,6 +91,7 @@ uniform LOVE_HIGHP_OR_MEDIUMP mat4 ClipSpaceFromView;
 uniform LOVE_HIGHP_OR_MEDIUMP mat4 ClipSpaceFromLocal;
 uniform LOVE_HIGHP_OR_MEDIUMP mat3 ViewNormalFromLocal;
 uniform LOVE_HIGHP_OR_MEDIUMP vec4 love_ScreenSize;
+#endif
 
 // Compatibility
 #define TransformMatrix ViewSpaceFromLocal
@@ -204,15 +219,15 @@ GLSL.VERTEX = {
 	#endif
 #endif
 
-#ifdef GL_ES
+#if __VERSION__ < 300
 	uniform mediump float love_PointSize;
-#endif]],
+#endif
+
+attribute float VertexPointSize;]],
 
 	FUNCTIONS = [[
 void setPointSize() {
-#ifdef GL_ES
-	gl_PointSize = love_PointSize;
-#endif
+	gl_PointSize = love_PointSize * VertexPointSize;
 }]],
 
 	MAIN = [[
@@ -297,6 +312,33 @@ void main() {
 }]],
 }
 
+GLSL.COMPUTE = {
+	VERSION = {[false]="#version 430 core", [true]="#version 310 es"},
+
+	HEADER = [[
+#ifdef GL_ES
+	precision highp float;
+	precision highp int;
+	precision highp image2D;
+	precision highp image2DArray;
+	precision highp image3D;
+	precision highp imageCube;
+	precision highp iimage2D;
+	precision highp iimage2DArray;
+	precision highp iimage3D;
+	precision highp iimageCube;
+	precision highp uimage2D;
+	precision highp uimage2DArray;
+	precision highp uimage3D;
+	precision highp uimageCube;
+#endif
+
+#define StorageImage image2D
+#define StorageArrayImage image2DArray
+#define StorageVolumeImage image3D
+#define StorageCubeImage imageCube]],
+}
+
 local function getLanguageTarget(code)
 	if not code then return nil end
 	return (code:match("^%s*#pragma language (%w+)")) or "glsl1"
@@ -397,6 +439,21 @@ function love.graphics._shaderCodeToGLSL(gles, arg1, arg2)
 	return vertexcode, pixelcode
 end
 
+function love.graphics._computeCodeToGLSL(gles, code)
+	local lines = {
+		GLSL.COMPUTE.VERSION[gles],
+		"#define COMPUTE COMPUTE",
+		love.graphics.isGammaCorrect() and "#define LOVE_GAMMA_CORRECT 1" or "",
+		GLSL.SYNTAX,
+		GLSL.COMPUTE.HEADER,
+		GLSL.UNIFORMS,
+		GLSL.FUNCTIONS,
+		"#line 1",
+		code,
+	}
+	return table_concat(lines, "\n")
+end
+
 function love.graphics._transformGLSLErrorMessages(message)
 	local compiling = true
 	local shadertype = message:match("Cannot compile (%a+) shader code")
@@ -456,6 +513,158 @@ void effect() {
 uniform ArrayImage MainTex;
 void effect() {
 	love_PixelColor = Texel(MainTex, VaryingTexCoord.xyz) * VaryingColor;
+}]],
+	-- Used by instanced SpriteBatches: VertexPosition is a corner of the unit
+	-- square, and each sprite's transform and texture rectangle are per-instance.
+	instancedvertex = [[
+attribute vec4 InstanceTransform;
+attribute vec2 InstancePosition;
+attribute vec4 InstanceTexRect;
+vec4 position(mat4 clipSpaceFromLocal, vec4 localPosition) {
+	vec2 corner = localPosition.xy;
+	VaryingTexCoord = vec4(mix(InstanceTexRect.xy, InstanceTexRect.zw, corner), 0.0, 0.0);
+	vec2 pos = InstancePosition + mat2(InstanceTransform.xy, InstanceTransform.zw) * corner;
+	return clipSpaceFromLocal * vec4(pos, 0.0, 1.0);
+}]],
+	-- Used by GPU-simulated ParticleSystems: each instance is one particle
+	-- slot, whose simulated state and spawn parameters are per-instance.
+	-- Appearance over the particle's lifetime is computed here.
+	gpuparticlevertex = [[
+attribute vec4 ParticlePositionVelocity;
+attribute vec2 ParticleLifeRotation;
+attribute float ParticleLifetime;
+attribute vec2 ParticleSizeVariation;
+uniform float love_ParticleSizes[8];
+uniform vec4 love_ParticleColors[8];
+uniform vec4 love_ParticleQuadTexCoords[32];
+uniform vec2 love_ParticleQuadSizes[32];
+uniform vec4 love_ParticleParams;
+uniform vec2 love_ParticleOffset;
+vec4 position(mat4 clipSpaceFromLocal, vec4 localPosition) {
+	float life = ParticleLifeRotation.x;
+	if (life <= 0.0) {
+		// Dead slots end up outside the clip volume.
+		return vec4(2.0, 2.0, 2.0, 1.0);
+	}
+	float t = 1.0 - life / ParticleLifetime;
+
+	float last = love_ParticleParams.x - 1.0;
+	float s = (ParticleSizeVariation.x + t * ParticleSizeVariation.y) * last;
+	float i = clamp(floor(s), 0.0, last);
+	float size = mix(love_ParticleSizes[int(i)], love_ParticleSizes[int(min(i + 1.0, last))], s - i);
+
+	last = love_ParticleParams.y - 1.0;
+	s = t * last;
+	i = clamp(floor(s), 0.0, last);
+	vec4 color = mix(love_ParticleColors[int(i)], love_ParticleColors[int(min(i + 1.0, last))], s - i);
+	VaryingColor = gammaCorrectColor(color) * ConstantColor;
+
+	int quad = int(clamp(floor(t * love_ParticleParams.z), 0.0, love_ParticleParams.z - 1.0));
+	vec2 corner = localPosition.xy;
+	vec4 texrect = love_ParticleQuadTexCoords[quad];
+	VaryingTexCoord = vec4(mix(texrect.xy, texrect.zw, corner), 0.0, 0.0);
+
+	float angle = ParticleLifeRotation.y;
+	if (love_ParticleParams.w > 0.0)
+		angle += atan(ParticlePositionVelocity.w, ParticlePositionVelocity.z);
+	float c = cos(angle);
+	float sn = sin(angle);
+	vec2 local = (corner * love_ParticleQuadSizes[quad] - love_ParticleOffset) * size;
+	vec2 pos = ParticlePositionVelocity.xy + vec2(c * local.x - sn * local.y, sn * local.x + c * local.y);
+	return clipSpaceFromLocal * vec4(pos, 0.0, 1.0);
+}]],
+	-- Used by the GPU line path: each instance is one line segment, and
+	-- VertexPosition is a corner of the quads it's expanded into (see
+	-- Graphics::createLineCornerBuffer). LineSegmentA holds the previous point
+	-- and the segment's start, LineSegmentB its end and the next point.
+	linevertex = [[
+attribute vec4 LineSegmentA;
+attribute vec4 LineSegmentB;
+attribute vec2 LineParams;
+vec2 lineJoinOffset(vec2 dir, vec2 normal, vec2 from, vec2 to, float width) {
+	// Miter join with the neighbouring segment, unless there's none or the
+	// two are (nearly) parallel.
+	vec2 d = to - from;
+	if (dot(d, d) > 0.0) {
+		d = normalize(d);
+		if (abs(dir.x * d.y - dir.y * d.x) > 0.001) {
+			vec2 miter = normalize(normal + vec2(-d.y, d.x));
+			return miter * (width / dot(miter, normal));
+		}
+	}
+	return normal * width;
+}
+vec4 position(mat4 clipSpaceFromLocal, vec4 localPosition) {
+	vec2 start = LineSegmentA.zw;
+	vec2 end = LineSegmentB.xy;
+	vec2 dir = end - start;
+	if (dot(dir, dir) == 0.0) {
+		// Zero-length segments end up outside the clip volume.
+		return vec4(2.0, 2.0, 2.0, 1.0);
+	}
+	dir = normalize(dir);
+	vec2 normal = vec2(-dir.y, dir.x);
+
+	float side = localPosition.y;
+	bool fringe = abs(side) > 1.5;
+	float width = LineParams.x + (fringe ? LineParams.y : 0.0);
+
+	vec2 pos;
+	if (localPosition.x < 0.5) {
+		pos = start + sign(side) * lineJoinOffset(dir, normal, LineSegmentA.xy, start, width);
+		if (fringe && LineSegmentA.xy == start)
+			pos -= dir * LineParams.y;
+	} else {
+		pos = end + sign(side) * lineJoinOffset(dir, normal, end, LineSegmentB.zw, width);
+		if (fringe && LineSegmentB.zw == end)
+			pos += dir * LineParams.y;
+	}
+
+	VaryingColor.a *= localPosition.z;
+	return clipSpaceFromLocal * vec4(pos, 0.0, 1.0);
+}]],
+	-- Used by Graphics::drawInstancedGlyphs: VertexPosition is a corner of the
+	-- unit square, and each glyph's rectangle and texture rectangle (min and
+	-- max corners) are per-instance.
+	instancedglyphvertex = [[
+attribute vec4 GlyphRect;
+attribute vec4 GlyphTexRect;
+vec4 position(mat4 clipSpaceFromLocal, vec4 localPosition) {
+	vec2 corner = localPosition.xy;
+	VaryingTexCoord = vec4(mix(GlyphTexRect.xy, GlyphTexRect.zw, corner), 0.0, 0.0);
+	return clipSpaceFromLocal * vec4(mix(GlyphRect.xy, GlyphRect.zw, corner), 0.0, 1.0);
+}]],
+	-- Used by SkinnedMeshes: each vertex is moved by up to four bones, whose
+	-- 2D affine transforms are two rows each in love_BoneTransforms (see
+	-- SkinnedMesh::MAX_BONES). The byte bone indices are normalized to [0, 1].
+	skinnedvertex = [[
+attribute vec4 VertexBoneIndices;
+attribute vec4 VertexBoneWeights;
+uniform vec4 love_BoneTransforms[96];
+vec2 love_transformByBone(float index, vec3 p) {
+	int i = int(min(index * 255.0 + 0.5, 47.0)) * 2;
+	return vec2(dot(love_BoneTransforms[i].xyz, p), dot(love_BoneTransforms[i + 1].xyz, p));
+}
+vec4 position(mat4 clipSpaceFromLocal, vec4 localPosition) {
+	vec3 p = vec3(localPosition.xy, 1.0);
+	vec2 pos = love_transformByBone(VertexBoneIndices.x, p) * VertexBoneWeights.x
+		+ love_transformByBone(VertexBoneIndices.y, p) * VertexBoneWeights.y
+		+ love_transformByBone(VertexBoneIndices.z, p) * VertexBoneWeights.z
+		+ love_transformByBone(VertexBoneIndices.w, p) * VertexBoneWeights.w;
+	return clipSpaceFromLocal * vec4(pos, 0.0, 1.0);
+}]],
+	-- Used by distance field Fonts: the glyph texture's alpha is a signed
+	-- distance to the outline, which is at 0.5.
+	distancefieldpixel = [[
+vec4 effect(vec4 vcolor, Image tex, vec2 texcoord, vec2 pixcoord) {
+	float dist = Texel(tex, texcoord).a;
+#if !defined(GL_ES) || __VERSION__ >= 300 || defined(GL_OES_standard_derivatives)
+	float width = 0.5 * fwidth(dist);
+#else
+	float width = 0.1;
+#endif
+	float alpha = smoothstep(0.5 - width, 0.5 + width, dist);
+	return vec4(vcolor.rgb, vcolor.a * alpha);
 }]],
 }
 
@@ -477,6 +686,12 @@ for lang, info in pairs(langs) do
 			pixel = createShaderStageCode("PIXEL", defaultcode.pixel, info.target, info.gles, false, gammacorrect, false),
 			videopixel = createShaderStageCode("PIXEL", defaultcode.videopixel, info.target, info.gles, false, gammacorrect, true),
 			arraypixel = createShaderStageCode("PIXEL", defaultcode.arraypixel, info.target, info.gles, false, gammacorrect, true),
+			instancedvertex = createShaderStageCode("VERTEX", defaultcode.instancedvertex, info.target, info.gles, false, gammacorrect),
+			gpuparticlevertex = createShaderStageCode("VERTEX", defaultcode.gpuparticlevertex, info.target, info.gles, false, gammacorrect),
+			linevertex = createShaderStageCode("VERTEX", defaultcode.linevertex, info.target, info.gles, false, gammacorrect),
+			instancedglyphvertex = createShaderStageCode("VERTEX", defaultcode.instancedglyphvertex, info.target, info.gles, false, gammacorrect),
+			distancefieldpixel = createShaderStageCode("PIXEL", defaultcode.distancefieldpixel, info.target, info.gles, false, gammacorrect, false),
+			skinnedvertex = createShaderStageCode("VERTEX", defaultcode.skinnedvertex, info.target, info.gles, false, gammacorrect),
 		}
 	end
 end
@@ -509,5 +724,105 @@ function love.graphics.newVideo(file, settings)
 	return video
 end
 
+
+-- Everything below this point is efficient FFI replacements for the graphics
+-- functions called most often per frame. Calls they don't handle, such as
+-- ones using Transform objects or tables of colors, or ones which fail, go
+-- through the regular functions instead, which also raise any errors.
+
+if type(jit) ~= "table" or not jit.status() then
+	-- LuaJIT's FFI is *much* slower than LOVE's regular methods when the JIT
+	-- compiler is disabled.
+	return
+end
+
+local status, ffi = pcall(require, "ffi")
+if not status then return end
+
+pcall(ffi.cdef, [[
+typedef struct Proxy Proxy;
+
+typedef struct FFI_Graphics
+{
+	void (*setColor)(float r, float g, float b, float a);
+	bool (*rectangle)(bool fill, float x, float y, float w, float h);
+	bool (*draw)(Proxy *p, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+	bool (*drawQuad)(Proxy *p, Proxy *q, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+	bool (*drawFrame)(Proxy *p, Proxy *q, int frame, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+} FFI_Graphics;
+]])
+
+local ffifuncs = ffi.cast("FFI_Graphics *", ffifuncspointer)
+
+local floor = math.floor
+
+local function isoptnumber(v)
+	return v == nil or type(v) == "number"
+end
+
+local function isstandardtransform(x, y, a, sx, sy, ox, oy, kx, ky)
+	return isoptnumber(x) and isoptnumber(y) and isoptnumber(a)
+		and isoptnumber(sx) and isoptnumber(sy) and isoptnumber(ox)
+		and isoptnumber(oy) and isoptnumber(kx) and isoptnumber(ky)
+end
+
+local setColor_C = love.graphics.setColor
+
+function love.graphics.setColor(r, g, b, a)
+	if type(r) == "number" and type(g) == "number" and type(b) == "number" and isoptnumber(a) then
+		ffifuncs.setColor(r, g, b, a == nil and 1 or a)
+	else
+		setColor_C(r, g, b, a)
+	end
+end
+
+local rectangle_C = love.graphics.rectangle
+
+function love.graphics.rectangle(mode, x, y, w, h, rx, ry, segments)
+	if rx == nil and (mode == "fill" or mode == "line")
+		and type(x) == "number" and type(y) == "number"
+		and type(w) == "number" and type(h) == "number" then
+		if ffifuncs.rectangle(mode == "fill", x, y, w, h) then return end
+	end
+
+	return rectangle_C(mode, x, y, w, h, rx, ry, segments)
+end
+
+local draw_C = love.graphics.draw
+
+function love.graphics.draw(drawable, x, y, a, sx, sy, ox, oy, kx, ky, quadky, frameky)
+	if type(drawable) == "userdata" then
+		if type(x) == "userdata" then
+			-- draw(texture, quad, x, y, a, sx, sy, ox, oy, kx, ky), or a Transform.
+			local qx, qy, qa, qsx, qsy, qox, qoy, qkx, qky = y, a, sx, sy, ox, oy, kx, ky, quadky
+			if isstandardtransform(qx, qy, qa, qsx, qsy, qox, qoy, qkx, qky) then
+				qsx = qsx or 1
+				if ffifuncs.drawQuad(drawable, x, qx or 0, qy or 0, qa or 0, qsx, qsy or qsx, qox or 0, qoy or 0, qkx or 0, qky or 0) then
+					return
+				end
+			end
+
+			-- draw(texture, quadatlas, frame, x, y, a, sx, sy, ox, oy, kx, ky)
+			if type(y) == "number" and y == floor(y) then
+				local fx, fy, fa, fsx, fsy, fox, foy, fkx, fky = a, sx, sy, ox, oy, kx, ky, quadky, frameky
+				if isstandardtransform(fx, fy, fa, fsx, fsy, fox, foy, fkx, fky) then
+					fsx = fsx or 1
+					if ffifuncs.drawFrame(drawable, x, y, fx or 0, fy or 0, fa or 0, fsx, fsy or fsx, fox or 0, foy or 0, fkx or 0, fky or 0) then
+						return
+					end
+				end
+			end
+		-- A nil followed by more arguments is a missing Quad, which is an error.
+		elseif (x ~= nil or y == nil) and isstandardtransform(x, y, a, sx, sy, ox, oy, kx, ky) then
+			local dsx = sx or 1
+			if ffifuncs.draw(drawable, x or 0, y or 0, a or 0, dsx, sy or dsx, ox or 0, oy or 0, kx or 0, ky or 0) then
+				return
+			end
+		end
+	end
+
+	return draw_C(drawable, x, y, a, sx, sy, ox, oy, kx, ky, quadky, frameky)
+end
+
 -- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
 --)luastring"--"
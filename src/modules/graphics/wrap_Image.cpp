@@ -20,6 +20,10 @@
 
 // LOVE
 #include "wrap_Image.h"
+#include "common/Reference.h"
+
+// C++
+#include <memory>
 
 namespace love
 {
@@ -74,11 +78,163 @@ int w_Image_replacePixels(lua_State *L)
 	return 0;
 }
 
+int w_Image_markDirty(lua_State *L)
+{
+	Image *i = luax_checkimage(L, 1);
+
+	Rect rect;
+	rect.x = (int) luaL_checkinteger(L, 2);
+	rect.y = (int) luaL_checkinteger(L, 3);
+	rect.w = (int) luaL_checkinteger(L, 4);
+	rect.h = (int) luaL_checkinteger(L, 5);
+
+	int slice = (int) luaL_optinteger(L, 6, 1) - 1;
+	int mipmap = (int) luaL_optinteger(L, 7, 1) - 1;
+
+	luax_catchexcept(L, [&](){ i->markDirty(slice, mipmap, rect); });
+	return 0;
+}
+
+int w_Image_isDynamic(lua_State *L)
+{
+	Image *i = luax_checkimage(L, 1);
+	luax_pushboolean(L, i->isDynamic());
+	return 1;
+}
+
+int w_Image_isDataRetained(lua_State *L)
+{
+	Image *i = luax_checkimage(L, 1);
+	luax_pushboolean(L, i->isDataRetained());
+	return 1;
+}
+
+int w_Image_setReloadCallback(lua_State *L)
+{
+	Image *i = luax_checkimage(L, 1);
+
+	if (lua_isnoneornil(L, 2))
+	{
+		i->setReloadFunction(nullptr);
+		return 0;
+	}
+
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+	lua_pushvalue(L, 2);
+
+	std::shared_ptr<Reference> callback = std::make_shared<Reference>(L);
+	lua_State *pinnedL = luax_getpinnedthread(L);
+
+	// The callback returns the ImageData or CompressedImageData to reload the
+	// Image with.
+	i->setReloadFunction([callback, pinnedL](Image::Slices &slices)
+	{
+		callback->push(pinnedL);
+
+		if (lua_pcall(pinnedL, 0, 1, 0) != 0)
+		{
+			std::string err = lua_isstring(pinnedL, -1) ? lua_tostring(pinnedL, -1) : "";
+			lua_pop(pinnedL, 1);
+			throw love::Exception("Error in Image reload callback: %s", err.c_str());
+		}
+
+		if (luax_istype(pinnedL, -1, love::image::ImageData::type))
+			slices.set(0, 0, luax_totype<love::image::ImageData>(pinnedL, -1));
+		else if (luax_istype(pinnedL, -1, love::image::CompressedImageData::type))
+			slices.add(luax_totype<love::image::CompressedImageData>(pinnedL, -1), 0, 0, false, true);
+
+		lua_pop(pinnedL, 1);
+	});
+
+	return 0;
+}
+
+int w_Image_isStreaming(lua_State *L)
+{
+	Image *i = luax_checkimage(L, 1);
+	luax_pushboolean(L, i->isStreaming());
+	return 1;
+}
+
+int w_Image_setRequestedMipmap(lua_State *L)
+{
+	Image *i = luax_checkimage(L, 1);
+	int mipmap = (int) luaL_checkinteger(L, 2) - 1;
+	luax_catchexcept(L, [&](){ i->setRequestedMipmap(mipmap); });
+	return 0;
+}
+
+int w_Image_getRequestedMipmap(lua_State *L)
+{
+	Image *i = luax_checkimage(L, 1);
+	lua_pushinteger(L, i->getRequestedMipmap() + 1);
+	return 1;
+}
+
+int w_Image_getResidentMipmap(lua_State *L)
+{
+	Image *i = luax_checkimage(L, 1);
+	lua_pushinteger(L, i->getResidentMipmap() + 1);
+	return 1;
+}
+
+int w_Image_setResidencyPriority(lua_State *L)
+{
+	Image *i = luax_checkimage(L, 1);
+	int priority = (int) luaL_checkinteger(L, 2);
+	i->setResidencyPriority(priority);
+	return 0;
+}
+
+int w_Image_getResidencyPriority(lua_State *L)
+{
+	Image *i = luax_checkimage(L, 1);
+	lua_pushinteger(L, i->getResidencyPriority());
+	return 1;
+}
+
+int w_Image_isResident(lua_State *L)
+{
+	Image *i = luax_checkimage(L, 1);
+	luax_pushboolean(L, i->isResident());
+	return 1;
+}
+
+int w_Image_evict(lua_State *L)
+{
+	Image *i = luax_checkimage(L, 1);
+	bool success = false;
+	luax_catchexcept(L, [&](){ success = i->evict(); });
+	luax_pushboolean(L, success);
+	return 1;
+}
+
+int w_Image_restore(lua_State *L)
+{
+	Image *i = luax_checkimage(L, 1);
+	bool async = luax_optboolean(L, 2, false);
+	luax_catchexcept(L, [&](){ i->restore(async); });
+	return 0;
+}
+
 static const luaL_Reg w_Image_functions[] =
 {
 	{ "isFormatLinear", w_Image_isFormatLinear },
 	{ "isCompressed", w_Image_isCompressed },
 	{ "replacePixels", w_Image_replacePixels },
+	{ "markDirty", w_Image_markDirty },
+	{ "isDynamic", w_Image_isDynamic },
+	{ "isStreaming", w_Image_isStreaming },
+	{ "isDataRetained", w_Image_isDataRetained },
+	{ "setReloadCallback", w_Image_setReloadCallback },
+	{ "setRequestedMipmap", w_Image_setRequestedMipmap },
+	{ "getRequestedMipmap", w_Image_getRequestedMipmap },
+	{ "getResidentMipmap", w_Image_getResidentMipmap },
+	{ "setResidencyPriority", w_Image_setResidencyPriority },
+	{ "getResidencyPriority", w_Image_getResidencyPriority },
+	{ "isResident", w_Image_isResident },
+	{ "evict", w_Image_evict },
+	{ "restore", w_Image_restore },
 	{ 0, 0 }
 };
 
@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_ImageLoader.h"
+
+namespace love
+{
+namespace graphics
+{
+
+ImageLoader *luax_checkimageloader(lua_State *L, int idx)
+{
+	return luax_checktype<ImageLoader>(L, idx);
+}
+
+int w_ImageLoader_isComplete(lua_State *L)
+{
+	ImageLoader *l = luax_checkimageloader(L, 1);
+	bool complete = false;
+	luax_catchexcept(L, [&](){ l->update(0); complete = l->isComplete(); });
+	luax_pushboolean(L, complete);
+	return 1;
+}
+
+int w_ImageLoader_wait(lua_State *L)
+{
+	ImageLoader *l = luax_checkimageloader(L, 1);
+	Image *image = nullptr;
+	luax_catchexcept(L, [&](){ l->wait(); image = l->getImage(); });
+	luax_pushtype(L, image);
+	return 1;
+}
+
+int w_ImageLoader_getImage(lua_State *L)
+{
+	ImageLoader *l = luax_checkimageloader(L, 1);
+	Image *image = nullptr;
+	luax_catchexcept(L, [&](){ l->update(0); image = l->getImage(); });
+
+	if (image != nullptr)
+		luax_pushtype(L, image);
+	else
+		lua_pushnil(L);
+
+	return 1;
+}
+
+static const luaL_Reg w_ImageLoader_functions[] =
+{
+	{ "isComplete", w_ImageLoader_isComplete },
+	{ "wait", w_ImageLoader_wait },
+	{ "getImage", w_ImageLoader_getImage },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_imageloader(lua_State *L)
+{
+	return luax_register_type(L, &ImageLoader::type, w_ImageLoader_functions, nullptr);
+}
+
+} // graphics
+} // love
@@ -23,6 +23,7 @@
 #include "Image.h"
 #include "Canvas.h"
 #include "wrap_Texture.h"
+#include "math/wrap_BezierCurve.h"
 
 // C++
 #include <algorithm>
@@ -296,6 +297,37 @@ int w_Mesh_getVertexAttribute(lua_State *L)
 	return components;
 }
 
+int w_Mesh_setVerticesFromCurves(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+
+	std::vector<love::math::BezierCurve *> curves;
+	love::math::luax_checkbeziercurves(L, 2, curves);
+
+	double tolerance = luaL_optnumber(L, 3, 0.25);
+	size_t vertoffset = (size_t) luaL_optnumber(L, 4, 1) - 1;
+	const char *attribname = luaL_optstring(L, 5, "VertexPosition");
+
+	if (vertoffset >= t->getVertexCount())
+		return luaL_error(L, "Invalid vertex start index (must be between 1 and %d)", (int) t->getVertexCount());
+
+	int attribindex = t->getAttributeIndex(attribname);
+	if (attribindex == -1)
+		return luaL_error(L, "Mesh does not have an attribute named '%s'", attribname);
+
+	std::vector<Vector2> points;
+	std::vector<size_t> chainstarts;
+
+	luax_catchexcept(L, [&]()
+	{
+		love::math::BezierCurve::renderAdaptive(curves.data(), curves.size(), tolerance, points, chainstarts);
+		t->setVertexAttributeXY(vertoffset, attribindex, points.data(), points.size());
+	});
+
+	lua_pushinteger(L, (lua_Integer) points.size());
+	return 1;
+}
+
 int w_Mesh_getVertexCount(lua_State *L)
 {
 	Mesh *t = luax_checkmesh(L, 1);
@@ -388,6 +420,35 @@ int w_Mesh_flush(lua_State *L)
 	return 0;
 }
 
+int w_Mesh_copyVertices(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+	Mesh *dst = luax_checkmesh(L, 2);
+
+	lua_Integer srcstart = luaL_optinteger(L, 3, 1) - 1;
+	lua_Integer dststart = luaL_optinteger(L, 4, 1) - 1;
+
+	if (srcstart < 0 || dststart < 0)
+		return luaL_error(L, "Invalid vertex start index (must be at least 1).");
+
+	lua_Integer srcleft = (lua_Integer) t->getVertexCount() - srcstart;
+	lua_Integer dstleft = (lua_Integer) dst->getVertexCount() - dststart;
+	lua_Integer count = luaL_optinteger(L, 5, std::max<lua_Integer>(std::min(srcleft, dstleft), 0));
+
+	if (count < 0)
+		return luaL_error(L, "Invalid vertex count: %d", (int) count);
+
+	luax_catchexcept(L, [&](){ t->copyVertices(dst, (size_t) srcstart, (size_t) dststart, (size_t) count); });
+	return 0;
+}
+
+int w_Mesh_optimize(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+	luax_catchexcept(L, [&](){ t->optimize(); });
+	return 0;
+}
+
 int w_Mesh_setVertexMap(lua_State *L)
 {
 	Mesh *t = luax_checkmesh(L, 1);
@@ -561,13 +622,14 @@ int w_Mesh_getDrawRange(lua_State *L)
 	return 2;
 }
 
-static const luaL_Reg w_Mesh_functions[] =
+const luaL_Reg w_Mesh_functions[] =
 {
 	{ "setVertices", w_Mesh_setVertices },
 	{ "setVertex", w_Mesh_setVertex },
 	{ "getVertex", w_Mesh_getVertex },
 	{ "setVertexAttribute", w_Mesh_setVertexAttribute },
 	{ "getVertexAttribute", w_Mesh_getVertexAttribute },
+	{ "setVerticesFromCurves", w_Mesh_setVerticesFromCurves },
 	{ "getVertexCount", w_Mesh_getVertexCount },
 	{ "getVertexFormat", w_Mesh_getVertexFormat },
 	{ "setAttributeEnabled", w_Mesh_setAttributeEnabled },
@@ -575,7 +637,9 @@ static const luaL_Reg w_Mesh_functions[] =
 	{ "attachAttribute", w_Mesh_attachAttribute },
 	{ "detachAttribute", w_Mesh_detachAttribute },
 	{ "flush", w_Mesh_flush },
+	{ "copyVertices", w_Mesh_copyVertices },
 	{ "setVertexMap", w_Mesh_setVertexMap },
+	{ "optimize", w_Mesh_optimize },
 	{ "getVertexMap", w_Mesh_getVertexMap },
 	{ "setTexture", w_Mesh_setTexture },
 	{ "getTexture", w_Mesh_getTexture },
@@ -36,5 +36,7 @@ const char *luax_readAttributeData(lua_State *L, vertex::DataType type, int comp
 Mesh *luax_checkmesh(lua_State *L, int idx);
 extern "C" int luaopen_mesh(lua_State *L);
 
+extern const luaL_Reg w_Mesh_functions[];
+
 } // graphics
 } // love
@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_OcclusionQuery.h"
+
+namespace love
+{
+namespace graphics
+{
+
+OcclusionQuery *luax_checkocclusionquery(lua_State *L, int idx)
+{
+	return luax_checktype<OcclusionQuery>(L, idx);
+}
+
+int w_OcclusionQuery_start(lua_State *L)
+{
+	OcclusionQuery *query = luax_checkocclusionquery(L, 1);
+	luax_catchexcept(L, [&](){ query->start(); });
+	return 0;
+}
+
+int w_OcclusionQuery_stop(lua_State *L)
+{
+	OcclusionQuery *query = luax_checkocclusionquery(L, 1);
+	luax_catchexcept(L, [&](){ query->stop(); });
+	return 0;
+}
+
+int w_OcclusionQuery_isActive(lua_State *L)
+{
+	OcclusionQuery *query = luax_checkocclusionquery(L, 1);
+	luax_pushboolean(L, query->isActive());
+	return 1;
+}
+
+int w_OcclusionQuery_isConservative(lua_State *L)
+{
+	OcclusionQuery *query = luax_checkocclusionquery(L, 1);
+	luax_pushboolean(L, query->isConservative());
+	return 1;
+}
+
+int w_OcclusionQuery_getResult(lua_State *L)
+{
+	OcclusionQuery *query = luax_checkocclusionquery(L, 1);
+
+	bool visible = false;
+	int age = 0;
+
+	if (!query->getResult(visible, age))
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+
+	luax_pushboolean(L, visible);
+	lua_pushinteger(L, age);
+	return 2;
+}
+
+static const luaL_Reg w_OcclusionQuery_functions[] =
+{
+	{ "start", w_OcclusionQuery_start },
+	{ "stop", w_OcclusionQuery_stop },
+	{ "isActive", w_OcclusionQuery_isActive },
+	{ "isConservative", w_OcclusionQuery_isConservative },
+	{ "getResult", w_OcclusionQuery_getResult },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_occlusionquery(lua_State *L)
+{
+	return luax_register_type(L, &OcclusionQuery::type, w_OcclusionQuery_functions, nullptr);
+}
+
+} // graphics
+} // love
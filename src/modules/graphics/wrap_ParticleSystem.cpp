@@ -641,6 +641,21 @@ int w_ParticleSystem_hasRelativeRotation(lua_State *L)
 	return 1;
 }
 
+int w_ParticleSystem_setGPUSimulated(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	bool enable = luax_checkboolean(L, 2);
+	luax_catchexcept(L, [&](){ t->setGPUSimulated(enable); });
+	return 0;
+}
+
+int w_ParticleSystem_isGPUSimulated(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	luax_pushboolean(L, t->isGPUSimulated());
+	return 1;
+}
+
 int w_ParticleSystem_getCount(lua_State *L)
 {
 	ParticleSystem *t = luax_checkparticlesystem(L, 1);
@@ -811,6 +826,8 @@ static const luaL_Reg w_ParticleSystem_functions[] =
 	{ "getOffset", w_ParticleSystem_getOffset },
 	{ "setRelativeRotation", w_ParticleSystem_setRelativeRotation },
 	{ "hasRelativeRotation", w_ParticleSystem_hasRelativeRotation },
+	{ "setGPUSimulated", w_ParticleSystem_setGPUSimulated },
+	{ "isGPUSimulated", w_ParticleSystem_isGPUSimulated },
 	{ "getCount", w_ParticleSystem_getCount },
 	{ "start", w_ParticleSystem_start },
 	{ "stop", w_ParticleSystem_stop },
@@ -0,0 +1,149 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_QuadAtlas.h"
+
+namespace love
+{
+namespace graphics
+{
+
+QuadAtlas *luax_checkquadatlas(lua_State *L, int idx)
+{
+	return luax_checktype<QuadAtlas>(L, idx);
+}
+
+static Quad::Viewport w_QuadAtlas_checkViewport(lua_State *L, int idx)
+{
+	Quad::Viewport v;
+	v.x = luaL_checknumber(L, idx + 0);
+	v.y = luaL_checknumber(L, idx + 1);
+	v.w = luaL_checknumber(L, idx + 2);
+	v.h = luaL_checknumber(L, idx + 3);
+	return v;
+}
+
+int w_QuadAtlas_add(lua_State *L)
+{
+	QuadAtlas *atlas = luax_checkquadatlas(L, 1);
+	Quad::Viewport v = w_QuadAtlas_checkViewport(L, 2);
+	int layer = (int) luaL_optinteger(L, 6, 1) - 1;
+
+	lua_pushinteger(L, atlas->add(v, layer) + 1);
+	return 1;
+}
+
+int w_QuadAtlas_addGrid(lua_State *L)
+{
+	QuadAtlas *atlas = luax_checkquadatlas(L, 1);
+	Quad::Viewport v = w_QuadAtlas_checkViewport(L, 2);
+	int columns = (int) luaL_checkinteger(L, 6);
+	int rows = (int) luaL_checkinteger(L, 7);
+	double spacingx = luaL_optnumber(L, 8, 0.0);
+	double spacingy = luaL_optnumber(L, 9, spacingx);
+
+	int first = 0;
+	luax_catchexcept(L, [&](){ first = atlas->addGrid(v.x, v.y, v.w, v.h, columns, rows, spacingx, spacingy); });
+
+	lua_pushinteger(L, first + 1);
+	return 1;
+}
+
+int w_QuadAtlas_set(lua_State *L)
+{
+	QuadAtlas *atlas = luax_checkquadatlas(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+	Quad::Viewport v = w_QuadAtlas_checkViewport(L, 3);
+	int layer = (int) luaL_optinteger(L, 7, 1) - 1;
+
+	luax_catchexcept(L, [&](){ atlas->set(index, v, layer); });
+	return 0;
+}
+
+int w_QuadAtlas_getViewport(lua_State *L)
+{
+	QuadAtlas *atlas = luax_checkquadatlas(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+
+	Quad::Viewport v = {};
+	luax_catchexcept(L, [&](){ v = atlas->getViewport(index); });
+
+	lua_pushnumber(L, v.x);
+	lua_pushnumber(L, v.y);
+	lua_pushnumber(L, v.w);
+	lua_pushnumber(L, v.h);
+	return 4;
+}
+
+int w_QuadAtlas_getLayer(lua_State *L)
+{
+	QuadAtlas *atlas = luax_checkquadatlas(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+
+	int layer = 0;
+	luax_catchexcept(L, [&](){ layer = atlas->getLayer(index); });
+
+	lua_pushinteger(L, layer + 1);
+	return 1;
+}
+
+int w_QuadAtlas_getCount(lua_State *L)
+{
+	QuadAtlas *atlas = luax_checkquadatlas(L, 1);
+	lua_pushinteger(L, atlas->getCount());
+	return 1;
+}
+
+int w_QuadAtlas_clear(lua_State *L)
+{
+	QuadAtlas *atlas = luax_checkquadatlas(L, 1);
+	atlas->clear();
+	return 0;
+}
+
+int w_QuadAtlas_getTextureDimensions(lua_State *L)
+{
+	QuadAtlas *atlas = luax_checkquadatlas(L, 1);
+	lua_pushnumber(L, atlas->getTextureWidth());
+	lua_pushnumber(L, atlas->getTextureHeight());
+	return 2;
+}
+
+static const luaL_Reg w_QuadAtlas_functions[] =
+{
+	{ "add", w_QuadAtlas_add },
+	{ "addGrid", w_QuadAtlas_addGrid },
+	{ "set", w_QuadAtlas_set },
+	{ "getViewport", w_QuadAtlas_getViewport },
+	{ "getLayer", w_QuadAtlas_getLayer },
+	{ "getCount", w_QuadAtlas_getCount },
+	{ "clear", w_QuadAtlas_clear },
+	{ "getTextureDimensions", w_QuadAtlas_getTextureDimensions },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_quadatlas(lua_State *L)
+{
+	return luax_register_type(L, &QuadAtlas::type, w_QuadAtlas_functions, nullptr);
+}
+
+} // graphics
+} // love
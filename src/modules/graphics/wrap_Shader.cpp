@@ -20,6 +20,7 @@
 
 #include "wrap_Shader.h"
 #include "wrap_Texture.h"
+#include "wrap_Mesh.h"
 #include "math/MathModule.h"
 #include "math/Transform.h"
 #include "Graphics.h"
@@ -34,9 +35,48 @@ namespace love
 namespace graphics
 {
 
+// Waits for an async Shader to finish loading, and reports errors the same
+// way love.graphics.newShader does.
+static void finishLoading(lua_State *L, Shader *shader)
+{
+	bool should_error = false;
+	try
+	{
+		shader->finishLoading();
+	}
+	catch (love::Exception &e)
+	{
+		luax_getfunction(L, "graphics", "_transformGLSLErrorMessages");
+		lua_pushstring(L, e.what());
+
+		// Function pushes the new error string onto the stack.
+		lua_pcall(L, 1, 1, 0);
+		should_error = true;
+	}
+
+	if (should_error)
+		lua_error(L);
+}
+
 Shader *luax_checkshader(lua_State *L, int idx)
 {
-	return luax_checktype<Shader>(L, idx);
+	Shader *shader = luax_checktype<Shader>(L, idx);
+	finishLoading(L, shader);
+	return shader;
+}
+
+int w_Shader_isReady(lua_State *L)
+{
+	// Not luax_checkshader, which would block until the Shader is ready.
+	Shader *shader = luax_checktype<Shader>(L, 1);
+	bool ready = shader->isReady();
+
+	// Raises any errors from loading.
+	if (ready)
+		finishLoading(L, shader);
+
+	luax_pushboolean(L, ready);
+	return 1;
 }
 
 int w_Shader_getWarnings(lua_State *L)
@@ -302,6 +342,7 @@ static int w_Shader_sendLuaValues(lua_State *L, int startidx, Shader *shader, co
 	case Shader::UNIFORM_BOOL:
 		return w_Shader_sendBooleans(L, startidx, shader, info);
 	case Shader::UNIFORM_SAMPLER:
+	case Shader::UNIFORM_STORAGE_IMAGE:
 		return w_Shader_sendTextures(L, startidx, shader, info);
 	default:
 		return luaL_error(L, "Unknown variable type for shader uniform '%s", name);
@@ -312,6 +353,8 @@ static int w_Shader_sendData(lua_State *L, int startidx, Shader *shader, const S
 {
 	if (info->baseType == Shader::UNIFORM_SAMPLER)
 		return luaL_error(L, "Uniform sampler values (textures) cannot be sent to Shaders via Data objects.");
+	else if (info->baseType == Shader::UNIFORM_STORAGE_IMAGE)
+		return luaL_error(L, "Storage images cannot be sent to Shaders via Data objects.");
 
 	bool columnmajor = false;
 	if (info->baseType == Shader::UNIFORM_MATRIX && lua_type(L, startidx + 1) == LUA_TSTRING)
@@ -344,9 +387,9 @@ static int w_Shader_sendData(lua_State *L, int startidx, Shader *shader, const S
 			return luaL_error(L, "Size must be greater than 0.");
 		else if ((size_t) datasize > size - offset)
 			return luaL_error(L, "Size and offset must fit within the Data's bounds.");
-		else if (size % uniformstride != 0)
+		else if ((size_t) datasize % uniformstride != 0)
 			return luaL_error(L, "Size must be a multiple of the uniform's size in bytes.");
-		else if (size > info->dataSize)
+		else if ((size_t) datasize > info->dataSize)
 			return luaL_error(L, "Size must not be greater than the uniform's total size in bytes.");
 
 		size = (size_t) datasize;
@@ -447,12 +490,108 @@ int w_Shader_hasUniform(lua_State *L)
 	return 1;
 }
 
+int w_Shader_sendUniformBlock(lua_State *L)
+{
+	Shader *shader = luax_checkshader(L, 1);
+	const char *name = luaL_checkstring(L, 2);
+	Data *data = luax_checktype<Data>(L, 3);
+
+	size_t blocksize = shader->getUniformBlockSize(name);
+	size_t datasize = data->getSize();
+
+	// The Data mirrors the block, so the same range is used in both.
+	ptrdiff_t offset = (ptrdiff_t) luaL_optinteger(L, 4, 0);
+	if (offset < 0)
+		return luaL_error(L, "Offset cannot be negative.");
+	else if ((size_t) offset > datasize)
+		return luaL_error(L, "Offset must not be greater than the size of the Data.");
+
+	size_t size = std::min(datasize, blocksize);
+	size = (size_t) offset < size ? size - offset : 0;
+
+	if (!lua_isnoneornil(L, 5))
+	{
+		lua_Integer s = luaL_checkinteger(L, 5);
+		if (s < 0)
+			return luaL_error(L, "Size cannot be negative.");
+		else if ((size_t) s > datasize - offset)
+			return luaL_error(L, "Size and offset must fit within the Data's bounds.");
+
+		size = (size_t) s;
+	}
+
+	const char *mem = (const char *) data->getData() + offset;
+	luax_catchexcept(L, [&](){ shader->sendUniformBlock(name, mem, (size_t) offset, size); });
+	return 0;
+}
+
+int w_Shader_getUniformBlockSize(lua_State *L)
+{
+	Shader *shader = luax_checkshader(L, 1);
+	const char *name = luaL_checkstring(L, 2);
+
+	size_t size = shader->getUniformBlockSize(name);
+	if (size == 0)
+		lua_pushnil(L);
+	else
+		lua_pushinteger(L, (lua_Integer) size);
+
+	return 1;
+}
+
+int w_Shader_sendBuffer(lua_State *L)
+{
+	Shader *shader = luax_checkshader(L, 1);
+	const char *name = luaL_checkstring(L, 2);
+	Mesh *mesh = lua_isnoneornil(L, 3) ? nullptr : luax_checkmesh(L, 3);
+	luax_catchexcept(L, [&](){ shader->sendBuffer(name, mesh); });
+	return 0;
+}
+
+int w_Shader_hasStorageBlock(lua_State *L)
+{
+	Shader *shader = luax_checkshader(L, 1);
+	const char *name = luaL_checkstring(L, 2);
+	luax_pushboolean(L, shader->hasStorageBlock(name));
+	return 1;
+}
+
+int w_Shader_isCompute(lua_State *L)
+{
+	Shader *shader = luax_checkshader(L, 1);
+	luax_pushboolean(L, shader->isCompute());
+	return 1;
+}
+
+int w_Shader_getLocalThreadgroupSize(lua_State *L)
+{
+	Shader *shader = luax_checkshader(L, 1);
+
+	if (!shader->isCompute())
+		return luaL_error(L, "Only compute shaders have a threadgroup size.");
+
+	int size[3];
+	shader->getLocalThreadgroupSize(size);
+
+	for (int i = 0; i < 3; i++)
+		lua_pushinteger(L, size[i]);
+
+	return 3;
+}
+
 static const luaL_Reg w_Shader_functions[] =
 {
 	{ "getWarnings", w_Shader_getWarnings },
 	{ "send",        w_Shader_send },
 	{ "sendColor",   w_Shader_sendColors },
 	{ "hasUniform",  w_Shader_hasUniform },
+	{ "sendUniformBlock", w_Shader_sendUniformBlock },
+	{ "getUniformBlockSize", w_Shader_getUniformBlockSize },
+	{ "isReady",     w_Shader_isReady },
+	{ "sendBuffer",  w_Shader_sendBuffer },
+	{ "hasStorageBlock", w_Shader_hasStorageBlock },
+	{ "isCompute",   w_Shader_isCompute },
+	{ "getLocalThreadgroupSize", w_Shader_getLocalThreadgroupSize },
 	{ 0, 0 }
 };
 
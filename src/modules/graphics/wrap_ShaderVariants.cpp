@@ -0,0 +1,151 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_ShaderVariants.h"
+
+namespace love
+{
+namespace graphics
+{
+
+ShaderVariants *luax_checkshadervariants(lua_State *L, int idx)
+{
+	return luax_checktype<ShaderVariants>(L, idx);
+}
+
+// Keys are given either as a table of names, or as the remaining arguments.
+static ShaderVariants::Mask w_ShaderVariants_checkMask(lua_State *L, int startidx, ShaderVariants *variants)
+{
+	std::vector<std::string> names;
+
+	if (lua_istable(L, startidx))
+	{
+		int n = (int) luax_objlen(L, startidx);
+		for (int i = 1; i <= n; i++)
+		{
+			lua_rawgeti(L, startidx, i);
+			names.push_back(luax_checkstring(L, -1));
+			lua_pop(L, 1);
+		}
+	}
+	else
+	{
+		for (int i = startidx; i <= lua_gettop(L); i++)
+			names.push_back(luax_checkstring(L, i));
+	}
+
+	ShaderVariants::Mask mask = 0;
+	luax_catchexcept(L, [&](){ mask = variants->getMask(names); });
+	return mask;
+}
+
+int w_ShaderVariants_getShader(lua_State *L)
+{
+	ShaderVariants *variants = luax_checkshadervariants(L, 1);
+	ShaderVariants::Mask mask = w_ShaderVariants_checkMask(L, 2, variants);
+
+	Shader *shader = nullptr;
+	bool should_error = false;
+
+	try
+	{
+		shader = variants->getShader(mask);
+	}
+	catch (love::Exception &e)
+	{
+		luax_getfunction(L, "graphics", "_transformGLSLErrorMessages");
+		lua_pushstring(L, e.what());
+
+		// Function pushes the new error string onto the stack.
+		lua_pcall(L, 1, 1, 0);
+		should_error = true;
+	}
+
+	if (should_error)
+		return lua_error(L);
+
+	luax_pushtype(L, shader);
+	return 1;
+}
+
+int w_ShaderVariants_precompile(lua_State *L)
+{
+	ShaderVariants *variants = luax_checkshadervariants(L, 1);
+	ShaderVariants::Mask mask = w_ShaderVariants_checkMask(L, 2, variants);
+	luax_catchexcept(L, [&](){ variants->precompile(mask); });
+	return 0;
+}
+
+int w_ShaderVariants_isCached(lua_State *L)
+{
+	ShaderVariants *variants = luax_checkshadervariants(L, 1);
+	ShaderVariants::Mask mask = w_ShaderVariants_checkMask(L, 2, variants);
+	luax_pushboolean(L, variants->isCached(mask));
+	return 1;
+}
+
+int w_ShaderVariants_getCachedCount(lua_State *L)
+{
+	ShaderVariants *variants = luax_checkshadervariants(L, 1);
+	lua_pushinteger(L, variants->getCachedCount());
+	return 1;
+}
+
+int w_ShaderVariants_getKeys(lua_State *L)
+{
+	ShaderVariants *variants = luax_checkshadervariants(L, 1);
+	const std::vector<std::string> &keys = variants->getKeys();
+
+	lua_createtable(L, (int) keys.size(), 0);
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		luax_pushstring(L, keys[i]);
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	return 1;
+}
+
+int w_ShaderVariants_clear(lua_State *L)
+{
+	ShaderVariants *variants = luax_checkshadervariants(L, 1);
+	variants->clear();
+	return 0;
+}
+
+static const luaL_Reg w_ShaderVariants_functions[] =
+{
+	{ "getShader", w_ShaderVariants_getShader },
+	{ "precompile", w_ShaderVariants_precompile },
+	{ "isCached", w_ShaderVariants_isCached },
+	{ "getCachedCount", w_ShaderVariants_getCachedCount },
+	{ "getKeys", w_ShaderVariants_getKeys },
+	{ "clear", w_ShaderVariants_clear },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_shadervariants(lua_State *L)
+{
+	return luax_register_type(L, &ShaderVariants::type, w_ShaderVariants_functions, nullptr);
+}
+
+} // graphics
+} // love
@@ -0,0 +1,136 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_SkinnedMesh.h"
+#include "wrap_Mesh.h"
+#include "math/wrap_Transform.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+SkinnedMesh *luax_checkskinnedmesh(lua_State *L, int idx)
+{
+	return luax_checktype<SkinnedMesh>(L, idx);
+}
+
+int w_SkinnedMesh_setBoneTransforms(lua_State *L)
+{
+	SkinnedMesh *t = luax_checkskinnedmesh(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+	int start = (int) luaL_optinteger(L, 3, 1) - 1;
+
+	int len = (int) luax_objlen(L, 2);
+	std::vector<float> transforms;
+
+	lua_rawgeti(L, 2, 1);
+	bool usetransforms = luax_istype(L, -1, love::math::Transform::type);
+	lua_pop(L, 1);
+
+	if (usetransforms)
+	{
+		// {transform, ...}
+		transforms.resize(len * 6);
+
+		for (int i = 0; i < len; i++)
+		{
+			lua_rawgeti(L, 2, i + 1);
+			const float *e = love::math::luax_checktransform(L, -1)->getMatrix().getElements();
+			lua_pop(L, 1);
+
+			// The elements are column-major.
+			float *bone = &transforms[i * 6];
+			bone[0] = e[0];
+			bone[1] = e[4];
+			bone[2] = e[12];
+			bone[3] = e[1];
+			bone[4] = e[5];
+			bone[5] = e[13];
+		}
+	}
+	else
+	{
+		// {a, b, tx, c, d, ty, ...}
+		if (len % 6 != 0)
+			return luaL_error(L, "Bone transform tables must have 6 numbers per bone.");
+
+		transforms.resize(len);
+
+		for (int i = 0; i < len; i++)
+		{
+			lua_rawgeti(L, 2, i + 1);
+			transforms[i] = (float) luaL_checknumber(L, -1);
+			lua_pop(L, 1);
+		}
+	}
+
+	int count = (int) transforms.size() / 6;
+	luax_catchexcept(L, [&](){ t->setBoneTransforms(start, transforms.data(), count); });
+	return 0;
+}
+
+int w_SkinnedMesh_getBoneTransform(lua_State *L)
+{
+	SkinnedMesh *t = luax_checkskinnedmesh(L, 1);
+	int bone = (int) luaL_checkinteger(L, 2) - 1;
+
+	float transform[6];
+	luax_catchexcept(L, [&](){ t->getBoneTransform(bone, transform); });
+
+	for (int i = 0; i < 6; i++)
+		lua_pushnumber(L, transform[i]);
+
+	return 6;
+}
+
+int w_SkinnedMesh_getBoneCount(lua_State *L)
+{
+	SkinnedMesh *t = luax_checkskinnedmesh(L, 1);
+	lua_pushinteger(L, t->getBoneCount());
+	return 1;
+}
+
+int w_SkinnedMesh_getMaxBones(lua_State *L)
+{
+	luax_checkskinnedmesh(L, 1);
+	lua_pushinteger(L, SkinnedMesh::MAX_BONES);
+	return 1;
+}
+
+static const luaL_Reg w_SkinnedMesh_functions[] =
+{
+	{ "setBoneTransforms", w_SkinnedMesh_setBoneTransforms },
+	{ "getBoneTransform", w_SkinnedMesh_getBoneTransform },
+	{ "getBoneCount", w_SkinnedMesh_getBoneCount },
+	{ "getMaxBones", w_SkinnedMesh_getMaxBones },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_skinnedmesh(lua_State *L)
+{
+	return luax_register_type(L, &SkinnedMesh::type, w_Mesh_functions, w_SkinnedMesh_functions, nullptr);
+}
+
+} // graphics
+} // love
@@ -23,6 +23,21 @@
 #include "Image.h"
 #include "Canvas.h"
 #include "wrap_Texture.h"
+#include "wrap_Quad.h"
+#include "wrap_QuadAtlas.h"
+#include "common/Data.h"
+
+// C++
+#include <vector>
+
+// Shove the wrap_SpriteBatch.lua code directly into a raw string literal.
+static const char spritebatch_lua[] =
+#include "wrap_SpriteBatch.lua"
+;
+
+#ifdef LOVE_PRECOMPILED_LUA
+#include "luabytecode/spritebatch_lua.h"
+#endif
 
 namespace love
 {
@@ -37,12 +52,20 @@ SpriteBatch *luax_checkspritebatch(lua_State *L, int idx)
 static inline int w_SpriteBatch_add_or_set(lua_State *L, SpriteBatch *t, int startidx, int index)
 {
 	Quad *quad = nullptr;
+	QuadAtlas *atlas = nullptr;
+	int frame = 0;
 
 	if (luax_istype(L, startidx, Quad::type))
 	{
 		quad = luax_totype<Quad>(L, startidx);
 		startidx++;
 	}
+	else if (luax_istype(L, startidx, QuadAtlas::type))
+	{
+		atlas = luax_totype<QuadAtlas>(L, startidx);
+		frame = (int) luaL_checkinteger(L, startidx + 1) - 1;
+		startidx += 2;
+	}
 	else if (lua_isnil(L, startidx) && !lua_isnoneornil(L, startidx + 1))
 		return luax_typerror(L, startidx, "Quad");
 
@@ -52,6 +75,8 @@ static inline int w_SpriteBatch_add_or_set(lua_State *L, SpriteBatch *t, int sta
 		{
 			if (quad)
 				index = t->add(quad, m, index);
+			else if (atlas)
+				index = t->add(atlas, frame, m, index);
 			else
 				index = t->add(m, index);
 		});
@@ -63,6 +88,8 @@ static inline int w_SpriteBatch_add_or_set(lua_State *L, SpriteBatch *t, int sta
 static int w_SpriteBatch_addLayer_or_setLayer(lua_State *L, SpriteBatch *t, int startidx, int index)
 {
 	Quad *quad = nullptr;
+	QuadAtlas *atlas = nullptr;
+	int frame = 0;
 	int layer = (int) luaL_checkinteger(L, startidx) - 1;
 	startidx++;
 
@@ -71,6 +98,12 @@ static int w_SpriteBatch_addLayer_or_setLayer(lua_State *L, SpriteBatch *t, int
 		quad = luax_totype<Quad>(L, startidx);
 		startidx++;
 	}
+	else if (luax_istype(L, startidx, QuadAtlas::type))
+	{
+		atlas = luax_totype<QuadAtlas>(L, startidx);
+		frame = (int) luaL_checkinteger(L, startidx + 1) - 1;
+		startidx += 2;
+	}
 	else if (lua_isnil(L, startidx) && !lua_isnoneornil(L, startidx + 1))
 		return luax_typerror(L, startidx, "Quad");
 
@@ -80,6 +113,8 @@ static int w_SpriteBatch_addLayer_or_setLayer(lua_State *L, SpriteBatch *t, int
 		{
 			if (quad)
 				index = t->addLayer(layer, quad, m, index);
+			else if (atlas)
+				index = t->addLayer(layer, atlas, frame, m, index);
 			else
 				index = t->addLayer(layer, m, index);
 		});
@@ -108,6 +143,45 @@ int w_SpriteBatch_set(lua_State *L)
 	return 0;
 }
 
+int w_SpriteBatch_setSprites(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+	Data *data = luax_checktype<Data>(L, 2);
+
+	size_t recordsize = sizeof(SpriteBatch::SpriteRecord);
+	int maxcount = (int) (data->getSize() / recordsize);
+
+	std::vector<Quad *> quads;
+	QuadAtlas *atlas = nullptr;
+
+	if (luax_istype(L, 3, QuadAtlas::type))
+		atlas = luax_totype<QuadAtlas>(L, 3);
+	else if (!lua_isnoneornil(L, 3))
+	{
+		luaL_checktype(L, 3, LUA_TTABLE);
+		int quadcount = (int) luax_objlen(L, 3);
+		quads.reserve(quadcount);
+
+		for (int i = 1; i <= quadcount; i++)
+		{
+			lua_rawgeti(L, 3, i);
+			quads.push_back(luax_checkquad(L, -1));
+			lua_pop(L, 1);
+		}
+	}
+
+	int start = (int) luaL_optinteger(L, 4, t->getCount() + 1) - 1;
+	int count = (int) luaL_optinteger(L, 5, maxcount);
+
+	if (count < 0 || count > maxcount)
+		return luaL_error(L, "Data is too small to hold %d sprites (it can hold %d).", count, maxcount);
+
+	const auto *records = (const SpriteBatch::SpriteRecord *) data->getData();
+
+	luax_catchexcept(L, [&](){ t->setSprites(start, records, count, quads, atlas); });
+	return 0;
+}
+
 int w_SpriteBatch_addLayer(lua_State *L)
 {
 	SpriteBatch *t = luax_checkspritebatch(L, 1);
@@ -233,6 +307,13 @@ int w_SpriteBatch_getBufferSize(lua_State *L)
 	return 1;
 }
 
+int w_SpriteBatch_isInstanced(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+	luax_pushboolean(L, t->isInstanced());
+	return 1;
+}
+
 int w_SpriteBatch_attachAttribute(lua_State *L)
 {
 	SpriteBatch *t = luax_checkspritebatch(L, 1);
@@ -273,10 +354,74 @@ int w_SpriteBatch_getDrawRange(lua_State *L)
 	return 2;
 }
 
+// C functions in a struct, necessary for the FFI versions of SpriteBatch
+// methods.
+struct FFI_SpriteBatch
+{
+	int (*add)(Proxy *p, Proxy *q, int index, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+	int (*addFrame)(Proxy *p, Proxy *q, int frame, int index, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+};
+
+static FFI_SpriteBatch ffifuncs =
+{
+	// Returns the 1-based index of the sprite, or 0 when the Lua C API version
+	// has to be called instead.
+	[](Proxy *p, Proxy *q, int index, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky) -> int // add
+	{
+		if (p == nullptr || p->object == nullptr || p->type == nullptr || !p->type->isa(SpriteBatch::type))
+			return 0;
+
+		// Transforms are also userdata, and are handled by the Lua C API version.
+		if (q != nullptr && (q->object == nullptr || q->type == nullptr || !q->type->isa(Quad::type)))
+			return 0;
+
+		SpriteBatch *t = (SpriteBatch *) p->object;
+		Matrix4 m(x, y, a, sx, sy, ox, oy, kx, ky);
+
+		try
+		{
+			if (q != nullptr)
+				index = t->add((Quad *) q->object, m, index);
+			else
+				index = t->add(m, index);
+		}
+		catch (love::Exception &)
+		{
+			return 0;
+		}
+
+		return index + 1;
+	},
+
+	[](Proxy *p, Proxy *q, int frame, int index, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky) -> int // addFrame
+	{
+		if (p == nullptr || p->object == nullptr || p->type == nullptr || !p->type->isa(SpriteBatch::type))
+			return 0;
+
+		if (q == nullptr || q->object == nullptr || q->type == nullptr || !q->type->isa(QuadAtlas::type))
+			return 0;
+
+		SpriteBatch *t = (SpriteBatch *) p->object;
+		Matrix4 m(x, y, a, sx, sy, ox, oy, kx, ky);
+
+		try
+		{
+			index = t->add((QuadAtlas *) q->object, frame - 1, m, index);
+		}
+		catch (love::Exception &)
+		{
+			return 0;
+		}
+
+		return index + 1;
+	},
+};
+
 static const luaL_Reg w_SpriteBatch_functions[] =
 {
 	{ "add", w_SpriteBatch_add },
 	{ "set", w_SpriteBatch_set },
+	{ "setSprites", w_SpriteBatch_setSprites },
 	{ "addLayer", w_SpriteBatch_addLayer },
 	{ "setLayer", w_SpriteBatch_setLayer },
 	{ "clear", w_SpriteBatch_clear },
@@ -287,6 +432,7 @@ static const luaL_Reg w_SpriteBatch_functions[] =
 	{ "getColor", w_SpriteBatch_getColor },
 	{ "getCount", w_SpriteBatch_getCount },
 	{ "getBufferSize", w_SpriteBatch_getBufferSize },
+	{ "isInstanced", w_SpriteBatch_isInstanced },
 	{ "attachAttribute", w_SpriteBatch_attachAttribute },
 	{ "setDrawRange", w_SpriteBatch_setDrawRange },
 	{ "getDrawRange", w_SpriteBatch_getDrawRange },
@@ -295,7 +441,24 @@ static const luaL_Reg w_SpriteBatch_functions[] =
 
 extern "C" int luaopen_spritebatch(lua_State *L)
 {
-	return luax_register_type(L, &SpriteBatch::type, w_SpriteBatch_functions, nullptr);
+	int ret = luax_register_type(L, &SpriteBatch::type, w_SpriteBatch_functions, nullptr);
+
+	luax_gettypemetatable(L, SpriteBatch::type);
+
+	// Load and execute wrap_SpriteBatch.lua, sending the metatable and the ffi
+	// functions struct pointer as arguments.
+	if (lua_istable(L, -1))
+	{
+		luax_loadembedded(L, LOVE_EMBEDDED_BYTECODE(spritebatch_lua), spritebatch_lua, sizeof(spritebatch_lua), "wrap_SpriteBatch.lua");
+		lua_pushvalue(L, -2);
+		lua_pushlightuserdata(L, &ffifuncs);
+		lua_call(L, 2, 0);
+	}
+
+	// Pop the metatable.
+	lua_pop(L, 1);
+
+	return ret;
 }
 
 } // graphics
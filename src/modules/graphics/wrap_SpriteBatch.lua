@@ -0,0 +1,121 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2018 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+
+local SpriteBatch_mt, ffifuncspointer = ...
+local SpriteBatch = SpriteBatch_mt.__index
+
+local type = type
+local floor = math.floor
+
+-- Everything below this point is efficient FFI replacements for existing
+-- SpriteBatch functionality. Calls they don't handle, such as ones using
+-- Transform objects, or ones which fail, go through the regular methods
+-- instead, which also raise any errors.
+
+if type(jit) ~= "table" or not jit.status() then
+	-- LuaJIT's FFI is *much* slower than LOVE's regular methods when the JIT
+	-- compiler is disabled.
+	return
+end
+
+local status, ffi = pcall(require, "ffi")
+if not status then return end
+
+pcall(ffi.cdef, [[
+typedef struct Proxy Proxy;
+
+typedef struct FFI_SpriteBatch
+{
+	int (*add)(Proxy *p, Proxy *q, int index, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+	int (*addFrame)(Proxy *p, Proxy *q, int frame, int index, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+} FFI_SpriteBatch;
+]])
+
+local ffifuncs = ffi.cast("FFI_SpriteBatch *", ffifuncspointer)
+
+local function isoptnumber(v)
+	return v == nil or type(v) == "number"
+end
+
+local function isstandardtransform(x, y, a, sx, sy, ox, oy, kx, ky)
+	return isoptnumber(x) and isoptnumber(y) and isoptnumber(a)
+		and isoptnumber(sx) and isoptnumber(sy) and isoptnumber(ox)
+		and isoptnumber(oy) and isoptnumber(kx) and isoptnumber(ky)
+end
+
+-- Adds or sets a sprite, returning its index, or 0 if the regular method has
+-- to be called instead. The arguments are an optional Quad, or a QuadAtlas
+-- and frame index, followed by the standard transform arguments.
+local function addsprite(self, index, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11)
+	if type(self) ~= "userdata" then return 0 end
+
+	if type(a1) == "userdata" then
+		local result = 0
+
+		-- add(quad, x, y, ...)
+		if a11 == nil and isstandardtransform(a2, a3, a4, a5, a6, a7, a8, a9, a10) then
+			local sx = a5 or 1
+			result = ffifuncs.add(self, a1, index, a2 or 0, a3 or 0, a4 or 0, sx, a6 or sx, a7 or 0, a8 or 0, a9 or 0, a10 or 0)
+		end
+
+		-- add(quadatlas, frame, x, y, ...)
+		if result == 0 and type(a2) == "number" and a2 == floor(a2)
+			and isstandardtransform(a3, a4, a5, a6, a7, a8, a9, a10, a11) then
+			local sx = a6 or 1
+			result = ffifuncs.addFrame(self, a1, a2, index, a3 or 0, a4 or 0, a5 or 0, sx, a7 or sx, a8 or 0, a9 or 0, a10 or 0, a11 or 0)
+		end
+
+		return result
+	elseif a10 ~= nil or a11 ~= nil or (a1 == nil and a2 ~= nil) then
+		-- A nil followed by more arguments is a missing Quad, which is an error.
+		return 0
+	end
+
+	if not isstandardtransform(a1, a2, a3, a4, a5, a6, a7, a8, a9) then return 0 end
+
+	local sx = a4 or 1
+	return ffifuncs.add(self, nil, index, a1 or 0, a2 or 0, a3 or 0, sx, a5 or sx, a6 or 0, a7 or 0, a8 or 0, a9 or 0)
+end
+
+local add_C = SpriteBatch.add
+
+function SpriteBatch:add(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11)
+	local index = addsprite(self, -1, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11)
+	if index > 0 then return index end
+	return add_C(self, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11)
+end
+
+local set_C = SpriteBatch.set
+
+function SpriteBatch:set(id, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11)
+	-- Sprite indices are checked by the SpriteBatch.
+	if type(id) == "number" and id == floor(id) then
+		if addsprite(self, id - 1, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11) > 0 then return end
+	end
+	return set_C(self, id, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11)
+end
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_TextureAtlas.h"
+#include "wrap_Image.h"
+
+namespace love
+{
+namespace graphics
+{
+
+TextureAtlas *luax_checktextureatlas(lua_State *L, int idx)
+{
+	return luax_checktype<TextureAtlas>(L, idx);
+}
+
+int w_TextureAtlas_add(lua_State *L)
+{
+	TextureAtlas *t = luax_checktextureatlas(L, 1);
+	Image *image = luax_checkimage(L, 2);
+
+	bool success = false;
+	luax_catchexcept(L, [&](){ success = t->add(image); });
+
+	lua_pushboolean(L, success);
+	return 1;
+}
+
+int w_TextureAtlas_remove(lua_State *L)
+{
+	TextureAtlas *t = luax_checktextureatlas(L, 1);
+	Image *image = luax_checkimage(L, 2);
+	luax_catchexcept(L, [&](){ t->remove(image); });
+	return 0;
+}
+
+int w_TextureAtlas_contains(lua_State *L)
+{
+	TextureAtlas *t = luax_checktextureatlas(L, 1);
+	Image *image = luax_checkimage(L, 2);
+	lua_pushboolean(L, t->contains(image));
+	return 1;
+}
+
+int w_TextureAtlas_canAdd(lua_State *L)
+{
+	TextureAtlas *t = luax_checktextureatlas(L, 1);
+	Image *image = luax_checkimage(L, 2);
+	lua_pushboolean(L, t->isCompatible(image, false));
+	return 1;
+}
+
+int w_TextureAtlas_clear(lua_State *L)
+{
+	TextureAtlas *t = luax_checktextureatlas(L, 1);
+	luax_catchexcept(L, [&](){ t->clear(); });
+	return 0;
+}
+
+int w_TextureAtlas_getTexture(lua_State *L)
+{
+	TextureAtlas *t = luax_checktextureatlas(L, 1);
+	luax_pushtype(L, t->getTexture());
+	return 1;
+}
+
+int w_TextureAtlas_getImageCount(lua_State *L)
+{
+	TextureAtlas *t = luax_checktextureatlas(L, 1);
+	lua_pushinteger(L, t->getImageCount());
+	return 1;
+}
+
+int w_TextureAtlas_getSize(lua_State *L)
+{
+	TextureAtlas *t = luax_checktextureatlas(L, 1);
+	lua_pushinteger(L, t->getSize());
+	return 1;
+}
+
+static const luaL_Reg w_TextureAtlas_functions[] =
+{
+	{ "add", w_TextureAtlas_add },
+	{ "remove", w_TextureAtlas_remove },
+	{ "contains", w_TextureAtlas_contains },
+	{ "canAdd", w_TextureAtlas_canAdd },
+	{ "clear", w_TextureAtlas_clear },
+	{ "getTexture", w_TextureAtlas_getTexture },
+	{ "getImageCount", w_TextureAtlas_getImageCount },
+	{ "getSize", w_TextureAtlas_getSize },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_textureatlas(lua_State *L)
+{
+	return luax_register_type(L, &TextureAtlas::type, w_TextureAtlas_functions, nullptr);
+}
+
+} // graphics
+} // love
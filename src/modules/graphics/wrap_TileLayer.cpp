@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_TileLayer.h"
+#include "wrap_Texture.h"
+#include "wrap_Quad.h"
+
+namespace love
+{
+namespace graphics
+{
+
+TileLayer *luax_checktilelayer(lua_State *L, int idx)
+{
+	return luax_checktype<TileLayer>(L, idx);
+}
+
+int w_TileLayer_setTile(lua_State *L)
+{
+	TileLayer *t = luax_checktilelayer(L, 1);
+	int x = (int) luaL_checkinteger(L, 2) - 1;
+	int y = (int) luaL_checkinteger(L, 3) - 1;
+	Quad *quad = luax_checkquad(L, 4);
+
+	Colorf c(1.0f, 1.0f, 1.0f, 1.0f);
+
+	if (lua_istable(L, 5))
+	{
+		for (int i = 1; i <= 4; i++)
+			lua_rawgeti(L, 5, i);
+
+		c.r = (float) luaL_checknumber(L, -4);
+		c.g = (float) luaL_checknumber(L, -3);
+		c.b = (float) luaL_checknumber(L, -2);
+		c.a = (float) luaL_optnumber(L, -1, 1.0);
+
+		lua_pop(L, 4);
+	}
+	else if (!lua_isnoneornil(L, 5))
+	{
+		c.r = (float) luaL_checknumber(L, 5);
+		c.g = (float) luaL_checknumber(L, 6);
+		c.b = (float) luaL_checknumber(L, 7);
+		c.a = (float) luaL_optnumber(L, 8, 1.0);
+	}
+
+	luax_catchexcept(L, [&](){ t->setTile(x, y, quad, c); });
+	return 0;
+}
+
+int w_TileLayer_clearTile(lua_State *L)
+{
+	TileLayer *t = luax_checktilelayer(L, 1);
+	int x = (int) luaL_checkinteger(L, 2) - 1;
+	int y = (int) luaL_checkinteger(L, 3) - 1;
+	luax_catchexcept(L, [&](){ t->clearTile(x, y); });
+	return 0;
+}
+
+int w_TileLayer_getTile(lua_State *L)
+{
+	TileLayer *t = luax_checktilelayer(L, 1);
+	int x = (int) luaL_checkinteger(L, 2) - 1;
+	int y = (int) luaL_checkinteger(L, 3) - 1;
+
+	Quad *quad = nullptr;
+	luax_catchexcept(L, [&](){ quad = t->getTile(x, y); });
+
+	luax_pushtype(L, quad);
+	return 1;
+}
+
+int w_TileLayer_clear(lua_State *L)
+{
+	TileLayer *t = luax_checktilelayer(L, 1);
+	t->clear();
+	return 0;
+}
+
+int w_TileLayer_setTexture(lua_State *L)
+{
+	TileLayer *t = luax_checktilelayer(L, 1);
+	Texture *tex = luax_checktexture(L, 2);
+	luax_catchexcept(L, [&](){ t->setTexture(tex); });
+	return 0;
+}
+
+int w_TileLayer_getTexture(lua_State *L)
+{
+	TileLayer *t = luax_checktilelayer(L, 1);
+	luax_pushtype(L, t->getTexture());
+	return 1;
+}
+
+int w_TileLayer_getDimensions(lua_State *L)
+{
+	TileLayer *t = luax_checktilelayer(L, 1);
+	lua_pushinteger(L, t->getWidth());
+	lua_pushinteger(L, t->getHeight());
+	return 2;
+}
+
+int w_TileLayer_getTileDimensions(lua_State *L)
+{
+	TileLayer *t = luax_checktilelayer(L, 1);
+	lua_pushnumber(L, t->getTileWidth());
+	lua_pushnumber(L, t->getTileHeight());
+	return 2;
+}
+
+int w_TileLayer_getChunkSize(lua_State *L)
+{
+	TileLayer *t = luax_checktilelayer(L, 1);
+	lua_pushinteger(L, t->getChunkSize());
+	return 1;
+}
+
+int w_TileLayer_getDrawnChunkCount(lua_State *L)
+{
+	TileLayer *t = luax_checktilelayer(L, 1);
+	lua_pushinteger(L, t->getDrawnChunkCount());
+	return 1;
+}
+
+static const luaL_Reg w_TileLayer_functions[] =
+{
+	{ "setTile", w_TileLayer_setTile },
+	{ "clearTile", w_TileLayer_clearTile },
+	{ "getTile", w_TileLayer_getTile },
+	{ "clear", w_TileLayer_clear },
+	{ "setTexture", w_TileLayer_setTexture },
+	{ "getTexture", w_TileLayer_getTexture },
+	{ "getDimensions", w_TileLayer_getDimensions },
+	{ "getTileDimensions", w_TileLayer_getTileDimensions },
+	{ "getChunkSize", w_TileLayer_getChunkSize },
+	{ "getDrawnChunkCount", w_TileLayer_getDrawnChunkCount },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_tilelayer(lua_State *L)
+{
+	return luax_register_type(L, &TileLayer::type, w_TileLayer_functions, nullptr);
+}
+
+} // graphics
+} // love
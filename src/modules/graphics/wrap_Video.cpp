@@ -25,6 +25,10 @@ static const char video_lua[] =
 #include "wrap_Video.lua"
 ;
 
+#ifdef LOVE_PRECOMPILED_LUA
+#include "luabytecode/video_lua.h"
+#endif
+
 namespace love
 {
 namespace graphics
@@ -168,7 +172,7 @@ int luaopen_video(lua_State *L)
 {
 	int ret = luax_register_type(L, &Video::type, functions, nullptr);
 
-	luaL_loadbuffer(L, video_lua, sizeof(video_lua), "Video.lua");
+	luax_loadembedded(L, LOVE_EMBEDDED_BYTECODE(video_lua), video_lua, sizeof(video_lua), "Video.lua");
 	luax_gettypemetatable(L, Video::type);
 	lua_call(L, 1, 0);
 
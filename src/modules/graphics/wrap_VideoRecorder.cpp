@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_VideoRecorder.h"
+#include "wrap_Canvas.h"
+
+namespace love
+{
+namespace graphics
+{
+
+VideoRecorder *luax_checkvideorecorder(lua_State *L, int idx)
+{
+	return luax_checktype<VideoRecorder>(L, idx);
+}
+
+int w_VideoRecorder_addFrame(lua_State *L)
+{
+	VideoRecorder *r = luax_checkvideorecorder(L, 1);
+	Canvas *canvas = luax_checkcanvas(L, 2);
+	luax_catchexcept(L, [&](){ r->addFrame(canvas); });
+	return 0;
+}
+
+int w_VideoRecorder_finish(lua_State *L)
+{
+	VideoRecorder *r = luax_checkvideorecorder(L, 1);
+	luax_catchexcept(L, [&](){ r->finish(); });
+	return 0;
+}
+
+int w_VideoRecorder_isFinished(lua_State *L)
+{
+	VideoRecorder *r = luax_checkvideorecorder(L, 1);
+	luax_pushboolean(L, r->isFinished());
+	return 1;
+}
+
+int w_VideoRecorder_getFrameCount(lua_State *L)
+{
+	VideoRecorder *r = luax_checkvideorecorder(L, 1);
+	lua_pushnumber(L, (lua_Number) r->getFrameCount());
+	return 1;
+}
+
+int w_VideoRecorder_getTimestep(lua_State *L)
+{
+	VideoRecorder *r = luax_checkvideorecorder(L, 1);
+	lua_pushnumber(L, r->getTimestep());
+	return 1;
+}
+
+int w_VideoRecorder_getTime(lua_State *L)
+{
+	VideoRecorder *r = luax_checkvideorecorder(L, 1);
+	lua_pushnumber(L, r->getTime());
+	return 1;
+}
+
+int w_VideoRecorder_getFPS(lua_State *L)
+{
+	VideoRecorder *r = luax_checkvideorecorder(L, 1);
+	lua_pushinteger(L, r->getFPS());
+	return 1;
+}
+
+int w_VideoRecorder_getFormat(lua_State *L)
+{
+	VideoRecorder *r = luax_checkvideorecorder(L, 1);
+	const char *str = nullptr;
+	if (!VideoRecorder::getConstant(r->getFormat(), str))
+		return luaL_error(L, "Unknown video format.");
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_VideoRecorder_getDimensions(lua_State *L)
+{
+	VideoRecorder *r = luax_checkvideorecorder(L, 1);
+	lua_pushinteger(L, r->getWidth());
+	lua_pushinteger(L, r->getHeight());
+	return 2;
+}
+
+static const luaL_Reg w_VideoRecorder_functions[] =
+{
+	{ "addFrame", w_VideoRecorder_addFrame },
+	{ "finish", w_VideoRecorder_finish },
+	{ "isFinished", w_VideoRecorder_isFinished },
+	{ "getFrameCount", w_VideoRecorder_getFrameCount },
+	{ "getTimestep", w_VideoRecorder_getTimestep },
+	{ "getTime", w_VideoRecorder_getTime },
+	{ "getFPS", w_VideoRecorder_getFPS },
+	{ "getFormat", w_VideoRecorder_getFormat },
+	{ "getDimensions", w_VideoRecorder_getDimensions },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_videorecorder(lua_State *L)
+{
+	return luax_register_type(L, &VideoRecorder::type, w_VideoRecorder_functions, nullptr);
+}
+
+} // graphics
+} // love
@@ -55,6 +55,8 @@ CompressedImageData::CompressedImageData(const std::list<FormatHandler *> &forma
 
 	if (dataImages.size() == 0 || memory->size == 0)
 		throw love::Exception("Could not parse compressed data: No valid data?");
+
+	setNativeMemorySize(type, memory->size);
 }
 
 CompressedImageData::CompressedImageData(const CompressedImageData &c)
@@ -70,6 +72,8 @@ CompressedImageData::CompressedImageData(const CompressedImageData &c)
 		dataImages.push_back(slice);
 		slice->release();
 	}
+
+	setNativeMemorySize(type, memory->size);
 }
 
 CompressedImageData *CompressedImageData::clone() const
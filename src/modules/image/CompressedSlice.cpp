@@ -40,9 +40,21 @@ CompressedMemory::CompressedMemory(size_t size)
 	}
 }
 
+CompressedMemory::CompressedMemory(Data *source, size_t offset, size_t size)
+	: data(nullptr)
+	, size(size)
+	, source(source)
+{
+	if (offset + size > source->getSize())
+		throw love::Exception("Compressed image data extends past the end of its file.");
+
+	data = (uint8 *) source->getData() + offset;
+}
+
 CompressedMemory::~CompressedMemory()
 {
-	delete[] data;
+	if (source.get() == nullptr)
+		delete[] data;
 }
 
 CompressedSlice::CompressedSlice(PixelFormat format, int width, int height, CompressedMemory *memory, size_t offset, size_t size)
@@ -24,6 +24,7 @@
 #include "common/int.h"
 #include "common/pixelformat.h"
 #include "common/Object.h"
+#include "common/Data.h"
 #include "ImageDataBase.h"
 
 namespace love
@@ -36,11 +37,23 @@ class CompressedMemory : public Object
 public:
 
 	CompressedMemory(size_t size);
+
+	/**
+	 * References a range of the source Data's memory instead of copying it.
+	 * The source is kept alive as long as this object is.
+	 **/
+	CompressedMemory(Data *source, size_t offset, size_t size);
+
 	virtual ~CompressedMemory();
 
 	uint8 *data;
 	size_t size;
 
+private:
+
+	// Set if the memory belongs to another Data object.
+	StrongRef<Data> source;
+
 }; // CompressedMemory
 
 // Compressed image data can have multiple mipmap levels, each represented by a
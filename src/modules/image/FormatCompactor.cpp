@@ -0,0 +1,975 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "FormatCompactor.h"
+#include "common/Exception.h"
+#include "thread/WorkerPool.h"
+
+// C++
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+namespace love
+{
+namespace image
+{
+
+CompactImageData::CompactImageData(PixelFormat format, int width, int height, size_t size)
+	: data(nullptr)
+	, size(size)
+{
+	this->format = format;
+	this->width = width;
+	this->height = height;
+
+	try
+	{
+		data = new uint8[size];
+	}
+	catch (std::exception &)
+	{
+		throw love::Exception("Out of memory.");
+	}
+}
+
+CompactImageData::CompactImageData(const CompactImageData &c)
+	: CompactImageData(c.getFormat(), c.getWidth(), c.getHeight(), c.getSize())
+{
+	memcpy(data, c.data, size);
+}
+
+CompactImageData::~CompactImageData()
+{
+	delete[] data;
+}
+
+CompactImageData *CompactImageData::clone() const
+{
+	return new CompactImageData(*this);
+}
+
+namespace
+{
+
+// Rows of pixels or blocks handed to a worker at a time.
+const int ROWS_PER_TASK = 16;
+
+struct CompactFormat
+{
+	PixelFormat format;
+	FormatCompactor::Mode mode;
+	int bitsPerPixel;
+};
+
+// Ordered by size, smallest first.
+const CompactFormat compactFormats[] =
+{
+	{ PIXELFORMAT_DXT1,      FormatCompactor::MODE_COMPRESSED, 4  },
+	{ PIXELFORMAT_ETC2_RGB,  FormatCompactor::MODE_COMPRESSED, 4  },
+	{ PIXELFORMAT_R8,        FormatCompactor::MODE_LOSSLESS,   8  },
+	{ PIXELFORMAT_DXT5,      FormatCompactor::MODE_COMPRESSED, 8  },
+	{ PIXELFORMAT_ETC2_RGBA, FormatCompactor::MODE_COMPRESSED, 8  },
+	{ PIXELFORMAT_RG8,       FormatCompactor::MODE_LOSSLESS,   16 },
+	{ PIXELFORMAT_LA8,       FormatCompactor::MODE_LOSSLESS,   16 },
+	{ PIXELFORMAT_RGB565,    FormatCompactor::MODE_PACKED,     16 },
+	{ PIXELFORMAT_RGBA4,     FormatCompactor::MODE_PACKED,     16 },
+	{ PIXELFORMAT_RGB5A1,    FormatCompactor::MODE_PACKED,     16 },
+};
+
+// 4x4 pixels, indexed by y * 4 + x. Pixels past the edge of the image repeat
+// the edge, and don't count towards the error.
+struct Block
+{
+	uint8 px[16][4];
+	bool valid[16];
+};
+
+inline int sq(int x)
+{
+	return x * x;
+}
+
+inline int clamp255(int v)
+{
+	return std::min(std::max(v, 0), 255);
+}
+
+void readBlock(const uint8 *src, int w, int h, int bx, int by, Block &b)
+{
+	for (int y = 0; y < 4; y++)
+	{
+		for (int x = 0; x < 4; x++)
+		{
+			int px = bx * 4 + x;
+			int py = by * 4 + y;
+			int i = y * 4 + x;
+
+			b.valid[i] = px < w && py < h;
+
+			const uint8 *p = src + ((size_t) std::min(py, h - 1) * w + std::min(px, w - 1)) * 4;
+			memcpy(b.px[i], p, 4);
+		}
+	}
+}
+
+// Error of dropping the alpha channel.
+int opaqueError(const Block &b)
+{
+	int err = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		if (b.valid[i])
+			err += sq(255 - b.px[i][3]);
+	}
+	return err;
+}
+
+inline uint16 to565(const float c[3])
+{
+	int r = clamp255((int) (c[0] + 0.5f)) * 31 + 127;
+	int g = clamp255((int) (c[1] + 0.5f)) * 63 + 127;
+	int b = clamp255((int) (c[2] + 0.5f)) * 31 + 127;
+	return (uint16) (((r / 255) << 11) | ((g / 255) << 5) | (b / 255));
+}
+
+inline void from565(uint16 v, int c[3])
+{
+	int r = (v >> 11) & 0x1F;
+	int g = (v >> 5) & 0x3F;
+	int b = v & 0x1F;
+	c[0] = (r << 3) | (r >> 2);
+	c[1] = (g << 2) | (g >> 4);
+	c[2] = (b << 3) | (b >> 2);
+}
+
+/**
+ * DXT1 color block. The endpoints lie on the principal axis of the block's
+ * colors, through their mean.
+ **/
+int encodeDXTColor(const Block &b, uint8 *out)
+{
+	float mean[3] = {0.0f, 0.0f, 0.0f};
+	int count = 0;
+
+	for (int i = 0; i < 16; i++)
+	{
+		if (!b.valid[i])
+			continue;
+
+		for (int c = 0; c < 3; c++)
+			mean[c] += b.px[i][c];
+		count++;
+	}
+
+	for (int c = 0; c < 3; c++)
+		mean[c] /= (float) count;
+
+	// rr, rg, rb, gg, gb, bb
+	float cov[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+
+	for (int i = 0; i < 16; i++)
+	{
+		if (!b.valid[i])
+			continue;
+
+		float r = b.px[i][0] - mean[0];
+		float g = b.px[i][1] - mean[1];
+		float bl = b.px[i][2] - mean[2];
+
+		cov[0] += r * r;
+		cov[1] += r * g;
+		cov[2] += r * bl;
+		cov[3] += g * g;
+		cov[4] += g * bl;
+		cov[5] += bl * bl;
+	}
+
+	// Power iteration.
+	float axis[3] = {1.0f, 1.0f, 1.0f};
+	for (int iter = 0; iter < 8; iter++)
+	{
+		float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+		float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+		float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+
+		float m = std::max(fabsf(x), std::max(fabsf(y), fabsf(z)));
+		if (m < 1e-6f)
+			break;
+
+		axis[0] = x / m;
+		axis[1] = y / m;
+		axis[2] = z / m;
+	}
+
+	float axislen2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+	float minp = std::numeric_limits<float>::max();
+	float maxp = -std::numeric_limits<float>::max();
+
+	for (int i = 0; i < 16; i++)
+	{
+		if (!b.valid[i])
+			continue;
+
+		float p = 0.0f;
+		for (int c = 0; c < 3; c++)
+			p += (b.px[i][c] - mean[c]) * axis[c];
+
+		minp = std::min(minp, p);
+		maxp = std::max(maxp, p);
+	}
+
+	float e0[3], e1[3];
+	for (int c = 0; c < 3; c++)
+	{
+		e0[c] = mean[c] + axis[c] * (maxp / axislen2);
+		e1[c] = mean[c] + axis[c] * (minp / axislen2);
+	}
+
+	uint16 c0 = to565(e0);
+	uint16 c1 = to565(e1);
+
+	// color0 > color1 selects the 4 color mode.
+	if (c0 < c1)
+		std::swap(c0, c1);
+
+	int palette[4][3];
+	from565(c0, palette[0]);
+	from565(c1, palette[1]);
+
+	for (int c = 0; c < 3; c++)
+	{
+		palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+		palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+	}
+
+	// Equal endpoints select the 3 color mode, where only index 0 is safe.
+	int colors = c0 == c1 ? 1 : 4;
+
+	uint32 indices = 0;
+	int err = 0;
+
+	for (int i = 0; i < 16; i++)
+	{
+		int best = 0;
+		int besterr = std::numeric_limits<int>::max();
+
+		for (int k = 0; k < colors; k++)
+		{
+			int e = sq(palette[k][0] - b.px[i][0]) + sq(palette[k][1] - b.px[i][1]) + sq(palette[k][2] - b.px[i][2]);
+			if (e < besterr)
+			{
+				besterr = e;
+				best = k;
+			}
+		}
+
+		indices |= (uint32) best << (2 * i);
+
+		if (b.valid[i])
+			err += besterr;
+	}
+
+	out[0] = (uint8) (c0 & 0xFF);
+	out[1] = (uint8) (c0 >> 8);
+	out[2] = (uint8) (c1 & 0xFF);
+	out[3] = (uint8) (c1 >> 8);
+	out[4] = (uint8) (indices & 0xFF);
+	out[5] = (uint8) ((indices >> 8) & 0xFF);
+	out[6] = (uint8) ((indices >> 16) & 0xFF);
+	out[7] = (uint8) (indices >> 24);
+
+	return err;
+}
+
+// DXT5 alpha block, in its 8 value mode.
+int encodeDXTAlpha(const Block &b, uint8 *out)
+{
+	int amin = 255;
+	int amax = 0;
+
+	for (int i = 0; i < 16; i++)
+	{
+		if (!b.valid[i])
+			continue;
+
+		amin = std::min(amin, (int) b.px[i][3]);
+		amax = std::max(amax, (int) b.px[i][3]);
+	}
+
+	int palette[8];
+	palette[0] = amax;
+	palette[1] = amin;
+	for (int i = 2; i < 8; i++)
+		palette[i] = ((8 - i) * amax + (i - 1) * amin) / 7;
+
+	uint64 indices = 0;
+	int err = 0;
+
+	for (int i = 0; i < 16; i++)
+	{
+		int best = 0;
+		int besterr = std::numeric_limits<int>::max();
+
+		// Equal endpoints select the 6 value mode, where index 0 is still
+		// the first endpoint.
+		int values = amax == amin ? 1 : 8;
+
+		for (int k = 0; k < values; k++)
+		{
+			int e = sq(palette[k] - b.px[i][3]);
+			if (e < besterr)
+			{
+				besterr = e;
+				best = k;
+			}
+		}
+
+		indices |= (uint64) best << (3 * i);
+
+		if (b.valid[i])
+			err += besterr;
+	}
+
+	out[0] = (uint8) amax;
+	out[1] = (uint8) amin;
+	for (int i = 0; i < 6; i++)
+		out[2 + i] = (uint8) ((indices >> (8 * i)) & 0xFF);
+
+	return err;
+}
+
+const int etcModifiers[8][2] =
+{
+	{ 2,   8 },
+	{ 5,  17 },
+	{ 9,  29 },
+	{ 13, 42 },
+	{ 18, 60 },
+	{ 24, 80 },
+	{ 33, 106 },
+	{ 47, 183 },
+};
+
+inline int etcModifier(int table, int index)
+{
+	int m = etcModifiers[table][index & 1];
+	return (index & 2) ? -m : m;
+}
+
+// Picks the modifier table with the least error for the pixels of a sub-block.
+int encodeETCSubblock(const Block &b, const bool insub[16], const int base[3], int &table, uint8 indices[16])
+{
+	int besterr = std::numeric_limits<int>::max();
+
+	for (int t = 0; t < 8; t++)
+	{
+		uint8 tindices[16] = {};
+		int err = 0;
+
+		for (int i = 0; i < 16 && err < besterr; i++)
+		{
+			if (!insub[i])
+				continue;
+
+			int best = 0;
+			int bestpixelerr = std::numeric_limits<int>::max();
+
+			for (int k = 0; k < 4; k++)
+			{
+				int m = etcModifier(t, k);
+				int e = sq(clamp255(base[0] + m) - b.px[i][0])
+					+ sq(clamp255(base[1] + m) - b.px[i][1])
+					+ sq(clamp255(base[2] + m) - b.px[i][2]);
+
+				if (e < bestpixelerr)
+				{
+					bestpixelerr = e;
+					best = k;
+				}
+			}
+
+			tindices[i] = (uint8) best;
+
+			if (b.valid[i])
+				err += bestpixelerr;
+		}
+
+		if (err < besterr)
+		{
+			besterr = err;
+			table = t;
+			memcpy(indices, tindices, sizeof(tindices));
+		}
+	}
+
+	return besterr;
+}
+
+/**
+ * ETC1 block, which is also valid ETC2 RGB data. Tries both sub-block
+ * orientations in the individual and differential modes. Differential base
+ * colors are only used when both fit in 5 bits, so they never overflow into
+ * the ETC2-only modes.
+ **/
+int encodeETC1(const Block &b, uint8 *out)
+{
+	int besterr = std::numeric_limits<int>::max();
+
+	for (int flip = 0; flip < 2; flip++)
+	{
+		bool insub[2][16];
+		float avg[2][3] = {};
+		int counts[2] = {0, 0};
+
+		for (int y = 0; y < 4; y++)
+		{
+			for (int x = 0; x < 4; x++)
+			{
+				int i = y * 4 + x;
+				int sub = flip ? (y >= 2) : (x >= 2);
+
+				insub[sub][i] = true;
+				insub[1 - sub][i] = false;
+
+				if (b.valid[i])
+				{
+					for (int c = 0; c < 3; c++)
+						avg[sub][c] += b.px[i][c];
+					counts[sub]++;
+				}
+			}
+		}
+
+		for (int sub = 0; sub < 2; sub++)
+		{
+			// Sub-blocks entirely past the edge of the image use the
+			// repeated edge pixels.
+			if (counts[sub] == 0)
+			{
+				for (int i = 0; i < 16; i++)
+				{
+					if (!insub[sub][i])
+						continue;
+
+					for (int c = 0; c < 3; c++)
+						avg[sub][c] += b.px[i][c];
+					counts[sub]++;
+				}
+			}
+
+			for (int c = 0; c < 3; c++)
+				avg[sub][c] /= (float) counts[sub];
+		}
+
+		for (int diff = 1; diff >= 0; diff--)
+		{
+			int q[2][3];
+			int base[2][3];
+			bool valid = true;
+
+			for (int sub = 0; sub < 2; sub++)
+			{
+				for (int c = 0; c < 3; c++)
+				{
+					if (diff)
+					{
+						q[sub][c] = std::min((int) (avg[sub][c] * 31.0f / 255.0f + 0.5f), 31);
+						base[sub][c] = (q[sub][c] << 3) | (q[sub][c] >> 2);
+					}
+					else
+					{
+						q[sub][c] = std::min((int) (avg[sub][c] * 15.0f / 255.0f + 0.5f), 15);
+						base[sub][c] = q[sub][c] * 17;
+					}
+				}
+			}
+
+			if (diff)
+			{
+				for (int c = 0; c < 3; c++)
+				{
+					int d = q[1][c] - q[0][c];
+					if (d < -4 || d > 3)
+						valid = false;
+				}
+			}
+
+			if (!valid)
+				continue;
+
+			int tables[2] = {0, 0};
+			uint8 indices[2][16];
+
+			int err = encodeETCSubblock(b, insub[0], base[0], tables[0], indices[0]);
+			if (err >= besterr)
+				continue;
+
+			err += encodeETCSubblock(b, insub[1], base[1], tables[1], indices[1]);
+			if (err >= besterr)
+				continue;
+
+			besterr = err;
+
+			for (int c = 0; c < 3; c++)
+			{
+				if (diff)
+					out[c] = (uint8) ((q[0][c] << 3) | ((q[1][c] - q[0][c]) & 0x7));
+				else
+					out[c] = (uint8) ((q[0][c] << 4) | q[1][c]);
+			}
+
+			out[3] = (uint8) ((tables[0] << 5) | (tables[1] << 2) | (diff << 1) | flip);
+
+			// Pixel indices are stored in column-major order, with the most
+			// significant bits of every index first.
+			uint32 word = 0;
+			for (int y = 0; y < 4; y++)
+			{
+				for (int x = 0; x < 4; x++)
+				{
+					int i = y * 4 + x;
+					int p = x * 4 + y;
+					int sub = insub[0][i] ? 0 : 1;
+					int index = indices[sub][i];
+
+					if (index & 2)
+						word |= 1u << (16 + p);
+					if (index & 1)
+						word |= 1u << p;
+				}
+			}
+
+			out[4] = (uint8) (word >> 24);
+			out[5] = (uint8) ((word >> 16) & 0xFF);
+			out[6] = (uint8) ((word >> 8) & 0xFF);
+			out[7] = (uint8) (word & 0xFF);
+		}
+	}
+
+	return besterr;
+}
+
+const int eacModifiers[16][8] =
+{
+	{ -3, -6,  -9, -15, 2, 5, 8, 14 },
+	{ -3, -7, -10, -13, 2, 6, 9, 12 },
+	{ -2, -5,  -8, -13, 1, 4, 7, 12 },
+	{ -2, -4,  -6, -13, 1, 3, 5, 12 },
+	{ -3, -6,  -8, -12, 2, 5, 7, 11 },
+	{ -3, -7,  -9, -11, 2, 6, 8, 10 },
+	{ -4, -7,  -8, -11, 3, 6, 7, 10 },
+	{ -3, -5,  -8, -11, 2, 4, 7, 10 },
+	{ -2, -6,  -8, -10, 1, 5, 7, 9  },
+	{ -2, -5,  -8, -10, 1, 4, 7, 9  },
+	{ -2, -4,  -8, -10, 1, 3, 7, 9  },
+	{ -2, -5,  -7, -10, 1, 4, 6, 9  },
+	{ -3, -4,  -7, -10, 2, 3, 6, 9  },
+	{ -1, -2,  -3, -10, 0, 1, 2, 9  },
+	{ -4, -6,  -8,  -9, 3, 5, 7, 8  },
+	{ -3, -5,  -7,  -9, 2, 4, 6, 8  },
+};
+
+// ETC2 EAC alpha block.
+int encodeEACAlpha(const Block &b, uint8 *out)
+{
+	int amin = 255;
+	int amax = 0;
+
+	for (int i = 0; i < 16; i++)
+	{
+		if (!b.valid[i])
+			continue;
+
+		amin = std::min(amin, (int) b.px[i][3]);
+		amax = std::max(amax, (int) b.px[i][3]);
+	}
+
+	// Table 13 has a zero modifier, for blocks of one value.
+	int bestbase = amin;
+	int bestmult = 1;
+	int besttable = 13;
+	int besterr = amin == amax ? 0 : std::numeric_limits<int>::max();
+
+	for (int t = 0; t < 16 && besterr > 0; t++)
+	{
+		int tmin = eacModifiers[t][3];
+		int tmax = eacModifiers[t][7];
+
+		int mult = (int) ((amax - amin) / (float) (tmax - tmin) + 0.5f);
+		mult = std::min(std::max(mult, 1), 15);
+
+		int center = (int) floorf(((amin - tmin * mult) + (amax - tmax * mult)) / 2.0f + 0.5f);
+
+		for (int base = center - 1; base <= center + 1; base++)
+		{
+			if (base < 0 || base > 255)
+				continue;
+
+			int err = 0;
+			for (int i = 0; i < 16 && err < besterr; i++)
+			{
+				if (!b.valid[i])
+					continue;
+
+				int pixelerr = std::numeric_limits<int>::max();
+				for (int k = 0; k < 8; k++)
+					pixelerr = std::min(pixelerr, sq(clamp255(base + eacModifiers[t][k] * mult) - b.px[i][3]));
+
+				err += pixelerr;
+			}
+
+			if (err < besterr)
+			{
+				besterr = err;
+				bestbase = base;
+				bestmult = mult;
+				besttable = t;
+			}
+		}
+	}
+
+	uint64 bits = ((uint64) bestbase << 56) | ((uint64) bestmult << 52) | ((uint64) besttable << 48);
+
+	for (int y = 0; y < 4; y++)
+	{
+		for (int x = 0; x < 4; x++)
+		{
+			int i = y * 4 + x;
+			int p = x * 4 + y;
+
+			int best = 0;
+			int bestpixelerr = std::numeric_limits<int>::max();
+
+			for (int k = 0; k < 8; k++)
+			{
+				int e = sq(clamp255(bestbase + eacModifiers[besttable][k] * bestmult) - b.px[i][3]);
+				if (e < bestpixelerr)
+				{
+					bestpixelerr = e;
+					best = k;
+				}
+			}
+
+			bits |= (uint64) best << (45 - 3 * p);
+		}
+	}
+
+	for (int i = 0; i < 8; i++)
+		out[i] = (uint8) ((bits >> (56 - 8 * i)) & 0xFF);
+
+	return besterr;
+}
+
+// Encodes one block, and returns its squared error.
+int encodeBlock(PixelFormat format, const Block &b, uint8 *out)
+{
+	switch (format)
+	{
+	case PIXELFORMAT_DXT1:
+		return encodeDXTColor(b, out) + opaqueError(b);
+	case PIXELFORMAT_DXT5:
+		return encodeDXTAlpha(b, out) + encodeDXTColor(b, out + 8);
+	case PIXELFORMAT_ETC2_RGB:
+		return encodeETC1(b, out) + opaqueError(b);
+	case PIXELFORMAT_ETC2_RGBA:
+		return encodeEACAlpha(b, out) + encodeETC1(b, out + 8);
+	default:
+		return 0;
+	}
+}
+
+inline int quantize(int v, int maxval)
+{
+	return (v * maxval + 127) / 255;
+}
+
+inline int expand5(int v)
+{
+	return (v << 3) | (v >> 2);
+}
+
+inline int expand6(int v)
+{
+	return (v << 2) | (v >> 4);
+}
+
+// Encodes one pixel, and returns its squared error.
+int encodePixel(PixelFormat format, const uint8 *p, uint8 *out)
+{
+	int r = p[0], g = p[1], b = p[2], a = p[3];
+
+	switch (format)
+	{
+	case PIXELFORMAT_R8:
+		out[0] = (uint8) r;
+		return sq(g) + sq(b) + sq(255 - a);
+	case PIXELFORMAT_RG8:
+		out[0] = (uint8) r;
+		out[1] = (uint8) g;
+		return sq(b) + sq(255 - a);
+	case PIXELFORMAT_LA8:
+	{
+		int l = (r + g + b + 1) / 3;
+		out[0] = (uint8) l;
+		out[1] = (uint8) a;
+		return sq(l - r) + sq(l - g) + sq(l - b);
+	}
+	case PIXELFORMAT_RGB565:
+	{
+		int r5 = quantize(r, 31), g6 = quantize(g, 63), b5 = quantize(b, 31);
+		uint16 v = (uint16) ((r5 << 11) | (g6 << 5) | b5);
+		memcpy(out, &v, sizeof(uint16));
+		return sq(expand5(r5) - r) + sq(expand6(g6) - g) + sq(expand5(b5) - b) + sq(255 - a);
+	}
+	case PIXELFORMAT_RGBA4:
+	{
+		int r4 = quantize(r, 15), g4 = quantize(g, 15), b4 = quantize(b, 15), a4 = quantize(a, 15);
+		uint16 v = (uint16) ((r4 << 12) | (g4 << 8) | (b4 << 4) | a4);
+		memcpy(out, &v, sizeof(uint16));
+		return sq(r4 * 17 - r) + sq(g4 * 17 - g) + sq(b4 * 17 - b) + sq(a4 * 17 - a);
+	}
+	case PIXELFORMAT_RGB5A1:
+	{
+		int r5 = quantize(r, 31), g5 = quantize(g, 31), b5 = quantize(b, 31), a1 = a >= 128 ? 1 : 0;
+		uint16 v = (uint16) ((r5 << 11) | (g5 << 6) | (b5 << 1) | a1);
+		memcpy(out, &v, sizeof(uint16));
+		return sq(expand5(r5) - r) + sq(expand5(g5) - g) + sq(expand5(b5) - b) + sq(a1 * 255 - a);
+	}
+	default:
+		return 0;
+	}
+}
+
+size_t getBlockSize(PixelFormat format)
+{
+	return (format == PIXELFORMAT_DXT1 || format == PIXELFORMAT_ETC2_RGB) ? 8 : 16;
+}
+
+/**
+ * Encodes an RGBA8 ImageData in a compact format, and returns the total
+ * squared error. Stops early and returns the error so far once it exceeds
+ * maxerror.
+ **/
+double encode(ImageData *src, PixelFormat format, double maxerror, bool parallel, StrongRef<ImageDataBase> &result)
+{
+	love::thread::Lock lock(src->getMutex());
+
+	int w = src->getWidth();
+	int h = src->getHeight();
+	const uint8 *pixels = (const uint8 *) src->getData();
+
+	bool blocks = isPixelFormatCompressed(format);
+	int bw = (w + 3) / 4;
+	int bh = (h + 3) / 4;
+
+	size_t size = 0;
+	int rows = 0;
+
+	if (blocks)
+	{
+		size = (size_t) bw * bh * getBlockSize(format);
+		rows = bh;
+	}
+	else
+	{
+		size = (size_t) w * h * getPixelFormatSize(format);
+		rows = h;
+	}
+
+	StrongRef<CompactImageData> dst(new CompactImageData(format, w, h, size), Acquire::NORETAIN);
+	uint8 *out = (uint8 *) dst->getData();
+
+	int tasks = (rows + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+	std::vector<double> errors(tasks, 0.0);
+
+	// Tasks past the budget are skipped: the result won't be used.
+	std::atomic<bool> exceeded(false);
+
+	auto task = [&](int t)
+	{
+		int start = t * ROWS_PER_TASK;
+		int end = std::min(start + ROWS_PER_TASK, rows);
+		double err = 0.0;
+
+		for (int row = start; row < end && !exceeded.load(std::memory_order_relaxed); row++)
+		{
+			if (blocks)
+			{
+				size_t blocksize = getBlockSize(format);
+				Block b;
+
+				for (int bx = 0; bx < bw; bx++)
+				{
+					readBlock(pixels, w, h, bx, row, b);
+					err += encodeBlock(format, b, out + ((size_t) row * bw + bx) * blocksize);
+				}
+			}
+			else
+			{
+				size_t pixelsize = getPixelFormatSize(format);
+				const uint8 *srcrow = pixels + (size_t) row * w * 4;
+				uint8 *dstrow = out + (size_t) row * w * pixelsize;
+
+				for (int x = 0; x < w; x++)
+					err += encodePixel(format, srcrow + x * 4, dstrow + x * pixelsize);
+			}
+
+			if (err > maxerror)
+				exceeded = true;
+		}
+
+		errors[t] = err;
+	};
+
+	if (parallel)
+		love::thread::WorkerPool::getShared().parallelFor(tasks, task);
+	else
+	{
+		for (int t = 0; t < tasks; t++)
+			task(t);
+	}
+
+	double total = 0.0;
+	for (double err : errors)
+		total += err;
+
+	if (exceeded)
+		total = std::max(total, std::nextafter(maxerror, std::numeric_limits<double>::max()));
+
+	result.set(dst);
+	return total;
+}
+
+} // anonymous namespace
+
+std::vector<StrongRef<ImageDataBase>> FormatCompactor::compact(const std::vector<ImageData *> &images, Mode mode, const std::vector<PixelFormat> &formats, float minPSNR, bool parallel)
+{
+	std::vector<StrongRef<ImageDataBase>> results;
+
+	if (mode == MODE_NONE || images.empty())
+		return results;
+
+	double pixels = 0.0;
+	for (ImageData *image : images)
+	{
+		if (image == nullptr || image->getFormat() != PIXELFORMAT_RGBA8)
+			return results;
+
+		pixels += (double) image->getWidth() * image->getHeight();
+	}
+
+	// PSNR = 10 * log10(255^2 / MSE), over all four channels.
+	double maxerror = 0.0;
+	if (mode != MODE_LOSSLESS)
+		maxerror = pixels * 4.0 * 255.0 * 255.0 / pow(10.0, minPSNR / 10.0);
+
+	const int count = (int) (sizeof(compactFormats) / sizeof(compactFormats[0]));
+
+	for (int tier = 0; tier < count;)
+	{
+		int bits = compactFormats[tier].bitsPerPixel;
+		double besterror = std::numeric_limits<double>::max();
+
+		int next = tier;
+		for (; next < count && compactFormats[next].bitsPerPixel == bits; next++)
+		{
+			PixelFormat format = compactFormats[next].format;
+
+			if (!isCompactFormat(format, mode))
+				continue;
+
+			if (std::find(formats.begin(), formats.end(), format) == formats.end())
+				continue;
+
+			std::vector<StrongRef<ImageDataBase>> encoded;
+			double error = 0.0;
+
+			for (ImageData *image : images)
+			{
+				StrongRef<ImageDataBase> result;
+				error += encode(image, format, maxerror - error, parallel, result);
+				encoded.push_back(result);
+
+				if (error > maxerror)
+					break;
+			}
+
+			if (error <= maxerror && error < besterror)
+			{
+				besterror = error;
+				results = encoded;
+			}
+		}
+
+		if (!results.empty())
+			return results;
+
+		tier = next;
+	}
+
+	return results;
+}
+
+bool FormatCompactor::isCompactFormat(PixelFormat format, Mode mode)
+{
+	if (mode == MODE_NONE)
+		return false;
+
+	for (const CompactFormat &f : compactFormats)
+	{
+		if (f.format == format)
+			return f.mode <= mode;
+	}
+
+	return false;
+}
+
+bool FormatCompactor::getConstant(const char *in, Mode &out)
+{
+	return modes.find(in, out);
+}
+
+bool FormatCompactor::getConstant(Mode in, const char *&out)
+{
+	return modes.find(in, out);
+}
+
+std::vector<std::string> FormatCompactor::getConstants(Mode)
+{
+	return modes.getNames();
+}
+
+StringMap<FormatCompactor::Mode, FormatCompactor::MODE_MAX_ENUM>::Entry FormatCompactor::modeEntries[] =
+{
+	{ "none",       MODE_NONE       },
+	{ "lossless",   MODE_LOSSLESS   },
+	{ "packed",     MODE_PACKED     },
+	{ "compressed", MODE_COMPRESSED },
+};
+
+StringMap<FormatCompactor::Mode, FormatCompactor::MODE_MAX_ENUM> FormatCompactor::modes(FormatCompactor::modeEntries, sizeof(FormatCompactor::modeEntries));
+
+} // image
+} // love
@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/StringMap.h"
+#include "ImageData.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace image
+{
+
+/**
+ * Pixels re-encoded by FormatCompactor, in formats ImageData doesn't support.
+ * They're only meant to be uploaded to textures.
+ **/
+class CompactImageData : public ImageDataBase
+{
+public:
+
+	CompactImageData(PixelFormat format, int width, int height, size_t size);
+	CompactImageData(const CompactImageData &c);
+	virtual ~CompactImageData();
+
+	// Implements Data.
+	CompactImageData *clone() const override;
+	void *getData() const override { return data; }
+	size_t getSize() const override { return size; }
+
+	bool isSRGB() const override { return false; }
+
+private:
+
+	uint8 *data;
+	size_t size;
+
+}; // CompactImageData
+
+/**
+ * Picks a smaller pixel format for RGBA8 ImageData based on its content, and
+ * re-encodes it: R8, RG8 or LA8 when they lose nothing, the 16 bit packed
+ * formats, or DXT1/DXT5/ETC2 blocks encoded at load time.
+ **/
+class FormatCompactor
+{
+public:
+
+	enum Mode
+	{
+		// The data is kept as it is.
+		MODE_NONE,
+
+		// Only formats which store the data exactly.
+		MODE_LOSSLESS,
+
+		// Also RGB565, RGBA4 and RGB5A1, within the quality budget.
+		MODE_PACKED,
+
+		// Also block compressed formats, within the quality budget.
+		MODE_COMPRESSED,
+
+		MODE_MAX_ENUM
+	};
+
+	/**
+	 * Re-encodes RGBA8 images in the smallest of the given formats whose peak
+	 * signal-to-noise ratio over all the images is at least minPSNR decibels,
+	 * preferring the most accurate one when several formats are the same size.
+	 * Every image gets the same format, so they can be the slices and mipmaps
+	 * of one texture. Returns an empty list if the images should be kept as
+	 * they are. Blocks are encoded in parallel on the shared worker pool if
+	 * parallel is true.
+	 **/
+	static std::vector<StrongRef<ImageDataBase>> compact(const std::vector<ImageData *> &images, Mode mode, const std::vector<PixelFormat> &formats, float minPSNR, bool parallel = true);
+
+	// Whether compact can produce the format with this mode.
+	static bool isCompactFormat(PixelFormat format, Mode mode);
+
+	static bool getConstant(const char *in, Mode &out);
+	static bool getConstant(Mode in, const char *&out);
+	static std::vector<std::string> getConstants(Mode);
+
+private:
+
+	static StringMap<Mode, MODE_MAX_ENUM>::Entry modeEntries[];
+	static StringMap<Mode, MODE_MAX_ENUM> modes;
+
+}; // FormatCompactor
+
+} // image
+} // love
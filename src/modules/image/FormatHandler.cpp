@@ -50,7 +50,7 @@ FormatHandler::DecodedImage FormatHandler::decode(Data* /*data*/)
 	throw love::Exception("Image decoding is not implemented for this format backend.");
 }
 
-FormatHandler::EncodedImage FormatHandler::encode(const DecodedImage& /*img*/, EncodedFormat /*format*/)
+FormatHandler::EncodedImage FormatHandler::encode(const DecodedImage& /*img*/, EncodedFormat /*format*/, const EncodeSettings& /*settings*/)
 {
 	throw love::Exception("Image encoding is not implemented for this format backend.");
 }
@@ -65,6 +65,10 @@ StrongRef<CompressedMemory> FormatHandler::parseCompressed(Data* /*filedata*/, s
 	throw love::Exception("Compressed image parsing is not implemented for this format backend.");
 }
 
+void FormatHandler::setSupportedCompressedFormats(const std::vector<PixelFormat>& /*formats*/)
+{
+}
+
 void FormatHandler::freeRawPixels(unsigned char *mem)
 {
 	delete[] mem;
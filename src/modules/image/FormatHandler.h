@@ -43,6 +43,7 @@ public:
 	{
 		ENCODED_TGA,
 		ENCODED_PNG,
+		ENCODED_QOI,
 		ENCODED_MAX_ENUM
 	};
 
@@ -63,6 +64,13 @@ public:
 		unsigned char *data = nullptr;
 	};
 
+	// Options for encoding raw pixel data.
+	struct EncodeSettings
+	{
+		// Favor encoding speed over output size, when the encoder supports it.
+		bool fast = false;
+	};
+
 	/**
 	 * The default constructor is called when the Image module is initialized.
 	 **/
@@ -87,7 +95,7 @@ public:
 	/**
 	 * Encodes an image from raw pixel data into a particular format.
 	 **/
-	virtual EncodedImage encode(const DecodedImage &img, EncodedFormat format);
+	virtual EncodedImage encode(const DecodedImage &img, EncodedFormat format, const EncodeSettings &settings);
 
 	/**
 	 * Whether this format handler can parse the given Data into a
@@ -111,6 +119,12 @@ public:
 	        std::vector<StrongRef<CompressedSlice>> &images,
 	        PixelFormat &format, bool &sRGB);
 
+	/**
+	 * Tells the format handler which compressed pixel formats the GPU supports,
+	 * for formats which are transcoded when they're parsed.
+	 **/
+	virtual void setSupportedCompressedFormats(const std::vector<PixelFormat> &formats);
+
 	/**
 	 * Frees raw pixel memory allocated by the format handler.
 	 **/
@@ -21,8 +21,10 @@
 // LOVE
 #include "Image.h"
 #include "common/config.h"
+#include "thread/WorkerPool.h"
 
 #include "magpie/PNGHandler.h"
+#include "magpie/QOIHandler.h"
 #include "magpie/STBHandler.h"
 #include "magpie/EXRHandler.h"
 
@@ -31,6 +33,7 @@
 #include "magpie/KTXHandler.h"
 #include "magpie/PKMHandler.h"
 #include "magpie/ASTCHandler.h"
+#include "magpie/BasisHandler.h"
 
 namespace love
 {
@@ -47,6 +50,7 @@ Image::Image()
 
 	formatHandlers = {
 		new PNGHandler,
+		new QOIHandler,
 		new STBHandler,
 		new EXRHandler,
 		new DDSHandler,
@@ -54,6 +58,9 @@ Image::Image()
 		new KTXHandler,
 		new PKMHandler,
 		new ASTCHandler,
+#ifdef LOVE_SUPPORT_BASISU
+		new BasisHandler,
+#endif
 	};
 }
 
@@ -75,6 +82,28 @@ love::image::ImageData *Image::newImageData(Data *data)
 	return new ImageData(data);
 }
 
+void Image::newImageDatas(const std::vector<Data *> &files, std::vector<StrongRef<ImageData>> &imagedatas, std::vector<std::string> &errors)
+{
+	imagedatas.clear();
+	imagedatas.resize(files.size());
+
+	errors.clear();
+	errors.resize(files.size());
+
+	// Each decode is independent, and the decoders don't share any state.
+	love::thread::WorkerPool::getShared().parallelFor((int) files.size(), [&](int i)
+	{
+		try
+		{
+			imagedatas[i].set(newImageData(files[i]), Acquire::NORETAIN);
+		}
+		catch (std::exception &e)
+		{
+			errors[i] = e.what();
+		}
+	});
+}
+
 love::image::ImageData *Image::newImageData(int width, int height, PixelFormat format)
 {
 	return new ImageData(width, height, format);
@@ -106,6 +135,12 @@ const std::list<FormatHandler *> &Image::getFormatHandlers() const
 	return formatHandlers;
 }
 
+void Image::setSupportedCompressedFormats(const std::vector<PixelFormat> &formats)
+{
+	for (FormatHandler *handler : formatHandlers)
+		handler->setSupportedCompressedFormats(formats);
+}
+
 ImageData *Image::newPastedImageData(ImageData *src, int sx, int sy, int w, int h)
 {
 	ImageData *res = newImageData(w, h, src->getFormat());
@@ -30,6 +30,8 @@
 
 // C++
 #include <list>
+#include <string>
+#include <vector>
 
 namespace love
 {
@@ -63,6 +65,16 @@ public:
 	 **/
 	ImageData *newImageData(Data *data);
 
+	/**
+	 * Decodes many encoded image files at once, spread across the shared
+	 * worker pool. Files which fail to decode get a null ImageData and the
+	 * error message at the same index in errors.
+	 * @param files The FileData objects containing the encoded image data.
+	 * @param[out] imagedatas The new ImageData, in the same order as files.
+	 * @param[out] errors Empty strings for files which decoded successfully.
+	 **/
+	void newImageDatas(const std::vector<Data *> &files, std::vector<StrongRef<ImageData>> &imagedatas, std::vector<std::string> &errors);
+
 	/**
 	 * Creates empty ImageData with the given size.
 	 * @param width The width of the ImageData.
@@ -100,6 +112,12 @@ public:
 
 	const std::list<FormatHandler *> &getFormatHandlers() const;
 
+	/**
+	 * Sets the compressed pixel formats the GPU supports, so formats which are
+	 * transcoded at load time (e.g. Basis Universal) can pick the best one.
+	 **/
+	void setSupportedCompressedFormats(const std::vector<PixelFormat> &formats);
+
 private:
 
 	ImageData *newPastedImageData(ImageData *src, int sx, int sy, int w, int h);
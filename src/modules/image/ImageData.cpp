@@ -20,7 +20,15 @@
 
 #include "ImageData.h"
 #include "Image.h"
+#include "RowConverters.h"
+#include "common/profiling.h"
 #include "filesystem/Filesystem.h"
+#include "filesystem/AssetCache.h"
+#include "thread/WorkerPool.h"
+
+// C++
+#include <algorithm>
+#include <vector>
 
 using love::thread::Lock;
 
@@ -61,7 +69,10 @@ ImageData::ImageData(int width, int height, PixelFormat format, void *data, bool
 	this->format = format;
 
 	if (own)
+	{
 		this->data = (unsigned char *) data;
+		setNativeMemorySize(type, getSize());
+	}
 	else
 		create(width, height, format, data);
 }
@@ -106,10 +117,82 @@ void ImageData::create(int width, int height, PixelFormat format, void *data)
 
 	decodeHandler = nullptr;
 	this->format = format;
+
+	setNativeMemorySize(type, datasize);
+}
+
+using filesystem::AssetCache;
+
+// Decoded images in the AssetCache are this header followed by the pixels.
+struct CachedImageHeader
+{
+	int32 width;
+	int32 height;
+	uint32 format;
+	uint32 padding;
+};
+
+// Must change whenever decoders change their output.
+static const char *IMAGEDATA_CACHE_PARAMS = "imagedata 1";
+
+bool ImageData::loadCached(const std::string &key)
+{
+	AssetCache::Entry entry;
+	if (!AssetCache::load(AssetCache::CATEGORY_IMAGEDATA, key, entry) || entry.size < sizeof(CachedImageHeader))
+		return false;
+
+	CachedImageHeader header;
+	memcpy(&header, entry.payload, sizeof(CachedImageHeader));
+
+	PixelFormat pixelformat = (PixelFormat) header.format;
+	if (header.width <= 0 || header.height <= 0 || header.format >= PIXELFORMAT_MAX_ENUM || !validPixelFormat(pixelformat))
+		return false;
+
+	size_t pixelsize = (size_t) header.width * header.height * getPixelFormatSize(pixelformat);
+	if (entry.size != sizeof(CachedImageHeader) + pixelsize)
+		return false;
+
+	if (decodeHandler)
+		decodeHandler->freeRawPixels(this->data);
+	else
+		delete[] this->data;
+
+	this->data = nullptr;
+	this->width = header.width;
+	this->height = header.height;
+
+	create(width, height, pixelformat, (void *) (entry.payload + sizeof(CachedImageHeader)));
+	return true;
+}
+
+void ImageData::saveCached(const std::string &key) const
+{
+	std::vector<uint8> contents(sizeof(CachedImageHeader) + getSize());
+
+	CachedImageHeader header = {};
+	header.width = width;
+	header.height = height;
+	header.format = (uint32) format;
+
+	memcpy(contents.data(), &header, sizeof(CachedImageHeader));
+	memcpy(contents.data() + sizeof(CachedImageHeader), data, getSize());
+
+	AssetCache::save(AssetCache::CATEGORY_IMAGEDATA, key, contents.data(), contents.size());
 }
 
 void ImageData::decode(Data *data)
 {
+	LOVE_PROFILE_ZONE("ImageData:decode");
+
+	// Warm starts skip decoding and format conversion entirely.
+	std::string cachekey;
+	if (AssetCache::isEnabled(AssetCache::CATEGORY_IMAGEDATA))
+	{
+		cachekey = AssetCache::getKey(data->getData(), data->getSize(), IMAGEDATA_CACHE_PARAMS);
+		if (loadCached(cachekey))
+			return;
+	}
+
 	FormatHandler *decoder = nullptr;
 	FormatHandler::DecodedImage decodedimage;
 
@@ -161,9 +244,14 @@ void ImageData::decode(Data *data)
 	this->format = decodedimage.format;
 
 	decodeHandler = decoder;
+
+	setNativeMemorySize(type, decodedimage.size);
+
+	if (!cachekey.empty())
+		saveCached(cachekey);
 }
 
-love::filesystem::FileData *ImageData::encode(FormatHandler::EncodedFormat encodedFormat, const char *filename, bool writefile) const
+love::filesystem::FileData *ImageData::encode(FormatHandler::EncodedFormat encodedFormat, const char *filename, bool writefile, const FormatHandler::EncodeSettings &settings) const
 {
 	FormatHandler *encoder = nullptr;
 	FormatHandler::EncodedImage encodedimage;
@@ -192,7 +280,7 @@ love::filesystem::FileData *ImageData::encode(FormatHandler::EncodedFormat encod
 	if (encoder != nullptr)
 	{
 		thread::Lock lock(mutex);
-		encodedimage = encoder->encode(rawimage, encodedFormat);
+		encodedimage = encoder->encode(rawimage, encodedFormat, settings);
 	}
 
 	if (encoder == nullptr || encodedimage.data == nullptr)
@@ -359,113 +447,250 @@ void ImageData::paste(ImageData *src, int dx, int dy, int sx, int sy, int sw, in
 			Row rowsrc = {s + (sx + (i + sy) * srcW) * srcpixelsize};
 			Row rowdst = {d + (dx + (i + dy) * dstW) * dstpixelsize};
 
-			if (srcformat == dstformat)
-				memcpy(rowdst.u8, rowsrc.u8, srcpixelsize * sw);
-
-			else if (srcformat == PIXELFORMAT_RGBA8 && dstformat == PIXELFORMAT_RGBA16)
-				pasteRGBA8toRGBA16(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA8 && dstformat == PIXELFORMAT_RGBA16F)
-				pasteRGBA8toRGBA16F(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA8 && dstformat == PIXELFORMAT_RGBA32F)
-				pasteRGBA8toRGBA32F(rowsrc, rowdst, sw);
-
-			else if (srcformat == PIXELFORMAT_RGBA16 && dstformat == PIXELFORMAT_RGBA8)
-				pasteRGBA16toRGBA8(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA16 && dstformat == PIXELFORMAT_RGBA16F)
-				pasteRGBA16toRGBA16F(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA16 && dstformat == PIXELFORMAT_RGBA32F)
-				pasteRGBA16toRGBA32F(rowsrc, rowdst, sw);
-
-			else if (srcformat == PIXELFORMAT_RGBA16F && dstformat == PIXELFORMAT_RGBA8)
-				pasteRGBA16FtoRGBA8(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA16F && dstformat == PIXELFORMAT_RGBA16)
-				pasteRGBA16FtoRGBA16(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA16F && dstformat == PIXELFORMAT_RGBA32F)
-				pasteRGBA16FtoRGBA32F(rowsrc, rowdst, sw);
-
-			else if (srcformat == PIXELFORMAT_RGBA32F && dstformat == PIXELFORMAT_RGBA8)
-				pasteRGBA32FtoRGBA8(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA32F && dstformat == PIXELFORMAT_RGBA16)
-				pasteRGBA32FtoRGBA16(rowsrc, rowdst, sw);
-			else if (srcformat == PIXELFORMAT_RGBA32F && dstformat == PIXELFORMAT_RGBA16F)
-				pasteRGBA32FtoRGBA16F(rowsrc, rowdst, sw);
-
-			else
-				throw love::Exception("Unsupported pixel format combination in ImageData:paste!");
+			convertRow(srcformat, rowsrc.u8, dstformat, rowdst.u8, sw);
 		}
 	}
 }
 
+void ImageData::convertRow(PixelFormat srcformat, const void *srcrow, PixelFormat dstformat, void *dstrow, int w)
+{
+	Row src = {(uint8 *) srcrow};
+	Row dst = {(uint8 *) dstrow};
+
+	if (srcformat == dstformat)
+		memcpy(dst.u8, src.u8, getPixelFormatSize(srcformat) * w);
+
+	else if (srcformat == PIXELFORMAT_RGBA8 && dstformat == PIXELFORMAT_RGBA16)
+		pasteRGBA8toRGBA16(src, dst, w);
+	else if (srcformat == PIXELFORMAT_RGBA8 && dstformat == PIXELFORMAT_RGBA16F)
+		pasteRGBA8toRGBA16F(src, dst, w);
+	else if (srcformat == PIXELFORMAT_RGBA8 && dstformat == PIXELFORMAT_RGBA32F)
+		pasteRGBA8toRGBA32F(src, dst, w);
+
+	else if (srcformat == PIXELFORMAT_RGBA16 && dstformat == PIXELFORMAT_RGBA8)
+		pasteRGBA16toRGBA8(src, dst, w);
+	else if (srcformat == PIXELFORMAT_RGBA16 && dstformat == PIXELFORMAT_RGBA16F)
+		pasteRGBA16toRGBA16F(src, dst, w);
+	else if (srcformat == PIXELFORMAT_RGBA16 && dstformat == PIXELFORMAT_RGBA32F)
+		pasteRGBA16toRGBA32F(src, dst, w);
+
+	else if (srcformat == PIXELFORMAT_RGBA16F && dstformat == PIXELFORMAT_RGBA8)
+		pasteRGBA16FtoRGBA8(src, dst, w);
+	else if (srcformat == PIXELFORMAT_RGBA16F && dstformat == PIXELFORMAT_RGBA16)
+		pasteRGBA16FtoRGBA16(src, dst, w);
+	else if (srcformat == PIXELFORMAT_RGBA16F && dstformat == PIXELFORMAT_RGBA32F)
+		pasteRGBA16FtoRGBA32F(src, dst, w);
+
+	else if (srcformat == PIXELFORMAT_RGBA32F && dstformat == PIXELFORMAT_RGBA8)
+		pasteRGBA32FtoRGBA8(src, dst, w);
+	else if (srcformat == PIXELFORMAT_RGBA32F && dstformat == PIXELFORMAT_RGBA16)
+		pasteRGBA32FtoRGBA16(src, dst, w);
+	else if (srcformat == PIXELFORMAT_RGBA32F && dstformat == PIXELFORMAT_RGBA16F)
+		pasteRGBA32FtoRGBA16F(src, dst, w);
+
+	else
+		throw love::Exception("Unsupported pixel format combination in ImageData:paste!");
+}
+
+void ImageData::convertColors(ColorConversion conversion, int x, int y, int w, int h)
+{
+	transformColors(x, y, w, h,
+		[&](float *rgba, size_t count) { love::convertColors(conversion, rgba, count); },
+		[&](uint8 *rgba, size_t count) { love::convertColors(conversion, rgba, count); });
+}
+
+void ImageData::swizzle(const int order[4], int x, int y, int w, int h)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		if (order[i] < 0 || order[i] > 3)
+			throw love::Exception("Invalid color channel: %d", order[i] + 1);
+	}
+
+	transformColors(x, y, w, h,
+		[&](float *rgba, size_t count) { love::swizzleColors(order, rgba, count); },
+		[&](uint8 *rgba, size_t count) { love::swizzleColors(order, rgba, count); });
+}
+
+void ImageData::transformColors(int x, int y, int w, int h, const std::function<void(float *, size_t)> &floatfn, const std::function<void(uint8 *, size_t)> &u8fn)
+{
+	// Rows handed to each worker task, and the smallest region worth
+	// splitting across threads.
+	const int ROWS_PER_TASK = 32;
+	const int MIN_PARALLEL_PIXELS = 256 * 256;
+
+	int x2 = std::min(x + w, getWidth());
+	int y2 = std::min(y + h, getHeight());
+	x = std::max(x, 0);
+	y = std::max(y, 0);
+
+	if (x >= x2 || y >= y2)
+		return;
+
+	w = x2 - x;
+	h = y2 - y;
+
+	PixelFormat format = getFormat();
+	size_t pixelsize = getPixelSize();
+	size_t rowsize = getWidth() * pixelsize;
+
+	Lock lock(mutex);
+
+	auto task = [&](int i)
+	{
+		int start = y + i * ROWS_PER_TASK;
+		int end = std::min(start + ROWS_PER_TASK, y2);
+
+		std::vector<float> scratch;
+		if (format == PIXELFORMAT_RGBA16 || format == PIXELFORMAT_RGBA16F)
+			scratch.resize(w * 4);
+
+		for (int row = start; row < end; row++)
+		{
+			Row pixels;
+			pixels.u8 = data + row * rowsize + x * pixelsize;
+
+			switch (format)
+			{
+			case PIXELFORMAT_RGBA8:
+				u8fn(pixels.u8, w);
+				break;
+			case PIXELFORMAT_RGBA32F:
+				floatfn(pixels.f32, w);
+				break;
+			case PIXELFORMAT_RGBA16:
+				for (int c = 0; c < w * 4; c++)
+					scratch[c] = pixels.u16[c] / 65535.0f;
+				floatfn(scratch.data(), w);
+				for (int c = 0; c < w * 4; c++)
+					pixels.u16[c] = (uint16) (std::min(std::max(scratch[c], 0.0f), 1.0f) * 65535.0f + 0.5f);
+				break;
+			case PIXELFORMAT_RGBA16F:
+				for (int c = 0; c < w * 4; c++)
+					scratch[c] = halfToFloat(pixels.f16[c]);
+				floatfn(scratch.data(), w);
+				for (int c = 0; c < w * 4; c++)
+					pixels.f16[c] = floatToHalf(scratch[c]);
+				break;
+			default:
+				break;
+			}
+		}
+	};
+
+	int tasks = (h + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+
+	if (tasks > 1 && w * h >= MIN_PARALLEL_PIXELS)
+		love::thread::WorkerPool::getShared().parallelFor(tasks, task);
+	else
+	{
+		for (int i = 0; i < tasks; i++)
+			task(i);
+	}
+}
+
+// Half-float rows are converted through float in chunks of this many
+// components, so the vectorized converters can be used for both halves.
+static const int HALF_CHUNK_SIZE = 1024;
+
 void ImageData::pasteRGBA8toRGBA16(Row src, Row dst, int w)
 {
-	for (int i = 0; i < w * 4; i++)
+	int i = (int) rowconverters::unorm8ToUnorm16(src.u8, dst.u16, w * 4);
+	for (; i < w * 4; i++)
 		dst.u16[i] = (uint16) src.u8[i] << 8u;
 }
 
 void ImageData::pasteRGBA8toRGBA16F(Row src, Row dst, int w)
 {
-	for (int i = 0; i < w * 4; i++)
-		dst.f16[i] = floatToHalf(src.u8[i] / 255.0f);
+	float temp[HALF_CHUNK_SIZE];
+
+	for (int i = 0; i < w * 4; i += HALF_CHUNK_SIZE)
+	{
+		int count = std::min(w * 4 - i, HALF_CHUNK_SIZE);
+		pasteRGBA8toRGBA32F({src.u8 + i}, {(uint8 *) temp}, count / 4);
+		floatToHalf(temp, dst.f16 + i, count);
+	}
 }
 
 void ImageData::pasteRGBA8toRGBA32F(Row src, Row dst, int w)
 {
-	for (int i = 0; i < w * 4; i++)
+	int i = (int) rowconverters::unorm8ToFloat(src.u8, dst.f32, w * 4);
+	for (; i < w * 4; i++)
 		dst.f32[i] = src.u8[i] / 255.0f;
 }
 
 void ImageData::pasteRGBA16toRGBA8(Row src, Row dst, int w)
 {
-	for (int i = 0; i < w * 4; i++)
+	int i = (int) rowconverters::unorm16ToUnorm8(src.u16, dst.u8, w * 4);
+	for (; i < w * 4; i++)
 		dst.u8[i] = src.u16[i] >> 8u;
 }
 
 void ImageData::pasteRGBA16toRGBA16F(Row src, Row dst, int w)
 {
-	for (int i = 0; i < w * 4; i++)
-		dst.f16[i] = floatToHalf(src.u16[i] / 65535.0f);
+	float temp[HALF_CHUNK_SIZE];
+
+	for (int i = 0; i < w * 4; i += HALF_CHUNK_SIZE)
+	{
+		int count = std::min(w * 4 - i, HALF_CHUNK_SIZE);
+		pasteRGBA16toRGBA32F({(uint8 *) (src.u16 + i)}, {(uint8 *) temp}, count / 4);
+		floatToHalf(temp, dst.f16 + i, count);
+	}
 }
 
 void ImageData::pasteRGBA16toRGBA32F(Row src, Row dst, int w)
 {
-	for (int i = 0; i < w * 4; i++)
+	int i = (int) rowconverters::unorm16ToFloat(src.u16, dst.f32, w * 4);
+	for (; i < w * 4; i++)
 		dst.f32[i] = src.u16[i] / 65535.0f;
 }
 
 void ImageData::pasteRGBA16FtoRGBA8(Row src, Row dst, int w)
 {
-	for (int i = 0; i < w * 4; i++)
-		dst.u8[i] = (uint8) (halfToFloat(src.f16[i]) * 255.0f);
+	float temp[HALF_CHUNK_SIZE];
+
+	for (int i = 0; i < w * 4; i += HALF_CHUNK_SIZE)
+	{
+		int count = std::min(w * 4 - i, HALF_CHUNK_SIZE);
+		halfToFloat(src.f16 + i, temp, count);
+		pasteRGBA32FtoRGBA8({(uint8 *) temp}, {dst.u8 + i}, count / 4);
+	}
 }
 
 void ImageData::pasteRGBA16FtoRGBA16(Row src, Row dst, int w)
 {
-	for (int i = 0; i < w * 4; i++)
-		dst.u16[i] = (uint16) (halfToFloat(src.f16[i]) * 65535.0f);
+	float temp[HALF_CHUNK_SIZE];
+
+	for (int i = 0; i < w * 4; i += HALF_CHUNK_SIZE)
+	{
+		int count = std::min(w * 4 - i, HALF_CHUNK_SIZE);
+		halfToFloat(src.f16 + i, temp, count);
+		pasteRGBA32FtoRGBA16({(uint8 *) temp}, {(uint8 *) (dst.u16 + i)}, count / 4);
+	}
 }
 
 void ImageData::pasteRGBA16FtoRGBA32F(Row src, Row dst, int w)
 {
-	for (int i = 0; i < w * 4; i++)
-		dst.f32[i] = halfToFloat(src.f16[i]);
+	halfToFloat(src.f16, dst.f32, w * 4);
 }
 
 void ImageData::pasteRGBA32FtoRGBA8(Row src, Row dst, int w)
 {
-	for (int i = 0; i < w * 4; i++)
+	int i = (int) rowconverters::floatToUnorm8(src.f32, dst.u8, w * 4);
+	for (; i < w * 4; i++)
 		dst.u8[i] = (uint8) (src.f32[i] * 255.0f);
 }
 
 void ImageData::pasteRGBA32FtoRGBA16(Row src, Row dst, int w)
 {
-	for (int i = 0; i < w * 4; i++)
+	int i = (int) rowconverters::floatToUnorm16(src.f32, dst.u16, w * 4);
+	for (; i < w * 4; i++)
 		dst.u16[i] = (uint16) (src.f32[i] * 65535.0f);
 }
 
 void ImageData::pasteRGBA32FtoRGBA16F(Row src, Row dst, int w)
 {
-	for (int i = 0; i < w * 4; i++)
-		dst.f16[i] = (uint16) floatToHalf(src.f32[i]);
+	floatToHalf(src.f32, dst.f16, w * 4);
 }
 
 love::thread::Mutex *ImageData::getMutex() const
@@ -511,6 +736,7 @@ StringMap<FormatHandler::EncodedFormat, FormatHandler::ENCODED_MAX_ENUM>::Entry
 {
 	{"tga", FormatHandler::ENCODED_TGA},
 	{"png", FormatHandler::ENCODED_PNG},
+	{"qoi", FormatHandler::ENCODED_QOI},
 };
 
 StringMap<FormatHandler::EncodedFormat, FormatHandler::ENCODED_MAX_ENUM> ImageData::encodedFormats(ImageData::encodedFormatEntries, sizeof(ImageData::encodedFormatEntries));
@@ -26,11 +26,15 @@
 #include "common/int.h"
 #include "common/pixelformat.h"
 #include "common/halffloat.h"
+#include "common/colorconvert.h"
 #include "filesystem/FileData.h"
 #include "thread/threads.h"
 #include "ImageDataBase.h"
 #include "FormatHandler.h"
 
+// C++
+#include <functional>
+
 using love::thread::Mutex;
 
 namespace love
@@ -73,6 +77,26 @@ public:
 	 **/
 	void paste(ImageData *src, int dx, int dy, int sx, int sy, int sw, int sh);
 
+	/**
+	 * Converts the colors of a rectangle of pixels in place, e.g. from sRGB
+	 * to linear or to premultiplied alpha. The rectangle is clipped to the
+	 * ImageData.
+	 **/
+	void convertColors(ColorConversion conversion, int x, int y, int w, int h);
+
+	/**
+	 * Reorders the color channels of a rectangle of pixels in place.
+	 * @param order Source channel (0-3) of each destination channel.
+	 **/
+	void swizzle(const int order[4], int x, int y, int w, int h);
+
+	/**
+	 * Converts a row of w pixels between two supported ImageData formats,
+	 * using the same converters as paste. Float values outside [0, 1] must be
+	 * clamped beforehand when converting to RGBA8 or RGBA16.
+	 **/
+	static void convertRow(PixelFormat srcformat, const void *src, PixelFormat dstformat, void *dst, int w);
+
 	/**
 	 * Checks whether a position is inside this ImageData. Useful for checking bounds.
 	 * @param x The position along the x-axis.
@@ -100,8 +124,9 @@ public:
 	 * Encodes raw pixel data into a given format.
 	 * @param f The file to save the encoded image data to.
 	 * @param format The format of the encoded data.
+	 * @param settings Encoder options, e.g. favoring speed over output size.
 	 **/
-	love::filesystem::FileData *encode(FormatHandler::EncodedFormat format, const char *filename, bool writefile) const;
+	love::filesystem::FileData *encode(FormatHandler::EncodedFormat format, const char *filename, bool writefile, const FormatHandler::EncodeSettings &settings = FormatHandler::EncodeSettings()) const;
 
 	love::thread::Mutex *getMutex() const;
 
@@ -132,6 +157,10 @@ private:
 	// Create imagedata. Initialize with data if not null.
 	void create(int width, int height, PixelFormat format, void *data = nullptr);
 
+	// Decoded pixels in the AssetCache, keyed by the encoded file.
+	bool loadCached(const std::string &key);
+	void saveCached(const std::string &key) const;
+
 	// Decode and load an encoded format.
 	void decode(Data *data);
 
@@ -144,6 +173,10 @@ private:
 	// this so we can properly delete memory allocated by the decoder.
 	StrongRef<FormatHandler> decodeHandler;
 
+	// Applies one of the color functions to every row of a rectangle, with
+	// RGBA16 and RGBA16F rows going through float.
+	void transformColors(int x, int y, int w, int h, const std::function<void(float *, size_t)> &floatfn, const std::function<void(uint8 *, size_t)> &u8fn);
+
 	static void pasteRGBA8toRGBA16(Row src, Row dst, int w);
 	static void pasteRGBA8toRGBA16F(Row src, Row dst, int w);
 	static void pasteRGBA8toRGBA32F(Row src, Row dst, int w);
@@ -0,0 +1,782 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "ImageOperations.h"
+#include "ImageData.h"
+#include "common/colorconvert.h"
+#include "common/config.h"
+#include "common/Exception.h"
+#include "thread/WorkerPool.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+#if defined(LOVE_SIMD_SSE)
+#include <xmmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace love
+{
+namespace image
+{
+
+using love::thread::Lock;
+
+namespace
+{
+
+// Rows handed to each worker task, and the smallest number of pixels worth
+// splitting across threads.
+const int ROWS_PER_TASK = 16;
+const int MIN_PARALLEL_PIXELS = 128 * 128;
+
+// One RGBA pixel, in a SIMD register where available.
+struct Float4
+{
+#if defined(LOVE_SIMD_SSE)
+	__m128 v;
+#elif defined(LOVE_SIMD_NEON)
+	float32x4_t v;
+#else
+	float v[4];
+#endif
+};
+
+#if defined(LOVE_SIMD_SSE)
+
+inline Float4 load4(const float *p) { return {_mm_loadu_ps(p)}; }
+inline void store4(float *p, Float4 a) { _mm_storeu_ps(p, a.v); }
+inline Float4 splat4(float s) { return {_mm_set1_ps(s)}; }
+inline Float4 add4(Float4 a, Float4 b) { return {_mm_add_ps(a.v, b.v)}; }
+inline Float4 sub4(Float4 a, Float4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline Float4 mul4(Float4 a, Float4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline Float4 madd4(Float4 a, Float4 b, Float4 c) { return {_mm_add_ps(_mm_mul_ps(a.v, b.v), c.v)}; }
+inline Float4 clamp4(Float4 a, Float4 lo, Float4 hi) { return {_mm_min_ps(_mm_max_ps(a.v, lo.v), hi.v)}; }
+
+inline Float4 setAlpha4(Float4 a, float alpha)
+{
+	__m128 t = _mm_shuffle_ps(a.v, _mm_set1_ps(alpha), _MM_SHUFFLE(0, 0, 2, 2));
+	return {_mm_shuffle_ps(a.v, t, _MM_SHUFFLE(2, 0, 1, 0))};
+}
+
+#elif defined(LOVE_SIMD_NEON)
+
+inline Float4 load4(const float *p) { return {vld1q_f32(p)}; }
+inline void store4(float *p, Float4 a) { vst1q_f32(p, a.v); }
+inline Float4 splat4(float s) { return {vdupq_n_f32(s)}; }
+inline Float4 add4(Float4 a, Float4 b) { return {vaddq_f32(a.v, b.v)}; }
+inline Float4 sub4(Float4 a, Float4 b) { return {vsubq_f32(a.v, b.v)}; }
+inline Float4 mul4(Float4 a, Float4 b) { return {vmulq_f32(a.v, b.v)}; }
+inline Float4 madd4(Float4 a, Float4 b, Float4 c) { return {vmlaq_f32(c.v, a.v, b.v)}; }
+inline Float4 clamp4(Float4 a, Float4 lo, Float4 hi) { return {vminq_f32(vmaxq_f32(a.v, lo.v), hi.v)}; }
+inline Float4 setAlpha4(Float4 a, float alpha) { return {vsetq_lane_f32(alpha, a.v, 3)}; }
+
+#else
+
+inline Float4 load4(const float *p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline void store4(float *p, Float4 a) { memcpy(p, a.v, sizeof(float) * 4); }
+inline Float4 splat4(float s) { return {{s, s, s, s}}; }
+inline Float4 add4(Float4 a, Float4 b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+inline Float4 sub4(Float4 a, Float4 b) { return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}}; }
+inline Float4 mul4(Float4 a, Float4 b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+inline Float4 madd4(Float4 a, Float4 b, Float4 c) { return add4(mul4(a, b), c); }
+
+inline Float4 clamp4(Float4 a, Float4 lo, Float4 hi)
+{
+	for (int i = 0; i < 4; i++)
+		a.v[i] = std::min(std::max(a.v[i], lo.v[i]), hi.v[i]);
+	return a;
+}
+
+inline Float4 setAlpha4(Float4 a, float alpha) { a.v[3] = alpha; return a; }
+
+#endif
+
+void forRows(int rows, int width, const std::function<void(int, int)> &fn)
+{
+	int tasks = (rows + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+
+	auto task = [&](int i)
+	{
+		int start = i * ROWS_PER_TASK;
+		fn(start, std::min(start + ROWS_PER_TASK, rows));
+	};
+
+	if (tasks > 1 && (int64) rows * width >= MIN_PARALLEL_PIXELS)
+		love::thread::WorkerPool::getShared().parallelFor(tasks, task);
+	else
+	{
+		for (int i = 0; i < tasks; i++)
+			task(i);
+	}
+}
+
+inline uint8 *getPixels(ImageData *data, int x, int y)
+{
+	return (uint8 *) data->getData() + ((size_t) y * data->getWidth() + x) * data->getPixelSize();
+}
+
+void loadRow(ImageData *data, int x, int y, int w, float *dst)
+{
+	ImageData::convertRow(data->getFormat(), getPixels(data, x, y), PIXELFORMAT_RGBA32F, dst, w);
+}
+
+// Clamps src in place if the ImageData can't hold values outside [0, 1].
+void storeRow(ImageData *data, int x, int y, int w, float *src)
+{
+	PixelFormat format = data->getFormat();
+
+	if (format == PIXELFORMAT_RGBA8 || format == PIXELFORMAT_RGBA16)
+	{
+		const Float4 zero = splat4(0.0f);
+		const Float4 one = splat4(1.0f);
+
+		for (int i = 0; i < w; i++)
+			store4(src + i * 4, clamp4(load4(src + i * 4), zero, one));
+	}
+
+	ImageData::convertRow(PIXELFORMAT_RGBA32F, src, format, getPixels(data, x, y), w);
+}
+
+struct FloatImage
+{
+	int width;
+	int height;
+	std::vector<float> pixels;
+
+	FloatImage(int w, int h)
+		: width(w)
+		, height(h)
+		, pixels((size_t) w * h * 4)
+	{}
+
+	float *row(int y) { return &pixels[(size_t) y * width * 4]; }
+	const float *row(int y) const { return &pixels[(size_t) y * width * 4]; }
+};
+
+void load(ImageData *data, FloatImage &img, bool premultiply)
+{
+	forRows(img.height, img.width, [&](int y0, int y1)
+	{
+		for (int y = y0; y < y1; y++)
+		{
+			loadRow(data, 0, y, img.width, img.row(y));
+			if (premultiply)
+				convertColors(COLOR_CONVERSION_PREMULTIPLY, img.row(y), img.width);
+		}
+	});
+}
+
+void store(FloatImage &img, ImageData *data, bool unpremultiply)
+{
+	forRows(img.height, img.width, [&](int y0, int y1)
+	{
+		for (int y = y0; y < y1; y++)
+		{
+			if (unpremultiply)
+				convertColors(COLOR_CONVERSION_UNPREMULTIPLY, img.row(y), img.width);
+			storeRow(data, 0, y, img.width, img.row(y));
+		}
+	});
+}
+
+// Source pixels and weights contributing to each destination pixel along one
+// axis of a resample or separable filter.
+struct Contributions
+{
+	std::vector<int> offsets;
+	std::vector<int> indices;
+	std::vector<float> weights;
+
+	int count(int i) const { return offsets[i + 1] - offsets[i]; }
+};
+
+float filterWeight(ImageOperations::Filter filter, float x)
+{
+	x = fabsf(x);
+
+	if (filter == ImageOperations::FILTER_CUBIC)
+	{
+		// Catmull-Rom.
+		if (x < 1.0f)
+			return (1.5f * x - 2.5f) * x * x + 1.0f;
+		else if (x < 2.0f)
+			return ((-0.5f * x + 2.5f) * x - 4.0f) * x + 2.0f;
+		return 0.0f;
+	}
+
+	return std::max(1.0f - x, 0.0f);
+}
+
+Contributions getResampleContributions(int srcsize, int dstsize, ImageOperations::Filter filter)
+{
+	Contributions c;
+	c.offsets.reserve(dstsize + 1);
+
+	float scale = (float) dstsize / (float) srcsize;
+	float filterscale = std::max(1.0f / scale, 1.0f);
+	float support = (filter == ImageOperations::FILTER_CUBIC ? 2.0f : 1.0f) * filterscale;
+
+	for (int i = 0; i < dstsize; i++)
+	{
+		c.offsets.push_back((int) c.indices.size());
+
+		float center = (i + 0.5f) / scale - 0.5f;
+		int lo = (int) ceilf(center - support);
+		int hi = (int) floorf(center + support);
+
+		float total = 0.0f;
+		size_t first = c.weights.size();
+
+		for (int j = lo; j <= hi; j++)
+		{
+			float w = filterWeight(filter, (j - center) / filterscale);
+			if (w == 0.0f)
+				continue;
+
+			c.indices.push_back(std::min(std::max(j, 0), srcsize - 1));
+			c.weights.push_back(w);
+			total += w;
+		}
+
+		if (total != 0.0f)
+		{
+			for (size_t j = first; j < c.weights.size(); j++)
+				c.weights[j] /= total;
+		}
+		else
+		{
+			c.indices.push_back(std::min(std::max((int) (center + 0.5f), 0), srcsize - 1));
+			c.weights.push_back(1.0f);
+		}
+	}
+
+	c.offsets.push_back((int) c.indices.size());
+	return c;
+}
+
+Contributions getKernelContributions(int size, const std::vector<float> &kernel)
+{
+	Contributions c;
+	int radius = (int) kernel.size() / 2;
+
+	for (int i = 0; i < size; i++)
+	{
+		c.offsets.push_back((int) c.indices.size());
+		for (int k = 0; k < (int) kernel.size(); k++)
+		{
+			c.indices.push_back(std::min(std::max(i + k - radius, 0), size - 1));
+			c.weights.push_back(kernel[k]);
+		}
+	}
+
+	c.offsets.push_back((int) c.indices.size());
+	return c;
+}
+
+void filterHorizontal(const FloatImage &src, FloatImage &dst, const Contributions &c)
+{
+	forRows(dst.height, dst.width, [&](int y0, int y1)
+	{
+		for (int y = y0; y < y1; y++)
+		{
+			const float *s = src.row(y);
+			float *d = dst.row(y);
+
+			for (int x = 0; x < dst.width; x++)
+			{
+				const int *indices = &c.indices[c.offsets[x]];
+				const float *weights = &c.weights[c.offsets[x]];
+				int count = c.count(x);
+
+				Float4 sum = splat4(0.0f);
+				for (int i = 0; i < count; i++)
+					sum = madd4(load4(s + indices[i] * 4), splat4(weights[i]), sum);
+
+				store4(d + x * 4, sum);
+			}
+		}
+	});
+}
+
+void filterVertical(const FloatImage &src, FloatImage &dst, const Contributions &c)
+{
+	forRows(dst.height, dst.width, [&](int y0, int y1)
+	{
+		for (int y = y0; y < y1; y++)
+		{
+			const int *indices = &c.indices[c.offsets[y]];
+			const float *weights = &c.weights[c.offsets[y]];
+			int count = c.count(y);
+
+			float *d = dst.row(y);
+			std::fill(d, d + dst.width * 4, 0.0f);
+
+			for (int i = 0; i < count; i++)
+			{
+				const float *s = src.row(indices[i]);
+				Float4 w = splat4(weights[i]);
+
+				for (int x = 0; x < dst.width; x++)
+					store4(d + x * 4, madd4(load4(s + x * 4), w, load4(d + x * 4)));
+			}
+		}
+	});
+}
+
+// Clips a source rectangle and destination position to both images, the
+// same way ImageData::paste does. Returns false if nothing is left.
+bool clipRects(int dstW, int dstH, int srcW, int srcH, int &dx, int &dy, int &sx, int &sy, int &sw, int &sh)
+{
+	if (dx < 0)
+	{
+		sw += dx;
+		sx -= dx;
+		dx = 0;
+	}
+	if (dy < 0)
+	{
+		sh += dy;
+		sy -= dy;
+		dy = 0;
+	}
+	if (sx < 0)
+	{
+		sw += sx;
+		dx -= sx;
+		sx = 0;
+	}
+	if (sy < 0)
+	{
+		sh += sy;
+		dy -= sy;
+		sy = 0;
+	}
+
+	sw = std::min(sw, std::min(dstW - dx, srcW - sx));
+	sh = std::min(sh, std::min(dstH - dy, srcH - sy));
+
+	return sw > 0 && sh > 0;
+}
+
+} // anonymous namespace
+
+void ImageOperations::fillRectangle(ImageData *dst, int x, int y, int w, int h, const float color[4])
+{
+	int x2 = std::min(x + w, dst->getWidth());
+	int y2 = std::min(y + h, dst->getHeight());
+	x = std::max(x, 0);
+	y = std::max(y, 0);
+
+	if (x >= x2 || y >= y2)
+		return;
+
+	w = x2 - x;
+	h = y2 - y;
+
+	PixelFormat format = dst->getFormat();
+	size_t rowsize = w * dst->getPixelSize();
+
+	// Convert one row of the color, then copy it to every row.
+	std::vector<float> colors(w * 4);
+	for (int i = 0; i < w; i++)
+		memcpy(&colors[i * 4], color, sizeof(float) * 4);
+
+	if (format == PIXELFORMAT_RGBA8 || format == PIXELFORMAT_RGBA16)
+	{
+		for (float &c : colors)
+			c = std::min(std::max(c, 0.0f), 1.0f);
+	}
+
+	std::vector<uint8> row(rowsize);
+	ImageData::convertRow(PIXELFORMAT_RGBA32F, colors.data(), format, row.data(), w);
+
+	Lock lock(dst->getMutex());
+
+	forRows(h, w, [&](int y0, int y1)
+	{
+		for (int i = y0; i < y1; i++)
+			memcpy(getPixels(dst, x, y + i), row.data(), rowsize);
+	});
+}
+
+void ImageOperations::blend(ImageData *dst, ImageData *src, int dx, int dy, int sx, int sy, int sw, int sh)
+{
+	if (!clipRects(dst->getWidth(), dst->getHeight(), src->getWidth(), src->getHeight(), dx, dy, sx, sy, sw, sh))
+		return;
+
+	Lock lock2(src->getMutex());
+	Lock lock1(dst->getMutex());
+
+	forRows(sh, sw, [&](int y0, int y1)
+	{
+		std::vector<float> srcrow(sw * 4);
+		std::vector<float> dstrow(sw * 4);
+
+		for (int i = y0; i < y1; i++)
+		{
+			loadRow(src, sx, sy + i, sw, srcrow.data());
+			loadRow(dst, dx, dy + i, sw, dstrow.data());
+
+			for (int x = 0; x < sw; x++)
+			{
+				float *d = &dstrow[x * 4];
+				const float *s = &srcrow[x * 4];
+
+				float sa = s[3];
+				float f = d[3] * (1.0f - sa);
+				float alpha = sa + f;
+				float invalpha = alpha > 0.0f ? 1.0f / alpha : 0.0f;
+
+				Float4 c = madd4(load4(s), splat4(sa), mul4(load4(d), splat4(f)));
+				store4(d, setAlpha4(mul4(c, splat4(invalpha)), alpha));
+			}
+
+			storeRow(dst, dx, dy + i, sw, dstrow.data());
+		}
+	});
+}
+
+ImageData *ImageOperations::resize(ImageData *src, int width, int height, Filter filter)
+{
+	if (width <= 0 || height <= 0)
+		throw love::Exception("Invalid ImageData dimensions: %dx%d", width, height);
+
+	PixelFormat format = src->getFormat();
+	int srcW = src->getWidth();
+	int srcH = src->getHeight();
+
+	StrongRef<ImageData> dst(new ImageData(width, height, format), Acquire::NORETAIN);
+
+	Lock lock(src->getMutex());
+
+	if (filter == FILTER_NEAREST)
+	{
+		size_t pixelsize = src->getPixelSize();
+
+		forRows(height, width, [&](int y0, int y1)
+		{
+			for (int y = y0; y < y1; y++)
+			{
+				int sy = std::min((int) ((y + 0.5f) * srcH / height), srcH - 1);
+				uint8 *d = getPixels(dst, 0, y);
+				const uint8 *s = getPixels(src, 0, sy);
+
+				for (int x = 0; x < width; x++)
+				{
+					int sx = std::min((int) ((x + 0.5f) * srcW / width), srcW - 1);
+					memcpy(d + x * pixelsize, s + sx * pixelsize, pixelsize);
+				}
+			}
+		});
+
+		dst->retain();
+		return dst.get();
+	}
+
+	FloatImage source(srcW, srcH);
+	load(src, source, true);
+
+	FloatImage horizontal(width, srcH);
+	filterHorizontal(source, horizontal, getResampleContributions(srcW, width, filter));
+
+	FloatImage result(width, height);
+	filterVertical(horizontal, result, getResampleContributions(srcH, height, filter));
+
+	store(result, dst, true);
+
+	dst->retain();
+	return dst.get();
+}
+
+void ImageOperations::flip(ImageData *data, bool horizontal, bool vertical)
+{
+	int w = data->getWidth();
+	int h = data->getHeight();
+	size_t pixelsize = data->getPixelSize();
+	size_t rowsize = w * pixelsize;
+
+	Lock lock(data->getMutex());
+
+	if (horizontal)
+	{
+		forRows(h, w, [&](int y0, int y1)
+		{
+			uint8 temp[16];
+
+			for (int y = y0; y < y1; y++)
+			{
+				uint8 *row = getPixels(data, 0, y);
+
+				for (int x = 0; x < w / 2; x++)
+				{
+					uint8 *a = row + x * pixelsize;
+					uint8 *b = row + (w - 1 - x) * pixelsize;
+					memcpy(temp, a, pixelsize);
+					memcpy(a, b, pixelsize);
+					memcpy(b, temp, pixelsize);
+				}
+			}
+		});
+	}
+
+	if (vertical)
+	{
+		forRows(h / 2, w, [&](int y0, int y1)
+		{
+			std::vector<uint8> temp(rowsize);
+
+			for (int y = y0; y < y1; y++)
+			{
+				uint8 *a = getPixels(data, 0, y);
+				uint8 *b = getPixels(data, 0, h - 1 - y);
+				memcpy(temp.data(), a, rowsize);
+				memcpy(a, b, rowsize);
+				memcpy(b, temp.data(), rowsize);
+			}
+		});
+	}
+}
+
+ImageData *ImageOperations::rotate(ImageData *src, int quarterTurns)
+{
+	quarterTurns = ((quarterTurns % 4) + 4) % 4;
+
+	int srcW = src->getWidth();
+	int srcH = src->getHeight();
+	int dstW = (quarterTurns % 2) == 0 ? srcW : srcH;
+	int dstH = (quarterTurns % 2) == 0 ? srcH : srcW;
+	size_t pixelsize = src->getPixelSize();
+
+	StrongRef<ImageData> dst(new ImageData(dstW, dstH, src->getFormat()), Acquire::NORETAIN);
+
+	Lock lock(src->getMutex());
+
+	forRows(dstH, dstW, [&](int y0, int y1)
+	{
+		for (int y = y0; y < y1; y++)
+		{
+			uint8 *d = getPixels(dst, 0, y);
+
+			for (int x = 0; x < dstW; x++)
+			{
+				int sx = x;
+				int sy = y;
+
+				if (quarterTurns == 1)
+				{
+					sx = y;
+					sy = srcH - 1 - x;
+				}
+				else if (quarterTurns == 2)
+				{
+					sx = srcW - 1 - x;
+					sy = srcH - 1 - y;
+				}
+				else if (quarterTurns == 3)
+				{
+					sx = srcW - 1 - y;
+					sy = x;
+				}
+
+				memcpy(d + x * pixelsize, getPixels(src, sx, sy), pixelsize);
+			}
+		}
+	});
+
+	dst->retain();
+	return dst.get();
+}
+
+void ImageOperations::convolve(ImageData *data, const std::vector<float> &kernel, int size)
+{
+	if (size <= 0 || size % 2 == 0 || (int) kernel.size() != size * size)
+		throw love::Exception("Convolution kernels must be square, with an odd width.");
+
+	int w = data->getWidth();
+	int h = data->getHeight();
+	int radius = size / 2;
+
+	Lock lock(data->getMutex());
+
+	FloatImage source(w, h);
+	load(data, source, false);
+
+	FloatImage result(w, h);
+
+	forRows(h, w, [&](int y0, int y1)
+	{
+		std::vector<int> columns(w * size);
+		for (int x = 0; x < w; x++)
+		{
+			for (int k = 0; k < size; k++)
+				columns[x * size + k] = std::min(std::max(x + k - radius, 0), w - 1) * 4;
+		}
+
+		for (int y = y0; y < y1; y++)
+		{
+			float *d = result.row(y);
+
+			for (int x = 0; x < w; x++)
+			{
+				Float4 sum = splat4(0.0f);
+
+				for (int ky = 0; ky < size; ky++)
+				{
+					const float *s = source.row(std::min(std::max(y + ky - radius, 0), h - 1));
+					const float *weights = &kernel[ky * size];
+					const int *cols = &columns[x * size];
+
+					for (int kx = 0; kx < size; kx++)
+						sum = madd4(load4(s + cols[kx]), splat4(weights[kx]), sum);
+				}
+
+				store4(d + x * 4, sum);
+			}
+		}
+	});
+
+	store(result, data, false);
+}
+
+void ImageOperations::blur(ImageData *data, float sigma)
+{
+	if (!(sigma > 0.0f))
+		return;
+
+	int w = data->getWidth();
+	int h = data->getHeight();
+	int radius = std::min((int) ceilf(sigma * 3.0f), std::max(w, h));
+
+	std::vector<float> kernel(radius * 2 + 1);
+	float total = 0.0f;
+
+	for (int i = -radius; i <= radius; i++)
+	{
+		float weight = expf(-(i * i) / (2.0f * sigma * sigma));
+		kernel[i + radius] = weight;
+		total += weight;
+	}
+
+	for (float &weight : kernel)
+		weight /= total;
+
+	Lock lock(data->getMutex());
+
+	FloatImage image(w, h);
+	load(data, image, true);
+
+	FloatImage temp(w, h);
+	filterHorizontal(image, temp, getKernelContributions(w, kernel));
+	filterVertical(temp, image, getKernelContributions(h, kernel));
+
+	store(image, data, true);
+}
+
+void ImageOperations::sharpen(ImageData *data, float amount)
+{
+	std::vector<float> kernel =
+	{
+		0.0f,    -amount,               0.0f,
+		-amount, 1.0f + 4.0f * amount, -amount,
+		0.0f,    -amount,               0.0f,
+	};
+
+	convolve(data, kernel, 3);
+}
+
+void ImageOperations::transformChannels(ImageData *data, const float matrix[16], const float offset[4])
+{
+	int w = data->getWidth();
+	int h = data->getHeight();
+
+	// Columns of the matrix, so each output is a sum of scaled columns.
+	float columns[4][4];
+	for (int c = 0; c < 4; c++)
+	{
+		for (int r = 0; r < 4; r++)
+			columns[c][r] = matrix[r * 4 + c];
+	}
+
+	Lock lock(data->getMutex());
+
+	forRows(h, w, [&](int y0, int y1)
+	{
+		const Float4 col0 = load4(columns[0]);
+		const Float4 col1 = load4(columns[1]);
+		const Float4 col2 = load4(columns[2]);
+		const Float4 col3 = load4(columns[3]);
+		const Float4 add = load4(offset);
+
+		std::vector<float> row(w * 4);
+
+		for (int y = y0; y < y1; y++)
+		{
+			loadRow(data, 0, y, w, row.data());
+
+			for (int x = 0; x < w; x++)
+			{
+				float *p = &row[x * 4];
+				Float4 r = madd4(col0, splat4(p[0]), add);
+				r = madd4(col1, splat4(p[1]), r);
+				r = madd4(col2, splat4(p[2]), r);
+				r = madd4(col3, splat4(p[3]), r);
+				store4(p, r);
+			}
+
+			storeRow(data, 0, y, w, row.data());
+		}
+	});
+}
+
+bool ImageOperations::getConstant(const char *in, Filter &out)
+{
+	return filters.find(in, out);
+}
+
+bool ImageOperations::getConstant(Filter in, const char *&out)
+{
+	return filters.find(in, out);
+}
+
+std::vector<std::string> ImageOperations::getConstants(Filter)
+{
+	return filters.getNames();
+}
+
+StringMap<ImageOperations::Filter, ImageOperations::FILTER_MAX_ENUM>::Entry ImageOperations::filterEntries[] =
+{
+	{ "nearest", FILTER_NEAREST },
+	{ "linear",  FILTER_LINEAR  },
+	{ "cubic",   FILTER_CUBIC   },
+};
+
+StringMap<ImageOperations::Filter, ImageOperations::FILTER_MAX_ENUM> ImageOperations::filters(ImageOperations::filterEntries, sizeof(ImageOperations::filterEntries));
+
+} // image
+} // love
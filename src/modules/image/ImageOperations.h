@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_IMAGE_IMAGE_OPERATIONS_H
+#define LOVE_IMAGE_IMAGE_OPERATIONS_H
+
+// LOVE
+#include "common/StringMap.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace image
+{
+
+class ImageData;
+
+/**
+ * Native whole-image and region operations on ImageData. Pixels are
+ * processed as RGBA floats a row at a time, so every supported format
+ * behaves the same, and rows are split across the shared worker pool for
+ * large images.
+ **/
+class ImageOperations
+{
+public:
+
+	enum Filter
+	{
+		FILTER_NEAREST,
+		FILTER_LINEAR,
+		FILTER_CUBIC,
+		FILTER_MAX_ENUM
+	};
+
+	/**
+	 * Sets every pixel in a rectangle (clipped to the image) to a color.
+	 **/
+	static void fillRectangle(ImageData *dst, int x, int y, int w, int h, const float color[4]);
+
+	/**
+	 * Like ImageData::paste, but alpha-blends the source over the destination
+	 * instead of replacing it. Colors are not premultiplied.
+	 **/
+	static void blend(ImageData *dst, ImageData *src, int dx, int dy, int sx, int sy, int sw, int sh);
+
+	/**
+	 * Creates a resampled copy of an ImageData, in the same format. Filtering
+	 * is done with premultiplied alpha, and the filter widens when
+	 * downscaling so small results don't alias.
+	 **/
+	static ImageData *resize(ImageData *src, int width, int height, Filter filter);
+
+	/**
+	 * Mirrors an ImageData in place.
+	 **/
+	static void flip(ImageData *data, bool horizontal, bool vertical);
+
+	/**
+	 * Creates a copy of an ImageData rotated clockwise by a multiple of 90
+	 * degrees.
+	 **/
+	static ImageData *rotate(ImageData *src, int quarterTurns);
+
+	/**
+	 * Convolves an ImageData in place with a square kernel of odd size, given
+	 * in row-major order. Edge pixels are extended.
+	 **/
+	static void convolve(ImageData *data, const std::vector<float> &kernel, int size);
+
+	/**
+	 * Gaussian blur in place, with premultiplied alpha.
+	 **/
+	static void blur(ImageData *data, float sigma);
+
+	/**
+	 * Sharpens an ImageData in place with a 3x3 Laplacian kernel.
+	 **/
+	static void sharpen(ImageData *data, float amount);
+
+	/**
+	 * Replaces each pixel p with matrix * p + offset, where matrix is 4x4 in
+	 * row-major order.
+	 **/
+	static void transformChannels(ImageData *data, const float matrix[16], const float offset[4]);
+
+	static bool getConstant(const char *in, Filter &out);
+	static bool getConstant(Filter in, const char *&out);
+	static std::vector<std::string> getConstants(Filter);
+
+private:
+
+	static StringMap<Filter, FILTER_MAX_ENUM>::Entry filterEntries[];
+	static StringMap<Filter, FILTER_MAX_ENUM> filters;
+
+}; // ImageOperations
+
+} // image
+} // love
+
+#endif // LOVE_IMAGE_IMAGE_OPERATIONS_H
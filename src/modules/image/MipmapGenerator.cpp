@@ -0,0 +1,522 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "MipmapGenerator.h"
+#include "common/halffloat.h"
+#include "common/math.h"
+#include "common/Exception.h"
+#include "thread/WorkerPool.h"
+#include "filesystem/AssetCache.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#if defined(LOVE_SIMD_SSE)
+#include <xmmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace love
+{
+namespace image
+{
+
+namespace
+{
+
+// Rows handed to a worker at a time.
+const int ROWS_PER_TASK = 16;
+
+float sinc(float x)
+{
+	if (fabsf(x) < 1e-5f)
+		return 1.0f;
+
+	x *= (float) LOVE_M_PI;
+	return sinf(x) / x;
+}
+
+// Zeroth order modified Bessel function of the first kind.
+float besselI0(float x)
+{
+	float sum = 1.0f;
+	float term = 1.0f;
+	float halfx = x * 0.5f;
+
+	for (int k = 1; k < 32; k++)
+	{
+		term *= (halfx / k) * (halfx / k);
+		sum += term;
+
+		if (term < sum * 1e-8f)
+			break;
+	}
+
+	return sum;
+}
+
+float getFilterRadius(MipmapGenerator::Filter filter)
+{
+	switch (filter)
+	{
+	case MipmapGenerator::FILTER_KAISER:
+		return 3.0f;
+	case MipmapGenerator::FILTER_LANCZOS:
+		return 3.0f;
+	case MipmapGenerator::FILTER_BOX:
+	default:
+		return 0.5f;
+	}
+}
+
+float evaluateFilter(MipmapGenerator::Filter filter, float x)
+{
+	x = fabsf(x);
+
+	switch (filter)
+	{
+	case MipmapGenerator::FILTER_KAISER:
+	{
+		// Kaiser-windowed sinc, alpha = 4.
+		const float radius = 3.0f;
+		const float alpha = 4.0f;
+
+		if (x >= radius)
+			return 0.0f;
+
+		float t = x / radius;
+		return sinc(x) * besselI0(alpha * sqrtf(1.0f - t * t)) / besselI0(alpha);
+	}
+	case MipmapGenerator::FILTER_LANCZOS:
+		return x < 3.0f ? sinc(x) * sinc(x / 3.0f) : 0.0f;
+	case MipmapGenerator::FILTER_BOX:
+	default:
+		return x <= 0.5f ? 1.0f : 0.0f;
+	}
+}
+
+// The source pixels (and their normalized weights) which contribute to each
+// destination pixel along one axis.
+struct Contributions
+{
+	std::vector<int> first;
+	std::vector<int> count;
+	std::vector<float> weights;
+	int maxCount;
+};
+
+Contributions computeContributions(MipmapGenerator::Filter filter, int srcsize, int dstsize)
+{
+	Contributions c;
+
+	float scale = (float) srcsize / (float) dstsize;
+	float radius = getFilterRadius(filter) * scale;
+
+	c.maxCount = (int) ceilf(radius * 2.0f) + 2;
+	c.first.resize(dstsize);
+	c.count.resize(dstsize);
+	c.weights.resize(dstsize * c.maxCount, 0.0f);
+
+	for (int i = 0; i < dstsize; i++)
+	{
+		float center = (i + 0.5f) * scale;
+
+		int first = std::max((int) floorf(center - radius), 0);
+		int last = std::min((int) ceilf(center + radius), srcsize - 1);
+
+		float *w = &c.weights[i * c.maxCount];
+		float total = 0.0f;
+		int count = 0;
+
+		for (int j = first; j <= last && count < c.maxCount; j++)
+		{
+			float weight = 0.0f;
+
+			if (filter == MipmapGenerator::FILTER_BOX)
+			{
+				// Exact coverage of the source pixel by the destination pixel.
+				float lo = std::max((float) j, center - radius);
+				float hi = std::min((float) j + 1.0f, center + radius);
+				weight = std::max(hi - lo, 0.0f);
+			}
+			else
+				weight = evaluateFilter(filter, (j + 0.5f - center) / scale);
+
+			w[count++] = weight;
+			total += weight;
+		}
+
+		// Trim zero weights from the start so the first index is useful.
+		int skip = 0;
+		while (skip < count - 1 && w[skip] == 0.0f)
+			skip++;
+
+		if (skip > 0)
+		{
+			std::copy(w + skip, w + count, w);
+			std::fill(w + count - skip, w + count, 0.0f);
+			count -= skip;
+			first += skip;
+		}
+
+		if (total != 0.0f)
+		{
+			for (int k = 0; k < count; k++)
+				w[k] /= total;
+		}
+
+		c.first[i] = first;
+		c.count[i] = count;
+	}
+
+	return c;
+}
+
+// dst[0..3] += src[0..3] * w
+inline void madd4(float *dst, const float *src, float w)
+{
+#if defined(LOVE_SIMD_SSE)
+	_mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(_mm_loadu_ps(src), _mm_set1_ps(w))));
+#elif defined(LOVE_SIMD_NEON)
+	vst1q_f32(dst, vmlaq_n_f32(vld1q_f32(dst), vld1q_f32(src), w));
+#else
+	dst[0] += src[0] * w;
+	dst[1] += src[1] * w;
+	dst[2] += src[2] * w;
+	dst[3] += src[3] * w;
+#endif
+}
+
+float toLinear(float c)
+{
+	if (c <= 0.04045f)
+		return c / 12.92f;
+	else
+		return powf((c + 0.055f) / 1.055f, 2.4f);
+}
+
+float toGamma(float c)
+{
+	if (c <= 0.0031308f)
+		return c * 12.92f;
+	else
+		return 1.055f * powf(c, 1.0f / 2.4f) - 0.055f;
+}
+
+void forRows(int rows, bool parallel, const std::function<void(int, int)> &fn)
+{
+	int tasks = (rows + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+
+	auto task = [&](int i)
+	{
+		int start = i * ROWS_PER_TASK;
+		fn(start, std::min(start + ROWS_PER_TASK, rows));
+	};
+
+	if (parallel)
+		love::thread::WorkerPool::getShared().parallelFor(tasks, task);
+	else
+	{
+		for (int i = 0; i < tasks; i++)
+			task(i);
+	}
+}
+
+// Converts the ImageData to straight RGBA floats, with linear colors if srgb.
+void decodeToFloat(const ImageData *src, bool srgb, std::vector<float> &dst, bool parallel)
+{
+	int w = src->getWidth();
+	int h = src->getHeight();
+	PixelFormat format = src->getFormat();
+
+	dst.resize((size_t) w * h * 4);
+
+	float lut[256];
+	for (int i = 0; i < 256; i++)
+		lut[i] = srgb ? toLinear(i / 255.0f) : i / 255.0f;
+
+	const uint8 *data = (const uint8 *) src->getData();
+	size_t rowsize = src->getPixelSize() * w;
+
+	forRows(h, parallel, [&](int start, int end)
+	{
+		for (int y = start; y < end; y++)
+		{
+			const uint8 *row = data + rowsize * y;
+			float *out = &dst[(size_t) y * w * 4];
+
+			for (int i = 0; i < w * 4; i++)
+			{
+				bool color = (i & 3) != 3;
+				float v = 0.0f;
+
+				if (format == PIXELFORMAT_RGBA8)
+				{
+					out[i] = color ? lut[row[i]] : row[i] / 255.0f;
+					continue;
+				}
+				else if (format == PIXELFORMAT_RGBA16)
+					v = ((const uint16 *) row)[i] / 65535.0f;
+				else if (format == PIXELFORMAT_RGBA16F)
+					v = halfToFloat(((const half *) row)[i]);
+				else
+					v = ((const float *) row)[i];
+
+				out[i] = (srgb && color) ? toLinear(v) : v;
+			}
+		}
+	});
+}
+
+void encodeFromFloat(const std::vector<float> &src, bool srgb, ImageData *dst, bool parallel)
+{
+	int w = dst->getWidth();
+	int h = dst->getHeight();
+	PixelFormat format = dst->getFormat();
+
+	uint8 *data = (uint8 *) dst->getData();
+	size_t rowsize = dst->getPixelSize() * w;
+
+	forRows(h, parallel, [&](int start, int end)
+	{
+		for (int y = start; y < end; y++)
+		{
+			uint8 *row = data + rowsize * y;
+			const float *in = &src[(size_t) y * w * 4];
+
+			for (int i = 0; i < w * 4; i++)
+			{
+				float v = in[i];
+
+				if (srgb && (i & 3) != 3)
+					v = toGamma(std::max(v, 0.0f));
+
+				if (format == PIXELFORMAT_RGBA8)
+					row[i] = (uint8) (std::min(std::max(v, 0.0f), 1.0f) * 255.0f + 0.5f);
+				else if (format == PIXELFORMAT_RGBA16)
+					((uint16 *) row)[i] = (uint16) (std::min(std::max(v, 0.0f), 1.0f) * 65535.0f + 0.5f);
+				else if (format == PIXELFORMAT_RGBA16F)
+					((half *) row)[i] = floatToHalf(v);
+				else
+					((float *) row)[i] = v;
+			}
+		}
+	});
+}
+
+// Separable resize of an RGBA float image.
+void downsample(MipmapGenerator::Filter filter, const std::vector<float> &src, int srcw, int srch, std::vector<float> &dst, int dstw, int dsth, bool parallel)
+{
+	Contributions cx = computeContributions(filter, srcw, dstw);
+	Contributions cy = computeContributions(filter, srch, dsth);
+
+	// Horizontal pass: srch rows of dstw pixels.
+	std::vector<float> temp((size_t) dstw * srch * 4);
+
+	forRows(srch, parallel, [&](int start, int end)
+	{
+		for (int y = start; y < end; y++)
+		{
+			const float *in = &src[(size_t) y * srcw * 4];
+			float *out = &temp[(size_t) y * dstw * 4];
+
+			for (int x = 0; x < dstw; x++)
+			{
+				float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+				const float *w = &cx.weights[x * cx.maxCount];
+				const float *p = in + cx.first[x] * 4;
+
+				for (int k = 0; k < cx.count[x]; k++)
+					madd4(acc, p + k * 4, w[k]);
+
+				std::copy(acc, acc + 4, out + x * 4);
+			}
+		}
+	});
+
+	// Vertical pass, which accumulates whole rows at a time so memory access
+	// stays sequential.
+	dst.assign((size_t) dstw * dsth * 4, 0.0f);
+
+	forRows(dsth, parallel, [&](int start, int end)
+	{
+		for (int y = start; y < end; y++)
+		{
+			float *out = &dst[(size_t) y * dstw * 4];
+			const float *w = &cy.weights[y * cy.maxCount];
+
+			for (int k = 0; k < cy.count[y]; k++)
+			{
+				const float *in = &temp[(size_t) (cy.first[y] + k) * dstw * 4];
+
+				for (int x = 0; x < dstw; x++)
+					madd4(out + x * 4, in + x * 4, w[k]);
+			}
+		}
+	});
+}
+
+} // anonymous namespace
+
+using filesystem::AssetCache;
+
+// Cached mipmap chains are every level's pixels back to back, largest first.
+static bool loadCachedMipmaps(const std::string &key, const ImageData *src, std::vector<StrongRef<ImageData>> &mipmaps)
+{
+	AssetCache::Entry entry;
+	if (!AssetCache::load(AssetCache::CATEGORY_MIPMAPS, key, entry))
+		return false;
+
+	PixelFormat format = src->getFormat();
+	size_t pixelsize = getPixelFormatSize(format);
+
+	int w = src->getWidth();
+	int h = src->getHeight();
+	size_t expectedsize = 0;
+
+	while (w > 1 || h > 1)
+	{
+		w = std::max(w / 2, 1);
+		h = std::max(h / 2, 1);
+		expectedsize += (size_t) w * h * pixelsize;
+	}
+
+	if (entry.size != expectedsize)
+		return false;
+
+	const uint8 *pixels = entry.payload;
+
+	w = src->getWidth();
+	h = src->getHeight();
+
+	while (w > 1 || h > 1)
+	{
+		w = std::max(w / 2, 1);
+		h = std::max(h / 2, 1);
+
+		StrongRef<ImageData> mip(new ImageData(w, h, format, (void *) pixels, false), Acquire::NORETAIN);
+		mipmaps.push_back(mip);
+
+		pixels += (size_t) w * h * pixelsize;
+	}
+
+	return true;
+}
+
+static void saveCachedMipmaps(const std::string &key, const std::vector<StrongRef<ImageData>> &mipmaps)
+{
+	std::vector<uint8> contents;
+
+	for (const auto &mip : mipmaps)
+	{
+		const uint8 *pixels = (const uint8 *) mip->getData();
+		contents.insert(contents.end(), pixels, pixels + mip->getSize());
+	}
+
+	AssetCache::save(AssetCache::CATEGORY_MIPMAPS, key, contents.data(), contents.size());
+}
+
+std::vector<StrongRef<ImageData>> MipmapGenerator::generate(ImageData *src, Filter filter, bool srgb, bool parallel)
+{
+	if (!ImageData::validPixelFormat(src->getFormat()))
+		throw love::Exception("Mipmaps can only be generated for ImageData with a RGBA pixel format.");
+
+	std::vector<StrongRef<ImageData>> mipmaps;
+
+	int w = src->getWidth();
+	int h = src->getHeight();
+
+	// Keyed by the source pixels and everything the filtering depends on. The
+	// number must change whenever the filters' output does.
+	std::string cachekey;
+	if (AssetCache::isEnabled(AssetCache::CATEGORY_MIPMAPS))
+	{
+		std::string params = "mipmaps 1 " + std::to_string(w) + "x" + std::to_string(h)
+			+ " " + std::to_string((int) src->getFormat()) + " " + std::to_string((int) filter) + (srgb ? " srgb" : "");
+
+		love::thread::Lock lock(src->getMutex());
+		cachekey = AssetCache::getKey(src->getData(), src->getSize(), params);
+
+		if (loadCachedMipmaps(cachekey, src, mipmaps))
+			return mipmaps;
+	}
+
+	std::vector<float> current;
+	std::vector<float> next;
+
+	{
+		love::thread::Lock lock(src->getMutex());
+		decodeToFloat(src, srgb, current, parallel);
+	}
+
+	while (w > 1 || h > 1)
+	{
+		int mipw = std::max(w / 2, 1);
+		int miph = std::max(h / 2, 1);
+
+		downsample(filter, current, w, h, next, mipw, miph, parallel);
+
+		StrongRef<ImageData> mip(new ImageData(mipw, miph, src->getFormat()), Acquire::NORETAIN);
+		encodeFromFloat(next, srgb, mip, parallel);
+		mipmaps.push_back(mip);
+
+		current.swap(next);
+		w = mipw;
+		h = miph;
+	}
+
+	if (!cachekey.empty() && !mipmaps.empty())
+		saveCachedMipmaps(cachekey, mipmaps);
+
+	return mipmaps;
+}
+
+bool MipmapGenerator::getConstant(const char *in, Filter &out)
+{
+	return filters.find(in, out);
+}
+
+bool MipmapGenerator::getConstant(Filter in, const char *&out)
+{
+	return filters.find(in, out);
+}
+
+std::vector<std::string> MipmapGenerator::getConstants(Filter)
+{
+	return filters.getNames();
+}
+
+StringMap<MipmapGenerator::Filter, MipmapGenerator::FILTER_MAX_ENUM>::Entry MipmapGenerator::filterEntries[] =
+{
+	{ "box",     FILTER_BOX     },
+	{ "kaiser",  FILTER_KAISER  },
+	{ "lanczos", FILTER_LANCZOS },
+};
+
+StringMap<MipmapGenerator::Filter, MipmapGenerator::FILTER_MAX_ENUM> MipmapGenerator::filters(MipmapGenerator::filterEntries, sizeof(MipmapGenerator::filterEntries));
+
+} // image
+} // love
@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/StringMap.h"
+#include "ImageData.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace image
+{
+
+/**
+ * Generates mipmap chains for ImageData on the CPU, with higher quality
+ * filtering than the GPU's (driver-dependent) mipmap generation.
+ **/
+class MipmapGenerator
+{
+public:
+
+	enum Filter
+	{
+		FILTER_BOX,
+		FILTER_KAISER,
+		FILTER_LANCZOS,
+		FILTER_MAX_ENUM
+	};
+
+	/**
+	 * Returns every mipmap level below the given ImageData, down to 1x1.
+	 * Each level is filtered from the previous one at full precision. If
+	 * srgb is true, color channels are averaged in linear space. Rows are
+	 * filtered in parallel on the shared worker pool if parallel is true.
+	 **/
+	static std::vector<StrongRef<ImageData>> generate(ImageData *src, Filter filter, bool srgb, bool parallel = true);
+
+	static bool getConstant(const char *in, Filter &out);
+	static bool getConstant(Filter in, const char *&out);
+	static std::vector<std::string> getConstants(Filter);
+
+private:
+
+	static StringMap<Filter, FILTER_MAX_ENUM>::Entry filterEntries[];
+	static StringMap<Filter, FILTER_MAX_ENUM> filters;
+
+}; // MipmapGenerator
+
+} // image
+} // love
@@ -0,0 +1,347 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "RowConverters.h"
+#include "common/config.h"
+#include "common/cpu.h"
+
+// C
+#include <string.h>
+
+#if defined(LOVE_CPU_X86)
+#include <immintrin.h>
+#elif defined(LOVE_SIMD_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace love
+{
+namespace image
+{
+namespace rowconverters
+{
+
+// The scalar converters divide by 255 and 65535 rather than multiplying by
+// the reciprocal, so the vector versions do too to give the same results.
+
+#if defined(LOVE_CPU_X86)
+
+LOVE_TARGET("sse4.1")
+static size_t unorm8ToFloatSSE41(const uint8 *src, float *dst, size_t count)
+{
+	const __m128 scale = _mm_set1_ps(255.0f);
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		int bytes;
+		memcpy(&bytes, src + i, sizeof(int));
+
+		__m128i v = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(bytes));
+		_mm_storeu_ps(dst + i, _mm_div_ps(_mm_cvtepi32_ps(v), scale));
+	}
+
+	return i;
+}
+
+LOVE_TARGET("avx2")
+static size_t unorm8ToFloatAVX2(const uint8 *src, float *dst, size_t count)
+{
+	const __m256 scale = _mm256_set1_ps(255.0f);
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (src + i)));
+		_mm256_storeu_ps(dst + i, _mm256_div_ps(_mm256_cvtepi32_ps(v), scale));
+	}
+
+	return i;
+}
+
+LOVE_TARGET("sse4.1")
+static size_t unorm16ToFloatSSE41(const uint16 *src, float *dst, size_t count)
+{
+	const __m128 scale = _mm_set1_ps(65535.0f);
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i v = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *) (src + i)));
+		_mm_storeu_ps(dst + i, _mm_div_ps(_mm_cvtepi32_ps(v), scale));
+	}
+
+	return i;
+}
+
+LOVE_TARGET("avx2")
+static size_t unorm16ToFloatAVX2(const uint16 *src, float *dst, size_t count)
+{
+	const __m256 scale = _mm256_set1_ps(65535.0f);
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256i v = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) (src + i)));
+		_mm256_storeu_ps(dst + i, _mm256_div_ps(_mm256_cvtepi32_ps(v), scale));
+	}
+
+	return i;
+}
+
+LOVE_TARGET("sse4.1")
+static size_t floatToUnorm8SSE41(const float *src, uint8 *dst, size_t count)
+{
+	const __m128 scale = _mm_set1_ps(255.0f);
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		// Truncate like the scalar cast, then saturate down to bytes.
+		__m128i v = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i), scale));
+		v = _mm_packus_epi32(v, v);
+		v = _mm_packus_epi16(v, v);
+		int bytes = _mm_cvtsi128_si32(v);
+		memcpy(dst + i, &bytes, sizeof(int));
+	}
+
+	return i;
+}
+
+LOVE_TARGET("avx2")
+static size_t floatToUnorm8AVX2(const float *src, uint8 *dst, size_t count)
+{
+	const __m256 scale = _mm256_set1_ps(255.0f);
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256i v = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale));
+		__m128i v16 = _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+		_mm_storel_epi64((__m128i *) (dst + i), _mm_packus_epi16(v16, v16));
+	}
+
+	return i;
+}
+
+LOVE_TARGET("sse4.1")
+static size_t floatToUnorm16SSE41(const float *src, uint16 *dst, size_t count)
+{
+	const __m128 scale = _mm_set1_ps(65535.0f);
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i v = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i), scale));
+		_mm_storel_epi64((__m128i *) (dst + i), _mm_packus_epi32(v, v));
+	}
+
+	return i;
+}
+
+LOVE_TARGET("avx2")
+static size_t floatToUnorm16AVX2(const float *src, uint16 *dst, size_t count)
+{
+	const __m256 scale = _mm256_set1_ps(65535.0f);
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256i v = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale));
+		_mm_storeu_si128((__m128i *) (dst + i), _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+	}
+
+	return i;
+}
+
+LOVE_TARGET("sse4.1")
+static size_t unorm8ToUnorm16SSE41(const uint8 *src, uint16 *dst, size_t count)
+{
+	const __m128i zero = _mm_setzero_si128();
+	size_t i = 0;
+
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i *) (src + i));
+
+		// Interleaving zero bytes below each byte shifts it left by 8.
+		_mm_storeu_si128((__m128i *) (dst + i), _mm_unpacklo_epi8(zero, v));
+		_mm_storeu_si128((__m128i *) (dst + i + 8), _mm_unpackhi_epi8(zero, v));
+	}
+
+	return i;
+}
+
+LOVE_TARGET("sse4.1")
+static size_t unorm16ToUnorm8SSE41(const uint16 *src, uint8 *dst, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i a = _mm_srli_epi16(_mm_loadu_si128((const __m128i *) (src + i)), 8);
+		__m128i b = _mm_srli_epi16(_mm_loadu_si128((const __m128i *) (src + i + 8)), 8);
+		_mm_storeu_si128((__m128i *) (dst + i), _mm_packus_epi16(a, b));
+	}
+
+	return i;
+}
+
+size_t unorm8ToFloat(const uint8 *src, float *dst, size_t count)
+{
+	const CPUFeatures &cpu = getCPUFeatures();
+	if (cpu.avx2)
+		return unorm8ToFloatAVX2(src, dst, count);
+	else if (cpu.sse41)
+		return unorm8ToFloatSSE41(src, dst, count);
+	return 0;
+}
+
+size_t unorm16ToFloat(const uint16 *src, float *dst, size_t count)
+{
+	const CPUFeatures &cpu = getCPUFeatures();
+	if (cpu.avx2)
+		return unorm16ToFloatAVX2(src, dst, count);
+	else if (cpu.sse41)
+		return unorm16ToFloatSSE41(src, dst, count);
+	return 0;
+}
+
+size_t floatToUnorm8(const float *src, uint8 *dst, size_t count)
+{
+	const CPUFeatures &cpu = getCPUFeatures();
+	if (cpu.avx2)
+		return floatToUnorm8AVX2(src, dst, count);
+	else if (cpu.sse41)
+		return floatToUnorm8SSE41(src, dst, count);
+	return 0;
+}
+
+size_t floatToUnorm16(const float *src, uint16 *dst, size_t count)
+{
+	const CPUFeatures &cpu = getCPUFeatures();
+	if (cpu.avx2)
+		return floatToUnorm16AVX2(src, dst, count);
+	else if (cpu.sse41)
+		return floatToUnorm16SSE41(src, dst, count);
+	return 0;
+}
+
+size_t unorm8ToUnorm16(const uint8 *src, uint16 *dst, size_t count)
+{
+	return getCPUFeatures().sse41 ? unorm8ToUnorm16SSE41(src, dst, count) : 0;
+}
+
+size_t unorm16ToUnorm8(const uint16 *src, uint8 *dst, size_t count)
+{
+	return getCPUFeatures().sse41 ? unorm16ToUnorm8SSE41(src, dst, count) : 0;
+}
+
+#elif defined(LOVE_SIMD_NEON) && defined(__aarch64__)
+
+size_t unorm8ToFloat(const uint8 *src, float *dst, size_t count)
+{
+	const float32x4_t scale = vdupq_n_f32(255.0f);
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		uint16x8_t v = vmovl_u8(vld1_u8(src + i));
+		vst1q_f32(dst + i, vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(v))), scale));
+		vst1q_f32(dst + i + 4, vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(v))), scale));
+	}
+
+	return i;
+}
+
+size_t unorm16ToFloat(const uint16 *src, float *dst, size_t count)
+{
+	const float32x4_t scale = vdupq_n_f32(65535.0f);
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+		vst1q_f32(dst + i, vdivq_f32(vcvtq_f32_u32(vmovl_u16(vld1_u16(src + i))), scale));
+
+	return i;
+}
+
+size_t floatToUnorm8(const float *src, uint8 *dst, size_t count)
+{
+	const float32x4_t scale = vdupq_n_f32(255.0f);
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		// vcvtq_u32_f32 truncates and saturates, like a clamped scalar cast.
+		uint32x4_t a = vcvtq_u32_f32(vmulq_f32(vld1q_f32(src + i), scale));
+		uint32x4_t b = vcvtq_u32_f32(vmulq_f32(vld1q_f32(src + i + 4), scale));
+		uint16x8_t v = vcombine_u16(vqmovn_u32(a), vqmovn_u32(b));
+		vst1_u8(dst + i, vqmovn_u16(v));
+	}
+
+	return i;
+}
+
+size_t floatToUnorm16(const float *src, uint16 *dst, size_t count)
+{
+	const float32x4_t scale = vdupq_n_f32(65535.0f);
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+		vst1_u16(dst + i, vqmovn_u32(vcvtq_u32_f32(vmulq_f32(vld1q_f32(src + i), scale))));
+
+	return i;
+}
+
+size_t unorm8ToUnorm16(const uint8 *src, uint16 *dst, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8)
+		vst1q_u16(dst + i, vshll_n_u8(vld1_u8(src + i), 8));
+
+	return i;
+}
+
+size_t unorm16ToUnorm8(const uint16 *src, uint8 *dst, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8)
+		vst1_u8(dst + i, vshrn_n_u16(vld1q_u16(src + i), 8));
+
+	return i;
+}
+
+#else
+
+size_t unorm8ToFloat(const uint8 *, float *, size_t) { return 0; }
+size_t unorm16ToFloat(const uint16 *, float *, size_t) { return 0; }
+size_t floatToUnorm8(const float *, uint8 *, size_t) { return 0; }
+size_t floatToUnorm16(const float *, uint16 *, size_t) { return 0; }
+size_t unorm8ToUnorm16(const uint8 *, uint16 *, size_t) { return 0; }
+size_t unorm16ToUnorm8(const uint16 *, uint8 *, size_t) { return 0; }
+
+#endif
+
+} // rowconverters
+} // image
+} // love
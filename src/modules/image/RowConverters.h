@@ -0,0 +1,55 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_IMAGE_ROW_CONVERTERS_H
+#define LOVE_IMAGE_ROW_CONVERTERS_H
+
+// LOVE
+#include "common/int.h"
+
+// C
+#include <stddef.h>
+
+namespace love
+{
+namespace image
+{
+namespace rowconverters
+{
+
+/**
+ * Vectorized versions of the ImageData::paste row converters, picked at
+ * runtime from the instruction sets the CPU supports. Each converts as many of
+ * the count components as it can in whole SIMD blocks, and returns how many it
+ * converted; the caller finishes the rest with the scalar code. Results are
+ * identical to the scalar converters for values in the [0, 1] range.
+ **/
+size_t unorm8ToFloat(const uint8 *src, float *dst, size_t count);
+size_t unorm16ToFloat(const uint16 *src, float *dst, size_t count);
+size_t floatToUnorm8(const float *src, uint8 *dst, size_t count);
+size_t floatToUnorm16(const float *src, uint16 *dst, size_t count);
+size_t unorm8ToUnorm16(const uint8 *src, uint16 *dst, size_t count);
+size_t unorm16ToUnorm8(const uint16 *src, uint8 *dst, size_t count);
+
+} // rowconverters
+} // image
+} // love
+
+#endif // LOVE_IMAGE_ROW_CONVERTERS_H
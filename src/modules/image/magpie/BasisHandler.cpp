@@ -0,0 +1,312 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "common/config.h"
+
+#ifdef LOVE_SUPPORT_BASISU
+
+// LOVE
+#include "BasisHandler.h"
+#include "common/int.h"
+#include "common/Exception.h"
+
+// Basis Universal
+#include <basisu_transcoder.h>
+
+// C
+#include <string.h>
+
+// C++
+#include <algorithm>
+
+namespace love
+{
+namespace image
+{
+namespace magpie
+{
+
+namespace
+{
+
+#define KTX2_IDENTIFIER_REF {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A}
+
+// The start of a KTX2 header. Basis Universal data is stored with an
+// undefined vkFormat.
+struct KTX2HeaderStart
+{
+	uint8  identifier[12];
+	uint32 vkFormat;
+};
+
+struct TranscodeTarget
+{
+	PixelFormat format;
+	basist::transcoder_texture_format basisFormat;
+};
+
+// Targets in order of preference. ETC1 data is valid ETC2 RGB data.
+const TranscodeTarget opaqueTargets[] =
+{
+	{ PIXELFORMAT_ASTC_4x4, basist::transcoder_texture_format::cTFASTC_4x4_RGBA },
+	{ PIXELFORMAT_BC7,      basist::transcoder_texture_format::cTFBC7_RGBA      },
+	{ PIXELFORMAT_ETC2_RGB, basist::transcoder_texture_format::cTFETC1_RGB      },
+	{ PIXELFORMAT_ETC1,     basist::transcoder_texture_format::cTFETC1_RGB      },
+	{ PIXELFORMAT_DXT1,     basist::transcoder_texture_format::cTFBC1_RGB       },
+};
+
+const TranscodeTarget alphaTargets[] =
+{
+	{ PIXELFORMAT_ASTC_4x4,  basist::transcoder_texture_format::cTFASTC_4x4_RGBA },
+	{ PIXELFORMAT_BC7,       basist::transcoder_texture_format::cTFBC7_RGBA      },
+	{ PIXELFORMAT_ETC2_RGBA, basist::transcoder_texture_format::cTFETC2_RGBA     },
+	{ PIXELFORMAT_DXT5,      basist::transcoder_texture_format::cTFBC3_RGBA      },
+};
+
+basist::transcoder_texture_format getBasisFormat(PixelFormat format, bool hasalpha)
+{
+	if (hasalpha)
+	{
+		for (const TranscodeTarget &target : alphaTargets)
+		{
+			if (target.format == format)
+				return target.basisFormat;
+		}
+	}
+	else
+	{
+		for (const TranscodeTarget &target : opaqueTargets)
+		{
+			if (target.format == format)
+				return target.basisFormat;
+		}
+	}
+
+	return basist::transcoder_texture_format::cTFTotalTextureFormats;
+}
+
+} // Anonymous namespace.
+
+BasisHandler::BasisHandler()
+{
+	basist::basisu_transcoder_init();
+}
+
+bool BasisHandler::canParseCompressed(Data *data)
+{
+	if (data->getSize() >= sizeof(KTX2HeaderStart))
+	{
+		KTX2HeaderStart *header = (KTX2HeaderStart *) data->getData();
+		uint8 ktx2identifier[12] = KTX2_IDENTIFIER_REF;
+
+		// KTX2 files with any other vkFormat are regular GPU formats, which
+		// we don't handle here.
+		if (memcmp(header->identifier, ktx2identifier, 12) == 0)
+			return header->vkFormat == 0;
+	}
+
+	basist::basisu_transcoder transcoder;
+	return transcoder.validate_header(data->getData(), (uint32) data->getSize());
+}
+
+void BasisHandler::setSupportedCompressedFormats(const std::vector<PixelFormat> &formats)
+{
+	love::thread::Lock lock(mutex);
+	supportedFormats = formats;
+}
+
+PixelFormat BasisHandler::getTargetFormat(bool hasalpha)
+{
+	love::thread::Lock lock(mutex);
+
+	auto supported = [&](PixelFormat format)
+	{
+		return std::find(supportedFormats.begin(), supportedFormats.end(), format) != supportedFormats.end();
+	};
+
+	if (hasalpha)
+	{
+		for (const TranscodeTarget &target : alphaTargets)
+		{
+			if (supported(target.format))
+				return target.format;
+		}
+	}
+	else
+	{
+		for (const TranscodeTarget &target : opaqueTargets)
+		{
+			if (supported(target.format))
+				return target.format;
+		}
+	}
+
+	return PIXELFORMAT_UNKNOWN;
+}
+
+StrongRef<CompressedMemory> BasisHandler::parseCompressed(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format, bool &sRGB)
+{
+	if (!canParseCompressed(filedata))
+		throw love::Exception("Could not decode compressed data (not a Basis Universal file?)");
+
+	uint8 ktx2identifier[12] = KTX2_IDENTIFIER_REF;
+
+	if (memcmp(filedata->getData(), ktx2identifier, 12) == 0)
+		return parseKTX2(filedata, images, format, sRGB);
+	else
+		return parseBasis(filedata, images, format, sRGB);
+}
+
+StrongRef<CompressedMemory> BasisHandler::parseKTX2(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format, bool &sRGB)
+{
+	basist::ktx2_transcoder transcoder;
+
+	if (!transcoder.init(filedata->getData(), (uint32) filedata->getSize()))
+		throw love::Exception("Could not parse KTX2 file.");
+
+	if (transcoder.get_faces() > 1)
+		throw love::Exception("Cubemap textures in KTX2 files are not supported.");
+
+	if (transcoder.get_layers() > 1)
+		throw love::Exception("Texture arrays in KTX2 files are not supported.");
+
+	bool hasalpha = transcoder.get_has_alpha();
+
+	PixelFormat cformat = getTargetFormat(hasalpha);
+	if (cformat == PIXELFORMAT_UNKNOWN)
+		throw love::Exception("Cannot transcode Basis Universal data: no supported compressed format is available.");
+
+	basist::transcoder_texture_format basisformat = getBasisFormat(cformat, hasalpha);
+	uint32 blocksize = basist::basis_get_bytes_per_block_or_pixel(basisformat);
+
+	if (!transcoder.start_transcoding())
+		throw love::Exception("Could not transcode KTX2 file.");
+
+	int levels = std::max((int) transcoder.get_levels(), 1);
+	size_t totalsize = 0;
+
+	for (int i = 0; i < levels; i++)
+	{
+		basist::ktx2_image_level_info info;
+		if (!transcoder.get_image_level_info(info, i, 0, 0))
+			throw love::Exception("Could not parse KTX2 file: invalid mipmap level.");
+
+		totalsize += info.m_total_blocks * blocksize;
+	}
+
+	StrongRef<CompressedMemory> memory;
+	memory.set(new CompressedMemory(totalsize), Acquire::NORETAIN);
+
+	size_t dataoffset = 0;
+
+	for (int i = 0; i < levels; i++)
+	{
+		basist::ktx2_image_level_info info;
+		transcoder.get_image_level_info(info, i, 0, 0);
+
+		size_t mipsize = info.m_total_blocks * blocksize;
+
+		if (!transcoder.transcode_image_level(i, 0, 0, memory->data + dataoffset, info.m_total_blocks, basisformat))
+			throw love::Exception("Could not transcode KTX2 file.");
+
+		auto slice = new CompressedSlice(cformat, (int) info.m_orig_width, (int) info.m_orig_height, memory, dataoffset, mipsize);
+		images.push_back(slice);
+		slice->release();
+
+		dataoffset += mipsize;
+	}
+
+	format = cformat;
+	sRGB = transcoder.get_dfd_transfer_func() == basist::KTX2_KHR_DF_TRANSFER_SRGB;
+
+	return memory;
+}
+
+StrongRef<CompressedMemory> BasisHandler::parseBasis(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format, bool &sRGB)
+{
+	const void *filebytes = filedata->getData();
+	uint32 filesize = (uint32) filedata->getSize();
+
+	basist::basisu_transcoder transcoder;
+	basist::basisu_image_info imageinfo;
+
+	// Only the first image in the file is used.
+	if (!transcoder.get_image_info(filebytes, filesize, imageinfo, 0))
+		throw love::Exception("Could not parse Basis Universal file.");
+
+	bool hasalpha = imageinfo.m_alpha_flag;
+
+	PixelFormat cformat = getTargetFormat(hasalpha);
+	if (cformat == PIXELFORMAT_UNKNOWN)
+		throw love::Exception("Cannot transcode Basis Universal data: no supported compressed format is available.");
+
+	basist::transcoder_texture_format basisformat = getBasisFormat(cformat, hasalpha);
+	uint32 blocksize = basist::basis_get_bytes_per_block_or_pixel(basisformat);
+
+	if (!transcoder.start_transcoding(filebytes, filesize))
+		throw love::Exception("Could not transcode Basis Universal file.");
+
+	int levels = std::max((int) imageinfo.m_total_levels, 1);
+	size_t totalsize = 0;
+
+	for (int i = 0; i < levels; i++)
+	{
+		uint32 w, h, blocks;
+		if (!transcoder.get_image_level_desc(filebytes, filesize, 0, i, w, h, blocks))
+			throw love::Exception("Could not parse Basis Universal file: invalid mipmap level.");
+
+		totalsize += blocks * blocksize;
+	}
+
+	StrongRef<CompressedMemory> memory;
+	memory.set(new CompressedMemory(totalsize), Acquire::NORETAIN);
+
+	size_t dataoffset = 0;
+
+	for (int i = 0; i < levels; i++)
+	{
+		uint32 w, h, blocks;
+		transcoder.get_image_level_desc(filebytes, filesize, 0, i, w, h, blocks);
+
+		size_t mipsize = blocks * blocksize;
+
+		if (!transcoder.transcode_image_level(filebytes, filesize, 0, i, memory->data + dataoffset, blocks, basisformat))
+			throw love::Exception("Could not transcode Basis Universal file.");
+
+		auto slice = new CompressedSlice(cformat, (int) w, (int) h, memory, dataoffset, mipsize);
+		images.push_back(slice);
+		slice->release();
+
+		dataoffset += mipsize;
+	}
+
+	// The .basis header doesn't say whether the data is sRGB-encoded, so it's
+	// up to the Image's settings.
+	format = cformat;
+	sRGB = false;
+
+	return memory;
+}
+
+} // magpie
+} // image
+} // love
+
+#endif // LOVE_SUPPORT_BASISU
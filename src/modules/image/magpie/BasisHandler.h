@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+#include "common/config.h"
+
+#ifdef LOVE_SUPPORT_BASISU
+
+// LOVE
+#include "image/FormatHandler.h"
+#include "thread/threads.h"
+
+namespace love
+{
+namespace image
+{
+namespace magpie
+{
+
+/**
+ * Handles Basis Universal files (.basis, and KTX2 files with ETC1S/BasisLZ or
+ * UASTC data). They're transcoded at load time to the best compressed format
+ * the system supports (see setSupportedCompressedFormats.)
+ **/
+class BasisHandler : public FormatHandler
+{
+public:
+
+	BasisHandler();
+	virtual ~BasisHandler() {}
+
+	// Implements FormatHandler.
+	bool canParseCompressed(Data *data) override;
+
+	StrongRef<CompressedMemory> parseCompressed(Data *filedata,
+	        std::vector<StrongRef<CompressedSlice>> &images,
+	        PixelFormat &format, bool &sRGB) override;
+
+	void setSupportedCompressedFormats(const std::vector<PixelFormat> &formats) override;
+
+private:
+
+	// Returns PIXELFORMAT_UNKNOWN if none of the transcoder's formats are
+	// supported.
+	PixelFormat getTargetFormat(bool hasalpha);
+
+	StrongRef<CompressedMemory> parseKTX2(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format, bool &sRGB);
+	StrongRef<CompressedMemory> parseBasis(Data *filedata, std::vector<StrongRef<CompressedSlice>> &images, PixelFormat &format, bool &sRGB);
+
+	// Compressed images can be parsed on other threads while the graphics
+	// module sets the supported formats.
+	love::thread::MutexRef mutex;
+	std::vector<PixelFormat> supportedFormats;
+
+}; // BasisHandler
+
+} // magpie
+} // image
+} // love
+
+#endif // LOVE_SUPPORT_BASISU
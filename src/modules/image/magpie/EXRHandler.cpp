@@ -192,7 +192,7 @@ FormatHandler::DecodedImage EXRHandler::decode(Data *data)
 	return img;
 }
 
-FormatHandler::EncodedImage EXRHandler::encode(const DecodedImage & /*img*/, EncodedFormat /*encodedFormat*/)
+FormatHandler::EncodedImage EXRHandler::encode(const DecodedImage & /*img*/, EncodedFormat /*encodedFormat*/, const EncodeSettings & /*settings*/)
 {
 	throw love::Exception("Invalid format.");
 }
@@ -354,14 +354,16 @@ StrongRef<CompressedMemory> KTXHandler::parseCompressed(Data *filedata, std::vec
 		fileoffset += mipsizepadded;
 	}
 
+	// The mipmap levels are referenced in-place rather than copied, so the
+	// memory covers all of the file's image data, including the size fields.
+	size_t datastart = sizeof(KTXHeader) + header.bytesOfKeyValueData;
+
 	StrongRef<CompressedMemory> memory;
-	memory.set(new CompressedMemory(totalsize), Acquire::NORETAIN);
+	memory.set(new CompressedMemory(filedata, datastart, fileoffset - datastart), Acquire::NORETAIN);
 
 	// Reset the file offset to the start of the file's image data.
-	fileoffset = sizeof(KTXHeader) + header.bytesOfKeyValueData;
-	size_t dataoffset = 0;
+	fileoffset = datastart;
 
-	// Copy each mipmap level of the image from the file to our block of memory.
 	for (int i = 0; i < (int) header.numberOfMipmapLevels; i++)
 	{
 		uint32 mipsize = *(uint32 *) (filebytes + fileoffset);
@@ -376,14 +378,11 @@ StrongRef<CompressedMemory> KTXHandler::parseCompressed(Data *filedata, std::vec
 		int width = (int) std::max(header.pixelWidth >> i, 1u);
 		int height = (int) std::max(header.pixelHeight >> i, 1u);
 
-		memcpy(memory->data + dataoffset, filebytes + fileoffset, mipsize);
-
-		auto slice = new CompressedSlice(cformat, width, height, memory, dataoffset, mipsize);
+		auto slice = new CompressedSlice(cformat, width, height, memory, fileoffset - datastart, mipsize);
 		images.push_back(slice);
 		slice->release();
 
 		fileoffset += mipsizepadded;
-		dataoffset += mipsizepadded;
 	}
 
 	format = cformat;
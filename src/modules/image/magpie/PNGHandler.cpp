@@ -23,6 +23,7 @@
 // LOVE
 #include "common/Exception.h"
 #include "common/math.h"
+#include "thread/WorkerPool.h"
 
 // LodePNG
 #include "lodepng/lodepng.h"
@@ -32,9 +33,11 @@
 
 // C++
 #include <algorithm>
+#include <vector>
 
 // C
 #include <cstdlib>
+#include <cstring>
 
 namespace love
 {
@@ -128,6 +131,239 @@ static unsigned zlibCompress(unsigned char **out, size_t *outsize, const unsigne
 	return 0; // Success.
 }
 
+// Fast encoding compresses the image in independent bands of rows, each
+// roughly this many bytes of filtered data.
+static const size_t FAST_BAND_SIZE = 256 * 1024;
+
+struct FastPNGBand
+{
+	std::vector<uint8> deflated;
+	uLong adler;
+	uLong crc;
+	size_t filteredSize;
+};
+
+// Copies a row of pixels in the byte order PNG stores them in.
+static void getPNGRow(const FormatHandler::DecodedImage &img, int y, size_t rowsize, uint8 *dst)
+{
+	const uint8 *src = img.data + rowsize * y;
+
+#ifndef LOVE_BIG_ENDIAN
+	if (img.format == PIXELFORMAT_RGBA16)
+	{
+		const uint16 *src16 = (const uint16 *) src;
+		for (size_t i = 0; i < rowsize / 2; i++)
+		{
+			uint16 v = swapuint16(src16[i]);
+			memcpy(dst + i * 2, &v, sizeof(uint16));
+		}
+		return;
+	}
+#endif
+
+	memcpy(dst, src, rowsize);
+}
+
+// Applies the Paeth filter to a whole row. A single fixed filter skips the
+// per-row trial encoding done by lodepng, and Paeth against a zeroed previous
+// row degenerates to the Sub filter, so the first row needs no special case.
+static void paethFilterRow(const uint8 *cur, const uint8 *prev, size_t rowsize, size_t bpp, uint8 *dst)
+{
+	for (size_t i = 0; i < bpp; i++)
+		dst[i] = (uint8) (cur[i] - prev[i]);
+
+	for (size_t i = bpp; i < rowsize; i++)
+	{
+		int a = cur[i - bpp];
+		int b = prev[i];
+		int c = prev[i - bpp];
+
+		int pa = abs(b - c);
+		int pb = abs(a - c);
+		int pc = abs(a + b - 2 * c);
+
+		int pred = (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+		dst[i] = (uint8) (cur[i] - pred);
+	}
+}
+
+// Filters and deflates rows [y0, y1) as a raw deflate stream. Every band but
+// the last ends on a byte-aligned sync flush, so the bands can be written
+// back to back as one zlib stream.
+static void encodeFastBand(const FormatHandler::DecodedImage &img, size_t bpp, int y0, int y1, bool last, FastPNGBand &band)
+{
+	size_t rowsize = (size_t) img.width * bpp;
+
+	std::vector<uint8> rows(rowsize * 2, 0);
+	uint8 *prev = rows.data();
+	uint8 *cur = rows.data() + rowsize;
+
+	if (y0 > 0)
+		getPNGRow(img, y0 - 1, rowsize, prev);
+
+	std::vector<uint8> filtered((rowsize + 1) * (y1 - y0));
+	uint8 *out = filtered.data();
+
+	for (int y = y0; y < y1; y++)
+	{
+		getPNGRow(img, y, rowsize, cur);
+
+		*out++ = 4; // Paeth
+		paethFilterRow(cur, prev, rowsize, bpp, out);
+		out += rowsize;
+
+		std::swap(prev, cur);
+	}
+
+	band.filteredSize = filtered.size();
+	band.adler = adler32(adler32(0L, Z_NULL, 0), filtered.data(), (uInt) filtered.size());
+
+	z_stream stream;
+	memset(&stream, 0, sizeof(z_stream));
+
+	// Negative window bits make a raw deflate stream, without the zlib header
+	// and checksum. Run-length matching is much cheaper than a full match
+	// search, and filtered image rows mostly compress through short runs.
+	if (deflateInit2(&stream, 1, Z_DEFLATED, -15, 8, Z_RLE) != Z_OK)
+		throw love::Exception("Could not encode PNG image (zlib initialization failed)");
+
+	// A sync flush adds a few bytes on top of the usual bound.
+	band.deflated.resize(deflateBound(&stream, (uLong) filtered.size()) + 16);
+
+	stream.next_in = filtered.data();
+	stream.avail_in = (uInt) filtered.size();
+	stream.next_out = band.deflated.data();
+	stream.avail_out = (uInt) band.deflated.size();
+
+	int status = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+	bool success = last ? status == Z_STREAM_END : (status == Z_OK && stream.avail_in == 0 && stream.avail_out > 0);
+
+	band.deflated.resize(stream.total_out);
+	deflateEnd(&stream);
+
+	if (!success)
+		throw love::Exception("Could not encode PNG image (zlib compression failed)");
+
+	band.crc = crc32(crc32(0L, Z_NULL, 0), band.deflated.data(), (uInt) band.deflated.size());
+}
+
+static uint8 *writePNGChunk(uint8 *dst, const char *type, const uint8 *prefix, size_t prefixsize,
+                            const uint8 *data, size_t datasize, uLong datacrc,
+                            const uint8 *suffix, size_t suffixsize)
+{
+	uint32 length = (uint32) (prefixsize + datasize + suffixsize);
+	uint8 header[8] = {
+		(uint8) (length >> 24), (uint8) (length >> 16), (uint8) (length >> 8), (uint8) length,
+		(uint8) type[0], (uint8) type[1], (uint8) type[2], (uint8) type[3]
+	};
+
+	memcpy(dst, header, 8);
+	dst += 8;
+
+	uLong crc = crc32(crc32(0L, Z_NULL, 0), header + 4, 4);
+
+	if (prefixsize > 0)
+	{
+		memcpy(dst, prefix, prefixsize);
+		crc = crc32(crc, prefix, (uInt) prefixsize);
+		dst += prefixsize;
+	}
+
+	if (datasize > 0)
+	{
+		memcpy(dst, data, datasize);
+		crc = crc32_combine(crc, datacrc, (z_off_t) datasize);
+		dst += datasize;
+	}
+
+	if (suffixsize > 0)
+	{
+		memcpy(dst, suffix, suffixsize);
+		crc = crc32(crc, suffix, (uInt) suffixsize);
+		dst += suffixsize;
+	}
+
+	uint8 crcbytes[4] = {(uint8) (crc >> 24), (uint8) (crc >> 16), (uint8) (crc >> 8), (uint8) crc};
+	memcpy(dst, crcbytes, 4);
+
+	return dst + 4;
+}
+
+// Encodes with a fixed row filter and zlib's fastest level, compressing bands
+// of rows in parallel. Each band is written as its own IDAT chunk.
+static FormatHandler::EncodedImage encodeFast(const FormatHandler::DecodedImage &img)
+{
+	size_t bpp = img.format == PIXELFORMAT_RGBA16 ? 8 : 4;
+	size_t filteredrowsize = (size_t) img.width * bpp + 1;
+
+	int bandrows = (int) std::max<size_t>(1, FAST_BAND_SIZE / filteredrowsize);
+	int bandcount = (img.height + bandrows - 1) / bandrows;
+
+	std::vector<FastPNGBand> bands(bandcount);
+
+	love::thread::WorkerPool::getShared().parallelFor(bandcount, [&](int i)
+	{
+		int y0 = i * bandrows;
+		int y1 = std::min(y0 + bandrows, img.height);
+		encodeFastBand(img, bpp, y0, y1, i == bandcount - 1, bands[i]);
+	});
+
+	uLong adler = bands[0].adler;
+	size_t totalsize = 8 + (12 + 13) + 12;
+
+	for (int i = 0; i < bandcount; i++)
+	{
+		if (i > 0)
+			adler = adler32_combine(adler, bands[i].adler, (z_off_t) bands[i].filteredSize);
+		totalsize += 12 + bands[i].deflated.size();
+	}
+
+	// zlib header and adler32 trailer.
+	totalsize += 2 + 4;
+
+	FormatHandler::EncodedImage encimg;
+
+	// Matches the allocator lodepng uses, for freeRawPixels.
+	encimg.data = (unsigned char *) malloc(totalsize);
+	if (encimg.data == nullptr)
+		throw love::Exception("Out of memory.");
+
+	encimg.size = totalsize;
+
+	static const uint8 signature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+	memcpy(encimg.data, signature, 8);
+
+	uint8 ihdr[13] = {
+		(uint8) (img.width >> 24), (uint8) (img.width >> 16), (uint8) (img.width >> 8), (uint8) img.width,
+		(uint8) (img.height >> 24), (uint8) (img.height >> 16), (uint8) (img.height >> 8), (uint8) img.height,
+		(uint8) (bpp == 8 ? 16 : 8), // bit depth
+		6, // color type: RGBA
+		0, 0, 0 // compression, filter, interlace
+	};
+
+	// 0x78 0x01: deflate with a 32K window, fastest compression level.
+	static const uint8 zlibheader[2] = {0x78, 0x01};
+	uint8 zlibtrailer[4] = {(uint8) (adler >> 24), (uint8) (adler >> 16), (uint8) (adler >> 8), (uint8) adler};
+
+	uint8 *dst = encimg.data + 8;
+	dst = writePNGChunk(dst, "IHDR", ihdr, sizeof(ihdr), nullptr, 0, 0, nullptr, 0);
+
+	for (int i = 0; i < bandcount; i++)
+	{
+		const FastPNGBand &band = bands[i];
+		bool first = i == 0;
+		bool last = i == bandcount - 1;
+
+		dst = writePNGChunk(dst, "IDAT", first ? zlibheader : nullptr, first ? 2 : 0,
+		                    band.deflated.data(), band.deflated.size(), band.crc,
+		                    last ? zlibtrailer : nullptr, last ? 4 : 0);
+	}
+
+	writePNGChunk(dst, "IEND", nullptr, 0, nullptr, 0, 0, nullptr, 0);
+
+	return encimg;
+}
+
 bool PNGHandler::canDecode(Data *data)
 {
 	unsigned int width = 0, height = 0;
@@ -199,11 +435,14 @@ PNGHandler::DecodedImage PNGHandler::decode(Data *fdata)
 	return img;
 }
 
-FormatHandler::EncodedImage PNGHandler::encode(const DecodedImage &img, EncodedFormat encodedFormat)
+FormatHandler::EncodedImage PNGHandler::encode(const DecodedImage &img, EncodedFormat encodedFormat, const EncodeSettings &settings)
 {
 	if (!canEncode(img.format, encodedFormat))
 		throw love::Exception("PNG encoder cannot encode to non-PNG format.");
 
+	if (settings.fast)
+		return encodeFast(img);
+
 	EncodedImage encimg;
 
 	lodepng::State state;
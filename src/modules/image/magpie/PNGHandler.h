@@ -43,7 +43,7 @@ public:
 	virtual bool canEncode(PixelFormat rawFormat, EncodedFormat encodedFormat);
 
 	virtual DecodedImage decode(Data *data);
-	virtual EncodedImage encode(const DecodedImage &img, EncodedFormat format);
+	virtual EncodedImage encode(const DecodedImage &img, EncodedFormat format, const EncodeSettings &settings);
 
 	virtual void freeRawPixels(unsigned char *mem);
 
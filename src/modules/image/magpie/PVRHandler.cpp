@@ -525,11 +525,11 @@ StrongRef<CompressedMemory> PVRHandler::parseCompressed(Data *filedata, std::vec
 	if (filedata->getSize() < fileoffset + totalsize)
 		throw love::Exception("Could not parse PVR file: invalid size calculation.");
 
+	// The mipmap levels are referenced in-place rather than copied.
 	StrongRef<CompressedMemory> memory;
-	memory.set(new CompressedMemory(totalsize), Acquire::NORETAIN);
+	memory.set(new CompressedMemory(filedata, fileoffset, totalsize), Acquire::NORETAIN);
 
 	size_t curoffset = 0;
-	const uint8 *filebytes = (uint8 *) filedata->getData() + fileoffset;
 
 	for (int i = 0; i < (int) header3.numMipmaps; i++)
 	{
@@ -541,8 +541,6 @@ StrongRef<CompressedMemory> PVRHandler::parseCompressed(Data *filedata, std::vec
 		int width = std::max((int) header3.width >> i, 1);
 		int height = std::max((int) header3.height >> i, 1);
 
-		memcpy(memory->data + curoffset, filebytes + curoffset, mipsize);
-
 		auto slice = new CompressedSlice(cformat, width, height, memory, curoffset, mipsize);
 		images.push_back(slice);
 		slice->release();
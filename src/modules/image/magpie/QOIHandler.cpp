@@ -0,0 +1,305 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "QOIHandler.h"
+#include "common/Exception.h"
+
+// C
+#include <cstdlib>
+#include <cstring>
+
+namespace love
+{
+namespace image
+{
+namespace magpie
+{
+
+// See https://qoiformat.org/qoi-specification.pdf
+
+static const size_t QOI_HEADER_SIZE = 14;
+static const uint8 QOI_PADDING[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+
+// Matches the reference implementation's limit, which keeps the worst case
+// encoded size well within 32 bits.
+static const uint64 QOI_PIXELS_MAX = 400000000;
+
+enum QOIOp
+{
+	QOI_OP_INDEX = 0x00,
+	QOI_OP_DIFF  = 0x40,
+	QOI_OP_LUMA  = 0x80,
+	QOI_OP_RUN   = 0xC0,
+	QOI_OP_RGB   = 0xFE,
+	QOI_OP_RGBA  = 0xFF,
+};
+
+static const uint8 QOI_MASK_2 = 0xC0;
+
+struct QOIPixel
+{
+	uint8 r, g, b, a;
+};
+
+static inline bool operator == (const QOIPixel &a, const QOIPixel &b)
+{
+	return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+static inline int qoiHash(const QOIPixel &p)
+{
+	return (p.r * 3 + p.g * 5 + p.b * 7 + p.a * 11) % 64;
+}
+
+static inline void writeUint32BE(uint8 *dst, uint32 v)
+{
+	dst[0] = (uint8) (v >> 24);
+	dst[1] = (uint8) (v >> 16);
+	dst[2] = (uint8) (v >> 8);
+	dst[3] = (uint8) v;
+}
+
+static inline uint32 readUint32BE(const uint8 *src)
+{
+	return ((uint32) src[0] << 24) | ((uint32) src[1] << 16) | ((uint32) src[2] << 8) | (uint32) src[3];
+}
+
+bool QOIHandler::canDecode(Data *data)
+{
+	if (data->getSize() < QOI_HEADER_SIZE + sizeof(QOI_PADDING))
+		return false;
+
+	const uint8 *bytes = (const uint8 *) data->getData();
+
+	if (memcmp(bytes, "qoif", 4) != 0)
+		return false;
+
+	uint32 width = readUint32BE(bytes + 4);
+	uint32 height = readUint32BE(bytes + 8);
+	uint8 channels = bytes[12];
+
+	return width > 0 && height > 0 && (channels == 3 || channels == 4)
+		&& (uint64) width * (uint64) height <= QOI_PIXELS_MAX;
+}
+
+bool QOIHandler::canEncode(PixelFormat rawFormat, EncodedFormat encodedFormat)
+{
+	return encodedFormat == ENCODED_QOI && rawFormat == PIXELFORMAT_RGBA8;
+}
+
+FormatHandler::DecodedImage QOIHandler::decode(Data *data)
+{
+	if (!canDecode(data))
+		throw love::Exception("Could not decode QOI image (invalid header).");
+
+	const uint8 *bytes = (const uint8 *) data->getData();
+	size_t size = data->getSize();
+
+	DecodedImage img;
+	img.width = (int) readUint32BE(bytes + 4);
+	img.height = (int) readUint32BE(bytes + 8);
+	img.format = PIXELFORMAT_RGBA8;
+	img.size = (size_t) img.width * (size_t) img.height * 4;
+
+	img.data = (unsigned char *) malloc(img.size);
+	if (img.data == nullptr)
+		throw love::Exception("Out of memory.");
+
+	QOIPixel index[64];
+	memset(index, 0, sizeof(index));
+
+	QOIPixel px = {0, 0, 0, 255};
+	QOIPixel *out = (QOIPixel *) img.data;
+
+	size_t p = QOI_HEADER_SIZE;
+	size_t chunksend = size - sizeof(QOI_PADDING);
+	size_t pixelcount = (size_t) img.width * (size_t) img.height;
+	int run = 0;
+
+	// The padding at the end of the stream guarantees the multi-byte ops below
+	// stay in bounds as long as they start before it. A truncated stream
+	// repeats the last pixel instead of failing, like the reference decoder.
+	for (size_t i = 0; i < pixelcount; i++)
+	{
+		if (run > 0)
+			run--;
+		else if (p < chunksend)
+		{
+			uint8 b1 = bytes[p++];
+
+			if (b1 == QOI_OP_RGB)
+			{
+				px.r = bytes[p++];
+				px.g = bytes[p++];
+				px.b = bytes[p++];
+			}
+			else if (b1 == QOI_OP_RGBA)
+			{
+				px.r = bytes[p++];
+				px.g = bytes[p++];
+				px.b = bytes[p++];
+				px.a = bytes[p++];
+			}
+			else if ((b1 & QOI_MASK_2) == QOI_OP_INDEX)
+				px = index[b1];
+			else if ((b1 & QOI_MASK_2) == QOI_OP_DIFF)
+			{
+				px.r += ((b1 >> 4) & 0x03) - 2;
+				px.g += ((b1 >> 2) & 0x03) - 2;
+				px.b += (b1 & 0x03) - 2;
+			}
+			else if ((b1 & QOI_MASK_2) == QOI_OP_LUMA)
+			{
+				uint8 b2 = bytes[p++];
+				int vg = (b1 & 0x3F) - 32;
+				px.r += vg - 8 + ((b2 >> 4) & 0x0F);
+				px.g += vg;
+				px.b += vg - 8 + (b2 & 0x0F);
+			}
+			else if ((b1 & QOI_MASK_2) == QOI_OP_RUN)
+				run = b1 & 0x3F;
+
+			index[qoiHash(px)] = px;
+		}
+
+		out[i] = px;
+	}
+
+	return img;
+}
+
+FormatHandler::EncodedImage QOIHandler::encode(const DecodedImage &img, EncodedFormat encodedFormat, const EncodeSettings & /*settings*/)
+{
+	if (!canEncode(img.format, encodedFormat))
+		throw love::Exception("QOI encoder cannot encode to non-QOI format.");
+
+	size_t pixelcount = (size_t) img.width * (size_t) img.height;
+
+	if (img.width <= 0 || img.height <= 0 || pixelcount > QOI_PIXELS_MAX)
+		throw love::Exception("Invalid image dimensions for QOI encoding.");
+
+	// Worst case: every pixel needs a full QOI_OP_RGBA.
+	size_t maxsize = QOI_HEADER_SIZE + pixelcount * 5 + sizeof(QOI_PADDING);
+
+	uint8 *bytes = (uint8 *) malloc(maxsize);
+	if (bytes == nullptr)
+		throw love::Exception("Out of memory.");
+
+	memcpy(bytes, "qoif", 4);
+	writeUint32BE(bytes + 4, (uint32) img.width);
+	writeUint32BE(bytes + 8, (uint32) img.height);
+	bytes[12] = 4; // channels
+	bytes[13] = 0; // sRGB with linear alpha
+
+	QOIPixel index[64];
+	memset(index, 0, sizeof(index));
+
+	QOIPixel prev = {0, 0, 0, 255};
+	const QOIPixel *in = (const QOIPixel *) img.data;
+
+	size_t p = QOI_HEADER_SIZE;
+	int run = 0;
+
+	for (size_t i = 0; i < pixelcount; i++)
+	{
+		const QOIPixel px = in[i];
+
+		if (px == prev)
+		{
+			run++;
+			if (run == 62 || i == pixelcount - 1)
+			{
+				bytes[p++] = (uint8) (QOI_OP_RUN | (run - 1));
+				run = 0;
+			}
+			continue;
+		}
+
+		if (run > 0)
+		{
+			bytes[p++] = (uint8) (QOI_OP_RUN | (run - 1));
+			run = 0;
+		}
+
+		int h = qoiHash(px);
+
+		if (index[h] == px)
+			bytes[p++] = (uint8) (QOI_OP_INDEX | h);
+		else
+		{
+			index[h] = px;
+
+			if (px.a == prev.a)
+			{
+				int8 vr = (int8) (px.r - prev.r);
+				int8 vg = (int8) (px.g - prev.g);
+				int8 vb = (int8) (px.b - prev.b);
+
+				int vgr = vr - vg;
+				int vgb = vb - vg;
+
+				if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2)
+					bytes[p++] = (uint8) (QOI_OP_DIFF | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2));
+				else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8)
+				{
+					bytes[p++] = (uint8) (QOI_OP_LUMA | (vg + 32));
+					bytes[p++] = (uint8) ((vgr + 8) << 4 | (vgb + 8));
+				}
+				else
+				{
+					bytes[p++] = QOI_OP_RGB;
+					bytes[p++] = px.r;
+					bytes[p++] = px.g;
+					bytes[p++] = px.b;
+				}
+			}
+			else
+			{
+				bytes[p++] = QOI_OP_RGBA;
+				bytes[p++] = px.r;
+				bytes[p++] = px.g;
+				bytes[p++] = px.b;
+				bytes[p++] = px.a;
+			}
+		}
+
+		prev = px;
+	}
+
+	memcpy(bytes + p, QOI_PADDING, sizeof(QOI_PADDING));
+	p += sizeof(QOI_PADDING);
+
+	EncodedImage encimg;
+	encimg.data = bytes;
+	encimg.size = p;
+
+	return encimg;
+}
+
+void QOIHandler::freeRawPixels(unsigned char *mem)
+{
+	if (mem)
+		::free(mem);
+}
+
+} // magpie
+} // image
+} // love
@@ -46,7 +46,7 @@ public:
 	bool canEncode(PixelFormat rawFormat, EncodedFormat encodedFormat) override;
 
 	DecodedImage decode(Data *data) override;
-	EncodedImage encode(const DecodedImage &img, EncodedFormat format) override;
+	EncodedImage encode(const DecodedImage &img, EncodedFormat format, const EncodeSettings &settings) override;
 
 	void freeRawPixels(unsigned char *mem) override;
 
@@ -21,6 +21,9 @@
 #include "ddsHandler.h"
 #include "common/Exception.h"
 
+// C++
+#include <algorithm>
+
 namespace love
 {
 namespace image
@@ -57,30 +60,32 @@ StrongRef<CompressedMemory> DDSHandler::parseCompressed(Data *filedata, std::vec
 	if (parser.getMipmapCount() == 0)
 		throw love::Exception("Could not parse compressed data: No readable texture data.");
 
-	// Calculate the size of the block of memory we're returning.
+	const uint8 *filebytes = (const uint8 *) filedata->getData();
+	size_t dataStart = filedata->getSize();
+	size_t dataEnd = 0;
+
+	// The parsed mipmap levels point into the FileData. Find the range of it
+	// they cover, so they can be referenced in-place instead of copied.
 	for (size_t i = 0; i < parser.getMipmapCount(); i++)
 	{
 		const dds::Image *img = parser.getImageData(i);
-		dataSize += img->dataSize;
-	}
+		size_t offset = (size_t) ((const uint8 *) img->data - filebytes);
 
-	memory.set(new CompressedMemory(dataSize), Acquire::NORETAIN);
+		dataStart = std::min(dataStart, offset);
+		dataEnd = std::max(dataEnd, offset + img->dataSize);
+	}
 
-	size_t dataOffset = 0;
+	dataSize = dataEnd - dataStart;
+	memory.set(new CompressedMemory(filedata, dataStart, dataSize), Acquire::NORETAIN);
 
-	// Copy the parsed mipmap levels from the FileData to our CompressedImageData.
 	for (size_t i = 0; i < parser.getMipmapCount(); i++)
 	{
 		// Fetch the data for this mipmap level.
 		const dds::Image *img = parser.getImageData(i);
-
-		// Copy the mipmap image from the FileData to our block of memory.
-		memcpy(memory->data + dataOffset, img->data, img->dataSize);
+		size_t dataOffset = (size_t) ((const uint8 *) img->data - filebytes) - dataStart;
 
 		auto slice = new CompressedSlice(texformat, img->width, img->height, memory, dataOffset, img->dataSize);
 		images.emplace_back(slice, Acquire::NORETAIN);
-
-		dataOffset += img->dataSize;
 	}
 
 	format = texformat;
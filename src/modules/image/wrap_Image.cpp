@@ -24,6 +24,7 @@
 #include "common/StringMap.h"
 
 #include "Image.h"
+#include "MipmapGenerator.h"
 
 #include "filesystem/wrap_Filesystem.h"
 
@@ -103,6 +104,99 @@ int w_newImageData(lua_State *L)
 	}
 }
 
+int w_newImageDatas(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+
+	bool hascallback = !lua_isnoneornil(L, 2);
+	if (hascallback)
+		luaL_checktype(L, 2, LUA_TFUNCTION);
+
+	int count = (int) luax_objlen(L, 1);
+
+	// Loaded files are kept in a table until decoding is done, so nothing
+	// leaks if a file can't be read.
+	lua_createtable(L, count, 0);
+	int filesidx = lua_gettop(L);
+
+	for (int i = 0; i < count; i++)
+	{
+		lua_rawgeti(L, 1, i + 1);
+		if (!filesystem::luax_cangetdata(L, -1))
+			return luaL_error(L, "Expected filename, File, or Data at index %d.", i + 1);
+
+		Data *data = love::filesystem::luax_getdata(L, lua_gettop(L));
+		lua_pop(L, 1);
+
+		luax_pushtype(L, data);
+		data->release();
+		lua_rawseti(L, filesidx, i + 1);
+	}
+
+	lua_createtable(L, count, 0);
+	int resultidx = lua_gettop(L);
+	int failedindex = 0;
+
+	{
+		std::vector<Data *> files;
+		files.reserve(count);
+
+		for (int i = 0; i < count; i++)
+		{
+			lua_rawgeti(L, filesidx, i + 1);
+			files.push_back(data::luax_checkdata(L, -1));
+			lua_pop(L, 1);
+		}
+
+		std::vector<StrongRef<ImageData>> imagedatas;
+		std::vector<std::string> errors;
+		instance()->newImageDatas(files, imagedatas, errors);
+
+		// Results are moved into Lua (and the error messages pushed onto the
+		// stack) before calling back into Lua, which may raise errors.
+		for (int i = 0; i < count; i++)
+		{
+			if (imagedatas[i].get() != nullptr)
+			{
+				luax_pushtype(L, imagedatas[i]);
+				lua_rawseti(L, resultidx, i + 1);
+			}
+			else if (failedindex == 0 || hascallback)
+			{
+				if (failedindex == 0)
+					failedindex = i + 1;
+				lua_pushstring(L, errors[i].c_str());
+				lua_rawseti(L, filesidx, i + 1);
+			}
+		}
+	}
+
+	if (hascallback)
+	{
+		for (int i = 1; i <= count; i++)
+		{
+			lua_pushvalue(L, 2);
+			lua_pushinteger(L, i);
+			lua_rawgeti(L, resultidx, i);
+
+			if (lua_isnil(L, -1))
+				lua_rawgeti(L, filesidx, i);
+			else
+				lua_pushnil(L);
+
+			lua_call(L, 3, 0);
+		}
+	}
+	else if (failedindex > 0)
+	{
+		lua_rawgeti(L, filesidx, failedindex);
+		return luaL_error(L, "Could not decode image %d: %s", failedindex, lua_tostring(L, -1));
+	}
+
+	lua_pushvalue(L, resultidx);
+	return 1;
+}
+
 int w_newCompressedData(lua_State *L)
 {
 	Data *data = love::filesystem::luax_getdata(L, 1);
@@ -138,13 +232,38 @@ int w_newCubeFaces(lua_State *L)
 	return (int) faces.size();
 }
 
+int w_newMipmaps(lua_State *L)
+{
+	ImageData *id = luax_checkimagedata(L, 1);
+
+	MipmapGenerator::Filter filter = MipmapGenerator::FILTER_BOX;
+	if (!lua_isnoneornil(L, 2))
+	{
+		const char *str = luaL_checkstring(L, 2);
+		if (!MipmapGenerator::getConstant(str, filter))
+			return luax_enumerror(L, "mipmap filter", MipmapGenerator::getConstants(filter), str);
+	}
+
+	bool srgb = luax_optboolean(L, 3, false);
+
+	std::vector<StrongRef<ImageData>> mipmaps;
+	luax_catchexcept(L, [&](){ mipmaps = MipmapGenerator::generate(id, filter, srgb); });
+
+	for (auto mip : mipmaps)
+		luax_pushtype(L, mip);
+
+	return (int) mipmaps.size();
+}
+
 // List of functions to wrap.
 static const luaL_Reg functions[] =
 {
 	{ "newImageData",  w_newImageData },
+	{ "newImageDatas", w_newImageDatas },
 	{ "newCompressedData", w_newCompressedData },
 	{ "isCompressed", w_isCompressed },
 	{ "newCubeFaces", w_newCubeFaces },
+	{ "newMipmaps", w_newMipmaps },
 	{ 0, 0 }
 };
 
@@ -19,16 +19,25 @@
  **/
 
 #include "wrap_ImageData.h"
+#include "ImageOperations.h"
 
 #include "data/wrap_Data.h"
 #include "filesystem/File.h"
 #include "filesystem/Filesystem.h"
 
+// C++
+#include <cmath>
+#include <vector>
+
 // Shove the wrap_ImageData.lua code directly into a raw string literal.
 static const char imagedata_lua[] =
 #include "wrap_ImageData.lua"
 ;
 
+#ifdef LOVE_PRECOMPILED_LUA
+#include "luabytecode/imagedata_lua.h"
+#endif
+
 namespace love
 {
 namespace image
@@ -256,6 +265,199 @@ int w_ImageData_paste(lua_State *L)
 	return 0;
 }
 
+int w_ImageData_convertColors(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+
+	ColorConversion conversion;
+	const char *str = luaL_checkstring(L, 2);
+	if (!getConstant(str, conversion))
+		return luax_enumerror(L, "color conversion", getConstants(conversion), str);
+
+	int x = (int) luaL_optinteger(L, 3, 0);
+	int y = (int) luaL_optinteger(L, 4, 0);
+	int w = (int) luaL_optinteger(L, 5, t->getWidth());
+	int h = (int) luaL_optinteger(L, 6, t->getHeight());
+
+	t->convertColors(conversion, x, y, w, h);
+	return 0;
+}
+
+int w_ImageData_swizzle(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+
+	int order[4];
+	const char *str = luaL_checkstring(L, 2);
+	if (!getSwizzle(str, order))
+		return luaL_error(L, "Invalid channel order '%s' (expected four of r, g, b and a, e.g. \"bgra\")", str);
+
+	int x = (int) luaL_optinteger(L, 3, 0);
+	int y = (int) luaL_optinteger(L, 4, 0);
+	int w = (int) luaL_optinteger(L, 5, t->getWidth());
+	int h = (int) luaL_optinteger(L, 6, t->getHeight());
+
+	luax_catchexcept(L, [&](){ t->swizzle(order, x, y, w, h); });
+	return 0;
+}
+
+int w_ImageData_fillRectangle(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+	int x = (int) luaL_checkinteger(L, 2);
+	int y = (int) luaL_checkinteger(L, 3);
+	int w = (int) luaL_checkinteger(L, 4);
+	int h = (int) luaL_checkinteger(L, 5);
+
+	float color[4];
+	for (int i = 0; i < 3; i++)
+		color[i] = (float) luaL_checknumber(L, 6 + i);
+	color[3] = (float) luaL_optnumber(L, 9, 1.0);
+
+	luax_catchexcept(L, [&](){ ImageOperations::fillRectangle(t, x, y, w, h, color); });
+	return 0;
+}
+
+int w_ImageData_blend(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+	ImageData *src = luax_checkimagedata(L, 2);
+	int dx = (int) luaL_checkinteger(L, 3);
+	int dy = (int) luaL_checkinteger(L, 4);
+	int sx = (int) luaL_optinteger(L, 5, 0);
+	int sy = (int) luaL_optinteger(L, 6, 0);
+	int sw = (int) luaL_optinteger(L, 7, src->getWidth());
+	int sh = (int) luaL_optinteger(L, 8, src->getHeight());
+
+	luax_catchexcept(L, [&](){ ImageOperations::blend(t, src, dx, dy, sx, sy, sw, sh); });
+	return 0;
+}
+
+int w_ImageData_resize(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+	int w = (int) luaL_checkinteger(L, 2);
+	int h = (int) luaL_checkinteger(L, 3);
+
+	ImageOperations::Filter filter = ImageOperations::FILTER_LINEAR;
+	const char *str = lua_isnoneornil(L, 4) ? nullptr : luaL_checkstring(L, 4);
+	if (str != nullptr && !ImageOperations::getConstant(str, filter))
+		return luax_enumerror(L, "filter mode", ImageOperations::getConstants(filter), str);
+
+	ImageData *c = nullptr;
+	luax_catchexcept(L, [&](){ c = ImageOperations::resize(t, w, h, filter); });
+	luax_pushtype(L, c);
+	c->release();
+	return 1;
+}
+
+int w_ImageData_flip(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+	bool horizontal = luax_optboolean(L, 2, true);
+	bool vertical = luax_optboolean(L, 3, false);
+
+	luax_catchexcept(L, [&](){ ImageOperations::flip(t, horizontal, vertical); });
+	return 0;
+}
+
+int w_ImageData_rotate(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+	int turns = (int) luaL_optinteger(L, 2, 1);
+
+	ImageData *c = nullptr;
+	luax_catchexcept(L, [&](){ c = ImageOperations::rotate(t, turns); });
+	luax_pushtype(L, c);
+	c->release();
+	return 1;
+}
+
+int w_ImageData_convolve(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+
+	int count = (int) luax_objlen(L, 2);
+	int size = (int) sqrt((double) count);
+
+	if (size * size != count || size % 2 == 0)
+		return luaL_error(L, "Convolution kernels must be square, with an odd width (got %d values).", count);
+
+	std::vector<float> kernel(count);
+	for (int i = 0; i < count; i++)
+	{
+		lua_rawgeti(L, 2, i + 1);
+		kernel[i] = (float) luaL_checknumber(L, -1);
+		lua_pop(L, 1);
+	}
+
+	luax_catchexcept(L, [&](){ ImageOperations::convolve(t, kernel, size); });
+	return 0;
+}
+
+int w_ImageData_blur(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+	float sigma = (float) luaL_checknumber(L, 2);
+	luax_catchexcept(L, [&](){ ImageOperations::blur(t, sigma); });
+	return 0;
+}
+
+int w_ImageData_sharpen(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+	float amount = (float) luaL_optnumber(L, 2, 1.0);
+	luax_catchexcept(L, [&](){ ImageOperations::sharpen(t, amount); });
+	return 0;
+}
+
+int w_ImageData_transformChannels(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+
+	float matrix[16] = {};
+	float offset[4] = {};
+
+	int count = (int) luax_objlen(L, 2);
+	if (count == 4)
+	{
+		// Per-channel multipliers: a diagonal matrix.
+		for (int i = 0; i < 4; i++)
+		{
+			lua_rawgeti(L, 2, i + 1);
+			matrix[i * 5] = (float) luaL_checknumber(L, -1);
+			lua_pop(L, 1);
+		}
+	}
+	else if (count == 16)
+	{
+		for (int i = 0; i < 16; i++)
+		{
+			lua_rawgeti(L, 2, i + 1);
+			matrix[i] = (float) luaL_checknumber(L, -1);
+			lua_pop(L, 1);
+		}
+	}
+	else
+		return luaL_error(L, "Expected 4 channel multipliers or a 16-value matrix, got %d values.", count);
+
+	if (!lua_isnoneornil(L, 3))
+	{
+		luaL_checktype(L, 3, LUA_TTABLE);
+		for (int i = 0; i < 4; i++)
+		{
+			lua_rawgeti(L, 3, i + 1);
+			offset[i] = (float) luaL_optnumber(L, -1, 0.0);
+			lua_pop(L, 1);
+		}
+	}
+
+	luax_catchexcept(L, [&](){ ImageOperations::transformChannels(t, matrix, offset); });
+	return 0;
+}
+
 int w_ImageData_encode(lua_State *L)
 {
 	ImageData *t = luax_checkimagedata(L, 1);
@@ -266,16 +468,25 @@ int w_ImageData_encode(lua_State *L)
 		return luax_enumerror(L, "encoded image format", ImageData::getConstants(format), fmt);
 
 	bool hasfilename = false;
+	int settingsidx = 3;
 
 	std::string filename = "Image." + std::string(fmt);
-	if (!lua_isnoneornil(L, 3))
+	if (!lua_isnoneornil(L, 3) && !lua_istable(L, 3))
 	{
 		hasfilename = true;
 		filename = luax_checkstring(L, 3);
+		settingsidx = 4;
+	}
+
+	FormatHandler::EncodeSettings settings;
+	if (!lua_isnoneornil(L, settingsidx))
+	{
+		luaL_checktype(L, settingsidx, LUA_TTABLE);
+		settings.fast = luax_boolflag(L, settingsidx, "fast", settings.fast);
 	}
 
 	love::filesystem::FileData *filedata = nullptr;
-	luax_catchexcept(L, [&](){ filedata = t->encode(format, filename.c_str(), hasfilename); });
+	luax_catchexcept(L, [&](){ filedata = t->encode(format, filename.c_str(), hasfilename, settings); });
 
 	luax_pushtype(L, filedata);
 	filedata->release();
@@ -343,6 +554,17 @@ static const luaL_Reg w_ImageData_functions[] =
 	{ "getPixel", w_ImageData_getPixel },
 	{ "setPixel", w_ImageData_setPixel },
 	{ "paste", w_ImageData_paste },
+	{ "convertColors", w_ImageData_convertColors },
+	{ "swizzle", w_ImageData_swizzle },
+	{ "fillRectangle", w_ImageData_fillRectangle },
+	{ "blend", w_ImageData_blend },
+	{ "resize", w_ImageData_resize },
+	{ "flip", w_ImageData_flip },
+	{ "rotate", w_ImageData_rotate },
+	{ "convolve", w_ImageData_convolve },
+	{ "blur", w_ImageData_blur },
+	{ "sharpen", w_ImageData_sharpen },
+	{ "transformChannels", w_ImageData_transformChannels },
 	{ "encode", w_ImageData_encode },
 
 	// Used in the Lua wrapper code.
@@ -372,7 +594,7 @@ extern "C" int luaopen_imagedata(lua_State *L)
 	// functions struct pointer as arguments.
 	if (lua_istable(L, -1))
 	{
-		luaL_loadbuffer(L, imagedata_lua, sizeof(imagedata_lua), "ImageData.lua");
+		luax_loadembedded(L, LOVE_EMBEDDED_BYTECODE(imagedata_lua), imagedata_lua, sizeof(imagedata_lua), "ImageData.lua");
 		lua_pushvalue(L, -2);
 		lua_pushlightuserdata(L, &ffifuncs);
 		lua_call(L, 2, 0);
@@ -127,6 +127,18 @@ public:
 		};
 	};
 
+	// A copy of all of a joystick's input values, taken at once.
+	struct State
+	{
+		std::vector<float> axes;
+		std::vector<bool> buttons;
+		std::vector<Hat> hats;
+
+		bool gamepad = false;
+		float gamepadAxes[GAMEPAD_AXIS_MAX_ENUM] = {};
+		bool gamepadButtons[GAMEPAD_BUTTON_MAX_ENUM] = {};
+	};
+
 	virtual ~Joystick() {}
 
 	virtual bool open(int deviceindex) = 0;
@@ -154,6 +166,12 @@ public:
 
 	virtual JoystickInput getGamepadMapping(const GamepadInput &input) const = 0;
 
+	/**
+	 * Copies every axis, button and hat value, and the Gamepad values if it's
+	 * a Gamepad, in one call. The State's vectors are reused.
+	 **/
+	virtual void getState(State &state) const = 0;
+
 	virtual void *getHandle() const = 0;
 
 	virtual std::string getGUID() const = 0;
@@ -96,6 +96,18 @@ public:
 	 **/
 	virtual std::string saveGamepadMappings() = 0;
 
+	/**
+	 * The time (in seconds, on SDL's clock) of the last event pump, which is
+	 * when the joysticks' input values were last updated. Set by the event
+	 * module.
+	 **/
+	void setLastPumpTime(double time) { lastPumpTime = time; }
+	double getLastPumpTime() const { return lastPumpTime; }
+
+protected:
+
+	double lastPumpTime = 0.0;
+
 }; // JoystickModule
 
 } // joystick
@@ -248,6 +248,46 @@ bool Joystick::isGamepadDown(const std::vector<GamepadButton> &blist) const
 	return false;
 }
 
+void Joystick::getState(State &state) const
+{
+	bool connected = isConnected();
+
+	state.axes.resize(connected ? getAxisCount() : 0);
+	for (size_t i = 0; i < state.axes.size(); i++)
+		state.axes[i] = clampval(((float) SDL_JoystickGetAxis(joyhandle, (int) i))/32768.0f);
+
+	state.buttons.resize(connected ? getButtonCount() : 0);
+	for (size_t i = 0; i < state.buttons.size(); i++)
+		state.buttons[i] = SDL_JoystickGetButton(joyhandle, (int) i) == 1;
+
+	state.hats.resize(connected ? getHatCount() : 0);
+	for (size_t i = 0; i < state.hats.size(); i++)
+	{
+		state.hats[i] = HAT_INVALID;
+		getConstant(SDL_JoystickGetHat(joyhandle, (int) i), state.hats[i]);
+	}
+
+	state.gamepad = connected && isGamepad();
+
+	for (int i = 0; i < GAMEPAD_AXIS_MAX_ENUM; i++)
+	{
+		SDL_GameControllerAxis sdlaxis;
+		state.gamepadAxes[i] = 0.0f;
+
+		if (state.gamepad && getConstant((GamepadAxis) i, sdlaxis))
+			state.gamepadAxes[i] = clampval((float) SDL_GameControllerGetAxis(controller, sdlaxis) / 32768.0f);
+	}
+
+	for (int i = 0; i < GAMEPAD_BUTTON_MAX_ENUM; i++)
+	{
+		SDL_GameControllerButton sdlbutton;
+		state.gamepadButtons[i] = false;
+
+		if (state.gamepad && getConstant((GamepadButton) i, sdlbutton))
+			state.gamepadButtons[i] = SDL_GameControllerGetButton(controller, sdlbutton) == 1;
+	}
+}
+
 Joystick::JoystickInput Joystick::getGamepadMapping(const GamepadInput &input) const
 {
 	Joystick::JoystickInput jinput;
@@ -69,6 +69,8 @@ public:
 
 	JoystickInput getGamepadMapping(const GamepadInput &input) const override;
 
+	void getState(State &state) const override;
+
 	void *getHandle() const override;
 
 	std::string getGUID() const override;
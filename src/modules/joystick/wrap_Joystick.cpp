@@ -21,6 +21,7 @@
 // LOVE
 #include "wrap_Joystick.h"
 #include "wrap_JoystickModule.h"
+#include "JoystickModule.h"
 
 #include <vector>
 
@@ -278,6 +279,125 @@ int w_Joystick_getGamepadMapping(lua_State *L)
 	return 1;
 }
 
+// Gets the table in field 'name' of the table at 'idx', creating it if needed.
+static void getStateTable(lua_State *L, int idx, const char *name, int narr, int nrec)
+{
+	lua_getfield(L, idx, name);
+	if (!lua_istable(L, -1))
+	{
+		lua_pop(L, 1);
+		lua_createtable(L, narr, nrec);
+		lua_pushvalue(L, -1);
+		lua_setfield(L, idx, name);
+	}
+}
+
+// Removes array entries past 'count' from a reused table.
+static void truncateStateArray(lua_State *L, int idx, int count)
+{
+	for (int i = count + 1; ; i++)
+	{
+		lua_rawgeti(L, idx, i);
+		bool isnil = lua_isnil(L, -1);
+		lua_pop(L, 1);
+
+		if (isnil)
+			break;
+
+		lua_pushnil(L);
+		lua_rawseti(L, idx, i);
+	}
+}
+
+void luax_pushjoystickstate(lua_State *L, const Joystick::State &state, double timestamp, int idx)
+{
+	if (lua_istable(L, idx))
+		lua_pushvalue(L, idx);
+	else
+		lua_createtable(L, 0, 6);
+
+	int t = lua_gettop(L);
+
+	lua_pushnumber(L, timestamp);
+	lua_setfield(L, t, "timestamp");
+
+	getStateTable(L, t, "axes", (int) state.axes.size(), 0);
+	for (size_t i = 0; i < state.axes.size(); i++)
+	{
+		lua_pushnumber(L, state.axes[i]);
+		lua_rawseti(L, t + 1, (int) i + 1);
+	}
+	truncateStateArray(L, t + 1, (int) state.axes.size());
+	lua_pop(L, 1);
+
+	getStateTable(L, t, "buttons", (int) state.buttons.size(), 0);
+	for (size_t i = 0; i < state.buttons.size(); i++)
+	{
+		luax_pushboolean(L, state.buttons[i]);
+		lua_rawseti(L, t + 1, (int) i + 1);
+	}
+	truncateStateArray(L, t + 1, (int) state.buttons.size());
+	lua_pop(L, 1);
+
+	getStateTable(L, t, "hats", (int) state.hats.size(), 0);
+	for (size_t i = 0; i < state.hats.size(); i++)
+	{
+		const char *str = nullptr;
+		if (!Joystick::getConstant(state.hats[i], str))
+			str = "c";
+		lua_pushstring(L, str);
+		lua_rawseti(L, t + 1, (int) i + 1);
+	}
+	truncateStateArray(L, t + 1, (int) state.hats.size());
+	lua_pop(L, 1);
+
+	if (state.gamepad)
+	{
+		getStateTable(L, t, "gamepadaxes", 0, Joystick::GAMEPAD_AXIS_MAX_ENUM);
+		for (int i = 0; i < Joystick::GAMEPAD_AXIS_MAX_ENUM; i++)
+		{
+			const char *name = nullptr;
+			if (!Joystick::getConstant((Joystick::GamepadAxis) i, name))
+				continue;
+			lua_pushnumber(L, state.gamepadAxes[i]);
+			lua_setfield(L, t + 1, name);
+		}
+		lua_pop(L, 1);
+
+		getStateTable(L, t, "gamepadbuttons", 0, Joystick::GAMEPAD_BUTTON_MAX_ENUM);
+		for (int i = 0; i < Joystick::GAMEPAD_BUTTON_MAX_ENUM; i++)
+		{
+			const char *name = nullptr;
+			if (!Joystick::getConstant((Joystick::GamepadButton) i, name))
+				continue;
+			luax_pushboolean(L, state.gamepadButtons[i]);
+			lua_setfield(L, t + 1, name);
+		}
+		lua_pop(L, 1);
+	}
+	else
+	{
+		lua_pushnil(L);
+		lua_setfield(L, t, "gamepadaxes");
+		lua_pushnil(L);
+		lua_setfield(L, t, "gamepadbuttons");
+	}
+}
+
+int w_Joystick_getState(lua_State *L)
+{
+	Joystick *j = luax_checkjoystick(L, 1);
+
+	Joystick::State state;
+	j->getState(state);
+
+	auto joymodule = Module::getInstance<JoystickModule>(Module::M_JOYSTICK);
+	double timestamp = joymodule ? joymodule->getLastPumpTime() : 0.0;
+
+	luax_pushjoystickstate(L, state, timestamp, 2);
+	return 1;
+}
+
 int w_Joystick_isVibrationSupported(lua_State *L)
 {
 	Joystick *j = luax_checkjoystick(L, 1);
@@ -337,6 +457,8 @@ static const luaL_Reg w_Joystick_functions[] =
 	{ "isGamepadDown", w_Joystick_isGamepadDown },
 	{ "getGamepadMapping", w_Joystick_getGamepadMapping },
 
+	{ "getState", w_Joystick_getState },
+
 	{ "isVibrationSupported", w_Joystick_isVibrationSupported },
 	{ "setVibration", w_Joystick_setVibration },
 	{ "getVibration", w_Joystick_getVibration },
@@ -32,6 +32,13 @@ namespace joystick
 {
 
 Joystick *luax_checkjoystick(lua_State *L, int idx);
+
+/**
+ * Pushes a Joystick's State as a table. The table at 'idx' and its sub-tables
+ * are reused if it's a table, so polling every frame doesn't make garbage.
+ **/
+void luax_pushjoystickstate(lua_State *L, const Joystick::State &state, double timestamp, int idx);
+
 extern "C" int luaopen_joystick(lua_State *L);
 
 } // joystick
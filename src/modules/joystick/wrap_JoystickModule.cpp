@@ -48,6 +48,48 @@ int w_getJoysticks(lua_State *L)
 	return 1;
 }
 
+int w_getStates(lua_State *L)
+{
+	int stickcount = instance()->getJoystickCount();
+	double timestamp = instance()->getLastPumpTime();
+
+	if (lua_istable(L, 1))
+		lua_settop(L, 1);
+	else
+	{
+		lua_settop(L, 0);
+		lua_createtable(L, stickcount, 0);
+	}
+
+	Joystick::State state;
+
+	for (int i = 0; i < stickcount; i++)
+	{
+		instance()->getJoystick(i)->getState(state);
+
+		// Reuse the existing state table for this index, if there is one.
+		lua_rawgeti(L, 1, i + 1);
+		luax_pushjoystickstate(L, state, timestamp, -1);
+		lua_rawseti(L, 1, i + 1);
+		lua_pop(L, 1);
+	}
+
+	for (int i = stickcount + 1; ; i++)
+	{
+		lua_rawgeti(L, 1, i);
+		bool isnil = lua_isnil(L, -1);
+		lua_pop(L, 1);
+
+		if (isnil)
+			break;
+
+		lua_pushnil(L);
+		lua_rawseti(L, 1, i);
+	}
+
+	return 1;
+}
+
 int w_getIndex(lua_State *L)
 {
 	Joystick *j = luax_checkjoystick(L, 1);
@@ -165,6 +207,7 @@ static const luaL_Reg functions[] =
 {
 	{ "getJoysticks", w_getJoysticks },
 	{ "getJoystickCount", w_getJoystickCount },
+	{ "getStates", w_getStates },
 	{ "setGamepadMapping", w_setGamepadMapping },
 	{ "loadGamepadMappings", w_loadGamepadMappings },
 	{ "saveGamepadMappings", w_saveGamepadMappings },
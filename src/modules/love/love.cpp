@@ -73,6 +73,11 @@ extern "C"
 #include "scripts/nogame.lua.h"
 #include "scripts/boot.lua.h"
 
+#ifdef LOVE_PRECOMPILED_LUA
+#include "luabytecode/nogame_lua.h"
+#include "luabytecode/boot_lua.h"
+#endif
+
 // All modules define a c-accessible luaopen
 // so let's make use of those, instead
 // of addressing implementations directly.
@@ -114,6 +119,9 @@ extern "C"
 #if defined(LOVE_ENABLE_PHYSICS)
 	extern int luaopen_love_physics(lua_State*);
 #endif
+#if defined(LOVE_ENABLE_PROFILER)
+	extern int luaopen_love_profiler(lua_State*);
+#endif
 #if defined(LOVE_ENABLE_SOUND)
 	extern int luaopen_love_sound(lua_State*);
 #endif
@@ -176,6 +184,9 @@ static const luaL_Reg modules[] = {
 #if defined(LOVE_ENABLE_PHYSICS)
 	{ "love.physics", luaopen_love_physics },
 #endif
+#if defined(LOVE_ENABLE_PROFILER)
+	{ "love.profiler", luaopen_love_profiler },
+#endif
 #if defined(LOVE_ENABLE_SOUND)
 	{ "love.sound", luaopen_love_sound },
 #endif
@@ -532,7 +543,7 @@ int w__setAccelerometerAsJoystick(lua_State *L)
 
 int luaopen_love_nogame(lua_State *L)
 {
-	if (luaL_loadbuffer(L, (const char *)love::nogame_lua, sizeof(love::nogame_lua), "nogame.lua") == 0)
+	if (love::luax_loadembedded(L, LOVE_EMBEDDED_BYTECODE(nogame_lua), (const char *)love::nogame_lua, sizeof(love::nogame_lua), "nogame.lua") == 0)
 		lua_call(L, 0, 1);
 
 	return 1;
@@ -540,7 +551,7 @@ int luaopen_love_nogame(lua_State *L)
 
 int luaopen_love_boot(lua_State *L)
 {
-	if (luaL_loadbuffer(L, (const char *)love::boot_lua, sizeof(love::boot_lua), "boot.lua") == 0)
+	if (love::luax_loadembedded(L, LOVE_EMBEDDED_BYTECODE(boot_lua), (const char *)love::boot_lua, sizeof(love::boot_lua), "boot.lua") == 0)
 		lua_call(L, 0, 1);
 
 	return 1;
@@ -76,6 +76,68 @@ void subdivide(vector<love::Vector2> &points, int k)
 		points[i-1 + left.size()] = right[right.size() - i - 1];
 }
 
+/**
+ * Checks whether the control polygon is within tolerance of its chord. The
+ * curve lies in the convex hull of the control points, so it is as well.
+ **/
+bool isFlat(const vector<love::Vector2> &points, double tolerance)
+{
+	const love::Vector2 &a = points.front();
+	love::Vector2 chord = points.back() - a;
+	float chordlen2 = chord.getLengthSquare();
+	float tolerance2 = float(tolerance * tolerance);
+
+	for (size_t i = 1; i + 1 < points.size(); i++)
+	{
+		love::Vector2 d = points[i] - a;
+
+		if (chordlen2 > 0.0f)
+		{
+			float t = std::min(std::max(love::Vector2::dot(d, chord) / chordlen2, 0.0f), 1.0f);
+			d -= chord * t;
+		}
+
+		if (d.getLengthSquare() > tolerance2)
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Flattens a Bezier control polygon, appending every vertex but the first.
+ **/
+void flatten(const vector<love::Vector2> &points, double tolerance, int depth, vector<love::Vector2> &out)
+{
+	// Deep enough for any on-screen curve with sensible tolerances.
+	const int MAX_DEPTH = 16;
+
+	if (depth >= MAX_DEPTH || isFlat(points, tolerance))
+	{
+		out.push_back(points.back());
+		return;
+	}
+
+	// de Casteljau at t = 0.5, as in subdivide().
+	vector<love::Vector2> left, right, work(points);
+	left.reserve(points.size());
+	right.reserve(points.size());
+
+	for (size_t step = 1; step < work.size(); ++step)
+	{
+		left.push_back(work[0]);
+		right.push_back(work[work.size() - step]);
+		for (size_t i = 0; i < work.size() - step; ++i)
+			work[i] = (work[i] + work[i+1]) * .5;
+	}
+	left.push_back(work[0]);
+	right.push_back(work[0]);
+	std::reverse(right.begin(), right.end());
+
+	flatten(left, tolerance, depth + 1, out);
+	flatten(right, tolerance, depth + 1, out);
+}
+
 }
 
 namespace love
@@ -272,5 +334,38 @@ vector<Vector2> BezierCurve::renderSegment(double start, double end, int accurac
 	return vertices;
 }
 
+void BezierCurve::renderAdaptive(double tolerance, std::vector<Vector2> &points) const
+{
+	if (controlPoints.size() < 2)
+		throw Exception("Invalid Bezier curve: Not enough control points.");
+	if (!(tolerance > 0.0))
+		throw Exception("Bezier curve tolerance must be greater than 0.");
+
+	points.push_back(controlPoints.front());
+	flatten(controlPoints, tolerance, 0, points);
+}
+
+void BezierCurve::renderAdaptive(const BezierCurve * const *curves, size_t count, double tolerance, std::vector<Vector2> &points, std::vector<size_t> &chainStarts)
+{
+	if (!(tolerance > 0.0))
+		throw Exception("Bezier curve tolerance must be greater than 0.");
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const std::vector<Vector2> &controls = curves[i]->controlPoints;
+
+		if (controls.size() < 2)
+			throw Exception("Invalid Bezier curve: Not enough control points.");
+
+		if (chainStarts.empty() || points.empty() || points.back() != controls.front())
+		{
+			chainStarts.push_back(points.size());
+			points.push_back(controls.front());
+		}
+
+		flatten(controls, tolerance, 0, points);
+	}
+}
+
 } // namespace math
 } // namespace love
@@ -140,6 +140,22 @@ public:
 	 **/
 	std::vector<Vector2> renderSegment(double start, double end, int accuracy = 4) const;
 
+	/**
+	 * Renders the curve by subdividing only where it isn't flat enough yet.
+	 * @param tolerance Maximum distance between the curve and the polygon
+	 *        chain, in the curve's units.
+	 * @param points The polygon chain is appended to this.
+	 **/
+	void renderAdaptive(double tolerance, std::vector<Vector2> &points) const;
+
+	/**
+	 * Renders several curves adaptively into one list of points. A curve
+	 * starting where the previous one ended continues the same chain.
+	 * @param chainStarts Receives the index in points where each separate
+	 *        polygon chain starts.
+	 **/
+	static void renderAdaptive(const BezierCurve * const *curves, size_t count, double tolerance, std::vector<Vector2> &points, std::vector<size_t> &chainStarts);
+
 private:
 	std::vector<Vector2> controlPoints;
 };
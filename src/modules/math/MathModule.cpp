@@ -25,60 +25,786 @@
 #include "common/StringMap.h"
 #include "BezierCurve.h"
 #include "Transform.h"
+#include "SpatialIndex.h"
+#include "Vec2Array.h"
+#include "data/ByteData.h"
 
 // STL
 #include <cmath>
-#include <list>
+#include <algorithm>
+#include <limits>
 #include <iostream>
+#include <map>
 
 // C
 #include <time.h>
 
-using std::list;
 using love::Vector2;
 
 namespace
 {
 
-// check if an angle is oriented counter clockwise
-inline bool is_oriented_ccw(const Vector2 &a, const Vector2 &b, const Vector2 &c)
+/**
+ * Ear clipping triangulation of polygons with holes, following the algorithm
+ * of the earcut library. Vertices live in one flat array of nodes linked by
+ * index. Larger polygons are also indexed along a z-order curve, so ear tests
+ * only look at vertices near the candidate ear.
+ **/
+class Earcut
 {
-	// return det(b-a, c-a) >= 0
-	return ((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x)) >= 0;
-}
+public:
 
-// check if a and b are on the same side of the line c->d
-bool on_same_side(const Vector2 &a, const Vector2 &b, const Vector2 &c, const Vector2 &d)
-{
-	float px = d.x - c.x, py = d.y - c.y;
-	// return det(p, a-c) * det(p, b-c) >= 0
-	float l = px * (a.y - c.y) - py * (a.x - c.x);
-	float m = px * (b.y - c.y) - py * (b.x - c.x);
-	return l * m >= 0;
-}
+	void triangulate(const Vector2 *points, size_t count, const std::vector<size_t> &holeStarts, std::vector<love::uint32> &indices)
+	{
+		nodes.clear();
+		nodes.reserve(count * 3 / 2 + holeStarts.size() * 2 + 8);
+		this->indices = &indices;
 
-// checks is p is contained in the triangle abc
-inline bool point_in_triangle(const Vector2 &p, const Vector2 &a, const Vector2 &b, const Vector2 &c)
-{
-	return on_same_side(p,a, b,c) && on_same_side(p,b, a,c) && on_same_side(p,c, a,b);
-}
+		size_t outerEnd = holeStarts.empty() ? count : holeStarts[0];
 
-// checks if any vertex in `vertices' is in the triangle abc.
-bool any_point_in_triangle(const std::list<const Vector2 *> &vertices, const Vector2 &a, const Vector2 &b, const Vector2 &c)
-{
-	for (const Vector2 *p : vertices)
+		int outer = linkedList(points, 0, outerEnd, true);
+		if (outer < 0 || nodes[outer].next == nodes[outer].prev)
+			return;
+
+		if (!holeStarts.empty())
+			outer = eliminateHoles(points, count, holeStarts, outer);
+
+		invSize = 0.0;
+
+		// Hashing only pays off for larger polygons.
+		if (count > 80)
+		{
+			minX = maxX = points[0].x;
+			minY = maxY = points[0].y;
+
+			for (size_t i = 1; i < outerEnd; i++)
+			{
+				minX = std::min(minX, (double) points[i].x);
+				minY = std::min(minY, (double) points[i].y);
+				maxX = std::max(maxX, (double) points[i].x);
+				maxY = std::max(maxY, (double) points[i].y);
+			}
+
+			// Coordinates are mapped to [0, 32767] for the z-order curve.
+			invSize = std::max(maxX - minX, maxY - minY);
+			invSize = invSize != 0.0 ? 32767.0 / invSize : 0.0;
+		}
+
+		earcutLinked(outer, 0);
+	}
+
+private:
+
+	struct Node
+	{
+		love::uint32 i;
+		double x, y;
+
+		int prev = -1, next = -1;
+
+		// Z-order curve value, and neighbours in z-order.
+		love::uint32 z = 0;
+		int prevZ = -1, nextZ = -1;
+
+		bool steiner = false;
+	};
+
+	int insertNode(love::uint32 i, double x, double y, int last)
+	{
+		Node n;
+		n.i = i;
+		n.x = x;
+		n.y = y;
+
+		int p = (int) nodes.size();
+		nodes.push_back(n);
+
+		if (last < 0)
+		{
+			nodes[p].prev = p;
+			nodes[p].next = p;
+		}
+		else
+		{
+			nodes[p].next = nodes[last].next;
+			nodes[p].prev = last;
+			nodes[nodes[last].next].prev = p;
+			nodes[last].next = p;
+		}
+
+		return p;
+	}
+
+	void removeNode(int p)
+	{
+		Node &n = nodes[p];
+
+		nodes[n.next].prev = n.prev;
+		nodes[n.prev].next = n.next;
+
+		if (n.prevZ >= 0)
+			nodes[n.prevZ].nextZ = n.nextZ;
+		if (n.nextZ >= 0)
+			nodes[n.nextZ].prevZ = n.prevZ;
+	}
+
+	double area(int p, int q, int r) const
+	{
+		const Node &a = nodes[p], &b = nodes[q], &c = nodes[r];
+		return (b.y - a.y) * (c.x - b.x) - (b.x - a.x) * (c.y - b.y);
+	}
+
+	bool equals(int p, int q) const
 	{
-		if ((p != &a) && (p != &b) && (p != &c) && point_in_triangle(*p, a,b,c)) // oh god...
+		return nodes[p].x == nodes[q].x && nodes[p].y == nodes[q].y;
+	}
+
+	static bool pointInTriangle(double ax, double ay, double bx, double by, double cx, double cy, double px, double py)
+	{
+		return (cx - px) * (ay - py) >= (ax - px) * (cy - py)
+			&& (ax - px) * (by - py) >= (bx - px) * (ay - py)
+			&& (bx - px) * (cy - py) >= (cx - px) * (by - py);
+	}
+
+	bool pointInTriangle(int a, int b, int c, int p) const
+	{
+		const Node &na = nodes[a], &nb = nodes[b], &nc = nodes[c], &np = nodes[p];
+		return pointInTriangle(na.x, na.y, nb.x, nb.y, nc.x, nc.y, np.x, np.y);
+	}
+
+	static int sign(double v)
+	{
+		return (v > 0.0) - (v < 0.0);
+	}
+
+	// Whether q lies on the bounding box of the segment p-r.
+	bool onSegment(int p, int q, int r) const
+	{
+		const Node &a = nodes[p], &b = nodes[q], &c = nodes[r];
+		return b.x <= std::max(a.x, c.x) && b.x >= std::min(a.x, c.x)
+			&& b.y <= std::max(a.y, c.y) && b.y >= std::min(a.y, c.y);
+	}
+
+	bool intersects(int p1, int q1, int p2, int q2) const
+	{
+		int o1 = sign(area(p1, q1, p2));
+		int o2 = sign(area(p1, q1, q2));
+		int o3 = sign(area(p2, q2, p1));
+		int o4 = sign(area(p2, q2, q1));
+
+		if (o1 != o2 && o3 != o4)
 			return true;
+
+		// Collinear special cases.
+		return (o1 == 0 && onSegment(p1, p2, q1)) || (o2 == 0 && onSegment(p1, q2, q1))
+			|| (o3 == 0 && onSegment(p2, p1, q2)) || (o4 == 0 && onSegment(p2, q1, q2));
 	}
 
-	return false;
-}
+	bool intersectsPolygon(int a, int b) const
+	{
+		int p = a;
+		do
+		{
+			const Node &n = nodes[p];
+			const Node &next = nodes[n.next];
 
-inline bool is_ear(const Vector2 &a, const Vector2 &b, const Vector2 &c, const std::list<const Vector2 *> &vertices)
-{
-	return is_oriented_ccw(a,b,c) && !any_point_in_triangle(vertices, a,b,c);
-}
+			if (n.i != nodes[a].i && next.i != nodes[a].i && n.i != nodes[b].i && next.i != nodes[b].i
+				&& intersects(p, n.next, a, b))
+			{
+				return true;
+			}
+
+			p = n.next;
+		} while (p != a);
+
+		return false;
+	}
+
+	// Whether the diagonal a-b starts inside the polygon at a.
+	bool locallyInside(int a, int b) const
+	{
+		const Node &n = nodes[a];
+
+		if (area(n.prev, a, n.next) < 0)
+			return area(a, b, n.next) >= 0 && area(a, n.prev, b) >= 0;
+		else
+			return area(a, b, n.prev) < 0 || area(a, n.next, b) < 0;
+	}
+
+	bool middleInside(int a, int b) const
+	{
+		double px = (nodes[a].x + nodes[b].x) / 2.0;
+		double py = (nodes[a].y + nodes[b].y) / 2.0;
+
+		bool inside = false;
+		int p = a;
+
+		do
+		{
+			const Node &n = nodes[p];
+			const Node &next = nodes[n.next];
+
+			if (((n.y > py) != (next.y > py)) && next.y != n.y
+				&& (px < (next.x - n.x) * (py - n.y) / (next.y - n.y) + n.x))
+			{
+				inside = !inside;
+			}
+
+			p = n.next;
+		} while (p != a);
+
+		return inside;
+	}
+
+	bool isValidDiagonal(int a, int b) const
+	{
+		const Node &na = nodes[a], &nb = nodes[b];
+
+		if (nodes[na.next].i == nb.i || nodes[na.prev].i == nb.i || intersectsPolygon(a, b))
+			return false;
+
+		return (locallyInside(a, b) && locallyInside(b, a) && middleInside(a, b)
+				&& (area(na.prev, a, nb.prev) != 0.0 || area(a, nb.prev, b) != 0.0))
+			|| (equals(a, b) && area(na.prev, a, na.next) > 0 && area(nb.prev, b, nb.next) > 0);
+	}
+
+	/**
+	 * Links a and b with a bridge, splitting the polygon in two. If they're in
+	 * different rings (a hole and the outer ring), it merges them instead.
+	 **/
+	int splitPolygon(int a, int b)
+	{
+		Node na = nodes[a];
+		Node nb = nodes[b];
+		na.prevZ = na.nextZ = -1;
+		nb.prevZ = nb.nextZ = -1;
+
+		int a2 = (int) nodes.size();
+		nodes.push_back(na);
+		int b2 = (int) nodes.size();
+		nodes.push_back(nb);
+
+		int an = nodes[a].next;
+		int bp = nodes[b].prev;
+
+		nodes[a].next = b;
+		nodes[b].prev = a;
+
+		nodes[a2].next = an;
+		nodes[an].prev = a2;
+
+		nodes[b2].next = a2;
+		nodes[a2].prev = b2;
+
+		nodes[bp].next = b2;
+		nodes[b2].prev = bp;
+
+		return b2;
+	}
+
+	static double signedArea(const Vector2 *points, size_t start, size_t end)
+	{
+		double sum = 0.0;
+
+		for (size_t i = start, j = end - 1; i < end; j = i++)
+			sum += ((double) points[j].x - points[i].x) * ((double) points[i].y + points[j].y);
+
+		return sum;
+	}
+
+	int linkedList(const Vector2 *points, size_t start, size_t end, bool clockwise)
+	{
+		int last = -1;
+
+		if (end <= start)
+			return last;
+
+		if (clockwise == (signedArea(points, start, end) > 0))
+		{
+			for (size_t i = start; i < end; i++)
+				last = insertNode((love::uint32) i, points[i].x, points[i].y, last);
+		}
+		else
+		{
+			for (size_t i = end; i-- > start;)
+				last = insertNode((love::uint32) i, points[i].x, points[i].y, last);
+		}
+
+		if (last >= 0 && equals(last, nodes[last].next))
+		{
+			int next = nodes[last].next;
+			removeNode(last);
+			last = next;
+		}
+
+		return last;
+	}
+
+	// Removes duplicate and collinear points.
+	int filterPoints(int start, int end = -1)
+	{
+		if (start < 0)
+			return start;
+
+		if (end < 0)
+			end = start;
+
+		int p = start;
+		bool again = false;
+
+		do
+		{
+			again = false;
+			const Node &n = nodes[p];
+
+			if (!n.steiner && (equals(p, n.next) || area(n.prev, p, n.next) == 0.0))
+			{
+				int prev = n.prev;
+				removeNode(p);
+				p = end = prev;
+
+				if (p == nodes[p].next)
+					break;
+
+				again = true;
+			}
+			else
+				p = n.next;
+		} while (again || p != end);
+
+		return end;
+	}
+
+	love::uint32 zOrder(double px, double py) const
+	{
+		love::uint32 x = (love::uint32) std::min(std::max((px - minX) * invSize, 0.0), 32767.0);
+		love::uint32 y = (love::uint32) std::min(std::max((py - minY) * invSize, 0.0), 32767.0);
+
+		x = (x | (x << 8)) & 0x00FF00FF;
+		x = (x | (x << 4)) & 0x0F0F0F0F;
+		x = (x | (x << 2)) & 0x33333333;
+		x = (x | (x << 1)) & 0x55555555;
+
+		y = (y | (y << 8)) & 0x00FF00FF;
+		y = (y | (y << 4)) & 0x0F0F0F0F;
+		y = (y | (y << 2)) & 0x33333333;
+		y = (y | (y << 1)) & 0x55555555;
+
+		return x | (y << 1);
+	}
+
+	// Merge sort of the z-order list (Simon Tatham's linked list sort).
+	int sortLinked(int list)
+	{
+		int insize = 1;
+		int nmerges = 0;
+
+		do
+		{
+			int p = list;
+			int tail = -1;
+			list = -1;
+			nmerges = 0;
+
+			while (p >= 0)
+			{
+				nmerges++;
+
+				int q = p;
+				int psize = 0;
+
+				for (int i = 0; i < insize; i++)
+				{
+					psize++;
+					q = nodes[q].nextZ;
+					if (q < 0)
+						break;
+				}
+
+				int qsize = insize;
+
+				while (psize > 0 || (qsize > 0 && q >= 0))
+				{
+					int e;
+
+					if (psize != 0 && (qsize == 0 || q < 0 || nodes[p].z <= nodes[q].z))
+					{
+						e = p;
+						p = nodes[p].nextZ;
+						psize--;
+					}
+					else
+					{
+						e = q;
+						q = nodes[q].nextZ;
+						qsize--;
+					}
+
+					if (tail >= 0)
+						nodes[tail].nextZ = e;
+					else
+						list = e;
+
+					nodes[e].prevZ = tail;
+					tail = e;
+				}
+
+				p = q;
+			}
+
+			nodes[tail].nextZ = -1;
+			insize *= 2;
+		} while (nmerges > 1);
+
+		return list;
+	}
+
+	void indexCurve(int start)
+	{
+		int p = start;
+
+		do
+		{
+			Node &n = nodes[p];
+			n.z = zOrder(n.x, n.y);
+			n.prevZ = n.prev;
+			n.nextZ = n.next;
+			p = n.next;
+		} while (p != start);
+
+		nodes[nodes[p].prevZ].nextZ = -1;
+		nodes[p].prevZ = -1;
+
+		sortLinked(p);
+	}
+
+	bool isEar(int ear) const
+	{
+		const Node &n = nodes[ear];
+		int a = n.prev, b = ear, c = n.next;
+
+		// Reflex, can't be an ear.
+		if (area(a, b, c) >= 0)
+			return false;
+
+		// Make sure no other point is inside the potential ear.
+		for (int p = nodes[c].next; p != a; p = nodes[p].next)
+		{
+			if (pointInTriangle(a, b, c, p) && area(nodes[p].prev, p, nodes[p].next) >= 0)
+				return false;
+		}
+
+		return true;
+	}
+
+	bool isEarHashed(int ear) const
+	{
+		const Node &n = nodes[ear];
+		int a = n.prev, b = ear, c = n.next;
+
+		if (area(a, b, c) >= 0)
+			return false;
+
+		const Node &na = nodes[a], &nb = nodes[b], &nc = nodes[c];
+
+		// Z-order range of the triangle's bounding box.
+		love::uint32 minz = zOrder(std::min(na.x, std::min(nb.x, nc.x)), std::min(na.y, std::min(nb.y, nc.y)));
+		love::uint32 maxz = zOrder(std::max(na.x, std::max(nb.x, nc.x)), std::max(na.y, std::max(nb.y, nc.y)));
+
+		int p = n.prevZ;
+		int q = n.nextZ;
+
+		// Look for points inside the triangle in both directions.
+		while (p >= 0 && nodes[p].z >= minz && q >= 0 && nodes[q].z <= maxz)
+		{
+			if (p != a && p != c && pointInTriangle(a, b, c, p) && area(nodes[p].prev, p, nodes[p].next) >= 0)
+				return false;
+			p = nodes[p].prevZ;
+
+			if (q != a && q != c && pointInTriangle(a, b, c, q) && area(nodes[q].prev, q, nodes[q].next) >= 0)
+				return false;
+			q = nodes[q].nextZ;
+		}
+
+		while (p >= 0 && nodes[p].z >= minz)
+		{
+			if (p != a && p != c && pointInTriangle(a, b, c, p) && area(nodes[p].prev, p, nodes[p].next) >= 0)
+				return false;
+			p = nodes[p].prevZ;
+		}
+
+		while (q >= 0 && nodes[q].z <= maxz)
+		{
+			if (q != a && q != c && pointInTriangle(a, b, c, q) && area(nodes[q].prev, q, nodes[q].next) >= 0)
+				return false;
+			q = nodes[q].nextZ;
+		}
+
+		return true;
+	}
+
+	void addTriangle(int a, int b, int c)
+	{
+		indices->push_back(nodes[a].i);
+		indices->push_back(nodes[b].i);
+		indices->push_back(nodes[c].i);
+	}
+
+	// Removes small self-intersections, by cutting off the triangle at them.
+	int cureLocalIntersections(int start)
+	{
+		int p = start;
+
+		do
+		{
+			int a = nodes[p].prev;
+			int b = nodes[nodes[p].next].next;
+
+			if (!equals(a, b) && intersects(a, p, nodes[p].next, b) && locallyInside(a, b) && locallyInside(b, a))
+			{
+				addTriangle(a, p, b);
+
+				removeNode(nodes[p].next);
+				removeNode(p);
+
+				p = start = b;
+			}
+
+			p = nodes[p].next;
+		} while (p != start);
+
+		return filterPoints(p);
+	}
+
+	// Splits the polygon along a valid diagonal, and triangulates both halves.
+	void splitEarcut(int start)
+	{
+		int a = start;
+
+		do
+		{
+			int b = nodes[nodes[a].next].next;
+
+			while (b != nodes[a].prev)
+			{
+				if (nodes[a].i != nodes[b].i && isValidDiagonal(a, b))
+				{
+					int c = splitPolygon(a, b);
+
+					a = filterPoints(a, nodes[a].next);
+					c = filterPoints(c, nodes[c].next);
+
+					earcutLinked(a, 0);
+					earcutLinked(c, 0);
+					return;
+				}
+
+				b = nodes[b].next;
+			}
+
+			a = nodes[a].next;
+		} while (a != start);
+	}
+
+	void earcutLinked(int ear, int pass)
+	{
+		if (ear < 0)
+			return;
+
+		if (pass == 0 && invSize != 0.0)
+			indexCurve(ear);
+
+		int stop = ear;
+
+		while (nodes[ear].prev != nodes[ear].next)
+		{
+			int prev = nodes[ear].prev;
+			int next = nodes[ear].next;
+
+			if (invSize != 0.0 ? isEarHashed(ear) : isEar(ear))
+			{
+				addTriangle(prev, ear, next);
+				removeNode(ear);
+
+				// Skipping the next vertex leads to fewer sliver triangles.
+				ear = nodes[next].next;
+				stop = ear;
+				continue;
+			}
+
+			ear = next;
+
+			// Went all the way around without finding an ear.
+			if (ear == stop)
+			{
+				if (pass == 0)
+					earcutLinked(filterPoints(ear), 1);
+				else if (pass == 1)
+					earcutLinked(cureLocalIntersections(filterPoints(ear)), 2);
+				else
+					splitEarcut(ear);
+
+				break;
+			}
+		}
+	}
+
+	int getLeftmost(int start) const
+	{
+		int p = start;
+		int leftmost = start;
+
+		do
+		{
+			const Node &n = nodes[p];
+			const Node &l = nodes[leftmost];
+
+			if (n.x < l.x || (n.x == l.x && n.y < l.y))
+				leftmost = p;
+
+			p = n.next;
+		} while (p != start);
+
+		return leftmost;
+	}
+
+	bool sectorContainsSector(int m, int p) const
+	{
+		return area(nodes[m].prev, m, nodes[p].prev) < 0 && area(nodes[p].next, m, nodes[m].next) < 0;
+	}
+
+	// David Eberly's algorithm for finding a bridge between a hole and the
+	// outer polygon.
+	int findHoleBridge(int hole, int outer) const
+	{
+		int p = outer;
+		double hx = nodes[hole].x;
+		double hy = nodes[hole].y;
+		double qx = -std::numeric_limits<double>::infinity();
+		int m = -1;
+
+		// Find the segment intersected by a ray from the hole's leftmost point
+		// to the left. The segment's endpoint with the lesser x is a candidate.
+		do
+		{
+			const Node &n = nodes[p];
+			const Node &next = nodes[n.next];
+
+			if (hy <= n.y && hy >= next.y && next.y != n.y)
+			{
+				double x = n.x + (hy - n.y) * (next.x - n.x) / (next.y - n.y);
+
+				if (x <= hx && x > qx)
+				{
+					qx = x;
+
+					if (x == hx)
+					{
+						if (hy == n.y)
+							return p;
+						if (hy == next.y)
+							return n.next;
+					}
+
+					m = n.x < next.x ? p : n.next;
+				}
+			}
+
+			p = n.next;
+		} while (p != outer);
+
+		if (m < 0)
+			return -1;
+
+		// The hole touches the outer segment.
+		if (hx == qx)
+			return m;
+
+		// Look for points inside the triangle of the hole point, the segment
+		// intersection and the endpoint. If there are any, the one with the
+		// smallest angle to the ray is the bridge point.
+		int stop = m;
+		double mx = nodes[m].x;
+		double my = nodes[m].y;
+		double tanmin = std::numeric_limits<double>::infinity();
+
+		p = m;
+
+		do
+		{
+			const Node &n = nodes[p];
+
+			if (hx >= n.x && n.x >= mx && hx != n.x
+				&& pointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, n.x, n.y))
+			{
+				double tan = std::abs(hy - n.y) / (hx - n.x);
+
+				if (locallyInside(p, hole)
+					&& (tan < tanmin || (tan == tanmin && (n.x > nodes[m].x || (n.x == nodes[m].x && sectorContainsSector(m, p))))))
+				{
+					m = p;
+					tanmin = tan;
+				}
+			}
+
+			p = n.next;
+		} while (p != stop);
+
+		return m;
+	}
+
+	int eliminateHole(int hole, int outer)
+	{
+		int bridge = findHoleBridge(hole, outer);
+		if (bridge < 0)
+			return outer;
+
+		int bridgereverse = splitPolygon(bridge, hole);
+
+		// Filter collinear points around the cuts.
+		int filtered = filterPoints(bridge, nodes[bridge].next);
+		filterPoints(bridgereverse, nodes[bridgereverse].next);
+
+		// The outer node may have been removed by the filtering.
+		return outer == bridge ? filtered : outer;
+	}
+
+	int eliminateHoles(const Vector2 *points, size_t count, const std::vector<size_t> &holeStarts, int outer)
+	{
+		std::vector<int> queue;
+		queue.reserve(holeStarts.size());
+
+		for (size_t i = 0; i < holeStarts.size(); i++)
+		{
+			size_t start = holeStarts[i];
+			size_t end = i + 1 < holeStarts.size() ? holeStarts[i + 1] : count;
+
+			int list = linkedList(points, start, end, false);
+			if (list < 0)
+				continue;
+
+			if (list == nodes[list].next)
+				nodes[list].steiner = true;
+
+			queue.push_back(getLeftmost(list));
+		}
+
+		// Process holes from left to right.
+		std::sort(queue.begin(), queue.end(), [this](int a, int b) { return nodes[a].x < nodes[b].x; });
+
+		for (int hole : queue)
+			outer = eliminateHole(hole, outer);
+
+		return outer;
+	}
+
+	std::vector<Node> nodes;
+	std::vector<love::uint32> *indices = nullptr;
+
+	double minX = 0.0, minY = 0.0, maxX = 0.0, maxY = 0.0;
+	double invSize = 0.0;
+
+}; // Earcut
 
 } // anonymous namespace
 
@@ -87,85 +813,201 @@ namespace love
 namespace math
 {
 
-std::vector<Triangle> triangulate(const std::vector<love::Vector2> &polygon)
+void triangulate(const Vector2 *points, size_t count, const std::vector<size_t> &holeStarts, std::vector<uint32> &indices)
 {
-	if (polygon.size() < 3)
+	if (count < 3)
 		throw love::Exception("Not a polygon");
-	else if (polygon.size() == 3)
-		return std::vector<Triangle>(1, Triangle(polygon[0], polygon[1], polygon[2]));
 
-	// collect list of connections and record leftmost item to check if the polygon
-	// has the expected winding
-	std::vector<size_t> next_idx(polygon.size()), prev_idx(polygon.size());
-	size_t idx_lm = 0;
-	for (size_t i = 0; i < polygon.size(); ++i)
+	for (size_t i = 0; i < holeStarts.size(); i++)
 	{
-		const love::Vector2 &lm = polygon[idx_lm], &p = polygon[i];
-		if (p.x < lm.x || (p.x == lm.x && p.y < lm.y))
-			idx_lm = i;
-		next_idx[i] = i+1;
-		prev_idx[i] = i-1;
+		if (holeStarts[i] == 0 || holeStarts[i] > count || (i > 0 && holeStarts[i] < holeStarts[i - 1]))
+			throw love::Exception("Invalid polygon hole starting index: %d", (int) holeStarts[i]);
 	}
-	next_idx[next_idx.size()-1] = 0;
-	prev_idx[0] = prev_idx.size()-1;
 
-	// check if the polygon has the expected winding and reverse polygon if needed
-	if (!is_oriented_ccw(polygon[prev_idx[idx_lm]], polygon[idx_lm], polygon[next_idx[idx_lm]]))
-		next_idx.swap(prev_idx);
+	Earcut earcut;
+	earcut.triangulate(points, count, holeStarts, indices);
+}
+
+std::vector<Triangle> triangulate(const std::vector<love::Vector2> &polygon)
+{
+	return triangulate(polygon, std::vector<size_t>());
+}
+
+std::vector<Triangle> triangulate(const std::vector<love::Vector2> &points, const std::vector<size_t> &holeStarts)
+{
+	if (points.size() < 3)
+		throw love::Exception("Not a polygon");
+	else if (points.size() == 3 && holeStarts.empty())
+		return std::vector<Triangle>(1, Triangle(points[0], points[1], points[2]));
 
-	// collect list of concave polygons
-	std::list<const love::Vector2 *> concave_vertices;
-	for (size_t i = 0; i < polygon.size(); ++i)
+	std::vector<uint32> indices;
+	triangulate(points.data(), points.size(), holeStarts, indices);
+
+	std::vector<Triangle> triangles;
+	triangles.reserve(indices.size() / 3);
+
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		triangles.push_back(Triangle(points[indices[i]], points[indices[i + 1]], points[indices[i + 2]]));
+
+	return triangles;
+}
+
+void decomposeConvex(const Vector2 *points, size_t count, const std::vector<size_t> &holeStarts, int maxVertices, std::vector<std::vector<uint32>> &pieces)
+{
+	if (maxVertices < 3)
+		throw love::Exception("Convex pieces must be allowed at least 3 vertices.");
+
+	std::vector<uint32> indices;
+	triangulate(points, count, holeStarts, indices);
+
+	auto turn = [points](uint32 a, uint32 b, uint32 c)
 	{
-		if (!is_oriented_ccw(polygon[prev_idx[i]], polygon[i], polygon[next_idx[i]]))
-			concave_vertices.push_back(&polygon[i]);
+		return Vector2::cross(points[b] - points[a], points[c] - points[b]);
+	};
+
+	std::vector<std::vector<uint32>> polys;
+	polys.reserve(indices.size() / 3);
+
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		uint32 a = indices[i], b = indices[i + 1], c = indices[i + 2];
+		if (turn(a, b, c) < 0.0f)
+			std::swap(b, c);
+		polys.push_back({a, b, c});
 	}
 
-	// triangulation according to kong
-	std::vector<Triangle> triangles;
-	size_t n_vertices = polygon.size();
-	size_t current = 1, skipped = 0, next, prev;
-	while (n_vertices > 3)
+	// The polygons on either side of each edge, by the edge's sorted indices.
+	std::map<std::pair<uint32, uint32>, std::vector<size_t>> edges;
+	for (size_t p = 0; p < polys.size(); p++)
+	{
+		for (size_t i = 0; i < 3; i++)
+		{
+			uint32 a = polys[p][i], b = polys[p][(i + 1) % 3];
+			edges[std::make_pair(std::min(a, b), std::max(a, b))].push_back(p);
+		}
+	}
+
+	// Merged polygons point at the one they were merged into.
+	std::vector<size_t> parent(polys.size());
+	for (size_t p = 0; p < parent.size(); p++)
+		parent[p] = p;
+
+	auto find = [&](size_t p)
 	{
-		next = next_idx[current];
-		prev = prev_idx[current];
-		const Vector2 &a = polygon[prev], &b = polygon[current], &c = polygon[next];
-		if (is_ear(a,b,c, concave_vertices))
+		while (parent[p] != p)
+			p = parent[p] = parent[parent[p]];
+		return p;
+	};
+
+	std::vector<uint32> merged;
+	std::vector<uint32> sorted;
+
+	for (const auto &edge : edges)
+	{
+		if (edge.second.size() != 2)
+			continue;
+
+		size_t p = find(edge.second[0]);
+		size_t q = find(edge.second[1]);
+		if (p == q)
+			continue;
+
+		const std::vector<uint32> &P = polys[p];
+		const std::vector<uint32> &Q = polys[q];
+
+		// The shared edge goes x -> y in P, and y -> x in Q.
+		size_t i = 0, j = 0;
+		for (; i < P.size(); i++)
 		{
-			triangles.push_back(Triangle(a,b,c));
-			next_idx[prev] = next;
-			prev_idx[next] = prev;
-			concave_vertices.remove(&b);
-			--n_vertices;
-			skipped = 0;
+			uint32 a = P[i], b = P[(i + 1) % P.size()];
+			if (std::make_pair(std::min(a, b), std::max(a, b)) == edge.first)
+				break;
 		}
-		else if (++skipped > n_vertices)
+
+		if (i == P.size())
+			continue;
+
+		uint32 x = P[i], y = P[(i + 1) % P.size()];
+
+		for (; j < Q.size(); j++)
+		{
+			if (Q[j] == y && Q[(j + 1) % Q.size()] == x)
+				break;
+		}
+
+		if (j == Q.size())
+			continue;
+
+		// P from y around to x, then the rest of Q.
+		merged.clear();
+		for (size_t k = 0; k < P.size(); k++)
+			merged.push_back(P[(i + 1 + k) % P.size()]);
+		for (size_t k = 2; k < Q.size(); k++)
+			merged.push_back(Q[(j + k) % Q.size()]);
+
+		// Collinear vertices don't count against the limit, they're removed
+		// at the end.
+		bool convex = true;
+		int corners = 0;
+		for (size_t k = 0; k < merged.size() && convex; k++)
 		{
-			throw love::Exception("Cannot triangulate polygon.");
+			float t = turn(merged[(k + merged.size() - 1) % merged.size()], merged[k], merged[(k + 1) % merged.size()]);
+			convex = t >= 0.0f;
+			if (t > 0.0f)
+				corners++;
 		}
-		current = next;
+
+		if (!convex || corners > maxVertices)
+			continue;
+
+		// Holes touching the outline at a vertex can make the same vertex
+		// appear twice.
+		sorted = merged;
+		std::sort(sorted.begin(), sorted.end());
+		if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+			continue;
+
+		polys[p] = merged;
+		polys[q].clear();
+		parent[q] = p;
 	}
-	next = next_idx[current];
-	prev = prev_idx[current];
-	triangles.push_back(Triangle(polygon[prev], polygon[current], polygon[next]));
 
-	return triangles;
+	for (const std::vector<uint32> &poly : polys)
+	{
+		if (poly.empty())
+			continue;
+
+		std::vector<uint32> piece;
+		for (size_t k = 0; k < poly.size(); k++)
+		{
+			if (turn(poly[(k + poly.size() - 1) % poly.size()], poly[k], poly[(k + 1) % poly.size()]) > 0.0f)
+				piece.push_back(poly[k]);
+		}
+
+		if (piece.size() >= 3)
+			pieces.push_back(piece);
+	}
 }
 
 bool isConvex(const std::vector<love::Vector2> &polygon)
 {
-	if (polygon.size() < 3)
+	return isConvex(polygon.data(), polygon.size());
+}
+
+bool isConvex(const Vector2 *polygon, size_t count)
+{
+	if (count < 3)
 		return false;
 
 	// a polygon is convex if all corners turn in the same direction
 	// turning direction can be determined using the cross-product of
 	// the forward difference vectors
-	size_t i = polygon.size() - 2, j = polygon.size() - 1, k = 0;
+	size_t i = count - 2, j = count - 1, k = 0;
 	Vector2 p(polygon[j] - polygon[i]);
 	Vector2 q(polygon[k] - polygon[j]);
 	float winding = Vector2::cross(p, q);
 
-	while (k+1 < polygon.size())
+	while (k+1 < count)
 	{
 		i = j; j = k; k++;
 		p = polygon[j] - polygon[i];
@@ -236,5 +1078,24 @@ Transform *Math::newTransform(float x, float y, float a, float sx, float sy, flo
 	return new Transform(x, y, a, sx, sy, ox, oy, kx, ky);
 }
 
+SpatialIndex *Math::newSpatialIndex(float margin)
+{
+	return new SpatialIndex(margin);
+}
+
+Vec2Array *Math::newVec2Array(int count)
+{
+	if (count < 0)
+		throw love::Exception("Invalid Vec2Array size: %d", count);
+
+	StrongRef<love::data::ByteData> data(new love::data::ByteData(sizeof(float) * 2 * (size_t) count), Acquire::NORETAIN);
+	return new Vec2Array(data, count, sizeof(float) * 2, 0);
+}
+
+Vec2Array *Math::newVec2Array(Data *data, int count, size_t stride, size_t offset)
+{
+	return new Vec2Array(data, count, stride, offset);
+}
+
 } // math
 } // love
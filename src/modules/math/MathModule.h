@@ -25,6 +25,7 @@
 
 // LOVE
 #include "common/Module.h"
+#include "common/Data.h"
 #include "common/math.h"
 #include "common/Vector.h"
 #include "common/int.h"
@@ -43,6 +44,8 @@ namespace math
 
 class BezierCurve;
 class Transform;
+class SpatialIndex;
+class Vec2Array;
 
 struct Triangle
 {
@@ -60,6 +63,33 @@ struct Triangle
  **/
 std::vector<Triangle> triangulate(const std::vector<love::Vector2> &polygon);
 
+/**
+ * Triangulate a polygon with holes.
+ *
+ * @param points The outer contour, followed by the contour of each hole.
+ * @param holeStarts Index in points of the first vertex of each hole.
+ * @return List of triangles the polygon is composed of.
+ **/
+std::vector<Triangle> triangulate(const std::vector<love::Vector2> &points, const std::vector<size_t> &holeStarts);
+
+/**
+ * Triangulate a polygon with holes, without copying vertices.
+ *
+ * @param indices Receives three indices into points for each triangle.
+ **/
+void triangulate(const Vector2 *points, size_t count, const std::vector<size_t> &holeStarts, std::vector<uint32> &indices);
+
+/**
+ * Splits a polygon with holes into convex pieces, by merging the triangles
+ * of its triangulation as long as they stay convex (Hertel-Mehlhorn.) This
+ * gives at most four times the minimum number of pieces.
+ *
+ * @param maxVertices Pieces aren't merged beyond this many vertices.
+ * @param pieces Receives indices into points for each piece, with a positive
+ *        signed area.
+ **/
+void decomposeConvex(const Vector2 *points, size_t count, const std::vector<size_t> &holeStarts, int maxVertices, std::vector<std::vector<uint32>> &pieces);
+
 /**
  * Checks whether a polygon is convex.
  *
@@ -67,6 +97,7 @@ std::vector<Triangle> triangulate(const std::vector<love::Vector2> &polygon);
  * @return True if the polygon is convex, false otherwise.
  **/
 bool isConvex(const std::vector<love::Vector2> &polygon);
+bool isConvex(const Vector2 *polygon, size_t count);
 
 /**
  * Converts a value from the sRGB (gamma) colorspace to linear RGB.
@@ -117,6 +148,12 @@ public:
 	Transform *newTransform();
 	Transform *newTransform(float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
 
+	SpatialIndex *newSpatialIndex(float margin);
+
+	// A new array of count zeroed vectors, in a tightly packed ByteData.
+	Vec2Array *newVec2Array(int count);
+	Vec2Array *newVec2Array(Data *data, int count, size_t stride, size_t offset);
+
 	// Implements Module.
 	virtual ModuleType getModuleType() const
 	{
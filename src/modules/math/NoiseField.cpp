@@ -0,0 +1,250 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "NoiseField.h"
+#include "common/Exception.h"
+#include "common/halffloat.h"
+#include "common/int.h"
+#include "image/ImageData.h"
+#include "thread/WorkerPool.h"
+
+// Noise
+#include "libraries/noise1234/noise1234.h"
+#include "libraries/noise1234/simplexnoise1234.h"
+
+// C++
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace love
+{
+namespace math
+{
+
+namespace
+{
+
+// Rows handed to each worker task.
+const int ROWS_PER_TASK = 16;
+
+// Grids with fewer samples (times octaves) than this aren't worth splitting
+// across threads.
+const int MIN_PARALLEL_SAMPLES = 16384;
+
+typedef float (*NoiseKernel)(const float *p);
+
+float simplex1(const float *p) { return SimplexNoise1234::noise(p[0]); }
+float simplex2(const float *p) { return SimplexNoise1234::noise(p[0], p[1]); }
+float perlin1(const float *p) { return Noise1234::noise(p[0]); }
+float perlin2(const float *p) { return Noise1234::noise(p[0], p[1]); }
+float perlin3(const float *p) { return Noise1234::noise(p[0], p[1], p[2]); }
+float perlin4(const float *p) { return Noise1234::noise(p[0], p[1], p[2], p[3]); }
+
+NoiseKernel getKernel(const NoiseField::Settings &s)
+{
+	if (s.type == NoiseField::TYPE_SIMPLEX)
+		return s.dimensions == 1 ? simplex1 : simplex2;
+
+	switch (s.dimensions)
+	{
+	case 1:
+		return perlin1;
+	case 2:
+		return perlin2;
+	case 3:
+		return perlin3;
+	default:
+		return perlin4;
+	}
+}
+
+void fillRow(const NoiseField::Settings &s, NoiseKernel kernel, int y, int width, float *dst)
+{
+	float base[4] = {s.origin[0], s.origin[1], s.origin[2], s.origin[3]};
+
+	if (s.dimensions > 1)
+		base[1] += y * s.step[1];
+
+	for (int x = 0; x < width; x++)
+	{
+		float p[4] = {base[0] + x * s.step[0], base[1], base[2], base[3]};
+
+		float scaled[4];
+		float frequency = 1.0f;
+		float amplitude = 1.0f;
+		float total = 0.0f;
+		float sum = 0.0f;
+
+		for (int o = 0; o < s.octaves; o++)
+		{
+			for (int i = 0; i < 4; i++)
+				scaled[i] = p[i] * frequency;
+
+			sum += kernel(scaled) * amplitude;
+			total += amplitude;
+
+			frequency *= s.lacunarity;
+			amplitude *= s.persistence;
+		}
+
+		dst[x] = (sum / total) * 0.5f + 0.5f;
+	}
+}
+
+void forRows(const NoiseField::Settings &s, int width, int height, const std::function<void(int, int)> &fn)
+{
+	int tasks = (height + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+	bool parallel = tasks > 1 && (int64) width * height * s.octaves >= MIN_PARALLEL_SAMPLES;
+
+	auto task = [&](int i)
+	{
+		int start = i * ROWS_PER_TASK;
+		fn(start, std::min(start + ROWS_PER_TASK, height));
+	};
+
+	if (parallel)
+		love::thread::WorkerPool::getShared().parallelFor(tasks, task);
+	else
+	{
+		for (int i = 0; i < tasks; i++)
+			task(i);
+	}
+}
+
+template <typename T>
+void writeChannel(T *dst, const float *src, int width, int channel, float scale)
+{
+	for (int x = 0; x < width; x++)
+	{
+		float v = std::min(std::max(src[x], 0.0f), 1.0f);
+		dst[x * 4 + channel] = (T) (v * scale + 0.5f);
+	}
+}
+
+} // anonymous namespace
+
+void NoiseField::validate(const Settings &s)
+{
+	if (s.dimensions < 1 || s.dimensions > 4)
+		throw love::Exception("Noise dimensions must be between 1 and 4.");
+
+	if (s.type == TYPE_SIMPLEX && s.dimensions > 2)
+		throw love::Exception("Simplex noise is only available in 1 and 2 dimensions.");
+
+	if (s.octaves < 1)
+		throw love::Exception("Noise octave count must be at least 1.");
+}
+
+void NoiseField::generate(const Settings &settings, int width, int height, float *dst, int stride)
+{
+	validate(settings);
+
+	if (width <= 0 || height <= 0)
+		return;
+
+	NoiseKernel kernel = getKernel(settings);
+
+	forRows(settings, width, height, [&](int y0, int y1)
+	{
+		for (int y = y0; y < y1; y++)
+			fillRow(settings, kernel, y, width, dst + (size_t) y * stride);
+	});
+}
+
+void NoiseField::generate(const Settings &settings, love::image::ImageData *data, int channel)
+{
+	using namespace love::image;
+
+	validate(settings);
+
+	if (channel < 0 || channel > 3)
+		throw love::Exception("Invalid color channel: %d", channel + 1);
+
+	NoiseKernel kernel = getKernel(settings);
+
+	int width = data->getWidth();
+	int height = data->getHeight();
+	PixelFormat format = data->getFormat();
+	size_t pixelsize = getPixelFormatSize(format);
+
+	love::thread::Lock lock(data->getMutex());
+
+	uint8 *pixels = (uint8 *) data->getData();
+
+	forRows(settings, width, height, [&](int y0, int y1)
+	{
+		std::vector<float> row(width);
+
+		for (int y = y0; y < y1; y++)
+		{
+			fillRow(settings, kernel, y, width, row.data());
+
+			uint8 *dst = pixels + (size_t) y * width * pixelsize;
+
+			switch (format)
+			{
+			case PIXELFORMAT_RGBA8:
+				writeChannel((uint8 *) dst, row.data(), width, channel, 255.0f);
+				break;
+			case PIXELFORMAT_RGBA16:
+				writeChannel((uint16 *) dst, row.data(), width, channel, 65535.0f);
+				break;
+			case PIXELFORMAT_RGBA16F:
+				for (int x = 0; x < width; x++)
+					((half *) dst)[x * 4 + channel] = floatToHalf(row[x]);
+				break;
+			case PIXELFORMAT_RGBA32F:
+				for (int x = 0; x < width; x++)
+					((float *) dst)[x * 4 + channel] = row[x];
+				break;
+			default:
+				break;
+			}
+		}
+	});
+}
+
+bool NoiseField::getConstant(const char *in, Type &out)
+{
+	return types.find(in, out);
+}
+
+bool NoiseField::getConstant(Type in, const char *&out)
+{
+	return types.find(in, out);
+}
+
+std::vector<std::string> NoiseField::getConstants(Type)
+{
+	return types.getNames();
+}
+
+StringMap<NoiseField::Type, NoiseField::TYPE_MAX_ENUM>::Entry NoiseField::typeEntries[] =
+{
+	{ "simplex", TYPE_SIMPLEX },
+	{ "perlin",  TYPE_PERLIN  },
+};
+
+StringMap<NoiseField::Type, NoiseField::TYPE_MAX_ENUM> NoiseField::types(NoiseField::typeEntries, sizeof(NoiseField::typeEntries));
+
+} // math
+} // love
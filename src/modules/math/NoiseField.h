@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_MATH_NOISE_FIELD_H
+#define LOVE_MATH_NOISE_FIELD_H
+
+// LOVE
+#include "common/StringMap.h"
+
+namespace love
+{
+namespace image
+{
+class ImageData;
+}
+
+namespace math
+{
+
+/**
+ * Fills grids of samples with fractal (fBm) noise in one call, instead of one
+ * love.math.noise call per sample. Rows are split across the shared worker
+ * pool when the grid is big enough to be worth it.
+ **/
+class NoiseField
+{
+public:
+
+	enum Type
+	{
+		TYPE_SIMPLEX,
+		TYPE_PERLIN,
+		TYPE_MAX_ENUM
+	};
+
+	struct Settings
+	{
+		Type type = TYPE_SIMPLEX;
+
+		// Number of noise dimensions, in [1, 4]. Samples vary along the first
+		// two (just the first for 1D noise); the remaining coordinates stay
+		// at their origin value.
+		int dimensions = 2;
+
+		// Noise-space coordinate of the first sample.
+		float origin[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+
+		// Noise-space distance between neighbouring samples in x and y.
+		float step[2] = {1.0f, 1.0f};
+
+		int octaves = 1;
+		float lacunarity = 2.0f;
+		float persistence = 0.5f;
+	};
+
+	/**
+	 * Writes width * height noise values in [0, 1] to dst, with rows of
+	 * stride floats. A single octave matches love.math.noise for the same
+	 * coordinates.
+	 **/
+	static void generate(const Settings &settings, int width, int height, float *dst, int stride);
+
+	/**
+	 * Writes noise into one color channel (0-3) of every pixel in the
+	 * ImageData, converted to its pixel format.
+	 **/
+	static void generate(const Settings &settings, love::image::ImageData *data, int channel);
+
+	/**
+	 * Throws if the settings can't be used to generate noise.
+	 **/
+	static void validate(const Settings &settings);
+
+	static bool getConstant(const char *in, Type &out);
+	static bool getConstant(Type in, const char *&out);
+	static std::vector<std::string> getConstants(Type);
+
+private:
+
+	static StringMap<Type, TYPE_MAX_ENUM>::Entry typeEntries[];
+	static StringMap<Type, TYPE_MAX_ENUM> types;
+
+}; // NoiseField
+
+} // math
+} // love
+
+#endif // LOVE_MATH_NOISE_FIELD_H
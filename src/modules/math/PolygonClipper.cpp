@@ -0,0 +1,577 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "PolygonClipper.h"
+#include "common/Exception.h"
+#include "common/int.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+namespace love
+{
+namespace math
+{
+
+namespace
+{
+
+struct IPoint
+{
+	int64 x, y;
+
+	bool operator == (const IPoint &o) const { return x == o.x && y == o.y; }
+	bool operator != (const IPoint &o) const { return !(*this == o); }
+	bool operator < (const IPoint &o) const { return x < o.x || (x == o.x && y < o.y); }
+};
+
+inline int64 cross(int64 ax, int64 ay, int64 bx, int64 by)
+{
+	return ax * by - ay * bx;
+}
+
+struct InputEdge
+{
+	IPoint a, b;
+	int set;
+	std::vector<IPoint> splits;
+};
+
+// A piece of the overlay, going from lo to hi. delta is the number of input
+// edges of each set along it in that direction, minus those going the other
+// way. The winding number on its left is delta higher than on its right.
+struct Segment
+{
+	IPoint lo, hi;
+	int delta[2];
+};
+
+struct OutputEdge
+{
+	IPoint from, to;
+	bool used;
+};
+
+void addContours(const std::vector<PolygonClipper::Contour> &contours, int set, std::vector<InputEdge> &edges)
+{
+	const float maxcoord = PolygonClipper::MAX_COORDINATE;
+	std::vector<IPoint> points;
+
+	for (const PolygonClipper::Contour &contour : contours)
+	{
+		points.clear();
+
+		for (const Vector2 &v : contour)
+		{
+			if (!(std::abs(v.x) <= maxcoord) || !(std::abs(v.y) <= maxcoord))
+				throw love::Exception("Polygon coordinates must be between -%g and %g.", maxcoord, maxcoord);
+
+			IPoint p = {(int64) std::llround((double) v.x * PolygonClipper::PRECISION), (int64) std::llround((double) v.y * PolygonClipper::PRECISION)};
+
+			if (points.empty() || points.back() != p)
+				points.push_back(p);
+		}
+
+		while (points.size() > 1 && points.front() == points.back())
+			points.pop_back();
+
+		if (points.size() < 3)
+			continue;
+
+		for (size_t i = 0; i < points.size(); i++)
+		{
+			InputEdge e;
+			e.a = points[i];
+			e.b = points[(i + 1) % points.size()];
+			e.set = set;
+			edges.push_back(e);
+		}
+	}
+}
+
+// Adds points to both edges where they intersect or overlap.
+void intersectEdges(InputEdge &p, InputEdge &q)
+{
+	if (std::max(p.a.x, p.b.x) < std::min(q.a.x, q.b.x) || std::max(q.a.x, q.b.x) < std::min(p.a.x, p.b.x)
+		|| std::max(p.a.y, p.b.y) < std::min(q.a.y, q.b.y) || std::max(q.a.y, q.b.y) < std::min(p.a.y, p.b.y))
+		return;
+
+	int64 rx = p.b.x - p.a.x, ry = p.b.y - p.a.y;
+	int64 sx = q.b.x - q.a.x, sy = q.b.y - q.a.y;
+	int64 qpx = q.a.x - p.a.x, qpy = q.a.y - p.a.y;
+
+	int64 d = cross(rx, ry, sx, sy);
+
+	if (d == 0)
+	{
+		if (cross(qpx, qpy, rx, ry) != 0)
+			return;
+
+		// Collinear: each edge is split at the other's endpoints.
+		auto within = [](const IPoint &a, const IPoint &b, const IPoint &pt)
+		{
+			int64 t = (pt.x - a.x) * (b.x - a.x) + (pt.y - a.y) * (b.y - a.y);
+			int64 len = (b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y);
+			return t > 0 && t < len;
+		};
+
+		if (within(p.a, p.b, q.a)) p.splits.push_back(q.a);
+		if (within(p.a, p.b, q.b)) p.splits.push_back(q.b);
+		if (within(q.a, q.b, p.a)) q.splits.push_back(p.a);
+		if (within(q.a, q.b, p.b)) q.splits.push_back(p.b);
+		return;
+	}
+
+	int64 tn = cross(qpx, qpy, sx, sy);
+	int64 un = cross(qpx, qpy, rx, ry);
+
+	if (d < 0)
+	{
+		d = -d;
+		tn = -tn;
+		un = -un;
+	}
+
+	if (tn < 0 || tn > d || un < 0 || un > d)
+		return;
+
+	IPoint pt;
+	if (tn == 0)
+		pt = p.a;
+	else if (tn == d)
+		pt = p.b;
+	else if (un == 0)
+		pt = q.a;
+	else if (un == d)
+		pt = q.b;
+	else
+	{
+		long double t = (long double) tn / (long double) d;
+		pt.x = p.a.x + (int64) std::llround((double) (rx * t));
+		pt.y = p.a.y + (int64) std::llround((double) (ry * t));
+	}
+
+	p.splits.push_back(pt);
+	q.splits.push_back(pt);
+}
+
+void buildSegments(std::vector<InputEdge> &edges, std::vector<Segment> &segments)
+{
+	for (size_t i = 0; i < edges.size(); i++)
+	{
+		for (size_t j = i + 1; j < edges.size(); j++)
+			intersectEdges(edges[i], edges[j]);
+	}
+
+	std::map<std::pair<IPoint, IPoint>, std::pair<int, int>> pieces;
+	std::vector<IPoint> points;
+
+	for (InputEdge &e : edges)
+	{
+		points.clear();
+		points.push_back(e.a);
+		points.insert(points.end(), e.splits.begin(), e.splits.end());
+		points.push_back(e.b);
+
+		int64 dx = e.b.x - e.a.x;
+		int64 dy = e.b.y - e.a.y;
+		IPoint a = e.a;
+
+		std::sort(points.begin(), points.end(), [&](const IPoint &p, const IPoint &q)
+		{
+			return (p.x - a.x) * dx + (p.y - a.y) * dy < (q.x - a.x) * dx + (q.y - a.y) * dy;
+		});
+
+		points.erase(std::unique(points.begin(), points.end()), points.end());
+
+		for (size_t i = 0; i + 1 < points.size(); i++)
+		{
+			const IPoint &from = points[i];
+			const IPoint &to = points[i + 1];
+
+			bool forward = from < to;
+			auto &piece = pieces[forward ? std::make_pair(from, to) : std::make_pair(to, from)];
+			int &delta = e.set == 0 ? piece.first : piece.second;
+			delta += forward ? 1 : -1;
+		}
+	}
+
+	for (const auto &piece : pieces)
+	{
+		// Pieces which cancel out don't separate anything.
+		if (piece.second.first == 0 && piece.second.second == 0)
+			continue;
+
+		Segment s;
+		s.lo = piece.first.first;
+		s.hi = piece.first.second;
+		s.delta[0] = piece.second.first;
+		s.delta[1] = piece.second.second;
+		segments.push_back(s);
+	}
+}
+
+/**
+ * Winding numbers of both sets just left of the middle of a segment. A ray is
+ * cast from the middle along the segment's left normal, and the crossings of
+ * the other segments are counted with exact integer tests. Coordinates are
+ * doubled so the middle is on the grid.
+ **/
+void getLeftWinding(const std::vector<Segment> &segments, size_t self, int winding[2])
+{
+	const Segment &s = segments[self];
+
+	int64 mx = s.lo.x + s.hi.x;
+	int64 my = s.lo.y + s.hi.y;
+	int64 nx = -(s.hi.y - s.lo.y);
+	int64 ny = s.hi.x - s.lo.x;
+
+	winding[0] = winding[1] = 0;
+
+	for (size_t i = 0; i < segments.size(); i++)
+	{
+		if (i == self)
+			continue;
+
+		const Segment &o = segments[i];
+
+		int64 ax = 2 * o.lo.x - mx, ay = 2 * o.lo.y - my;
+		int64 bx = 2 * o.hi.x - mx, by = 2 * o.hi.y - my;
+
+		// Half-open test, so a ray through a vertex counts it once.
+		if ((cross(nx, ny, ax, ay) > 0) == (cross(nx, ny, bx, by) > 0))
+			continue;
+
+		int64 ex = o.hi.x - o.lo.x, ey = o.hi.y - o.lo.y;
+		int64 num = cross(ax, ay, ex, ey);
+		int64 den = cross(nx, ny, ex, ey);
+
+		// Behind the start of the ray, or through its start.
+		if (num == 0 || den == 0 || (num > 0) != (den > 0))
+			continue;
+
+		// Going outwards from the right of o to its left adds its delta, and
+		// the winding number is 0 at the far end of the ray.
+		int sign = den < 0 ? 1 : -1;
+		winding[0] -= sign * o.delta[0];
+		winding[1] -= sign * o.delta[1];
+	}
+}
+
+bool isFilled(PolygonClipper::FillRule fill, int winding)
+{
+	if (fill == PolygonClipper::FILL_NONZERO)
+		return winding != 0;
+	else
+		return (winding % 2) != 0;
+}
+
+bool isInResult(PolygonClipper::Operation op, bool subject, bool clip)
+{
+	switch (op)
+	{
+	case PolygonClipper::OPERATION_UNION:
+		return subject || clip;
+	case PolygonClipper::OPERATION_INTERSECTION:
+		return subject && clip;
+	case PolygonClipper::OPERATION_DIFFERENCE:
+		return subject && !clip;
+	case PolygonClipper::OPERATION_XOR:
+	default:
+		return subject != clip;
+	}
+}
+
+/**
+ * Links the result's edges into closed contours. Where several edges leave
+ * the same point, the sharpest left turn is taken, so polygons which only
+ * touch at a point stay separate.
+ **/
+void traceContours(std::vector<OutputEdge> &edges, std::vector<std::vector<IPoint>> &contours)
+{
+	std::map<IPoint, std::vector<size_t>> outgoing;
+	for (size_t i = 0; i < edges.size(); i++)
+		outgoing[edges[i].from].push_back(i);
+
+	for (size_t start = 0; start < edges.size(); start++)
+	{
+		if (edges[start].used)
+			continue;
+
+		std::vector<IPoint> contour;
+		size_t current = start;
+		edges[start].used = true;
+		bool closed = false;
+
+		while (true)
+		{
+			const OutputEdge &e = edges[current];
+			contour.push_back(e.from);
+
+			double inx = (double) (e.to.x - e.from.x);
+			double iny = (double) (e.to.y - e.from.y);
+
+			size_t best = edges.size();
+			double bestangle = -10.0;
+
+			for (size_t candidate : outgoing[e.to])
+			{
+				if (edges[candidate].used && candidate != start)
+					continue;
+
+				const OutputEdge &c = edges[candidate];
+				double outx = (double) (c.to.x - c.from.x);
+				double outy = (double) (c.to.y - c.from.y);
+				double angle = std::atan2(inx * outy - iny * outx, inx * outx + iny * outy);
+
+				if (angle > bestangle)
+				{
+					bestangle = angle;
+					best = candidate;
+				}
+			}
+
+			if (best == edges.size())
+				break;
+
+			if (best == start)
+			{
+				closed = true;
+				break;
+			}
+
+			edges[best].used = true;
+			current = best;
+		}
+
+		if (closed)
+			contours.push_back(contour);
+	}
+}
+
+void removeCollinear(std::vector<IPoint> &contour)
+{
+	bool changed = true;
+
+	while (changed && contour.size() >= 3)
+	{
+		changed = false;
+
+		for (size_t i = 0; i < contour.size() && contour.size() >= 3; )
+		{
+			const IPoint &prev = contour[(i + contour.size() - 1) % contour.size()];
+			const IPoint &cur = contour[i];
+			const IPoint &next = contour[(i + 1) % contour.size()];
+
+			if (cross(cur.x - prev.x, cur.y - prev.y, next.x - cur.x, next.y - cur.y) == 0)
+			{
+				contour.erase(contour.begin() + i);
+				changed = true;
+			}
+			else
+				i++;
+		}
+	}
+}
+
+double getSignedArea(const std::vector<IPoint> &contour)
+{
+	double area = 0.0;
+	for (size_t i = 0; i < contour.size(); i++)
+	{
+		const IPoint &a = contour[i];
+		const IPoint &b = contour[(i + 1) % contour.size()];
+		area += (double) cross(a.x, a.y, b.x, b.y);
+	}
+	return area * 0.5;
+}
+
+// Whether the point (in doubled coordinates) is inside the contour.
+bool containsDoubled(const std::vector<IPoint> &contour, int64 px, int64 py)
+{
+	bool inside = false;
+
+	for (size_t i = 0, j = contour.size() - 1; i < contour.size(); j = i++)
+	{
+		int64 ax = 2 * contour[j].x, ay = 2 * contour[j].y;
+		int64 bx = 2 * contour[i].x, by = 2 * contour[i].y;
+
+		if ((ay > py) == (by > py))
+			continue;
+
+		// Whether the edge crosses the horizontal ray to the right of p.
+		int64 side = cross(bx - ax, by - ay, px - ax, py - ay);
+		if ((side > 0) == (by > ay))
+			inside = !inside;
+	}
+
+	return inside;
+}
+
+PolygonClipper::Contour toContour(const std::vector<IPoint> &points)
+{
+	PolygonClipper::Contour contour;
+	contour.reserve(points.size());
+
+	for (const IPoint &p : points)
+		contour.emplace_back((float) ((double) p.x / PolygonClipper::PRECISION), (float) ((double) p.y / PolygonClipper::PRECISION));
+
+	return contour;
+}
+
+} // anonymous namespace
+
+// Keeps differences of doubled coordinates, and their products, in an int64.
+const float PolygonClipper::MAX_COORDINATE = (float) (1 << 29) / PolygonClipper::PRECISION;
+
+void PolygonClipper::clip(Operation op, const std::vector<Contour> &subject, const std::vector<Contour> &clip, FillRule fill, std::vector<Polygon> &result)
+{
+	std::vector<InputEdge> edges;
+	addContours(subject, 0, edges);
+	addContours(clip, 1, edges);
+
+	std::vector<Segment> segments;
+	buildSegments(edges, segments);
+
+	std::vector<OutputEdge> outedges;
+
+	for (size_t i = 0; i < segments.size(); i++)
+	{
+		const Segment &s = segments[i];
+
+		int left[2];
+		getLeftWinding(segments, i, left);
+		int right[2] = {left[0] - s.delta[0], left[1] - s.delta[1]};
+
+		bool inleft = isInResult(op, isFilled(fill, left[0]), isFilled(fill, left[1]));
+		bool inright = isInResult(op, isFilled(fill, right[0]), isFilled(fill, right[1]));
+
+		// The result's inside is kept on the left of its edges.
+		if (inleft && !inright)
+			outedges.push_back({s.lo, s.hi, false});
+		else if (inright && !inleft)
+			outedges.push_back({s.hi, s.lo, false});
+	}
+
+	std::vector<std::vector<IPoint>> contours;
+	traceContours(outedges, contours);
+
+	std::vector<std::vector<IPoint>> outers;
+	std::vector<std::vector<IPoint>> holes;
+	std::vector<double> outerareas;
+
+	for (std::vector<IPoint> &contour : contours)
+	{
+		removeCollinear(contour);
+		if (contour.size() < 3)
+			continue;
+
+		double area = getSignedArea(contour);
+
+		if (area > 0.0)
+		{
+			outers.push_back(contour);
+			outerareas.push_back(area);
+		}
+		else if (area < 0.0)
+			holes.push_back(contour);
+	}
+
+	size_t first = result.size();
+	for (const std::vector<IPoint> &outer : outers)
+	{
+		Polygon p;
+		p.outer = toContour(outer);
+		result.push_back(p);
+	}
+
+	// Each hole belongs to the smallest outer contour around it. The middle
+	// of an edge is never on another contour's boundary, since the result's
+	// edges don't overlap.
+	for (const std::vector<IPoint> &hole : holes)
+	{
+		int64 px = hole[0].x + hole[1].x;
+		int64 py = hole[0].y + hole[1].y;
+
+		size_t owner = outers.size();
+		for (size_t i = 0; i < outers.size(); i++)
+		{
+			if ((owner == outers.size() || outerareas[i] < outerareas[owner]) && containsDoubled(outers[i], px, py))
+				owner = i;
+		}
+
+		if (owner < outers.size())
+			result[first + owner].holes.push_back(toContour(hole));
+	}
+}
+
+bool PolygonClipper::getConstant(const char *in, Operation &out)
+{
+	return operations.find(in, out);
+}
+
+bool PolygonClipper::getConstant(Operation in, const char *&out)
+{
+	return operations.find(in, out);
+}
+
+std::vector<std::string> PolygonClipper::getConstants(Operation)
+{
+	return operations.getNames();
+}
+
+bool PolygonClipper::getConstant(const char *in, FillRule &out)
+{
+	return fillRules.find(in, out);
+}
+
+bool PolygonClipper::getConstant(FillRule in, const char *&out)
+{
+	return fillRules.find(in, out);
+}
+
+std::vector<std::string> PolygonClipper::getConstants(FillRule)
+{
+	return fillRules.getNames();
+}
+
+StringMap<PolygonClipper::Operation, PolygonClipper::OPERATION_MAX_ENUM>::Entry PolygonClipper::operationEntries[] =
+{
+	{ "union",        OPERATION_UNION        },
+	{ "intersection", OPERATION_INTERSECTION },
+	{ "difference",   OPERATION_DIFFERENCE   },
+	{ "xor",          OPERATION_XOR          },
+};
+
+StringMap<PolygonClipper::Operation, PolygonClipper::OPERATION_MAX_ENUM> PolygonClipper::operations(PolygonClipper::operationEntries, sizeof(PolygonClipper::operationEntries));
+
+StringMap<PolygonClipper::FillRule, PolygonClipper::FILL_MAX_ENUM>::Entry PolygonClipper::fillRuleEntries[] =
+{
+	{ "evenodd", FILL_EVENODD },
+	{ "nonzero", FILL_NONZERO },
+};
+
+StringMap<PolygonClipper::FillRule, PolygonClipper::FILL_MAX_ENUM> PolygonClipper::fillRules(PolygonClipper::fillRuleEntries, sizeof(PolygonClipper::fillRuleEntries));
+
+} // math
+} // love
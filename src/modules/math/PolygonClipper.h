@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Vector.h"
+#include "common/StringMap.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace math
+{
+
+/**
+ * Boolean operations on polygons with holes. Coordinates are snapped to a
+ * grid of 1/PRECISION units, and everything after that uses exact integer
+ * arithmetic, so coincident and touching edges are handled consistently.
+ *
+ * Runs in O(n^2) time for n edges in total, which is fine for game terrain
+ * and the like but not for huge GIS-style inputs.
+ **/
+class PolygonClipper
+{
+public:
+
+	enum Operation
+	{
+		OPERATION_UNION,
+		OPERATION_INTERSECTION,
+		OPERATION_DIFFERENCE,
+		OPERATION_XOR,
+		OPERATION_MAX_ENUM
+	};
+
+	// How overlapping and nested contours of the same input are filled.
+	enum FillRule
+	{
+		FILL_EVENODD,
+		FILL_NONZERO,
+		FILL_MAX_ENUM
+	};
+
+	typedef std::vector<Vector2> Contour;
+
+	/**
+	 * One piece of the result. The outer contour has a positive signed area
+	 * (counterclockwise with y pointing up), and its holes a negative one.
+	 **/
+	struct Polygon
+	{
+		Contour outer;
+		std::vector<Contour> holes;
+	};
+
+	// Grid cells per unit.
+	static const int PRECISION = 1024;
+
+	// Largest absolute coordinate which can be used.
+	static const float MAX_COORDINATE;
+
+	/**
+	 * Computes subject <operation> clip. Each input is any number of
+	 * contours with either orientation. Collinear vertices are removed from
+	 * the result.
+	 **/
+	static void clip(Operation op, const std::vector<Contour> &subject, const std::vector<Contour> &clip, FillRule fill, std::vector<Polygon> &result);
+
+	static bool getConstant(const char *in, Operation &out);
+	static bool getConstant(Operation in, const char *&out);
+	static std::vector<std::string> getConstants(Operation);
+
+	static bool getConstant(const char *in, FillRule &out);
+	static bool getConstant(FillRule in, const char *&out);
+	static std::vector<std::string> getConstants(FillRule);
+
+private:
+
+	static StringMap<Operation, OPERATION_MAX_ENUM>::Entry operationEntries[];
+	static StringMap<Operation, OPERATION_MAX_ENUM> operations;
+
+	static StringMap<FillRule, FILL_MAX_ENUM>::Entry fillRuleEntries[];
+	static StringMap<FillRule, FILL_MAX_ENUM> fillRules;
+
+}; // PolygonClipper
+
+} // math
+} // love
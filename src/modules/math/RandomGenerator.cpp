@@ -90,6 +90,26 @@ double RandomGenerator::randomNormal(double stddev)
 	return r * sin(phi) * stddev;
 }
 
+void RandomGenerator::randomFill(float *dst, size_t count, double min, double max)
+{
+	for (size_t i = 0; i < count; i++)
+		dst[i] = (float) random(min, max);
+}
+
+void RandomGenerator::randomFill(int32 *dst, size_t count, int32 min, int32 max)
+{
+	double range = (double) max - (double) min + 1.0;
+
+	for (size_t i = 0; i < count; i++)
+		dst[i] = (int32) (floor(random() * range) + min);
+}
+
+void RandomGenerator::randomNormalFill(float *dst, size_t count, double stddev, double mean)
+{
+	for (size_t i = 0; i < count; i++)
+		dst[i] = (float) (randomNormal(stddev) + mean);
+}
+
 void RandomGenerator::setSeed(RandomGenerator::Seed newseed)
 {
 	seed = newseed;
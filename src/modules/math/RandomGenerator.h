@@ -112,6 +112,25 @@ public:
 	 **/
 	double randomNormal(double stddev);
 
+	/**
+	 * Fills an array with uniformly distributed numbers in [min, max). Uses
+	 * the same sequence as calling random(min, max) count times.
+	 **/
+	void randomFill(float *dst, size_t count, double min, double max);
+
+	/**
+	 * Fills an array with uniformly distributed integers in [min, max]. Uses
+	 * the same sequence, and gives the same values, as calling
+	 * RandomGenerator:random(min, max) from Lua count times.
+	 **/
+	void randomFill(int32 *dst, size_t count, int32 min, int32 max);
+
+	/**
+	 * Fills an array with normally distributed numbers. Uses the same
+	 * sequence as calling randomNormal(stddev) count times.
+	 **/
+	void randomNormalFill(float *dst, size_t count, double stddev, double mean);
+
 	/**
 	 * Set pseudo-random seed.
 	 * It's up to the implementation how to use this.
@@ -0,0 +1,309 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "SpatialIndex.h"
+#include "common/Exception.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+
+namespace love
+{
+namespace math
+{
+
+love::Type SpatialIndex::type("SpatialIndex", &Object::type);
+
+static bool overlaps(const SpatialIndex::Box &a, const SpatialIndex::Box &b)
+{
+	return a.x <= b.x + b.w && b.x <= a.x + a.w && a.y <= b.y + b.h && b.y <= a.y + a.h;
+}
+
+// Returns the fraction along the segment where it enters the box, or a
+// negative value if it misses.
+static float intersectRay(const SpatialIndex::Box &b, float x1, float y1, float dx, float dy)
+{
+	float tmin = 0.0f;
+	float tmax = 1.0f;
+
+	const float origin[2] = {x1, y1};
+	const float dir[2] = {dx, dy};
+	const float lower[2] = {b.x, b.y};
+	const float upper[2] = {b.x + b.w, b.y + b.h};
+
+	for (int i = 0; i < 2; i++)
+	{
+		if (dir[i] == 0.0f)
+		{
+			if (origin[i] < lower[i] || origin[i] > upper[i])
+				return -1.0f;
+			continue;
+		}
+
+		float t1 = (lower[i] - origin[i]) / dir[i];
+		float t2 = (upper[i] - origin[i]) / dir[i];
+
+		if (t1 > t2)
+			std::swap(t1, t2);
+
+		tmin = std::max(tmin, t1);
+		tmax = std::min(tmax, t2);
+
+		if (tmin > tmax)
+			return -1.0f;
+	}
+
+	return tmin;
+}
+
+struct SpatialIndex::BoxQuery
+{
+	const SpatialIndex *index;
+	Box box;
+	std::vector<int> *ids;
+
+	bool QueryCallback(int32 proxy)
+	{
+		if (overlaps(index->entries[proxy].box, box))
+			ids->push_back(proxy + 1);
+		return true;
+	}
+};
+
+struct SpatialIndex::RayQuery
+{
+	const SpatialIndex *index;
+	float x1, y1, dx, dy;
+	std::vector<std::pair<float, int>> hits;
+
+	float RayCastCallback(const b2RayCastInput &, int32 proxy)
+	{
+		float fraction = intersectRay(index->entries[proxy].box, x1, y1, dx, dy);
+		if (fraction >= 0.0f)
+			hits.emplace_back(fraction, proxy + 1);
+
+		// Negative values let the ray continue without being shortened.
+		return -1.0f;
+	}
+};
+
+SpatialIndex::SpatialIndex(float margin)
+	: count(0)
+	, margin(margin)
+	, scale(b2_aabbExtension / margin)
+{
+	if (!(margin > 0.0f) || !std::isfinite(margin))
+		throw love::Exception("SpatialIndex margin must be greater than 0.");
+}
+
+SpatialIndex::~SpatialIndex()
+{
+}
+
+b2AABB SpatialIndex::toTree(const Box &box) const
+{
+	if (!(box.w >= 0.0f) || !(box.h >= 0.0f))
+		throw love::Exception("Box width and height must not be negative.");
+
+	b2AABB aabb;
+	aabb.lowerBound.Set(box.x * scale, box.y * scale);
+	aabb.upperBound.Set((box.x + box.w) * scale, (box.y + box.h) * scale);
+	return aabb;
+}
+
+int32 SpatialIndex::checkProxy(int id) const
+{
+	if (!contains(id))
+		throw love::Exception("Invalid SpatialIndex id: %d", id);
+
+	return id - 1;
+}
+
+int SpatialIndex::insert(const Box &box)
+{
+	int32 proxy = tree.CreateProxy(toTree(box), nullptr);
+
+	if ((size_t) proxy >= entries.size())
+		entries.resize(proxy + 1, Entry());
+
+	entries[proxy].box = box;
+	entries[proxy].used = true;
+	count++;
+
+	return proxy + 1;
+}
+
+void SpatialIndex::update(int id, const Box &box)
+{
+	int32 proxy = checkProxy(id);
+
+	// Box2D uses the displacement to predict movement, which doesn't apply.
+	tree.MoveProxy(proxy, toTree(box), b2Vec2(0.0f, 0.0f));
+	entries[proxy].box = box;
+}
+
+void SpatialIndex::remove(int id)
+{
+	int32 proxy = checkProxy(id);
+
+	tree.DestroyProxy(proxy);
+	entries[proxy].used = false;
+	count--;
+}
+
+void SpatialIndex::clear()
+{
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		if (entries[i].used)
+			tree.DestroyProxy((int32) i);
+	}
+
+	entries.clear();
+	count = 0;
+}
+
+bool SpatialIndex::contains(int id) const
+{
+	return id >= 1 && (size_t) id <= entries.size() && entries[id - 1].used;
+}
+
+const SpatialIndex::Box &SpatialIndex::getBox(int id) const
+{
+	return entries[checkProxy(id)].box;
+}
+
+int SpatialIndex::getCount() const
+{
+	return count;
+}
+
+float SpatialIndex::getMargin() const
+{
+	return margin;
+}
+
+void SpatialIndex::queryBox(const Box &box, std::vector<int> &ids) const
+{
+	BoxQuery query = {this, box, &ids};
+	tree.Query(&query, toTree(box));
+}
+
+void SpatialIndex::queryPoint(float x, float y, std::vector<int> &ids) const
+{
+	Box box = {x, y, 0.0f, 0.0f};
+	queryBox(box, ids);
+}
+
+void SpatialIndex::rayCast(float x1, float y1, float x2, float y2, std::vector<int> &ids) const
+{
+	// Box2D can't cast rays without a direction.
+	if (x1 == x2 && y1 == y2)
+		return queryPoint(x1, y1, ids);
+
+	RayQuery query;
+	query.index = this;
+	query.x1 = x1;
+	query.y1 = y1;
+	query.dx = x2 - x1;
+	query.dy = y2 - y1;
+
+	b2RayCastInput input;
+	input.p1.Set(x1 * scale, y1 * scale);
+	input.p2.Set(x2 * scale, y2 * scale);
+	input.maxFraction = 1.0f;
+
+	tree.RayCast(&query, input);
+
+	std::stable_sort(query.hits.begin(), query.hits.end(), [](const std::pair<float, int> &a, const std::pair<float, int> &b)
+	{
+		return a.first < b.first;
+	});
+
+	for (const auto &hit : query.hits)
+		ids.push_back(hit.second);
+}
+
+int SpatialIndex::getQueryComponents(QueryType type)
+{
+	switch (type)
+	{
+	case QUERY_POINT:
+		return 2;
+	case QUERY_BOX:
+	case QUERY_RAY:
+	default:
+		return 4;
+	}
+}
+
+void SpatialIndex::queryBatch(QueryType type, const float *queries, int querycount, std::vector<BatchResult> &results) const
+{
+	int components = getQueryComponents(type);
+	std::vector<int> ids;
+
+	for (int i = 0; i < querycount; i++)
+	{
+		const float *q = queries + i * components;
+		ids.clear();
+
+		if (type == QUERY_BOX)
+		{
+			Box box = {q[0], q[1], q[2], q[3]};
+			queryBox(box, ids);
+		}
+		else if (type == QUERY_POINT)
+			queryPoint(q[0], q[1], ids);
+		else
+			rayCast(q[0], q[1], q[2], q[3], ids);
+
+		for (int id : ids)
+			results.push_back({i, id});
+	}
+}
+
+bool SpatialIndex::getConstant(const char *in, QueryType &out)
+{
+	return queryTypes.find(in, out);
+}
+
+bool SpatialIndex::getConstant(QueryType in, const char *&out)
+{
+	return queryTypes.find(in, out);
+}
+
+std::vector<std::string> SpatialIndex::getConstants(QueryType)
+{
+	return queryTypes.getNames();
+}
+
+StringMap<SpatialIndex::QueryType, SpatialIndex::QUERY_MAX_ENUM>::Entry SpatialIndex::queryTypeEntries[] =
+{
+	{ "box",   QUERY_BOX   },
+	{ "point", QUERY_POINT },
+	{ "ray",   QUERY_RAY   },
+};
+
+StringMap<SpatialIndex::QueryType, SpatialIndex::QUERY_MAX_ENUM> SpatialIndex::queryTypes(SpatialIndex::queryTypeEntries, sizeof(SpatialIndex::queryTypeEntries));
+
+} // math
+} // love
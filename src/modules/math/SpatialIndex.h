@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/StringMap.h"
+
+// Box2D
+#include <Box2D/Collision/b2DynamicTree.h>
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace math
+{
+
+/**
+ * A dynamic bounding volume tree of axis-aligned boxes, for culling, hit
+ * testing and neighbor queries of things which don't need love.physics. It
+ * uses the same tree as the Box2D broad-phase.
+ *
+ * Boxes are referred to by positive integer ids, which are reused after their
+ * box is removed. Query results only contain boxes which actually
+ * overlap the query, not just the enlarged boxes stored in the tree.
+ **/
+class SpatialIndex : public Object
+{
+public:
+
+	static love::Type type;
+
+	enum QueryType
+	{
+		QUERY_BOX,
+		QUERY_POINT,
+		QUERY_RAY,
+		QUERY_MAX_ENUM
+	};
+
+	// A box given by its top-left corner and size.
+	struct Box
+	{
+		float x, y, w, h;
+	};
+
+	// One result of queryBatch: the index of the query (starting at 0) and
+	// the id of a box it found.
+	struct BatchResult
+	{
+		int query;
+		int id;
+	};
+
+	/**
+	 * margin is how far each box is enlarged in the tree, in the same units
+	 * as the boxes. Boxes which move by less than that since they were last
+	 * inserted don't change the structure of the tree.
+	 **/
+	SpatialIndex(float margin);
+	virtual ~SpatialIndex();
+
+	int insert(const Box &box);
+	void update(int id, const Box &box);
+	void remove(int id);
+	void clear();
+
+	bool contains(int id) const;
+	const Box &getBox(int id) const;
+	int getCount() const;
+	float getMargin() const;
+
+	// Appends the ids of the boxes which overlap the box.
+	void queryBox(const Box &box, std::vector<int> &ids) const;
+
+	// Appends the ids of the boxes which contain the point.
+	void queryPoint(float x, float y, std::vector<int> &ids) const;
+
+	// Appends the ids of the boxes the line segment passes through, nearest
+	// to its start first.
+	void rayCast(float x1, float y1, float x2, float y2, std::vector<int> &ids) const;
+
+	// Number of floats in each query of queryBatch.
+	static int getQueryComponents(QueryType type);
+
+	/**
+	 * Runs count queries of the same type. Boxes are given as x, y, width,
+	 * height, points as x, y, and rays as x1, y1, x2, y2. Results are appended
+	 * in query order.
+	 **/
+	void queryBatch(QueryType type, const float *queries, int count, std::vector<BatchResult> &results) const;
+
+	static bool getConstant(const char *in, QueryType &out);
+	static bool getConstant(QueryType in, const char *&out);
+	static std::vector<std::string> getConstants(QueryType);
+
+private:
+
+	struct Entry
+	{
+		Box box;
+		bool used;
+	};
+
+	struct BoxQuery;
+	struct RayQuery;
+
+	b2AABB toTree(const Box &box) const;
+	int32 checkProxy(int id) const;
+
+	b2DynamicTree tree;
+
+	// Indexed by the tree's proxy id, which is the box's id - 1.
+	std::vector<Entry> entries;
+	int count;
+
+	float margin;
+
+	// Tree units per box unit. Box2D's fixed enlargement becomes the margin.
+	float scale;
+
+	static StringMap<QueryType, QUERY_MAX_ENUM>::Entry queryTypeEntries[];
+	static StringMap<QueryType, QUERY_MAX_ENUM> queryTypes;
+
+}; // SpatialIndex
+
+} // math
+} // love
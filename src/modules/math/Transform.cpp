@@ -118,6 +118,18 @@ love::Vector2 Transform::inverseTransformPoint(love::Vector2 p)
 	return result;
 }
 
+void Transform::transformPoints(float *dst, size_t dststride, const float *src, size_t srcstride, int count) const
+{
+	if (count > 0)
+		matrix.transformXY(dst, dststride, src, srcstride, count);
+}
+
+void Transform::inverseTransformPoints(float *dst, size_t dststride, const float *src, size_t srcstride, int count)
+{
+	if (count > 0)
+		getInverseMatrix().transformXY(dst, dststride, src, srcstride, count);
+}
+
 const Matrix4 &Transform::getMatrix() const
 {
 	return matrix;
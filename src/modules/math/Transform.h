@@ -66,6 +66,14 @@ public:
 	love::Vector2 transformPoint(love::Vector2 p) const;
 	love::Vector2 inverseTransformPoint(love::Vector2 p);
 
+	/**
+	 * Transforms count 2D points. The pointers are to the x component of the
+	 * first point, and the strides are the distances in bytes between
+	 * consecutive points. The source and destination may be the same.
+	 **/
+	void transformPoints(float *dst, size_t dststride, const float *src, size_t srcstride, int count) const;
+	void inverseTransformPoints(float *dst, size_t dststride, const float *src, size_t srcstride, int count);
+
 	const Matrix4 &getMatrix() const;
 	void setMatrix(const Matrix4 &m);
 
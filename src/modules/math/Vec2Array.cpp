@@ -0,0 +1,426 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Vec2Array.h"
+#include "common/config.h"
+#include "common/Exception.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+
+#if defined(LOVE_SIMD_SSE)
+#include <xmmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace love
+{
+namespace math
+{
+
+love::Type Vec2Array::type("Vec2Array", &Object::type);
+
+#if defined(LOVE_SIMD_SSE)
+
+// Two vectors as [x0 y0 x1 y1].
+static inline __m128 load2(const uint8 *p, size_t stride)
+{
+	__m128 v = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *) p);
+	return _mm_loadh_pi(v, (const __m64 *) (p + stride));
+}
+
+static inline void store2(uint8 *p, size_t stride, __m128 v)
+{
+	_mm_storel_pi((__m64 *) p, v);
+	_mm_storeh_pi((__m64 *) (p + stride), v);
+}
+
+// [x0 y0 x1 y1] -> [l0 l0 l1 l1]
+static inline __m128 length2(__m128 v)
+{
+	__m128 sq = _mm_mul_ps(v, v);
+	__m128 sum = _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_sqrt_ps(sum);
+}
+
+#endif
+
+Vec2Array::Vec2Array(Data *data, int count, size_t stride, size_t offset)
+	: data(data)
+	, count(count)
+	, stride(stride)
+	, offset(offset)
+{
+	if (stride < sizeof(float) * 2 || stride % sizeof(float) != 0)
+		throw love::Exception("Vec2Array stride must be a multiple of 4 bytes, and at least 8.");
+
+	if (offset % sizeof(float) != 0)
+		throw love::Exception("Vec2Array byte offset must be a multiple of 4.");
+
+	if (count < 0 || count > getMaxCount(data->getSize(), stride, offset))
+		throw love::Exception("Data is too small to hold %d vectors.", count);
+}
+
+Vec2Array::~Vec2Array()
+{
+}
+
+Data *Vec2Array::getData() const
+{
+	return data.get();
+}
+
+int Vec2Array::getCount() const
+{
+	return count;
+}
+
+size_t Vec2Array::getStride() const
+{
+	return stride;
+}
+
+size_t Vec2Array::getOffset() const
+{
+	return offset;
+}
+
+void Vec2Array::get(int index, float &x, float &y) const
+{
+	const float *v = (const float *) (getBytes() + stride * index);
+	x = v[0];
+	y = v[1];
+}
+
+void Vec2Array::set(int index, float x, float y)
+{
+	float *v = (float *) (getBytes() + stride * index);
+	v[0] = x;
+	v[1] = y;
+}
+
+void Vec2Array::fill(float x, float y)
+{
+	uint8 *d = getBytes();
+
+	for (int i = 0; i < count; i++)
+	{
+		float *v = (float *) d;
+		v[0] = x;
+		v[1] = y;
+		d += stride;
+	}
+}
+
+void Vec2Array::axpy(const Vec2Array *x, float a)
+{
+	checkCount(x);
+
+	uint8 *d = getBytes();
+	const uint8 *s = x->getBytes();
+	const size_t sstride = x->stride;
+
+	int i = 0;
+
+#if defined(LOVE_SIMD_SSE)
+
+	const __m128 va = _mm_set1_ps(a);
+
+	for (; i + 2 <= count; i += 2)
+	{
+		__m128 r = _mm_add_ps(load2(d, stride), _mm_mul_ps(load2(s, sstride), va));
+		store2(d, stride, r);
+
+		d += stride * 2;
+		s += sstride * 2;
+	}
+
+#elif defined(LOVE_SIMD_NEON)
+
+	for (; i < count; i++)
+	{
+		float32x2_t r = vmla_n_f32(vld1_f32((const float *) d), vld1_f32((const float *) s), a);
+		vst1_f32((float *) d, r);
+
+		d += stride;
+		s += sstride;
+	}
+
+#endif
+
+	for (; i < count; i++)
+	{
+		float *v = (float *) d;
+		const float *u = (const float *) s;
+
+		v[0] += u[0] * a;
+		v[1] += u[1] * a;
+
+		d += stride;
+		s += sstride;
+	}
+}
+
+void Vec2Array::add(const Vec2Array *x)
+{
+	axpy(x, 1.0f);
+}
+
+void Vec2Array::add(float x, float y)
+{
+	scaleAndOffset(1.0f, 1.0f, x, y);
+}
+
+void Vec2Array::scale(float sx, float sy)
+{
+	scaleAndOffset(sx, sy, 0.0f, 0.0f);
+}
+
+void Vec2Array::scaleAndOffset(float sx, float sy, float tx, float ty)
+{
+	uint8 *d = getBytes();
+	int i = 0;
+
+#if defined(LOVE_SIMD_SSE)
+
+	const __m128 vs = _mm_setr_ps(sx, sy, sx, sy);
+	const __m128 vt = _mm_setr_ps(tx, ty, tx, ty);
+
+	for (; i + 2 <= count; i += 2)
+	{
+		store2(d, stride, _mm_add_ps(_mm_mul_ps(load2(d, stride), vs), vt));
+		d += stride * 2;
+	}
+
+#elif defined(LOVE_SIMD_NEON)
+
+	const float s[2] = {sx, sy};
+	const float t[2] = {tx, ty};
+	const float32x2_t vs = vld1_f32(s);
+	const float32x2_t vt = vld1_f32(t);
+
+	for (; i < count; i++)
+	{
+		vst1_f32((float *) d, vmla_f32(vt, vld1_f32((const float *) d), vs));
+		d += stride;
+	}
+
+#endif
+
+	for (; i < count; i++)
+	{
+		float *v = (float *) d;
+		v[0] = v[0] * sx + tx;
+		v[1] = v[1] * sy + ty;
+		d += stride;
+	}
+}
+
+void Vec2Array::clamp(float minx, float miny, float maxx, float maxy)
+{
+	uint8 *d = getBytes();
+	int i = 0;
+
+#if defined(LOVE_SIMD_SSE)
+
+	const __m128 vmin = _mm_setr_ps(minx, miny, minx, miny);
+	const __m128 vmax = _mm_setr_ps(maxx, maxy, maxx, maxy);
+
+	for (; i + 2 <= count; i += 2)
+	{
+		store2(d, stride, _mm_min_ps(_mm_max_ps(load2(d, stride), vmin), vmax));
+		d += stride * 2;
+	}
+
+#elif defined(LOVE_SIMD_NEON)
+
+	const float mins[2] = {minx, miny};
+	const float maxs[2] = {maxx, maxy};
+	const float32x2_t vmin = vld1_f32(mins);
+	const float32x2_t vmax = vld1_f32(maxs);
+
+	for (; i < count; i++)
+	{
+		vst1_f32((float *) d, vmin_f32(vmax_f32(vld1_f32((const float *) d), vmin), vmax));
+		d += stride;
+	}
+
+#endif
+
+	for (; i < count; i++)
+	{
+		float *v = (float *) d;
+		v[0] = std::min(std::max(v[0], minx), maxx);
+		v[1] = std::min(std::max(v[1], miny), maxy);
+		d += stride;
+	}
+}
+
+void Vec2Array::normalize()
+{
+	uint8 *d = getBytes();
+	int i = 0;
+
+#if defined(LOVE_SIMD_SSE)
+
+	const __m128 zero = _mm_setzero_ps();
+
+	for (; i + 2 <= count; i += 2)
+	{
+		__m128 v = load2(d, stride);
+		__m128 len = length2(v);
+
+		// Zero-length vectors would divide to NaN, so they're masked out.
+		__m128 nonzero = _mm_cmpgt_ps(len, zero);
+		store2(d, stride, _mm_or_ps(_mm_and_ps(nonzero, _mm_div_ps(v, len)), _mm_andnot_ps(nonzero, v)));
+
+		d += stride * 2;
+	}
+
+#endif
+
+	for (; i < count; i++)
+	{
+		float *v = (float *) d;
+		float len = sqrtf(v[0] * v[0] + v[1] * v[1]);
+
+		if (len > 0.0f)
+		{
+			v[0] /= len;
+			v[1] /= len;
+		}
+
+		d += stride;
+	}
+}
+
+void Vec2Array::getLengths(float *dst) const
+{
+	const uint8 *s = getBytes();
+	int i = 0;
+
+#if defined(LOVE_SIMD_SSE)
+
+	for (; i + 2 <= count; i += 2)
+	{
+		__m128 len = length2(load2(s, stride));
+		dst[i + 0] = _mm_cvtss_f32(len);
+		dst[i + 1] = _mm_cvtss_f32(_mm_movehl_ps(len, len));
+
+		s += stride * 2;
+	}
+
+#endif
+
+	for (; i < count; i++)
+	{
+		const float *v = (const float *) s;
+		dst[i] = sqrtf(v[0] * v[0] + v[1] * v[1]);
+		s += stride;
+	}
+}
+
+void Vec2Array::findPairs(const Vec2Array *other, float distance, std::vector<Pair> &pairs) const
+{
+	if (distance < 0.0f)
+		return;
+
+	const bool self = other == this;
+	const float maxsq = distance * distance;
+
+	const uint8 *a = getBytes();
+	const uint8 *bstart = other->getBytes();
+	const size_t bstride = other->stride;
+
+	for (int i = 0; i < count; i++)
+	{
+		const float *va = (const float *) a;
+		const float ax = va[0];
+		const float ay = va[1];
+
+		int j = self ? i + 1 : 0;
+		const uint8 *b = bstart + bstride * j;
+
+#if defined(LOVE_SIMD_SSE)
+
+		const __m128 vpos = _mm_setr_ps(ax, ay, ax, ay);
+		const __m128 vmax = _mm_set1_ps(maxsq);
+
+		for (; j + 2 <= other->count; j += 2)
+		{
+			__m128 diff = _mm_sub_ps(load2(b, bstride), vpos);
+			__m128 sq = _mm_mul_ps(diff, diff);
+			__m128 sum = _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2, 3, 0, 1)));
+
+			int mask = _mm_movemask_ps(_mm_cmple_ps(sum, vmax));
+
+			if (mask & 0x1)
+				pairs.push_back({i, j});
+			if (mask & 0x4)
+				pairs.push_back({i, j + 1});
+
+			b += bstride * 2;
+		}
+
+#endif
+
+		for (; j < other->count; j++)
+		{
+			const float *vb = (const float *) b;
+			float dx = vb[0] - ax;
+			float dy = vb[1] - ay;
+
+			if (dx * dx + dy * dy <= maxsq)
+				pairs.push_back({i, j});
+
+			b += bstride;
+		}
+
+		a += stride;
+	}
+}
+
+int Vec2Array::getMaxCount(size_t datasize, size_t stride, size_t offset)
+{
+	if (stride == 0 || offset > datasize || datasize - offset < sizeof(float) * 2)
+		return 0;
+
+	size_t maxcount = (datasize - offset - sizeof(float) * 2) / stride + 1;
+	return (int) std::min(maxcount, (size_t) LOVE_INT32_MAX);
+}
+
+uint8 *Vec2Array::getBytes() const
+{
+	return (uint8 *) data->getData() + offset;
+}
+
+void Vec2Array::checkCount(const Vec2Array *other) const
+{
+	if (other->count != count)
+		throw love::Exception("Vec2Array sizes must match (got %d and %d vectors).", count, other->count);
+}
+
+} // math
+} // love
@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/Data.h"
+#include "common/int.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace math
+{
+
+/**
+ * An array of 2D float vectors stored in a Data, with bulk operations which
+ * process the whole array in one call (two vectors per iteration with SSE).
+ *
+ * The vectors don't have to be tightly packed. Each one is two consecutive
+ * floats, stride bytes apart, starting offset bytes into the Data. That lets
+ * an array share its Data with other packed records, for example the
+ * positions and velocities in World:getBodyStates output, or the sprite
+ * positions read by SpriteBatch:setSprites.
+ **/
+class Vec2Array : public Object
+{
+public:
+
+	static love::Type type;
+
+	// A pair of vector indices (starting at 0) found by findPairs.
+	struct Pair
+	{
+		int a;
+		int b;
+	};
+
+	Vec2Array(Data *data, int count, size_t stride, size_t offset);
+	virtual ~Vec2Array();
+
+	Data *getData() const;
+	int getCount() const;
+	size_t getStride() const;
+	size_t getOffset() const;
+
+	void get(int index, float &x, float &y) const;
+	void set(int index, float x, float y);
+	void fill(float x, float y);
+
+	// this += x * a. Both arrays must have the same number of vectors.
+	void axpy(const Vec2Array *x, float a);
+	void add(const Vec2Array *x);
+	void add(float x, float y);
+	void scale(float sx, float sy);
+	void clamp(float minx, float miny, float maxx, float maxy);
+
+	// Scales each vector to unit length. Zero vectors are left as they are.
+	void normalize();
+
+	// Writes the length of each vector to dst, which must hold getCount()
+	// floats.
+	void getLengths(float *dst) const;
+
+	/**
+	 * Appends the index pairs of vectors in this array and other which are at
+	 * most distance apart. When other is this array, each pair is only found
+	 * once (with a < b), and vectors aren't paired with themselves.
+	 **/
+	void findPairs(const Vec2Array *other, float distance, std::vector<Pair> &pairs) const;
+
+	// The number of vectors which fit in a Data of the given size.
+	static int getMaxCount(size_t datasize, size_t stride, size_t offset);
+
+private:
+
+	uint8 *getBytes() const;
+	void checkCount(const Vec2Array *other) const;
+
+	// v = v * (sx, sy) + (tx, ty)
+	void scaleAndOffset(float sx, float sy, float tx, float ty);
+
+	StrongRef<Data> data;
+	int count;
+	size_t stride;
+	size_t offset;
+
+}; // Vec2Array
+
+} // math
+} // love
@@ -33,6 +33,25 @@ BezierCurve *luax_checkbeziercurve(lua_State *L, int idx)
 	return luax_checktype<BezierCurve>(L, idx);
 }
 
+void luax_checkbeziercurves(lua_State *L, int idx, std::vector<BezierCurve *> &curves)
+{
+	if (!lua_istable(L, idx))
+	{
+		curves.push_back(luax_checkbeziercurve(L, idx));
+		return;
+	}
+
+	int count = (int) luax_objlen(L, idx);
+	curves.reserve(curves.size() + count);
+
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, idx, i);
+		curves.push_back(luax_checkbeziercurve(L, -1));
+		lua_pop(L, 1);
+	}
+}
+
 int w_BezierCurve_getDegree(lua_State *L)
 {
 	BezierCurve *curve = luax_checkbeziercurve(L, 1);
@@ -213,6 +232,26 @@ int w_BezierCurve_renderSegment(lua_State *L)
 	return 1;
 }
 
+int w_BezierCurve_renderAdaptive(lua_State *L)
+{
+	BezierCurve *curve = luax_checkbeziercurve(L, 1);
+	double tolerance = luaL_optnumber(L, 2, 0.25);
+
+	std::vector<Vector2> points;
+	luax_catchexcept(L, [&](){ curve->renderAdaptive(tolerance, points); });
+
+	lua_createtable(L, (int) points.size() * 2, 0);
+	for (int i = 0; i < (int) points.size(); ++i)
+	{
+		lua_pushnumber(L, points[i].x);
+		lua_rawseti(L, -2, 2*i+1);
+		lua_pushnumber(L, points[i].y);
+		lua_rawseti(L, -2, 2*i+2);
+	}
+
+	return 1;
+}
+
 static const luaL_Reg w_BezierCurve_functions[] =
 {
 	{"getDegree", w_BezierCurve_getDegree},
@@ -229,6 +268,7 @@ static const luaL_Reg w_BezierCurve_functions[] =
 	{"getSegment", w_BezierCurve_getSegment},
 	{"render", w_BezierCurve_render},
 	{"renderSegment", w_BezierCurve_renderSegment},
+	{"renderAdaptive", w_BezierCurve_renderAdaptive},
 	{ 0, 0 }
 };
 
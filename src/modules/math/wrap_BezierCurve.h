@@ -31,6 +31,12 @@ namespace math
 {
 
 BezierCurve *luax_checkbeziercurve(lua_State *L, int idx);
+
+/**
+ * Gets either one BezierCurve or a table of them.
+ **/
+void luax_checkbeziercurves(lua_State *L, int idx, std::vector<BezierCurve *> &curves);
+
 extern "C" int luaopen_beziercurve(lua_State *L);
 
 } // math
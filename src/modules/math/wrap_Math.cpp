@@ -22,13 +22,21 @@
 #include "wrap_RandomGenerator.h"
 #include "wrap_BezierCurve.h"
 #include "wrap_Transform.h"
+#include "wrap_SpatialIndex.h"
+#include "wrap_Vec2Array.h"
 #include "MathModule.h"
 #include "BezierCurve.h"
+#include "NoiseField.h"
+#include "PolygonClipper.h"
 #include "Transform.h"
+#include "Vec2Array.h"
 
 #include "data/wrap_DataModule.h"
 #include "data/wrap_CompressedData.h"
 #include "data/DataModule.h"
+#include "common/colorconvert.h"
+
+#include "image/wrap_ImageData.h"
 
 #include <cmath>
 #include <iostream>
@@ -39,6 +47,10 @@ static const char math_lua[] =
 #include "wrap_Math.lua"
 ;
 
+#ifdef LOVE_PRECOMPILED_LUA
+#include "luabytecode/math_lua.h"
+#endif
+
 namespace love
 {
 namespace math
@@ -147,24 +159,92 @@ int w_newTransform(lua_State *L)
 	return 1;
 }
 
+int w_newSpatialIndex(lua_State *L)
+{
+	float margin = (float) luaL_optnumber(L, 1, 1.0);
+
+	SpatialIndex *t = nullptr;
+	luax_catchexcept(L, [&](){ t = Math::instance.newSpatialIndex(margin); });
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
+int w_newVec2Array(lua_State *L)
+{
+	Vec2Array *a = nullptr;
+
+	if (lua_isnumber(L, 1))
+	{
+		int count = (int) luaL_checkinteger(L, 1);
+		luax_catchexcept(L, [&](){ a = Math::instance.newVec2Array(count); });
+	}
+	else if (lua_istable(L, 1))
+	{
+		// A flat {x1, y1, x2, y2, ...} table, copied into a new ByteData.
+		int count = (int) luax_objlen(L, 1) / 2;
+		luax_catchexcept(L, [&](){ a = Math::instance.newVec2Array(count); });
+
+		for (int i = 0; i < count; i++)
+		{
+			lua_rawgeti(L, 1, i * 2 + 1);
+			lua_rawgeti(L, 1, i * 2 + 2);
+			a->set(i, (float) luaL_checknumber(L, -2), (float) luaL_checknumber(L, -1));
+			lua_pop(L, 2);
+		}
+	}
+	else
+	{
+		// A view into existing Data, which may be shared with other records.
+		Data *data = luax_checktype<Data>(L, 1);
+		lua_Integer stride = luaL_optinteger(L, 3, sizeof(float) * 2);
+		lua_Integer offset = luaL_optinteger(L, 4, 0);
+
+		if (stride <= 0 || offset < 0)
+			return luaL_error(L, "Vec2Array stride must be positive, and byte offset non-negative.");
+
+		int maxcount = Vec2Array::getMaxCount(data->getSize(), (size_t) stride, (size_t) offset);
+		int count = (int) luaL_optinteger(L, 2, maxcount);
+
+		luax_catchexcept(L, [&](){ a = Math::instance.newVec2Array(data, count, (size_t) stride, (size_t) offset); });
+	}
+
+	luax_pushtype(L, a);
+	a->release();
+	return 1;
+}
+
 int w_triangulate(lua_State *L)
 {
 	std::vector<love::Vector2> vertices;
+	std::vector<size_t> holestarts;
+
 	if (lua_istable(L, 1))
 	{
-		int top = (int) luax_objlen(L, 1);
-		vertices.reserve(top / 2);
-		for (int i = 1; i <= top; i += 2)
+		// Any tables after the first one are holes.
+		int ncontours = lua_gettop(L);
+		for (int contour = 1; contour <= ncontours; contour++)
 		{
-			lua_rawgeti(L, 1, i);
-			lua_rawgeti(L, 1, i+1);
+			luaL_checktype(L, contour, LUA_TTABLE);
 
-			Vector2 v;
-			v.x = (float) luaL_checknumber(L, -2);
-			v.y = (float) luaL_checknumber(L, -1);
-			vertices.push_back(v);
+			if (contour > 1)
+				holestarts.push_back(vertices.size());
 
-			lua_pop(L, 2);
+			int top = (int) luax_objlen(L, contour);
+			vertices.reserve(vertices.size() + top / 2);
+			for (int i = 1; i <= top; i += 2)
+			{
+				lua_rawgeti(L, contour, i);
+				lua_rawgeti(L, contour, i+1);
+
+				Vector2 v;
+				v.x = (float) luaL_checknumber(L, -2);
+				v.y = (float) luaL_checknumber(L, -1);
+				vertices.push_back(v);
+
+				lua_pop(L, 2);
+			}
 		}
 	}
 	else
@@ -189,7 +269,7 @@ int w_triangulate(lua_State *L)
 		if (vertices.size() == 3)
 			triangles.push_back(Triangle(vertices[0], vertices[1], vertices[2]));
 		else
-			triangles = triangulate(vertices);
+			triangles = triangulate(vertices, holestarts);
 	});
 
 	lua_createtable(L, (int) triangles.size(), 0);
@@ -217,6 +297,180 @@ int w_triangulate(lua_State *L)
 	return 1;
 }
 
+// Reads a flat table of vertex coordinates.
+static void luax_checkcontour(lua_State *L, int idx, std::vector<love::Vector2> &contour)
+{
+	luaL_checktype(L, idx, LUA_TTABLE);
+
+	int top = (int) luax_objlen(L, idx);
+	contour.reserve(contour.size() + top / 2);
+
+	for (int i = 1; i <= top; i += 2)
+	{
+		lua_rawgeti(L, idx, i);
+		lua_rawgeti(L, idx, i+1);
+
+		love::Vector2 v;
+		v.x = (float) luaL_checknumber(L, -2);
+		v.y = (float) luaL_checknumber(L, -1);
+		contour.push_back(v);
+
+		lua_pop(L, 2);
+	}
+}
+
+static void luax_pushcontour(lua_State *L, const love::Vector2 *points, size_t count)
+{
+	lua_createtable(L, (int) count * 2, 0);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		lua_pushnumber(L, points[i].x);
+		lua_rawseti(L, -2, (int) i * 2 + 1);
+		lua_pushnumber(L, points[i].y);
+		lua_rawseti(L, -2, (int) i * 2 + 2);
+	}
+}
+
+/**
+ * Gets one contour, a list of contours, or a list of polygons which are lists
+ * of contours (such as the results of clipPolygons.)
+ **/
+static void luax_checkcontours(lua_State *L, int idx, std::vector<PolygonClipper::Contour> &contours)
+{
+	if (idx < 0)
+		idx = lua_gettop(L) + idx + 1;
+
+	luaL_checktype(L, idx, LUA_TTABLE);
+
+	lua_rawgeti(L, idx, 1);
+	bool flat = lua_type(L, -1) == LUA_TNUMBER;
+	lua_pop(L, 1);
+
+	if (flat)
+	{
+		contours.emplace_back();
+		luax_checkcontour(L, idx, contours.back());
+		return;
+	}
+
+	int count = (int) luax_objlen(L, idx);
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, idx, i);
+		int element = lua_gettop(L);
+		luaL_checktype(L, element, LUA_TTABLE);
+
+		lua_rawgeti(L, element, 1);
+		bool contour = lua_type(L, -1) != LUA_TTABLE;
+		lua_pop(L, 1);
+
+		if (contour)
+		{
+			contours.emplace_back();
+			luax_checkcontour(L, element, contours.back());
+		}
+		else
+			luax_checkcontours(L, element, contours);
+
+		lua_pop(L, 1);
+	}
+}
+
+int w_clipPolygons(lua_State *L)
+{
+	const char *opstr = luaL_checkstring(L, 1);
+	PolygonClipper::Operation op;
+	if (!PolygonClipper::getConstant(opstr, op))
+		return luax_enumerror(L, "polygon operation", PolygonClipper::getConstants(op), opstr);
+
+	std::vector<PolygonClipper::Contour> subject;
+	std::vector<PolygonClipper::Contour> clip;
+	luax_checkcontours(L, 2, subject);
+	luax_checkcontours(L, 3, clip);
+
+	PolygonClipper::FillRule fill = PolygonClipper::FILL_EVENODD;
+	if (!lua_isnoneornil(L, 4))
+	{
+		const char *fillstr = luaL_checkstring(L, 4);
+		if (!PolygonClipper::getConstant(fillstr, fill))
+			return luax_enumerror(L, "fill rule", PolygonClipper::getConstants(fill), fillstr);
+	}
+
+	std::vector<PolygonClipper::Polygon> result;
+	luax_catchexcept(L, [&](){ PolygonClipper::clip(op, subject, clip, fill, result); });
+
+	// Each polygon is its outer contour followed by its holes, which can be
+	// passed straight to triangulate and decomposeConvex.
+	lua_createtable(L, (int) result.size(), 0);
+
+	for (size_t i = 0; i < result.size(); i++)
+	{
+		const PolygonClipper::Polygon &poly = result[i];
+
+		lua_createtable(L, (int) poly.holes.size() + 1, 0);
+
+		luax_pushcontour(L, poly.outer.data(), poly.outer.size());
+		lua_rawseti(L, -2, 1);
+
+		for (size_t j = 0; j < poly.holes.size(); j++)
+		{
+			luax_pushcontour(L, poly.holes[j].data(), poly.holes[j].size());
+			lua_rawseti(L, -2, (int) j + 2);
+		}
+
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	return 1;
+}
+
+int w_decomposeConvex(lua_State *L)
+{
+	std::vector<love::Vector2> vertices;
+	std::vector<size_t> holestarts;
+
+	// Any tables after the first one are holes. The vertex limit defaults to
+	// what love.physics polygon shapes can use.
+	int maxvertices = 8;
+	int ncontours = lua_gettop(L);
+
+	if (ncontours > 1 && lua_type(L, ncontours) == LUA_TNUMBER)
+	{
+		maxvertices = (int) luaL_checkinteger(L, ncontours);
+		ncontours--;
+	}
+
+	for (int contour = 1; contour <= ncontours; contour++)
+	{
+		if (contour > 1)
+			holestarts.push_back(vertices.size());
+
+		luax_checkcontour(L, contour, vertices);
+	}
+
+	if (vertices.size() < 3)
+		return luaL_error(L, "Need at least 3 vertices to decompose a polygon");
+
+	std::vector<std::vector<uint32>> pieces;
+	luax_catchexcept(L, [&](){ decomposeConvex(vertices.data(), vertices.size(), holestarts, maxvertices, pieces); });
+
+	std::vector<love::Vector2> points;
+
+	lua_createtable(L, (int) pieces.size(), 0);
+	for (size_t i = 0; i < pieces.size(); i++)
+	{
+		points.clear();
+		for (uint32 index : pieces[i])
+			points.push_back(vertices[index]);
+
+		luax_pushcontour(L, points.data(), points.size());
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	return 1;
+}
+
 int w_isConvex(lua_State *L)
 {
 	std::vector<love::Vector2> vertices;
@@ -318,6 +572,50 @@ int w_linearToGamma(lua_State *L)
 	return numcomponents;
 }
 
+static size_t luax_checkcolorcount(lua_State *L, int idx, const Data *data)
+{
+	size_t maxcount = data->getSize() / (sizeof(float) * 4);
+
+	if (lua_isnoneornil(L, idx))
+		return maxcount;
+
+	lua_Integer count = luaL_checkinteger(L, idx);
+	if (count < 0 || (size_t) count > maxcount)
+		luaL_error(L, "Data is too small to hold %d colors.", (int) count);
+
+	return (size_t) count;
+}
+
+int w_convertColors(lua_State *L)
+{
+	Data *data = luax_checktype<Data>(L, 1);
+
+	ColorConversion conversion;
+	const char *str = luaL_checkstring(L, 2);
+	if (!getConstant(str, conversion))
+		return luax_enumerror(L, "color conversion", getConstants(conversion), str);
+
+	size_t count = luax_checkcolorcount(L, 3, data);
+
+	love::convertColors(conversion, (float *) data->getData(), count);
+	return 0;
+}
+
+int w_swizzleColors(lua_State *L)
+{
+	Data *data = luax_checktype<Data>(L, 1);
+
+	int order[4];
+	const char *str = luaL_checkstring(L, 2);
+	if (!getSwizzle(str, order))
+		return luaL_error(L, "Invalid channel order '%s' (expected four of r, g, b and a, e.g. \"bgra\")", str);
+
+	size_t count = luax_checkcolorcount(L, 3, data);
+
+	love::swizzleColors(order, (float *) data->getData(), count);
+	return 0;
+}
+
 int w_noise(lua_State *L)
 {
 	int nargs = std::min(std::max(lua_gettop(L), 1), 4);
@@ -348,6 +646,74 @@ int w_noise(lua_State *L)
 	return 1;
 }
 
+static void luax_checknoisefieldsettings(lua_State *L, int idx, NoiseField::Settings &s)
+{
+	if (lua_isnoneornil(L, idx))
+		return;
+
+	luaL_checktype(L, idx, LUA_TTABLE);
+
+	s.dimensions = luax_intflag(L, idx, "dimensions", s.dimensions);
+	s.type = s.dimensions > 2 ? NoiseField::TYPE_PERLIN : NoiseField::TYPE_SIMPLEX;
+
+	lua_getfield(L, idx, "type");
+	if (!lua_isnoneornil(L, -1))
+	{
+		const char *str = luaL_checkstring(L, -1);
+		if (!NoiseField::getConstant(str, s.type))
+			luax_enumerror(L, "noise type", NoiseField::getConstants(s.type), str);
+	}
+	lua_pop(L, 1);
+
+	const char *origin[] = {"x", "y", "z", "w"};
+	for (int i = 0; i < 4; i++)
+		s.origin[i] = (float) luax_numberflag(L, idx, origin[i], s.origin[i]);
+
+	s.step[0] = (float) luax_numberflag(L, idx, "dx", s.step[0]);
+	s.step[1] = (float) luax_numberflag(L, idx, "dy", s.step[1]);
+
+	s.octaves = luax_intflag(L, idx, "octaves", s.octaves);
+	s.lacunarity = (float) luax_numberflag(L, idx, "lacunarity", s.lacunarity);
+	s.persistence = (float) luax_numberflag(L, idx, "persistence", s.persistence);
+}
+
+int w_generateNoise(lua_State *L)
+{
+	NoiseField::Settings settings;
+
+	if (luax_istype(L, 1, love::image::ImageData::type))
+	{
+		love::image::ImageData *data = love::image::luax_checkimagedata(L, 1);
+		luax_checknoisefieldsettings(L, 2, settings);
+
+		int channel = lua_istable(L, 2) ? luax_intflag(L, 2, "channel", 1) : 1;
+
+		luax_catchexcept(L, [&](){ NoiseField::generate(settings, data, channel - 1); });
+		return 0;
+	}
+
+	Data *data = luax_checktype<Data>(L, 1);
+	int width = (int) luaL_checkinteger(L, 2);
+	int height = (int) luaL_checkinteger(L, 3);
+	luax_checknoisefieldsettings(L, 4, settings);
+
+	lua_Integer offset = lua_istable(L, 4) ? luax_intflag(L, 4, "offset", 0) : 0;
+
+	if (width <= 0 || height <= 0)
+		return luaL_error(L, "Noise field dimensions must be greater than 0.");
+
+	if (offset < 0 || offset % sizeof(float) != 0)
+		return luaL_error(L, "Noise field byte offset must be a non-negative multiple of 4.");
+
+	if ((size_t) offset + (size_t) width * height * sizeof(float) > data->getSize())
+		return luaL_error(L, "Data is too small for a %dx%d noise field.", width, height);
+
+	float *dst = (float *) ((uint8 *) data->getData() + offset);
+
+	luax_catchexcept(L, [&](){ NoiseField::generate(settings, width, height, dst, width); });
+	return 0;
+}
+
 int w_compress(lua_State *L)
 {
 	using namespace love::data;
@@ -455,11 +821,18 @@ static const luaL_Reg functions[] =
 	{ "newRandomGenerator", w_newRandomGenerator },
 	{ "newBezierCurve", w_newBezierCurve },
 	{ "newTransform", w_newTransform },
+	{ "newSpatialIndex", w_newSpatialIndex },
+	{ "newVec2Array", w_newVec2Array },
 	{ "triangulate", w_triangulate },
 	{ "isConvex", w_isConvex },
+	{ "clipPolygons", w_clipPolygons },
+	{ "decomposeConvex", w_decomposeConvex },
 	{ "gammaToLinear", w_gammaToLinear },
 	{ "linearToGamma", w_linearToGamma },
+	{ "convertColors", w_convertColors },
+	{ "swizzleColors", w_swizzleColors },
 	{ "noise", w_noise },
+	{ "generateNoise", w_generateNoise },
 
 	// Deprecated.
 	{ "compress", w_compress },
@@ -473,6 +846,8 @@ static const lua_CFunction types[] =
 	luaopen_randomgenerator,
 	luaopen_beziercurve,
 	luaopen_transform,
+	luaopen_spatialindex,
+	luaopen_vec2array,
 	0
 };
 
@@ -490,7 +865,7 @@ extern "C" int luaopen_love_math(lua_State *L)
 	int n = luax_register_module(L, w);
 
 	// Execute wrap_Math.lua, sending the math table and ffifuncs pointer as args.
-	luaL_loadbuffer(L, math_lua, sizeof(math_lua), "wrap_Math.lua");
+	luax_loadembedded(L, LOVE_EMBEDDED_BYTECODE(math_lua), math_lua, sizeof(math_lua), "wrap_Math.lua");
 	lua_pushvalue(L, -2);
 	lua_pushlightuserdata(L, &ffifuncs);
 	lua_call(L, 2, 0);
@@ -42,6 +42,14 @@ function love_math.randomNormal(stddev, mean)
 	return rng:randomNormal(stddev, mean)
 end
 
+function love_math.randomFill(data, count, l, u)
+	return rng:randomFill(data, count, l, u)
+end
+
+function love_math.randomNormalFill(data, count, stddev, mean)
+	return rng:randomNormalFill(data, count, stddev, mean)
+end
+
 function love_math.setRandomSeed(low, high)
 	return rng:setSeed(low, high)
 end
@@ -19,6 +19,7 @@
  **/
 
 #include "wrap_RandomGenerator.h"
+#include "common/Data.h"
 
 #include <cmath>
 #include <algorithm>
@@ -28,6 +29,10 @@ static const char randomgenerator_lua[] =
 #include "wrap_RandomGenerator.lua"
 ;
 
+#ifdef LOVE_PRECOMPILED_LUA
+#include "luabytecode/randomgenerator_lua.h"
+#endif
+
 namespace love
 {
 namespace math
@@ -85,6 +90,62 @@ int w_RandomGenerator_randomNormal(lua_State *L)
 	return 1;
 }
 
+static size_t luax_checkrandomfillcount(lua_State *L, int idx, const Data *data, size_t elementsize)
+{
+	size_t maxcount = data->getSize() / elementsize;
+
+	if (lua_isnoneornil(L, idx))
+		return maxcount;
+
+	lua_Integer count = luaL_checkinteger(L, idx);
+	if (count < 0)
+		luaL_argerror(L, idx, "count must not be negative");
+	else if ((size_t) count > maxcount)
+		luaL_error(L, "Data is too small to hold %d values.", (int) count);
+
+	return (size_t) count;
+}
+
+int w_RandomGenerator_randomFill(lua_State *L)
+{
+	RandomGenerator *rng = luax_checkrandomgenerator(L, 1);
+	Data *data = luax_checktype<Data>(L, 2);
+
+	if (lua_isnoneornil(L, 4))
+	{
+		size_t count = luax_checkrandomfillcount(L, 3, data, sizeof(float));
+		rng->randomFill((float *) data->getData(), count, 0.0, 1.0);
+		return 0;
+	}
+
+	size_t count = luax_checkrandomfillcount(L, 3, data, sizeof(int32));
+
+	int32 min = 1;
+	int32 max = (int32) luaL_checkinteger(L, 4);
+
+	if (!lua_isnoneornil(L, 5))
+	{
+		min = max;
+		max = (int32) luaL_checkinteger(L, 5);
+	}
+
+	rng->randomFill((int32 *) data->getData(), count, min, max);
+	return 0;
+}
+
+int w_RandomGenerator_randomNormalFill(lua_State *L)
+{
+	RandomGenerator *rng = luax_checkrandomgenerator(L, 1);
+	Data *data = luax_checktype<Data>(L, 2);
+	size_t count = luax_checkrandomfillcount(L, 3, data, sizeof(float));
+
+	double stddev = luaL_optnumber(L, 4, 1.0);
+	double mean = luaL_optnumber(L, 5, 0.0);
+
+	rng->randomNormalFill((float *) data->getData(), count, stddev, mean);
+	return 0;
+}
+
 int w_RandomGenerator_setSeed(lua_State *L)
 {
 	RandomGenerator *rng = luax_checkrandomgenerator(L, 1);
@@ -149,6 +210,8 @@ static const luaL_Reg w_RandomGenerator_functions[] =
 {
 	{ "_random", w_RandomGenerator__random }, // random() is defined in wrap_RandomGenerator.lua.
 	{ "randomNormal", w_RandomGenerator_randomNormal },
+	{ "randomFill", w_RandomGenerator_randomFill },
+	{ "randomNormalFill", w_RandomGenerator_randomNormalFill },
 	{ "setSeed", w_RandomGenerator_setSeed },
 	{ "getSeed", w_RandomGenerator_getSeed },
 	{ "setState", w_RandomGenerator_setState },
@@ -166,7 +229,7 @@ extern "C" int luaopen_randomgenerator(lua_State *L)
 	// ffi functions struct pointer as arguments.
 	if (lua_istable(L, -1))
 	{
-		luaL_loadbuffer(L, randomgenerator_lua, sizeof(randomgenerator_lua), "wrap_RandomGenerator.lua");
+		luax_loadembedded(L, LOVE_EMBEDDED_BYTECODE(randomgenerator_lua), randomgenerator_lua, sizeof(randomgenerator_lua), "wrap_RandomGenerator.lua");
 		lua_pushvalue(L, -2);
 		lua_pushlightuserdata(L, &ffifuncs);
 		lua_call(L, 2, 0);
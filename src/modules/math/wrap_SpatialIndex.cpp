@@ -0,0 +1,320 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_SpatialIndex.h"
+#include "common/Data.h"
+#include "common/int.h"
+
+// C++
+#include <algorithm>
+#include <cstring>
+
+namespace love
+{
+namespace math
+{
+
+SpatialIndex *luax_checkspatialindex(lua_State *L, int idx)
+{
+	return luax_checktype<SpatialIndex>(L, idx);
+}
+
+static SpatialIndex::Box luax_checkbox(lua_State *L, int idx)
+{
+	SpatialIndex::Box box;
+	box.x = (float) luaL_checknumber(L, idx + 0);
+	box.y = (float) luaL_checknumber(L, idx + 1);
+	box.w = (float) luaL_checknumber(L, idx + 2);
+	box.h = (float) luaL_checknumber(L, idx + 3);
+	return box;
+}
+
+static int luax_checkid(lua_State *L, SpatialIndex *t, int idx)
+{
+	int id = (int) luaL_checkinteger(L, idx);
+	if (!t->contains(id))
+		luaL_error(L, "Invalid SpatialIndex id: %d", id);
+	return id;
+}
+
+/**
+ * Reads count values of components floats each from a Data or a flat table
+ * of numbers. Table values are stored in temp.
+ **/
+static const float *luax_checkfloats(lua_State *L, int idx, int components, int &count, std::vector<float> &temp)
+{
+	if (lua_istable(L, idx))
+	{
+		count = (int) luax_objlen(L, idx) / components;
+		temp.resize((size_t) count * components);
+
+		for (size_t i = 0; i < temp.size(); i++)
+		{
+			lua_rawgeti(L, idx, (int) i + 1);
+			temp[i] = (float) luaL_checknumber(L, -1);
+			lua_pop(L, 1);
+		}
+
+		return temp.data();
+	}
+
+	Data *data = luax_checktype<Data>(L, idx);
+	count = (int) (data->getSize() / (components * sizeof(float)));
+	return (const float *) data->getData();
+}
+
+/**
+ * Writes the values to the Data or table at idx (replacing the table's old
+ * contents), or to a new table if there's neither. Data receives 32-bit
+ * integers. Returns the table and the value count, or for Data the number of
+ * values which fit and the total count.
+ **/
+static int luax_pushints(lua_State *L, int idx, const std::vector<int> &values)
+{
+	if (luax_istype(L, idx, Data::type))
+	{
+		Data *data = luax_checktype<Data>(L, idx);
+		size_t written = std::min(values.size(), data->getSize() / sizeof(int32));
+		int32 *dst = (int32 *) data->getData();
+
+		for (size_t i = 0; i < written; i++)
+			dst[i] = (int32) values[i];
+
+		lua_pushinteger(L, (lua_Integer) written);
+		lua_pushinteger(L, (lua_Integer) values.size());
+		return 2;
+	}
+
+	int oldlength = 0;
+
+	if (lua_istable(L, idx))
+	{
+		oldlength = (int) luax_objlen(L, idx);
+		lua_pushvalue(L, idx);
+	}
+	else
+		lua_createtable(L, (int) values.size(), 0);
+
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		lua_pushinteger(L, values[i]);
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	for (int i = oldlength; i > (int) values.size(); i--)
+	{
+		lua_pushnil(L);
+		lua_rawseti(L, -2, i);
+	}
+
+	lua_pushinteger(L, (lua_Integer) values.size());
+	return 2;
+}
+
+int w_SpatialIndex_insert(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	SpatialIndex::Box box = luax_checkbox(L, 2);
+
+	int id = 0;
+	luax_catchexcept(L, [&](){ id = t->insert(box); });
+
+	lua_pushinteger(L, id);
+	return 1;
+}
+
+int w_SpatialIndex_update(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	int id = luax_checkid(L, t, 2);
+	SpatialIndex::Box box = luax_checkbox(L, 3);
+
+	luax_catchexcept(L, [&](){ t->update(id, box); });
+	return 0;
+}
+
+int w_SpatialIndex_updateBatch(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+
+	// Each update is an id followed by x, y, width and height.
+	const int components = 5;
+
+	std::vector<float> temp;
+	int count = 0;
+	const float *values = luax_checkfloats(L, 2, components, count, temp);
+
+	for (int i = 0; i < count; i++)
+	{
+		const float *v = values + i * components;
+		int id = (int) v[0];
+
+		if (!t->contains(id))
+			return luaL_error(L, "Invalid SpatialIndex id at update %d: %d", i + 1, id);
+
+		SpatialIndex::Box box = {v[1], v[2], v[3], v[4]};
+		luax_catchexcept(L, [&](){ t->update(id, box); });
+	}
+
+	return 0;
+}
+
+int w_SpatialIndex_remove(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	int id = luax_checkid(L, t, 2);
+	t->remove(id);
+	return 0;
+}
+
+int w_SpatialIndex_clear(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	t->clear();
+	return 0;
+}
+
+int w_SpatialIndex_contains(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	int id = (int) luaL_checkinteger(L, 2);
+	luax_pushboolean(L, t->contains(id));
+	return 1;
+}
+
+int w_SpatialIndex_getBoundingBox(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	int id = luax_checkid(L, t, 2);
+
+	const SpatialIndex::Box &box = t->getBox(id);
+	lua_pushnumber(L, box.x);
+	lua_pushnumber(L, box.y);
+	lua_pushnumber(L, box.w);
+	lua_pushnumber(L, box.h);
+	return 4;
+}
+
+int w_SpatialIndex_getCount(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	lua_pushinteger(L, t->getCount());
+	return 1;
+}
+
+int w_SpatialIndex_getMargin(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	lua_pushnumber(L, t->getMargin());
+	return 1;
+}
+
+int w_SpatialIndex_queryBoundingBox(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	SpatialIndex::Box box = luax_checkbox(L, 2);
+
+	std::vector<int> ids;
+	luax_catchexcept(L, [&](){ t->queryBox(box, ids); });
+
+	return luax_pushints(L, 6, ids);
+}
+
+int w_SpatialIndex_queryPoint(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	float x = (float) luaL_checknumber(L, 2);
+	float y = (float) luaL_checknumber(L, 3);
+
+	std::vector<int> ids;
+	t->queryPoint(x, y, ids);
+
+	return luax_pushints(L, 4, ids);
+}
+
+int w_SpatialIndex_rayCast(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+	float x1 = (float) luaL_checknumber(L, 2);
+	float y1 = (float) luaL_checknumber(L, 3);
+	float x2 = (float) luaL_checknumber(L, 4);
+	float y2 = (float) luaL_checknumber(L, 5);
+
+	std::vector<int> ids;
+	t->rayCast(x1, y1, x2, y2, ids);
+
+	return luax_pushints(L, 6, ids);
+}
+
+int w_SpatialIndex_queryBatch(lua_State *L)
+{
+	SpatialIndex *t = luax_checkspatialindex(L, 1);
+
+	const char *typestr = luaL_checkstring(L, 2);
+	SpatialIndex::QueryType type;
+	if (!SpatialIndex::getConstant(typestr, type))
+		return luax_enumerror(L, "spatial query type", SpatialIndex::getConstants(type), typestr);
+
+	std::vector<float> temp;
+	int count = 0;
+	const float *queries = luax_checkfloats(L, 3, SpatialIndex::getQueryComponents(type), count, temp);
+
+	std::vector<SpatialIndex::BatchResult> results;
+	luax_catchexcept(L, [&](){ t->queryBatch(type, queries, count, results); });
+
+	// Each result is written as the query index (starting at 1) followed by
+	// the id that was found.
+	std::vector<int> values;
+	values.reserve(results.size() * 2);
+
+	for (const SpatialIndex::BatchResult &r : results)
+	{
+		values.push_back(r.query + 1);
+		values.push_back(r.id);
+	}
+
+	return luax_pushints(L, 4, values);
+}
+
+static const luaL_Reg w_SpatialIndex_functions[] =
+{
+	{ "insert", w_SpatialIndex_insert },
+	{ "update", w_SpatialIndex_update },
+	{ "updateBatch", w_SpatialIndex_updateBatch },
+	{ "remove", w_SpatialIndex_remove },
+	{ "clear", w_SpatialIndex_clear },
+	{ "contains", w_SpatialIndex_contains },
+	{ "getBoundingBox", w_SpatialIndex_getBoundingBox },
+	{ "getCount", w_SpatialIndex_getCount },
+	{ "getMargin", w_SpatialIndex_getMargin },
+	{ "queryBoundingBox", w_SpatialIndex_queryBoundingBox },
+	{ "queryPoint", w_SpatialIndex_queryPoint },
+	{ "rayCast", w_SpatialIndex_rayCast },
+	{ "queryBatch", w_SpatialIndex_queryBatch },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_spatialindex(lua_State *L)
+{
+	return luax_register_type(L, &SpatialIndex::type, w_SpatialIndex_functions, nullptr);
+}
+
+} // math
+} // love
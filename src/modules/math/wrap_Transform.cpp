@@ -19,6 +19,19 @@
  **/
 
 #include "wrap_Transform.h"
+#include "common/Data.h"
+
+// C++
+#include <vector>
+
+// Shove the wrap_Transform.lua code directly into a raw string literal.
+static const char transform_lua[] =
+#include "wrap_Transform.lua"
+;
+
+#ifdef LOVE_PRECOMPILED_LUA
+#include "luabytecode/transform_lua.h"
+#endif
 
 namespace love
 {
@@ -281,6 +294,77 @@ int w_Transform_inverseTransformPoint(lua_State *L)
 	return 2;
 }
 
+static int transformPoints(lua_State *L, bool inverse)
+{
+	Transform *t = luax_checktransform(L, 1);
+
+	if (lua_istable(L, 2))
+	{
+		int components = (int) luax_objlen(L, 2);
+		int count = components / 2;
+
+		std::vector<float> points(count * 2);
+
+		for (int i = 0; i < count * 2; i++)
+		{
+			lua_rawgeti(L, 2, i + 1);
+			points[i] = (float) luaL_checknumber(L, -1);
+			lua_pop(L, 1);
+		}
+
+		if (inverse)
+			t->inverseTransformPoints(points.data(), sizeof(float) * 2, points.data(), sizeof(float) * 2, count);
+		else
+			t->transformPoints(points.data(), sizeof(float) * 2, points.data(), sizeof(float) * 2, count);
+
+		for (int i = 0; i < count * 2; i++)
+		{
+			lua_pushnumber(L, points[i]);
+			lua_rawseti(L, 2, i + 1);
+		}
+
+		return 0;
+	}
+
+	Data *data = luax_checktype<Data>(L, 2);
+	lua_Integer stride = luaL_optinteger(L, 4, sizeof(float) * 2);
+	lua_Integer offset = luaL_optinteger(L, 5, 0);
+	lua_Integer size = (lua_Integer) data->getSize();
+
+	if (stride < (lua_Integer) sizeof(float) * 2 || stride % sizeof(float) != 0)
+		return luaL_error(L, "Point stride must be a multiple of 4 bytes, and at least 8.");
+
+	if (offset < 0 || offset % sizeof(float) != 0)
+		return luaL_error(L, "Point byte offset must be a non-negative multiple of 4.");
+
+	lua_Integer maxcount = 0;
+	if (size - offset >= (lua_Integer) sizeof(float) * 2)
+		maxcount = (size - offset - sizeof(float) * 2) / stride + 1;
+
+	lua_Integer count = luaL_optinteger(L, 3, maxcount);
+	if (count < 0 || count > maxcount)
+		return luaL_error(L, "Data is too small to hold %d points.", (int) count);
+
+	float *points = (float *) ((uint8 *) data->getData() + offset);
+
+	if (inverse)
+		t->inverseTransformPoints(points, (size_t) stride, points, (size_t) stride, (int) count);
+	else
+		t->transformPoints(points, (size_t) stride, points, (size_t) stride, (int) count);
+
+	return 0;
+}
+
+int w_Transform_transformPoints(lua_State *L)
+{
+	return transformPoints(L, false);
+}
+
+int w_Transform_inverseTransformPoints(lua_State *L)
+{
+	return transformPoints(L, true);
+}
+
 int w_Transform__mul(lua_State *L)
 {
 	Transform *t1 = luax_checktransform(L, 1);
@@ -291,6 +375,80 @@ int w_Transform__mul(lua_State *L)
 	return 1;
 }
 
+static inline Transform *ffi_totransform(Proxy *p)
+{
+	if (p == nullptr || p->object == nullptr || p->type == nullptr || !p->type->isa(Transform::type))
+		return nullptr;
+	return (Transform *) p->object;
+}
+
+// C functions in a struct, necessary for the FFI versions of Transform methods.
+// They return false when given something other than a Transform.
+struct FFI_Transform
+{
+	bool (*translate)(Proxy *p, float x, float y);
+	bool (*rotate)(Proxy *p, float angle);
+	bool (*scale)(Proxy *p, float sx, float sy);
+	bool (*shear)(Proxy *p, float kx, float ky);
+	bool (*setTransformation)(Proxy *p, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+	bool (*transformPoint)(Proxy *p, float x, float y, float *result);
+};
+
+static FFI_Transform ffifuncs =
+{
+	[](Proxy *p, float x, float y) -> bool // translate
+	{
+		Transform *t = ffi_totransform(p);
+		if (t != nullptr)
+			t->translate(x, y);
+		return t != nullptr;
+	},
+
+	[](Proxy *p, float angle) -> bool // rotate
+	{
+		Transform *t = ffi_totransform(p);
+		if (t != nullptr)
+			t->rotate(angle);
+		return t != nullptr;
+	},
+
+	[](Proxy *p, float sx, float sy) -> bool // scale
+	{
+		Transform *t = ffi_totransform(p);
+		if (t != nullptr)
+			t->scale(sx, sy);
+		return t != nullptr;
+	},
+
+	[](Proxy *p, float kx, float ky) -> bool // shear
+	{
+		Transform *t = ffi_totransform(p);
+		if (t != nullptr)
+			t->shear(kx, ky);
+		return t != nullptr;
+	},
+
+	[](Proxy *p, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky) -> bool // setTransformation
+	{
+		Transform *t = ffi_totransform(p);
+		if (t != nullptr)
+			t->setTransformation(x, y, a, sx, sy, ox, oy, kx, ky);
+		return t != nullptr;
+	},
+
+	[](Proxy *p, float x, float y, float *result) -> bool // transformPoint
+	{
+		Transform *t = ffi_totransform(p);
+		if (t == nullptr)
+			return false;
+
+		love::Vector2 v = t->transformPoint(love::Vector2(x, y));
+		result[0] = v.x;
+		result[1] = v.y;
+		return true;
+	},
+};
+
 static const luaL_Reg functions[] =
 {
 	{ "clone", w_Transform_clone },
@@ -307,13 +465,32 @@ static const luaL_Reg functions[] =
 	{ "getMatrix", w_Transform_getMatrix },
 	{ "transformPoint", w_Transform_transformPoint },
 	{ "inverseTransformPoint", w_Transform_inverseTransformPoint },
+	{ "transformPoints", w_Transform_transformPoints },
+	{ "inverseTransformPoints", w_Transform_inverseTransformPoints },
 	{ "__mul", w_Transform__mul },
 	{ 0, 0 }
 };
 
 extern "C" int luaopen_transform(lua_State *L)
 {
-	return luax_register_type(L, &Transform::type, functions, nullptr);
+	int ret = luax_register_type(L, &Transform::type, functions, nullptr);
+
+	luax_gettypemetatable(L, Transform::type);
+
+	// Load and execute wrap_Transform.lua, sending the metatable and the ffi
+	// functions struct pointer as arguments.
+	if (lua_istable(L, -1))
+	{
+		luax_loadembedded(L, LOVE_EMBEDDED_BYTECODE(transform_lua), transform_lua, sizeof(transform_lua), "wrap_Transform.lua");
+		lua_pushvalue(L, -2);
+		lua_pushlightuserdata(L, &ffifuncs);
+		lua_call(L, 2, 0);
+	}
+
+	// Pop the metatable.
+	lua_pop(L, 1);
+
+	return ret;
 }
 
 } // math
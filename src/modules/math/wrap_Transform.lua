@@ -0,0 +1,129 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2018 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+
+local Transform_mt, ffifuncspointer = ...
+local Transform = Transform_mt.__index
+
+local type, tonumber = type, tonumber
+
+-- Everything below this point is efficient FFI replacements for existing
+-- Transform functionality. Calls they don't handle go through the regular
+-- methods instead, which also raise any errors.
+
+if type(jit) ~= "table" or not jit.status() then
+	-- LuaJIT's FFI is *much* slower than LOVE's regular methods when the JIT
+	-- compiler is disabled.
+	return
+end
+
+local status, ffi = pcall(require, "ffi")
+if not status then return end
+
+pcall(ffi.cdef, [[
+typedef struct Proxy Proxy;
+
+typedef struct FFI_Transform
+{
+	bool (*translate)(Proxy *p, float x, float y);
+	bool (*rotate)(Proxy *p, float angle);
+	bool (*scale)(Proxy *p, float sx, float sy);
+	bool (*shear)(Proxy *p, float kx, float ky);
+	bool (*setTransformation)(Proxy *p, float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
+	bool (*transformPoint)(Proxy *p, float x, float y, float *result);
+} FFI_Transform;
+]])
+
+local ffifuncs = ffi.cast("FFI_Transform *", ffifuncspointer)
+
+local function isoptnumber(v)
+	return v == nil or type(v) == "number"
+end
+
+local translate_C = Transform.translate
+
+function Transform:translate(x, y)
+	if type(self) == "userdata" and type(x) == "number" and type(y) == "number" then
+		if ffifuncs.translate(self, x, y) then return self end
+	end
+	return translate_C(self, x, y)
+end
+
+local rotate_C = Transform.rotate
+
+function Transform:rotate(angle)
+	if type(self) == "userdata" and type(angle) == "number" then
+		if ffifuncs.rotate(self, angle) then return self end
+	end
+	return rotate_C(self, angle)
+end
+
+local scale_C = Transform.scale
+
+function Transform:scale(sx, sy)
+	if type(self) == "userdata" and type(sx) == "number" and isoptnumber(sy) then
+		if ffifuncs.scale(self, sx, sy == nil and sx or sy) then return self end
+	end
+	return scale_C(self, sx, sy)
+end
+
+local shear_C = Transform.shear
+
+function Transform:shear(kx, ky)
+	if type(self) == "userdata" and type(kx) == "number" and type(ky) == "number" then
+		if ffifuncs.shear(self, kx, ky) then return self end
+	end
+	return shear_C(self, kx, ky)
+end
+
+local setTransformation_C = Transform.setTransformation
+
+function Transform:setTransformation(x, y, a, sx, sy, ox, oy, kx, ky)
+	if type(self) == "userdata" and isoptnumber(x) and isoptnumber(y) and isoptnumber(a)
+		and isoptnumber(sx) and isoptnumber(sy) and isoptnumber(ox)
+		and isoptnumber(oy) and isoptnumber(kx) and isoptnumber(ky) then
+		local tsx = sx or 1
+		if ffifuncs.setTransformation(self, x or 0, y or 0, a or 0, tsx, sy or tsx, ox or 0, oy or 0, kx or 0, ky or 0) then
+			return self
+		end
+	end
+	return setTransformation_C(self, x, y, a, sx, sy, ox, oy, kx, ky)
+end
+
+-- Reused for every call, the result is copied out right away.
+local point = ffi.new("float[2]")
+
+local transformPoint_C = Transform.transformPoint
+
+function Transform:transformPoint(x, y)
+	if type(self) == "userdata" and type(x) == "number" and type(y) == "number" then
+		if ffifuncs.transformPoint(self, x, y, point) then
+			return tonumber(point[0]), tonumber(point[1])
+		end
+	end
+	return transformPoint_C(self, x, y)
+end
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
@@ -0,0 +1,259 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_Vec2Array.h"
+
+// C++
+#include <algorithm>
+#include <vector>
+
+namespace love
+{
+namespace math
+{
+
+Vec2Array *luax_checkvec2array(lua_State *L, int idx)
+{
+	return luax_checktype<Vec2Array>(L, idx);
+}
+
+static int luax_checkindex(lua_State *L, Vec2Array *a, int idx)
+{
+	int index = (int) luaL_checkinteger(L, idx) - 1;
+	if (index < 0 || index >= a->getCount())
+		luaL_error(L, "Invalid Vec2Array index: %d", index + 1);
+	return index;
+}
+
+int w_Vec2Array_getData(lua_State *L)
+{
+	Vec2Array *a = luax_checkvec2array(L, 1);
+	luax_pushtype(L, a->getData());
+	return 1;
+}
+
+int w_Vec2Array_getCount(lua_State *L)
+{
+	Vec2Array *a = luax_checkvec2array(L, 1);
+	lua_pushinteger(L, a->getCount());
+	return 1;
+}
+
+int w_Vec2Array_getLayout(lua_State *L)
+{
+	Vec2Array *a = luax_checkvec2array(L, 1);
+	lua_pushinteger(L, (lua_Integer) a->getStride());
+	lua_pushinteger(L, (lua_Integer) a->getOffset());
+	return 2;
+}
+
+int w_Vec2Array_get(lua_State *L)
+{
+	Vec2Array *a = luax_checkvec2array(L, 1);
+	int index = luax_checkindex(L, a, 2);
+
+	float x, y;
+	a->get(index, x, y);
+
+	lua_pushnumber(L, x);
+	lua_pushnumber(L, y);
+	return 2;
+}
+
+int w_Vec2Array_set(lua_State *L)
+{
+	Vec2Array *a = luax_checkvec2array(L, 1);
+	int index = luax_checkindex(L, a, 2);
+	float x = (float) luaL_checknumber(L, 3);
+	float y = (float) luaL_checknumber(L, 4);
+	a->set(index, x, y);
+	return 0;
+}
+
+int w_Vec2Array_fill(lua_State *L)
+{
+	Vec2Array *a = luax_checkvec2array(L, 1);
+	float x = (float) luaL_checknumber(L, 2);
+	float y = (float) luaL_optnumber(L, 3, x);
+	a->fill(x, y);
+	return 0;
+}
+
+int w_Vec2Array_axpy(lua_State *L)
+{
+	Vec2Array *a = luax_checkvec2array(L, 1);
+	Vec2Array *x = luax_checkvec2array(L, 2);
+	float s = (float) luaL_checknumber(L, 3);
+	luax_catchexcept(L, [&](){ a->axpy(x, s); });
+	return 0;
+}
+
+int w_Vec2Array_add(lua_State *L)
+{
+	Vec2Array *a = luax_checkvec2array(L, 1);
+
+	if (lua_isnumber(L, 2))
+	{
+		float x = (float) luaL_checknumber(L, 2);
+		float y = (float) luaL_checknumber(L, 3);
+		a->add(x, y);
+	}
+	else
+	{
+		Vec2Array *x = luax_checkvec2array(L, 2);
+		luax_catchexcept(L, [&](){ a->add(x); });
+	}
+
+	return 0;
+}
+
+int w_Vec2Array_scale(lua_State *L)
+{
+	Vec2Array *a = luax_checkvec2array(L, 1);
+	float sx = (float) luaL_checknumber(L, 2);
+	float sy = (float) luaL_optnumber(L, 3, sx);
+	a->scale(sx, sy);
+	return 0;
+}
+
+int w_Vec2Array_clamp(lua_State *L)
+{
+	Vec2Array *a = luax_checkvec2array(L, 1);
+	float minx = (float) luaL_checknumber(L, 2);
+	float miny = (float) luaL_checknumber(L, 3);
+	float maxx = (float) luaL_checknumber(L, 4);
+	float maxy = (float) luaL_checknumber(L, 5);
+	a->clamp(minx, miny, maxx, maxy);
+	return 0;
+}
+
+int w_Vec2Array_normalize(lua_State *L)
+{
+	Vec2Array *a = luax_checkvec2array(L, 1);
+	a->normalize();
+	return 0;
+}
+
+int w_Vec2Array_getLengths(lua_State *L)
+{
+	Vec2Array *a = luax_checkvec2array(L, 1);
+	int count = a->getCount();
+
+	// Lengths go straight into a Data of packed floats, if one is given.
+	if (luax_istype(L, 2, Data::type))
+	{
+		Data *data = luax_checktype<Data>(L, 2);
+		if (data->getSize() < sizeof(float) * (size_t) count)
+			return luaL_error(L, "Data is too small to hold %d lengths.", count);
+
+		a->getLengths((float *) data->getData());
+		lua_pushvalue(L, 2);
+		return 1;
+	}
+
+	std::vector<float> lengths(count);
+	a->getLengths(lengths.data());
+
+	if (lua_istable(L, 2))
+		lua_pushvalue(L, 2);
+	else
+		lua_createtable(L, count, 0);
+
+	for (int i = 0; i < count; i++)
+	{
+		lua_pushnumber(L, lengths[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
+int w_Vec2Array_findPairs(lua_State *L)
+{
+	Vec2Array *a = luax_checkvec2array(L, 1);
+	float distance = (float) luaL_checknumber(L, 2);
+
+	Vec2Array *other = a;
+	int tableidx = 3;
+
+	if (luax_istype(L, 3, Vec2Array::type))
+	{
+		other = luax_checkvec2array(L, 3);
+		tableidx = 4;
+	}
+
+	std::vector<Vec2Array::Pair> pairs;
+	a->findPairs(other, distance, pairs);
+
+	// Pairs are returned as a flat {a1, b1, a2, b2, ...} list of indices,
+	// reusing the given table if there is one.
+	int oldlength = 0;
+
+	if (lua_istable(L, tableidx))
+	{
+		oldlength = (int) luax_objlen(L, tableidx);
+		lua_pushvalue(L, tableidx);
+	}
+	else
+		lua_createtable(L, (int) pairs.size() * 2, 0);
+
+	for (size_t i = 0; i < pairs.size(); i++)
+	{
+		lua_pushinteger(L, pairs[i].a + 1);
+		lua_rawseti(L, -2, (int) i * 2 + 1);
+		lua_pushinteger(L, pairs[i].b + 1);
+		lua_rawseti(L, -2, (int) i * 2 + 2);
+	}
+
+	for (int i = oldlength; i > (int) pairs.size() * 2; i--)
+	{
+		lua_pushnil(L);
+		lua_rawseti(L, -2, i);
+	}
+
+	lua_pushinteger(L, (lua_Integer) pairs.size());
+	return 2;
+}
+
+static const luaL_Reg w_Vec2Array_functions[] =
+{
+	{ "getData", w_Vec2Array_getData },
+	{ "getCount", w_Vec2Array_getCount },
+	{ "getLayout", w_Vec2Array_getLayout },
+	{ "get", w_Vec2Array_get },
+	{ "set", w_Vec2Array_set },
+	{ "fill", w_Vec2Array_fill },
+	{ "axpy", w_Vec2Array_axpy },
+	{ "add", w_Vec2Array_add },
+	{ "scale", w_Vec2Array_scale },
+	{ "clamp", w_Vec2Array_clamp },
+	{ "normalize", w_Vec2Array_normalize },
+	{ "getLengths", w_Vec2Array_getLengths },
+	{ "findPairs", w_Vec2Array_findPairs },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_vec2array(lua_State *L)
+{
+	return luax_register_type(L, &Vec2Array::type, w_Vec2Array_functions, nullptr);
+}
+
+} // math
+} // love
@@ -41,28 +41,41 @@ namespace box2d
 Body::Body(World *world, b2Vec2 p, Body::Type type)
 	: world(world)
 	, udata(nullptr)
+	, previousAngle(0.0f)
+	, hasPreviousTransform(false)
 {
+	// Physics objects stay on the thread running the World.
+	confineToThread();
 	udata = new bodyudata();
 	udata->ref = nullptr;
 	b2BodyDef def;
 	def.position = Physics::scaleDown(p);
 	def.userData = (void *) udata;
 	body = world->world->CreateBody(&def);
+	udata->body = this;
+	setNativeMemorySize(Body::type, sizeof(b2Body) + sizeof(bodyudata));
 	// Box2D body holds a reference to the love Body.
 	this->retain();
 	this->setType(type);
-	Memoizer::add(body, this);
 }
 
 Body::Body(b2Body *b)
 	: body(b)
 	, udata(nullptr)
+	, previousAngle(0.0f)
+	, hasPreviousTransform(false)
 {
+	confineToThread();
 	udata = (bodyudata *) b->GetUserData();
+	if (udata == nullptr)
+	{
+		udata = new bodyudata();
+		b->SetUserData((void *) udata);
+	}
+	udata->body = this;
 	world = (World *) Memoizer::find(b->GetWorld());
 	// Box2D body holds a reference to the love Body.
 	this->retain();
-	Memoizer::add(body, this);
 }
 
 Body::~Body()
@@ -76,38 +89,74 @@ Body::~Body()
 	delete udata;
 }
 
+Body *Body::fromBox2D(b2Body *b)
+{
+	bodyudata *data = (bodyudata *) b->GetUserData();
+	return data != nullptr ? data->body : nullptr;
+}
+
+Body::State Body::getState() const
+{
+	if (world != nullptr && world->isStepping())
+		return savedState;
+
+	State state;
+	state.transform = body->GetTransform();
+	state.angle = body->GetAngle();
+	state.worldCenter = body->GetWorldCenter();
+	state.linearVelocity = body->GetLinearVelocity();
+	state.angularVelocity = body->GetAngularVelocity();
+	state.awake = body->IsAwake();
+	return state;
+}
+
+void Body::resetPreviousTransform()
+{
+	hasPreviousTransform = false;
+}
+
+void Body::saveState()
+{
+	savedState.transform = body->GetTransform();
+	savedState.angle = body->GetAngle();
+	savedState.worldCenter = body->GetWorldCenter();
+	savedState.linearVelocity = body->GetLinearVelocity();
+	savedState.angularVelocity = body->GetAngularVelocity();
+	savedState.awake = body->IsAwake();
+}
+
 float Body::getX()
 {
-	return Physics::scaleUp(body->GetPosition().x);
+	return Physics::scaleUp(getState().transform.p.x);
 }
 
 float Body::getY()
 {
-	return Physics::scaleUp(body->GetPosition().y);
+	return Physics::scaleUp(getState().transform.p.y);
 }
 
 void Body::getPosition(float &x_o, float &y_o)
 {
-	b2Vec2 v = Physics::scaleUp(body->GetPosition());
+	b2Vec2 v = Physics::scaleUp(getState().transform.p);
 	x_o = v.x;
 	y_o = v.y;
 }
 
 void Body::getLinearVelocity(float &x_o, float &y_o)
 {
-	b2Vec2 v = Physics::scaleUp(body->GetLinearVelocity());
+	b2Vec2 v = Physics::scaleUp(getState().linearVelocity);
 	x_o = v.x;
 	y_o = v.y;
 }
 
 float Body::getAngle()
 {
-	return body->GetAngle();
+	return getState().angle;
 }
 
 void Body::getWorldCenter(float &x_o, float &y_o)
 {
-	b2Vec2 v = Physics::scaleUp(body->GetWorldCenter());
+	b2Vec2 v = Physics::scaleUp(getState().worldCenter);
 	x_o = v.x;
 	y_o = v.y;
 }
@@ -121,7 +170,7 @@ void Body::getLocalCenter(float &x_o, float &y_o)
 
 float Body::getAngularVelocity() const
 {
-	return body->GetAngularVelocity();
+	return getState().angularVelocity;
 }
 
 float Body::getMass() const
@@ -214,11 +263,13 @@ void Body::applyForce(float fx, float fy, bool wake)
 
 void Body::setX(float x)
 {
+	resetPreviousTransform();
 	body->SetTransform(Physics::scaleDown(b2Vec2(x, getY())), getAngle());
 }
 
 void Body::setY(float y)
 {
+	resetPreviousTransform();
 	body->SetTransform(Physics::scaleDown(b2Vec2(getX(), y)), getAngle());
 }
 
@@ -229,6 +280,7 @@ void Body::setLinearVelocity(float x, float y)
 
 void Body::setAngle(float d)
 {
+	resetPreviousTransform();
 	body->SetTransform(body->GetPosition(), d);
 }
 
@@ -239,6 +291,7 @@ void Body::setAngularVelocity(float r)
 
 void Body::setPosition(float x, float y)
 {
+	resetPreviousTransform();
 	body->SetTransform(Physics::scaleDown(b2Vec2(x, y)), body->GetAngle());
 }
 
@@ -308,14 +361,14 @@ void Body::setType(Body::Type type)
 
 void Body::getWorldPoint(float x, float y, float &x_o, float &y_o)
 {
-	b2Vec2 v = Physics::scaleUp(body->GetWorldPoint(Physics::scaleDown(b2Vec2(x, y))));
+	b2Vec2 v = Physics::scaleUp(b2Mul(getState().transform, Physics::scaleDown(b2Vec2(x, y))));
 	x_o = v.x;
 	y_o = v.y;
 }
 
 void Body::getWorldVector(float x, float y, float &x_o, float &y_o)
 {
-	b2Vec2 v = Physics::scaleUp(body->GetWorldVector(Physics::scaleDown(b2Vec2(x, y))));
+	b2Vec2 v = Physics::scaleUp(b2Mul(getState().transform.q, Physics::scaleDown(b2Vec2(x, y))));
 	x_o = v.x;
 	y_o = v.y;
 }
@@ -327,6 +380,8 @@ int Body::getWorldPoints(lua_State *L)
 	// at least one point
 	love::luax_assert_argc(L, 2);
 
+	b2Transform transform = getState().transform;
+
 	for (int i = 0; i<vcount; i++)
 	{
 		float x = (float)lua_tonumber(L, 1);
@@ -335,7 +390,7 @@ int Body::getWorldPoints(lua_State *L)
 		lua_remove(L, 1);
 		lua_remove(L, 1);
 		// Time for scaling
-		b2Vec2 point = Physics::scaleUp(body->GetWorldPoint(Physics::scaleDown(b2Vec2(x, y))));
+		b2Vec2 point = Physics::scaleUp(b2Mul(transform, Physics::scaleDown(b2Vec2(x, y))));
 		// And then we push the result
 		lua_pushnumber(L, point.x);
 		lua_pushnumber(L, point.y);
@@ -346,14 +401,14 @@ int Body::getWorldPoints(lua_State *L)
 
 void Body::getLocalPoint(float x, float y, float &x_o, float &y_o)
 {
-	b2Vec2 v = Physics::scaleUp(body->GetLocalPoint(Physics::scaleDown(b2Vec2(x, y))));
+	b2Vec2 v = Physics::scaleUp(b2MulT(getState().transform, Physics::scaleDown(b2Vec2(x, y))));
 	x_o = v.x;
 	y_o = v.y;
 }
 
 void Body::getLocalVector(float x, float y, float &x_o, float &y_o)
 {
-	b2Vec2 v = Physics::scaleUp(body->GetLocalVector(Physics::scaleDown(b2Vec2(x, y))));
+	b2Vec2 v = Physics::scaleUp(b2MulT(getState().transform.q, Physics::scaleDown(b2Vec2(x, y))));
 	x_o = v.x;
 	y_o = v.y;
 }
@@ -452,9 +507,9 @@ int Body::getFixtures(lua_State *L) const
 	{
 		if (!f)
 			break;
-		Fixture *fixture = (Fixture *)Memoizer::find(f);
+		Fixture *fixture = Fixture::fromBox2D(f);
 		if (!fixture)
-			throw love::Exception("A fixture has escaped Memoizer!");
+			throw love::Exception("A fixture has no love Fixture!");
 		luax_pushtype(L, fixture);
 		lua_rawseti(L, -2, i);
 		i++;
@@ -474,9 +529,9 @@ int Body::getJoints(lua_State *L) const
 		if (!je)
 			break;
 
-		Joint *joint = (Joint *) Memoizer::find(je->joint);
+		Joint *joint = Joint::fromBox2D(je->joint);
 		if (!joint)
-			throw love::Exception("A joint has escaped Memoizer!");
+			throw love::Exception("A joint has no love Joint!");
 
 		luax_pushjoint(L, joint);
 		lua_rawseti(L, -2, i);
@@ -529,7 +584,7 @@ int Body::pushVector(lua_State *L, const b2Vec2 &v)
 
 void Body::destroy()
 {
-	if (world->world->IsLocked())
+	if (world->isLocked())
 	{
 		// Called during time step. Save reference for destruction afterwards.
 		this->retain();
@@ -538,7 +593,7 @@ void Body::destroy()
 	}
 
 	world->world->DestroyBody(body);
-	Memoizer::remove(body);
+	udata->body = nullptr;
 	body = NULL;
 
 	// Remove userdata reference to avoid it sticking around after GC
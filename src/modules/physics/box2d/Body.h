@@ -40,6 +40,7 @@ namespace box2d
 class World;
 class Shape;
 class Fixture;
+class Body;
 
 /**
  * This struct is stored in a void pointer in the Box2D Body class. For now, all
@@ -49,6 +50,9 @@ struct bodyudata
 {
 	// Reference to arbitrary data.
 	Reference *ref = nullptr;
+
+	// The love Body of the b2Body, found without a Memoizer lookup.
+	Body *body = nullptr;
 };
 
 /**
@@ -68,6 +72,7 @@ public:
 	friend class PolygonShape;
 	friend class Shape;
 	friend class Fixture;
+	friend class World;
 
 	// Public because joints et al ask for b2body
 	b2Body *body;
@@ -77,6 +82,11 @@ public:
 	 **/
 	Body(World *world, b2Vec2 p, Type type);
 
+	/**
+	 * Gets the love Body of a b2Body, or null if it doesn't have one.
+	 **/
+	static Body *fromBox2D(b2Body *b);
+
 	/**
 	 * Create a Body from an extant b2Body.
 	 **/
@@ -389,6 +399,12 @@ public:
 	 */
 	World *getWorld() const;
 
+	/**
+	 * Saves the position and velocity of the Body. The getters for those
+	 * report the saved values while the World steps asynchronously.
+	 **/
+	void saveState();
+
 	/**
 	 * Get an array of all the Fixtures attached to this Body.
 	 * @return An array of Fixtures.
@@ -426,6 +442,22 @@ public:
 
 private:
 
+	struct State
+	{
+		b2Transform transform;
+		float angle;
+		b2Vec2 worldCenter;
+		b2Vec2 linearVelocity;
+		float angularVelocity;
+		bool awake;
+	};
+
+	// The saved state while the World steps, the Box2D body's otherwise.
+	State getState() const;
+
+	// Moving the body directly shouldn't be smoothed by interpolation.
+	void resetPreviousTransform();
+
 	/**
 	 * Gets a 2d vector from the arguments on the stack.
 	 **/
@@ -443,6 +475,13 @@ private:
 
 	bodyudata *udata;
 
+	State savedState;
+
+	// The transform before the last fixed timestep, for interpolation.
+	b2Vec2 previousPosition;
+	float previousAngle;
+	bool hasPreviousTransform;
+
 }; // Body
 
 } // box2d
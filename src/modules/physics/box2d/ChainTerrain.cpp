@@ -0,0 +1,300 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "ChainTerrain.h"
+
+// Module
+#include "World.h"
+#include "common/Reference.h"
+
+// C++
+#include <algorithm>
+
+namespace love
+{
+namespace physics
+{
+namespace box2d
+{
+
+love::Type ChainTerrain::type("ChainTerrain", &Object::type);
+
+ChainTerrain::ChainTerrain(Body *body, const std::vector<b2Vec2> &vertices, int segmentSize)
+	: body(body)
+	, segmentSize(segmentSize)
+	, destroyed(false)
+	, vertices(vertices)
+{
+	if (segmentSize < 1)
+		throw love::Exception("ChainTerrain segment size must be at least 1.");
+
+	if (vertices.size() < 2)
+		throw love::Exception("A ChainTerrain needs at least 2 vertices.");
+
+	if (body->getWorld()->isLocked())
+		throw love::Exception("Can't create a ChainTerrain during a World update.");
+
+	split(0, (int) vertices.size(), segments);
+
+	std::vector<b2ChainShape> chains(segments.size());
+	for (size_t i = 0; i < segments.size(); i++)
+		makeChain(this->vertices, segments[i], chains[i]);
+
+	for (size_t i = 0; i < segments.size(); i++)
+		segments[i].fixture.set(createFixture(nullptr, chains[i], nullptr), Acquire::NORETAIN);
+}
+
+ChainTerrain::~ChainTerrain()
+{
+}
+
+void ChainTerrain::setVertices(lua_State *L, int index, int removeCount, const std::vector<b2Vec2> &verts)
+{
+	checkValid();
+
+	if (body->getWorld()->isLocked())
+		throw love::Exception("Can't edit a ChainTerrain during a World update.");
+
+	int count = (int) vertices.size();
+	int added = (int) verts.size();
+
+	if (index < 0 || index > count)
+		throw love::Exception("Vertex index out of range.");
+
+	if (removeCount < 0 || removeCount > count - index)
+		throw love::Exception("Invalid number of vertices to replace.");
+
+	if (count - removeCount + added < 2)
+		throw love::Exception("A ChainTerrain needs at least 2 vertices.");
+
+	if (removeCount == 0 && added == 0)
+		return;
+
+	// The edges touching the replaced vertices, or the edge vertices are
+	// inserted into. Edge i goes from vertex i to vertex i + 1.
+	int edgeLo = std::min(std::max(index - 1, 0), count - 2);
+	int edgeHi = std::min(std::max(index + removeCount - 1, edgeLo), count - 2);
+
+	auto findSegment = [this](int edge) -> int
+	{
+		auto it = std::upper_bound(segments.begin(), segments.end(), edge, [](int e, const Segment &s) { return e < s.first; });
+		return (int) (it - segments.begin()) - 1;
+	};
+
+	int first = findSegment(edgeLo);
+	int last = findSegment(edgeHi);
+
+	int spanFirst = segments[first].first;
+	int spanCount = segments[last].first + segments[last].count - spanFirst - removeCount + added;
+
+	// Merge with neighbouring segments if too few vertices would be left.
+	while (spanCount < 2)
+	{
+		if (first > 0)
+		{
+			first--;
+			spanCount += segments[first].count - 1;
+			spanFirst = segments[first].first;
+		}
+		else
+		{
+			last++;
+			spanCount += segments[last].count - 1;
+		}
+	}
+
+	std::vector<b2Vec2> edited;
+	edited.reserve(count - removeCount + added);
+	edited.insert(edited.end(), vertices.begin(), vertices.begin() + index);
+	edited.insert(edited.end(), verts.begin(), verts.end());
+	edited.insert(edited.end(), vertices.begin() + index + removeCount, vertices.end());
+
+	std::vector<Segment> replacements;
+	split(spanFirst, spanCount, replacements);
+
+	// Make every shape before changing anything, since invalid vertices
+	// throw.
+	std::vector<b2ChainShape> chains(replacements.size());
+	for (size_t i = 0; i < replacements.size(); i++)
+		makeChain(edited, replacements[i], chains[i]);
+
+	Fixture *model = segments[first].fixture.get();
+	for (size_t i = 0; i < replacements.size(); i++)
+		replacements[i].fixture.set(createFixture(L, chains[i], model), Acquire::NORETAIN);
+
+	for (int i = first; i <= last; i++)
+	{
+		if (segments[i].fixture->isValid())
+			segments[i].fixture->destroy();
+	}
+
+	int shift = added - removeCount;
+	for (int i = last + 1; i < (int) segments.size(); i++)
+		segments[i].first += shift;
+
+	segments.erase(segments.begin() + first, segments.begin() + last + 1);
+	segments.insert(segments.begin() + first, replacements.begin(), replacements.end());
+	vertices.swap(edited);
+
+	// The segments next to the edit only need new ghost vertices, which
+	// don't affect their broadphase proxies.
+	if (first > 0)
+	{
+		const Segment &prev = segments[first - 1];
+		b2ChainShape *chain = (b2ChainShape *) prev.fixture->fixture->GetShape();
+		chain->SetNextVertex(vertices[prev.first + prev.count]);
+	}
+
+	size_t after = first + replacements.size();
+	if (after < segments.size())
+	{
+		const Segment &next = segments[after];
+		b2ChainShape *chain = (b2ChainShape *) next.fixture->fixture->GetShape();
+		chain->SetPrevVertex(vertices[next.first - 1]);
+	}
+}
+
+const std::vector<b2Vec2> &ChainTerrain::getVertices() const
+{
+	return vertices;
+}
+
+int ChainTerrain::getSegmentSize() const
+{
+	return segmentSize;
+}
+
+int ChainTerrain::getSegmentCount() const
+{
+	return (int) segments.size();
+}
+
+Fixture *ChainTerrain::getSegmentFixture(int segment) const
+{
+	checkValid();
+
+	if (segment < 0 || segment >= (int) segments.size())
+		throw love::Exception("Invalid segment index: %d", segment + 1);
+
+	return segments[segment].fixture.get();
+}
+
+Body *ChainTerrain::getBody() const
+{
+	return body.get();
+}
+
+void ChainTerrain::destroy()
+{
+	if (destroyed)
+		return;
+
+	for (Segment &segment : segments)
+	{
+		if (segment.fixture->isValid())
+			segment.fixture->destroy();
+	}
+
+	segments.clear();
+	destroyed = true;
+}
+
+bool ChainTerrain::isDestroyed() const
+{
+	return destroyed;
+}
+
+void ChainTerrain::checkValid() const
+{
+	if (destroyed)
+		throw love::Exception("ChainTerrain has been destroyed.");
+
+	if (body->body == nullptr)
+		throw love::Exception("The ChainTerrain's Body has been destroyed.");
+}
+
+void ChainTerrain::split(int first, int count, std::vector<Segment> &out) const
+{
+	int edges = count - 1;
+	int segmentCount = std::max((edges + segmentSize - 1) / segmentSize, 1);
+
+	// Spread the edges evenly, so edits don't leave tiny segments behind.
+	int size = edges / segmentCount;
+	int remainder = edges % segmentCount;
+
+	for (int i = 0; i < segmentCount; i++)
+	{
+		Segment segment;
+		segment.first = first;
+		segment.count = size + (i < remainder ? 1 : 0) + 1;
+		out.push_back(segment);
+
+		first += segment.count - 1;
+	}
+}
+
+void ChainTerrain::makeChain(const std::vector<b2Vec2> &verts, const Segment &segment, b2ChainShape &chain) const
+{
+	chain.CreateChain(&verts[segment.first], segment.count);
+
+	if (segment.first > 0)
+		chain.SetPrevVertex(verts[segment.first - 1]);
+
+	if (segment.first + segment.count < (int) verts.size())
+		chain.SetNextVertex(verts[segment.first + segment.count]);
+}
+
+Fixture *ChainTerrain::createFixture(lua_State *L, const b2ChainShape &chain, Fixture *model)
+{
+	fixtureudata *udata = new fixtureudata();
+
+	b2FixtureDef def;
+	def.shape = &chain;
+	def.userData = (void *) udata;
+	def.density = 0.0f;
+
+	if (model != nullptr && model->fixture != nullptr)
+	{
+		const b2Fixture *f = model->fixture;
+		def.friction = f->GetFriction();
+		def.restitution = f->GetRestitution();
+		def.density = f->GetDensity();
+		def.isSensor = f->IsSensor();
+		def.filter = f->GetFilterData();
+
+		if (model->udata != nullptr)
+		{
+			udata->reportContacts = model->udata->reportContacts;
+
+			if (L != nullptr && model->udata->ref != nullptr)
+			{
+				model->udata->ref->push(L);
+				udata->ref = new Reference(L);
+			}
+		}
+	}
+
+	b2Fixture *fixture = body->body->CreateFixture(&def);
+	return new Fixture(fixture);
+}
+
+} // box2d
+} // physics
+} // love
@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_PHYSICS_BOX2D_CHAIN_TERRAIN_H
+#define LOVE_PHYSICS_BOX2D_CHAIN_TERRAIN_H
+
+// LOVE
+#include "common/Object.h"
+#include "common/runtime.h"
+#include "Body.h"
+#include "Fixture.h"
+
+// C++
+#include <vector>
+
+// Box2D
+#include <Box2D/Box2D.h>
+
+namespace love
+{
+namespace physics
+{
+namespace box2d
+{
+
+/**
+ * An open chain of edges attached to a Body, split into segments which each
+ * have their own chain Fixture. Editing vertices only recreates the Fixtures
+ * (and broadphase proxies) of the segments around the edit, so the chain can
+ * change often, like destructible terrain.
+ **/
+class ChainTerrain : public Object
+{
+public:
+
+	static love::Type type;
+
+	/**
+	 * @param body The Body the segment Fixtures are attached to.
+	 * @param vertices The vertices of the chain, in meters.
+	 * @param segmentSize The number of edges in each segment.
+	 **/
+	ChainTerrain(Body *body, const std::vector<b2Vec2> &vertices, int segmentSize);
+	virtual ~ChainTerrain();
+
+	/**
+	 * Replaces removeCount vertices starting at index with new ones. Only
+	 * the segments around the edit are recreated; their new Fixtures copy
+	 * the properties and user data of the first Fixture they replace.
+	 * @param index The 0-based index of the first vertex to replace.
+	 * @param vertices The new vertices, in meters.
+	 **/
+	void setVertices(lua_State *L, int index, int removeCount, const std::vector<b2Vec2> &vertices);
+
+	const std::vector<b2Vec2> &getVertices() const;
+
+	int getSegmentSize() const;
+	int getSegmentCount() const;
+
+	/**
+	 * Gets the Fixture of a segment, in order along the chain.
+	 **/
+	Fixture *getSegmentFixture(int segment) const;
+
+	Body *getBody() const;
+
+	/**
+	 * Destroys the Fixtures of all segments.
+	 **/
+	void destroy();
+	bool isDestroyed() const;
+
+private:
+
+	struct Segment
+	{
+		// Index of the first vertex. The last vertex is shared with the
+		// next segment.
+		int first;
+		int count;
+		StrongRef<Fixture> fixture;
+	};
+
+	void checkValid() const;
+
+	// Splits the vertices [first, first + count) of verts into segments.
+	void split(int first, int count, std::vector<Segment> &out) const;
+
+	// Makes the chain shape of a segment of verts, with its ghost vertices.
+	void makeChain(const std::vector<b2Vec2> &verts, const Segment &segment, b2ChainShape &chain) const;
+
+	Fixture *createFixture(lua_State *L, const b2ChainShape &chain, Fixture *model);
+
+	StrongRef<Body> body;
+	int segmentSize;
+	bool destroyed;
+
+	std::vector<b2Vec2> vertices;
+	std::vector<Segment> segments;
+
+}; // ChainTerrain
+
+} // box2d
+} // physics
+} // love
+
+#endif // LOVE_PHYSICS_BOX2D_CHAIN_TERRAIN_H
@@ -36,7 +36,9 @@ love::Type Contact::type("Contact", &Object::type);
 Contact::Contact(b2Contact *contact)
 	: contact(contact)
 {
-	Memoizer::add(contact, this);
+	confineToThread();
+	if (contact != NULL)
+		Memoizer::add(contact, this);
 }
 
 Contact::~Contact()
@@ -146,11 +148,11 @@ void Contact::getChildren(int &childA, int &childB)
 
 void Contact::getFixtures(Fixture *&fixtureA, Fixture *&fixtureB)
 {
-	fixtureA = (Fixture *) Memoizer::find(contact->GetFixtureA());
-	fixtureB = (Fixture *) Memoizer::find(contact->GetFixtureB());
+	fixtureA = Fixture::fromBox2D(contact->GetFixtureA());
+	fixtureB = Fixture::fromBox2D(contact->GetFixtureB());
 
 	if (!fixtureA || !fixtureB)
-		throw love::Exception("A fixture has escaped Memoizer!");
+		throw love::Exception("A fixture has no love Fixture!");
 }
 
 } // box2d
@@ -0,0 +1,230 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "DebugDraw.h"
+#include "Physics.h"
+#include "common/math.h"
+#include "graphics/Graphics.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace love
+{
+namespace physics
+{
+namespace box2d
+{
+
+// Stream draws are split into batches of this many vertices, so a busy World
+// doesn't grow the stream buffers much beyond their usual size.
+static const int MAX_BATCH_VERTICES = 3 * 8192;
+
+static Vector2 scaleUp(const b2Vec2 &v)
+{
+	b2Vec2 s = Physics::scaleUp(v);
+	return Vector2(s.x, s.y);
+}
+
+DebugDraw::DebugDraw()
+	: tint(1.0f, 1.0f, 1.0f, 1.0f)
+	, halfLineWidth(0.5f)
+	, pixelSize(1.0f)
+{
+}
+
+void DebugDraw::begin(graphics::Graphics *gfx)
+{
+	positions.clear();
+	colors.clear();
+
+	float sx = 1.0f, sy = 1.0f;
+	gfx->getTransform().getApproximateScale(sx, sy);
+
+	pixelSize = 1.0f / std::max((sx + sy) * 0.5f, 0.000001f);
+	halfLineWidth = gfx->getLineWidth() * 0.5f * pixelSize;
+	tint = gfx->getColor();
+}
+
+void DebugDraw::end(graphics::Graphics *gfx)
+{
+	using namespace graphics;
+
+	const Matrix4 &t = gfx->getTransform();
+	bool is2D = t.isAffine2DTransform();
+
+	int total = (int) positions.size();
+
+	for (int start = 0; start < total; start += MAX_BATCH_VERTICES)
+	{
+		Graphics::StreamDrawCommand cmd;
+		cmd.formats[0] = vertex::getSinglePositionFormat(is2D);
+		cmd.formats[1] = vertex::CommonFormat::RGBAub;
+		cmd.vertexCount = std::min(total - start, MAX_BATCH_VERTICES);
+
+		Graphics::StreamVertexData data = gfx->requestStreamDraw(cmd);
+
+		if (is2D)
+			t.transformXY((Vector2 *) data.stream[0], &positions[start], cmd.vertexCount);
+		else
+			t.transformXY0((Vector3 *) data.stream[0], &positions[start], cmd.vertexCount);
+
+		memcpy(data.stream[1], &colors[start], sizeof(Color) * cmd.vertexCount);
+	}
+
+	positions.clear();
+	colors.clear();
+}
+
+Color DebugDraw::toColor(const b2Color &color, float alpha) const
+{
+	Colorf c(color.r * tint.r, color.g * tint.g, color.b * tint.b, color.a * alpha * tint.a);
+	return love::toColor(c);
+}
+
+void DebugDraw::addTriangle(const Vector2 &a, const Vector2 &b, const Vector2 &c, Color color)
+{
+	positions.push_back(a);
+	positions.push_back(b);
+	positions.push_back(c);
+
+	colors.insert(colors.end(), 3, color);
+}
+
+void DebugDraw::addLine(const Vector2 &a, const Vector2 &b, Color color)
+{
+	Vector2 d = b - a;
+	float len = d.getLength();
+
+	if (len == 0.0f)
+		return;
+
+	Vector2 n = d.getNormal(halfLineWidth / len);
+
+	addTriangle(a + n, a - n, b + n, color);
+	addTriangle(b + n, a - n, b - n, color);
+}
+
+int DebugDraw::getCirclePoints(float radius) const
+{
+	// Same heuristic as love.graphics.circle.
+	int points = (int) sqrtf(radius * 20.0f / pixelSize);
+	return std::min(std::max(points, 8), 64);
+}
+
+void DebugDraw::DrawPolygon(const b2Vec2 *vertices, int32 vertexCount, const b2Color &color)
+{
+	Color c = toColor(color);
+
+	Vector2 prev = scaleUp(vertices[vertexCount - 1]);
+	for (int32 i = 0; i < vertexCount; i++)
+	{
+		Vector2 v = scaleUp(vertices[i]);
+		addLine(prev, v, c);
+		prev = v;
+	}
+}
+
+void DebugDraw::DrawSolidPolygon(const b2Vec2 *vertices, int32 vertexCount, const b2Color &color)
+{
+	// Box2D polygons are always convex, so a fan covers them.
+	Color fill = toColor(color, 0.5f);
+	Vector2 first = scaleUp(vertices[0]);
+
+	for (int32 i = 1; i < vertexCount - 1; i++)
+		addTriangle(first, scaleUp(vertices[i]), scaleUp(vertices[i + 1]), fill);
+
+	DrawPolygon(vertices, vertexCount, color);
+}
+
+void DebugDraw::DrawCircle(const b2Vec2 &center, float32 radius, const b2Color &color)
+{
+	Color c = toColor(color);
+	Vector2 p = scaleUp(center);
+	float r = Physics::scaleUp(radius);
+
+	int points = getCirclePoints(r);
+	float step = LOVE_M_TORAD * 360.0f / points;
+
+	Vector2 prev(p.x + r, p.y);
+	for (int i = 1; i <= points; i++)
+	{
+		Vector2 v(p.x + r * cosf(step * i), p.y + r * sinf(step * i));
+		addLine(prev, v, c);
+		prev = v;
+	}
+}
+
+void DebugDraw::DrawSolidCircle(const b2Vec2 &center, float32 radius, const b2Vec2 &axis, const b2Color &color)
+{
+	Color fill = toColor(color, 0.5f);
+	Vector2 p = scaleUp(center);
+	float r = Physics::scaleUp(radius);
+
+	int points = getCirclePoints(r);
+	float step = LOVE_M_TORAD * 360.0f / points;
+
+	Vector2 prev(p.x + r, p.y);
+	for (int i = 1; i <= points; i++)
+	{
+		Vector2 v(p.x + r * cosf(step * i), p.y + r * sinf(step * i));
+		addTriangle(p, prev, v, fill);
+		prev = v;
+	}
+
+	DrawCircle(center, radius, color);
+
+	// The axis shows the rotation of the circle.
+	addLine(p, Vector2(p.x + r * axis.x, p.y + r * axis.y), toColor(color));
+}
+
+void DebugDraw::DrawSegment(const b2Vec2 &p1, const b2Vec2 &p2, const b2Color &color)
+{
+	addLine(scaleUp(p1), scaleUp(p2), toColor(color));
+}
+
+void DebugDraw::DrawTransform(const b2Transform &xf)
+{
+	// The same length as in the Box2D testbed.
+	const float32 axisScale = 0.4f;
+
+	b2Vec2 p = xf.p;
+	DrawSegment(p, p + axisScale * xf.q.GetXAxis(), b2Color(1.0f, 0.0f, 0.0f));
+	DrawSegment(p, p + axisScale * xf.q.GetYAxis(), b2Color(0.0f, 1.0f, 0.0f));
+}
+
+void DebugDraw::DrawPoint(const b2Vec2 &p, float32 size, const b2Color &color)
+{
+	Color c = toColor(color);
+	Vector2 v = scaleUp(p);
+	float h = size * 0.5f * pixelSize;
+
+	Vector2 tl(v.x - h, v.y - h), tr(v.x + h, v.y - h);
+	Vector2 bl(v.x - h, v.y + h), br(v.x + h, v.y + h);
+
+	addTriangle(tl, bl, tr, c);
+	addTriangle(tr, bl, br, c);
+}
+
+} // box2d
+} // physics
+} // love
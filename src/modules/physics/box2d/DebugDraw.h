@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_PHYSICS_BOX2D_DEBUG_DRAW_H
+#define LOVE_PHYSICS_BOX2D_DEBUG_DRAW_H
+
+// LOVE
+#include "common/Color.h"
+#include "common/Vector.h"
+
+// C++
+#include <vector>
+
+// Box2D
+#include <Box2D/Box2D.h>
+
+namespace love
+{
+namespace graphics
+{
+class Graphics;
+}
+
+namespace physics
+{
+namespace box2d
+{
+
+/**
+ * Collects the debug geometry Box2D emits for a World as colored triangles,
+ * in love units, and submits them to Graphics in as few stream draws as
+ * possible. Outlines are drawn as quads with the current line width.
+ **/
+class DebugDraw : public b2Draw
+{
+public:
+
+	DebugDraw();
+	virtual ~DebugDraw() {}
+
+	/**
+	 * Prepares for a new batch, using the current color, line width and
+	 * transform of the given Graphics.
+	 **/
+	void begin(graphics::Graphics *gfx);
+
+	/**
+	 * Draws everything added since begin, and clears the batch.
+	 **/
+	void end(graphics::Graphics *gfx);
+
+	void DrawPolygon(const b2Vec2 *vertices, int32 vertexCount, const b2Color &color) override;
+	void DrawSolidPolygon(const b2Vec2 *vertices, int32 vertexCount, const b2Color &color) override;
+	void DrawCircle(const b2Vec2 &center, float32 radius, const b2Color &color) override;
+	void DrawSolidCircle(const b2Vec2 &center, float32 radius, const b2Vec2 &axis, const b2Color &color) override;
+	void DrawSegment(const b2Vec2 &p1, const b2Vec2 &p2, const b2Color &color) override;
+	void DrawTransform(const b2Transform &xf) override;
+
+	/**
+	 * Draws a square point which is a fixed number of pixels wide.
+	 **/
+	void DrawPoint(const b2Vec2 &p, float32 size, const b2Color &color);
+
+private:
+
+	Color toColor(const b2Color &color, float alpha = 1.0f) const;
+
+	// The arguments are in love units.
+	void addTriangle(const Vector2 &a, const Vector2 &b, const Vector2 &c, Color color);
+	void addLine(const Vector2 &a, const Vector2 &b, Color color);
+
+	// Returns the number of points, in love units.
+	int getCirclePoints(float radius) const;
+
+	// Triangle list vertices, in love units.
+	std::vector<Vector2> positions;
+	std::vector<Color> colors;
+
+	// The color set in Graphics, which tints everything.
+	Colorf tint;
+
+	// Half of the line width and the size of a pixel, in love units.
+	float halfLineWidth;
+	float pixelSize;
+
+}; // DebugDraw
+
+} // box2d
+} // physics
+} // love
+
+#endif // LOVE_PHYSICS_BOX2D_DEBUG_DRAW_H
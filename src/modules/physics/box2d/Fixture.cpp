@@ -25,7 +25,6 @@
 #include "World.h"
 #include "Physics.h"
 
-#include "common/Memoizer.h"
 
 // STD
 #include <bitset>
@@ -43,6 +42,7 @@ Fixture::Fixture(Body *body, Shape *shape, float density)
 	: body(body)
 	, fixture(nullptr)
 {
+	confineToThread();
 	udata = new fixtureudata();
 	udata->ref = nullptr;
 	b2FixtureDef def;
@@ -50,19 +50,26 @@ Fixture::Fixture(Body *body, Shape *shape, float density)
 	def.userData = (void *)udata;
 	def.density = density;
 	fixture = body->body->CreateFixture(&def);
+	udata->fixture = this;
+	setNativeMemorySize(type, sizeof(b2Fixture) + sizeof(fixtureudata));
 	this->retain();
-	Memoizer::add(fixture, this);
 }
 
 Fixture::Fixture(b2Fixture *f)
 	: fixture(f)
 {
+	confineToThread();
 	udata = (fixtureudata *)f->GetUserData();
-	body = (Body *)Memoizer::find(f->GetBody());
+	if (udata == nullptr)
+	{
+		udata = new fixtureudata();
+		f->SetUserData((void *) udata);
+	}
+	udata->fixture = this;
+	body = Body::fromBox2D(f->GetBody());
 	if (!body)
 		body = new Body(f->GetBody());
 	this->retain();
-	Memoizer::add(fixture, this);
 }
 
 Fixture::~Fixture()
@@ -76,6 +83,12 @@ Fixture::~Fixture()
 	delete udata;
 }
 
+Fixture *Fixture::fromBox2D(b2Fixture *f)
+{
+	fixtureudata *data = (fixtureudata *) f->GetUserData();
+	return data != nullptr ? data->fixture : nullptr;
+}
+
 void Fixture::checkCreateShape()
 {
 	if (shape.get() != nullptr || fixture == nullptr || fixture->GetShape() == nullptr)
@@ -151,6 +164,22 @@ bool Fixture::isSensor() const
 	return fixture->IsSensor();
 }
 
+void Fixture::setContactReported(bool reported)
+{
+	if (udata == nullptr)
+	{
+		udata = new fixtureudata();
+		fixture->SetUserData((void *) udata);
+	}
+
+	udata->reportContacts = reported;
+}
+
+bool Fixture::isContactReported() const
+{
+	return udata == nullptr || udata->reportContacts;
+}
+
 Body *Fixture::getBody() const
 {
 	return body;
@@ -349,7 +378,7 @@ int Fixture::getMassData(lua_State *L) const
 
 void Fixture::destroy(bool implicit)
 {
-	if (body->world->world->IsLocked())
+	if (body->world->isLocked())
 	{
 		// Called during time step. Save reference for destruction afterwards.
 		this->retain();
@@ -359,9 +388,11 @@ void Fixture::destroy(bool implicit)
 
 	shape.set(nullptr);
 
+	body->world->removeContactEvents(fixture);
+
 	if (!implicit && fixture != nullptr)
 		body->body->DestroyFixture(fixture);
-	Memoizer::remove(fixture);
+	udata->fixture = nullptr;
 	fixture = nullptr;
 
 	// Remove userdata reference to avoid it sticking around after GC
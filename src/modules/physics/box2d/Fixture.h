@@ -44,10 +44,18 @@ namespace box2d
  * need is a Lua reference to arbitrary data,
  * but we might need more later.
  **/
+class Fixture;
+
 struct fixtureudata
 {
 	// Reference to arbitrary data.
 	Reference *ref = nullptr;
+
+	// The love Fixture of the b2Fixture, found without a Memoizer lookup.
+	Fixture *fixture = nullptr;
+
+	// Whether buffered contact events involving the fixture are recorded.
+	bool reportContacts = true;
 };
 
 /**
@@ -60,6 +68,7 @@ class Fixture : public Object
 {
 public:
 	friend class Physics;
+	friend class ChainTerrain;
 
 	static love::Type type;
 
@@ -75,6 +84,11 @@ public:
 
 	virtual ~Fixture();
 
+	/**
+	 * Gets the love Fixture of a b2Fixture, or null if it doesn't have one.
+	 **/
+	static Fixture *fromBox2D(b2Fixture *f);
+
 	/**
 	 * Gets the type of the Fixture's Shape. Useful for
 	 * debug drawing.
@@ -103,6 +117,14 @@ public:
 	 **/
 	void setSensor(bool sensor);
 
+	/**
+	 * Sets whether contact events involving this Fixture are recorded when
+	 * the World buffers its contact events. Events between two Fixtures
+	 * which both don't report contacts are skipped.
+	 **/
+	void setContactReported(bool reported);
+	bool isContactReported() const;
+
 	/**
 	 * Gets the Body this Fixture is attached to.
 	 **/
@@ -23,7 +23,6 @@
 // Module
 #include "Body.h"
 #include "World.h"
-#include "common/Memoizer.h"
 
 namespace love
 {
@@ -69,9 +68,9 @@ Joint *GearJoint::getJointA() const
 	if (b2joint == nullptr)
 		return nullptr;
 
-	Joint *j = (Joint *) Memoizer::find(b2joint);
+	Joint *j = Joint::fromBox2D(b2joint);
 	if (j == nullptr)
-		throw love::Exception("A joint has escaped Memoizer!");
+		throw love::Exception("A joint has no love Joint!");
 
 	return j;
 }
@@ -82,9 +81,9 @@ Joint *GearJoint::getJointB() const
 	if (b2joint == nullptr)
 		return nullptr;
 
-	Joint *j = (Joint *) Memoizer::find(b2joint);
+	Joint *j = Joint::fromBox2D(b2joint);
 	if (j == nullptr)
-		throw love::Exception("A joint has escaped Memoizer!");
+		throw love::Exception("A joint has no love Joint!");
 
 	return j;
 }
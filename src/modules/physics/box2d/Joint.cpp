@@ -24,7 +24,6 @@
 #include <bitset>
 
 // LOVE
-#include "common/Memoizer.h"
 
 // Module
 #include "Body.h"
@@ -45,6 +44,7 @@ Joint::Joint(Body *body1)
 	, body1(body1)
 	, body2(nullptr)
 {
+	confineToThread();
 	udata = new jointudata();
 	udata->ref = nullptr;
 }
@@ -55,6 +55,7 @@ Joint::Joint(Body *body1, Body *body2)
 	, body1(body1)
 	, body2(body2)
 {
+	confineToThread();
 	udata = new jointudata();
 	udata->ref = nullptr;
 }
@@ -70,6 +71,12 @@ Joint::~Joint()
 	delete udata;
 }
 
+Joint *Joint::fromBox2D(b2Joint *j)
+{
+	jointudata *data = (jointudata *) j->GetUserData();
+	return data != nullptr ? data->joint : nullptr;
+}
+
 Joint::Type Joint::getType() const
 {
 	switch (joint->GetType())
@@ -107,9 +114,9 @@ Body *Joint::getBodyA() const
 	if (b2body == nullptr)
 		return nullptr;
 
-	Body *body = (Body *) Memoizer::find(b2body);
+	Body *body = Body::fromBox2D(b2body);
 	if (body == nullptr)
-		throw love::Exception("A body has escaped Memoizer!");
+		throw love::Exception("A body has no love Body!");
 
 	return body;
 }
@@ -120,13 +127,18 @@ Body *Joint::getBodyB() const
 	if (b2body == nullptr)
 		return nullptr;
 
-	Body *body = (Body *) Memoizer::find(b2body);
+	Body *body = Body::fromBox2D(b2body);
 	if (body == nullptr)
-		throw love::Exception("A body has escaped Memoizer!");
+		throw love::Exception("A body has no love Body!");
 
 	return body;
 }
 
+World *Joint::getWorld() const
+{
+	return world;
+}
+
 bool Joint::isValid() const
 {
 	return joint != 0;
@@ -159,7 +171,7 @@ b2Joint *Joint::createJoint(b2JointDef *def)
 {
 	def->userData = udata;
 	joint = world->world->CreateJoint(def);
-	Memoizer::add(joint, this);
+	udata->joint = this;
 	// Box2D joint has a reference to this love Joint.
 	this->retain();
 	return joint;
@@ -167,7 +179,7 @@ b2Joint *Joint::createJoint(b2JointDef *def)
 
 void Joint::destroyJoint(bool implicit)
 {
-	if (world->world->IsLocked())
+	if (world->isLocked())
 	{
 		// Called during time step. Save reference for destruction afterwards.
 		this->retain();
@@ -177,7 +189,7 @@ void Joint::destroyJoint(bool implicit)
 
 	if (!implicit && joint != 0)
 		world->world->DestroyJoint(joint);
-	Memoizer::remove(joint);
+	udata->joint = nullptr;
 	joint = NULL;
 
 	// Remove userdata reference to avoid it sticking around after GC
@@ -38,6 +38,7 @@ namespace box2d
 // Forward declarations.
 class Body;
 class World;
+class Joint;
 
 /**
  * This struct is stored in a void pointer in the Box2D Joint class. For now, all
@@ -47,6 +48,9 @@ struct jointudata
 {
     // Reference to arbitrary data.
     Reference *ref = nullptr;
+
+    // The love Joint of the b2Joint, found without a Memoizer lookup.
+    Joint *joint = nullptr;
 };
 
 /**
@@ -74,6 +78,11 @@ public:
 
 	virtual ~Joint();
 
+	/**
+	 * Gets the love Joint of a b2Joint, or null if it doesn't have one.
+	 **/
+	static Joint *fromBox2D(b2Joint *j);
+
 	/**
 	 * Returns true if the joint is active in a Box2D world.
 	 **/
@@ -87,6 +96,11 @@ public:
 	virtual Body *getBodyA() const;
 	virtual Body *getBodyB() const;
 
+	/**
+	 * Gets the World the Joint resides in.
+	 **/
+	World *getWorld() const;
+
 	/**
 	 * Gets the anchor positions of the Joint in world
 	 * coordinates. This is useful for debugdrawing the joint.
@@ -22,8 +22,12 @@
 
 // LOVE
 #include "common/math.h"
+#include "common/Data.h"
 #include "wrap_Body.h"
 
+// C++
+#include <cstring>
+
 namespace love
 {
 namespace physics
@@ -153,35 +157,19 @@ int Physics::newPolygonShape(lua_State *L)
 
 int Physics::newChainShape(lua_State *L)
 {
-	int argc = lua_gettop(L)-1; // first argument is looping
-
-	bool istable = lua_istable(L, 2);
-
-	if (istable)
-		argc = (int) luax_objlen(L, 2);
-
-	if (argc % 2 != 0)
-		return luaL_error(L, "Number of vertex components must be a multiple of two.");
+	std::vector<b2Vec2> vecs;
 
-	int vcount = argc/2;
-	bool loop = luax_checkboolean(L, 1);
-	b2Vec2 *vecs = new b2Vec2[vcount];
-
-	if (istable)
-	{
-		for (int i = 0; i < vcount; i++)
-		{
-			lua_rawgeti(L, 2, 1 + i * 2);
-			lua_rawgeti(L, 2, 2 + i * 2);
-			float x = (float)lua_tonumber(L, -2);
-			float y = (float)lua_tonumber(L, -1);
-			vecs[i] = Physics::scaleDown(b2Vec2(x, y));
-			lua_pop(L, 2);
-		}
-	}
+	if (lua_istable(L, 2) || luax_istype(L, 2, love::Data::type))
+		checkVertices(L, 2, vecs);
 	else
 	{
-		for (int i = 0; i < vcount; i++)
+		int argc = lua_gettop(L)-1; // first argument is looping
+
+		if (argc % 2 != 0)
+			return luaL_error(L, "Number of vertex components must be a multiple of two.");
+
+		vecs.resize(argc/2);
+		for (int i = 0; i < (int) vecs.size(); i++)
 		{
 			float x = (float)luaL_checknumber(L, 2 + i * 2);
 			float y = (float)luaL_checknumber(L, 3 + i * 2);
@@ -189,30 +177,77 @@ int Physics::newChainShape(lua_State *L)
 		}
 	}
 
+	bool loop = luax_checkboolean(L, 1);
+
 	b2ChainShape *s = new b2ChainShape();
 
 	try
 	{
 		if (loop)
-			s->CreateLoop(vecs, vcount);
+			s->CreateLoop(vecs.data(), (int) vecs.size());
 		else
-			s->CreateChain(vecs, vcount);
+			s->CreateChain(vecs.data(), (int) vecs.size());
 	}
 	catch (love::Exception &)
 	{
-		delete[] vecs;
 		delete s;
 		throw;
 	}
 
-	delete[] vecs;
-
 	ChainShape *c = new ChainShape(s);
 	luax_pushtype(L, c);
 	c->release();
 	return 1;
 }
 
+void Physics::checkVertices(lua_State *L, int idx, std::vector<b2Vec2> &vertices)
+{
+	if (luax_istype(L, idx, love::Data::type))
+	{
+		love::Data *data = luax_totype<love::Data>(L, idx);
+		const size_t stride = sizeof(float) * 2;
+
+		if (data->getSize() % stride != 0)
+			throw love::Exception("Vertex Data size must be a multiple of %d bytes (two floats per vertex).", (int) stride);
+
+		const char *src = (const char *) data->getData();
+		vertices.resize(data->getSize() / stride);
+
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			float v[2];
+			memcpy(v, src + i * stride, stride);
+			vertices[i] = Physics::scaleDown(b2Vec2(v[0], v[1]));
+		}
+	}
+	else if (lua_istable(L, idx))
+	{
+		int argc = (int) luax_objlen(L, idx);
+
+		if (argc % 2 != 0)
+			throw love::Exception("Number of vertex components must be a multiple of two.");
+
+		vertices.resize(argc/2);
+
+		for (int i = 0; i < (int) vertices.size(); i++)
+		{
+			lua_rawgeti(L, idx, 1 + i * 2);
+			lua_rawgeti(L, idx, 2 + i * 2);
+			float x = (float)lua_tonumber(L, -2);
+			float y = (float)lua_tonumber(L, -1);
+			vertices[i] = Physics::scaleDown(b2Vec2(x, y));
+			lua_pop(L, 2);
+		}
+	}
+	else
+		throw love::Exception("Expected a table or Data of vertex coordinates.");
+}
+
+ChainTerrain *Physics::newChainTerrain(Body *body, const std::vector<b2Vec2> &vertices, int segmentSize)
+{
+	return new ChainTerrain(body, vertices, segmentSize);
+}
+
 DistanceJoint *Physics::newDistanceJoint(Body *body1, Body *body2, float x1, float y1, float x2, float y2, bool collideConnected)
 {
 	return new DistanceJoint(body1, body2, x1, y1, x2, y2, collideConnected);
@@ -32,6 +32,7 @@
 #include "PolygonShape.h"
 #include "EdgeShape.h"
 #include "ChainShape.h"
+#include "ChainTerrain.h"
 #include "Joint.h"
 #include "MouseJoint.h"
 #include "DistanceJoint.h"
@@ -148,10 +149,24 @@ public:
 	int newPolygonShape(lua_State *L);
 
 	/**
-	 * Creates a new ChainShape from a variable number of vertices.
+	 * Creates a new ChainShape from a variable number of vertices, a table
+	 * of vertex coordinates, or a Data of float coordinate pairs.
 	 **/
 	int newChainShape(lua_State *L);
 
+	/**
+	 * Creates a new ChainTerrain on the body.
+	 * @param vertices The vertices of the chain, in meters.
+	 * @param segmentSize The number of edges in each segment.
+	 **/
+	ChainTerrain *newChainTerrain(Body *body, const std::vector<b2Vec2> &vertices, int segmentSize);
+
+	/**
+	 * Reads vertices scaled to meters from a table of coordinates or a Data
+	 * of float coordinate pairs.
+	 **/
+	static void checkVertices(lua_State *L, int idx, std::vector<b2Vec2> &vertices);
+
 	/**
 	 * Creates a new DistanceJoint connecting body1 with body2.
 	 * @param x1 Anchor1 along the x-axis. (World coordinates)
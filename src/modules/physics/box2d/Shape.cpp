@@ -41,12 +41,14 @@ Shape::Shape()
 	: shape(nullptr)
 	, own(false)
 {
+	confineToThread();
 }
 
 Shape::Shape(b2Shape *shape, bool own)
 	: shape(shape)
 	, own(own)
 {
+	confineToThread();
 	if (own)
 		Memoizer::add(shape, this);
 }
@@ -25,7 +25,14 @@
 #include "Contact.h"
 #include "Physics.h"
 #include "common/Memoizer.h"
+#include "common/profiling.h"
 #include "common/Reference.h"
+#include "thread/WorkerPool.h"
+
+// STD
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 namespace love
 {
@@ -36,6 +43,8 @@ namespace box2d
 
 love::Type World::type("World", &Object::type);
 
+std::vector<World *> World::steppingWorlds;
+
 World::ContactCallback::ContactCallback()
 	: ref(nullptr)
 	, L(nullptr)
@@ -49,6 +58,11 @@ World::ContactCallback::~ContactCallback()
 }
 
 void World::ContactCallback::process(b2Contact *contact, const b2ContactImpulse *impulse)
+{
+	process(contact->GetFixtureA(), contact->GetFixtureB(), contact, impulse);
+}
+
+void World::ContactCallback::process(b2Fixture *fixtureA, b2Fixture *fixtureB, b2Contact *contact, const b2ContactImpulse *impulse)
 {
 	// Process contacts.
 	if (ref != nullptr && L != nullptr)
@@ -57,23 +71,24 @@ void World::ContactCallback::process(b2Contact *contact, const b2ContactImpulse
 
 		// Push first fixture.
 		{
-			Fixture *a = (Fixture *)Memoizer::find(contact->GetFixtureA());
+			Fixture *a = Fixture::fromBox2D(fixtureA);
 			if (a != nullptr)
 				luax_pushtype(L, a);
 			else
-				throw love::Exception("A fixture has escaped Memoizer!");
+				throw love::Exception("A fixture has no love Fixture!");
 		}
 
 		// Push second fixture.
 		{
-			Fixture *b = (Fixture *)Memoizer::find(contact->GetFixtureB());
+			Fixture *b = Fixture::fromBox2D(fixtureB);
 			if (b != nullptr)
 				luax_pushtype(L, b);
 			else
-				throw love::Exception("A fixture has escaped Memoizer!");
+				throw love::Exception("A fixture has no love Fixture!");
 		}
 
-		Contact *cobj = (Contact *)Memoizer::find(contact);
+		// A destroyed contact is passed as an invalid Contact.
+		Contact *cobj = contact != nullptr ? (Contact *)Memoizer::find(contact) : nullptr;
 		if (!cobj)
 			cobj = new Contact(contact);
 		else
@@ -154,9 +169,9 @@ bool World::QueryCallback::ReportFixture(b2Fixture *fixture)
 	if (L != nullptr)
 	{
 		lua_pushvalue(L, funcidx);
-		Fixture *f = (Fixture *)Memoizer::find(fixture);
+		Fixture *f = Fixture::fromBox2D(fixture);
 		if (!f)
-			throw love::Exception("A fixture has escaped Memoizer!");
+			throw love::Exception("A fixture has no love Fixture!");
 		luax_pushtype(L, f);
 		lua_call(L, 1, 1);
 		bool cont = luax_toboolean(L, -1);
@@ -183,9 +198,9 @@ float32 World::RayCastCallback::ReportFixture(b2Fixture *fixture, const b2Vec2 &
 	if (L != nullptr)
 	{
 		lua_pushvalue(L, funcidx);
-		Fixture *f = (Fixture *)Memoizer::find(fixture);
+		Fixture *f = Fixture::fromBox2D(fixture);
 		if (!f)
-			throw love::Exception("A fixture has escaped Memoizer!");
+			throw love::Exception("A fixture has no love Fixture!");
 		luax_pushtype(L, f);
 		b2Vec2 scaledPoint = Physics::scaleUp(point);
 		lua_pushnumber(L, scaledPoint.x);
@@ -206,14 +221,14 @@ float32 World::RayCastCallback::ReportFixture(b2Fixture *fixture, const b2Vec2 &
 
 void World::SayGoodbye(b2Fixture *fixture)
 {
-	Fixture *f = (Fixture *)Memoizer::find(fixture);
+	Fixture *f = Fixture::fromBox2D(fixture);
 	// Hint implicit destruction with true.
 	if (f) f->destroy(true);
 }
 
 void World::SayGoodbye(b2Joint *joint)
 {
-	Joint *j = (Joint *)Memoizer::find(joint);
+	Joint *j = Joint::fromBox2D(joint);
 	// Hint implicit destruction with true.
 	if (j) j->destroyJoint(true);
 }
@@ -221,6 +236,14 @@ void World::SayGoodbye(b2Joint *joint)
 World::World()
 	: world(nullptr)
 	, destructWorld(false)
+	, stepping(false)
+	, stepDone(false)
+	, asyncStep(false)
+	, deliveringContacts(false)
+	, fixedTimestep(0.0f)
+	, maxSubsteps(8)
+	, accumulator(0.0)
+	, contactBuffering(false)
 {
 	world = new b2World(b2Vec2(0,0));
 	world->SetAllowSleeping(true);
@@ -230,11 +253,20 @@ World::World()
 	b2BodyDef def;
 	groundBody = world->CreateBody(&def);
 	Memoizer::add(world, this);
+	setNativeMemorySize(type, sizeof(b2World));
 }
 
 World::World(b2Vec2 gravity, bool sleep)
 	: world(nullptr)
 	, destructWorld(false)
+	, stepping(false)
+	, stepDone(false)
+	, asyncStep(false)
+	, deliveringContacts(false)
+	, fixedTimestep(0.0f)
+	, maxSubsteps(8)
+	, accumulator(0.0)
+	, contactBuffering(false)
 {
 	world = new b2World(Physics::scaleDown(gravity));
 	world->SetAllowSleeping(sleep);
@@ -244,6 +276,7 @@ World::World(b2Vec2 gravity, bool sleep)
 	b2BodyDef def;
 	groundBody = world->CreateBody(&def);
 	Memoizer::add(world, this);
+	setNativeMemorySize(type, sizeof(b2World));
 }
 
 World::~World()
@@ -258,8 +291,301 @@ void World::update(float dt)
 
 void World::update(float dt, int velocityIterations, int positionIterations)
 {
-	world->Step(dt, velocityIterations, positionIterations);
+	LOVE_PROFILE_ZONE("World:update");
+
+	finishStep();
+
+	if (isLocked())
+		throw love::Exception("The World can't be updated during a contact callback.");
+
+	contactEvents.clear();
+
+	if (fixedTimestep > 0.0f)
+	{
+		int count = consumeFixedTime(dt);
+		stepSubsteps(count, fixedTimestep, velocityIterations, positionIterations);
+		applyPreviousTransforms();
+	}
+	else
+		world->Step(dt, velocityIterations, positionIterations);
+
+	destroyMarked();
+}
+
+void World::setFixedTimestep(float timestep, int maxSubsteps)
+{
+	if (timestep < 0.0f)
+		throw love::Exception("The fixed timestep can't be negative.");
+	if (maxSubsteps < 1)
+		throw love::Exception("The maximum number of substeps must be at least 1.");
+
+	fixedTimestep = timestep;
+	this->maxSubsteps = maxSubsteps;
+	accumulator = 0.0;
+}
+
+float World::getFixedTimestep() const
+{
+	return fixedTimestep;
+}
+
+int World::getMaxSubsteps() const
+{
+	return maxSubsteps;
+}
+
+float World::getInterpolationAlpha() const
+{
+	if (fixedTimestep <= 0.0f)
+		return 1.0f;
+
+	return (float) (accumulator / fixedTimestep);
+}
+
+int World::consumeFixedTime(float dt)
+{
+	accumulator += std::max(dt, 0.0f);
+
+	int count = (int) (accumulator / fixedTimestep);
+	if (count > maxSubsteps)
+	{
+		// Falling further behind every frame would only make things worse.
+		count = maxSubsteps;
+		accumulator = std::fmod(accumulator - count * (double) fixedTimestep, (double) fixedTimestep);
+	}
+	else
+		accumulator -= count * (double) fixedTimestep;
+
+	accumulator = std::max(accumulator, 0.0);
+	return count;
+}
+
+void World::stepSubsteps(int count, float dt, int velocityIterations, int positionIterations)
+{
+	for (int i = 0; i < count; i++)
+	{
+		if (i == count - 1)
+		{
+			previousTransforms.clear();
+			for (b2Body *b = world->GetBodyList(); b != nullptr; b = b->GetNext())
+				previousTransforms.push_back(std::make_pair(b->GetPosition(), b->GetAngle()));
+		}
+
+		world->Step(dt, velocityIterations, positionIterations);
+	}
+}
+
+void World::applyPreviousTransforms()
+{
+	if (previousTransforms.empty())
+		return;
+
+	// No bodies are created or destroyed during timesteps, so the list still
+	// matches.
+	size_t i = 0;
+	for (b2Body *b = world->GetBodyList(); b != nullptr && i < previousTransforms.size(); b = b->GetNext(), i++)
+	{
+		Body *body = Body::fromBox2D(b);
+		if (body == nullptr)
+			continue;
+
+		body->previousPosition = previousTransforms[i].first;
+		body->previousAngle = previousTransforms[i].second;
+		body->hasPreviousTransform = true;
+	}
+
+	previousTransforms.clear();
+}
+
+void World::updateAsync(float dt, int velocityIterations, int positionIterations)
+{
+	finishStep();
+
+	if (isLocked())
+		throw love::Exception("The World can't be updated during a contact callback.");
+
+	if (presolve.ref != nullptr || filter.ref != nullptr)
+	{
+		update(dt, velocityIterations, positionIterations);
+		return;
+	}
+
+	contactEvents.clear();
+
+	// Without a fixed timestep, this is a single step of dt.
+	int count = 1;
+	float stepdt = dt;
+
+	if (fixedTimestep > 0.0f)
+	{
+		count = consumeFixedTime(dt);
+		stepdt = fixedTimestep;
+
+		if (count == 0)
+			return;
+	}
+
+	// Bodies report this state until the step is finished.
+	for (b2Body *b = world->GetBodyList(); b != nullptr; b = b->GetNext())
+	{
+		Body *body = Body::fromBox2D(b);
+		if (body != nullptr)
+			body->saveState();
+	}
+
+	stepping = true;
+	stepDone = false;
+	asyncStep = true;
+	steppingWorlds.push_back(this);
+
+	bool fixed = fixedTimestep > 0.0f;
+
+	love::thread::WorkerPool::getShared().submit([this, fixed, count, stepdt, velocityIterations, positionIterations]()
+	{
+		std::string err;
+
+		try
+		{
+			if (fixed)
+				stepSubsteps(count, stepdt, velocityIterations, positionIterations);
+			else
+				world->Step(stepdt, velocityIterations, positionIterations);
+		}
+		catch (std::exception &e)
+		{
+			err = e.what();
+		}
+
+		love::thread::Lock lock(stepMutex);
+		stepError = err;
+		stepDone = true;
+		stepCond->broadcast();
+	});
+}
+
+void World::waitForStep()
+{
+	if (!stepping)
+		return;
+
+	{
+		love::thread::Lock lock(stepMutex);
+		while (!stepDone)
+			stepCond->wait(stepMutex);
+	}
+
+	stepping = false;
+	asyncStep = false;
+	steppingWorlds.erase(std::remove(steppingWorlds.begin(), steppingWorlds.end(), this), steppingWorlds.end());
+}
+
+bool World::isContactAlive(const QueuedContact &queued) const
+{
+	b2Contact *c = queued.contact;
+	if (c == nullptr)
+		return false;
+
+	// Only the contact pointer is compared while searching, since it may be
+	// dangling.
+	for (b2ContactEdge *edge = queued.fixtureA->GetBody()->GetContactList(); edge != nullptr; edge = edge->next)
+	{
+		if (edge->contact == c)
+			return c->GetFixtureA() == queued.fixtureA && c->GetFixtureB() == queued.fixtureB;
+	}
+
+	return false;
+}
+
+void World::finishStep()
+{
+	if (!stepping)
+		return;
+
+	waitForStep();
+
+	std::vector<QueuedContact> queued;
+	queued.swap(queuedContacts);
+
+	std::string err;
+	std::swap(err, stepError);
+
+	applyPreviousTransforms();
+
+	// Contacts destroyed during the step can't be used by their Contact
+	// objects anymore.
+	for (QueuedContact &q : queued)
+	{
+		if (!isContactAlive(q))
+		{
+			Contact *c = (Contact *) Memoizer::find(q.contact);
+			if (c != nullptr)
+				c->invalidate();
+			q.contact = nullptr;
+		}
+	}
+
+	// Objects destroyed by the callbacks are only marked, like during a step,
+	// so the queued contacts stay valid.
+	deliveringContacts = true;
+
+	try
+	{
+		for (QueuedContact &q : queued)
+		{
+			// A callback may have destroyed the contact, by deactivating a
+			// Body for example.
+			if (q.contact != nullptr && !isContactAlive(q))
+			{
+				Contact *c = (Contact *) Memoizer::find(q.contact);
+				if (c != nullptr)
+					c->invalidate();
+				q.contact = nullptr;
+			}
+
+			if (q.event == CONTACT_BEGIN)
+				begin.process(q.fixtureA, q.fixtureB, q.contact, nullptr);
+			else if (q.event == CONTACT_END)
+			{
+				// Buffered end events are only queued to invalidate Contacts.
+				if (!contactBuffering)
+					end.process(q.fixtureA, q.fixtureB, q.contact, nullptr);
+
+				Contact *c = q.contact != nullptr ? (Contact *) Memoizer::find(q.contact) : nullptr;
+				if (c != nullptr)
+					c->invalidate();
+			}
+			else if (q.event == CONTACT_POSTSOLVE)
+				postsolve.process(q.fixtureA, q.fixtureB, q.contact, &q.impulse);
+		}
+	}
+	catch (...)
+	{
+		deliveringContacts = false;
+		destroyMarked();
+		throw;
+	}
+
+	deliveringContacts = false;
+	destroyMarked();
+
+	if (!err.empty())
+		throw love::Exception("%s", err.c_str());
+}
+
+bool World::isStepping() const
+{
+	return stepping;
+}
+
+void World::finishAllSteps()
+{
+	// finishStep removes the World from the list.
+	while (!steppingWorlds.empty())
+		steppingWorlds.back()->finishStep();
+}
 
+void World::destroyMarked()
+{
 	// Destroy all objects marked during the time step.
 	for (Body *b : destructBodies)
 	{
@@ -287,14 +613,76 @@ void World::update(float dt, int velocityIterations, int positionIterations)
 		destroy();
 }
 
+void World::recordContact(ContactEvent event, b2Contact *contact, const b2ContactImpulse *impulse)
+{
+	b2Fixture *fixtureA = contact->GetFixtureA();
+	b2Fixture *fixtureB = contact->GetFixtureB();
+
+	// Only the fixture userdata is used, so this is safe during asynchronous
+	// steps.
+	fixtureudata *udataA = (fixtureudata *) fixtureA->GetUserData();
+	fixtureudata *udataB = (fixtureudata *) fixtureB->GetUserData();
+	bool reportA = udataA == nullptr || udataA->reportContacts;
+	bool reportB = udataB == nullptr || udataB->reportContacts;
+
+	if (!reportA && !reportB)
+		return;
+
+	ContactRecord record = {event, fixtureA, fixtureB, b2Vec2(0.0f, 0.0f), 0.0f, 0.0f};
+
+	// Ended contacts may not be touching anymore, so their normal is unused.
+	if (event != CONTACT_END && contact->GetManifold()->pointCount > 0)
+	{
+		b2WorldManifold manifold;
+		contact->GetWorldManifold(&manifold);
+		record.normal = manifold.normal;
+	}
+
+	if (impulse != nullptr)
+	{
+		for (int i = 0; i < impulse->count; i++)
+		{
+			record.normalImpulse += Physics::scaleUp(impulse->normalImpulses[i]);
+			record.tangentImpulse += Physics::scaleUp(impulse->tangentImpulses[i]);
+		}
+	}
+
+	contactEvents.push_back(record);
+}
+
 void World::BeginContact(b2Contact *contact)
 {
+	if (contactBuffering)
+	{
+		recordContact(CONTACT_BEGIN, contact, nullptr);
+		return;
+	}
+
+	if (asyncStep)
+	{
+		if (begin.ref != nullptr)
+			queuedContacts.push_back({CONTACT_BEGIN, contact, contact->GetFixtureA(), contact->GetFixtureB(), b2ContactImpulse()});
+		return;
+	}
+
 	begin.process(contact);
 }
 
 void World::EndContact(b2Contact *contact)
 {
-	end.process(contact);
+	if (contactBuffering)
+		recordContact(CONTACT_END, contact, nullptr);
+
+	// Contacts which ended are always queued, so their Contact objects can be
+	// invalidated.
+	if (asyncStep)
+	{
+		queuedContacts.push_back({CONTACT_END, contact, contact->GetFixtureA(), contact->GetFixtureB(), b2ContactImpulse()});
+		return;
+	}
+
+	if (!contactBuffering)
+		end.process(contact);
 
 	// Letting the Contact know that the b2Contact will be destroyed any second.
 	Contact *c = (Contact *)Memoizer::find(contact);
@@ -310,16 +698,34 @@ void World::PreSolve(b2Contact *contact, const b2Manifold *oldManifold)
 
 void World::PostSolve(b2Contact *contact, const b2ContactImpulse *impulse)
 {
+	if (contactBuffering)
+	{
+		recordContact(CONTACT_POSTSOLVE, contact, impulse);
+		return;
+	}
+
+	if (asyncStep)
+	{
+		if (postsolve.ref != nullptr)
+			queuedContacts.push_back({CONTACT_POSTSOLVE, contact, contact->GetFixtureA(), contact->GetFixtureB(), *impulse});
+		return;
+	}
+
 	postsolve.process(contact, impulse);
 }
 
 bool World::ShouldCollide(b2Fixture *fixtureA, b2Fixture *fixtureB)
 {
-	// Fixtures should be memoized, if we created them
-	Fixture *a = (Fixture *)Memoizer::find(fixtureA);
-	Fixture *b = (Fixture *)Memoizer::find(fixtureB);
+	// Asynchronous steps never have a filter callback, and can't call into
+	// Lua off the main thread.
+	if (asyncStep)
+		return b2ContactFilter::ShouldCollide(fixtureA, fixtureB);
+
+	// Fixtures have a love Fixture, if we created them
+	Fixture *a = Fixture::fromBox2D(fixtureA);
+	Fixture *b = Fixture::fromBox2D(fixtureB);
 	if (!a || !b)
-		throw love::Exception("A fixture has escaped Memoizer!");
+		throw love::Exception("A fixture has no love Fixture!");
 	return filter.process(a, b);
 }
 
@@ -395,6 +801,82 @@ void World::setCallbacksL(lua_State *L)
 	begin.L = end.L = presolve.L = postsolve.L = filter.L = L;
 }
 
+void World::setContactBuffering(bool enable)
+{
+	contactBuffering = enable;
+	contactEvents.clear();
+}
+
+bool World::isContactBuffering() const
+{
+	return contactBuffering;
+}
+
+int World::getContactEvents(lua_State *L)
+{
+	static const char *eventNames[] = {"begin", "end", "postsolve"};
+	const int components = 7;
+
+	int oldlength = 0;
+	if (lua_istable(L, 1))
+	{
+		oldlength = (int) luax_objlen(L, 1);
+		lua_settop(L, 1);
+	}
+	else
+	{
+		lua_settop(L, 0);
+		lua_createtable(L, (int) contactEvents.size() * components, 0);
+	}
+
+	int i = 1;
+	for (const ContactRecord &record : contactEvents)
+	{
+		Fixture *a = Fixture::fromBox2D(record.fixtureA);
+		Fixture *b = Fixture::fromBox2D(record.fixtureB);
+		if (!a || !b)
+			throw love::Exception("A fixture has no love Fixture!");
+
+		lua_pushstring(L, eventNames[record.event]);
+		lua_rawseti(L, 1, i++);
+		luax_pushtype(L, a);
+		lua_rawseti(L, 1, i++);
+		luax_pushtype(L, b);
+		lua_rawseti(L, 1, i++);
+		lua_pushnumber(L, record.normal.x);
+		lua_rawseti(L, 1, i++);
+		lua_pushnumber(L, record.normal.y);
+		lua_rawseti(L, 1, i++);
+		lua_pushnumber(L, record.normalImpulse);
+		lua_rawseti(L, 1, i++);
+		lua_pushnumber(L, record.tangentImpulse);
+		lua_rawseti(L, 1, i++);
+	}
+
+	// Clear leftovers from a reused table, so its length stays correct.
+	for (int j = oldlength; j >= i; j--)
+	{
+		lua_pushnil(L);
+		lua_rawseti(L, 1, j);
+	}
+
+	lua_pushinteger(L, (lua_Integer) contactEvents.size());
+	return 2;
+}
+
+void World::removeContactEvents(b2Fixture *fixture)
+{
+	if (contactEvents.empty())
+		return;
+
+	auto involves = [fixture](const ContactRecord &record)
+	{
+		return record.fixtureA == fixture || record.fixtureB == fixture;
+	};
+
+	contactEvents.erase(std::remove_if(contactEvents.begin(), contactEvents.end(), involves), contactEvents.end());
+}
+
 int World::setContactFilter(lua_State *L)
 {
 	if (!lua_isnoneornil(L, 1))
@@ -441,9 +923,42 @@ bool World::isSleepingAllowed() const
 	return world->GetAllowSleeping();
 }
 
+namespace
+{
+
+// Runs the parallel parts of Box2D's timesteps on the shared worker pool.
+class WorkerPoolTaskExecutor : public b2TaskExecutor
+{
+public:
+
+	int32 GetThreadCount() const override
+	{
+		return love::thread::WorkerPool::getShared().getWorkerCount() + 1;
+	}
+
+	void ParallelFor(int32 count, b2Task *task) override
+	{
+		love::thread::WorkerPool::getShared().parallelFor(count, [task](int i) { task->Execute(i); });
+	}
+};
+
+WorkerPoolTaskExecutor workerPoolTaskExecutor;
+
+} // anonymous namespace
+
+void World::setParallel(bool enable)
+{
+	world->SetTaskExecutor(enable ? &workerPoolTaskExecutor : nullptr);
+}
+
+bool World::isParallel() const
+{
+	return world->GetTaskExecutor() != nullptr;
+}
+
 bool World::isLocked() const
 {
-	return world->IsLocked();
+	return world->IsLocked() || deliveringContacts;
 }
 
 int World::getBodyCount() const
@@ -472,9 +987,9 @@ int World::getBodies(lua_State *L) const
 			break;
 		if (b == groundBody)
 			continue;
-		Body *body = (Body *)Memoizer::find(b);
+		Body *body = Body::fromBox2D(b);
 		if (!body)
-			throw love::Exception("A body has escaped Memoizer!");
+			throw love::Exception("A body has no love Body!");
 		luax_pushtype(L, body);
 		lua_rawseti(L, -2, i);
 		i++;
@@ -483,6 +998,130 @@ int World::getBodies(lua_State *L) const
 	return 1;
 }
 
+static void writeBodyState(const b2Vec2 &p, float angle, const b2Vec2 &v, float angularVelocity, bool awake, float *dst)
+{
+	b2Vec2 position = Physics::scaleUp(p);
+	b2Vec2 velocity = Physics::scaleUp(v);
+
+	float values[World::BODY_STATE_COMPONENTS] =
+	{
+		position.x, position.y, angle,
+		velocity.x, velocity.y, angularVelocity,
+		awake ? 1.0f : 0.0f,
+	};
+
+	// The destination may not be aligned for floats.
+	memcpy(dst, values, sizeof(values));
+}
+
+static void readBodyState(b2Body *body, const float *src)
+{
+	float values[World::BODY_STATE_COMPONENTS];
+	memcpy(values, src, sizeof(values));
+
+	body->SetTransform(Physics::scaleDown(b2Vec2(values[0], values[1])), values[2]);
+	body->SetLinearVelocity(Physics::scaleDown(b2Vec2(values[3], values[4])));
+	body->SetAngularVelocity(values[5]);
+	body->SetAwake(values[6] != 0.0f);
+}
+
+void World::getBodyStates(float *dst) const
+{
+	for (b2Body *b = world->GetBodyList(); b != nullptr; b = b->GetNext())
+	{
+		if (b == groundBody)
+			continue;
+
+		// The Body is only needed for its saved state.
+		if (stepping)
+		{
+			Body *body = Body::fromBox2D(b);
+			if (!body)
+				throw love::Exception("A body has no love Body!");
+			const Body::State &s = body->savedState;
+			writeBodyState(s.transform.p, s.angle, s.linearVelocity, s.angularVelocity, s.awake, dst);
+		}
+		else
+			writeBodyState(b->GetPosition(), b->GetAngle(), b->GetLinearVelocity(), b->GetAngularVelocity(), b->IsAwake(), dst);
+
+		dst += BODY_STATE_COMPONENTS;
+	}
+}
+
+void World::getBodyStates(const std::vector<Body *> &bodies, float *dst) const
+{
+	for (Body *body : bodies)
+	{
+		Body::State s = body->getState();
+		writeBodyState(s.transform.p, s.angle, s.linearVelocity, s.angularVelocity, s.awake, dst);
+		dst += BODY_STATE_COMPONENTS;
+	}
+}
+
+void World::getInterpolatedBodyStates(float *dst) const
+{
+	std::vector<Body *> bodies;
+	bodies.reserve(getBodyCount());
+
+	for (b2Body *b = world->GetBodyList(); b != nullptr; b = b->GetNext())
+	{
+		if (b == groundBody)
+			continue;
+
+		Body *body = Body::fromBox2D(b);
+		if (!body)
+			throw love::Exception("A body has no love Body!");
+		bodies.push_back(body);
+	}
+
+	getInterpolatedBodyStates(bodies, dst);
+}
+
+void World::getInterpolatedBodyStates(const std::vector<Body *> &bodies, float *dst) const
+{
+	float alpha = getInterpolationAlpha();
+
+	for (Body *body : bodies)
+	{
+		Body::State s = body->getState();
+		b2Vec2 position = s.transform.p;
+		float angle = s.angle;
+
+		if (body->hasPreviousTransform)
+		{
+			position = body->previousPosition + alpha * (position - body->previousPosition);
+			angle = body->previousAngle + alpha * (angle - body->previousAngle);
+		}
+
+		writeBodyState(position, angle, s.linearVelocity, s.angularVelocity, s.awake, dst);
+		dst += BODY_STATE_COMPONENTS;
+	}
+}
+
+void World::setBodyStates(const float *src)
+{
+	for (b2Body *b = world->GetBodyList(); b != nullptr; b = b->GetNext())
+	{
+		if (b == groundBody)
+			continue;
+
+		if (b->GetType() == b2_kinematicBody)
+			readBodyState(b, src);
+
+		src += BODY_STATE_COMPONENTS;
+	}
+}
+
+void World::setBodyStates(const std::vector<Body *> &bodies, const float *src)
+{
+	for (Body *body : bodies)
+	{
+		if (body->body->GetType() == b2_kinematicBody)
+			readBodyState(body->body, src);
+		src += BODY_STATE_COMPONENTS;
+	}
+}
+
 int World::getJoints(lua_State *L) const
 {
 	lua_newtable(L);
@@ -491,8 +1130,8 @@ int World::getJoints(lua_State *L) const
 	do
 	{
 		if (!j) break;
-		Joint *joint = (Joint *)Memoizer::find(j);
-		if (!joint) throw love::Exception("A joint has escaped Memoizer!");
+		Joint *joint = Joint::fromBox2D(j);
+		if (!joint) throw love::Exception("A joint has no love Joint!");
 		luax_pushtype(L, joint);
 		lua_rawseti(L, -2, i);
 		i++;
@@ -557,17 +1196,460 @@ int World::rayCast(lua_State *L)
 	return 0;
 }
 
+namespace
+{
+
+class BatchRayCastCallback : public b2RayCastCallback
+{
+public:
+
+	BatchRayCastCallback(int query, const World::CastOptions &options, std::vector<World::CastHit> &hits)
+		: query(query)
+		, options(options)
+		, hits(hits)
+		, first(hits.size())
+	{
+	}
+
+	float32 ReportFixture(b2Fixture *fixture, const b2Vec2 &point, const b2Vec2 &normal, float32 fraction) override
+	{
+		if ((fixture->GetFilterData().categoryBits & options.categories) == 0)
+			return -1.0f;
+
+		World::CastHit hit = {query, fixture, point, normal, fraction};
+
+		if (options.mode == World::CAST_ALL)
+		{
+			hits.push_back(hit);
+			return 1.0f;
+		}
+
+		// Hits are reported in no particular order, so the closest one so far
+		// is replaced. Returning the fraction clips the ray to it.
+		if (hits.size() > first)
+			hits.back() = hit;
+		else
+			hits.push_back(hit);
+
+		return options.mode == World::CAST_ANY ? 0.0f : fraction;
+	}
+
+private:
+
+	int query;
+	const World::CastOptions &options;
+	std::vector<World::CastHit> &hits;
+	size_t first;
+};
+
+class BatchQueryCallback : public b2QueryCallback
+{
+public:
+
+	BatchQueryCallback(uint16 categories, std::vector<b2Fixture *> &fixtures)
+		: categories(categories)
+		, fixtures(fixtures)
+	{
+	}
+
+	bool ReportFixture(b2Fixture *fixture) override
+	{
+		if ((fixture->GetFilterData().categoryBits & categories) != 0)
+			fixtures.push_back(fixture);
+		return true;
+	}
+
+private:
+
+	uint16 categories;
+	std::vector<b2Fixture *> &fixtures;
+};
+
+// Fixtures with several children, like chains, are reported once per child.
+void removeDuplicateFixtures(std::vector<b2Fixture *> &fixtures, size_t first)
+{
+	std::sort(fixtures.begin() + first, fixtures.end());
+	fixtures.erase(std::unique(fixtures.begin() + first, fixtures.end()), fixtures.end());
+}
+
+bool compareCastHits(const World::CastHit &a, const World::CastHit &b)
+{
+	return a.fraction < b.fraction;
+}
+
+} // anonymous namespace
+
+void World::castRay(int query, const b2Vec2 &p1, const b2Vec2 &p2, const CastOptions &options, std::vector<CastHit> &hits) const
+{
+	// Box2D asserts on zero length rays.
+	if ((p2 - p1).LengthSquared() <= 0.0f)
+		return;
+
+	size_t first = hits.size();
+
+	BatchRayCastCallback callback(query, options, hits);
+	world->RayCast(&callback, p1, p2);
+
+	if (options.mode == CAST_ALL)
+		std::sort(hits.begin() + first, hits.end(), compareCastHits);
+}
+
+void World::castShape(int query, const b2Vec2 &p1, const b2Vec2 &p2, const b2Shape &shape, const CastOptions &options, std::vector<CastHit> &hits) const
+{
+	b2Vec2 translation = p2 - p1;
+	b2Transform start(p1, b2Rot(options.angle));
+	b2Transform end(p2, b2Rot(options.angle));
+
+	b2AABB startbox, endbox, box;
+	shape.ComputeAABB(&startbox, start, 0);
+	shape.ComputeAABB(&endbox, end, 0);
+	box.Combine(startbox, endbox);
+
+	std::vector<b2Fixture *> fixtures;
+	BatchQueryCallback callback(options.categories, fixtures);
+	world->QueryAABB(&callback, box);
+
+	b2DistanceProxy castproxy;
+	castproxy.Set(&shape, 0);
+
+	b2Sweep castsweep;
+	castsweep.localCenter.SetZero();
+	castsweep.c0 = p1;
+	castsweep.c = p2;
+	castsweep.a0 = castsweep.a = options.angle;
+	castsweep.alpha0 = 0.0f;
+
+	size_t first = hits.size();
+
+	for (b2Fixture *fixture : fixtures)
+	{
+		const b2Transform &xf = fixture->GetBody()->GetTransform();
+		const b2Shape *fixtureshape = fixture->GetShape();
+
+		b2Sweep fixturesweep;
+		fixturesweep.localCenter.SetZero();
+		fixturesweep.c0 = fixturesweep.c = xf.p;
+		fixturesweep.a0 = fixturesweep.a = xf.q.GetAngle();
+		fixturesweep.alpha0 = 0.0f;
+
+		for (int32 child = 0; child < fixtureshape->GetChildCount(); child++)
+		{
+			b2TOIInput input;
+			input.proxyA.Set(fixtureshape, child);
+			input.proxyB = castproxy;
+			input.sweepA = fixturesweep;
+			input.sweepB = castsweep;
+			input.tMax = 1.0f;
+
+			b2TOIOutput output;
+			b2TimeOfImpact(&output, &input);
+
+			float fraction;
+			if (output.state == b2TOIOutput::e_touching)
+				fraction = output.t;
+			else if (output.state == b2TOIOutput::e_overlapped)
+				fraction = 0.0f;
+			else
+				continue;
+
+			// The contact point and normal come from the closest features
+			// at the time of impact. The shapes are slightly overlapping
+			// there, so their radii are left out of the distance.
+			b2Transform castxf(p1 + fraction * translation, start.q);
+
+			b2DistanceInput distinput;
+			distinput.proxyA = input.proxyA;
+			distinput.proxyB = castproxy;
+			distinput.transformA = xf;
+			distinput.transformB = castxf;
+			distinput.useRadii = false;
+
+			b2SimplexCache cache;
+			cache.count = 0;
+
+			b2DistanceOutput distoutput;
+			b2Distance(&distoutput, &cache, &distinput);
+
+			b2Vec2 normal = distoutput.pointB - distoutput.pointA;
+			if (normal.Normalize() < b2_epsilon)
+			{
+				normal = -translation;
+				if (normal.Normalize() < b2_epsilon)
+					normal.Set(0.0f, 0.0f);
+			}
+
+			// The core shapes don't include the polygon skin or circle radius.
+			b2Vec2 point = distoutput.pointA + input.proxyA.m_radius * normal;
+
+			CastHit hit = {query, fixture, point, normal, fraction};
+
+			if (options.mode == CAST_ALL)
+				hits.push_back(hit);
+			else if (hits.size() == first)
+				hits.push_back(hit);
+			else if (fraction < hits.back().fraction)
+				hits.back() = hit;
+
+			if (options.mode == CAST_ANY)
+				return;
+		}
+	}
+
+	if (options.mode == CAST_ALL)
+		std::sort(hits.begin() + first, hits.end(), compareCastHits);
+}
+
+void World::castBatch(const float *queries, int count, const CastOptions &options, std::vector<CastHit> &hits) const
+{
+	b2CircleShape circle;
+	circle.m_radius = Physics::scaleDown(options.radius);
+
+	b2PolygonShape box;
+	box.SetAsBox(Physics::scaleDown(options.halfWidth), Physics::scaleDown(options.halfHeight));
+
+	const b2Shape *shape = nullptr;
+	if (options.shape == CAST_SHAPE_CIRCLE)
+		shape = &circle;
+	else if (options.shape == CAST_SHAPE_BOX)
+		shape = &box;
+
+	auto cast = [&](int i, std::vector<CastHit> &out)
+	{
+		float q[CAST_QUERY_COMPONENTS];
+		memcpy(q, queries + i * CAST_QUERY_COMPONENTS, sizeof(q));
+
+		b2Vec2 p1 = Physics::scaleDown(b2Vec2(q[0], q[1]));
+		b2Vec2 p2 = Physics::scaleDown(b2Vec2(q[2], q[3]));
+
+		if (shape != nullptr)
+			castShape(i, p1, p2, *shape, options, out);
+		else
+			castRay(i, p1, p2, options, out);
+	};
+
+	// b2TimeOfImpact and b2Distance update global statistics counters, so
+	// only ray casts are spread across threads.
+	love::thread::WorkerPool &pool = love::thread::WorkerPool::getShared();
+	bool parallel = options.parallel && shape == nullptr && count > 1 && pool.getWorkerCount() > 0;
+
+	if (!parallel)
+	{
+		for (int i = 0; i < count; i++)
+			cast(i, hits);
+	}
+	else
+	{
+		// Each chunk collects its own hits, which are joined in query order.
+		int chunkcount = std::min(count, (pool.getWorkerCount() + 1) * 4);
+		std::vector<std::vector<CastHit>> chunks(chunkcount);
+
+		pool.parallelFor(chunkcount, [&](int chunk)
+		{
+			int begin = (int) ((int64) count * chunk / chunkcount);
+			int end = (int) ((int64) count * (chunk + 1) / chunkcount);
+			for (int i = begin; i < end; i++)
+				cast(i, chunks[chunk]);
+		});
+
+		for (const std::vector<CastHit> &chunk : chunks)
+			hits.insert(hits.end(), chunk.begin(), chunk.end());
+	}
+
+	for (size_t i = 0; i < hits.size(); i++)
+	{
+		hits[i].point = Physics::scaleUp(hits[i].point);
+	}
+}
+
+void World::getFixturesInArea(const b2AABB &box, uint16 categories, std::vector<b2Fixture *> &fixtures) const
+{
+	size_t first = fixtures.size();
+
+	BatchQueryCallback callback(categories, fixtures);
+	world->QueryAABB(&callback, box);
+	removeDuplicateFixtures(fixtures, first);
+
+	// The broadphase uses enlarged boxes, so the fixtures' own boxes are
+	// checked as well.
+	auto outside = [&box](b2Fixture *fixture)
+	{
+		for (int32 child = 0; child < fixture->GetShape()->GetChildCount(); child++)
+		{
+			if (b2TestOverlap(fixture->GetAABB(child), box))
+				return false;
+		}
+		return true;
+	};
+
+	fixtures.erase(std::remove_if(fixtures.begin() + first, fixtures.end(), outside), fixtures.end());
+}
+
+void World::getFixturesAtPoint(const b2Vec2 &point, uint16 categories, std::vector<b2Fixture *> &fixtures) const
+{
+	size_t first = fixtures.size();
+
+	b2AABB box;
+	box.lowerBound = box.upperBound = point;
+
+	BatchQueryCallback callback(categories, fixtures);
+	world->QueryAABB(&callback, box);
+	removeDuplicateFixtures(fixtures, first);
+
+	auto outside = [&point](b2Fixture *fixture)
+	{
+		return !fixture->TestPoint(point);
+	};
+
+	fixtures.erase(std::remove_if(fixtures.begin() + first, fixtures.end(), outside), fixtures.end());
+}
+
+size_t World::getStateSize() const
+{
+	return (size_t) b2WorldState::GetSize(world);
+}
+
+size_t World::saveState(void *dst, size_t size) const
+{
+	size_t needed = getStateSize();
+	if (size < needed)
+		throw love::Exception("Data is too small to hold the World's state (needs %d bytes.)", (int) needed);
+
+	b2WorldState::Save(world, dst);
+	return needed;
+}
+
+void World::restoreState(const void *src, size_t size)
+{
+	if (isLocked())
+		throw love::Exception("The World's state can't be restored during a contact callback.");
+
+	int32 clampedsize = (int32) std::min(size, (size_t) LOVE_INT32_MAX);
+
+	// Every contact is recreated, so existing Contact objects become invalid.
+	std::vector<Contact *> contacts;
+	for (b2Contact *c = world->GetContactList(); c != nullptr; c = c->GetNext())
+	{
+		Contact *contact = (Contact *) Memoizer::find(c);
+		if (contact != nullptr)
+			contacts.push_back(contact);
+	}
+
+	if (!b2WorldState::Restore(world, src, clampedsize))
+		throw love::Exception("Invalid World state, or the World's bodies, fixtures or joints changed since it was saved.");
+
+	for (Contact *contact : contacts)
+		contact->invalidate();
+
+	contactEvents.clear();
+}
+
+bool World::getConstant(const char *in, CastMode &out)
+{
+	return castModes.find(in, out);
+}
+
+bool World::getConstant(CastMode in, const char *&out)
+{
+	return castModes.find(in, out);
+}
+
+std::vector<std::string> World::getConstants(CastMode)
+{
+	return castModes.getNames();
+}
+
+bool World::getConstant(const char *in, CastShape &out)
+{
+	return castShapes.find(in, out);
+}
+
+bool World::getConstant(CastShape in, const char *&out)
+{
+	return castShapes.find(in, out);
+}
+
+std::vector<std::string> World::getConstants(CastShape)
+{
+	return castShapes.getNames();
+}
+
+StringMap<World::CastMode, World::CAST_MAX_ENUM>::Entry World::castModeEntries[] =
+{
+	{ "closest", CAST_CLOSEST },
+	{ "all",     CAST_ALL     },
+	{ "any",     CAST_ANY     },
+};
+
+StringMap<World::CastMode, World::CAST_MAX_ENUM> World::castModes(World::castModeEntries, sizeof(World::castModeEntries));
+
+StringMap<World::CastShape, World::CAST_SHAPE_MAX_ENUM>::Entry World::castShapeEntries[] =
+{
+	{ "ray",    CAST_SHAPE_RAY    },
+	{ "circle", CAST_SHAPE_CIRCLE },
+	{ "box",    CAST_SHAPE_BOX    },
+};
+
+StringMap<World::CastShape, World::CAST_SHAPE_MAX_ENUM> World::castShapes(World::castShapeEntries, sizeof(World::castShapeEntries));
+
+void World::debugDraw(graphics::Graphics *gfx, uint32 flags)
+{
+	LOVE_PROFILE_ZONE("World:debugDraw");
+
+	uint32 b2flags = 0;
+	if (flags & DEBUGDRAW_SHAPES)
+		b2flags |= b2Draw::e_shapeBit;
+	if (flags & DEBUGDRAW_JOINTS)
+		b2flags |= b2Draw::e_jointBit;
+	if (flags & DEBUGDRAW_AABBS)
+		b2flags |= b2Draw::e_aabbBit;
+	if (flags & DEBUGDRAW_CENTERS_OF_MASS)
+		b2flags |= b2Draw::e_centerOfMassBit;
+
+	debugDrawer.SetFlags(b2flags);
+	debugDrawer.begin(gfx);
+
+	world->SetDebugDraw(&debugDrawer);
+	world->DrawDebugData();
+	world->SetDebugDraw(nullptr);
+
+	// Box2D doesn't draw contact points itself.
+	if (flags & DEBUGDRAW_CONTACTS)
+	{
+		b2Color color(0.9f, 0.9f, 0.3f);
+
+		for (b2Contact *c = world->GetContactList(); c != nullptr; c = c->GetNext())
+		{
+			if (!c->IsTouching())
+				continue;
+
+			b2WorldManifold manifold;
+			c->GetWorldManifold(&manifold);
+
+			int count = c->GetManifold()->pointCount;
+			for (int i = 0; i < count; i++)
+				debugDrawer.DrawPoint(manifold.points[i], 4.0f, color);
+		}
+	}
+
+	debugDrawer.end(gfx);
+}
+
 void World::destroy()
 {
 	if (world == nullptr)
 		return;
 
-	if (world->IsLocked())
+	if (isLocked())
 	{
 		destructWorld = true;
 		return;
 	}
 
+	// The queued callbacks are dropped along with the World.
+	waitForStep();
+	queuedContacts.clear();
+	contactEvents.clear();
+
 	// Remove userdata reference to avoid it sticking around after GC
 	if (begin.ref)     begin.ref->unref();
 	if (end.ref)       end.ref->unref();
@@ -586,9 +1668,9 @@ void World::destroy()
 		b = b->GetNext();
 		if (t == groundBody)
 			continue;
-		Body *body = (Body *)Memoizer::find(t);
+		Body *body = Body::fromBox2D(t);
 		if (!body)
-			throw love::Exception("A body has escaped Memoizer!");
+			throw love::Exception("A body has no love Body!");
 		body->destroy();
 	}
 
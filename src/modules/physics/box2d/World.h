@@ -25,15 +25,24 @@
 #include "common/Object.h"
 #include "common/runtime.h"
 #include "common/Reference.h"
+#include "common/StringMap.h"
+#include "thread/threads.h"
+#include "DebugDraw.h"
 
 // STD
 #include <vector>
+#include <string>
 
 // Box2D
 #include <Box2D/Box2D.h>
 
 namespace love
 {
+namespace graphics
+{
+class Graphics;
+}
+
 namespace physics
 {
 namespace box2d
@@ -68,6 +77,59 @@ public:
 
 	static love::Type type;
 
+	enum DebugDrawFlags
+	{
+		DEBUGDRAW_SHAPES = 1 << 0,
+		DEBUGDRAW_JOINTS = 1 << 1,
+		DEBUGDRAW_AABBS = 1 << 2,
+		DEBUGDRAW_CENTERS_OF_MASS = 1 << 3,
+		DEBUGDRAW_CONTACTS = 1 << 4,
+	};
+
+	enum CastMode
+	{
+		CAST_CLOSEST,
+		CAST_ALL,
+		CAST_ANY,
+		CAST_MAX_ENUM
+	};
+
+	enum CastShape
+	{
+		CAST_SHAPE_RAY,
+		CAST_SHAPE_CIRCLE,
+		CAST_SHAPE_BOX,
+		CAST_SHAPE_MAX_ENUM
+	};
+
+	struct CastOptions
+	{
+		CastMode mode = CAST_CLOSEST;
+		CastShape shape = CAST_SHAPE_RAY;
+
+		// Size of the cast shape. The box uses half extents.
+		float radius = 0.0f;
+		float halfWidth = 0.0f;
+		float halfHeight = 0.0f;
+		float angle = 0.0f;
+
+		// Only fixtures in one of these categories are hit.
+		uint16 categories = 0xFFFF;
+
+		bool parallel = true;
+	};
+
+	struct CastHit
+	{
+		int query;
+		b2Fixture *fixture;
+		b2Vec2 point;
+		b2Vec2 normal;
+		float fraction;
+	};
+
+	static const int CAST_QUERY_COMPONENTS = 4;
+
 	class ContactCallback
 	{
 	public:
@@ -76,6 +138,8 @@ public:
 		ContactCallback();
 		~ContactCallback();
 		void process(b2Contact *contact, const b2ContactImpulse *impulse = NULL);
+		// The contact may be null if it was destroyed before the callback.
+		void process(b2Fixture *fixtureA, b2Fixture *fixtureB, b2Contact *contact, const b2ContactImpulse *impulse);
 	};
 
 	class ContactFilter
@@ -110,6 +174,14 @@ public:
 		int funcidx;
 	};
 
+	static bool getConstant(const char *in, CastMode &out);
+	static bool getConstant(CastMode in, const char *&out);
+	static std::vector<std::string> getConstants(CastMode);
+
+	static bool getConstant(const char *in, CastShape &out);
+	static bool getConstant(CastShape in, const char *&out);
+	static std::vector<std::string> getConstants(CastShape);
+
 	/**
 	 * Creates a new world.
 	 **/
@@ -135,6 +207,49 @@ public:
 	void update(float dt);
 	void update(float dt, int velocityIterations, int positionIterations);
 
+	/**
+	 * Enables fixed timesteps when the timestep is positive. Updates then
+	 * accumulate time and take as many timesteps as fit, up to maxSubsteps;
+	 * time beyond that is dropped. The remainder is used to interpolate body
+	 * transforms between the last two timesteps.
+	 **/
+	void setFixedTimestep(float timestep, int maxSubsteps);
+	float getFixedTimestep() const;
+	int getMaxSubsteps() const;
+
+	/**
+	 * Gets how far the accumulated time is between the last fixed timestep
+	 * and the next one, in [0, 1).
+	 **/
+	float getInterpolationAlpha() const;
+
+	/**
+	 * Starts a timestep on a worker thread and returns immediately. While it
+	 * runs, Bodies report their position and velocity from before the step.
+	 * Contact callbacks are queued and called once the step is finished,
+	 * which happens the next time anything else in the World is used.
+	 * Worlds with a presolve callback or a contact filter are updated
+	 * immediately instead, since those have to run during the step.
+	 **/
+	void updateAsync(float dt, int velocityIterations, int positionIterations);
+
+	/**
+	 * Waits for a timestep started by updateAsync, then calls its queued
+	 * contact callbacks and destroys the objects they marked for destruction.
+	 **/
+	void finishStep();
+
+	/**
+	 * Returns whether a timestep started by updateAsync may still be running.
+	 **/
+	bool isStepping() const;
+
+	/**
+	 * Finishes the pending timestep of every World. Used for objects which
+	 * can't tell which World they belong to while it steps.
+	 **/
+	static void finishAllSteps();
+
 	// From b2ContactListener
 	void BeginContact(b2Contact *contact);
 	void EndContact(b2Contact *contact);
@@ -173,6 +288,26 @@ public:
 	 **/
 	void setCallbacksL(lua_State *L);
 
+	/**
+	 * Sets whether begin, end and postsolve contact events are recorded
+	 * natively and read in a batch with getContactEvents, instead of calling
+	 * the Lua callbacks for each contact. The presolve callback is unaffected.
+	 **/
+	void setContactBuffering(bool enable);
+	bool isContactBuffering() const;
+
+	/**
+	 * Fills a table with the contact events recorded by the last update,
+	 * as flat groups of 7 values: the event name, both Fixtures, the normal
+	 * and the summed normal and tangent impulses.
+	 **/
+	int getContactEvents(lua_State *L);
+
+	/**
+	 * Drops the recorded contact events which involve the fixture.
+	 **/
+	void removeContactEvents(b2Fixture *fixture);
+
 	/**
 	 * Sets the ContactFilter callback.
 	 **/
@@ -216,9 +351,19 @@ public:
 	 **/
 	bool isSleepingAllowed() const;
 
+	/**
+	 * Sets whether timesteps update contacts and solve independent groups of
+	 * touching bodies on several threads. The simulation is the same either
+	 * way, but postsolve callbacks are only called once every group has been
+	 * solved.
+	 **/
+	void setParallel(bool enable);
+	bool isParallel() const;
+
 	/**
 	 * Returns whether this World is currently locked.
-	 * If it's locked, it's in the middle of a timestep.
+	 * If it's locked, it's in the middle of a timestep, or calling the
+	 * queued callbacks of an asynchronous one.
 	 * @return Whether the World is locked.
 	 **/
 	bool isLocked() const;
@@ -247,6 +392,36 @@ public:
 	 **/
 	int getBodies(lua_State *L) const;
 
+	/**
+	 * Number of floats written or read per Body by the body state functions:
+	 * x, y, angle, x velocity, y velocity, angular velocity and awake (1 or
+	 * 0).
+	 **/
+	static const int BODY_STATE_COMPONENTS = 7;
+
+	/**
+	 * Writes the state of every Body, in the same order as getBodies, or of
+	 * the given Bodies. While the World steps asynchronously, the state from
+	 * before the step is written.
+	 **/
+	void getBodyStates(float *dst) const;
+	void getBodyStates(const std::vector<Body *> &bodies, float *dst) const;
+
+	/**
+	 * Like getBodyStates, but the position and angle are interpolated
+	 * between the last two fixed timesteps.
+	 **/
+	void getInterpolatedBodyStates(float *dst) const;
+	void getInterpolatedBodyStates(const std::vector<Body *> &bodies, float *dst) const;
+
+	/**
+	 * Sets the state of every kinematic Body, in the same order as
+	 * getBodies, or of the given Bodies. The states of other Bodies are
+	 * skipped when setting every Body, so the layout matches getBodyStates.
+	 **/
+	void setBodyStates(const float *src);
+	void setBodyStates(const std::vector<Body *> &bodies, const float *src);
+
 	/**
 	 * Get an array of all the Joints in the World.
 	 * @return An array of Joints.
@@ -275,6 +450,49 @@ public:
 	 **/
 	int rayCast(lua_State *L);
 
+	/**
+	 * Finds the fixtures in one of the categories whose bounding boxes
+	 * overlap the box, or whose shapes contain the point. Unlike
+	 * queryBoundingBox, nothing calls into Lua.
+	 **/
+	void getFixturesInArea(const b2AABB &box, uint16 categories, std::vector<b2Fixture *> &fixtures) const;
+	void getFixturesAtPoint(const b2Vec2 &point, uint16 categories, std::vector<b2Fixture *> &fixtures) const;
+
+	/**
+	 * Casts a batch of rays or shapes, each given by its start and end point
+	 * (CAST_QUERY_COMPONENTS floats). Hits are appended in query order, and
+	 * by distance within a query. Ray batches may run on several threads,
+	 * since the broadphase is only read.
+	 **/
+	void castBatch(const float *queries, int count, const CastOptions &options, std::vector<CastHit> &hits) const;
+
+	/**
+	 * Gets the number of bytes saveState needs for the current state.
+	 **/
+	size_t getStateSize() const;
+
+	/**
+	 * Saves the simulation state of the World for rollback: body motion,
+	 * contacts with their warm starting data, joint impulses and the
+	 * broad-phase. Settings like gravity or joint motors aren't saved.
+	 * Returns the number of bytes written.
+	 **/
+	size_t saveState(void *dst, size_t size) const;
+
+	/**
+	 * Restores a state from saveState. Stepping afterwards gives the same
+	 * results as it did after the save. The World must have the same bodies,
+	 * fixtures and joints as when the state was saved.
+	 **/
+	void restoreState(const void *src, size_t size);
+
+	/**
+	 * Draws the World's debug geometry with the current color, line width
+	 * and transform of the given Graphics, batched into a few stream draws.
+	 * @param flags A combination of DebugDrawFlags.
+	 **/
+	void debugDraw(graphics::Graphics *gfx, uint32 flags);
+
 	/**
 	 * Destroy this world.
 	 **/
@@ -282,6 +500,60 @@ public:
 
 private:
 
+	enum ContactEvent
+	{
+		CONTACT_BEGIN,
+		CONTACT_END,
+		CONTACT_POSTSOLVE,
+	};
+
+	// A contact callback recorded during an asynchronous timestep.
+	struct QueuedContact
+	{
+		ContactEvent event;
+		b2Contact *contact;
+		b2Fixture *fixtureA;
+		b2Fixture *fixtureB;
+		b2ContactImpulse impulse;
+	};
+
+	// A contact event recorded while contact buffering is enabled.
+	struct ContactRecord
+	{
+		ContactEvent event;
+		b2Fixture *fixtureA;
+		b2Fixture *fixtureB;
+		b2Vec2 normal;
+		float normalImpulse;
+		float tangentImpulse;
+	};
+
+	// Records the event if either fixture reports contacts.
+	void recordContact(ContactEvent event, b2Contact *contact, const b2ContactImpulse *impulse);
+
+	void castRay(int query, const b2Vec2 &p1, const b2Vec2 &p2, const CastOptions &options, std::vector<CastHit> &hits) const;
+	void castShape(int query, const b2Vec2 &p1, const b2Vec2 &p2, const b2Shape &shape, const CastOptions &options, std::vector<CastHit> &hits) const;
+
+	// Whether the contact still exists and is between the same fixtures.
+	bool isContactAlive(const QueuedContact &queued) const;
+
+	// Consumes accumulated time, returning the number of fixed timesteps to
+	// take.
+	int consumeFixedTime(float dt);
+
+	// Takes the timesteps, recording the transforms before the last one.
+	// Doesn't use the Memoizer, so it can run on a worker thread.
+	void stepSubsteps(int count, float dt, int velocityIterations, int positionIterations);
+
+	// Hands the recorded transforms to their Bodies.
+	void applyPreviousTransforms();
+
+	// Waits for the asynchronous timestep without calling its callbacks.
+	void waitForStep();
+
+	// Destroys the objects marked for destruction during a timestep.
+	void destroyMarked();
+
 	// Pointer to the Box2D world.
 	b2World *world;
 
@@ -297,6 +569,39 @@ private:
 	// Contact callbacks.
 	ContactCallback begin, end, presolve, postsolve;
 	ContactFilter filter;
+
+	// State of asynchronous timesteps. The listeners queue contacts instead
+	// of calling into Lua while asyncStep is set.
+	bool stepping;
+	bool stepDone;
+	bool asyncStep;
+	bool deliveringContacts;
+	std::string stepError;
+	std::vector<QueuedContact> queuedContacts;
+
+	// Fixed timestep state.
+	float fixedTimestep;
+	int maxSubsteps;
+	double accumulator;
+	std::vector<std::pair<b2Vec2, float>> previousTransforms;
+
+	// Contact events recorded during the last update, when buffering.
+	bool contactBuffering;
+	std::vector<ContactRecord> contactEvents;
+
+	// Reused between debugDraw calls to keep its vertex storage.
+	DebugDraw debugDrawer;
+
+	love::thread::MutexRef stepMutex;
+	love::thread::ConditionalRef stepCond;
+
+	static std::vector<World *> steppingWorlds;
+
+	static StringMap<CastMode, CAST_MAX_ENUM>::Entry castModeEntries[];
+	static StringMap<CastMode, CAST_MAX_ENUM> castModes;
+
+	static StringMap<CastShape, CAST_SHAPE_MAX_ENUM>::Entry castShapeEntries[];
+	static StringMap<CastShape, CAST_SHAPE_MAX_ENUM> castShapes;
 };
 
 } // box2d
@@ -21,6 +21,15 @@
 #include "wrap_Body.h"
 #include "wrap_Physics.h"
 
+// Shove the wrap_Body.lua code directly into a raw string literal.
+static const char body_lua[] =
+#include "wrap_Body.lua"
+;
+
+#ifdef LOVE_PRECOMPILED_LUA
+#include "luabytecode/body_lua.h"
+#endif
+
 namespace love
 {
 namespace physics
@@ -29,6 +38,18 @@ namespace box2d
 {
 
 Body *luax_checkbody(lua_State *L, int idx)
+{
+	Body *b = luax_checktype<Body>(L, idx);
+	if (b->body != 0 && b->getWorld() != nullptr)
+		luax_catchexcept(L, [&](){ b->getWorld()->finishStep(); });
+	if (b->body == 0)
+		luaL_error(L, "Attempt to use destroyed body.");
+	return b;
+}
+
+// Position and velocity can be read while the World steps asynchronously, so
+// the getters for them don't wait for the step.
+static Body *luax_checkbodystate(lua_State *L, int idx)
 {
 	Body *b = luax_checktype<Body>(L, idx);
 	if (b->body == 0)
@@ -38,28 +59,28 @@ Body *luax_checkbody(lua_State *L, int idx)
 
 int w_Body_getX(lua_State *L)
 {
-	Body *t = luax_checkbody(L, 1);
+	Body *t = luax_checkbodystate(L, 1);
 	lua_pushnumber(L, t->getX());
 	return 1;
 }
 
 int w_Body_getY(lua_State *L)
 {
-	Body *t = luax_checkbody(L, 1);
+	Body *t = luax_checkbodystate(L, 1);
 	lua_pushnumber(L, t->getY());
 	return 1;
 }
 
 int w_Body_getAngle(lua_State *L)
 {
-	Body *t = luax_checkbody(L, 1);
+	Body *t = luax_checkbodystate(L, 1);
 	lua_pushnumber(L, t->getAngle());
 	return 1;
 }
 
 int w_Body_getPosition(lua_State *L)
 {
-	Body *t = luax_checkbody(L, 1);
+	Body *t = luax_checkbodystate(L, 1);
 
 	float x_o, y_o;
 	t->getPosition(x_o, y_o);
@@ -71,7 +92,7 @@ int w_Body_getPosition(lua_State *L)
 
 int w_Body_getTransform(lua_State *L)
 {
-	Body *t = luax_checkbody(L, 1);
+	Body *t = luax_checkbodystate(L, 1);
 
 	float x_o, y_o;
 	t->getPosition(x_o, y_o);
@@ -84,7 +105,7 @@ int w_Body_getTransform(lua_State *L)
 
 int w_Body_getLinearVelocity(lua_State *L)
 {
-	Body *t = luax_checkbody(L, 1);
+	Body *t = luax_checkbodystate(L, 1);
 
 	float x_o, y_o;
 	t->getLinearVelocity(x_o, y_o);
@@ -96,7 +117,7 @@ int w_Body_getLinearVelocity(lua_State *L)
 
 int w_Body_getWorldCenter(lua_State *L)
 {
-	Body *t = luax_checkbody(L, 1);
+	Body *t = luax_checkbodystate(L, 1);
 
 	float x_o, y_o;
 	t->getWorldCenter(x_o, y_o);
@@ -120,7 +141,7 @@ int w_Body_getLocalCenter(lua_State *L)
 
 int w_Body_getAngularVelocity(lua_State *L)
 {
-	Body *t = luax_checkbody(L, 1);
+	Body *t = luax_checkbodystate(L, 1);
 	lua_pushnumber(L, t->getAngularVelocity());
 	return 1;
 }
@@ -383,7 +404,7 @@ int w_Body_setType(lua_State *L)
 
 int w_Body_getWorldPoint(lua_State *L)
 {
-	Body *t = luax_checkbody(L, 1);
+	Body *t = luax_checkbodystate(L, 1);
 
 	float x = (float)luaL_checknumber(L, 2);
 	float y = (float)luaL_checknumber(L, 3);
@@ -397,7 +418,7 @@ int w_Body_getWorldPoint(lua_State *L)
 
 int w_Body_getWorldVector(lua_State *L)
 {
-	Body *t = luax_checkbody(L, 1);
+	Body *t = luax_checkbodystate(L, 1);
 
 	float x = (float)luaL_checknumber(L, 2);
 	float y = (float)luaL_checknumber(L, 3);
@@ -411,14 +432,14 @@ int w_Body_getWorldVector(lua_State *L)
 
 int w_Body_getWorldPoints(lua_State *L)
 {
-	Body *t = luax_checkbody(L, 1);
+	Body *t = luax_checkbodystate(L, 1);
 	lua_remove(L, 1);
 	return t->getWorldPoints(L);
 }
 
 int w_Body_getLocalPoint(lua_State *L)
 {
-	Body *t = luax_checkbody(L, 1);
+	Body *t = luax_checkbodystate(L, 1);
 
 	float x = (float)luaL_checknumber(L, 2);
 	float y = (float)luaL_checknumber(L, 3);
@@ -432,7 +453,7 @@ int w_Body_getLocalPoint(lua_State *L)
 
 int w_Body_getLocalVector(lua_State *L)
 {
-	Body *t = luax_checkbody(L, 1);
+	Body *t = luax_checkbodystate(L, 1);
 
 	float x = (float)luaL_checknumber(L, 2);
 	float y = (float)luaL_checknumber(L, 3);
@@ -637,6 +658,29 @@ int w_Body_getContactList(lua_State *L)
 	return w_Body_getContacts(L);
 }
 
+// C functions in a struct, necessary for the FFI versions of Body methods.
+struct FFI_Body
+{
+	bool (*getPosition)(Proxy *p, float *result);
+};
+
+static FFI_Body ffifuncs =
+{
+	[](Proxy *p, float *result) -> bool // getPosition
+	{
+		// Destroyed Bodies are reported by the Lua C API version.
+		if (p == nullptr || p->object == nullptr || p->type == nullptr || !p->type->isa(Body::type))
+			return false;
+
+		Body *b = (Body *) p->object;
+		if (b->body == 0)
+			return false;
+
+		b->getPosition(result[0], result[1]);
+		return true;
+	},
+};
+
 static const luaL_Reg w_Body_functions[] =
 {
 	{ "getX", w_Body_getX },
@@ -711,7 +755,24 @@ static const luaL_Reg w_Body_functions[] =
 
 extern "C" int luaopen_body(lua_State *L)
 {
-	return luax_register_type(L, &Body::type, w_Body_functions, nullptr);
+	int ret = luax_register_type(L, &Body::type, w_Body_functions, nullptr);
+
+	luax_gettypemetatable(L, Body::type);
+
+	// Load and execute wrap_Body.lua, sending the metatable and the ffi
+	// functions struct pointer as arguments.
+	if (lua_istable(L, -1))
+	{
+		luax_loadembedded(L, LOVE_EMBEDDED_BYTECODE(body_lua), body_lua, sizeof(body_lua), "wrap_Body.lua");
+		lua_pushvalue(L, -2);
+		lua_pushlightuserdata(L, &ffifuncs);
+		lua_call(L, 2, 0);
+	}
+
+	// Pop the metatable.
+	lua_pop(L, 1);
+
+	return ret;
 }
 
 } // box2d
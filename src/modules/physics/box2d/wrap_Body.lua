@@ -0,0 +1,68 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2018 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+
+local Body_mt, ffifuncspointer = ...
+local Body = Body_mt.__index
+
+local type, tonumber = type, tonumber
+
+-- Everything below this point is efficient FFI replacements for existing
+-- Body functionality. Calls they don't handle go through the regular methods
+-- instead, which also raise any errors.
+
+if type(jit) ~= "table" or not jit.status() then
+	-- LuaJIT's FFI is *much* slower than LOVE's regular methods when the JIT
+	-- compiler is disabled.
+	return
+end
+
+local status, ffi = pcall(require, "ffi")
+if not status then return end
+
+pcall(ffi.cdef, [[
+typedef struct Proxy Proxy;
+
+typedef struct FFI_Body
+{
+	bool (*getPosition)(Proxy *p, float *result);
+} FFI_Body;
+]])
+
+local ffifuncs = ffi.cast("FFI_Body *", ffifuncspointer)
+
+-- Reused for every call, the result is copied out right away.
+local position = ffi.new("float[2]")
+
+local getPosition_C = Body.getPosition
+
+function Body:getPosition()
+	if type(self) == "userdata" and ffifuncs.getPosition(self, position) then
+		return tonumber(position[0]), tonumber(position[1])
+	end
+	return getPosition_C(self)
+end
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
@@ -0,0 +1,163 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_ChainTerrain.h"
+#include "Physics.h"
+
+// C++
+#include <algorithm>
+
+namespace love
+{
+namespace physics
+{
+namespace box2d
+{
+
+ChainTerrain *luax_checkchainterrain(lua_State *L, int idx)
+{
+	ChainTerrain *t = luax_checktype<ChainTerrain>(L, idx);
+	Body *body = t->getBody();
+	if (!t->isDestroyed() && body->body != nullptr)
+		luax_catchexcept(L, [&](){ body->getWorld()->finishStep(); });
+	return t;
+}
+
+int w_ChainTerrain_setVertices(lua_State *L)
+{
+	ChainTerrain *t = luax_checkchainterrain(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+
+	luax_catchexcept(L, [&]()
+	{
+		std::vector<b2Vec2> vertices;
+		Physics::checkVertices(L, 3, vertices);
+
+		// By default the new vertices overwrite the same number of old ones.
+		int count = (int) t->getVertices().size();
+		int removeCount = std::max(std::min((int) vertices.size(), count - index), 0);
+		if (!lua_isnoneornil(L, 4))
+			removeCount = (int) luaL_checkinteger(L, 4);
+
+		t->setVertices(L, index, removeCount, vertices);
+	});
+
+	return 0;
+}
+
+int w_ChainTerrain_getVertices(lua_State *L)
+{
+	ChainTerrain *t = luax_checkchainterrain(L, 1);
+	const std::vector<b2Vec2> &vertices = t->getVertices();
+
+	lua_createtable(L, (int) vertices.size() * 2, 0);
+	for (int i = 0; i < (int) vertices.size(); i++)
+	{
+		b2Vec2 v = Physics::scaleUp(vertices[i]);
+		lua_pushnumber(L, v.x);
+		lua_rawseti(L, -2, i * 2 + 1);
+		lua_pushnumber(L, v.y);
+		lua_rawseti(L, -2, i * 2 + 2);
+	}
+
+	return 1;
+}
+
+int w_ChainTerrain_getVertexCount(lua_State *L)
+{
+	ChainTerrain *t = luax_checkchainterrain(L, 1);
+	lua_pushinteger(L, (lua_Integer) t->getVertices().size());
+	return 1;
+}
+
+int w_ChainTerrain_getSegmentCount(lua_State *L)
+{
+	ChainTerrain *t = luax_checkchainterrain(L, 1);
+	lua_pushinteger(L, t->getSegmentCount());
+	return 1;
+}
+
+int w_ChainTerrain_getSegmentSize(lua_State *L)
+{
+	ChainTerrain *t = luax_checkchainterrain(L, 1);
+	lua_pushinteger(L, t->getSegmentSize());
+	return 1;
+}
+
+int w_ChainTerrain_getFixtures(lua_State *L)
+{
+	ChainTerrain *t = luax_checkchainterrain(L, 1);
+	int count = t->getSegmentCount();
+
+	lua_createtable(L, count, 0);
+	for (int i = 0; i < count; i++)
+	{
+		Fixture *f = nullptr;
+		luax_catchexcept(L, [&](){ f = t->getSegmentFixture(i); });
+		luax_pushtype(L, f);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
+int w_ChainTerrain_getBody(lua_State *L)
+{
+	ChainTerrain *t = luax_checkchainterrain(L, 1);
+	luax_pushtype(L, t->getBody());
+	return 1;
+}
+
+int w_ChainTerrain_destroy(lua_State *L)
+{
+	ChainTerrain *t = luax_checkchainterrain(L, 1);
+	luax_catchexcept(L, [&](){ t->destroy(); });
+	return 0;
+}
+
+int w_ChainTerrain_isDestroyed(lua_State *L)
+{
+	ChainTerrain *t = luax_checktype<ChainTerrain>(L, 1);
+	luax_pushboolean(L, t->isDestroyed());
+	return 1;
+}
+
+static const luaL_Reg w_ChainTerrain_functions[] =
+{
+	{ "setVertices", w_ChainTerrain_setVertices },
+	{ "getVertices", w_ChainTerrain_getVertices },
+	{ "getVertexCount", w_ChainTerrain_getVertexCount },
+	{ "getSegmentCount", w_ChainTerrain_getSegmentCount },
+	{ "getSegmentSize", w_ChainTerrain_getSegmentSize },
+	{ "getFixtures", w_ChainTerrain_getFixtures },
+	{ "getBody", w_ChainTerrain_getBody },
+	{ "destroy", w_ChainTerrain_destroy },
+	{ "isDestroyed", w_ChainTerrain_isDestroyed },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_chainterrain(lua_State *L)
+{
+	return luax_register_type(L, &ChainTerrain::type, w_ChainTerrain_functions, nullptr);
+}
+
+} // box2d
+} // physics
+} // love
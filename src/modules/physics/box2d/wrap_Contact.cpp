@@ -31,6 +31,8 @@ namespace box2d
 Contact *luax_checkcontact(lua_State *L, int idx)
 {
 	Contact *c = luax_checktype<Contact>(L, idx);
+	// Contacts can be destroyed by a step, and don't know their World.
+	luax_catchexcept(L, [&](){ World::finishAllSteps(); });
 	if (!c->isValid())
 		luaL_error(L, "Attempt to use destroyed contact.");
 	return c;
@@ -31,6 +31,8 @@ namespace box2d
 Fixture *luax_checkfixture(lua_State *L, int idx)
 {
 	Fixture *f = luax_checktype<Fixture>(L, idx);
+	if (f->isValid())
+		luax_catchexcept(L, [&](){ f->getBody()->getWorld()->finishStep(); });
 	if (!f->isValid())
 		luaL_error(L, "Attempt to use destroyed fixture.");
 	return f;
@@ -105,6 +107,20 @@ int w_Fixture_isSensor(lua_State *L)
 	return 1;
 }
 
+int w_Fixture_setContactReported(lua_State *L)
+{
+	Fixture *t = luax_checkfixture(L, 1);
+	t->setContactReported(luax_checkboolean(L, 2));
+	return 0;
+}
+
+int w_Fixture_isContactReported(lua_State *L)
+{
+	Fixture *t = luax_checkfixture(L, 1);
+	luax_pushboolean(L, t->isContactReported());
+	return 1;
+}
+
 int w_Fixture_getBody(lua_State *L)
 {
 	Fixture *t = luax_checkfixture(L, 1);
@@ -281,6 +297,8 @@ static const luaL_Reg w_Fixture_functions[] =
 	{ "getBody", w_Fixture_getBody },
 	{ "getShape", w_Fixture_getShape },
 	{ "isSensor", w_Fixture_isSensor },
+	{ "setContactReported", w_Fixture_setContactReported },
+	{ "isContactReported", w_Fixture_isContactReported },
 	{ "testPoint", w_Fixture_testPoint },
 	{ "rayCast", w_Fixture_rayCast },
 	{ "setFilterData", w_Fixture_setFilterData },
@@ -22,6 +22,7 @@
 #include "wrap_Joint.h"
 #include "common/StringMap.h"
 #include "Body.h"
+#include "World.h"
 #include "DistanceJoint.h"
 #include "RevoluteJoint.h"
 #include "PrismaticJoint.h"
@@ -78,6 +79,8 @@ void luax_pushjoint(lua_State *L, Joint *j)
 Joint *luax_checkjoint(lua_State *L, int idx)
 {
 	Joint *t = luax_checktype<Joint>(L, idx);
+	if (t->isValid())
+		luax_catchexcept(L, [&](){ t->getWorld()->finishStep(); });
 	if (!t->isValid())
 		luaL_error(L, "Attempt to use destroyed joint.");
 	return t;
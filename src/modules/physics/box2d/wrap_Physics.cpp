@@ -29,6 +29,7 @@
 #include "wrap_PolygonShape.h"
 #include "wrap_EdgeShape.h"
 #include "wrap_ChainShape.h"
+#include "wrap_ChainTerrain.h"
 #include "wrap_Joint.h"
 #include "wrap_MouseJoint.h"
 #include "wrap_DistanceJoint.h"
@@ -181,6 +182,22 @@ int w_newChainShape(lua_State *L)
 	return ret;
 }
 
+int w_newChainTerrain(lua_State *L)
+{
+	Body *body = luax_checkbody(L, 1);
+	int segmentSize = (int) luaL_optinteger(L, 3, 32);
+	ChainTerrain *terrain = nullptr;
+	luax_catchexcept(L, [&]()
+	{
+		std::vector<b2Vec2> vertices;
+		Physics::checkVertices(L, 2, vertices);
+		terrain = instance()->newChainTerrain(body, vertices, segmentSize);
+	});
+	luax_pushtype(L, terrain);
+	terrain->release();
+	return 1;
+}
+
 int w_newDistanceJoint(lua_State *L)
 {
 	Body *body1 = luax_checkbody(L, 1);
@@ -493,6 +510,7 @@ static const luaL_Reg functions[] =
 	{ "newPolygonShape", w_newPolygonShape },
 	{ "newEdgeShape", w_newEdgeShape },
 	{ "newChainShape", w_newChainShape },
+	{ "newChainTerrain", w_newChainTerrain },
 	{ "newDistanceJoint", w_newDistanceJoint },
 	{ "newMouseJoint", w_newMouseJoint },
 	{ "newRevoluteJoint", w_newRevoluteJoint },
@@ -521,6 +539,7 @@ static const lua_CFunction types[] =
 	luaopen_polygonshape,
 	luaopen_edgeshape,
 	luaopen_chainshape,
+	luaopen_chainterrain,
 	luaopen_joint,
 	luaopen_mousejoint,
 	luaopen_distancejoint,
@@ -19,6 +19,14 @@
  **/
 
 #include "wrap_World.h"
+#include "Fixture.h"
+#include "common/Data.h"
+#include "graphics/Graphics.h"
+
+// C++
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
 
 namespace love
 {
@@ -30,6 +38,7 @@ namespace box2d
 World *luax_checkworld(lua_State *L, int idx)
 {
 	World *w = luax_checktype<World>(L, idx);
+	luax_catchexcept(L, [&](){ w->finishStep(); });
 	if (!w->isValid())
 		luaL_error(L, "Attempt to use destroyed world.");
 	return w;
@@ -55,6 +64,55 @@ int w_World_update(lua_State *L)
 	return 0;
 }
 
+int w_World_setFixedTimestep(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	float timestep = (float) luaL_optnumber(L, 2, 0.0);
+	int maxsubsteps = (int) luaL_optinteger(L, 3, 8);
+	luax_catchexcept(L, [&](){ t->setFixedTimestep(timestep, maxsubsteps); });
+	return 0;
+}
+
+int w_World_getFixedTimestep(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	lua_pushnumber(L, t->getFixedTimestep());
+	lua_pushinteger(L, t->getMaxSubsteps());
+	return 2;
+}
+
+int w_World_getInterpolationAlpha(lua_State *L)
+{
+	// Known as soon as an asynchronous step starts, so it isn't finished.
+	World *t = luax_checktype<World>(L, 1);
+	if (!t->isValid())
+		return luaL_error(L, "Attempt to use destroyed world.");
+
+	lua_pushnumber(L, t->getInterpolationAlpha());
+	return 1;
+}
+
+int w_World_updateAsync(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	float dt = (float)luaL_checknumber(L, 2);
+	int velocityiterations = (int) luaL_optinteger(L, 3, 8);
+	int positioniterations = (int) luaL_optinteger(L, 4, 3);
+
+	// The queued callbacks are called on the calling Lua thread.
+	t->setCallbacksL(L);
+
+	luax_catchexcept(L, [&](){ t->updateAsync(dt, velocityiterations, positioniterations); });
+	return 0;
+}
+
+int w_World_finishUpdate(lua_State *L)
+{
+	// Checking the World finishes its pending update.
+	luax_checkworld(L, 1);
+	return 0;
+}
+
 int w_World_setCallbacks(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -83,6 +141,29 @@ int w_World_getContactFilter(lua_State *L)
 	return t->getContactFilter(L);
 }
 
+int w_World_setContactBuffering(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	t->setContactBuffering(luax_checkboolean(L, 2));
+	return 0;
+}
+
+int w_World_isContactBuffering(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	luax_pushboolean(L, t->isContactBuffering());
+	return 1;
+}
+
+int w_World_getContactEvents(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	lua_remove(L, 1);
+	int ret = 0;
+	luax_catchexcept(L, [&](){ ret = t->getContactEvents(L); });
+	return ret;
+}
+
 int w_World_setGravity(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -123,6 +204,20 @@ int w_World_isSleepingAllowed(lua_State *L)
 	return 1;
 }
 
+int w_World_setParallel(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	t->setParallel(luax_checkboolean(L, 2));
+	return 0;
+}
+
+int w_World_isParallel(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	luax_pushboolean(L, t->isParallel());
+	return 1;
+}
+
 int w_World_isLocked(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -160,6 +255,101 @@ int w_World_getBodies(lua_State *L)
 	return ret;
 }
 
+static void luax_checkbodystatelist(lua_State *L, int idx, World *world, std::vector<Body *> &bodies)
+{
+	luaL_checktype(L, idx, LUA_TTABLE);
+	int count = (int) luax_objlen(L, idx);
+	bodies.reserve(count);
+
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, idx, i);
+		Body *b = luax_checktype<Body>(L, -1);
+		if (b->body == 0)
+			luaL_error(L, "Attempt to use destroyed body.");
+		if (b->getWorld() != world)
+			luaL_error(L, "Body at index %d does not belong to this World.", i);
+		bodies.push_back(b);
+		lua_pop(L, 1);
+	}
+}
+
+static float *luax_checkbodystatedata(lua_State *L, int idx, int bodycount)
+{
+	Data *data = luax_checktype<Data>(L, idx);
+	size_t needed = (size_t) bodycount * World::BODY_STATE_COMPONENTS * sizeof(float);
+
+	if (data->getSize() < needed)
+		luaL_error(L, "Data is too small to hold the states of %d bodies (needs %d bytes.)", bodycount, (int) needed);
+
+	return (float *) data->getData();
+}
+
+static int w_World_getStates(lua_State *L, bool interpolated)
+{
+	// Doesn't finish an asynchronous step: the state from before it is used.
+	World *t = luax_checktype<World>(L, 1);
+	if (!t->isValid())
+		return luaL_error(L, "Attempt to use destroyed world.");
+
+	if (lua_isnoneornil(L, 3))
+	{
+		int count = t->getBodyCount();
+		float *dst = luax_checkbodystatedata(L, 2, count);
+		if (interpolated)
+			luax_catchexcept(L, [&](){ t->getInterpolatedBodyStates(dst); });
+		else
+			luax_catchexcept(L, [&](){ t->getBodyStates(dst); });
+		lua_pushinteger(L, count);
+	}
+	else
+	{
+		std::vector<Body *> bodies;
+		luax_checkbodystatelist(L, 3, t, bodies);
+		float *dst = luax_checkbodystatedata(L, 2, (int) bodies.size());
+		if (interpolated)
+			luax_catchexcept(L, [&](){ t->getInterpolatedBodyStates(bodies, dst); });
+		else
+			luax_catchexcept(L, [&](){ t->getBodyStates(bodies, dst); });
+		lua_pushinteger(L, (lua_Integer) bodies.size());
+	}
+
+	return 1;
+}
+
+int w_World_getBodyStates(lua_State *L)
+{
+	return w_World_getStates(L, false);
+}
+
+int w_World_getInterpolatedBodyStates(lua_State *L)
+{
+	return w_World_getStates(L, true);
+}
+
+int w_World_setBodyStates(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+
+	if (lua_isnoneornil(L, 3))
+	{
+		int count = t->getBodyCount();
+		const float *src = luax_checkbodystatedata(L, 2, count);
+		luax_catchexcept(L, [&](){ t->setBodyStates(src); });
+		lua_pushinteger(L, count);
+	}
+	else
+	{
+		std::vector<Body *> bodies;
+		luax_checkbodystatelist(L, 3, t, bodies);
+		const float *src = luax_checkbodystatedata(L, 2, (int) bodies.size());
+		luax_catchexcept(L, [&](){ t->setBodyStates(bodies, src); });
+		lua_pushinteger(L, (lua_Integer) bodies.size());
+	}
+
+	return 1;
+}
+
 int w_World_getJoints(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -194,6 +384,320 @@ int w_World_rayCast(lua_State *L)
 	return ret;
 }
 
+static uint16 luax_checkcategories(lua_State *L, int idx)
+{
+	luaL_checktype(L, idx, LUA_TTABLE);
+	uint16 categories = 0;
+
+	int count = (int) luax_objlen(L, idx);
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, idx, i);
+		int category = (int) luaL_checkinteger(L, -1);
+		if (category < 1 || category > 16)
+			luaL_error(L, "Values must be in range 1-16.");
+		categories |= (uint16) (1 << (category - 1));
+		lua_pop(L, 1);
+	}
+
+	return categories;
+}
+
+// Replaces the contents of the table at idx, or of a new table pushed onto the
+// stack, with the objects of the fixtures or their bodies.
+static int luax_pushfixturelist(lua_State *L, int idx, const std::vector<b2Fixture *> &fixtures, bool bodies)
+{
+	int oldlength = 0;
+
+	if (lua_istable(L, idx))
+	{
+		oldlength = (int) luax_objlen(L, idx);
+		lua_pushvalue(L, idx);
+	}
+	else
+		lua_createtable(L, (int) fixtures.size(), 0);
+
+	std::unordered_set<b2Body *> seen;
+
+	int i = 1;
+	for (size_t j = 0; j < fixtures.size(); j++)
+	{
+		if (bodies)
+		{
+			b2Body *b = fixtures[j]->GetBody();
+			if (!seen.insert(b).second)
+				continue;
+
+			Body *body = Body::fromBox2D(b);
+			if (body == nullptr)
+				return luaL_error(L, "A body has no love Body!");
+			luax_pushtype(L, body);
+		}
+		else
+		{
+			Fixture *fixture = Fixture::fromBox2D(fixtures[j]);
+			if (fixture == nullptr)
+				return luaL_error(L, "A fixture has no love Fixture!");
+			luax_pushtype(L, fixture);
+		}
+
+		lua_rawseti(L, -2, i++);
+	}
+
+	for (int j = oldlength; j >= i; j--)
+	{
+		lua_pushnil(L);
+		lua_rawseti(L, -2, j);
+	}
+
+	return 1;
+}
+
+static int w_World_getInArea(lua_State *L, bool bodies)
+{
+	World *t = luax_checkworld(L, 1);
+	float lx = (float) luaL_checknumber(L, 2);
+	float ly = (float) luaL_checknumber(L, 3);
+	float ux = (float) luaL_checknumber(L, 4);
+	float uy = (float) luaL_checknumber(L, 5);
+	uint16 categories = lua_isnoneornil(L, 6) ? 0xFFFF : luax_checkcategories(L, 6);
+
+	b2AABB box;
+	box.lowerBound = Physics::scaleDown(b2Vec2(std::min(lx, ux), std::min(ly, uy)));
+	box.upperBound = Physics::scaleDown(b2Vec2(std::max(lx, ux), std::max(ly, uy)));
+
+	std::vector<b2Fixture *> fixtures;
+	luax_catchexcept(L, [&](){ t->getFixturesInArea(box, categories, fixtures); });
+
+	return luax_pushfixturelist(L, 7, fixtures, bodies);
+}
+
+int w_World_getFixturesInArea(lua_State *L)
+{
+	return w_World_getInArea(L, false);
+}
+
+int w_World_getBodiesInArea(lua_State *L)
+{
+	return w_World_getInArea(L, true);
+}
+
+int w_World_getFixturesAtPoint(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	float x = (float) luaL_checknumber(L, 2);
+	float y = (float) luaL_checknumber(L, 3);
+	uint16 categories = lua_isnoneornil(L, 4) ? 0xFFFF : luax_checkcategories(L, 4);
+
+	std::vector<b2Fixture *> fixtures;
+	luax_catchexcept(L, [&](){ t->getFixturesAtPoint(Physics::scaleDown(b2Vec2(x, y)), categories, fixtures); });
+
+	return luax_pushfixturelist(L, 5, fixtures, false);
+}
+
+static void luax_checkcastoptions(lua_State *L, int idx, World::CastOptions &options)
+{
+	if (lua_isnoneornil(L, idx))
+		return;
+
+	luaL_checktype(L, idx, LUA_TTABLE);
+
+	lua_getfield(L, idx, "mode");
+	if (!lua_isnoneornil(L, -1))
+	{
+		const char *str = luaL_checkstring(L, -1);
+		if (!World::getConstant(str, options.mode))
+			luax_enumerror(L, "cast mode", World::getConstants(options.mode), str);
+	}
+	lua_pop(L, 1);
+
+	lua_getfield(L, idx, "shape");
+	if (!lua_isnoneornil(L, -1))
+	{
+		const char *str = luaL_checkstring(L, -1);
+		if (!World::getConstant(str, options.shape))
+			luax_enumerror(L, "cast shape", World::getConstants(options.shape), str);
+	}
+	lua_pop(L, 1);
+
+	options.radius = (float) luax_numberflag(L, idx, "radius", 0.0);
+	options.halfWidth = (float) luax_numberflag(L, idx, "width", 0.0) * 0.5f;
+	options.halfHeight = (float) luax_numberflag(L, idx, "height", 0.0) * 0.5f;
+	options.angle = (float) luax_numberflag(L, idx, "angle", 0.0);
+	options.parallel = luax_boolflag(L, idx, "parallel", options.parallel);
+
+	if (options.shape == World::CAST_SHAPE_CIRCLE && options.radius <= 0.0f)
+		luaL_error(L, "Circle casts need a positive radius.");
+	if (options.shape == World::CAST_SHAPE_BOX && (options.halfWidth <= 0.0f || options.halfHeight <= 0.0f))
+		luaL_error(L, "Box casts need a positive width and height.");
+
+	lua_getfield(L, idx, "categories");
+	if (!lua_isnoneornil(L, -1))
+		options.categories = luax_checkcategories(L, lua_gettop(L));
+	lua_pop(L, 1);
+}
+
+int w_World_rayCastBatch(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+
+	// Queries are read from Data, or from a flat table of numbers.
+	std::vector<float> tablequeries;
+	const float *queries = nullptr;
+	int count = 0;
+
+	if (lua_istable(L, 2))
+	{
+		int length = (int) luax_objlen(L, 2);
+		count = length / World::CAST_QUERY_COMPONENTS;
+		tablequeries.resize(count * World::CAST_QUERY_COMPONENTS);
+
+		for (size_t i = 0; i < tablequeries.size(); i++)
+		{
+			lua_rawgeti(L, 2, (int) i + 1);
+			tablequeries[i] = (float) luaL_checknumber(L, -1);
+			lua_pop(L, 1);
+		}
+
+		queries = tablequeries.data();
+	}
+	else
+	{
+		Data *data = luax_checktype<Data>(L, 2);
+		count = (int) (data->getSize() / (World::CAST_QUERY_COMPONENTS * sizeof(float)));
+		queries = (const float *) data->getData();
+	}
+
+	Data *results = luax_checktype<Data>(L, 3);
+
+	World::CastOptions options;
+	luax_checkcastoptions(L, 4, options);
+
+	std::vector<World::CastHit> hits;
+	luax_catchexcept(L, [&](){ t->castBatch(queries, count, options, hits); });
+
+	// Each hit is written as 6 floats: the query index (starting at 1), the
+	// point, the normal and the fraction.
+	const int components = 6;
+	size_t capacity = results->getSize() / (components * sizeof(float));
+	size_t written = std::min(capacity, hits.size());
+	char *dst = (char *) results->getData();
+
+	for (size_t i = 0; i < written; i++)
+	{
+		const World::CastHit &hit = hits[i];
+		float values[components] =
+		{
+			(float) (hit.query + 1), hit.point.x, hit.point.y,
+			hit.normal.x, hit.normal.y, hit.fraction,
+		};
+		memcpy(dst + i * sizeof(values), values, sizeof(values));
+	}
+
+	// The Fixtures which were hit can optionally be stored in a table.
+	bool hasfixtures = false;
+	if (!lua_isnoneornil(L, 4))
+	{
+		lua_getfield(L, 4, "fixtures");
+		hasfixtures = lua_istable(L, -1);
+		if (!hasfixtures)
+			lua_pop(L, 1);
+	}
+
+	if (hasfixtures)
+	{
+		int oldlength = (int) luax_objlen(L, -1);
+
+		for (size_t i = 0; i < written; i++)
+		{
+			Fixture *f = Fixture::fromBox2D(hits[i].fixture);
+			if (f == nullptr)
+				return luaL_error(L, "A fixture has no love Fixture!");
+			luax_pushtype(L, f);
+			lua_rawseti(L, -2, (int) i + 1);
+		}
+
+		for (int i = oldlength; i > (int) written; i--)
+		{
+			lua_pushnil(L);
+			lua_rawseti(L, -2, i);
+		}
+
+		lua_pop(L, 1);
+	}
+
+	lua_pushinteger(L, (lua_Integer) written);
+	lua_pushinteger(L, (lua_Integer) hits.size());
+	return 2;
+}
+
+int w_World_getStateSize(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	lua_pushinteger(L, (lua_Integer) t->getStateSize());
+	return 1;
+}
+
+int w_World_saveState(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	Data *data = luax_checktype<Data>(L, 2);
+	lua_Integer offset = luaL_optinteger(L, 3, 0);
+
+	if (offset < 0 || (size_t) offset > data->getSize())
+		return luaL_error(L, "Invalid Data offset: %d", (int) offset);
+
+	size_t written = 0;
+	luax_catchexcept(L, [&](){ written = t->saveState((char *) data->getData() + offset, data->getSize() - (size_t) offset); });
+
+	lua_pushinteger(L, (lua_Integer) written);
+	return 1;
+}
+
+int w_World_restoreState(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	Data *data = luax_checktype<Data>(L, 2);
+	lua_Integer offset = luaL_optinteger(L, 3, 0);
+
+	if (offset < 0 || (size_t) offset > data->getSize())
+		return luaL_error(L, "Invalid Data offset: %d", (int) offset);
+
+	luax_catchexcept(L, [&](){ t->restoreState((const char *) data->getData() + offset, data->getSize() - (size_t) offset); });
+	return 0;
+}
+
+int w_World_debugDraw(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+
+	uint32 flags = World::DEBUGDRAW_SHAPES | World::DEBUGDRAW_JOINTS;
+
+	if (!lua_isnoneornil(L, 2))
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+
+		flags = 0;
+		if (luax_boolflag(L, 2, "shapes", true))
+			flags |= World::DEBUGDRAW_SHAPES;
+		if (luax_boolflag(L, 2, "joints", true))
+			flags |= World::DEBUGDRAW_JOINTS;
+		if (luax_boolflag(L, 2, "aabbs", false))
+			flags |= World::DEBUGDRAW_AABBS;
+		if (luax_boolflag(L, 2, "centersofmass", false))
+			flags |= World::DEBUGDRAW_CENTERS_OF_MASS;
+		if (luax_boolflag(L, 2, "contacts", false))
+			flags |= World::DEBUGDRAW_CONTACTS;
+	}
+
+	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
+	if (gfx == nullptr)
+		return luaL_error(L, "love.graphics must be loaded to draw a World.");
+
+	luax_catchexcept(L, [&](){ t->debugDraw(gfx, flags); });
+	return 0;
+}
+
 int w_World_destroy(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -229,24 +733,45 @@ int w_World_getContactList(lua_State *L)
 static const luaL_Reg w_World_functions[] =
 {
 	{ "update", w_World_update },
+	{ "updateAsync", w_World_updateAsync },
+	{ "setFixedTimestep", w_World_setFixedTimestep },
+	{ "getFixedTimestep", w_World_getFixedTimestep },
+	{ "getInterpolationAlpha", w_World_getInterpolationAlpha },
+	{ "finishUpdate", w_World_finishUpdate },
 	{ "setCallbacks", w_World_setCallbacks },
 	{ "getCallbacks", w_World_getCallbacks },
 	{ "setContactFilter", w_World_setContactFilter },
 	{ "getContactFilter", w_World_getContactFilter },
+	{ "setContactBuffering", w_World_setContactBuffering },
+	{ "isContactBuffering", w_World_isContactBuffering },
+	{ "getContactEvents", w_World_getContactEvents },
 	{ "setGravity", w_World_setGravity },
 	{ "getGravity", w_World_getGravity },
 	{ "translateOrigin", w_World_translateOrigin },
 	{ "setSleepingAllowed", w_World_setSleepingAllowed },
 	{ "isSleepingAllowed", w_World_isSleepingAllowed },
+	{ "setParallel", w_World_setParallel },
+	{ "isParallel", w_World_isParallel },
 	{ "isLocked", w_World_isLocked },
 	{ "getBodyCount", w_World_getBodyCount },
 	{ "getJointCount", w_World_getJointCount },
 	{ "getContactCount", w_World_getContactCount },
 	{ "getBodies", w_World_getBodies },
+	{ "getBodyStates", w_World_getBodyStates },
+	{ "getInterpolatedBodyStates", w_World_getInterpolatedBodyStates },
+	{ "setBodyStates", w_World_setBodyStates },
 	{ "getJoints", w_World_getJoints },
 	{ "getContacts", w_World_getContacts },
 	{ "queryBoundingBox", w_World_queryBoundingBox },
+	{ "getFixturesInArea", w_World_getFixturesInArea },
+	{ "getBodiesInArea", w_World_getBodiesInArea },
+	{ "getFixturesAtPoint", w_World_getFixturesAtPoint },
 	{ "rayCast", w_World_rayCast },
+	{ "rayCastBatch", w_World_rayCastBatch },
+	{ "getStateSize", w_World_getStateSize },
+	{ "saveState", w_World_saveState },
+	{ "restoreState", w_World_restoreState },
+	{ "debugDraw", w_World_debugDraw },
 	{ "destroy", w_World_destroy },
 	{ "isDestroyed", w_World_isDestroyed },
 
@@ -0,0 +1,350 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Profiler.h"
+
+// C++
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace love
+{
+namespace profiler
+{
+
+Profiler::Sampler::Sampler(Profiler *profiler)
+	: profiler(profiler)
+{
+	threadName = "Profiler";
+	threadPriority = PRIORITY_HIGH;
+}
+
+void Profiler::Sampler::threadFunction()
+{
+	profiler->samplerLoop();
+}
+
+Profiler::Profiler()
+	: sampler(nullptr)
+	, rate(MAX_RATE)
+	, stopping(false)
+	, tick(0)
+	, sampleCount(0)
+{
+}
+
+Profiler::~Profiler()
+{
+	stop();
+	stopTrace();
+}
+
+void Profiler::start(int rate)
+{
+	thread::Lock lock(mutex);
+
+	if (sampler != nullptr)
+		return;
+
+	this->rate = std::min(std::max(rate, 1), (int) MAX_RATE);
+	stopping = false;
+
+	sampler = new Sampler(this);
+	if (!sampler->start())
+	{
+		delete sampler;
+		sampler = nullptr;
+		return;
+	}
+
+	profilingFlags.fetch_or(PROFILE_SAMPLING);
+}
+
+void Profiler::stop()
+{
+	{
+		thread::Lock lock(mutex);
+
+		if (sampler == nullptr)
+			return;
+
+		stopping = true;
+		cond->broadcast();
+	}
+
+	sampler->wait();
+
+	thread::Lock lock(mutex);
+
+	delete sampler;
+	sampler = nullptr;
+
+	profilingFlags.fetch_and(~PROFILE_SAMPLING);
+}
+
+bool Profiler::isRunning() const
+{
+	thread::Lock lock(mutex);
+	return sampler != nullptr;
+}
+
+int Profiler::getRate() const
+{
+	thread::Lock lock(mutex);
+	return rate;
+}
+
+void Profiler::setLuaSampled(bool sampled)
+{
+	getProfileZoneStack()->luaSampled.store(sampled);
+}
+
+void Profiler::getNativeStack(std::string &threadname, std::string &zones) const
+{
+	ProfileZoneStack *current = getProfileZoneStack();
+	uint64 lasttick = tick.load();
+
+	forEachProfileZoneStack([&](ProfileZoneStack &stack)
+	{
+		if (&stack != current)
+			return;
+
+		threadname = stack.threadName;
+
+		// The snapshot is only relevant if it's from the latest sample.
+		if (stack.snapshotTick != lasttick)
+			return;
+
+		for (const char *zone : stack.snapshot)
+		{
+			if (!zones.empty())
+				zones += ";";
+			zones += zone;
+		}
+	});
+}
+
+void Profiler::addSample(const std::string &stack, int64 count)
+{
+	thread::Lock lock(samplesMutex);
+	samples[stack] += count;
+	sampleCount += count;
+}
+
+std::string Profiler::getFoldedStacks() const
+{
+	thread::Lock lock(samplesMutex);
+
+	std::string folded;
+	for (const auto &sample : samples)
+		folded += sample.first + " " + std::to_string(sample.second) + "\n";
+
+	return folded;
+}
+
+int64 Profiler::getSampleCount() const
+{
+	thread::Lock lock(samplesMutex);
+	return sampleCount;
+}
+
+void Profiler::reset()
+{
+	thread::Lock lock(samplesMutex);
+	samples.clear();
+	sampleCount = 0;
+}
+
+void Profiler::startTrace()
+{
+	clearProfileTraces();
+	profilingFlags.fetch_or(PROFILE_TRACING);
+}
+
+void Profiler::stopTrace()
+{
+	profilingFlags.fetch_and(~PROFILE_TRACING);
+}
+
+bool Profiler::isTracing() const
+{
+	return (profilingFlags.load() & PROFILE_TRACING) != 0;
+}
+
+void Profiler::beginTraceZone(const std::string &name)
+{
+	if (isTracing())
+		addProfileTraceEvent(internProfileName(name), 'B');
+}
+
+void Profiler::endTraceZone()
+{
+	if (isTracing())
+		addProfileTraceEvent("", 'E');
+}
+
+void Profiler::addTraceMarker(const std::string &name)
+{
+	if (isTracing())
+		addProfileTraceEvent(internProfileName(name), 'i');
+}
+
+static void appendJSONString(std::string &json, const std::string &str)
+{
+	json += '"';
+
+	for (char c : str)
+	{
+		if (c == '"' || c == '\\')
+		{
+			json += '\\';
+			json += c;
+		}
+		else if ((unsigned char) c < 0x20)
+		{
+			char escaped[8];
+			snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char) c);
+			json += escaped;
+		}
+		else
+			json += c;
+	}
+
+	json += '"';
+}
+
+std::string Profiler::getTraceJSON() const
+{
+	std::vector<ProfileThreadTrace> traces = getProfileTraces();
+
+	std::string json = "{\"traceEvents\":[";
+	bool first = true;
+
+	for (const ProfileThreadTrace &trace : traces)
+	{
+		std::string tid = std::to_string(trace.threadID);
+
+		std::string threadname = trace.threadName;
+		if (trace.dropped > 0)
+			threadname += " (" + std::to_string(trace.dropped) + " events dropped)";
+
+		if (!first)
+			json += ",";
+		first = false;
+
+		json += "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":";
+		appendJSONString(json, threadname);
+		json += "}}";
+
+		for (const ProfileTraceEvent &event : trace.events)
+		{
+			// Timestamps are in microseconds.
+			char ts[32];
+			snprintf(ts, sizeof(ts), "%.3f", event.time * 1000000.0);
+
+			json += ",\n{\"name\":";
+			appendJSONString(json, event.name);
+			json += ",\"ph\":\"";
+			json += event.phase;
+			json += "\",\"ts\":";
+			json += ts;
+			json += ",\"pid\":1,\"tid\":" + tid;
+
+			// Instant events are scoped to their thread.
+			if (event.phase == 'i')
+				json += ",\"s\":\"t\"";
+
+			json += "}";
+		}
+	}
+
+	json += "\n]}\n";
+	return json;
+}
+
+void Profiler::samplerLoop()
+{
+	thread::Lock lock(mutex);
+
+	int interval = std::max(1000 / rate, 1);
+
+	while (!stopping)
+	{
+		cond->wait(mutex, interval);
+
+		if (!stopping)
+			sample();
+	}
+}
+
+void Profiler::sample()
+{
+	uint64 sampletick = tick.fetch_add(1) + 1;
+	std::vector<std::string> stacks;
+
+	forEachProfileZoneStack([&](ProfileZoneStack &stack)
+	{
+		int depth = std::min(stack.depth.load(std::memory_order_acquire), (int) ProfileZoneStack::MAX_DEPTH);
+
+		// Threads running sampled Lua code keep a snapshot, which their Lua
+		// sampler adds to the samples it takes while in native code.
+		if (stack.luaSampled.load(std::memory_order_relaxed))
+		{
+			stack.snapshot.clear();
+
+			for (int i = 0; i < depth; i++)
+			{
+				const char *zone = stack.zones[i].load(std::memory_order_relaxed);
+				if (zone != nullptr)
+					stack.snapshot.push_back(zone);
+			}
+
+			stack.snapshotTick = sampletick;
+		}
+		else if (depth > 0)
+		{
+			std::string folded = stack.threadName;
+
+			for (int i = 0; i < depth; i++)
+			{
+				const char *zone = stack.zones[i].load(std::memory_order_relaxed);
+				if (zone != nullptr)
+					folded += std::string(";") + zone;
+			}
+
+			stacks.push_back(folded);
+		}
+	});
+
+	if (stacks.empty())
+		return;
+
+	thread::Lock lock(samplesMutex);
+
+	for (const std::string &stack : stacks)
+		samples[stack]++;
+
+	sampleCount += (int64) stacks.size();
+}
+
+} // profiler
+} // love
@@ -0,0 +1,149 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_PROFILER_PROFILER_H
+#define LOVE_PROFILER_PROFILER_H
+
+// LOVE
+#include "common/Module.h"
+#include "common/int.h"
+#include "common/profiling.h"
+#include "thread/threads.h"
+
+// C++
+#include <atomic>
+#include <map>
+#include <string>
+
+namespace love
+{
+namespace profiler
+{
+
+/**
+ * A sampling profiler. A thread samples the native zone stacks (see
+ * LOVE_PROFILE_ZONE) of every thread at a fixed rate, and Lua code is sampled
+ * by each Lua state which starts the profiler. The samples are kept as counts
+ * of folded stacks: frames from the outermost in, separated by semicolons.
+ *
+ * It also records traces: timelines of the native zones and Lua markers of
+ * every thread, which can be saved in the Chrome trace format.
+ **/
+class Profiler : public Module
+{
+public:
+
+	static const int MAX_RATE = 1000;
+
+	Profiler();
+	virtual ~Profiler();
+
+	// Implements Module.
+	ModuleType getModuleType() const override { return M_PROFILER; }
+	const char *getName() const override { return "love.profiler"; }
+
+	/**
+	 * Starts sampling the native zone stacks. The rate is in samples per
+	 * second, and is ignored if sampling has already started.
+	 **/
+	void start(int rate);
+	void stop();
+	bool isRunning() const;
+
+	int getRate() const;
+
+	/**
+	 * Marks whether the calling thread's Lua code is being sampled. Its native
+	 * zones are then only recorded as part of its Lua samples.
+	 **/
+	void setLuaSampled(bool sampled);
+
+	/**
+	 * Gets the calling thread's name, and the native zones it was inside at
+	 * the most recent sample, as a folded stack. The zones are empty if the
+	 * thread wasn't inside any.
+	 **/
+	void getNativeStack(std::string &threadname, std::string &zones) const;
+
+	void addSample(const std::string &stack, int64 count);
+
+	std::string getFoldedStacks() const;
+	int64 getSampleCount() const;
+
+	void reset();
+
+	/**
+	 * Starts recording traces, discarding the previously recorded ones.
+	 **/
+	void startTrace();
+	void stopTrace();
+	bool isTracing() const;
+
+	// Lua markers on the calling thread's trace.
+	void beginTraceZone(const std::string &name);
+	void endTraceZone();
+	void addTraceMarker(const std::string &name);
+
+	/**
+	 * Gets the recorded traces as Chrome trace format JSON, which can be opened
+	 * in chrome://tracing or Perfetto.
+	 **/
+	std::string getTraceJSON() const;
+
+private:
+
+	class Sampler : public thread::Threadable
+	{
+	public:
+
+		Sampler(Profiler *profiler);
+
+		// Implements Threadable.
+		void threadFunction() override;
+
+	private:
+
+		Profiler *profiler;
+
+	}; // Sampler
+
+	void samplerLoop();
+	void sample();
+
+	Sampler *sampler;
+	int rate;
+	bool stopping;
+
+	// Incremented every time the native zone stacks are sampled.
+	std::atomic<uint64> tick;
+
+	thread::MutexRef mutex;
+	thread::ConditionalRef cond;
+
+	thread::MutexRef samplesMutex;
+	std::map<std::string, int64> samples;
+	int64 sampleCount;
+
+}; // Profiler
+
+} // profiler
+} // love
+
+#endif // LOVE_PROFILER_PROFILER_H
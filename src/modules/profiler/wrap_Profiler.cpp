@@ -0,0 +1,227 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "common/config.h"
+
+// LOVE
+#include "wrap_Profiler.h"
+#include "common/memory.h"
+
+// Shove the wrap_Profiler.lua code directly into a raw string literal.
+static const char profiler_lua[] =
+#include "wrap_Profiler.lua"
+;
+
+#ifdef LOVE_PRECOMPILED_LUA
+#include "luabytecode/profiler_lua.h"
+#endif
+
+namespace love
+{
+namespace profiler
+{
+
+#define instance() (Module::getInstance<Profiler>(Module::M_PROFILER))
+
+int w__start(lua_State *L)
+{
+	int rate = (int) luaL_optinteger(L, 1, Profiler::MAX_RATE);
+	luax_catchexcept(L, [&]() { instance()->start(rate); });
+	lua_pushinteger(L, instance()->getRate());
+	return 1;
+}
+
+int w__stop(lua_State *L)
+{
+	instance()->stop();
+	return 0;
+}
+
+int w__setLuaSampled(lua_State *L)
+{
+	instance()->setLuaSampled(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w__getNativeStack(lua_State *L)
+{
+	std::string threadname;
+	std::string zones;
+	instance()->getNativeStack(threadname, zones);
+
+	luax_pushstring(L, threadname);
+	luax_pushstring(L, zones);
+	return 2;
+}
+
+int w__addSample(lua_State *L)
+{
+	size_t len = 0;
+	const char *stack = luaL_checklstring(L, 1, &len);
+	int64 count = (int64) luaL_optnumber(L, 2, 1);
+
+	instance()->addSample(std::string(stack, len), count);
+	return 0;
+}
+
+int w_getRate(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getRate());
+	return 1;
+}
+
+int w_getFoldedStacks(lua_State *L)
+{
+	luax_pushstring(L, instance()->getFoldedStacks());
+	return 1;
+}
+
+int w_getSampleCount(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getSampleCount());
+	return 1;
+}
+
+int w_reset(lua_State *L)
+{
+	instance()->reset();
+	return 0;
+}
+
+int w_startTrace(lua_State *L)
+{
+	instance()->startTrace();
+	return 0;
+}
+
+int w_stopTrace(lua_State *L)
+{
+	instance()->stopTrace();
+	return 0;
+}
+
+int w_isTracing(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isTracing());
+	return 1;
+}
+
+int w_beginZone(lua_State *L)
+{
+	instance()->beginTraceZone(luax_checkstring(L, 1));
+	return 0;
+}
+
+int w_endZone(lua_State *L)
+{
+	instance()->endTraceZone();
+	return 0;
+}
+
+int w_mark(lua_State *L)
+{
+	instance()->addTraceMarker(luax_checkstring(L, 1));
+	return 0;
+}
+
+int w_getTrace(lua_State *L)
+{
+	luax_pushstring(L, instance()->getTraceJSON());
+	return 1;
+}
+
+int w_getMemoryStats(lua_State *L)
+{
+	std::vector<TypeMemoryStats> stats = getTypeMemoryStats();
+
+	if (lua_istable(L, 1))
+		lua_pushvalue(L, 1);
+	else
+		lua_createtable(L, 0, (int) stats.size());
+
+	for (const TypeMemoryStats &s : stats)
+	{
+		lua_createtable(L, 0, 2);
+
+		lua_pushnumber(L, (lua_Number) s.count);
+		lua_setfield(L, -2, "count");
+
+		lua_pushnumber(L, (lua_Number) s.bytes);
+		lua_setfield(L, -2, "bytes");
+
+		lua_setfield(L, -2, s.type->getName());
+	}
+
+	return 1;
+}
+
+// List of functions to wrap.
+static const luaL_Reg functions[] =
+{
+	// The public start, stop and isRunning are defined in wrap_Profiler.lua.
+	{ "_start", w__start },
+	{ "_stop", w__stop },
+	{ "_setLuaSampled", w__setLuaSampled },
+	{ "_getNativeStack", w__getNativeStack },
+	{ "_addSample", w__addSample },
+	{ "getRate", w_getRate },
+	{ "getFoldedStacks", w_getFoldedStacks },
+	{ "getSampleCount", w_getSampleCount },
+	{ "reset", w_reset },
+	{ "startTrace", w_startTrace },
+	{ "stopTrace", w_stopTrace },
+	{ "isTracing", w_isTracing },
+	{ "beginZone", w_beginZone },
+	{ "endZone", w_endZone },
+	{ "mark", w_mark },
+	{ "getTrace", w_getTrace },
+	{ "getMemoryStats", w_getMemoryStats },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_love_profiler(lua_State *L)
+{
+	Profiler *instance = instance();
+	if (instance == nullptr)
+	{
+		luax_catchexcept(L, [&](){ instance = new love::profiler::Profiler(); });
+	}
+	else
+		instance->retain();
+
+	WrappedModule w;
+	w.module = instance;
+	w.name = "profiler";
+	w.type = &Module::type;
+	w.functions = functions;
+	w.types = 0;
+
+	int n = luax_register_module(L, w);
+
+	// Execute wrap_Profiler.lua, sending the profiler table as an argument.
+	luax_loadembedded(L, LOVE_EMBEDDED_BYTECODE(profiler_lua), profiler_lua, sizeof(profiler_lua), "wrap_Profiler.lua");
+	lua_pushvalue(L, -2);
+	lua_call(L, 1, 0);
+
+	return n;
+}
+
+} // profiler
+} // love
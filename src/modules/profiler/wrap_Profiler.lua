@@ -0,0 +1,174 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2018 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+
+local love_profiler = ...
+
+local type, pcall, require = type, pcall, require
+local floor, max = math.floor, math.max
+local concat = table.concat
+
+-- Lua code is sampled with jit.profile when it's available. Otherwise a count
+-- hook samples every few VM instructions instead of at a fixed rate, and
+-- doesn't see coroutines.
+local profile
+if type(jit) == "table" then
+	local ok, p = pcall(require, "jit.profile")
+	if ok then
+		profile = p
+	end
+end
+
+local MAX_DEPTH = 64
+local HOOK_INSTRUCTIONS_PER_SECOND = 100000000
+
+local running = false
+local threadname = ""
+
+local addsample = love_profiler._addSample
+local getnativestack = love_profiler._getNativeStack
+
+local vmstatenames = {
+	G = "[GC]",
+	J = "[JIT compiler]",
+}
+
+local function record(luastack, vmstate, count)
+	local stack = threadname
+	if luastack ~= "" then
+		stack = stack .. ";" .. luastack
+	end
+
+	if vmstate == "C" then
+		-- Add the native zones this thread was inside, if any.
+		local _, zones = getnativestack()
+		if zones ~= "" then
+			stack = stack .. ";" .. zones
+		end
+	elseif vmstatenames[vmstate] then
+		stack = stack .. ";" .. vmstatenames[vmstate]
+	end
+
+	addsample(stack, count)
+end
+
+local startlua, stoplua
+
+if profile then
+	local dumpstack = profile.dumpstack
+
+	local function onsample(thread, samples, vmstate)
+		-- A negative depth puts the outermost frame first, and Z removes the
+		-- trailing separator.
+		record(dumpstack(thread, "FZ;", -MAX_DEPTH), vmstate, samples)
+	end
+
+	function startlua(rate)
+		profile.start("i" .. max(floor(1000 / rate), 1), onsample)
+	end
+
+	function stoplua()
+		profile.stop()
+	end
+else
+	local getinfo, sethook = debug.getinfo, debug.sethook
+
+	local function onhook()
+		local frames = {}
+
+		-- Level 2 is the function the hook interrupted.
+		for level = 2, MAX_DEPTH + 1 do
+			local info = getinfo(level, "Sn")
+			if not info then
+				break
+			end
+
+			local frame
+			if info.what == "C" then
+				frame = "[C]:" .. (info.name or "?")
+			else
+				frame = info.short_src .. ":" .. (info.name or info.linedefined)
+			end
+
+			table.insert(frames, 1, frame)
+		end
+
+		record(concat(frames, ";"), "I", 1)
+	end
+
+	function startlua(rate)
+		sethook(onhook, "", max(floor(HOOK_INSTRUCTIONS_PER_SECOND / rate), 1))
+	end
+
+	function stoplua()
+		sethook()
+	end
+end
+
+function love_profiler.start(rate)
+	if running then
+		return
+	end
+
+	-- Native sampling is shared by every thread, and keeps its rate if
+	-- another thread already started it.
+	rate = love_profiler._start(rate)
+
+	threadname = getnativestack()
+	love_profiler._setLuaSampled(true)
+	startlua(rate)
+
+	running = true
+end
+
+function love_profiler.stop()
+	if not running then
+		return
+	end
+
+	stoplua()
+	love_profiler._setLuaSampled(false)
+
+	-- This stops native sampling for every thread.
+	love_profiler._stop()
+
+	running = false
+end
+
+function love_profiler.isRunning()
+	return running
+end
+
+function love_profiler.write(filename)
+	local filesystem = require("love.filesystem")
+	return filesystem.write(filename, love_profiler.getFoldedStacks())
+end
+
+function love_profiler.writeTrace(filename)
+	local filesystem = require("love.filesystem")
+	return filesystem.write(filename, love_profiler.getTrace())
+end
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
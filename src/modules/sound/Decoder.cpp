@@ -61,6 +61,11 @@ int Decoder::getSampleRate() const
 	return sampleRate;
 }
 
+bool Decoder::setBitDepth(int bitDepth)
+{
+	return bitDepth == getBitDepth();
+}
+
 bool Decoder::isFinished()
 {
 	return eof;
@@ -126,11 +126,20 @@ public:
 	virtual int getChannelCount() const = 0;
 
 	/**
-	 * Gets the number of bits per sample. Supported values are 8 or 16.
-	 * @return Either 8, 16, or 0 if unsupported.
+	 * Gets the number of bits per sample. Supported values are 8 or 16 for
+	 * integer samples, and 32 for float samples.
+	 * @return Either 8, 16, 32, or 0 if unsupported.
 	 **/
 	virtual int getBitDepth() const = 0;
 
+	/**
+	 * Changes the format of decoded samples. Decoders whose codec produces
+	 * floats can output 32-bit float samples directly, skipping a conversion.
+	 * Must be called before decoding.
+	 * @return False if the Decoder can't output the bit depth.
+	 **/
+	virtual bool setBitDepth(int bitDepth);
+
 	/**
 	 * Gets the sample rate for the Decoder, that is, samples per second.
 	 * @return The sample rate, eg. 44100.
@@ -19,6 +19,7 @@
  **/
 
 #include "SoundData.h"
+#include "common/math.h"
 
 // C
 #include <cstdlib>
@@ -28,6 +29,8 @@
 #include <limits>
 #include <iostream>
 #include <vector>
+#include <algorithm>
+#include <cmath>
 
 namespace love
 {
@@ -43,7 +46,7 @@ SoundData::SoundData(Decoder *decoder)
 	, bitDepth(0)
 	, channels(0)
 {
-	if (decoder->getBitDepth() != 8 && decoder->getBitDepth() != 16)
+	if (!isValidBitDepth(decoder->getBitDepth()))
 		throw love::Exception("Invalid bit depth: %d", decoder->getBitDepth());
 
 	size_t bufferSize = 524288; // 0x80000
@@ -86,6 +89,8 @@ SoundData::SoundData(Decoder *decoder)
 	channels = decoder->getChannelCount();
 	bitDepth = decoder->getBitDepth();
 	sampleRate = decoder->getSampleRate();
+
+	setNativeMemorySize(type, size);
 }
 
 SoundData::SoundData(int samples, int sampleRate, int bitDepth, int channels)
@@ -137,7 +142,7 @@ void SoundData::load(int samples, int sampleRate, int bitDepth, int channels, vo
 	if (sampleRate <= 0)
 		throw love::Exception("Invalid sample rate: %d", sampleRate);
 
-	if (bitDepth != 8 && bitDepth != 16)
+	if (!isValidBitDepth(bitDepth))
 		throw love::Exception("Invalid bit depth: %d", bitDepth);
 
 	if (channels <= 0)
@@ -167,6 +172,13 @@ void SoundData::load(int samples, int sampleRate, int bitDepth, int channels, vo
 		memcpy(data, newData, size);
 	else
 		memset(data, bitDepth == 8 ? 128 : 0, size);
+
+	setNativeMemorySize(type, size);
+}
+
+bool SoundData::isValidBitDepth(int bitDepth)
+{
+	return bitDepth == 8 || bitDepth == 16 || bitDepth == 32;
 }
 
 void *SoundData::getData() const
@@ -216,6 +228,12 @@ void SoundData::setSample(int i, float sample)
 		int16 *s = (int16 *) data;
 		s[i] = (int16) (sample * (float) LOVE_INT16_MAX);
 	}
+	else if (bitDepth == 32)
+	{
+		// 32-bit sample values are floats.
+		float *s = (float *) data;
+		s[i] = sample;
+	}
 	else
 	{
 		// 8-bit sample values are unsigned internally.
@@ -243,6 +261,12 @@ float SoundData::getSample(int i) const
 		int16 *s = (int16 *) data;
 		return (float) s[i] / (float) LOVE_INT16_MAX;
 	}
+	else if (bitDepth == 32)
+	{
+		// 32-bit sample values are floats.
+		float *s = (float *) data;
+		return s[i];
+	}
 	else
 	{
 		// 8-bit sample values are unsigned internally.
@@ -258,5 +282,212 @@ float SoundData::getSample(int i, int channel) const
 	return getSample(i * channels + (channel - 1));
 }
 
+// The loops below avoid per-sample branches so the compiler can vectorize
+// them.
+
+void SoundData::readFloats(int start, int count, float *out) const
+{
+	int n = count * channels;
+
+	if (bitDepth == 16)
+	{
+		const int16 *s = (const int16 *) data + start * channels;
+		for (int i = 0; i < n; i++)
+			out[i] = (float) s[i] * (1.0f / (float) LOVE_INT16_MAX);
+	}
+	else if (bitDepth == 32)
+		memcpy(out, (const float *) data + start * channels, n * sizeof(float));
+	else
+	{
+		const uint8 *s = data + start * channels;
+		for (int i = 0; i < n; i++)
+			out[i] = ((float) s[i] - 128.0f) * (1.0f / 127.0f);
+	}
+}
+
+void SoundData::writeFloats(int start, int count, const float *in)
+{
+	int n = count * channels;
+
+	if (bitDepth == 16)
+	{
+		int16 *s = (int16 *) data + start * channels;
+		for (int i = 0; i < n; i++)
+			s[i] = (int16) (std::min(std::max(in[i], -1.0f), 1.0f) * (float) LOVE_INT16_MAX);
+	}
+	else if (bitDepth == 32)
+	{
+		// Floats can go past full scale, so they aren't clipped.
+		memcpy((float *) data + start * channels, in, n * sizeof(float));
+	}
+	else
+	{
+		uint8 *s = data + start * channels;
+		for (int i = 0; i < n; i++)
+			s[i] = (uint8) (std::min(std::max(in[i], -1.0f), 1.0f) * 127.0f + 128.0f);
+	}
+}
+
+void SoundData::checkRange(const SoundData *src, int srcStart, int dstStart, int count) const
+{
+	if (src->channels != channels)
+		throw love::Exception("SoundData channel counts must match.");
+
+	if (count < 0 || srcStart < 0 || dstStart < 0
+		|| srcStart + count > src->getSampleCount() || dstStart + count > getSampleCount())
+		throw love::Exception("Sample range is out of bounds.");
+}
+
+SoundData *SoundData::convert(int bitDepth, int channels) const
+{
+	int samples = getSampleCount();
+	SoundData *c = new SoundData(samples, sampleRate, bitDepth, channels);
+
+	if (bitDepth == this->bitDepth && channels == this->channels)
+	{
+		memcpy(c->data, data, size);
+		return c;
+	}
+
+	std::vector<float> in(samples * this->channels);
+	std::vector<float> out(samples * channels, 0.0f);
+
+	readFloats(0, samples, in.data());
+
+	if (channels == this->channels)
+		out = in;
+	else if (channels > this->channels)
+	{
+		for (int ch = 0; ch < channels; ch++)
+		{
+			int from = ch % this->channels;
+			for (int i = 0; i < samples; i++)
+				out[i * channels + ch] = in[i * this->channels + from];
+		}
+	}
+	else
+	{
+		// Each output channel averages the input channels mapped onto it.
+		for (int from = 0; from < this->channels; from++)
+		{
+			int ch = from % channels;
+			float weight = 1.0f / (float) ((this->channels - ch + channels - 1) / channels);
+			for (int i = 0; i < samples; i++)
+				out[i * channels + ch] += in[i * this->channels + from] * weight;
+		}
+	}
+
+	c->writeFloats(0, samples, out.data());
+	return c;
+}
+
+SoundData *SoundData::resample(int sampleRate) const
+{
+	if (sampleRate <= 0)
+		throw love::Exception("Invalid sample rate: %d", sampleRate);
+
+	int insamples = getSampleCount();
+	int outsamples = std::max((int) (((double) insamples * sampleRate) / this->sampleRate), 1);
+
+	SoundData *c = new SoundData(outsamples, sampleRate, bitDepth, channels);
+
+	if (sampleRate == this->sampleRate)
+	{
+		memcpy(c->data, data, size);
+		return c;
+	}
+
+	// Half the number of sinc lobes used per output sample.
+	const int taps = 16;
+
+	// Low-pass at the lower of the two Nyquist frequencies to avoid aliasing
+	// when downsampling.
+	double step = (double) this->sampleRate / sampleRate;
+	double cutoff = std::min(1.0, 1.0 / step);
+	int radius = (int) std::ceil(taps / cutoff);
+
+	std::vector<float> in(insamples * channels);
+	std::vector<float> out(outsamples * channels, 0.0f);
+	std::vector<float> weights(2 * radius + 1);
+
+	readFloats(0, insamples, in.data());
+
+	for (int i = 0; i < outsamples; i++)
+	{
+		double pos = i * step;
+		int center = (int) std::floor(pos);
+		float total = 0.0f;
+
+		for (int k = -radius; k <= radius; k++)
+		{
+			double x = (center + k - pos) * cutoff;
+			double w = 0.0;
+
+			if (std::abs(x) < taps)
+			{
+				double sinc = x == 0.0 ? 1.0 : std::sin(LOVE_M_PI * x) / (LOVE_M_PI * x);
+				double window = 0.42 + 0.5 * std::cos(LOVE_M_PI * x / taps) + 0.08 * std::cos(2.0 * LOVE_M_PI * x / taps);
+				w = sinc * window;
+			}
+
+			if (center + k < 0 || center + k >= insamples)
+				w = 0.0;
+
+			weights[k + radius] = (float) w;
+			total += (float) w;
+		}
+
+		if (total == 0.0f)
+			continue;
+
+		float *o = &out[i * channels];
+		for (int k = -radius; k <= radius; k++)
+		{
+			float w = weights[k + radius] / total;
+			if (w == 0.0f)
+				continue;
+
+			const float *s = &in[(center + k) * channels];
+			for (int ch = 0; ch < channels; ch++)
+				o[ch] += s[ch] * w;
+		}
+	}
+
+	c->writeFloats(0, outsamples, out.data());
+	return c;
+}
+
+void SoundData::mix(const SoundData *src, float gain, int dstStart, int srcStart, int count)
+{
+	checkRange(src, srcStart, dstStart, count);
+
+	std::vector<float> a(count * channels);
+	std::vector<float> b(count * channels);
+
+	readFloats(dstStart, count, a.data());
+	src->readFloats(srcStart, count, b.data());
+
+	for (size_t i = 0; i < a.size(); i++)
+		a[i] += b[i] * gain;
+
+	writeFloats(dstStart, count, a.data());
+}
+
+void SoundData::copyFrom(const SoundData *src, int srcStart, int count, int dstStart)
+{
+	checkRange(src, srcStart, dstStart, count);
+
+	if (src->bitDepth == bitDepth)
+	{
+		size_t framesize = channels * (bitDepth / 8);
+		memmove(data + dstStart * framesize, src->data + srcStart * framesize, count * framesize);
+		return;
+	}
+
+	std::vector<float> samples(count * channels);
+	src->readFloats(srcStart, count, samples.data());
+	writeFloats(dstStart, count, samples.data());
+}
+
 } // sound
 } // love
@@ -56,13 +56,48 @@ public:
 
 	virtual float getDuration() const;
 
+	/**
+	 * Valid bit depths are 8 and 16 (integer samples) and 32 (float samples).
+	 **/
+	static bool isValidBitDepth(int bitDepth);
+
 	void setSample(int i, float sample);
 	void setSample(int i, int channel, float sample);
 	float getSample(int i) const;
 	float getSample(int i, int channel) const;
 
+	/**
+	 * Creates a copy with a different bit depth and channel count. Extra
+	 * channels repeat the source channels, and missing ones are mixed down.
+	 **/
+	SoundData *convert(int bitDepth, int channels) const;
+
+	/**
+	 * Creates a copy at a different sample rate, using windowed sinc
+	 * interpolation.
+	 **/
+	SoundData *resample(int sampleRate) const;
+
+	/**
+	 * Adds count samples of src, starting at srcStart and scaled by gain, to
+	 * this SoundData starting at dstStart. Integer results are clipped.
+	 **/
+	void mix(const SoundData *src, float gain, int dstStart, int srcStart, int count);
+
+	/**
+	 * Replaces count samples starting at dstStart with samples from src
+	 * starting at srcStart, converting the bit depth if needed.
+	 **/
+	void copyFrom(const SoundData *src, int srcStart, int count, int dstStart);
+
 private:
 
+	// Converts whole sample frames to and from interleaved floats in [-1, 1].
+	void readFloats(int start, int count, float *out) const;
+	void writeFloats(int start, int count, const float *in);
+
+	void checkRange(const SoundData *src, int srcStart, int dstStart, int count) const;
+
 	void load(int samples, int sampleRate, int bitDepth, int channels, void *newData = 0);
 
 	uint8 *data;
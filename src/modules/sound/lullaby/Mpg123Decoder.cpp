@@ -132,6 +132,12 @@ Mpg123Decoder::Mpg123Decoder(Data *data, const std::string &ext, int bufferSize)
 	// Suppressing all mpg123 messages.
 	mpg123_param(handle, MPG123_ADD_FLAGS, MPG123_QUIET, 0);
 
+	// The frame index normally stops growing after a fixed number of entries,
+	// so seeking past it scans the file from the last indexed frame. A
+	// negative size makes it grow to cover the whole stream as it's decoded
+	// or scanned.
+	mpg123_param(handle, MPG123_INDEX_SIZE, -INDEX_SIZE, 0);
+
 	try
 	{
 		ret = mpg123_replace_reader_handle(handle, &read_callback, &seek_callback, &cleanup_callback);
@@ -196,7 +202,20 @@ void Mpg123Decoder::quit()
 
 love::sound::Decoder *Mpg123Decoder::clone()
 {
-	return new Mpg123Decoder(data.get(), ext, bufferSize);
+	Mpg123Decoder *c = new Mpg123Decoder(data.get(), ext, bufferSize);
+
+	// The clone decodes the same data, so it can reuse the index and duration
+	// instead of scanning for them again.
+	off_t *offsets = nullptr;
+	off_t step = 0;
+	size_t fill = 0;
+
+	if (mpg123_index(handle, &offsets, &step, &fill) == MPG123_OK && fill > 0)
+		mpg123_set_index(c->handle, offsets, step, fill);
+
+	c->duration = duration;
+
+	return c;
 }
 
 int Mpg123Decoder::decode()
@@ -272,6 +291,7 @@ double Mpg123Decoder::getDuration()
 	// Only calculate the duration if we haven't done so already.
 	if (duration == -2.0)
 	{
+		// This also fills the frame index, which makes later seeks cheap.
 		mpg123_scan(handle);
 
 		off_t length = mpg123_length(handle);
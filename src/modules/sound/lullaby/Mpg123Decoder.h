@@ -75,6 +75,9 @@ public:
 
 private:
 
+	// Initial number of entries in mpg123's frame index.
+	static const long INDEX_SIZE = 1000;
+
 	DecoderFile decoder_file;
 
 	mpg123_handle *handle;
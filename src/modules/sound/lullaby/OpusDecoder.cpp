@@ -0,0 +1,211 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "OpusDecoder.h"
+
+#ifdef LOVE_SUPPORT_OPUS
+
+#include "common/Exception.h"
+
+namespace love
+{
+namespace sound
+{
+namespace lullaby
+{
+
+// Opus streams are always decoded at this rate.
+static const int OPUS_SAMPLE_RATE = 48000;
+
+OpusDecoder::OpusDecoder(Data *data, const std::string &ext, int bufferSize)
+	: Decoder(data, ext, bufferSize)
+	, handle(nullptr)
+	, channels(2)
+	, bitDepth(16)
+	, duration(-2.0)
+{
+	int error = 0;
+	handle = op_open_memory((const unsigned char *) data->getData(), data->getSize(), &error);
+
+	if (handle == nullptr)
+		throw love::Exception("Could not read Ogg Opus stream (error %d).", error);
+
+	channels = op_channel_count(handle, -1) == 1 ? 1 : 2;
+	sampleRate = OPUS_SAMPLE_RATE;
+}
+
+OpusDecoder::~OpusDecoder()
+{
+	op_free(handle);
+}
+
+bool OpusDecoder::accepts(const std::string &ext)
+{
+	static const std::string supported[] =
+	{
+		"opus", ""
+	};
+
+	for (int i = 0; !(supported[i].empty()); i++)
+	{
+		if (supported[i].compare(ext) == 0)
+			return true;
+	}
+
+	return false;
+}
+
+bool OpusDecoder::isOpus(Data *data)
+{
+	int error = 0;
+	OggOpusFile *file = op_test_memory((const unsigned char *) data->getData(), data->getSize(), &error);
+
+	if (file == nullptr)
+		return false;
+
+	op_free(file);
+	return true;
+}
+
+love::sound::Decoder *OpusDecoder::clone()
+{
+	OpusDecoder *c = new OpusDecoder(data.get(), ext, bufferSize);
+	c->bitDepth = bitDepth;
+	c->duration = duration;
+	return c;
+}
+
+int OpusDecoder::decode()
+{
+	int size = 0;
+	int samplesize = channels * (bitDepth / 8);
+
+	while (size + samplesize <= bufferSize)
+	{
+		void *pcm = (char *) buffer + size;
+		int count = (bufferSize - size) / (bitDepth / 8);
+		int result = 0;
+
+		// Opus decodes to floats internally, so float output is cheapest.
+		if (bitDepth == 32)
+		{
+			if (channels == 1)
+				result = op_read_float(handle, (float *) pcm, count, nullptr);
+			else
+				result = op_read_float_stereo(handle, (float *) pcm, count);
+		}
+		else
+		{
+			if (channels == 1)
+				result = op_read(handle, (opus_int16 *) pcm, count, nullptr);
+			else
+				result = op_read_stereo(handle, (opus_int16 *) pcm, count);
+		}
+
+		if (result == OP_HOLE)
+			continue;
+		else if (result < 0)
+			return -1;
+		else if (result == 0)
+		{
+			eof = true;
+			break;
+		}
+
+		size += result * samplesize;
+	}
+
+	return size;
+}
+
+bool OpusDecoder::seek(float s)
+{
+	if (s < 0.0f)
+		return false;
+
+	// opusfile bisects the stream's pages to find the target, then decodes up
+	// to the exact sample.
+	ogg_int64_t offset = (ogg_int64_t) ((double) s * OPUS_SAMPLE_RATE);
+
+	if (op_pcm_seek(handle, offset) == 0)
+	{
+		eof = false;
+		return true;
+	}
+
+	return false;
+}
+
+bool OpusDecoder::rewind()
+{
+	if (op_pcm_seek(handle, 0) == 0)
+	{
+		eof = false;
+		return true;
+	}
+
+	return false;
+}
+
+bool OpusDecoder::isSeekable()
+{
+	return op_seekable(handle) != 0;
+}
+
+int OpusDecoder::getChannelCount() const
+{
+	return channels;
+}
+
+int OpusDecoder::getBitDepth() const
+{
+	return bitDepth;
+}
+
+bool OpusDecoder::setBitDepth(int bitDepth)
+{
+	if (bitDepth != 16 && bitDepth != 32)
+		return false;
+
+	this->bitDepth = bitDepth;
+	return true;
+}
+
+double OpusDecoder::getDuration()
+{
+	// Only calculate the duration if we haven't done so already.
+	if (duration == -2.0)
+	{
+		ogg_int64_t samples = op_pcm_total(handle, -1);
+
+		if (samples < 0)
+			duration = -1.0;
+		else
+			duration = (double) samples / OPUS_SAMPLE_RATE;
+	}
+
+	return duration;
+}
+
+} // lullaby
+} // sound
+} // love
+
+#endif // LOVE_SUPPORT_OPUS
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_SOUND_LULLABY_OPUS_DECODER_H
+#define LOVE_SOUND_LULLABY_OPUS_DECODER_H
+
+#include "common/config.h"
+
+#ifdef LOVE_SUPPORT_OPUS
+
+// LOVE
+#include "common/Data.h"
+#include "sound/Decoder.h"
+
+// opusfile
+#include <opusfile.h>
+
+namespace love
+{
+namespace sound
+{
+namespace lullaby
+{
+
+/**
+ * Decodes Ogg Opus streams. Opus always decodes at 48 kHz, and streams with
+ * more than two channels are downmixed to stereo.
+ **/
+class OpusDecoder : public Decoder
+{
+public:
+
+	OpusDecoder(Data *data, const std::string &ext, int bufferSize);
+	virtual ~OpusDecoder();
+
+	static bool accepts(const std::string &ext);
+
+	/**
+	 * Checks whether Ogg data holds an Opus stream rather than a Vorbis one,
+	 * since both commonly use the .ogg extension.
+	 **/
+	static bool isOpus(Data *data);
+
+	love::sound::Decoder *clone();
+	int decode();
+	bool seek(float s);
+	bool rewind();
+	bool isSeekable();
+	int getChannelCount() const;
+	int getBitDepth() const;
+	bool setBitDepth(int bitDepth);
+	double getDuration();
+
+private:
+
+	OggOpusFile *handle;
+	int channels;
+	int bitDepth;
+	double duration;
+
+}; // OpusDecoder
+
+} // lullaby
+} // sound
+} // love
+
+#endif // LOVE_SUPPORT_OPUS
+
+#endif // LOVE_SOUND_LULLABY_OPUS_DECODER_H
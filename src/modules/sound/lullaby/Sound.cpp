@@ -38,6 +38,10 @@
 #	include "CoreAudioDecoder.h"
 #endif
 
+#ifdef LOVE_SUPPORT_OPUS
+#	include "OpusDecoder.h"
+#endif // LOVE_SUPPORT_OPUS
+
 namespace love
 {
 namespace sound
@@ -79,6 +83,10 @@ sound::Decoder *Sound::newDecoder(love::filesystem::FileData *data, int bufferSi
 	else if (Mpg123Decoder::accepts(ext))
 		decoder = new Mpg123Decoder(data, ext, bufferSize);
 #endif // LOVE_NOMPG123
+#ifdef LOVE_SUPPORT_OPUS
+	else if (OpusDecoder::accepts(ext) || (VorbisDecoder::accepts(ext) && OpusDecoder::isOpus(data)))
+		decoder = new OpusDecoder(data, ext, bufferSize);
+#endif // LOVE_SUPPORT_OPUS
 	else if (VorbisDecoder::accepts(ext))
 		decoder = new VorbisDecoder(data, ext, bufferSize);
 #ifdef LOVE_SUPPORT_GME
@@ -130,6 +130,7 @@ static long vorbisTell(void *datasource	/* ptr to the data that the vorbis files
 
 VorbisDecoder::VorbisDecoder(Data *data, const std::string &ext, int bufferSize)
 	: Decoder(data, ext, bufferSize)
+	, bitDepth(16)
 	, duration(-2.0)
 {
 	// Initialize callbacks
@@ -182,16 +183,52 @@ bool VorbisDecoder::accepts(const std::string &ext)
 
 love::sound::Decoder *VorbisDecoder::clone()
 {
-	return new VorbisDecoder(data.get(), ext, bufferSize);
+	VorbisDecoder *c = new VorbisDecoder(data.get(), ext, bufferSize);
+	c->bitDepth = bitDepth;
+	return c;
 }
 
 int VorbisDecoder::decode()
 {
 	int size = 0;
 
+	if (bitDepth == 32)
+	{
+		// Vorbis decodes to planar floats, which only need interleaving.
+		int channels = getChannelCount();
+		int framesize = channels * (int) sizeof(float);
+
+		while (size + framesize <= bufferSize)
+		{
+			float **pcm = nullptr;
+			long result = ov_read_float(&handle, &pcm, (bufferSize - size) / framesize, nullptr);
+
+			if (result == OV_HOLE)
+				continue;
+			else if (result <= OV_EREAD)
+				return -1;
+			else if (result == 0)
+			{
+				eof = true;
+				break;
+			}
+
+			float *out = (float *) ((char *) buffer + size);
+			for (int c = 0; c < channels; c++)
+			{
+				for (long i = 0; i < result; i++)
+					out[i * channels + c] = pcm[c][i];
+			}
+
+			size += (int) result * framesize;
+		}
+
+		return size;
+	}
+
 	while (size < bufferSize)
 	{
-		long result = ov_read(&handle, (char *) buffer + size, bufferSize - size, endian, (getBitDepth() == 16 ? 2 : 1), 1, 0);
+		long result = ov_read(&handle, (char *) buffer + size, bufferSize - size, endian, 2, 1, 0);
 
 		if (result == OV_HOLE)
 			continue;
@@ -257,7 +294,16 @@ int VorbisDecoder::getChannelCount() const
 
 int VorbisDecoder::getBitDepth() const
 {
-	return 16;
+	return bitDepth;
+}
+
+bool VorbisDecoder::setBitDepth(int bitDepth)
+{
+	if (bitDepth != 16 && bitDepth != 32)
+		return false;
+
+	this->bitDepth = bitDepth;
+	return true;
 }
 
 int VorbisDecoder::getSampleRate() const
@@ -62,6 +62,7 @@ public:
 	bool isSeekable();
 	int getChannelCount() const;
 	int getBitDepth() const;
+	bool setBitDepth(int bitDepth);
 	int getSampleRate() const;
 	double getDuration();
 
@@ -72,6 +73,7 @@ private:
 	vorbis_info *vorbisInfo;		// Info
 	vorbis_comment *vorbisComment;	// Comments
 	int endian;						// Endianness
+	int bitDepth;					// 16, or 32 for float samples
 	double duration;
 }; // VorbisDecoder
 
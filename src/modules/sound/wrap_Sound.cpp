@@ -36,6 +36,7 @@ int w_newDecoder(lua_State *L)
 {
 	love::filesystem::FileData *data = love::filesystem::luax_getfiledata(L, 1);
 	int bufferSize = (int) luaL_optinteger(L, 2, Decoder::DEFAULT_BUFFER_SIZE);
+	int bitDepth = (int) luaL_optinteger(L, 3, 0);
 
 	Decoder *t = nullptr;
 	luax_catchexcept(L,
@@ -48,6 +49,10 @@ int w_newDecoder(lua_State *L)
 
 	luax_pushtype(L, t);
 	t->release();
+
+	if (bitDepth != 0 && !t->setBitDepth(bitDepth))
+		return luaL_error(L, "This Decoder can't output %d-bit samples.", bitDepth);
+
 	return 1;
 }
 
@@ -22,11 +22,17 @@
 
 #include "data/wrap_Data.h"
 
+#include <algorithm>
+
 // Shove the wrap_SoundData.lua code directly into a raw string literal.
 static const char sounddata_lua[] =
 #include "wrap_SoundData.lua"
 ;
 
+#ifdef LOVE_PRECOMPILED_LUA
+#include "luabytecode/sounddata_lua.h"
+#endif
+
 namespace love
 {
 namespace sound
@@ -121,6 +127,62 @@ int w_SoundData_getSample(lua_State *L)
 	return 1;
 }
 
+int w_SoundData_convert(lua_State *L)
+{
+	SoundData *t = luax_checksounddata(L, 1);
+	int bitdepth = (int) luaL_optinteger(L, 2, t->getBitDepth());
+	int channels = (int) luaL_optinteger(L, 3, t->getChannelCount());
+
+	SoundData *c = nullptr;
+	luax_catchexcept(L, [&](){ c = t->convert(bitdepth, channels); });
+
+	luax_pushtype(L, c);
+	c->release();
+	return 1;
+}
+
+int w_SoundData_resample(lua_State *L)
+{
+	SoundData *t = luax_checksounddata(L, 1);
+	int samplerate = (int) luaL_checkinteger(L, 2);
+
+	SoundData *c = nullptr;
+	luax_catchexcept(L, [&](){ c = t->resample(samplerate); });
+
+	luax_pushtype(L, c);
+	c->release();
+	return 1;
+}
+
+int w_SoundData_mix(lua_State *L)
+{
+	SoundData *t = luax_checksounddata(L, 1);
+	SoundData *src = luax_checksounddata(L, 2);
+	float gain = (float) luaL_optnumber(L, 3, 1.0);
+	int dststart = (int) luaL_optinteger(L, 4, 0);
+	int srcstart = (int) luaL_optinteger(L, 5, 0);
+
+	int available = std::min(t->getSampleCount() - dststart, src->getSampleCount() - srcstart);
+	int count = (int) luaL_optinteger(L, 6, std::max(available, 0));
+
+	luax_catchexcept(L, [&](){ t->mix(src, gain, dststart, srcstart, count); });
+	return 0;
+}
+
+int w_SoundData_copyFrom(lua_State *L)
+{
+	SoundData *t = luax_checksounddata(L, 1);
+	SoundData *src = luax_checksounddata(L, 2);
+	int srcstart = (int) luaL_optinteger(L, 3, 0);
+	int dststart = (int) luaL_optinteger(L, 5, 0);
+
+	int available = std::min(t->getSampleCount() - dststart, src->getSampleCount() - srcstart);
+	int count = (int) luaL_optinteger(L, 4, std::max(available, 0));
+
+	luax_catchexcept(L, [&](){ t->copyFrom(src, srcstart, count, dststart); });
+	return 0;
+}
+
 int w_SoundData_getChannels(lua_State *L)
 {
 	luax_markdeprecated(L, "SoundData:getChannels", API_METHOD, DEPRECATED_RENAMED, "SoundData:getChannelCount");
@@ -137,6 +199,10 @@ static const luaL_Reg w_SoundData_functions[] =
 	{ "getDuration", w_SoundData_getDuration },
 	{ "setSample", w_SoundData_setSample },
 	{ "getSample", w_SoundData_getSample },
+	{ "convert", w_SoundData_convert },
+	{ "resample", w_SoundData_resample },
+	{ "mix", w_SoundData_mix },
+	{ "copyFrom", w_SoundData_copyFrom },
 
 	// Deprecated
 	{ "getChannels", w_SoundData_getChannels },
@@ -153,7 +219,7 @@ extern "C" int luaopen_sounddata(lua_State *L)
 	// Load and execute SoundData.lua, sending the metatable as an argument.
 	if (lua_istable(L, -1))
 	{
-		luaL_loadbuffer(L, sounddata_lua, sizeof(sounddata_lua), "SoundData.lua");
+		luax_loadembedded(L, LOVE_EMBEDDED_BYTECODE(sounddata_lua), sounddata_lua, sizeof(sounddata_lua), "SoundData.lua");
 		lua_pushvalue(L, -2);
 		lua_call(L, 1, 0);
 	}
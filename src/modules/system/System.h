@@ -28,6 +28,7 @@
 
 // stdlib
 #include <string>
+#include <vector>
 
 namespace love
 {
@@ -48,6 +49,23 @@ public:
 		POWER_MAX_ENUM
 	};
 
+	struct ProcessorInfo
+	{
+		int logicalCores;
+		int physicalCores;
+		int performanceCores;
+		int efficiencyCores;
+
+		// In bytes, or 0 if unknown.
+		int l1DataCacheSize;
+		int l2CacheSize;
+		int l3CacheSize;
+		int cacheLineSize;
+
+		// Names of supported instruction set extensions, e.g. "sse4.1".
+		std::vector<std::string> features;
+	};
+
 	System();
 	virtual ~System() {}
 
@@ -66,6 +84,12 @@ public:
 	 **/
 	virtual int getProcessorCount() const = 0;
 
+	/**
+	 * Gets the core counts, cache sizes and SIMD instruction set extensions
+	 * of the current system's CPU.
+	 **/
+	virtual ProcessorInfo getProcessorInfo() const = 0;
+
 	/**
 	 * Replaces the contents of the system's text clipboard with a string.
 	 * @param text The clipboard text to set.
@@ -21,6 +21,7 @@
 // LOVE
 #include "System.h"
 #include "window/Window.h"
+#include "common/cpu.h"
 
 // SDL
 #include <SDL_clipboard.h>
@@ -47,6 +48,45 @@ int System::getProcessorCount() const
 	return SDL_GetCPUCount();
 }
 
+System::ProcessorInfo System::getProcessorInfo() const
+{
+	const CPUTopology &topology = getCPUTopology();
+	const CPUFeatures &cpu = getCPUFeatures();
+
+	ProcessorInfo info;
+
+	info.logicalCores = topology.logicalCores;
+	info.physicalCores = topology.physicalCores;
+	info.performanceCores = topology.performanceCores;
+	info.efficiencyCores = topology.efficiencyCores;
+
+	info.l1DataCacheSize = topology.l1DataCacheSize;
+	info.l2CacheSize = topology.l2CacheSize;
+	info.l3CacheSize = topology.l3CacheSize;
+	info.cacheLineSize = topology.cacheLineSize;
+
+	const std::pair<bool, const char *> features[] =
+	{
+		{cpu.sse2, "sse2"},
+		{cpu.ssse3, "ssse3"},
+		{cpu.sse41, "sse4.1"},
+		{cpu.sse42, "sse4.2"},
+		{cpu.avx, "avx"},
+		{cpu.avx2, "avx2"},
+		{cpu.fma, "fma"},
+		{cpu.f16c, "f16c"},
+		{cpu.neon, "neon"},
+	};
+
+	for (const auto &feature : features)
+	{
+		if (feature.first)
+			info.features.push_back(feature.second);
+	}
+
+	return info;
+}
+
 bool System::isWindowOpen() const
 {
 	auto window = Module::getInstance<window::Window>(M_WINDOW);
@@ -46,6 +46,7 @@ public:
 	const char *getName() const;
 
 	int getProcessorCount() const;
+	ProcessorInfo getProcessorInfo() const;
 
 	void setClipboardText(const std::string &text) const;
 	std::string getClipboardText() const;
@@ -41,6 +41,52 @@ int w_getProcessorCount(lua_State *L)
 	return 1;
 }
 
+int w_getProcessorInfo(lua_State *L)
+{
+	System::ProcessorInfo info = instance()->getProcessorInfo();
+
+	lua_createtable(L, 0, 9);
+
+	lua_pushinteger(L, info.logicalCores);
+	lua_setfield(L, -2, "logicalcores");
+	lua_pushinteger(L, info.physicalCores);
+	lua_setfield(L, -2, "physicalcores");
+	lua_pushinteger(L, info.performanceCores);
+	lua_setfield(L, -2, "performancecores");
+	lua_pushinteger(L, info.efficiencyCores);
+	lua_setfield(L, -2, "efficiencycores");
+
+	// Unknown cache sizes are left as nil.
+	const std::pair<int, const char *> caches[] =
+	{
+		{info.l1DataCacheSize, "l1cachesize"},
+		{info.l2CacheSize, "l2cachesize"},
+		{info.l3CacheSize, "l3cachesize"},
+	};
+
+	for (const auto &cache : caches)
+	{
+		if (cache.first > 0)
+		{
+			lua_pushinteger(L, cache.first);
+			lua_setfield(L, -2, cache.second);
+		}
+	}
+
+	lua_pushinteger(L, info.cacheLineSize);
+	lua_setfield(L, -2, "cachelinesize");
+
+	lua_createtable(L, 0, (int) info.features.size());
+	for (const std::string &feature : info.features)
+	{
+		luax_pushboolean(L, true);
+		lua_setfield(L, -2, feature.c_str());
+	}
+	lua_setfield(L, -2, "features");
+
+	return 1;
+}
+
 int w_setClipboardText(lua_State *L)
 {
 	const char *text = luaL_checkstring(L, 1);
@@ -105,6 +151,7 @@ static const luaL_Reg functions[] =
 {
 	{ "getOS", w_getOS },
 	{ "getProcessorCount", w_getProcessorCount },
+	{ "getProcessorInfo", w_getProcessorInfo },
 	{ "setClipboardText", w_setClipboardText },
 	{ "getClipboardText", w_getClipboardText },
 	{ "getPowerInfo", w_getPowerInfo },
@@ -19,6 +19,9 @@
  **/
 
 #include "Channel.h"
+#include "common/Exception.h"
+#include "common/profiling.h"
+#include <algorithm>
 #include <map>
 #include <string>
 
@@ -55,14 +58,35 @@ Channel::Channel()
 	: named(false)
 	, sent(0)
 	, received(0)
+	, mode(MODE_QUEUE)
+	, ring(nullptr)
+	, ringWaiters(0)
+	, selectorCount(0)
 {
 }
 
+Channel::Channel(Mode mode, size_t capacity)
+	: named(false)
+	, sent(0)
+	, received(0)
+	, mode(mode)
+	, ring(nullptr)
+	, ringWaiters(0)
+	, selectorCount(0)
+{
+	if (mode != MODE_QUEUE)
+		ring = new VariantRing(std::max(capacity, (size_t) 1), mode == MODE_MPMC);
+}
+
 Channel::Channel(const std::string &name)
 	: named(true)
 	, name(name)
 	, sent(0)
 	, received(0)
+	, mode(MODE_QUEUE)
+	, ring(nullptr)
+	, ringWaiters(0)
+	, selectorCount(0)
 {
 }
 
@@ -73,10 +97,73 @@ Channel::~Channel()
 		Lock l(namedChannelMutex);
 		namedChannels.erase(name);
 	}
+
+	delete ring;
+}
+
+template <typename T>
+bool Channel::waitRing(T condition, double timeout)
+{
+	if (condition())
+		return true;
+
+	// Pairs with the fence in wakeRingWaiters: either the waker sees this
+	// thread waiting, or this thread sees the change the waker made.
+	ringWaiters.fetch_add(1);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	bool result = false;
+
+	{
+		Lock l(mutex);
+
+		while (!(result = condition()))
+		{
+			// A negative timeout waits forever.
+			if (timeout < 0)
+				cond->wait(mutex);
+			else if (timeout > 0)
+			{
+				double start = love::timer::Timer::getTime();
+				cond->wait(mutex, (int) (timeout*1000));
+				double stop = love::timer::Timer::getTime();
+
+				timeout = std::max(timeout - (stop-start), 0.0);
+			}
+			else
+				break;
+		}
+	}
+
+	ringWaiters.fetch_sub(1);
+	return result;
+}
+
+void Channel::wakeRingWaiters()
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (ringWaiters.load(std::memory_order_relaxed) > 0)
+	{
+		Lock l(mutex);
+		cond->broadcast();
+	}
+}
+
+uint64 Channel::pushRing(const Variant &var)
+{
+	uint64 id = 0;
+	waitRing([&]() { return ring->tryPush(var, id); }, -1.0);
+	wakeRingWaiters();
+	notifySelectors();
+	return id;
 }
 
 uint64 Channel::push(const Variant &var)
 {
+	if (ring != nullptr)
+		return pushRing(var);
+
 	Lock l(mutex);
 
 	// Keep a reference to ourselves
@@ -86,12 +173,21 @@ uint64 Channel::push(const Variant &var)
 
 	queue.push(var);
 	cond->broadcast();
+	notifySelectors();
 
 	return ++sent;
 }
 
 bool Channel::supply(const Variant &var)
 {
+	LOVE_PROFILE_ZONE("Channel:supply");
+
+	if (ring != nullptr)
+	{
+		uint64 id = pushRing(var);
+		return waitRing([&]() { return ring->getPopCount() >= id; }, -1.0);
+	}
+
 	Lock l(mutex);
 	uint64 id = push(var);
 
@@ -103,6 +199,14 @@ bool Channel::supply(const Variant &var)
 
 bool Channel::supply(const Variant &var, double timeout)
 {
+	LOVE_PROFILE_ZONE("Channel:supply");
+
+	if (ring != nullptr)
+	{
+		uint64 id = pushRing(var);
+		return waitRing([&]() { return ring->getPopCount() >= id; }, std::max(timeout, 0.0));
+	}
+
 	Lock l(mutex);
 	uint64 id = push(var);
 
@@ -123,6 +227,15 @@ bool Channel::supply(const Variant &var, double timeout)
 
 bool Channel::pop(Variant *var)
 {
+	if (ring != nullptr)
+	{
+		if (!ring->tryPop(*var))
+			return false;
+
+		wakeRingWaiters();
+		return true;
+	}
+
 	Lock l(mutex);
 
 	if (queue.empty())
@@ -144,6 +257,15 @@ bool Channel::pop(Variant *var)
 
 bool Channel::demand(Variant *var)
 {
+	LOVE_PROFILE_ZONE("Channel:demand");
+
+	if (ring != nullptr)
+	{
+		waitRing([&]() { return ring->tryPop(*var); }, -1.0);
+		wakeRingWaiters();
+		return true;
+	}
+
 	Lock l(mutex);
 
 	while (!pop(var))
@@ -154,6 +276,17 @@ bool Channel::demand(Variant *var)
 
 bool Channel::demand(Variant *var, double timeout)
 {
+	LOVE_PROFILE_ZONE("Channel:demand");
+
+	if (ring != nullptr)
+	{
+		if (!waitRing([&]() { return ring->tryPop(*var); }, std::max(timeout, 0.0)))
+			return false;
+
+		wakeRingWaiters();
+		return true;
+	}
+
 	Lock l(mutex);
 
 	while (timeout >= 0)
@@ -173,6 +306,10 @@ bool Channel::demand(Variant *var, double timeout)
 
 bool Channel::peek(Variant *var)
 {
+	// Another thread could pop the value while it's being copied.
+	if (ring != nullptr)
+		throw love::Exception("Lock-free Channels can't be peeked.");
+
 	Lock l(mutex);
 
 	if (queue.empty())
@@ -182,20 +319,127 @@ bool Channel::peek(Variant *var)
 	return true;
 }
 
+uint64 Channel::pushMany(const std::vector<Variant> &vars)
+{
+	if (vars.empty())
+	{
+		if (ring != nullptr)
+			return ring->getPopCount() + ring->getCount();
+
+		Lock l(mutex);
+		return sent;
+	}
+
+	if (ring != nullptr)
+	{
+		uint64 id = 0;
+
+		for (const Variant &var : vars)
+		{
+			if (!ring->tryPush(var, id))
+			{
+				// Wake readers first, they may be waiting on what's been pushed
+				// so far.
+				wakeRingWaiters();
+				notifySelectors();
+				waitRing([&]() { return ring->tryPush(var, id); }, -1.0);
+			}
+		}
+
+		wakeRingWaiters();
+		notifySelectors();
+		return id;
+	}
+
+	Lock l(mutex);
+
+	if (named && queue.empty())
+		retain();
+
+	for (const Variant &var : vars)
+		queue.push(var);
+
+	sent += vars.size();
+	cond->broadcast();
+	notifySelectors();
+
+	return sent;
+}
+
+int Channel::popMany(std::vector<Variant> &vars, int max)
+{
+	int count = 0;
+
+	if (ring != nullptr)
+	{
+		Variant var;
+		while ((max < 0 || count < max) && ring->tryPop(var))
+		{
+			vars.push_back(var);
+			count++;
+		}
+
+		if (count > 0)
+			wakeRingWaiters();
+
+		return count;
+	}
+
+	Lock l(mutex);
+
+	if (queue.empty())
+		return 0;
+
+	while (!queue.empty() && (max < 0 || count < max))
+	{
+		vars.push_back(queue.front());
+		queue.pop();
+		count++;
+	}
+
+	received += count;
+	cond->broadcast();
+
+	if (named && queue.empty())
+		release();
+
+	return count;
+}
+
 int Channel::getCount() const
 {
+	if (ring != nullptr)
+		return (int) ring->getCount();
+
 	Lock l(mutex);
 	return (int) queue.size();
 }
 
 bool Channel::hasRead(uint64 id) const
 {
+	if (ring != nullptr)
+		return ring->getPopCount() >= id;
+
 	Lock l(mutex);
 	return received >= id;
 }
 
 void Channel::clear()
 {
+	if (ring != nullptr)
+	{
+		Variant var;
+		bool popped = false;
+
+		while (ring->tryPop(var))
+			popped = true;
+
+		if (popped)
+			wakeRingWaiters();
+
+		return;
+	}
+
 	Lock l(mutex);
 
 	// We're already empty.
@@ -215,6 +459,109 @@ void Channel::clear()
 		release();
 }
 
+void ChannelSelector::notify()
+{
+	Lock l(mutex);
+	notified = true;
+	cond->signal();
+}
+
+void Channel::addSelector(ChannelSelector *selector)
+{
+	Lock l(selectorMutex);
+	selectors.push_back(selector);
+	selectorCount.fetch_add(1);
+}
+
+void Channel::removeSelector(ChannelSelector *selector)
+{
+	Lock l(selectorMutex);
+	selectors.erase(std::remove(selectors.begin(), selectors.end(), selector), selectors.end());
+	selectorCount.fetch_sub(1);
+}
+
+void Channel::notifySelectors()
+{
+	// Pairs with the fence in select, like wakeRingWaiters.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (selectorCount.load(std::memory_order_relaxed) > 0)
+	{
+		Lock l(selectorMutex);
+		for (ChannelSelector *selector : selectors)
+			selector->notify();
+	}
+}
+
+int Channel::select(const std::vector<Channel *> &channels, double timeout)
+{
+	auto findReady = [&]() -> int
+	{
+		for (size_t i = 0; i < channels.size(); i++)
+		{
+			if (channels[i]->getCount() > 0)
+				return (int) i;
+		}
+		return -1;
+	};
+
+	int ready = findReady();
+	if (ready >= 0 || timeout == 0 || channels.empty())
+		return ready;
+
+	LOVE_PROFILE_ZONE("Channel.select");
+
+	ChannelSelector selector;
+
+	for (Channel *c : channels)
+		c->addSelector(&selector);
+
+	// Pairs with the fence in notifySelectors.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	// The Channels are checked without holding the selector's mutex, since
+	// pushes lock the Channel before notifying the selector. A push that
+	// happens after the check sets the notified flag, so it's never missed.
+	while ((ready = findReady()) < 0)
+	{
+		Lock l(selector.mutex);
+
+		if (!selector.notified)
+		{
+			// A negative timeout waits forever.
+			if (timeout < 0)
+				selector.cond->wait(selector.mutex);
+			else if (timeout > 0)
+			{
+				double start = love::timer::Timer::getTime();
+				selector.cond->wait(selector.mutex, (int) (timeout*1000));
+				double stop = love::timer::Timer::getTime();
+
+				timeout = std::max(timeout - (stop-start), 0.0);
+			}
+			else
+				break;
+		}
+
+		selector.notified = false;
+	}
+
+	for (Channel *c : channels)
+		c->removeSelector(&selector);
+
+	return ready;
+}
+
+Channel::Mode Channel::getMode() const
+{
+	return mode;
+}
+
+size_t Channel::getCapacity() const
+{
+	return ring != nullptr ? ring->getCapacity() : 0;
+}
+
 void Channel::lockMutex()
 {
 	mutex->lock();
@@ -225,5 +572,29 @@ void Channel::unlockMutex()
 	mutex->unlock();
 }
 
+StringMap<Channel::Mode, Channel::MODE_MAX_ENUM>::Entry Channel::modeEntries[] =
+{
+	{ "queue", MODE_QUEUE },
+	{ "spsc",  MODE_SPSC  },
+	{ "mpmc",  MODE_MPMC  },
+};
+
+StringMap<Channel::Mode, Channel::MODE_MAX_ENUM> Channel::modes(Channel::modeEntries, sizeof(Channel::modeEntries));
+
+bool Channel::getConstant(const char *in, Mode &out)
+{
+	return modes.find(in, out);
+}
+
+bool Channel::getConstant(Mode in, const char *&out)
+{
+	return modes.find(in, out);
+}
+
+std::vector<std::string> Channel::getConstants(Mode)
+{
+	return modes.getNames();
+}
+
 } // thread
 } // love
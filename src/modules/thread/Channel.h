@@ -22,19 +22,40 @@
 #define LOVE_THREAD_CHANNEL_H
 
 // STL
+#include <atomic>
 #include <queue>
 #include <string>
+#include <vector>
 
 // LOVE
 #include "common/Variant.h"
+#include "common/StringMap.h"
 #include "common/int.h"
 #include "threads.h"
+#include "VariantRing.h"
 
 namespace love
 {
 namespace thread
 {
 
+/**
+ * Lets a thread sleep until any of several Channels receives a value.
+ **/
+class ChannelSelector
+{
+public:
+
+	ChannelSelector() : notified(false) {}
+
+	void notify();
+
+	MutexRef mutex;
+	ConditionalRef cond;
+	bool notified;
+
+}; // ChannelSelector
+
 class Channel : public love::Object
 {
 // FOR WRAPPER USE ONLY
@@ -44,7 +65,23 @@ public:
 
 	static love::Type type;
 
+	enum Mode
+	{
+		MODE_QUEUE, // Unbounded, protected by a mutex.
+		MODE_SPSC,  // Bounded lock-free ring, one pushing and one popping thread.
+		MODE_MPMC,  // Bounded lock-free ring, any number of threads.
+		MODE_MAX_ENUM
+	};
+
 	Channel();
+
+	/**
+	 * Creates a Channel backed by a lock-free ring of the given capacity.
+	 * Pushing waits while the ring is full. The mutex is only used to sleep
+	 * when a thread has to wait for the ring.
+	 **/
+	Channel(Mode mode, size_t capacity);
+
 	~Channel();
 
 	static Channel *getChannel(const std::string &name);
@@ -56,16 +93,55 @@ public:
 	bool demand(Variant *var); // blocking pop
 	bool demand(Variant *var, double timeout); // blocking pop
 	bool peek(Variant *var);
+
+	/**
+	 * Pushes every value under a single lock (or wakeup, for lock-free
+	 * Channels), returning the id of the last one.
+	 **/
+	uint64 pushMany(const std::vector<Variant> &vars);
+
+	/**
+	 * Pops up to max values (all of them if max is negative) under a single
+	 * lock, appending them to vars. Returns how many were popped.
+	 **/
+	int popMany(std::vector<Variant> &vars, int max = -1);
+
 	int getCount() const;
 	bool hasRead(uint64 id) const;
 	void clear();
 
+	/**
+	 * Waits until any of the Channels has a value, and returns its index, or
+	 * -1 if the timeout (in seconds) ran out first. A negative timeout waits
+	 * forever. Values aren't popped, so another thread may take the value
+	 * before the caller does.
+	 **/
+	static int select(const std::vector<Channel *> &channels, double timeout);
+
+	Mode getMode() const;
+	size_t getCapacity() const;
+
+	static bool getConstant(const char *in, Mode &out);
+	static bool getConstant(Mode in, const char *&out);
+	static std::vector<std::string> getConstants(Mode);
+
 private:
 
 	Channel(const std::string &name);
 	void lockMutex();
 	void unlockMutex();
 
+	// Ring mode helpers. Waiting threads sleep on cond, and are only woken
+	// when someone is known to be waiting.
+	uint64 pushRing(const Variant &var);
+	void wakeRingWaiters();
+	template <typename T>
+	bool waitRing(T condition, double timeout);
+
+	void addSelector(ChannelSelector *selector);
+	void removeSelector(ChannelSelector *selector);
+	void notifySelectors();
+
 	MutexRef mutex;
 	ConditionalRef cond;
 	std::queue<Variant> queue;
@@ -75,6 +151,17 @@ private:
 	uint64 sent;
 	uint64 received;
 
+	Mode mode;
+	VariantRing *ring;
+	std::atomic<int> ringWaiters;
+
+	MutexRef selectorMutex;
+	std::vector<ChannelSelector *> selectors;
+	std::atomic<int> selectorCount;
+
+	static StringMap<Mode, MODE_MAX_ENUM>::Entry modeEntries[];
+	static StringMap<Mode, MODE_MAX_ENUM> modes;
+
 }; // Channel
 
 } // thread
@@ -0,0 +1,346 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "JobPool.h"
+#include "LuaThread.h"
+#include "common/runtime.h"
+#include "timer/Timer.h"
+
+// C++
+#include <algorithm>
+
+namespace love
+{
+namespace thread
+{
+
+love::Type Job::type("Job", &Object::type);
+love::Type JobPool::type("JobPool", &Object::type);
+
+Job::Job(const std::string &module, const std::string &function, const std::vector<Variant> &args)
+	: module(module)
+	, function(function)
+	, args(args)
+	, done(false)
+{
+}
+
+Job::~Job()
+{
+}
+
+bool Job::isDone() const
+{
+	Lock lock(mutex);
+	return done;
+}
+
+bool Job::wait(double timeout)
+{
+	Lock lock(mutex);
+
+	while (!done)
+	{
+		if (timeout < 0)
+			cond->wait(mutex);
+		else if (timeout > 0)
+		{
+			double start = love::timer::Timer::getTime();
+			cond->wait(mutex, (int) (timeout * 1000));
+			double stop = love::timer::Timer::getTime();
+
+			timeout = std::max(timeout - (stop - start), 0.0);
+		}
+		else
+			break;
+	}
+
+	return done;
+}
+
+const std::vector<Variant> &Job::getResults() const
+{
+	return results;
+}
+
+const std::string &Job::getError() const
+{
+	return error;
+}
+
+const std::string &Job::getModule() const
+{
+	return module;
+}
+
+const std::string &Job::getFunction() const
+{
+	return function;
+}
+
+void Job::finish(const std::vector<Variant> &results, const std::string &error)
+{
+	Lock lock(mutex);
+
+	this->results = results;
+	this->error = error;
+	done = true;
+
+	// Don't keep argument objects alive longer than needed.
+	args.clear();
+
+	cond->broadcast();
+}
+
+JobPool::Worker::Worker(JobPool *pool, int index)
+	: pool(pool)
+	, index(index)
+{
+	threadName = "JobPool" + std::to_string(index);
+}
+
+void JobPool::Worker::threadFunction()
+{
+	pool->workerLoop(index);
+}
+
+JobPool::JobPool(int workercount)
+	: stopping(false)
+	, pending(0)
+	, nextWorker(0)
+{
+	for (int i = 0; i < std::max(workercount, 1); i++)
+	{
+		Worker *worker = new Worker(this, i);
+
+		if (!worker->start())
+		{
+			delete worker;
+			break;
+		}
+
+		workers.push_back(worker);
+	}
+
+	if (workers.empty())
+		throw love::Exception("Could not create JobPool threads.");
+}
+
+JobPool::~JobPool()
+{
+	{
+		Lock lock(mutex);
+		stopping = true;
+		cond->broadcast();
+	}
+
+	// Workers finish the job they're running before exiting.
+	for (Worker *worker : workers)
+		worker->wait();
+
+	for (Worker *worker : workers)
+	{
+		for (Job *job : worker->queue)
+		{
+			job->finish({}, "The JobPool was destroyed before the job could run.");
+			job->release();
+		}
+
+		delete worker;
+	}
+}
+
+void JobPool::submit(Job *job)
+{
+	job->retain();
+
+	Worker *worker = workers[nextWorker++ % workers.size()];
+
+	{
+		Lock lock(worker->queueMutex);
+		worker->queue.push_back(job);
+	}
+
+	// Counted under the pool mutex, so a worker that found nothing to do
+	// either sees this or is already waiting when it's signalled.
+	Lock lock(mutex);
+	pending++;
+	cond->signal();
+}
+
+int JobPool::getWorkerCount() const
+{
+	return (int) workers.size();
+}
+
+int JobPool::getPendingCount() const
+{
+	return pending;
+}
+
+void JobPool::setCompletionChannel(Channel *channel)
+{
+	Lock lock(mutex);
+	completionChannel.set(channel);
+}
+
+Channel *JobPool::getCompletionChannel() const
+{
+	Lock lock(mutex);
+	return completionChannel.get();
+}
+
+Job *JobPool::takeJob(int index)
+{
+	Job *job = nullptr;
+
+	{
+		Worker *own = workers[index];
+		Lock lock(own->queueMutex);
+
+		if (!own->queue.empty())
+		{
+			job = own->queue.back();
+			own->queue.pop_back();
+		}
+	}
+
+	for (size_t i = 1; job == nullptr && i < workers.size(); i++)
+	{
+		Worker *victim = workers[(index + i) % workers.size()];
+		Lock lock(victim->queueMutex);
+
+		if (!victim->queue.empty())
+		{
+			job = victim->queue.front();
+			victim->queue.pop_front();
+		}
+	}
+
+	if (job != nullptr)
+		pending--;
+
+	return job;
+}
+
+void JobPool::workerLoop(int index)
+{
+	lua_State *L = LuaThread::createState();
+
+	while (true)
+	{
+		Job *job = takeJob(index);
+
+		if (job != nullptr)
+		{
+			runJob(L, job);
+			continue;
+		}
+
+		Lock lock(mutex);
+
+		if (stopping)
+			break;
+
+		if (pending == 0)
+			cond->wait(mutex);
+	}
+
+	lua_close(L);
+}
+
+// Runs inside lua_pcall, so errors from require, the job function and
+// converting its results are all caught.
+static int w_runJob(lua_State *L)
+{
+	Job *job = (Job *) lua_touserdata(L, 1);
+	std::vector<Variant> *results = (std::vector<Variant> *) lua_touserdata(L, 2);
+	const std::vector<Variant> &args = *(const std::vector<Variant> *) lua_touserdata(L, 3);
+	lua_settop(L, 0);
+
+	luax_require(L, job->getModule().c_str());
+
+	if (!job->getFunction().empty())
+	{
+		lua_getfield(L, -1, job->getFunction().c_str());
+		lua_remove(L, -2);
+	}
+
+	if (!lua_isfunction(L, -1))
+		return luaL_error(L, "Job function %s.%s is not a function.", job->getModule().c_str(), job->getFunction().c_str());
+
+	luaL_checkstack(L, (int) args.size(), "Too many job arguments.");
+	for (const Variant &arg : args)
+		arg.toLua(L);
+
+	lua_call(L, (int) args.size(), LUA_MULTRET);
+
+	int count = lua_gettop(L);
+
+	luax_catchexcept(L, [&]() {
+		for (int i = 1; i <= count; i++)
+		{
+			results->push_back(Variant::fromLua(L, i));
+			if (results->back().getType() == Variant::UNKNOWN)
+				throw love::Exception("Job returned a value of type %s, which can't be sent between threads.", luaL_typename(L, i));
+		}
+	});
+
+	return 0;
+}
+
+void JobPool::runJob(lua_State *L, Job *job)
+{
+	std::vector<Variant> results;
+	std::string error;
+
+	lua_settop(L, 0);
+	lua_pushcfunction(L, luax_traceback);
+	lua_pushcfunction(L, w_runJob);
+	lua_pushlightuserdata(L, job);
+	lua_pushlightuserdata(L, &results);
+	lua_pushlightuserdata(L, &job->args);
+
+	if (lua_pcall(L, 3, 0, 1) != 0)
+	{
+		error = luax_tostring(L, -1);
+		results.clear();
+	}
+
+	lua_settop(L, 0);
+
+	job->finish(results, error);
+
+	// Keep the Channel alive even if it's replaced while pushing.
+	StrongRef<Channel> channel;
+	{
+		Lock lock(mutex);
+		channel = completionChannel;
+	}
+
+	if (channel.get() != nullptr)
+		channel->push(Variant(&Job::type, job));
+
+	job->release();
+}
+
+} // thread
+} // love
@@ -0,0 +1,165 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_JOB_POOL_H
+#define LOVE_THREAD_JOB_POOL_H
+
+// LOVE
+#include "common/Object.h"
+#include "common/Variant.h"
+#include "Channel.h"
+#include "threads.h"
+
+// C++
+#include <atomic>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * A call to a Lua function, run by a JobPool. The function is looked up as
+ * require(module)[function] in the worker's Lua state, or require(module)
+ * itself if no function name is given.
+ **/
+class Job : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	Job(const std::string &module, const std::string &function, const std::vector<Variant> &args);
+	virtual ~Job();
+
+	bool isDone() const;
+
+	/**
+	 * Waits for the job to finish. A negative timeout waits forever.
+	 * Returns whether the job is done.
+	 **/
+	bool wait(double timeout = -1.0);
+
+	// Only valid once the job is done.
+	const std::vector<Variant> &getResults() const;
+	const std::string &getError() const;
+
+	const std::string &getModule() const;
+	const std::string &getFunction() const;
+
+private:
+
+	friend class JobPool;
+
+	void finish(const std::vector<Variant> &results, const std::string &error);
+
+	std::string module;
+	std::string function;
+	std::vector<Variant> args;
+
+	std::vector<Variant> results;
+	std::string error;
+	bool done;
+
+	MutexRef mutex;
+	ConditionalRef cond;
+
+}; // Job
+
+/**
+ * A fixed set of worker threads, each with a Lua state that's created once
+ * and reused for every job it runs. Each worker has its own queue of jobs,
+ * and workers with nothing to do steal from the back of the others' queues.
+ *
+ * Engine code that doesn't need Lua should use WorkerPool instead.
+ **/
+class JobPool : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	JobPool(int workercount);
+	virtual ~JobPool();
+
+	void submit(Job *job);
+
+	int getWorkerCount() const;
+
+	/**
+	 * Gets the number of jobs which haven't started yet.
+	 **/
+	int getPendingCount() const;
+
+	/**
+	 * Sets a Channel which every finished Job is pushed to, or nullptr.
+	 **/
+	void setCompletionChannel(Channel *channel);
+	Channel *getCompletionChannel() const;
+
+private:
+
+	class Worker : public Threadable
+	{
+	public:
+
+		Worker(JobPool *pool, int index);
+
+		// Implements Threadable.
+		void threadFunction() override;
+
+		MutexRef queueMutex;
+		std::deque<Job *> queue;
+
+	private:
+
+		JobPool *pool;
+		int index;
+
+	}; // Worker
+
+	void workerLoop(int index);
+
+	// Takes the newest job from the worker's own queue, or steals the oldest
+	// job from another worker's queue.
+	Job *takeJob(int index);
+
+	void runJob(lua_State *L, Job *job);
+
+	std::vector<Worker *> workers;
+
+	MutexRef mutex;
+	ConditionalRef cond;
+	bool stopping;
+
+	std::atomic<int> pending;
+	std::atomic<unsigned int> nextWorker;
+
+	StrongRef<Channel> completionChannel;
+
+}; // JobPool
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_JOB_POOL_H
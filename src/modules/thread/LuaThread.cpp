@@ -22,6 +22,9 @@
 #include "event/Event.h"
 #include "common/config.h"
 
+// C++
+#include <algorithm>
+
 #ifdef LOVE_BUILD_STANDALONE
 extern "C" int luaopen_love(lua_State * L);
 #endif // LOVE_BUILD_STANDALONE
@@ -33,6 +36,69 @@ namespace thread
 
 love::Type LuaThread::type("Thread", &Threadable::type);
 
+static const char *STATE_SNAPSHOT_KEY = "_love_thread_snapshot";
+
+static std::vector<lua_State *> statePool;
+static int statePoolSize = 0;
+
+static Mutex *getStatePoolMutex()
+{
+	static MutexRef mutex;
+	return mutex;
+}
+
+static void pushGlobals(lua_State *L)
+{
+#if LUA_VERSION_NUM >= 502
+	lua_pushglobaltable(L);
+#else
+	lua_pushvalue(L, LUA_GLOBALSINDEX);
+#endif
+}
+
+// Pushes a shallow copy of the table at the (absolute) index.
+static void copyTable(lua_State *L, int idx)
+{
+	lua_newtable(L);
+	lua_pushnil(L);
+	while (lua_next(L, idx) != 0)
+	{
+		lua_pushvalue(L, -2);
+		lua_insert(L, -2);
+		lua_rawset(L, -4);
+	}
+}
+
+// Makes the table at target contain exactly the fields of the copy at source.
+static void restoreTable(lua_State *L, int target, int source)
+{
+	lua_pushnil(L);
+	while (lua_next(L, target) != 0)
+	{
+		lua_pop(L, 1);
+		lua_pushvalue(L, -1);
+		lua_rawget(L, source);
+		bool keep = !lua_isnil(L, -1);
+		lua_pop(L, 1);
+
+		// Clearing existing fields is allowed while traversing.
+		if (!keep)
+		{
+			lua_pushvalue(L, -1);
+			lua_pushnil(L);
+			lua_rawset(L, target);
+		}
+	}
+
+	lua_pushnil(L);
+	while (lua_next(L, source) != 0)
+	{
+		lua_pushvalue(L, -2);
+		lua_insert(L, -2);
+		lua_rawset(L, target);
+	}
+}
+
 LuaThread::LuaThread(const std::string &name, love::Data *code)
 	: code(code)
 	, name(name)
@@ -44,10 +110,8 @@ LuaThread::~LuaThread()
 {
 }
 
-void LuaThread::threadFunction()
+lua_State *LuaThread::createState()
 {
-	error.clear();
-
 	lua_State *L = luaL_newstate();
 	luaL_openlibs(L);
 
@@ -66,6 +130,173 @@ void LuaThread::threadFunction()
 	luax_require(L, "love.filesystem");
 	lua_pop(L, 1);
 
+	return L;
+}
+
+void LuaThread::snapshotState(lua_State *L)
+{
+	// {table, copy, table, copy, ...} for the globals, package.loaded, love
+	// and loaded module tables. Restoring the last one lets modules loaded by
+	// a Thread be released once it's done.
+	lua_newtable(L);
+	int snapshot = lua_gettop(L);
+	int count = 0;
+
+	pushGlobals(L);
+	lua_getglobal(L, "package");
+	lua_getfield(L, -1, "loaded");
+	lua_remove(L, -2);
+	lua_getglobal(L, "love");
+	luax_getregistry(L, REGISTRY_MODULES);
+
+	for (int i = snapshot + 1; i <= snapshot + 4; i++)
+	{
+		if (!lua_istable(L, i))
+			continue;
+
+		lua_pushvalue(L, i);
+		lua_rawseti(L, snapshot, ++count);
+		copyTable(L, i);
+		lua_rawseti(L, snapshot, ++count);
+	}
+
+	lua_settop(L, snapshot);
+	lua_setfield(L, LUA_REGISTRYINDEX, STATE_SNAPSHOT_KEY);
+}
+
+void LuaThread::resetState(lua_State *L)
+{
+	lua_settop(L, 0);
+
+	lua_getfield(L, LUA_REGISTRYINDEX, STATE_SNAPSHOT_KEY);
+	int count = (int) luax_objlen(L, 1);
+
+	for (int i = 1; i + 1 <= count; i += 2)
+	{
+		lua_rawgeti(L, 1, i);
+		lua_rawgeti(L, 1, i + 1);
+		restoreTable(L, 2, 3);
+		lua_pop(L, 2);
+	}
+
+	lua_settop(L, 0);
+
+	pushGlobals(L);
+	lua_pushnil(L);
+	lua_setmetatable(L, -2);
+	lua_pop(L, 1);
+
+	// Collect whatever the last Thread left behind, including modules it
+	// loaded, before the state sits in the pool.
+	lua_gc(L, LUA_GCCOLLECT, 0);
+}
+
+lua_State *LuaThread::acquireState()
+{
+	{
+		Lock l(getStatePoolMutex());
+		if (!statePool.empty())
+		{
+			lua_State *L = statePool.back();
+			statePool.pop_back();
+			return L;
+		}
+	}
+
+	lua_State *L = createState();
+	snapshotState(L);
+	return L;
+}
+
+void LuaThread::releaseState(lua_State *L)
+{
+	{
+		Lock l(getStatePoolMutex());
+		if ((int) statePool.size() >= statePoolSize)
+			L = nullptr;
+	}
+
+	if (L == nullptr)
+		return;
+
+	resetState(L);
+
+	{
+		Lock l(getStatePoolMutex());
+		if ((int) statePool.size() < statePoolSize)
+		{
+			statePool.push_back(L);
+			return;
+		}
+	}
+
+	lua_close(L);
+}
+
+void LuaThread::setStatePoolSize(int size, bool prewarm)
+{
+	std::vector<lua_State *> closing;
+	int missing = 0;
+
+	{
+		Lock l(getStatePoolMutex());
+		statePoolSize = std::max(size, 0);
+
+		while ((int) statePool.size() > statePoolSize)
+		{
+			closing.push_back(statePool.back());
+			statePool.pop_back();
+		}
+
+		if (prewarm)
+			missing = statePoolSize - (int) statePool.size();
+	}
+
+	for (lua_State *L : closing)
+		lua_close(L);
+
+	for (int i = 0; i < missing; i++)
+	{
+		lua_State *L = createState();
+		snapshotState(L);
+
+		Lock l(getStatePoolMutex());
+		if ((int) statePool.size() < statePoolSize)
+			statePool.push_back(L);
+		else
+		{
+			lua_close(L);
+			break;
+		}
+	}
+}
+
+int LuaThread::getStatePoolSize()
+{
+	Lock l(getStatePoolMutex());
+	return statePoolSize;
+}
+
+void LuaThread::clearStatePool()
+{
+	std::vector<lua_State *> closing;
+
+	{
+		Lock l(getStatePoolMutex());
+		closing.swap(statePool);
+	}
+
+	// Closed outside the lock, a closing state can end up calling back in.
+	for (lua_State *L : closing)
+		lua_close(L);
+}
+
+void LuaThread::threadFunction()
+{
+	error.clear();
+
+	lua_State *L = acquireState();
+
 	lua_pushcfunction(L, luax_traceback);
 	int tracebackidx = lua_gettop(L);
 
@@ -84,7 +315,12 @@ void LuaThread::threadFunction()
 			error = luax_tostring(L, -1);
 	}
 
-	lua_close(L);
+	// Don't reuse a state after an error, it may have been left inconsistent
+	// (e.g. by running out of memory).
+	if (error.empty())
+		releaseState(L);
+	else
+		lua_close(L);
 
 	if (!error.empty())
 		onError();
@@ -110,12 +346,10 @@ void LuaThread::onError()
 	if (!eventmodule)
 		return;
 
-	std::vector<Variant> vargs = {
-		Variant(&LuaThread::type, this),
-		Variant(error.c_str(), error.length())
-	};
+	event::Message msg("threaderror");
+	msg.addArg(Variant(&LuaThread::type, this));
+	msg.addArg(Variant(error.c_str(), error.length()));
 
-	StrongRef<event::Message> msg(new event::Message("threaderror", vargs), Acquire::NORETAIN);
 	eventmodule->push(msg);
 }
 
@@ -49,10 +49,36 @@ public:
 
 	bool start(const std::vector<Variant> &args);
 
+	/**
+	 * Creates a Lua state for a thread, with love, love.thread and
+	 * love.filesystem loaded.
+	 **/
+	static lua_State *createState();
+
+	/**
+	 * Sets how many Lua states are kept after their Threads finish, so later
+	 * Threads can skip creating them. A reused state has its globals,
+	 * package.loaded and love table put back the way they were when it was
+	 * created, but tables inside them aren't reset. A size of 0 (the default)
+	 * disables reuse. If prewarm is true, the pool is filled right away.
+	 **/
+	static void setStatePoolSize(int size, bool prewarm);
+	static int getStatePoolSize();
+
+	/**
+	 * Closes every state in the pool, without changing its size.
+	 **/
+	static void clearStatePool();
+
 private:
 
 	void onError();
 
+	static lua_State *acquireState();
+	static void releaseState(lua_State *L);
+	static void snapshotState(lua_State *L);
+	static void resetState(lua_State *L);
+
 	StrongRef<love::Data> code;
 	std::string name;
 	std::string error;
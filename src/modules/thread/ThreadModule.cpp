@@ -35,11 +35,21 @@ Channel *ThreadModule::newChannel()
 	return new Channel();
 }
 
+Channel *ThreadModule::newChannel(Channel::Mode mode, size_t capacity)
+{
+	return new Channel(mode, capacity);
+}
+
 Channel *ThreadModule::getChannel(const std::string &name)
 {
 	return Channel::getChannel(name);
 }
 
+JobPool *ThreadModule::newJobPool(int workercount)
+{
+	return new JobPool(workercount);
+}
+
 const char *ThreadModule::getName() const
 {
 	return "love.thread.sdl";
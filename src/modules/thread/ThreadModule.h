@@ -32,6 +32,7 @@
 #include "Thread.h"
 #include "Channel.h"
 #include "LuaThread.h"
+#include "JobPool.h"
 #include "threads.h"
 
 namespace love
@@ -45,7 +46,9 @@ public:
 	virtual ~ThreadModule() {}
 	virtual LuaThread *newThread(const std::string &name, love::Data *data);
 	virtual Channel *newChannel();
+	virtual Channel *newChannel(Channel::Mode mode, size_t capacity);
 	virtual Channel *getChannel(const std::string &name);
+	virtual JobPool *newJobPool(int workercount);
 
 	// Implements Module.
 	virtual const char *getName() const;
@@ -0,0 +1,184 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "VariantRing.h"
+
+namespace love
+{
+namespace thread
+{
+
+VariantRing::VariantRing(size_t capacity, bool multiproducer)
+	: slots(nullptr)
+	, mask(0)
+	, multiproducer(multiproducer)
+	, tail(0)
+	, cachedHead(0)
+	, head(0)
+	, cachedTail(0)
+{
+	uint64 size = 1;
+	while (size < capacity)
+		size <<= 1;
+
+	slots = new Slot[size];
+	mask = size - 1;
+
+	// Each slot's sequence is the position it'll next be written at.
+	for (uint64 i = 0; i < size; i++)
+		slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+VariantRing::~VariantRing()
+{
+	delete[] slots;
+}
+
+bool VariantRing::tryPush(const Variant &var, uint64 &id)
+{
+	return multiproducer ? tryPushMulti(var, id) : tryPushSingle(var, id);
+}
+
+bool VariantRing::tryPop(Variant &var)
+{
+	return multiproducer ? tryPopMulti(var) : tryPopSingle(var);
+}
+
+uint64 VariantRing::getPopCount() const
+{
+	return head.load(std::memory_order_acquire);
+}
+
+size_t VariantRing::getCount() const
+{
+	uint64 h = head.load(std::memory_order_acquire);
+	uint64 t = tail.load(std::memory_order_acquire);
+	return t > h ? (size_t) (t - h) : 0;
+}
+
+size_t VariantRing::getCapacity() const
+{
+	return (size_t) (mask + 1);
+}
+
+bool VariantRing::tryPushSingle(const Variant &var, uint64 &id)
+{
+	uint64 t = tail.load(std::memory_order_relaxed);
+
+	if (t - cachedHead > mask)
+	{
+		cachedHead = head.load(std::memory_order_acquire);
+		if (t - cachedHead > mask)
+			return false;
+	}
+
+	slots[t & mask].value = var;
+	tail.store(t + 1, std::memory_order_release);
+
+	id = t + 1;
+	return true;
+}
+
+bool VariantRing::tryPopSingle(Variant &var)
+{
+	uint64 h = head.load(std::memory_order_relaxed);
+
+	if (h == cachedTail)
+	{
+		cachedTail = tail.load(std::memory_order_acquire);
+		if (h == cachedTail)
+			return false;
+	}
+
+	Slot &slot = slots[h & mask];
+	var = slot.value;
+
+	// Don't keep objects alive just because they passed through the ring.
+	slot.value = Variant();
+
+	head.store(h + 1, std::memory_order_release);
+	return true;
+}
+
+// Dmitry Vyukov's bounded MPMC queue: producers and consumers claim
+// positions with a CAS, and each slot's sequence says whether it's ready to
+// be written or read at a given position.
+
+bool VariantRing::tryPushMulti(const Variant &var, uint64 &id)
+{
+	uint64 pos = tail.load(std::memory_order_relaxed);
+	Slot *slot = nullptr;
+
+	while (true)
+	{
+		slot = &slots[pos & mask];
+		uint64 seq = slot->sequence.load(std::memory_order_acquire);
+		int64 diff = (int64) seq - (int64) pos;
+
+		if (diff == 0)
+		{
+			if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+			return false;
+		else
+			pos = tail.load(std::memory_order_relaxed);
+	}
+
+	slot->value = var;
+	slot->sequence.store(pos + 1, std::memory_order_release);
+
+	id = pos + 1;
+	return true;
+}
+
+bool VariantRing::tryPopMulti(Variant &var)
+{
+	uint64 pos = head.load(std::memory_order_relaxed);
+	Slot *slot = nullptr;
+
+	while (true)
+	{
+		slot = &slots[pos & mask];
+		uint64 seq = slot->sequence.load(std::memory_order_acquire);
+		int64 diff = (int64) seq - (int64) (pos + 1);
+
+		if (diff == 0)
+		{
+			if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+			return false;
+		else
+			pos = head.load(std::memory_order_relaxed);
+	}
+
+	var = slot->value;
+	slot->value = Variant();
+	slot->sequence.store(pos + mask + 1, std::memory_order_release);
+
+	return true;
+}
+
+} // thread
+} // love
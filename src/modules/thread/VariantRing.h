@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_VARIANT_RING_H
+#define LOVE_THREAD_VARIANT_RING_H
+
+// LOVE
+#include "common/Variant.h"
+#include "common/int.h"
+
+// C++
+#include <atomic>
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * A bounded queue of Variants in a preallocated ring, which never locks.
+ * Single-producer rings must only be pushed to by one thread at a time and
+ * popped from by one thread at a time; multi-producer rings allow any number
+ * of both.
+ **/
+class VariantRing
+{
+public:
+
+	/**
+	 * @param capacity The number of values the ring can hold. It's rounded up
+	 *        to a power of two.
+	 * @param multiproducer Whether multiple threads may push or pop at once.
+	 **/
+	VariantRing(size_t capacity, bool multiproducer);
+	~VariantRing();
+
+	/**
+	 * Adds a value if there's room. id is set to the value's position in the
+	 * sequence of every value pushed, starting at 1.
+	 **/
+	bool tryPush(const Variant &var, uint64 &id);
+
+	/**
+	 * Removes the oldest value if there is one.
+	 **/
+	bool tryPop(Variant &var);
+
+	/**
+	 * The number of values popped so far. A pushed value has been read once
+	 * this reaches its id.
+	 **/
+	uint64 getPopCount() const;
+
+	/**
+	 * The number of values in the ring. Only a snapshot while other threads
+	 * are using it.
+	 **/
+	size_t getCount() const;
+
+	size_t getCapacity() const;
+
+private:
+
+	struct Slot
+	{
+		std::atomic<uint64> sequence;
+		Variant value;
+	};
+
+	bool tryPushSingle(const Variant &var, uint64 &id);
+	bool tryPopSingle(Variant &var);
+	bool tryPushMulti(const Variant &var, uint64 &id);
+	bool tryPopMulti(Variant &var);
+
+	Slot *slots;
+	uint64 mask;
+	bool multiproducer;
+
+	// Padded onto separate cache lines so producers and consumers don't
+	// contend. (alignas would need C++17's aligned new.)
+	char padding0[64];
+	std::atomic<uint64> tail;
+	uint64 cachedHead; // Single-producer only.
+
+	char padding1[64];
+	std::atomic<uint64> head;
+	uint64 cachedTail; // Single-producer only.
+	char padding2[64];
+
+}; // VariantRing
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_VARIANT_RING_H
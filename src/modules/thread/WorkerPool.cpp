@@ -0,0 +1,227 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "WorkerPool.h"
+#include "common/Exception.h"
+#include "common/cpu.h"
+
+// C++
+#include <algorithm>
+#include <exception>
+
+namespace love
+{
+namespace thread
+{
+
+WorkerPool::Worker::Worker(WorkerPool *pool, int index)
+	: pool(pool)
+{
+	threadName = "WorkerPool" + std::to_string(index);
+}
+
+void WorkerPool::Worker::threadFunction()
+{
+	pool->workerLoop();
+}
+
+WorkerPool::WorkerPool(int workercount)
+	: job(nullptr)
+	, jobCount(0)
+	, nextIndex(0)
+	, remaining(0)
+	, generation(0)
+	, stopping(false)
+{
+	for (int i = 0; i < workercount; i++)
+	{
+		Worker *worker = new Worker(this, i);
+
+		if (!worker->start())
+		{
+			delete worker;
+			break;
+		}
+
+		workers.push_back(worker);
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		Lock lock(mutex);
+		stopping = true;
+		jobCond->broadcast();
+	}
+
+	for (Worker *worker : workers)
+	{
+		worker->wait();
+		delete worker;
+	}
+}
+
+WorkerPool &WorkerPool::getShared()
+{
+	// Never destroyed: joining threads from static destructors at exit isn't
+	// safe on every platform.
+	static WorkerPool *pool = new WorkerPool(std::max(getParallelThreadCount() - 1, 0));
+	return *pool;
+}
+
+int WorkerPool::getWorkerCount() const
+{
+	return (int) workers.size();
+}
+
+void WorkerPool::parallelFor(int count, const std::function<void(int)> &fn)
+{
+	if (count <= 0)
+		return;
+
+	// Not worth waking anyone up for.
+	if (workers.empty() || count == 1)
+	{
+		for (int i = 0; i < count; i++)
+			fn(i);
+		return;
+	}
+
+	Lock runlock(runMutex);
+
+	{
+		Lock lock(mutex);
+		job = &fn;
+		jobCount = count;
+		nextIndex = 0;
+		remaining = count;
+		error.clear();
+		generation++;
+		jobCond->broadcast();
+	}
+
+	runItems();
+
+	std::string jobError;
+
+	{
+		Lock lock(mutex);
+		while (remaining > 0)
+			doneCond->wait(mutex);
+
+		job = nullptr;
+		jobError.swap(error);
+	}
+
+	if (!jobError.empty())
+		throw love::Exception("%s", jobError.c_str());
+}
+
+void WorkerPool::submit(const std::function<void()> &task)
+{
+	if (workers.empty())
+	{
+		task();
+		return;
+	}
+
+	Lock lock(mutex);
+	tasks.push_back(task);
+	jobCond->signal();
+}
+
+void WorkerPool::runItems()
+{
+	while (true)
+	{
+		const std::function<void(int)> *fn = nullptr;
+		int index = 0;
+
+		{
+			Lock lock(mutex);
+			if (job == nullptr || nextIndex >= jobCount)
+				return;
+
+			fn = job;
+			index = nextIndex++;
+		}
+
+		try
+		{
+			(*fn)(index);
+		}
+		catch (std::exception &e)
+		{
+			Lock lock(mutex);
+			if (error.empty())
+				error = e.what();
+		}
+
+		Lock lock(mutex);
+		if (--remaining == 0)
+			doneCond->signal();
+	}
+}
+
+void WorkerPool::workerLoop()
+{
+	int seen = 0;
+
+	while (true)
+	{
+		std::function<void()> task;
+
+		{
+			Lock lock(mutex);
+			while (!stopping && (job == nullptr || generation == seen) && tasks.empty())
+				jobCond->wait(mutex);
+
+			if (stopping)
+				return;
+
+			// parallelFor has a thread waiting on it, so it goes first.
+			if (job != nullptr && generation != seen)
+				seen = generation;
+			else
+			{
+				task = tasks.front();
+				tasks.pop_front();
+			}
+		}
+
+		if (task)
+		{
+			try
+			{
+				task();
+			}
+			catch (std::exception &)
+			{
+			}
+		}
+		else
+			runItems();
+	}
+}
+
+} // thread
+} // love
@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_WORKER_POOL_H
+#define LOVE_THREAD_WORKER_POOL_H
+
+// LOVE
+#include "threads.h"
+
+// C++
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * A fixed set of threads for splitting independent pieces of engine work.
+ * It isn't exposed to Lua: modules use it internally for batched operations.
+ **/
+class WorkerPool
+{
+public:
+
+	WorkerPool(int workercount);
+	~WorkerPool();
+
+	/**
+	 * Calls fn(i) for every i in [0, count), spread across the workers and
+	 * the calling thread, and returns once every call has finished. If any
+	 * call throws, the first error is rethrown as a love::Exception.
+	 * fn must not call parallelFor on the same pool.
+	 **/
+	void parallelFor(int count, const std::function<void(int)> &fn);
+
+	/**
+	 * Queues a task to run on a worker thread, and returns immediately.
+	 * The task runs on the calling thread if the pool has no workers. Tasks
+	 * must handle their own errors, and ones still queued when the pool is
+	 * destroyed never run.
+	 **/
+	void submit(const std::function<void()> &task);
+
+	int getWorkerCount() const;
+
+	/**
+	 * Gets a pool with one worker per extra physical processor core, created
+	 * the first time it's needed.
+	 **/
+	static WorkerPool &getShared();
+
+private:
+
+	class Worker : public Threadable
+	{
+	public:
+
+		Worker(WorkerPool *pool, int index);
+
+		// Implements Threadable.
+		void threadFunction() override;
+
+	private:
+
+		WorkerPool *pool;
+
+	}; // Worker
+
+	void workerLoop();
+
+	// Claims and runs items of the current job until none are left.
+	void runItems();
+
+	std::vector<Worker *> workers;
+
+	// Only one parallelFor runs at a time.
+	MutexRef runMutex;
+
+	MutexRef mutex;
+	ConditionalRef jobCond;
+	ConditionalRef doneCond;
+
+	const std::function<void(int)> *job;
+	int jobCount;
+	int nextIndex;
+	int remaining;
+	int generation;
+	bool stopping;
+
+	std::string error;
+
+	std::deque<std::function<void()>> tasks;
+
+}; // WorkerPool
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_WORKER_POOL_H
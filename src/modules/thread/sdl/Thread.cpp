@@ -19,6 +19,14 @@
  **/
 
 #include "Thread.h"
+#include "common/profiling.h"
+
+#if defined(LOVE_WINDOWS) && !defined(LOVE_WINDOWS_UWP)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace love
 {
@@ -30,6 +38,7 @@ Thread::Thread(Threadable *t)
 	: t(t)
 	, running(false)
 	, thread(nullptr)
+	, priority(Threadable::PRIORITY_NORMAL)
 {
 }
 
@@ -52,6 +61,8 @@ bool Thread::start()
 		return false;
 	if (thread) // Clean old handle up
 		SDL_WaitThread(thread, nullptr);
+	priority = t->getThreadPriority();
+	affinity = t->getThreadAffinity();
 	thread = SDL_CreateThread(thread_runner, t->getThreadName(), this);
 	running = (thread != nullptr);
 
@@ -85,6 +96,23 @@ int Thread::thread_runner(void *data)
 	Thread *self = (Thread *) data; // some compilers don't like 'this'
 	self->t->retain();
 
+	setProfileThreadName(self->t->getThreadName());
+
+	switch (self->priority)
+	{
+	case Threadable::PRIORITY_LOW:
+		SDL_SetThreadPriority(SDL_THREAD_PRIORITY_LOW);
+		break;
+	case Threadable::PRIORITY_HIGH:
+		SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+		break;
+	default:
+		break;
+	}
+
+	if (!self->affinity.empty())
+		setCurrentAffinity(self->affinity);
+
 	self->t->threadFunction();
 
 	{
@@ -95,6 +123,41 @@ int Thread::thread_runner(void *data)
 	self->t->release();
 	return 0;
 }
+
+void Thread::setCurrentAffinity(const std::vector<int> &cores)
+{
+	// Failures are ignored, affinity is only a hint.
+#if defined(LOVE_WINDOWS) && !defined(LOVE_WINDOWS_UWP)
+	DWORD_PTR mask = 0;
+	for (int core : cores)
+	{
+		if (core >= 0 && core < (int) (sizeof(DWORD_PTR) * 8))
+			mask |= (DWORD_PTR) 1 << core;
+	}
+
+	if (mask != 0)
+		SetThreadAffinityMask(GetCurrentThread(), mask);
+#elif defined(__linux__)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+
+	bool any = false;
+	for (int core : cores)
+	{
+		if (core >= 0 && core < CPU_SETSIZE)
+		{
+			CPU_SET(core, &set);
+			any = true;
+		}
+	}
+
+	if (any)
+		sched_setaffinity(0, sizeof(set), &set);
+#else
+	// macOS and iOS don't let threads be pinned to cores.
+	LOVE_UNUSED(cores);
+#endif
+}
 } // sdl
 } // thread
 } // love
@@ -28,6 +28,9 @@
 // SDL
 #include <SDL_thread.h>
 
+// C++
+#include <vector>
+
 namespace love
 {
 namespace thread
@@ -52,7 +55,12 @@ private:
 	SDL_Thread *thread;
 	Mutex mutex;
 
+	// Copied from the Threadable when starting.
+	Threadable::Priority priority;
+	std::vector<int> affinity;
+
 	static int thread_runner(void *data);
+	static void setCurrentAffinity(const std::vector<int> &cores);
 
 }; // Thread
 
@@ -21,6 +21,8 @@
 #include "threads.h"
 #include "Thread.h"
 
+#include <SDL_cpuinfo.h>
+
 namespace love
 {
 namespace thread
@@ -102,5 +104,10 @@ thread::Thread *newThread(Threadable *t)
 	return new sdl::Thread(t);
 }
 
+int getProcessorCount()
+{
+	return SDL_GetCPUCount();
+}
+
 } // thread
 } // love
@@ -88,6 +88,7 @@ void EmptyLock::setLock(Mutex &m)
 love::Type Threadable::type("Threadable", &Object::type);
 
 Threadable::Threadable()
+	: threadPriority(PRIORITY_NORMAL)
 {
 	owner = newThread(this);
 }
@@ -117,6 +118,55 @@ const char *Threadable::getThreadName() const
 	return threadName.empty() ? nullptr : threadName.c_str();
 }
 
+void Threadable::setThreadName(const std::string &name)
+{
+	threadName = name;
+}
+
+void Threadable::setThreadPriority(Priority priority)
+{
+	threadPriority = priority;
+}
+
+Threadable::Priority Threadable::getThreadPriority() const
+{
+	return threadPriority;
+}
+
+void Threadable::setThreadAffinity(const std::vector<int> &cores)
+{
+	threadAffinity = cores;
+}
+
+const std::vector<int> &Threadable::getThreadAffinity() const
+{
+	return threadAffinity;
+}
+
+StringMap<Threadable::Priority, Threadable::PRIORITY_MAX_ENUM>::Entry Threadable::priorityEntries[] =
+{
+	{ "low",    PRIORITY_LOW    },
+	{ "normal", PRIORITY_NORMAL },
+	{ "high",   PRIORITY_HIGH   },
+};
+
+StringMap<Threadable::Priority, Threadable::PRIORITY_MAX_ENUM> Threadable::priorities(Threadable::priorityEntries, sizeof(Threadable::priorityEntries));
+
+bool Threadable::getConstant(const char *in, Priority &out)
+{
+	return priorities.find(in, out);
+}
+
+bool Threadable::getConstant(Priority in, const char *&out)
+{
+	return priorities.find(in, out);
+}
+
+std::vector<std::string> Threadable::getConstants(Priority)
+{
+	return priorities.getNames();
+}
+
 MutexRef::MutexRef()
 	: mutex(newMutex())
 {
@@ -23,10 +23,12 @@
 
 // LOVE
 #include "common/config.h"
+#include "common/StringMap.h"
 #include "Thread.h"
 
 // C++
 #include <string>
+#include <vector>
 
 namespace love
 {
@@ -82,6 +84,14 @@ class Threadable : public love::Object
 public:
 	static love::Type type;
 
+	enum Priority
+	{
+		PRIORITY_LOW,
+		PRIORITY_NORMAL,
+		PRIORITY_HIGH,
+		PRIORITY_MAX_ENUM
+	};
+
 	Threadable();
 	virtual ~Threadable();
 
@@ -92,10 +102,38 @@ public:
 	bool isRunning() const;
 	const char *getThreadName() const;
 
+	/**
+	 * The name, priority and affinity are applied when the thread starts, so
+	 * changing them while it's running only affects the next start.
+	 **/
+	void setThreadName(const std::string &name);
+
+	void setThreadPriority(Priority priority);
+	Priority getThreadPriority() const;
+
+	/**
+	 * Sets the logical CPU cores (starting at 0) the thread may run on. An
+	 * empty list lets it run anywhere. The OS treats this as a hint, and it's
+	 * ignored on platforms without an affinity API.
+	 **/
+	void setThreadAffinity(const std::vector<int> &cores);
+	const std::vector<int> &getThreadAffinity() const;
+
+	static bool getConstant(const char *in, Priority &out);
+	static bool getConstant(Priority in, const char *&out);
+	static std::vector<std::string> getConstants(Priority);
+
 protected:
 
 	Thread *owner;
 	std::string threadName;
+	Priority threadPriority;
+	std::vector<int> threadAffinity;
+
+private:
+
+	static StringMap<Priority, PRIORITY_MAX_ENUM>::Entry priorityEntries[];
+	static StringMap<Priority, PRIORITY_MAX_ENUM> priorities;
 
 };
 
@@ -129,6 +167,11 @@ Mutex *newMutex();
 Conditional *newConditional();
 Thread *newThread(Threadable *t);
 
+/**
+ * Gets the number of logical CPU cores.
+ **/
+int getProcessorCount();
+
 #if defined(LOVE_LINUX)
 void disableSignals();
 void reenableSignals();
@@ -94,13 +94,77 @@ int w_Channel_peek(lua_State *L)
 {
 	Channel *c = luax_checkchannel(L, 1);
 	Variant var;
-	if (c->peek(&var))
+	bool result = false;
+	luax_catchexcept(L, [&]() { result = c->peek(&var); });
+	if (result)
 		var.toLua(L);
 	else
 		lua_pushnil(L);
 	return 1;
 }
 
+int w_Channel_pushMany(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+
+	int count = (int) luax_objlen(L, 2);
+	uint64 id = 0;
+
+	luax_catchexcept(L, [&]() {
+		std::vector<Variant> vars;
+		vars.reserve(count);
+
+		for (int i = 1; i <= count; i++)
+		{
+			lua_rawgeti(L, 2, i);
+			vars.push_back(Variant::fromLua(L, -1));
+			lua_pop(L, 1);
+
+			if (vars.back().getType() == Variant::UNKNOWN)
+				throw love::Exception("Invalid value at index %d: boolean, number, string, love type, or table expected", i);
+		}
+
+		id = c->pushMany(vars);
+	});
+
+	lua_pushnumber(L, (lua_Number) id);
+	return 1;
+}
+
+static int pushVariantArray(lua_State *L, const std::vector<Variant> &vars)
+{
+	lua_createtable(L, (int) vars.size(), 0);
+
+	for (size_t i = 0; i < vars.size(); i++)
+	{
+		vars[i].toLua(L);
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	return 1;
+}
+
+int w_Channel_popMany(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	int max = (int) luaL_checkinteger(L, 2);
+	if (max < 0)
+		return luaL_error(L, "Invalid maximum count: %d", max);
+
+	std::vector<Variant> vars;
+	c->popMany(vars, max);
+	return pushVariantArray(L, vars);
+}
+
+int w_Channel_drain(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	std::vector<Variant> vars;
+	c->popMany(vars);
+	return pushVariantArray(L, vars);
+}
+
 int w_Channel_getCount(lua_State *L)
 {
 	Channel *c = luax_checkchannel(L, 1);
@@ -128,6 +192,10 @@ int w_Channel_performAtomic(lua_State *L)
 	Channel *c = luax_checkchannel(L, 1);
 	luaL_checktype(L, 2, LUA_TFUNCTION);
 
+	// Holding the mutex doesn't stop lock-free operations.
+	if (c->getMode() != Channel::MODE_QUEUE)
+		return luaL_error(L, "Lock-free Channels can't perform atomic operations.");
+
 	// Pass this channel as an argument to the function.
 	lua_pushvalue(L, 1);
 	lua_insert(L, 3);
@@ -150,6 +218,27 @@ int w_Channel_performAtomic(lua_State *L)
 	return lua_gettop(L) - 1;
 }
 
+int w_Channel_getMode(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	const char *str = nullptr;
+	if (!Channel::getConstant(c->getMode(), str))
+		return luaL_error(L, "Unknown channel mode.");
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_Channel_getCapacity(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	size_t capacity = c->getCapacity();
+	if (capacity == 0)
+		lua_pushnil(L);
+	else
+		lua_pushnumber(L, (lua_Number) capacity);
+	return 1;
+}
+
 static const luaL_Reg w_Channel_functions[] =
 {
 	{ "push", w_Channel_push },
@@ -157,10 +246,15 @@ static const luaL_Reg w_Channel_functions[] =
 	{ "pop", w_Channel_pop },
 	{ "demand", w_Channel_demand },
 	{ "peek", w_Channel_peek },
+	{ "pushMany", w_Channel_pushMany },
+	{ "popMany", w_Channel_popMany },
+	{ "drain", w_Channel_drain },
 	{ "getCount", w_Channel_getCount },
 	{ "hasRead", w_Channel_hasRead },
 	{ "clear", w_Channel_clear },
 	{ "performAtomic", w_Channel_performAtomic },
+	{ "getMode", w_Channel_getMode },
+	{ "getCapacity", w_Channel_getCapacity },
 	{ 0, 0 }
 };
 
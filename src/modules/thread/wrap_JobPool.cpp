@@ -0,0 +1,183 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_JobPool.h"
+#include "wrap_Channel.h"
+
+namespace love
+{
+namespace thread
+{
+
+Job *luax_checkjob(lua_State *L, int idx)
+{
+	return luax_checktype<Job>(L, idx);
+}
+
+JobPool *luax_checkjobpool(lua_State *L, int idx)
+{
+	return luax_checktype<JobPool>(L, idx);
+}
+
+int w_Job_isDone(lua_State *L)
+{
+	Job *j = luax_checkjob(L, 1);
+	luax_pushboolean(L, j->isDone());
+	return 1;
+}
+
+int w_Job_wait(lua_State *L)
+{
+	Job *j = luax_checkjob(L, 1);
+	double timeout = luaL_optnumber(L, 2, -1.0);
+	luax_pushboolean(L, j->wait(timeout));
+	return 1;
+}
+
+int w_Job_getResults(lua_State *L)
+{
+	Job *j = luax_checkjob(L, 1);
+	if (!j->isDone())
+		return 0;
+
+	const std::vector<Variant> &results = j->getResults();
+	luaL_checkstack(L, (int) results.size(), nullptr);
+
+	for (const Variant &v : results)
+		v.toLua(L);
+
+	return (int) results.size();
+}
+
+int w_Job_getError(lua_State *L)
+{
+	Job *j = luax_checkjob(L, 1);
+	if (!j->isDone() || j->getError().empty())
+		return 0;
+
+	luax_pushstring(L, j->getError());
+	return 1;
+}
+
+int w_Job_getFunction(lua_State *L)
+{
+	Job *j = luax_checkjob(L, 1);
+	luax_pushstring(L, j->getModule());
+
+	if (j->getFunction().empty())
+		return 1;
+
+	luax_pushstring(L, j->getFunction());
+	return 2;
+}
+
+int w_JobPool_submit(lua_State *L)
+{
+	JobPool *p = luax_checkjobpool(L, 1);
+	std::string module = luax_checkstring(L, 2);
+	std::string function = lua_isnoneornil(L, 3) ? std::string() : luax_checkstring(L, 3);
+
+	Job *j = nullptr;
+
+	luax_catchexcept(L, [&]() {
+		std::vector<Variant> args;
+		int top = lua_gettop(L);
+
+		for (int i = 4; i <= top; i++)
+		{
+			args.push_back(Variant::fromLua(L, i));
+			if (args.back().getType() == Variant::UNKNOWN)
+				throw love::Exception("Argument %d can't be sent to another thread: boolean, number, string, love type, or table expected.", i);
+		}
+
+		j = new Job(module, function, args);
+		p->submit(j);
+	});
+
+	luax_pushtype(L, j);
+	j->release();
+	return 1;
+}
+
+int w_JobPool_getWorkerCount(lua_State *L)
+{
+	JobPool *p = luax_checkjobpool(L, 1);
+	lua_pushinteger(L, p->getWorkerCount());
+	return 1;
+}
+
+int w_JobPool_getPendingCount(lua_State *L)
+{
+	JobPool *p = luax_checkjobpool(L, 1);
+	lua_pushinteger(L, p->getPendingCount());
+	return 1;
+}
+
+int w_JobPool_setCompletionChannel(lua_State *L)
+{
+	JobPool *p = luax_checkjobpool(L, 1);
+	Channel *c = lua_isnoneornil(L, 2) ? nullptr : luax_checkchannel(L, 2);
+	p->setCompletionChannel(c);
+	return 0;
+}
+
+int w_JobPool_getCompletionChannel(lua_State *L)
+{
+	JobPool *p = luax_checkjobpool(L, 1);
+	Channel *c = p->getCompletionChannel();
+	if (c != nullptr)
+		luax_pushtype(L, c);
+	else
+		lua_pushnil(L);
+	return 1;
+}
+
+static const luaL_Reg w_Job_functions[] =
+{
+	{ "isDone", w_Job_isDone },
+	{ "wait", w_Job_wait },
+	{ "getResults", w_Job_getResults },
+	{ "getError", w_Job_getError },
+	{ "getFunction", w_Job_getFunction },
+	{ 0, 0 }
+};
+
+static const luaL_Reg w_JobPool_functions[] =
+{
+	{ "submit", w_JobPool_submit },
+	{ "getWorkerCount", w_JobPool_getWorkerCount },
+	{ "getPendingCount", w_JobPool_getPendingCount },
+	{ "setCompletionChannel", w_JobPool_setCompletionChannel },
+	{ "getCompletionChannel", w_JobPool_getCompletionChannel },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_job(lua_State *L)
+{
+	return luax_register_type(L, &Job::type, w_Job_functions, nullptr);
+}
+
+extern "C" int luaopen_jobpool(lua_State *L)
+{
+	return luax_register_type(L, &JobPool::type, w_JobPool_functions, nullptr);
+}
+
+} // thread
+} // love
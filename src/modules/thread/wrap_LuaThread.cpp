@@ -30,6 +30,31 @@ LuaThread *luax_checkthread(lua_State *L, int idx)
 	return luax_checktype<LuaThread>(L, idx);
 }
 
+std::vector<int> luax_checkcorelist(lua_State *L, int idx)
+{
+	if (idx < 0)
+		idx = lua_gettop(L) + idx + 1;
+
+	luaL_checktype(L, idx, LUA_TTABLE);
+	int count = (int) luax_objlen(L, idx);
+	std::vector<int> cores;
+
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, idx, i);
+		int core = (int) luaL_checkinteger(L, -1);
+		lua_pop(L, 1);
+
+		if (core < 1)
+			luaL_error(L, "Invalid CPU core index: %d", core);
+
+		// Lua uses 1-based core indices.
+		cores.push_back(core - 1);
+	}
+
+	return cores;
+}
+
 int w_Thread_start(lua_State *L)
 {
 	LuaThread *t = luax_checkthread(L, 1);
@@ -78,12 +103,82 @@ int w_Thread_isRunning(lua_State *L)
 	return 1;
 }
 
+int w_Thread_setName(lua_State *L)
+{
+	LuaThread *t = luax_checkthread(L, 1);
+	t->setThreadName(luax_checkstring(L, 2));
+	return 0;
+}
+
+int w_Thread_getName(lua_State *L)
+{
+	LuaThread *t = luax_checkthread(L, 1);
+	const char *name = t->getThreadName();
+	lua_pushstring(L, name != nullptr ? name : "");
+	return 1;
+}
+
+int w_Thread_setPriority(lua_State *L)
+{
+	LuaThread *t = luax_checkthread(L, 1);
+	const char *str = luaL_checkstring(L, 2);
+	Threadable::Priority priority;
+	if (!Threadable::getConstant(str, priority))
+		return luax_enumerror(L, "thread priority", Threadable::getConstants(priority), str);
+
+	t->setThreadPriority(priority);
+	return 0;
+}
+
+int w_Thread_getPriority(lua_State *L)
+{
+	LuaThread *t = luax_checkthread(L, 1);
+	const char *str = nullptr;
+	if (!Threadable::getConstant(t->getThreadPriority(), str))
+		return luaL_error(L, "Unknown thread priority.");
+
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_Thread_setAffinity(lua_State *L)
+{
+	LuaThread *t = luax_checkthread(L, 1);
+	std::vector<int> cores;
+	if (!lua_isnoneornil(L, 2))
+		cores = luax_checkcorelist(L, 2);
+
+	t->setThreadAffinity(cores);
+	return 0;
+}
+
+int w_Thread_getAffinity(lua_State *L)
+{
+	LuaThread *t = luax_checkthread(L, 1);
+	const std::vector<int> &cores = t->getThreadAffinity();
+
+	lua_createtable(L, (int) cores.size(), 0);
+	for (size_t i = 0; i < cores.size(); i++)
+	{
+		lua_pushinteger(L, cores[i] + 1);
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	return 1;
+}
+
 static const luaL_Reg w_Thread_functions[] =
 {
 	{ "start", w_Thread_start },
 	{ "wait", w_Thread_wait },
 	{ "getError", w_Thread_getError },
 	{ "isRunning", w_Thread_isRunning },
+	{ "setName", w_Thread_setName },
+	{ "getName", w_Thread_getName },
+	{ "setPriority", w_Thread_setPriority },
+	{ "getPriority", w_Thread_getPriority },
+	{ "setAffinity", w_Thread_setAffinity },
+	{ "getAffinity", w_Thread_getAffinity },
 	{ 0, 0 }
 };
 
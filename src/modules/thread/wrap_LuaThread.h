@@ -30,6 +30,7 @@ namespace thread
 {
 
 LuaThread *luax_checkthread(lua_State *L, int idx);
+std::vector<int> luax_checkcorelist(lua_State *L, int idx);
 extern "C" int luaopen_thread(lua_State *L);
 
 } // thread
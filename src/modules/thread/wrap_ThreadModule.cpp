@@ -22,7 +22,9 @@
 #include "wrap_ThreadModule.h"
 #include "wrap_LuaThread.h"
 #include "wrap_Channel.h"
+#include "wrap_JobPool.h"
 #include "ThreadModule.h"
+#include "common/cpu.h"
 
 #include "filesystem/File.h"
 #include "filesystem/FileData.h"
@@ -78,12 +80,55 @@ int w_newThread(lua_State *L)
 	LuaThread *t = instance()->newThread(name, data);
 	luax_pushtype(L, t);
 	t->release();
+
+	// Optional settings table: name, priority, and a list of CPU cores.
+	if (lua_istable(L, 2))
+	{
+		lua_getfield(L, 2, "name");
+		if (!lua_isnoneornil(L, -1))
+			t->setThreadName(luax_checkstring(L, -1));
+		lua_pop(L, 1);
+
+		lua_getfield(L, 2, "priority");
+		if (!lua_isnoneornil(L, -1))
+		{
+			const char *str = luaL_checkstring(L, -1);
+			Threadable::Priority priority;
+			if (!Threadable::getConstant(str, priority))
+				return luax_enumerror(L, "thread priority", Threadable::getConstants(priority), str);
+			t->setThreadPriority(priority);
+		}
+		lua_pop(L, 1);
+
+		lua_getfield(L, 2, "affinity");
+		if (!lua_isnoneornil(L, -1))
+			t->setThreadAffinity(luax_checkcorelist(L, -1));
+		lua_pop(L, 1);
+	}
+
 	return 1;
 }
 
 int w_newChannel(lua_State *L)
 {
-	Channel *c = instance()->newChannel();
+	Channel *c = nullptr;
+
+	if (lua_isnoneornil(L, 1))
+		c = instance()->newChannel();
+	else
+	{
+		lua_Integer capacity = luaL_checkinteger(L, 1);
+		if (capacity <= 0)
+			return luaL_error(L, "Channel capacity must be greater than 0.");
+
+		Channel::Mode mode = Channel::MODE_MPMC;
+		const char *str = lua_isnoneornil(L, 2) ? nullptr : luaL_checkstring(L, 2);
+		if (str && !Channel::getConstant(str, mode))
+			return luax_enumerror(L, "channel mode", Channel::getConstants(mode), str);
+
+		luax_catchexcept(L, [&]() { c = instance()->newChannel(mode, (size_t) capacity); });
+	}
+
 	luax_pushtype(L, c);
 	c->release();
 	return 1;
@@ -98,18 +143,106 @@ int w_getChannel(lua_State *L)
 	return 1;
 }
 
+int w_select(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	double timeout = luaL_optnumber(L, 2, -1.0);
+
+	std::vector<Channel *> channels;
+	int count = (int) luax_objlen(L, 1);
+
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, 1, i);
+		channels.push_back(luax_checkchannel(L, -1));
+		lua_pop(L, 1);
+	}
+
+	// The table keeps the Channels alive while waiting.
+	int index = -1;
+	luax_catchexcept(L, [&]() { index = Channel::select(channels, timeout); });
+
+	if (index < 0)
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+
+	luax_pushtype(L, channels[index]);
+	lua_pushinteger(L, index + 1);
+	return 2;
+}
+
+static int w__clearStatePool(lua_State *)
+{
+	LuaThread::clearStatePool();
+	return 0;
+}
+
+int w_setStatePoolSize(lua_State *L)
+{
+	int size = (int) luaL_checkinteger(L, 1);
+	if (size < 0)
+		return luaL_error(L, "State pool size must not be negative.");
+
+	bool prewarm = luax_optboolean(L, 2, false);
+
+	// Pooled states keep love.thread and love.filesystem loaded, so they have
+	// to be closed along with the Lua state that set up the pool rather than
+	// by the module's destructor.
+	lua_getfield(L, LUA_REGISTRYINDEX, "_love_thread_statepool");
+	if (lua_isnil(L, -1))
+	{
+		lua_newuserdata(L, 1);
+		lua_newtable(L);
+		lua_pushcfunction(L, w__clearStatePool);
+		lua_setfield(L, -2, "__gc");
+		lua_setmetatable(L, -2);
+		lua_setfield(L, LUA_REGISTRYINDEX, "_love_thread_statepool");
+	}
+	lua_pop(L, 1);
+
+	luax_catchexcept(L, [&]() { LuaThread::setStatePoolSize(size, prewarm); });
+	return 0;
+}
+
+int w_getStatePoolSize(lua_State *L)
+{
+	lua_pushinteger(L, LuaThread::getStatePoolSize());
+	return 1;
+}
+
+int w_newJobPool(lua_State *L)
+{
+	int workercount = (int) luaL_optinteger(L, 1, getParallelThreadCount());
+	if (workercount <= 0)
+		return luaL_error(L, "JobPool worker count must be greater than 0.");
+
+	JobPool *p = nullptr;
+	luax_catchexcept(L, [&]() { p = instance()->newJobPool(workercount); });
+	luax_pushtype(L, p);
+	p->release();
+	return 1;
+}
+
 // List of functions to wrap.
 static const luaL_Reg module_functions[] =
 {
 	{ "newThread", w_newThread },
 	{ "newChannel", w_newChannel },
 	{ "getChannel", w_getChannel },
+	{ "select", w_select },
+	{ "setStatePoolSize", w_setStatePoolSize },
+	{ "getStatePoolSize", w_getStatePoolSize },
+	{ "newJobPool", w_newJobPool },
 	{ 0, 0 }
 };
 
 static const lua_CFunction types[] = {
 	luaopen_thread,
 	luaopen_channel,
+	luaopen_job,
+	luaopen_jobpool,
 	0
 };
 
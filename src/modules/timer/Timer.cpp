@@ -24,11 +24,17 @@
 #include "common/delay.h"
 #include "Timer.h"
 
+// C++
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
 #if defined(LOVE_WINDOWS)
 #include <windows.h>
 #elif defined(LOVE_MACOSX) || defined(LOVE_IOS)
 #include <mach/mach_time.h>
 #include <sys/time.h>
+#include <time.h>
 #elif defined(LOVE_LINUX)
 #include <unistd.h>
 #include <time.h>
@@ -49,6 +55,9 @@ namespace love
 namespace timer
 {
 
+constexpr double Timer::FRAME_TIME_BUCKET_SIZE;
+constexpr double Timer::MAX_FRAME_TIME;
+
 Timer::Timer()
 	: currTime(0)
 	, prevFpsUpdate(0)
@@ -57,12 +66,36 @@ Timer::Timer()
 	, fpsUpdateFrequency(1)
 	, frames(0)
 	, dt(0)
+	, frameLimitTime(0)
+	, nextFrameTime(0)
+	, frameLimitStats()
+	, frameTimeSum(0)
+	, frameTimeSquaredSum(0)
+	, frameMaxError(0)
+	, frameMissCount(0)
+	, frameLimitCount(0)
+	, frameTimeHead(0)
+	, frameTimeCount(0)
+	, hitchThreshold(0.05)
+	, windowHitches(0)
+	, totalHitches(0)
+	, hasStepped(false)
 {
 	prevFpsUpdate = currTime = getTime();
+
+	frameTimeHistogram.resize(getFrameTimeBucket(MAX_FRAME_TIME) + 1, 0);
+	setFrameTimeWindow(1000);
 }
 
 double Timer::step()
 {
+	if (frameLimitTime > 0)
+	{
+		double now = getTime();
+		if (now < nextFrameTime)
+			sleepPrecise(nextFrameTime - now);
+	}
+
 	// Frames rendered
 	frames++;
 
@@ -75,6 +108,29 @@ double Timer::step()
 	// Convert to number of seconds.
 	dt = currTime - prevTime;
 
+	// The first step measures the time since the module was loaded, which
+	// isn't a frame.
+	if (hasStepped)
+		addFrameTime(dt);
+	hasStepped = true;
+
+	if (frameLimitTime > 0)
+	{
+		// Scheduling from the previous deadline instead of the current time
+		// keeps small oversleeps from adding up. If the frame was late by
+		// more than a whole frame, don't catch up with a burst of short ones.
+		nextFrameTime += frameLimitTime;
+		if (nextFrameTime < currTime)
+			nextFrameTime = currTime + frameLimitTime;
+
+		frameTimeSum += dt;
+		frameTimeSquaredSum += dt * dt;
+		frameMaxError = std::max(frameMaxError, fabs(dt - frameLimitTime));
+		if (dt > frameLimitTime + 0.001)
+			frameMissCount++;
+		frameLimitCount++;
+	}
+
 	double timeSinceLast = currTime - prevFpsUpdate;
 	// Update FPS?
 	if (timeSinceLast > fpsUpdateFrequency)
@@ -83,17 +139,262 @@ double Timer::step()
 		averageDelta = timeSinceLast/frames;
 		prevFpsUpdate = currTime;
 		frames = 0;
+
+		FrameLimitStats &stats = frameLimitStats;
+		stats = FrameLimitStats();
+		stats.targetTime = frameLimitTime;
+
+		if (frameLimitCount > 0)
+		{
+			stats.meanTime = frameTimeSum / frameLimitCount;
+			double variance = frameTimeSquaredSum / frameLimitCount - stats.meanTime * stats.meanTime;
+			stats.jitter = sqrt(std::max(variance, 0.0));
+			stats.maxError = frameMaxError;
+			stats.missedFrames = frameMissCount;
+		}
+
+		frameTimeSum = frameTimeSquaredSum = frameMaxError = 0;
+		frameMissCount = frameLimitCount = 0;
 	}
 
 	return dt;
 }
 
+void Timer::addFrameTime(double time)
+{
+	if (frameTimes.empty())
+		return;
+
+	if (frameTimeCount == frameTimes.size())
+	{
+		float oldest = frameTimes[frameTimeHead];
+		frameTimeHistogram[getFrameTimeBucket(oldest)]--;
+		if (oldest > hitchThreshold)
+			windowHitches--;
+
+		frameTimeHead = (frameTimeHead + 1) % frameTimes.size();
+		frameTimeCount--;
+	}
+
+	frameTimes[(frameTimeHead + frameTimeCount) % frameTimes.size()] = (float) time;
+	frameTimeCount++;
+
+	frameTimeHistogram[getFrameTimeBucket(time)]++;
+	if (time > hitchThreshold)
+	{
+		windowHitches++;
+		totalHitches++;
+	}
+}
+
+size_t Timer::getFrameTimeBucket(double time)
+{
+	time = std::min(std::max(time, 0.0), MAX_FRAME_TIME);
+	return (size_t) (time / FRAME_TIME_BUCKET_SIZE);
+}
+
+double Timer::getFrameTimePercentile(double p) const
+{
+	if (frameTimeCount == 0)
+		return 0.0;
+
+	// The number of frames at or below the percentile.
+	int target = std::max((int) ceil(p * frameTimeCount), 1);
+	int count = 0;
+
+	for (size_t i = 0; i < frameTimeHistogram.size(); i++)
+	{
+		count += frameTimeHistogram[i];
+		if (count >= target)
+			return std::min((i + 1) * FRAME_TIME_BUCKET_SIZE, MAX_FRAME_TIME);
+	}
+
+	return MAX_FRAME_TIME;
+}
+
+void Timer::setFrameTimeWindow(int frames)
+{
+	frameTimes.clear();
+	frameTimes.resize(std::max(frames, 0));
+	frameTimes.shrink_to_fit();
+
+	frameTimeHead = 0;
+	frameTimeCount = 0;
+	std::fill(frameTimeHistogram.begin(), frameTimeHistogram.end(), 0);
+	windowHitches = 0;
+}
+
+int Timer::getFrameTimeWindow() const
+{
+	return (int) frameTimes.size();
+}
+
+void Timer::setHitchThreshold(double seconds)
+{
+	hitchThreshold = seconds;
+
+	windowHitches = 0;
+	for (size_t i = 0; i < frameTimeCount; i++)
+	{
+		if (frameTimes[(frameTimeHead + i) % frameTimes.size()] > hitchThreshold)
+			windowHitches++;
+	}
+}
+
+double Timer::getHitchThreshold() const
+{
+	return hitchThreshold;
+}
+
+Timer::FrameTimeStats Timer::getFrameTimeStats() const
+{
+	FrameTimeStats stats;
+
+	stats.p50 = getFrameTimePercentile(0.50);
+	stats.p95 = getFrameTimePercentile(0.95);
+	stats.p99 = getFrameTimePercentile(0.99);
+
+	// The histogram caps long frames, the window has the exact times.
+	for (size_t i = 0; i < frameTimeCount; i++)
+		stats.max = std::max(stats.max, (double) frameTimes[(frameTimeHead + i) % frameTimes.size()]);
+
+	stats.frames = (int) frameTimeCount;
+	stats.hitches = windowHitches;
+	stats.totalHitches = totalHitches;
+
+	return stats;
+}
+
 void Timer::sleep(double seconds) const
 {
 	if (seconds > 0)
 		love::sleep((unsigned int)(seconds*1000));
 }
 
+void Timer::sleepPrecise(double seconds)
+{
+	if (seconds <= 0)
+		return;
+
+	// How long a short OS sleep actually takes, with its mean and variance
+	// tracked per thread. Sleeping stops once less time is left than the mean
+	// plus one standard deviation.
+	static thread_local double estimate = 0.005;
+	static thread_local double mean = 0.005;
+	static thread_local double m2 = 0.0;
+	static thread_local int count = 1;
+
+	const double sleeptime = 0.001;
+
+	double now = getTime();
+	double end = now + seconds;
+
+	while (end - now > estimate)
+	{
+		sleepOS(sleeptime);
+
+		double after = getTime();
+		double observed = after - now;
+		now = after;
+
+		// Welford's online algorithm.
+		count++;
+		double delta = observed - mean;
+		mean += delta / count;
+		m2 += delta * (observed - mean);
+		estimate = mean + sqrt(m2 / (count - 1));
+
+		// Halve the history now and then, so the estimate follows changes
+		// in the system's timer resolution.
+		if (count >= 1000)
+		{
+			m2 *= 0.5;
+			count /= 2;
+		}
+	}
+
+	// Spin for the rest, yielding so other threads on this core can run.
+	while (getTime() < end)
+		std::this_thread::yield();
+}
+
+#if defined(LOVE_WINDOWS)
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+// High resolution waitable timers (Windows 10 1803 and newer) aren't limited
+// by the system timer resolution, unlike Sleep.
+struct WaitableTimer
+{
+	HANDLE handle;
+
+	WaitableTimer()
+		: handle(CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS))
+	{}
+
+	~WaitableTimer()
+	{
+		if (handle != nullptr)
+			CloseHandle(handle);
+	}
+};
+
+#endif
+
+void Timer::sleepOS(double seconds)
+{
+#if defined(LOVE_WINDOWS)
+	static thread_local WaitableTimer timer;
+
+	if (timer.handle != nullptr)
+	{
+		// Negative times are relative, in 100 nanosecond units.
+		LARGE_INTEGER duetime;
+		duetime.QuadPart = -(LONGLONG) (seconds * 10000000.0);
+
+		if (SetWaitableTimerEx(timer.handle, &duetime, 0, nullptr, nullptr, nullptr, 0))
+		{
+			WaitForSingleObject(timer.handle, INFINITE);
+			return;
+		}
+	}
+
+	love::sleep((unsigned int) std::max(seconds * 1000.0, 1.0));
+#else
+	timespec t;
+	t.tv_sec = (time_t) seconds;
+	t.tv_nsec = (long) ((seconds - (double) t.tv_sec) * 1000000000.0);
+	nanosleep(&t, nullptr);
+#endif
+}
+
+void Timer::setFrameLimit(double fps)
+{
+	if (fps > 0)
+	{
+		frameLimitTime = 1.0 / fps;
+		nextFrameTime = currTime + frameLimitTime;
+	}
+	else
+		frameLimitTime = 0;
+
+	frameTimeSum = frameTimeSquaredSum = frameMaxError = 0;
+	frameMissCount = frameLimitCount = 0;
+	frameLimitStats = FrameLimitStats();
+}
+
+double Timer::getFrameLimit() const
+{
+	return frameLimitTime > 0 ? 1.0 / frameLimitTime : 0.0;
+}
+
+const Timer::FrameLimitStats &Timer::getFrameLimitStats() const
+{
+	return frameLimitStats;
+}
+
 double Timer::getDelta() const
 {
 	return dt;
@@ -23,6 +23,10 @@
 
 // LOVE
 #include "common/Module.h"
+#include "common/int.h"
+
+// C++
+#include <vector>
 
 namespace love
 {
@@ -40,6 +44,42 @@ public:
 	ModuleType getModuleType() const override { return M_TIMER; }
 	const char *getName() const override { return "love.timer"; }
 
+	/**
+	 * Statistics of the frame limiter, over the same window as the FPS.
+	 * Times are in seconds.
+	 **/
+	struct FrameLimitStats
+	{
+		double targetTime = 0.0;
+		double meanTime = 0.0;
+		// Standard deviation of the frame times.
+		double jitter = 0.0;
+		// Largest difference between a frame's time and the target.
+		double maxError = 0.0;
+		// Frames which took longer than the target plus a millisecond.
+		int missedFrames = 0;
+	};
+
+	/**
+	 * Percentiles of the frame times in the rolling window, in seconds.
+	 **/
+	struct FrameTimeStats
+	{
+		double p50 = 0.0;
+		double p95 = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+		// Frames in the window.
+		int frames = 0;
+		// Frames longer than the hitch threshold, in the window and in total.
+		int hitches = 0;
+		int64 totalHitches = 0;
+	};
+
+	// Frame times are put in buckets of this size, up to MAX_FRAME_TIME.
+	static constexpr double FRAME_TIME_BUCKET_SIZE = 0.0001;
+	static constexpr double MAX_FRAME_TIME = 0.25;
+
 	/**
 	 * Measures the time between this call and the previous call,
 	 * and updates internal values accordingly.
@@ -53,6 +93,38 @@ public:
 	 **/
 	void sleep(double seconds) const;
 
+	/**
+	 * Waits for the specified amount of time with sub-millisecond precision.
+	 * The OS is asked to sleep for as long as it can be trusted to wake up in
+	 * time (learned from previous sleeps), and the rest is spent spinning.
+	 **/
+	static void sleepPrecise(double seconds);
+
+	/**
+	 * Makes step() wait until at least 1/fps seconds have passed since the
+	 * start of the previous frame. 0 disables the limit.
+	 **/
+	void setFrameLimit(double fps);
+	double getFrameLimit() const;
+
+	const FrameLimitStats &getFrameLimitStats() const;
+
+	/**
+	 * Sets how many of the most recent frames the frame time stats cover.
+	 * Clears the current window.
+	 **/
+	void setFrameTimeWindow(int frames);
+	int getFrameTimeWindow() const;
+
+	void setHitchThreshold(double seconds);
+	double getHitchThreshold() const;
+
+	/**
+	 * Percentiles come from a histogram of the window, so they're accurate to
+	 * FRAME_TIME_BUCKET_SIZE. Frames longer than MAX_FRAME_TIME share a bucket.
+	 **/
+	FrameTimeStats getFrameTimeStats() const;
+
 	/**
 	 * Gets the time between the last two frames, assuming step is called
 	 * each frame.
@@ -99,6 +171,38 @@ private:
 	// The current timestep.
 	double dt;
 
+	// Target frame time of the frame limiter, or 0.
+	double frameLimitTime;
+	// When the current frame is allowed to end.
+	double nextFrameTime;
+
+	FrameLimitStats frameLimitStats;
+
+	// Sums of the frame times since the last stats update.
+	double frameTimeSum;
+	double frameTimeSquaredSum;
+	double frameMaxError;
+	int frameMissCount;
+	int frameLimitCount;
+
+	// Rolling window of frame times, and a histogram of the same frames.
+	std::vector<float> frameTimes;
+	size_t frameTimeHead;
+	size_t frameTimeCount;
+	std::vector<int> frameTimeHistogram;
+
+	double hitchThreshold;
+	int windowHitches;
+	int64 totalHitches;
+
+	bool hasStepped;
+
+	void addFrameTime(double time);
+	static size_t getFrameTimeBucket(double time);
+	double getFrameTimePercentile(double p) const;
+
+	static void sleepOS(double seconds);
+
 	// Returns the timer period on some platforms.
 	static double getTimerPeriod();
 
@@ -60,6 +60,116 @@ int w_sleep(lua_State *L)
 	return 0;
 }
 
+int w_sleepPrecise(lua_State *L)
+{
+	Timer::sleepPrecise(luaL_checknumber(L, 1));
+	return 0;
+}
+
+int w_setFrameLimit(lua_State *L)
+{
+	double fps = luaL_optnumber(L, 1, 0.0);
+	if (fps < 0)
+		return luaL_error(L, "The frame limit can't be negative.");
+
+	instance()->setFrameLimit(fps);
+	return 0;
+}
+
+int w_getFrameLimit(lua_State *L)
+{
+	lua_pushnumber(L, instance()->getFrameLimit());
+	return 1;
+}
+
+int w_getFrameLimitStats(lua_State *L)
+{
+	const Timer::FrameLimitStats &stats = instance()->getFrameLimitStats();
+
+	if (lua_istable(L, 1))
+		lua_pushvalue(L, 1);
+	else
+		lua_createtable(L, 0, 5);
+
+	lua_pushnumber(L, stats.targetTime);
+	lua_setfield(L, -2, "target");
+
+	lua_pushnumber(L, stats.meanTime);
+	lua_setfield(L, -2, "mean");
+
+	lua_pushnumber(L, stats.jitter);
+	lua_setfield(L, -2, "jitter");
+
+	lua_pushnumber(L, stats.maxError);
+	lua_setfield(L, -2, "maxerror");
+
+	lua_pushinteger(L, stats.missedFrames);
+	lua_setfield(L, -2, "missed");
+
+	return 1;
+}
+
+int w_setFrameTimeWindow(lua_State *L)
+{
+	int frames = (int) luaL_checkinteger(L, 1);
+	if (frames < 0)
+		return luaL_error(L, "The frame time window can't be negative.");
+
+	luax_catchexcept(L, [&]() { instance()->setFrameTimeWindow(frames); });
+	return 0;
+}
+
+int w_getFrameTimeWindow(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getFrameTimeWindow());
+	return 1;
+}
+
+int w_setHitchThreshold(lua_State *L)
+{
+	instance()->setHitchThreshold(luaL_checknumber(L, 1));
+	return 0;
+}
+
+int w_getHitchThreshold(lua_State *L)
+{
+	lua_pushnumber(L, instance()->getHitchThreshold());
+	return 1;
+}
+
+int w_getFrameTimeStats(lua_State *L)
+{
+	Timer::FrameTimeStats stats = instance()->getFrameTimeStats();
+
+	if (lua_istable(L, 1))
+		lua_pushvalue(L, 1);
+	else
+		lua_createtable(L, 0, 7);
+
+	lua_pushnumber(L, stats.p50);
+	lua_setfield(L, -2, "p50");
+
+	lua_pushnumber(L, stats.p95);
+	lua_setfield(L, -2, "p95");
+
+	lua_pushnumber(L, stats.p99);
+	lua_setfield(L, -2, "p99");
+
+	lua_pushnumber(L, stats.max);
+	lua_setfield(L, -2, "max");
+
+	lua_pushinteger(L, stats.frames);
+	lua_setfield(L, -2, "frames");
+
+	lua_pushinteger(L, stats.hitches);
+	lua_setfield(L, -2, "hitches");
+
+	lua_pushnumber(L, (lua_Number) stats.totalHitches);
+	lua_setfield(L, -2, "totalhitches");
+
+	return 1;
+}
+
 int w_getTime(lua_State *L)
 {
 	lua_pushnumber(L, instance()->getTime());
@@ -74,6 +184,15 @@ static const luaL_Reg functions[] =
 	{ "getFPS", w_getFPS },
 	{ "getAverageDelta", w_getAverageDelta },
 	{ "sleep", w_sleep },
+	{ "sleepPrecise", w_sleepPrecise },
+	{ "setFrameLimit", w_setFrameLimit },
+	{ "getFrameLimit", w_getFrameLimit },
+	{ "getFrameLimitStats", w_getFrameLimitStats },
+	{ "setFrameTimeWindow", w_setFrameTimeWindow },
+	{ "getFrameTimeWindow", w_getFrameTimeWindow },
+	{ "setHitchThreshold", w_setHitchThreshold },
+	{ "getHitchThreshold", w_getHitchThreshold },
+	{ "getFrameTimeStats", w_getFrameTimeStats },
 	{ "getTime", w_getTime },
 	{ 0, 0 }
 };
@@ -20,6 +20,9 @@
 
 #include "OggDemuxer.h"
 
+// STL
+#include <algorithm>
+
 namespace love
 {
 namespace video
@@ -32,7 +35,12 @@ OggDemuxer::OggDemuxer(love::filesystem::File *file)
 	, streamInited(false)
 	, videoSerial(0)
 	, eos(false)
+	, pageOffset(0)
+	, lastRecorded(-1)
 {
+	// Pages are read sequentially in small chunks while decoding.
+	file->setBuffer(love::filesystem::File::BUFFER_READAHEAD, 0);
+
 	ogg_sync_init(&sync);
 }
 
@@ -55,6 +63,32 @@ void OggDemuxer::readPage()
 		size_t read = file->read(syncBuffer, 8192);
 		ogg_sync_wrote(&sync, read);
 	}
+
+	// The sync state's unread bytes follow the page we just got.
+	int64 unread = sync.fill - sync.returned;
+	pageOffset = file->tell() - unread - (page.header_len + page.body_len);
+}
+
+void OggDemuxer::recordPage()
+{
+	int64 granulepos = ogg_page_granulepos(&page);
+	if (granulepos < 0)
+		return;
+
+	auto it = std::lower_bound(seekIndex.begin(), seekIndex.end(), granulepos,
+		[](const SeekPoint &point, int64 pos) { return point.granulepos < pos; });
+
+	if (it == seekIndex.end() || it->granulepos != granulepos)
+	{
+		SeekPoint point = {pageOffset, granulepos, ogg_page_continued(&page) != 0, false};
+		it = seekIndex.insert(it, point);
+	}
+
+	// Pages read in a row since the last resync directly follow each other.
+	if (lastRecorded >= 0 && it != seekIndex.begin() && (it - 1)->granulepos == lastRecorded)
+		it->linked = true;
+
+	lastRecorded = granulepos;
 }
 
 bool OggDemuxer::readPacket(ogg_packet &packet, bool mustSucceed)
@@ -73,6 +107,7 @@ bool OggDemuxer::readPacket(ogg_packet &packet, bool mustSucceed)
 			readPage();
 		} while (ogg_page_serialno(&page) != videoSerial);
 
+		recordPage();
 		ogg_stream_pagein(&stream, &page);
 	}
 
@@ -84,6 +119,7 @@ void OggDemuxer::resync()
 	ogg_sync_reset(&sync);
 	ogg_sync_pageseek(&sync, &page);
 	ogg_stream_reset(&stream);
+	lastRecorded = -1;
 }
 
 bool OggDemuxer::isEos() const
@@ -123,6 +159,9 @@ OggDemuxer::StreamType OggDemuxer::findStream()
 		ogg_sync_reset(&sync);
 	}
 
+	seekIndex.clear();
+	lastRecorded = -1;
+
 	streamInited = true;
 	while (true)
 	{
@@ -154,7 +193,45 @@ OggDemuxer::StreamType OggDemuxer::findStream()
 	return TYPE_UNKNOWN;
 }
 
-bool OggDemuxer::seek(ogg_packet &packet, double target, std::function<double(int64)> getTime)
+bool OggDemuxer::seekIndexed(ogg_packet &packet, double target, const std::function<double(int64)> &getTime, const std::function<int64(int64)> &getKeyframe)
+{
+	// The first page which ends at or after the target contains its frame.
+	auto end = std::lower_bound(seekIndex.begin(), seekIndex.end(), target,
+		[&](const SeekPoint &point, double t) { return getTime(point.granulepos) < t; });
+
+	if (end == seekIndex.end() || end == seekIndex.begin() || !end->linked)
+		return false;
+
+	// The keyframe of the last frame before that page is never later than the
+	// target frame's keyframe.
+	int64 keyframe = getKeyframe((end - 1)->granulepos);
+
+	// Find the last page which ends before the keyframe.
+	auto first = end - 1;
+	while (first->granulepos >= keyframe && first != seekIndex.begin())
+		--first;
+
+	// Decoding starts at the beginning of that page, which must directly
+	// follow a known page so the decoder knows which frame comes next.
+	if (first->granulepos >= keyframe || first == seekIndex.begin() || !first->linked)
+		return false;
+
+	const SeekPoint &prev = *(first - 1);
+
+	file->seek(first->offset);
+	resync();
+
+	// Nothing has been read from the new position yet, the caller only needs
+	// the granule position of the last frame before it. A packet continued
+	// from the previous page is dropped after a resync, so it counts as read.
+	// It can't be the keyframe, which comes after the end of this page.
+	packet.bytes = 0;
+	packet.granulepos = prev.granulepos + (first->continued ? 1 : 0);
+
+	return true;
+}
+
+bool OggDemuxer::seek(ogg_packet &packet, double target, std::function<double(int64)> getTime, std::function<int64(int64)> getKeyframe)
 {
 	static const double rewindThreshold = 0.01;
 
@@ -168,6 +245,9 @@ bool OggDemuxer::seek(ogg_packet &packet, double target, std::function<double(in
 		return true;
 	}
 
+	if (seekIndexed(packet, target, getTime, getKeyframe))
+		return true;
+
 	double low = 0;
 	double high = file->getSize();
 
@@ -23,6 +23,7 @@
 
 // STL
 #include <functional>
+#include <vector>
 
 // LOVE
 #include "filesystem/File.h"
@@ -54,9 +55,34 @@ public:
 	void resync();
 	bool isEos() const;
 	const std::string &getFilename() const;
-	bool seek(ogg_packet &packet, double target, std::function<double(int64)> getTime);
+
+	/**
+	 * Seeks so the next packet read is at or before target. getKeyframe maps a
+	 * granule position to that of the keyframe it depends on. Pages read
+	 * during playback are indexed, so seeks within already played parts of
+	 * the stream go straight to the right keyframe without bisecting.
+	 **/
+	bool seek(ogg_packet &packet, double target, std::function<double(int64)> getTime, std::function<int64(int64)> getKeyframe);
 
 private:
+
+	// A video page whose last completed packet has a known granule position.
+	struct SeekPoint
+	{
+		int64 offset;
+		int64 granulepos;
+
+		// Whether the page starts with the end of a packet from the last page.
+		bool continued;
+
+		// Whether the previous SeekPoint in the index is the video page which
+		// directly precedes this one in the file.
+		bool linked;
+	};
+
+	void recordPage();
+	bool seekIndexed(ogg_packet &packet, double target, const std::function<double(int64)> &getTime, const std::function<int64(int64)> &getKeyframe);
+
 	StrongRef<love::filesystem::File> file;
 
 	ogg_sync_state sync;
@@ -67,6 +93,16 @@ private:
 	int videoSerial;
 	bool eos;
 
+	// File offset of the current page.
+	int64 pageOffset;
+
+	// Seek index, sorted by granule position.
+	std::vector<SeekPoint> seekIndex;
+
+	// Granule position of the last page recorded since the last resync, or
+	// -1 if there hasn't been one.
+	int64 lastRecorded;
+
 	void readPage();
 	StreamType determineType();
 }; // OggDemuxer
@@ -20,9 +20,11 @@
 
 // STL
 #include <iostream>
+#include <algorithm>
 
 // LOVE
 #include "TheoraVideoStream.h"
+#include "timer/Timer.h"
 
 using love::filesystem::File;
 
@@ -37,9 +39,9 @@ TheoraVideoStream::TheoraVideoStream(love::filesystem::File *file)
 	: demuxer(file)
 	, headerParsed(false)
 	, decoder(nullptr)
-	, frameReady(false)
-	, lastFrame(0)
-	, nextFrame(0)
+	, frameDuration(1.0 / 30.0)
+	, lastUpdate(-1)
+	, lastFrame(-1)
 {
 	if (demuxer.findStream() != OggDemuxer::TYPE_THEORA)
 		throw love::Exception("Invalid video file, video is not theora");
@@ -47,7 +49,8 @@ TheoraVideoStream::TheoraVideoStream(love::filesystem::File *file)
 	th_info_init(&videoInfo);
 
 	frontBuffer = new Frame();
-	backBuffer = new Frame();
+	for (int i = 0; i < QUEUE_FRAMES; i++)
+		freeFrames.push_back(new Frame());
 
 	try
 	{
@@ -55,7 +58,8 @@ TheoraVideoStream::TheoraVideoStream(love::filesystem::File *file)
 	}
 	catch (love::Exception &ex)
 	{
-		delete backBuffer;
+		for (Frame *frame : freeFrames)
+			delete frame;
 		delete frontBuffer;
 		th_info_clear(&videoInfo);
 		throw ex;
@@ -72,7 +76,12 @@ TheoraVideoStream::~TheoraVideoStream()
 	th_info_clear(&videoInfo);
 
 	delete frontBuffer;
-	delete backBuffer;
+
+	for (const QueuedFrame &queued : readyFrames)
+		delete queued.frame;
+
+	for (Frame *frame : freeFrames)
+		delete frame;
 }
 
 int TheoraVideoStream::getWidth() const
@@ -162,14 +171,18 @@ void TheoraVideoStream::parseHeader()
 	decoder = th_decode_alloc(&videoInfo, setupInfo);
 	th_setup_free(setupInfo);
 
-	Frame *buffers[2] = {backBuffer, frontBuffer};
+	std::vector<Frame *> buffers = freeFrames;
+	buffers.push_back(frontBuffer);
 
 	yPlaneXOffset = cPlaneXOffset = videoInfo.pic_x;
 	yPlaneYOffset = cPlaneYOffset = videoInfo.pic_y;
 
 	scaleFormat(videoInfo.pixel_fmt, cPlaneXOffset, cPlaneYOffset);
 
-	for (int i = 0; i < 2; i++)
+	if (videoInfo.fps_numerator > 0 && videoInfo.fps_denominator > 0)
+		frameDuration = (double) videoInfo.fps_denominator / videoInfo.fps_numerator;
+
+	for (size_t i = 0; i < buffers.size(); i++)
 	{
 		buffers[i]->cw = buffers[i]->yw = videoInfo.pic_width;
 		buffers[i]->ch = buffers[i]->yh = videoInfo.pic_height;
@@ -191,87 +204,158 @@ void TheoraVideoStream::parseHeader()
 
 void TheoraVideoStream::seekDecoder(double target)
 {
+	int shift = videoInfo.keyframe_granule_shift;
+
 	bool success = demuxer.seek(packet, target, [this](int64 granulepos) {
 		return th_granule_time(decoder, granulepos);
+	}, [shift](int64 granulepos) {
+		return (granulepos >> shift) << shift;
 	});
 
 	if (!success)
 		return;
 
 	// Now update theora and our decoder on this new position of ours
-	lastFrame = nextFrame = -1;
+	lastFrame = -1;
 	th_decode_ctl(decoder, TH_DECCTL_SET_GRANPOS, &packet.granulepos, sizeof(packet.granulepos));
+
+	flushFrames();
+}
+
+void TheoraVideoStream::flushFrames()
+{
+	love::thread::Lock l(bufferMutex);
+
+	for (const QueuedFrame &queued : readyFrames)
+		freeFrames.push_back(queued.frame);
+
+	readyFrames.clear();
 }
 
-void TheoraVideoStream::threadedFillBackBuffer(double dt)
+void TheoraVideoStream::copyFrame(Frame *frame)
+{
+	th_ycbcr_buffer bufferinfo;
+	th_decode_ycbcr_out(decoder, bufferinfo);
+
+	for (int y = 0; y < frame->yh; ++y)
+	{
+		memcpy(frame->yplane+frame->yw*y,
+				bufferinfo[0].data+
+					bufferinfo[0].stride*(y+yPlaneYOffset)+yPlaneXOffset,
+				frame->yw);
+	}
+
+	for (int y = 0; y < frame->ch; ++y)
+	{
+		memcpy(frame->cbplane+frame->cw*y,
+				bufferinfo[1].data+
+					bufferinfo[1].stride*(y+cPlaneYOffset)+cPlaneXOffset,
+				frame->cw);
+	}
+
+	for (int y = 0; y < frame->ch; ++y)
+	{
+		memcpy(frame->crplane+frame->cw*y,
+				bufferinfo[2].data+
+					bufferinfo[2].stride*(y+cPlaneYOffset)+cPlaneXOffset,
+				frame->cw);
+	}
+}
+
+double TheoraVideoStream::threadedDecode()
 {
 	// Synchronize
+	double now = love::timer::Timer::getTime();
+	double dt = lastUpdate < 0 ? 0 : now - lastUpdate;
+	lastUpdate = now;
+
 	frameSync->update(dt);
 	double position = frameSync->getPosition();
 
+	bool seekBack = false;
+
+	{
+		love::thread::Lock l(bufferMutex);
+
+		// Frames the clock has already moved past will never be shown.
+		while (!readyFrames.empty() && readyFrames.front().end <= position)
+		{
+			freeFrames.push_back(readyFrames.front().frame);
+			readyFrames.pop_front();
+		}
+
+		// The frame being shown ends where the next one starts.
+		double next = readyFrames.empty() ? lastFrame : readyFrames.front().start;
+		seekBack = position < next - frameDuration;
+	}
+
 	// Seeking backwards
-	if (position < lastFrame)
+	if (seekBack)
 		seekDecoder(position);
 
-	// Until we are at the end of the stream, or we are displaying the right frame
 	unsigned int lagCounter = 0;
-	while (!demuxer.isEos() && position >= nextFrame)
+	Frame *frame = nullptr;
+
+	while (!demuxer.isEos())
 	{
-		// If we can't catch up, seek
-		if (lagCounter++ > 5)
+		if (frame == nullptr)
 		{
-			seekDecoder(position);
-			lagCounter = 0;
+			love::thread::Lock l(bufferMutex);
+			if (freeFrames.empty())
+				break;
+			frame = freeFrames.back();
+			freeFrames.pop_back();
 		}
 
-		th_ycbcr_buffer bufferinfo;
-		th_decode_ycbcr_out(decoder, bufferinfo);
-
 		ogg_int64_t granulePosition;
+		bool eos = false;
 		do
 		{
-			if (demuxer.readPacket(packet))
-				return;
-		} while (th_decode_packetin(decoder, &packet, &granulePosition) != 0);
-		lastFrame = nextFrame;
-		nextFrame = th_granule_time(decoder, granulePosition);
+			eos = demuxer.readPacket(packet);
+		} while (!eos && th_decode_packetin(decoder, &packet, &granulePosition) != 0);
 
-		// Don't swap whilst we're writing to the backbuffer
-		{
-			love::thread::Lock l(bufferMutex);
-			frameReady = false;
-		}
+		if (eos)
+			break;
 
-		for (int y = 0; y < backBuffer->yh; ++y)
-		{
-			memcpy(backBuffer->yplane+backBuffer->yw*y,
-					bufferinfo[0].data+
-						bufferinfo[0].stride*(y+yPlaneYOffset)+yPlaneXOffset,
-					backBuffer->yw);
-		}
+		double end = th_granule_time(decoder, granulePosition);
+		lastFrame = end;
 
-		for (int y = 0; y < backBuffer->ch; ++y)
+		// The frame is already over, skip it without copying it out.
+		if (end <= position)
 		{
-			memcpy(backBuffer->cbplane+backBuffer->cw*y,
-					bufferinfo[1].data+
-						bufferinfo[1].stride*(y+cPlaneYOffset)+cPlaneXOffset,
-					backBuffer->cw);
+			// If we can't catch up, seek
+			if (lagCounter++ > 5)
+			{
+				seekDecoder(position);
+				lagCounter = 0;
+			}
+			continue;
 		}
 
-		for (int y = 0; y < backBuffer->ch; ++y)
-		{
-			memcpy(backBuffer->crplane+backBuffer->cw*y,
-					bufferinfo[2].data+
-						bufferinfo[2].stride*(y+cPlaneYOffset)+cPlaneXOffset,
-					backBuffer->cw);
-		}
+		copyFrame(frame);
 
-		// Re-enable swapping
-		{
-			love::thread::Lock l(bufferMutex);
-			frameReady = true;
-		}
+		love::thread::Lock l(bufferMutex);
+		readyFrames.push_back({frame, end - frameDuration, end});
+		frame = nullptr;
+	}
+
+	if (frame != nullptr)
+	{
+		love::thread::Lock l(bufferMutex);
+		freeFrames.push_back(frame);
 	}
+
+	if (!isPlaying())
+		return frameDuration;
+
+	// The next slot frees up once the oldest queued frame has been shown.
+	love::thread::Lock l(bufferMutex);
+
+	double delay = frameDuration;
+	if (!readyFrames.empty())
+		delay = std::min(delay, readyFrames.front().end - position);
+
+	return std::max(delay, 0.001);
 }
 
 void TheoraVideoStream::fillBackBuffer()
@@ -281,17 +365,23 @@ void TheoraVideoStream::fillBackBuffer()
 
 bool TheoraVideoStream::swapBuffers()
 {
-	if (demuxer.isEos())
-		return false;
-
 	love::thread::Lock l(bufferMutex);
-	if (!frameReady)
+
+	double position = frameSync->getPosition();
+
+	// Drop frames the clock has already moved past.
+	while (readyFrames.size() > 1 && readyFrames[1].start <= position)
+	{
+		freeFrames.push_back(readyFrames.front().frame);
+		readyFrames.pop_front();
+	}
+
+	if (readyFrames.empty() || readyFrames.front().start > position)
 		return false;
-	frameReady = false;
 
-	Frame *temp = frontBuffer;
-	frontBuffer = backBuffer;
-	backBuffer = temp;
+	freeFrames.push_back(frontBuffer);
+	frontBuffer = readyFrames.front().frame;
+	readyFrames.pop_front();
 
 	return true;
 }
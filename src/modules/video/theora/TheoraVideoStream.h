@@ -29,6 +29,10 @@
 #include "thread/threads.h"
 #include "OggDemuxer.h"
 
+// C++
+#include <deque>
+#include <vector>
+
 // OGG/Theora
 #include <ogg/ogg.h>
 #include <theora/codec.h>
@@ -59,9 +63,27 @@ public:
 
 	bool isPlaying() const;
 
-	void threadedFillBackBuffer(double dt);
+	/**
+	 * Decodes frames ahead of the playback position until the queue is full.
+	 * Only one thread may call this at a time.
+	 * @return Seconds until the stream should be decoded again.
+	 **/
+	double threadedDecode();
+
+	// Number of frames decoded ahead of playback.
+	static const int QUEUE_FRAMES = 4;
 
 private:
+
+	struct QueuedFrame
+	{
+		Frame *frame;
+
+		// When the frame should start and stop being shown.
+		double start;
+		double end;
+	};
+
 	OggDemuxer demuxer;
 
 	bool headerParsed;
@@ -72,20 +94,29 @@ private:
 	th_dec_ctx *decoder;
 
 	Frame *frontBuffer;
-	Frame *backBuffer;
+
+	// Decoded frames waiting to be shown, oldest first, and frames that can
+	// be decoded into. Both are guarded by bufferMutex.
+	std::deque<QueuedFrame> readyFrames;
+	std::vector<Frame *> freeFrames;
+
+	double frameDuration;
+	double lastUpdate;
+
 	unsigned int yPlaneXOffset;
 	unsigned int cPlaneXOffset;
 	unsigned int yPlaneYOffset;
 	unsigned int cPlaneYOffset;
 
 	love::thread::MutexRef bufferMutex;
-	bool frameReady;
 
+	// End time of the newest decoded frame.
 	double lastFrame;
-	double nextFrame;
 
 	void parseHeader();
 	void seekDecoder(double target);
+	void copyFrame(Frame *frame);
+	void flushFrames();
 }; // TheoraVideoStream
 
 } // theora
@@ -20,11 +20,13 @@
 
 // STL
 #include <vector>
+#include <algorithm>
 
 // LOVE
 #include "Video.h"
-#include "common/delay.h"
 #include "timer/Timer.h"
+#include "common/profiling.h"
+#include "thread/WorkerPool.h"
 
 namespace love
 {
@@ -57,7 +59,8 @@ const char *Video::getName() const
 }
 
 Worker::Worker()
-	: stopping(false)
+	: pendingDecodes(0)
+	, stopping(false)
 {
 	threadName = "VideoWorker";
 }
@@ -70,7 +73,7 @@ Worker::~Worker()
 void Worker::addStream(TheoraVideoStream *stream)
 {
 	love::thread::Lock l(mutex);
-	streams.push_back(stream);
+	streams.push_back({stream, love::timer::Timer::getTime(), false});
 	cond->broadcast();
 }
 
@@ -85,40 +88,113 @@ void Worker::stop()
 	owner->wait();
 }
 
-void Worker::threadFunction()
+void Worker::finishDecode(TheoraVideoStream *stream, double delay)
 {
-	double lastFrame = love::timer::Timer::getTime();
-
-	while (true)
-	{
-		love::sleep(2);
+	love::thread::Lock l(mutex);
 
-		love::thread::Lock l(mutex);
+	double now = love::timer::Timer::getTime();
 
-		while (!stopping && streams.empty())
+	for (ScheduledStream &s : streams)
+	{
+		if (s.stream.get() == stream)
 		{
-			cond->wait(mutex);
-			lastFrame = love::timer::Timer::getTime();
+			s.deadline = now + delay;
+			s.decoding = false;
+			break;
 		}
+	}
+
+	pendingDecodes--;
+	cond->broadcast();
+}
 
-		if (stopping)
-			return;
+void Worker::threadFunction()
+{
+	std::vector<TheoraVideoStream *> due;
 
-		double curFrame = love::timer::Timer::getTime();
-		double dt = curFrame-lastFrame;
-		lastFrame = curFrame;
+	while (true)
+	{
+		due.clear();
 
-		for (auto it = streams.begin(); it != streams.end(); ++it)
 		{
-			TheoraVideoStream *stream = *it;
-			if (stream->getReferenceCount() == 1)
+			love::thread::Lock l(mutex);
+
+			while (true)
 			{
-				// We're the only ones left
-				streams.erase(it);
-				break;
+				if (stopping)
+				{
+					// Decode tasks reference this Worker, let them finish.
+					while (pendingDecodes > 0)
+						cond->wait(mutex);
+					return;
+				}
+
+				double now = love::timer::Timer::getTime();
+				double wakeup = -1.0;
+
+				for (auto it = streams.begin(); it != streams.end();)
+				{
+					if (it->decoding)
+					{
+						++it;
+						continue;
+					}
+
+					// We're the only ones left
+					if (it->stream->getReferenceCount() == 1)
+					{
+						it = streams.erase(it);
+						continue;
+					}
+
+					if (it->deadline <= now)
+					{
+						it->decoding = true;
+						due.push_back(it->stream.get());
+					}
+					else if (wakeup < 0 || it->deadline < wakeup)
+						wakeup = it->deadline;
+
+					++it;
+				}
+
+				if (!due.empty())
+					break;
+
+				// Sleep until the earliest deadline, or until something changes.
+				if (wakeup < 0)
+					cond->wait(mutex);
+				else
+					cond->wait(mutex, std::max((int) ((wakeup - now) * 1000), 1));
 			}
 
-			stream->threadedFillBackBuffer(dt);
+			pendingDecodes += (int) due.size();
+		}
+
+		// Tasks run inline when the pool has no workers, so submit them
+		// without holding the mutex.
+		// The streams can't be erased while they're decoding, so they stay
+		// alive until finishDecode.
+		for (TheoraVideoStream *stream : due)
+		{
+			love::thread::WorkerPool::getShared().submit([this, stream]()
+			{
+				LOVE_PROFILE_ZONE("VideoStream:decode");
+
+				double delay = 0.0;
+
+				try
+				{
+					delay = stream->threadedDecode();
+				}
+				catch (love::Exception &)
+				{
+					// Try again a frame later rather than spinning.
+					delay = 1.0 / 30.0;
+				}
+
+				finishDecode(stream, delay);
+			});
 		}
 	}
 }
@@ -70,11 +70,27 @@ public:
 
 private:
 
-	std::vector<StrongRef<TheoraVideoStream>> streams;
+	struct ScheduledStream
+	{
+		StrongRef<TheoraVideoStream> stream;
+
+		// When the stream next needs decoding.
+		double deadline;
+
+		// Whether a decode task for the stream is queued or running.
+		bool decoding;
+	};
+
+	void finishDecode(TheoraVideoStream *stream, double delay);
+
+	std::vector<ScheduledStream> streams;
 
 	love::thread::MutexRef mutex;
 	love::thread::ConditionalRef cond;
 
+	// Number of decode tasks submitted but not yet finished.
+	int pendingDecodes;
+
 	bool stopping;
 }; // Worker
 
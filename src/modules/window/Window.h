@@ -68,6 +68,7 @@ public:
 		SETTING_REFRESHRATE,
 		SETTING_X,
 		SETTING_Y,
+		SETTING_HEADLESS,
 		SETTING_MAX_ENUM
 	};
 
@@ -190,6 +191,29 @@ public:
 
 	virtual const void *getHandle() const = 0;
 
+	/**
+	 * Headless windows have an OpenGL context but nothing on screen, and
+	 * love.graphics draws to an offscreen framebuffer in place of the window's.
+	 **/
+	virtual bool isHeadless() const = 0;
+
+	// Gets OpenGL functions for the current context.
+	virtual void *getGLProcAddress(const char *name) const = 0;
+
+	/**
+	 * Creates an OpenGL context which shares its objects with the window's,
+	 * for use on another thread. Must be called on the main thread. Returns
+	 * null if that isn't possible, for example for headless windows.
+	 **/
+	virtual void *createSharedGLContext() = 0;
+
+	// Makes a shared context current on the calling thread. Null releases the
+	// thread's current context.
+	virtual bool makeSharedGLContextCurrent(void *context) = 0;
+
+	// The context mustn't be current on any thread.
+	virtual void deleteSharedGLContext(void *context) = 0;
+
 	virtual bool showMessageBox(const std::string &title, const std::string &message, MessageBoxType type, bool attachtowindow) = 0;
 	virtual int showMessageBox(const MessageBoxData &data) = 0;
 
@@ -238,6 +262,7 @@ struct WindowSettings
 	bool useposition = false;
 	int x = 0;
 	int y = 0;
+	bool headless = false;
 };
 
 } // window
@@ -0,0 +1,342 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "HeadlessContext.h"
+
+// SDL
+#include <SDL_error.h>
+#include <SDL_loadso.h>
+
+// C
+#include <cstring>
+#include <cstdio>
+
+namespace love
+{
+namespace window
+{
+namespace sdl
+{
+
+// We don't depend on the EGL headers, so the values we use are defined here.
+enum
+{
+	EGL_ALPHA_SIZE = 0x3021,
+	EGL_BLUE_SIZE = 0x3022,
+	EGL_GREEN_SIZE = 0x3023,
+	EGL_RED_SIZE = 0x3024,
+	EGL_SURFACE_TYPE = 0x3033,
+	EGL_NONE = 0x3038,
+	EGL_RENDERABLE_TYPE = 0x3040,
+	EGL_EXTENSIONS = 0x3055,
+	EGL_HEIGHT = 0x3056,
+	EGL_WIDTH = 0x3057,
+	EGL_PBUFFER_BIT = 0x0001,
+	EGL_OPENGL_ES2_BIT = 0x0004,
+	EGL_OPENGL_BIT = 0x0008,
+	EGL_OPENGL_ES3_BIT_KHR = 0x0040,
+	EGL_OPENGL_ES_API = 0x30A0,
+	EGL_OPENGL_API = 0x30A2,
+	EGL_CONTEXT_MAJOR_VERSION_KHR = 0x3098,
+	EGL_CONTEXT_MINOR_VERSION_KHR = 0x30FB,
+	EGL_CONTEXT_FLAGS_KHR = 0x30FC,
+	EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR = 0x30FD,
+	EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR = 0x0001,
+	EGL_CONTEXT_OPENGL_DEBUG_BIT_KHR = 0x0001,
+	EGL_PLATFORM_SURFACELESS_MESA = 0x31DD,
+};
+
+HeadlessContext::HeadlessContext()
+	: library(nullptr)
+	, display(nullptr)
+	, context(nullptr)
+	, surface(nullptr)
+	, egl()
+{
+}
+
+HeadlessContext::~HeadlessContext()
+{
+	destroy();
+
+	if (display != nullptr)
+		egl.Terminate(display);
+
+	if (library != nullptr)
+		SDL_UnloadObject(library);
+}
+
+bool HeadlessContext::loadLibrary(std::string &error)
+{
+	if (library != nullptr)
+		return true;
+
+#if defined(_WIN32)
+	// ANGLE.
+	const char *names[] = {"libEGL.dll"};
+#elif defined(__APPLE__)
+	const char *names[] = {"libEGL.dylib"};
+#else
+	const char *names[] = {"libEGL.so.1", "libEGL.so"};
+#endif
+
+	for (const char *name : names)
+	{
+		library = SDL_LoadObject(name);
+		if (library != nullptr)
+			break;
+	}
+
+	if (library == nullptr)
+	{
+		error = "Could not load EGL: " + std::string(SDL_GetError());
+		return false;
+	}
+
+#define LOAD_EGL(name) \
+	if ((*(void **) &egl.name = SDL_LoadFunction(library, "egl" #name)) == nullptr) \
+	{ \
+		error = "EGL is missing egl" #name; \
+		SDL_UnloadObject(library); \
+		library = nullptr; \
+		return false; \
+	}
+
+	LOAD_EGL(GetProcAddress)
+	LOAD_EGL(GetDisplay)
+	LOAD_EGL(Initialize)
+	LOAD_EGL(Terminate)
+	LOAD_EGL(QueryString)
+	LOAD_EGL(BindAPI)
+	LOAD_EGL(ChooseConfig)
+	LOAD_EGL(CreateContext)
+	LOAD_EGL(DestroyContext)
+	LOAD_EGL(CreatePbufferSurface)
+	LOAD_EGL(DestroySurface)
+	LOAD_EGL(MakeCurrent)
+	LOAD_EGL(GetError)
+
+#undef LOAD_EGL
+
+	// Only exported through eglGetProcAddress, and only with the extension.
+	*(void **) &egl.GetPlatformDisplayEXT = egl.GetProcAddress("eglGetPlatformDisplayEXT");
+
+	return true;
+}
+
+bool HeadlessContext::hasExtension(const char *extensions, const char *name) const
+{
+	if (extensions == nullptr)
+		return false;
+
+	size_t length = strlen(name);
+	for (const char *s = strstr(extensions, name); s != nullptr; s = strstr(s + length, name))
+	{
+		if ((s == extensions || s[-1] == ' ') && (s[length] == ' ' || s[length] == '\0'))
+			return true;
+	}
+
+	return false;
+}
+
+bool HeadlessContext::initializeDisplay(std::string &error)
+{
+	if (display != nullptr)
+		return true;
+
+	// Client extensions are queried without a display.
+	const char *clientextensions = egl.QueryString(nullptr, EGL_EXTENSIONS);
+
+	if (egl.GetPlatformDisplayEXT != nullptr && hasExtension(clientextensions, "EGL_MESA_platform_surfaceless"))
+	{
+		display = egl.GetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, nullptr, nullptr);
+		if (display != nullptr && !egl.Initialize(display, nullptr, nullptr))
+			display = nullptr;
+	}
+
+	if (display == nullptr)
+	{
+		display = egl.GetDisplay(nullptr);
+		if (display != nullptr && !egl.Initialize(display, nullptr, nullptr))
+			display = nullptr;
+	}
+
+	if (display == nullptr)
+	{
+		char message[64];
+		snprintf(message, sizeof(message), "Could not initialize an EGL display (0x%x)", (unsigned int) egl.GetError());
+		error = message;
+		return false;
+	}
+
+	return true;
+}
+
+bool HeadlessContext::create(int versionMajor, int versionMinor, bool gles, bool debug, std::string &error)
+{
+	destroy();
+
+	if (!loadLibrary(error) || !initializeDisplay(error))
+		return false;
+
+	if (!egl.BindAPI(gles ? EGL_OPENGL_ES_API : EGL_OPENGL_API))
+	{
+		error = gles ? "EGL does not support OpenGL ES" : "EGL does not support OpenGL";
+		return false;
+	}
+
+	Int renderable = EGL_OPENGL_BIT;
+	if (gles)
+		renderable = versionMajor >= 3 ? EGL_OPENGL_ES3_BIT_KHR : EGL_OPENGL_ES2_BIT;
+
+	// love.graphics renders to its own framebuffer, so the config only has to
+	// support the API. A pbuffer-capable one is preferred in case it's needed.
+	Config config = nullptr;
+	Int count = 0;
+
+	for (Int surfacetype : {(Int) EGL_PBUFFER_BIT, (Int) 0})
+	{
+		const Int configattribs[] =
+		{
+			EGL_RED_SIZE, 8,
+			EGL_GREEN_SIZE, 8,
+			EGL_BLUE_SIZE, 8,
+			EGL_ALPHA_SIZE, 8,
+			EGL_SURFACE_TYPE, surfacetype,
+			EGL_RENDERABLE_TYPE, renderable,
+			EGL_NONE
+		};
+
+		if (egl.ChooseConfig(display, configattribs, &config, 1, &count) && count > 0)
+			break;
+	}
+
+	if (count == 0)
+	{
+		error = "No EGL config supports the requested OpenGL version";
+		return false;
+	}
+
+	const char *extensions = egl.QueryString(display, EGL_EXTENSIONS);
+	bool createcontext = hasExtension(extensions, "EGL_KHR_create_context");
+
+	Int contextattribs[16];
+	int i = 0;
+
+	if (createcontext)
+	{
+		contextattribs[i++] = EGL_CONTEXT_MAJOR_VERSION_KHR;
+		contextattribs[i++] = versionMajor;
+		contextattribs[i++] = EGL_CONTEXT_MINOR_VERSION_KHR;
+		contextattribs[i++] = versionMinor;
+
+		if (!gles && versionMajor * 10 + versionMinor >= 32)
+		{
+			contextattribs[i++] = EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR;
+			contextattribs[i++] = EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR;
+		}
+
+		if (debug)
+		{
+			contextattribs[i++] = EGL_CONTEXT_FLAGS_KHR;
+			contextattribs[i++] = EGL_CONTEXT_OPENGL_DEBUG_BIT_KHR;
+		}
+	}
+	else if (gles)
+	{
+		// EGL_CONTEXT_CLIENT_VERSION has the same value.
+		contextattribs[i++] = EGL_CONTEXT_MAJOR_VERSION_KHR;
+		contextattribs[i++] = versionMajor;
+	}
+
+	contextattribs[i++] = EGL_NONE;
+
+	context = egl.CreateContext(display, config, nullptr, contextattribs);
+	if (context == nullptr)
+	{
+		char message[64];
+		snprintf(message, sizeof(message), "Could not create an EGL context (0x%x)", (unsigned int) egl.GetError());
+		error = message;
+		return false;
+	}
+
+	if (!hasExtension(extensions, "EGL_KHR_surfaceless_context"))
+	{
+		const Int pbufferattribs[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+		surface = egl.CreatePbufferSurface(display, config, pbufferattribs);
+
+		if (surface == nullptr)
+		{
+			error = "EGL supports neither surfaceless contexts nor pbuffers";
+			destroy();
+			return false;
+		}
+	}
+
+	if (!egl.MakeCurrent(display, surface, surface, context))
+	{
+		error = "Could not make the EGL context current";
+		destroy();
+		return false;
+	}
+
+	return true;
+}
+
+void HeadlessContext::destroy()
+{
+	if (display == nullptr)
+		return;
+
+	if (context != nullptr || surface != nullptr)
+		egl.MakeCurrent(display, nullptr, nullptr, nullptr);
+
+	if (context != nullptr)
+		egl.DestroyContext(display, context);
+
+	if (surface != nullptr)
+		egl.DestroySurface(display, surface);
+
+	context = nullptr;
+	surface = nullptr;
+}
+
+bool HeadlessContext::isCreated() const
+{
+	return context != nullptr;
+}
+
+void *HeadlessContext::getProcAddress(const char *name) const
+{
+	if (library == nullptr)
+		return nullptr;
+
+	// Current implementations return core functions as well (EGL 1.5 and
+	// EGL_KHR_get_all_proc_addresses). Older ones may export them instead.
+	void *proc = egl.GetProcAddress(name);
+	if (proc == nullptr)
+		proc = SDL_LoadFunction(library, name);
+
+	return proc;
+}
+
+} // sdl
+} // window
+} // love
@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2006-2018 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_WINDOW_SDL_HEADLESS_CONTEXT_H
+#define LOVE_WINDOW_SDL_HEADLESS_CONTEXT_H
+
+// C
+#include <stdint.h>
+
+// C++
+#include <string>
+
+#ifdef _WIN32
+#	define LOVE_EGL_APIENTRY __stdcall
+#else
+#	define LOVE_EGL_APIENTRY
+#endif
+
+namespace love
+{
+namespace window
+{
+namespace sdl
+{
+
+/**
+ * An OpenGL context without a window, for rendering on machines without a
+ * display server. EGL is loaded at runtime, so it isn't a build dependency.
+ * Mesa's surfaceless platform is used when it's available, which also works
+ * with its software renderers. Otherwise the context is made current without
+ * a surface (EGL_KHR_surfaceless_context), or with a tiny pbuffer.
+ *
+ * Nothing is drawn to the surface: love.graphics renders to an offscreen
+ * framebuffer instead.
+ **/
+class HeadlessContext
+{
+public:
+
+	HeadlessContext();
+	~HeadlessContext();
+
+	// Creates the context and makes it current.
+	bool create(int versionMajor, int versionMinor, bool gles, bool debug, std::string &error);
+	void destroy();
+
+	bool isCreated() const;
+
+	void *getProcAddress(const char *name) const;
+
+private:
+
+	typedef void *Display;
+	typedef void *Config;
+	typedef void *Context;
+	typedef void *Surface;
+	typedef int32_t Int;
+
+	bool loadLibrary(std::string &error);
+	bool initializeDisplay(std::string &error);
+	bool hasExtension(const char *extensions, const char *name) const;
+
+	void *library;
+
+	Display display;
+	Context context;
+	Surface surface;
+
+	struct
+	{
+		void *(LOVE_EGL_APIENTRY *GetProcAddress)(const char *name);
+		Display (LOVE_EGL_APIENTRY *GetDisplay)(void *nativeDisplay);
+		Display (LOVE_EGL_APIENTRY *GetPlatformDisplayEXT)(unsigned int platform, void *nativeDisplay, const Int *attribs);
+		unsigned int (LOVE_EGL_APIENTRY *Initialize)(Display display, Int *major, Int *minor);
+		unsigned int (LOVE_EGL_APIENTRY *Terminate)(Display display);
+		const char *(LOVE_EGL_APIENTRY *QueryString)(Display display, Int name);
+		unsigned int (LOVE_EGL_APIENTRY *BindAPI)(unsigned int api);
+		unsigned int (LOVE_EGL_APIENTRY *ChooseConfig)(Display display, const Int *attribs, Config *configs, Int size, Int *count);
+		Context (LOVE_EGL_APIENTRY *CreateContext)(Display display, Config config, Context share, const Int *attribs);
+		unsigned int (LOVE_EGL_APIENTRY *DestroyContext)(Display display, Context context);
+		Surface (LOVE_EGL_APIENTRY *CreatePbufferSurface)(Display display, Config config, const Int *attribs);
+		unsigned int (LOVE_EGL_APIENTRY *DestroySurface)(Display display, Surface surface);
+		unsigned int (LOVE_EGL_APIENTRY *MakeCurrent)(Display display, Surface draw, Surface read, Context context);
+		Int (LOVE_EGL_APIENTRY *GetError)();
+	} egl;
+
+}; // HeadlessContext
+
+} // sdl
+} // window
+} // love
+
+#endif // LOVE_WINDOW_SDL_HEADLESS_CONTEXT_H
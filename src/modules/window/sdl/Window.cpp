@@ -60,12 +60,21 @@ Window::Window()
 	, mouseGrabbed(false)
 	, window(nullptr)
 	, context(nullptr)
+	, headless(false)
 	, displayedWindowError(false)
 	, hasSDL203orEarlier(false)
 	, contextAttribs()
 {
 	if (SDL_InitSubSystem(SDL_INIT_VIDEO) < 0)
-		throw love::Exception("Could not initialize SDL video subsystem (%s)", SDL_GetError());
+	{
+		std::string error = SDL_GetError();
+
+		// Without a display server, fall back to SDL's dummy driver so headless
+		// windows still work. Regular windows will fail to open.
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+		if (SDL_InitSubSystem(SDL_INIT_VIDEO) < 0)
+			throw love::Exception("Could not initialize SDL video subsystem (%s)", error.c_str());
+	}
 
 	// Make sure the screensaver doesn't activate by default.
 	setDisplaySleepEnabled(false);
@@ -156,7 +165,7 @@ bool Window::checkGLVersion(const ContextAttribs &attribs, std::string &outversi
 
 	// We don't have OpenGL headers or an automatic OpenGL function loader in
 	// this module, so we have to get the glGetString function pointer ourselves.
-	glGetStringPtr glGetStringFunc = (glGetStringPtr) SDL_GL_GetProcAddress("glGetString");
+	glGetStringPtr glGetStringFunc = (glGetStringPtr) getGLProcAddress("glGetString");
 	if (!glGetStringFunc)
 		return false;
 
@@ -495,6 +504,9 @@ bool Window::setWindow(int width, int height, WindowSettings *settings)
 
 	close();
 
+	if (f.headless)
+		return setHeadlessWindow(width, height, f);
+
 	if (!createWindowAndContext(x, y, width, height, sdlflags, f.msaa, f.stencil, f.depth))
 		return false;
 
@@ -535,6 +547,57 @@ bool Window::setWindow(int width, int height, WindowSettings *settings)
 	return true;
 }
 
+bool Window::setHeadlessWindow(int width, int height, const WindowSettings &f)
+{
+	std::string error;
+	std::string glversion;
+
+	for (const ContextAttribs &attribs : getContextAttribsList())
+	{
+		if (!headlessContext.create(attribs.versionMajor, attribs.versionMinor, attribs.gles, attribs.debug, error))
+			continue;
+
+		if (checkGLVersion(attribs, glversion))
+		{
+			contextAttribs = attribs;
+			break;
+		}
+
+		headlessContext.destroy();
+	}
+
+	if (!headlessContext.isCreated())
+	{
+		std::cerr << "Unable to create headless OpenGL context" << std::endl;
+		if (!glversion.empty())
+			std::cerr << "Detected OpenGL version: " << glversion << std::endl;
+		else if (!error.empty())
+			std::cerr << error << std::endl;
+		return false;
+	}
+
+	headless = true;
+	open = true;
+
+	windowWidth = pixelWidth = width;
+	windowHeight = pixelHeight = height;
+
+	// Most settings don't apply without a window. MSAA isn't supported by
+	// the offscreen framebuffer.
+	settings = WindowSettings();
+	settings.headless = true;
+	settings.vsync = 0;
+	settings.stencil = f.stencil;
+	settings.depth = f.depth;
+	settings.minwidth = f.minwidth;
+	settings.minheight = f.minheight;
+
+	if (graphics.get())
+		graphics->setMode(width, height, width, height, f.stencil);
+
+	return true;
+}
+
 bool Window::onSizeChanged(int width, int height)
 {
 	if (!window)
@@ -660,6 +723,9 @@ void Window::close(bool allowExceptions)
 		context = nullptr;
 	}
 
+	headlessContext.destroy();
+	headless = false;
+
 	if (window)
 	{
 		SDL_DestroyWindow(window);
@@ -944,7 +1010,10 @@ bool Window::isMinimized() const
 
 void Window::swapBuffers()
 {
-	SDL_GL_SwapWindow(window);
+	// Headless contexts draw to an offscreen framebuffer, so there's nothing
+	// to present.
+	if (window)
+		SDL_GL_SwapWindow(window);
 }
 
 bool Window::hasFocus() const
@@ -1087,6 +1156,54 @@ const void *Window::getHandle() const
 	return window;
 }
 
+bool Window::isHeadless() const
+{
+	return headless;
+}
+
+void *Window::getGLProcAddress(const char *name) const
+{
+	if (headlessContext.isCreated())
+		return headlessContext.getProcAddress(name);
+
+	return SDL_GL_GetProcAddress(name);
+}
+
+void *Window::createSharedGLContext()
+{
+	if (headless || window == nullptr || context == nullptr)
+		return nullptr;
+
+	// SDL shares with whichever context is current, and makes the new one
+	// current on this thread.
+	SDL_GL_MakeCurrent(window, context);
+	SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+
+	SDL_GLContext shared = SDL_GL_CreateContext(window);
+
+	SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 0);
+	SDL_GL_MakeCurrent(window, context);
+
+	return shared;
+}
+
+bool Window::makeSharedGLContextCurrent(void *sharedcontext)
+{
+	if (sharedcontext == nullptr)
+		return SDL_GL_MakeCurrent(nullptr, nullptr) == 0;
+
+	if (window == nullptr)
+		return false;
+
+	return SDL_GL_MakeCurrent(window, (SDL_GLContext) sharedcontext) == 0;
+}
+
+void Window::deleteSharedGLContext(void *sharedcontext)
+{
+	if (sharedcontext != nullptr)
+		SDL_GL_DeleteContext((SDL_GLContext) sharedcontext);
+}
+
 SDL_MessageBoxFlags Window::convertMessageBoxType(MessageBoxType type) const
 {
 	switch (type)
@@ -23,6 +23,7 @@
 
 // LOVE
 #include "window/Window.h"
+#include "HeadlessContext.h"
 
 // SDL
 #include <SDL.h>
@@ -112,6 +113,13 @@ public:
 
 	const void *getHandle() const override;
 
+	bool isHeadless() const override;
+	void *getGLProcAddress(const char *name) const override;
+
+	void *createSharedGLContext() override;
+	bool makeSharedGLContextCurrent(void *context) override;
+	void deleteSharedGLContext(void *context) override;
+
 	bool showMessageBox(const std::string &title, const std::string &message, MessageBoxType type, bool attachtowindow) override;
 	int showMessageBox(const MessageBoxData &data) override;
 
@@ -136,6 +144,7 @@ private:
 	bool checkGLVersion(const ContextAttribs &attribs, std::string &outversion);
 	std::vector<ContextAttribs> getContextAttribsList() const;
 	bool createWindowAndContext(int x, int y, int w, int h, Uint32 windowflags, int msaa, bool stencil, int depth);
+	bool setHeadlessWindow(int width, int height, const WindowSettings &settings);
 
 	// Update the saved window settings based on the window's actual state.
 	void updateSettings(const WindowSettings &newsettings, bool updateGraphicsViewport);
@@ -158,6 +167,9 @@ private:
 	SDL_Window *window;
 	SDL_GLContext context;
 
+	HeadlessContext headlessContext;
+	bool headless;
+
 	bool displayedWindowError;
 	bool hasSDL203orEarlier;
 	ContextAttribs contextAttribs;
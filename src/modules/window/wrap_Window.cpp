@@ -76,6 +76,7 @@ static int readWindowSettings(lua_State *L, int idx, WindowSettings &settings)
 	settings.centered = luax_boolflag(L, idx, settingName(Window::SETTING_CENTERED), settings.centered);
 	settings.display = luax_intflag(L, idx, settingName(Window::SETTING_DISPLAY), settings.display+1) - 1;
 	settings.highdpi = luax_boolflag(L, idx, settingName(Window::SETTING_HIGHDPI), settings.highdpi);
+	settings.headless = luax_boolflag(L, idx, settingName(Window::SETTING_HEADLESS), settings.headless);
 
 	lua_getfield(L, idx, settingName(Window::SETTING_VSYNC));
 	if (lua_isnumber(L, -1))
@@ -212,6 +213,9 @@ int w_getMode(lua_State *L)
 	lua_pushinteger(L, settings.y);
 	lua_setfield(L, -2, settingName(Window::SETTING_Y));
 
+	luax_pushboolean(L, settings.headless);
+	lua_setfield(L, -2, settingName(Window::SETTING_HEADLESS));
+
 	return 3;
 }
 
@@ -398,6 +398,7 @@ function love.init()
 			resizable = false,
 			centered = true,
 			highdpi = false,
+			headless = false,
 		},
 		modules = {
 			data = true,
@@ -412,6 +413,7 @@ function love.init()
 			audio = true,
 			math = true,
 			physics = true,
+			profiler = true,
 			sound = true,
 			system = true,
 			font = true,
@@ -422,6 +424,10 @@ function love.init()
 		audio = {
 			mixwithsystem = true, -- Only relevant for Android / iOS.
 		},
+		graphics = {
+			streambuffersizes = nil, -- Minimum sizes in bytes: {positions=, attributes=, indices=}.
+			streambufferautosizing = true,
+		},
 		console = false, -- Only relevant for windows.
 		identity = false,
 		appendidentity = false,
@@ -465,6 +471,13 @@ function love.init()
 		love._setGammaCorrect(c.gammacorrect)
 	end
 
+	-- Modules marked as "deferred" in love.conf are loaded the first time
+	-- love.<module> is accessed, so the devices and threads they create only
+	-- exist if they're used. The modules the main loop and window setup rely
+	-- on are always loaded right away.
+	local eagermodules = {event = true, timer = true, window = true, graphics = true}
+	local deferredmodules = {}
+
 	-- Gets desired modules.
 	for k,v in ipairs{
 		"data",
@@ -485,12 +498,33 @@ function love.init()
 		"graphics",
 		"math",
 		"physics",
+		"profiler",
 	} do
-		if c.modules[v] then
+		if c.modules[v] == "deferred" and not eagermodules[v] then
+			deferredmodules[v] = true
+		elseif c.modules[v] then
 			require("love." .. v)
 		end
 	end
 
+	-- Settings for deferred modules are applied when they're loaded.
+	local deferredsetup = {}
+
+	if next(deferredmodules) ~= nil then
+		setmetatable(love, {
+			__index = function(t, name)
+				if deferredmodules[name] then
+					deferredmodules[name] = nil
+					require("love." .. name)
+					if deferredsetup[name] then
+						deferredsetup[name]()
+					end
+					return rawget(t, name)
+				end
+			end,
+		})
+	end
+
 	if love.event then
 		love.createhandlers()
 	end
@@ -515,6 +549,15 @@ function love.init()
 		error(conferr)
 	end
 
+	-- The stream buffers are created along with the window, so these have to
+	-- be set before it.
+	if love.graphics and c.graphics then
+		if c.graphics.streambuffersizes then
+			love.graphics.setStreamBufferSizes(c.graphics.streambuffersizes)
+		end
+		love.graphics.setStreamBufferAutoSizing(c.graphics.streambufferautosizing ~= false)
+	end
+
 	-- Setup window here.
 	if c.window and c.modules.window then
 		assert(love.window.setMode(c.window.width, c.window.height,
@@ -534,6 +577,7 @@ function love.init()
 			highdpi = c.window.highdpi,
 			x = c.window.x,
 			y = c.window.y,
+			headless = c.window.headless,
 		}), "Could not set window mode")
 		love.window.setTitle(c.window.title or c.title)
 		if c.window.icon then
@@ -542,10 +586,16 @@ function love.init()
 		end
 	end
 
-	if love.audio then
+	local function setupaudio()
 		love.audio.setMixWithSystem(c.audio.mixwithsystem)
 	end
 
+	if deferredmodules.audio then
+		deferredsetup.audio = setupaudio
+	elseif love.audio then
+		setupaudio()
+	end
+
 	-- Our first timestep, because window creation can take some time
 	if love.timer then
 		love.timer.step()
@@ -641,8 +691,8 @@ function love.errhand(msg)
 		end
 	end
 
-	-- Reset state.
-	if love.mouse then
+	-- Reset state. Deferred modules which haven't been loaded have no state.
+	if rawget(love, "mouse") then
 		love.mouse.setVisible(true)
 		love.mouse.setGrabbed(false)
 		love.mouse.setRelativeMode(false)
@@ -650,13 +700,13 @@ function love.errhand(msg)
 			love.mouse.setCursor()
 		end
 	end
-	if love.joystick then
+	if rawget(love, "joystick") then
 		-- Stop all joystick vibrations.
 		for i,v in ipairs(love.joystick.getJoysticks()) do
 			v:setVibration()
 		end
 	end
-	if love.audio then love.audio.stop() end
+	if rawget(love, "audio") then love.audio.stop() end
 
 	love.graphics.reset()
 	local font = love.graphics.setNewFont(14)